@@ -2283,6 +2283,12 @@ public:
         return std::string();
       }) const;
 
+  /// Compute the hash value of the instruction opcodes of \p BB, ignoring
+  /// their operands. Unlike the hash of the function, it does not depend on
+  /// the rest of the CFG, which makes it usable for matching the blocks of a
+  /// function that changed since its profile was collected.
+  size_t computeBlockHash(const BinaryBasicBlock &BB) const;
+
   void setDWARFUnit(DWARFUnit *Unit) { DwarfUnit = Unit; }
 
   /// Return DWARF compile unit for this function.
@@ -415,10 +415,11 @@ public:
 
   virtual MCPhysReg getX86R11() const { llvm_unreachable("not implemented"); }
 
-  /// Create increment contents of target by 1 for Instrumentation
+  /// Create increment contents of target by 1 for Instrumentation. If
+  /// \p IsAtomic is false, concurrent increments may be lost.
   virtual void createInstrIncMemory(InstructionListType &Instrs,
                                     const MCSymbol *Target, MCContext *Ctx,
-                                    bool IsLeaf) const {
+                                    bool IsLeaf, bool IsAtomic) const {
     llvm_unreachable("not implemented");
   }
 
@@ -1485,9 +1486,10 @@ public:
     llvm_unreachable("not implemented");
   }
 
-  /// Create instruction to increment contents of target by 1
+  /// Create instruction to increment contents of target by 1, atomically if
+  /// \p IsAtomic is set.
   virtual bool createIncMemory(MCInst &Inst, const MCSymbol *Target,
-                               MCContext *Ctx) const {
+                               MCContext *Ctx, bool IsAtomic = true) const {
     llvm_unreachable("not implemented");
     return false;
   }
@@ -24,6 +24,10 @@ namespace CacheMetrics {
 /// Calculate various metrics related to instruction cache performance.
 void printAll(const std::vector<BinaryFunction *> &BinaryFunctions);
 
+/// Calculate the metrics that depend on the placement of basic blocks for the
+/// input binary, before any of its functions is reordered.
+void printInput(const std::vector<BinaryFunction *> &BinaryFunctions);
+
 /// Calculate Extended-TSP metric, which quantifies the expected number of
 /// i-cache misses for a given pair of basic blocks. The parameters are:
 /// - SrcAddr is the address of the source block;
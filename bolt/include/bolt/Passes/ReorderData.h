@@ -35,6 +35,11 @@ private:
   sortedByFunc(BinaryContext &BC, const BinarySection &Section,
                std::map<uint64_t, BinaryFunction> &BFs) const;
 
+  /// Group symbols accessed by the same functions, starting with the
+  /// functions with the most accesses to \p Section.
+  std::pair<DataOrder, unsigned>
+  sortedByAffinity(BinaryContext &BC, const BinarySection &Section) const;
+
   void printOrder(const BinarySection &Section, DataOrder::const_iterator Begin,
                   DataOrder::const_iterator End) const;
 
@@ -33,6 +33,7 @@ private:
 
   std::atomic<uint64_t> SplitBytesHot{0ull};
   std::atomic<uint64_t> SplitBytesCold{0ull};
+  std::atomic<uint64_t> SplitWarmBlocks{0ull};
 
 public:
   explicit SplitFunctions(const cl::opt<bool> &PrintPass)
@@ -135,6 +135,17 @@ private:
   std::unordered_map<uint64_t, uint64_t> BasicSamples;
   std::vector<PerfMemSample> MemSamples;
 
+  /// Branch and fall-through counts of a subset of the LBR samples. Batches of
+  /// samples are aggregated into several of these in parallel, which are then
+  /// merged into BranchLBRs and FallthroughLBRs.
+  struct LBRAggregation {
+    std::unordered_map<Trace, BranchInfo, TraceHash> BranchLBRs;
+    std::unordered_map<Trace, FTInfo, TraceHash> FallthroughLBRs;
+    uint64_t NumTraces{0};
+    uint64_t NumInvalidTraces{0};
+    uint64_t NumLongRangeTraces{0};
+  };
+
   template <typename T> void clear(T &Container) {
     T TempContainer;
     TempContainer.swap(Container);
@@ -288,6 +299,12 @@ private:
   /// return the error. Otherwise, return the parsed sample.
   ErrorOr<PerfBranchSample> parseBranchSample();
 
+  /// Aggregate the LBR entries of \p Sample into \p Aggr. If \p SkylakeFix is
+  /// set, the two most recent entries are dropped. This only reads the binary
+  /// context, so that separate aggregations can be done in parallel.
+  void aggregateBranchSample(const PerfBranchSample &Sample, bool SkylakeFix,
+                             LBRAggregation &Aggr) const;
+
   /// Parse a single perf sample containing a PID associated with an event name
   /// and a PC
   ErrorOr<PerfBasicSample> parseBasicSample();
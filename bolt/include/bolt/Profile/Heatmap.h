@@ -12,6 +12,7 @@
 #include "llvm/ADT/StringRef.h"
 #include <cstdint>
 #include <map>
+#include <system_error>
 
 namespace llvm {
 class raw_ostream;
@@ -54,6 +55,10 @@ public:
   void registerAddressRange(uint64_t StartAddress, uint64_t EndAddress,
                             uint64_t Count);
 
+  /// Add the block counts read from \p FileName, written by printCounts() for
+  /// a heat map with the same block size.
+  std::error_code mergeCounts(StringRef FileName);
+
   /// Return the number of ranges that failed to register.
   uint64_t getNumInvalidRanges() const { return NumSkippedRanges; }
 
@@ -65,6 +70,11 @@ public:
 
   void printCDF(raw_ostream &OS) const;
 
+  /// Print the sample count of every non-empty block as CSV.
+  void printCounts(StringRef FileName) const;
+
+  void printCounts(raw_ostream &OS) const;
+
   size_t size() const { return Map.size(); }
 };
 
@@ -45,6 +45,9 @@ private:
   bool NormalizeByInsnCount{false};
   bool NormalizeByCalls{false};
 
+  /// Number of profiles applied to functions that changed since profiling.
+  uint64_t NumStaleProfiles{0};
+
   /// Binary profile in YAML format.
   yaml::bolt::BinaryProfile YamlBP;
 
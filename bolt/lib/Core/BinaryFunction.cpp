@@ -99,7 +99,7 @@ JumpTables("jump-tables",
   cl::ZeroOrMore,
   cl::cat(BoltOptCategory));
 
-static cl::opt<bool>
+cl::opt<bool>
 NoScan("no-scan",
   cl::desc("do not scan cold functions for external references (may result in "
            "slower binary)"),
@@ -3576,6 +3576,38 @@ BinaryFunction::BasicBlockOrderType BinaryFunction::dfs() const {
   return DFS;
 }
 
+/// Append the opcodes and the hashed operands of the instructions of \p BB to
+/// \p HashString.
+static void appendHashString(const BinaryContext &BC,
+                             const BinaryBasicBlock &BB,
+                             BinaryFunction::OperandHashFuncTy OperandHashFunc,
+                             std::string &HashString) {
+  for (const MCInst &Inst : BB) {
+    unsigned Opcode = Inst.getOpcode();
+
+    if (BC.MIB->isPseudo(Inst))
+      continue;
+
+    // Ignore unconditional jumps since we check CFG consistency by processing
+    // basic blocks in order and do not rely on branches to be in-sync with
+    // CFG. Note that we still use condition code of conditional jumps.
+    if (BC.MIB->isUnconditionalBranch(Inst))
+      continue;
+
+    if (Opcode == 0)
+      HashString.push_back(0);
+
+    while (Opcode) {
+      uint8_t LSB = Opcode & 0xff;
+      HashString.push_back(LSB);
+      Opcode = Opcode >> 8;
+    }
+
+    for (unsigned I = 0, E = MCPlus::getNumPrimeOperands(Inst); I != E; ++I)
+      HashString.append(OperandHashFunc(Inst.getOperand(I)));
+  }
+}
+
 size_t BinaryFunction::computeHash(bool UseDFS,
                                    OperandHashFuncTy OperandHashFunc) const {
   if (size() == 0)
@@ -3588,36 +3620,19 @@ size_t BinaryFunction::computeHash(bool UseDFS,
   // The hash is computed by creating a string of all instruction opcodes and
   // possibly their operands and then hashing that string with std::hash.
   std::string HashString;
-  for (const BinaryBasicBlock *BB : Order) {
-    for (const MCInst &Inst : *BB) {
-      unsigned Opcode = Inst.getOpcode();
-
-      if (BC.MIB->isPseudo(Inst))
-        continue;
-
-      // Ignore unconditional jumps since we check CFG consistency by processing
-      // basic blocks in order and do not rely on branches to be in-sync with
-      // CFG. Note that we still use condition code of conditional jumps.
-      if (BC.MIB->isUnconditionalBranch(Inst))
-        continue;
-
-      if (Opcode == 0)
-        HashString.push_back(0);
-
-      while (Opcode) {
-        uint8_t LSB = Opcode & 0xff;
-        HashString.push_back(LSB);
-        Opcode = Opcode >> 8;
-      }
-
-      for (unsigned I = 0, E = MCPlus::getNumPrimeOperands(Inst); I != E; ++I)
-        HashString.append(OperandHashFunc(Inst.getOperand(I)));
-    }
-  }
+  for (const BinaryBasicBlock *BB : Order)
+    appendHashString(BC, *BB, OperandHashFunc, HashString);
 
   return Hash = std::hash<std::string>{}(HashString);
 }
 
+size_t BinaryFunction::computeBlockHash(const BinaryBasicBlock &BB) const {
+  std::string HashString;
+  appendHashString(
+      BC, BB, [](const MCOperand &) { return std::string(); }, HashString);
+  return std::hash<std::string>{}(HashString);
+}
+
 void BinaryFunction::insertBasicBlocks(
     BinaryBasicBlock *Start,
     std::vector<std::unique_ptr<BinaryBasicBlock>> &&NewBBs,
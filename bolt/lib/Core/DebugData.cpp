@@ -141,11 +141,18 @@ DebugRangesSectionWriter::addRanges(const DebugAddressRangesVector &Ranges) {
   if (Ranges.empty())
     return getEmptyRangesOffset();
 
+  // Encode the list before taking the lock, so that units updated in parallel
+  // only serialize on appending the encoded bytes to the section.
+  DebugBufferVector Buffer;
+  raw_svector_ostream OS(Buffer);
+  writeAddressRanges(OS, Ranges);
+
   // Reading the SectionOffset and updating it should be atomic to guarantee
   // unique and correct offsets in patches.
   std::lock_guard<std::mutex> Lock(WriterMutex);
   const uint32_t EntryOffset = SectionOffset;
-  SectionOffset += writeAddressRanges(*RangesStream.get(), Ranges);
+  *RangesStream << OS.str();
+  SectionOffset += Buffer.size();
 
   return EntryOffset;
 }
@@ -31,20 +31,30 @@ extern cl::opt<unsigned> BackwardDistance;
 extern cl::opt<unsigned> ITLBPageSize;
 extern cl::opt<unsigned> ITLBEntries;
 
+static cl::opt<unsigned>
+ITLBHugePageEntries("itlb-huge-page-entries",
+  cl::desc("The number of entries for 2MB pages in i-tlb cache"),
+  cl::init(8),
+  cl::ReallyHidden,
+  cl::ZeroOrMore,
+  cl::cat(BoltOptCategory));
+
 } // namespace opts
 
 namespace {
 
-/// Initialize and return a position map for binary basic blocks
+/// Initialize and return a position map for binary basic blocks. If
+/// \p UseInputAddresses is set, the positions are those of the input binary.
 void extractBasicBlockInfo(
     const std::vector<BinaryFunction *> &BinaryFunctions,
     std::unordered_map<BinaryBasicBlock *, uint64_t> &BBAddr,
-    std::unordered_map<BinaryBasicBlock *, uint64_t> &BBSize) {
+    std::unordered_map<BinaryBasicBlock *, uint64_t> &BBSize,
+    bool UseInputAddresses = false) {
 
   for (BinaryFunction *BF : BinaryFunctions) {
     const BinaryContext &BC = BF->getBinaryContext();
     for (BinaryBasicBlock *BB : BF->layout()) {
-      if (BF->isSimple() || BC.HasRelocations) {
+      if (!UseInputAddresses && (BF->isSimple() || BC.HasRelocations)) {
         // Use addresses/sizes as in the output binary
         BBAddr[BB] = BB->getOutputAddressRange().first;
         BBSize[BB] = BB->getOutputSize();
@@ -157,10 +167,9 @@ extractFunctionCalls(const std::vector<BinaryFunction *> &BinaryFunctions) {
 double expectedCacheHitRatio(
     const std::vector<BinaryFunction *> &BinaryFunctions,
     const std::unordered_map<BinaryBasicBlock *, uint64_t> &BBAddr,
-    const std::unordered_map<BinaryBasicBlock *, uint64_t> &BBSize) {
+    const std::unordered_map<BinaryBasicBlock *, uint64_t> &BBSize,
+    uint64_t PageSize, uint64_t CacheEntries) {
 
-  const double PageSize = opts::ITLBPageSize;
-  const uint64_t CacheEntries = opts::ITLBEntries;
   std::unordered_map<const BinaryFunction *, Predecessors> Calls =
       extractFunctionCalls(BinaryFunctions);
   // Compute 'hotness' of the functions
@@ -180,7 +189,7 @@ double expectedCacheHitRatio(
   for (BinaryFunction *BF : BinaryFunctions) {
     if (BF->layout_empty())
       continue;
-    double Page = BBAddr.at(BF->layout_front()) / PageSize;
+    uint64_t Page = BBAddr.at(BF->layout_front()) / PageSize;
     PageSamples[Page] += FunctionSamples.at(BF);
   }
 
@@ -191,14 +200,14 @@ double expectedCacheHitRatio(
     if (BF->layout_empty() || FunctionSamples.at(BF) == 0.0)
       continue;
     double Samples = FunctionSamples.at(BF);
-    double Page = BBAddr.at(BF->layout_front()) / PageSize;
+    uint64_t Page = BBAddr.at(BF->layout_front()) / PageSize;
     // The probability that the page is not present in the cache
     double MissProb = pow(1.0 - PageSamples[Page] / TotalSamples, CacheEntries);
 
     // Processing all callers of the function
     for (std::pair<BinaryFunction *, uint64_t> Pair : Calls[BF]) {
       BinaryFunction *SrcFunction = Pair.first;
-      double SrcPage = BBAddr.at(SrcFunction->layout_front()) / PageSize;
+      uint64_t SrcPage = BBAddr.at(SrcFunction->layout_front()) / PageSize;
       // Is this a 'long' or a 'short' call?
       if (Page != SrcPage) {
         // This is a miss
@@ -214,6 +223,33 @@ double expectedCacheHitRatio(
   return 100.0 * (1.0 - Misses / TotalSamples);
 }
 
+constexpr uint64_t HugePage2MB = 2 << 20;
+
+/// Print the metrics of the given placement of basic blocks.
+void printLayoutMetrics(
+    const std::vector<BinaryFunction *> &BinaryFunctions,
+    const std::unordered_map<BinaryBasicBlock *, uint64_t> &BBAddr,
+    const std::unordered_map<BinaryBasicBlock *, uint64_t> &BBSize) {
+  outs() << "  Expected i-TLB cache hit ratio: "
+         << format("%.2lf%%\n",
+                   expectedCacheHitRatio(BinaryFunctions, BBAddr, BBSize,
+                                         opts::ITLBPageSize,
+                                         opts::ITLBEntries));
+
+  outs() << "  Expected i-TLB cache hit ratio with 2MB pages: "
+         << format("%.2lf%%\n",
+                   expectedCacheHitRatio(BinaryFunctions, BBAddr, BBSize,
+                                         HugePage2MB,
+                                         opts::ITLBHugePageEntries));
+
+  outs() << "  TSP score: "
+         << format("%.0lf\n", calcTSPScore(BinaryFunctions, BBAddr, BBSize));
+
+  outs() << "  ExtTSP score: "
+         << format("%.0lf\n",
+                   calcExtTSPScore(BinaryFunctions, BBAddr, BBSize));
+}
+
 } // namespace
 
 double CacheMetrics::extTSPScore(uint64_t SrcAddr, uint64_t SrcSize,
@@ -289,7 +325,6 @@ void CacheMetrics::printAll(const std::vector<BinaryFunction *> &BFs) {
   size_t HotCodeSize = HotCodeMaxAddr - HotCodeMinAddr;
   size_t TotalCodeSize = TotalCodeMaxAddr - TotalCodeMinAddr;
 
-  size_t HugePage2MB = 2 << 20;
   outs() << format("  Hot code takes %.2lf%% of binary (%zu bytes out of %zu, "
                    "%.2lf huge pages)\n",
                    100.0 * HotCodeSize / TotalCodeSize, HotCodeSize,
@@ -299,13 +334,12 @@ void CacheMetrics::printAll(const std::vector<BinaryFunction *> &BFs) {
   std::unordered_map<BinaryBasicBlock *, uint64_t> BBAddr;
   std::unordered_map<BinaryBasicBlock *, uint64_t> BBSize;
   extractBasicBlockInfo(BFs, BBAddr, BBSize);
+  printLayoutMetrics(BFs, BBAddr, BBSize);
+}
 
-  outs() << "  Expected i-TLB cache hit ratio: "
-         << format("%.2lf%%\n", expectedCacheHitRatio(BFs, BBAddr, BBSize));
-
-  outs() << "  TSP score: "
-         << format("%.0lf\n", calcTSPScore(BFs, BBAddr, BBSize));
-
-  outs() << "  ExtTSP score: "
-         << format("%.0lf\n", calcExtTSPScore(BFs, BBAddr, BBSize));
+void CacheMetrics::printInput(const std::vector<BinaryFunction *> &BFs) {
+  std::unordered_map<BinaryBasicBlock *, uint64_t> BBAddr;
+  std::unordered_map<BinaryBasicBlock *, uint64_t> BBSize;
+  extractBasicBlockInfo(BFs, BBAddr, BBSize, /*UseInputAddresses=*/true);
+  printLayoutMetrics(BFs, BBAddr, BBSize);
 }
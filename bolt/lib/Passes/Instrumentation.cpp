@@ -67,6 +67,14 @@ cl::opt<bool> InstrumentationWaitForks(
              "(use with instrumentation-sleep-time option)"),
     cl::init(false), cl::Optional, cl::cat(BoltInstrCategory));
 
+cl::opt<bool> InstrumentationAtomicCounters(
+    "instrumentation-atomic-counters",
+    cl::desc("increment counters with atomic instructions. Disabling it "
+             "lowers the overhead of instrumented code, at the cost of losing "
+             "increments of the same counter that race between threads "
+             "(default: true)"),
+    cl::init(true), cl::Optional, cl::cat(BoltInstrCategory));
+
 cl::opt<bool>
     InstrumentHotOnly("instrument-hot-only",
                       cl::desc("only insert instrumentation on hot functions "
@@ -177,7 +185,8 @@ Instrumentation::createInstrumentationSnippet(BinaryContext &BC, bool IsLeaf) {
   Label = BC.Ctx->createNamedTempSymbol("InstrEntry");
   Summary->Counters.emplace_back(Label);
   InstructionListType CounterInstrs;
-  BC.MIB->createInstrIncMemory(CounterInstrs, Label, &*BC.Ctx, IsLeaf);
+  BC.MIB->createInstrIncMemory(CounterInstrs, Label, &*BC.Ctx, IsLeaf,
+                               opts::InstrumentationAtomicCounters);
   return CounterInstrs;
 }
 
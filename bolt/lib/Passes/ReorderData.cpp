@@ -17,6 +17,7 @@
 
 #include "bolt/Passes/ReorderData.h"
 #include <algorithm>
+#include <unordered_set>
 
 #undef  DEBUG_TYPE
 #define DEBUG_TYPE "reorder-data"
@@ -45,7 +46,8 @@ ReorderData("reorder-data",
 
 enum ReorderAlgo : char {
   REORDER_COUNT         = 0,
-  REORDER_FUNCS         = 1
+  REORDER_FUNCS         = 1,
+  REORDER_AFFINITY      = 2
 };
 
 static cl::opt<ReorderAlgo>
@@ -58,7 +60,10 @@ ReorderAlgorithm("reorder-data-algo",
       "sort hot data by read counts"),
     clEnumValN(REORDER_FUNCS,
       "funcs",
-      "sort hot data by hot function usage and count")),
+      "sort hot data by hot function usage and count"),
+    clEnumValN(REORDER_AFFINITY,
+      "affinity",
+      "group hot data accessed by the same functions, hottest first")),
   cl::ZeroOrMore,
   cl::cat(BoltOptCategory));
 
@@ -310,6 +315,85 @@ ReorderData::sortedByFunc(BinaryContext &BC, const BinarySection &Section,
   return std::make_pair(Order, SplitPoint);
 }
 
+/// Place the data accessed by the same function next to each other, so that
+/// the hot data of a function shares cache lines and pages. Functions are
+/// processed in decreasing order of their accesses to the section, and the
+/// data of each function in decreasing order of access density.
+std::pair<DataOrder, unsigned>
+ReorderData::sortedByAffinity(BinaryContext &BC,
+                              const BinarySection &Section) const {
+  DataOrder BaseOrder = baseOrder(BC, Section);
+  std::unordered_map<const BinaryData *, uint64_t> BDCounts;
+  for (const DataOrder::value_type &Entry : BaseOrder)
+    BDCounts.emplace(Entry.first, Entry.second);
+
+  // Accesses of every function to the data of the section.
+  using AccessCounts = std::map<BinaryData *, uint64_t>;
+  std::vector<std::pair<uint64_t, AccessCounts>> FuncAccesses;
+  for (auto &BFI : BC.getBinaryFunctions()) {
+    const BinaryFunction &BF = BFI.second;
+    if (!BF.hasMemoryProfile())
+      continue;
+
+    uint64_t TotalCount = 0;
+    AccessCounts Counts;
+    for (const BinaryBasicBlock &BB : BF) {
+      for (const MCInst &Inst : BB) {
+        auto ErrorOrMemAccesssProfile =
+            BC.MIB->tryGetAnnotationAs<MemoryAccessProfile>(
+                Inst, "MemoryAccessProfile");
+        if (!ErrorOrMemAccesssProfile)
+          continue;
+
+        for (const AddressAccess &AccessInfo :
+             ErrorOrMemAccesssProfile.get().AddressAccessInfo) {
+          if (!AccessInfo.MemoryObject)
+            continue;
+          BinaryData *BD = AccessInfo.MemoryObject->getAtomicRoot();
+          if (!BDCounts.count(BD))
+            continue;
+          Counts[BD] += AccessInfo.Count;
+          TotalCount += AccessInfo.Count;
+        }
+      }
+    }
+    if (TotalCount)
+      FuncAccesses.emplace_back(TotalCount, std::move(Counts));
+  }
+
+  std::stable_sort(FuncAccesses.begin(), FuncAccesses.end(),
+                   [](const std::pair<uint64_t, AccessCounts> &A,
+                      const std::pair<uint64_t, AccessCounts> &B) {
+                     return A.first > B.first;
+                   });
+
+  DataOrder Order;
+  std::unordered_set<const BinaryData *> Placed;
+  for (std::pair<uint64_t, AccessCounts> &FuncAccess : FuncAccesses) {
+    DataOrder FuncOrder(FuncAccess.second.begin(), FuncAccess.second.end());
+    std::sort(
+        FuncOrder.begin(), FuncOrder.end(),
+        [](const DataOrder::value_type &A, const DataOrder::value_type &B) {
+          // Weight by number of loads from this function/data size.
+          const double AWeight = double(A.second) / A.first->getSize();
+          const double BWeight = double(B.second) / B.first->getSize();
+          return AWeight > BWeight ||
+                 (AWeight == BWeight &&
+                  A.first->getAddress() < B.first->getAddress());
+        });
+    for (const DataOrder::value_type &Entry : FuncOrder)
+      if (Placed.insert(Entry.first).second)
+        Order.emplace_back(Entry.first, BDCounts[Entry.first]);
+  }
+
+  const unsigned SplitPoint = Order.size();
+  for (const DataOrder::value_type &Entry : BaseOrder)
+    if (!Placed.count(Entry.first))
+      Order.push_back(Entry);
+
+  return std::make_pair(Order, SplitPoint);
+}
+
 std::pair<DataOrder, unsigned>
 ReorderData::sortedByCount(BinaryContext &BC,
                            const BinarySection &Section) const {
@@ -497,10 +581,13 @@ void ReorderData::runOnFunctions(BinaryContext &BC) {
     if (opts::ReorderAlgorithm == opts::ReorderAlgo::REORDER_COUNT) {
       outs() << "BOLT-INFO: reorder-sections: ordering data by count\n";
       std::tie(Order, SplitPointIdx) = sortedByCount(BC, *Section);
-    } else {
+    } else if (opts::ReorderAlgorithm == opts::ReorderAlgo::REORDER_FUNCS) {
       outs() << "BOLT-INFO: reorder-sections: ordering data by funcs\n";
       std::tie(Order, SplitPointIdx) =
           sortedByFunc(BC, *Section, BC.getBinaryFunctions());
+    } else {
+      outs() << "BOLT-INFO: reorder-sections: ordering data by affinity\n";
+      std::tie(Order, SplitPointIdx) = sortedByAffinity(BC, *Section);
     }
     auto SplitPoint = Order.begin() + SplitPointIdx;
 
@@ -72,6 +72,17 @@ SplitThreshold("split-threshold",
   cl::Hidden,
   cl::cat(BoltOptCategory));
 
+static cl::opt<double>
+SplitWarmThreshold("split-warm-threshold",
+  cl::desc("also outline warm basic blocks, i.e. blocks executed at most this "
+           "percentage of the times the function is executed. Warm blocks "
+           "are placed at the start of the cold fragment, ahead of the blocks "
+           "that were never executed. Default value: 0, i.e. only outline "
+           "blocks that were never executed."),
+  cl::init(0.0),
+  cl::ZeroOrMore,
+  cl::cat(BoltOptCategory));
+
 void syncOptions(BinaryContext &BC) {
   if (!BC.HasRelocations && opts::SplitFunctions == SplitFunctions::ST_LARGE)
     opts::SplitFunctions = SplitFunctions::ST_ALL;
@@ -113,6 +124,9 @@ void SplitFunctions::runOnFunctions(BinaryContext &BC) {
            << " hot bytes from " << SplitBytesCold << " cold bytes "
            << format("(%.2lf%% of split functions is hot).\n",
                      100.0 * SplitBytesHot / (SplitBytesHot + SplitBytesCold));
+  if (SplitWarmBlocks > 0)
+    outs() << "BOLT-INFO: splitting moved " << SplitWarmBlocks
+           << " warm basic blocks to cold fragments\n";
 }
 
 void SplitFunctions::splitFunction(BinaryFunction &BF) {
@@ -154,12 +168,17 @@ void SplitFunctions::splitFunction(BinaryFunction &BF) {
       return;
   }
 
+  // Blocks executed at most this many times are outlined together with the
+  // blocks that were never executed.
+  const uint64_t WarmCount =
+      opts::SplitWarmThreshold * BF.getKnownExecutionCount() / 100.0;
+
   // Never outline the first basic block.
   BF.layout_front()->setCanOutline(false);
   for (BinaryBasicBlock *BB : BF.layout()) {
     if (!BB->canOutline())
       continue;
-    if (BB->getExecutionCount() != 0) {
+    if (BB->getExecutionCount() > WarmCount) {
       BB->setCanOutline(false);
       continue;
     }
@@ -213,11 +232,27 @@ void SplitFunctions::splitFunction(BinaryFunction &BF) {
   }
 
   // Separate hot from cold starting from the bottom.
+  auto FirstCold = BF.layout_end();
   for (auto I = BF.layout_rbegin(), E = BF.layout_rend(); I != E; ++I) {
     BinaryBasicBlock *BB = *I;
     if (!BB->canOutline())
       break;
     BB->setIsCold(true);
+    FirstCold = std::prev(I.base());
+  }
+
+  // Keep the warm blocks of the cold fragment together at its start, so that
+  // the code that is never executed does not share cache lines and pages with
+  // them.
+  uint64_t NumWarmBlocks = 0;
+  if (WarmCount > 0) {
+    std::stable_sort(FirstCold, BF.layout_end(),
+                     [&](BinaryBasicBlock *A, BinaryBasicBlock *B) {
+                       return A->getExecutionCount() > B->getExecutionCount();
+                     });
+    NumWarmBlocks = std::count_if(
+        FirstCold, BF.layout_end(),
+        [](BinaryBasicBlock *BB) { return BB->getExecutionCount() != 0; });
   }
 
   // Check the new size to see if it's worth splitting the function.
@@ -236,11 +271,13 @@ void SplitFunctions::splitFunction(BinaryFunction &BF) {
       BF.updateBasicBlockLayout(PreSplitLayout);
       for (BinaryBasicBlock &BB : BF)
         BB.setIsCold(false);
-    } else {
-      SplitBytesHot += HotSize;
-      SplitBytesCold += ColdSize;
+      return;
     }
+    SplitBytesHot += HotSize;
+    SplitBytesCold += ColdSize;
   }
+
+  SplitWarmBlocks += NumWarmBlocks;
 }
 
 } // namespace bolt
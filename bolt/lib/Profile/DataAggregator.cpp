@@ -14,6 +14,7 @@
 #include "bolt/Profile/DataAggregator.h"
 #include "bolt/Core/BinaryContext.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Profile/BoltAddressTranslation.h"
 #include "bolt/Profile/Heatmap.h"
 #include "bolt/Utils/CommandLineOpts.h"
@@ -26,6 +27,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Regex.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -60,6 +62,21 @@ FilterPID("pid",
   cl::Optional,
   cl::cat(AggregatorCategory));
 
+static cl::opt<std::string>
+HeatmapCountsOutput("counts-output",
+  cl::desc("write the sample count of each heat map block to this CSV file, "
+           "for merging with other profiles with -merge-counts"),
+  cl::Optional,
+  cl::cat(HeatmapCategory));
+
+static cl::list<std::string>
+HeatmapMergeCounts("merge-counts",
+  cl::CommaSeparated,
+  cl::desc("add the block counts of CSV files written with -counts-output "
+           "to the heat map"),
+  cl::value_desc("file1,file2,file3,..."),
+  cl::cat(HeatmapCategory));
+
 static cl::opt<bool>
 IgnoreBuildID("ignore-build-id",
   cl::desc("continue even if build-ids in input binary and perf.data mismatch"),
@@ -1344,6 +1361,15 @@ std::error_code DataAggregator::printLBRHeatMap() {
   if (HM.getNumInvalidRanges())
     outs() << "HEATMAP: invalid traces: " << HM.getNumInvalidRanges() << '\n';
 
+  for (const std::string &FileName : opts::HeatmapMergeCounts) {
+    if (std::error_code EC = HM.mergeCounts(FileName)) {
+      errs() << "HEATMAP-ERROR: cannot merge " << FileName << ": "
+             << EC.message() << '\n';
+      exit(1);
+    }
+    outs() << "HEATMAP: merged block counts from " << FileName << '\n';
+  }
+
   if (!HM.size()) {
     errs() << "HEATMAP-ERROR: no valid traces registered\n";
     exit(1);
@@ -1354,10 +1380,90 @@ std::error_code DataAggregator::printLBRHeatMap() {
     HM.printCDF(opts::OutputFilename);
   else
     HM.printCDF(opts::OutputFilename + ".csv");
+  if (!opts::HeatmapCountsOutput.empty())
+    HM.printCounts(opts::HeatmapCountsOutput);
 
   return std::error_code();
 }
 
+void DataAggregator::aggregateBranchSample(const PerfBranchSample &Sample,
+                                           bool SkylakeFix,
+                                           LBRAggregation &Aggr) const {
+  // LBRs are stored in reverse execution order. NextPC refers to the next
+  // recorded executed PC.
+  uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
+  uint32_t NumEntry = 0;
+  for (const LBREntry &LBR : Sample.LBR) {
+    ++NumEntry;
+    // Hardware bug workaround: Intel Skylake (which has 32 LBR entries)
+    // sometimes record entry 32 as an exact copy of entry 31. This will cause
+    // us to likely record an invalid trace and generate a stale function for
+    // BAT mode (non BAT disassembles the function and is able to ignore this
+    // trace at aggregation time). Drop first 2 entries (last two, in
+    // chronological order)
+    if (SkylakeFix && NumEntry <= 2)
+      continue;
+    if (NextPC) {
+      // Record fall-through trace.
+      const uint64_t TraceFrom = LBR.To;
+      const uint64_t TraceTo = NextPC;
+      const BinaryFunction *TraceBF =
+          getBinaryFunctionContainingAddress(TraceFrom);
+      if (TraceBF && TraceBF->containsAddress(TraceTo)) {
+        FTInfo &Info = Aggr.FallthroughLBRs[Trace(TraceFrom, TraceTo)];
+        if (TraceBF->containsAddress(LBR.From))
+          ++Info.InternCount;
+        else
+          ++Info.ExternCount;
+      } else {
+        if (TraceBF && getBinaryFunctionContainingAddress(TraceTo)) {
+          LLVM_DEBUG(dbgs()
+                     << "Invalid trace starting in "
+                     << TraceBF->getPrintName() << " @ "
+                     << Twine::utohexstr(TraceFrom - TraceBF->getAddress())
+                     << " and ending @ " << Twine::utohexstr(TraceTo)
+                     << '\n');
+          ++Aggr.NumInvalidTraces;
+        } else {
+          LLVM_DEBUG(dbgs()
+                     << "Out of range trace starting in "
+                     << (TraceBF ? TraceBF->getPrintName() : "None") << " @ "
+                     << Twine::utohexstr(
+                            TraceFrom - (TraceBF ? TraceBF->getAddress() : 0))
+                     << " and ending in "
+                     << (getBinaryFunctionContainingAddress(TraceTo)
+                             ? getBinaryFunctionContainingAddress(TraceTo)
+                                   ->getPrintName()
+                             : "None")
+                     << " @ "
+                     << Twine::utohexstr(
+                            TraceTo -
+                            (getBinaryFunctionContainingAddress(TraceTo)
+                                 ? getBinaryFunctionContainingAddress(TraceTo)
+                                       ->getAddress()
+                                 : 0))
+                     << '\n');
+          ++Aggr.NumLongRangeTraces;
+        }
+      }
+      ++Aggr.NumTraces;
+    }
+    NextPC = LBR.From;
+
+    uint64_t From = LBR.From;
+    if (!getBinaryFunctionContainingAddress(From))
+      From = 0;
+    uint64_t To = LBR.To;
+    if (!getBinaryFunctionContainingAddress(To))
+      To = 0;
+    if (!From && !To)
+      continue;
+    BranchInfo &Info = Aggr.BranchLBRs[Trace(From, To)];
+    ++Info.TakenCount;
+    Info.MispredCount += LBR.Mispred;
+  }
+}
+
 std::error_code DataAggregator::parseBranchEvents() {
   outs() << "PERF2BOLT: parse branch events...\n";
   NamedRegionTimer T("parseBranch", "Parsing branch events", TimerGroupName,
@@ -1370,6 +1476,39 @@ std::error_code DataAggregator::parseBranchEvents() {
   uint64_t NumTraces = 0;
   bool NeedsSkylakeFix = false;
 
+  // The perf script output is parsed sequentially, but the samples are
+  // aggregated in batches, in parallel unless threads are disabled. Every
+  // thread aggregates its share of a batch into its own maps, which are merged
+  // once all the samples are read.
+  const unsigned NumAggregations =
+      opts::NoThreads ? 1 : std::max(1u, unsigned(opts::ThreadCount));
+  const size_t BatchSize = 4096 * NumAggregations;
+  std::vector<LBRAggregation> Aggregations(NumAggregations);
+  std::vector<std::pair<PerfBranchSample, bool>> Batch;
+  Batch.reserve(BatchSize);
+
+  auto aggregateBatch = [&]() {
+    if (NumAggregations == 1) {
+      for (const auto &SampleAndFix : Batch)
+        aggregateBranchSample(SampleAndFix.first, SampleAndFix.second,
+                              Aggregations.front());
+    } else {
+      ThreadPool &Pool = ParallelUtilities::getThreadPool();
+      const size_t ChunkSize = divideCeil(Batch.size(), NumAggregations);
+      for (unsigned I = 0; I < NumAggregations; ++I) {
+        const size_t Begin = std::min(Batch.size(), I * ChunkSize);
+        const size_t End = std::min(Batch.size(), Begin + ChunkSize);
+        Pool.async([&, I, Begin, End] {
+          for (size_t J = Begin; J < End; ++J)
+            aggregateBranchSample(Batch[J].first, Batch[J].second,
+                                  Aggregations[I]);
+        });
+      }
+      Pool.wait();
+    }
+    Batch.clear();
+  };
+
   while (hasData() && NumTotalSamples < opts::MaxSamples) {
     ++NumTotalSamples;
 
@@ -1396,80 +1535,32 @@ std::error_code DataAggregator::parseBranchEvents() {
       NeedsSkylakeFix = true;
     }
 
-    // LBRs are stored in reverse execution order. NextPC refers to the next
-    // recorded executed PC.
-    uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
-    uint32_t NumEntry = 0;
-    for (const LBREntry &LBR : Sample.LBR) {
-      ++NumEntry;
-      // Hardware bug workaround: Intel Skylake (which has 32 LBR entries)
-      // sometimes record entry 32 as an exact copy of entry 31. This will cause
-      // us to likely record an invalid trace and generate a stale function for
-      // BAT mode (non BAT disassembles the function and is able to ignore this
-      // trace at aggregation time). Drop first 2 entries (last two, in
-      // chronological order)
-      if (NeedsSkylakeFix && NumEntry <= 2)
-        continue;
-      if (NextPC) {
-        // Record fall-through trace.
-        const uint64_t TraceFrom = LBR.To;
-        const uint64_t TraceTo = NextPC;
-        const BinaryFunction *TraceBF =
-            getBinaryFunctionContainingAddress(TraceFrom);
-        if (TraceBF && TraceBF->containsAddress(TraceTo)) {
-          FTInfo &Info = FallthroughLBRs[Trace(TraceFrom, TraceTo)];
-          if (TraceBF->containsAddress(LBR.From))
-            ++Info.InternCount;
-          else
-            ++Info.ExternCount;
-        } else {
-          if (TraceBF && getBinaryFunctionContainingAddress(TraceTo)) {
-            LLVM_DEBUG(dbgs()
-                       << "Invalid trace starting in "
-                       << TraceBF->getPrintName() << " @ "
-                       << Twine::utohexstr(TraceFrom - TraceBF->getAddress())
-                       << " and ending @ " << Twine::utohexstr(TraceTo)
-                       << '\n');
-            ++NumInvalidTraces;
-          } else {
-            LLVM_DEBUG(dbgs()
-                       << "Out of range trace starting in "
-                       << (TraceBF ? TraceBF->getPrintName() : "None") << " @ "
-                       << Twine::utohexstr(
-                              TraceFrom - (TraceBF ? TraceBF->getAddress() : 0))
-                       << " and ending in "
-                       << (getBinaryFunctionContainingAddress(TraceTo)
-                               ? getBinaryFunctionContainingAddress(TraceTo)
-                                     ->getPrintName()
-                               : "None")
-                       << " @ "
-                       << Twine::utohexstr(
-                              TraceTo -
-                              (getBinaryFunctionContainingAddress(TraceTo)
-                                   ? getBinaryFunctionContainingAddress(TraceTo)
-                                         ->getAddress()
-                                   : 0))
-                       << '\n');
-            ++NumLongRangeTraces;
-          }
-        }
-        ++NumTraces;
-      }
-      NextPC = LBR.From;
-
-      uint64_t From = LBR.From;
-      if (!getBinaryFunctionContainingAddress(From))
-        From = 0;
-      uint64_t To = LBR.To;
-      if (!getBinaryFunctionContainingAddress(To))
-        To = 0;
-      if (!From && !To)
-        continue;
-      BranchInfo &Info = BranchLBRs[Trace(From, To)];
-      ++Info.TakenCount;
-      Info.MispredCount += LBR.Mispred;
+    Batch.emplace_back(std::move(Sample), NeedsSkylakeFix);
+    if (Batch.size() == BatchSize)
+      aggregateBatch();
+  }
+  aggregateBatch();
+
+  // The first aggregation is moved rather than merged, which keeps the order
+  // of the maps of a single-threaded run.
+  BranchLBRs.swap(Aggregations.front().BranchLBRs);
+  FallthroughLBRs.swap(Aggregations.front().FallthroughLBRs);
+  for (LBRAggregation &Aggr : Aggregations) {
+    for (const auto &Entry : Aggr.BranchLBRs) {
+      BranchInfo &Info = BranchLBRs[Entry.first];
+      Info.TakenCount += Entry.second.TakenCount;
+      Info.MispredCount += Entry.second.MispredCount;
+    }
+    for (const auto &Entry : Aggr.FallthroughLBRs) {
+      FTInfo &Info = FallthroughLBRs[Entry.first];
+      Info.InternCount += Entry.second.InternCount;
+      Info.ExternCount += Entry.second.ExternCount;
     }
+    NumTraces += Aggr.NumTraces;
+    NumInvalidTraces += Aggr.NumInvalidTraces;
+    NumLongRangeTraces += Aggr.NumLongRangeTraces;
   }
+  Aggregations.clear();
 
   for (const auto &LBR : BranchLBRs) {
     const Trace &Trace = LBR.first;
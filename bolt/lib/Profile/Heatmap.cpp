@@ -12,8 +12,11 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Errc.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/LineIterator.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cmath>
@@ -45,6 +48,46 @@ void Heatmap::registerAddressRange(uint64_t StartAddress, uint64_t EndAddress,
     Map[Bucket] += Count;
 }
 
+std::error_code Heatmap::mergeCounts(StringRef FileName) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MB = MemoryBuffer::getFile(FileName);
+  if (std::error_code EC = MB.getError())
+    return EC;
+
+  line_iterator Line(**MB);
+  auto parseLine = [&](StringRef &Key, uint64_t &Value) {
+    if (Line.is_at_eof())
+      return false;
+    StringRef ValueStr;
+    std::tie(Key, ValueStr) = Line->split(',');
+    Key = Key.trim();
+    ++Line;
+    return !ValueStr.trim().getAsInteger(0, Value);
+  };
+
+  StringRef Key;
+  uint64_t Value;
+  if (!parseLine(Key, Value) || Key != "Block size" || Value != BucketSize ||
+      Line.is_at_eof() || !Line->startswith("Address")) {
+    errs() << "HEATMAP-ERROR: " << FileName
+           << " is not a heat map with block size " << BucketSize << '\n';
+    return make_error_code(errc::invalid_argument);
+  }
+  ++Line;
+
+  while (!Line.is_at_eof()) {
+    uint64_t Address;
+    if (!parseLine(Key, Value) || Key.getAsInteger(0, Address)) {
+      errs() << "HEATMAP-ERROR: malformed block count in " << FileName
+             << " at line " << (Line.line_number() - 1) << '\n';
+      return make_error_code(errc::invalid_argument);
+    }
+    if (!ignoreAddress(Address))
+      Map[Address / BucketSize] += Value;
+  }
+
+  return std::error_code();
+}
+
 void Heatmap::print(StringRef FileName) const {
   std::error_code EC;
   raw_fd_ostream OS(FileName, EC, sys::fs::OpenFlags::OF_None);
@@ -251,5 +294,22 @@ void Heatmap::printCDF(raw_ostream &OS) const {
   Counts.clear();
 }
 
+void Heatmap::printCounts(StringRef FileName) const {
+  std::error_code EC;
+  raw_fd_ostream OS(FileName, EC, sys::fs::OpenFlags::OF_None);
+  if (EC) {
+    errs() << "error opening output file: " << EC.message() << '\n';
+    exit(1);
+  }
+  printCounts(OS);
+}
+
+void Heatmap::printCounts(raw_ostream &OS) const {
+  OS << "Block size, " << BucketSize << '\n';
+  OS << "Address, Count\n";
+  for (const std::pair<const uint64_t, uint64_t> &KV : Map)
+    OS << format("0x%llx", KV.first * BucketSize) << ", " << KV.second << '\n';
+}
+
 } // namespace bolt
 } // namespace llvm
@@ -29,6 +29,23 @@ IgnoreHash("profile-ignore-hash",
   cl::Hidden,
   cl::cat(BoltOptCategory));
 
+static llvm::cl::opt<bool>
+InferStaleProfile("infer-stale-profile",
+  cl::desc("apply the profile of functions that changed since it was "
+           "collected, matching basic blocks by their hash"),
+  cl::init(false),
+  cl::ZeroOrMore,
+  cl::cat(BoltOptCategory));
+
+static llvm::cl::opt<unsigned>
+StaleMatchingMinMatchedBlock("stale-matching-min-matched-block",
+  cl::desc("minimum percentage of the samples of a stale function profile "
+           "that has to be matched to basic blocks for the profile to be used"),
+  cl::init(50),
+  cl::ZeroOrMore,
+  cl::Hidden,
+  cl::cat(BoltOptCategory));
+
 }
 
 namespace llvm {
@@ -74,6 +91,48 @@ bool YAMLProfileReader::hasLocalsWithFileName() const {
   return false;
 }
 
+/// Match the basic blocks of the stale profile \p YamlBF to the blocks of
+/// \p BF, given in \p DFSOrder. A profiled block is matched to an unmatched
+/// block with the same hash, preferring the one closest to its position in the
+/// DFS order of the profiled function. Return the matched blocks indexed by
+/// the index of the profiled blocks, with null entries for the blocks without
+/// a match.
+static BinaryFunction::BasicBlockOrderType
+matchStaleBlocks(const BinaryFunction &BF,
+                 const BinaryFunction::BasicBlockOrderType &DFSOrder,
+                 const yaml::bolt::BinaryFunctionProfile &YamlBF) {
+  std::unordered_map<uint64_t, std::vector<unsigned>> BlocksByHash;
+  for (unsigned I = 0, E = DFSOrder.size(); I != E; ++I)
+    BlocksByHash[BF.computeBlockHash(*DFSOrder[I])].push_back(I);
+
+  BinaryFunction::BasicBlockOrderType MatchedBlocks;
+  std::vector<bool> IsMatched(DFSOrder.size());
+  for (const yaml::bolt::BinaryBasicBlockProfile &YamlBB : YamlBF.Blocks) {
+    // Profiles written before block hashes were recorded have none.
+    if (!YamlBB.Hash)
+      continue;
+    auto It = BlocksByHash.find(YamlBB.Hash);
+    if (It == BlocksByHash.end())
+      continue;
+
+    auto distance = [&](unsigned I) {
+      return I > YamlBB.Index ? I - YamlBB.Index : YamlBB.Index - I;
+    };
+    Optional<unsigned> Best;
+    for (unsigned I : It->second)
+      if (!IsMatched[I] && (!Best || distance(I) < distance(*Best)))
+        Best = I;
+    if (!Best)
+      continue;
+
+    IsMatched[*Best] = true;
+    if (YamlBB.Index >= MatchedBlocks.size())
+      MatchedBlocks.resize(YamlBB.Index + 1);
+    MatchedBlocks[YamlBB.Index] = DFSOrder[*Best];
+  }
+  return MatchedBlocks;
+}
+
 bool YAMLProfileReader::parseFunctionProfile(
     BinaryFunction &BF, const yaml::bolt::BinaryFunctionProfile &YamlBF) {
   BinaryContext &BC = BF.getBinaryContext();
@@ -87,7 +146,9 @@ bool YAMLProfileReader::parseFunctionProfile(
 
   BF.setExecutionCount(YamlBF.ExecCount);
 
-  if (!opts::IgnoreHash && YamlBF.Hash != BF.computeHash(/*UseDFS=*/true)) {
+  const bool HashMatched =
+      opts::IgnoreHash || YamlBF.Hash == BF.computeHash(/*UseDFS=*/true);
+  if (!HashMatched) {
     if (opts::Verbosity >= 1)
       errs() << "BOLT-WARNING: function hash mismatch\n";
     ProfileMatched = false;
@@ -101,16 +162,35 @@ bool YAMLProfileReader::parseFunctionProfile(
 
   BinaryFunction::BasicBlockOrderType DFSOrder = BF.dfs();
 
+  // The blocks of a function that did not change since the profile was
+  // collected are in the same DFS order as the profiled blocks. Otherwise,
+  // they are matched by their hash if stale profiles are to be inferred.
+  const bool IsStale = opts::InferStaleProfile && !HashMatched;
+  BinaryFunction::BasicBlockOrderType ProfiledBlocks =
+      IsStale ? matchStaleBlocks(BF, DFSOrder, YamlBF) : DFSOrder;
+  auto getProfiledBlock = [&](uint32_t Index) -> BinaryBasicBlock * {
+    return Index < ProfiledBlocks.size() ? ProfiledBlocks[Index] : nullptr;
+  };
+
+  // Samples of the profiled blocks, and those of the blocks that were found in
+  // the function.
+  uint64_t TotalBlockCount = 0;
+  uint64_t MatchedBlockCount = 0;
+
   for (const yaml::bolt::BinaryBasicBlockProfile &YamlBB : YamlBF.Blocks) {
-    if (YamlBB.Index >= DFSOrder.size()) {
+    const uint64_t BlockCount = YamlBB.ExecCount + YamlBB.EventCount;
+    TotalBlockCount += BlockCount;
+    if (!getProfiledBlock(YamlBB.Index)) {
       if (opts::Verbosity >= 2)
         errs() << "BOLT-WARNING: index " << YamlBB.Index
-               << " is out of bounds\n";
+               << (IsStale ? " has no matching block\n"
+                           : " is out of bounds\n");
       ++MismatchedBlocks;
       continue;
     }
+    MatchedBlockCount += BlockCount;
 
-    BinaryBasicBlock &BB = *DFSOrder[YamlBB.Index];
+    BinaryBasicBlock &BB = *getProfiledBlock(YamlBB.Index);
 
     // Basic samples profile (without LBR) does not have branches information
     // and needs a special processing.
@@ -194,14 +274,14 @@ bool YAMLProfileReader::parseFunctionProfile(
     }
 
     for (const yaml::bolt::SuccessorInfo &YamlSI : YamlBB.Successors) {
-      if (YamlSI.Index >= DFSOrder.size()) {
+      if (!getProfiledBlock(YamlSI.Index)) {
         if (opts::Verbosity >= 1)
           errs() << "BOLT-WARNING: index out of bounds for profiled block\n";
         ++MismatchedEdges;
         continue;
       }
 
-      BinaryBasicBlock &SuccessorBB = *DFSOrder[YamlSI.Index];
+      BinaryBasicBlock &SuccessorBB = *getProfiledBlock(YamlSI.Index);
       if (!BB.getSuccessor(SuccessorBB.getLabel())) {
         if (opts::Verbosity >= 1)
           errs() << "BOLT-WARNING: no successor for block " << BB.getName()
@@ -229,6 +309,15 @@ bool YAMLProfileReader::parseFunctionProfile(
 
   ProfileMatched &= !MismatchedBlocks && !MismatchedCalls && !MismatchedEdges;
 
+  // A stale profile is used as long as most of its samples were attributed,
+  // even if some blocks, calls or edges did not match.
+  if (IsStale && TotalBlockCount &&
+      MatchedBlockCount * 100 >=
+          TotalBlockCount * opts::StaleMatchingMinMatchedBlock) {
+    ++NumStaleProfiles;
+    ProfileMatched = true;
+  }
+
   if (ProfileMatched)
     BF.markProfiled(YamlBP.Header.Flags);
 
@@ -411,6 +500,10 @@ Error YAMLProfileReader::readProfile(BinaryContext &BC) {
 
   BC.setNumUnusedProfiledObjects(NumUnused);
 
+  if (opts::InferStaleProfile)
+    outs() << "BOLT-INFO: inferred profile for " << NumStaleProfiles
+           << " functions that changed since profiling\n";
+
   return Error::success();
 }
 
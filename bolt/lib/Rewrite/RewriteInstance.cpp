@@ -76,6 +76,7 @@ extern cl::list<std::string> HotTextMoveSections;
 extern cl::opt<bool> Hugify;
 extern cl::opt<bool> Instrument;
 extern cl::opt<JumpTableSupportLevel> JumpTables;
+extern cl::opt<bool> NoScan;
 extern cl::list<std::string> ReorderData;
 extern cl::opt<bolt::ReorderFunctions::ReorderType> ReorderFunctions;
 extern cl::opt<bool> TimeBuild;
@@ -795,6 +796,14 @@ Error RewriteInstance::run() {
   if (opts::DiffOnly)
     return Error::success();
 
+  if (opts::PrintCacheMetrics) {
+    std::vector<BinaryFunction *> Functions;
+    for (auto &BFI : BC->getBinaryFunctions())
+      Functions.push_back(&BFI.second);
+    outs() << "BOLT-INFO: cache metrics of the input binary:\n";
+    CacheMetrics::printInput(Functions);
+  }
+
   runOptimizationPasses();
 
   emitAndLink();
@@ -2732,6 +2741,8 @@ void RewriteInstance::selectFunctionsToProcess() {
     return true;
   };
 
+  uint64_t TotalSize = 0;
+  uint64_t SizeToProcess = 0;
   for (auto &BFI : BC->getBinaryFunctions()) {
     BinaryFunction &Function = BFI.second;
 
@@ -2742,16 +2753,28 @@ void RewriteInstance::selectFunctionsToProcess() {
       continue;
     }
 
+    TotalSize += Function.getSize();
     if (!shouldProcess(Function)) {
       LLVM_DEBUG(dbgs() << "BOLT-INFO: skipping processing of function "
                         << Function << " per user request\n");
       Function.setIgnored();
     } else {
       ++NumFunctionsToProcess;
+      SizeToProcess += Function.getSize();
       if (opts::MaxFunctions && NumFunctionsToProcess == opts::MaxFunctions)
         outs() << "BOLT-INFO: processing ending on " << Function << '\n';
     }
   }
+
+  // Functions that are not processed are neither disassembled nor moved. They
+  // are only scanned for references to the functions that are, unless
+  // -no-scan is given.
+  if (opts::Lite && TotalSize)
+    outs() << "BOLT-INFO: lite mode: processing " << NumFunctionsToProcess
+           << " functions with "
+           << format("%.1f%%", 100.0 * SizeToProcess / TotalSize)
+           << " of the code, "
+           << (opts::NoScan ? "leaving" : "scanning") << " the rest\n";
 }
 
 void RewriteInstance::readDebugInfo() {
@@ -3832,7 +3855,20 @@ void RewriteInstance::mapExtraSections(RuntimeDyld &RTDyld) {
 }
 
 void RewriteInstance::updateOutputValues(const MCAsmLayout &Layout) {
-  for (BinaryFunction *Function : BC->getAllBinaryFunctions())
+  // Lay out every section up front. Queries for symbol offsets then only read
+  // the layout, and the functions can be updated in parallel.
+  for (MCSection *Section : Layout.getSectionOrder())
+    if (!Section->getFragmentList().empty())
+      Layout.getFragmentOffset(&Section->getFragmentList().back());
+
+  ParallelUtilities::WorkFuncTy WorkFun = [&](BinaryFunction &Function) {
+    Function.updateOutputValues(Layout);
+  };
+  ParallelUtilities::runOnEachFunction(
+      *BC, ParallelUtilities::SchedulingPolicy::SP_TRIVIAL, WorkFun,
+      /*SkipPredicate=*/nullptr, "updateOutputValues");
+
+  for (BinaryFunction *Function : BC->getInjectedBinaryFunctions())
     Function->updateOutputValues(Layout);
 }
 
@@ -40,7 +40,9 @@
 #include "clang/Tooling/ReplacementsYaml.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
+#include <mutex>
 #include <utility>
 
 #if CLANG_TIDY_ENABLE_STATIC_ANALYZER
@@ -509,13 +511,11 @@ getCheckOptions(const ClangTidyOptions &Options,
   return Factory.getCheckOptions();
 }
 
-std::vector<ClangTidyError>
-runClangTidy(clang::tidy::ClangTidyContext &Context,
-             const CompilationDatabase &Compilations,
-             ArrayRef<std::string> InputFiles,
-             llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
-             bool ApplyAnyFix, bool EnableCheckProfile,
-             llvm::StringRef StoreCheckProfile) {
+static std::vector<ClangTidyError> runClangTidyOnFiles(
+    ClangTidyContext &Context, const CompilationDatabase &Compilations,
+    ArrayRef<std::string> InputFiles,
+    llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+    bool RemoveIncompatibleErrors, bool ApplyAnyFix) {
   ClangTool Tool(Compilations, InputFiles,
                  std::make_shared<PCHContainerOperations>(), BaseFS);
 
@@ -539,10 +539,9 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
 
   Tool.appendArgumentsAdjuster(PerFileExtraArgumentsInserter);
   Tool.appendArgumentsAdjuster(getStripPluginsAdjuster());
-  Context.setEnableProfiling(EnableCheckProfile);
-  Context.setProfileStoragePrefix(StoreCheckProfile);
 
-  ClangTidyDiagnosticConsumer DiagConsumer(Context, nullptr, true, ApplyAnyFix);
+  ClangTidyDiagnosticConsumer DiagConsumer(Context, nullptr,
+                                           RemoveIncompatibleErrors, ApplyAnyFix);
   DiagnosticsEngine DE(new DiagnosticIDs(), new DiagnosticOptions(),
                        &DiagConsumer, /*ShouldOwnClient=*/false);
   Context.setDiagnosticsEngine(&DE);
@@ -588,6 +587,87 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   return DiagConsumer.take();
 }
 
+namespace {
+/// Forwards to the options provider of the main context, for the contexts of
+/// translation units that are processed in parallel.
+class SharedOptionsProvider : public ClangTidyOptionsProvider {
+public:
+  SharedOptionsProvider(ClangTidyOptionsProvider &Provider, std::mutex &Mutex)
+      : Provider(Provider), Mutex(Mutex) {}
+
+  const ClangTidyGlobalOptions &getGlobalOptions() override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Provider.getGlobalOptions();
+  }
+
+  std::vector<OptionsSource> getRawOptions(llvm::StringRef FileName) override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Provider.getRawOptions(FileName);
+  }
+
+private:
+  ClangTidyOptionsProvider &Provider;
+  std::mutex &Mutex;
+};
+} // namespace
+
+static bool isRealFileSystem(const llvm::vfs::OverlayFileSystem &FS) {
+  auto It = FS.overlays_begin();
+  return It != FS.overlays_end() && std::next(It) == FS.overlays_end() &&
+         *It == llvm::vfs::getRealFileSystem();
+}
+
+std::vector<ClangTidyError>
+runClangTidy(clang::tidy::ClangTidyContext &Context,
+             const CompilationDatabase &Compilations,
+             ArrayRef<std::string> InputFiles,
+             llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+             bool ApplyAnyFix, bool EnableCheckProfile,
+             llvm::StringRef StoreCheckProfile, unsigned Jobs) {
+  Context.setEnableProfiling(EnableCheckProfile);
+  Context.setProfileStoragePrefix(StoreCheckProfile);
+
+  // The real file system changes the working directory of the process for
+  // each translation unit, and other file systems keep a single one.
+  if (Jobs == 1 || InputFiles.size() < 2 || EnableCheckProfile ||
+      !isRealFileSystem(*BaseFS))
+    return runClangTidyOnFiles(Context, Compilations, InputFiles,
+                               std::move(BaseFS),
+                               /*RemoveIncompatibleErrors=*/true, ApplyAnyFix);
+
+  std::mutex OptionsMutex;
+  std::vector<std::vector<ClangTidyError>> FileErrors(InputFiles.size());
+  std::vector<ClangTidyStats> FileStats(InputFiles.size());
+  {
+    llvm::ThreadPool Pool(llvm::hardware_concurrency(Jobs));
+    for (size_t I = 0, E = InputFiles.size(); I != E; ++I) {
+      Pool.async([&, I]() {
+        ClangTidyContext FileContext(
+            std::make_unique<SharedOptionsProvider>(
+                Context.getOptionsProvider(), OptionsMutex),
+            Context.canEnableAnalyzerAlphaCheckers());
+        // Give each translation unit its own working directory.
+        llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> FS(
+            new llvm::vfs::OverlayFileSystem(
+                llvm::vfs::createPhysicalFileSystem()));
+        FileErrors[I] = runClangTidyOnFiles(
+            FileContext, Compilations, InputFiles[I], std::move(FS),
+            /*RemoveIncompatibleErrors=*/false, ApplyAnyFix);
+        FileStats[I] = FileContext.getStats();
+      });
+    }
+  }
+
+  // Merge the results in the order of the input files, and remove the
+  // conflicting fixes across all of them, as when running serially.
+  ClangTidyDiagnosticConsumer DiagConsumer(Context, nullptr, true, ApplyAnyFix);
+  for (size_t I = 0, E = InputFiles.size(); I != E; ++I) {
+    DiagConsumer.addFilteredErrors(std::move(FileErrors[I]));
+    Context.addStats(FileStats[I]);
+  }
+  return DiagConsumer.take();
+}
+
 void handleErrors(llvm::ArrayRef<ClangTidyError> Errors,
                   ClangTidyContext &Context, FixBehaviour Fix,
                   unsigned &WarningsAsErrorsCount,
@@ -74,13 +74,19 @@ getCheckOptions(const ClangTidyOptions &Options,
 /// \param StoreCheckProfile If provided, and EnableCheckProfile is true,
 /// the profile will not be output to stderr, but will instead be stored
 /// as a JSON file in the specified directory.
+///
+/// Up to \p Jobs translation units are processed in parallel, all of them
+/// if \p Jobs is 0. The translation units are processed one at a time when
+/// profiling, or when \p BaseFS is not just the real file system, as their
+/// working directories would conflict.
 std::vector<ClangTidyError>
 runClangTidy(clang::tidy::ClangTidyContext &Context,
              const tooling::CompilationDatabase &Compilations,
              ArrayRef<std::string> InputFiles,
              llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
              bool ApplyAnyFix, bool EnableCheckProfile = false,
-             llvm::StringRef StoreCheckProfile = StringRef());
+             llvm::StringRef StoreCheckProfile = StringRef(),
+             unsigned Jobs = 1);
 
 /// Controls what kind of fixes clang-tidy is allowed to apply.
 enum FixBehaviour {
@@ -295,7 +295,7 @@ ClangTidyDiagnosticConsumer::ClangTidyDiagnosticConsumer(
       LastErrorPassesLineFilter(false), LastErrorWasIgnored(false) {}
 
 void ClangTidyDiagnosticConsumer::finalizeLastError() {
-  if (!Errors.empty()) {
+  if (Errors.size() > NumFilteredErrors) {
     ClangTidyError &Error = Errors.back();
     if (Error.DiagnosticName == "clang-tidy-config") {
       // Never ignore these.
@@ -729,9 +729,17 @@ std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
                Errors.end());
   if (RemoveIncompatibleErrors)
     removeIncompatibleErrors();
+  NumFilteredErrors = 0;
   return std::move(Errors);
 }
 
+void ClangTidyDiagnosticConsumer::addFilteredErrors(
+    std::vector<ClangTidyError> NewErrors) {
+  finalizeLastError();
+  llvm::move(NewErrors, std::back_inserter(Errors));
+  NumFilteredErrors = Errors.size();
+}
+
 namespace {
 struct LessClangTidyErrorWithoutDiagnosticName {
   bool operator()(const ClangTidyError *LHS, const ClangTidyError *RHS) const {
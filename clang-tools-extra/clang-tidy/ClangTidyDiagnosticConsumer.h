@@ -52,6 +52,15 @@ struct ClangTidyStats {
     return ErrorsIgnoredNOLINT + ErrorsIgnoredCheckFilter +
            ErrorsIgnoredNonUserCode + ErrorsIgnoredLineFilter;
   }
+
+  ClangTidyStats &operator+=(const ClangTidyStats &Other) {
+    ErrorsDisplayed += Other.ErrorsDisplayed;
+    ErrorsIgnoredCheckFilter += Other.ErrorsIgnoredCheckFilter;
+    ErrorsIgnoredNOLINT += Other.ErrorsIgnoredNOLINT;
+    ErrorsIgnoredNonUserCode += Other.ErrorsIgnoredNonUserCode;
+    ErrorsIgnoredLineFilter += Other.ErrorsIgnoredLineFilter;
+    return *this;
+  }
 };
 
 /// Every \c ClangTidyCheck reports errors through a \c DiagnosticsEngine
@@ -162,6 +171,15 @@ public:
   /// counters.
   const ClangTidyStats &getStats() const { return Stats; }
 
+  /// Adds the statistics of another context, e.g. one that processed a
+  /// translation unit in parallel with this one.
+  void addStats(const ClangTidyStats &Other) { Stats += Other; }
+
+  /// Returns the options provider, so that other contexts can share it.
+  ClangTidyOptionsProvider &getOptionsProvider() const {
+    return *OptionsProvider;
+  }
+
   /// Control profile collection in clang-tidy.
   void setEnableProfiling(bool Profile);
   bool getEnableProfiling() const { return Profile; }
@@ -256,6 +274,11 @@ public:
   // Retrieve the diagnostics that were captured.
   std::vector<ClangTidyError> take();
 
+  // Add diagnostics that another consumer captured and filtered already, e.g.
+  // for a translation unit processed in parallel. take() deduplicates them
+  // and removes incompatible fixes together with the ones of this consumer.
+  void addFilteredErrors(std::vector<ClangTidyError> NewErrors);
+
 private:
   void finalizeLastError();
   void removeIncompatibleErrors();
@@ -278,6 +301,9 @@ private:
   bool GetFixesFromNotes;
   bool EnableNolintBlocks;
   std::vector<ClangTidyError> Errors;
+  // The number of errors from addFilteredErrors(), which finalizeLastError()
+  // must not filter again.
+  size_t NumFilteredErrors = 0;
   std::unique_ptr<llvm::Regex> HeaderFilter;
   bool LastErrorRelatesToUserCode;
   bool LastErrorPassesLineFilter;
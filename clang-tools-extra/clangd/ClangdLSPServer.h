@@ -18,6 +18,7 @@
 #include "support/MemoryTree.h"
 #include "support/Path.h"
 #include "support/Threading.h"
+#include "support/Trace.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/Support/JSON.h"
 #include <chrono>
@@ -59,6 +60,10 @@ public:
 
     /// Limit the number of references returned (0 means no limit).
     size_t ReferencesLimit = 0;
+
+    /// If set, the summaries of its metrics are provided by the
+    /// $/clangd/metrics extension.
+    const trace::MetricsRegistry *Metrics = nullptr;
   };
 
   ClangdLSPServer(Transport &Transp, const ThreadsafeFS &TFS,
@@ -158,6 +163,8 @@ private:
   /// This is a clangd extension. Provides a json tree representing memory usage
   /// hierarchy.
   void onMemoryUsage(const NoParams &, Callback<MemoryTree>);
+  void onMetrics(const NoParams &,
+                 Callback<std::vector<trace::MetricsRegistry::Summary>>);
   void onCommand(const ExecuteCommandParams &, Callback<llvm::json::Value>);
 
   /// Implement commands.
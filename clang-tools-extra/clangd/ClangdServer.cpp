@@ -137,6 +137,7 @@ ClangdServer::Options::operator TUScheduler::Options() const {
   Opts.AsyncThreadsCount = AsyncThreadsCount;
   Opts.RetentionPolicy = RetentionPolicy;
   Opts.StorePreamblesInMemory = StorePreamblesInMemory;
+  Opts.SharePreambles = SharePreambles;
   Opts.UpdateDebounce = UpdateDebounce;
   Opts.ContextProvider = ContextProvider;
   return Opts;
@@ -148,7 +149,9 @@ ClangdServer::ClangdServer(const GlobalCompilationDatabase &CDB,
     : FeatureModules(Opts.FeatureModules), CDB(CDB), TFS(TFS),
       DynamicIdx(Opts.BuildDynamicSymbolIndex ? new FileIndex() : nullptr),
       ClangTidyProvider(Opts.ClangTidyProvider),
-      UseDirtyHeaders(Opts.UseDirtyHeaders), WorkspaceRoot(Opts.WorkspaceRoot),
+      UseDirtyHeaders(Opts.UseDirtyHeaders),
+      ReuseCompletionResults(Opts.ReuseCompletionResults),
+      WorkspaceRoot(Opts.WorkspaceRoot),
       Transient(Opts.ImplicitCancellation ? TUScheduler::InvalidateOnUpdate
                                           : TUScheduler::NoInvalidation),
       DirtyFS(std::make_unique<DraftStoreFS>(TFS, DraftMgr)) {
@@ -331,6 +334,8 @@ ClangdServer::createConfiguredContextProvider(const config::Provider *Provider,
 void ClangdServer::removeDocument(PathRef File) {
   DraftMgr.removeDraft(File);
   WorkScheduler->remove(File);
+  std::lock_guard<std::mutex> Lock(CompletionSessionMutex);
+  CompletionSessionByFile.erase(File);
 }
 
 void ClangdServer::codeComplete(PathRef File, Position Pos,
@@ -369,11 +374,21 @@ void ClangdServer::codeComplete(PathRef File, Position Pos,
 
     CodeCompleteOpts.MainFileSignals = IP->Signals;
     CodeCompleteOpts.AllScopes = Config::current().Completion.AllScopes;
+    std::shared_ptr<const CompletionSession> Session;
+    if (ReuseCompletionResults) {
+      std::lock_guard<std::mutex> Lock(CompletionSessionMutex);
+      Session = CompletionSessionByFile.lookup(File);
+    }
     // FIXME(ibiryukov): even if Preamble is non-null, we may want to check
     // both the old and the new version in case only one of them matches.
     CodeCompleteResult Result = clangd::codeComplete(
         File, Pos, IP->Preamble, ParseInput, CodeCompleteOpts,
-        SpecFuzzyFind ? SpecFuzzyFind.getPointer() : nullptr);
+        SpecFuzzyFind ? SpecFuzzyFind.getPointer() : nullptr,
+        ReuseCompletionResults ? &Session : nullptr);
+    if (ReuseCompletionResults) {
+      std::lock_guard<std::mutex> Lock(CompletionSessionMutex);
+      CompletionSessionByFile[File] = std::move(Session);
+    }
     {
       clang::clangd::trace::Span Tracer("Completion results callback");
       CB(std::move(Result));
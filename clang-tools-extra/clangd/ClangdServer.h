@@ -104,6 +104,10 @@ public:
     /// Cached preambles are potentially large. If false, store them on disk.
     bool StorePreamblesInMemory = true;
 
+    /// Share a single preamble between files with the same preamble section,
+    /// directory and compile flags.
+    bool SharePreambles = false;
+
     /// If true, ClangdServer builds a dynamic in-memory index for symbols in
     /// opened files and uses the index to augment code completion results.
     bool BuildDynamicSymbolIndex = false;
@@ -164,6 +168,10 @@ public:
     /// If true, use the dirty buffer contents when building Preambles.
     bool UseDirtyHeaders = false;
 
+    /// Answer code completion requests that extend the identifier of the
+    /// previous request in the same file by refiltering its results.
+    bool ReuseCompletionResults = false;
+
     explicit operator TUScheduler::Options() const;
   };
   // Sensible default options for use in tests.
@@ -421,6 +429,12 @@ private:
       CachedCompletionFuzzyFindRequestByFile;
   mutable std::mutex CachedCompletionFuzzyFindRequestMutex;
 
+  bool ReuseCompletionResults = false;
+  // GUARDED_BY(CompletionSessionMutex)
+  llvm::StringMap<std::shared_ptr<const CompletionSession>>
+      CompletionSessionByFile;
+  mutable std::mutex CompletionSessionMutex;
+
   llvm::Optional<std::string> WorkspaceRoot;
   llvm::Optional<TUScheduler> WorkScheduler;
   // Invalidation policy used for actions that we assume are "transient".
@@ -1998,16 +1998,97 @@ maybeFunctionArgumentCommentStart(llvm::StringRef Content) {
   return None;
 }
 
-CodeCompleteResult codeComplete(PathRef FileName, Position Pos,
-                                const PreambleData *Preamble,
-                                const ParseInputs &ParseInput,
-                                CodeCompleteOptions Opts,
-                                SpeculativeFuzzyFind *SpecFuzzyFind) {
+namespace {
+// Answers a completion request from the results of a previous one, if the
+// request is at the same completion point and the user only typed more of the
+// identifier since then. Returns the results matching the new filter, which
+// are all the results of the request, and narrows Session->Result down to
+// them.
+llvm::Optional<CodeCompleteResult>
+reuseCompletionSession(CompletionSession &Session, llvm::StringRef Content,
+                       size_t Offset, const PreambleData &Preamble,
+                       const CodeCompleteOptions &Opts) {
+  if (Session.PreambleVersion != Preamble.Version)
+    return None;
+  llvm::StringRef Filter = guessCompletionPrefix(Content, Offset).Name;
+  size_t Start = Offset - Filter.size();
+  if (Session.Offset - Session.Filter.size() != Start ||
+      !Filter.startswith(Session.Filter) ||
+      Content.take_front(Start) !=
+          llvm::StringRef(Session.Contents).take_front(Start) ||
+      Content.drop_front(Offset) !=
+          llvm::StringRef(Session.Contents).drop_front(Session.Offset))
+    return None;
+
+  trace::Span Tracer("CodeCompleteFromSession");
+  // The identifier only has ASCII characters, so the positions after it move
+  // by as many UTF-16 code units as bytes were typed.
+  int Typed = Offset - Session.Offset;
+  auto Extend = [&](Range &R) { R.end.character += Typed; };
+  FuzzyMatcher Matcher(Filter);
+  std::vector<CodeCompletion> Matches;
+  for (CodeCompletion &C : Session.Result.Completions) {
+    // Macros are only prefix-matched, see CodeCompleteFlow::fuzzyScore().
+    if (C.Kind == CompletionItemKind::Text &&
+        !llvm::StringRef(C.Name).startswith_insensitive(Filter))
+      continue;
+    auto NameMatch = Matcher.match(C.Name);
+    if (!NameMatch)
+      continue;
+    // NameMatch is a multiplier on the total score of both ranking models.
+    C.Score.Total = C.Score.ExcludingName * *NameMatch;
+    Extend(C.CompletionTokenRange);
+    Matches.push_back(std::move(C));
+  }
+  llvm::sort(Matches, [](const CodeCompletion &L, const CodeCompletion &R) {
+    if (L.Score.Total != R.Score.Total)
+      return L.Score.Total > R.Score.Total;
+    return L.Name < R.Name;
+  });
+
+  Session.Contents = Content.str();
+  Session.Offset = Offset;
+  Session.Filter = Filter.str();
+  Session.Result.Completions = std::move(Matches);
+  if (Session.Result.CompletionRange)
+    Extend(*Session.Result.CompletionRange);
+
+  CodeCompleteResult Output = Session.Result;
+  if (Opts.Limit && Output.Completions.size() > Opts.Limit) {
+    Output.Completions.resize(Opts.Limit);
+    Output.HasMore = true;
+  }
+  SPAN_ATTACH(Tracer, "returned_results", int64_t(Output.Completions.size()));
+  log("Code complete: {0} results from the completion session, {1} returned.",
+      Session.Result.Completions.size(), Output.Completions.size());
+  return Output;
+}
+} // namespace
+
+CodeCompleteResult
+codeComplete(PathRef FileName, Position Pos, const PreambleData *Preamble,
+             const ParseInputs &ParseInput, CodeCompleteOptions Opts,
+             SpeculativeFuzzyFind *SpecFuzzyFind,
+             std::shared_ptr<const CompletionSession> *Session) {
   auto Offset = positionToOffset(ParseInput.Contents, Pos);
   if (!Offset) {
     elog("Code completion position was invalid {0}", Offset.takeError());
     return CodeCompleteResult();
   }
+  // Sessions are only kept for results from Sema, which are the slow ones.
+  bool UseSession = Session && Preamble &&
+                    Opts.RunParser != CodeCompleteOptions::NeverParse &&
+                    !Opts.RecordCCResult;
+  if (UseSession && *Session) {
+    auto Reused = std::make_shared<CompletionSession>(**Session);
+    if (auto Output = reuseCompletionSession(*Reused, ParseInput.Contents,
+                                             *Offset, *Preamble, Opts)) {
+      *Session = std::move(Reused);
+      return std::move(*Output);
+    }
+  }
+  if (Session)
+    Session->reset();
 
   auto Content = llvm::StringRef(ParseInput.Contents).take_front(*Offset);
   if (auto OffsetBeforeComment = maybeFunctionArgumentCommentStart(Content)) {
@@ -2024,14 +2105,28 @@ CodeCompleteResult codeComplete(PathRef FileName, Position Pos,
   auto Flow = CodeCompleteFlow(
       FileName, Preamble ? Preamble->Includes : IncludeStructure(),
       SpecFuzzyFind, Opts);
-  return (!Preamble || Opts.RunParser == CodeCompleteOptions::NeverParse)
-             ? std::move(Flow).runWithoutSema(ParseInput.Contents, *Offset,
-                                              *ParseInput.TFS)
-             : std::move(Flow).run({FileName, *Offset, *Preamble,
-                                    /*PreamblePatch=*/
-                                    PreamblePatch::createMacroPatch(
-                                        FileName, ParseInput, *Preamble),
-                                    ParseInput});
+  CodeCompleteResult Output =
+      (!Preamble || Opts.RunParser == CodeCompleteOptions::NeverParse)
+          ? std::move(Flow).runWithoutSema(ParseInput.Contents, *Offset,
+                                           *ParseInput.TFS)
+          : std::move(Flow).run({FileName, *Offset, *Preamble,
+                                 /*PreamblePatch=*/
+                                 PreamblePatch::createMacroPatch(
+                                     FileName, ParseInput, *Preamble),
+                                 ParseInput});
+  // Results that were cut off can't be refiltered, candidates that didn't
+  // make it may rank higher with a longer filter.
+  if (UseSession && Output.RanParser && !Output.HasMore) {
+    auto NewSession = std::make_shared<CompletionSession>();
+    NewSession->Contents = ParseInput.Contents;
+    NewSession->Offset = *Offset;
+    NewSession->Filter =
+        guessCompletionPrefix(ParseInput.Contents, *Offset).Name.str();
+    NewSession->PreambleVersion = Preamble->Version;
+    NewSession->Result = Output;
+    *Session = std::move(NewSession);
+  }
+  return Output;
 }
 
 SignatureHelp signatureHelp(PathRef FileName, Position Pos,
@@ -31,6 +31,7 @@
 #include "llvm/ADT/StringRef.h"
 #include <functional>
 #include <future>
+#include <memory>
 
 namespace clang {
 class NamedDecl;
@@ -261,6 +262,23 @@ struct SpeculativeFuzzyFind {
   std::future<SymbolSlab> Result;
 };
 
+/// The results of a completion request, kept to answer the following requests
+/// at the same completion point while the user keeps typing the identifier.
+/// As the typed prefix grows, the candidates can only get fewer, so when the
+/// cached results were complete they are refiltered and rescored locally
+/// instead of running Sema and querying the index again.
+struct CompletionSession {
+  /// The contents of the file and the cursor offset of the cached request.
+  std::string Contents;
+  size_t Offset = 0;
+  /// The identifier being completed, which ends at Offset.
+  std::string Filter;
+  /// Version of the preamble the results were computed with.
+  std::string PreambleVersion;
+  /// All the results matching Filter. HasMore is always false.
+  CodeCompleteResult Result;
+};
+
 /// Gets code completions at a specified \p Pos in \p FileName.
 ///
 /// If \p Preamble is nullptr, this runs code completion without compiling the
@@ -271,11 +289,16 @@ struct SpeculativeFuzzyFind {
 /// the speculative result is used by code completion (e.g. speculation failed),
 /// the speculative result is not consumed, and `SpecFuzzyFind` is only
 /// destroyed when the async request finishes.
-CodeCompleteResult codeComplete(PathRef FileName, Position Pos,
-                                const PreambleData *Preamble,
-                                const ParseInputs &ParseInput,
-                                CodeCompleteOptions Opts,
-                                SpeculativeFuzzyFind *SpecFuzzyFind = nullptr);
+///
+/// If \p Session is set, the results of the completion session it points to
+/// are reused when the request only extends the identifier they were computed
+/// for, and it is updated to the session of this request. It may point to
+/// null, and is reset to null when the results can't be reused later on.
+CodeCompleteResult
+codeComplete(PathRef FileName, Position Pos, const PreambleData *Preamble,
+             const ParseInputs &ParseInput, CodeCompleteOptions Opts,
+             SpeculativeFuzzyFind *SpecFuzzyFind = nullptr,
+             std::shared_ptr<const CompletionSession> *Session = nullptr);
 
 /// Get signature help at a specified \p Pos in \p FileName.
 SignatureHelp signatureHelp(PathRef FileName, Position Pos,
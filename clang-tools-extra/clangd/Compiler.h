@@ -39,7 +39,9 @@ public:
 
 // Options to run clang e.g. when parsing AST.
 struct ParseOptions {
-  // (empty at present, formerly controlled recovery AST, include-fixer etc)
+  // Whether the AST should carry diagnostics for the main file. Without them,
+  // neither clang-tidy checks nor the include-fixer run during the build.
+  bool PreserveDiagnostics = true;
 };
 
 /// Information required to run clang, e.g. to parse AST or do code completion.
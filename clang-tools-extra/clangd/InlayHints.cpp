@@ -212,6 +212,15 @@ public:
     StructuredBindingPolicy.PrintCanonicalTypes = true;
   }
 
+  bool TraverseDecl(Decl *D) {
+    // The hints of a declaration are all within its range. Clients usually ask
+    // for the visible part of the file, and there's no need to traverse the
+    // rest of it.
+    if (D && RestrictRange && !mayHaveHintsInRange(D->getSourceRange()))
+      return true;
+    return RecursiveASTVisitor<InlayHintVisitor>::TraverseDecl(D);
+  }
+
   bool VisitCXXConstructExpr(CXXConstructExpr *E) {
     // Weed out constructor calls that don't look like a function call with
     // an argument list, by checking the validity of getParenOrBraceRange().
@@ -567,6 +576,19 @@ private:
         InlayHint{LSPPos, LSPRange, Kind, (Prefix + Label + Suffix).str()});
   }
 
+  // Whether hints positioned within \p R can be in RestrictRange. This is
+  // conservatively true if R isn't a range of the main file.
+  bool mayHaveHintsInRange(SourceRange R) {
+    const SourceManager &SM = AST.getSourceManager();
+    auto FileRange = toHalfOpenFileRange(SM, AST.getLangOpts(), R);
+    if (!FileRange || !SM.isWrittenInMainFile(FileRange->getBegin()))
+      return true;
+    return sourceLocToPosition(SM, FileRange->getBegin()) <
+               RestrictRange->end &&
+           !(sourceLocToPosition(SM, FileRange->getEnd()) <
+             RestrictRange->start);
+  }
+
   void addTypeHint(SourceRange R, QualType T, llvm::StringRef Prefix) {
     addTypeHint(R, T, Prefix, TypeHintPolicy);
   }
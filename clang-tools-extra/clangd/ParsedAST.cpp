@@ -25,6 +25,7 @@
 #include "TidyProvider.h"
 #include "index/CanonicalIncludes.h"
 #include "index/Index.h"
+#include "support/Cancellation.h"
 #include "support/Logger.h"
 #include "support/Trace.h"
 #include "clang/AST/ASTContext.h"
@@ -87,7 +88,9 @@ public:
 
       TopLevelDecls.push_back(D);
     }
-    return true;
+    // Stop parsing if the build was cancelled, e.g. by a newer edit. This is
+    // the finest point clang lets us abandon the parse at.
+    return !isCancelled();
   }
 
 private:
@@ -317,18 +320,18 @@ ParsedAST::build(llvm::StringRef Filename, const ParseInputs &Inputs,
       });
 
   llvm::Optional<PreamblePatch> Patch;
-  bool PreserveDiags = true;
-  // We might use an ignoring diagnostic consumer if they are going to be
-  // dropped later on to not pay for extra latency by processing them.
-  DiagnosticConsumer *DiagConsumer = &ASTDiags;
-  IgnoreDiagnostics DropDiags;
+  bool PreserveDiags = Inputs.Opts.PreserveDiagnostics;
   if (Preamble) {
     Patch = PreamblePatch::createFullPatch(Filename, Inputs, *Preamble);
     Patch->apply(*CI);
-    PreserveDiags = Patch->preserveDiagnostics();
-    if (!PreserveDiags)
-      DiagConsumer = &DropDiags;
+    PreserveDiags &= Patch->preserveDiagnostics();
   }
+  // We might use an ignoring diagnostic consumer if they are going to be
+  // dropped later on to not pay for extra latency by processing them.
+  DiagnosticConsumer *DiagConsumer = &ASTDiags;
+  IgnoreDiagnostics DropDiags;
+  if (!PreserveDiags)
+    DiagConsumer = &DropDiags;
   auto Clang = prepareCompilerInstance(
       std::move(CI), PreamblePCH,
       llvm::MemoryBuffer::getMemBufferCopy(Inputs.Contents, Filename), VFS,
@@ -557,6 +560,13 @@ ParsedAST::build(llvm::StringRef Filename, const ParseInputs &Inputs,
   // tokens from running the preprocessor inside the checks (only
   // modernize-use-trailing-return-type does that today).
   syntax::TokenBuffer Tokens = std::move(CollectTokens).consume();
+  if (isCancelled()) {
+    // The parse was abandoned half-way, the AST is incomplete.
+    vlog("Cancelled AST build for {0}", MainInput.getFile());
+    Clang->getDiagnostics().setClient(new IgnoreDiagnostics);
+    Action->EndSourceFile();
+    return None;
+  }
   // Makes SelectionTree build much faster.
   Tokens.indexExpandedTokens();
   std::vector<Decl *> ParsedDecls = Action->takeTopLevelDecls();
@@ -38,6 +38,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
@@ -62,6 +63,34 @@ bool compileCommandsAreEqual(const tooling::CompileCommand &LHS,
          llvm::makeArrayRef(LHS.CommandLine).equals(RHS.CommandLine);
 }
 
+// The command line of \p Cmd without the main file and the output, which do
+// not affect its preamble.
+std::vector<llvm::StringRef>
+commandLineWithoutFile(const tooling::CompileCommand &Cmd) {
+  std::vector<llvm::StringRef> Result;
+  for (size_t I = 0; I < Cmd.CommandLine.size(); ++I) {
+    llvm::StringRef Arg = Cmd.CommandLine[I];
+    if (Arg == "-o") {
+      ++I;
+      continue;
+    }
+    if (Arg == Cmd.Filename)
+      continue;
+    Result.push_back(Arg);
+  }
+  return Result;
+}
+
+// Quoted includes are looked up next to the main file first, so files can
+// only share a preamble with files of the same directory.
+std::string mainFileDirectory(const tooling::CompileCommand &Cmd) {
+  llvm::SmallString<256> Path(Cmd.Filename);
+  llvm::sys::fs::make_absolute(Cmd.Directory, Path);
+  llvm::sys::path::remove_dots(Path, /*remove_dot_dot=*/true);
+  llvm::sys::path::remove_filename(Path);
+  return std::string(Path.str());
+}
+
 class CppFilePreambleCallbacks : public PreambleCallbacks {
 public:
   CppFilePreambleCallbacks(PathRef File, PreambleParsedCallback ParsedCallback)
@@ -418,6 +447,37 @@ bool isPreambleCompatible(const PreambleData &Preamble,
          Preamble.Preamble.CanReuse(CI, *ContentsBuffer, Bounds, *VFS);
 }
 
+llvm::hash_code sharedPreambleKey(const ParseInputs &Inputs,
+                                  const CompilerInvocation &CI) {
+  auto ContentsBuffer =
+      llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, "", false);
+  auto Bounds = ComputePreambleBounds(*CI.getLangOpts(), *ContentsBuffer, 0);
+  std::vector<llvm::StringRef> CommandLine =
+      commandLineWithoutFile(Inputs.CompileCommand);
+  return llvm::hash_combine(
+      mainFileDirectory(Inputs.CompileCommand), Inputs.CompileCommand.Directory,
+      llvm::hash_combine_range(CommandLine.begin(), CommandLine.end()),
+      Inputs.Contents.substr(0, Bounds.Size));
+}
+
+bool isPreambleShareable(const PreambleData &Preamble,
+                         const ParseInputs &Inputs, PathRef FileName,
+                         const CompilerInvocation &CI) {
+  const tooling::CompileCommand &LHS = Inputs.CompileCommand;
+  const tooling::CompileCommand &RHS = Preamble.CompileCommand;
+  if (LHS.Directory != RHS.Directory ||
+      mainFileDirectory(LHS) != mainFileDirectory(RHS) ||
+      commandLineWithoutFile(LHS) != commandLineWithoutFile(RHS))
+    return false;
+  // CanReuse() checks that the preamble sections are the same, and that the
+  // headers did not change since the preamble was built.
+  auto ContentsBuffer =
+      llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+  auto Bounds = ComputePreambleBounds(*CI.getLangOpts(), *ContentsBuffer, 0);
+  auto VFS = Inputs.TFS->view(Inputs.CompileCommand.Directory);
+  return Preamble.Preamble.CanReuse(CI, *ContentsBuffer, Bounds, *VFS);
+}
+
 void escapeBackslashAndQuotes(llvm::StringRef Text, llvm::raw_ostream &OS) {
   for (char C : Text) {
     switch (C) {
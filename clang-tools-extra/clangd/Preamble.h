@@ -33,6 +33,7 @@
 #include "clang/Frontend/PrecompiledPreamble.h"
 #include "clang/Lex/Lexer.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringRef.h"
 
 #include <memory>
@@ -91,6 +92,20 @@ bool isPreambleCompatible(const PreambleData &Preamble,
                           const ParseInputs &Inputs, PathRef FileName,
                           const CompilerInvocation &CI);
 
+/// Returns a hash of everything a preamble depends on in \p Inputs, except for
+/// the name of the main file: its directory, the compile command and the
+/// preamble section of its contents. Files whose preambles can be shared, see
+/// isPreambleShareable(), have the same key.
+llvm::hash_code sharedPreambleKey(const ParseInputs &Inputs,
+                                  const CompilerInvocation &CI);
+
+/// Returns true if \p Preamble, built for another file in the same directory
+/// with the same compile flags and the same preamble section, can be used as
+/// is for \p Inputs.
+bool isPreambleShareable(const PreambleData &Preamble,
+                         const ParseInputs &Inputs, PathRef FileName,
+                         const CompilerInvocation &CI);
+
 /// Stores information required to parse a TU using a (possibly stale) Baseline
 /// preamble. Later on this information can be injected into the main file by
 /// updating compiler invocation with \c apply. This injected section
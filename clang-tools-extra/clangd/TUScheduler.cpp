@@ -84,6 +84,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -308,6 +309,61 @@ public:
   }
 };
 
+/// Lets open files with the same preamble share a single PreambleData, rather
+/// than each building their own. This is common for sibling files, e.g. the
+/// tests of a directory, that start with the same includes and are compiled
+/// with the same flags.
+///
+/// Only weak references are kept, a preamble is destroyed as soon as the last
+/// file using it moves on to another one.
+///
+/// All methods are threadsafe, they are called from the preamble threads.
+class TUScheduler::SharedPreambleCache {
+  std::mutex Mu;
+  // Keyed by sharedPreambleKey(). Candidates are checked with
+  // isPreambleShareable(), so collisions are harmless.
+  std::map<size_t, std::vector<std::weak_ptr<const PreambleData>>> Preambles;
+
+public:
+  /// Returns a preamble that was built for another file and can be used for
+  /// \p FileName as is, or null if there is none.
+  std::shared_ptr<const PreambleData> get(PathRef FileName,
+                                          const ParseInputs &Inputs,
+                                          const CompilerInvocation &CI) {
+    std::vector<std::shared_ptr<const PreambleData>> Candidates;
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      auto It = Preambles.find(sharedPreambleKey(Inputs, CI));
+      if (It == Preambles.end())
+        return nullptr;
+      for (const auto &Preamble : It->second)
+        if (auto Candidate = Preamble.lock())
+          Candidates.push_back(std::move(Candidate));
+    }
+    // isPreambleShareable() does IO, don't hold the lock.
+    for (auto &Candidate : Candidates)
+      if (isPreambleShareable(*Candidate, Inputs, FileName, CI))
+        return std::move(Candidate);
+    return nullptr;
+  }
+
+  /// Makes \p Preamble, built from \p Inputs, available to other files.
+  void put(const ParseInputs &Inputs, const CompilerInvocation &CI,
+           std::shared_ptr<const PreambleData> Preamble) {
+    size_t Key = sharedPreambleKey(Inputs, CI);
+    std::lock_guard<std::mutex> Lock(Mu);
+    // Drop the preambles that were destroyed since the last update.
+    for (auto It = Preambles.begin(); It != Preambles.end();) {
+      llvm::erase_if(It->second,
+                     [](const std::weak_ptr<const PreambleData> &P) {
+                       return P.expired();
+                     });
+      It = It->second.empty() ? Preambles.erase(It) : std::next(It);
+    }
+    Preambles[Key].push_back(std::move(Preamble));
+  }
+};
+
 namespace {
 
 bool isReliable(const tooling::CompileCommand &Cmd) {
@@ -357,10 +413,12 @@ public:
                  bool StorePreambleInMemory, bool RunSync,
                  SynchronizedTUStatus &Status,
                  TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                 TUScheduler::SharedPreambleCache *SharedPreambles,
                  ASTWorker &AW)
       : FileName(FileName), Callbacks(Callbacks),
         StoreInMemory(StorePreambleInMemory), RunSync(RunSync), Status(Status),
-        ASTPeer(AW), HeaderIncluders(HeaderIncluders) {}
+        ASTPeer(AW), HeaderIncluders(HeaderIncluders),
+        SharedPreambles(SharedPreambles) {}
 
   /// It isn't guaranteed that each requested version will be built. If there
   /// are multiple update requests while building a preamble, only the last one
@@ -488,6 +546,8 @@ private:
   SynchronizedTUStatus &Status;
   ASTWorker &ASTPeer;
   TUScheduler::HeaderIncluderCache &HeaderIncluders;
+  /// Null if preambles are not shared between files.
+  TUScheduler::SharedPreambleCache *SharedPreambles;
 };
 
 class ASTWorkerHandle;
@@ -507,6 +567,7 @@ class ASTWorker {
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
             TUScheduler::ASTCache &LRUCache,
             TUScheduler::HeaderIncluderCache &HeaderIncluders,
+            TUScheduler::SharedPreambleCache *SharedPreambles,
             Semaphore &Barrier, bool RunSync, const TUScheduler::Options &Opts,
             ParsingCallbacks &Callbacks);
 
@@ -520,6 +581,7 @@ public:
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
          TUScheduler::ASTCache &IdleASTs,
          TUScheduler::HeaderIncluderCache &HeaderIncluders,
+         TUScheduler::SharedPreambleCache *SharedPreambles,
          AsyncTaskRunner *Tasks, Semaphore &Barrier,
          const TUScheduler::Options &Opts, ParsingCallbacks &Callbacks);
   ~ASTWorker();
@@ -573,9 +635,11 @@ private:
 
   /// Publishes diagnostics for \p Inputs. It will build an AST or reuse the
   /// cached one if applicable. Assumes LatestPreamble is compatible for \p
-  /// Inputs.
+  /// Inputs. If \p WantDiags is Auto, the AST build is abandoned as soon as a
+  /// newer update changes the contents of the file.
   void generateDiagnostics(std::unique_ptr<CompilerInvocation> Invocation,
-                           ParseInputs Inputs, std::vector<Diag> CIDiags);
+                           ParseInputs Inputs, std::vector<Diag> CIDiags,
+                           WantDiagnostics WantDiags);
 
   void updateASTSignals(ParsedAST &AST);
 
@@ -642,6 +706,9 @@ private:
   bool Done;                              /* GUARDED_BY(Mutex) */
   std::deque<Request> Requests;           /* GUARDED_BY(Mutex) */
   llvm::Optional<Request> CurrentRequest; /* GUARDED_BY(Mutex) */
+  /// Cancels the AST build of generateDiagnostics() in progress, if a newer
+  /// update is allowed to preempt it.
+  Canceler CancelDiagnosticsBuild; /* GUARDED_BY(Mutex) */
   /// Signalled whenever a new request has been scheduled or processing of a
   /// request has completed.
   mutable std::condition_variable RequestsCV;
@@ -717,12 +784,13 @@ ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
                   TUScheduler::ASTCache &IdleASTs,
                   TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                  TUScheduler::SharedPreambleCache *SharedPreambles,
                   AsyncTaskRunner *Tasks, Semaphore &Barrier,
                   const TUScheduler::Options &Opts,
                   ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, HeaderIncluders, Barrier,
-                    /*RunSync=*/!Tasks, Opts, Callbacks));
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, HeaderIncluders, SharedPreambles, Barrier,
+      /*RunSync=*/!Tasks, Opts, Callbacks));
   if (Tasks) {
     Tasks->runAsync("ASTWorker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -736,6 +804,7 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
                      TUScheduler::ASTCache &LRUCache,
                      TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                     TUScheduler::SharedPreambleCache *SharedPreambles,
                      Semaphore &Barrier, bool RunSync,
                      const TUScheduler::Options &Opts,
                      ParsingCallbacks &Callbacks)
@@ -744,7 +813,7 @@ ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
       ContextProvider(Opts.ContextProvider), CDB(CDB), Callbacks(Callbacks),
       Barrier(Barrier), Done(false), Status(FileName, Callbacks),
       PreamblePeer(FileName, Callbacks, Opts.StorePreamblesInMemory, RunSync,
-                   Status, HeaderIncluders, *this) {
+                   Status, HeaderIncluders, SharedPreambles, *this) {
   // Set a fallback command because compile command can be accessed before
   // `Inputs` is initialized. Other fields are only used after initialization
   // from client inputs.
@@ -884,13 +953,22 @@ void ASTWorker::runWithAST(
       // FIXME: We might need to build a patched ast once preamble thread starts
       // running async. Currently getPossiblyStalePreamble below will always
       // return a compatible preamble as ASTWorker::update blocks.
+      // Once the diagnostics of these inputs are published, the AST is never
+      // used to publish them again, see generateDiagnostics(). Re-opening an
+      // evicted file then doesn't pay for clang-tidy and the include-fixer.
+      ParseInputs Inputs = FileInputs;
+      Inputs.Opts.PreserveDiagnostics = !RanASTCallback;
       llvm::Optional<ParsedAST> NewAST;
       if (Invocation) {
-        NewAST = ParsedAST::build(FileName, FileInputs, std::move(Invocation),
+        NewAST = ParsedAST::build(FileName, Inputs, std::move(Invocation),
                                   CompilerInvocationDiagConsumer.take(),
                                   getPossiblyStalePreamble());
         ++ASTBuildCount;
       }
+      // The build stops early if this read is invalidated by an edit, the AST
+      // is incomplete then.
+      if (auto Reason = isCancelled())
+        return Action(llvm::make_error<CancelledError>(Reason));
       AST = NewAST ? std::make_unique<ParsedAST>(std::move(*NewAST)) : nullptr;
     }
     // Make sure we put the AST back into the LRU cache.
@@ -970,17 +1048,33 @@ void PreambleThread::build(Request Req) {
          FileName, Inputs.Version, LatestBuild->Version);
   }
 
-  ThreadCrashReporter ScopedReporter([&Inputs]() {
-    llvm::errs() << "Signalled while building preamble\n";
-    crashDumpParseInputs(llvm::errs(), Inputs);
-  });
+  std::shared_ptr<const PreambleData> Shared;
+  if (SharedPreambles && !Inputs.ForceRebuild)
+    Shared = SharedPreambles->get(FileName, Inputs, *Req.CI);
+  if (Shared) {
+    // The symbols of the preamble were indexed when it was built for the
+    // other file, there is no AST to run onPreambleAST() on.
+    vlog("Sharing preamble of {0} version {1} with version {2} of {3}",
+         Shared->CompileCommand.Filename, Shared->Version, Inputs.Version,
+         FileName);
+    ReusedPreamble = Shared == LatestBuild;
+    LatestBuild = std::move(Shared);
+  } else {
+    ThreadCrashReporter ScopedReporter([&Inputs]() {
+      llvm::errs() << "Signalled while building preamble\n";
+      crashDumpParseInputs(llvm::errs(), Inputs);
+    });
 
-  LatestBuild = clang::clangd::buildPreamble(
-      FileName, *Req.CI, Inputs, StoreInMemory,
-      [this, Version(Inputs.Version)](ASTContext &Ctx, Preprocessor &PP,
-                                      const CanonicalIncludes &CanonIncludes) {
-        Callbacks.onPreambleAST(FileName, Version, Ctx, PP, CanonIncludes);
-      });
+    LatestBuild = clang::clangd::buildPreamble(
+        FileName, *Req.CI, Inputs, StoreInMemory,
+        [this, Version(Inputs.Version)](
+            ASTContext &Ctx, Preprocessor &PP,
+            const CanonicalIncludes &CanonIncludes) {
+          Callbacks.onPreambleAST(FileName, Version, Ctx, PP, CanonIncludes);
+        });
+    if (LatestBuild && SharedPreambles)
+      SharedPreambles->put(Inputs, *Req.CI, LatestBuild);
+  }
   if (LatestBuild && isReliable(LatestBuild->CompileCommand))
     HeaderIncluders.update(FileName, LatestBuild->Includes.allHeaders());
 }
@@ -1022,7 +1116,8 @@ void ASTWorker::updatePreamble(std::unique_ptr<CompilerInvocation> CI,
     // Report diagnostics with the new preamble to ensure progress. Otherwise
     // diagnostics might get stale indefinitely if user keeps invalidating the
     // preamble.
-    generateDiagnostics(std::move(CI), std::move(PI), std::move(CIDiags));
+    generateDiagnostics(std::move(CI), std::move(PI), std::move(CIDiags),
+                        WantDiags);
   };
   if (RunSync) {
     runTask(TaskName, Task);
@@ -1051,7 +1146,7 @@ void ASTWorker::updateASTSignals(ParsedAST &AST) {
 
 void ASTWorker::generateDiagnostics(
     std::unique_ptr<CompilerInvocation> Invocation, ParseInputs Inputs,
-    std::vector<Diag> CIDiags) {
+    std::vector<Diag> CIDiags, WantDiagnostics WantDiags) {
   // Tracks ast cache accesses for publishing diags.
   static constexpr trace::Metric ASTAccessForDiag(
       "ast_access_diag", trace::Metric::Counter, "result");
@@ -1087,11 +1182,35 @@ void ASTWorker::generateDiagnostics(
   llvm::Optional<std::unique_ptr<ParsedAST>> AST =
       IdleASTs.take(this, &ASTAccessForDiag);
   if (!AST || !InputsAreLatest) {
+    // A newer edit makes these diagnostics stale, and the build can take long
+    // enough on heavy files to delay the reads queued behind it. Unless they
+    // were explicitly requested, let the next content change cancel it.
+    llvm::Optional<WithContext> CancelableBuild;
+    if (WantDiags == WantDiagnostics::Auto) {
+      auto Task = cancelableTask(
+          /*Reason=*/static_cast<int>(ErrorCode::ContentModified));
+      CancelableBuild.emplace(std::move(Task.first));
+      std::lock_guard<std::mutex> Lock(Mutex);
+      CancelDiagnosticsBuild = std::move(Task.second);
+    }
     auto RebuildStartTime = DebouncePolicy::clock::now();
     llvm::Optional<ParsedAST> NewAST = ParsedAST::build(
         FileName, Inputs, std::move(Invocation), CIDiags, *LatestPreamble);
     auto RebuildDuration = DebouncePolicy::clock::now() - RebuildStartTime;
     ++ASTBuildCount;
+    if (CancelableBuild) {
+      {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        CancelDiagnosticsBuild = nullptr;
+      }
+      if (isCancelled()) {
+        // The update that cancelled us will publish its own diagnostics. An
+        // AST abandoned half-way is neither reported nor cached.
+        log("Cancelled AST build for {0} version {1}, superseded by an edit",
+            FileName, Inputs.Version);
+        return;
+      }
+    }
     // Try to record the AST-build time, to inform future update debouncing.
     // This is best-effort only: if the lock is held, don't bother.
     std::unique_lock<std::mutex> Lock(Mutex, std::try_to_lock);
@@ -1220,12 +1339,26 @@ void ASTWorker::startTask(llvm::StringRef Name,
     assert(!Done && "running a task after stop()");
     // Cancel any requests invalidated by this request.
     if (Update && Update->ContentChanged) {
+      bool InvalidatedAll = true;
       for (auto &R : llvm::reverse(Requests)) {
         if (R.InvalidationPolicy == TUScheduler::InvalidateOnUpdate)
           R.Invalidate();
-        if (R.Update && R.Update->ContentChanged)
-          break; // Older requests were already invalidated by the older update.
+        if (R.Update && R.Update->ContentChanged) {
+          // Older requests were already invalidated by the older update.
+          InvalidatedAll = false;
+          break;
+        }
       }
+      // The request in progress may be rebuilding an evicted AST. It stops
+      // early once cancelled.
+      if (InvalidatedAll && CurrentRequest &&
+          CurrentRequest->InvalidationPolicy ==
+              TUScheduler::InvalidateOnUpdate)
+        CurrentRequest->Invalidate();
+      // An automatic diagnostics build is superseded by this version, as long
+      // as it produces diagnostics of its own.
+      if (CancelDiagnosticsBuild && Update->Diagnostics != WantDiagnostics::No)
+        CancelDiagnosticsBuild();
     }
 
     // Allow this request to be cancelled if invalidated.
@@ -1510,6 +1643,8 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
       IdleASTs(
           std::make_unique<ASTCache>(Opts.RetentionPolicy.MaxRetainedASTs)),
       HeaderIncluders(std::make_unique<HeaderIncluderCache>()) {
+  if (Opts.SharePreambles)
+    SharedPreambles = std::make_unique<SharedPreambleCache>();
   // Avoid null checks everywhere.
   if (!Opts.ContextProvider) {
     this->Opts.ContextProvider = [](llvm::StringRef) {
@@ -1552,6 +1687,7 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
     // Create a new worker to process the AST-related tasks.
     ASTWorkerHandle Worker =
         ASTWorker::create(File, CDB, *IdleASTs, *HeaderIncluders,
+                          SharedPreambles.get(),
                           WorkerThreads ? WorkerThreads.getPointer() : nullptr,
                           Barrier, Opts, *Callbacks);
     FD = std::unique_ptr<FileData>(
@@ -93,6 +93,7 @@ BackgroundIndex::BackgroundIndex(
     BackgroundIndexStorage::Factory IndexStorageFactory, Options Opts)
     : SwapIndex(std::make_unique<MemIndex>()), TFS(TFS), CDB(CDB),
       ContextProvider(std::move(Opts.ContextProvider)),
+      LoaderThreadCount(Opts.ThreadPoolSize),
       IndexedSymbols(IndexContents::All),
       Rebuilder(this, &IndexedSymbols, Opts.ThreadPoolSize),
       IndexStorageFactory(std::move(IndexStorageFactory)),
@@ -362,7 +363,7 @@ BackgroundIndex::loadProject(std::vector<std::string> MainFiles) {
   Rebuilder.startLoading();
   // Load shards for all of the mainfiles.
   const std::vector<LoadedShard> Result =
-      loadIndexShards(MainFiles, IndexStorageFactory, CDB);
+      loadIndexShards(MainFiles, IndexStorageFactory, CDB, LoaderThreadCount);
   size_t LoadedShards = 0;
   {
     // Update in-memory state.
@@ -370,6 +371,14 @@ BackgroundIndex::loadProject(std::vector<std::string> MainFiles) {
     for (auto &LS : Result) {
       if (!LS.Shard)
         continue;
+      // The symbols of files we already hold for the same contents were read
+      // from this shard, or indexed into it. Skipping them avoids a rebuild of
+      // the whole index when e.g. the compile commands of a project are
+      // reloaded but most of the sources did not change.
+      auto It = ShardVersions.find(LS.AbsolutePath);
+      if (It != ShardVersions.end() && It->second.Digest == LS.Digest &&
+          It->second.HadErrors == LS.HadErrors)
+        continue;
       auto SS =
           LS.Shard->Symbols
               ? std::make_unique<SymbolSlab>(std::move(*LS.Shard->Symbols))
@@ -195,6 +195,8 @@ private:
   const ThreadsafeFS &TFS;
   const GlobalCompilationDatabase &CDB;
   std::function<Context(PathRef)> ContextProvider;
+  // Number of threads reading shards from storage in parallel.
+  const size_t LoaderThreadCount;
 
   llvm::Error index(tooling::CompileCommand);
 
@@ -10,9 +10,13 @@
 #include "GlobalCompilationDatabase.h"
 #include "index/Background.h"
 #include "support/Logger.h"
+#include "support/Context.h"
 #include "support/Path.h"
+#include "support/Threading.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Path.h"
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,54 +29,46 @@ namespace {
 /// inverse dependency mapping.
 class BackgroundIndexLoader {
 public:
-  BackgroundIndexLoader(BackgroundIndexStorage::Factory &IndexStorageFactory)
-      : IndexStorageFactory(IndexStorageFactory) {}
-  /// Load the shards for \p MainFile and all of its dependencies.
-  void load(PathRef MainFile);
+  BackgroundIndexLoader(BackgroundIndexStorage::Factory &IndexStorageFactory,
+                        unsigned ThreadCount)
+      : IndexStorageFactory(IndexStorageFactory), ThreadCount(ThreadCount) {}
+  /// Load the shards for \p MainFiles and all of their dependencies.
+  void load(llvm::ArrayRef<Path> MainFiles);
 
   /// Consumes the loader and returns all shards.
   std::vector<LoadedShard> takeResult() &&;
 
 private:
-  /// Returns the Shard for \p StartSourceFile from cache or loads it from \p
-  /// Storage. Also returns paths for dependencies of \p StartSourceFile if it
-  /// wasn't cached yet.
-  std::pair<const LoadedShard &, std::vector<Path>>
-  loadShard(PathRef StartSourceFile, PathRef DependentTU);
+  /// Loads the shard for \p LS.AbsolutePath from storage into \p LS. Returns
+  /// the paths of its dependencies. Safe to call concurrently for different
+  /// shards.
+  std::vector<Path> loadShard(LoadedShard &LS);
 
   /// Cache for Storage lookups.
   llvm::StringMap<LoadedShard> LoadedShards;
 
   BackgroundIndexStorage::Factory &IndexStorageFactory;
+  const unsigned ThreadCount;
 };
 
-std::pair<const LoadedShard &, std::vector<Path>>
-BackgroundIndexLoader::loadShard(PathRef StartSourceFile, PathRef DependentTU) {
-  auto It = LoadedShards.try_emplace(StartSourceFile);
-  LoadedShard &LS = It.first->getValue();
+std::vector<Path> BackgroundIndexLoader::loadShard(LoadedShard &LS) {
   std::vector<Path> Edges = {};
-  // Return the cached shard.
-  if (!It.second)
-    return {LS, Edges};
-
-  LS.AbsolutePath = StartSourceFile.str();
-  LS.DependentTU = std::string(DependentTU);
   BackgroundIndexStorage *Storage = IndexStorageFactory(LS.AbsolutePath);
-  auto Shard = Storage->loadShard(StartSourceFile);
+  auto Shard = Storage->loadShard(LS.AbsolutePath);
   if (!Shard || !Shard->Sources) {
-    vlog("Failed to load shard: {0}", StartSourceFile);
-    return {LS, Edges};
+    vlog("Failed to load shard: {0}", LS.AbsolutePath);
+    return Edges;
   }
 
   LS.Shard = std::move(Shard);
   for (const auto &It : *LS.Shard->Sources) {
-    auto AbsPath = URI::resolve(It.getKey(), StartSourceFile);
+    auto AbsPath = URI::resolve(It.getKey(), LS.AbsolutePath);
     if (!AbsPath) {
       elog("Failed to resolve URI: {0}", AbsPath.takeError());
       continue;
     }
     // A shard contains only edges for non main-file sources.
-    if (*AbsPath != StartSourceFile) {
+    if (*AbsPath != LS.AbsolutePath) {
       Edges.push_back(*AbsPath);
       continue;
     }
@@ -84,26 +80,54 @@ BackgroundIndexLoader::loadShard(PathRef StartSourceFile, PathRef DependentTU) {
     LS.HadErrors = IGN.Flags & IncludeGraphNode::SourceFlag::HadErrors;
   }
   assert(LS.Digest != FileDigest{{0}} && "Digest is empty?");
-  return {LS, Edges};
+  return Edges;
 }
 
-void BackgroundIndexLoader::load(PathRef MainFile) {
-  llvm::StringSet<> InQueue;
-  // Following containers points to strings inside InQueue.
-  std::queue<PathRef> ToVisit;
-  InQueue.insert(MainFile);
-  ToVisit.push(MainFile);
-
-  while (!ToVisit.empty()) {
-    PathRef SourceFile = ToVisit.front();
-    ToVisit.pop();
+void BackgroundIndexLoader::load(llvm::ArrayRef<Path> MainFiles) {
+  // Shards left to load. They point into LoadedShards, whose entries are
+  // never moved.
+  std::vector<LoadedShard *> ToLoad;
+  auto Enqueue = [&](PathRef SourceFile, PathRef DependentTU) {
+    auto It = LoadedShards.try_emplace(SourceFile);
+    if (!It.second)
+      return;
+    LoadedShard &LS = It.first->getValue();
+    LS.AbsolutePath = SourceFile.str();
+    LS.DependentTU = DependentTU.str();
+    ToLoad.push_back(&LS);
+  };
+  for (PathRef MainFile : MainFiles) {
+    assert(llvm::sys::path::is_absolute(MainFile));
+    Enqueue(MainFile, MainFile);
+  }
 
-    auto ShardAndEdges = loadShard(SourceFile, MainFile);
-    for (PathRef Edge : ShardAndEdges.second) {
-      auto It = InQueue.insert(Edge);
-      if (It.second)
-        ToVisit.push(It.first->getKey());
+  // Walk the include graph breadth-first. Reading and deserializing a shard
+  // is the expensive part, so the shards of each round are loaded in
+  // parallel; the dependencies they discover make up the next round.
+  while (!ToLoad.empty()) {
+    std::vector<LoadedShard *> Round = std::move(ToLoad);
+    ToLoad.clear();
+    std::vector<std::vector<Path>> Edges(Round.size());
+    std::atomic<size_t> Next = {0};
+    auto LoadShards = [&] {
+      for (size_t I = Next++; I < Round.size(); I = Next++)
+        Edges[I] = loadShard(*Round[I]);
+    };
+    {
+      AsyncTaskRunner Loaders;
+      for (unsigned I = 1; I < std::min<size_t>(ThreadCount, Round.size());
+           ++I)
+        Loaders.runAsync("shard-loader-" + llvm::Twine(I),
+                         [&LoadShards, Ctx(Context::current().clone())] {
+                           WithContext WithCtx(Ctx.clone());
+                           LoadShards();
+                         });
+      LoadShards();
+      // ~AsyncTaskRunner waits for the other loaders.
     }
+    for (size_t I = 0; I < Round.size(); ++I)
+      for (PathRef Edge : Edges[I])
+        Enqueue(Edge, Round[I]->DependentTU);
   }
 }
 
@@ -119,12 +143,9 @@ std::vector<LoadedShard> BackgroundIndexLoader::takeResult() && {
 std::vector<LoadedShard>
 loadIndexShards(llvm::ArrayRef<Path> MainFiles,
                 BackgroundIndexStorage::Factory &IndexStorageFactory,
-                const GlobalCompilationDatabase &CDB) {
-  BackgroundIndexLoader Loader(IndexStorageFactory);
-  for (llvm::StringRef MainFile : MainFiles) {
-    assert(llvm::sys::path::is_absolute(MainFile));
-    Loader.load(MainFile);
-  }
+                const GlobalCompilationDatabase &CDB, unsigned ThreadCount) {
+  BackgroundIndexLoader Loader(IndexStorageFactory, ThreadCount);
+  Loader.load(MainFiles);
   return std::move(Loader).takeResult();
 }
 
@@ -449,6 +449,7 @@ readCompileCommand(Reader CmdReader, llvm::ArrayRef<llvm::StringRef> Strings) {
 //   - stri: string table
 //   - symb: symbols
 //   - refs: references to symbols
+//   - plst: Dex posting lists of the symbols, see Dex::writePostingLists()
 
 // The current versioning scheme is simple - non-current versions are rejected.
 // If you make a breaking change, bump this version number to invalidate stored
@@ -543,6 +544,9 @@ llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data,
     for (llvm::StringRef C : Cmd.CommandLine)
       Result.Cmd->CommandLine.emplace_back(C);
   }
+  // The posting lists are validated against the symbols when they are used.
+  if (Chunks.count("plst"))
+    Result.DexPostingLists = Chunks.lookup("plst");
   return std::move(Result);
 }
 
@@ -665,6 +669,22 @@ void writeRIFF(const IndexFileOut &Data, llvm::raw_ostream &OS) {
     RIFF.Chunks.push_back({riff::fourCC("cmdl"), CmdlSection});
   }
 
+  std::string PostingListsSection;
+  if (Data.DexPostingLists) {
+    {
+      llvm::raw_string_ostream PostingListsOS(PostingListsSection);
+      dex::Dex(*Data.Symbols,
+               llvm::ArrayRef<std::pair<SymbolID, llvm::ArrayRef<Ref>>>(),
+               llvm::ArrayRef<Relation>())
+          .writePostingLists(PostingListsOS);
+    }
+    // The chunk goes first, right after the 12 bytes of the RIFF header and
+    // its own 8 byte header, so that the posting lists are suitably aligned
+    // to be used in place in a memory mapped file.
+    RIFF.Chunks.insert(RIFF.Chunks.begin(),
+                       {riff::fourCC("plst"), PostingListsSection});
+  }
+
   OS << RIFF;
 }
 
@@ -711,6 +731,7 @@ std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
   SymbolSlab Symbols;
   RefSlab Refs;
   RelationSlab Relations;
+  llvm::StringRef PostingLists;
   {
     trace::Span Tracer("ParseIndex");
     if (auto I = readIndexFile(Buffer->get()->getBuffer(), Origin)) {
@@ -720,6 +741,7 @@ std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
         Refs = std::move(*I->Refs);
       if (I->Relations)
         Relations = std::move(*I->Relations);
+      PostingLists = I->DexPostingLists;
     } else {
       elog("Bad index file: {0}", I.takeError());
       return nullptr;
@@ -731,10 +753,18 @@ std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
   size_t NumRelations = Relations.size();
 
   trace::Span Tracer("BuildIndex");
-  auto Index = UseDex ? dex::Dex::build(std::move(Symbols), std::move(Refs),
-                                        std::move(Relations))
-                      : MemIndex::build(std::move(Symbols), std::move(Refs),
-                                        std::move(Relations));
+  std::unique_ptr<SymbolIndex> Index;
+  if (UseDex && !PostingLists.empty())
+    // The posting lists point into the buffer, which Dex keeps alive.
+    Index = dex::Dex::build(std::move(Symbols), std::move(Refs),
+                            std::move(Relations), PostingLists,
+                            std::move(*Buffer));
+  else if (UseDex)
+    Index = dex::Dex::build(std::move(Symbols), std::move(Refs),
+                            std::move(Relations));
+  else
+    Index = MemIndex::build(std::move(Symbols), std::move(Refs),
+                            std::move(Relations));
   vlog("Loaded {0} from {1} with estimated memory usage {2} bytes\n"
        "  - number of symbols: {3}\n"
        "  - number of refs: {4}\n"
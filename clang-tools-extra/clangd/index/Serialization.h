@@ -12,6 +12,7 @@
 //  - metadata such as version info
 //  - a string table (which is compressed)
 //  - lists of encoded symbols
+//  - optionally, the Dex posting lists of the symbols
 //
 // The format has a simple versioning scheme: the format version number is
 // written in the file and non-current versions are rejected when reading.
@@ -47,6 +48,9 @@ struct IndexFileIn {
   llvm::Optional<IncludeGraph> Sources;
   // This contains only the Directory and CommandLine.
   llvm::Optional<tooling::CompileCommand> Cmd;
+  // The serialized Dex posting lists of the symbols, if present. This points
+  // into the data that was read, which must outlive it.
+  llvm::StringRef DexPostingLists;
 };
 // Parse an index file. The input must be a RIFF or YAML file.
 llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef, SymbolOrigin);
@@ -58,7 +62,9 @@ struct IndexFileOut {
   const RelationSlab *Relations = nullptr;
   // Keys are URIs of the source files.
   const IncludeGraph *Sources = nullptr;
-  // TODO: Support serializing Dex posting lists.
+  // Whether to also write the Dex posting lists of the symbols, so that a Dex
+  // index can be loaded without building them. Only supported by RIFF.
+  bool DexPostingLists = false;
   IndexFileFormat Format = IndexFileFormat::RIFF;
   const tooling::CompileCommand *Cmd = nullptr;
 
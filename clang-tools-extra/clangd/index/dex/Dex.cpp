@@ -17,9 +17,11 @@
 #include "support/Logger.h"
 #include "support/Trace.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include <algorithm>
+#include <cstring>
 #include <queue>
 
 namespace clang {
@@ -36,6 +38,22 @@ std::unique_ptr<SymbolIndex> Dex::build(SymbolSlab Symbols, RefSlab Refs,
                                 Size);
 }
 
+std::unique_ptr<SymbolIndex>
+Dex::build(SymbolSlab Symbols, RefSlab Refs, RelationSlab Rels,
+           llvm::StringRef PostingLists,
+           std::unique_ptr<llvm::MemoryBuffer> Buffer) {
+  auto Size = Symbols.bytes() + Refs.bytes();
+  // A memory mapped buffer is backed by the file, and shared with the other
+  // processes that map it.
+  if (Buffer->getBufferKind() == llvm::MemoryBuffer::MemoryBuffer_Malloc)
+    Size += Buffer->getBufferSize();
+  auto Data =
+      std::make_pair(std::make_pair(std::move(Symbols), std::move(Refs)),
+                     std::move(Buffer));
+  return std::make_unique<Dex>(Data.first.first, Data.first.second, Rels,
+                                PostingLists, std::move(Data), Size);
+}
+
 namespace {
 
 // Mark symbols which are can be used for code completion.
@@ -97,9 +115,161 @@ public:
   }
 };
 
+// POSTING LIST ENCODING
+// The posting lists are written as:
+//   - NumSymbols : uint32
+//   - RankHash   : uint64, see hashRanks()
+//   - NumChunks  : uint32
+//   - NumTokens  : uint32
+//   - Chunks     : Chunk[NumChunks], the chunks of all the lists
+//   - Tokens     : { Kind : uint8, Size : uint32, Data : char[Size],
+//                    NumChunks : uint32 }[NumTokens]
+// All integers are little-endian, including the heads of the chunks, so that
+// on little-endian hosts the chunks can be used in place when they are
+// suitably aligned.
+constexpr size_t PostingListsHeaderSize = 20;
+
+// A DocID is the rank of a symbol in the index, so posting lists can only be
+// reused by an index that ranks the same symbols in the same order. This is a
+// FNV-1a hash of the IDs of the symbols in the order of their ranks.
+uint64_t hashRanks(llvm::ArrayRef<const Symbol *> Symbols) {
+  uint64_t Hash = 14695981039346656037ULL;
+  for (const Symbol *Sym : Symbols)
+    for (char C : Sym->ID.raw()) {
+      Hash ^= static_cast<uint8_t>(C);
+      Hash *= 1099511628211ULL;
+    }
+  return Hash;
+}
+
+// Checks that the chunks hold a well-formed list of increasing DocIDs below
+// NumDocs, so that a corrupt file can not make queries read out of bounds.
+bool isValidPostingList(llvm::ArrayRef<Chunk> Chunks, size_t NumDocs) {
+  llvm::Optional<DocID> Last;
+  for (const Chunk &C : Chunks) {
+    // A DocID takes at most 5 bytes.
+    unsigned Continued = 0;
+    for (uint8_t B : C.Payload)
+      if (B & 0x80) {
+        if (++Continued == 5)
+          return false;
+      } else {
+        Continued = 0;
+      }
+    for (DocID D : C.decompress()) {
+      if (D >= NumDocs || (Last && D <= *Last))
+        return false;
+      Last = D;
+    }
+  }
+  return true;
+}
+
 } // namespace
 
-void Dex::buildIndex() {
+void Dex::writePostingLists(llvm::raw_ostream &OS) const {
+  std::vector<const std::pair<Token, PostingList> *> Lists;
+  size_t NumChunks = 0;
+  for (const auto &TokenAndList : InvertedIndex) {
+    Lists.push_back(&TokenAndList);
+    NumChunks += TokenAndList.second.chunks().size();
+  }
+  // Sort the tokens so that the output does not depend on the hash function.
+  llvm::sort(Lists, [](const std::pair<Token, PostingList> *L,
+                       const std::pair<Token, PostingList> *R) {
+    return std::make_pair(L->first.kind(), L->first.data()) <
+           std::make_pair(R->first.kind(), R->first.data());
+  });
+
+  llvm::support::endian::Writer W(OS, llvm::support::little);
+  W.write<uint32_t>(Symbols.size());
+  W.write<uint64_t>(hashRanks(Symbols));
+  W.write<uint32_t>(NumChunks);
+  W.write<uint32_t>(Lists.size());
+  for (const auto *TokenAndList : Lists)
+    for (const Chunk &C : TokenAndList->second.chunks()) {
+      W.write<uint32_t>(C.Head);
+      OS.write(reinterpret_cast<const char *>(C.Payload.data()),
+               C.Payload.size());
+    }
+  for (const auto *TokenAndList : Lists) {
+    const Token &Tok = TokenAndList->first;
+    W.write<uint8_t>(static_cast<uint8_t>(Tok.kind()));
+    W.write<uint32_t>(Tok.data().size());
+    OS << Tok.data();
+    W.write<uint32_t>(TokenAndList->second.chunks().size());
+  }
+}
+
+bool Dex::readPostingLists(llvm::StringRef Data) {
+  using namespace llvm::support;
+  if (Data.size() < PostingListsHeaderSize)
+    return false;
+  const char *P = Data.data();
+  uint32_t NumSymbols = endian::read32le(P);
+  uint64_t RankHash = endian::read64le(P + 4);
+  uint32_t NumChunks = endian::read32le(P + 12);
+  uint32_t NumTokens = endian::read32le(P + 16);
+  if (NumSymbols != Symbols.size() || RankHash != hashRanks(Symbols) ||
+      NumChunks > (Data.size() - PostingListsHeaderSize) / sizeof(Chunk))
+    return false;
+  P += PostingListsHeaderSize;
+
+  llvm::ArrayRef<Chunk> Chunks;
+  if (llvm::sys::IsLittleEndianHost &&
+      reinterpret_cast<uintptr_t>(P) % alignof(Chunk) == 0) {
+    Chunks = llvm::makeArrayRef(reinterpret_cast<const Chunk *>(P), NumChunks);
+  } else {
+    PostingListStorage.resize(NumChunks);
+    for (uint32_t I = 0; I < NumChunks; ++I) {
+      const char *C = P + I * sizeof(Chunk);
+      PostingListStorage[I].Head = endian::read32le(C);
+      std::memcpy(PostingListStorage[I].Payload.data(), C + sizeof(DocID),
+                  Chunk::PayloadSize);
+    }
+    Chunks = PostingListStorage;
+  }
+  llvm::StringRef Rest = Data.drop_front(PostingListsHeaderSize +
+                                         size_t(NumChunks) * sizeof(Chunk));
+
+  auto Fail = [&] {
+    InvertedIndex.clear();
+    PostingListStorage.clear();
+    return false;
+  };
+  InvertedIndex.reserve(NumTokens);
+  size_t FirstChunk = 0;
+  for (uint32_t I = 0; I < NumTokens; ++I) {
+    if (Rest.size() < 5)
+      return Fail();
+    uint8_t Kind = Rest[0];
+    uint32_t Size = endian::read32le(Rest.data() + 1);
+    Rest = Rest.drop_front(5);
+    if (Kind > static_cast<uint8_t>(Token::Kind::Sentinel) ||
+        Rest.size() < size_t(Size) + 4)
+      return Fail();
+    Token Tok(static_cast<Token::Kind>(Kind), Rest.take_front(Size));
+    uint32_t ListChunks = endian::read32le(Rest.data() + Size);
+    Rest = Rest.drop_front(size_t(Size) + 4);
+    // The empty and tombstone keys of the map are sentinel tokens too.
+    if ((Tok.kind() == Token::Kind::Sentinel &&
+         !(Tok == RestrictedForCodeCompletion)) ||
+        ListChunks == 0 || ListChunks > Chunks.size() - FirstChunk)
+      return Fail();
+    llvm::ArrayRef<Chunk> List = Chunks.slice(FirstChunk, ListChunks);
+    if (!isValidPostingList(List, Symbols.size()) ||
+        !InvertedIndex
+             .try_emplace(std::move(Tok), PostingList::fromChunks(List))
+             .second)
+      return Fail();
+    FirstChunk += ListChunks;
+  }
+  if (FirstChunk != Chunks.size() || !Rest.empty())
+    return Fail();
+  return true;
+}
+
+void Dex::buildIndex(llvm::StringRef PostingLists) {
   this->Corpus = dex::Corpus(Symbols.size());
   std::vector<std::pair<float, const Symbol *>> ScoredSymbols(Symbols.size());
 
@@ -121,6 +291,12 @@ void Dex::buildIndex() {
     Symbols[I] = ScoredSymbols[I].second;
   }
 
+  if (!PostingLists.empty()) {
+    if (readPostingLists(PostingLists))
+      return;
+    vlog("Dex: ignoring posting lists that do not match the symbols");
+  }
+
   // Build posting lists for symbols.
   IndexBuilder Builder;
   for (DocID SymbolRank = 0; SymbolRank < Symbols.size(); ++SymbolRank)
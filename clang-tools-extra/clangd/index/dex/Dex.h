@@ -26,6 +26,7 @@
 #include "index/dex/PostingList.h"
 #include "index/dex/Token.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 namespace clang {
 namespace clangd {
@@ -37,6 +38,14 @@ public:
   // All data must outlive this index.
   template <typename SymbolRange, typename RefsRange, typename RelationsRange>
   Dex(SymbolRange &&Symbols, RefsRange &&Refs, RelationsRange &&Relations)
+      : Dex(std::forward<SymbolRange>(Symbols), std::forward<RefsRange>(Refs),
+            std::forward<RelationsRange>(Relations), llvm::StringRef()) {}
+  // As above, but the posting lists are read from PostingLists, as written by
+  // writePostingLists() for the same symbols, instead of being built. They are
+  // built anyway if PostingLists is empty or does not match the symbols.
+  template <typename SymbolRange, typename RefsRange, typename RelationsRange>
+  Dex(SymbolRange &&Symbols, RefsRange &&Refs, RelationsRange &&Relations,
+      llvm::StringRef PostingLists)
       : Corpus(0) {
     for (auto &&Sym : Symbols)
       this->Symbols.push_back(&Sym);
@@ -46,7 +55,7 @@ public:
       this->Relations[std::make_pair(Rel.Subject,
                                      static_cast<uint8_t>(Rel.Predicate))]
           .push_back(Rel.Object);
-    buildIndex();
+    buildIndex(PostingLists);
   }
   // Symbols and Refs are owned by BackingData, Index takes ownership.
   template <typename SymbolRange, typename RefsRange, typename RelationsRange,
@@ -54,7 +63,17 @@ public:
   Dex(SymbolRange &&Symbols, RefsRange &&Refs, RelationsRange &&Relations,
       Payload &&BackingData, size_t BackingDataSize)
       : Dex(std::forward<SymbolRange>(Symbols), std::forward<RefsRange>(Refs),
-            std::forward<RelationsRange>(Relations)) {
+            std::forward<RelationsRange>(Relations), llvm::StringRef(),
+            std::forward<Payload>(BackingData), BackingDataSize) {}
+  // Symbols, Refs and PostingLists are owned by BackingData, Index takes
+  // ownership.
+  template <typename SymbolRange, typename RefsRange, typename RelationsRange,
+            typename Payload>
+  Dex(SymbolRange &&Symbols, RefsRange &&Refs, RelationsRange &&Relations,
+      llvm::StringRef PostingLists, Payload &&BackingData,
+      size_t BackingDataSize)
+      : Dex(std::forward<SymbolRange>(Symbols), std::forward<RefsRange>(Refs),
+            std::forward<RelationsRange>(Relations), PostingLists) {
     KeepAlive = std::shared_ptr<void>(
         std::make_shared<Payload>(std::move(BackingData)), nullptr);
     this->BackingDataSize = BackingDataSize;
@@ -74,6 +93,16 @@ public:
 
   /// Builds an index from slabs. The index takes ownership of the slab.
   static std::unique_ptr<SymbolIndex> build(SymbolSlab, RefSlab, RelationSlab);
+  /// Builds an index from slabs and from the posting lists of the symbols in
+  /// Buffer, which are used in place. The index takes ownership of the slabs
+  /// and of the buffer.
+  static std::unique_ptr<SymbolIndex>
+  build(SymbolSlab, RefSlab, RelationSlab, llvm::StringRef PostingLists,
+        std::unique_ptr<llvm::MemoryBuffer> Buffer);
+
+  /// Serializes the posting lists of the index, so that an index of the same
+  /// symbols can later be loaded without building them.
+  void writePostingLists(llvm::raw_ostream &OS) const;
 
   bool
   fuzzyFind(const FuzzyFindRequest &Req,
@@ -95,7 +124,8 @@ public:
   size_t estimateMemoryUsage() const override;
 
 private:
-  void buildIndex();
+  void buildIndex(llvm::StringRef PostingLists);
+  bool readPostingLists(llvm::StringRef Data);
   std::unique_ptr<Iterator> iterator(const Token &Tok) const;
   std::unique_ptr<Iterator>
   createFileProximityIterator(llvm::ArrayRef<std::string> ProximityPaths) const;
@@ -114,6 +144,9 @@ private:
   /// std. Inverted index is used to retrieve posting lists which are processed
   /// during the fuzzyFind process.
   llvm::DenseMap<Token, PostingList> InvertedIndex;
+  /// Holds the chunks of the posting lists that were read, if they could not
+  /// be used in place.
+  std::vector<Chunk> PostingListStorage;
   dex::Corpus Corpus;
   llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> Refs;
   static_assert(sizeof(RelationKind) == sizeof(uint8_t),
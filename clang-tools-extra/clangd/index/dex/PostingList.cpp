@@ -24,7 +24,7 @@ public:
   explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
       : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
     if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
+      CurrentChunk->decompress(DecompressedChunk);
       CurrentID = DecompressedChunk.begin();
     }
   }
@@ -47,9 +47,14 @@ public:
     if (ID <= peek())
       return;
     advanceToChunk(ID);
-    // Try to find ID within current chunk.
-    CurrentID = std::partition_point(CurrentID, DecompressedChunk.end(),
-                                     [&](const DocID D) { return D < ID; });
+    // Try to find ID within current chunk. A chunk holds at most 29 DocIDs, so
+    // counting the smaller ones is faster than a binary search: the loop has
+    // no data dependent branches and is vectorized.
+    const DocID *Begin = &*CurrentID, *End = DecompressedChunk.end();
+    size_t Smaller = 0;
+    for (const DocID *D = Begin; D != End; ++D)
+      Smaller += *D < ID;
+    CurrentID += Smaller;
     normalizeCursor();
   }
 
@@ -92,7 +97,7 @@ private:
     ++CurrentChunk;
     if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
       return;
-    DecompressedChunk = CurrentChunk->decompress();
+    CurrentChunk->decompress(DecompressedChunk);
     CurrentID = DecompressedChunk.begin();
   }
 
@@ -100,11 +105,21 @@ private:
   void advanceToChunk(DocID ID) {
     if ((CurrentChunk != Chunks.end() - 1) &&
         ((CurrentChunk + 1)->Head <= ID)) {
+      // Intersections mostly advance by a few chunks at a time, so gallop from
+      // the current chunk to bound the search instead of searching all the
+      // remaining chunks.
+      auto Low = CurrentChunk + 1;
+      size_t Step = 1;
+      while (Step < size_t(Chunks.end() - Low) && Low[Step].Head <= ID) {
+        Low += Step;
+        Step *= 2;
+      }
+      auto High = Low + std::min(Step, size_t(Chunks.end() - Low));
       CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
+          std::partition_point(Low + 1, High,
+                               [&](const Chunk &C) { return C.Head <= ID; });
       --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
+      CurrentChunk->decompress(DecompressedChunk);
       CurrentID = DecompressedChunk.begin();
     }
   }
@@ -201,7 +216,14 @@ llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
 } // namespace
 
 llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
+  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result;
+  decompress(Result);
+  return Result;
+}
+
+void Chunk::decompress(llvm::SmallVectorImpl<DocID> &Result) const {
+  Result.clear();
+  Result.push_back(Head);
   llvm::ArrayRef<uint8_t> Bytes(Payload);
   DocID Delta;
   for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
@@ -211,11 +233,10 @@ llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
     Delta = *MaybeDelta;
     Result.push_back(Current + Delta);
   }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
-    : Chunks(encodeStream(Documents)) {}
+    : Storage(encodeStream(Documents)), Chunks(Storage) {}
 
 std::unique_ptr<Iterator> PostingList::iterator(const Token *Tok) const {
   return std::make_unique<ChunkIterator>(Tok, Chunks);
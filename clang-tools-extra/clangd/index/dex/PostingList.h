@@ -44,6 +44,8 @@ struct Chunk {
   static constexpr size_t PayloadSize = 32 - sizeof(DocID);
 
   llvm::SmallVector<DocID, PayloadSize + 1> decompress() const;
+  /// As above, but decompresses into Result, replacing its contents.
+  void decompress(llvm::SmallVectorImpl<DocID> &Result) const;
 
   /// The first element of decompressed Chunk.
   DocID Head;
@@ -60,16 +62,34 @@ class PostingList {
 public:
   explicit PostingList(llvm::ArrayRef<DocID> Documents);
 
+  /// Constructs a posting list over already encoded chunks, e.g. in a memory
+  /// mapped index file. The chunks are not copied and must outlive the list.
+  static PostingList fromChunks(llvm::ArrayRef<Chunk> Chunks) {
+    return PostingList(Chunks);
+  }
+
+  PostingList(PostingList &&) = default;
+  PostingList &operator=(PostingList &&) = default;
+
   /// Constructs DocumentIterator over given posting list. DocumentIterator will
   /// go through the chunks and decompress them on-the-fly when necessary.
   /// If given, Tok is only used for the string representation.
   std::unique_ptr<Iterator> iterator(const Token *Tok = nullptr) const;
 
-  /// Returns in-memory size of external storage.
-  size_t bytes() const { return Chunks.capacity() * sizeof(Chunk); }
+  /// The encoded chunks of the list.
+  llvm::ArrayRef<Chunk> chunks() const { return Chunks; }
+
+  /// Returns in-memory size of external storage. Chunks that are not owned by
+  /// the list are not counted.
+  size_t bytes() const { return Storage.capacity() * sizeof(Chunk); }
 
 private:
-  const std::vector<Chunk> Chunks;
+  explicit PostingList(llvm::ArrayRef<Chunk> Chunks) : Chunks(Chunks) {}
+
+  /// Owns the chunks of lists built from documents, and is empty otherwise.
+  /// Moving a vector keeps its buffer, so Chunks stays valid across moves.
+  std::vector<Chunk> Storage;
+  llvm::ArrayRef<Chunk> Chunks;
 };
 
 } // namespace dex
@@ -356,6 +356,70 @@ public:
   }
 };
 
+class Bench : public Command {
+  llvm::cl::opt<std::string> RequestsFile{
+      "requests",
+      llvm::cl::Positional,
+      llvm::cl::Required,
+      llvm::cl::desc("JSON file with an array of fuzzyFind requests"),
+  };
+  llvm::cl::opt<unsigned> Iterations{
+      "iterations",
+      llvm::cl::init(10),
+      llvm::cl::desc("Number of times to run each request"),
+  };
+
+  void run() override {
+    auto Buffer = llvm::MemoryBuffer::getFile(RequestsFile);
+    if (!Buffer) {
+      llvm::errs() << llvm::formatv("Can't open {0}", RequestsFile) << "\n";
+      return;
+    }
+    auto JSON = llvm::json::parse(Buffer->get()->getBuffer());
+    if (!JSON) {
+      llvm::errs() << llvm::toString(JSON.takeError()) << "\n";
+      return;
+    }
+    if (!JSON->getAsArray()) {
+      llvm::errs() << "Requests must be a JSON array\n";
+      return;
+    }
+    std::vector<FuzzyFindRequest> Requests;
+    for (const auto &Item : *JSON->getAsArray()) {
+      FuzzyFindRequest Request;
+      llvm::json::Path::Root Root("FuzzyFindRequest");
+      if (!fromJSON(Item, Request, Root)) {
+        llvm::errs() << llvm::toString(Root.getError()) << "\n";
+        return;
+      }
+      Requests.push_back(std::move(Request));
+    }
+    if (Requests.empty())
+      return;
+
+    std::vector<std::chrono::nanoseconds> Latencies;
+    Latencies.reserve(Requests.size() * Iterations);
+    for (unsigned I = 0; I < Iterations; ++I)
+      for (const FuzzyFindRequest &Request : Requests) {
+        const auto Start = std::chrono::steady_clock::now();
+        Index->fuzzyFind(Request, [](const Symbol &) {});
+        Latencies.push_back(std::chrono::steady_clock::now() - Start);
+      }
+    if (Latencies.empty())
+      return;
+    llvm::sort(Latencies);
+    auto Percentile = [&](unsigned P) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(
+          Latencies[(Latencies.size() - 1) * P / 100]);
+    };
+    llvm::outs() << llvm::formatv(
+        "{0} queries: p50 {1:us+n}, p90 {2:us+n}, p99 {3:us+n}, "
+        "max {4:us+n}\n",
+        Latencies.size(), Percentile(50), Percentile(90), Percentile(99),
+        Percentile(100));
+  }
+};
+
 struct {
   const char *Name;
   const char *Description;
@@ -368,6 +432,8 @@ struct {
     {"relations", "Find relations by ID and relation kind",
      std::make_unique<Relations>},
     {"export", "Export index", std::make_unique<Export>},
+    {"bench", "Report the latency percentiles of fuzzyFind requests",
+     std::make_unique<Bench>},
 };
 
 std::unique_ptr<SymbolIndex> openIndex(llvm::StringRef Index) {
@@ -15,13 +15,21 @@
 #include "marshalling/Marshalling.h"
 #include "support/Logger.h"
 #include "support/Trace.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace clang {
 namespace clangd {
@@ -45,25 +53,129 @@ llvm::StringRef toString(const grpc_connectivity_state &State) {
 }
 
 class IndexClient : public clangd::SymbolIndex {
-  void updateConnectionStatus() const {
-    auto NewStatus = Channel->GetState(/*try_to_connect=*/false);
-    auto OldStatus = ConnectionStatus.exchange(NewStatus);
+  /// A server serving the same index as the others.
+  struct Replica {
+    Replica(std::shared_ptr<grpc::Channel> Channel, llvm::StringRef Address)
+        : Stub(remote::v1::SymbolIndex::NewStub(Channel)), Channel(Channel),
+          Address(Address),
+          ConnectionStatus(Channel->GetState(/*try_to_connect=*/true)) {}
+
+    std::unique_ptr<remote::v1::SymbolIndex::Stub> Stub;
+    std::shared_ptr<grpc::Channel> Channel;
+    llvm::SmallString<256> Address;
+    mutable std::atomic<grpc_connectivity_state> ConnectionStatus;
+  };
+
+  void updateConnectionStatus(const Replica &R) const {
+    auto NewStatus = R.Channel->GetState(/*try_to_connect=*/false);
+    auto OldStatus = R.ConnectionStatus.exchange(NewStatus);
     if (OldStatus != NewStatus)
-      vlog("Remote index connection [{0}]: {1} => {2}", ServerAddress,
+      vlog("Remote index connection [{0}]: {1} => {2}", R.Address,
            toString(OldStatus), toString(NewStatus));
   }
 
+  void prepareContext(grpc::ClientContext &Context,
+                      std::chrono::system_clock::time_point Deadline) const {
+    Context.AddMetadata("version", versionString());
+    Context.AddMetadata("features", featureString());
+    Context.AddMetadata("platform", platformString());
+    Context.set_deadline(Deadline);
+  }
+
   template <typename RequestT, typename ReplyT>
   using StreamingCall = std::unique_ptr<grpc::ClientReader<ReplyT>> (
       remote::v1::SymbolIndex::Stub::*)(grpc::ClientContext *,
                                         const RequestT &);
 
+  /// The request to a replica, buffering its replies.
+  template <typename ReplyT> struct Attempt {
+    const Replica *Server;
+    grpc::ClientContext Context;
+    std::vector<ReplyT> Replies;
+    grpc::Status Status;
+  };
+
+  /// Sends \p RPCRequest to the replicas, starting with \p First, and passes
+  /// the replies of the first one to answer successfully to \p OnReply.
+  /// Another replica is only asked if the previous ones did not answer within
+  /// HedgingDelay, or failed. The other requests are cancelled once there is
+  /// an answer. Returns the replica that answered, or the first one if none
+  /// did.
+  template <typename RequestT, typename ReplyT>
+  const Replica &
+  hedgedRPC(const RequestT &RPCRequest, StreamingCall<RequestT, ReplyT> RPCCall,
+            size_t First, std::chrono::system_clock::time_point Deadline,
+            llvm::function_ref<void(const ReplyT &)> OnReply,
+            grpc::Status &Status) const {
+    std::vector<std::unique_ptr<Attempt<ReplyT>>> Attempts;
+    std::vector<std::thread> Threads;
+    std::mutex Mu;
+    std::condition_variable CV;
+    size_t Finished = 0;           // GUARDED_BY(Mu)
+    llvm::Optional<size_t> Winner; // GUARDED_BY(Mu)
+    auto Start = [&] {
+      size_t I = Attempts.size();
+      Attempts.push_back(std::make_unique<Attempt<ReplyT>>());
+      Attempt<ReplyT> &A = *Attempts.back();
+      A.Server = Replicas[(First + I) % Replicas.size()].get();
+      prepareContext(A.Context, Deadline);
+      Threads.emplace_back([&, &A = A, I, RPCCall] {
+        auto Reader = (A.Server->Stub.get()->*RPCCall)(&A.Context, RPCRequest);
+        ReplyT Reply;
+        while (Reader->Read(&Reply))
+          A.Replies.push_back(std::move(Reply));
+        A.Status = Reader->Finish();
+        std::lock_guard<std::mutex> Lock(Mu);
+        ++Finished;
+        if (!Winner && A.Status.ok())
+          Winner = I;
+        CV.notify_all();
+      });
+    };
+
+    {
+      std::unique_lock<std::mutex> Lock(Mu);
+      Start();
+      auto Done = [&] { return Winner || Finished == Attempts.size(); };
+      while (!Winner) {
+        bool AllFailed = Finished == Attempts.size();
+        if (Attempts.size() == Replicas.size()) {
+          if (AllFailed)
+            break;
+          CV.wait(Lock, Done);
+          continue;
+        }
+        // Wait a bit for the replicas already asked before hedging, unless
+        // they all failed already.
+        if (!AllFailed && CV.wait_for(Lock, HedgingDelay, Done))
+          continue;
+        vlog("Remote index: hedging {0} to {1}", RequestT::descriptor()->name(),
+             Replicas[(First + Attempts.size()) % Replicas.size()]->Address);
+        Start();
+      }
+    }
+    // Requests still in flight only complete once cancelled, and threads can
+    // be joined.
+    for (auto &A : Attempts)
+      A->Context.TryCancel();
+    for (auto &T : Threads)
+      T.join();
+
+    Attempt<ReplyT> &Answer = *Attempts[Winner.getValueOr(0)];
+    for (const ReplyT &Reply : Answer.Replies)
+      OnReply(Reply);
+    Status = Answer.Status;
+    return *Answer.Server;
+  }
+
   template <typename RequestT, typename ReplyT, typename ClangdRequestT,
             typename CallbackT>
   bool streamRPC(ClangdRequestT Request,
                  StreamingCall<RequestT, ReplyT> RPCCall,
                  CallbackT Callback) const {
-    updateConnectionStatus();
+    // Spread the requests over the replicas.
+    size_t First = NextReplica++ % Replicas.size();
+    updateConnectionStatus(*Replicas[First]);
     // We initialize to true because stream might be broken before we see the
     // final message. In such a case there are actually more results on the
     // stream, but we couldn't get to them.
@@ -71,24 +183,17 @@ class IndexClient : public clangd::SymbolIndex {
     trace::Span Tracer(RequestT::descriptor()->name());
     const auto RPCRequest = ProtobufMarshaller->toProtobuf(Request);
     SPAN_ATTACH(Tracer, "Request", RPCRequest.DebugString());
-    grpc::ClientContext Context;
-    Context.AddMetadata("version", versionString());
-    Context.AddMetadata("features", featureString());
-    Context.AddMetadata("platform", platformString());
     std::chrono::system_clock::time_point StartTime =
         std::chrono::system_clock::now();
     auto Deadline = StartTime + DeadlineWaitingTime;
-    Context.set_deadline(Deadline);
-    auto Reader = (Stub.get()->*RPCCall)(&Context, RPCRequest);
     dlog("Sending {0}: {1}", RequestT::descriptor()->name(),
          RPCRequest.DebugString());
-    ReplyT Reply;
     unsigned Successful = 0;
     unsigned FailedToParse = 0;
-    while (Reader->Read(&Reply)) {
+    auto OnReply = [&](const ReplyT &Reply) {
       if (!Reply.has_stream_result()) {
         HasMore = Reply.final_result().has_more();
-        continue;
+        return;
       }
       auto Response = ProtobufMarshaller->fromProtobuf(Reply.stream_result());
       if (!Response) {
@@ -96,35 +201,51 @@ class IndexClient : public clangd::SymbolIndex {
              ReplyT::descriptor()->name(), Reply.stream_result().DebugString(),
              Response.takeError());
         ++FailedToParse;
-        continue;
+        return;
       }
       Callback(*Response);
       ++Successful;
+    };
+    const Replica *Server = Replicas[First].get();
+    grpc::Status Status;
+    if (Replicas.size() == 1) {
+      // Stream the results as they come.
+      grpc::ClientContext Context;
+      prepareContext(Context, Deadline);
+      auto Reader = (Server->Stub.get()->*RPCCall)(&Context, RPCRequest);
+      ReplyT Reply;
+      while (Reader->Read(&Reply))
+        OnReply(Reply);
+      Status = Reader->Finish();
+    } else {
+      Server = &hedgedRPC<RequestT, ReplyT>(RPCRequest, RPCCall, First,
+                                            Deadline, OnReply, Status);
     }
     auto Millis = std::chrono::duration_cast<std::chrono::milliseconds>(
                       std::chrono::system_clock::now() - StartTime)
                       .count();
-    vlog("Remote index [{0}]: {1} => {2} results in {3}ms.", ServerAddress,
+    vlog("Remote index [{0}]: {1} => {2} results in {3}ms.", Server->Address,
          RequestT::descriptor()->name(), Successful, Millis);
-    SPAN_ATTACH(Tracer, "Status", Reader->Finish().ok());
+    SPAN_ATTACH(Tracer, "Status", Status.ok());
     SPAN_ATTACH(Tracer, "Successful", Successful);
     SPAN_ATTACH(Tracer, "Failed to parse", FailedToParse);
-    updateConnectionStatus();
+    updateConnectionStatus(*Server);
     return HasMore;
   }
 
 public:
   IndexClient(
-      std::shared_ptr<grpc::Channel> Channel, llvm::StringRef Address,
-      llvm::StringRef ProjectRoot,
-      std::chrono::milliseconds DeadlineTime = std::chrono::milliseconds(1000))
-      : Stub(remote::v1::SymbolIndex::NewStub(Channel)), Channel(Channel),
-        ServerAddress(Address),
-        ConnectionStatus(Channel->GetState(/*try_to_connect=*/true)),
-        ProtobufMarshaller(new Marshaller(/*RemoteIndexRoot=*/"",
+      llvm::ArrayRef<std::shared_ptr<grpc::Channel>> Channels,
+      llvm::ArrayRef<llvm::StringRef> Addresses, llvm::StringRef ProjectRoot,
+      std::chrono::milliseconds DeadlineTime = std::chrono::milliseconds(1000),
+      std::chrono::milliseconds HedgingDelay = std::chrono::milliseconds(50))
+      : ProtobufMarshaller(new Marshaller(/*RemoteIndexRoot=*/"",
                                           /*LocalIndexRoot=*/ProjectRoot)),
-        DeadlineWaitingTime(DeadlineTime) {
+        DeadlineWaitingTime(DeadlineTime), HedgingDelay(HedgingDelay) {
     assert(!ProjectRoot.empty());
+    assert(!Channels.empty() && Channels.size() == Addresses.size());
+    for (size_t I = 0; I < Channels.size(); ++I)
+      Replicas.push_back(std::make_unique<Replica>(Channels[I], Addresses[I]));
   }
 
   void lookup(const clangd::LookupRequest &Request,
@@ -171,23 +292,32 @@ public:
   size_t estimateMemoryUsage() const override { return 0; }
 
 private:
-  std::unique_ptr<remote::v1::SymbolIndex::Stub> Stub;
-  std::shared_ptr<grpc::Channel> Channel;
-  llvm::SmallString<256> ServerAddress;
-  mutable std::atomic<grpc_connectivity_state> ConnectionStatus;
+  std::vector<std::unique_ptr<Replica>> Replicas;
+  mutable std::atomic<size_t> NextReplica = {0};
   std::unique_ptr<Marshaller> ProtobufMarshaller;
   // Each request will be terminated if it takes too long.
   std::chrono::milliseconds DeadlineWaitingTime;
+  // Time to wait for a replica to answer before asking the next one.
+  std::chrono::milliseconds HedgingDelay;
 };
 
 } // namespace
 
 std::unique_ptr<clangd::SymbolIndex> getClient(llvm::StringRef Address,
                                                llvm::StringRef ProjectRoot) {
-  const auto Channel =
-      grpc::CreateChannel(Address.str(), grpc::InsecureChannelCredentials());
+  // Several replicas of the index server can be given, separated by commas.
+  llvm::SmallVector<llvm::StringRef> Addresses;
+  Address.split(Addresses, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (llvm::StringRef &ReplicaAddress : Addresses)
+    ReplicaAddress = ReplicaAddress.trim();
+  if (Addresses.empty())
+    return nullptr;
+  std::vector<std::shared_ptr<grpc::Channel>> Channels;
+  for (llvm::StringRef ReplicaAddress : Addresses)
+    Channels.push_back(grpc::CreateChannel(ReplicaAddress.str(),
+                                           grpc::InsecureChannelCredentials()));
   return std::unique_ptr<clangd::SymbolIndex>(
-      new IndexClient(Channel, Address, ProjectRoot));
+      new IndexClient(Channels, Addresses, ProjectRoot));
 }
 
 } // namespace remote
@@ -18,6 +18,10 @@ namespace remote {
 
 /// Returns an SymbolIndex client that passes requests to remote index located
 /// at \p Address. The client allows synchronous RPC calls.
+/// \p Address can be a comma-separated list of replicas of the same index.
+/// Requests are then spread over the replicas, and hedged: if a replica is
+/// slow to answer, the request is also sent to the next one, and the first
+/// answer is used.
 /// \p IndexRoot is an absolute path on the local machine to the source tree
 /// described by the remote index. Paths returned by the index will be treated
 /// as relative to this directory.
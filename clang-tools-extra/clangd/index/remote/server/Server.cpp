@@ -143,6 +143,10 @@ private:
     unsigned FailedToSend = 0;
     bool HasMore = false;
     Index.lookup(*Req, [&](const clangd::Symbol &Item) {
+      // The client is gone, e.g. its deadline passed or it got the answer
+      // from another replica. Don't spend time on serializing results.
+      if (Context->IsCancelled())
+        return;
       if (Sent >= LimitResults) {
         HasMore = true;
         return;
@@ -193,6 +197,8 @@ private:
     unsigned Sent = 0;
     unsigned FailedToSend = 0;
     bool HasMore = Index.fuzzyFind(*Req, [&](const clangd::Symbol &Item) {
+      if (Context->IsCancelled())
+        return;
       auto SerializedItem = ProtobufMarshaller->toProtobuf(Item);
       if (!SerializedItem) {
         elog("Unable to convert Symbol to protobuf: {0}",
@@ -235,6 +241,8 @@ private:
     unsigned Sent = 0;
     unsigned FailedToSend = 0;
     bool HasMore = Index.refs(*Req, [&](const clangd::Ref &Item) {
+      if (Context->IsCancelled())
+        return;
       auto SerializedItem = ProtobufMarshaller->toProtobuf(Item);
       if (!SerializedItem) {
         elog("Unable to convert Ref to protobuf: {0}",
@@ -281,6 +289,8 @@ private:
     unsigned FailedToSend = 0;
     Index.relations(
         *Req, [&](const SymbolID &Subject, const clangd::Symbol &Object) {
+          if (Context->IsCancelled())
+            return;
           auto SerializedItem = ProtobufMarshaller->toProtobuf(Subject, Object);
           if (!SerializedItem) {
             elog("Unable to convert Relation to protobuf: {0}",
@@ -334,8 +344,10 @@ private:
 
 class Monitor final : public v1::Monitor::Service {
 public:
-  Monitor(llvm::sys::TimePoint<> IndexAge)
-      : StartTime(std::chrono::system_clock::now()), IndexBuildTime(IndexAge) {}
+  Monitor(llvm::sys::TimePoint<> IndexAge,
+          const clangd::trace::MetricsRegistry &Metrics)
+      : StartTime(std::chrono::system_clock::now()), IndexBuildTime(IndexAge),
+        Metrics(Metrics) {}
 
   void updateIndex(llvm::sys::TimePoint<> UpdateTime) {
     IndexBuildTime.exchange(UpdateTime);
@@ -359,11 +371,23 @@ private:
         std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::system_clock::now() - IndexBuildTime.load())
             .count());
+    for (const auto &Summary : Metrics.summaries()) {
+      auto *Metric = Reply->add_metrics();
+      Metric->set_metric(Summary.Metric);
+      Metric->set_label(Summary.Label);
+      Metric->set_count(Summary.Count);
+      Metric->set_mean(Summary.Mean);
+      Metric->set_p50(Summary.P50);
+      Metric->set_p90(Summary.P90);
+      Metric->set_p99(Summary.P99);
+      Metric->set_max(Summary.Max);
+    }
     return grpc::Status::OK;
   }
 
   const llvm::sys::TimePoint<> StartTime;
   std::atomic<llvm::sys::TimePoint<>> IndexBuildTime;
+  const clangd::trace::MetricsRegistry &Metrics;
 };
 
 void maybeTrimMemory() {
@@ -514,17 +538,22 @@ int main(int argc, char *argv[]) {
       TracerStream.reset();
       elog("Error while opening trace file {0}: {1}", TraceFile, EC.message());
     } else {
-      // FIXME(kirillbobyrev): Also create metrics tracer to track latency and
-      // accumulate other request statistics.
       Tracer = clang::clangd::trace::createJSONTracer(*TracerStream,
                                                       /*PrettyPrint=*/false);
       clang::clangd::vlog("Successfully created a tracer.");
     }
   }
 
-  llvm::Optional<clang::clangd::trace::Session> TracingSession;
-  if (Tracer)
-    TracingSession.emplace(*Tracer);
+  // Request latencies are always aggregated, for the monitoring service.
+  clang::clangd::trace::MetricsRegistry Metrics;
+  clang::clangd::trace::EventTracer *ActiveTracer = &Metrics;
+  std::unique_ptr<clang::clangd::trace::EventTracer> MultiplexTracer;
+  if (Tracer) {
+    MultiplexTracer =
+        clang::clangd::trace::createMultiplexTracer({Tracer.get(), &Metrics});
+    ActiveTracer = MultiplexTracer.get();
+  }
+  clang::clangd::trace::Session TracingSession(*ActiveTracer);
 
   clang::clangd::RealThreadsafeFS TFS;
   auto FS = TFS.view(llvm::None);
@@ -542,7 +571,7 @@ int main(int argc, char *argv[]) {
   }
   clang::clangd::SwapIndex Index(std::move(SymIndex));
 
-  Monitor Monitor(Status->getLastModificationTime());
+  Monitor Monitor(Status->getLastModificationTime(), Metrics);
 
   std::thread HotReloadThread([&Index, &Status, &FS, &Monitor]() {
     llvm::vfs::Status LastStatus = *Status;
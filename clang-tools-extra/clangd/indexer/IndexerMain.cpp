@@ -38,6 +38,12 @@ static llvm::cl::opt<IndexFileFormat>
                                        "binary RIFF format")),
            llvm::cl::init(IndexFileFormat::RIFF));
 
+static llvm::cl::opt<bool> DexPostingLists(
+    "dex-posting-lists",
+    llvm::cl::desc("Also write the Dex posting lists of the symbols, so that "
+                   "clangd can load the index without building them"),
+    llvm::cl::init(false));
+
 class IndexActionFactory : public tooling::FrontendActionFactory {
 public:
   IndexActionFactory(IndexFileIn &Result) : Result(Result) {}
@@ -155,6 +161,7 @@ int main(int argc, const char **argv) {
   // Emit collected data.
   clang::clangd::IndexFileOut Out(Data);
   Out.Format = clang::clangd::Format;
+  Out.DexPostingLists = clang::clangd::DexPostingLists;
   llvm::outs() << Out;
   return 0;
 }
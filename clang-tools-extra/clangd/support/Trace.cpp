@@ -17,6 +17,8 @@
 #include "llvm/Support/Threading.h"
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <mutex>
 
@@ -255,6 +257,67 @@ private:
 
 Key<std::unique_ptr<JSONTracer::JSONSpan>> JSONTracer::SpanKey;
 
+class MultiplexTracer : public EventTracer {
+public:
+  MultiplexTracer(std::vector<EventTracer *> Tracers)
+      : Tracers(std::move(Tracers)) {}
+
+  Context beginSpan(
+      llvm::StringRef Name,
+      llvm::function_ref<void(llvm::json::Object *)> AttachDetails) override {
+    bool Attached = false;
+    auto AttachOnce = [&](llvm::json::Object *Args) {
+      if (!Attached)
+        AttachDetails(Args);
+      Attached = true;
+    };
+    // Each tracer derives the context of the span from the previous one.
+    Context Ctx = Context::current().clone();
+    for (EventTracer *Tracer : Tracers) {
+      WithContext Parent(std::move(Ctx));
+      Ctx = Tracer->beginSpan(Name, AttachOnce);
+    }
+    return Ctx;
+  }
+
+  void endSpan() override {
+    for (EventTracer *Tracer : Tracers)
+      Tracer->endSpan();
+  }
+
+  void instant(llvm::StringRef Name, llvm::json::Object &&Args) override {
+    for (EventTracer *Tracer : Tracers)
+      Tracer->instant(Name, llvm::json::Object(Args));
+  }
+
+  void record(const Metric &Metric, double Value,
+              llvm::StringRef Label) override {
+    for (EventTracer *Tracer : Tracers)
+      Tracer->record(Metric, Value, Label);
+  }
+
+private:
+  std::vector<EventTracer *> Tracers;
+};
+
+// The bucket of a measurement and the largest value that falls in it.
+int bucketOf(double Value) {
+  if (!(Value > 0))
+    return std::numeric_limits<int>::min();
+  int Exp;
+  double Mantissa = std::frexp(Value, &Exp); // In [0.5, 1).
+  int Sub = (Mantissa - 0.5) * 2 * MetricsRegistry::SubBuckets;
+  return Exp * int(MetricsRegistry::SubBuckets) + Sub;
+}
+double bucketUpperBound(int Bucket) {
+  if (Bucket == std::numeric_limits<int>::min())
+    return 0;
+  const int N = MetricsRegistry::SubBuckets;
+  int Exp = Bucket >= 0 ? Bucket / N : (Bucket - N + 1) / N;
+  int Sub = Bucket - Exp * N;
+  return std::ldexp(0.5 + double(Sub + 1) / (2 * N), Exp);
+}
+
 EventTracer *T = nullptr;
 } // namespace
 
@@ -274,6 +337,60 @@ std::unique_ptr<EventTracer> createCSVMetricTracer(llvm::raw_ostream &OS) {
   return std::make_unique<CSVMetricTracer>(OS);
 }
 
+std::unique_ptr<EventTracer>
+createMultiplexTracer(std::vector<EventTracer *> Tracers) {
+  return std::make_unique<MultiplexTracer>(std::move(Tracers));
+}
+
+constexpr unsigned MetricsRegistry::SubBuckets;
+
+void MetricsRegistry::record(const Metric &Metric, double Value,
+                             llvm::StringRef Label) {
+  if (Metric.Type != Metric::Distribution)
+    return;
+  std::lock_guard<std::mutex> Lock(Mu);
+  Histogram &H = Histograms[{Metric.Name.str(), Label.str()}];
+  ++H.Buckets[bucketOf(Value)];
+  ++H.Count;
+  H.Sum += Value;
+  H.Max = std::max(H.Max, Value);
+}
+
+std::vector<MetricsRegistry::Summary> MetricsRegistry::summaries() const {
+  std::lock_guard<std::mutex> Lock(Mu);
+  std::vector<Summary> Result;
+  for (const auto &Entry : Histograms) {
+    const Histogram &H = Entry.second;
+    Summary S;
+    S.Metric = Entry.first.first;
+    S.Label = Entry.first.second;
+    S.Count = H.Count;
+    S.Mean = H.Sum / H.Count;
+    S.Max = H.Max;
+    // The percentiles are the upper bounds of the buckets they fall in.
+    std::pair<double, double *> Percentiles[] = {
+        {0.5, &S.P50}, {0.9, &S.P90}, {0.99, &S.P99}};
+    auto *Next = std::begin(Percentiles);
+    uint64_t Seen = 0;
+    for (const auto &Bucket : H.Buckets) {
+      Seen += Bucket.second;
+      for (; Next != std::end(Percentiles) && Seen >= Next->first * H.Count;
+           ++Next)
+        *Next->second = std::min(bucketUpperBound(Bucket.first), H.Max);
+    }
+    Result.push_back(std::move(S));
+  }
+  return Result;
+}
+
+llvm::json::Value toJSON(const MetricsRegistry::Summary &S) {
+  return llvm::json::Object{
+      {"metric", S.Metric}, {"label", S.Label}, {"count", int64_t(S.Count)},
+      {"mean", S.Mean},     {"p50", S.P50},     {"p90", S.P90},
+      {"p99", S.P99},       {"max", S.Max},
+  };
+}
+
 void log(const llvm::Twine &Message) {
   if (!T)
     return;
@@ -23,6 +23,8 @@
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 #include <chrono>
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -125,6 +127,57 @@ std::unique_ptr<EventTracer> createJSONTracer(llvm::raw_ostream &OS,
 /// Trace spans and instant events are ignored.
 std::unique_ptr<EventTracer> createCSVMetricTracer(llvm::raw_ostream &OS);
 
+/// Create an instance of EventTracer that forwards all events to \p Tracers,
+/// which must outlive it. Details attached to spans are only provided to the
+/// first of them that asks for them.
+std::unique_ptr<EventTracer>
+createMultiplexTracer(std::vector<EventTracer *> Tracers);
+
+/// An EventTracer that aggregates the measurements of Distribution metrics
+/// in memory, such as the latencies of LSP methods and spans, so that their
+/// percentiles can be reported by clangd itself.
+///
+/// Each metric and label has a histogram in the style of HdrHistogram: buckets
+/// are log-linear, splitting each power of two in SubBuckets, so percentiles
+/// are within 1/SubBuckets of the recorded values whatever their magnitude.
+class MetricsRegistry : public EventTracer {
+public:
+  static constexpr unsigned SubBuckets = 16;
+
+  struct Summary {
+    std::string Metric;
+    std::string Label;
+    uint64_t Count = 0;
+    double Mean = 0;
+    double P50 = 0;
+    double P90 = 0;
+    double P99 = 0;
+    double Max = 0;
+  };
+
+  void record(const Metric &Metric, double Value,
+              llvm::StringRef Label) override;
+
+  /// Summaries of all the metrics and labels with measurements, sorted by
+  /// metric and label.
+  std::vector<Summary> summaries() const;
+
+private:
+  struct Histogram {
+    // Bucket index to number of measurements. Non-positive values are counted
+    // in bucket INT_MIN.
+    std::map<int, uint64_t> Buckets;
+    uint64_t Count = 0;
+    double Sum = 0;
+    double Max = 0;
+  };
+
+  mutable std::mutex Mu;
+  std::map<std::pair<std::string, std::string>, Histogram>
+      Histograms /*GUARDED_BY(Mu)*/;
+};
+llvm::json::Value toJSON(const MetricsRegistry::Summary &);
+
 /// Records a single instant event, associated with the current thread.
 void log(const llvm::Twine &Name);
 
@@ -398,6 +398,32 @@ opt<PCHStorageFlag> PCHStorage{
     init(PCHStorageFlag::Disk),
 };
 
+opt<bool> SharePreambles{
+    "share-preambles",
+    cat(Misc),
+    desc("Build a single preamble for open files in the same directory that "
+         "start with the same includes and have the same compile flags"),
+    init(true),
+    Hidden,
+};
+
+opt<bool> ReuseCompletionResults{
+    "reuse-completion-results",
+    cat(Misc),
+    desc("Answer code completion requests for a longer prefix of the same "
+         "identifier by refiltering the previous results"),
+    init(true),
+    Hidden,
+};
+
+opt<bool> CollectMetrics{
+    "collect-metrics",
+    cat(Misc),
+    desc("Keep latency histograms of LSP methods and internal operations, "
+         "provided through the $/clangd/metrics extension"),
+    init(false),
+};
+
 opt<bool> Sync{
     "sync",
     cat(Misc),
@@ -525,7 +551,8 @@ std::function<void()> getMemoryCleanupFunction() { return nullptr; }
 opt<std::string> RemoteIndexAddress{
     "remote-index-address",
     cat(Features),
-    desc("Address of the remote index server"),
+    desc("Address of the remote index server, or comma-separated addresses "
+         "of its replicas"),
 };
 
 // FIXME(kirillbobyrev): Should this be the location of compile_commands.json?
@@ -804,8 +831,18 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     }
   }
 
+  // Metrics are aggregated in memory alongside any tracer set in the
+  // environment.
+  trace::MetricsRegistry Metrics;
+  std::unique_ptr<trace::EventTracer> MultiplexTracer;
+  if (CollectMetrics && Tracer)
+    MultiplexTracer = trace::createMultiplexTracer({Tracer.get(), &Metrics});
   llvm::Optional<trace::Session> TracingSession;
-  if (Tracer)
+  if (MultiplexTracer)
+    TracingSession.emplace(*MultiplexTracer);
+  else if (CollectMetrics)
+    TracingSession.emplace(Metrics);
+  else if (Tracer)
     TracingSession.emplace(*Tracer);
 
   // If a user ran `clangd` in a terminal without redirecting anything,
@@ -848,6 +885,7 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     Opts.StorePreamblesInMemory = false;
     break;
   }
+  Opts.SharePreambles = SharePreambles;
   if (!ResourceDir.empty())
     Opts.ResourceDir = ResourceDir;
   Opts.BuildDynamicSymbolIndex = true;
@@ -870,6 +908,8 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
 #endif
   Opts.BackgroundIndex = EnableBackgroundIndex;
   Opts.ReferencesLimit = ReferencesLimit;
+  if (CollectMetrics)
+    Opts.Metrics = &Metrics;
   auto PAI = createProjectAwareIndex(loadExternalIndex, Sync);
   if (StaticIdx) {
     IdxStack.emplace_back(std::move(StaticIdx));
@@ -896,6 +936,7 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
   Opts.CodeComplete.EnableFunctionArgSnippets = EnableFunctionArgSnippets;
   Opts.CodeComplete.RunParser = CodeCompletionParse;
   Opts.CodeComplete.RankingModel = RankingModel;
+  Opts.ReuseCompletionResults = ReuseCompletionResults;
 
   RealThreadsafeFS TFS;
   std::vector<std::unique_ptr<config::Provider>> ProviderStack;
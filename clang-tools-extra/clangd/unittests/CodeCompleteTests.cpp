@@ -1115,6 +1115,51 @@ template <typename T> void foo(Templ<T> &t) {
   EXPECT_THAT(Completions, Contains(named("xxx")));
 }
 
+TEST(CompletionTest, ReuseSession) {
+  MockFS FS;
+  auto TU = TestTU::withCode("int xyz1, xyz2, xab;");
+  auto Inputs = TU.inputs(FS);
+  IgnoreDiagnostics Diags;
+  auto CI = buildCompilerInvocation(Inputs, Diags);
+  ASSERT_TRUE(CI);
+  auto Preamble = buildPreamble(testPath(TU.Filename), *CI, Inputs,
+                                /*InMemory=*/true, /*Callback=*/nullptr);
+  ASSERT_TRUE(Preamble);
+  std::shared_ptr<const CompletionSession> Session;
+  auto Complete = [&](llvm::StringRef Code, CodeCompleteOptions Opts) {
+    Annotations Test(Code);
+    Inputs.Contents = Test.code().str();
+    return codeComplete(testPath(TU.Filename), Test.point(), Preamble.get(),
+                        Inputs, Opts, /*SpecFuzzyFind=*/nullptr, &Session);
+  };
+
+  auto Results = Complete("int xyz1, xyz2, xab; int a = x^;", {});
+  EXPECT_FALSE(Results.HasMore);
+  EXPECT_THAT(Results.Completions,
+              AllOf(has("xyz1"), has("xyz2"), has("xab")));
+  ASSERT_TRUE(Session);
+  EXPECT_EQ(Session->Filter, "x");
+
+  // Extending the identifier refilters the results of the session, which
+  // still holds all of them when they don't fit within the limit.
+  CodeCompleteOptions Limited;
+  Limited.Limit = 1;
+  Results = Complete("int xyz1, xyz2, xab; int a = xyz^;", Limited);
+  EXPECT_TRUE(Results.HasMore);
+  ASSERT_EQ(Results.Completions.size(), 1u);
+  EXPECT_THAT(Results.Completions[0].Name, testing::StartsWith("xyz"));
+  EXPECT_EQ(Results.Completions[0].CompletionTokenRange.end.character, 32);
+  ASSERT_TRUE(Session);
+  EXPECT_EQ(Session->Filter, "xyz");
+  EXPECT_THAT(Session->Result.Completions,
+              UnorderedElementsAre(named("xyz1"), named("xyz2")));
+
+  // Any other edit runs Sema again, and incomplete results aren't kept.
+  Results = Complete("int xyz1, xyz2, xab; int b = xyz^;", Limited);
+  EXPECT_TRUE(Results.HasMore);
+  EXPECT_FALSE(Session);
+}
+
 TEST(CompletionTest, RecordCCResultCallback) {
   std::vector<CodeCompletion> RecordedCompletions;
   CodeCompleteOptions Opts;
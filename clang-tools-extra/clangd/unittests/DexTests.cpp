@@ -14,6 +14,7 @@
 #include "index/dex/Iterator.h"
 #include "index/dex/Token.h"
 #include "index/dex/Trigram.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -65,6 +66,23 @@ TEST(DexIterators, DocumentIterator) {
   EXPECT_TRUE(DocIterator->reachedEnd());
 }
 
+TEST(DexIterators, DocumentIteratorAcrossChunks) {
+  // Multiples of 3 up to 30000 span many chunks.
+  std::vector<DocID> Docs;
+  for (DocID D = 0; D <= 30000; D += 3)
+    Docs.push_back(D);
+  const PostingList L(Docs);
+  auto DocIterator = L.iterator();
+
+  for (DocID ID : {1, 2, 3, 100, 101, 600, 603, 700, 20000, 29998}) {
+    DocIterator->advanceTo(ID);
+    ASSERT_FALSE(DocIterator->reachedEnd());
+    EXPECT_EQ(DocIterator->peek(), (ID + 2) / 3 * 3);
+  }
+  DocIterator->advance();
+  EXPECT_TRUE(DocIterator->reachedEnd());
+}
+
 TEST(DexIterators, AndTwoLists) {
   Corpus C{10000};
   const PostingList L0({0, 5, 7, 10, 42, 320, 9000});
@@ -510,6 +528,44 @@ TEST(Dex, FuzzyFind) {
                                    "other::A"));
 }
 
+TEST(Dex, PostingLists) {
+  std::vector<std::string> Names = {"ns::ABC", "ns::BCD", "::ABC",
+                                    "ns::nested::ABC", "other::ABC",
+                                    "other::A"};
+  SymbolSlab Symbols = generateSymbols(Names);
+  std::string Lists;
+  {
+    llvm::raw_string_ostream OS(Lists);
+    Dex(Symbols, RefSlab(), RelationSlab()).writePostingLists(OS);
+  }
+  auto Buffer = llvm::MemoryBuffer::getMemBufferCopy(Lists);
+  llvm::StringRef Data = Buffer->getBuffer();
+  auto Index = Dex::build(generateSymbols(Names), RefSlab(), RelationSlab(),
+                          Data, std::move(Buffer));
+  FuzzyFindRequest Req;
+  Req.Query = "ABC";
+  Req.Scopes = {"ns::", "ns::nested::"};
+  EXPECT_THAT(match(*Index, Req),
+              UnorderedElementsAre("ns::ABC", "ns::nested::ABC"));
+  Req.Query = "A";
+  Req.Scopes = {"other::"};
+  EXPECT_THAT(match(*Index, Req),
+              UnorderedElementsAre("other::A", "other::ABC"));
+
+  // Lists of other symbols, or corrupt lists, are ignored.
+  Index = Dex::build(generateSymbols({"ns::ABC", "other::A"}), RefSlab(),
+                     RelationSlab(), Lists,
+                     llvm::MemoryBuffer::getMemBuffer(""));
+  EXPECT_THAT(match(*Index, Req), UnorderedElementsAre("other::A"));
+  // Make the head of the first chunk out of the bounds of the symbols.
+  std::string Corrupt = Lists;
+  Corrupt[23] = 0x7f;
+  Index = Dex::build(generateSymbols(Names), RefSlab(), RelationSlab(),
+                     Corrupt, llvm::MemoryBuffer::getMemBuffer(""));
+  EXPECT_THAT(match(*Index, Req),
+              UnorderedElementsAre("other::A", "other::ABC"));
+}
+
 TEST(DexTest, DexLimitedNumMatches) {
   auto I = Dex::build(generateNumSymbols(0, 100), RefSlab(), RelationSlab());
   FuzzyFindRequest Req;
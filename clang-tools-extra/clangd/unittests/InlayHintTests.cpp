@@ -765,6 +765,23 @@ TEST(InlayHints, RestrictRange) {
               ElementsAre(labelIs(": int"), labelIs(": char")));
 }
 
+TEST(InlayHints, RestrictRangeNestedDecls) {
+  Annotations Code(R"cpp(
+    void foo(int param);
+    void before() { auto a = 1; foo(a); }
+    void around() {
+      auto b = 2;
+      [[foo(b);
+      auto c = 3;]]
+      auto d = 4;
+    }
+    void after() { auto e = 5; foo(e); }
+  )cpp");
+  auto AST = TestTU::withCode(Code.code()).build();
+  EXPECT_THAT(inlayHints(AST, Code.range()),
+              ElementsAre(labelIs("param:"), labelIs(": int")));
+}
+
 // FIXME: Low-hanging fruit where we could omit a type hint:
 //  - auto x = TypeName(...);
 //  - auto x = (TypeName) (...);
@@ -25,6 +25,8 @@
 #include "TestFS.h"
 #include "TestTU.h"
 #include "TidyProvider.h"
+#include "support/Cancellation.h"
+#include "support/Context.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/SourceManager.h"
@@ -845,6 +847,24 @@ TEST(ParsedASTTest, DiscoversPragmaMarks) {
                                           pragmaTrivia(" End")));
 }
 
+TEST(ParsedASTTest, Cancelled) {
+  TestTU TU = TestTU::withCode("int x; int y;");
+  MockFS FS;
+  auto Inputs = TU.inputs(FS);
+  StoreDiags Diags;
+  auto CI = buildCompilerInvocation(Inputs, Diags);
+  ASSERT_TRUE(CI);
+  auto Preamble =
+      buildPreamble(testPath(TU.Filename), *CI, Inputs, true, nullptr);
+  ASSERT_TRUE(Preamble);
+
+  auto Task = cancelableTask();
+  WithContext Ctx(std::move(Task.first));
+  Task.second();
+  EXPECT_FALSE(ParsedAST::build(testPath(TU.Filename), Inputs, std::move(CI),
+                                {}, Preamble));
+}
+
 } // namespace
 } // namespace clangd
 } // namespace clang
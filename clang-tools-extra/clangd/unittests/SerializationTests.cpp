@@ -236,6 +236,26 @@ TEST(SerializationTest, BinaryConversions) {
               UnorderedElementsAreArray(yamlFromRelations(*In->Relations)));
 }
 
+TEST(SerializationTest, DexPostingLists) {
+  auto In = readIndexFile(YAML);
+  ASSERT_TRUE(bool(In)) << In.takeError();
+
+  IndexFileOut Out(*In);
+  Out.Format = IndexFileFormat::RIFF;
+  auto In2 = readIndexFile(llvm::to_string(Out));
+  ASSERT_TRUE(bool(In2)) << In2.takeError();
+  EXPECT_TRUE(In2->DexPostingLists.empty());
+
+  Out.DexPostingLists = true;
+  std::string Serialized = llvm::to_string(Out);
+  auto In3 = readIndexFile(Serialized);
+  ASSERT_TRUE(bool(In3)) << In3.takeError();
+  ASSERT_TRUE(In3->Symbols);
+  EXPECT_FALSE(In3->DexPostingLists.empty());
+  EXPECT_THAT(yamlFromSymbols(*In3->Symbols),
+              UnorderedElementsAreArray(yamlFromSymbols(*In->Symbols)));
+}
+
 TEST(SerializationTest, SrcsTest) {
   auto In = readIndexFile(YAML);
   EXPECT_TRUE(bool(In)) << In.takeError();
@@ -631,6 +631,47 @@ TEST_F(TUSchedulerTests, EvictedAST) {
               UnorderedElementsAre(Foo, AnyOf(Bar, Baz)));
 }
 
+// Diagnostics of an evicted file were published already, a read rebuilding its
+// AST doesn't compute them again.
+TEST_F(TUSchedulerTests, EvictedASTWithoutDiagnostics) {
+  auto Opts = optsForTest();
+  Opts.RetentionPolicy.MaxRetainedASTs = 1;
+  TUScheduler S(CDB, Opts, captureDiags());
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  std::atomic<bool> SeenDiags(false);
+  updateWithDiags(S, Foo, "int x = y;", WantDiagnostics::Yes,
+                  [&](std::vector<Diag> Diags) {
+                    EXPECT_THAT(Diags, SizeIs(1));
+                    SeenDiags = true;
+                  });
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  ASSERT_TRUE(SeenDiags);
+  S.update(Bar, getInputs(Bar, "int x;"), WantDiagnostics::Yes);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  ASSERT_THAT(S.getFilesWithCachedAST(), ElementsAre(Bar));
+
+  S.runWithAST("touchAST", Foo, [](Expected<InputsAndAST> IA) {
+    ASSERT_TRUE(bool(IA));
+    EXPECT_FALSE(IA->AST.getDiagnostics());
+  });
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_EQ(S.fileStats().lookup(Foo).ASTBuilds, 2u);
+
+  // The same inputs don't publish diagnostics again, new ones rebuild the AST.
+  updateWithDiags(S, Foo, "int x = y;", WantDiagnostics::Yes,
+                  [](std::vector<Diag>) { ADD_FAILURE() << "Unexpected."; });
+  SeenDiags = false;
+  updateWithDiags(S, Foo, "int x = z;", WantDiagnostics::Yes,
+                  [&](std::vector<Diag> Diags) {
+                    EXPECT_THAT(Diags, SizeIs(1));
+                    SeenDiags = true;
+                  });
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_TRUE(SeenDiags);
+}
+
 // We send "empty" changes to TUScheduler when we think some external event
 // *might* have invalidated current state (e.g. a header was edited).
 // Verify that this doesn't evict our cache entries.
@@ -772,6 +813,44 @@ TEST_F(TUSchedulerTests, RunWaitsForPreamble) {
   ASSERT_THAT(Preambles, Each(Preambles[0]));
 }
 
+TEST_F(TUSchedulerTests, SharesPreambles) {
+  auto Opts = optsForTest();
+  Opts.SharePreambles = true;
+  TUScheduler S(CDB, Opts);
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  auto Baz = testPath("sub/baz.cpp");
+  FS.Files[testPath("foo.h")] = "int a;";
+  FS.Files[testPath("sub/foo.h")] = "int a;";
+
+  auto GetPreamble = [&](PathRef File) {
+    const void *Result = nullptr;
+    S.runWithPreamble("test", File, TUScheduler::Stale,
+                      [&](Expected<InputsAndPreamble> IP) {
+                        Result = cantFail(std::move(IP)).Preamble;
+                      });
+    EXPECT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    return Result;
+  };
+
+  S.update(Foo, getInputs(Foo, "#include \"foo.h\"\nint b = a;"),
+           WantDiagnostics::Yes);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  S.update(Bar, getInputs(Bar, "#include \"foo.h\"\nint c = a;"),
+           WantDiagnostics::Yes);
+  // Quoted includes are resolved next to the main file, files in another
+  // directory can't share the preamble.
+  S.update(Baz, getInputs(Baz, "#include \"foo.h\"\nint b = a;"),
+           WantDiagnostics::Yes);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+
+  const void *FooPreamble = GetPreamble(Foo);
+  ASSERT_NE(FooPreamble, nullptr);
+  EXPECT_EQ(GetPreamble(Bar), FooPreamble);
+  EXPECT_NE(GetPreamble(Baz), FooPreamble);
+  EXPECT_NE(GetPreamble(Baz), nullptr);
+}
+
 TEST_F(TUSchedulerTests, NoopOnEmptyChanges) {
   TUScheduler S(CDB, optsForTest(), captureDiags());
 
@@ -140,6 +140,51 @@ TEST(MetricsTracer, LatencyTest) {
   EXPECT_THAT(Tracer.takeMetric(MetricName, OpName), SizeIs(1));
 }
 
+TEST(MetricsRegistry, Percentiles) {
+  trace::MetricsRegistry Registry;
+  trace::Metric Dist = {"dist", trace::Metric::Distribution, "lbl"};
+  trace::Metric Counter = {"cnt", trace::Metric::Counter};
+  for (int I = 1; I <= 100; ++I)
+    Registry.record(Dist, I, "a");
+  Registry.record(Dist, 0, "b");
+  Registry.record(Counter, 1, "");
+
+  auto Summaries = Registry.summaries();
+  ASSERT_THAT(Summaries, SizeIs(2));
+  const auto &A = Summaries[0];
+  EXPECT_EQ(A.Metric, "dist");
+  EXPECT_EQ(A.Label, "a");
+  EXPECT_EQ(A.Count, 100u);
+  EXPECT_DOUBLE_EQ(A.Mean, 50.5);
+  EXPECT_EQ(A.Max, 100);
+  // Percentiles are rounded up to the bucket of their value.
+  const double Precision = 1 + 1.0 / trace::MetricsRegistry::SubBuckets;
+  EXPECT_GE(A.P50, 50);
+  EXPECT_LE(A.P50, 50 * Precision);
+  EXPECT_GE(A.P90, 90);
+  EXPECT_LE(A.P90, 90 * Precision);
+  EXPECT_GE(A.P99, 99);
+  EXPECT_LE(A.P99, 100);
+  const auto &B = Summaries[1];
+  EXPECT_EQ(B.Label, "b");
+  EXPECT_EQ(B.Count, 1u);
+  EXPECT_EQ(B.P99, 0);
+}
+
+TEST(MultiplexTracer, ForwardsEvents) {
+  trace::MetricsRegistry First, Second;
+  auto Tracer = trace::createMultiplexTracer({&First, &Second});
+  trace::Session Session(*Tracer);
+  { trace::Span S("op_name"); }
+  for (const auto *Registry : {&First, &Second}) {
+    auto Summaries = Registry->summaries();
+    ASSERT_THAT(Summaries, SizeIs(1));
+    EXPECT_EQ(Summaries[0].Metric, "span_latency");
+    EXPECT_EQ(Summaries[0].Label, "op_name");
+    EXPECT_EQ(Summaries[0].Count, 1u);
+  }
+}
+
 class CSVMetricsTracerTest : public ::testing::Test {
 protected:
   CSVMetricsTracerTest()
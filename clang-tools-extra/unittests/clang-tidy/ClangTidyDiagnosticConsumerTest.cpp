@@ -111,6 +111,26 @@ TEST(ClangTidyDiagnosticConsumer, InvalidSourceLocationRangesIgnored) {
   EXPECT_EQ(1ul, Errors[3].Message.Ranges.size());
 }
 
+TEST(ClangTidyDiagnosticConsumer, MergesFilteredErrors) {
+  std::vector<ClangTidyError> First, Second;
+  runCheckOnCode<TestCheck>("int a;", &First);
+  runCheckOnCode<TestCheck>("int a;", &Second);
+  ASSERT_EQ(3ul, First.size());
+
+  ClangTidyContext Context(std::make_unique<DefaultOptionsProvider>(
+      ClangTidyGlobalOptions(), ClangTidyOptions()));
+  ClangTidyDiagnosticConsumer DiagConsumer(Context);
+  DiagConsumer.addFilteredErrors(std::move(First));
+  DiagConsumer.addFilteredErrors(std::move(Second));
+
+  // Diagnostics reported by both translation units are only kept once.
+  std::vector<ClangTidyError> Errors = DiagConsumer.take();
+  EXPECT_EQ(3ul, Errors.size());
+  EXPECT_EQ("DiagWithNoLoc", Errors[0].Message.Message);
+  EXPECT_EQ("type specifier", Errors[1].Message.Message);
+  EXPECT_EQ("variable", Errors[2].Message.Message);
+}
+
 } // namespace test
 } // namespace tidy
 } // namespace clang
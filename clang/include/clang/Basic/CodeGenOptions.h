@@ -58,6 +58,7 @@ public:
     NoLibrary,         // Don't use any vector library.
     Accelerate,        // Use the Accelerate framework.
     LIBMVEC,           // GLIBC vector math library.
+    LLVMLibc,          // LLVM libc vector math functions.
     MASSV,             // IBM MASS vector library.
     SVML,              // Intel short vector math library.
     Darwin_libsystem_m // Use Darwin's libsytem_m vector functions.
@@ -272,6 +273,10 @@ public:
   /// Prefix to use for -save-temps output.
   std::string SaveTempsFilePrefix;
 
+  /// Prefix of the output files for the partitions after the first with
+  /// -fparallel-codegen.
+  std::string ParallelCodeGenOutputPrefix;
+
   /// Name of file passed with -fcuda-include-gpubinary option to forward to
   /// CUDA runtime back-end for incorporating them into host-side object file.
   std::string CudaGpuBinaryFileName;
@@ -24,6 +24,10 @@ public:
   /// If set, paths are resolved as if the working directory was
   /// set to the value of WorkingDir.
   std::string WorkingDir;
+
+  /// If set, the path of a file in which listings of the directories searched
+  /// for files are cached between compiler invocations.
+  std::string HeaderSearchCachePath;
 };
 
 } // end namespace clang
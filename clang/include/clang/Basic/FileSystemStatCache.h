@@ -15,16 +15,20 @@
 #define LLVM_CLANG_BASIC_FILESYSTEMSTATCACHE_H
 
 #include "clang/Basic/LLVM.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/StringSaver.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include <cstdint>
 #include <ctime>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace clang {
 
@@ -83,6 +87,65 @@ public:
                           llvm::vfs::FileSystem &FS) override;
 };
 
+/// A stat cache that answers lookups of missing files from a listing of their
+/// parent directory, so that probing a long list of search paths costs one
+/// 'stat' per directory rather than one per directory and header.
+///
+/// Listings are persisted in the file at \p CachePath, which is memory mapped
+/// when the cache is created and rewritten atomically when it is destroyed, so
+/// that concurrent compiler processes can share it.  A persisted listing is
+/// only trusted while the modification time of its directory is unchanged.
+///
+/// Lookups of files that do exist, and of anything the cache cannot answer
+/// conservatively, are forwarded to the file system.
+class DirectoryListingStatCache : public FileSystemStatCache {
+public:
+  explicit DirectoryListingStatCache(StringRef CachePath);
+  ~DirectoryListingStatCache() override;
+
+  std::error_code getStat(StringRef Path, llvm::vfs::Status &Status,
+                          bool isFile,
+                          std::unique_ptr<llvm::vfs::File> *F,
+                          llvm::vfs::FileSystem &FS) override;
+
+private:
+  struct DirectoryListing {
+    /// The modification time of the directory when it was listed, in
+    /// nanoseconds since the epoch.
+    uint64_t MTime = 0;
+
+    /// The lower-cased names of the directory entries, sorted.
+    std::vector<StringRef> Entries;
+
+    /// Whether the listing was checked against the file system by this
+    /// process.
+    bool Validated = false;
+
+    /// Whether the listing can be used to answer lookups.
+    bool Usable = false;
+
+    /// Whether the listing should be written back to the cache file.
+    bool Persist = false;
+  };
+
+  /// Retrieve the up-to-date listing of \p Dir, or null if \p Dir cannot be
+  /// listed.  \p KnownStatus, if given, is the current status of \p Dir.
+  const DirectoryListing *
+  getListing(StringRef Dir, llvm::vfs::FileSystem &FS,
+             const llvm::vfs::Status *KnownStatus = nullptr);
+
+  void load();
+  void save();
+
+  std::string CachePath;
+  std::unique_ptr<llvm::MemoryBuffer> Buffer;
+  llvm::StringMap<DirectoryListing> Listings;
+  llvm::BumpPtrAllocator Alloc;
+  llvm::StringSaver Saver{Alloc};
+  Optional<std::string> WorkingDir;
+  bool Dirty = false;
+};
+
 } // namespace clang
 
 #endif // LLVM_CLANG_BASIC_FILESYSTEMSTATCACHE_H
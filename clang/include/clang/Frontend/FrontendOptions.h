@@ -249,6 +249,10 @@ public:
   /// Output time trace profile.
   unsigned TimeTrace : 1;
 
+  /// Record AST allocation, deserialization and instantiation depth metrics
+  /// in the time trace profile.
+  unsigned TimeTraceMetrics : 1;
+
   /// Show the -version text.
   unsigned ShowVersion : 1;
 
@@ -461,7 +465,8 @@ public:
 public:
   FrontendOptions()
       : DisableFree(false), RelocatablePCH(false), ShowHelp(false),
-        ShowStats(false), TimeTrace(false), ShowVersion(false),
+        ShowStats(false), TimeTrace(false), TimeTraceMetrics(false),
+        ShowVersion(false),
         FixWhatYouCan(false), FixOnlyWarnings(false), FixAndRecompile(false),
         FixToTemporaries(false), ARCMTMigrateEmitARCErrors(false),
         SkipFunctionBodies(false), UseGlobalModuleIndex(true),
@@ -78,13 +78,21 @@ public:
   ///
   /// \param Callbacks A set of callbacks to be executed when building
   /// the preamble.
+  ///
+  /// \param SharedStorePath If not empty, a directory of preambles shared by
+  /// all processes using it. Preambles are keyed by the preamble contents and
+  /// the compiler options, and the preamble in the store is reused if none of
+  /// the files it was built from changed. Otherwise the preamble is built and
+  /// added to the store, while other processes that need it wait for it.
+  /// \p Callbacks are not run for a preamble reused from the store.
   static llvm::ErrorOr<PrecompiledPreamble>
   Build(const CompilerInvocation &Invocation,
         const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
         DiagnosticsEngine &Diagnostics,
         IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS,
         std::shared_ptr<PCHContainerOperations> PCHContainerOps,
-        bool StoreInMemory, PreambleCallbacks &Callbacks);
+        bool StoreInMemory, PreambleCallbacks &Callbacks,
+        StringRef SharedStorePath = StringRef());
 
   PrecompiledPreamble(PrecompiledPreamble &&) = default;
   PrecompiledPreamble &operator=(PrecompiledPreamble &&) = default;
@@ -133,6 +141,25 @@ private:
                       llvm::StringMap<PreambleFileHash> FilesInPreamble,
                       llvm::StringSet<> MissingFiles);
 
+  /// Build the preamble without consulting a shared store.
+  static llvm::ErrorOr<PrecompiledPreamble>
+  BuildUncached(const CompilerInvocation &Invocation,
+                const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
+                DiagnosticsEngine &Diagnostics,
+                IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS,
+                std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+                bool StoreInMemory, PreambleCallbacks &Callbacks);
+
+  /// Load the preamble stored at \p EntryPath in a shared store, if the files
+  /// it was built from are unchanged in \p VFS.
+  static llvm::Optional<PrecompiledPreamble>
+  loadFromStore(StringRef EntryPath, const llvm::MemoryBuffer *MainFileBuffer,
+                PreambleBounds Bounds, llvm::vfs::FileSystem &VFS,
+                bool StoreInMemory);
+
+  /// Add this preamble to a shared store as \p EntryPath.
+  void addToStore(StringRef EntryPath, llvm::vfs::FileSystem &VFS) const;
+
   /// A temp file that would be deleted on destructor call. If destructor is not
   /// called for any reason, the file will be deleted at static objects'
   /// destruction.
@@ -901,6 +901,11 @@ private:
   SmallVector<Token, 16> MacroExpandedTokens;
   std::vector<std::pair<TokenLexer *, size_t>> MacroExpandingLexersStack;
 
+  /// Token buffers lent out by ScratchTokenBuffer, of which the first
+  /// NumScratchTokenBuffersInUse are currently in use.
+  SmallVector<std::unique_ptr<SmallVector<Token, 0>>, 4> ScratchTokenBuffers;
+  unsigned NumScratchTokenBuffersInUse = 0;
+
   /// A record of the macro definitions and expansions that
   /// occurred during preprocessing.
   ///
@@ -2273,6 +2278,23 @@ private:
 
   void removeCachedMacroExpandedTokensOfLastLexer();
 
+  /// A token buffer borrowed from the preprocessor for the lifetime of this
+  /// object, used to collect the arguments or the expansion of a function-like
+  /// macro. Buffers keep their capacity when they are returned, so that
+  /// expanding large macros over and over does not allocate.
+  class ScratchTokenBuffer {
+    Preprocessor &PP;
+    SmallVectorImpl<Token> &Tokens;
+
+  public:
+    explicit ScratchTokenBuffer(Preprocessor &PP);
+    ScratchTokenBuffer(const ScratchTokenBuffer &) = delete;
+    ScratchTokenBuffer &operator=(const ScratchTokenBuffer &) = delete;
+    ~ScratchTokenBuffer();
+
+    SmallVectorImpl<Token> &get() { return Tokens; }
+  };
+
   /// Determine whether the next preprocessor token to be
   /// lexed is a '('.  If so, consume the token and return true, if not, this
   /// method should have no observable side-effect on the lexed tokens.
@@ -1025,6 +1025,44 @@ private:
   /// Number of visible decl contexts read/total.
   unsigned NumVisibleDeclContextsRead = 0, TotalVisibleDeclContexts = 0;
 
+  /// What caused a declaration to be deserialized, for the breakdown printed
+  /// by PrintStats().
+  enum DeclLoadReason {
+    DLR_Other,
+    DLR_Eager,
+    DLR_LexicalContents,
+    DLR_NameLookup,
+    DLR_CompleteVisibleDecls,
+    DLR_RedeclChain,
+    NUM_DECL_LOAD_REASONS
+  };
+
+  /// The reason of the outermost declaration load currently in progress.
+  DeclLoadReason CurrentDeclLoadReason = DLR_Other;
+
+  /// Number of declarations read for each DeclLoadReason.
+  unsigned NumDeclsReadByReason[NUM_DECL_LOAD_REASONS] = {};
+
+  /// Name and number of declarations read for each Decl::Kind.
+  SmallVector<std::pair<const char *, unsigned>, 0> NumDeclsReadByKind;
+
+  /// RAII object that attributes the declarations read in its scope to a
+  /// reason, unless an enclosing scope has already done so.
+  class DeclLoadReasonRAII {
+    ASTReader &Reader;
+    DeclLoadReason PrevReason;
+
+  public:
+    DeclLoadReasonRAII(ASTReader &Reader, DeclLoadReason Reason)
+        : Reader(Reader), PrevReason(Reader.CurrentDeclLoadReason) {
+      if (PrevReason == DLR_Other)
+        Reader.CurrentDeclLoadReason = Reason;
+    }
+    DeclLoadReasonRAII(const DeclLoadReasonRAII &) = delete;
+    DeclLoadReasonRAII &operator=(const DeclLoadReasonRAII &) = delete;
+    ~DeclLoadReasonRAII() { Reader.CurrentDeclLoadReason = PrevReason; }
+  };
+
   /// Total size of modules, in bits, currently loaded
   uint64_t TotalModulesSizeInBits = 0;
 
@@ -1779,6 +1817,14 @@ public:
     return static_cast<unsigned>(DeclsLoaded.size());
   }
 
+  /// Returns the number of declarations deserialized so far.
+  unsigned getNumDeclsRead() const {
+    unsigned Result = 0;
+    for (unsigned N : NumDeclsReadByReason)
+      Result += N;
+    return Result;
+  }
+
   /// Returns the number of submodules known.
   unsigned getTotalNumSubmodules() const {
     return static_cast<unsigned>(SubmodulesLoaded.size());
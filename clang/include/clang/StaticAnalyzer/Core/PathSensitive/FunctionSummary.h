@@ -49,9 +49,17 @@ class FunctionSummariesTy {
     /// The number of times the function has been inlined.
     unsigned TimesInlined : 32;
 
+    /// The number of visited basic blocks when the function was last inlined.
+    unsigned VisitedBasicBlocksWhenInlined : 32;
+
+    /// The number of times in a row the function has been inlined without
+    /// any new basic block being visited in between.
+    unsigned TimesInlinedWithoutNewBlocks : 32;
+
     FunctionSummary()
         : TotalBasicBlocks(0), InlineChecked(0), MayInline(0),
-          TimesInlined(0) {}
+          TimesInlined(0), VisitedBasicBlocksWhenInlined(0),
+          TimesInlinedWithoutNewBlocks(0) {}
   };
 
   using MapTy = llvm::DenseMap<const Decl *, FunctionSummary>;
@@ -121,6 +129,23 @@ public:
   void bumpNumTimesInlined(const Decl* D) {
     MapTy::iterator I = findOrInsertSummary(D);
     I->second.TimesInlined++;
+
+    unsigned NumVisited = I->second.VisitedBasicBlocks.count();
+    if (I->second.TimesInlined > 1 &&
+        NumVisited == I->second.VisitedBasicBlocksWhenInlined)
+      I->second.TimesInlinedWithoutNewBlocks++;
+    else
+      I->second.TimesInlinedWithoutNewBlocks = 0;
+    I->second.VisitedBasicBlocksWhenInlined = NumVisited;
+  }
+
+  /// Get the number of times in a row the function has been inlined without
+  /// the previous inlining (or any other analysis of it) reaching a new block.
+  unsigned getNumTimesInlinedWithoutNewBlocks(const Decl *D) {
+    MapTy::const_iterator I = Map.find(D);
+    if (I != Map.end())
+      return I->second.TimesInlinedWithoutNewBlocks;
+    return 0;
   }
 
   /// Get the percentage of the reachable blocks.
@@ -35,6 +35,9 @@ struct CachedFileContents {
   std::mutex ValueLock;
   /// Owning storage for the minimized contents.
   std::unique_ptr<llvm::MemoryBuffer> MinimizedStorage;
+  /// The entry of the persistent \c MinimizedSourceCache that
+  /// \c MinimizedStorage refers to, if the minimized contents came from there.
+  std::unique_ptr<llvm::MemoryBuffer> MinimizedCacheEntry;
   /// Accessor to the minimized contents that's atomic to avoid data races.
   std::atomic<llvm::MemoryBuffer *> MinimizedAccess;
   /// Skipped range mapping of the minimized contents.
@@ -144,6 +147,33 @@ private:
   CachedFileContents *Contents;
 };
 
+/// A cache of minimized file contents that persists across scanning processes.
+///
+/// Entries are keyed by a hash of the original contents of the file and of the
+/// compiler version, and are memory mapped when read. This way a scan of a tree
+/// that didn't change since a previous scan doesn't minimize any file again.
+class MinimizedSourceCache {
+public:
+  explicit MinimizedSourceCache(StringRef Path) : Path(Path) {}
+
+  /// Looks up the minimized form of \p Original. On success, sets \p Minimized
+  /// and \p Mapping and returns the cache entry that \p Minimized points into.
+  std::unique_ptr<llvm::MemoryBuffer>
+  lookup(StringRef Original, StringRef &Minimized,
+         PreprocessorSkippedRangeMapping &Mapping) const;
+
+  /// Adds the minimized form of \p Original to the cache. Errors are ignored,
+  /// since the cache is only an optimization.
+  void store(StringRef Original, StringRef Minimized,
+             const PreprocessorSkippedRangeMapping &Mapping) const;
+
+private:
+  std::string getEntryPath(StringRef Original) const;
+
+  /// The directory holding the cache entries.
+  std::string Path;
+};
+
 /// This class is a shared cache, that caches the 'stat' and 'open' calls to the
 /// underlying real file system. It distinguishes between minimized and original
 /// files.
@@ -204,9 +234,19 @@ public:
   CacheShard &getShardForFilename(StringRef Filename) const;
   CacheShard &getShardForUID(llvm::sys::fs::UniqueID UID) const;
 
+  /// Persist minimized file contents in the directory \p Path, see
+  /// \c MinimizedSourceCache.
+  void setMinimizedSourceCachePath(StringRef Path);
+
+  /// Returns the persistent cache of minimized file contents, if any.
+  const MinimizedSourceCache *getMinimizedSourceCache() const {
+    return PersistentCache.get();
+  }
+
 private:
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
+  std::unique_ptr<MinimizedSourceCache> PersistentCache;
 };
 
 /// This class is a local cache, that caches the 'stat' and 'open' calls to the
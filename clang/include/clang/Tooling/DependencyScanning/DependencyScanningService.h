@@ -49,7 +49,8 @@ public:
   DependencyScanningService(ScanningMode Mode, ScanningOutputFormat Format,
                             bool ReuseFileManager = true,
                             bool SkipExcludedPPRanges = true,
-                            bool OptimizeArgs = false);
+                            bool OptimizeArgs = false,
+                            StringRef MinimizedSourceCachePath = StringRef());
 
   ScanningMode getMode() const { return Mode; }
 
@@ -121,6 +121,18 @@ struct ModuleDeps {
   std::vector<std::string> getCanonicalCommandLineWithoutModulePaths() const;
 };
 
+/// Computes a hash of everything that determines the contents of the PCM built
+/// for \p MD: its name and context hash, its command line, the paths and
+/// contents of the files it directly depends on, and the content hashes of the
+/// modules it imports, as returned by \p LookupContentHash.
+///
+/// Unlike the context hash, this changes whenever any input of the module
+/// changes. A PCM stored under this hash can therefore be reused by any build,
+/// even on another machine, that computes the same hash.
+std::string getModuleContentHash(
+    const ModuleDeps &MD, llvm::vfs::FileSystem &FS,
+    llvm::function_ref<StringRef(ModuleID)> LookupContentHash);
+
 namespace detail {
 /// Collect the paths of PCM and module map files for the modules in \c Modules
 /// transitively.
@@ -849,18 +849,26 @@ private:
     const bool EnableCheckProfiling = Options.CheckProfiling.hasValue();
     TimeBucketRegion Timer;
     auto &Matchers = this->Matchers->DeclOrStmt;
+    // Whether the node is ignored, per traversal kind. Most matchers share a
+    // traversal kind, so only find that out once per node and kind.
+    llvm::Optional<bool> IsIgnored[TK_IgnoreUnlessSpelledInSource + 1];
+    const TraversalKind DefaultTK =
+        getASTContext().getParentMapContext().getTraversalKind();
     for (unsigned short I : Filter) {
       auto &MP = Matchers[I];
       if (EnableCheckProfiling)
         Timer.setBucket(&TimeByBucket[MP.second->getID()]);
       BoundNodesTreeBuilder Builder;
 
-      {
-        TraversalKindScope RAII(getASTContext(), MP.first.getTraversalKind());
-        if (getASTContext().getParentMapContext().traverseIgnored(DynNode) !=
-            DynNode)
-          continue;
+      const llvm::Optional<TraversalKind> TK = MP.first.getTraversalKind();
+      llvm::Optional<bool> &Ignored = IsIgnored[TK.getValueOr(DefaultTK)];
+      if (!Ignored) {
+        TraversalKindScope RAII(getASTContext(), TK);
+        Ignored = getASTContext().getParentMapContext().traverseIgnored(
+                      DynNode) != DynNode;
       }
+      if (*Ignored)
+        continue;
 
       if (MP.first.matches(DynNode, this, &Builder)) {
         MatchVisitor Visitor(ActiveASTContext, MP.second);
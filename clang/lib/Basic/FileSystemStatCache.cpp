@@ -11,10 +11,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Basic/FileSystemStatCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Chrono.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 using namespace clang;
@@ -118,3 +126,216 @@ MemorizeStatCalls::getStat(StringRef Path, llvm::vfs::Status &Status,
 
   return std::error_code();
 }
+
+// The cache file is a header followed by one record per directory:
+//
+//   "CLNGDLC1" <directory count>
+//   <path length> <path> <mtime> <entry count> { <name length> <name> }*
+//
+// with every integer stored as a little-endian uint32_t, except the mtime,
+// which is a uint64_t.
+static constexpr llvm::StringLiteral DirectoryListingMagic = "CLNGDLC1";
+
+/// Directories modified this recently might be modified again without their
+/// modification time changing, so their listings are not persisted.
+static constexpr std::chrono::seconds DirectoryListingRaceWindow(2);
+
+static uint64_t getMTimeNanos(llvm::sys::TimePoint<> T) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             T.time_since_epoch())
+      .count();
+}
+
+DirectoryListingStatCache::DirectoryListingStatCache(StringRef CachePath)
+    : CachePath(CachePath.str()) {
+  load();
+}
+
+DirectoryListingStatCache::~DirectoryListingStatCache() { save(); }
+
+void DirectoryListingStatCache::load() {
+  auto BufOrErr = llvm::MemoryBuffer::getFile(CachePath, /*IsText=*/false,
+                                              /*RequiresNullTerminator=*/false);
+  if (!BufOrErr)
+    return;
+  Buffer = std::move(*BufOrErr);
+
+  using namespace llvm::support;
+  const char *Ptr = Buffer->getBufferStart();
+  const char *End = Buffer->getBufferEnd();
+  auto ReadU32 = [&](uint32_t &V) {
+    if (End - Ptr < 4)
+      return false;
+    V = endian::readNext<uint32_t, little, unaligned>(Ptr);
+    return true;
+  };
+  auto ReadString = [&](StringRef &S) {
+    uint32_t Len;
+    if (!ReadU32(Len) || uint32_t(End - Ptr) < Len)
+      return false;
+    S = StringRef(Ptr, Len);
+    Ptr += Len;
+    return true;
+  };
+
+  // A malformed or truncated file is ignored in its entirety, and replaced
+  // when the cache is saved.
+  auto Parse = [&]() {
+    if (!Buffer->getBuffer().startswith(DirectoryListingMagic))
+      return false;
+    Ptr += DirectoryListingMagic.size();
+    uint32_t NumDirs;
+    if (!ReadU32(NumDirs))
+      return false;
+    for (uint32_t I = 0; I != NumDirs; ++I) {
+      StringRef Dir;
+      uint32_t NumEntries;
+      if (!ReadString(Dir) || End - Ptr < 8)
+        return false;
+      uint64_t MTime = endian::readNext<uint64_t, little, unaligned>(Ptr);
+      if (!ReadU32(NumEntries))
+        return false;
+      DirectoryListing &Listing = Listings[Dir];
+      Listing.MTime = MTime;
+      Listing.Persist = true;
+      Listing.Entries.resize(NumEntries);
+      for (StringRef &Entry : Listing.Entries)
+        if (!ReadString(Entry))
+          return false;
+      if (!std::is_sorted(Listing.Entries.begin(), Listing.Entries.end()))
+        return false;
+    }
+    return Ptr == End;
+  };
+
+  if (!Parse()) {
+    Listings.clear();
+    Buffer.reset();
+    Dirty = true;
+  }
+}
+
+void DirectoryListingStatCache::save() {
+  if (!Dirty)
+    return;
+
+  SmallString<0> Data;
+  llvm::raw_svector_ostream OS(Data);
+  llvm::support::endian::Writer W(OS, llvm::support::little);
+  auto WriteString = [&](StringRef S) {
+    W.write<uint32_t>(S.size());
+    OS << S;
+  };
+
+  uint32_t NumDirs = 0;
+  for (const auto &Entry : Listings)
+    NumDirs += Entry.second.Persist;
+  OS << DirectoryListingMagic;
+  W.write<uint32_t>(NumDirs);
+  for (const auto &Entry : Listings) {
+    const DirectoryListing &Listing = Entry.second;
+    if (!Listing.Persist)
+      continue;
+    WriteString(Entry.first());
+    W.write<uint64_t>(Listing.MTime);
+    W.write<uint32_t>(Listing.Entries.size());
+    for (StringRef Name : Listing.Entries)
+      WriteString(Name);
+  }
+
+  // The cache is only an optimization; failing to update it is not an error.
+  llvm::consumeError(
+      llvm::writeFileAtomically(CachePath + "-%%%%%%%%", CachePath, Data));
+}
+
+const DirectoryListingStatCache::DirectoryListing *
+DirectoryListingStatCache::getListing(StringRef Dir, llvm::vfs::FileSystem &FS,
+                                      const llvm::vfs::Status *KnownStatus) {
+  DirectoryListing &Listing = Listings[Dir];
+  if (Listing.Validated)
+    return Listing.Usable ? &Listing : nullptr;
+  Listing.Validated = true;
+
+  llvm::ErrorOr<llvm::vfs::Status> DirStatus =
+      KnownStatus ? *KnownStatus : FS.status(Dir);
+  if (!DirStatus || !DirStatus->isDirectory()) {
+    Dirty |= Listing.Persist;
+    Listing.Persist = false;
+    return nullptr;
+  }
+
+  uint64_t MTime = getMTimeNanos(DirStatus->getLastModificationTime());
+  if (Listing.Persist && Listing.MTime == MTime) {
+    Listing.Usable = true;
+    return &Listing;
+  }
+
+  // The directory changed, or was never listed; list it now.
+  Dirty |= Listing.Persist;
+  Listing.MTime = MTime;
+  Listing.Persist = false;
+  Listing.Entries.clear();
+  std::error_code EC;
+  for (llvm::vfs::directory_iterator I = FS.dir_begin(Dir, EC), E;
+       I != E && !EC; I.increment(EC))
+    Listing.Entries.push_back(
+        Saver.save(llvm::sys::path::filename(I->path()).lower()));
+  if (EC) {
+    Listing.Entries.clear();
+    return nullptr;
+  }
+  llvm::sort(Listing.Entries);
+  Listing.Usable = true;
+
+  auto Age = std::chrono::system_clock::now().time_since_epoch() -
+             std::chrono::nanoseconds(MTime);
+  if (Age > DirectoryListingRaceWindow) {
+    Listing.Persist = true;
+    Dirty = true;
+  }
+  return &Listing;
+}
+
+std::error_code
+DirectoryListingStatCache::getStat(StringRef Path, llvm::vfs::Status &Status,
+                                   bool isFile,
+                                   std::unique_ptr<llvm::vfs::File> *F,
+                                   llvm::vfs::FileSystem &FS) {
+  SmallString<256> AbsPath;
+  if (!llvm::sys::path::is_absolute(Path)) {
+    if (!WorkingDir) {
+      llvm::ErrorOr<std::string> CWD = FS.getCurrentWorkingDirectory();
+      WorkingDir = CWD ? *CWD : std::string();
+    }
+    if (!WorkingDir->empty()) {
+      AbsPath = *WorkingDir;
+      llvm::sys::path::append(AbsPath, Path);
+    }
+  } else {
+    AbsPath = Path;
+  }
+
+  // Names are matched case-insensitively, so that case-insensitive file
+  // systems only ever see false positives.  Anything that might be spelled
+  // differently on disk is left to the file system.
+  StringRef Name = llvm::sys::path::filename(AbsPath);
+  StringRef Dir = llvm::sys::path::parent_path(AbsPath);
+  bool Cacheable = !Dir.empty() && !Name.empty() && Name != "." &&
+                   Name != ".." && llvm::isASCII(Name);
+  if (Cacheable) {
+    if (const DirectoryListing *Listing = getListing(Dir, FS)) {
+      std::string Lower = Name.lower();
+      if (!std::binary_search(Listing->Entries.begin(), Listing->Entries.end(),
+                              StringRef(Lower)))
+        return std::make_error_code(std::errc::no_such_file_or_directory);
+    }
+  }
+
+  std::error_code EC = get(Path, Status, isFile, F, nullptr, FS);
+
+  // Directories are usually looked up right before the files in them, so
+  // validate the listing now rather than stat the directory again later.
+  if (!EC && Status.isDirectory() && llvm::sys::path::is_absolute(AbsPath))
+    getListing(AbsPath, FS, &Status);
+  return EC;
+}
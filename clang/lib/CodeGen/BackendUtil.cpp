@@ -46,6 +46,8 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -86,7 +88,9 @@
 #include "llvm/Transforms/Utils/EntryExitInstrumenter.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
 #include "llvm/Transforms/Utils/NameAnonGlobals.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "llvm/Transforms/Utils/SymbolRewriter.h"
+#include <atomic>
 #include <memory>
 using namespace clang;
 using namespace llvm;
@@ -97,13 +101,15 @@ using namespace llvm;
 
 namespace llvm {
 extern cl::opt<bool> DebugInfoCorrelate;
+extern cl::opt<bool> BinaryCorrelate;
 }
 
 namespace {
 
 // Default filename used for profile generation.
 std::string getDefaultProfileGenName() {
-  return DebugInfoCorrelate ? "default_%p.proflite" : "default_%m.profraw";
+  return DebugInfoCorrelate || BinaryCorrelate ? "default_%p.proflite"
+                                               : "default_%m.profraw";
 }
 
 class EmitAssemblyHelper {
@@ -162,6 +168,12 @@ class EmitAssemblyHelper {
                           std::unique_ptr<raw_pwrite_stream> &OS,
                           std::unique_ptr<llvm::ToolOutputFile> &DwoOS);
 
+  /// Split the module into CodeGenOpts.ParallelCodeGen partitions and run the
+  /// codegen pipeline on them concurrently.  The first partition is written to
+  /// \p OS and partition N to "<ParallelCodeGenOutputPrefix>.N".
+  void RunParallelCodegenPipeline(BackendAction Action,
+                                  std::unique_ptr<raw_pwrite_stream> &OS);
+
 public:
   EmitAssemblyHelper(DiagnosticsEngine &_Diags,
                      const HeaderSearchOptions &HeaderSearchOpts,
@@ -427,6 +439,20 @@ static TargetLibraryInfoImpl *createTLII(llvm::Triple &TargetTriple,
         break;
     }
     break;
+  case CodeGenOptions::LLVMLibc:
+    switch (TargetTriple.getArch()) {
+    default:
+      break;
+    case llvm::Triple::aarch64:
+      TLII->addVectorizableFunctionsFromVecLib(
+          TargetLibraryInfoImpl::LLVMLIBC_AARCH64);
+      break;
+    case llvm::Triple::x86_64:
+      TLII->addVectorizableFunctionsFromVecLib(
+          TargetLibraryInfoImpl::LLVMLIBC_X86);
+      break;
+    }
+    break;
   case CodeGenOptions::MASSV:
     TLII->addVectorizableFunctionsFromVecLib(TargetLibraryInfoImpl::MASSV);
     break;
@@ -957,12 +983,16 @@ void EmitAssemblyHelper::CreateTargetMachine(bool MustCreateTM) {
                                           Options, RM, CM, OptLevel));
 }
 
-bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
-                                       BackendAction Action,
-                                       raw_pwrite_stream &OS,
-                                       raw_pwrite_stream *DwoOS) {
+/// Add the passes that run the code generator for \p TM to \p CodeGenPasses.
+///
+/// \return True on success.
+static bool addEmitPassesForTarget(legacy::PassManager &CodeGenPasses,
+                                   TargetMachine &TM,
+                                   llvm::Triple &TargetTriple,
+                                   const CodeGenOptions &CodeGenOpts,
+                                   BackendAction Action, raw_pwrite_stream &OS,
+                                   raw_pwrite_stream *DwoOS) {
   // Add LibraryInfo.
-  llvm::Triple TargetTriple(TheModule->getTargetTriple());
   std::unique_ptr<TargetLibraryInfoImpl> TLII(
       createTLII(TargetTriple, CodeGenOpts));
   CodeGenPasses.add(new TargetLibraryInfoWrapperPass(*TLII));
@@ -977,8 +1007,17 @@ bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
   if (CodeGenOpts.OptimizationLevel > 0)
     CodeGenPasses.add(createObjCARCContractPass());
 
-  if (TM->addPassesToEmitFile(CodeGenPasses, OS, DwoOS, CGFT,
-                              /*DisableVerify=*/!CodeGenOpts.VerifyModule)) {
+  return !TM.addPassesToEmitFile(CodeGenPasses, OS, DwoOS, CGFT,
+                                 /*DisableVerify=*/!CodeGenOpts.VerifyModule);
+}
+
+bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
+                                       BackendAction Action,
+                                       raw_pwrite_stream &OS,
+                                       raw_pwrite_stream *DwoOS) {
+  llvm::Triple TargetTriple(TheModule->getTargetTriple());
+  if (!addEmitPassesForTarget(CodeGenPasses, *TM, TargetTriple, CodeGenOpts,
+                              Action, OS, DwoOS)) {
     Diags.Report(diag::err_fe_unable_to_interface_with_target);
     return false;
   }
@@ -1537,6 +1576,83 @@ void EmitAssemblyHelper::RunCodegenPipeline(
   }
 }
 
+void EmitAssemblyHelper::RunParallelCodegenPipeline(
+    BackendAction Action, std::unique_ptr<raw_pwrite_stream> &OS) {
+  unsigned NumParts = CodeGenOpts.ParallelCodeGen;
+
+  // Open all outputs up front so that failures are reported before any work
+  // is done.
+  SmallVector<std::unique_ptr<llvm::ToolOutputFile>, 8> PartFiles;
+  SmallVector<raw_pwrite_stream *, 8> PartOSs = {OS.get()};
+  for (unsigned I = 1; I != NumParts; ++I) {
+    PartFiles.push_back(openOutputFile(CodeGenOpts.ParallelCodeGenOutputPrefix +
+                                       "." + llvm::utostr(I)));
+    if (!PartFiles.back())
+      return;
+    PartOSs.push_back(&PartFiles.back()->os());
+  }
+
+  std::atomic<bool> Failed(false);
+  {
+    PrettyStackTraceString CrashInfo("Parallel code generation");
+    llvm::TimeTraceScope TimeScope("CodeGenPasses");
+    ThreadPool Pool(hardware_concurrency(NumParts));
+    unsigned Part = 0;
+
+    // The partitions share the context of the original module, which code
+    // generation cannot use concurrently, so each one is moved into a fresh
+    // context through bitcode.  Locals are kept with their users so that
+    // partitioning does not change the symbols the object files define.
+    SplitModule(
+        *TheModule, NumParts,
+        [&](std::unique_ptr<Module> MPart) {
+          SmallString<0> BC;
+          {
+            raw_svector_ostream BCOS(BC);
+            WriteBitcodeToFile(*MPart, BCOS);
+          }
+
+          raw_pwrite_stream *PartOS = PartOSs[Part++];
+          Pool.async(
+              [this, Action, PartOS, &Failed](const SmallString<0> &BC) {
+                LLVMContext Ctx;
+                Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
+                    MemoryBufferRef(BC.str(), "<split-module>"), Ctx);
+                if (!MOrErr)
+                  report_fatal_error("Failed to read bitcode");
+                Module &M = **MOrErr;
+
+                std::unique_ptr<TargetMachine> PartTM(
+                    TM->getTarget().createTargetMachine(
+                        TM->getTargetTriple().str(), TM->getTargetCPU(),
+                        TM->getTargetFeatureString(), TM->Options,
+                        TM->getRelocationModel(), TM->getCodeModel(),
+                        TM->getOptLevel()));
+                llvm::Triple TargetTriple(M.getTargetTriple());
+                legacy::PassManager CodeGenPasses;
+                CodeGenPasses.add(createTargetTransformInfoWrapperPass(
+                    PartTM->getTargetIRAnalysis()));
+                if (!addEmitPassesForTarget(CodeGenPasses, *PartTM,
+                                            TargetTriple, CodeGenOpts, Action,
+                                            *PartOS, /*DwoOS=*/nullptr)) {
+                  Failed = true;
+                  return;
+                }
+                CodeGenPasses.run(M);
+              },
+              std::move(BC));
+        },
+        /*PreserveLocals=*/true);
+  }
+
+  if (Failed) {
+    Diags.Report(diag::err_fe_unable_to_interface_with_target);
+    return;
+  }
+  for (std::unique_ptr<llvm::ToolOutputFile> &F : PartFiles)
+    F->keep();
+}
+
 /// A clean version of `EmitAssembly` that uses the new pass manager.
 ///
 /// Not all features are currently supported in this system, but where
@@ -1563,7 +1679,14 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
 
   std::unique_ptr<llvm::ToolOutputFile> ThinLinkOS, DwoOS;
   RunOptimizationPipeline(Action, OS, ThinLinkOS);
-  RunCodegenPipeline(Action, OS, DwoOS);
+  if (CodeGenOpts.ParallelCodeGen > 1 &&
+      (Action == Backend_EmitObj || Action == Backend_EmitAssembly) &&
+      CodeGenOpts.SplitDwarfOutput.empty() &&
+      !CodeGenOpts.ParallelCodeGenOutputPrefix.empty() &&
+      CodeGenOpts.ParallelCodeGenOutputPrefix != "-")
+    RunParallelCodegenPipeline(Action, OS);
+  else
+    RunCodegenPipeline(Action, OS, DwoOS);
 
   if (ThinLinkOS)
     ThinLinkOS->keep();
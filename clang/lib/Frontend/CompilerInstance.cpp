@@ -13,6 +13,7 @@
 #include "clang/Basic/CharInfo.h"
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/FileManager.h"
+#include "clang/Basic/FileSystemStatCache.h"
 #include "clang/Basic/LangStandard.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/Stack.h"
@@ -377,6 +378,9 @@ FileManager *CompilerInstance::createFileManager(
                                                     getDiagnostics());
   assert(VFS && "FileManager has no VFS?");
   FileMgr = new FileManager(getFileSystemOpts(), std::move(VFS));
+  if (!getFileSystemOpts().HeaderSearchCachePath.empty())
+    FileMgr->setStatCache(std::make_unique<DirectoryListingStatCache>(
+        getFileSystemOpts().HeaderSearchCachePath));
   return FileMgr.get();
 }
 
@@ -15,6 +15,7 @@
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/LangStandard.h"
 #include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/Version.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/CompilerInvocation.h"
 #include "clang/Frontend/FrontendActions.h"
@@ -31,8 +32,11 @@
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/CrashRecoveryContext.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/LockFileManager.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/StringSaver.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include <limits>
 #include <mutex>
@@ -300,6 +304,52 @@ template <class T> bool moveOnNoError(llvm::ErrorOr<T> Val, T &Output) {
   return true;
 }
 
+/// The first line of the dependency file of an entry in a shared preamble
+/// store.
+constexpr llvm::StringLiteral SharedPreambleStoreVersion =
+    "clang-preamble-store-1";
+
+/// Returns the path, without extension, of the entry for a preamble in the
+/// shared preamble store \p StorePath.
+std::string getSharedPreambleEntryPath(StringRef StorePath,
+                                       const CompilerInvocation &Invocation,
+                                       StringRef PreambleBytes,
+                                       bool PreambleEndsAtStartOfLine,
+                                       llvm::vfs::FileSystem &VFS) {
+  llvm::BumpPtrAllocator Alloc;
+  llvm::StringSaver Saver(Alloc);
+  SmallVector<const char *, 64> Args;
+  Invocation.generateCC1CommandLine(
+      Args, [&](const Twine &Arg) { return Saver.save(Arg).data(); });
+
+  llvm::MD5 Hash;
+  Hash.update(getClangFullRepositoryVersion());
+  for (StringRef Arg : Args) {
+    Hash.update(Arg);
+    Hash.update(StringRef("\0", 1));
+  }
+  // Relative paths in the arguments are resolved against the working
+  // directory.
+  if (llvm::ErrorOr<std::string> CWD = VFS.getCurrentWorkingDirectory())
+    Hash.update(*CWD);
+  Hash.update(PreambleBytes);
+  Hash.update(PreambleEndsAtStartOfLine ? "1" : "0");
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+
+  SmallString<128> Path(StorePath);
+  llvm::sys::path::append(Path, Result.digest());
+  return std::string(Path.str());
+}
+
+SmallString<32> getContentDigest(StringRef Contents) {
+  llvm::MD5 Hash;
+  Hash.update(Contents);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+  return Result.digest();
+}
+
 } // namespace
 
 PreambleBounds clang::ComputePreambleBounds(const LangOptions &LangOpts,
@@ -314,9 +364,73 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
     DiagnosticsEngine &Diagnostics,
     IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS,
     std::shared_ptr<PCHContainerOperations> PCHContainerOps, bool StoreInMemory,
-    PreambleCallbacks &Callbacks) {
+    PreambleCallbacks &Callbacks, StringRef SharedStorePath) {
   assert(VFS && "VFS is null");
 
+  // Remapped files and buffers are private to this process, so preambles
+  // built from them can't be shared.
+  const PreprocessorOptions &PreprocessorOpts =
+      Invocation.getPreprocessorOpts();
+  if (SharedStorePath.empty() || !PreprocessorOpts.RemappedFiles.empty() ||
+      !PreprocessorOpts.RemappedFileBuffers.empty() ||
+      llvm::sys::fs::create_directories(SharedStorePath))
+    return BuildUncached(Invocation, MainFileBuffer, Bounds, Diagnostics,
+                         std::move(VFS), std::move(PCHContainerOps),
+                         StoreInMemory, Callbacks);
+
+  std::string EntryPath = getSharedPreambleEntryPath(
+      SharedStorePath, Invocation,
+      MainFileBuffer->getBuffer().take_front(Bounds.Size),
+      Bounds.PreambleEndsAtStartOfLine, *VFS);
+  while (true) {
+    llvm::LockFileManager Locked(EntryPath);
+    switch (Locked) {
+    case llvm::LockFileManager::LFS_Error:
+      // The store is only an optimization, so fall back to building the
+      // preamble in case of any lock related errors.
+      Locked.unsafeRemoveLockFile();
+      LLVM_FALLTHROUGH;
+    case llvm::LockFileManager::LFS_Owned: {
+      if (llvm::Optional<PrecompiledPreamble> Stored = loadFromStore(
+              EntryPath, MainFileBuffer, Bounds, *VFS, StoreInMemory))
+        return std::move(*Stored);
+      llvm::ErrorOr<PrecompiledPreamble> Built = BuildUncached(
+          Invocation, MainFileBuffer, Bounds, Diagnostics, VFS,
+          std::move(PCHContainerOps), StoreInMemory, Callbacks);
+      if (Built)
+        Built->addToStore(EntryPath, *VFS);
+      return Built;
+    }
+    case llvm::LockFileManager::LFS_Shared:
+      break;
+    }
+
+    // Another process is building the preamble. Wait for it to finish.
+    switch (Locked.waitForUnlock()) {
+    case llvm::LockFileManager::Res_Success:
+      if (llvm::Optional<PrecompiledPreamble> Stored = loadFromStore(
+              EntryPath, MainFileBuffer, Bounds, *VFS, StoreInMemory))
+        return std::move(*Stored);
+      // The other process failed to build the preamble, or built it from
+      // files that differ from ours. Try to build it ourselves.
+      continue;
+    case llvm::LockFileManager::Res_OwnerDied:
+      continue;
+    case llvm::LockFileManager::Res_Timeout:
+      Locked.unsafeRemoveLockFile();
+      continue;
+    }
+  }
+}
+
+llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::BuildUncached(
+    const CompilerInvocation &Invocation,
+    const llvm::MemoryBuffer *MainFileBuffer, PreambleBounds Bounds,
+    DiagnosticsEngine &Diagnostics,
+    IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS,
+    std::shared_ptr<PCHContainerOperations> PCHContainerOps, bool StoreInMemory,
+    PreambleCallbacks &Callbacks) {
+
   auto PreambleInvocation = std::make_shared<CompilerInvocation>(Invocation);
   FrontendOptions &FrontendOpts = PreambleInvocation->getFrontendOpts();
   PreprocessorOptions &PreprocessorOpts =
@@ -470,6 +584,138 @@ llvm::ErrorOr<PrecompiledPreamble> PrecompiledPreamble::Build(
       std::move(FilesInPreamble), std::move(MissingFiles));
 }
 
+llvm::Optional<PrecompiledPreamble> PrecompiledPreamble::loadFromStore(
+    StringRef EntryPath, const llvm::MemoryBuffer *MainFileBuffer,
+    PreambleBounds Bounds, llvm::vfs::FileSystem &VFS, bool StoreInMemory) {
+  std::string DepsPath = (EntryPath + ".deps").str();
+  std::string PCHPath = (EntryPath + ".pch").str();
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Deps =
+      llvm::MemoryBuffer::getFile(DepsPath);
+  if (!Deps)
+    return None;
+
+  SmallVector<StringRef, 0> Lines;
+  (*Deps)->getBuffer().split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  if (Lines.empty() || Lines.front() != SharedPreambleStoreVersion)
+    return None;
+
+  // Check that none of the files used by the preamble have changed since it
+  // was built, and record them as CanReuse would see them now.
+  llvm::StringMap<PreambleFileHash> FilesInPreamble;
+  llvm::StringSet<> MissingFiles;
+  for (StringRef Line : llvm::drop_begin(Lines)) {
+    StringRef Kind;
+    std::tie(Kind, Line) = Line.split(' ');
+    if (Kind == "missing") {
+      if (auto Status = VFS.status(Line))
+        if (Status->isRegularFile())
+          return None;
+      MissingFiles.insert(Line);
+      continue;
+    }
+    if (Kind != "file")
+      return None;
+
+    StringRef Digest, Filename;
+    std::tie(Digest, Filename) = Line.split(' ');
+    llvm::vfs::Status Status;
+    if (!moveOnNoError(VFS.status(Filename), Status))
+      return None;
+    auto Buffer = VFS.getBufferForFile(Filename);
+    if (!Buffer || getContentDigest((*Buffer)->getBuffer()) != Digest)
+      return None;
+    if (time_t ModTime = llvm::sys::toTimeT(Status.getLastModificationTime()))
+      FilesInPreamble[Filename] =
+          PreambleFileHash::createForFile(Status.getSize(), ModTime);
+    else
+      FilesInPreamble[Filename] =
+          PreambleFileHash::createForMemoryBuffer((*Buffer)->getMemBufferRef());
+  }
+
+  PCHStorage Storage;
+  if (StoreInMemory) {
+    auto PCH = llvm::MemoryBuffer::getFile(PCHPath);
+    if (!PCH)
+      return None;
+    InMemoryPreamble Memory;
+    Memory.Data = std::string((*PCH)->getBuffer());
+    Storage = PCHStorage(std::move(Memory));
+  } else {
+    // Copy the PCH, so that it outlives the entry if another process replaces
+    // it.
+    llvm::ErrorOr<TempPCHFile> File = TempPCHFile::CreateNewPreamblePCHFile();
+    if (!File || llvm::sys::fs::copy_file(PCHPath, File->getFilePath()))
+      return None;
+    Storage = PCHStorage(std::move(*File));
+  }
+
+  std::vector<char> PreambleBytes(MainFileBuffer->getBufferStart(),
+                                  MainFileBuffer->getBufferStart() +
+                                      Bounds.Size);
+  return PrecompiledPreamble(std::move(Storage), std::move(PreambleBytes),
+                             Bounds.PreambleEndsAtStartOfLine,
+                             std::move(FilesInPreamble),
+                             std::move(MissingFiles));
+}
+
+void PrecompiledPreamble::addToStore(StringRef EntryPath,
+                                     llvm::vfs::FileSystem &VFS) const {
+  // Record the contents of the files used by the preamble, so that processes
+  // that see different modification times for them can still reuse it.
+  std::string Deps;
+  llvm::raw_string_ostream OS(Deps);
+  OS << SharedPreambleStoreVersion << '\n';
+  for (const auto &F : FilesInPreamble) {
+    llvm::vfs::Status Status;
+    if (!moveOnNoError(VFS.status(F.first()), Status))
+      return;
+    auto Buffer = VFS.getBufferForFile(F.first());
+    if (!Buffer)
+      return;
+    // Don't add the preamble if a file changed since it was read.
+    PreambleFileHash Hash =
+        F.second.ModTime
+            ? PreambleFileHash::createForFile(
+                  Status.getSize(),
+                  llvm::sys::toTimeT(Status.getLastModificationTime()))
+            : PreambleFileHash::createForMemoryBuffer(
+                  (*Buffer)->getMemBufferRef());
+    if (Hash != F.second)
+      return;
+    OS << "file " << getContentDigest((*Buffer)->getBuffer()) << ' '
+       << F.first() << '\n';
+  }
+  for (const auto &F : MissingFiles)
+    OS << "missing " << F.getKey() << '\n';
+  OS.flush();
+
+  std::unique_ptr<llvm::MemoryBuffer> PCHFile;
+  StringRef PCH;
+  if (Storage.getKind() == PCHStorage::Kind::InMemory) {
+    PCH = Storage.asMemory().Data;
+  } else {
+    auto Buffer = llvm::MemoryBuffer::getFile(Storage.asFile().getFilePath());
+    if (!Buffer)
+      return;
+    PCHFile = std::move(*Buffer);
+    PCH = PCHFile->getBuffer();
+  }
+
+  // Readers only trust the PCH once its dependency file exists, so remove the
+  // dependency file of any entry this replaces first and write ours last.
+  std::string DepsPath = (EntryPath + ".deps").str();
+  std::string TempPathModel = (EntryPath + "-%%%%%%%%.tmp").str();
+  llvm::sys::fs::remove(DepsPath);
+  if (llvm::Error Err = llvm::writeFileAtomically(
+          TempPathModel, (EntryPath + ".pch").str(), PCH)) {
+    llvm::consumeError(std::move(Err));
+    return;
+  }
+  if (llvm::Error Err =
+          llvm::writeFileAtomically(TempPathModel, DepsPath, Deps))
+    llvm::consumeError(std::move(Err));
+}
+
 PreambleBounds PrecompiledPreamble::getBounds() const {
   return PreambleBounds(PreambleBytes.size(), PreambleEndsAtStartOfLine);
 }
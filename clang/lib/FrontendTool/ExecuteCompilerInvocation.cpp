@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/ARCMigrate/ARCMTActions.h"
+#include "clang/Basic/FileManager.h"
 #include "clang/CodeGen/CodeGenAction.h"
 #include "clang/Config/config.h"
 #include "clang/Driver/Options.h"
@@ -261,6 +262,11 @@ bool ExecuteCompilerInvocation(CompilerInstance *Clang) {
   if (!Act)
     return false;
   bool Success = Clang->ExecuteAction(*Act);
+  // Write back the directory listings cached by the file manager, which is
+  // leaked when freeing is disabled.
+  if (Clang->hasFileManager() &&
+      !Clang->getFileSystemOpts().HeaderSearchCachePath.empty())
+    Clang->getFileManager().clearStatCache();
   if (Clang->getFrontendOpts().DisableFree)
     llvm::BuryPointer(std::move(Act));
   return Success;
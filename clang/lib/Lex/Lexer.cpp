@@ -47,6 +47,13 @@
 #include <tuple>
 #include <utility>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif __ALTIVEC__
+#include <altivec.h>
+#undef bool
+#endif
+
 using namespace clang;
 
 //===----------------------------------------------------------------------===//
@@ -1760,9 +1767,40 @@ bool Lexer::LexUnicodeIdentifierStart(Token &Result, uint32_t C,
   return true;
 }
 
+#ifdef __SSE2__
+/// Return a mask with bit N set if byte N of \p V is not one of [_A-Za-z0-9].
+static inline unsigned getNonIdentifierMask(__m128i V) {
+  // Setting bit 5 folds upper-case letters onto lower-case ones.  Bytes with
+  // the high bit set are negative as signed chars and fall outside every
+  // range below.
+  __m128i Lower = _mm_or_si128(V, _mm_set1_epi8(0x20));
+  __m128i IsAlpha = _mm_and_si128(_mm_cmpgt_epi8(Lower, _mm_set1_epi8('a' - 1)),
+                                  _mm_cmplt_epi8(Lower, _mm_set1_epi8('z' + 1)));
+  __m128i IsDigit = _mm_and_si128(_mm_cmpgt_epi8(V, _mm_set1_epi8('0' - 1)),
+                                  _mm_cmplt_epi8(V, _mm_set1_epi8('9' + 1)));
+  __m128i IsUnderscore = _mm_cmpeq_epi8(V, _mm_set1_epi8('_'));
+  __m128i IsIdent = _mm_or_si128(_mm_or_si128(IsAlpha, IsDigit), IsUnderscore);
+  return ~_mm_movemask_epi8(IsIdent) & 0xFFFF;
+}
+#endif
+
 bool Lexer::LexIdentifierContinue(Token &Result, const char *CurPtr) {
   // Match [_A-Za-z0-9]*, we have already matched an identifier start.
   while (true) {
+#ifdef __SSE2__
+    // Skip over plain ASCII identifier characters 16 bytes at a time.  The
+    // buffer is null terminated, and a null is never part of an identifier,
+    // so the scan cannot run past the end of the token.
+    while (CurPtr + 16 <= BufferEnd) {
+      unsigned Mask = getNonIdentifierMask(
+          _mm_loadu_si128((const __m128i *)CurPtr));
+      if (Mask) {
+        CurPtr += llvm::countTrailingZeros(Mask);
+        break;
+      }
+      CurPtr += 16;
+    }
+#endif
     unsigned char C = *CurPtr;
     // Fast path.
     if (isAsciiIdentifierContinue(C)) {
@@ -2395,6 +2433,26 @@ bool Lexer::SkipLineComment(Token &Result, const char *CurPtr,
   // character that ends the line comment.
   char C;
   while (true) {
+#ifdef __SSE2__
+    // Scan 16 bytes at a time for a null, '\n' or '\r'.
+    {
+      const __m128i Nul = _mm_setzero_si128();
+      const __m128i LF = _mm_set1_epi8('\n');
+      const __m128i CR = _mm_set1_epi8('\r');
+      while (CurPtr + 16 <= BufferEnd) {
+        __m128i V = _mm_loadu_si128((const __m128i *)CurPtr);
+        unsigned Mask = _mm_movemask_epi8(
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(V, Nul),
+                                      _mm_cmpeq_epi8(V, LF)),
+                         _mm_cmpeq_epi8(V, CR)));
+        if (Mask) {
+          CurPtr += llvm::countTrailingZeros(Mask);
+          break;
+        }
+        CurPtr += 16;
+      }
+    }
+#endif
     C = *CurPtr;
     // Skip over characters in the fast loop.
     while (C != 0 &&                // Potentially EOF.
@@ -2616,13 +2674,6 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr, Lexer *L,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
-#include <altivec.h>
-#undef bool
-#endif
-
 /// We have just read from input the / and * characters that started a comment.
 /// Read until we find the * and / characters that terminate the comment.
 /// Note that we don't bother decoding trigraphs or escaped newlines in block
@@ -774,9 +774,10 @@ MacroArgs *Preprocessor::ReadMacroCallArgumentList(Token &MacroName,
   assert(Tok.is(tok::l_paren) && "Error computing l-paren-ness?");
 
   // ArgTokens - Build up a list of tokens that make up each argument.  Each
-  // argument is separated by an EOF token.  Use a SmallVector so we can avoid
-  // heap allocations in the common case.
-  SmallVector<Token, 64> ArgTokens;
+  // argument is separated by an EOF token.  Use a scratch buffer so we can
+  // avoid heap allocations.
+  ScratchTokenBuffer ArgTokenBuffer(*this);
+  SmallVectorImpl<Token> &ArgTokens = ArgTokenBuffer.get();
   bool ContainsCodeCompletionTok = false;
   bool FoundElidedComma = false;
 
@@ -1075,6 +1076,23 @@ void Preprocessor::removeCachedMacroExpandedTokensOfLastLexer() {
   MacroExpandingLexersStack.pop_back();
 }
 
+Preprocessor::ScratchTokenBuffer::ScratchTokenBuffer(Preprocessor &PP)
+    : PP(PP), Tokens([&]() -> SmallVectorImpl<Token> & {
+        if (PP.NumScratchTokenBuffersInUse == PP.ScratchTokenBuffers.size())
+          PP.ScratchTokenBuffers.push_back(
+              std::make_unique<SmallVector<Token, 0>>());
+        return *PP.ScratchTokenBuffers[PP.NumScratchTokenBuffersInUse++];
+      }()) {}
+
+Preprocessor::ScratchTokenBuffer::~ScratchTokenBuffer() {
+  assert(PP.NumScratchTokenBuffersInUse &&
+         &Tokens ==
+             PP.ScratchTokenBuffers[PP.NumScratchTokenBuffersInUse - 1].get() &&
+         "Scratch token buffers must be returned in reverse order");
+  Tokens.clear();
+  --PP.NumScratchTokenBuffersInUse;
+}
+
 /// ComputeDATE_TIME - Compute the current time, enter it into the specified
 /// scratch buffer, then return DATELoc/TIMELoc locations with the position of
 /// the identifier tokens inserted.
@@ -294,6 +294,10 @@ void Preprocessor::PrintStats() {
   llvm::errs() << "\n  BumpPtr: " << BP.getTotalMemory();
   llvm::errs() << "\n  Macro Expanded Tokens: "
                << llvm::capacity_in_bytes(MacroExpandedTokens);
+  size_t ScratchTokenBufferBytes = 0;
+  for (const auto &Buffer : ScratchTokenBuffers)
+    ScratchTokenBufferBytes += llvm::capacity_in_bytes(*Buffer);
+  llvm::errs() << "\n  Scratch Token Buffers: " << ScratchTokenBufferBytes;
   llvm::errs() << "\n  Predefines Buffer: " << Predefines.capacity();
   // FIXME: List information for all submodules.
   llvm::errs() << "\n  Macros: "
@@ -322,8 +326,12 @@ Preprocessor::macro_begin(bool IncludeExternalMacros) const {
 }
 
 size_t Preprocessor::getTotalMemory() const {
+  size_t ScratchTokenBufferBytes = 0;
+  for (const auto &Buffer : ScratchTokenBuffers)
+    ScratchTokenBufferBytes += llvm::capacity_in_bytes(*Buffer);
   return BP.getTotalMemory()
     + llvm::capacity_in_bytes(MacroExpandedTokens)
+    + ScratchTokenBufferBytes
     + Predefines.capacity() /* Predefines buffer. */
     // FIXME: Include sizes from all submodules, and include MacroInfo sizes,
     // and ModuleMacros.
@@ -240,7 +240,8 @@ void TokenLexer::stringifyVAOPTContents(
 /// Expand the arguments of a function-like macro so that we can quickly
 /// return preexpanded tokens from Tokens.
 void TokenLexer::ExpandFunctionArguments() {
-  SmallVector<Token, 128> ResultToks;
+  Preprocessor::ScratchTokenBuffer ResultBuffer(PP);
+  SmallVectorImpl<Token> &ResultToks = ResultBuffer.get();
 
   // Loop through 'Tokens', expanding them into ResultToks.  Keep
   // track of whether we change anything.  If not, no need to keep them.  If so,
@@ -28,10 +28,20 @@
 #include "clang/Sema/SemaInternal.h"
 #include "clang/Sema/Template.h"
 #include "clang/Sema/TemplateInstCallback.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/TimeProfiler.h"
 
 using namespace clang;
 
+#define DEBUG_TYPE "sema-instantiate"
+
+ALWAYS_ENABLED_STATISTIC(NumFunctionInstantiations,
+                         "Number of function definitions instantiated.");
+ALWAYS_ENABLED_STATISTIC(
+    NumFunctionInstantiationsFromASTFile,
+    "Number of function instantiations whose definition was loaded from an "
+    "AST file instead of being instantiated.");
+
 static bool isDeclWithinFunction(const Decl *D) {
   const DeclContext *DC = D->getDeclContext();
   if (DC->isFunctionOrMethod())
@@ -4814,8 +4824,11 @@ void Sema::InstantiateFunctionDefinition(SourceLocation PointOfInstantiation,
   const FunctionDecl *ExistingDefn = nullptr;
   if (Function->isDefined(ExistingDefn,
                           /*CheckForPendingFriendDefinition=*/true)) {
-    if (ExistingDefn->isThisDeclarationADefinition())
+    if (ExistingDefn->isThisDeclarationADefinition()) {
+      if (ExistingDefn->isFromASTFile())
+        ++NumFunctionInstantiationsFromASTFile;
       return;
+    }
 
     // If we're asked to instantiate a function whose body comes from an
     // instantiated friend declaration, attach the instantiated body to the
@@ -4876,6 +4889,7 @@ void Sema::InstantiateFunctionDefinition(SourceLocation PointOfInstantiation,
     return;
   }
 
+  ++NumFunctionInstantiations;
   llvm::TimeTraceScope TimeScope("InstantiateFunction", [&]() {
     std::string Name;
     llvm::raw_string_ostream OS(Name);
@@ -7195,6 +7195,8 @@ void ASTReader::CompleteRedeclChain(const Decl *D) {
     return;
   }
 
+  DeclLoadReasonRAII Reason(*this, DLR_RedeclChain);
+
   if (!D->getDeclContext()) {
     assert(isa<TranslationUnitDecl>(D) && "Not a TU?");
     return;
@@ -7524,6 +7526,7 @@ Stmt *ASTReader::GetExternalDeclStmt(uint64_t Offset) {
 void ASTReader::FindExternalLexicalDecls(
     const DeclContext *DC, llvm::function_ref<bool(Decl::Kind)> IsKindWeWant,
     SmallVectorImpl<Decl *> &Decls) {
+  DeclLoadReasonRAII Reason(*this, DLR_LexicalContents);
   bool PredefsVisited[NUM_PREDEF_DECL_IDS] = {};
 
   auto Visit = [&] (ModuleFile *M, LexicalContents LexicalDecls) {
@@ -7651,6 +7654,7 @@ ASTReader::FindExternalVisibleDeclsByName(const DeclContext *DC,
     return false;
 
   Deserializing LookupResults(this);
+  DeclLoadReasonRAII Reason(*this, DLR_NameLookup);
 
   // Load the list of declarations.
   SmallVector<NamedDecl *, 64> Decls;
@@ -7675,6 +7679,7 @@ void ASTReader::completeVisibleDeclsMap(const DeclContext *DC) {
          "have external visible storage but no lookup tables");
 
   DeclsMap Decls;
+  DeclLoadReasonRAII Reason(*this, DLR_CompleteVisibleDecls);
 
   for (DeclID ID : It->second.Table.findAll()) {
     NamedDecl *ND = cast<NamedDecl>(GetDecl(ID));
@@ -7803,6 +7808,29 @@ void ASTReader::PrintStats() {
                  NumIdentifierLookupHits, NumIdentifierLookups,
                  (double)NumIdentifierLookupHits*100.0/NumIdentifierLookups);
 
+  if (NumDeclsLoaded) {
+    static const char *const ReasonNames[NUM_DECL_LOAD_REASONS] = {
+        "other",           "eagerly deserialized",       "lexical contents",
+        "name lookup",     "complete visible decl maps", "redeclaration chains",
+    };
+    std::fprintf(stderr, "  declarations read, by cause:\n");
+    for (unsigned I = 0; I != NUM_DECL_LOAD_REASONS; ++I)
+      if (NumDeclsReadByReason[I])
+        std::fprintf(stderr, "    %u %s\n", NumDeclsReadByReason[I],
+                     ReasonNames[I]);
+
+    SmallVector<std::pair<const char *, unsigned>, 0> ByKind;
+    for (const auto &Entry : NumDeclsReadByKind)
+      if (Entry.second)
+        ByKind.push_back(Entry);
+    llvm::stable_sort(ByKind, [](const auto &A, const auto &B) {
+      return A.second > B.second;
+    });
+    std::fprintf(stderr, "  declarations read, by kind:\n");
+    for (const auto &Entry : ByKind)
+      std::fprintf(stderr, "    %u %s\n", Entry.second, Entry.first);
+  }
+
   if (GlobalIndex) {
     std::fprintf(stderr, "\n");
     GlobalIndex->printStats();
@@ -3778,6 +3778,12 @@ Decl *ASTReader::ReadDeclRecord(DeclID ID) {
 
   assert(D && "Unknown declaration reading AST file");
   LoadedDecl(Index, D);
+  ++NumDeclsReadByReason[CurrentDeclLoadReason];
+  unsigned KindIndex = D->getKind();
+  if (KindIndex >= NumDeclsReadByKind.size())
+    NumDeclsReadByKind.resize(KindIndex + 1, {nullptr, 0});
+  NumDeclsReadByKind[KindIndex].first = D->getDeclKindName();
+  ++NumDeclsReadByKind[KindIndex].second;
   // Set the DeclContext before doing any deserialization, to make sure internal
   // calls to Decl::getASTContext() by Decl's methods will find the
   // TranslationUnitDecl without crashing.
@@ -3832,8 +3838,11 @@ void ASTReader::PassInterestingDeclsToConsumer() {
 
   // Ensure that we've loaded all potentially-interesting declarations
   // that need to be eagerly loaded.
-  for (auto ID : EagerlyDeserializedDecls)
-    GetDecl(ID);
+  {
+    DeclLoadReasonRAII Reason(*this, DLR_Eager);
+    for (auto ID : EagerlyDeserializedDecls)
+      GetDecl(ID);
+  }
   EagerlyDeserializedDecls.clear();
 
   while (!PotentiallyInterestingDecls.empty()) {
@@ -3932,6 +3941,8 @@ void ASTReader::loadDeclUpdateRecords(PendingUpdateRecord &Record) {
 }
 
 void ASTReader::loadPendingDeclChain(Decl *FirstLocal, uint64_t LocalOffset) {
+  DeclLoadReasonRAII Reason(*this, DLR_RedeclChain);
+
   // Attach FirstLocal to the end of the decl chain.
   Decl *CanonDecl = FirstLocal->getCanonicalDecl();
   if (FirstLocal != CanonDecl) {
@@ -40,6 +40,9 @@ STATISTIC(NumInlinedCalls,
 STATISTIC(NumReachedInlineCountMax,
   "The # of times we reached inline count maximum");
 
+STATISTIC(NumReachedInlineCoverageMax,
+  "The # of times we stopped inlining a function that gained no coverage");
+
 void ExprEngine::processCallEnter(NodeBuilderContext& BC, CallEnter CE,
                                   ExplodedNode *Pred) {
   // Get the entry block in the CFG of the callee.
@@ -1024,6 +1027,16 @@ bool ExprEngine::shouldInlineCall(const CallEvent &Call, const Decl *D,
     return false;
   }
 
+  // Do not keep inlining a function whose previous inlinings did not explore
+  // anything new in it.
+  if (Opts.MaxTimesInlineWithoutNewCoverage &&
+      Engine.FunctionSummaries->getNumTimesInlinedWithoutNewBlocks(D) >=
+          Opts.MaxTimesInlineWithoutNewCoverage &&
+      !isSmall(CalleeADC)) {
+    NumReachedInlineCoverageMax++;
+    return false;
+  }
+
   if (HowToInline == Inline_Minimal && (!isSmall(CalleeADC) || IsRecursive))
     return false;
 
@@ -7,8 +7,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "clang/Basic/Version.h"
 #include "clang/Lex/DependencyDirectivesSourceMinimizer.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/Threading.h"
 
@@ -60,6 +65,21 @@ EntryRef DependencyScanningWorkerFilesystem::minimizeIfNecessary(
   if (Contents->MinimizedAccess.load())
     return EntryRef(/*Minimized=*/true, Filename, Entry);
 
+  const MinimizedSourceCache *PersistentCache =
+      SharedCache.getMinimizedSourceCache();
+  if (PersistentCache) {
+    StringRef Minimized;
+    if (auto CacheEntry =
+            PersistentCache->lookup(Contents->Original->getBuffer(), Minimized,
+                                    Contents->PPSkippedRangeMapping)) {
+      Contents->MinimizedCacheEntry = std::move(CacheEntry);
+      Contents->MinimizedStorage = llvm::MemoryBuffer::getMemBuffer(
+          Minimized, Contents->Original->getBufferIdentifier());
+      Contents->MinimizedAccess.store(Contents->MinimizedStorage.get());
+      return EntryRef(/*Minimized=*/true, Filename, Entry);
+    }
+  }
+
   llvm::SmallString<1024> MinimizedFileContents;
   // Minimize the file down to directives that might affect the dependencies.
   SmallVector<minimize_source_to_dependency_directives::Token, 64> Tokens;
@@ -95,6 +115,11 @@ EntryRef DependencyScanningWorkerFilesystem::minimizeIfNecessary(
   }
   Contents->PPSkippedRangeMapping = std::move(Mapping);
 
+  if (PersistentCache)
+    PersistentCache->store(Contents->Original->getBuffer(),
+                           MinimizedFileContents,
+                           Contents->PPSkippedRangeMapping);
+
   Contents->MinimizedStorage = std::make_unique<llvm::SmallVectorMemoryBuffer>(
       std::move(MinimizedFileContents));
   // This function performed double-checked locking using `MinimizedAccess`.
@@ -106,6 +131,78 @@ EntryRef DependencyScanningWorkerFilesystem::minimizeIfNecessary(
   return EntryRef(/*Minimized=*/true, Filename, Entry);
 }
 
+/// The signature of a MinimizedSourceCache entry file. An entry is laid out as
+/// the signature, the number of skipped ranges, each skipped range as a pair
+/// of offset and length, and finally the minimized contents, which extend to
+/// the end of the file so that they are null terminated when mapped. All
+/// integers are 32-bit little-endian.
+static constexpr llvm::StringLiteral MinimizedSourceCacheSignature =
+    "CLNGMIN1";
+
+std::string MinimizedSourceCache::getEntryPath(StringRef Original) const {
+  llvm::MD5 Hash;
+  Hash.update(getClangFullRepositoryVersion());
+  Hash.update(MinimizedSourceCacheSignature);
+  Hash.update(Original);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+
+  SmallString<128> EntryPath(Path);
+  llvm::sys::path::append(EntryPath, Result.digest());
+  return std::string(EntryPath.str());
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+MinimizedSourceCache::lookup(StringRef Original, StringRef &Minimized,
+                             PreprocessorSkippedRangeMapping &Mapping) const {
+  auto MaybeEntry = llvm::MemoryBuffer::getFile(getEntryPath(Original));
+  if (!MaybeEntry)
+    return nullptr;
+  std::unique_ptr<llvm::MemoryBuffer> Entry = std::move(*MaybeEntry);
+
+  StringRef Data = Entry->getBuffer();
+  size_t HeaderSize = MinimizedSourceCacheSignature.size() + 4;
+  if (Data.size() < HeaderSize ||
+      !Data.startswith(MinimizedSourceCacheSignature))
+    return nullptr;
+  const char *Ptr = Data.data() + MinimizedSourceCacheSignature.size();
+  uint32_t NumRanges = llvm::support::endian::read32le(Ptr);
+  Ptr += 4;
+  if ((Data.size() - HeaderSize) / 8 < NumRanges)
+    return nullptr;
+
+  PreprocessorSkippedRangeMapping Ranges;
+  for (uint32_t I = 0; I != NumRanges; ++I, Ptr += 8)
+    Ranges[llvm::support::endian::read32le(Ptr)] =
+        llvm::support::endian::read32le(Ptr + 4);
+
+  Minimized = StringRef(Ptr, Data.end() - Ptr);
+  Mapping = std::move(Ranges);
+  return Entry;
+}
+
+void MinimizedSourceCache::store(
+    StringRef Original, StringRef Minimized,
+    const PreprocessorSkippedRangeMapping &Mapping) const {
+  std::string Data;
+  llvm::raw_string_ostream OS(Data);
+  llvm::support::endian::Writer W(OS, llvm::support::little);
+  OS << MinimizedSourceCacheSignature;
+  W.write<uint32_t>(Mapping.size());
+  for (const auto &Range : Mapping) {
+    W.write<uint32_t>(Range.first);
+    W.write<uint32_t>(Range.second);
+  }
+  OS << Minimized;
+  OS.flush();
+
+  std::string EntryPath = getEntryPath(Original);
+  if (llvm::Error Err =
+          llvm::writeFileAtomically(EntryPath + "-%%%%%%%%.tmp", EntryPath,
+                                    Data))
+    llvm::consumeError(std::move(Err));
+}
+
 DependencyScanningFilesystemSharedCache::
     DependencyScanningFilesystemSharedCache() {
   // This heuristic was chosen using a empirical testing on a
@@ -118,6 +215,12 @@ DependencyScanningFilesystemSharedCache::
   CacheShards = std::make_unique<CacheShard[]>(NumShards);
 }
 
+void DependencyScanningFilesystemSharedCache::setMinimizedSourceCachePath(
+    StringRef Path) {
+  llvm::sys::fs::create_directories(Path);
+  PersistentCache = std::make_unique<MinimizedSourceCache>(Path);
+}
+
 DependencyScanningFilesystemSharedCache::CacheShard &
 DependencyScanningFilesystemSharedCache::getShardForFilename(
     StringRef Filename) const {
@@ -15,9 +15,13 @@ using namespace dependencies;
 
 DependencyScanningService::DependencyScanningService(
     ScanningMode Mode, ScanningOutputFormat Format, bool ReuseFileManager,
-    bool SkipExcludedPPRanges, bool OptimizeArgs)
+    bool SkipExcludedPPRanges, bool OptimizeArgs,
+    StringRef MinimizedSourceCachePath)
     : Mode(Mode), Format(Format), ReuseFileManager(ReuseFileManager),
       SkipExcludedPPRanges(SkipExcludedPPRanges), OptimizeArgs(OptimizeArgs) {
+  if (!MinimizedSourceCachePath.empty())
+    SharedCache.setMinimizedSourceCachePath(MinimizedSourceCachePath);
+
   // Initialize targets for object file support.
   llvm::InitializeAllTargets();
   llvm::InitializeAllTargetMCs();
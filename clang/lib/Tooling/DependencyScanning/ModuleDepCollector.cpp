@@ -11,6 +11,7 @@
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningWorker.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/StringSaver.h"
 
 using namespace clang;
@@ -106,6 +107,53 @@ ModuleDeps::getCanonicalCommandLineWithoutModulePaths() const {
   return serializeCompilerInvocation(BuildInvocation);
 }
 
+std::string dependencies::getModuleContentHash(
+    const ModuleDeps &MD, llvm::vfs::FileSystem &FS,
+    llvm::function_ref<StringRef(ModuleID)> LookupContentHash) {
+  llvm::MD5 Hasher;
+  // Terminate every string so that the concatenation is unambiguous.
+  auto AddString = [&](StringRef Str) {
+    Hasher.update(Str);
+    Hasher.update(StringRef("", 1));
+  };
+  // Hash the contents of a file. Files that can't be read contribute only
+  // their path.
+  auto AddFile = [&](StringRef Path) {
+    AddString(Path);
+    if (auto Buffer = FS.getBufferForFile(Path))
+      AddString((*Buffer)->getBuffer());
+  };
+
+  AddString(MD.ID.ModuleName);
+  AddString(MD.ID.ContextHash);
+  for (const std::string &Arg : MD.getCanonicalCommandLineWithoutModulePaths())
+    AddString(Arg);
+
+  std::vector<StringRef> FileDeps;
+  for (const auto &Entry : MD.FileDeps)
+    FileDeps.push_back(Entry.getKey());
+  llvm::sort(FileDeps);
+  for (StringRef File : FileDeps)
+    AddFile(File);
+
+  for (const PrebuiltModuleDep &PMD : MD.PrebuiltModuleDeps)
+    AddFile(PMD.PCMFile);
+
+  std::vector<ModuleID> Deps = MD.ClangModuleDeps;
+  llvm::sort(Deps, [](const ModuleID &A, const ModuleID &B) {
+    return std::tie(A.ModuleName, A.ContextHash) <
+           std::tie(B.ModuleName, B.ContextHash);
+  });
+  for (const ModuleID &MID : Deps) {
+    AddString(MID.ModuleName);
+    AddString(LookupContentHash(MID));
+  }
+
+  llvm::MD5::MD5Result Result;
+  Hasher.final(Result);
+  return std::string(Result.digest());
+}
+
 void dependencies::detail::collectPCMAndModuleMapPaths(
     llvm::ArrayRef<ModuleID> Modules,
     std::function<StringRef(ModuleID)> LookupPCMPath,
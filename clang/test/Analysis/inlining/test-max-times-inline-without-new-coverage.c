@@ -0,0 +1,23 @@
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.ExprInspection \
+// RUN:   -verify=expected,default %s
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,debug.ExprInspection \
+// RUN:   -analyzer-config max-times-inline-without-new-coverage=1 \
+// RUN:   -verify=expected,limited %s
+
+void clang_analyzer_eval(int);
+
+int pick(int x) {
+  if (x > 0)
+    return x;
+  return -x;
+}
+
+void test(void) {
+  clang_analyzer_eval(pick(1) == 1); // expected-warning{{TRUE}}
+  // This inlining only reaches blocks that the first one visited, which is
+  // noticed when pick() is inlined for the next call.
+  clang_analyzer_eval(pick(2) == 2); // expected-warning{{TRUE}}
+  clang_analyzer_eval(pick(3) == 3); // expected-warning{{TRUE}}
+  clang_analyzer_eval(pick(4) == 4); // default-warning{{TRUE}} \
+                                     // limited-warning{{UNKNOWN}}
+}
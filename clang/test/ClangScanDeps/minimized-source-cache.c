@@ -0,0 +1,45 @@
+// Check that -minimized-source-cache-path persists the minimized contents of
+// the scanned files, and that a later scan reading them back from the cache
+// produces the same dependencies.
+
+// RUN: rm -rf %t
+// RUN: split-file %s %t
+// RUN: sed -e "s|DIR|%/t|g" %t/cdb.json.template > %t/cdb.json
+
+//--- cdb.json.template
+[{
+  "directory": "DIR",
+  "command": "clang -fsyntax-only DIR/tu.c -o DIR/tu.o",
+  "file": "DIR/tu.c"
+}]
+
+//--- a.h
+#ifdef NOT_DEFINED
+#include "b.h"
+int not_included_at_all(void);
+#endif
+#include "c.h"
+
+//--- b.h
+
+//--- c.h
+int c(void);
+
+//--- tu.c
+#include "a.h"
+
+// RUN: clang-scan-deps -compilation-database %t/cdb.json -j 1 \
+// RUN:   -minimized-source-cache-path %t/cache > %t/result1.d
+// RUN: ls %t/cache | FileCheck --check-prefix=CACHE %s
+// CACHE: {{[0-9a-f]{32}}}
+
+// RUN: clang-scan-deps -compilation-database %t/cdb.json -j 1 \
+// RUN:   -minimized-source-cache-path %t/cache > %t/result2.d
+// RUN: diff %t/result1.d %t/result2.d
+// RUN: cat %t/result2.d | sed 's:\\\\\?:/:g' | FileCheck %s -DPREFIX=%/t
+
+// CHECK:      [[PREFIX]]/tu.o:
+// CHECK-NEXT:   [[PREFIX]]/tu.c
+// CHECK-NEXT:   [[PREFIX]]/a.h
+// CHECK-NEXT:   [[PREFIX]]/c.h
+// CHECK-NOT:    b.h
@@ -0,0 +1,58 @@
+// Check that -content-addressed-module-files names module files after the
+// contents of their inputs: scanning the same inputs twice produces the same
+// paths, and changing a header of a module changes the path of that module
+// and of every module that imports it.
+
+// RUN: rm -rf %t
+// RUN: split-file %s %t
+// RUN: sed -e "s|DIR|%/t|g" %t/cdb.json.template > %t/cdb.json
+
+//--- cdb.json.template
+[{
+  "directory": "DIR",
+  "command": "clang -fsyntax-only DIR/tu.c -fmodules -fimplicit-module-maps -fmodules-cache-path=DIR/cache",
+  "file": "DIR/tu.c"
+}]
+
+//--- module.modulemap
+module Top { header "top.h" }
+module Bottom { header "bottom.h" }
+
+//--- top.h
+#include "bottom.h"
+
+//--- bottom.h
+int bottom(void);
+
+//--- tu.c
+#include "top.h"
+
+// RUN: clang-scan-deps -compilation-database %t/cdb.json -format experimental-full \
+// RUN:   -generate-modules-path-args -module-files-dir %t/build \
+// RUN:   -content-addressed-module-files > %t/result1.json
+// RUN: clang-scan-deps -compilation-database %t/cdb.json -format experimental-full \
+// RUN:   -generate-modules-path-args -module-files-dir %t/build \
+// RUN:   -content-addressed-module-files > %t/result2.json
+// RUN: diff %t/result1.json %t/result2.json
+
+// RUN: echo "int bottom2(void);" >> %t/bottom.h
+// RUN: clang-scan-deps -compilation-database %t/cdb.json -format experimental-full \
+// RUN:   -generate-modules-path-args -module-files-dir %t/build \
+// RUN:   -content-addressed-module-files > %t/result3.json
+// RUN: cat %t/result1.json %t/result3.json | sed 's:\\\\\?:/:g' | FileCheck %s
+
+// CHECK:      "modules": [
+// CHECK:          "{{.*}}/build/[[BOTTOM1:[0-9a-f]+]]/Bottom-{{[A-Z0-9]+}}.pcm"
+// CHECK:          "content-hash": "[[BOTTOM1]]",
+// CHECK:          "name": "Bottom"
+// CHECK-DAG:      "-fmodule-file={{.*}}/build/[[BOTTOM1]]/Bottom-{{[A-Z0-9]+}}.pcm"
+// CHECK-DAG:      "{{.*}}/build/[[TOP1:[0-9a-f]+]]/Top-{{[A-Z0-9]+}}.pcm"
+// CHECK:          "content-hash": "[[TOP1]]",
+// CHECK:          "name": "Top"
+
+// CHECK:      "modules": [
+// CHECK-NOT:      [[BOTTOM1]]
+// CHECK:          "name": "Bottom"
+// CHECK-NOT:      [[BOTTOM1]]
+// CHECK-NOT:      [[TOP1]]
+// CHECK:          "name": "Top"
@@ -0,0 +1,18 @@
+// REQUIRES: x86-registered-target
+// RUN: rm -f %t.o %t.o.1 %t.o.2
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -O1 -emit-obj \
+// RUN:   -fparallel-codegen=3 %s -o %t.o
+// RUN: llvm-nm %t.o %t.o.1 %t.o.2 | FileCheck %s
+
+// Every definition ends up in exactly one of the partitions, and static
+// functions stay local.
+
+// CHECK-DAG: T f1
+// CHECK-DAG: T f2
+// CHECK-DAG: T f3
+// CHECK-DAG: t helper
+
+__attribute__((noinline)) static int helper(int x) { return x * 3; }
+int f1(int x) { return helper(x) + 1; }
+int f2(int x) { return helper(x) + 2; }
+int f3(int x) { return x - 3; }
@@ -0,0 +1,30 @@
+// RUN: %clang_cc1 -fveclib=LLVMLibc -fno-math-errno -triple x86_64-unknown-linux-gnu %s -target-feature +avx2 -vectorize-loops -emit-llvm -O3 -o - | FileCheck %s --check-prefix=X86
+// RUN: %clang_cc1 -fveclib=LLVMLibc -fno-math-errno -triple aarch64-unknown-linux-gnu %s -vectorize-loops -emit-llvm -O3 -o - | FileCheck %s --check-prefix=AARCH64
+
+// REQUIRES: x86-registered-target, aarch64-registered-target
+
+// Make sure -fveclib=LLVMLibc gets passed through to LLVM as expected: calls
+// to the LLVM libc vector variants of expf and logf should be generated.
+
+extern float expf(float);
+extern float logf(float);
+
+// X86-LABEL: define{{.*}}@apply_exp
+// X86: call <8 x float> @_ZGVdN8v_expf(
+// AARCH64-LABEL: define{{.*}}@apply_exp
+// AARCH64: call <4 x float> @_ZGVnN4v_expf(
+//
+void apply_exp(float *A, float *C, unsigned N) {
+  for (unsigned i = 0; i < N; i++)
+    C[i] = expf(A[i]);
+}
+
+// X86-LABEL: define{{.*}}@apply_log
+// X86: call <8 x float> @_ZGVdN8v_logf(
+// AARCH64-LABEL: define{{.*}}@apply_log
+// AARCH64: call <4 x float> @_ZGVnN4v_logf(
+//
+void apply_log(float *A, float *C, unsigned N) {
+  for (unsigned i = 0; i < N; i++)
+    C[i] = logf(A[i]);
+}
@@ -82,6 +82,7 @@
 // FVECLIBALL: Accelerate
 // FVECLIBALL-NEXT: Darwin_libsystem_m
 // FVECLIBALL-NEXT: libmvec
+// FVECLIBALL-NEXT: LLVMLibc
 // FVECLIBALL-NEXT: MASSV
 // FVECLIBALL-NEXT: none
 // FVECLIBALL-NEXT: SVML
@@ -0,0 +1,28 @@
+// RUN: %clangxx -S -ftime-trace -ftime-trace-granularity=0 -ftime-trace-metrics -o %T/check-time-trace-metrics %s
+// RUN: cat %T/check-time-trace-metrics.json \
+// RUN:   | %python -c 'import json, sys; json.dump(json.loads(sys.stdin.read()), sys.stdout, sort_keys=True, indent=2)' \
+// RUN:   | FileCheck %s
+
+// CHECK:      "traceEvents": [
+// CHECK:      "AST bytes allocated": {{[1-9][0-9]*}}
+// CHECK:      "detail": "Inner<int>"
+// CHECK-NEXT: "instantiation depth": {{[1-9][0-9]*}}
+// CHECK-NEXT: },
+// CHECK-NEXT: "dur":
+// CHECK-NEXT: "name": "InstantiateClass"
+
+// RUN: %clangxx -### -c -ftime-trace -ftime-trace-metrics %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=DRIVER %s
+// DRIVER: "-ftime-trace-metrics"
+
+template <typename T>
+struct Inner {
+  T Num;
+};
+
+template <typename T>
+struct Outer {
+  Inner<T> I;
+};
+
+Outer<int> O;
@@ -0,0 +1,3 @@
+// RUN: %clang -### -c -fheader-search-cache=%t.cache %s 2>&1 | FileCheck %s
+// CHECK: "-cc1"
+// CHECK-SAME: "-fheader-search-cache={{.*}}.cache"
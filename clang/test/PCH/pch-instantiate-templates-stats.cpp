@@ -0,0 +1,23 @@
+// Check that instantiations performed while building a PCH with
+// -fpch-instantiate-templates are reused by the translation unit, and counted
+// separately from the instantiations performed by the translation unit.
+
+// RUN: %clang_cc1 -emit-pch -fpch-instantiate-templates -o %t.pch %s
+// RUN: %clang_cc1 -include-pch %t.pch -emit-llvm -o /dev/null \
+// RUN:   -stats-file=%t.json %s
+// RUN: FileCheck --input-file=%t.json %s
+
+// CHECK-DAG: "sema-instantiate.NumFunctionInstantiations": 1
+// CHECK-DAG: "sema-instantiate.NumFunctionInstantiationsFromASTFile": {{[1-9]}}
+
+#ifndef HEADER
+#define HEADER
+
+template <typename T> constexpr T twice(T x) { return x + x; }
+inline int use() { return twice(1); }
+
+#else
+
+long test() { return use() + twice(1) + twice(2l); }
+
+#endif
@@ -0,0 +1,25 @@
+// Test the breakdown of deserialized declarations printed by -print-stats.
+
+// RUN: %clang_cc1 -emit-pch -o %t %s
+// RUN: %clang_cc1 -include-pch %t -fsyntax-only -print-stats %s 2>&1 \
+// RUN:   | FileCheck %s
+
+#ifndef HEADER
+#define HEADER
+
+namespace N {
+int f();
+int unused();
+}
+
+#else
+
+int g() { return N::f(); }
+
+// CHECK:      declarations read, by cause:
+// CHECK:        {{[0-9]+}} name lookup
+// CHECK:      declarations read, by kind:
+// CHECK-DAG:    {{[0-9]+}} Namespace
+// CHECK-DAG:    1 Function
+
+#endif
@@ -0,0 +1,30 @@
+// RUN: %clang_cc1 -E %s | FileCheck %s
+
+// Function-like macros expanded while the arguments of another macro are
+// being read or pre-expanded each collect their tokens in their own buffer.
+
+#define ID(x) x
+#define CAT(a, b) a ## b
+#define TWICE(x) x x
+#define X16(x) x x x x x x x x x x x x x x x x
+#define X256(x) X16(X16(x))
+
+// CHECK: int outer = 1 2 1 2;
+int outer = TWICE(ID(1) ID(CAT(, 2)));
+
+// CHECK: result = 3{{ *}};
+result = ID(
+#if ID(CAT(1, 0)) == 10
+  3
+#else
+  4
+#endif
+);
+
+// CHECK: count = 256;
+#define COUNT(...) ID(CAT(COUNT_, 1))
+#define COUNT_1 256
+count = COUNT(X256(+));
+
+// CHECK: a a a a a a a a a a a a a a a a a a a a a a a a a a a a a a a a
+ID(X16(ID(a)) X16(ID(a)))
@@ -170,6 +170,14 @@ static llvm::cl::opt<std::string> ModuleFilesDir(
                    "specified directory instead the module cache directory."),
     llvm::cl::cat(DependencyScannerCategory));
 
+static llvm::cl::opt<bool> ContentAddressedModuleFiles(
+    "content-addressed-module-files",
+    llvm::cl::desc("With '-generate-modules-path-args', name the directory of "
+                   "each module file after a hash of the module's inputs "
+                   "instead of its context hash, so that module files can be "
+                   "shared between builds with identical inputs."),
+    llvm::cl::init(false), llvm::cl::cat(DependencyScannerCategory));
+
 static llvm::cl::opt<bool> OptimizeArgs(
     "optimize-args",
     llvm::cl::desc("Whether to optimize command-line arguments of modules."),
@@ -199,6 +207,13 @@ llvm::cl::opt<bool> SkipExcludedPPRanges(
         "until reaching the end directive."),
     llvm::cl::init(true), llvm::cl::cat(DependencyScannerCategory));
 
+llvm::cl::opt<std::string> MinimizedSourceCachePath(
+    "minimized-source-cache-path",
+    llvm::cl::desc("Directory in which to persist the minimized contents of "
+                   "source files across invocations, keyed by the hash of "
+                   "their contents."),
+    llvm::cl::cat(DependencyScannerCategory));
+
 llvm::cl::opt<std::string> ModuleName(
     "module-name", llvm::cl::Optional,
     llvm::cl::desc("the module of which the dependencies are to be computed"),
@@ -342,6 +357,8 @@ public:
                      })
                : MD.getCanonicalCommandLineWithoutModulePaths()},
       };
+      if (GenerateModulesPathArgs && ContentAddressedModuleFiles)
+        O.try_emplace("content-hash", lookupContentHash(MD.ID));
       OutModules.push_back(std::move(O));
     }
 
@@ -374,17 +391,31 @@ private:
   }
 
   /// Construct a path for the explicitly built PCM.
-  std::string constructPCMPath(const ModuleDeps &MD) const {
+  std::string constructPCMPath(const ModuleDeps &MD) {
     StringRef Filename = llvm::sys::path::filename(MD.ImplicitModulePCMPath);
 
     SmallString<256> ExplicitPCMPath(
         !ModuleFilesDir.empty()
             ? ModuleFilesDir
             : MD.BuildInvocation.getHeaderSearchOpts().ModuleCachePath);
-    llvm::sys::path::append(ExplicitPCMPath, MD.ID.ContextHash, Filename);
+    llvm::sys::path::append(ExplicitPCMPath,
+                            ContentAddressedModuleFiles
+                                ? lookupContentHash(MD.ID)
+                                : StringRef(MD.ID.ContextHash),
+                            Filename);
     return std::string(ExplicitPCMPath);
   }
 
+  StringRef lookupContentHash(ModuleID MID) {
+    auto It = ContentHashes.find(MID);
+    if (It != ContentHashes.end())
+      return It->second;
+    std::string Hash =
+        getModuleContentHash(lookupModuleDeps(MID), *RealFS,
+                             [&](ModuleID Dep) { return lookupContentHash(Dep); });
+    return ContentHashes.insert({MID, std::move(Hash)}).first->second;
+  }
+
   const ModuleDeps &lookupModuleDeps(ModuleID MID) {
     auto I = Modules.find(IndexedModuleID{MID, 0});
     assert(I != Modules.end());
@@ -421,6 +452,9 @@ private:
   std::unordered_map<IndexedModuleID, ModuleDeps, IndexedModuleIDHasher>
       Modules;
   std::unordered_map<ModuleID, std::string, ModuleIDHasher> PCMPaths;
+  std::unordered_map<ModuleID, std::string, ModuleIDHasher> ContentHashes;
+  IntrusiveRefCntPtr<llvm::vfs::FileSystem> RealFS =
+      llvm::vfs::getRealFileSystem();
   std::vector<InputDeps> Inputs;
 };
 
@@ -530,7 +564,8 @@ int main(int argc, const char **argv) {
   SharedStream DependencyOS(llvm::outs());
 
   DependencyScanningService Service(ScanMode, Format, ReuseFileManager,
-                                    SkipExcludedPPRanges, OptimizeArgs);
+                                    SkipExcludedPPRanges, OptimizeArgs,
+                                    MinimizedSourceCachePath);
   llvm::ThreadPool Pool(llvm::hardware_concurrency(NumThreads));
   std::vector<std::unique_ptr<DependencyScanningTool>> WorkerTools;
   for (unsigned I = 0; I < Pool.getThreadCount(); ++I)
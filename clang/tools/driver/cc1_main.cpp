@@ -12,6 +12,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "clang/AST/ASTContext.h"
 #include "clang/Basic/Stack.h"
 #include "clang/Basic/TargetOptions.h"
 #include "clang/CodeGen/ObjectFilePCHContainerOperations.h"
@@ -25,6 +26,8 @@
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Frontend/Utils.h"
 #include "clang/FrontendTool/Utils.h"
+#include "clang/Sema/Sema.h"
+#include "clang/Serialization/ASTReader.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/LinkAllPasses.h"
@@ -181,6 +184,36 @@ static int PrintSupportedCPUs(std::string TargetStr) {
   return 0;
 }
 
+/// Attach the AST allocation, deserialization and instantiation depth of
+/// \p Clang to every event recorded by the time trace profiler.
+static void addTimeTraceMetrics(CompilerInstance *Clang) {
+  llvm::timeTraceProfilerAddMetric(
+      "AST bytes allocated",
+      [Clang]() -> int64_t {
+        if (!Clang->hasASTContext())
+          return 0;
+        return Clang->getASTContext().getAllocator().getBytesAllocated();
+      },
+      llvm::TimeTraceMetricKind::Delta);
+  llvm::timeTraceProfilerAddMetric(
+      "decls deserialized",
+      [Clang]() -> int64_t {
+        if (IntrusiveRefCntPtr<ASTReader> Reader = Clang->getASTReader())
+          return Reader->getNumDeclsRead();
+        return 0;
+      },
+      llvm::TimeTraceMetricKind::Delta);
+  llvm::timeTraceProfilerAddMetric(
+      "instantiation depth",
+      [Clang]() -> int64_t {
+        if (!Clang->hasSema())
+          return 0;
+        const Sema &S = Clang->getSema();
+        return S.CodeSynthesisContexts.size() - S.NonInstantiationEntries;
+      },
+      llvm::TimeTraceMetricKind::Value);
+}
+
 int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
   ensureSufficientStack();
 
@@ -215,6 +248,8 @@ int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
   if (Clang->getFrontendOpts().TimeTrace) {
     llvm::timeTraceProfilerInitialize(
         Clang->getFrontendOpts().TimeTraceGranularity, Argv0);
+    if (Clang->getFrontendOpts().TimeTraceMetrics)
+      addTimeTraceMetrics(Clang.get());
   }
   // --print-supported-cpus takes priority over the actual compilation.
   if (Clang->getFrontendOpts().PrintSupportedCPUs)
@@ -10,6 +10,7 @@
 #include "clang/Basic/FileSystemOptions.h"
 #include "clang/Basic/FileSystemStatCache.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Testing/Support/Error.h"
@@ -578,4 +579,67 @@ TEST_F(FileManagerTest, getBypassFile) {
   EXPECT_EQ(&FE, &SearchRef->getFileEntry());
 }
 
+
+// The following tests use POSIX-style absolute paths.
+#ifndef _WIN32
+
+// Counts the 'stat' calls that reach the underlying file system.
+class StatCountingFileSystem : public llvm::vfs::ProxyFileSystem {
+public:
+  explicit StatCountingFileSystem(
+      IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status(const Twine &Path) override {
+    ++NumStats;
+    return ProxyFileSystem::status(Path);
+  }
+
+  unsigned NumStats = 0;
+};
+
+TEST_F(FileManagerTest, DirectoryListingStatCache) {
+  SmallString<128> CachePath;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("stat-cache", "bin", CachePath));
+  llvm::FileRemover RemoveCache(CachePath);
+
+  auto FS = makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  FS->addFile("/dir/a.h", /*ModificationTime=*/1,
+              llvm::MemoryBuffer::getMemBuffer("a"));
+  auto Counting = makeIntrusiveRefCnt<StatCountingFileSystem>(FS);
+
+  // The first lookups list the directory and record it in the cache file.
+  {
+    FileManager Files(options, Counting);
+    Files.setStatCache(std::make_unique<DirectoryListingStatCache>(CachePath));
+    EXPECT_TRUE(Files.getOptionalFileRef("/dir/a.h"));
+    EXPECT_FALSE(Files.getOptionalFileRef("/dir/b.h"));
+  }
+
+  // Later lookups of missing files only stat "/" and "/dir".
+  Counting->NumStats = 0;
+  {
+    FileManager Files(options, Counting);
+    Files.setStatCache(std::make_unique<DirectoryListingStatCache>(CachePath));
+    EXPECT_FALSE(Files.getOptionalFileRef("/dir/b.h"));
+    EXPECT_FALSE(Files.getOptionalFileRef("/dir/c.h"));
+    EXPECT_EQ(Counting->NumStats, 2u);
+    EXPECT_TRUE(Files.getOptionalFileRef("/dir/a.h"));
+  }
+
+  // A directory with a different modification time is listed again.
+  auto NewFS = makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  NewFS->addFile("/dir/c.h", /*ModificationTime=*/2,
+                 llvm::MemoryBuffer::getMemBuffer("c"));
+  {
+    FileManager Files(options, NewFS);
+    Files.setStatCache(std::make_unique<DirectoryListingStatCache>(CachePath));
+    EXPECT_TRUE(Files.getOptionalFileRef("/dir/c.h"));
+    EXPECT_FALSE(Files.getOptionalFileRef("/dir/a.h"));
+  }
+}
+
+#endif // !_WIN32
+
 } // anonymous namespace
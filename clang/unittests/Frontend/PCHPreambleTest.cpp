@@ -11,6 +11,7 @@
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Frontend/FrontendOptions.h"
+#include "clang/Frontend/PrecompiledPreamble.h"
 #include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/FileManager.h"
@@ -262,4 +263,60 @@ TEST_F(PCHPreambleTest, ParseWithBom) {
   ASSERT_LE(HeaderReadCount, GetFileReadCount(Header));
 }
 
+TEST(PrecompiledPreambleStoreTest, ReuseFromSharedStore) {
+  SmallString<128> StorePath;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("preamble-store", StorePath));
+
+  std::string Main = "#include \"//./header.h\"\nint x = f();\n";
+  auto MainBuffer = MemoryBuffer::getMemBuffer(Main, "//./main.cpp");
+  auto CreateVFS = [](StringRef Header) {
+    IntrusiveRefCntPtr<vfs::InMemoryFileSystem> VFS(
+        new vfs::InMemoryFileSystem());
+    VFS->setCurrentWorkingDirectory("//./");
+    VFS->addFile("//./header.h", 1, MemoryBuffer::getMemBufferCopy(Header));
+    return VFS;
+  };
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> VFS = CreateVFS("int f();\n");
+
+  auto CI = std::make_shared<CompilerInvocation>();
+  CI->getFrontendOpts().Inputs.push_back(
+      FrontendInputFile("//./main.cpp", Language::CXX));
+  CI->getTargetOpts().Triple = "i386-unknown-linux-gnu";
+  IntrusiveRefCntPtr<DiagnosticsEngine> Diags(
+      CompilerInstance::createDiagnostics(new DiagnosticOptions,
+                                          new DiagnosticConsumer));
+  PreambleBounds Bounds =
+      ComputePreambleBounds(*CI->getLangOpts(), *MainBuffer, 0);
+
+  struct CountingCallbacks : public PreambleCallbacks {
+    unsigned Builds = 0;
+    void AfterExecute(CompilerInstance &CI) override { ++Builds; }
+  } Callbacks;
+  auto Build = [&] {
+    return PrecompiledPreamble::Build(
+        *CI, MainBuffer.get(), Bounds, *Diags, VFS,
+        std::make_shared<PCHContainerOperations>(), /*StoreInMemory=*/true,
+        Callbacks, StorePath);
+  };
+
+  auto Built = Build();
+  ASSERT_TRUE(Built);
+  EXPECT_EQ(1u, Callbacks.Builds);
+
+  // The second build finds the preamble in the store.
+  auto Stored = Build();
+  ASSERT_TRUE(Stored);
+  EXPECT_EQ(1u, Callbacks.Builds);
+  EXPECT_EQ(Built->getSize(), Stored->getSize());
+  EXPECT_TRUE(Stored->CanReuse(*CI, *MainBuffer, Bounds, *VFS));
+
+  // A changed header invalidates the stored preamble.
+  VFS = CreateVFS("int f(int = 0);\n");
+  auto Rebuilt = Build();
+  ASSERT_TRUE(Rebuilt);
+  EXPECT_EQ(2u, Callbacks.Builds);
+
+  sys::fs::remove_directories(StorePath);
+}
+
 } // anonymous namespace
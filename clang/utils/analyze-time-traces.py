@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+#
+#===- analyze-time-traces.py - Aggregate -ftime-trace profiles -*- python -*-===#
+#
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+#===------------------------------------------------------------------------===#
+
+"""
+Aggregate the time trace profiles written by clang -ftime-trace for many
+translation units into a report of the cost of each header and of each
+template. Example usage:
+
+  analyze-time-traces.py build/ --top 50
+  analyze-time-traces.py --json a.json b.json > report.json
+
+A header is charged the time spent in each "Source" section for it, i.e. the
+time spent parsing it and everything it includes. A template is charged the
+time spent in each "InstantiateClass" and "InstantiateFunction" section for a
+specialization of it. A section nested inside a section for the same header or
+template is not counted again, so recursive includes and instantiations are
+not charged twice.
+
+Metrics recorded with -ftime-trace-metrics are summed, except for
+"instantiation depth", of which the maximum is reported.
+"""
+from __future__ import absolute_import, division, print_function
+
+import argparse
+import json
+import os
+import sys
+
+CATEGORIES = {
+    'Source': 'headers',
+    'InstantiateClass': 'templates',
+    'InstantiateFunction': 'templates',
+}
+
+MAX_METRICS = {'instantiation depth'}
+
+
+def template_name(detail):
+  """Strip the template arguments from the name of a specialization."""
+  result = []
+  depth = 0
+  for c in detail:
+    if c == '<':
+      depth += 1
+    elif c == '>' and depth > 0:
+      depth -= 1
+    elif depth == 0:
+      result.append(c)
+  return ''.join(result)
+
+
+def event_key(event):
+  category = CATEGORIES.get(event.get('name'))
+  detail = event.get('args', {}).get('detail')
+  if category is None or detail is None:
+    return None
+  if category == 'templates':
+    detail = template_name(detail)
+  return (category, detail)
+
+
+class Cost(object):
+  def __init__(self):
+    self.count = 0
+    self.duration = 0
+    self.files = set()
+    self.metrics = {}
+
+  def add(self, event, path):
+    self.count += 1
+    self.duration += event.get('dur', 0)
+    self.files.add(path)
+    for name, value in event.get('args', {}).items():
+      if name == 'detail' or not isinstance(value, int):
+        continue
+      if name in MAX_METRICS:
+        self.metrics[name] = max(self.metrics.get(name, value), value)
+      else:
+        self.metrics[name] = self.metrics.get(name, 0) + value
+
+  def to_json(self, name):
+    result = {
+        'name': name,
+        'count': self.count,
+        'dur': self.duration,
+        'translation units': len(self.files),
+    }
+    result.update(self.metrics)
+    return result
+
+
+def add_trace(path, costs):
+  with open(path) as f:
+    try:
+      trace = json.load(f)
+    except ValueError:
+      print('warning: %s is not a JSON file, ignoring' % path, file=sys.stderr)
+      return
+  if not isinstance(trace, dict) or 'traceEvents' not in trace:
+    return
+
+  threads = {}
+  for event in trace['traceEvents']:
+    if event.get('ph') != 'X':
+      continue
+    key = event_key(event)
+    if key is None:
+      continue
+    threads.setdefault((event.get('pid'), event.get('tid')), []).append(
+        (event, key))
+
+  for events in threads.values():
+    # Visit enclosing sections before the sections nested in them.
+    events.sort(key=lambda e: (e[0]['ts'], -e[0].get('dur', 0)))
+    stack = []
+    for event, key in events:
+      begin = event['ts']
+      while stack and stack[-1][0] <= begin:
+        stack.pop()
+      if not any(k == key for _, k in stack):
+        costs[key[0]].setdefault(key[1], Cost()).add(event, path)
+      stack.append((begin + event.get('dur', 0), key))
+
+
+def find_traces(paths):
+  for path in paths:
+    if not os.path.isdir(path):
+      yield path
+      continue
+    for root, _, files in os.walk(path):
+      for name in sorted(files):
+        if name.endswith('.json'):
+          yield os.path.join(root, name)
+
+
+def print_table(title, costs, top):
+  metrics = sorted(set(m for c in costs.values() for m in c.metrics))
+  print('===- %s -===' % title)
+  columns = ['total ms', 'count', 'TUs'] + metrics
+  widths = [max(10, len(c)) + 2 for c in columns]
+  print(''.join('%*s' % (w, c) for w, c in zip(widths, columns)) + '  name')
+  entries = sorted(costs.items(), key=lambda e: -e[1].duration)
+  for name, cost in entries[:top]:
+    row = ['%.1f' % (cost.duration / 1000.0), cost.count, len(cost.files)]
+    row += [cost.metrics.get(m, 0) for m in metrics]
+    print(''.join('%*s' % (w, v) for w, v in zip(widths, row)) + '  ' + name)
+  print()
+
+
+def main():
+  parser = argparse.ArgumentParser(
+      description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('paths', nargs='+', metavar='PATH',
+                      help='time trace file, or directory to search for '
+                      '*.json time trace files')
+  parser.add_argument('--top', type=int, default=20,
+                      help='number of headers and templates to print '
+                      '(default: %(default)s)')
+  parser.add_argument('--json', action='store_true',
+                      help='print every header and template as JSON')
+  args = parser.parse_args()
+
+  costs = {'headers': {}, 'templates': {}}
+  num_traces = 0
+  for path in find_traces(args.paths):
+    add_trace(path, costs)
+    num_traces += 1
+
+  if args.json:
+    report = {'traces': num_traces}
+    for category, entries in costs.items():
+      report[category] = [
+          cost.to_json(name) for name, cost in
+          sorted(entries.items(), key=lambda e: -e[1].duration)]
+    json.dump(report, sys.stdout, indent=2)
+    print()
+    return
+
+  print('%d time trace files' % num_traces)
+  print_table('Headers', costs['headers'], args.top)
+  print_table('Templates', costs['templates'], args.top)
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,42 @@
+//===-- sanitizer/sprof_interface.h -----------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of the sampling CPU profiler (SProf).
+//
+// Public interface header.
+//===----------------------------------------------------------------------===//
+#ifndef SANITIZER_SPROF_INTERFACE_H
+#define SANITIZER_SPROF_INTERFACE_H
+
+#include <sanitizer/common_interface_defs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/// Starts sampling, if it is not already running. Sampling starts at
+/// initialization unless SPROF_OPTIONS has start_at_init=0.
+void __sprof_start(void);
+
+/// Stops sampling. Samples taken so far are kept.
+void __sprof_stop(void);
+
+/// Writes the samples taken so far to the file named by the profile_path flag.
+/// The profile is also written at exit.
+///
+/// \returns 0 on success.
+int __sprof_dump(void);
+
+/// Default options for SPROF_OPTIONS, which can be overridden by defining
+/// this function in the program.
+const char *__sprof_default_options(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // SANITIZER_SPROF_INTERFACE_H
@@ -1214,7 +1214,9 @@ void __sanitizer_purge_allocator() {
 }
 
 int __asan_update_allocation_context(void* addr) {
-  GET_STACK_TRACE_MALLOC;
+  // This is an explicit request for the stack, so it is never sampled out.
+  GET_STACK_TRACE(GetMallocContextSize(),
+                  common_flags()->fast_unwind_on_malloc);
   return instance.UpdateAllocationStack((uptr)addr, &stack);
 }
 
@@ -356,7 +356,8 @@ void __asan_unregister_elf_globals(uptr *flag, void *start, void *stop) {
 // Register an array of globals.
 void __asan_register_globals(__asan_global *globals, uptr n) {
   if (!flags()->report_globals) return;
-  GET_STACK_TRACE_MALLOC;
+  GET_STACK_TRACE(GetMallocContextSize(),
+                  common_flags()->fast_unwind_on_malloc);
   u32 stack_id = StackDepotPut(stack);
   Lock lock(&mu_for_globals);
   if (!global_registration_site_vector) {
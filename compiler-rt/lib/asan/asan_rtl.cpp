@@ -363,6 +363,8 @@ void PrintAddressSpaceLayout() {
          (uptr)flags()->thread_local_quarantine_size_kb);
   Printf("malloc_context_size=%zu\n",
          (uptr)common_flags()->malloc_context_size);
+  Printf("malloc_context_sample_rate=%zu\n",
+         (uptr)flags()->malloc_context_sample_rate);
 
   Printf("SHADOW_SCALE: %d\n", (int)ASAN_SHADOW_SCALE);
   Printf("SHADOW_GRANULARITY: %d\n", (int)ASAN_SHADOW_GRANULARITY);
@@ -26,6 +26,17 @@ u32 GetMallocContextSize() {
   return atomic_load(&malloc_context_size, memory_order_acquire);
 }
 
+u32 GetMallocContextSizeSampled() {
+  u32 size = GetMallocContextSize();
+  int rate = flags()->malloc_context_sample_rate;
+  if (LIKELY(rate <= 1) || size == 0)
+    return size;
+  AsanThread *t = GetCurrentThread();
+  if (!t || t->SampleMallocContext(rate))
+    return size;
+  return 0;
+}
+
 namespace {
 
 // ScopedUnwinding is a scope for stacktracing member of a context
@@ -25,6 +25,9 @@ static const u32 kDefaultMallocContextSize = 30;
 
 void SetMallocContextSize(u32 size);
 u32 GetMallocContextSize();
+// Same as GetMallocContextSize(), but returns 0 for the allocations that are
+// not sampled, see the malloc_context_sample_rate flag.
+u32 GetMallocContextSizeSampled();
 
 } // namespace __asan
 
@@ -58,9 +61,11 @@ u32 GetMallocContextSize();
   GET_STACK_TRACE(kStackTraceMax, true)
 
 #define GET_STACK_TRACE_MALLOC                                                 \
-  GET_STACK_TRACE(GetMallocContextSize(), common_flags()->fast_unwind_on_malloc)
+  GET_STACK_TRACE(GetMallocContextSizeSampled(),                               \
+                  common_flags()->fast_unwind_on_malloc)
 
-#define GET_STACK_TRACE_FREE GET_STACK_TRACE_MALLOC
+#define GET_STACK_TRACE_FREE                                                   \
+  GET_STACK_TRACE(GetMallocContextSize(), common_flags()->fast_unwind_on_malloc)
 
 #define PRINT_CURRENT_STACK()   \
   {                             \
@@ -124,6 +124,15 @@ class AsanThread {
   bool isUnwinding() const { return unwinding_; }
   void setUnwinding(bool b) { unwinding_ = b; }
 
+  // Returns true if the stack of the current allocation should be recorded,
+  // which happens once every `rate` calls.
+  bool SampleMallocContext(u32 rate) {
+    if (++malloc_context_sample_counter_ < rate)
+      return false;
+    malloc_context_sample_counter_ = 0;
+    return true;
+  }
+
   AsanThreadLocalMallocStorage &malloc_storage() { return malloc_storage_; }
   AsanStats &stats() { return stats_; }
 
@@ -166,6 +175,7 @@ class AsanThread {
   AsanThreadLocalMallocStorage malloc_storage_;
   AsanStats stats_;
   bool unwinding_;
+  u32 malloc_context_sample_counter_;
   uptr extra_spill_area_;
 };
 
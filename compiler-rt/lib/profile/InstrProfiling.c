@@ -20,6 +20,12 @@
 #define INSTR_PROF_VALUE_PROF_DATA
 #include "profile/InstrProfData.inc"
 
+COMPILER_RT_VISIBILITY void (*CounterShardsHook)(int Fold) = NULL;
+
+/* The logical time of temporal profiles, i.e. the number of functions called
+ * so far. */
+static uint64_t CurrentTime = 0;
+
 COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_magic(void) {
   return sizeof(void *) == sizeof(uint64_t) ? (INSTR_PROF_RAW_MAGIC_64)
                                             : (INSTR_PROF_RAW_MAGIC_32);
@@ -41,13 +47,25 @@ COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_version(void) {
   return INSTR_PROF_RAW_VERSION_VAR;
 }
 
+COMPILER_RT_VISIBILITY void
+INSTR_PROF_PROFILE_SET_TIMESTAMP(uint64_t *Probe) {
+  /* Functions first called at the same time by different threads may get the
+   * same time, which is good enough to order them. */
+  if (*Probe == 0)
+    *Probe = ++CurrentTime;
+}
+
 COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
   char *I = __llvm_profile_begin_counters();
   char *E = __llvm_profile_end_counters();
 
+  CurrentTime = 0;
+
   char ResetValue =
       (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) ? 0xFF : 0;
   memset(I, ResetValue, E - I);
+  if (CounterShardsHook)
+    CounterShardsHook(0);
 
   const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
   const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
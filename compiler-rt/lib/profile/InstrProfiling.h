@@ -136,6 +136,14 @@ void __llvm_profile_instrument_target_value(uint64_t TargetValue, void *Data,
                                             uint32_t CounterIndex,
                                             uint64_t CounterValue);
 
+/*!
+ * \brief Records the time of the first call of a function.
+ *
+ * Probe is the first counter of the function in a temporal profile. It is set
+ * to the current logical time if it has not been set yet.
+ */
+void INSTR_PROF_PROFILE_SET_TIMESTAMP(uint64_t *Probe);
+
 /*!
  * \brief Write instrumentation data to the current file.
  *
@@ -231,6 +231,121 @@ static int mmapForContinuousMode(uint64_t CurrentFileOffset, FILE *File) {
 }
 #endif
 
+#if defined(__ELF__)
+
+#define INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_DEFAULT_VAR                   \
+  INSTR_PROF_CONCAT(INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_VAR, _default)
+intptr_t INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_DEFAULT_VAR
+    [INSTR_PROF_MAX_COUNTER_SHARDS];
+
+/* This table is defined by the compiler when the counters are sharded. Each
+ * thread adds the entry its hash selects to the addresses of the counters. */
+COMPILER_RT_VISIBILITY extern intptr_t
+    INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_VAR[INSTR_PROF_MAX_COUNTER_SHARDS]
+    __attribute__((weak, alias(INSTR_PROF_QUOTE(
+        INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_DEFAULT_VAR))));
+
+/* The number of copies of the counters used by default, including the
+ * counters themselves. */
+#define DEFAULT_NUM_COUNTER_SHARDS 16
+
+static char *CounterShards = NULL;
+static unsigned NumCounterShardCopies = 0;
+
+static void foldCounterShards(int Fold) {
+  char *CountersBegin = __llvm_profile_begin_counters();
+  char *CountersEnd = __llvm_profile_end_counters();
+  size_t CountersSize = CountersEnd - CountersBegin;
+  int ByteCoverage =
+      (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) != 0;
+  unsigned I;
+  size_t J;
+
+  /* The threads may still update their copies, so take each counter out of
+   * its copy atomically. */
+  for (I = 0; I < NumCounterShardCopies; ++I) {
+    char *Shard = CounterShards + I * CountersSize;
+    if (ByteCoverage) {
+      for (J = 0; J < CountersSize; ++J) {
+        char Value = __atomic_exchange_n(&Shard[J], (char)0xFF,
+                                         __ATOMIC_RELAXED);
+        if (Fold)
+          CountersBegin[J] &= Value;
+      }
+      continue;
+    }
+    uint64_t *Counters = (uint64_t *)CountersBegin;
+    uint64_t *ShardCounters = (uint64_t *)Shard;
+    for (J = 0; J < CountersSize / sizeof(uint64_t); ++J) {
+      uint64_t Value = __atomic_exchange_n(&ShardCounters[J], 0,
+                                           __ATOMIC_RELAXED);
+      if (Fold)
+        Counters[J] += Value;
+    }
+  }
+}
+
+/* Allocate the copies of the counters, and point the entries of the shard
+ * table at them. Threads keep updating the counters themselves until this
+ * is done, so counts from before the initialization are not lost. */
+static void initCounterShards(void) {
+  char *CountersBegin = __llvm_profile_begin_counters();
+  char *CountersEnd = __llvm_profile_end_counters();
+  size_t CountersSize = CountersEnd - CountersBegin;
+  unsigned NumShards = DEFAULT_NUM_COUNTER_SHARDS;
+  const char *NumShardsStr;
+  unsigned I;
+
+  if ((void *)INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_VAR ==
+          (void *)INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_DEFAULT_VAR ||
+      CounterShards || !CountersSize)
+    return;
+
+  /* The counters are mapped onto the profile file in continuous mode, and
+   * the copies would never be folded into them. */
+  if (__llvm_profile_is_continuous_mode_enabled()) {
+    PROF_WARN("%s", "Counter sharding is not supported in continuous mode, "
+                    "the counters are not sharded.\n");
+    return;
+  }
+
+  NumShardsStr = getenv("LLVM_PROFILE_COUNTER_SHARDS");
+  if (NumShardsStr && NumShardsStr[0])
+    NumShards = atoi(NumShardsStr);
+  if (NumShards > INSTR_PROF_MAX_COUNTER_SHARDS)
+    NumShards = INSTR_PROF_MAX_COUNTER_SHARDS;
+  if (NumShards < 2)
+    return;
+
+  CounterShards = (char *)malloc((NumShards - 1) * CountersSize);
+  if (!CounterShards) {
+    PROF_WARN("Unable to allocate %u counter shards, the counters are not "
+              "sharded.\n",
+              NumShards);
+    return;
+  }
+  memset(CounterShards,
+         (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) ? 0xFF
+                                                                      : 0,
+         (NumShards - 1) * CountersSize);
+  NumCounterShardCopies = NumShards - 1;
+  CounterShardsHook = foldCounterShards;
+
+  /* Entries that map to the first shard keep updating the counters. */
+  for (I = 0; I < INSTR_PROF_MAX_COUNTER_SHARDS; ++I) {
+    unsigned Shard = I % NumShards;
+    intptr_t Bias = 0;
+    if (Shard)
+      Bias = (intptr_t)(CounterShards + (Shard - 1) * CountersSize) -
+             (intptr_t)CountersBegin;
+    __atomic_store_n(&INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_VAR[I], Bias,
+                     __ATOMIC_RELAXED);
+  }
+}
+#else
+static void initCounterShards(void) {}
+#endif
+
 static int isProfileMergeRequested() { return ProfileMergeRequested; }
 static void setProfileMergeRequested(int EnableMerge) {
   ProfileMergeRequested = EnableMerge;
@@ -994,6 +1109,7 @@ void __llvm_profile_initialize_file(void) {
 COMPILER_RT_VISIBILITY
 void __llvm_profile_initialize(void) {
   __llvm_profile_initialize_file();
+  initCounterShards();
   if (!__llvm_profile_is_continuous_mode_enabled())
     __llvm_profile_register_write_file_atexit();
 }
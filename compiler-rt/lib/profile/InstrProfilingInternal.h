@@ -191,6 +191,10 @@ COMPILER_RT_VISIBILITY extern uint32_t VPMaxNumValsPerSite;
 COMPILER_RT_VISIBILITY extern ValueProfNode *CurrentVNode;
 COMPILER_RT_VISIBILITY extern ValueProfNode *EndVNode;
 extern void (*VPMergeHook)(struct ValueProfData *, __llvm_profile_data *);
+/* Set when the threads update their own copies of the counters. When Fold is
+ * non-zero, the copies are added to the counters. They are reset either
+ * way. */
+COMPILER_RT_VISIBILITY extern void (*CounterShardsHook)(int Fold);
 
 /*
  * Write binary ids into profiles if writer is given.
@@ -155,7 +155,11 @@ int __llvm_profile_merge_from_buffer(const char *ProfileData,
     if (SrcCounters < SrcCountersStart || SrcCounters >= SrcNameStart ||
         (SrcCounters + __llvm_profile_counter_entry_size() * NC) > SrcNameStart)
       return 1;
-    for (unsigned I = 0; I < NC; I++) {
+    /* The times of the first calls of different runs can not be merged, the
+     * profile keeps the one of this run. */
+    unsigned FirstCounter =
+        (__llvm_profile_get_version() & VARIANT_MASK_TEMPORAL_PROF) ? 1 : 0;
+    for (unsigned I = FirstCounter; I < NC; I++) {
       if (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) {
         // A value of zero signifies the function is covered.
         DstCounters[I] &= SrcCounters[I];
@@ -17,6 +17,7 @@
 #include "secondary.h"
 #include "size_class_map.h"
 #include "tsd_exclusive.h"
+#include "tsd_percpu.h"
 #include "tsd_shared.h"
 
 namespace scudo {
@@ -46,13 +47,18 @@ namespace scudo {
 //   // Call map for user memory with at least this size. Only used with
 //   // primary64.
 //   static const uptr PrimaryMapSizeIncrement = 1UL << 18;
+//   // Lays out the regions so that user memory is backed by transparent huge
+//   // pages, and only releases whole huge pages to the OS. Only used with
+//   // primary64, requires regions of at least 64 huge pages.
+//   static const bool PrimaryEnableHugePages = false;
 //   // Defines the minimal & maximal release interval that can be set.
 //   static const s32 PrimaryMinReleaseToOsIntervalMs = INT32_MIN;
 //   static const s32 PrimaryMaxReleaseToOsIntervalMs = INT32_MAX;
 //   // Defines the type of cache used by the Secondary. Some additional
 //   // configuration entries can be necessary depending on the Cache.
 //   typedef MapAllocatorNoCache SecondaryCache;
-//   // Thread-Specific Data Registry used, shared or exclusive.
+//   // Thread-Specific Data Registry used, shared, exclusive or per-CPU (eg:
+//   // TSDRegistryPerCPUT<A, 64U> for up to 64 TSDs).
 //   template <class A> using TSDRegistryT = TSDRegistrySharedT<A, 8U, 4U>;
 // };
 
@@ -69,6 +75,7 @@ struct DefaultConfig {
   static const uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 #else
   typedef SizeClassAllocator32<DefaultConfig> Primary;
   static const uptr PrimaryRegionSizeLog = 19U;
@@ -98,6 +105,7 @@ struct AndroidConfig {
   static const uptr PrimaryCompactPtrScale = SCUDO_MIN_ALIGNMENT_LOG;
   static const bool PrimaryEnableRandomOffset = true;
   static const uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 #else
   typedef SizeClassAllocator32<AndroidConfig> Primary;
   static const uptr PrimaryRegionSizeLog = 18U;
@@ -129,6 +137,7 @@ struct AndroidSvelteConfig {
   static const uptr PrimaryCompactPtrScale = SCUDO_MIN_ALIGNMENT_LOG;
   static const bool PrimaryEnableRandomOffset = true;
   static const uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 #else
   typedef SizeClassAllocator32<AndroidSvelteConfig> Primary;
   static const uptr PrimaryRegionSizeLog = 16U;
@@ -159,6 +168,7 @@ struct FuchsiaConfig {
   typedef u32 PrimaryCompactPtrT;
   static const bool PrimaryEnableRandomOffset = true;
   static const uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
   static const uptr PrimaryCompactPtrScale = SCUDO_MIN_ALIGNMENT_LOG;
   static const s32 PrimaryMinReleaseToOsIntervalMs = INT32_MIN;
   static const s32 PrimaryMaxReleaseToOsIntervalMs = INT32_MAX;
@@ -179,6 +189,7 @@ struct TrustyConfig {
   static const bool PrimaryEnableRandomOffset = false;
   // Trusty is extremely memory-constrained so minimally round up map calls.
   static const uptr PrimaryMapSizeIncrement = 1UL << 4;
+  static const bool PrimaryEnableHugePages = false;
   static const uptr PrimaryCompactPtrScale = SCUDO_MIN_ALIGNMENT_LOG;
   static const s32 PrimaryMinReleaseToOsIntervalMs = INT32_MIN;
   static const s32 PrimaryMaxReleaseToOsIntervalMs = INT32_MAX;
@@ -106,4 +106,58 @@ BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::FuchsiaConfig)
     ->Range(MinIters, MaxIters);
 #endif
 
+// A Linux configuration using per-CPU caches, for comparison with the shared
+// TSDs of AndroidConfig in the multi-threaded benchmark below.
+#if SCUDO_LINUX
+struct PerCPUConfig : scudo::AndroidConfig {
+  template <class A>
+  using TSDRegistryT = scudo::TSDRegistryPerCPUT<A, 64U>;
+};
+#endif
+
+// Every benchmark thread allocates and frees batches of chunks of assorted
+// sizes from the same allocator, measuring the throughput of the TSDs under
+// contention.
+template <typename Config>
+static void BM_malloc_free_threaded(benchmark::State &State) {
+  using AllocatorT = scudo::Allocator<Config, PostInitCallback<Config>>;
+  static AllocatorT *Allocator;
+  if (State.thread_index() == 0) {
+    Allocator = new AllocatorT;
+    CurrentAllocator = Allocator;
+  }
+
+  constexpr size_t BatchSize = 64;
+  void *Ptrs[BatchSize];
+  // Benchmark threads only start iterating once all of them got here, by which
+  // point thread 0 has set up the allocator.
+  for (auto _ : State) {
+    for (size_t I = 0; I < BatchSize; I++) {
+      Ptrs[I] = Allocator->allocate(16U << (I % 8U),
+                                    scudo::Chunk::Origin::Malloc);
+      benchmark::DoNotOptimize(Ptrs[I]);
+    }
+    for (size_t I = 0; I < BatchSize; I++)
+      Allocator->deallocate(Ptrs[I], scudo::Chunk::Origin::Malloc);
+  }
+  State.SetItemsProcessed(uint64_t(State.iterations()) * BatchSize);
+
+  // Likewise, all threads are done iterating once any of them gets here.
+  if (State.thread_index() == 0) {
+    Allocator->unmapTestOnly();
+    delete Allocator;
+  }
+}
+
+static const int MaxThreads = 128;
+
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, scudo::AndroidConfig)
+    ->ThreadRange(1, MaxThreads)
+    ->UseRealTime();
+#if SCUDO_LINUX
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, PerCPUConfig)
+    ->ThreadRange(1, MaxThreads)
+    ->UseRealTime();
+#endif
+
 BENCHMARK_MAIN();
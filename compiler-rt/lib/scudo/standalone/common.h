@@ -130,6 +130,11 @@ inline uptr getPageSizeCached() {
 // Returns 0 if the number of CPUs could not be determined.
 u32 getNumberOfCPUs();
 
+// Returns the index of the CPU the calling thread is running on, or -1 if it
+// could not be determined. The thread can be migrated at any time, so the
+// result is only a hint.
+s32 getCurrentCPU();
+
 const char *getEnv(const char *Name);
 
 u64 getMonotonicTime();
@@ -147,6 +152,9 @@ bool getRandom(void *Buffer, uptr Length, bool Blocking = false);
 #define MAP_NOACCESS (1U << 1)
 #define MAP_RESIZABLE (1U << 2)
 #define MAP_MEMTAG (1U << 3)
+// Hints that the mapping should be backed by transparent huge pages when the
+// platform supports them.
+#define MAP_HUGEPAGE (1U << 4)
 
 // Our platform memory mapping use is restricted to 3 scenarios:
 // - reserve memory at a random address (MAP_NOACCESS);
@@ -70,6 +70,9 @@ void *map(void *Addr, uptr Size, UNUSED const char *Name, uptr Flags,
   if (Name)
     prctl(ANDROID_PR_SET_VMA, ANDROID_PR_SET_VMA_ANON_NAME, P, Size, Name);
 #endif
+  // This is only a hint, it fails if transparent huge pages are disabled.
+  if (Flags & MAP_HUGEPAGE)
+    madvise(P, Size, MADV_HUGEPAGE);
   return P;
 }
 
@@ -143,6 +146,39 @@ u32 getNumberOfCPUs() {
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+#if !SCUDO_ANDROID && (defined(__x86_64__) || defined(__aarch64__))
+// Since 2.35, glibc registers a restartable sequences area for every thread,
+// at this offset from the thread pointer. The kernel keeps its cpu_id field up
+// to date, so reading it directly saves a call into the C library, and with
+// older C libraries, the vDSO or system call behind sched_getcpu().
+extern "C" WEAK const ptrdiff_t __rseq_offset;
+extern "C" WEAK const unsigned int __rseq_size;
+
+static inline uptr getThreadPointer() {
+  uptr TP;
+#if defined(__x86_64__)
+  __asm__("mov %%fs:0, %0" : "=r"(TP));
+#else
+  __asm__("mrs %0, tpidr_el0" : "=r"(TP));
+#endif
+  return TP;
+}
+#endif
+
+s32 getCurrentCPU() {
+#if !SCUDO_ANDROID && (defined(__x86_64__) || defined(__aarch64__))
+  if (&__rseq_size && __rseq_size != 0) {
+    // The layout of struct rseq starts with u32 cpu_id_start, u32 cpu_id. The
+    // latter is negative if the registration failed.
+    const s32 CPU = *reinterpret_cast<volatile s32 *>(
+        getThreadPointer() + __rseq_offset + sizeof(u32));
+    if (LIKELY(CPU >= 0))
+      return CPU;
+  }
+#endif
+  return sched_getcpu();
+}
+
 u32 getThreadID() {
 #if SCUDO_ANDROID
   return static_cast<u32>(gettid());
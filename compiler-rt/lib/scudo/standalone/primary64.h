@@ -40,6 +40,12 @@ namespace scudo {
 //
 // The memory used by this allocator is never unmapped, but can be partially
 // released if the platform allows for it.
+//
+// If PrimaryEnableHugePages is set, the user memory of each Region starts on a
+// huge page boundary (the random offset is then a number of huge pages), it is
+// mapped in multiples of huge pages with a hint to back it with transparent
+// huge pages, and only whole free huge pages get released. This trades some
+// RSS for fewer dTLB misses.
 
 template <typename Config> class SizeClassAllocator64 {
 public:
@@ -74,10 +80,17 @@ public:
       RegionInfo *Region = getRegionInfo(I);
       // The actual start of a region is offset by a random number of pages
       // when PrimaryEnableRandomOffset is set.
-      Region->RegionBeg = getRegionBaseByClassId(I) +
-                          (Config::PrimaryEnableRandomOffset
-                               ? ((getRandomModN(&Seed, 16) + 1) * PageSize)
-                               : 0);
+      if (EnableHugePages)
+        Region->RegionBeg =
+            roundUpTo(getRegionBaseByClassId(I), HugePageSize) +
+            (Config::PrimaryEnableRandomOffset
+                 ? (getRandomModN(&Seed, 16) * HugePageSize)
+                 : 0);
+      else
+        Region->RegionBeg = getRegionBaseByClassId(I) +
+                            (Config::PrimaryEnableRandomOffset
+                                 ? ((getRandomModN(&Seed, 16) + 1) * PageSize)
+                                 : 0);
       Region->RandState = getRandomU32(&Seed);
       Region->ReleaseInfo.LastReleaseAtNs = Time;
     }
@@ -168,6 +181,8 @@ public:
                 "allocations; remains %zu\n",
                 TotalMapped >> 20, 0U, PoppedBlocks,
                 PoppedBlocks - PushedBlocks);
+    if (EnableHugePages)
+      getHugePageStats(Str);
 
     for (uptr I = 0; I < NumClasses; I++)
       getStats(Str, I, 0);
@@ -272,7 +287,15 @@ private:
   static const uptr NumClasses = SizeClassMap::NumClasses;
   static const uptr PrimarySize = RegionSize * NumClasses;
 
-  static const uptr MapSizeIncrement = Config::PrimaryMapSizeIncrement;
+  static const bool EnableHugePages = Config::PrimaryEnableHugePages;
+  // The size of a PMD-mapped transparent huge page with 4K pages.
+  static const uptr HugePageSize = 1UL << 21;
+  static_assert(!EnableHugePages || RegionSize >= 64 * HugePageSize,
+                "Regions are too small to be aligned on huge pages");
+
+  static const uptr MapSizeIncrement =
+      EnableHugePages ? roundUpTo(Config::PrimaryMapSizeIncrement, HugePageSize)
+                      : Config::PrimaryMapSizeIncrement;
   // Fill at most this number of batches from the newly map'd memory.
   static const u32 MaxNumBatches = SCUDO_ANDROID ? 4U : 8U;
 
@@ -286,6 +309,9 @@ private:
     uptr RangesReleased;
     uptr LastReleasedBytes;
     u64 LastReleaseAtNs;
+    // Only used with EnableHugePages.
+    uptr HugePagesReleased;
+    uptr LastKeptBytes;
   };
 
   struct UnpaddedRegionInfo {
@@ -360,7 +386,8 @@ private:
               reinterpret_cast<void *>(RegionBeg + MappedUser), MapSize,
               "scudo:primary",
               MAP_ALLOWNOMEM | MAP_RESIZABLE |
-                  (useMemoryTagging<Config>(Options.load()) ? MAP_MEMTAG : 0),
+                  (useMemoryTagging<Config>(Options.load()) ? MAP_MEMTAG : 0) |
+                  (EnableHugePages ? MAP_HUGEPAGE : 0),
               &Region->Data)))
         return nullptr;
       Region->MappedUser += MapSize;
@@ -424,21 +451,43 @@ private:
                 getRegionBaseByClassId(ClassId));
   }
 
+  void getHugePageStats(ScopedString *Str) {
+    uptr MappedHugePages = 0;
+    uptr HugePagesReleased = 0;
+    uptr KeptBytes = 0;
+    for (uptr I = 0; I < NumClasses; I++) {
+      RegionInfo *Region = getRegionInfo(I);
+      MappedHugePages += Region->MappedUser / HugePageSize;
+      HugePagesReleased += Region->ReleaseInfo.HugePagesReleased;
+      KeptBytes += Region->ReleaseInfo.LastKeptBytes;
+    }
+    // Huge pages released are faulted back in when the memory is reused, not
+    // necessarily as huge pages, so the released count is a measure of how
+    // much of the mapped memory may not be huge page backed.
+    Str->append("Stats: SizeClassAllocator64: %zu huge pages mapped; %zu "
+                "released; %zuK free but kept to preserve huge pages\n",
+                MappedHugePages, HugePagesReleased, KeptBytes >> 10);
+  }
+
   NOINLINE uptr releaseToOSMaybe(RegionInfo *Region, uptr ClassId,
                                  bool Force = false) {
     const uptr BlockSize = getSizeByClassId(ClassId);
     const uptr PageSize = getPageSizeCached();
+    // Only whole huge pages are released in huge page mode, so there is no
+    // point in looking for free memory until there is at least that much.
+    // This also batches the releases, and the madvise calls that go with them.
+    const uptr ReleaseGranule = EnableHugePages ? HugePageSize : PageSize;
 
     DCHECK_GE(Region->Stats.PoppedBlocks, Region->Stats.PushedBlocks);
     const uptr BytesInFreeList =
         Region->AllocatedUser -
         (Region->Stats.PoppedBlocks - Region->Stats.PushedBlocks) * BlockSize;
-    if (BytesInFreeList < PageSize)
+    if (BytesInFreeList < ReleaseGranule)
       return 0; // No chance to release anything.
     const uptr BytesPushed = (Region->Stats.PushedBlocks -
                               Region->ReleaseInfo.PushedBlocksAtLastRelease) *
                              BlockSize;
-    if (BytesPushed < PageSize)
+    if (BytesPushed < ReleaseGranule)
       return 0; // Nothing new to release.
 
     // Releasing smaller blocks is expensive, so we want to make sure that a
@@ -470,8 +519,19 @@ private:
       return decompactPtrInternal(CompactPtrBase, CompactPtr);
     };
     auto SkipRegion = [](UNUSED uptr RegionIndex) { return false; };
-    releaseFreeMemoryToOS(Region->FreeList, Region->AllocatedUser, 1U,
-                          BlockSize, &Recorder, DecompactPtr, SkipRegion);
+    if (EnableHugePages) {
+      HugePageReleaseRecorder<ReleaseRecorder> HugePageRecorder(&Recorder,
+                                                                HugePageSize);
+      releaseFreeMemoryToOS(Region->FreeList, Region->AllocatedUser, 1U,
+                            BlockSize, &HugePageRecorder, DecompactPtr,
+                            SkipRegion);
+      Region->ReleaseInfo.HugePagesReleased +=
+          Recorder.getReleasedBytes() / HugePageSize;
+      Region->ReleaseInfo.LastKeptBytes = HugePageRecorder.getKeptBytes();
+    } else {
+      releaseFreeMemoryToOS(Region->FreeList, Region->AllocatedUser, 1U,
+                            BlockSize, &Recorder, DecompactPtr, SkipRegion);
+    }
 
     if (Recorder.getReleasedRangesCount() > 0) {
       Region->ReleaseInfo.PushedBlocksAtLastRelease =
@@ -41,6 +41,40 @@ private:
   MapPlatformData *Data = nullptr;
 };
 
+// Forwards to another recorder only the huge pages that are entirely contained
+// in the released ranges. Releasing a part of a transparent huge page makes the
+// kernel split it, and the pages left are then backed by small pages, so we
+// rather keep around the free pages sharing a huge page with used ones. The
+// base of the wrapped recorder must be aligned on HugePageSize.
+template <class ReleaseRecorderT> class HugePageReleaseRecorder {
+public:
+  HugePageReleaseRecorder(ReleaseRecorderT *Recorder, uptr HugePageSize)
+      : Recorder(Recorder), HugePageSize(HugePageSize) {
+    DCHECK(isAligned(Recorder->getBase(), HugePageSize));
+  }
+
+  // Bytes that were free but have been kept to preserve huge pages.
+  uptr getKeptBytes() const { return KeptBytes; }
+
+  uptr getBase() const { return Recorder->getBase(); }
+
+  void releasePageRangeToOS(uptr From, uptr To) {
+    const uptr AlignedFrom = roundUpTo(From, HugePageSize);
+    const uptr AlignedTo = roundDownTo(To, HugePageSize);
+    if (AlignedFrom >= AlignedTo) {
+      KeptBytes += To - From;
+      return;
+    }
+    KeptBytes += (AlignedFrom - From) + (To - AlignedTo);
+    Recorder->releasePageRangeToOS(AlignedFrom, AlignedTo);
+  }
+
+private:
+  ReleaseRecorderT *const Recorder;
+  const uptr HugePageSize;
+  uptr KeptBytes = 0;
+};
+
 // A packed array of Counters. Each counter occupies 2^N bits, enough to store
 // counter's MaxValue. Ctor will try to use a static buffer first, and if that
 // fails (the buffer is too small or already locked), will allocate the
@@ -15,6 +15,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <stdlib.h>
+#include <string.h>
 #include <thread>
 #include <vector>
 
@@ -31,6 +32,7 @@ struct TestConfig1 {
   static const scudo::uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 };
 
 struct TestConfig2 {
@@ -47,6 +49,7 @@ struct TestConfig2 {
   static const scudo::uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 };
 
 struct TestConfig3 {
@@ -63,8 +66,25 @@ struct TestConfig3 {
   static const scudo::uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 };
 
+#if SCUDO_WORDSIZE == 64U
+// Regions must be large enough to hold a few huge pages. This one is not part
+// of the typed tests as it only releases memory by huge pages.
+struct TestConfig4 {
+  static const scudo::uptr PrimaryRegionSizeLog = 27U;
+  static const scudo::s32 PrimaryMinReleaseToOsIntervalMs = INT32_MIN;
+  static const scudo::s32 PrimaryMaxReleaseToOsIntervalMs = INT32_MAX;
+  static const bool MaySupportMemoryTagging = false;
+  typedef scudo::uptr PrimaryCompactPtrT;
+  static const scudo::uptr PrimaryCompactPtrScale = 0;
+  static const bool PrimaryEnableRandomOffset = true;
+  static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = true;
+};
+#endif
+
 template <typename BaseConfig, typename SizeClassMapT>
 struct Config : public BaseConfig {
   using SizeClassMap = SizeClassMapT;
@@ -153,6 +173,7 @@ struct SmallRegionsConfig {
   static const scudo::uptr PrimaryCompactPtrScale = 0;
   static const bool PrimaryEnableRandomOffset = true;
   static const scudo::uptr PrimaryMapSizeIncrement = 1UL << 18;
+  static const bool PrimaryEnableHugePages = false;
 };
 
 // The 64-bit SizeClassAllocator can be easily OOM'd with small region sizes.
@@ -294,3 +315,32 @@ SCUDO_TYPED_TEST(ScudoPrimaryTest, ReleaseToOS) {
   Cache.destroy(nullptr);
   EXPECT_GT(Allocator->releaseToOS(), 0U);
 }
+
+#if SCUDO_WORDSIZE == 64U
+TEST(ScudoPrimaryTest, ReleaseToOSHugePages) {
+  using Primary = TestAllocator<TestConfig4, scudo::DefaultSizeClassMap>;
+  std::unique_ptr<Primary> Allocator(new Primary);
+  Allocator->init(/*ReleaseToOsInterval=*/-1);
+  typename Primary::CacheT Cache;
+  Cache.init(nullptr, Allocator.get());
+  const scudo::uptr HugePageSize = 1UL << 21;
+  const scudo::uptr Size = 1024U;
+  const scudo::uptr ClassId = Primary::SizeClassMap::getClassIdBySize(Size);
+  // Allocate enough blocks to span a few huge pages, then free all of them.
+  std::vector<void *> V;
+  for (scudo::uptr I = 0; I < 8 * HugePageSize / Size; I++) {
+    void *P = Cache.allocate(ClassId);
+    EXPECT_NE(P, nullptr);
+    V.push_back(P);
+  }
+  for (void *P : V)
+    Cache.deallocate(ClassId, P);
+  Cache.destroy(nullptr);
+  const scudo::uptr Released = Allocator->releaseToOS();
+  EXPECT_GT(Released, 0U);
+  EXPECT_EQ(Released % HugePageSize, 0U);
+  scudo::ScopedString Str;
+  Allocator->getStats(&Str);
+  EXPECT_NE(strstr(Str.data(), "huge pages mapped"), nullptr);
+}
+#endif
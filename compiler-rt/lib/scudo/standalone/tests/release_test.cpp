@@ -74,6 +74,8 @@ public:
     LastPageReported = To;
   }
 
+  scudo::uptr getBase() const { return 0; }
+
 private:
   const scudo::uptr PageSizeScaledLog;
   scudo::uptr LastPageReported = 0;
@@ -115,6 +117,44 @@ TEST(ScudoReleaseTest, FreePagesRangeTracker) {
   }
 }
 
+TEST(ScudoReleaseTest, HugePageReleaseRecorder) {
+  // Huge pages are made of 4 pages here, '|' denotes a huge page boundary, and
+  // only the whole huge pages are expected to be reported.
+  const scudo::uptr PageSize = scudo::getPageSizeCached();
+  const scudo::uptr HugePageSize = 4 * PageSize;
+  const struct {
+    const char *Input;
+    const char *Expected;
+  } TestCases[] = {
+      {"....|....", ""},
+      {"xxxx|....", "xxxx"},
+      {"..xx|xx..", ""},
+      {".xxx|xxxx|xxx.", "....|xxxx"},
+      {"xxxx|xx..|..xx|xxxx", "xxxx|....|....|xxxx"},
+  };
+  for (const auto &TestCase : TestCases) {
+    std::string Input = TestCase.Input;
+    Input.erase(std::remove(Input.begin(), Input.end(), '|'), Input.end());
+    std::string Expected = TestCase.Expected;
+    Expected.erase(std::remove(Expected.begin(), Expected.end(), '|'),
+                   Expected.end());
+    StringRangeRecorder Recorder;
+    scudo::HugePageReleaseRecorder<StringRangeRecorder> HugePageRecorder(
+        &Recorder, HugePageSize);
+    scudo::FreePagesRangeTracker<
+        scudo::HugePageReleaseRecorder<StringRangeRecorder>>
+        Tracker(&HugePageRecorder);
+    for (char C : Input)
+      Tracker.processNextPage(C == 'x');
+    Tracker.finish();
+    EXPECT_STREQ(Expected.c_str(), Recorder.ReportedPages.c_str());
+    const scudo::uptr Free = std::count(Input.begin(), Input.end(), 'x');
+    const scudo::uptr Released =
+        std::count(Expected.begin(), Expected.end(), 'x');
+    EXPECT_EQ((Free - Released) * PageSize, HugePageRecorder.getKeptBytes());
+  }
+}
+
 class ReleasedPagesRecorder {
 public:
   std::set<scudo::uptr> ReportedPages;
@@ -9,8 +9,10 @@
 #include "tests/scudo_unit_test.h"
 
 #include "tsd_exclusive.h"
+#include "tsd_percpu.h"
 #include "tsd_shared.h"
 
+#include <sched.h>
 #include <stdlib.h>
 
 #include <condition_variable>
@@ -69,6 +71,11 @@ struct ExclusiveCaches {
   using TSDRegistryT = scudo::TSDRegistryExT<Allocator>;
 };
 
+struct PerCPUCaches {
+  template <class Allocator>
+  using TSDRegistryT = scudo::TSDRegistryPerCPUT<Allocator, 16U>;
+};
+
 TEST(ScudoTSDTest, TSDRegistryInit) {
   using AllocatorT = MockAllocator<OneCache>;
   auto Deleter = [](AllocatorT *A) {
@@ -116,6 +123,7 @@ template <class AllocatorT> static void testRegistry() {
 TEST(ScudoTSDTest, TSDRegistryBasic) {
   testRegistry<MockAllocator<OneCache>>();
   testRegistry<MockAllocator<SharedCaches>>();
+  testRegistry<MockAllocator<PerCPUCaches>>();
 #if !SCUDO_FUCHSIA
   testRegistry<MockAllocator<ExclusiveCaches>>();
 #endif
@@ -174,6 +182,7 @@ template <class AllocatorT> static void testRegistryThreaded() {
 TEST(ScudoTSDTest, TSDRegistryThreaded) {
   testRegistryThreaded<MockAllocator<OneCache>>();
   testRegistryThreaded<MockAllocator<SharedCaches>>();
+  testRegistryThreaded<MockAllocator<PerCPUCaches>>();
 #if !SCUDO_FUCHSIA
   testRegistryThreaded<MockAllocator<ExclusiveCaches>>();
 #endif
@@ -248,3 +257,49 @@ TEST(ScudoTSDTest, TSDRegistryTSDsCount) {
   // We should get 16 distinct TSDs back.
   EXPECT_EQ(Pointers.size(), 16U);
 }
+
+TEST(ScudoTSDTest, TSDRegistryPerCPU) {
+  using AllocatorT = MockAllocator<PerCPUCaches>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  auto Registry = Allocator->getTSDRegistry();
+  Registry->initThreadMaybe(Allocator.get(), /*MinimalInit=*/false);
+  // The number of TSDs follows the number of CPUs and can't be changed.
+  EXPECT_FALSE(Registry->setOption(scudo::Option::MaxTSDsCount, 16));
+  EXPECT_TRUE(Registry->setOption(scudo::Option::ThreadDisableMemInit, 1));
+  EXPECT_TRUE(Registry->getDisableMemInit());
+  EXPECT_TRUE(Registry->setOption(scudo::Option::ThreadDisableMemInit, 0));
+  EXPECT_FALSE(Registry->getDisableMemInit());
+
+  // Repeated lookups from a thread that stays on the same CPU get the same
+  // TSD back. Pinning the thread may be disallowed, in which case we can only
+  // check that we got a TSD.
+  bool UnlockRequired;
+  auto TSD = Registry->getTSDAndLock(&UnlockRequired);
+  EXPECT_NE(TSD, nullptr);
+  EXPECT_TRUE(UnlockRequired);
+  TSD->unlock();
+#if SCUDO_LINUX
+  const scudo::s32 CPU = scudo::getCurrentCPU();
+  ASSERT_GE(CPU, 0);
+  cpu_set_t OldCPUs, CPUs;
+  if (sched_getaffinity(0, sizeof(OldCPUs), &OldCPUs) != 0)
+    return;
+  CPU_ZERO(&CPUs);
+  CPU_SET(CPU, &CPUs);
+  if (sched_setaffinity(0, sizeof(CPUs), &CPUs) != 0)
+    return;
+  auto PinnedTSD = Registry->getTSDAndLock(&UnlockRequired);
+  PinnedTSD->unlock();
+  for (scudo::uptr I = 0; I < 256U; I++) {
+    TSD = Registry->getTSDAndLock(&UnlockRequired);
+    EXPECT_EQ(TSD, PinnedTSD);
+    TSD->unlock();
+  }
+  EXPECT_EQ(sched_setaffinity(0, sizeof(OldCPUs), &OldCPUs), 0);
+#endif
+}
@@ -85,6 +85,8 @@ u64 getMonotonicTime() {
 
 u32 getNumberOfCPUs() { return 0; }
 
+s32 getCurrentCPU() { return -1; }
+
 u32 getThreadID() { return 0; }
 
 bool getRandom(UNUSED void *Buffer, UNUSED uptr Length, UNUSED bool Blocking) {
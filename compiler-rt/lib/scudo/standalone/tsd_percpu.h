@@ -0,0 +1,138 @@
+//===-- tsd_percpu.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SCUDO_TSD_PERCPU_H_
+#define SCUDO_TSD_PERCPU_H_
+
+#include "tsd.h"
+
+namespace scudo {
+
+// A registry of TSDs indexed by the CPU the calling thread currently runs on.
+//
+// Exclusive TSDs cost a cache per thread, which adds up with thousands of
+// threads, while shared TSDs are assigned to threads round-robin, so that
+// threads running concurrently regularly end up contending for the same one.
+// Picking the TSD of the current CPU bounds the number of caches by the number
+// of CPUs, and the lock is only contended when a thread is preempted or
+// migrated while holding it.
+//
+// The CPU number is obtained through getCurrentCPU(), which on Linux reads the
+// restartable sequences area registered by the C library when there is one.
+// If the CPU can't be determined, threads fall back to a round-robin
+// assignment similar to the shared registry.
+template <class Allocator, u32 TSDsArraySize> struct TSDRegistryPerCPUT {
+  void init(Allocator *Instance) {
+    DCHECK(!Initialized);
+    Instance->init();
+    for (u32 I = 0; I < TSDsArraySize; I++)
+      TSDs[I].init(Instance);
+    const u32 NumberOfCPUs = getNumberOfCPUs();
+    NumberOfTSDs = (NumberOfCPUs == 0) ? TSDsArraySize
+                                       : Min(NumberOfCPUs, TSDsArraySize);
+    Initialized = true;
+  }
+
+  void initOnceMaybe(Allocator *Instance) {
+    ScopedLock L(Mutex);
+    if (LIKELY(Initialized))
+      return;
+    init(Instance); // Sets Initialized.
+  }
+
+  void unmapTestOnly(Allocator *Instance) {
+    for (u32 I = 0; I < TSDsArraySize; I++) {
+      TSDs[I].commitBack(Instance);
+      TSDs[I] = {};
+    }
+    State = {};
+    Initialized = false;
+  }
+
+  ALWAYS_INLINE void initThreadMaybe(Allocator *Instance,
+                                     UNUSED bool MinimalInit) {
+    if (LIKELY(State.Initialized))
+      return;
+    initThread(Instance);
+  }
+
+  ALWAYS_INLINE TSD<Allocator> *getTSDAndLock(bool *UnlockRequired) {
+    TSD<Allocator> *TSD = &TSDs[getCurrentIndex()];
+    *UnlockRequired = true;
+    if (LIKELY(TSD->tryLock()))
+      return TSD;
+    // Another thread on this CPU got preempted while holding the TSD, or we
+    // were migrated to this CPU. Either way this is transient, so wait for it
+    // rather than spreading to the TSD of another CPU.
+    TSD->lock();
+    return TSD;
+  }
+
+  void disable() {
+    Mutex.lock();
+    for (u32 I = 0; I < TSDsArraySize; I++)
+      TSDs[I].lock();
+  }
+
+  void enable() {
+    for (s32 I = static_cast<s32>(TSDsArraySize - 1); I >= 0; I--)
+      TSDs[I].unlock();
+    Mutex.unlock();
+  }
+
+  bool setOption(Option O, sptr Value) {
+    if (O == Option::ThreadDisableMemInit)
+      State.DisableMemInit = Value;
+    // The number of TSDs follows the number of CPUs.
+    if (O == Option::MaxTSDsCount)
+      return false;
+    return true;
+  }
+
+  bool getDisableMemInit() const { return State.DisableMemInit; }
+
+private:
+  struct ThreadState {
+    bool Initialized : 1;
+    bool DisableMemInit : 1;
+    // Only used when the current CPU can't be determined.
+    u32 FallbackIndex;
+  };
+
+  ALWAYS_INLINE u32 getCurrentIndex() const {
+    const s32 CPU = getCurrentCPU();
+    if (UNLIKELY(CPU < 0))
+      return State.FallbackIndex;
+    const u32 Index = static_cast<u32>(CPU);
+    // CPU numbers are usually dense, so avoid the division when we can.
+    return LIKELY(Index < NumberOfTSDs) ? Index : Index % NumberOfTSDs;
+  }
+
+  NOINLINE void initThread(Allocator *Instance) {
+    initOnceMaybe(Instance);
+    const u32 Index = atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
+    State.FallbackIndex = Index % NumberOfTSDs;
+    State.Initialized = true;
+    Instance->callPostInitCallback();
+  }
+
+  atomic_u32 CurrentIndex = {};
+  u32 NumberOfTSDs = 0;
+  bool Initialized = false;
+  HybridMutex Mutex;
+  TSD<Allocator> TSDs[TSDsArraySize];
+  static thread_local ThreadState State;
+};
+
+template <class Allocator, u32 TSDsArraySize>
+thread_local typename TSDRegistryPerCPUT<Allocator, TSDsArraySize>::ThreadState
+    TSDRegistryPerCPUT<Allocator, TSDsArraySize>::State;
+
+} // namespace scudo
+
+#endif // SCUDO_TSD_PERCPU_H_
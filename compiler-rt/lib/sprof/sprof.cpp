@@ -0,0 +1,304 @@
+//===-- sprof.cpp ---------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Sampling CPU profiler. A SIGPROF timer interrupts the process every 1 /
+// frequency seconds of CPU time, the interrupted thread unwinds its stack with
+// frame pointers and counts the sample against the stack depot id of its
+// stack. The counts are written out at exit, or on __sprof_dump(), in the
+// legacy CPU profile format of gperftools, which pprof reads and symbolizes
+// with the memory map written along with the samples.
+//
+// The runtime doesn't need the program to be instrumented: besides linking it
+// in (with --whole-archive for the static library), the shared library can be
+// preloaded into any program.
+//
+//===----------------------------------------------------------------------===//
+
+#include "sanitizer/sprof_interface.h"
+#include "sanitizer_common/sanitizer_atomic.h"
+#include "sanitizer_common/sanitizer_common.h"
+#include "sanitizer_common/sanitizer_file.h"
+#include "sanitizer_common/sanitizer_flag_parser.h"
+#include "sanitizer_common/sanitizer_flags.h"
+#include "sanitizer_common/sanitizer_internal_defs.h"
+#include "sanitizer_common/sanitizer_mutex.h"
+#include "sanitizer_common/sanitizer_posix.h"
+#include "sanitizer_common/sanitizer_stackdepot.h"
+#include "sanitizer_common/sanitizer_stacktrace.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/time.h>
+
+using namespace __sanitizer;
+
+namespace __sprof {
+
+struct Flags {
+#define SPROF_FLAG(Type, Name, DefaultValue, Description) Type Name;
+#include "sprof_flags.inc"
+#undef SPROF_FLAG
+
+  void SetDefaults() {
+#define SPROF_FLAG(Type, Name, DefaultValue, Description) Name = DefaultValue;
+#include "sprof_flags.inc"
+#undef SPROF_FLAG
+  }
+};
+
+static Flags sprof_flags;
+
+static void InitializeFlags() {
+  SetCommonFlagsDefaults();
+  sprof_flags.SetDefaults();
+
+  FlagParser parser;
+#define SPROF_FLAG(Type, Name, DefaultValue, Description)                      \
+  RegisterFlag(&parser, #Name, Description, &sprof_flags.Name);
+#include "sprof_flags.inc"
+#undef SPROF_FLAG
+  RegisterCommonFlags(&parser);
+  parser.ParseString(__sprof_default_options());
+  parser.ParseStringFromEnv("SPROF_OPTIONS");
+
+  InitializeCommonFlags();
+  if (Verbosity())
+    ReportUnrecognizedFlags();
+  if (common_flags()->help)
+    parser.PrintFlagDescriptions();
+}
+
+// Number of samples of each stack, in an open addressing hash table indexed by
+// stack depot id, so that it can be updated from the signal handler without
+// locks or allocations.
+struct StackCount {
+  atomic_uint32_t id;
+  atomic_uint64_t count;
+};
+
+static StackCount *stack_counts;
+static uptr stack_counts_size;
+// Samples dropped because the table was full or the stack couldn't be unwound.
+static atomic_uint64_t dropped_samples;
+
+static uptr main_thread_stack_top;
+static uptr main_thread_stack_bottom;
+
+static StaticSpinMutex state_mutex;
+static bool inited;
+static bool running;
+
+static void CountSample(u32 id) {
+  uptr mask = stack_counts_size - 1;
+  uptr i = (id * 0x9E3779B1U) & mask;
+  for (uptr n = 0; n < stack_counts_size; n++, i = (i + 1) & mask) {
+    StackCount &c = stack_counts[i];
+    u32 cur = atomic_load(&c.id, memory_order_acquire);
+    if (cur == 0) {
+      if (atomic_compare_exchange_strong(&c.id, &cur, id,
+                                         memory_order_acq_rel))
+        cur = id;
+    }
+    if (cur == id) {
+      atomic_fetch_add(&c.count, 1, memory_order_relaxed);
+      return;
+    }
+  }
+  atomic_fetch_add(&dropped_samples, 1, memory_order_relaxed);
+}
+
+static void SigprofHandler(int signo, siginfo_t *siginfo, void *context) {
+  int saved_errno = errno;
+  SignalContext sig(siginfo, context);
+  // Querying the bounds of the stack of the current thread isn't async signal
+  // safe, so only use them for the main thread. Frames can't be below sp, and
+  // the frame pointer of a leaf function may point right at it.
+  uptr bottom = sig.sp - 1;
+  uptr top;
+  if (sig.sp >= main_thread_stack_bottom && sig.sp < main_thread_stack_top)
+    top = main_thread_stack_top;
+  else
+    top = sig.sp + sprof_flags.max_stack_scan;
+  BufferedStackTrace stack;
+  stack.Unwind(sprof_flags.max_depth, sig.pc, sig.bp, context, top, bottom,
+               /*request_fast_unwind=*/true);
+  u32 id = stack.size ? StackDepotPut(stack) : 0;
+  if (id)
+    CountSample(id);
+  else
+    atomic_fetch_add(&dropped_samples, 1, memory_order_relaxed);
+  errno = saved_errno;
+}
+
+static uptr SamplingPeriodUs() { return 1000000 / sprof_flags.frequency; }
+
+static void SetTimer(uptr period_us) {
+  struct itimerval timer;
+  timer.it_interval.tv_sec = period_us / 1000000;
+  timer.it_interval.tv_usec = period_us % 1000000;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr))
+    Report("sprof: failed to set the profiling timer (errno: %d)\n", errno);
+}
+
+static void Start() {
+  SpinMutexLock l(&state_mutex);
+  if (!inited || running)
+    return;
+  struct sigaction sigact, old;
+  internal_memset(&sigact, 0, sizeof(sigact));
+  sigact.sa_sigaction = SigprofHandler;
+  sigact.sa_flags = SA_SIGINFO | SA_RESTART;
+  internal_sigaction(SIGPROF, &sigact, &old);
+  if (!(old.sa_flags & SA_SIGINFO) && old.sa_handler != SIG_DFL &&
+      old.sa_handler != SIG_IGN) {
+    // Somebody else is using SIGPROF, leave it to them.
+    Report("sprof: SIGPROF is already handled, not sampling\n");
+    internal_sigaction(SIGPROF, &old, nullptr);
+    return;
+  }
+  SetTimer(SamplingPeriodUs());
+  running = true;
+  VReport(1, "sprof: sampling every %zu us of CPU time\n", SamplingPeriodUs());
+}
+
+static void Stop() {
+  SpinMutexLock l(&state_mutex);
+  if (!running)
+    return;
+  SetTimer(0);
+  running = false;
+}
+
+static void WriteWord(fd_t fd, uptr word) {
+  WriteToFile(fd, &word, sizeof(word));
+}
+
+// Writes the profile in the legacy CPU profile format of gperftools: a header,
+// one record per stack (count, depth, pcs), a trailer, and the memory map of
+// the process in the format of /proc/self/maps.
+static bool WriteProfile() {
+  if (!inited)
+    return false;
+  InternalMmapVector<char> path(kMaxPathLength);
+  SubstituteForFlagValue(sprof_flags.profile_path, path.data(),
+                         kMaxPathLength);
+  error_t err;
+  fd_t fd = OpenFile(path.data(), WrOnly, &err);
+  if (fd == kInvalidFd) {
+    Report("sprof: failed to open %s for writing (reason: %d)\n", path.data(),
+           err);
+    return false;
+  }
+
+  // Header: header words, version, sampling period in us, padding.
+  WriteWord(fd, 0);
+  WriteWord(fd, 3);
+  WriteWord(fd, 0);
+  WriteWord(fd, SamplingPeriodUs());
+  WriteWord(fd, 0);
+
+  uptr num_stacks = 0;
+  u64 num_samples = 0;
+  for (uptr i = 0; i < stack_counts_size; i++) {
+    u32 id = atomic_load(&stack_counts[i].id, memory_order_acquire);
+    u64 count = atomic_load(&stack_counts[i].count, memory_order_relaxed);
+    if (!id || !count)
+      continue;
+    StackTrace stack = StackDepotGet(id);
+    WriteWord(fd, count);
+    WriteWord(fd, stack.size);
+    WriteToFile(fd, stack.trace, stack.size * sizeof(stack.trace[0]));
+    num_stacks++;
+    num_samples += count;
+  }
+
+  // Trailer: a record of a single sample of depth 1 at pc 0.
+  WriteWord(fd, 0);
+  WriteWord(fd, 1);
+  WriteWord(fd, 0);
+
+  char *maps = nullptr;
+  uptr maps_size = 0, maps_len = 0;
+  if (ReadFileToBuffer("/proc/self/maps", &maps, &maps_size, &maps_len)) {
+    WriteToFile(fd, maps, maps_len);
+    UnmapOrDie(maps, maps_size);
+  }
+  CloseFile(fd);
+
+  VReport(1,
+          "sprof: wrote %llu samples of %zu stacks to %s (%llu dropped)\n",
+          num_samples, num_stacks, path.data(),
+          atomic_load(&dropped_samples, memory_order_relaxed));
+  return true;
+}
+
+static void Initialize() {
+  SanitizerToolName = "SProf";
+  CacheBinaryName();
+  InitializeFlags();
+
+  if (sprof_flags.frequency <= 0 || sprof_flags.frequency > 1000000) {
+    Report("sprof: frequency must be in [1, 1000000], using 100\n");
+    sprof_flags.frequency = 100;
+  }
+  if (sprof_flags.max_depth <= 0 ||
+      (uptr)sprof_flags.max_depth > kStackTraceMax)
+    sprof_flags.max_depth = kStackTraceMax;
+  if (sprof_flags.max_stacks <= 0)
+    sprof_flags.max_stacks = 1 << 16;
+
+  stack_counts_size = RoundUpToPowerOfTwo(sprof_flags.max_stacks);
+  stack_counts = reinterpret_cast<StackCount *>(MmapOrDie(
+      stack_counts_size * sizeof(StackCount), "sprof stack counts"));
+  GetThreadStackTopAndBottom(/*at_initialization=*/true, &main_thread_stack_top,
+                             &main_thread_stack_bottom);
+  inited = true;
+
+  if (sprof_flags.start_at_init)
+    Start();
+}
+
+struct InitializeAndWriteProfileOnExit {
+  InitializeAndWriteProfileOnExit() { Initialize(); }
+  ~InitializeAndWriteProfileOnExit() {
+    Stop();
+    WriteProfile();
+  }
+} init;
+
+} // namespace __sprof
+
+using namespace __sprof;
+
+void __sanitizer::BufferedStackTrace::UnwindImpl(uptr pc, uptr bp,
+                                                 void *context,
+                                                 bool request_fast,
+                                                 u32 max_depth) {
+  uptr top = 0;
+  uptr bottom = 0;
+  GetThreadStackTopAndBottom(false, &top, &bottom);
+  Unwind(max_depth, pc, bp, context, top, bottom, /*request_fast=*/true);
+}
+
+extern "C" {
+
+SANITIZER_INTERFACE_ATTRIBUTE
+void __sprof_start() { Start(); }
+
+SANITIZER_INTERFACE_ATTRIBUTE
+void __sprof_stop() { Stop(); }
+
+SANITIZER_INTERFACE_ATTRIBUTE
+int __sprof_dump() { return WriteProfile() ? 0 : 1; }
+
+} // extern "C"
+
+SANITIZER_INTERFACE_WEAK_DEF(const char *, __sprof_default_options, void) {
+  return "";
+}
@@ -0,0 +1,119 @@
+// Mini-benchmark for tsan: scaling of the runtime with the number of threads.
+//
+// Each workload is run with 1, 2, 4, ... up to max_threads threads doing the
+// same amount of work each, so that the time per operation should stay flat
+// on a machine with enough cores (except for churn, as thread creation is
+// serialized). Compare the numbers with and without -fsanitize=thread to get
+// the overhead, and across thread counts to see how the runtime scales:
+//  - access: threads write to private memory, which mostly exercises the
+//    trace, and thus slot management when trace parts get switched;
+//  - sync: threads create, lock and destroy private mutexes, which exercises
+//    the allocation of sync objects;
+//  - churn: threads are started and joined in waves of up to max_threads,
+//    which exercises slot attachment and preemption once there are more
+//    threads than slots.
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int n_iterations;
+
+__attribute__((noinline)) void Access(volatile long *p, int n) {
+  for (int i = 0; i < n; i++)
+    p[i % 64] = i;
+}
+
+void *AccessThread(void *unused) {
+  volatile long data[64];
+  for (int i = 0; i < n_iterations; i++)
+    Access(data, 64);
+  return 0;
+}
+
+void *SyncThread(void *unused) {
+  for (int i = 0; i < n_iterations; i++) {
+    pthread_mutex_t m;
+    pthread_mutex_init(&m, 0);
+    pthread_mutex_lock(&m);
+    pthread_mutex_unlock(&m);
+    pthread_mutex_destroy(&m);
+  }
+  return 0;
+}
+
+void *ChurnThread(void *arg) {
+  // Do a bit of work so that the thread actually attaches to a slot.
+  volatile long data[64];
+  Access(data, 64);
+  return 0;
+}
+
+double Now() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void RunThreads(int n_threads, void *(*fn)(void *)) {
+  pthread_t *t = new pthread_t[n_threads];
+  for (int i = 0; i < n_threads; i++) {
+    int status = pthread_create(&t[i], 0, fn, 0);
+    assert(status == 0);
+  }
+  for (int i = 0; i < n_threads; i++)
+    pthread_join(t[i], 0);
+  delete[] t;
+}
+
+void RunChurn(int n_threads) {
+  for (int i = 0; i < n_iterations / 1000 + 1; i++)
+    RunThreads(n_threads, ChurnThread);
+}
+
+int main(int argc, char **argv) {
+  int max_threads = 128;
+  n_iterations = 100000;
+  const char *workload = 0;
+  if (argc > 1)
+    max_threads = atoi(argv[1]);
+  if (argc > 2)
+    n_iterations = atoi(argv[2]);
+  if (argc > 3)
+    workload = argv[3];
+  if (argc > 4 || max_threads <= 0 || n_iterations <= 0) {
+    printf("Usage: %s [max_threads [n_iterations [access|sync|churn]]]\n",
+           argv[0]);
+    return 1;
+  }
+  printf("%s: max_threads=%d n_iterations=%d\n", __FILE__, max_threads,
+         n_iterations);
+
+  struct {
+    const char *name;
+    void *(*fn)(void *);
+  } workloads[] = {
+      {"access", AccessThread},
+      {"sync", SyncThread},
+      {"churn", 0},
+  };
+  for (auto &w : workloads) {
+    if (workload && strcmp(workload, w.name))
+      continue;
+    for (int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+      double start = Now();
+      if (w.fn)
+        RunThreads(n_threads, w.fn);
+      else
+        RunChurn(n_threads);
+      double elapsed = Now() - start;
+      // Operations done by each thread.
+      double ops = w.fn ? n_iterations : n_iterations / 1000 + 1;
+      printf("%-6s threads=%-4d time=%8.3fs ns/op=%8.1f\n", w.name, n_threads,
+             elapsed, elapsed * 1e9 / ops);
+    }
+  }
+  return 0;
+}
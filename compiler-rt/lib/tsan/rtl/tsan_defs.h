@@ -57,6 +57,8 @@ constexpr uptr kByteBits = 8;
 enum class Sid : u8 {};
 constexpr uptr kThreadSlotCount = 256;
 constexpr Sid kFreeSid = static_cast<Sid>(255);
+// Number of queues the free slots are spread over, see Context::slot_queues.
+constexpr uptr kSlotQueueCount = 8;
 
 // Abstract time unit, vector clock element.
 enum class Epoch : u16 {};
@@ -209,6 +211,7 @@ enum {
   MutexTypeTrace,
   MutexTypeSlot,
   MutexTypeSlots,
+  MutexTypeSlotQueue,
 };
 
 }  // namespace __tsan
@@ -14,6 +14,8 @@
 // allocates/free indices of objects and provide a functionality to map
 // the index onto the real pointer. The index is u32, that is, 2 times smaller
 // than uptr (hense the Dense prefix).
+// Free objects that are not cached are kept in several freelists, each cache
+// going to its own one, so that caches of different threads rarely contend.
 //===----------------------------------------------------------------------===//
 #ifndef TSAN_DENSE_ALLOC_H
 #define TSAN_DENSE_ALLOC_H
@@ -28,6 +30,8 @@ class DenseSlabAllocCache {
   typedef u32 IndexT;
   uptr pos;
   IndexT cache[kSize];
+  // 1 + index of the freelist of this cache, 0 if not assigned yet.
+  u32 shard;
   template <typename, uptr, uptr, u64>
   friend class DenseSlabAlloc;
 };
@@ -87,16 +91,18 @@ class DenseSlabAlloc {
   void FlushCache(Cache *c) {
     if (!c->pos)
       return;
-    SpinMutexLock lock(&mtx_);
+    Shard *shard = GetShard(c);
+    SpinMutexLock lock(&shard->mtx);
     while (c->pos) {
       IndexT idx = c->cache[--c->pos];
-      *(IndexT*)Map(idx) = freelist_;
-      freelist_ = idx;
+      *(IndexT*)Map(idx) = shard->freelist;
+      shard->freelist = idx;
     }
   }
 
   void InitCache(Cache *c) {
     c->pos = 0;
+    c->shard = 0;
     internal_memset(c->cache, 0, sizeof(c->cache));
   }
 
@@ -114,48 +120,89 @@ class DenseSlabAlloc {
   }
 
  private:
+  static const uptr kShards = 8;
+
+  struct Shard {
+    IndexT freelist;
+    SpinMutex mtx;
+    char pad[SANITIZER_CACHE_LINE_SIZE - sizeof(IndexT) - sizeof(SpinMutex)];
+  };
+
   T *map_[kL1Size];
+  // Protects growing of the map.
   SpinMutex mtx_;
-  IndexT freelist_ = {0};
   atomic_uintptr_t fillpos_ = {0};
+  atomic_uint32_t next_shard_ = {0};
+  Shard shards_[kShards] = {};
   const char *const name_;
 
+  Shard *GetShard(Cache *c) {
+    if (UNLIKELY(c->shard == 0))
+      c->shard = 1 + atomic_fetch_add(&next_shard_, 1, memory_order_relaxed) %
+                         kShards;
+    return &shards_[c->shard - 1];
+  }
+
+  // Moves up to half a cache worth of objects from the shard to the cache.
+  bool RefillFromShard(Cache *c, Shard *shard) {
+    SpinMutexLock lock(&shard->mtx);
+    if (shard->freelist == 0)
+      return false;
+    for (uptr i = 0; i < Cache::kSize / 2 && shard->freelist != 0; i++) {
+      IndexT idx = shard->freelist;
+      c->cache[c->pos++] = idx;
+      shard->freelist = *(IndexT*)Map(idx);
+    }
+    return true;
+  }
+
   void Refill(Cache *c) {
+    Shard *own = GetShard(c);
+    if (RefillFromShard(c, own))
+      return;
+    // Take objects freed through other caches before mapping more memory.
+    for (uptr i = 1; i < kShards; i++) {
+      if (RefillFromShard(c, &shards_[(c->shard - 1 + i) % kShards]))
+        return;
+    }
     SpinMutexLock lock(&mtx_);
-    if (freelist_ == 0) {
-      uptr fillpos = atomic_load_relaxed(&fillpos_);
-      if (fillpos == kL1Size) {
-        Printf("ThreadSanitizer: %s overflow (%zu*%zu). Dying.\n",
-            name_, kL1Size, kL2Size);
-        Die();
-      }
-      VPrintf(2, "ThreadSanitizer: growing %s: %zu out of %zu*%zu\n", name_,
-              fillpos, kL1Size, kL2Size);
-      T *batch = (T*)MmapOrDie(kL2Size * sizeof(T), name_);
-      // Reserve 0 as invalid index.
-      IndexT start = fillpos == 0 ? 1 : 0;
-      for (IndexT i = start; i < kL2Size; i++) {
-        new(batch + i) T;
-        *(IndexT *)(batch + i) = i + 1 + fillpos * kL2Size;
-      }
-      *(IndexT*)(batch + kL2Size - 1) = 0;
-      freelist_ = fillpos * kL2Size + start;
-      map_[fillpos] = batch;
-      atomic_store_relaxed(&fillpos_, fillpos + 1);
+    uptr fillpos = atomic_load_relaxed(&fillpos_);
+    if (fillpos == kL1Size) {
+      Printf("ThreadSanitizer: %s overflow (%zu*%zu). Dying.\n",
+          name_, kL1Size, kL2Size);
+      Die();
     }
-    for (uptr i = 0; i < Cache::kSize / 2 && freelist_ != 0; i++) {
-      IndexT idx = freelist_;
-      c->cache[c->pos++] = idx;
-      freelist_ = *(IndexT*)Map(idx);
+    VPrintf(2, "ThreadSanitizer: growing %s: %zu out of %zu*%zu\n", name_,
+            fillpos, kL1Size, kL2Size);
+    T *batch = (T*)MmapOrDie(kL2Size * sizeof(T), name_);
+    // Reserve 0 as invalid index.
+    IndexT start = fillpos == 0 ? 1 : 0;
+    for (IndexT i = start; i < kL2Size; i++) {
+      new(batch + i) T;
+      *(IndexT *)(batch + i) = i + 1 + fillpos * kL2Size;
     }
+    map_[fillpos] = batch;
+    atomic_store_relaxed(&fillpos_, fillpos + 1);
+    // Put half a cache worth of the new objects in the cache, and the rest in
+    // the freelist of the cache.
+    IndexT first = fillpos * kL2Size + start;
+    IndexT last = fillpos * kL2Size + kL2Size - 1;
+    for (uptr i = 0; i < Cache::kSize / 2 && first <= last; i++)
+      c->cache[c->pos++] = first++;
+    if (first > last)
+      return;
+    SpinMutexLock shard_lock(&own->mtx);
+    *(IndexT*)Map(last) = own->freelist;
+    own->freelist = first;
   }
 
   void Drain(Cache *c) {
-    SpinMutexLock lock(&mtx_);
+    Shard *shard = GetShard(c);
+    SpinMutexLock lock(&shard->mtx);
     for (uptr i = 0; i < Cache::kSize / 2; i++) {
       IndexT idx = c->cache[--c->pos];
-      *(IndexT*)Map(idx) = freelist_;
-      freelist_ = idx;
+      *(IndexT*)Map(idx) = shard->freelist;
+      shard->freelist = idx;
     }
   }
 };
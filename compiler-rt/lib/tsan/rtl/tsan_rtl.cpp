@@ -132,11 +132,27 @@ void TraceResetForTesting() {
   ctx->trace_part_finished_excess = 0;
 }
 
-static void DoResetImpl(uptr epoch) {
+static SlotQueue* SlotQueueOf(TidSlot* slot) {
+  return &ctx->slot_queues[static_cast<uptr>(slot->sid) % kSlotQueueCount];
+}
+
+// Clang does not understand locking all queues in the loop.
+static void SlotQueuesLock() SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
+  for (auto& queue : ctx->slot_queues) queue.mtx.Lock();
+}
+
+static void SlotQueuesUnlock() SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
+  for (auto& queue : ctx->slot_queues) queue.mtx.Unlock();
+}
+
+static void DoResetImpl(uptr epoch) SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
   ThreadRegistryLock lock0(&ctx->thread_registry);
   Lock lock1(&ctx->slot_mtx);
   CHECK_EQ(ctx->global_epoch, epoch);
+  // Threads looking for a slot read the epoch under a queue mutex.
+  SlotQueuesLock();
   ctx->global_epoch++;
+  SlotQueuesUnlock();
   CHECK(!ctx->resetting);
   ctx->resetting = true;
   for (u32 i = ctx->thread_registry.NumThreadsLocked(); i--;) {
@@ -187,14 +203,18 @@ static void DoResetImpl(uptr epoch) {
       trace->parts_allocated = trace->parts.Size();
     }
   }
-  while (ctx->slot_queue.PopFront()) {
+  SlotQueuesLock();
+  for (auto& queue : ctx->slot_queues) {
+    while (queue.slots.PopFront()) {
+    }
   }
   for (auto& slot : ctx->slots) {
     slot.SetEpoch(kEpochZero);
     slot.journal.Reset();
     slot.thr = nullptr;
-    ctx->slot_queue.PushBack(&slot);
+    SlotQueueOf(&slot)->slots.PushBack(&slot);
   }
+  SlotQueuesUnlock();
 
   DPrintf("Resetting shadow...\n");
   if (!MmapFixedSuperNoReserve(ShadowBeg(), ShadowEnd() - ShadowBeg(),
@@ -235,23 +255,31 @@ static TidSlot* FindSlotAndLock(ThreadState* thr)
   CHECK(!thr->slot);
   TidSlot* slot = nullptr;
   for (;;) {
-    uptr epoch;
-    {
-      Lock lock(&ctx->slot_mtx);
-      epoch = ctx->global_epoch;
-      if (slot) {
-        // This is an exhausted slot from the previous iteration.
-        if (ctx->slot_queue.Queued(slot))
-          ctx->slot_queue.Remove(slot);
-        thr->slot_locked = false;
-        slot->mtx.Unlock();
-      }
+    if (slot) {
+      // This is an exhausted slot from the previous iteration.
+      SlotQueue* queue = SlotQueueOf(slot);
+      Lock lock(&queue->mtx);
+      if (queue->slots.Queued(slot))
+        queue->slots.Remove(slot);
+      thr->slot_locked = false;
+      slot->mtx.Unlock();
+      slot = nullptr;
+    }
+    // Threads start looking in different queues, and only move on to the
+    // next one when all slots of the current one are exhausted.
+    uptr epoch = 0;
+    const uptr first = static_cast<uptr>(thr->tid) % kSlotQueueCount;
+    for (uptr i = 0; i < kSlotQueueCount && !slot; i++) {
+      SlotQueue* queue = &ctx->slot_queues[(first + i) % kSlotQueueCount];
+      Lock lock(&queue->mtx);
+      if (i == 0)
+        epoch = ctx->global_epoch;
       for (;;) {
-        slot = ctx->slot_queue.PopFront();
+        slot = queue->slots.PopFront();
         if (!slot)
           break;
         if (slot->epoch() != kEpochLast) {
-          ctx->slot_queue.PushBack(slot);
+          queue->slots.PushBack(slot);
           break;
         }
       }
@@ -378,13 +406,15 @@ Context::Context()
   for (uptr i = 0; i < ARRAY_SIZE(slots); i++) {
     TidSlot* slot = &slots[i];
     slot->sid = static_cast<Sid>(i);
-    slot_queue.PushBack(slot);
+    slot_queues[i % kSlotQueueCount].slots.PushBack(slot);
   }
   global_epoch = 1;
 }
 
 TidSlot::TidSlot() : mtx(MutexTypeSlot) {}
 
+SlotQueue::SlotQueue() : mtx(MutexTypeSlotQueue) {}
+
 // The objects are allocated in TLS, so one may rely on zero-initialization.
 ThreadState::ThreadState(Tid tid)
     // Do not touch these, rely on zero initialization,
@@ -765,6 +795,7 @@ void ForkBefore(ThreadState* thr, uptr pc) SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
   for (auto& slot : ctx->slots) slot.mtx.Lock();
   ctx->thread_registry.Lock();
   ctx->slot_mtx.Lock();
+  SlotQueuesLock();
   ScopedErrorReportLock::Lock();
   AllocatorLock();
   // Suppress all reports in the pthread_atfork callbacks.
@@ -790,6 +821,7 @@ static void ForkAfter(ThreadState* thr) SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
   thr->ignore_reads_and_writes--;
   AllocatorUnlock();
   ScopedErrorReportLock::Unlock();
+  SlotQueuesUnlock();
   ctx->slot_mtx.Unlock();
   ctx->thread_registry.Unlock();
   for (auto& slot : ctx->slots) slot.mtx.Unlock();
@@ -953,7 +985,8 @@ void TraceSwitchPartImpl(ThreadState* thr) {
                      d.addr, d.stack_id);
   }
   {
-    Lock lock(&ctx->slot_mtx);
+    SlotQueue* queue = SlotQueueOf(thr->slot);
+    Lock lock(&queue->mtx);
     // There is a small chance that the slot may be not queued at this point.
     // This can happen if the slot has kEpochLast epoch and another thread
     // in FindSlotAndLock discovered that it's exhausted and removed it from
@@ -962,12 +995,14 @@ void TraceSwitchPartImpl(ThreadState* thr) {
     // or (2) if we've acquired a new slot in SlotLock in the beginning
     // of the function and the slot was at kEpochLast - 1, so after increment
     // in SlotAttachAndLock it become kEpochLast.
-    if (ctx->slot_queue.Queued(thr->slot)) {
-      ctx->slot_queue.Remove(thr->slot);
-      ctx->slot_queue.PushBack(thr->slot);
+    if (queue->slots.Queued(thr->slot)) {
+      queue->slots.Remove(thr->slot);
+      queue->slots.PushBack(thr->slot);
     }
-    if (recycle)
-      ctx->trace_part_recycle.PushBack(recycle);
+  }
+  if (recycle) {
+    Lock lock(&ctx->slot_mtx);
+    ctx->trace_part_recycle.PushBack(recycle);
   }
   DPrintf("#%d: TraceSwitchPart exit parts=%p-%p pos=0x%zx\n", thr->tid,
           trace->parts.Front(), trace->parts.Back(),
@@ -1056,8 +1091,11 @@ MutexMeta mutex_meta[] = {
     {MutexTypeSlot,
      "Slot",
      {MutexMulti, MutexTypeTrace, MutexTypeSyncVar, MutexThreadRegistry,
-      MutexTypeSlots}},
-    {MutexTypeSlots, "Slots", {MutexTypeTrace, MutexTypeReport}},
+      MutexTypeSlots, MutexTypeSlotQueue}},
+    {MutexTypeSlots,
+     "Slots",
+     {MutexTypeTrace, MutexTypeReport, MutexTypeSlotQueue}},
+    {MutexTypeSlotQueue, "SlotQueue", {MutexMulti}},
     {},
 };
 
@@ -154,6 +154,14 @@ struct TidSlot {
   TidSlot();
 } ALIGNED(SANITIZER_CACHE_LINE_SIZE);
 
+// A queue of slots that threads can attach to, least recently used first.
+struct SlotQueue {
+  Mutex mtx;
+  IList<TidSlot, &TidSlot::node> slots SANITIZER_GUARDED_BY(mtx);
+
+  SlotQueue();
+} ALIGNED(SANITIZER_CACHE_LINE_SIZE);
+
 // This struct is stored in TLS.
 struct ThreadState {
   FastState fast_state;
@@ -328,11 +336,15 @@ struct Context {
   // The last slot index (kFreeSid) is used to denote freed memory.
   TidSlot slots[kThreadSlotCount - 1];
 
-  // Protects global_epoch, slot_queue, trace_part_recycle.
+  // Protects global_epoch, trace_part_recycle.
   Mutex slot_mtx;
-  uptr global_epoch;  // guarded by slot_mtx and by all slot mutexes
-  bool resetting;     // global reset is in progress
-  IList<TidSlot, &TidSlot::node> slot_queue SANITIZER_GUARDED_BY(slot_mtx);
+  // Guarded by slot_mtx, by all slot mutexes and by all slot queue mutexes.
+  uptr global_epoch;
+  bool resetting;  // global reset is in progress
+  // The slots are spread over several queues so that threads attaching to a
+  // slot, or moving theirs to the back of its queue, don't all contend on the
+  // same mutex. A slot always goes back to the queue selected by its sid.
+  SlotQueue slot_queues[kSlotQueueCount];
   IList<TraceHeader, &TraceHeader::global, TracePart> trace_part_recycle
       SANITIZER_GUARDED_BY(slot_mtx);
   uptr trace_part_total_allocated SANITIZER_GUARDED_BY(slot_mtx);
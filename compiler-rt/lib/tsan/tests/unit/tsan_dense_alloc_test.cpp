@@ -52,4 +52,34 @@ TEST(DenseSlabAlloc, Basic) {
   }
 }
 
+TEST(DenseSlabAlloc, ReuseAcrossCaches) {
+  typedef u64 T;
+  typedef DenseSlabAlloc<T, 128, 128> Alloc;
+  typedef Alloc::Cache Cache;
+  typedef Alloc::IndexT IndexT;
+  const T N = 1000;
+
+  Alloc alloc("test");
+  Cache cache1, cache2;
+  alloc.InitCache(&cache1);
+  alloc.InitCache(&cache2);
+
+  IndexT blocks[N];
+  uptr allocated = 0;
+  for (int ntry = 0; ntry < 3; ntry++) {
+    for (T i = 0; i < N; i++) {
+      blocks[i] = alloc.Alloc(&cache1);
+      EXPECT_NE(blocks[i], 0U);
+    }
+    // Objects freed through another cache must be reused rather than new
+    // memory being mapped.
+    if (ntry == 0)
+      allocated = alloc.AllocatedMemory();
+    EXPECT_EQ(allocated, alloc.AllocatedMemory());
+    for (T i = 0; i < N; i++) alloc.Free(&cache2, blocks[i]);
+    alloc.FlushCache(&cache1);
+    alloc.FlushCache(&cache2);
+  }
+}
+
 }  // namespace __tsan
@@ -230,5 +230,41 @@ TEST(BufferQueueTest, GenerationalSupportAcrossThreads) {
   ASSERT_EQ(Counter.load(std::memory_order_acquire), 0);
 }
 
+TEST(BufferQueueTest, ConcurrentGetAndReleaseAreExclusive) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 4, Success);
+  ASSERT_TRUE(Success);
+  std::atomic<int> Failures{0};
+  auto Process = [&] {
+    for (int I = 0; I < 10000; ++I) {
+      BufferQueue::Buffer B;
+      if (Buffers.getBuffer(B) != BufferQueue::ErrorCode::Ok)
+        continue;
+      // No other thread may be holding the same buffer.
+      auto *Owned = reinterpret_cast<std::atomic<int> *>(B.Data);
+      if (Owned->exchange(1, std::memory_order_acq_rel) != 0)
+        Failures.fetch_add(1, std::memory_order_relaxed);
+      Owned->store(0, std::memory_order_release);
+      if (Buffers.releaseBuffer(B) != BufferQueue::ErrorCode::Ok)
+        Failures.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+  std::thread Threads[8];
+  for (auto &T : Threads)
+    T = std::thread(Process);
+  for (auto &T : Threads)
+    T.join();
+  EXPECT_EQ(Failures.load(), 0);
+
+  // All the buffers made it back to the queue.
+  BufferQueue::Buffer B[4];
+  for (auto &Buf : B)
+    EXPECT_EQ(Buffers.getBuffer(Buf), BufferQueue::ErrorCode::Ok);
+  BufferQueue::Buffer Extra;
+  EXPECT_EQ(Buffers.getBuffer(Extra), BufferQueue::ErrorCode::NotEnoughMemory);
+  for (auto &Buf : B)
+    EXPECT_EQ(Buffers.releaseBuffer(Buf), BufferQueue::ErrorCode::Ok);
+}
+
 } // namespace
 } // namespace __xray
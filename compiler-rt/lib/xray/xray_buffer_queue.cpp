@@ -73,6 +73,12 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   if (!finalizing())
     return BufferQueue::ErrorCode::AlreadyInitialized;
 
+  // Buffers from the previous generation are refused from now on, so we only
+  // need to wait for the calls that may still be using the current buffers.
+  atomic_fetch_add(&Generation, 1, memory_order_seq_cst);
+  while (atomic_load(&Users, memory_order_seq_cst) != 0)
+    internal_sched_yield();
+
   cleanupBuffers();
 
   bool Success = false;
@@ -106,10 +112,6 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   if (Buffers == nullptr)
     return BufferQueue::ErrorCode::NotEnoughMemory;
 
-  // At this point we increment the generation number to associate the buffers
-  // to the new generation.
-  atomic_fetch_add(&Generation, 1, memory_order_acq_rel);
-
   // First, we initialize the refcount in the ControlBlock, which we treat as
   // being at the start of the BackingStore pointer.
   atomic_store(&BackingStore->RefCount, 1, memory_order_release);
@@ -132,11 +134,13 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
     Buf.ExtentsBackingStore = ExtentsBackingStore;
     Buf.Count = BufferCount;
     T.Used = false;
+    // All the buffers start in the ring, at positions [0, BufferCount).
+    atomic_store(&T.Sequence, i + 1, memory_order_relaxed);
   }
 
-  Next = Buffers;
-  First = Buffers;
-  LiveBuffers = 0;
+  atomic_store(&Next, 0, memory_order_relaxed);
+  atomic_store(&First, BufferCount, memory_order_relaxed);
+  atomic_store(&LiveBuffers, 0, memory_order_relaxed);
   atomic_store(&Finalizing, 0, memory_order_release);
   Success = true;
   return BufferQueue::ErrorCode::Ok;
@@ -151,26 +155,60 @@ BufferQueue::BufferQueue(size_t B, size_t N,
       BackingStore(nullptr),
       ExtentsBackingStore(nullptr),
       Buffers(nullptr),
-      Next(Buffers),
-      First(Buffers),
-      LiveBuffers(0),
+      Next{0},
+      First{0},
+      LiveBuffers{0},
+      Users{0},
       Generation{0} {
   Success = init(B, N) == BufferQueue::ErrorCode::Ok;
 }
 
+// The available buffers form a bounded ring, in which getBuffer takes from
+// position Next and releaseBuffer puts back at position First. Each slot has a
+// sequence number saying what the slot is ready for: a slot holds the buffer
+// at position P when its sequence is P + 1, and can receive the buffer
+// released at position P when its sequence is P. Claiming a position is a
+// compare-and-swap, after which the thread owns the slot until it publishes
+// the new sequence, so neither operation takes a lock.
+//
+// LiveBuffers is updated before claiming a position, which guarantees that
+// the slot becomes ready: a slot not ready yet is still being published by
+// another thread, and we only have to wait for it.
+
 BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
   if (atomic_load(&Finalizing, memory_order_acquire))
     return ErrorCode::QueueFinalizing;
 
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (LiveBuffers == BufferCount)
+  atomic_fetch_add(&Users, 1, memory_order_seq_cst);
+  auto ReleaseUser = at_scope_exit(
+      [this] { atomic_fetch_sub(&Users, 1, memory_order_seq_cst); });
+  // init() may have started since the check above, in which case it waits for
+  // us unless we see it.
+  if (atomic_load(&Finalizing, memory_order_seq_cst))
+    return ErrorCode::QueueFinalizing;
+
+  uptr Live = atomic_load(&LiveBuffers, memory_order_relaxed);
+  do {
+    if (Live == BufferCount)
       return ErrorCode::NotEnoughMemory;
-    B = Next++;
-    if (Next == (Buffers + BufferCount))
-      Next = Buffers;
-    ++LiveBuffers;
+  } while (!atomic_compare_exchange_weak(&LiveBuffers, &Live, Live + 1,
+                                         memory_order_relaxed));
+
+  BufferRep *B = nullptr;
+  u64 Pos = atomic_load(&Next, memory_order_relaxed);
+  for (;;) {
+    B = &Buffers[Pos % BufferCount];
+    u64 Seq = atomic_load(&B->Sequence, memory_order_acquire);
+    s64 Diff = static_cast<s64>(Seq - (Pos + 1));
+    if (Diff == 0) {
+      if (atomic_compare_exchange_weak(&Next, &Pos, Pos + 1,
+                                       memory_order_relaxed))
+        break;
+      continue;
+    }
+    if (Diff < 0)
+      internal_sched_yield();
+    Pos = atomic_load(&Next, memory_order_relaxed);
   }
 
   incRefCount(BackingStore);
@@ -178,30 +216,51 @@ BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
   Buf = B->Buff;
   Buf.Generation = generation();
   B->Used = true;
+  atomic_store(&B->Sequence, Pos + BufferCount, memory_order_release);
   return ErrorCode::Ok;
 }
 
 BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
+  atomic_fetch_add(&Users, 1, memory_order_seq_cst);
+  auto ReleaseUser = at_scope_exit(
+      [this] { atomic_fetch_sub(&Users, 1, memory_order_seq_cst); });
+  if (Buf.Generation != atomic_load(&Generation, memory_order_seq_cst)) {
+    Buf = {};
+    decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
+    decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
+    return BufferQueue::ErrorCode::Ok;
+  }
+
   // Check whether the buffer being referred to is within the bounds of the
   // backing store's range.
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (Buf.Generation != generation() || LiveBuffers == 0) {
+  if (Buf.Data < &BackingStore->Data ||
+      Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
+    return BufferQueue::ErrorCode::UnrecognizedBuffer;
+
+  uptr Live = atomic_load(&LiveBuffers, memory_order_relaxed);
+  do {
+    if (Live == 0) {
       Buf = {};
-      decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
-      decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
       return BufferQueue::ErrorCode::Ok;
     }
+  } while (!atomic_compare_exchange_weak(&LiveBuffers, &Live, Live - 1,
+                                         memory_order_relaxed));
 
-    if (Buf.Data < &BackingStore->Data ||
-        Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
-      return BufferQueue::ErrorCode::UnrecognizedBuffer;
-
-    --LiveBuffers;
-    B = First++;
-    if (First == (Buffers + BufferCount))
-      First = Buffers;
+  BufferRep *B = nullptr;
+  u64 Pos = atomic_load(&First, memory_order_relaxed);
+  for (;;) {
+    B = &Buffers[Pos % BufferCount];
+    u64 Seq = atomic_load(&B->Sequence, memory_order_acquire);
+    s64 Diff = static_cast<s64>(Seq - Pos);
+    if (Diff == 0) {
+      if (atomic_compare_exchange_weak(&First, &Pos, Pos + 1,
+                                       memory_order_relaxed))
+        break;
+      continue;
+    }
+    if (Diff < 0)
+      internal_sched_yield();
+    Pos = atomic_load(&First, memory_order_relaxed);
   }
 
   // Now that the buffer has been released, we mark it as "used".
@@ -211,6 +270,7 @@ BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
   decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
   atomic_store(B->Buff.Extents, atomic_load(Buf.Extents, memory_order_acquire),
                memory_order_release);
+  atomic_store(&B->Sequence, Pos + 1, memory_order_release);
   Buf = {};
   return ErrorCode::Ok;
 }
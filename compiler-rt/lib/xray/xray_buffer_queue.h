@@ -68,6 +68,11 @@ public:
     // The managed buffer.
     Buffer Buff;
 
+    // Sequence number of the slot in the ring of available buffers. It
+    // tells getBuffer and releaseBuffer whether the slot currently holds a
+    // buffer for the position they claimed, see getBuffer.
+    atomic_uint64_t Sequence;
+
     // This is true if the buffer has been returned to the available queue, and
     // is considered "used" by another thread.
     bool Used = false;
@@ -137,6 +142,7 @@ private:
   // Amount of pre-allocated buffers.
   size_t BufferCount;
 
+  // Serializes init() and apply(). getBuffer and releaseBuffer don't take it.
   SpinMutex Mutex;
   atomic_uint8_t Finalizing;
 
@@ -149,15 +155,19 @@ private:
   // A dynamically allocated array of BufferRep instances.
   BufferRep *Buffers;
 
-  // Pointer to the next buffer to be handed out.
-  BufferRep *Next;
+  // Position in the ring of the next buffer to be handed out. The slot used
+  // is the position modulo BufferCount.
+  atomic_uint64_t Next;
 
-  // Pointer to the entry in the array where the next released buffer will be
-  // placed.
-  BufferRep *First;
+  // Position in the ring where the next released buffer will be placed.
+  atomic_uint64_t First;
 
   // Count of buffers that have been handed out through 'getBuffer'.
-  size_t LiveBuffers;
+  atomic_uintptr_t LiveBuffers;
+
+  // Count of getBuffer and releaseBuffer calls in progress, which init() waits
+  // for before it frees the buffers.
+  atomic_uint32_t Users;
 
   // We use a generation number to identify buffers and which generation they're
   // associated with.
@@ -202,6 +212,9 @@ public:
   /// error in case there are no available buffers to return when we will run
   /// over the upper bound for the total buffers.
   ///
+  /// This and releaseBuffer are lock-free, so that threads switching buffers
+  /// don't contend on a lock.
+  ///
   /// Requirements:
   ///   - BufferQueue is not finalising.
   ///
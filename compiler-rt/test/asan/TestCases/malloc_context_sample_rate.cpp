@@ -0,0 +1,19 @@
+// RUN: %clangxx_asan -O0 %s -o %t
+// RUN: not %run %t 2>&1 | FileCheck %s --check-prefixes=CHECK,ALL
+// RUN: %env_asan_opts=malloc_context_sample_rate=1000000 not %run %t 2>&1 | FileCheck %s --check-prefixes=CHECK,SAMPLED
+
+int main() {
+  char *x = new char[20];
+  delete[] x;
+  return x[0];
+
+  // Deallocation stacks are never sampled out.
+  // CHECK: freed by thread T{{.*}} here:
+  // CHECK: #{{[0-9]+}} 0x{{.*}} in main {{.*}}malloc_context_sample_rate.cpp
+
+  // CHECK: previously allocated by thread T{{.*}} here:
+  // ALL: #{{[0-9]+}} 0x{{.*}} in main {{.*}}malloc_context_sample_rate.cpp
+  // SAMPLED-NEXT: <empty stack>
+
+  // CHECK: SUMMARY: AddressSanitizer: heap-use-after-free
+}
@@ -0,0 +1,92 @@
+// Check that samples of a busy loop are written at exit in the legacy
+// gperftools CPU profile format, with full stacks.
+// RUN: %clang_sprof %s -o %t
+// RUN: rm -f %t.prof
+// RUN: env SPROF_OPTIONS=profile_path=%t.prof:frequency=1000 %run %t
+// RUN: env SPROF_OPTIONS=profile_path=%t.check %run %t check %t.prof 2>&1 | FileCheck %s
+
+// Nothing is sampled until __sprof_start() with start_at_init=0.
+// RUN: env SPROF_OPTIONS=profile_path=%t.prof:start_at_init=0 %run %t
+// RUN: env SPROF_OPTIONS=profile_path=%t.check %run %t check %t.prof 2>&1 | FileCheck %s --check-prefix=STOPPED
+// RUN: env SPROF_OPTIONS=profile_path=%t.prof:start_at_init=0:frequency=1000 %run %t start
+// RUN: env SPROF_OPTIONS=profile_path=%t.check %run %t check %t.prof 2>&1 | FileCheck %s
+
+// The shared runtime can be preloaded into a program that isn't linked with it.
+// RUN: %clang %s -o %t-preload -DNO_INTERFACE
+// RUN: env LD_PRELOAD=%libsprof_shared SPROF_OPTIONS=profile_path=%t.prof:frequency=1000 %run %t-preload
+// RUN: env SPROF_OPTIONS=profile_path=%t.check %run %t check %t.prof 2>&1 | FileCheck %s
+
+// CHECK: header: 0 3 0 0
+// CHECK: deep stacks: 1
+// CHECK: maps: 1
+// STOPPED: header: 0 3 0 0
+// STOPPED: samples: 0
+// STOPPED: maps: 1
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef NO_INTERFACE
+#include <sanitizer/sprof_interface.h>
+#endif
+
+__attribute__((noinline)) double Spin(int n) {
+  volatile double x = 0;
+  for (int i = 0; i < n; i++)
+    x += i * 0.5;
+  return x;
+}
+
+__attribute__((noinline)) double Busy(int n) { return Spin(n) + 1; }
+
+static int Check(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "no profile at %s\n", path);
+    return 1;
+  }
+  uintptr_t header[5];
+  if (fread(header, sizeof(header), 1, f) != 1)
+    return 1;
+  fprintf(stderr, "header: %lu %lu %lu %lu\n", (unsigned long)header[0],
+          (unsigned long)header[1], (unsigned long)header[2],
+          (unsigned long)header[4]);
+
+  unsigned long samples = 0, deep = 0;
+  for (;;) {
+    uintptr_t record[2], pcs[256];
+    if (fread(record, sizeof(record), 1, f) != 1 || record[1] > 256 ||
+        fread(pcs, sizeof(pcs[0]), record[1], f) != record[1])
+      return 1;
+    if (record[0] == 0 && record[1] == 1 && pcs[0] == 0)
+      break; // Trailer.
+    samples += record[0];
+    // Spin, Busy, main and whatever called main.
+    if (record[1] >= 4)
+      deep += record[0];
+  }
+  char maps[64] = {0};
+  fread(maps, 1, sizeof(maps) - 1, f);
+  fclose(f);
+
+  if (samples == 0)
+    fprintf(stderr, "samples: 0\n");
+  else
+    fprintf(stderr, "deep stacks: %d\n", deep * 2 > samples);
+  fprintf(stderr, "maps: %d\n", strchr(maps, '-') != NULL);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc == 3 && !strcmp(argv[1], "check"))
+    return Check(argv[2]);
+#ifndef NO_INTERFACE
+  if (argc == 2 && !strcmp(argv[1], "start"))
+    __sprof_start();
+#endif
+  double s = 0;
+  for (int i = 0; i < 200; i++)
+    s += Busy(1000000);
+  return s < 0;
+}
@@ -0,0 +1,34 @@
+# -*- Python -*-
+
+import os
+
+# Setup config name.
+config.name = 'SProf' + config.name_suffix
+
+# Setup source root.
+config.test_source_root = os.path.join(os.path.dirname(__file__), 'TestCases')
+
+# Test suffixes.
+config.suffixes = ['.c', '.cpp']
+
+c_flags = [config.target_cflags, '-O1', '-fno-omit-frame-pointer']
+
+libsprof = os.path.join(config.compiler_rt_libdir,
+                        "libclang_rt.sprof%s.a" % config.target_suffix)
+libsprof_shared = os.path.join(config.compiler_rt_libdir,
+                               "libclang_rt.sprof%s.so" % config.target_suffix)
+
+# Nothing in the program refers to the runtime, so it has to be linked whole.
+sprof_link_flags = ["-pthread", "-Wl,--whole-archive", libsprof,
+                    "-Wl,--no-whole-archive", "-ldl"]
+
+def build_invocation(compile_flags):
+  return " " + " ".join([config.clang] + compile_flags) + " "
+
+config.substitutions.append(("%clang ", build_invocation(c_flags)))
+config.substitutions.append(
+    ("%clang_sprof ", build_invocation(c_flags + sprof_link_flags)))
+config.substitutions.append(("%libsprof_shared", libsprof_shared))
+
+if config.host_os not in ['Linux']:
+   config.unsupported = True
@@ -7,8 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "big-radix-floating-point.h"
+#include "shortest-decimal.h"
 #include "flang/Decimal/decimal.h"
 #include <cassert>
+#include <cstring>
 #include <string>
 
 namespace Fortran::decimal {
@@ -118,7 +120,17 @@ BigRadixFloatingPointNumber<PREC, LOG10RADIX>::ConvertToDecimal(char *buffer,
   while (sp > stack) {
     *p++ = *--sp;
   }
+  // Digits beyond the limit only matter for rounding, and then only whether
+  // any of them are nonzero.
+  bool sticky{false};
+  int skipped{0};
   for (int j{digits_ - 1}; j-- > 0;) {
+    if (maxDigits > 0 && p - start > maxDigits) {
+      for (skipped = j + 1; j >= 0 && !sticky; --j) {
+        sticky = digit_[j] != 0;
+      }
+      break;
+    }
     Digit dig{digit_[j]};
     char *reverse{p += log10Radix};
     for (int k{0}; k < log10Radix; k += 2) {
@@ -133,7 +145,7 @@ BigRadixFloatingPointNumber<PREC, LOG10RADIX>::ConvertToDecimal(char *buffer,
   }
   // Adjust exponent so the effective decimal point is to
   // the left of the first digit.
-  int expo = exponent_ + p - start;
+  int expo = exponent_ + p - start + skipped * log10Radix;
   // Trim trailing zeroes.
   while (p[-1] == '0') {
     --p;
@@ -142,7 +154,7 @@ BigRadixFloatingPointNumber<PREC, LOG10RADIX>::ConvertToDecimal(char *buffer,
   if (maxDigits == 0) {
     p = end;
   }
-  if (p <= end) {
+  if (p <= end && !sticky) {
     *p = '\0';
     return {buffer, static_cast<std::size_t>(p - buffer), expo, Exact};
   } else {
@@ -151,7 +163,8 @@ BigRadixFloatingPointNumber<PREC, LOG10RADIX>::ConvertToDecimal(char *buffer,
     switch (rounding_) {
     case RoundNearest:
       incr = *end > '5' ||
-          (*end == '5' && (p > end + 1 || ((end[-1] - '0') & 1) != 0));
+          (*end == '5' &&
+              (p > end + 1 || sticky || ((end[-1] - '0') & 1) != 0));
       break;
     case RoundUp:
       incr = !isNegative_;
@@ -276,6 +289,44 @@ void BigRadixFloatingPointNumber<PREC, LOG10RADIX>::Minimize(
   Normalize();
 }
 
+// Implements the Minimize flag for IEEE single and double precision with
+// round-to-nearest; see shortest-decimal.h.  Returns a null string when the
+// result does not fit in the buffer or exceeds the digit limit, so that the
+// general conversion can handle those cases.
+template <int PREC>
+static ConversionToDecimalResult ConvertShortestToDecimal(char *buffer,
+    std::size_t size, enum DecimalConversionFlags flags, int maxDigits,
+    BinaryFloatingPointNumber<PREC> x) {
+  ShortestDecimal shortest{FindShortestDecimal(x)};
+  std::uint64_t significand{shortest.significand};
+  int exponent{shortest.exponent};
+  while (significand % 10 == 0) {
+    significand /= 10;
+    ++exponent;
+  }
+  char digits[20], *end{digits + sizeof digits}, *first{end};
+  do {
+    *--first = '0' + static_cast<char>(significand % 10);
+    significand /= 10;
+  } while (significand > 0);
+  std::size_t length(end - first);
+  if (maxDigits <= 0 || length > static_cast<std::size_t>(maxDigits) ||
+      size < length + 2) {
+    return {nullptr, 0, 0, Overflow};
+  }
+  char *p{buffer};
+  if (x.IsNegative()) {
+    *p++ = '-';
+  } else if (flags & AlwaysSign) {
+    *p++ = '+';
+  }
+  std::memcpy(p, first, length);
+  p += length;
+  *p = '\0';
+  return {buffer, static_cast<std::size_t>(p - buffer),
+      exponent + static_cast<int>(length), Exact};
+}
+
 template <int PREC>
 ConversionToDecimalResult ConvertToDecimal(char *buffer, std::size_t size,
     enum DecimalConversionFlags flags, int digits,
@@ -291,6 +342,14 @@ ConversionToDecimalResult ConvertToDecimal(char *buffer, std::size_t size,
       return {"Inf", 3, 0, Exact};
     }
   } else {
+    if constexpr (PREC == 24 || PREC == 53) {
+      if ((flags & Minimize) && rounding == RoundNearest && !x.IsZero()) {
+        auto result{ConvertShortestToDecimal(buffer, size, flags, digits, x)};
+        if (result.str) {
+          return result;
+        }
+      }
+    }
     using Big = BigRadixFloatingPointNumber<PREC>;
     Big number{x, rounding};
     if ((flags & Minimize) && !x.IsZero()) {
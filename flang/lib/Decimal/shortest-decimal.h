@@ -0,0 +1,199 @@
+//===-- lib/Decimal/shortest-decimal.h --------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef FORTRAN_DECIMAL_SHORTEST_DECIMAL_H_
+#define FORTRAN_DECIMAL_SHORTEST_DECIMAL_H_
+
+// Finds the shortest decimal representation of an IEEE binary32 or binary64
+// value that converts back to the same value with round-to-nearest-even,
+// choosing the representation that is closest to the value when several of
+// them have the fewest digits.
+//
+// This is the algorithm of Ulf Adams, "Ryu: Fast Float-to-String Conversion"
+// (PLDI 2018): the value and the bounds of its rounding interval are scaled
+// by a power of ten with 64x128-bit multiplications by precomputed powers of
+// five, so that the digits can then be removed with 64-bit arithmetic only.
+// The big radix arithmetic of the general conversion is avoided entirely.
+// Binary32 values use the binary64 tables, which are more than precise
+// enough for them.
+
+#include "powers-of-five.h"
+#include "flang/Common/uint128.h"
+#include "flang/Decimal/binary-floating-point.h"
+#include <cinttypes>
+
+namespace Fortran::decimal {
+
+// A decimal value of the form significand * 10**exponent
+struct ShortestDecimal {
+  std::uint64_t significand;
+  int exponent;
+};
+
+// ceil(log2(5**e)), or 1 when e == 0; valid for 0 <= e <= 3528
+constexpr int Pow5Bits(int e) {
+  return static_cast<int>((static_cast<std::uint32_t>(e) * 1217359) >> 19) +
+      1;
+}
+// floor(log10(2**e)) for 0 <= e <= 1650
+constexpr int Log10Pow2(int e) {
+  return static_cast<int>((static_cast<std::uint32_t>(e) * 78913) >> 18);
+}
+// floor(log10(5**e)) for 0 <= e <= 2620
+constexpr int Log10Pow5(int e) {
+  return static_cast<int>((static_cast<std::uint32_t>(e) * 732923) >> 20);
+}
+
+constexpr int Pow5Factor(std::uint64_t x) {
+  int count{0};
+  for (; x % 5 == 0; x /= 5) {
+    ++count;
+  }
+  return count;
+}
+constexpr bool IsMultipleOfPowerOf5(std::uint64_t x, int p) {
+  return Pow5Factor(x) >= p;
+}
+constexpr bool IsMultipleOfPowerOf2(std::uint64_t x, int p) {
+  return (x & ((std::uint64_t{1} << p) - 1)) == 0;
+}
+
+// Returns (m * mul) >> j for a 128-bit mul and j >= 64; m has at most 55
+// significant bits.
+inline std::uint64_t MulShift(
+    std::uint64_t m, const std::uint64_t mul[2], int j) {
+  using common::uint128_t;
+  uint128_t low{uint128_t{m} * uint128_t{mul[0]}};
+  uint128_t high{uint128_t{m} * uint128_t{mul[1]}};
+  return static_cast<std::uint64_t>(((low >> 64) + high) >> (j - 64));
+}
+
+// The sign of x is ignored; x must be finite and nonzero.
+template <int PREC>
+ShortestDecimal FindShortestDecimal(BinaryFloatingPointNumber<PREC> x) {
+  static_assert(PREC == 24 || PREC == 53);
+  using Binary = BinaryFloatingPointNumber<PREC>;
+  constexpr int significandBits{Binary::significandBits};
+  constexpr int exponentBias{Binary::exponentBias};
+
+  // Step 1: x = m2 * 2**e2, with two extra bits in m2 for the bounds of
+  // the rounding interval of x.
+  std::uint64_t significand{x.Significand()};
+  int biasedExponent{x.BiasedExponent()};
+  std::uint64_t m2{x.Fraction()};
+  int e2{biasedExponent == 0 ? 1 - exponentBias - significandBits - 2
+                             : biasedExponent - exponentBias - significandBits -
+              2};
+  // Values that round to x are accepted at both ends of its interval when
+  // the significand of x is even.
+  bool acceptBounds{(m2 & 1) == 0};
+
+  // Step 2: the interval of values that round to x is [mm,mp] * 2**e2,
+  // which is asymmetric when x is a power of two.
+  std::uint64_t mv{4 * m2};
+  int mmShift{significand != 0 || biasedExponent <= 1 ? 1 : 0};
+  std::uint64_t mp{mv + 2}, mm{mv - 1 - mmShift};
+
+  // Step 3: scale the interval by a power of ten, so that its bounds are
+  // vm, vr, vp * 10**e10.
+  std::uint64_t vr, vp, vm;
+  int e10;
+  bool vmIsTrailingZeroes{false}, vrIsTrailingZeroes{false};
+  if (e2 >= 0) {
+    int q{Log10Pow2(e2) - (e2 > 3)};
+    e10 = q;
+    int k{pow5InverseBits + Pow5Bits(q) - 1};
+    int i{-e2 + q + k};
+    vr = MulShift(mv, pow5InverseSplit[q], i);
+    vp = MulShift(mp, pow5InverseSplit[q], i);
+    vm = MulShift(mm, pow5InverseSplit[q], i);
+    if (q <= 21) {
+      // Only one of mp, mv, and mm can be a multiple of 5, if any.
+      if (mv % 5 == 0) {
+        vrIsTrailingZeroes = IsMultipleOfPowerOf5(mv, q);
+      } else if (acceptBounds) {
+        vmIsTrailingZeroes = IsMultipleOfPowerOf5(mm, q);
+      } else {
+        vp -= IsMultipleOfPowerOf5(mp, q);
+      }
+    }
+  } else {
+    int q{Log10Pow5(-e2) - (-e2 > 1)};
+    e10 = q + e2;
+    int i{-e2 - q};
+    int k{Pow5Bits(i) - pow5Bits};
+    int j{q - k};
+    vr = MulShift(mv, pow5Split[i], j);
+    vp = MulShift(mp, pow5Split[i], j);
+    vm = MulShift(mm, pow5Split[i], j);
+    if (q <= 1) {
+      // mv has at least two trailing zero bits, mp at least one, and mm
+      // has one when mmShift is 1.
+      vrIsTrailingZeroes = true;
+      if (acceptBounds) {
+        vmIsTrailingZeroes = mmShift == 1;
+      } else {
+        --vp;
+      }
+    } else if (q < 63) {
+      vrIsTrailingZeroes = IsMultipleOfPowerOf2(mv, q - 1);
+    }
+  }
+
+  // Step 4: remove the digits that are not needed to distinguish the
+  // interval, rounding vr to nearest.
+  int removed{0};
+  std::uint64_t result;
+  if (vmIsTrailingZeroes || vrIsTrailingZeroes) {
+    // The bounds or the value may be exact in decimal (rare)
+    int lastRemovedDigit{0};
+    for (; vp / 10 > vm / 10; ++removed) {
+      vmIsTrailingZeroes &= vm % 10 == 0;
+      vrIsTrailingZeroes &= lastRemovedDigit == 0;
+      lastRemovedDigit = static_cast<int>(vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+    }
+    if (vmIsTrailingZeroes) {
+      for (; vm % 10 == 0; ++removed) {
+        vrIsTrailingZeroes &= lastRemovedDigit == 0;
+        lastRemovedDigit = static_cast<int>(vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+      }
+    }
+    if (vrIsTrailingZeroes && lastRemovedDigit == 5 && vr % 2 == 0) {
+      lastRemovedDigit = 4; // exactly halfway: round to even
+    }
+    result = vr +
+        ((vr == vm && (!acceptBounds || !vmIsTrailingZeroes)) ||
+            lastRemovedDigit >= 5);
+  } else {
+    bool roundUp{false};
+    if (vp / 100 > vm / 100) { // two digits at a time
+      roundUp = vr % 100 >= 50;
+      vr /= 100;
+      vp /= 100;
+      vm /= 100;
+      removed += 2;
+    }
+    for (; vp / 10 > vm / 10; ++removed) {
+      roundUp = vr % 10 >= 5;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+    }
+    result = vr + (vr == vm || roundUp);
+  }
+  return {result, e10 + removed};
+}
+
+} // namespace Fortran::decimal
+#endif // FORTRAN_DECIMAL_SHORTEST_DECIMAL_H_
@@ -15,6 +15,7 @@
 #include "flang/Optimizer/Transforms/Passes.h"
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/Support/Debug.h"
 
@@ -56,6 +57,20 @@ namespace {
 ///
 /// If none of the array values overlap in storage and the accesses are not
 /// loop-carried, then the arrays are conflict-free and no copies are required.
+///
+/// Two refinements avoid copies in common cases of the first kind, such as
+/// `a = a + 1` or `a(1:n:2) = a(2:n:2)`, where lowering loads the same array
+/// more than once.
+///
+/// 1'. An array value a_i loaded from array_j with an equivalent shape and
+/// slice as a_j, and only fetched at the very indices at which a_j is updated,
+/// does not conflict: each element is read before it is updated.
+///
+/// 1''. An array value a_i loaded from array_j with a slice that is disjoint
+/// from the slice of a_j does not conflict.
+///
+/// Index values are compared by structural equivalence rather than identity,
+/// since lowering computes the indices of each array reference separately.
 class ArrayCopyAnalysis {
 public:
   using ConflictSetT = llvm::SmallPtrSet<mlir::Operation *, 16>;
@@ -83,6 +98,10 @@ public:
   /// by the array load operation, `load`.
   const llvm::SmallVector<mlir::Operation *> &arrayAccesses(ArrayLoadOp load);
 
+  /// Return the number of array_merge_stores that would have required a copy
+  /// without the refinements of the analysis.
+  unsigned getNumEliminatedCopies() const { return numEliminatedCopies; }
+
 private:
   void construct(mlir::Operation *topLevelOp);
 
@@ -90,6 +109,7 @@ private:
   ConflictSetT conflicts;     // set of conflicts (loads and merge stores)
   OperationUseMapT useMap;
   LoadMapSetsT loadMapSets;
+  unsigned numEliminatedCopies = 0;
 };
 } // namespace
 
@@ -104,7 +124,6 @@ private:
       : reach{reach}, loopRegion{loopRegion} {}
 
   void collectArrayAccessFrom(mlir::Operation *op, mlir::ValueRange range) {
-    llvm::errs() << "COLLECT " << *op << "\n";
     if (range.empty()) {
       collectArrayAccessFrom(op, mlir::Value{});
       return;
@@ -119,7 +138,6 @@ private:
     // `val` is defined by an Op, process the defining Op.
     // If `val` is defined by a region containing Op, we want to drill down
     // and through that Op's region(s).
-    llvm::errs() << "COLLECT " << *op << "\n";
     LLVM_DEBUG(llvm::dbgs() << "popset: " << *op << '\n');
     auto popFn = [&](auto rop) {
       assert(val && "op must have a result value");
@@ -347,14 +365,196 @@ ArrayCopyAnalysis::arrayAccesses(ArrayLoadOp load) {
   return loadMapSets.insert({load, accesses}).first->getSecond();
 }
 
+/// Are `v1` and `v2` the same value, or computed by equivalent operations
+/// without side effects from equivalent values?
+static bool areEquivalentValues(mlir::Value v1, mlir::Value v2,
+                                unsigned depth = 0) {
+  if (v1 == v2)
+    return true;
+  if (!v1 || !v2)
+    return false;
+  constexpr unsigned maxDepth = 8;
+  auto r1 = v1.dyn_cast<mlir::OpResult>();
+  auto r2 = v2.dyn_cast<mlir::OpResult>();
+  if (!r1 || !r2 || depth >= maxDepth ||
+      r1.getResultNumber() != r2.getResultNumber())
+    return false;
+  mlir::Operation *op1 = r1.getOwner();
+  mlir::Operation *op2 = r2.getOwner();
+  if (op1->getNumRegions() != 0 ||
+      !mlir::MemoryEffectOpInterface::hasNoEffect(op1))
+    return false;
+  return mlir::OperationEquivalence::isEquivalentTo(
+      op1, op2,
+      [&](mlir::Value x, mlir::Value y) {
+        return mlir::success(areEquivalentValues(x, y, depth + 1));
+      },
+      mlir::OperationEquivalence::ignoreValueEquivalence,
+      mlir::OperationEquivalence::IgnoreLocations);
+}
+
+static bool areEquivalentValues(mlir::ValueRange r1, mlir::ValueRange r2) {
+  return r1.size() == r2.size() &&
+         llvm::all_of(llvm::zip(r1, r2), [](auto pair) {
+           return areEquivalentValues(std::get<0>(pair), std::get<1>(pair));
+         });
+}
+
+/// Return the indices of an array_fetch, array_update, or array_modify.
+static mlir::OperandRange getAccessIndices(mlir::Operation *op) {
+  if (auto u = mlir::dyn_cast<ArrayUpdateOp>(op))
+    return u.getIndices();
+  if (auto m = mlir::dyn_cast<ArrayModifyOp>(op))
+    return m.getIndices();
+  return mlir::cast<ArrayFetchOp>(op).getIndices();
+}
+
+/// Do two accesses use equivalent indices, with the same interpretation?
+static bool haveEquivalentIndices(mlir::Operation *op1, mlir::Operation *op2) {
+  auto offsets = fir::factory::attrFortranArrayOffsets();
+  return op1->hasAttr(offsets) == op2->hasAttr(offsets) &&
+         areEquivalentValues(getAccessIndices(op1), getAccessIndices(op2));
+}
+
+/// Decompose an integer value into `base + offset`, where `offset` is a
+/// constant and `base` is null when the value is a constant.
+static std::pair<mlir::Value, int64_t> decomposeOffset(mlir::Value v) {
+  int64_t offset = 0;
+  while (true) {
+    if (auto cvt = v.getDefiningOp<fir::ConvertOp>()) {
+      if (!cvt.getValue().getType().isIntOrIndex())
+        break;
+      v = cvt.getValue();
+    } else if (auto cst = v.getDefiningOp<mlir::arith::ConstantOp>()) {
+      if (auto attr = cst.getValue().dyn_cast<mlir::IntegerAttr>())
+        return {mlir::Value{}, offset + attr.getValue().getSExtValue()};
+      break;
+    } else if (auto add = v.getDefiningOp<mlir::arith::AddIOp>()) {
+      auto [base, c] = decomposeOffset(add.getRhs());
+      if (base)
+        break;
+      offset += c;
+      v = add.getLhs();
+    } else if (auto sub = v.getDefiningOp<mlir::arith::SubIOp>()) {
+      auto [base, c] = decomposeOffset(sub.getRhs());
+      if (base)
+        break;
+      offset -= c;
+      v = sub.getLhs();
+    } else {
+      break;
+    }
+  }
+  return {v, offset};
+}
+
+/// Return `v2 - v1` if it is a known constant.
+static llvm::Optional<int64_t> getConstantDifference(mlir::Value v1,
+                                                     mlir::Value v2) {
+  auto [base1, offset1] = decomposeOffset(v1);
+  auto [base2, offset2] = decomposeOffset(v2);
+  if (base1 != base2 && !(base1 && base2 && areEquivalentValues(base1, base2)))
+    return llvm::None;
+  return offset2 - offset1;
+}
+
+/// Are the elements selected by the slices of two array_loads of the same
+/// array provably disjoint? It suffices that the triples of one dimension
+/// select disjoint ranges, or interleaved elements with the same stride.
+static bool areDisjointSlices(ArrayLoadOp ld1, ArrayLoadOp ld2) {
+  auto slice1 = mlir::dyn_cast_or_null<SliceOp>(
+      ld1.getSlice() ? ld1.getSlice().getDefiningOp() : nullptr);
+  auto slice2 = mlir::dyn_cast_or_null<SliceOp>(
+      ld2.getSlice() ? ld2.getSlice().getDefiningOp() : nullptr);
+  if (!slice1 || !slice2 || !slice1.getFields().empty() ||
+      !slice2.getFields().empty() || !slice1.getSubstr().empty() ||
+      !slice2.getSubstr().empty() ||
+      slice1.getTriples().size() != slice2.getTriples().size() ||
+      !areEquivalentValues(ld1.getShape(), ld2.getShape()))
+    return false;
+  auto triples1 = slice1.getTriples();
+  auto triples2 = slice2.getTriples();
+  for (unsigned i = 0, e = triples1.size(); i < e; i += 3) {
+    // A scalar subscript has an undefined upper bound and stride.
+    auto isScalar = [](mlir::Value ub) {
+      return mlir::isa_and_nonnull<fir::UndefOp>(ub.getDefiningOp());
+    };
+    bool isScalar1 = isScalar(triples1[i + 1]);
+    bool isScalar2 = isScalar(triples2[i + 1]);
+    auto getStride = [&](mlir::ValueRange triples, bool isScalar) {
+      return isScalar ? llvm::Optional<int64_t>{1}
+                      : getConstantDifference({}, triples[i + 2]);
+    };
+    llvm::Optional<int64_t> stride1 = getStride(triples1, isScalar1);
+    llvm::Optional<int64_t> stride2 = getStride(triples2, isScalar2);
+    if (!stride1 || !stride2 || *stride1 <= 0 || *stride2 <= 0)
+      continue;
+    mlir::Value ub1 = isScalar1 ? triples1[i] : triples1[i + 1];
+    mlir::Value ub2 = isScalar2 ? triples2[i] : triples2[i + 1];
+    // ld1 ends before ld2 begins, or ld2 ends before ld1 begins
+    llvm::Optional<int64_t> gap12 = getConstantDifference(ub1, triples2[i]);
+    llvm::Optional<int64_t> gap21 = getConstantDifference(ub2, triples1[i]);
+    if ((gap12 && *gap12 > 0) || (gap21 && *gap21 > 0))
+      return true;
+    // Both select every stride-th element, from different residues
+    llvm::Optional<int64_t> start =
+        getConstantDifference(triples1[i], triples2[i]);
+    if (!isScalar1 && !isScalar2 && *stride1 == *stride2 && start &&
+        *start % *stride1 != 0)
+      return true;
+  }
+  return false;
+}
+
+using ArrayAccessesFn =
+    llvm::function_ref<const llvm::SmallVector<mlir::Operation *> &(
+        ArrayLoadOp)>;
+
+/// Can the array value loaded by `ld` from the same array as the destination
+/// of `st` be used without a copy? The updates of the destination are
+/// `updates`. This covers refinements 1' and 1'' of the analysis.
+static bool isSafeReload(ArrayLoadOp ld, ArrayMergeStoreOp st,
+                         llvm::ArrayRef<mlir::Operation *> updates,
+                         ArrayAccessesFn arrayAccesses) {
+  auto dest = st.getOriginal().getDefiningOp<ArrayLoadOp>();
+  if (!dest)
+    return false;
+  if (areDisjointSlices(ld, dest)) {
+    LLVM_DEBUG(llvm::dbgs() << "disjoint slices: " << ld << '\n');
+    return true;
+  }
+  if (!areEquivalentValues(ld.getShape(), dest.getShape()) ||
+      !areEquivalentValues(ld.getSlice(), dest.getSlice()) ||
+      !areEquivalentValues(ld.getTypeparams(), dest.getTypeparams()) ||
+      updates.empty())
+    return false;
+  for (mlir::Operation *access : arrayAccesses(ld)) {
+    if (!mlir::isa<ArrayFetchOp>(access))
+      return false;
+    for (mlir::Operation *update : updates)
+      if (!haveEquivalentIndices(access, update))
+        return false;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "fetched only where updated: " << ld << '\n');
+  return true;
+}
+
 /// Is there a conflict between the array value that was updated and to be
 /// stored to `st` and the set of arrays loaded (`reach`) and used to compute
-/// the updated value?
+/// the updated value? `accesses` are the accesses to the destination array
+/// value. `refined` is set when a conflict was avoided by the refinements of
+/// the analysis.
 static bool conflictOnLoad(llvm::ArrayRef<mlir::Operation *> reach,
-                           ArrayMergeStoreOp st) {
+                           ArrayMergeStoreOp st,
+                           llvm::ArrayRef<mlir::Operation *> accesses,
+                           ArrayAccessesFn arrayAccesses, bool &refined) {
   mlir::Value load;
   mlir::Value addr = st.getMemref();
   auto stEleTy = fir::dyn_cast_ptrOrBoxEleTy(addr.getType());
+  llvm::SmallVector<mlir::Operation *> updates;
+  for (auto *acc : accesses)
+    if (mlir::isa<ArrayUpdateOp, ArrayModifyOp>(acc))
+      updates.push_back(acc);
   for (auto *op : reach) {
     auto ld = mlir::dyn_cast<ArrayLoadOp>(op);
     if (!ld)
@@ -365,8 +565,12 @@ static bool conflictOnLoad(llvm::ArrayRef<mlir::Operation *> reach,
     if (ldTy.isa<fir::PointerType>() && stEleTy == dyn_cast_ptrEleTy(ldTy))
       return true;
     if (ld.getMemref() == addr) {
-      if (ld.getResult() != st.getOriginal())
-        return true;
+      if (ld.getResult() != st.getOriginal()) {
+        if (!isSafeReload(ld, st, updates, arrayAccesses))
+          return true;
+        refined = true;
+        continue;
+      }
       if (load)
         return true;
       load = ld;
@@ -379,37 +583,20 @@ static bool conflictOnLoad(llvm::ArrayRef<mlir::Operation *> reach,
 /// (ArrayFetchOp, ArrayUpdateOp, ArrayModifyOp) while merging back to the
 /// array. A potential conflict is detected if two operations work on the same
 /// indices.
-static bool conflictOnMerge(llvm::ArrayRef<mlir::Operation *> accesses) {
+static bool conflictOnMerge(llvm::ArrayRef<mlir::Operation *> accesses,
+                            bool &refined) {
   if (accesses.size() < 2)
     return false;
-  llvm::SmallVector<mlir::Value> indices;
   LLVM_DEBUG(llvm::dbgs() << "check merge conflict on with " << accesses.size()
                           << " accesses on the list\n");
-  for (auto *op : accesses) {
+  mlir::Operation *first = accesses.front();
+  for (auto *op : accesses.drop_front()) {
     assert((mlir::isa<ArrayFetchOp, ArrayUpdateOp, ArrayModifyOp>(op)) &&
            "unexpected operation in analysis");
-    llvm::SmallVector<mlir::Value> compareVector;
-    if (auto u = mlir::dyn_cast<ArrayUpdateOp>(op)) {
-      if (indices.empty()) {
-        indices = u.getIndices();
-        continue;
-      }
-      compareVector = u.getIndices();
-    } else if (auto f = mlir::dyn_cast<ArrayModifyOp>(op)) {
-      if (indices.empty()) {
-        indices = f.getIndices();
-        continue;
-      }
-      compareVector = f.getIndices();
-    } else if (auto f = mlir::dyn_cast<ArrayFetchOp>(op)) {
-      if (indices.empty()) {
-        indices = f.getIndices();
-        continue;
-      }
-      compareVector = f.getIndices();
-    }
-    if (compareVector != indices)
+    if (!haveEquivalentIndices(first, op))
       return true;
+    if (!llvm::equal(getAccessIndices(first), getAccessIndices(op)))
+      refined = true;
     LLVM_DEBUG(llvm::dbgs() << "vectors compare equal\n");
   }
   return false;
@@ -418,8 +605,10 @@ static bool conflictOnMerge(llvm::ArrayRef<mlir::Operation *> accesses) {
 // Are either of types of conflicts present?
 inline bool conflictDetected(llvm::ArrayRef<mlir::Operation *> reach,
                              llvm::ArrayRef<mlir::Operation *> accesses,
-                             ArrayMergeStoreOp st) {
-  return conflictOnLoad(reach, st) || conflictOnMerge(accesses);
+                             ArrayMergeStoreOp st,
+                             ArrayAccessesFn arrayAccesses, bool &refined) {
+  return conflictOnLoad(reach, st, accesses, arrayAccesses, refined) ||
+         conflictOnMerge(accesses, refined);
 }
 
 /// Constructor of the array copy analysis.
@@ -431,13 +620,21 @@ void ArrayCopyAnalysis::construct(mlir::Operation *topLevelOp) {
       ReachCollector::reachingValues(values, st.getSequence());
       const llvm::SmallVector<Operation *> &accesses = arrayAccesses(
           mlir::cast<ArrayLoadOp>(st.getOriginal().getDefiningOp()));
-      if (conflictDetected(values, accesses, st)) {
+      bool refined = false;
+      auto getAccesses =
+          [&](ArrayLoadOp load) -> const llvm::SmallVector<Operation *> & {
+        return arrayAccesses(load);
+      };
+      if (conflictDetected(values, accesses, st, getAccesses, refined)) {
         LLVM_DEBUG(llvm::dbgs()
                    << "CONFLICT: copies required for " << st << '\n'
                    << "   adding conflicts on: " << op << " and "
                    << st.getOriginal() << '\n');
         conflicts.insert(op);
         conflicts.insert(st.getOriginal().getDefiningOp());
+      } else if (refined) {
+        LLVM_DEBUG(llvm::dbgs() << "no copy required for " << st << '\n');
+        ++numEliminatedCopies;
       }
       auto *ld = st.getOriginal().getDefiningOp();
       LLVM_DEBUG(llvm::dbgs()
@@ -780,6 +977,14 @@ public:
     // Perform the conflict analysis.
     auto &analysis = getAnalysis<ArrayCopyAnalysis>();
     const auto &useMap = analysis.getUseMap();
+    if (unsigned eliminated = analysis.getNumEliminatedCopies()) {
+      numEliminatedCopies += eliminated;
+      if (emitRemarks)
+        mlir::emitRemark(func.getLoc())
+            << "array-value-copy: " << eliminated
+            << " array temporar" << (eliminated == 1 ? "y" : "ies")
+            << " avoided by conflict analysis refinements";
+    }
 
     // Phase 1 is performing a rewrite on the array accesses. Once all the
     // array accesses are rewritten we can go on phase 2.
@@ -0,0 +1,315 @@
+//===- LoopFusion.cpp - Fuse adjacent elemental loop nests ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Consecutive array assignments such as
+//
+//   b = a + 1.0
+//   c = b * 2.0
+//
+// are lowered to consecutive `fir.do_loop` nests over the same iteration
+// space. Once array-value-copy has rewritten the array value operations to
+// memory accesses, this pass fuses such nests when every element used by the
+// second nest is computed by the same iteration of the first one, so that the
+// intermediate values are reused while they are still in registers or cache.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+#include "flang/Optimizer/Dialect/FIRDialect.h"
+#include "flang/Optimizer/Dialect/FIROps.h"
+#include "flang/Optimizer/Dialect/FIROpsSupport.h"
+#include "flang/Optimizer/Dialect/FIRType.h"
+#include "flang/Optimizer/Transforms/Passes.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "flang-loop-fusion"
+
+namespace {
+
+/// A load or a store in the innermost loop of a nest.
+struct MemoryAccess {
+  mlir::Operation *op;
+  mlir::Value address;
+  bool isWrite;
+};
+
+/// A perfect nest of unordered loops, outermost first.
+struct LoopNest {
+  llvm::SmallVector<fir::DoLoopOp> loops;
+  llvm::SmallVector<MemoryAccess> accesses;
+
+  fir::DoLoopOp outermost() const { return loops.front(); }
+  fir::DoLoopOp innermost() const { return loops.back(); }
+};
+
+/// Values of the second nest that are replaced by values of the first nest
+/// when the nests are fused (the induction variables).
+using ValueMap = llvm::DenseMap<mlir::Value, mlir::Value>;
+
+/// Is the value `v2` of the second nest equivalent to the value `v1` of the
+/// first one, once the values of `map` are replaced?
+static bool areEquivalentValues(mlir::Value v1, mlir::Value v2,
+                                const ValueMap &map, unsigned depth = 0) {
+  if (v1 == v2 || (v2 && map.lookup(v2) == v1))
+    return true;
+  if (!v1 || !v2)
+    return false;
+  constexpr unsigned maxDepth = 8;
+  auto r1 = v1.dyn_cast<mlir::OpResult>();
+  auto r2 = v2.dyn_cast<mlir::OpResult>();
+  if (!r1 || !r2 || depth >= maxDepth ||
+      r1.getResultNumber() != r2.getResultNumber())
+    return false;
+  mlir::Operation *op1 = r1.getOwner();
+  mlir::Operation *op2 = r2.getOwner();
+  if (op1->getNumRegions() != 0 ||
+      !mlir::MemoryEffectOpInterface::hasNoEffect(op1))
+    return false;
+  return mlir::OperationEquivalence::isEquivalentTo(
+      op1, op2,
+      [&](mlir::Value x, mlir::Value y) {
+        return mlir::success(areEquivalentValues(x, y, map, depth + 1));
+      },
+      mlir::OperationEquivalence::ignoreValueEquivalence,
+      mlir::OperationEquivalence::IgnoreLocations);
+}
+
+/// Collect the perfect nest of unordered loops rooted at `loop`, and the
+/// memory accesses of its innermost body. Return false if the nest does not
+/// have the simple form of a lowered array assignment: the body of each outer
+/// loop is only the next loop, and the innermost body only has operations
+/// without side effects and loads and stores.
+static bool collectLoopNest(fir::DoLoopOp loop, LoopNest &nest) {
+  while (true) {
+    if (!loop.getUnordered() || loop.getFinalValue())
+      return false;
+    nest.loops.push_back(loop);
+    mlir::Block *body = loop.getBody();
+    if (body->getOperations().size() != 2)
+      break;
+    auto inner = mlir::dyn_cast<fir::DoLoopOp>(body->front());
+    if (!inner)
+      break;
+    loop = inner;
+  }
+  for (mlir::Operation &op : nest.innermost().getBody()->without_terminator()) {
+    if (auto load = mlir::dyn_cast<fir::LoadOp>(op)) {
+      nest.accesses.push_back({&op, load.getMemref(), /*isWrite=*/false});
+    } else if (auto store = mlir::dyn_cast<fir::StoreOp>(op)) {
+      nest.accesses.push_back({&op, store.getMemref(), /*isWrite=*/true});
+    } else if (op.getNumRegions() != 0 ||
+               !mlir::MemoryEffectOpInterface::hasNoEffect(&op)) {
+      LLVM_DEBUG(llvm::dbgs() << "not fusible: " << op << '\n');
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Return the entity whose storage is accessed through `address`, looking
+/// through conversions and descriptors. `isPointer` is set if the storage may
+/// be associated with a POINTER or TARGET.
+static mlir::Value getStorageRoot(mlir::Value address, bool &isPointer) {
+  while (true) {
+    mlir::Type ty = address.getType();
+    if (auto boxTy = ty.dyn_cast<fir::BoxType>())
+      ty = boxTy.getEleTy();
+    if (ty.isa<fir::PointerType>())
+      isPointer = true;
+    if (fir::valueHasFirAttribute(address, fir::getTargetAttrName()))
+      isPointer = true;
+    mlir::Operation *def = address.getDefiningOp();
+    if (!def)
+      return address;
+    if (auto coor = mlir::dyn_cast<fir::ArrayCoorOp>(def))
+      address = coor.getMemref();
+    else if (auto convert = mlir::dyn_cast<fir::ConvertOp>(def))
+      address = convert.getValue();
+    else if (auto boxAddr = mlir::dyn_cast<fir::BoxAddrOp>(def))
+      address = boxAddr.getVal();
+    else if (auto embox = mlir::dyn_cast<fir::EmboxOp>(def))
+      address = embox.getMemref();
+    else if (auto rebox = mlir::dyn_cast<fir::ReboxOp>(def))
+      address = rebox.getBox();
+    else
+      return address;
+  }
+}
+
+/// May the storage accessed through `a1` and `a2` overlap? Distinct variables
+/// do not overlap, as Fortran requires of dummy arguments that are defined,
+/// unless POINTER or TARGET entities are involved.
+static bool mayAlias(mlir::Value a1, mlir::Value a2) {
+  bool isPointer = false;
+  mlir::Value r1 = getStorageRoot(a1, isPointer);
+  mlir::Value r2 = getStorageRoot(a2, isPointer);
+  if (r1 == r2 || isPointer)
+    return true;
+  auto isLocal = [](mlir::Value v) {
+    return mlir::isa_and_nonnull<fir::AllocaOp, fir::AllocMemOp>(
+        v.getDefiningOp());
+  };
+  auto isDummy = [](mlir::Value v) { return v.isa<mlir::BlockArgument>(); };
+  auto addr1 = r1.getDefiningOp<fir::AddrOfOp>();
+  auto addr2 = r2.getDefiningOp<fir::AddrOfOp>();
+  if (addr1 && addr2)
+    return addr1.getSymbol() == addr2.getSymbol();
+  auto load1 = r1.getDefiningOp<fir::LoadOp>();
+  auto load2 = r2.getDefiningOp<fir::LoadOp>();
+  // The data of allocatables held in distinct descriptors is distinct.
+  if (load1 && load2)
+    return mayAlias(load1.getMemref(), load2.getMemref());
+  if ((isLocal(r1) || isDummy(r1) || addr1) &&
+      (isLocal(r2) || isDummy(r2) || addr2))
+    return false;
+  // The address of a heap allocation may have been stored in a descriptor.
+  if ((load1 && r2.getDefiningOp<fir::AllocaOp>()) ||
+      (load2 && r1.getDefiningOp<fir::AllocaOp>()))
+    return false;
+  return true;
+}
+
+/// Does `index` vary like the induction variable `iv`, that is, is it `iv`
+/// plus a constant, maybe converted to another integer type?
+static bool isInductionIndex(mlir::Value index, mlir::Value iv) {
+  while (index != iv) {
+    mlir::Operation *def = index.getDefiningOp();
+    if (auto convert = mlir::dyn_cast_or_null<fir::ConvertOp>(def)) {
+      index = convert.getValue();
+    } else if (mlir::isa_and_nonnull<mlir::arith::AddIOp, mlir::arith::SubIOp>(
+                   def)) {
+      if (!def->getOperand(1).getDefiningOp<mlir::arith::ConstantOp>())
+        return false;
+      index = def->getOperand(0);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Do the accesses `x` of the first nest and `y` of the second nest access
+/// the same element in the same iteration, and distinct elements in distinct
+/// iterations?
+static bool isSameIterationAccess(const MemoryAccess &x, const MemoryAccess &y,
+                                  const LoopNest &first, const ValueMap &map) {
+  auto coor1 = x.address.getDefiningOp<fir::ArrayCoorOp>();
+  auto coor2 = y.address.getDefiningOp<fir::ArrayCoorOp>();
+  if (!coor1 || !coor2 || !areEquivalentValues(x.address, y.address, map))
+    return false;
+  // Each induction variable must determine one of the indices.
+  for (fir::DoLoopOp loop : first.loops)
+    if (llvm::none_of(coor1.getIndices(), [&](mlir::Value index) {
+          return isInductionIndex(index, loop.getInductionVar());
+        }))
+      return false;
+  return true;
+}
+
+/// Fuse the nest `second` into the nest `first` that precedes it in the same
+/// block, if that preserves the order of the accesses to every element.
+static bool tryFuse(LoopNest &first, LoopNest &second) {
+  if (first.loops.size() != second.loops.size() ||
+      !second.outermost()->use_empty())
+    return false;
+  ValueMap map;
+  for (auto [loop1, loop2] : llvm::zip(first.loops, second.loops)) {
+    if (!areEquivalentValues(loop1.getLowerBound(), loop2.getLowerBound(),
+                             map) ||
+        !areEquivalentValues(loop1.getUpperBound(), loop2.getUpperBound(),
+                             map) ||
+        !areEquivalentValues(loop1.getStep(), loop2.getStep(), map))
+      return false;
+    map[loop2.getInductionVar()] = loop1.getInductionVar();
+  }
+
+  // The operations between the nests must be movable before the first nest.
+  mlir::Operation *firstOp = first.outermost();
+  for (mlir::Operation *op = firstOp->getNextNode();
+       op != second.outermost().getOperation(); op = op->getNextNode())
+    if (op->getNumRegions() != 0 ||
+        !mlir::MemoryEffectOpInterface::hasNoEffect(op) ||
+        llvm::any_of(op->getOperands(), [&](mlir::Value v) {
+          return v.getDefiningOp() == firstOp;
+        }))
+      return false;
+
+  // The moved operations may only use the induction variables of the second
+  // nest, not its loop-carried values.
+  mlir::Block *secondBody = second.innermost().getBody();
+  for (mlir::Operation &op : secondBody->without_terminator())
+    for (mlir::Value operand : op.getOperands())
+      if (auto arg = operand.dyn_cast<mlir::BlockArgument>())
+        if (!map.count(arg) &&
+            llvm::any_of(second.loops, [&](fir::DoLoopOp loop) {
+              return arg.getOwner() == loop.getBody();
+            }))
+          return false;
+
+  for (const MemoryAccess &x : first.accesses)
+    for (const MemoryAccess &y : second.accesses)
+      if ((x.isWrite || y.isWrite) && mayAlias(x.address, y.address) &&
+          !isSameIterationAccess(x, y, first, map)) {
+        LLVM_DEBUG(llvm::dbgs() << "fusion prevented by " << *x.op << " and "
+                                << *y.op << '\n');
+        return false;
+      }
+
+  while (firstOp->getNextNode() != second.outermost().getOperation())
+    firstOp->getNextNode()->moveBefore(firstOp);
+  for (auto entry : map)
+    entry.first.replaceAllUsesWith(entry.second);
+  mlir::Block *firstBody = first.innermost().getBody();
+  firstBody->getOperations().splice(std::prev(firstBody->end()),
+                                    secondBody->getOperations(),
+                                    secondBody->begin(),
+                                    std::prev(secondBody->end()));
+  first.accesses.append(second.accesses);
+  second.outermost().erase();
+  return true;
+}
+
+class LoopFusion : public fir::LoopFusionBase<LoopFusion> {
+public:
+  void runOnOperation() override {
+    llvm::SmallVector<mlir::Block *> blocks;
+    getOperation()->walk([&](mlir::Block *block) { blocks.push_back(block); });
+    for (mlir::Block *block : blocks) {
+      llvm::Optional<LoopNest> current;
+      for (mlir::Operation &op : llvm::make_early_inc_range(*block)) {
+        auto loop = mlir::dyn_cast<fir::DoLoopOp>(op);
+        if (!loop)
+          continue;
+        LoopNest nest;
+        if (!collectLoopNest(loop, nest)) {
+          current.reset();
+          continue;
+        }
+        mlir::Location loc = loop.getLoc();
+        if (current && tryFuse(*current, nest)) {
+          ++numFused;
+          if (emitRemarks)
+            mlir::emitRemark(loc) << "loop nest fused with the loop nest at "
+                                  << current->outermost().getLoc();
+          continue;
+        }
+        current = std::move(nest);
+      }
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<mlir::Pass> fir::createLoopFusionPass() {
+  return std::make_unique<LoopFusion>();
+}
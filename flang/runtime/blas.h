@@ -0,0 +1,82 @@
+//===-- runtime/blas.h ------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Declarations of the reference BLAS routines that can implement some cases
+// of the MATMUL and DOT_PRODUCT intrinsic functions when the runtime is
+// configured with FLANG_RUNTIME_USE_BLAS.  They are declared here with the
+// usual Fortran calling conventions (trailing underscore, all arguments by
+// reference, LP64 integers) so that no CBLAS header is needed.
+//
+// Functions returning COMPLEX values (CDOTC, ZDOTC) are not declared, since
+// the way they return their results depends on the compiler that built the
+// library.
+
+#ifndef FORTRAN_RUNTIME_BLAS_H_
+#define FORTRAN_RUNTIME_BLAS_H_
+
+#include "config.h"
+#include <complex>
+#include <limits>
+
+namespace Fortran::runtime::blas {
+
+// All extents and leading dimensions must be representable as the
+// default INTEGER of the library.
+template <typename... A> inline bool FitsInt(A... xs) {
+  return ((xs >= 0 && xs <= std::numeric_limits<int>::max()) && ...);
+}
+
+} // namespace Fortran::runtime::blas
+
+#if FLANG_RUNTIME_USE_BLAS
+extern "C" {
+void sgemm_(const char *transa, const char *transb, const int *m, const int *n,
+    const int *k, const float *alpha, const float *a, const int *lda,
+    const float *b, const int *ldb, const float *beta, float *c,
+    const int *ldc);
+void dgemm_(const char *transa, const char *transb, const int *m, const int *n,
+    const int *k, const double *alpha, const double *a, const int *lda,
+    const double *b, const int *ldb, const double *beta, double *c,
+    const int *ldc);
+void cgemm_(const char *transa, const char *transb, const int *m, const int *n,
+    const int *k, const std::complex<float> *alpha,
+    const std::complex<float> *a, const int *lda, const std::complex<float> *b,
+    const int *ldb, const std::complex<float> *beta, std::complex<float> *c,
+    const int *ldc);
+void zgemm_(const char *transa, const char *transb, const int *m, const int *n,
+    const int *k, const std::complex<double> *alpha,
+    const std::complex<double> *a, const int *lda,
+    const std::complex<double> *b, const int *ldb,
+    const std::complex<double> *beta, std::complex<double> *c, const int *ldc);
+
+void sgemv_(const char *trans, const int *m, const int *n, const float *alpha,
+    const float *a, const int *lda, const float *x, const int *incx,
+    const float *beta, float *y, const int *incy);
+void dgemv_(const char *trans, const int *m, const int *n, const double *alpha,
+    const double *a, const int *lda, const double *x, const int *incx,
+    const double *beta, double *y, const int *incy);
+void cgemv_(const char *trans, const int *m, const int *n,
+    const std::complex<float> *alpha, const std::complex<float> *a,
+    const int *lda, const std::complex<float> *x, const int *incx,
+    const std::complex<float> *beta, std::complex<float> *y, const int *incy);
+void zgemv_(const char *trans, const int *m, const int *n,
+    const std::complex<double> *alpha, const std::complex<double> *a,
+    const int *lda, const std::complex<double> *x, const int *incx,
+    const std::complex<double> *beta, std::complex<double> *y,
+    const int *incy);
+
+// DSDOT accumulates REAL(4) products in double precision, as DOT_PRODUCT
+// requires; SDOT does not.
+double dsdot_(const int *n, const float *x, const int *incx, const float *y,
+    const int *incy);
+double ddot_(const int *n, const double *x, const int *incx, const double *y,
+    const int *incy);
+} // extern "C"
+#endif // FLANG_RUNTIME_USE_BLAS
+
+#endif // FORTRAN_RUNTIME_BLAS_H_
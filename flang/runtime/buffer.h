@@ -128,6 +128,13 @@ public:
     }
   }
 
+  // Writes any buffered output and discards all buffered data, before the
+  // file is accessed elsewhere than through the buffer.
+  void Discard(IoErrorHandler &handler) {
+    Flush(handler);
+    Reset(fileOffset_);
+  }
+
 private:
   STORE &Store() { return static_cast<STORE &>(*this); }
 
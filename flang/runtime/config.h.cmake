@@ -8,4 +8,7 @@
    don't. */
 #cmakedefine01 HAVE_DECL_STRERROR_S
 
+/* Define to 1 to implement some cases of MATMUL and DOT_PRODUCT with BLAS. */
+#cmakedefine01 FLANG_RUNTIME_USE_BLAS
+
 #endif
@@ -36,6 +36,43 @@ inline A &ExtractElement(IoStatementState &io, const Descriptor &descriptor,
   return *p;
 }
 
+// Steps through the elements of an I/O data list item in array element
+// order.  Contiguous items are traversed by address, which avoids the
+// subscript arithmetic for the common case of whole arrays.
+template <typename A> class ElementCursor {
+public:
+  ElementCursor(IoStatementState &io, const Descriptor &descriptor)
+      : io_{io}, descriptor_{descriptor} {
+    descriptor.GetLowerBounds(subscripts_);
+    if (descriptor.IsContiguous() && descriptor.Elements() > 0) {
+      next_ = &ExtractElement<char>(io, descriptor, subscripts_);
+      elementBytes_ = descriptor.ElementBytes();
+    }
+  }
+
+  A &operator*() const {
+    return next_ ? *reinterpret_cast<A *>(next_)
+                 : ExtractElement<A>(io_, descriptor_, subscripts_);
+  }
+
+  // 'what' names the caller in the message of the crash that occurs when
+  // the subscripts run out before the last element.
+  void Advance(bool isLast, const char *what) {
+    if (next_) {
+      next_ += elementBytes_;
+    } else if (!descriptor_.IncrementSubscripts(subscripts_) && !isLast) {
+      io_.GetIoErrorHandler().Crash("%s: subscripts out of bounds", what);
+    }
+  }
+
+private:
+  IoStatementState &io_;
+  const Descriptor &descriptor_;
+  SubscriptValue subscripts_[maxRank];
+  char *next_{nullptr};
+  std::size_t elementBytes_{0};
+};
+
 // Per-category descriptor-based I/O templates
 
 // TODO (perhaps as a nontrivial but small starter project): implement
@@ -46,13 +83,12 @@ template <int KIND, Direction DIR>
 inline bool FormattedIntegerIO(
     IoStatementState &io, const Descriptor &descriptor) {
   std::size_t numElements{descriptor.Elements()};
-  SubscriptValue subscripts[maxRank];
-  descriptor.GetLowerBounds(subscripts);
   using IntType = CppTypeFor<TypeCategory::Integer, KIND>;
+  ElementCursor<IntType> element{io, descriptor};
   bool anyInput{false};
   for (std::size_t j{0}; j < numElements; ++j) {
     if (auto edit{io.GetNextDataEdit()}) {
-      IntType &x{ExtractElement<IntType>(io, descriptor, subscripts)};
+      IntType &x{*element};
       if constexpr (DIR == Direction::Output) {
         if (!EditIntegerOutput<KIND>(io, *edit, x)) {
           return false;
@@ -64,10 +100,7 @@ inline bool FormattedIntegerIO(
           return anyInput && edit->IsNamelist();
         }
       }
-      if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-        io.GetIoErrorHandler().Crash(
-            "FormattedIntegerIO: subscripts out of bounds");
-      }
+      element.Advance(j + 1 == numElements, "FormattedIntegerIO");
     } else {
       return false;
     }
@@ -79,13 +112,12 @@ template <int KIND, Direction DIR>
 inline bool FormattedRealIO(
     IoStatementState &io, const Descriptor &descriptor) {
   std::size_t numElements{descriptor.Elements()};
-  SubscriptValue subscripts[maxRank];
-  descriptor.GetLowerBounds(subscripts);
   using RawType = typename RealOutputEditing<KIND>::BinaryFloatingPoint;
+  ElementCursor<RawType> element{io, descriptor};
   bool anyInput{false};
   for (std::size_t j{0}; j < numElements; ++j) {
     if (auto edit{io.GetNextDataEdit()}) {
-      RawType &x{ExtractElement<RawType>(io, descriptor, subscripts)};
+      RawType &x{*element};
       if constexpr (DIR == Direction::Output) {
         if (!RealOutputEditing<KIND>{io, x}.Edit(*edit)) {
           return false;
@@ -97,10 +129,7 @@ inline bool FormattedRealIO(
           return anyInput && edit->IsNamelist();
         }
       }
-      if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-        io.GetIoErrorHandler().Crash(
-            "FormattedRealIO: subscripts out of bounds");
-      }
+      element.Advance(j + 1 == numElements, "FormattedRealIO");
     } else {
       return false;
     }
@@ -112,14 +141,13 @@ template <int KIND, Direction DIR>
 inline bool FormattedComplexIO(
     IoStatementState &io, const Descriptor &descriptor) {
   std::size_t numElements{descriptor.Elements()};
-  SubscriptValue subscripts[maxRank];
-  descriptor.GetLowerBounds(subscripts);
   bool isListOutput{
       io.get_if<ListDirectedStatementState<Direction::Output>>() != nullptr};
   using RawType = typename RealOutputEditing<KIND>::BinaryFloatingPoint;
+  ElementCursor<RawType> element{io, descriptor};
   bool anyInput{false};
   for (std::size_t j{0}; j < numElements; ++j) {
-    RawType *x{&ExtractElement<RawType>(io, descriptor, subscripts)};
+    RawType *x{&*element};
     if (isListOutput) {
       DataEdit rEdit, iEdit;
       rEdit.descriptor = DataEdit::ListDirectedRealPart;
@@ -148,10 +176,7 @@ inline bool FormattedComplexIO(
         }
       }
     }
-    if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-      io.GetIoErrorHandler().Crash(
-          "FormattedComplexIO: subscripts out of bounds");
-    }
+    element.Advance(j + 1 == numElements, "FormattedComplexIO");
   }
   return true;
 }
@@ -160,13 +185,12 @@ template <typename A, Direction DIR>
 inline bool FormattedCharacterIO(
     IoStatementState &io, const Descriptor &descriptor) {
   std::size_t numElements{descriptor.Elements()};
-  SubscriptValue subscripts[maxRank];
-  descriptor.GetLowerBounds(subscripts);
+  ElementCursor<A> element{io, descriptor};
   std::size_t length{descriptor.ElementBytes() / sizeof(A)};
   auto *listOutput{io.get_if<ListDirectedStatementState<Direction::Output>>()};
   bool anyInput{false};
   for (std::size_t j{0}; j < numElements; ++j) {
-    A *x{&ExtractElement<A>(io, descriptor, subscripts)};
+    A *x{&*element};
     if (listOutput) {
       if (!ListDirectedDefaultCharacterOutput(io, *listOutput, x, length)) {
         return false;
@@ -188,10 +212,7 @@ inline bool FormattedCharacterIO(
     } else {
       return false;
     }
-    if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-      io.GetIoErrorHandler().Crash(
-          "FormattedCharacterIO: subscripts out of bounds");
-    }
+    element.Advance(j + 1 == numElements, "FormattedCharacterIO");
   }
   return true;
 }
@@ -200,13 +221,12 @@ template <int KIND, Direction DIR>
 inline bool FormattedLogicalIO(
     IoStatementState &io, const Descriptor &descriptor) {
   std::size_t numElements{descriptor.Elements()};
-  SubscriptValue subscripts[maxRank];
-  descriptor.GetLowerBounds(subscripts);
   auto *listOutput{io.get_if<ListDirectedStatementState<Direction::Output>>()};
   using IntType = CppTypeFor<TypeCategory::Integer, KIND>;
+  ElementCursor<IntType> element{io, descriptor};
   bool anyInput{false};
   for (std::size_t j{0}; j < numElements; ++j) {
-    IntType &x{ExtractElement<IntType>(io, descriptor, subscripts)};
+    IntType &x{*element};
     if (listOutput) {
       if (!ListDirectedLogicalOutput(io, *listOutput, x != 0)) {
         return false;
@@ -230,10 +250,7 @@ inline bool FormattedLogicalIO(
     } else {
       return false;
     }
-    if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-      io.GetIoErrorHandler().Crash(
-          "FormattedLogicalIO: subscripts out of bounds");
-    }
+    element.Advance(j + 1 == numElements, "FormattedLogicalIO");
   }
   return true;
 }
@@ -6,12 +6,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "blas.h"
 #include "terminator.h"
 #include "tools.h"
+#include "flang/Runtime/c-or-cpp.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
 #include "flang/Runtime/reduction.h"
 #include <cinttypes>
+#include <optional>
 
 namespace Fortran::runtime {
 
@@ -47,6 +50,54 @@ private:
   Result sum_{};
 };
 
+// Contiguous numeric vectors: the sum is split into several partial sums
+// that are accumulated independently, so that the loop is not limited by the
+// latency of the additions and can be vectorized.
+template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
+static inline AccumulationType<RCAT, RKIND> ContiguousDotProduct(
+    SubscriptValue n, const XT *RESTRICT xp, const YT *RESTRICT yp) {
+  using AccumType = AccumulationType<RCAT, RKIND>;
+  constexpr SubscriptValue partials{4};
+  auto term{[&](SubscriptValue j) {
+    if constexpr (RCAT == TypeCategory::Complex) {
+      return std::conj(static_cast<AccumType>(xp[j])) *
+          static_cast<AccumType>(yp[j]);
+    } else {
+      return static_cast<AccumType>(xp[j]) * static_cast<AccumType>(yp[j]);
+    }
+  }};
+  AccumType accum[partials]{};
+  SubscriptValue j{0};
+  for (; j + partials <= n; j += partials) {
+    for (SubscriptValue p{0}; p < partials; ++p) {
+      accum[p] += term(j + p);
+    }
+  }
+  for (; j < n; ++j) {
+    accum[0] += term(j);
+  }
+  return (accum[0] + accum[1]) + (accum[2] + accum[3]);
+}
+
+// BLAS-1 dot products of contiguous REAL vectors, when the runtime was
+// configured to use BLAS.  COMPLEX dot products are not delegated, as the
+// way CDOTC and ZDOTC return their results depends on the library.
+template <typename T>
+static inline std::optional<T> BlasDotProduct(
+    SubscriptValue n, const T *x, const T *y) {
+#if FLANG_RUNTIME_USE_BLAS
+  if (blas::FitsInt(n)) {
+    const int nn{static_cast<int>(n)}, inc{1};
+    if constexpr (std::is_same_v<T, float>) {
+      return static_cast<float>(dsdot_(&nn, x, &inc, y, &inc));
+    } else if constexpr (std::is_same_v<T, double>) {
+      return ddot_(&nn, x, &inc, y, &inc);
+    }
+  }
+#endif
+  return std::nullopt;
+}
+
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 static inline CppTypeFor<RCAT, RKIND> DoDotProduct(
     const Descriptor &x, const Descriptor &y, Terminator &terminator) {
@@ -62,34 +113,16 @@ static inline CppTypeFor<RCAT, RKIND> DoDotProduct(
     if (x.GetDimension(0).ByteStride() == sizeof(XT) &&
         y.GetDimension(0).ByteStride() == sizeof(YT)) {
       // Contiguous numeric vectors
-      if constexpr (std::is_same_v<XT, YT>) {
+      if constexpr (std::is_same_v<XT, YT> && std::is_same_v<XT, Result>) {
         // Contiguous homogeneous numeric vectors
-        if constexpr (std::is_same_v<XT, float>) {
-          // TODO: call BLAS-1 SDOT or SDSDOT
-        } else if constexpr (std::is_same_v<XT, double>) {
-          // TODO: call BLAS-1 DDOT
-        } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-          // TODO: call BLAS-1 CDOTC
-        } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-          // TODO: call BLAS-1 ZDOTC
-        }
-      }
-      XT *xp{x.OffsetElement<XT>(0)};
-      YT *yp{y.OffsetElement<YT>(0)};
-      using AccumType = AccumulationType<RCAT, RKIND>;
-      AccumType accum{};
-      if constexpr (RCAT == TypeCategory::Complex) {
-        for (SubscriptValue j{0}; j < n; ++j) {
-          accum += std::conj(static_cast<AccumType>(*xp++)) *
-              static_cast<AccumType>(*yp++);
-        }
-      } else {
-        for (SubscriptValue j{0}; j < n; ++j) {
-          accum +=
-              static_cast<AccumType>(*xp++) * static_cast<AccumType>(*yp++);
+        if (std::optional<Result> dot{BlasDotProduct(
+                n, x.OffsetElement<XT>(0), y.OffsetElement<YT>(0))}) {
+          return *dot;
         }
       }
-      return static_cast<Result>(accum);
+      return static_cast<Result>(
+          ContiguousDotProduct<RCAT, RKIND, XT, YT>(n,
+              x.OffsetElement<XT>(0), y.OffsetElement<YT>(0)));
     }
   }
   // Non-contiguous, heterogeneous, & LOGICAL cases
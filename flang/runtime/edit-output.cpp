@@ -9,9 +9,17 @@
 #include "edit-output.h"
 #include "flang/Common/uint128.h"
 #include <algorithm>
+#include <cstring>
 
 namespace Fortran::runtime::io {
 
+static constexpr char decimalDigitPairs[]{
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899"};
+
 template <int KIND>
 bool EditIntegerOutput(IoStatementState &io, const DataEdit &edit,
     common::HostSignedIntType<8 * KIND> n) {
@@ -30,11 +38,19 @@ bool EditIntegerOutput(IoStatementState &io, const DataEdit &edit,
     if (isNegative || (edit.modes.editingFlags & signPlus)) {
       signChars = 1; // '-' or '+'
     }
-    while (un > 0) {
-      auto quotient{un / 10u};
-      *--p = '0' + static_cast<int>(un - Unsigned{10} * quotient);
+    // Convert two digits at a time
+    for (; un >= 100; p -= 2) {
+      auto quotient{un / 100u};
+      int pair{static_cast<int>(un - Unsigned{100} * quotient)};
+      std::memcpy(p - 2, &decimalDigitPairs[2 * pair], 2);
       un = quotient;
     }
+    if (un >= 10) {
+      p -= 2;
+      std::memcpy(p, &decimalDigitPairs[2 * static_cast<int>(un)], 2);
+    } else if (un > 0) {
+      *--p = '0' + static_cast<int>(un);
+    }
     break;
   case 'B':
     for (; un > 0; un >>= 1) {
@@ -90,6 +106,17 @@ bool EditIntegerOutput(IoStatementState &io, const DataEdit &edit,
     }
     leadingSpaces = 1;
   }
+  if (leadingSpaces + signChars + leadingZeroes <= p - buffer) {
+    // Assemble the whole field in the buffer and emit it at once
+    p -= leadingZeroes;
+    std::fill_n(p, leadingZeroes, '0');
+    if (signChars > 0) {
+      *--p = n < 0 ? '-' : '+';
+    }
+    p -= leadingSpaces;
+    std::fill_n(p, leadingSpaces, ' ');
+    return io.Emit(p, end - p);
+  }
   return io.EmitRepeated(' ', leadingSpaces) &&
       io.Emit(n < 0 ? "-" : "+", signChars) &&
       io.EmitRepeated('0', leadingZeroes) && io.Emit(p, digits);
@@ -128,6 +155,7 @@ const char *RealOutputEditingBase::FormatExponent(
 
 bool RealOutputEditingBase::EmitPrefix(
     const DataEdit &edit, std::size_t length, std::size_t width) {
+  fieldLength_ = 0;
   if (edit.IsListDirected()) {
     int prefixLength{edit.descriptor == DataEdit::ListDirectedRealPart ? 2
             : edit.descriptor == DataEdit::ListDirectedImaginaryPart   ? 0
@@ -139,27 +167,66 @@ bool RealOutputEditingBase::EmitPrefix(
     length += prefixLength + suffixLength;
     ConnectionState &connection{io_.GetConnectionState()};
     return (!connection.NeedAdvance(length) || io_.AdvanceRecord()) &&
-        io_.Emit(" (", prefixLength);
+        Append(" (", prefixLength);
   } else if (width > length) {
-    return io_.EmitRepeated(' ', width - length);
+    return AppendRepeated(' ', width - length);
   } else {
     return true;
   }
 }
 
+bool RealOutputEditingBase::Append(const char *data, std::size_t bytes) {
+  if (fieldLength_ + bytes > sizeof field_) {
+    if (!io_.Emit(field_, fieldLength_)) {
+      return false;
+    }
+    fieldLength_ = 0;
+    if (bytes > sizeof field_) {
+      return io_.Emit(data, bytes);
+    }
+  }
+  std::memcpy(field_ + fieldLength_, data, bytes);
+  fieldLength_ += bytes;
+  return true;
+}
+
+bool RealOutputEditingBase::AppendRepeated(char ch, std::size_t bytes) {
+  if (fieldLength_ + bytes > sizeof field_) {
+    if (!io_.Emit(field_, fieldLength_)) {
+      return false;
+    }
+    fieldLength_ = 0;
+    if (bytes > sizeof field_) {
+      return io_.EmitRepeated(ch, bytes);
+    }
+  }
+  std::memset(field_ + fieldLength_, ch, bytes);
+  fieldLength_ += bytes;
+  return true;
+}
+
 bool RealOutputEditingBase::EmitSuffix(const DataEdit &edit) {
   if (edit.descriptor == DataEdit::ListDirectedRealPart) {
-    return io_.Emit(edit.modes.editingFlags & decimalComma ? ";" : ",", 1);
+    if (!Append(edit.modes.editingFlags & decimalComma ? ";" : ",", 1)) {
+      return false;
+    }
   } else if (edit.descriptor == DataEdit::ListDirectedImaginaryPart) {
-    return io_.Emit(")", 1);
-  } else {
-    return true;
+    if (!Append(")", 1)) {
+      return false;
+    }
   }
+  std::size_t bytes{fieldLength_};
+  fieldLength_ = 0;
+  return io_.Emit(field_, bytes);
 }
 
 template <int binaryPrecision>
 decimal::ConversionToDecimalResult RealOutputEditing<binaryPrecision>::Convert(
     int significantDigits, enum decimal::FortranRounding rounding, int flags) {
+  if (flags == minimizedFlags_ && rounding == minimizedRounding_ &&
+      static_cast<int>(minimized_.length) <= significantDigits) {
+    return minimized_;
+  }
   auto converted{decimal::ConvertToDecimal<binaryPrecision>(buffer_,
       sizeof buffer_, static_cast<enum decimal::DecimalConversionFlags>(flags),
       significantDigits, rounding, x_)};
@@ -168,6 +235,13 @@ decimal::ConversionToDecimalResult RealOutputEditing<binaryPrecision>::Convert(
         "RealOutputEditing::Convert : buffer size %zd was insufficient",
         sizeof buffer_);
   }
+  if ((flags & decimal::Minimize) && converted.flags == decimal::Exact) {
+    minimizedFlags_ = flags;
+    minimizedRounding_ = rounding;
+    minimized_ = converted;
+  } else {
+    minimizedFlags_ = -1;
+  }
   return converted;
 }
 
@@ -207,7 +281,7 @@ bool RealOutputEditing<binaryPrecision>::EditEorDOutput(const DataEdit &edit) {
         Convert(significantDigits, edit.modes.round, flags)};
     if (IsInfOrNaN(converted)) {
       return EmitPrefix(edit, converted.length, editWidth) &&
-          io_.Emit(converted.str, converted.length) && EmitSuffix(edit);
+          Append(converted.str, converted.length) && EmitSuffix(edit);
     }
     if (!IsZero()) {
       converted.decimalExponent -= scale;
@@ -245,14 +319,14 @@ bool RealOutputEditing<binaryPrecision>::EditEorDOutput(const DataEdit &edit) {
       ++totalLength;
     }
     return EmitPrefix(edit, totalLength, width) &&
-        io_.Emit(converted.str, signLength + digitsBeforePoint) &&
-        io_.EmitRepeated('0', zeroesBeforePoint) &&
-        io_.Emit(edit.modes.editingFlags & decimalComma ? "," : ".", 1) &&
-        io_.EmitRepeated('0', zeroesAfterPoint) &&
-        io_.Emit(
+        Append(converted.str, signLength + digitsBeforePoint) &&
+        AppendRepeated('0', zeroesBeforePoint) &&
+        Append(edit.modes.editingFlags & decimalComma ? "," : ".", 1) &&
+        AppendRepeated('0', zeroesAfterPoint) &&
+        Append(
             converted.str + signLength + digitsBeforePoint, digitsAfterPoint) &&
-        io_.EmitRepeated('0', trailingZeroes) &&
-        io_.Emit(exponent, expoLength) && EmitSuffix(edit);
+        AppendRepeated('0', trailingZeroes) &&
+        Append(exponent, expoLength) && EmitSuffix(edit);
   }
 }
 
@@ -281,7 +355,7 @@ bool RealOutputEditing<binaryPrecision>::EditFOutput(const DataEdit &edit) {
         Convert(extraDigits + fracDigits, rounding, flags)};
     if (IsInfOrNaN(converted)) {
       return EmitPrefix(edit, converted.length, editWidth) &&
-          io_.Emit(converted.str, converted.length) && EmitSuffix(edit);
+          Append(converted.str, converted.length) && EmitSuffix(edit);
     }
     int scale{IsZero() ? 1 : edit.modes.scale}; // kP
     int expo{converted.decimalExponent + scale};
@@ -340,15 +414,15 @@ bool RealOutputEditing<binaryPrecision>::EditFOutput(const DataEdit &edit) {
       ++totalLength;
     }
     return EmitPrefix(edit, totalLength, width) &&
-        io_.Emit(converted.str, signLength + digitsBeforePoint) &&
-        io_.EmitRepeated('0', zeroesBeforePoint) &&
-        io_.Emit(edit.modes.editingFlags & decimalComma ? "," : ".", 1) &&
-        io_.EmitRepeated('0', zeroesAfterPoint) &&
-        io_.Emit(
+        Append(converted.str, signLength + digitsBeforePoint) &&
+        AppendRepeated('0', zeroesBeforePoint) &&
+        Append(edit.modes.editingFlags & decimalComma ? "," : ".", 1) &&
+        AppendRepeated('0', zeroesAfterPoint) &&
+        Append(
             converted.str + signLength + digitsBeforePoint, digitsAfterPoint) &&
-        io_.EmitRepeated('1', trailingOnes) &&
-        io_.EmitRepeated('0', trailingZeroes) &&
-        io_.EmitRepeated(' ', trailingBlanks_) && EmitSuffix(edit);
+        AppendRepeated('1', trailingOnes) &&
+        AppendRepeated('0', trailingZeroes) &&
+        AppendRepeated(' ', trailingBlanks_) && EmitSuffix(edit);
   }
 }
 
@@ -53,12 +53,20 @@ protected:
   }
 
   const char *FormatExponent(int, const DataEdit &edit, int &length);
+
+  // The characters of an output field are collected from EmitPrefix()
+  // through EmitSuffix(), which emits them with one call rather than
+  // piecemeal; long fields are emitted in several parts.
   bool EmitPrefix(const DataEdit &, std::size_t length, std::size_t width);
+  bool Append(const char *, std::size_t);
+  bool AppendRepeated(char, std::size_t);
   bool EmitSuffix(const DataEdit &);
 
   IoStatementState &io_;
   int trailingBlanks_{0}; // created when Gw editing maps to Fw
   char exponent_[16];
+  char field_[64];
+  std::size_t fieldLength_{0};
 };
 
 template <int KIND> class RealOutputEditing : public RealOutputEditingBase {
@@ -89,6 +97,12 @@ private:
   BinaryFloatingPoint x_;
   char buffer_[BinaryFloatingPoint::maxDecimalConversionDigits +
       EXTRA_DECIMAL_CONVERSION_SPACE];
+  // The last conversion into buffer_, when it had the Minimize flag and was
+  // exact; it serves again for later conversions with the same flags and
+  // rounding that allow at least as many digits.
+  int minimizedFlags_{-1};
+  decimal::FortranRounding minimizedRounding_{decimal::RoundNearest};
+  decimal::ConversionToDecimalResult minimized_;
 };
 
 bool ListDirectedLogicalOutput(
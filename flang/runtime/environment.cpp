@@ -78,6 +78,18 @@ void ExecutionEnvironment::Configure(
     }
   }
 
+  matmulThreads = 0;
+  if (auto *x{std::getenv("FORT_MATMUL_THREADS")}) {
+    char *end;
+    auto n{std::strtol(x, &end, 10)};
+    if (n >= 1 && n < std::numeric_limits<int>::max() && *end == '\0') {
+      matmulThreads = n;
+    } else {
+      std::fprintf(stderr,
+          "Fortran runtime: FORT_MATMUL_THREADS=%s is invalid; ignored\n", x);
+    }
+  }
+
   // TODO: Set RP/ROUND='PROCESSOR_DEFINED' from environment
 }
 
@@ -42,6 +42,7 @@ struct ExecutionEnvironment {
   enum decimal::FortranRounding defaultOutputRoundingMode;
   Convert conversion; // FORT_CONVERT
   bool noStopMessage; // NO_STOP_MESSAGE=1 inhibits "Fortran STOP"
+  int matmulThreads; // FORT_MATMUL_THREADS; 0 means one per processor
 };
 extern ExecutionEnvironment executionEnvironment;
 } // namespace Fortran::runtime
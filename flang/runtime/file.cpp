@@ -66,6 +66,8 @@ void OpenFile::Open(OpenStatus status, std::optional<Action> action,
       (status == OpenStatus::Old || status == OpenStatus::Unknown)) {
     return;
   }
+  WaitAll(handler);
+  StopWorker();
   CloseFd(handler);
   if (status == OpenStatus::Scratch) {
     if (path_.get()) {
@@ -166,7 +168,8 @@ void OpenFile::Predefine(int fd) {
 }
 
 void OpenFile::Close(CloseStatus status, IoErrorHandler &handler) {
-  pending_.reset();
+  WaitAll(handler);
+  StopWorker();
   knownSize_.reset();
   switch (status) {
   case CloseStatus::Keep:
@@ -257,69 +260,180 @@ void OpenFile::Truncate(FileOffset at, IoErrorHandler &handler) {
   }
 }
 
-// The operation is performed immediately; the results are saved
-// to be claimed by a later WAIT statement.
-// TODO: True asynchronicity
-int OpenFile::ReadAsynchronously(
-    FileOffset at, char *buffer, std::size_t bytes, IoErrorHandler &handler) {
-  CheckOpen(handler);
-  int iostat{0};
-  for (std::size_t got{0}; got < bytes;) {
-#if _XOPEN_SOURCE >= 500 || _POSIX_C_SOURCE >= 200809L
-    auto chunk{::pread(fd_, buffer + got, bytes - got, at)};
-#else
-    auto chunk{Seek(at, handler) ? ::read(fd_, buffer + got, bytes - got) : -1};
-#endif
-    if (chunk == 0) {
-      iostat = FORTRAN_RUNTIME_IOSTAT_END;
-      break;
-    }
-    if (chunk < 0) {
-      auto err{errno};
-      if (err != EAGAIN && err != EWOULDBLOCK && err != EINTR) {
-        iostat = err;
+#if USE_PTHREADS
+// The background thread that performs the asynchronous transfers of a file.
+struct OpenFile::Worker {
+  static void *Run(void *arg) {
+    auto &file{*static_cast<OpenFile *>(arg)};
+    Worker &worker{*file.worker_};
+    file.TakePending();
+    while (true) {
+      if (Pending * request{file.nextTransfer_}) {
+        file.DropPending();
+        int ioStat{file.Transfer(*request)};
+        file.TakePending();
+        request->ioStat = ioStat;
+        request->done = true;
+        file.nextTransfer_ = request->next.get();
+        pthread_cond_broadcast(&worker.completed);
+      } else if (worker.stop) {
         break;
+      } else {
+        pthread_cond_wait(&worker.requested, &worker.mutex);
       }
-    } else {
-      at += chunk;
-      got += chunk;
     }
+    file.DropPending();
+    return nullptr;
+  }
+
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t requested; // signaled by StartTransfer() and StopWorker()
+  pthread_cond_t completed; // broadcast by the worker after each transfer
+  bool stop{false};
+};
+
+void OpenFile::StartWorker(const Terminator &terminator) {
+  worker_ = New<Worker>{terminator}().release();
+  pthread_mutex_init(&worker_->mutex, nullptr);
+  pthread_cond_init(&worker_->requested, nullptr);
+  pthread_cond_init(&worker_->completed, nullptr);
+  if (pthread_create(&worker_->thread, nullptr, &Worker::Run, this) != 0) {
+    // No thread; transfers will be performed immediately
+    pthread_cond_destroy(&worker_->completed);
+    pthread_cond_destroy(&worker_->requested);
+    pthread_mutex_destroy(&worker_->mutex);
+    FreeMemoryAndNullify(worker_);
+  }
+}
+
+void OpenFile::StopWorker() {
+  if (worker_) {
+    TakePending();
+    worker_->stop = true;
+    pthread_cond_signal(&worker_->requested);
+    DropPending();
+    pthread_join(worker_->thread, nullptr);
+    pthread_cond_destroy(&worker_->completed);
+    pthread_cond_destroy(&worker_->requested);
+    pthread_mutex_destroy(&worker_->mutex);
+    FreeMemoryAndNullify(worker_);
+  }
+}
+
+void OpenFile::TakePending() {
+  if (worker_) {
+    pthread_mutex_lock(&worker_->mutex);
+  }
+}
+
+void OpenFile::DropPending() {
+  if (worker_) {
+    pthread_mutex_unlock(&worker_->mutex);
   }
-  return PendingResult(handler, iostat);
 }
 
-// TODO: True asynchronicity
+void OpenFile::AwaitCompletion(Pending &request) {
+  while (!request.done) {
+    pthread_cond_wait(&worker_->completed, &worker_->mutex);
+  }
+}
+#else
+struct OpenFile::Worker {};
+void OpenFile::StartWorker(const Terminator &) {}
+void OpenFile::StopWorker() {}
+void OpenFile::TakePending() {}
+void OpenFile::DropPending() {}
+void OpenFile::AwaitCompletion(Pending &) {}
+#endif
+
+int OpenFile::ReadAsynchronously(
+    FileOffset at, char *buffer, std::size_t bytes, IoErrorHandler &handler) {
+  CheckOpen(handler);
+  return StartTransfer(handler, true, at, buffer, bytes);
+}
+
 int OpenFile::WriteAsynchronously(FileOffset at, const char *buffer,
     std::size_t bytes, IoErrorHandler &handler) {
   CheckOpen(handler);
-  int iostat{0};
-  for (std::size_t put{0}; put < bytes;) {
+  if (knownSize_ && at + static_cast<FileOffset>(bytes) > *knownSize_) {
+    knownSize_ = at + bytes;
+  }
+  return StartTransfer(
+      handler, false, at, const_cast<char *>(buffer), bytes);
+}
+
+int OpenFile::StartTransfer(const Terminator &terminator, bool isRead,
+    FileOffset at, char *buffer, std::size_t bytes) {
+  OwningPtr<Pending> owner{
+      New<Pending>{terminator}(nextId_, isRead, at, buffer, bytes)};
+  Pending &request{*owner};
+  if (!worker_) {
+    StartWorker(terminator);
+  }
+  if (!worker_) {
+    request.ioStat = Transfer(request);
+    request.done = true;
+  }
+  TakePending();
+  if (lastPending_) {
+    lastPending_->next = std::move(owner);
+  } else {
+    pending_ = std::move(owner);
+  }
+  lastPending_ = &request;
+  if (!request.done && !nextTransfer_) {
+    nextTransfer_ = &request;
+#if USE_PTHREADS
+    pthread_cond_signal(&worker_->requested);
+#endif
+  }
+  DropPending();
+  return nextId_++;
+}
+
+// Performs a transfer without changing the file position, so that
+// synchronous transfers may proceed at the same time.
+int OpenFile::Transfer(Pending &request) {
+  FileOffset at{request.at};
+  for (std::size_t done{0}; done < request.bytes;) {
+    char *buffer{request.buffer + done};
+    std::size_t bytes{request.bytes - done};
 #if _XOPEN_SOURCE >= 500 || _POSIX_C_SOURCE >= 200809L
-    auto chunk{::pwrite(fd_, buffer + put, bytes - put, at)};
+    auto chunk{request.isRead ? ::pread(fd_, buffer, bytes, at)
+                              : ::pwrite(fd_, buffer, bytes, at)};
 #else
-    auto chunk{
-        Seek(at, handler) ? ::write(fd_, buffer + put, bytes - put) : -1};
+    auto chunk{!RawSeek(at)  ? -1
+            : request.isRead ? ::read(fd_, buffer, bytes)
+                             : ::write(fd_, buffer, bytes)};
+    SetPosition(-1); // unknown; the next Seek() will reposition
 #endif
-    if (chunk >= 0) {
-      at += chunk;
-      put += chunk;
-    } else {
+    if (chunk == 0 && request.isRead) {
+      return FORTRAN_RUNTIME_IOSTAT_END;
+    } else if (chunk < 0) {
       auto err{errno};
       if (err != EAGAIN && err != EWOULDBLOCK && err != EINTR) {
-        iostat = err;
-        break;
+        return err;
       }
+    } else {
+      at += chunk;
+      done += chunk;
     }
   }
-  return PendingResult(handler, iostat);
+  return 0;
 }
 
 void OpenFile::Wait(int id, IoErrorHandler &handler) {
   std::optional<int> ioStat;
+  TakePending();
   Pending *prev{nullptr};
   for (Pending *p{pending_.get()}; p; p = (prev = p)->next.get()) {
     if (p->id == id) {
+      AwaitCompletion(*p);
       ioStat = p->ioStat;
+      if (lastPending_ == p) {
+        lastPending_ = prev;
+      }
       if (prev) {
         prev->next.reset(p->next.release());
       } else {
@@ -328,6 +442,7 @@ void OpenFile::Wait(int id, IoErrorHandler &handler) {
       break;
     }
   }
+  DropPending();
   if (ioStat) {
     handler.SignalError(*ioStat);
   }
@@ -336,16 +451,49 @@ void OpenFile::Wait(int id, IoErrorHandler &handler) {
 void OpenFile::WaitAll(IoErrorHandler &handler) {
   while (true) {
     int ioStat;
+    TakePending();
     if (pending_) {
+      AwaitCompletion(*pending_);
       ioStat = pending_->ioStat;
+      if (lastPending_ == pending_.get()) {
+        lastPending_ = nullptr;
+      }
       pending_.reset(pending_->next.release());
     } else {
+      DropPending();
       return;
     }
+    DropPending();
     handler.SignalError(ioStat);
   }
 }
 
+bool OpenFile::InquirePending(IoErrorHandler &handler) {
+  TakePending();
+  bool isPending{nextTransfer_ != nullptr};
+  DropPending();
+  if (!isPending) {
+    WaitAll(handler);
+  }
+  return isPending;
+}
+
+bool OpenFile::InquirePending(int id, IoErrorHandler &handler) {
+  bool isPending{false};
+  TakePending();
+  for (Pending *p{pending_.get()}; p; p = p->next.get()) {
+    if (p->id == id) {
+      isPending = !p->done;
+      break;
+    }
+  }
+  DropPending();
+  if (!isPending) {
+    Wait(id, handler);
+  }
+  return isPending;
+}
+
 Position OpenFile::InquirePosition() const {
   if (openPosition_) { // from OPEN statement
     return *openPosition_;
@@ -398,12 +546,6 @@ bool OpenFile::RawSeekToEnd() {
   }
 }
 
-int OpenFile::PendingResult(const Terminator &terminator, int iostat) {
-  int id{nextId_++};
-  pending_ = New<Pending>{terminator}(id, iostat, std::move(pending_));
-  return id;
-}
-
 void OpenFile::CloseFd(IoErrorHandler &handler) {
   if (fd_ >= 0) {
     if (fd_ <= 2) {
@@ -12,6 +12,7 @@
 #define FORTRAN_RUNTIME_FILE_H_
 
 #include "io-error.h"
+#include "lock.h"
 #include "flang/Runtime/memory.h"
 #include <cinttypes>
 #include <optional>
@@ -59,28 +60,49 @@ public:
   // Truncates the file
   void Truncate(FileOffset, IoErrorHandler &);
 
-  // Asynchronous transfers
+  // Asynchronous transfers.  They are performed in order of request by a
+  // background thread of the file, when possible, and complete no later
+  // than the WAIT for their identifiers.  The buffers must remain valid
+  // until then.  Errors are signaled by the WAIT.
   int ReadAsynchronously(FileOffset, char *, std::size_t, IoErrorHandler &);
   int WriteAsynchronously(
       FileOffset, const char *, std::size_t, IoErrorHandler &);
   void Wait(int id, IoErrorHandler &);
   void WaitAll(IoErrorHandler &);
 
+  // INQUIRE(PENDING=); performs the wait operation(s) once the
+  // transfer(s) are complete
+  bool InquirePending(IoErrorHandler &);
+  bool InquirePending(int id, IoErrorHandler &);
+
   // INQUIRE(POSITION=)
   Position InquirePosition() const;
 
 private:
   struct Pending {
     int id;
+    bool isRead;
+    FileOffset at;
+    char *buffer; // const for writes
+    std::size_t bytes;
     int ioStat{0};
+    bool done{false};
     OwningPtr<Pending> next;
   };
+  struct Worker;
 
   void CheckOpen(const Terminator &);
   bool Seek(FileOffset, IoErrorHandler &);
   bool RawSeek(FileOffset);
   bool RawSeekToEnd();
-  int PendingResult(const Terminator &, int);
+  int StartTransfer(const Terminator &, bool isRead, FileOffset, char *,
+      std::size_t);
+  int Transfer(Pending &);
+  void StartWorker(const Terminator &);
+  void StopWorker();
+  void TakePending();
+  void DropPending();
+  void AwaitCompletion(Pending &);
   void SetPosition(FileOffset pos) {
     position_ = pos;
     openPosition_.reset();
@@ -100,8 +122,14 @@ private:
   bool isTerminal_{false};
   bool isWindowsTextFile_{false}; // expands LF to CR+LF on write
 
-  int nextId_;
+  // Asynchronous transfers in order of request; those that precede
+  // nextTransfer_ are done.  When there is a worker thread, its mutex
+  // protects the list.
+  int nextId_{0};
   OwningPtr<Pending> pending_;
+  Pending *lastPending_{nullptr};
+  Pending *nextTransfer_{nullptr};
+  Worker *worker_{nullptr};
 };
 
 bool IsATerminal(int fd);
@@ -318,6 +318,51 @@ Cookie IONAME(BeginUnformattedInput)(
       unitNumber, sourceFile, sourceLine);
 }
 
+AsynchronousId IONAME(BeginAsynchronousOutput)(ExternalUnit unitNumber,
+    std::int64_t REC, const char *data, std::size_t bytes,
+    const char *sourceFile, int sourceLine) {
+  Terminator terminator{sourceFile, sourceLine};
+  ExternalFileUnit &unit{
+      ExternalFileUnit::LookUpOrCrash(unitNumber, terminator)};
+  IoErrorHandler handler{terminator};
+  return unit.BeginAsynchronousTransfer(Direction::Output, REC,
+      const_cast<char *>(data), bytes, handler);
+}
+
+AsynchronousId IONAME(BeginAsynchronousInput)(ExternalUnit unitNumber,
+    std::int64_t REC, char *data, std::size_t bytes, const char *sourceFile,
+    int sourceLine) {
+  Terminator terminator{sourceFile, sourceLine};
+  ExternalFileUnit &unit{
+      ExternalFileUnit::LookUpOrCrash(unitNumber, terminator)};
+  IoErrorHandler handler{terminator};
+  return unit.BeginAsynchronousTransfer(
+      Direction::Input, REC, data, bytes, handler);
+}
+
+// WAIT has no source position arguments.
+static Cookie BeginWait(ExternalUnit unitNumber,
+    ExternalMiscIoStatementState::Which which, AsynchronousId id = 0) {
+  if (ExternalFileUnit * unit{ExternalFileUnit::LookUp(unitNumber)}) {
+    return &unit->BeginIoStatement<ExternalMiscIoStatementState>(
+        *unit, which, nullptr, 0, id);
+  } else {
+    // WAIT(UNIT=unconnected unit) is a no-op
+    Terminator oom;
+    return &New<NoopStatementState>{oom}(nullptr, 0)
+                .release()
+                ->ioStatementState();
+  }
+}
+
+Cookie IONAME(BeginWait)(ExternalUnit unitNumber, AsynchronousId id) {
+  return BeginWait(unitNumber, ExternalMiscIoStatementState::Wait, id);
+}
+
+Cookie IONAME(BeginWaitAll)(ExternalUnit unitNumber) {
+  return BeginWait(unitNumber, ExternalMiscIoStatementState::WaitAll);
+}
+
 Cookie IONAME(BeginOpenUnit)( // OPEN(without NEWUNIT=)
     ExternalUnit unitNumber, const char *sourceFile, int sourceLine) {
   bool wasExtant{false};
@@ -480,12 +480,22 @@ ExternalFileUnit *IoStatementState::GetExternalFileUnit() const {
 }
 
 bool IoStatementState::EmitRepeated(char ch, std::size_t n) {
+  if (n == 0) {
+    return true;
+  }
+  // Emit in chunks rather than one character at a time, since padding
+  // with blanks and zeroes accounts for much of the output of numeric
+  // edit descriptors.
+  char chunk[32];
+  std::memset(chunk, ch, std::min(n, sizeof chunk));
   return std::visit(
-      [=](auto &x) {
-        for (std::size_t j{0}; j < n; ++j) {
-          if (!x.get().Emit(&ch, 1)) {
+      [&](auto &x) {
+        for (std::size_t remaining{n}; remaining > 0;) {
+          std::size_t bytes{std::min(remaining, sizeof chunk)};
+          if (!x.get().Emit(chunk, bytes)) {
             return false;
           }
+          remaining -= bytes;
         }
         return true;
       },
@@ -868,14 +878,23 @@ int ExternalMiscIoStatementState::EndIoStatement() {
     std::fflush(nullptr); // flushes C stdio output streams (12.9(2))
     break;
   case Backspace:
+    ext.WaitAll(*this); // file positioning performs wait operations
     ext.BackspaceRecord(*this);
     break;
   case Endfile:
+    ext.WaitAll(*this);
     ext.Endfile(*this);
     break;
   case Rewind:
+    ext.WaitAll(*this);
     ext.Rewind(*this);
     break;
+  case Wait:
+    ext.Wait(id_, *this);
+    break;
+  case WaitAll:
+    ext.WaitAll(*this);
+    break;
   }
   return ExternalIoStatementBase::EndIoStatement();
 }
@@ -1088,7 +1107,7 @@ bool InquireUnitState::Inquire(InquiryKeywordHash inquiry, bool &result) {
     result = unit().IsConnected();
     return true;
   case HashInquiryKeyword("PENDING"):
-    result = false; // asynchronous I/O is not implemented
+    result = unit().InquirePending(*this);
     return true;
   default:
     BadInquiryKeywordHashCrash(inquiry);
@@ -1097,10 +1116,10 @@ bool InquireUnitState::Inquire(InquiryKeywordHash inquiry, bool &result) {
 }
 
 bool InquireUnitState::Inquire(
-    InquiryKeywordHash inquiry, std::int64_t, bool &result) {
+    InquiryKeywordHash inquiry, std::int64_t id, bool &result) {
   switch (inquiry) {
   case HashInquiryKeyword("PENDING"):
-    result = false; // asynchronous I/O is not implemented
+    result = unit().InquirePending(static_cast<int>(id), *this);
     return true;
   default:
     BadInquiryKeywordHashCrash(inquiry);
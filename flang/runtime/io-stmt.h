@@ -666,14 +666,16 @@ private:
 
 class ExternalMiscIoStatementState : public ExternalIoStatementBase {
 public:
-  enum Which { Flush, Backspace, Endfile, Rewind };
+  enum Which { Flush, Backspace, Endfile, Rewind, Wait, WaitAll };
   ExternalMiscIoStatementState(ExternalFileUnit &unit, Which which,
-      const char *sourceFile = nullptr, int sourceLine = 0)
-      : ExternalIoStatementBase{unit, sourceFile, sourceLine}, which_{which} {}
+      const char *sourceFile = nullptr, int sourceLine = 0, int id = 0)
+      : ExternalIoStatementBase{unit, sourceFile, sourceLine}, which_{which},
+        id_{id} {}
   int EndIoStatement();
 
 private:
   Which which_;
+  int id_; // for WAIT(ID=)
 };
 
 class ErroneousIoStatementState : public IoStatementBase {
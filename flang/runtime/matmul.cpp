@@ -17,15 +17,25 @@
 // of logical kinds (16).  A single template undergoes many instantiations
 // to cover all of the valid possibilities.
 //
-// Places where BLAS routines could be called are marked as TODO items.
+// Contiguous REAL and COMPLEX cases can be delegated to BLAS routines when
+// the runtime is configured with FLANG_RUNTIME_USE_BLAS; otherwise, the
+// contiguous matrix*matrix cases use a cache-blocked kernel that spreads
+// large products over several threads.
 
 #include "flang/Runtime/matmul.h"
+#include "blas.h"
+#include "environment.h"
+#include "lock.h"
 #include "terminator.h"
 #include "tools.h"
 #include "flang/Runtime/c-or-cpp.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <algorithm>
 #include <cstring>
+#if USE_PTHREADS
+#include <unistd.h>
+#endif
 
 namespace Fortran::runtime {
 
@@ -69,26 +79,160 @@ private:
 //    DO 2 J = 1, NCOLS
 //     DO 2 I = 1, NROWS
 //   2  RES(I,J) = RES(I,J) + X(I,K)*Y(K,J) ! loop-invariant last term
+// The loops over I and K are then blocked so that a block of X stays in
+// the cache while it is used for all columns of the result, and the loop
+// over J is unrolled so that each element of X that is loaded is used for
+// four columns of the result:
+//   DO 2 I0 = 1, NROWS, ROWBLOCK
+//    DO 2 K0 = 1, N, DEPTHBLOCK
+//     DO 2 J = 1, NCOLS, 4
+//      DO 2 K = K0, MIN(K0+DEPTHBLOCK-1, N)
+//       DO 2 I = I0, MIN(I0+ROWBLOCK-1, NROWS)
+//   2    RES(I,J:J+3) = RES(I,J:J+3) + X(I,K)*Y(K,J:J+3)
+template <typename ResultType> struct MatmulBlocking {
+  // Four columns of the result spanning a row block take 8KiB, and a
+  // block of X (rowBlock x depthBlock) takes about 128KiB.
+  static constexpr SubscriptValue rowBlock{std::max<SubscriptValue>(
+      2048 / sizeof(ResultType), 1)};
+  static constexpr SubscriptValue depthBlock{std::max<SubscriptValue>(
+      128 * 1024 / (rowBlock * sizeof(ResultType)), 1)};
+};
+
+// Computes columns [jStart,jEnd) of the product.
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
-inline void MatrixTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
-    SubscriptValue rows, SubscriptValue cols, const XT *RESTRICT x,
-    const YT *RESTRICT y, SubscriptValue n) {
+void MatrixTimesMatrixColumns(CppTypeFor<RCAT, RKIND> *RESTRICT product,
+    SubscriptValue rows, const XT *RESTRICT x, const YT *RESTRICT y,
+    SubscriptValue n, SubscriptValue jStart, SubscriptValue jEnd) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
-  std::memset(product, 0, rows * cols * sizeof *product);
-  const XT *RESTRICT xp0{x};
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    for (SubscriptValue j{0}; j < cols; ++j) {
-      const XT *RESTRICT xp{xp0};
-      auto yv{static_cast<ResultType>(y[k + j * n])};
-      for (SubscriptValue i{0}; i < rows; ++i) {
-        *p++ += static_cast<ResultType>(*xp++) * yv;
+  using Blocking = MatmulBlocking<ResultType>;
+  std::memset(&product[jStart * rows], 0,
+      (jEnd - jStart) * rows * sizeof *product);
+  for (SubscriptValue i0{0}; i0 < rows; i0 += Blocking::rowBlock) {
+    SubscriptValue iCount{std::min(Blocking::rowBlock, rows - i0)};
+    for (SubscriptValue k0{0}; k0 < n; k0 += Blocking::depthBlock) {
+      SubscriptValue kEnd{std::min(k0 + Blocking::depthBlock, n)};
+      SubscriptValue j{jStart};
+      for (; j + 4 <= jEnd; j += 4) {
+        ResultType *RESTRICT p0{&product[i0 + j * rows]};
+        ResultType *RESTRICT p1{p0 + rows};
+        ResultType *RESTRICT p2{p1 + rows};
+        ResultType *RESTRICT p3{p2 + rows};
+        for (SubscriptValue k{k0}; k < kEnd; ++k) {
+          const XT *RESTRICT xp{&x[i0 + k * rows]};
+          auto yv0{static_cast<ResultType>(y[k + j * n])};
+          auto yv1{static_cast<ResultType>(y[k + (j + 1) * n])};
+          auto yv2{static_cast<ResultType>(y[k + (j + 2) * n])};
+          auto yv3{static_cast<ResultType>(y[k + (j + 3) * n])};
+          for (SubscriptValue i{0}; i < iCount; ++i) {
+            auto xv{static_cast<ResultType>(xp[i])};
+            p0[i] += xv * yv0;
+            p1[i] += xv * yv1;
+            p2[i] += xv * yv2;
+            p3[i] += xv * yv3;
+          }
+        }
+      }
+      for (; j < jEnd; ++j) {
+        ResultType *RESTRICT p{&product[i0 + j * rows]};
+        for (SubscriptValue k{k0}; k < kEnd; ++k) {
+          const XT *RESTRICT xp{&x[i0 + k * rows]};
+          auto yv{static_cast<ResultType>(y[k + j * n])};
+          for (SubscriptValue i{0}; i < iCount; ++i) {
+            p[i] += static_cast<ResultType>(xp[i]) * yv;
+          }
+        }
       }
     }
-    xp0 += rows;
   }
 }
 
+// Large products are computed by several threads, each one computing a
+// contiguous range of columns of the result.  The number of threads is
+// limited by FORT_MATMUL_THREADS, and each thread gets enough work to
+// amortize its creation.
+static constexpr double minFlopsPerThread{1 << 22};
+
+static int GetMatmulThreads(double flops) {
+  int threads{executionEnvironment.matmulThreads};
+  if (threads <= 0) {
+#if USE_PTHREADS
+    threads = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#else
+    threads = 1;
+#endif
+  }
+  return std::max(1,
+      static_cast<int>(std::min<double>(threads, flops / minFlopsPerThread)));
+}
+
+#if USE_PTHREADS
+template <typename WORK> struct MatmulThread {
+  static void *Run(void *arg) {
+    auto *self{static_cast<MatmulThread *>(arg)};
+    (*self->work)(self->part);
+    return nullptr;
+  }
+  const WORK *work;
+  int part;
+  pthread_t thread;
+  bool started{false};
+};
+#endif
+
+// Calls work(part) for each part in [0,parts), concurrently when possible.
+template <typename WORK> static void ParallelMatmul(int parts, WORK work) {
+#if USE_PTHREADS
+  constexpr int maxThreads{64};
+  parts = std::min(parts, maxThreads);
+  if (parts > 1) {
+    MatmulThread<WORK> threads[maxThreads];
+    for (int part{1}; part < parts; ++part) {
+      MatmulThread<WORK> &thread{threads[part]};
+      thread.work = &work;
+      thread.part = part;
+      thread.started = pthread_create(&thread.thread, nullptr,
+                           &MatmulThread<WORK>::Run, &thread) == 0;
+      if (!thread.started) {
+        work(part); // could not create a thread, do the work here
+      }
+    }
+    work(0);
+    for (int part{1}; part < parts; ++part) {
+      if (threads[part].started) {
+        pthread_join(threads[part].thread, nullptr);
+      }
+    }
+    return;
+  }
+#endif
+  for (int part{0}; part < parts; ++part) {
+    work(part);
+  }
+}
+
+template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
+inline void MatrixTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
+    SubscriptValue rows, SubscriptValue cols, const XT *RESTRICT x,
+    const YT *RESTRICT y, SubscriptValue n) {
+  constexpr SubscriptValue NR{4};
+  double flops{2.0 * rows * cols * n};
+  // Each thread computes whole tiles of columns.
+  SubscriptValue colTiles{(cols + NR - 1) / NR};
+  int parts{static_cast<int>(
+      std::min<SubscriptValue>(GetMatmulThreads(flops), colTiles))};
+  if (parts <= 1) {
+    MatrixTimesMatrixColumns<RCAT, RKIND, XT, YT>(
+        product, rows, x, y, n, 0, cols);
+    return;
+  }
+  ParallelMatmul(parts, [=](int part) {
+    SubscriptValue jStart{colTiles * part / parts * NR};
+    SubscriptValue jEnd{std::min(colTiles * (part + 1) / parts * NR, cols)};
+    MatrixTimesMatrixColumns<RCAT, RKIND, XT, YT>(
+        product, rows, x, y, n, jStart, jEnd);
+  });
+}
+
 // Contiguous numeric matrix*vector multiplication
 //   matrix(rows,n) * column vector(n) -> column vector(rows)
 // Straightforward algorithm:
@@ -125,28 +269,115 @@ inline void MatrixTimesVector(CppTypeFor<RCAT, RKIND> *RESTRICT product,
 //    RES(J) = 0
 //    DO 1 K = 1, N
 //   1 RES(J) = RES(J) + X(K)*Y(K,J)
-// With loop distribution and transposition to avoid the inner
-// sum reduction and one non-unit stride (the other remains):
-//   DO 1 J = 1, NCOLS
-//   1 RES(J) = 0
-//   DO 2 K = 1, N
-//    DO 2 J = 1, NCOLS
-//   2 RES(J) = RES(J) + X(K)*Y(K,J)
+// The inner sum reduction has unit strides, so it is kept, and the loop
+// over J is unrolled so that each element of X that is loaded is used for
+// four columns of Y:
+//   DO 1 J = 1, NCOLS, 4
+//    RES(J:J+3) = 0
+//    DO 1 K = 1, N
+//   1 RES(J:J+3) = RES(J:J+3) + X(K)*Y(K,J:J+3)
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 inline void VectorTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
     SubscriptValue n, SubscriptValue cols, const XT *RESTRICT x,
     const YT *RESTRICT y) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
-  std::memset(product, 0, cols * sizeof *product);
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    auto xv{static_cast<ResultType>(*x++)};
-    const YT *RESTRICT yp{&y[k]};
-    for (SubscriptValue j{0}; j < cols; ++j) {
-      *p++ += xv * static_cast<ResultType>(*yp);
-      yp += n;
+  SubscriptValue j{0};
+  for (; j + 4 <= cols; j += 4) {
+    const YT *RESTRICT y0{&y[j * n]};
+    const YT *RESTRICT y1{y0 + n};
+    const YT *RESTRICT y2{y1 + n};
+    const YT *RESTRICT y3{y2 + n};
+    ResultType sum0{}, sum1{}, sum2{}, sum3{};
+    for (SubscriptValue k{0}; k < n; ++k) {
+      auto xv{static_cast<ResultType>(x[k])};
+      sum0 += xv * static_cast<ResultType>(y0[k]);
+      sum1 += xv * static_cast<ResultType>(y1[k]);
+      sum2 += xv * static_cast<ResultType>(y2[k]);
+      sum3 += xv * static_cast<ResultType>(y3[k]);
+    }
+    product[j] = sum0;
+    product[j + 1] = sum1;
+    product[j + 2] = sum2;
+    product[j + 3] = sum3;
+  }
+  for (; j < cols; ++j) {
+    const YT *RESTRICT yp{&y[j * n]};
+    ResultType sum{};
+    for (SubscriptValue k{0}; k < n; ++k) {
+      sum += static_cast<ResultType>(x[k]) * static_cast<ResultType>(yp[k]);
+    }
+    product[j] = sum;
+  }
+}
+
+// BLAS implementations of the contiguous cases with operands and results of
+// the same REAL or COMPLEX type.  They return false when the runtime was not
+// configured to use BLAS, or when the extents exceed the range of the
+// integers of the library, and the generic kernels are used instead.
+template <typename T>
+static constexpr bool isBlasType{std::is_same_v<T, float> ||
+    std::is_same_v<T, double> || std::is_same_v<T, std::complex<float>> ||
+    std::is_same_v<T, std::complex<double>>};
+
+template <typename T>
+static inline bool BlasMatrixTimesMatrix(T *product, SubscriptValue rows,
+    SubscriptValue cols, const T *x, const T *y, SubscriptValue n) {
+#if FLANG_RUNTIME_USE_BLAS
+  if constexpr (isBlasType<T>) {
+    if (!blas::FitsInt(rows, cols, n)) {
+      return false;
+    }
+    const char notrans{'N'};
+    const int m{static_cast<int>(rows)}, nn{static_cast<int>(cols)},
+        k{static_cast<int>(n)};
+    const int ldx{std::max(m, 1)}, ldy{std::max(k, 1)};
+    const T one{1}, zero{0};
+    if constexpr (std::is_same_v<T, float>) {
+      sgemm_(&notrans, &notrans, &m, &nn, &k, &one, x, &ldx, y, &ldy, &zero,
+          product, &ldx);
+    } else if constexpr (std::is_same_v<T, double>) {
+      dgemm_(&notrans, &notrans, &m, &nn, &k, &one, x, &ldx, y, &ldy, &zero,
+          product, &ldx);
+    } else if constexpr (std::is_same_v<T, std::complex<float>>) {
+      cgemm_(&notrans, &notrans, &m, &nn, &k, &one, x, &ldx, y, &ldy, &zero,
+          product, &ldx);
+    } else {
+      zgemm_(&notrans, &notrans, &m, &nn, &k, &one, x, &ldx, y, &ldy, &zero,
+          product, &ldx);
+    }
+    return true;
+  }
+#endif
+  return false;
+}
+
+// Computes product = a(rows,cols) * v, or product = TRANSPOSE(a) * v when
+// TRANSPOSE is true.
+template <bool TRANSPOSE, typename T>
+static inline bool BlasMatrixTimesVector(T *product, SubscriptValue rows,
+    SubscriptValue cols, const T *a, const T *v) {
+#if FLANG_RUNTIME_USE_BLAS
+  if constexpr (isBlasType<T>) {
+    if (!blas::FitsInt(rows, cols)) {
+      return false;
+    }
+    const char trans{TRANSPOSE ? 'T' : 'N'};
+    const int m{static_cast<int>(rows)}, nn{static_cast<int>(cols)};
+    const int lda{std::max(m, 1)}, inc{1};
+    const T one{1}, zero{0};
+    if constexpr (std::is_same_v<T, float>) {
+      sgemv_(&trans, &m, &nn, &one, a, &lda, v, &inc, &zero, product, &inc);
+    } else if constexpr (std::is_same_v<T, double>) {
+      dgemv_(&trans, &m, &nn, &one, a, &lda, v, &inc, &zero, product, &inc);
+    } else if constexpr (std::is_same_v<T, std::complex<float>>) {
+      cgemv_(&trans, &m, &nn, &one, a, &lda, v, &inc, &zero, product, &inc);
+    } else {
+      zgemv_(&trans, &m, &nn, &one, a, &lda, v, &inc, &zero, product, &inc);
     }
+    return true;
   }
+#endif
+  return false;
 }
 
 // Implements an instance of MATMUL for given argument types.
@@ -196,15 +427,12 @@ static inline void DoMatmul(
         (IS_ALLOCATING || result.IsContiguous())) {
       // Contiguous numeric matrices
       if (resRank == 2) { // M*M -> M
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-3 SGEMM
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-3 DGEMM
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-3 CGEMM
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-3 ZGEMM
+        if constexpr (std::is_same_v<XT, YT> &&
+            std::is_same_v<XT, WriteResult>) {
+          if (BlasMatrixTimesMatrix(result.template OffsetElement<XT>(),
+                  extent[0], extent[1], x.OffsetElement<XT>(),
+                  y.OffsetElement<XT>(), n)) {
+            return;
           }
         }
         MatrixTimesMatrix<RCAT, RKIND, XT, YT>(
@@ -212,15 +440,12 @@ static inline void DoMatmul(
             x.OffsetElement<XT>(), y.OffsetElement<YT>(), n);
         return;
       } else if (xRank == 2) { // M*V -> V
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-2 SGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-2 DGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-2 CGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-2 ZGEMV(x,y)
+        if constexpr (std::is_same_v<XT, YT> &&
+            std::is_same_v<XT, WriteResult>) {
+          if (BlasMatrixTimesVector<false>(result.template OffsetElement<XT>(),
+                  extent[0], n, x.OffsetElement<XT>(),
+                  y.OffsetElement<XT>())) {
+            return;
           }
         }
         MatrixTimesVector<RCAT, RKIND, XT, YT>(
@@ -228,15 +453,12 @@ static inline void DoMatmul(
             x.OffsetElement<XT>(), y.OffsetElement<YT>());
         return;
       } else { // V*M -> V
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-2 SGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-2 DGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-2 CGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-2 ZGEMV(y,x)
+        if constexpr (std::is_same_v<XT, YT> &&
+            std::is_same_v<XT, WriteResult>) {
+          if (BlasMatrixTimesVector<true>(result.template OffsetElement<XT>(),
+                  n, extent[0], y.OffsetElement<XT>(),
+                  x.OffsetElement<XT>())) {
+            return;
           }
         }
         VectorTimesMatrix<RCAT, RKIND, XT, YT>(
@@ -256,6 +256,10 @@ void ExternalFileUnit::FlushAll(IoErrorHandler &handler) {
   }
 }
 
+// Unformatted output of at least this many bytes is not buffered; this
+// avoids copying large arrays (e.g., checkpoints) into the frame.
+static constexpr std::size_t minDirectWriteBytes{256 * 1024};
+
 static void SwapEndianness(
     char *data, std::size_t bytes, std::size_t elementBytes) {
   if (elementBytes > 1) {
@@ -311,12 +315,29 @@ bool ExternalFileUnit::Emit(const char *data, std::size_t bytes,
     return false;
   }
   CheckDirectAccess(handler);
+  if (bytes >= minDirectWriteBytes &&
+      positionInRecord <= furthestPositionInRecord &&
+      isUnformatted.value_or(false) && !swapEndianness_ && mayPosition()) {
+    // Large unformatted data are written directly from the program's memory
+    // rather than copied into the frame.  The frame then begins after them,
+    // and the record may begin before the frame.
+    Discard(handler);
+    std::int64_t recordStart{frameOffsetInFile_ + recordOffsetInFrame_};
+    std::int64_t at{recordStart + positionInRecord};
+    std::size_t put{Write(at, data, bytes, handler)};
+    frameOffsetInFile_ = at + put;
+    recordOffsetInFrame_ = recordStart - frameOffsetInFile_;
+    positionInRecord += put;
+    furthestPositionInRecord =
+        std::max(furthestPositionInRecord, positionInRecord);
+    return put == bytes;
+  }
   WriteFrame(frameOffsetInFile_, recordOffsetInFrame_ + furthestAfter, handler);
   if (positionInRecord > furthestPositionInRecord) {
-    std::memset(Frame() + recordOffsetInFrame_ + furthestPositionInRecord, ' ',
-        positionInRecord - furthestPositionInRecord);
+    std::memset(Frame() + (recordOffsetInFrame_ + furthestPositionInRecord),
+        ' ', positionInRecord - furthestPositionInRecord);
   }
-  char *to{Frame() + recordOffsetInFrame_ + positionInRecord};
+  char *to{Frame() + (recordOffsetInFrame_ + positionInRecord)};
   std::memcpy(to, data, bytes);
   if (swapEndianness_) {
     SwapEndianness(to, bytes, elementBytes);
@@ -338,7 +359,8 @@ bool ExternalFileUnit::Receive(char *data, std::size_t bytes,
         static_cast<std::intmax_t>(*recordLength));
     return false;
   }
-  auto need{recordOffsetInFrame_ + furthestAfter};
+  std::size_t need{
+      static_cast<std::size_t>(recordOffsetInFrame_ + furthestAfter)};
   auto got{ReadFrame(frameOffsetInFile_, need, handler)};
   if (got >= need) {
     std::memcpy(data, Frame() + recordOffsetInFrame_ + positionInRecord, bytes);
@@ -408,7 +430,7 @@ const char *ExternalFileUnit::FrameNextInput(
 bool ExternalFileUnit::SetVariableFormattedRecordLength() {
   if (recordLength || access == Access::Direct) {
     return true;
-  } else if (FrameLength() > recordOffsetInFrame_) {
+  } else if (static_cast<std::int64_t>(FrameLength()) > recordOffsetInFrame_) {
     const char *record{Frame() + recordOffsetInFrame_};
     std::size_t bytes{FrameLength() - recordOffsetInFrame_};
     if (const char *nl{
@@ -483,11 +505,11 @@ void ExternalFileUnit::FinishReadingRecord(IoErrorHandler &handler) {
         frameOffsetInFile_ += recordOffsetInFrame_;
         recordOffsetInFrame_ = sizeof(std::uint32_t);
       } else { // formatted
-        if (FrameLength() > recordOffsetInFrame_ &&
+        if (static_cast<std::int64_t>(FrameLength()) > recordOffsetInFrame_ &&
             Frame()[recordOffsetInFrame_] == '\r') {
           ++recordOffsetInFrame_;
         }
-        if (FrameLength() > recordOffsetInFrame_ &&
+        if (static_cast<std::int64_t>(FrameLength()) > recordOffsetInFrame_ &&
             Frame()[recordOffsetInFrame_] == '\n') {
           ++recordOffsetInFrame_;
         }
@@ -520,7 +542,7 @@ bool ExternalFileUnit::AdvanceRecord(IoErrorHandler &handler) {
         // Pad remainder of fixed length record
         WriteFrame(
             frameOffsetInFile_, recordOffsetInFrame_ + *openRecl, handler);
-        std::memset(Frame() + recordOffsetInFrame_ + furthestPositionInRecord,
+        std::memset(Frame() + (recordOffsetInFrame_ + furthestPositionInRecord),
             isUnformatted.value_or(false) ? 0 : ' ',
             *openRecl - furthestPositionInRecord);
         furthestPositionInRecord = *openRecl;
@@ -539,9 +561,17 @@ bool ExternalFileUnit::AdvanceRecord(IoErrorHandler &handler) {
             Emit(reinterpret_cast<const char *>(&length), sizeof length,
                 sizeof length, handler);
         positionInRecord = 0;
-        ok = ok &&
-            Emit(reinterpret_cast<const char *>(&length), sizeof length,
-                sizeof length, handler);
+        if (recordOffsetInFrame_ < 0) {
+          // The header is no longer in the frame (see Emit())
+          ok = ok &&
+              Write(frameOffsetInFile_ + recordOffsetInFrame_,
+                  reinterpret_cast<const char *>(&length), sizeof length,
+                  handler) == sizeof length;
+        } else {
+          ok = ok &&
+              Emit(reinterpret_cast<const char *>(&length), sizeof length,
+                  sizeof length, handler);
+        }
       } else {
         // Unformatted stream: nothing to do
       }
@@ -661,6 +691,43 @@ void ExternalFileUnit::SetPosition(std::int64_t pos, IoErrorHandler &handler) {
   BeginRecord();
 }
 
+int ExternalFileUnit::BeginAsynchronousTransfer(Direction direction,
+    std::int64_t rec, char *data, std::size_t bytes, IoErrorHandler &handler) {
+  CriticalSection critical{lock_};
+  if (!mayAsynchronous()) {
+    handler.SignalError(
+        "Asynchronous transfer on unit %d without ASYNCHRONOUS='YES'",
+        unitNumber());
+  } else if (access != Access::Direct || !isUnformatted.value_or(false)) {
+    handler.SignalError("Asynchronous transfer on unit %d, which is not "
+                        "connected for unformatted direct access",
+        unitNumber());
+  } else if (swapEndianness_) {
+    handler.SignalError(
+        "Asynchronous transfer on unit %d with byte swapping (CONVERT=)",
+        unitNumber());
+  } else if (rec < 1) {
+    handler.SignalError("REC=%jd is invalid for an asynchronous transfer",
+        static_cast<std::intmax_t>(rec));
+  } else if (direction == Direction::Input && !mayRead()) {
+    handler.SignalError(IostatReadFromWriteOnly);
+  } else if (direction == Direction::Output && !mayWrite()) {
+    handler.SignalError(IostatWriteToReadOnly);
+  } else {
+    RUNTIME_CHECK(handler, openRecl.has_value());
+    // The buffer must hold neither output for nor stale input from
+    // the records of the transfer.
+    Discard(handler);
+    std::int64_t at{(rec - 1) * *openRecl};
+    if (direction == Direction::Input) {
+      return ReadAsynchronously(at, data, bytes, handler);
+    } else {
+      return WriteAsynchronously(at, data, bytes, handler);
+    }
+  }
+  return -1;
+}
+
 void ExternalFileUnit::EndIoStatement() {
   io_.reset();
   u_.emplace<std::monostate>();
@@ -675,7 +742,7 @@ void ExternalFileUnit::BeginSequentialVariableUnformattedInputRecord(
   // Try to emit informative errors to help debug corrupted files.
   const char *error{nullptr};
   if (got < need) {
-    if (got == recordOffsetInFrame_) {
+    if (static_cast<std::int64_t>(got) == recordOffsetInFrame_) {
       handler.SignalEnd();
     } else {
       error = "Unformatted variable-length sequential file input failed at "
@@ -92,6 +92,11 @@ public:
   void Rewind(IoErrorHandler &);
   void EndIoStatement();
   void SetPosition(std::int64_t, IoErrorHandler &); // zero-based
+  // Starts an asynchronous transfer of unformatted data to or from
+  // consecutive records of a direct access file, beginning with record
+  // number "rec"; returns its identifier for WAIT, or -1 after an error.
+  int BeginAsynchronousTransfer(Direction, std::int64_t rec, char *,
+      std::size_t, IoErrorHandler &);
   std::int64_t InquirePos() const {
     // 12.6.2.11 defines POS=1 as the beginning of file
     return frameOffsetInFile_ + 1;
@@ -142,7 +147,9 @@ private:
   // multi-record CHARACTER value with a "r*" repeat count.  So we
   // manage the frame and the current record therein separately.
   std::int64_t frameOffsetInFile_{0};
-  std::size_t recordOffsetInFrame_{0}; // of currentRecordNumber
+  // Can be negative when large unformatted output has bypassed the frame;
+  // see Emit().
+  std::int64_t recordOffsetInFrame_{0}; // of currentRecordNumber
 
   bool swapEndianness_{false};
 
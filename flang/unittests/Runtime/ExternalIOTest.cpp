@@ -17,8 +17,10 @@
 #include "flang/Runtime/main.h"
 #include "flang/Runtime/stop.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cstring>
 #include <string_view>
+#include <vector>
 
 using namespace Fortran::runtime;
 using namespace Fortran::runtime::io;
@@ -335,6 +337,200 @@ TEST(ExternalIOTests, TestSequentialVariableUnformatted) {
       << "EndIoStatement() for Close";
 }
 
+TEST(ExternalIOTests, TestSequentialLargeUnformatted) {
+  // OPEN(NEWUNIT=unit,ACCESS='SEQUENTIAL',ACTION='READWRITE',&
+  //   FORM='UNFORMATTED',STATUS='SCRATCH')
+  auto *io{IONAME(BeginOpenNewUnit)(__FILE__, __LINE__)};
+  ASSERT_TRUE(IONAME(SetAccess)(io, "SEQUENTIAL", 10))
+      << "SetAccess(SEQUENTIAL)";
+  ASSERT_TRUE(IONAME(SetAction)(io, "READWRITE", 9)) << "SetAction(READWRITE)";
+  ASSERT_TRUE(IONAME(SetForm)(io, "UNFORMATTED", 11)) << "SetForm(UNFORMATTED)";
+  ASSERT_TRUE(IONAME(SetStatus)(io, "SCRATCH", 7)) << "SetStatus(SCRATCH)";
+  int unit{-1};
+  ASSERT_TRUE(IONAME(GetNewUnit)(io, unit)) << "GetNewUnit()";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for OpenNewUnit";
+
+  // Arrays this large are written without being buffered
+  static constexpr int n{100000};
+  std::vector<std::int64_t> big(n);
+  for (int j{0}; j < n; ++j) {
+    big[j] = j;
+  }
+  static constexpr int records{3};
+  for (int j{1}; j <= records; ++j) {
+    // WRITE(UNIT=unit) j, BIG, -j, BIG(1:j)
+    std::int64_t head{j}, tail{-j};
+    io = IONAME(BeginUnformattedOutput)(unit, __FILE__, __LINE__);
+    ASSERT_TRUE(IONAME(OutputUnformattedBlock)(io,
+        reinterpret_cast<const char *>(&head), sizeof head, sizeof head))
+        << "OutputUnformattedBlock(head)";
+    ASSERT_TRUE(IONAME(OutputUnformattedBlock)(io,
+        reinterpret_cast<const char *>(big.data()), n * sizeof big[0],
+        sizeof big[0]))
+        << "OutputUnformattedBlock(big)";
+    ASSERT_TRUE(IONAME(OutputUnformattedBlock)(io,
+        reinterpret_cast<const char *>(&tail), sizeof tail, sizeof tail))
+        << "OutputUnformattedBlock(tail)";
+    ASSERT_TRUE(IONAME(OutputUnformattedBlock)(io,
+        reinterpret_cast<const char *>(big.data()), j * sizeof big[0],
+        sizeof big[0]))
+        << "OutputUnformattedBlock(big(1:j))";
+    ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+        << "EndIoStatement() for OutputUnformattedBlock";
+  }
+
+  auto readRecord{[&](int j) {
+    // READ(UNIT=unit) head, BIG, tail, BIG(1:j); check
+    std::int64_t head{0}, tail{0};
+    std::vector<std::int64_t> got(n + j, -1);
+    io = IONAME(BeginUnformattedInput)(unit, __FILE__, __LINE__);
+    ASSERT_TRUE(IONAME(InputUnformattedBlock)(io,
+        reinterpret_cast<char *>(&head), sizeof head, sizeof head))
+        << "InputUnformattedBlock(head)";
+    ASSERT_TRUE(IONAME(InputUnformattedBlock)(io,
+        reinterpret_cast<char *>(got.data()), n * sizeof got[0], sizeof got[0]))
+        << "InputUnformattedBlock(big)";
+    ASSERT_TRUE(IONAME(InputUnformattedBlock)(io,
+        reinterpret_cast<char *>(&tail), sizeof tail, sizeof tail))
+        << "InputUnformattedBlock(tail)";
+    ASSERT_TRUE(IONAME(InputUnformattedBlock)(io,
+        reinterpret_cast<char *>(got.data() + n), j * sizeof got[0],
+        sizeof got[0]))
+        << "InputUnformattedBlock(big(1:j))";
+    ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+        << "EndIoStatement() for InputUnformattedBlock";
+    ASSERT_EQ(head, j) << "record " << j;
+    ASSERT_EQ(tail, -j) << "record " << j;
+    for (int k{0}; k < n + j; ++k) {
+      ASSERT_EQ(got[k], k < n ? k : k - n)
+          << "Read back [" << k << "] from record " << j;
+    }
+  }};
+
+  // REWIND(UNIT=unit)
+  io = IONAME(BeginRewind)(unit, __FILE__, __LINE__);
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Rewind";
+  for (int j{1}; j <= records; ++j) {
+    readRecord(j);
+  }
+  // BACKSPACE(UNIT=unit) relies on the record footers
+  for (int j{records}; j >= 1; --j) {
+    io = IONAME(BeginBackspace)(unit, __FILE__, __LINE__);
+    ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+        << "EndIoStatement() for Backspace (before read)";
+    readRecord(j);
+    io = IONAME(BeginBackspace)(unit, __FILE__, __LINE__);
+    ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+        << "EndIoStatement() for Backspace (after read)";
+  }
+
+  // CLOSE(UNIT=unit,STATUS='DELETE')
+  io = IONAME(BeginClose)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(SetStatus)(io, "DELETE", 6)) << "SetStatus(DELETE)";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Close";
+}
+
+TEST(ExternalIOTests, TestDirectAsynchronousUnformatted) {
+  // OPEN(NEWUNIT=unit,ACCESS='DIRECT',ACTION='READWRITE',&
+  //   FORM='UNFORMATTED',RECL=8*n,ASYNCHRONOUS='YES',STATUS='SCRATCH')
+  static constexpr int n{1000};
+  auto *io{IONAME(BeginOpenNewUnit)(__FILE__, __LINE__)};
+  ASSERT_TRUE(IONAME(SetAccess)(io, "DIRECT", 6)) << "SetAccess(DIRECT)";
+  ASSERT_TRUE(IONAME(SetAction)(io, "READWRITE", 9)) << "SetAction(READWRITE)";
+  ASSERT_TRUE(IONAME(SetForm)(io, "UNFORMATTED", 11)) << "SetForm(UNFORMATTED)";
+  ASSERT_TRUE(IONAME(SetRecl)(io, n * sizeof(std::int64_t))) << "SetRecl()";
+  ASSERT_TRUE(IONAME(SetAsynchronous)(io, "YES", 3)) << "SetAsynchronous(YES)";
+  ASSERT_TRUE(IONAME(SetStatus)(io, "SCRATCH", 7)) << "SetStatus(SCRATCH)";
+  int unit{-1};
+  ASSERT_TRUE(IONAME(GetNewUnit)(io, unit)) << "GetNewUnit()";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for OpenNewUnit";
+
+  // WRITE(UNIT=unit,REC=j,ASYNCHRONOUS='YES',ID=id(j)) out(:,j), two
+  // records at a time
+  static constexpr int records{20};
+  std::vector<std::int64_t> out(n * records);
+  for (int j{0}; j < n * records; ++j) {
+    out[j] = j;
+  }
+  AsynchronousId id[records];
+  for (int j{0}; j < records; j += 2) {
+    id[j] = IONAME(BeginAsynchronousOutput)(unit, j + 1,
+        reinterpret_cast<const char *>(&out[j * n]), 2 * n * sizeof out[0],
+        __FILE__, __LINE__);
+  }
+  // WAIT(UNIT=unit,ID=id(1)); WAIT(UNIT=unit)
+  io = IONAME(BeginWait)(unit, id[0]);
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Wait";
+  io = IONAME(BeginWaitAll)(unit);
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for WaitAll";
+
+  // READ(UNIT=unit,REC=j) in(:,j), synchronously
+  std::vector<std::int64_t> in(n * records, -1);
+  for (int j{records}; j >= 1; --j) {
+    io = IONAME(BeginUnformattedInput)(unit, __FILE__, __LINE__);
+    ASSERT_TRUE(IONAME(SetRec)(io, j)) << "SetRec(" << j << ')';
+    ASSERT_TRUE(IONAME(InputUnformattedBlock)(io,
+        reinterpret_cast<char *>(&in[(j - 1) * n]), n * sizeof in[0],
+        sizeof in[0]))
+        << "InputUnformattedBlock()";
+    ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+        << "EndIoStatement() for InputUnformattedBlock";
+  }
+  ASSERT_EQ(in, out) << "synchronous READ after asynchronous WRITE";
+
+  // READ(UNIT=unit,REC=j,ASYNCHRONOUS='YES',ID=id(j)) in(:,j), after
+  // a buffered WRITE(UNIT=unit,REC=records) of the last record
+  std::int64_t last{-1};
+  io = IONAME(BeginUnformattedOutput)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(SetRec)(io, records)) << "SetRec()";
+  ASSERT_TRUE(IONAME(OutputUnformattedBlock)(
+      io, reinterpret_cast<const char *>(&last), sizeof last, sizeof last))
+      << "OutputUnformattedBlock()";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for OutputUnformattedBlock";
+  out[(records - 1) * n] = last;
+  std::fill(out.begin() + (records - 1) * n + 1, out.end(), 0); // padding
+  std::fill(in.begin(), in.end(), -1);
+  for (int j{0}; j < records; ++j) {
+    id[j] = IONAME(BeginAsynchronousInput)(unit, j + 1,
+        reinterpret_cast<char *>(&in[j * n]), n * sizeof in[0], __FILE__,
+        __LINE__);
+  }
+  // INQUIRE(UNIT=unit,ID=id(j),PENDING=pending) until it is false
+  for (int j{records - 1}; j >= 0; --j) {
+    bool pending{true};
+    while (pending) {
+      io = IONAME(BeginInquireUnit)(unit, __FILE__, __LINE__);
+      ASSERT_TRUE(IONAME(InquirePendingId)(io, id[j], pending))
+          << "InquirePendingId()";
+      ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+          << "EndIoStatement() for InquireUnit";
+    }
+  }
+  // INQUIRE(UNIT=unit,PENDING=pending)
+  bool pending{true};
+  io = IONAME(BeginInquireUnit)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(InquireLogical)(
+      io, HashInquiryKeyword("PENDING"), pending))
+      << "InquireLogical(PENDING)";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for InquireUnit";
+  ASSERT_FALSE(pending);
+  ASSERT_EQ(in, out) << "asynchronous READ";
+
+  // CLOSE(UNIT=unit,STATUS='DELETE')
+  io = IONAME(BeginClose)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(SetStatus)(io, "DELETE", 6)) << "SetStatus(DELETE)";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Close";
+}
+
 TEST(ExternalIOTests, TestDirectFormatted) {
   // OPEN(NEWUNIT=unit,ACCESS='DIRECT',ACTION='READWRITE',&
   //   FORM='FORMATTED',RECL=8,STATUS='SCRATCH')
@@ -9,10 +9,12 @@
 #include "flang/Runtime/matmul.h"
 #include "gtest/gtest.h"
 #include "tools.h"
+#include "../../runtime/environment.h"
 #include "flang/Runtime/allocatable.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
 #include "flang/Runtime/type-code.h"
+#include <complex>
 
 using namespace Fortran::runtime;
 using Fortran::common::TypeCategory;
@@ -96,3 +98,73 @@ TEST(Matmul, Basic) {
   EXPECT_TRUE(
       static_cast<bool>(*result.ZeroBasedIndexedElement<std::uint16_t>(3)));
 }
+
+// Compares the contiguous blocked and threaded kernels with a straightforward
+// computation, with extents that are not multiples of the tile sizes.
+template <TypeCategory CAT, int KIND, typename T>
+static void CheckLargeMatmul(int rows, int n, int cols) {
+  std::vector<T> xData(rows * n), yData(n * cols);
+  for (int j{0}; j < rows * n; ++j) {
+    xData[j] = static_cast<T>(j % 7 - 3);
+  }
+  for (int j{0}; j < n * cols; ++j) {
+    yData[j] = static_cast<T>(j % 5 - 2);
+  }
+  if constexpr (CAT == TypeCategory::Complex) {
+    for (int j{0}; j < n * cols; ++j) {
+      yData[j] += T{0, static_cast<typename T::value_type>(j % 3)};
+    }
+  }
+  auto x{MakeArray<CAT, KIND>(std::vector<int>{rows, n}, xData)};
+  auto y{MakeArray<CAT, KIND>(std::vector<int>{n, cols}, yData)};
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+  RTNAME(Matmul)(result, *x, *y, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 2);
+  ASSERT_EQ(result.GetDimension(0).Extent(), rows);
+  ASSERT_EQ(result.GetDimension(1).Extent(), cols);
+  for (int j{0}; j < cols; ++j) {
+    for (int i{0}; i < rows; ++i) {
+      T expect{};
+      for (int k{0}; k < n; ++k) {
+        expect += xData[i + k * rows] * yData[k + j * n];
+      }
+      // All values are small integers, so the sums are exact.
+      ASSERT_EQ(*result.ZeroBasedIndexedElement<T>(i + j * rows), expect)
+          << "at (" << i << ',' << j << ')';
+    }
+  }
+  result.Destroy();
+
+  // Vector*matrix products
+  auto v{MakeArray<CAT, KIND>(
+      std::vector<int>{n}, std::vector<T>(xData.begin(), xData.begin() + n))};
+  RTNAME(Matmul)(result, *v, *y, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 1);
+  ASSERT_EQ(result.GetDimension(0).Extent(), cols);
+  for (int j{0}; j < cols; ++j) {
+    T expect{};
+    for (int k{0}; k < n; ++k) {
+      expect += xData[k] * yData[k + j * n];
+    }
+    ASSERT_EQ(*result.ZeroBasedIndexedElement<T>(j), expect) << "at " << j;
+  }
+  result.Destroy();
+}
+
+TEST(Matmul, Blocked) {
+  CheckLargeMatmul<TypeCategory::Real, 8, double>(37, 53, 29);
+  CheckLargeMatmul<TypeCategory::Real, 4, float>(300, 301, 7);
+  CheckLargeMatmul<TypeCategory::Complex, 8, std::complex<double>>(
+      45, 70, 13);
+  CheckLargeMatmul<TypeCategory::Integer, 4, std::int32_t>(9, 600, 3);
+}
+
+TEST(Matmul, Threaded) {
+  int saveThreads{executionEnvironment.matmulThreads};
+  executionEnvironment.matmulThreads = 3;
+  CheckLargeMatmul<TypeCategory::Real, 8, double>(211, 170, 150);
+  CheckLargeMatmul<TypeCategory::Complex, 4, std::complex<float>>(
+      129, 100, 98);
+  executionEnvironment.matmulThreads = saveThreads;
+}
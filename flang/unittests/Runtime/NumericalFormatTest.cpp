@@ -11,9 +11,13 @@
 #include "flang/Runtime/io-api.h"
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <gtest/gtest.h>
 #include <tuple>
+#include <vector>
 
 using namespace Fortran::runtime;
 using namespace Fortran::runtime::io;
@@ -717,3 +721,146 @@ TEST(IOApiTests, FormatDoubleInputValues) {
                            << "', want " << want << ", got " << u.raw;
   }
 }
+
+//------------------------------------------------------------------------------
+/// Tests for array output and output throughput
+//------------------------------------------------------------------------------
+
+// Formats all of the elements of an array with one data transfer statement
+// into records of 'recordLength' characters.
+static std::string FormatArray(const Descriptor &array, const char *format,
+    std::size_t records, std::size_t recordLength) {
+  std::string buffer(records * recordLength, '?');
+  StaticDescriptor<1> staticDescriptor;
+  Descriptor &desc{staticDescriptor.descriptor()};
+  SubscriptValue extent[]{static_cast<SubscriptValue>(records)};
+  desc.Establish(TypeCode{CFI_type_char}, recordLength, buffer.data(), 1,
+      extent, CFI_attribute_pointer);
+  auto cookie{format ? IONAME(BeginInternalArrayFormattedOutput)(
+                           desc, format, std::strlen(format))
+                     : IONAME(BeginInternalArrayListOutput)(desc)};
+  EXPECT_TRUE(IONAME(OutputDescriptor)(cookie, array));
+  EXPECT_EQ(IONAME(EndIoStatement)(cookie), 0);
+  return buffer;
+}
+
+TEST(IOApiTests, NonContiguousArrayOutput) {
+  // Every other column of a 3x8 array, and the same values contiguously
+  std::array<double, 24> whole;
+  std::array<double, 12> packed;
+  for (int j{0}; j < 24; ++j) {
+    whole[j] = (j - 11.5) / 3;
+  }
+  for (int j{0}; j < 4; ++j) {
+    for (int k{0}; k < 3; ++k) {
+      packed[3 * j + k] = whole[6 * j + k];
+    }
+  }
+  StaticDescriptor<2> wholeStaticDescriptor, sectionStaticDescriptor,
+      packedStaticDescriptor;
+  Descriptor &wholeDesc{wholeStaticDescriptor.descriptor()};
+  Descriptor &section{sectionStaticDescriptor.descriptor()};
+  Descriptor &packedDesc{packedStaticDescriptor.descriptor()};
+  static const SubscriptValue wholeExtent[]{3, 8}, sectionExtent[]{3, 4};
+  wholeDesc.Establish(TypeCategory::Real, 8, whole.data(), 2, wholeExtent,
+      CFI_attribute_pointer);
+  packedDesc.Establish(TypeCategory::Real, 8, packed.data(), 2, sectionExtent);
+  section.Establish(TypeCategory::Real, 8, nullptr, 2, sectionExtent,
+      CFI_attribute_pointer);
+  static const SubscriptValue lowers[]{0, 0}, uppers[]{2, 7}, strides[]{1, 2};
+  ASSERT_EQ(
+      CFI_section(&section.raw(), &wholeDesc.raw(), lowers, uppers, strides),
+      0);
+  ASSERT_FALSE(section.IsContiguous());
+  for (const char *format : {"(3F10.4)", "(3ES12.4)", "(3G0)",
+           static_cast<const char *>(nullptr)}) {
+    std::string got{FormatArray(section, format, 4, 48)};
+    EXPECT_EQ(got, FormatArray(packedDesc, format, 4, 48))
+        << (format ? format : "list-directed");
+    EXPECT_EQ(got.find('?'), std::string::npos) << got;
+  }
+}
+
+template <typename REAL> static std::string FormatListDirected(REAL x) {
+  char buffer[32];
+  auto cookie{IONAME(BeginInternalListOutput)(buffer, sizeof buffer)};
+  if constexpr (sizeof x == 4) {
+    EXPECT_TRUE(IONAME(OutputReal32)(cookie, x));
+  } else {
+    EXPECT_TRUE(IONAME(OutputReal64)(cookie, x));
+  }
+  EXPECT_EQ(IONAME(EndIoStatement)(cookie), 0);
+  return std::string{buffer, sizeof buffer};
+}
+
+// List-directed output uses the shortest digit sequence that reads back to
+// the same value, choosing the closest one when there are several.
+TEST(IOApiTests, FormatShortestValues) {
+  static const std::tuple<double, const char *> doubleCases[]{
+      {0.1, " .1"},
+      {1.0 / 3, " .3333333333333333"},
+      {1.0e23, " 1.E+23"},
+      {5.3165205877497296e16, " 5.31652058774973E+16"},
+      {5.0e-324, " 5.E-324"},
+      {1.7976931348623157e308, " 1.7976931348623157E+308"},
+      {2.2250738585072014e-308, " 2.2250738585072014E-308"},
+      {9007199254740993.0, " 9.007199254740992E+15"},
+      {-123456.0, " -123456."},
+  };
+  for (auto const &[x, expect] : doubleCases) {
+    std::string got{FormatListDirected(x)};
+    EXPECT_TRUE(CompareFormattedStrings(expect, std::string{got}))
+        << "REAL(8) " << x << ": got '" << got << "', want '" << expect
+        << "'";
+  }
+  static const std::tuple<float, const char *> floatCases[]{
+      {0.3f, " .3"},
+      {1.0f / 3, " .33333334"},
+      {16777216.0f, " 1.6777216E+07"},
+      {3.4028235e38f, " 3.4028235E+38"},
+      {1.0e-45f, " 1.E-45"},
+  };
+  for (auto const &[x, expect] : floatCases) {
+    std::string got{FormatListDirected(x)};
+    EXPECT_TRUE(CompareFormattedStrings(expect, std::string{got}))
+        << "REAL(4) " << x << ": got '" << got << "', want '" << expect
+        << "'";
+  }
+}
+
+// Measures the throughput of formatted output of whole arrays.
+TEST(IOApiTests, FormattedOutputThroughput) {
+  static constexpr int numItems{1 << 18};
+  std::vector<double> reals(numItems);
+  std::vector<std::int32_t> integers(numItems);
+  for (int j{0}; j < numItems; ++j) {
+    // Values of random magnitudes between 1e-3 and 1e3
+    double scale{std::pow(10.0, (j * 2654435761u % 60001) / 10000.0 - 3)};
+    reals[j] = (j % 2 ? -scale : scale) * 3.14159;
+    integers[j] =
+        static_cast<std::int32_t>(j * 2654435761u % 2000001) - 1000000;
+  }
+  StaticDescriptor<1> realStaticDescriptor, integerStaticDescriptor;
+  Descriptor &realDesc{realStaticDescriptor.descriptor()};
+  Descriptor &integerDesc{integerStaticDescriptor.descriptor()};
+  static const SubscriptValue extent[]{numItems};
+  realDesc.Establish(TypeCategory::Real, 8, reals.data(), 1, extent);
+  integerDesc.Establish(TypeCategory::Integer, 4, integers.data(), 1, extent);
+
+  auto measure{[&](const char *name, const Descriptor &array,
+                   const char *format, int itemsPerRecord) {
+    auto start{std::chrono::steady_clock::now()};
+    FormatArray(array, format,
+        (numItems + itemsPerRecord - 1) / itemsPerRecord, 200);
+    std::chrono::duration<double> elapsed{
+        std::chrono::steady_clock::now() - start};
+    std::fprintf(stderr, "%-22s %8.1f ns/item\n", name,
+        elapsed.count() * 1e9 / numItems);
+  }};
+  measure("list-directed REAL(8)", realDesc, nullptr, 4);
+  measure("(8F12.5)", realDesc, "(8F12.5)", 8);
+  measure("(1P6E20.12)", realDesc, "(1P6E20.12)", 6);
+  measure("(6G0)", realDesc, "(6G0)", 6);
+  measure("list-directed INTEGER", integerDesc, nullptr, 8);
+  measure("(8I10)", integerDesc, "(8I10)", 8);
+}
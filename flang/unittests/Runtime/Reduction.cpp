@@ -544,3 +544,27 @@ TEST(Reductions, DotProduct) {
   EXPECT_FALSE(RTNAME(DotProductLogical)(
       *logicalVector2, *logicalVector1, __FILE__, __LINE__));
 }
+
+TEST(Reductions, DotProductLong) {
+  // Lengths that are not multiples of the number of partial sums
+  for (int n : {1, 7, 103}) {
+    std::vector<float> xData(n), yData(n);
+    std::vector<std::complex<double>> zData(n);
+    double expect{0};
+    std::complex<double> expectComplex{0};
+    for (int j{0}; j < n; ++j) {
+      xData[j] = j % 9 - 4;
+      yData[j] = j % 4 + 1;
+      zData[j] = {static_cast<double>(j % 3), static_cast<double>(j % 5)};
+      expect += xData[j] * yData[j];
+      expectComplex += std::conj(zData[j]) * zData[j];
+    }
+    auto x{MakeArray<TypeCategory::Real, 4>(std::vector<int>{n}, xData)};
+    auto y{MakeArray<TypeCategory::Real, 4>(std::vector<int>{n}, yData)};
+    EXPECT_EQ(RTNAME(DotProductReal4)(*x, *y, __FILE__, __LINE__), expect);
+    auto z{MakeArray<TypeCategory::Complex, 8>(std::vector<int>{n}, zData)};
+    std::complex<double> result;
+    RTNAME(CppDotProductComplex8)(result, *z, *z, __FILE__, __LINE__);
+    EXPECT_EQ(result, expectComplex);
+  }
+}
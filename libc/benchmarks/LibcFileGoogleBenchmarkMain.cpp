@@ -0,0 +1,108 @@
+//===-- Benchmark for the libc File abstraction ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the throughput of buffered writes through __llvm_libc::File when a
+// single stream is shared between threads, as happens with processes logging
+// to stderr. The platform functions discard the data so that only the cost of
+// buffering and locking is measured.
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/File/file.h"
+
+#include "benchmark/benchmark.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+using __llvm_libc::File;
+using __llvm_libc::FileLock;
+
+// Size of the stream buffer, the same as glibc's BUFSIZ.
+static constexpr size_t kBufferSize = 8192;
+
+// Number of writes performed under a single lock by the unlocked benchmarks.
+static constexpr size_t kBatchSize = 64;
+
+namespace {
+
+class NullFile : public File {
+  std::mutex Mutex;
+  char Buffer[kBufferSize];
+
+  static size_t nullWrite(File *, const void *, size_t Len) { return Len; }
+  static size_t nullWriteV(File *, const WriteChunk *Chunks, size_t Count) {
+    size_t Len = 0;
+    for (size_t I = 0; I < Count; ++I)
+      Len += Chunks[I].len;
+    return Len;
+  }
+  static size_t nullRead(File *, void *, size_t) { return 0; }
+  static int nullSeek(File *, long, int) { return 0; }
+  static int nullClose(File *) { return 0; }
+  static int nullFlush(File *) { return 0; }
+  static void lockFile(File *F) { static_cast<NullFile *>(F)->Mutex.lock(); }
+  static void unlockFile(File *F) {
+    static_cast<NullFile *>(F)->Mutex.unlock();
+  }
+
+public:
+  explicit NullFile(bool Vectored)
+      : File(&nullWrite, &nullRead, &nullSeek, &nullClose, &nullFlush,
+             &lockFile, &unlockFile, Buffer, kBufferSize, 0, false,
+             File::mode_flags("w"), Vectored ? &nullWriteV : nullptr) {}
+};
+
+// The stream shared by all the threads of a benchmark.
+NullFile &getFile(bool Vectored) {
+  static NullFile VectoredFile(true);
+  static NullFile PlainFile(false);
+  return Vectored ? VectoredFile : PlainFile;
+}
+
+void setCounters(benchmark::State &State, size_t WriteSize) {
+  State.SetBytesProcessed(State.iterations() * WriteSize);
+  State.SetItemsProcessed(State.iterations());
+}
+
+// Arguments are the size of each write and whether the platform supports
+// vectored writes.
+void applyArguments(benchmark::internal::Benchmark *Benchmark) {
+  for (int64_t Vectored : {0, 1})
+    for (int64_t WriteSize : {16, 128, 1024, 4096, 16384})
+      Benchmark->Args({WriteSize, Vectored});
+  Benchmark->ThreadRange(1, 16)->UseRealTime();
+}
+
+} // namespace
+
+// Every write takes the file lock.
+void BM_FileWrite(benchmark::State &State) {
+  const size_t WriteSize = State.range(0);
+  NullFile &F = getFile(State.range(1));
+  const std::vector<char> Data(WriteSize, 'x');
+  for (auto _ : State)
+    benchmark::DoNotOptimize(F.write(Data.data(), WriteSize));
+  setCounters(State, WriteSize);
+}
+BENCHMARK(BM_FileWrite)->Apply(applyArguments);
+
+// The file lock is taken once per batch of writes.
+void BM_FileWriteUnlocked(benchmark::State &State) {
+  const size_t WriteSize = State.range(0);
+  NullFile &F = getFile(State.range(1));
+  const std::vector<char> Data(WriteSize, 'x');
+  while (State.KeepRunningBatch(kBatchSize)) {
+    FileLock Lock(&F);
+    for (size_t I = 0; I < kBatchSize; ++I)
+      benchmark::DoNotOptimize(F.write_unlocked(Data.data(), WriteSize));
+  }
+  setCounters(State, WriteSize);
+}
+BENCHMARK(BM_FileWriteUnlocked)->Apply(applyArguments);
@@ -35,13 +35,18 @@ extern int bcmp(const void *, const void *, size_t);
 namespace llvm {
 namespace libc_benchmarks {
 
-static cl::opt<std::string>
-    StudyName("study-name", cl::desc("The name for this study"), cl::Required);
+static cl::opt<std::string> StudyName("study-name",
+                                      cl::desc("The name for this study"));
 
 static cl::opt<std::string>
     SizeDistributionName("size-distribution-name",
                          cl::desc("The name of the distribution to use"));
 
+static cl::opt<bool> ListSizeDistributions(
+    "list-size-distributions",
+    cl::desc("Print the names of the distributions available for the "
+             "function under test, one per line, and exit"));
+
 static cl::opt<bool>
     SweepMode("sweep-mode",
               cl::desc("If set, benchmark all sizes from 0 to sweep-max-size"));
@@ -248,6 +253,13 @@ void writeStudy(const Study &S) {
 }
 
 void main() {
+  if (ListSizeDistributions) {
+    for (const auto &MSD : BenchmarkSetup::getDistributions())
+      outs() << MSD.Name << "\n";
+    return;
+  }
+  if (StudyName.empty())
+    report_fatal_error("`--" + Twine(StudyName.ArgStr) + "` is required");
   checkRequirements();
   if (!isPowerOf2_32(AlignedAccess))
     report_fatal_error(AlignedAccess.ArgStr +
@@ -9,6 +9,7 @@
 #include "file.h"
 
 #include "src/__support/CPP/ArrayRef.h"
+#include "src/string/memory_utils/memcpy_implementations.h"
 
 #include <errno.h>
 #include <stdlib.h>
@@ -17,7 +18,10 @@ namespace __llvm_libc {
 
 size_t File::write(const void *data, size_t len) {
   FileLock lock(this);
+  return write_unlocked(data, len);
+}
 
+size_t File::write_unlocked(const void *data, size_t len) {
   if (!write_allowed()) {
     errno = EBADF;
     err = true;
@@ -31,53 +35,76 @@ size_t File::write(const void *data, size_t len) {
 
   const size_t used = pos;
   const size_t bufspace = bufsize - pos;
-  const size_t write_size = bufspace > len ? len : bufspace;
-  // TODO: Replace the for loop below with a call to internal memcpy.
-  for (size_t i = 0; i < write_size; ++i)
-    bufref[pos + i] = dataref[i];
-  pos += write_size;
-  if (len < bufspace)
+  if (len < bufspace) {
+    inline_memcpy(reinterpret_cast<char *>(bufref.data() + pos),
+                  reinterpret_cast<const char *>(dataref.data()), len);
+    pos += len;
+    return len;
+  }
+
+  // If the control reaches beyond this point, it means that |data| is more
+  // than what can be accomodated in the buffer. When the platform supports
+  // vectored writes, or when |data| would not fit even in an empty buffer, the
+  // buffered bytes and |data| are written out directly from where they are
+  // instead of being copied over to the buffer first.
+  if (platform_writev != nullptr || len >= bufsize) {
+    size_t bytes_written = write_through(data, len);
+    if (bytes_written < used + len) {
+      err = true;
+      // If less bytes were written than expected, then there are two
+      // possibilities.
+      // 1. None of the bytes from |data| were flushed out.
+      if (bytes_written <= used)
+        return 0;
+      // 2. Some of the bytes from |data| were written
+      return bytes_written - used;
+    }
     return len;
+  }
 
-  // If the control reaches beyond this point, it means that |data|
-  // is more than what can be accomodated in the buffer. So, we first
-  // flush out the buffer.
+  // Fill up the buffer, flush it out and buffer the remaining bytes of |data|,
+  // which fit in the now empty buffer.
+  inline_memcpy(reinterpret_cast<char *>(bufref.data() + pos),
+                reinterpret_cast<const char *>(dataref.data()), bufspace);
   size_t bytes_written = platform_write(this, buf, bufsize);
   pos = 0; // Buffer is now empty so reset pos to the beginning.
   if (bytes_written < bufsize) {
     err = true;
-    // If less bytes were written than expected, then there are two
-    // possibilities.
-    // 1. None of the bytes from |data| were flushed out.
     if (bytes_written <= used)
       return 0;
-    // 2. Some of the bytes from |data| were written
     return bytes_written - used;
   }
 
-  // If the remaining bytes from |data| can fit in the buffer, write
-  // into it. Else, write it directly to the platform stream.
-  size_t remaining = len - write_size;
-  if (remaining <= len) {
-    // TODO: Replace the for loop below with a call to internal memcpy.
-    for (size_t i = 0; i < remaining; ++i)
-      bufref[i] = dataref[i];
-    pos += remaining;
-    return len;
-  }
+  const size_t remaining = len - bufspace;
+  inline_memcpy(reinterpret_cast<char *>(bufref.data()),
+                reinterpret_cast<const char *>(dataref.data() + bufspace),
+                remaining);
+  pos = remaining;
+  return len;
+}
 
-  size_t transferred =
-      platform_write(this, dataref.data() + write_size, remaining);
-  if (transferred < remaining) {
-    err = true;
-    return write_size + transferred;
+size_t File::write_through(const void *data, size_t len) {
+  const size_t used = pos;
+  pos = 0; // The buffer is emptied whatever the outcome.
+  if (platform_writev != nullptr) {
+    const WriteChunk chunks[2] = {{buf, used}, {data, len}};
+    return used == 0 ? platform_writev(this, chunks + 1, 1)
+                     : platform_writev(this, chunks, 2);
   }
-  return len;
+  if (used > 0) {
+    size_t bytes_written = platform_write(this, buf, used);
+    if (bytes_written < used)
+      return bytes_written;
+  }
+  return used + platform_write(this, data, len);
 }
 
 size_t File::read(void *data, size_t len) {
   FileLock lock(this);
+  return read_unlocked(data, len);
+}
 
+size_t File::read_unlocked(void *data, size_t len) {
   if (!read_allowed()) {
     errno = EBADF;
     err = true;
@@ -93,22 +120,22 @@ size_t File::read(void *data, size_t len) {
   // available_data is never a wrapped around value.
   size_t available_data = read_limit - pos;
   if (len <= available_data) {
-    // TODO: Replace the for loop below with a call to internal memcpy.
-    for (size_t i = 0; i < len; ++i)
-      dataref[i] = bufref[i + pos];
+    inline_memcpy(reinterpret_cast<char *>(dataref.data()),
+                  reinterpret_cast<const char *>(bufref.data() + pos), len);
     pos += len;
     return len;
   }
 
   // Copy all of the available data.
-  // TODO: Replace the for loop with a call to internal memcpy.
-  for (size_t i = 0; i < available_data; ++i)
-    dataref[i] = bufref[i + pos];
+  inline_memcpy(reinterpret_cast<char *>(dataref.data()),
+                reinterpret_cast<const char *>(bufref.data() + pos),
+                available_data);
   read_limit = pos = 0; // Reset the pointers.
 
   size_t to_fetch = len - available_data;
   if (to_fetch > bufsize) {
-    size_t fetched_size = platform_read(this, data, to_fetch);
+    size_t fetched_size =
+        platform_read(this, dataref.data() + available_data, to_fetch);
     if (fetched_size < to_fetch) {
       if (errno == 0)
         eof = true;
@@ -123,8 +150,8 @@ size_t File::read(void *data, size_t len) {
   size_t fetched_size = platform_read(this, buf, bufsize);
   read_limit += fetched_size;
   size_t transfer_size = fetched_size >= to_fetch ? to_fetch : fetched_size;
-  for (size_t i = 0; i < transfer_size; ++i)
-    dataref[i] = bufref[i];
+  inline_memcpy(reinterpret_cast<char *>(dataref.data() + available_data),
+                reinterpret_cast<const char *>(bufref.data()), transfer_size);
   pos += transfer_size;
   if (fetched_size < to_fetch) {
     if (errno == 0)
@@ -154,6 +181,10 @@ int File::seek(long offset, int whence) {
 
 int File::flush() {
   FileLock lock(this);
+  return flush_unlocked();
+}
+
+int File::flush_unlocked() {
   if (prev_op == FileOp::WRITE && pos > 0) {
     size_t transferred_size = platform_write(this, buf, pos);
     if (transferred_size < pos) {
@@ -22,7 +22,17 @@ public:
   using LockFunc = void(File *);
   using UnlockFunc = void(File *);
 
+  // A contiguous range of bytes to be written by a WriteVFunc.
+  struct WriteChunk {
+    const void *data;
+    size_t len;
+  };
+
   using WriteFunc = size_t(File *, const void *, size_t);
+  // Write the |count| chunks pointed to by |chunks| one after the other, in a
+  // single operation if the platform allows it, and return the total number of
+  // bytes written.
+  using WriteVFunc = size_t(File *, const WriteChunk *chunks, size_t count);
   using ReadFunc = size_t(File *, void *, size_t);
   using SeekFunc = int(File *, long, int);
   using CloseFunc = int(File *);
@@ -55,6 +65,10 @@ public:
 private:
   enum class FileOp : uint8_t { NONE, READ, WRITE, SEEK };
 
+  // Write out the buffered data followed by |len| bytes from |data| and empty
+  // the buffer. Returns the number of bytes written.
+  size_t write_through(const void *data, size_t len);
+
   // Platfrom specific functions which create new file objects should initialize
   // these fields suitably via the constructor. Typically, they should be simple
   // syscall wrappers for the corresponding functionality.
@@ -63,6 +77,9 @@ private:
   SeekFunc *platform_seek;
   CloseFunc *platform_close;
   FlushFunc *platform_flush;
+  // Optional. If not null, buffered data and data which does not fit in the
+  // buffer are written out together with a single call to this function.
+  WriteVFunc *platform_writev;
 
   // Platform specific functions to lock and unlock file for mutually exclusive
   // access from threads in a multi-threaded application.
@@ -112,10 +129,11 @@ public:
   constexpr File(WriteFunc *wf, ReadFunc *rf, SeekFunc *sf, CloseFunc *cf,
                  FlushFunc *ff, LockFunc *lf, UnlockFunc *ulf, void *buffer,
                  size_t buffer_size, int buffer_mode, bool owned,
-                 ModeFlags modeflags)
+                 ModeFlags modeflags, WriteVFunc *wvf = nullptr)
       : platform_write(wf), platform_read(rf), platform_seek(sf),
-        platform_close(cf), platform_flush(ff), platform_lock(lf),
-        platform_unlock(ulf), buf(buffer), bufsize(buffer_size),
+        platform_close(cf), platform_flush(ff), platform_writev(wvf),
+        platform_lock(lf), platform_unlock(ulf), buf(buffer),
+        bufsize(buffer_size),
         bufmode(buffer_mode), own_buf(owned), mode(modeflags), pos(0),
         prev_op(FileOp::NONE), read_limit(0), eof(false), err(false) {}
 
@@ -124,12 +142,14 @@ public:
   static void init(File *f, WriteFunc *wf, ReadFunc *rf, SeekFunc *sf,
                    CloseFunc *cf, FlushFunc *ff, LockFunc *lf, UnlockFunc *ulf,
                    void *buffer, size_t buffer_size, int buffer_mode,
-                   bool owned, ModeFlags modeflags) {
+                   bool owned, ModeFlags modeflags,
+                   WriteVFunc *wvf = nullptr) {
     f->platform_write = wf;
     f->platform_read = rf;
     f->platform_seek = sf;
     f->platform_close = cf;
     f->platform_flush = ff;
+    f->platform_writev = wvf;
     f->platform_lock = lf;
     f->platform_unlock = ulf;
     f->buf = reinterpret_cast<uint8_t *>(buffer);
@@ -155,6 +175,15 @@ public:
   // buffer is currently being used as a read buffer.
   int flush();
 
+  // Same as write, read and flush above but without locking the file. The
+  // caller is responsible for holding the file lock, for example with a
+  // FileLock, if the file can be accessed by other threads at the same time.
+  // Taking the lock once around a batch of operations avoids paying for it on
+  // each individual call.
+  size_t write_unlocked(const void *data, size_t len);
+  size_t read_unlocked(void *data, size_t len);
+  int flush_unlocked();
+
   // Sets the internal buffer to |buffer| with buffering mode |mode|.
   // |size| is the size of |buffer|. This new |buffer| is owned by the
   // stream only if |owned| is true.
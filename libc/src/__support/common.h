@@ -19,7 +19,18 @@
 #define LLVM_LIBC_FUNCTION_ATTR
 #endif
 
-#ifdef LLVM_LIBC_PUBLIC_PACKAGING
+// A function with multiple implementations selected at load time is built
+// once per variant with LLVM_LIBC_VARIANT set to the variant's suffix. Each
+// build then defines the internal function `name_<variant>` instead of the
+// entrypoint itself, which is provided by LLVM_LIBC_IFUNC below.
+#define LLVM_LIBC_VARIANT_NAME(name, variant)                                  \
+  LLVM_LIBC_VARIANT_NAME__CONCAT(name, variant)
+#define LLVM_LIBC_VARIANT_NAME__CONCAT(name, variant) name##_##variant
+
+#if defined(LLVM_LIBC_VARIANT)
+#define LLVM_LIBC_FUNCTION(type, name, arglist)                                \
+  type LLVM_LIBC_VARIANT_NAME(name, LLVM_LIBC_VARIANT) arglist
+#elif defined(LLVM_LIBC_PUBLIC_PACKAGING)
 #define LLVM_LIBC_FUNCTION(type, name, arglist)                                \
   LLVM_LIBC_FUNCTION_ATTR decltype(__llvm_libc::name)                          \
       __##name##_impl__ __asm__(#name);                                        \
@@ -29,6 +40,25 @@
 #define LLVM_LIBC_FUNCTION(type, name, arglist) type name arglist
 #endif
 
+// Declares the variant `name_<variant>` of function `name`. Variants are
+// hidden so that resolvers can refer to them without going through the GOT.
+#define LLVM_LIBC_DECLARE_VARIANT(name, variant)                               \
+  [[gnu::visibility("hidden")]] decltype(__llvm_libc::name)                    \
+      LLVM_LIBC_VARIANT_NAME(name, variant)
+
+// Defines the entrypoint `name` as an indirect function whose implementation
+// is returned by `resolver` when the program is loaded. `resolver` must have C
+// language linkage.
+#ifdef LLVM_LIBC_PUBLIC_PACKAGING
+#define LLVM_LIBC_IFUNC(name, resolver)                                        \
+  decltype(__llvm_libc::name) __##name##_impl__ __asm__(#name)                 \
+      __attribute__((ifunc(#resolver)));                                       \
+  decltype(__llvm_libc::name) name __attribute__((ifunc(#resolver)))
+#else
+#define LLVM_LIBC_IFUNC(name, resolver)                                        \
+  decltype(__llvm_libc::name) name __attribute__((ifunc(#resolver)))
+#endif
+
 namespace __llvm_libc {
 namespace internal {
 constexpr bool same_string(char const *lhs, char const *rhs) {
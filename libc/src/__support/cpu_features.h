@@ -0,0 +1,125 @@
+//===-- Runtime detection of CPU features -----------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_SUPPORT_CPU_FEATURES_H
+#define LLVM_LIBC_SRC_SUPPORT_CPU_FEATURES_H
+
+#include "src/__support/architectures.h"
+#include "src/__support/common.h"
+
+#include <stdint.h>
+
+// The functions in this file are meant to be called from ifunc resolvers.
+// Resolvers run while the dynamic loader is still processing relocations so
+// they must not depend on anything that needs relocating: everything here is
+// inline, does not touch global state and does not call into other functions.
+
+namespace __llvm_libc {
+namespace cpu_features {
+
+#if defined(LLVM_LIBC_ARCH_X86_64)
+
+// The x86-64 micro-architecture levels as defined by the x86-64 psABI. Each
+// level is a superset of the previous one. The memory function variants are
+// compiled with -march values implying these levels:
+// - V1 : -march=k8             (SSE2)
+// - V2 : -march=nehalem        (SSE4.2, POPCNT, ...)
+// - V3 : -march=haswell        (AVX2, BMI2, ...)
+// - V4 : -march=skylake-avx512 (AVX512F, AVX512BW, AVX512DQ, AVX512VL, ...)
+enum class X86Level { V1 = 1, V2 = 2, V3 = 3, V4 = 4 };
+
+struct X86Features {
+  X86Level level = X86Level::V1;
+  // Enhanced REP MOVSB/STOSB.
+  bool erms = false;
+  // Fast Short REP MOV.
+  bool fsrm = false;
+};
+
+namespace internal {
+
+struct CpuIdRegisters {
+  uint32_t eax, ebx, ecx, edx;
+};
+
+static inline CpuIdRegisters cpuid(uint32_t leaf, uint32_t subleaf = 0) {
+  CpuIdRegisters r;
+  LIBC_INLINE_ASM("cpuid"
+                  : "=a"(r.eax), "=b"(r.ebx), "=c"(r.ecx), "=d"(r.edx)
+                  : "a"(leaf), "c"(subleaf));
+  return r;
+}
+
+static inline uint64_t xgetbv(uint32_t xcr) {
+  uint32_t eax, edx;
+  LIBC_INLINE_ASM("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+static constexpr bool has_bits(uint32_t reg, uint32_t mask) {
+  return (reg & mask) == mask;
+}
+
+static constexpr uint32_t bit(unsigned index) { return uint32_t(1) << index; }
+
+} // namespace internal
+
+static inline X86Features get_x86_features() {
+  using namespace internal;
+  X86Features features;
+
+  const uint32_t max_leaf = cpuid(0).eax;
+  if (max_leaf < 1)
+    return features;
+  const CpuIdRegisters leaf1 = cpuid(1);
+  const CpuIdRegisters leaf7 = max_leaf >= 7 ? cpuid(7, 0) : CpuIdRegisters{};
+  const uint32_t max_ext_leaf = cpuid(0x80000000).eax;
+  const CpuIdRegisters ext1 =
+      max_ext_leaf >= 0x80000001 ? cpuid(0x80000001) : CpuIdRegisters{};
+
+  features.erms = has_bits(leaf7.ebx, bit(9));
+  features.fsrm = has_bits(leaf7.edx, bit(4));
+
+  // SSE3, SSSE3, CX16, SSE4.1, SSE4.2, POPCNT and LAHF/SAHF.
+  if (!has_bits(leaf1.ecx, bit(0) | bit(9) | bit(13) | bit(19) | bit(20) |
+                               bit(23)) ||
+      !has_bits(ext1.ecx, bit(0)))
+    return features;
+  features.level = X86Level::V2;
+
+  // The AVX register state must also be enabled by the OS, which is advertised
+  // through OSXSAVE and XCR0 (XMM and YMM state).
+  if (!has_bits(leaf1.ecx, bit(27)))
+    return features;
+  const uint64_t xcr0 = xgetbv(0);
+  constexpr uint64_t XCR0_AVX_STATE = 0x6;
+  constexpr uint64_t XCR0_AVX512_STATE = 0xE0;
+  if ((xcr0 & XCR0_AVX_STATE) != XCR0_AVX_STATE)
+    return features;
+
+  // FMA, MOVBE, AVX, F16C; LZCNT; BMI1, AVX2, BMI2.
+  if (!has_bits(leaf1.ecx, bit(12) | bit(22) | bit(28) | bit(29)) ||
+      !has_bits(ext1.ecx, bit(5)) ||
+      !has_bits(leaf7.ebx, bit(3) | bit(5) | bit(8)))
+    return features;
+  features.level = X86Level::V3;
+
+  // AVX512F, AVX512DQ, AVX512CD, AVX512BW, AVX512VL and the opmask/ZMM state.
+  if ((xcr0 & XCR0_AVX512_STATE) != XCR0_AVX512_STATE ||
+      !has_bits(leaf7.ebx, bit(16) | bit(17) | bit(28) | bit(30) | bit(31)))
+    return features;
+  features.level = X86Level::V4;
+  return features;
+}
+
+#endif // LLVM_LIBC_ARCH_X86_64
+
+} // namespace cpu_features
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_SUPPORT_CPU_FEATURES_H
@@ -22,28 +22,16 @@ namespace __llvm_libc {
 // small values. Large inputs have their range reduced using fast integer
 // arithmetic.
 LLVM_LIBC_FUNCTION(float, cosf, (float y)) {
+  if (likely(!sincosf_is_special(y)))
+    return cosf_fast_path(y);
+
   double x = y;
   double s;
   int n;
   const sincos_t *p = &SINCOSF_TABLE[0];
 
-  if (abstop12(y) < abstop12(PIO4)) {
-    double x2 = x * x;
-
-    if (unlikely(abstop12(y) < abstop12(as_float(0x39800000))))
-      return 1.0f;
-
-    return sinf_poly(x, x2, p, 1);
-  } else if (likely(abstop12(y) < abstop12(120.0f))) {
-    x = reduce_fast(x, p, &n);
-
-    // Setup the signs for sin and cos.
-    s = p->sign[n & 3];
-
-    if (n & 2)
-      p = &SINCOSF_TABLE[1];
-
-    return sinf_poly(x * s, x * x, p, n ^ 1);
+  if (abstop12(y) < abstop12(as_float(0x39800000))) {
+    return 1.0f;
   } else if (abstop12(y) < abstop12(INFINITY)) {
     uint32_t xi = as_uint32_bits(y);
     int sign = xi >> 31;
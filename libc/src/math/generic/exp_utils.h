@@ -9,6 +9,8 @@
 #ifndef LLVM_LIBC_SRC_MATH_EXP_UTILS_H
 #define LLVM_LIBC_SRC_MATH_EXP_UTILS_H
 
+#include "math_utils.h"
+
 #include <stdint.h>
 
 #define EXP2F_TABLE_BITS 5
@@ -28,6 +30,44 @@ struct Exp2fDataTable {
 
 extern const Exp2fDataTable exp2f_data;
 
+// Return true if expf(x) cannot be computed with expf_fast_path, i.e. when
+// |x| >= 88 or x is nan.
+static inline bool expf_is_special(float x) {
+  return (top12_bits(x) & 0x7ff) >= top12_bits(88.0f);
+}
+
+// Compute expf(x) for |x| < 88. This is the main path shared by expf and its
+// vector variants so that both return bit identical results.
+static inline float expf_fast_path(float x) {
+  // double_t for better performance on targets with FLT_EVAL_METHOD == 2.
+  double_t kd, xd, z, r, r2, y, s;
+  uint64_t ki, t;
+
+  xd = static_cast<double_t>(x);
+  // x*N/Ln2 = k + r with r in [-1/2, 1/2] and int k.
+  z = exp2f_data.invln2_scaled * xd;
+
+  // Round and convert z to int, the result is in [-150*N, 128*N] and
+  // ideally nearest int is used, otherwise the magnitude of r can be
+  // bigger which gives larger approximation error.
+  kd = static_cast<double>(z + exp2f_data.shift);
+  ki = as_uint64_bits(kd);
+  kd -= exp2f_data.shift;
+  r = z - kd;
+
+  // exp(x) = 2^(k/N) * 2^(r/N) ~= s *(C0*r^3 + C1*r^2 + C2*r + 1)
+  const double *c = exp2f_data.poly_scaled;
+  t = exp2f_data.tab[ki % N];
+  t += ki << (52 - EXP2F_TABLE_BITS);
+  s = as_double(t);
+  z = c[0] * r + c[1];
+  r2 = r * r;
+  y = c[2] * r + 1;
+  y = z * r2 + y;
+  y = y * s;
+  return static_cast<float>(y);
+}
+
 } // namespace __llvm_libc
 
 #endif // LLVM_LIBC_SRC_MATH_EXP_UTILS_H
@@ -7,12 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "src/math/logf.h"
-#include "common_constants.h" // Lookup table for (1/f) and log(f)
+#include "logf_utils.h"
 #include "src/__support/FPUtil/BasicOperations.h"
 #include "src/__support/FPUtil/FEnvImpl.h"
-#include "src/__support/FPUtil/FMA.h"
 #include "src/__support/FPUtil/FPBits.h"
-#include "src/__support/FPUtil/PolyEval.h"
 #include "src/__support/common.h"
 
 // This is an algorithm for log(x) in single precision which is correctly
@@ -51,7 +49,6 @@ namespace __llvm_libc {
 
 INLINE_FMA
 LLVM_LIBC_FUNCTION(float, logf, (float x)) {
-  constexpr double LOG_2 = 0x1.62e42fefa39efp-1;
   using FPBits = typename fputil::FPBits<float>;
   FPBits xbits(x);
 
@@ -108,25 +105,7 @@ LLVM_LIBC_FUNCTION(float, logf, (float x)) {
     m = -23;
   }
 
-  m += xbits.get_exponent();
-  // Set bits to 1.m
-  xbits.set_unbiased_exponent(0x7F);
-  int f_index = xbits.get_mantissa() >> 16;
-
-  FPBits f = xbits;
-  f.bits &= ~0x0000'FFFF;
-
-  double d = static_cast<float>(xbits) - static_cast<float>(f);
-  d *= ONE_OVER_F[f_index];
-
-  double extra_factor =
-      fputil::fma(static_cast<double>(m), LOG_2, LOG_F[f_index]);
-
-  double r = __llvm_libc::fputil::polyeval(
-      d, extra_factor, 0x1.fffffffffffacp-1, -0x1.fffffffef9cb2p-2,
-      0x1.5555513bc679ap-2, -0x1.fff4805ea441p-3, 0x1.930180dbde91ap-3);
-
-  return static_cast<float>(r);
+  return logf_eval(xbits, m);
 }
 
 } // namespace __llvm_libc
@@ -0,0 +1,79 @@
+//===-- Collection of utils for logf ----------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_GENERIC_LOGF_UTILS_H
+#define LLVM_LIBC_SRC_MATH_GENERIC_LOGF_UTILS_H
+
+#include "common_constants.h" // Lookup table for (1/f) and log(f)
+#include "src/__support/FPUtil/FMA.h"
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/__support/FPUtil/PolyEval.h"
+#include "src/__support/architectures.h"
+
+#include <stdint.h>
+
+namespace __llvm_libc {
+
+// Return true if logf(x) cannot be computed with logf_fast_path: x is zero,
+// negative, denormal, inf or nan, or x is one of the few inputs for which the
+// polynomial does not round correctly.
+static inline bool logf_is_special(float x) {
+  using FPBits = typename fputil::FPBits<float>;
+  const uint32_t x_u = FPBits(x).uintval();
+  if (x_u < FPBits::MIN_NORMAL || x_u > FPBits::MAX_NORMAL)
+    return true;
+  switch (x_u) {
+  case 0x41178febU: // x = 0x1.2f1fd6p+3f
+  case 0x4c5d65a5U: // x = 0x1.bacb4ap+25f
+  case 0x65d890d3U: // x = 0x1.b121a6p+76f
+  case 0x6f31a8ecU: // x = 0x1.6351d8p+95f
+  case 0x3f800001U: // x = 0x1.000002p+0f
+  case 0x500ffb03U: // x = 0x1.1ff606p+33f
+  case 0x7a17f30aU: // x = 0x1.2fe614p+117f
+  case 0x5cd69e88U: // x = 0x1.ad3d1p+58f
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Compute log(2^m * xbits) where xbits is a positive normal number.
+INLINE_FMA static inline float logf_eval(fputil::FPBits<float> xbits, int m) {
+  constexpr double LOG_2 = 0x1.62e42fefa39efp-1;
+  using FPBits = typename fputil::FPBits<float>;
+
+  m += xbits.get_exponent();
+  // Set bits to 1.m
+  xbits.set_unbiased_exponent(0x7F);
+  int f_index = xbits.get_mantissa() >> 16;
+
+  FPBits f = xbits;
+  f.bits &= ~0x0000'FFFF;
+
+  double d = static_cast<float>(xbits) - static_cast<float>(f);
+  d *= ONE_OVER_F[f_index];
+
+  double extra_factor =
+      fputil::fma(static_cast<double>(m), LOG_2, LOG_F[f_index]);
+
+  double r = __llvm_libc::fputil::polyeval(
+      d, extra_factor, 0x1.fffffffffffacp-1, -0x1.fffffffef9cb2p-2,
+      0x1.5555513bc679ap-2, -0x1.fff4805ea441p-3, 0x1.930180dbde91ap-3);
+
+  return static_cast<float>(r);
+}
+
+// Compute logf(x) for the inputs rejected by logf_is_special. This is shared
+// by logf and its vector variants so that both return bit identical results.
+INLINE_FMA static inline float logf_fast_path(float x) {
+  return logf_eval(fputil::FPBits<float>(x), 0);
+}
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_GENERIC_LOGF_UTILS_H
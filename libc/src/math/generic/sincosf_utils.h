@@ -137,6 +137,45 @@ static inline double reduce_large(uint32_t xi, int *np) {
   return x * PI63;
 }
 
+// Return true if sinf(y) and cosf(y) cannot be computed with sinf_fast_path
+// and cosf_fast_path: |y| is tiny, |y| >= 120 or y is inf or nan.
+static inline bool sincosf_is_special(float y) {
+  return abstop12(y) < abstop12(as_float(0x39800000)) ||
+         abstop12(y) >= abstop12(120.0f);
+}
+
+// Compute sinf(y) or cosf(y) for the inputs rejected by sincosf_is_special.
+// QUADRANT_OFFSET is 0 for sine and 1 for cosine. This is the main path shared
+// by sinf, cosf and their vector variants so that they return bit identical
+// results.
+template <int QUADRANT_OFFSET>
+static inline float sincosf_fast_path_impl(float y) {
+  double x = y;
+  int n;
+  const sincos_t *p = &SINCOSF_TABLE[0];
+
+  if (abstop12(y) < abstop12(PIO4))
+    return sinf_poly(x, x * x, p, QUADRANT_OFFSET);
+
+  x = reduce_fast(x, p, &n);
+
+  // Setup the signs for sin and cos.
+  double s = p->sign[n & 3];
+
+  if (n & 2)
+    p = &SINCOSF_TABLE[1];
+
+  return sinf_poly(x * s, x * x, p, n ^ QUADRANT_OFFSET);
+}
+
+static inline float sinf_fast_path(float y) {
+  return sincosf_fast_path_impl<0>(y);
+}
+
+static inline float cosf_fast_path(float y) {
+  return sincosf_fast_path_impl<1>(y);
+}
+
 } // namespace __llvm_libc
 
 #endif // LLVM_LIBC_SRC_MATH_SINCOSF_UTILS_H
@@ -22,32 +22,19 @@ namespace __llvm_libc {
 // small values. Large inputs have their range reduced using fast integer
 // arithmetic.
 LLVM_LIBC_FUNCTION(float, sinf, (float y)) {
+  if (likely(!sincosf_is_special(y)))
+    return sinf_fast_path(y);
+
   double x = y;
   double s;
   int n;
   const sincos_t *p = &SINCOSF_TABLE[0];
 
-  if (abstop12(y) < abstop12(PIO4)) {
-    s = x * x;
-
-    if (unlikely(abstop12(y) < abstop12(as_float(0x39800000)))) {
-      if (unlikely(abstop12(y) < abstop12(as_float(0x800000))))
-        // Force underflow for tiny y.
-        force_eval<float>(s);
-      return y;
-    }
-
-    return sinf_poly(x, s, p, 0);
-  } else if (likely(abstop12(y) < abstop12(120.0f))) {
-    x = reduce_fast(x, p, &n);
-
-    // Setup the signs for sin and cos.
-    s = p->sign[n & 3];
-
-    if (n & 2)
-      p = &SINCOSF_TABLE[1];
-
-    return sinf_poly(x * s, x * x, p, n);
+  if (abstop12(y) < abstop12(as_float(0x39800000))) {
+    if (unlikely(abstop12(y) < abstop12(as_float(0x800000))))
+      // Force underflow for tiny y.
+      force_eval<float>(x * x);
+    return y;
   } else if (abstop12(y) < abstop12(INFINITY)) {
     uint32_t xi = as_uint32_bits(y);
     int sign = xi >> 31;
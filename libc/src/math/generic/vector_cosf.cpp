@@ -0,0 +1,20 @@
+//===-- Vector variants of cosf -------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/vector_math.h"
+#include "sincosf_utils.h"
+#include "vector_utils.h"
+
+#include "src/__support/common.h"
+#include "src/math/cosf.h"
+
+namespace __llvm_libc {
+
+LLVM_LIBC_VECTOR_MATH_FUNCTIONS(cosf, sincosf_is_special, cosf_fast_path)
+
+} // namespace __llvm_libc
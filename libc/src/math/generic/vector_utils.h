@@ -0,0 +1,86 @@
+//===-- Utils for the vector variants of the math functions -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_GENERIC_VECTOR_UTILS_H
+#define LLVM_LIBC_SRC_MATH_GENERIC_VECTOR_UTILS_H
+
+#include "src/__support/architectures.h"
+#include "src/__support/common.h"
+#include "src/math/vector_math.h"
+
+#include <stddef.h>
+
+namespace __llvm_libc {
+
+// Apply a scalar math function to every lane of X and store it in RESULT.
+//
+// The lanes are first all computed with FAST_PATH, which must be branch free
+// enough for the compiler to if-convert and vectorize the loop. Lanes for which
+// IS_SPECIAL returns true are fed a harmless input instead (1.0f) and, if there
+// are any, are recomputed with the full scalar function SCALAR afterwards. This
+// way vectors of ordinary inputs are computed without calls while overflow,
+// nan, errno and rounding mode handling stay exactly those of SCALAR.
+//
+// This function is always inlined so that it is compiled with the target
+// features of the vector variant calling it. The vectors are passed by
+// reference because the ABI for passing them by value depends on those target
+// features.
+template <bool (*IS_SPECIAL)(float), float (*FAST_PATH)(float),
+          float (*SCALAR)(float), typename VectorType>
+[[gnu::always_inline]] static inline void vector_map(const VectorType &x,
+                                                     VectorType &result) {
+  constexpr size_t LANES = sizeof(VectorType) / sizeof(float);
+  bool has_special = false;
+  for (size_t i = 0; i < LANES; ++i) {
+    const bool special = IS_SPECIAL(x[i]);
+    has_special |= special;
+    result[i] = FAST_PATH(special ? 1.0f : x[i]);
+  }
+  if (unlikely(has_special)) {
+    for (size_t i = 0; i < LANES; ++i)
+      if (IS_SPECIAL(x[i]))
+        result[i] = SCALAR(x[i]);
+  }
+}
+
+} // namespace __llvm_libc
+
+// Define all the vector variants of NAME available on the target, see
+// src/math/vector_math.h.
+#if defined(LLVM_LIBC_ARCH_X86_64)
+#define LLVM_LIBC_VECTOR_MATH_FUNCTIONS(name, is_special, fast_path)           \
+  LLVM_LIBC_X86_SSE_VECTOR_ATTR                                                \
+  LLVM_LIBC_FUNCTION(VectorFloat4, _ZGVbN4v_##name, (VectorFloat4 x)) {        \
+    VectorFloat4 result;                                                       \
+    vector_map<is_special, fast_path, name>(x, result);                        \
+    return result;                                                             \
+  }                                                                            \
+  LLVM_LIBC_X86_AVX2_VECTOR_ATTR                                               \
+  LLVM_LIBC_FUNCTION(VectorFloat8, _ZGVdN8v_##name, (VectorFloat8 x)) {        \
+    VectorFloat8 result;                                                       \
+    vector_map<is_special, fast_path, name>(x, result);                        \
+    return result;                                                             \
+  }                                                                            \
+  LLVM_LIBC_X86_AVX512_VECTOR_ATTR                                             \
+  LLVM_LIBC_FUNCTION(VectorFloat16, _ZGVeN16v_##name, (VectorFloat16 x)) {     \
+    VectorFloat16 result;                                                      \
+    vector_map<is_special, fast_path, name>(x, result);                        \
+    return result;                                                             \
+  }
+#elif defined(LLVM_LIBC_ARCH_AARCH64)
+#define LLVM_LIBC_VECTOR_MATH_FUNCTIONS(name, is_special, fast_path)           \
+  LLVM_LIBC_FUNCTION(VectorFloat4, _ZGVnN4v_##name, (VectorFloat4 x)) {        \
+    VectorFloat4 result;                                                       \
+    vector_map<is_special, fast_path, name>(x, result);                        \
+    return result;                                                             \
+  }
+#else
+#define LLVM_LIBC_VECTOR_MATH_FUNCTIONS(name, is_special, fast_path)
+#endif
+
+#endif // LLVM_LIBC_SRC_MATH_GENERIC_VECTOR_UTILS_H
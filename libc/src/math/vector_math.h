@@ -0,0 +1,62 @@
+//===-- Implementation header for the vector math functions -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_VECTOR_MATH_H
+#define LLVM_LIBC_SRC_MATH_VECTOR_MATH_H
+
+#include "src/__support/architectures.h"
+
+// Vector variants of the single precision math functions. They follow the
+// vector function ABI so that the loop vectorizer can call them directly, see
+// -fveclib=LLVMLibc:
+//   _ZGV<isa><mask><lanes><params>_<name>
+// with <isa> being 'b' (SSE), 'd' (AVX2), 'e' (AVX-512) or 'n' (AdvSIMD), 'N'
+// for unmasked variants and 'v' for a single vector parameter.
+//
+// Every lane of the result is bit identical to the scalar function applied to
+// the corresponding lane of the input. Like their scalar counterparts, the x86
+// variants make use of FMA instructions.
+
+namespace __llvm_libc {
+
+#if defined(LLVM_LIBC_ARCH_X86_64)
+
+#define LLVM_LIBC_X86_SSE_VECTOR_ATTR __attribute__((target("fma")))
+#define LLVM_LIBC_X86_AVX2_VECTOR_ATTR __attribute__((target("avx2,fma")))
+#define LLVM_LIBC_X86_AVX512_VECTOR_ATTR                                       \
+  __attribute__((target("avx512f,fma")))
+
+typedef float VectorFloat4 __attribute__((vector_size(16)));
+typedef float VectorFloat8 __attribute__((vector_size(32)));
+typedef float VectorFloat16 __attribute__((vector_size(64)));
+
+#define LLVM_LIBC_DECLARE_VECTOR_MATH_FUNCTION(name)                           \
+  LLVM_LIBC_X86_SSE_VECTOR_ATTR VectorFloat4 _ZGVbN4v_##name(VectorFloat4 x);  \
+  LLVM_LIBC_X86_AVX2_VECTOR_ATTR VectorFloat8 _ZGVdN8v_##name(VectorFloat8 x); \
+  LLVM_LIBC_X86_AVX512_VECTOR_ATTR VectorFloat16 _ZGVeN16v_##name(             \
+      VectorFloat16 x)
+
+#elif defined(LLVM_LIBC_ARCH_AARCH64)
+
+typedef float VectorFloat4 __attribute__((vector_size(16)));
+
+#define LLVM_LIBC_DECLARE_VECTOR_MATH_FUNCTION(name)                           \
+  VectorFloat4 _ZGVnN4v_##name(VectorFloat4 x)
+
+#endif
+
+#ifdef LLVM_LIBC_DECLARE_VECTOR_MATH_FUNCTION
+LLVM_LIBC_DECLARE_VECTOR_MATH_FUNCTION(cosf);
+LLVM_LIBC_DECLARE_VECTOR_MATH_FUNCTION(expf);
+LLVM_LIBC_DECLARE_VECTOR_MATH_FUNCTION(logf);
+LLVM_LIBC_DECLARE_VECTOR_MATH_FUNCTION(sinf);
+#endif
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_VECTOR_MATH_H
@@ -1,4 +1,4 @@
-//===-- Implementation of fwrite and fwrite_unlocked ------------*- C++ -*-===//
+//===-- Implementation of fwrite ------------------------------------------===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -8,17 +8,12 @@
 
 #include "src/stdio/fwrite.h"
 #include "src/stdio/FILE.h"
+#include "src/stdio/fwrite_unlocked.h"
 #include "src/threads/mtx_lock.h"
 #include "src/threads/mtx_unlock.h"
 
 namespace __llvm_libc {
 
-size_t fwrite_unlocked(const void *__restrict ptr, size_t size, size_t nmeb,
-                       __llvm_libc::FILE *__restrict stream) {
-  return stream->write(stream, reinterpret_cast<const char *>(ptr),
-                       size * nmeb);
-}
-
 size_t fwrite(const void *__restrict ptr, size_t size, size_t nmeb,
               __llvm_libc::FILE *__restrict stream) {
   __llvm_libc::mtx_lock(&stream->lock);
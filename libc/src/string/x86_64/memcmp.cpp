@@ -0,0 +1,40 @@
+//===-- Load time dispatch of memcmp on x86-64 ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memcmp.h"
+#include "src/__support/common.h"
+#include "src/__support/cpu_features.h"
+
+namespace __llvm_libc {
+
+LLVM_LIBC_DECLARE_VARIANT(memcmp, x86_64_v1);
+LLVM_LIBC_DECLARE_VARIANT(memcmp, x86_64_v2);
+LLVM_LIBC_DECLARE_VARIANT(memcmp, x86_64_v3);
+LLVM_LIBC_DECLARE_VARIANT(memcmp, x86_64_v4);
+
+extern "C" {
+static decltype(&__llvm_libc::memcmp) __llvm_libc_memcmp_resolver() {
+  using namespace cpu_features;
+  const X86Features features = get_x86_features();
+  switch (features.level) {
+  case X86Level::V4:
+    return &memcmp_x86_64_v4;
+  case X86Level::V3:
+    return &memcmp_x86_64_v3;
+  case X86Level::V2:
+    return &memcmp_x86_64_v2;
+  case X86Level::V1:
+    break;
+  }
+  return &memcmp_x86_64_v1;
+}
+}
+
+LLVM_LIBC_IFUNC(memcmp, __llvm_libc_memcmp_resolver);
+
+} // namespace __llvm_libc
@@ -0,0 +1,43 @@
+//===-- Load time dispatch of memcpy on x86-64 ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memcpy.h"
+#include "src/__support/common.h"
+#include "src/__support/cpu_features.h"
+
+namespace __llvm_libc {
+
+LLVM_LIBC_DECLARE_VARIANT(memcpy, x86_64_v1);
+LLVM_LIBC_DECLARE_VARIANT(memcpy, x86_64_v2);
+LLVM_LIBC_DECLARE_VARIANT(memcpy, x86_64_v3);
+LLVM_LIBC_DECLARE_VARIANT(memcpy, x86_64_v4);
+LLVM_LIBC_DECLARE_VARIANT(memcpy, x86_64_v3_erms);
+LLVM_LIBC_DECLARE_VARIANT(memcpy, x86_64_v4_erms);
+
+extern "C" {
+static decltype(&__llvm_libc::memcpy) __llvm_libc_memcpy_resolver() {
+  using namespace cpu_features;
+  const X86Features features = get_x86_features();
+  // Large copies are faster with `rep movsb` when the CPU advertises ERMS.
+  switch (features.level) {
+  case X86Level::V4:
+    return features.erms ? &memcpy_x86_64_v4_erms : &memcpy_x86_64_v4;
+  case X86Level::V3:
+    return features.erms ? &memcpy_x86_64_v3_erms : &memcpy_x86_64_v3;
+  case X86Level::V2:
+    return &memcpy_x86_64_v2;
+  case X86Level::V1:
+    break;
+  }
+  return &memcpy_x86_64_v1;
+}
+}
+
+LLVM_LIBC_IFUNC(memcpy, __llvm_libc_memcpy_resolver);
+
+} // namespace __llvm_libc
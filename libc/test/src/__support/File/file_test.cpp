@@ -23,9 +23,12 @@ class StringFile : public __llvm_libc::File {
   char str[SIZE] = {0};
   size_t eof_marker;
   bool write_append;
+  size_t write_calls;
 
   static size_t str_read(__llvm_libc::File *f, void *data, size_t len);
   static size_t str_write(__llvm_libc::File *f, const void *data, size_t len);
+  static size_t str_writev(__llvm_libc::File *f, const WriteChunk *chunks,
+                           size_t count);
   static int str_seek(__llvm_libc::File *f, long offset, int whence);
   static int str_close(__llvm_libc::File *f) { return 0; }
   static int str_flush(__llvm_libc::File *f) { return 0; }
@@ -40,17 +43,17 @@ public:
       : __llvm_libc::File(&str_write, &str_read, &str_seek, &str_close,
                           &str_flush, &str_lock, &str_unlock, buffer, buflen,
                           bufmode, owned, modeflags),
-        pos(0), eof_marker(0), write_append(false) {
+        pos(0), eof_marker(0), write_append(false), write_calls(0) {
     if (modeflags & static_cast<ModeFlags>(__llvm_libc::File::OpenMode::APPEND))
       write_append = true;
   }
 
   void init(char *buffer, size_t buflen, int bufmode, bool owned,
-            ModeFlags modeflags) {
+            ModeFlags modeflags, bool vectored) {
     File::init(this, &str_write, &str_read, &str_seek, &str_close, &str_flush,
                &str_lock, &str_unlock, buffer, buflen, bufmode, owned,
-               modeflags);
-    pos = eof_marker = 0;
+               modeflags, vectored ? &str_writev : nullptr);
+    pos = eof_marker = write_calls = 0;
     if (modeflags & static_cast<ModeFlags>(__llvm_libc::File::OpenMode::APPEND))
       write_append = true;
     else
@@ -59,6 +62,8 @@ public:
 
   void reset() { pos = 0; }
   size_t get_pos() const { return pos; }
+  // Number of calls to the platform write functions.
+  size_t get_write_calls() const { return write_calls; }
   char *get_str() { return str; }
 
   // Use this method to prefill the file.
@@ -86,6 +91,7 @@ size_t StringFile::str_read(__llvm_libc::File *f, void *data, size_t len) {
 size_t StringFile::str_write(__llvm_libc::File *f, const void *data,
                              size_t len) {
   StringFile *sf = static_cast<StringFile *>(f);
+  ++sf->write_calls;
   if (sf->write_append)
     sf->pos = sf->eof_marker;
   if (sf->pos >= SIZE)
@@ -99,6 +105,21 @@ size_t StringFile::str_write(__llvm_libc::File *f, const void *data,
   return i;
 }
 
+size_t StringFile::str_writev(__llvm_libc::File *f, const WriteChunk *chunks,
+                              size_t count) {
+  StringFile *sf = static_cast<StringFile *>(f);
+  size_t written = 0;
+  for (size_t i = 0; i < count; ++i) {
+    size_t chunk_written = str_write(f, chunks[i].data, chunks[i].len);
+    written += chunk_written;
+    if (chunk_written < chunks[i].len)
+      break;
+  }
+  // A vectored write is a single platform call.
+  sf->write_calls -= count - 1;
+  return written;
+}
+
 int StringFile::str_seek(__llvm_libc::File *f, long offset, int whence) {
   StringFile *sf = static_cast<StringFile *>(f);
   if (whence == SEEK_SET)
@@ -111,9 +132,11 @@ int StringFile::str_seek(__llvm_libc::File *f, long offset, int whence) {
 }
 
 StringFile *new_string_file(char *buffer, size_t buflen, int bufmode,
-                            bool owned, const char *mode) {
+                            bool owned, const char *mode,
+                            bool vectored = false) {
   StringFile *f = reinterpret_cast<StringFile *>(malloc(sizeof(StringFile)));
-  f->init(buffer, buflen, bufmode, owned, __llvm_libc::File::mode_flags(mode));
+  f->init(buffer, buflen, bufmode, owned, __llvm_libc::File::mode_flags(mode),
+          vectored);
   return f;
 }
 
@@ -319,3 +342,104 @@ TEST(LlvmLibcFileTest, AppendUpdate) {
 
   ASSERT_EQ(f->close(), 0);
 }
+
+TEST(LlvmLibcFileTest, LargeWriteBypassesBuffer) {
+  const char data[] = "a write larger than the file buffer";
+  constexpr size_t FILE_BUFFER_SIZE = 8;
+  char file_buffer[FILE_BUFFER_SIZE];
+  StringFile *f = new_string_file(file_buffer, FILE_BUFFER_SIZE, 0, false, "w");
+
+  ASSERT_EQ(size_t(3), f->write("abc", 3));
+  EXPECT_EQ(f->get_pos(), size_t(0));
+  // The buffered bytes and |data| are written out, nothing is left buffered.
+  ASSERT_EQ(sizeof(data), f->write(data, sizeof(data)));
+  EXPECT_EQ(f->get_pos(), sizeof(data) + 3);
+  EXPECT_EQ(f->get_write_calls(), size_t(2));
+  MemoryView src1("abc", 3), dst1(f->get_str(), 3);
+  EXPECT_MEM_EQ(src1, dst1);
+  MemoryView src2(data, sizeof(data)), dst2(f->get_str() + 3, sizeof(data));
+  EXPECT_MEM_EQ(src2, dst2);
+  ASSERT_EQ(f->flush(), 0);
+  EXPECT_EQ(f->get_write_calls(), size_t(2));
+
+  ASSERT_EQ(f->close(), 0);
+}
+
+TEST(LlvmLibcFileTest, VectoredWrite) {
+  const char data[] = "hello, file";
+  constexpr size_t FILE_BUFFER_SIZE = sizeof(data) * 3 / 2;
+  char file_buffer[FILE_BUFFER_SIZE];
+  StringFile *f =
+      new_string_file(file_buffer, FILE_BUFFER_SIZE, 0, false, "w", true);
+
+  ASSERT_EQ(sizeof(data), f->write(data, sizeof(data)));
+  EXPECT_EQ(f->get_pos(), size_t(0));
+  // The second write does not fit in the buffer. The buffered data and the new
+  // data are written out with a single vectored write.
+  ASSERT_EQ(sizeof(data), f->write(data, sizeof(data)));
+  EXPECT_EQ(f->get_pos(), 2 * sizeof(data));
+  EXPECT_EQ(f->get_write_calls(), size_t(1));
+  MemoryView src1(data, sizeof(data)), dst1(f->get_str(), sizeof(data));
+  EXPECT_MEM_EQ(src1, dst1);
+  MemoryView src2(data, sizeof(data)),
+      dst2(f->get_str() + sizeof(data), sizeof(data));
+  EXPECT_MEM_EQ(src2, dst2);
+  // Nothing is left to flush.
+  ASSERT_EQ(f->flush(), 0);
+  EXPECT_EQ(f->get_write_calls(), size_t(1));
+
+  ASSERT_EQ(f->close(), 0);
+}
+
+TEST(LlvmLibcFileTest, Unlocked) {
+  const char data[] = "hello, file";
+  constexpr size_t FILE_BUFFER_SIZE = sizeof(data) * 3;
+  char file_buffer[FILE_BUFFER_SIZE];
+  StringFile *f =
+      new_string_file(file_buffer, FILE_BUFFER_SIZE, 0, false, "w+");
+
+  {
+    __llvm_libc::FileLock lock(f);
+    ASSERT_EQ(sizeof(data), f->write_unlocked(data, sizeof(data)));
+    ASSERT_EQ(sizeof(data), f->write_unlocked(data, sizeof(data)));
+    EXPECT_EQ(f->get_pos(), size_t(0));
+    ASSERT_EQ(f->flush_unlocked(), 0);
+    EXPECT_EQ(f->get_pos(), 2 * sizeof(data));
+  }
+
+  ASSERT_EQ(f->seek(0, SEEK_SET), 0);
+  char read_data[2 * sizeof(data)];
+  {
+    __llvm_libc::FileLock lock(f);
+    ASSERT_EQ(f->read_unlocked(read_data, sizeof(read_data)),
+              sizeof(read_data));
+  }
+  MemoryView src1(data, sizeof(data)), dst1(read_data, sizeof(data));
+  EXPECT_MEM_EQ(src1, dst1);
+  MemoryView src2(data, sizeof(data)),
+      dst2(read_data + sizeof(data), sizeof(data));
+  EXPECT_MEM_EQ(src2, dst2);
+
+  ASSERT_EQ(f->close(), 0);
+}
+
+TEST(LlvmLibcFileTest, ReadAcrossBuffer) {
+  const char initial_content[] = "1234567890987654321";
+  constexpr size_t FILE_BUFFER_SIZE = 4;
+  char file_buffer[FILE_BUFFER_SIZE];
+  StringFile *f = new_string_file(file_buffer, FILE_BUFFER_SIZE, 0, false, "r");
+  f->reset_and_fill(initial_content, sizeof(initial_content));
+
+  char read_data[sizeof(initial_content)];
+  ASSERT_EQ(size_t(3), f->read(read_data, 3));
+  // One byte comes from the buffer, the next one from a newly fetched buffer.
+  ASSERT_EQ(size_t(2), f->read(read_data + 3, 2));
+  // Three bytes come from the buffer, the others are read directly.
+  ASSERT_EQ(sizeof(initial_content) - 5,
+            f->read(read_data + 5, sizeof(initial_content) - 5));
+  MemoryView src(initial_content, sizeof(initial_content)),
+      dst(read_data, sizeof(initial_content));
+  EXPECT_MEM_EQ(src, dst);
+
+  ASSERT_EQ(f->close(), 0);
+}
@@ -0,0 +1,48 @@
+//===-- Unittests for cpu_features ----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/architectures.h"
+#include "src/__support/cpu_features.h"
+#include "utils/UnitTest/Test.h"
+
+namespace __llvm_libc {
+
+#if defined(LLVM_LIBC_ARCH_X86_64)
+
+using cpu_features::X86Level;
+
+static int as_int(X86Level level) { return static_cast<int>(level); }
+
+// The test runs on the host it was compiled for, so the detected level is at
+// least the one the compiler targets.
+TEST(LlvmLibcCpuFeaturesTest, X86LevelCoversCompilerTarget) {
+  const auto features = cpu_features::get_x86_features();
+  EXPECT_GE(as_int(features.level), as_int(X86Level::V1));
+  EXPECT_LE(as_int(features.level), as_int(X86Level::V4));
+#if defined(__SSE4_2__) && defined(__POPCNT__)
+  EXPECT_GE(as_int(features.level), as_int(X86Level::V2));
+#endif
+#if defined(__AVX2__) && defined(__BMI2__) && defined(__FMA__)
+  EXPECT_GE(as_int(features.level), as_int(X86Level::V3));
+#endif
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+  EXPECT_EQ(as_int(features.level), as_int(X86Level::V4));
+#endif
+}
+
+TEST(LlvmLibcCpuFeaturesTest, X86FeaturesAreStable) {
+  const auto a = cpu_features::get_x86_features();
+  const auto b = cpu_features::get_x86_features();
+  EXPECT_EQ(as_int(a.level), as_int(b.level));
+  EXPECT_EQ(a.erms, b.erms);
+  EXPECT_EQ(a.fsrm, b.fsrm);
+}
+
+#endif // LLVM_LIBC_ARCH_X86_64
+
+} // namespace __llvm_libc
@@ -0,0 +1,109 @@
+//===-- Unittests for the vector math functions ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/__support/architectures.h"
+#include "src/__support/cpu_features.h"
+#include "src/math/cosf.h"
+#include "src/math/expf.h"
+#include "src/math/logf.h"
+#include "src/math/sinf.h"
+#include "src/math/vector_math.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+using FPBits = __llvm_libc::fputil::FPBits<float>;
+
+// Every lane of the vector variants must be bit identical to the scalar
+// function. The inputs walk the whole float range, special values included,
+// so that vectors mixing fast path and special lanes are tested as well.
+class LlvmLibcVectorMathTest : public __llvm_libc::testing::Test {
+public:
+  template <size_t LANES, typename VectorFunction>
+  void check_against_scalar(float (*scalar)(float),
+                            VectorFunction vector_function) {
+    constexpr uint32_t COUNT = 1000003;
+    constexpr uint32_t STEP = UINT32_MAX / COUNT;
+    float inputs[LANES];
+    float outputs[LANES];
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < COUNT; i += LANES) {
+      for (size_t lane = 0; lane < LANES; ++lane, v += STEP)
+        inputs[lane] = float(FPBits(v));
+      vector_function(inputs, outputs);
+      for (size_t lane = 0; lane < LANES; ++lane) {
+        const uint32_t expected = FPBits(scalar(inputs[lane])).uintval();
+        const uint32_t actual = FPBits(outputs[lane]).uintval();
+        // All the nans are equivalent.
+        if (FPBits(expected).is_nan() && FPBits(actual).is_nan())
+          continue;
+        ASSERT_EQ(expected, actual);
+      }
+    }
+  }
+};
+
+#if defined(LLVM_LIBC_ARCH_X86_64)
+
+#define VECTOR_MATH_TEST(name)                                                 \
+  LLVM_LIBC_X86_SSE_VECTOR_ATTR static void name##_4(const float *in,          \
+                                                     float *out) {             \
+    __llvm_libc::VectorFloat4 x;                                               \
+    __builtin_memcpy(&x, in, sizeof(x));                                       \
+    x = __llvm_libc::_ZGVbN4v_##name(x);                                       \
+    __builtin_memcpy(out, &x, sizeof(x));                                      \
+  }                                                                            \
+  LLVM_LIBC_X86_AVX2_VECTOR_ATTR static void name##_8(const float *in,         \
+                                                      float *out) {            \
+    __llvm_libc::VectorFloat8 x;                                               \
+    __builtin_memcpy(&x, in, sizeof(x));                                       \
+    x = __llvm_libc::_ZGVdN8v_##name(x);                                       \
+    __builtin_memcpy(out, &x, sizeof(x));                                      \
+  }                                                                            \
+  LLVM_LIBC_X86_AVX512_VECTOR_ATTR static void name##_16(const float *in,      \
+                                                         float *out) {         \
+    __llvm_libc::VectorFloat16 x;                                              \
+    __builtin_memcpy(&x, in, sizeof(x));                                       \
+    x = __llvm_libc::_ZGVeN16v_##name(x);                                      \
+    __builtin_memcpy(out, &x, sizeof(x));                                      \
+  }                                                                            \
+  TEST_F(LlvmLibcVectorMathTest, name) {                                       \
+    using namespace __llvm_libc::cpu_features;                                 \
+    const X86Level level = get_x86_features().level;                           \
+    if (level < X86Level::V3)                                                  \
+      return;                                                                  \
+    check_against_scalar<4>(__llvm_libc::name, name##_4);                      \
+    check_against_scalar<8>(__llvm_libc::name, name##_8);                      \
+    if (level < X86Level::V4)                                                  \
+      return;                                                                  \
+    check_against_scalar<16>(__llvm_libc::name, name##_16);                    \
+  }
+
+#elif defined(LLVM_LIBC_ARCH_AARCH64)
+
+#define VECTOR_MATH_TEST(name)                                                 \
+  static void name##_4(const float *in, float *out) {                          \
+    __llvm_libc::VectorFloat4 x;                                               \
+    __builtin_memcpy(&x, in, sizeof(x));                                       \
+    x = __llvm_libc::_ZGVnN4v_##name(x);                                       \
+    __builtin_memcpy(out, &x, sizeof(x));                                      \
+  }                                                                            \
+  TEST_F(LlvmLibcVectorMathTest, name) {                                       \
+    check_against_scalar<4>(__llvm_libc::name, name##_4);                      \
+  }
+
+#endif
+
+#ifdef VECTOR_MATH_TEST
+VECTOR_MATH_TEST(cosf)
+VECTOR_MATH_TEST(expf)
+VECTOR_MATH_TEST(logf)
+VECTOR_MATH_TEST(sinf)
+#endif
@@ -9,6 +9,7 @@
 #include "src/__support/CPP/Array.h"
 #include "src/stdio/FILE.h"
 #include "src/stdio/fwrite.h"
+#include "src/stdio/fwrite_unlocked.h"
 #include "utils/UnitTest/Test.h"
 
 TEST(LlvmLibcStdio, FWriteBasic) {
@@ -26,3 +27,19 @@ TEST(LlvmLibcStdio, FWriteBasic) {
   EXPECT_EQ(fwrite("hello", 1, 6, &f), 6UL);
   EXPECT_STREQ(array, "hello");
 }
+
+TEST(LlvmLibcStdio, FWriteUnlocked) {
+  struct StrcpyFile : __llvm_libc::FILE {
+    char *buf;
+  } f;
+  char array[6];
+  f.buf = array;
+  f.write = +[](__llvm_libc::FILE *file, const char *ptr, size_t size) {
+    StrcpyFile *strcpyFile = static_cast<StrcpyFile *>(file);
+    for (size_t i = 0; i < size; ++i)
+      strcpyFile->buf[i] = ptr[i];
+    return size;
+  };
+  EXPECT_EQ(__llvm_libc::fwrite_unlocked("hello", 1, 6, &f), 6UL);
+  EXPECT_STREQ(array, "hello");
+}
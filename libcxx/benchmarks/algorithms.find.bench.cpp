@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// These loops exit as soon as they find what they are looking for, so they
+// are not auto-vectorized. Every benchmark puts the element or difference it
+// looks for last, so the whole range is scanned.
+
+namespace {
+
+template <class T>
+void bm_find(benchmark::State& state) {
+  std::vector<T> vec(state.range(), T(1));
+  vec.back() = T(2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vec);
+    benchmark::DoNotOptimize(std::find(vec.begin(), vec.end(), T(2)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range() * sizeof(T));
+}
+BENCHMARK(bm_find<char>)->Range(8, 1 << 20);
+BENCHMARK(bm_find<short>)->Range(8, 1 << 20);
+BENCHMARK(bm_find<int>)->Range(8, 1 << 20);
+BENCHMARK(bm_find<long long>)->Range(8, 1 << 20);
+
+template <class T>
+void bm_count(benchmark::State& state) {
+  std::vector<T> vec(state.range());
+  for (std::size_t i = 0; i != vec.size(); ++i)
+    vec[i] = T(i % 3);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vec);
+    benchmark::DoNotOptimize(std::count(vec.begin(), vec.end(), T(1)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range() * sizeof(T));
+}
+BENCHMARK(bm_count<char>)->Range(8, 1 << 20);
+BENCHMARK(bm_count<short>)->Range(8, 1 << 20);
+BENCHMARK(bm_count<int>)->Range(8, 1 << 20);
+BENCHMARK(bm_count<long long>)->Range(8, 1 << 20);
+
+template <class T>
+void bm_mismatch(benchmark::State& state) {
+  std::vector<T> vec1(state.range(), T(1));
+  std::vector<T> vec2(state.range(), T(1));
+  vec2.back() = T(2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vec1);
+    benchmark::DoNotOptimize(vec2);
+    benchmark::DoNotOptimize(std::mismatch(vec1.begin(), vec1.end(), vec2.begin()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range() * sizeof(T) * 2);
+}
+BENCHMARK(bm_mismatch<char>)->Range(8, 1 << 20);
+BENCHMARK(bm_mismatch<short>)->Range(8, 1 << 20);
+BENCHMARK(bm_mismatch<int>)->Range(8, 1 << 20);
+BENCHMARK(bm_mismatch<long long>)->Range(8, 1 << 20);
+
+template <class T>
+void bm_equal(benchmark::State& state) {
+  std::vector<T> vec1(state.range(), T(1));
+  std::vector<T> vec2(state.range(), T(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vec1);
+    benchmark::DoNotOptimize(vec2);
+    benchmark::DoNotOptimize(std::equal(vec1.begin(), vec1.end(), vec2.begin(), vec2.end()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range() * sizeof(T) * 2);
+}
+BENCHMARK(bm_equal<char>)->Range(8, 1 << 20);
+BENCHMARK(bm_equal<int>)->Range(8, 1 << 20);
+
+// The haystack is made of near misses of the needle, so each candidate
+// position is checked past its first element.
+template <class T>
+void bm_search(benchmark::State& state) {
+  std::vector<T> haystack(state.range());
+  for (std::size_t i = 0; i != haystack.size(); ++i)
+    haystack[i] = T(i % 8 == 0 ? 0 : 1);
+  std::vector<T> needle(16, T(1));
+  needle[0] = T(0);
+  needle.back() = T(2);
+  std::copy(needle.begin(), needle.end(), haystack.end() - needle.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(haystack);
+    benchmark::DoNotOptimize(std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range() * sizeof(T));
+}
+BENCHMARK(bm_search<char>)->Range(64, 1 << 20);
+BENCHMARK(bm_search<int>)->Range(64, 1 << 20);
+
+} // namespace
+
+BENCHMARK_MAIN();
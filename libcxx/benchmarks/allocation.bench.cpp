@@ -8,6 +8,7 @@
 
 #include "benchmark/benchmark.h"
 
+#include <memory_resource>
 #include <new>
 #include <vector>
 #include <cassert>
@@ -60,6 +61,35 @@ struct BuiltinSizedNewWrapper {
   }
 };
 
+struct UnsynchronizedPoolWrapper {
+  static std::pmr::memory_resource& Resource() {
+    static std::pmr::unsynchronized_pool_resource R;
+    return R;
+  }
+  __attribute__((always_inline))
+  static void* Allocate(size_t N) {
+    return Resource().allocate(N);
+  }
+  __attribute__((always_inline))
+  static void Deallocate(void* P, size_t N) {
+    Resource().deallocate(P, N);
+  }
+};
+
+struct SynchronizedPoolWrapper {
+  static std::pmr::memory_resource& Resource() {
+    static std::pmr::synchronized_pool_resource R;
+    return R;
+  }
+  __attribute__((always_inline))
+  static void* Allocate(size_t N) {
+    return Resource().allocate(N);
+  }
+  __attribute__((always_inline))
+  static void Deallocate(void* P, size_t N) {
+    Resource().deallocate(P, N);
+  }
+};
 
 template <class AllocWrapper>
 static void BM_AllocateAndDeallocate(benchmark::State& st) {
@@ -123,6 +153,10 @@ static int RegisterAllocBenchmarks() {
       {"BM_BuiltinSizedNewDelete", BM_AllocateAndDeallocate<BuiltinSizedNewWrapper>},
       {"BM_BuiltinNewAllocateOnly", BM_AllocateOnly<BuiltinSizedNewWrapper>},
       {"BM_BuiltinNewSizedDeallocateOnly", BM_DeallocateOnly<BuiltinSizedNewWrapper>},
+      {"BM_UnsynchronizedPool", BM_AllocateAndDeallocate<UnsynchronizedPoolWrapper>},
+      {"BM_UnsynchronizedPoolAllocateOnly", BM_AllocateOnly<UnsynchronizedPoolWrapper>},
+      {"BM_UnsynchronizedPoolDeallocateOnly", BM_DeallocateOnly<UnsynchronizedPoolWrapper>},
+      {"BM_SynchronizedPool", BM_AllocateAndDeallocate<SynchronizedPoolWrapper>},
 
   };
   for (auto TC : TestCases) {
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <barrier>
+#include <cstdint>
+#include <latch>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+constexpr int NumRounds = 100;
+
+// Runs `fn(index)` on `count` threads and waits for all of them.
+template <class Fn>
+void RunOnThreads(int count, Fn fn) {
+  std::vector<std::thread> threads;
+  threads.reserve(count);
+  for (int i = 0; i < count; ++i)
+    threads.emplace_back(fn, i);
+  for (auto& t : threads)
+    t.join();
+}
+
+// `pairs` pairs of threads, each pair passing a token back and forth through
+// its own atomic. With 32-bit atomics the wait goes straight to the platform
+// wait primitive; other sizes go through the library's contention table, so
+// the number of pairs shows how well unrelated atomics are kept apart.
+template <class T>
+void BM_AtomicPingPong(benchmark::State& st) {
+  const int pairs = st.range(0);
+  for (auto _ : st) {
+    std::vector<std::atomic<T>> tokens(pairs);
+    RunOnThreads(2 * pairs, [&](int index) {
+      std::atomic<T>& token = tokens[index / 2];
+      const T parity = index % 2;
+      for (T round = parity; round < 2 * NumRounds; round += 2) {
+        for (T current = token.load(); current != round; current = token.load())
+          token.wait(current);
+        token.store(round + 1);
+        token.notify_one();
+      }
+    });
+  }
+  st.SetItemsProcessed(st.iterations() * pairs * NumRounds);
+}
+BENCHMARK_TEMPLATE(BM_AtomicPingPong, std::int32_t)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_AtomicPingPong, std::int64_t)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+struct EmptyCompletion {
+  void operator()() noexcept {}
+};
+
+template <class Barrier>
+void BM_BarrierArriveAndWait(benchmark::State& st) {
+  const int count = st.range(0);
+  for (auto _ : st) {
+    Barrier barrier(count);
+    RunOnThreads(count, [&](int) {
+      for (int round = 0; round < NumRounds; ++round)
+        barrier.arrive_and_wait();
+    });
+  }
+  st.SetItemsProcessed(st.iterations() * NumRounds);
+}
+// Without a completion function the library picks its most specialized
+// barrier; a user-provided completion gets the general algorithm.
+BENCHMARK_TEMPLATE(BM_BarrierArriveAndWait, std::barrier<>)->RangeMultiplier(2)->Range(2, 128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BarrierArriveAndWait, std::barrier<EmptyCompletion>)->RangeMultiplier(2)->Range(2, 128)->UseRealTime();
+
+static void BM_LatchArriveAndWait(benchmark::State& st) {
+  const int count = st.range(0);
+  for (auto _ : st) {
+    std::latch latch(count);
+    RunOnThreads(count, [&](int) { latch.arrive_and_wait(); });
+  }
+}
+BENCHMARK(BM_LatchArriveAndWait)->RangeMultiplier(2)->Range(2, 128)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -1,3 +1,4 @@
+#include <string>
 #include <vector>
 #include <functional>
 #include <cstdint>
@@ -37,4 +38,46 @@ BENCHMARK_CAPTURE(BM_ConstructIterIter,
   getRandomStringInputs)->Arg(TestNumInputs);
 
 
+template <class Container>
+void BM_Resize(benchmark::State& st, Container) {
+  const auto size = st.range(0);
+  for (auto _ : st) {
+    Container c;
+    c.resize(size);
+    DoNotOptimizeData(c);
+  }
+}
+BENCHMARK_CAPTURE(BM_Resize,
+    vector_byte,
+    std::vector<unsigned char>{})->Arg(5140480);
+
+template <class Container>
+void BM_ResizeDefaultInit(benchmark::State& st, Container) {
+  const auto size = st.range(0);
+  for (auto _ : st) {
+    Container c;
+    c.__resize_default_init(size);
+    DoNotOptimizeData(c);
+  }
+}
+BENCHMARK_CAPTURE(BM_ResizeDefaultInit,
+    vector_byte,
+    std::vector<unsigned char>{})->Arg(5140480);
+
+// Builds a string out of many short pieces, the way serializers and loggers
+// typically do.
+static void BM_StringAppendChain(benchmark::State& st) {
+  const auto count = st.range(0);
+  const std::string piece = "0123456789";
+  for (auto _ : st) {
+    std::string s;
+    for (auto i = 0; i < count; ++i) {
+      s += piece;
+      s.append("abc", 3);
+    }
+    benchmark::DoNotOptimize(s.data());
+  }
+}
+BENCHMARK(BM_StringAppendChain)->Arg(1)->Arg(64)->Arg(TestNumInputs);
+
 BENCHMARK_MAIN();
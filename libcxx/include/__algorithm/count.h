@@ -10,8 +10,11 @@
 #ifndef _LIBCPP___ALGORITHM_COUNT_H
 #define _LIBCPP___ALGORITHM_COUNT_H
 
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
+#include <type_traits>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #  pragma GCC system_header
@@ -20,9 +23,9 @@
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 template <class _InputIterator, class _Tp>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17
+inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17
     typename iterator_traits<_InputIterator>::difference_type
-    count(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
+    __count_constexpr(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
   typename iterator_traits<_InputIterator>::difference_type __r(0);
   for (; __first != __last; ++__first)
     if (*__first == __value_)
@@ -30,6 +33,34 @@ _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_C
   return __r;
 }
 
+template <class _InputIterator, class _Tp>
+inline _LIBCPP_INLINE_VISIBILITY typename iterator_traits<_InputIterator>::difference_type
+__count(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
+  return _VSTD::__count_constexpr(__first, __last, __value_);
+}
+
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+template <class _Tp, class _Up>
+inline _LIBCPP_INLINE_VISIBILITY
+typename enable_if<__is_simd_comparable<_Tp>::value && is_integral<_Up>::value, ptrdiff_t>::type
+__count(_Tp* __first, _Tp* __last, const _Up& __value_) {
+  typedef typename remove_const<_Tp>::type _RawTp;
+  _RawTp __v;
+  if (!_VSTD::__simd_convert_value(__value_, __v))
+    return 0;
+  return static_cast<ptrdiff_t>(_VSTD::__simd_count<_RawTp>(__first, __last, __v));
+}
+#endif
+
+template <class _InputIterator, class _Tp>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17
+    typename iterator_traits<_InputIterator>::difference_type
+    count(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::__count_constexpr(__first, __last, __value_);
+  return _VSTD::__count(_VSTD::__unwrap_iter(__first), _VSTD::__unwrap_iter(__last), __value_);
+}
+
 _LIBCPP_END_NAMESPACE_STD
 
 #endif // _LIBCPP___ALGORITHM_COUNT_H
@@ -11,9 +11,13 @@
 #define _LIBCPP___ALGORITHM_MISMATCH_H
 
 #include <__algorithm/comp.h>
+#include <__algorithm/min.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
 #include <__utility/pair.h>
+#include <type_traits>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #  pragma GCC system_header
@@ -22,15 +26,46 @@
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
-    _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
-    mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _BinaryPredicate __pred) {
+inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
+__mismatch_constexpr(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2,
+                     _BinaryPredicate& __pred) {
   for (; __first1 != __last1; ++__first1, (void)++__first2)
     if (!__pred(*__first1, *__first2))
       break;
   return pair<_InputIterator1, _InputIterator2>(__first1, __first2);
 }
 
+template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
+inline _LIBCPP_INLINE_VISIBILITY pair<_InputIterator1, _InputIterator2>
+__mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _BinaryPredicate& __pred) {
+  return _VSTD::__mismatch_constexpr(__first1, __last1, __first2, __pred);
+}
+
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+// Only comparisons with the predicate we pass ourselves are known to be
+// comparisons of the object representations.
+template <class _Tp, class _Up, class _V1, class _V2>
+inline _LIBCPP_INLINE_VISIBILITY
+typename enable_if<__is_simd_comparable_pair<_Tp, _Up>::value, pair<_Tp*, _Up*> >::type
+__mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2, __equal_to<_V1, _V2>&) {
+  size_t __n = _VSTD::__simd_mismatch<typename remove_const<_Tp>::type>(
+      __first1, __first2, static_cast<size_t>(__last1 - __first1));
+  return pair<_Tp*, _Up*>(__first1 + __n, __first2 + __n);
+}
+#endif
+
+template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
+    _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
+    mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _BinaryPredicate __pred) {
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::__mismatch_constexpr(__first1, __last1, __first2, __pred);
+  pair<decltype(_VSTD::__unwrap_iter(__first1)), decltype(_VSTD::__unwrap_iter(__first2))> __r = _VSTD::__mismatch(
+      _VSTD::__unwrap_iter(__first1), _VSTD::__unwrap_iter(__last1), _VSTD::__unwrap_iter(__first2), __pred);
+  return pair<_InputIterator1, _InputIterator2>(
+      _VSTD::__rewrap_iter(__first1, __r.first), _VSTD::__rewrap_iter(__first2, __r.second));
+}
+
 template <class _InputIterator1, class _InputIterator2>
 _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
     _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
@@ -42,16 +77,46 @@ _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
 
 #if _LIBCPP_STD_VER > 11
 template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
-    _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
-    mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _InputIterator2 __last2,
-             _BinaryPredicate __pred) {
+inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
+__mismatch_constexpr(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2,
+                     _InputIterator2 __last2, _BinaryPredicate& __pred) {
   for (; __first1 != __last1 && __first2 != __last2; ++__first1, (void)++__first2)
     if (!__pred(*__first1, *__first2))
       break;
   return pair<_InputIterator1, _InputIterator2>(__first1, __first2);
 }
 
+template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
+inline _LIBCPP_INLINE_VISIBILITY pair<_InputIterator1, _InputIterator2>
+__mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _InputIterator2 __last2,
+           _BinaryPredicate& __pred) {
+  return _VSTD::__mismatch_constexpr(__first1, __last1, __first2, __last2, __pred);
+}
+
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+template <class _Tp, class _Up, class _V1, class _V2>
+inline _LIBCPP_INLINE_VISIBILITY
+typename enable_if<__is_simd_comparable_pair<_Tp, _Up>::value, pair<_Tp*, _Up*> >::type
+__mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2, _Up* __last2, __equal_to<_V1, _V2>& __pred) {
+  return _VSTD::__mismatch(
+      __first1, __first1 + _VSTD::min(__last1 - __first1, __last2 - __first2), __first2, __pred);
+}
+#endif
+
+template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
+    _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
+    mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _InputIterator2 __last2,
+             _BinaryPredicate __pred) {
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::__mismatch_constexpr(__first1, __last1, __first2, __last2, __pred);
+  pair<decltype(_VSTD::__unwrap_iter(__first1)), decltype(_VSTD::__unwrap_iter(__first2))> __r =
+      _VSTD::__mismatch(_VSTD::__unwrap_iter(__first1), _VSTD::__unwrap_iter(__last1),
+                        _VSTD::__unwrap_iter(__first2), _VSTD::__unwrap_iter(__last2), __pred);
+  return pair<_InputIterator1, _InputIterator2>(
+      _VSTD::__rewrap_iter(__first1, __r.first), _VSTD::__rewrap_iter(__first2, __r.second));
+}
+
 template <class _InputIterator1, class _InputIterator2>
 _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
     _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
@@ -11,9 +11,12 @@
 #define _LIBCPP___ALGORITHM_SEARCH_H
 
 #include <__algorithm/comp.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
 #include <__utility/pair.h>
+#include <type_traits>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #  pragma GCC system_header
@@ -94,15 +97,55 @@ __search(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1, _Rando
 }
 
 template <class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 _ForwardIterator1
-search(_ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2, _ForwardIterator2 __last2,
-       _BinaryPredicate __pred) {
+inline _LIBCPP_INLINE_VISIBILITY _ForwardIterator1
+__search_impl(_ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+              _ForwardIterator2 __last2, _BinaryPredicate& __pred) {
   return _VSTD::__search<_BinaryPredicate&>(
              __first1, __last1, __first2, __last2, __pred,
              typename iterator_traits<_ForwardIterator1>::iterator_category(),
              typename iterator_traits<_ForwardIterator2>::iterator_category()).first;
 }
 
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+// Looks for the first element of the pattern a vector at a time, and then
+// compares the rest of the pattern a vector at a time.
+template <class _Tp, class _Up, class _V1, class _V2>
+inline _LIBCPP_INLINE_VISIBILITY typename enable_if<__is_simd_comparable_pair<_Tp, _Up>::value, _Tp*>::type
+__search_impl(_Tp* __first1, _Tp* __last1, _Up* __first2, _Up* __last2, __equal_to<_V1, _V2>&) {
+  typedef typename remove_const<_Tp>::type _RawTp;
+  const ptrdiff_t __len2 = __last2 - __first2;
+  if (__len2 == 0)
+    return __first1;
+  if (__last1 - __first1 < __len2)
+    return __last1;
+  _Tp* const __s = __last1 - (__len2 - 1); // Start of pattern match can't go beyond here
+  const size_t __rest = static_cast<size_t>(__len2 - 1);
+  while (true) {
+    __first1 = const_cast<_Tp*>(_VSTD::__simd_find<_RawTp>(__first1, __s, *__first2));
+    if (__first1 == __s)
+      return __last1;
+    if (_VSTD::__simd_mismatch<_RawTp>(__first1 + 1, __first2 + 1, __rest) == __rest)
+      return __first1;
+    ++__first1;
+  }
+}
+#endif
+
+template <class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 _ForwardIterator1
+search(_ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2, _ForwardIterator2 __last2,
+       _BinaryPredicate __pred) {
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::__search<_BinaryPredicate&>(
+               __first1, __last1, __first2, __last2, __pred,
+               typename iterator_traits<_ForwardIterator1>::iterator_category(),
+               typename iterator_traits<_ForwardIterator2>::iterator_category()).first;
+  return _VSTD::__rewrap_iter(__first1, _VSTD::__search_impl(_VSTD::__unwrap_iter(__first1),
+                                                             _VSTD::__unwrap_iter(__last1),
+                                                             _VSTD::__unwrap_iter(__first2),
+                                                             _VSTD::__unwrap_iter(__last2), __pred));
+}
+
 template <class _ForwardIterator1, class _ForwardIterator2>
 _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 _ForwardIterator1
 search(_ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2, _ForwardIterator2 __last2) {
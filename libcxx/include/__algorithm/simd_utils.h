@@ -0,0 +1,272 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___ALGORITHM_SIMD_UTILS_H
+#define _LIBCPP___ALGORITHM_SIMD_UTILS_H
+
+#include <__algorithm/min.h>
+#include <__bits>
+#include <__config>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+_LIBCPP_PUSH_MACROS
+#include <__undef_macros>
+
+// The loops in find, count, mismatch and equal exit early, so the compiler
+// does not vectorize them. For integers, comparing for equality is comparing
+// the object representations, so these helpers compare a whole vector of
+// elements at a time using the vector extension that Clang and GCC share.
+// They are never constexpr; the algorithms only call them outside of
+// constant evaluation.
+#if __has_attribute(__vector_size__) && !defined(_LIBCPP_COMPILER_MSVC)
+#  define _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS 1
+#else
+#  define _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS 0
+#endif
+
+#if _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#  if defined(__AVX2__)
+#    define _LIBCPP_SIMD_VECTOR_BYTES 32
+#  else
+#    define _LIBCPP_SIMD_VECTOR_BYTES 16
+#  endif
+
+// Whether _Tp can be compared a vector at a time. bool is excluded, as
+// a bool object may hold a value other than 0 and 1. With fewer than four
+// lanes per vector, the scalar loop is as fast, so 64-bit elements need wider
+// vectors than SSE2 has.
+template <class _Tp>
+struct __is_simd_comparable
+    : integral_constant<bool,
+                        is_integral<_Tp>::value && !is_same<typename remove_cv<_Tp>::type, bool>::value &&
+                            !is_volatile<_Tp>::value &&
+                            (sizeof(_Tp) == 1 || sizeof(_Tp) == 2 || sizeof(_Tp) == 4 || sizeof(_Tp) == 8) &&
+                            4 * sizeof(_Tp) <= _LIBCPP_SIMD_VECTOR_BYTES> {};
+
+// Whether the elements of a range of _Tp and of a range of _Up can be compared
+// with each other a vector at a time.
+template <class _Tp, class _Up>
+struct __is_simd_comparable_pair
+    : integral_constant<bool,
+                        __is_simd_comparable<_Tp>::value &&
+                            is_same<typename remove_cv<_Tp>::type, typename remove_cv<_Up>::type>::value> {};
+
+// The vector types are named after the size of their elements rather than
+// their type, as the extension ignores the attribute on dependent types.
+template <size_t _Size>
+struct __simd_traits;
+
+template <>
+struct __simd_traits<1> {
+  typedef uint8_t __element;
+  typedef uint8_t __vector __attribute__((__vector_size__(_LIBCPP_SIMD_VECTOR_BYTES)));
+};
+
+template <>
+struct __simd_traits<2> {
+  typedef uint16_t __element;
+  typedef uint16_t __vector __attribute__((__vector_size__(_LIBCPP_SIMD_VECTOR_BYTES)));
+};
+
+template <>
+struct __simd_traits<4> {
+  typedef uint32_t __element;
+  typedef uint32_t __vector __attribute__((__vector_size__(_LIBCPP_SIMD_VECTOR_BYTES)));
+};
+
+template <>
+struct __simd_traits<8> {
+  typedef uint64_t __element;
+  typedef uint64_t __vector __attribute__((__vector_size__(_LIBCPP_SIMD_VECTOR_BYTES)));
+};
+
+template <class _Tp>
+struct __simd_ops {
+  typedef typename __simd_traits<sizeof(_Tp)>::__element __element;
+  typedef typename __simd_traits<sizeof(_Tp)>::__vector __vector;
+
+  static const size_t __lanes = _LIBCPP_SIMD_VECTOR_BYTES / sizeof(_Tp);
+  static const size_t __words = _LIBCPP_SIMD_VECTOR_BYTES / sizeof(uint64_t);
+
+  // The callers check that a whole vector is left, but GCC may warn about the
+  // loads it can't prove that for once they are inlined.
+  _LIBCPP_DIAGNOSTIC_PUSH
+  _LIBCPP_GCC_DIAGNOSTIC_IGNORED("-Warray-bounds")
+  _LIBCPP_HIDE_FROM_ABI static __vector __load(const _Tp* __p) _NOEXCEPT {
+    __vector __v;
+    __builtin_memcpy(&__v, __p, sizeof(__v));
+    return __v;
+  }
+  _LIBCPP_DIAGNOSTIC_POP
+
+  _LIBCPP_HIDE_FROM_ABI static __element __bits_of(_Tp __x) _NOEXCEPT { return static_cast<__element>(__x); }
+
+  // Each lane of a comparison result is either all ones or all zeros.
+  _LIBCPP_HIDE_FROM_ABI static __vector __equal_lanes(__vector __x, __vector __y) _NOEXCEPT {
+    return (__vector)(__x == __y);
+  }
+  _LIBCPP_HIDE_FROM_ABI static __vector __equal_lanes(__vector __x, __element __y) _NOEXCEPT {
+    return (__vector)(__x == __y);
+  }
+
+  // Returns the index of the first lane of __mask which is set, or __lanes if
+  // there is none.
+  _LIBCPP_HIDE_FROM_ABI static size_t __first_set_lane(__vector __mask) _NOEXCEPT {
+    uint64_t __w[__words];
+    __builtin_memcpy(__w, &__mask, sizeof(__w));
+    for (size_t __i = 0; __i != __words; ++__i) {
+      if (__w[__i] != 0) {
+#  if defined(_LIBCPP_BIG_ENDIAN)
+        size_t __bit = static_cast<size_t>(__libcpp_clz(static_cast<unsigned long long>(__w[__i])));
+#  else
+        size_t __bit = static_cast<size_t>(__libcpp_ctz(static_cast<unsigned long long>(__w[__i])));
+#  endif
+        return (__i * 64 + __bit) / (8 * sizeof(_Tp));
+      }
+    }
+    return __lanes;
+  }
+
+  // Returns whether any lane of __mask is set.
+  _LIBCPP_HIDE_FROM_ABI static bool __any_lane(__vector __mask) _NOEXCEPT {
+    uint64_t __w[__words];
+    __builtin_memcpy(__w, &__mask, sizeof(__w));
+    uint64_t __any = 0;
+    for (size_t __i = 0; __i != __words; ++__i)
+      __any |= __w[__i];
+    return __any != 0;
+  }
+
+  // Returns the sum of the lanes of __v.
+  _LIBCPP_HIDE_FROM_ABI static size_t __sum_lanes(__vector __v) _NOEXCEPT {
+    __element __e[__lanes];
+    __builtin_memcpy(__e, &__v, sizeof(__e));
+    size_t __sum = 0;
+    for (size_t __i = 0; __i != __lanes; ++__i)
+      __sum += __e[__i];
+    return __sum;
+  }
+};
+
+// The number of vectors the loops below compare before they check the
+// results, so that the check is amortized over several comparisons.
+static const size_t __simd_unroll = 4;
+
+// Returns the first element of [__first, __last) equal to __value, or __last.
+template <class _Tp>
+_LIBCPP_HIDE_FROM_ABI const _Tp* __simd_find(const _Tp* __first, const _Tp* __last, _Tp __value) _NOEXCEPT {
+  typedef __simd_ops<_Tp> _Ops;
+  typedef typename _Ops::__vector __vector;
+  const typename _Ops::__element __v = _Ops::__bits_of(__value);
+  for (; static_cast<size_t>(__last - __first) >= __simd_unroll * _Ops::__lanes;
+       __first += __simd_unroll * _Ops::__lanes) {
+    __vector __m[__simd_unroll];
+    for (size_t __k = 0; __k != __simd_unroll; ++__k)
+      __m[__k] = _Ops::__equal_lanes(_Ops::__load(__first + __k * _Ops::__lanes), __v);
+    if (_Ops::__any_lane(__m[0] | __m[1] | __m[2] | __m[3])) {
+      for (size_t __k = 0;; ++__k) {
+        size_t __i = _Ops::__first_set_lane(__m[__k]);
+        if (__i != _Ops::__lanes)
+          return __first + __k * _Ops::__lanes + __i;
+      }
+    }
+  }
+  for (; static_cast<size_t>(__last - __first) >= _Ops::__lanes; __first += _Ops::__lanes) {
+    size_t __i = _Ops::__first_set_lane(_Ops::__equal_lanes(_Ops::__load(__first), __v));
+    if (__i != _Ops::__lanes)
+      return __first + __i;
+  }
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      break;
+  return __first;
+}
+
+// Returns the number of elements of [__first, __last) equal to __value.
+template <class _Tp>
+_LIBCPP_HIDE_FROM_ABI size_t __simd_count(const _Tp* __first, const _Tp* __last, _Tp __value) _NOEXCEPT {
+  typedef __simd_ops<_Tp> _Ops;
+  typedef typename _Ops::__vector __vector;
+  const typename _Ops::__element __v = _Ops::__bits_of(__value);
+  // Subtracting a comparison result adds one to each lane which matched.
+  // Every lane is summed before it can overflow, which takes 255 vectors for
+  // the narrowest lanes.
+  const size_t __max_vectors = 255;
+  size_t __n = 0;
+  while (static_cast<size_t>(__last - __first) >= _Ops::__lanes) {
+    size_t __vectors = _VSTD::min<size_t>(static_cast<size_t>(__last - __first) / _Ops::__lanes, __max_vectors);
+    __vector __acc = __vector();
+    for (size_t __k = 0; __k != __vectors; ++__k, __first += _Ops::__lanes)
+      __acc -= _Ops::__equal_lanes(_Ops::__load(__first), __v);
+    __n += _Ops::__sum_lanes(__acc);
+  }
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      ++__n;
+  return __n;
+}
+
+// Returns the index of the first position at which [__first1, __first1 + __n)
+// and [__first2, __first2 + __n) differ, or __n.
+template <class _Tp>
+_LIBCPP_HIDE_FROM_ABI size_t __simd_mismatch(const _Tp* __first1, const _Tp* __first2, size_t __n) _NOEXCEPT {
+  typedef __simd_ops<_Tp> _Ops;
+  typedef typename _Ops::__vector __vector;
+  size_t __i = 0;
+  for (; __n - __i >= __simd_unroll * _Ops::__lanes; __i += __simd_unroll * _Ops::__lanes) {
+    __vector __m[__simd_unroll];
+    for (size_t __k = 0; __k != __simd_unroll; ++__k) {
+      size_t __j = __i + __k * _Ops::__lanes;
+      __m[__k] = ~_Ops::__equal_lanes(_Ops::__load(__first1 + __j), _Ops::__load(__first2 + __j));
+    }
+    if (_Ops::__any_lane(__m[0] | __m[1] | __m[2] | __m[3])) {
+      for (size_t __k = 0;; ++__k) {
+        size_t __j = _Ops::__first_set_lane(__m[__k]);
+        if (__j != _Ops::__lanes)
+          return __i + __k * _Ops::__lanes + __j;
+      }
+    }
+  }
+  for (; __n - __i >= _Ops::__lanes; __i += _Ops::__lanes) {
+    size_t __j =
+        _Ops::__first_set_lane(~_Ops::__equal_lanes(_Ops::__load(__first1 + __i), _Ops::__load(__first2 + __i)));
+    if (__j != _Ops::__lanes)
+      return __i + __j;
+  }
+  for (; __i != __n; ++__i)
+    if (!(__first1[__i] == __first2[__i]))
+      break;
+  return __i;
+}
+
+// Converts __value to a _Tp which compares equal to the same elements. Returns
+// false if no _Tp compares equal to __value, e.g. if it is out of range.
+template <class _Tp, class _Up>
+_LIBCPP_HIDE_FROM_ABI bool __simd_convert_value(const _Up& __value, _Tp& __result) _NOEXCEPT {
+  __result = static_cast<_Tp>(__value);
+  return __result == __value;
+}
+
+_LIBCPP_END_NAMESPACE_STD
+
+#  undef _LIBCPP_SIMD_VECTOR_BYTES
+
+#endif // _LIBCPP_HAS_ALGORITHM_VECTOR_UTILS
+
+_LIBCPP_POP_MACROS
+
+#endif // _LIBCPP___ALGORITHM_SIMD_UTILS_H
@@ -0,0 +1,58 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___FLAT_MAP_UTILS_H
+#define _LIBCPP___FLAT_MAP_UTILS_H
+
+#include <__compare/ordering.h>
+#include <__compare/synth_three_way.h>
+#include <__config>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+#if _LIBCPP_STD_VER > 20
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+// Whether each element of the range compares less than the next one.
+template <class _Iter, class _Compare>
+_LIBCPP_HIDE_FROM_ABI bool __flat_is_sorted_and_unique(_Iter __first, _Iter __last, _Compare& __comp) {
+  if (__first == __last)
+    return true;
+  for (_Iter __next = __first; ++__next != __last; __first = __next)
+    if (!__comp(*__first, *__next))
+      return false;
+  return true;
+}
+
+#if !defined(_LIBCPP_HAS_NO_CONCEPTS)
+
+template <class _Iter1, class _Iter2>
+_LIBCPP_HIDE_FROM_ABI auto
+__flat_synth_three_way_range(_Iter1 __first1, _Iter1 __last1, _Iter2 __first2, _Iter2 __last2)
+    -> __synth_three_way_result<decltype(*__first1), decltype(*__first2)> {
+  for (; __first1 != __last1 && __first2 != __last2; ++__first1, ++__first2)
+    if (auto __c = _VSTD::__synth_three_way(*__first1, *__first2); __c != 0)
+      return __c;
+  if (__first1 != __last1)
+    return strong_ordering::greater;
+  if (__first2 != __last2)
+    return strong_ordering::less;
+  return strong_ordering::equal;
+}
+
+#endif // !defined(_LIBCPP_HAS_NO_CONCEPTS)
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP_STD_VER > 20
+
+#endif // _LIBCPP___FLAT_MAP_UTILS_H
@@ -0,0 +1,386 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___FORMAT_BUFFER_H
+#define _LIBCPP___FORMAT_BUFFER_H
+
+#include <__algorithm/copy_n.h>
+#include <__algorithm/min.h>
+#include <__config>
+#include <__format/format_to_n_result.h>
+#include <__iterator/back_insert_iterator.h>
+#include <__iterator/incrementable_traits.h>
+#include <__iterator/wrap_iter.h>
+#include <__memory/pointer_traits.h>
+#include <__utility/move.h>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#if _LIBCPP_STD_VER > 17
+
+// TODO FMT Remove this once we require compilers with proper C++20 support.
+// If the compiler has no concepts support, the format header will be disabled.
+// Without concepts support enable_if needs to be used and that too much effort
+// to support compilers with partial C++20 support.
+#if !defined(_LIBCPP_HAS_NO_CONCEPTS)
+
+namespace __format {
+
+/// A "buffer" that handles writing to the proper iterator.
+///
+/// This helper is used together with the @ref back_insert_iterator to offer
+/// type-erasure for the formatting functions. Every formatting function
+/// formats to a back_insert_iterator<__output_buffer<_CharT>>, regardless of
+/// the output iterator used by the caller. This reduces the number of
+/// template instantiations and lets the output be written in bulk.
+///
+/// The buffer writes to the memory provided by its owner. When the memory is
+/// full, or when formatting is done, the owner's @c __flush(_CharT*, size_t)
+/// member is called to forward the written characters to their destination.
+template <class _CharT>
+class _LIBCPP_TEMPLATE_VIS __output_buffer {
+public:
+  using value_type = _CharT;
+
+  template <class _Tp>
+  _LIBCPP_HIDE_FROM_ABI explicit __output_buffer(_CharT* __ptr,
+                                                 size_t __capacity, _Tp* __obj)
+      : __ptr_(__ptr), __capacity_(__capacity),
+        __flush_([](_CharT* __p, size_t __size, void* __o) {
+          static_cast<_Tp*>(__o)->__flush(__p, __size);
+        }),
+        __obj_(__obj) {}
+
+  _LIBCPP_HIDE_FROM_ABI void __reset(_CharT* __ptr, size_t __capacity) {
+    __ptr_ = __ptr;
+    __capacity_ = __capacity;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI back_insert_iterator<__output_buffer>
+  __make_output_iterator() {
+    return back_insert_iterator<__output_buffer>{*this};
+  }
+
+  // Used in std::back_insert_iterator.
+  _LIBCPP_HIDE_FROM_ABI void push_back(_CharT __c) {
+    __ptr_[__size_++] = __c;
+
+    // Flushing after adding keeps the common case to a store, an increment
+    // and a compare.
+    if (__size_ == __capacity_)
+      __flush();
+  }
+
+  /// Copies the characters in [__first, __last) to the buffer.
+  ///
+  /// This avoids the per character overhead of the iterator interface for
+  /// larger runs, like the literal text of a format string.
+  _LIBCPP_HIDE_FROM_ABI void __copy(const _CharT* __first,
+                                    const _CharT* __last) {
+    size_t __n = static_cast<size_t>(__last - __first);
+    while (__n) {
+      size_t __chunk = _VSTD::min(__n, __capacity_ - __size_);
+      _VSTD::copy_n(__first, __chunk, __ptr_ + __size_);
+      __size_ += __chunk;
+      __first += __chunk;
+      __n -= __chunk;
+      if (__size_ == __capacity_)
+        __flush();
+    }
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush() {
+    __flush_(__ptr_, __size_, __obj_);
+    __size_ = 0;
+  }
+
+private:
+  _CharT* __ptr_;
+  size_t __capacity_;
+  size_t __size_{0};
+  void (*__flush_)(_CharT*, size_t, void*);
+  void* __obj_;
+};
+
+/// Copies [__first, __last) to __out_it.
+///
+/// When the output is an @ref __output_buffer the characters are copied in
+/// bulk, otherwise they are copied one at a time.
+template <class _CharT, class _OutIt>
+_LIBCPP_HIDE_FROM_ABI _OutIt __copy(const _CharT* __first, const _CharT* __last,
+                                    _OutIt __out_it) {
+  if constexpr (same_as<_OutIt,
+                        back_insert_iterator<__output_buffer<_CharT>>>) {
+    __out_it.__get_container()->__copy(__first, __last);
+    return __out_it;
+  } else
+    return _VSTD::copy_n(__first, __last - __first, _VSTD::move(__out_it));
+}
+
+/// The storage used when the output can't be written directly.
+template <class _CharT>
+class _LIBCPP_TEMPLATE_VIS __internal_storage {
+public:
+  static constexpr size_t __buffer_size = 256 / sizeof(_CharT);
+
+  _LIBCPP_HIDE_FROM_ABI _CharT* __begin() { return __buffer_; }
+
+private:
+  _CharT __buffer_[__buffer_size];
+};
+
+/// The storage used when the output is written directly to its destination.
+///
+/// This storage is empty, the output iterator provides the memory.
+template <class _CharT>
+class _LIBCPP_TEMPLATE_VIS __direct_storage {};
+
+/// Whether the output can be written directly to the output iterator.
+///
+/// This is the case for pointers and the contiguous iterators of the library
+/// containers. The caller guarantees there is enough space available.
+template <class _OutIt, class _CharT>
+concept __enable_direct_output =
+    same_as<_OutIt, _CharT*> || same_as<_OutIt, __wrap_iter<_CharT*>>;
+
+/// Write policy for directly writing to the underlying output.
+///
+/// Since the memory is provided by the output iterator the buffer has an
+/// unlimited capacity and is only flushed once, when formatting is done.
+template <class _OutIt, class _CharT>
+class _LIBCPP_TEMPLATE_VIS __writer_direct {
+public:
+  _LIBCPP_HIDE_FROM_ABI explicit __writer_direct(_OutIt __out_it)
+      : __out_it_(__out_it) {}
+
+  _LIBCPP_HIDE_FROM_ABI _OutIt __out() { return __out_it_; }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT*, size_t __size) {
+    // _OutIt can be a __wrap_iter<_CharT*>, therefore the original iterator
+    // is adjusted instead of using the buffer's pointer.
+    __out_it_ += __size;
+  }
+
+private:
+  _OutIt __out_it_;
+};
+
+/// Write policy for copying the buffer to the output iterator.
+template <class _OutIt, class _CharT>
+class _LIBCPP_TEMPLATE_VIS __writer_iterator {
+public:
+  _LIBCPP_HIDE_FROM_ABI explicit __writer_iterator(_OutIt __out_it)
+      : __out_it_{_VSTD::move(__out_it)} {}
+
+  _LIBCPP_HIDE_FROM_ABI _OutIt __out() && { return _VSTD::move(__out_it_); }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT* __ptr, size_t __size) {
+    __out_it_ = _VSTD::copy_n(__ptr, __size, _VSTD::move(__out_it_));
+  }
+
+private:
+  _OutIt __out_it_;
+};
+
+/// Concept to determine whether a container can be appended to in bulk.
+///
+/// This is the case for the library's sequence containers and basic_string.
+template <class _Container, class _CharT>
+concept __insertable =
+    same_as<typename _Container::value_type, _CharT> &&
+    requires(_Container& __t, const _CharT* __first, const _CharT* __last) {
+      __t.insert(__t.end(), __first, __last);
+    };
+
+/// Extracts the container of a back_insert_iterator.
+///
+/// Sets @c type to @c void when the iterator is not a back_insert_iterator
+/// or the container is not @ref __insertable.
+template <class _It, class _CharT>
+struct _LIBCPP_TEMPLATE_VIS __back_insert_iterator_container {
+  using type = void;
+};
+
+template <class _Container, class _CharT>
+  requires __insertable<_Container, _CharT>
+struct _LIBCPP_TEMPLATE_VIS
+    __back_insert_iterator_container<back_insert_iterator<_Container>, _CharT> {
+  using type = _Container;
+};
+
+/// Write policy for inserting the buffer in a container.
+template <class _Container>
+class _LIBCPP_TEMPLATE_VIS __writer_container {
+public:
+  using _CharT = typename _Container::value_type;
+
+  _LIBCPP_HIDE_FROM_ABI explicit __writer_container(
+      back_insert_iterator<_Container> __out_it)
+      : __container_{__out_it.__get_container()} {}
+
+  _LIBCPP_HIDE_FROM_ABI back_insert_iterator<_Container> __out() {
+    return back_insert_iterator<_Container>{*__container_};
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT* __ptr, size_t __size) {
+    __container_->insert(__container_->end(), __ptr, __ptr + __size);
+  }
+
+private:
+  _Container* __container_;
+};
+
+/// Selects the type of the writer used for the output iterator.
+template <class _OutIt, class _CharT>
+class _LIBCPP_TEMPLATE_VIS __writer_selector {
+  using _Container =
+      typename __back_insert_iterator_container<_OutIt, _CharT>::type;
+
+public:
+  using type = conditional_t<
+      !same_as<_Container, void>, __writer_container<_Container>,
+      conditional_t<__enable_direct_output<_OutIt, _CharT>,
+                    __writer_direct<_OutIt, _CharT>,
+                    __writer_iterator<_OutIt, _CharT>>>;
+};
+
+/// The generic formatting buffer.
+template <class _OutIt, class _CharT>
+requires(output_iterator<_OutIt, const _CharT&>) class _LIBCPP_TEMPLATE_VIS
+    __format_buffer {
+  using _Storage =
+      conditional_t<__enable_direct_output<_OutIt, _CharT>,
+                    __direct_storage<_CharT>, __internal_storage<_CharT>>;
+
+public:
+  _LIBCPP_HIDE_FROM_ABI explicit __format_buffer(_OutIt __out_it)
+      requires(same_as<_Storage, __internal_storage<_CharT>>)
+      : __output_(__storage_.__begin(), __storage_.__buffer_size, this),
+        __writer_(_VSTD::move(__out_it)) {}
+
+  _LIBCPP_HIDE_FROM_ABI explicit __format_buffer(_OutIt __out_it)
+      requires(same_as<_Storage, __direct_storage<_CharT>>)
+      : __output_(_VSTD::__to_address(__out_it), size_t(-1), this),
+        __writer_(_VSTD::move(__out_it)) {}
+
+  _LIBCPP_HIDE_FROM_ABI back_insert_iterator<__output_buffer<_CharT>>
+  __make_output_iterator() {
+    return __output_.__make_output_iterator();
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT* __ptr, size_t __size) {
+    __writer_.__flush(__ptr, __size);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI _OutIt __out() && {
+    __output_.__flush();
+    return _VSTD::move(__writer_).__out();
+  }
+
+private:
+  _LIBCPP_NO_UNIQUE_ADDRESS _Storage __storage_;
+  __output_buffer<_CharT> __output_;
+  typename __writer_selector<_OutIt, _CharT>::type __writer_;
+};
+
+/// A buffer that counts the number of insertions.
+///
+/// Since @ref formatted_size only needs to know the size, the output itself
+/// is discarded.
+template <class _CharT>
+class _LIBCPP_TEMPLATE_VIS __formatted_size_buffer {
+public:
+  _LIBCPP_HIDE_FROM_ABI __formatted_size_buffer()
+      : __output_(__storage_.__begin(), __storage_.__buffer_size, this) {}
+
+  _LIBCPP_HIDE_FROM_ABI back_insert_iterator<__output_buffer<_CharT>>
+  __make_output_iterator() {
+    return __output_.__make_output_iterator();
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT*, size_t __size) {
+    __size_ += __size;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI size_t __result() && {
+    __output_.__flush();
+    return __size_;
+  }
+
+private:
+  __internal_storage<_CharT> __storage_;
+  __output_buffer<_CharT> __output_;
+  size_t __size_{0};
+};
+
+/// The buffer that truncates the output for @ref format_to_n.
+///
+/// Only the first @c __max_size characters are written to the output, the
+/// remaining characters are only counted. When the output can be written to
+/// directly, the first @c __max_size characters are written in place and the
+/// internal storage is only used to count the remaining characters.
+template <class _OutIt, class _CharT>
+requires(output_iterator<_OutIt, const _CharT&>) class _LIBCPP_TEMPLATE_VIS
+    __format_to_n_buffer {
+public:
+  _LIBCPP_HIDE_FROM_ABI explicit __format_to_n_buffer(
+      _OutIt __out_it, iter_difference_t<_OutIt> __max_size)
+      : __output_(__storage_.__begin(), __storage_.__buffer_size, this),
+        __writer_(_VSTD::move(__out_it)),
+        __max_size_(__max_size > 0 ? static_cast<size_t>(__max_size) : 0) {
+    if constexpr (__enable_direct_output<_OutIt, _CharT>)
+      if (__max_size_)
+        __output_.__reset(_VSTD::__to_address(__writer_.__out()), __max_size_);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI back_insert_iterator<__output_buffer<_CharT>>
+  __make_output_iterator() {
+    return __output_.__make_output_iterator();
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __flush(_CharT* __ptr, size_t __size) {
+    if (__size_ < __max_size_) {
+      __writer_.__flush(__ptr, _VSTD::min(__size, __max_size_ - __size_));
+      if constexpr (__enable_direct_output<_OutIt, _CharT>)
+        // The output is full, discard the rest of the output.
+        __output_.__reset(__storage_.__begin(), __storage_.__buffer_size);
+    }
+    __size_ += __size;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI format_to_n_result<_OutIt> __result() && {
+    __output_.__flush();
+    return {_VSTD::move(__writer_).__out(),
+            static_cast<iter_difference_t<_OutIt>>(__size_)};
+  }
+
+private:
+  __internal_storage<_CharT> __storage_;
+  __output_buffer<_CharT> __output_;
+  typename __writer_selector<_OutIt, _CharT>::type __writer_;
+  size_t __max_size_;
+  size_t __size_{0};
+};
+
+} // namespace __format
+
+#endif // !defined(_LIBCPP_HAS_NO_CONCEPTS)
+
+#endif //_LIBCPP_STD_VER > 17
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP___FORMAT_BUFFER_H
@@ -0,0 +1,124 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___MEMORY_RESOURCE_MONOTONIC_BUFFER_RESOURCE_H
+#define _LIBCPP___MEMORY_RESOURCE_MONOTONIC_BUFFER_RESOURCE_H
+
+#include <__config>
+#include <__memory_resource/memory_resource.h>
+#include <cstddef>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+#if _LIBCPP_STD_VER > 14
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace pmr {
+
+// [mem.res.monotonic.buffer]
+
+// The resource hands out memory from the current buffer by bumping a pointer.
+// When the current buffer is exhausted a new one is obtained from the upstream
+// resource. The size of the new buffers grows geometrically, so the number of
+// upstream allocations is logarithmic in the total amount of memory used.
+class _LIBCPP_TYPE_VIS monotonic_buffer_resource : public memory_resource {
+  static const size_t __default_buffer_capacity = 1024;
+  static const size_t __growth_factor           = 2;
+
+  struct _LIBCPP_HIDDEN __chunk_footer {
+    __chunk_footer* __next_;
+    char* __start_;
+    size_t __align_;
+
+    _LIBCPP_HIDE_FROM_ABI size_t __allocation_size() {
+      return (reinterpret_cast<char*>(this) - __start_) + sizeof(*this);
+    }
+  };
+
+public:
+  _LIBCPP_HIDE_FROM_ABI monotonic_buffer_resource()
+      : monotonic_buffer_resource(nullptr, __default_buffer_capacity, get_default_resource()) {}
+
+  _LIBCPP_HIDE_FROM_ABI explicit monotonic_buffer_resource(size_t __initial_size)
+      : monotonic_buffer_resource(nullptr, __initial_size, get_default_resource()) {}
+
+  _LIBCPP_HIDE_FROM_ABI monotonic_buffer_resource(void* __buffer, size_t __buffer_size)
+      : monotonic_buffer_resource(__buffer, __buffer_size, get_default_resource()) {}
+
+  _LIBCPP_HIDE_FROM_ABI explicit monotonic_buffer_resource(memory_resource* __upstream)
+      : monotonic_buffer_resource(nullptr, __default_buffer_capacity, __upstream) {}
+
+  _LIBCPP_HIDE_FROM_ABI monotonic_buffer_resource(size_t __initial_size, memory_resource* __upstream)
+      : monotonic_buffer_resource(nullptr, __initial_size, __upstream) {}
+
+  _LIBCPP_HIDE_FROM_ABI monotonic_buffer_resource(void* __buffer, size_t __buffer_size, memory_resource* __upstream)
+      : __res_(__upstream),
+        __initial_buffer_(static_cast<char*>(__buffer)),
+        __initial_size_(__buffer_size),
+        __chunks_(nullptr) {
+    __reset();
+  }
+
+  monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+
+  ~monotonic_buffer_resource() override { release(); }
+
+  monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+  _LIBCPP_HIDE_FROM_ABI void release() {
+    while (__chunks_ != nullptr) {
+      __chunk_footer* __next = __chunks_->__next_;
+      __res_->deallocate(__chunks_->__start_, __chunks_->__allocation_size(), __chunks_->__align_);
+      __chunks_ = __next;
+    }
+    __reset();
+  }
+
+  _LIBCPP_HIDE_FROM_ABI memory_resource* upstream_resource() const { return __res_; }
+
+protected:
+  void* do_allocate(size_t __bytes, size_t __alignment) override; // key function
+
+  void do_deallocate(void*, size_t, size_t) override {}
+
+  bool do_is_equal(const memory_resource& __other) const noexcept override { return this == &__other; }
+
+private:
+  // Makes the initial buffer, if any, the current buffer again.
+  _LIBCPP_HIDE_FROM_ABI void __reset() {
+    __cur_ = __initial_buffer_;
+    __end_ = __initial_buffer_ == nullptr ? nullptr : __initial_buffer_ + __initial_size_;
+    __next_buffer_size_ = __initial_size_ == 0 ? 1 : __initial_size_;
+    if (__initial_buffer_ != nullptr)
+      __next_buffer_size_ = __next_buffer_size(__next_buffer_size_);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI static size_t __next_buffer_size(size_t __size) {
+    return __size > size_t(-1) / __growth_factor ? size_t(-1) : __size * __growth_factor;
+  }
+
+  memory_resource* __res_;
+  char* __initial_buffer_;
+  size_t __initial_size_;
+  char* __cur_;
+  char* __end_;
+  size_t __next_buffer_size_;
+  __chunk_footer* __chunks_;
+};
+
+} // namespace pmr
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP_STD_VER > 14
+
+#endif // _LIBCPP___MEMORY_RESOURCE_MONOTONIC_BUFFER_RESOURCE_H
@@ -88,7 +88,12 @@ static void __libcpp_platform_wake_by_address(__cxx_atomic_contention_t const vo
 
 #endif // __linux__
 
-static constexpr size_t __libcpp_contention_table_size = (1 << 8);  /* < there's no magic in this number */
+// Unrelated atomics that hash to the same entry share its contention counter
+// and, for atomics that are not the platform wait size, its wake-up channel.
+// Keep the table large enough that a pool of a hundred or so waiting threads
+// rarely collides; the entries live in zero-initialized storage, so the ones
+// that are never used cost no memory.
+static constexpr size_t __libcpp_contention_table_size = (1 << 10);
 
 struct alignas(64) /*  aim to avoid false sharing */ __libcpp_contention_table_entry
 {
@@ -0,0 +1,438 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+#ifndef _LIBCPP_HAS_NO_ATOMIC_HEADER
+#  include <atomic>
+#elif !defined(_LIBCPP_HAS_NO_THREADS)
+#  include <mutex>
+#  if defined(__ELF__) && defined(_LIBCPP_LINK_PTHREAD_LIB)
+#    pragma comment(lib, "pthread")
+#  endif
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace pmr {
+
+// memory_resource
+
+memory_resource::~memory_resource() = default;
+
+// new_delete_resource()
+
+class _LIBCPP_TYPE_VIS __new_delete_memory_resource_imp : public memory_resource {
+  void* do_allocate(size_t __bytes, size_t __align) override { return std::__libcpp_allocate(__bytes, __align); }
+
+  void do_deallocate(void* __p, size_t __bytes, size_t __align) override {
+    std::__libcpp_deallocate(__p, __bytes, __align);
+  }
+
+  bool do_is_equal(const memory_resource& __other) const noexcept override { return &__other == this; }
+};
+
+// null_memory_resource()
+
+class _LIBCPP_TYPE_VIS __null_memory_resource_imp : public memory_resource {
+  void* do_allocate(size_t, size_t) override { __throw_bad_alloc(); }
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const memory_resource& __other) const noexcept override { return &__other == this; }
+};
+
+namespace {
+
+// The global resources are constant initialized and never destroyed, so they
+// can be used during the construction and destruction of other globals.
+union __resource_init_helper {
+  struct {
+    __new_delete_memory_resource_imp __new_delete_res;
+    __null_memory_resource_imp __null_res;
+  } __resources;
+  char __dummy;
+  constexpr __resource_init_helper() : __resources() {}
+  ~__resource_init_helper() {}
+};
+
+constinit __resource_init_helper __res_init;
+
+} // namespace
+
+memory_resource* new_delete_resource() noexcept { return &__res_init.__resources.__new_delete_res; }
+
+memory_resource* null_memory_resource() noexcept { return &__res_init.__resources.__null_res; }
+
+// default_memory_resource()
+
+static memory_resource* __default_memory_resource(bool __set = false, memory_resource* __new_res = nullptr) noexcept {
+#ifndef _LIBCPP_HAS_NO_ATOMIC_HEADER
+  static constinit atomic<memory_resource*> __res{&__res_init.__resources.__new_delete_res};
+  if (__set) {
+    __new_res = __new_res ? __new_res : new_delete_resource();
+    // TODO: Can a weaker ordering be used?
+    return std::atomic_exchange_explicit(&__res, __new_res, memory_order_acq_rel);
+  } else {
+    return std::atomic_load_explicit(&__res, memory_order_acquire);
+  }
+#elif !defined(_LIBCPP_HAS_NO_THREADS)
+  static constinit memory_resource* __res = &__res_init.__resources.__new_delete_res;
+  static mutex __res_lock;
+  if (__set) {
+    __new_res = __new_res ? __new_res : new_delete_resource();
+    lock_guard<mutex> __guard(__res_lock);
+    memory_resource* __old_res = __res;
+    __res                      = __new_res;
+    return __old_res;
+  } else {
+    lock_guard<mutex> __guard(__res_lock);
+    return __res;
+  }
+#else
+  static constinit memory_resource* __res = &__res_init.__resources.__new_delete_res;
+  if (__set) {
+    __new_res = __new_res ? __new_res : new_delete_resource();
+    memory_resource* __old_res = __res;
+    __res                      = __new_res;
+    return __old_res;
+  } else {
+    return __res;
+  }
+#endif
+}
+
+memory_resource* get_default_resource() noexcept { return __default_memory_resource(); }
+
+memory_resource* set_default_resource(memory_resource* __new_res) noexcept {
+  return __default_memory_resource(true, __new_res);
+}
+
+// 23.12.5, mem.res.pool
+
+static size_t __roundup(size_t __count, size_t __alignment) {
+  size_t __mask = __alignment - 1;
+  return (__count + __mask) & ~__mask;
+}
+
+// The ad-hoc pool hands out the blocks that are too large for the fixed
+// pools. Every block has a footer, placed right after the requested bytes.
+// Since the caller passes the same size on deallocation the footer is found
+// without a search, and the block is unlinked in constant time.
+
+struct unsynchronized_pool_resource::__adhoc_pool::__chunk_footer {
+  __chunk_footer* __next_;
+  __chunk_footer* __prev_;
+  char* __start_;
+  size_t __align_;
+  size_t __allocation_size() { return (reinterpret_cast<char*>(this) - __start_) + sizeof(*this); }
+};
+
+void unsynchronized_pool_resource::__adhoc_pool::__release(memory_resource* __upstream) {
+  while (__first_ != nullptr) {
+    __chunk_footer* __next = __first_->__next_;
+    __upstream->deallocate(__first_->__start_, __first_->__allocation_size(), __first_->__align_);
+    __first_ = __next;
+  }
+}
+
+void* unsynchronized_pool_resource::__adhoc_pool::__do_allocate(
+    memory_resource* __upstream, size_t __bytes, size_t __align) {
+  const size_t __footer_size  = sizeof(__chunk_footer);
+  const size_t __footer_align = alignof(__chunk_footer);
+
+  if (__bytes > size_t(-1) - __footer_size - __footer_align)
+    __throw_bad_alloc();
+
+  if (__align < __footer_align)
+    __align = __footer_align;
+
+  size_t __aligned_capacity = __roundup(__bytes, __footer_align) + __footer_size;
+
+  void* __result = __upstream->allocate(__aligned_capacity, __align);
+
+  __chunk_footer* __h =
+      reinterpret_cast<__chunk_footer*>(static_cast<char*>(__result) + __aligned_capacity - __footer_size);
+  __h->__next_  = __first_;
+  __h->__prev_  = nullptr;
+  __h->__start_ = static_cast<char*>(__result);
+  __h->__align_ = __align;
+  if (__first_ != nullptr)
+    __first_->__prev_ = __h;
+  __first_ = __h;
+  return __result;
+}
+
+void unsynchronized_pool_resource::__adhoc_pool::__do_deallocate(
+    memory_resource* __upstream, void* __p, size_t __bytes, size_t) {
+  _LIBCPP_ASSERT(__first_ != nullptr, "deallocating a block that was not allocated with this allocator");
+  __chunk_footer* __h =
+      reinterpret_cast<__chunk_footer*>(static_cast<char*>(__p) + __roundup(__bytes, alignof(__chunk_footer)));
+  _LIBCPP_ASSERT(__h->__start_ == __p, "deallocating a block that was not allocated with this allocator");
+
+  if (__h->__prev_ != nullptr)
+    __h->__prev_->__next_ = __h->__next_;
+  else
+    __first_ = __h->__next_;
+  if (__h->__next_ != nullptr)
+    __h->__next_->__prev_ = __h->__prev_;
+
+  __upstream->deallocate(__p, __h->__allocation_size(), __h->__align_);
+}
+
+// A fixed pool hands out the blocks of one size class.
+//
+// New blocks are carved from the newest chunk in address order, so the memory
+// of a chunk is only touched when it is handed out. Deallocated blocks are put
+// on a LIFO free list, so the most recently used, and likely cached, memory is
+// reused first. The number of blocks per chunk doubles with every new chunk.
+
+class unsynchronized_pool_resource::__fixed_pool {
+  struct __chunk_footer {
+    __chunk_footer* __next_;
+    char* __start_;
+    size_t __align_;
+    size_t __allocation_size() { return (reinterpret_cast<char*>(this) - __start_) + sizeof(*this); }
+  };
+
+  struct __vacancy_header {
+    __vacancy_header* __next_vacancy_;
+  };
+
+  __chunk_footer* __first_chunk_     = nullptr;
+  __vacancy_header* __first_vacancy_ = nullptr;
+  char* __cur_                       = nullptr;
+  char* __end_                       = nullptr;
+  size_t __next_chunk_blocks_        = 0;
+
+  void* __allocate_in_new_chunk(memory_resource* __upstream, size_t __block_size, size_t __max_blocks) {
+    const size_t __footer_size  = sizeof(__chunk_footer);
+    const size_t __footer_align = alignof(__chunk_footer);
+
+    size_t __limit = __max_bytes_per_chunk / __block_size;
+    if (__limit > __max_blocks)
+      __limit = __max_blocks;
+    if (__limit == 0)
+      __limit = 1;
+
+    if (__next_chunk_blocks_ == 0) {
+      __next_chunk_blocks_ = __min_bytes_per_chunk / __block_size;
+      if (__next_chunk_blocks_ < __min_blocks_per_chunk)
+        __next_chunk_blocks_ = __min_blocks_per_chunk;
+    }
+    size_t __blocks = __next_chunk_blocks_ < __limit ? __next_chunk_blocks_ : __limit;
+
+    // The block size is a power of two and at least as large as the
+    // alignment of the footer, so the footer is suitably aligned.
+    size_t __bytes = __blocks * __block_size;
+    size_t __align = alignof(max_align_t) < __footer_align ? __footer_align : alignof(max_align_t);
+    char* __start  = static_cast<char*>(__upstream->allocate(__bytes + __footer_size, __align));
+
+    __chunk_footer* __h = reinterpret_cast<__chunk_footer*>(__start + __bytes);
+    __h->__next_        = __first_chunk_;
+    __h->__start_       = __start;
+    __h->__align_       = __align;
+    __first_chunk_      = __h;
+
+    __cur_ = __start + __block_size;
+    __end_ = __start + __bytes;
+
+    __next_chunk_blocks_ = __blocks > __limit / 2 ? __limit : __blocks * 2;
+    return __start;
+  }
+
+public:
+  void __release(memory_resource* __upstream) {
+    while (__first_chunk_ != nullptr) {
+      __chunk_footer* __next = __first_chunk_->__next_;
+      __upstream->deallocate(__first_chunk_->__start_, __first_chunk_->__allocation_size(), __first_chunk_->__align_);
+      __first_chunk_ = __next;
+    }
+    __first_vacancy_     = nullptr;
+    __cur_               = nullptr;
+    __end_               = nullptr;
+    __next_chunk_blocks_ = 0;
+  }
+
+  void* __allocate(memory_resource* __upstream, size_t __block_size, size_t __max_blocks) {
+    if (__first_vacancy_ != nullptr) {
+      void* __result   = __first_vacancy_;
+      __first_vacancy_ = __first_vacancy_->__next_vacancy_;
+      return __result;
+    }
+    if (__cur_ != __end_) {
+      void* __result = __cur_;
+      __cur_ += __block_size;
+      return __result;
+    }
+    return __allocate_in_new_chunk(__upstream, __block_size, __max_blocks);
+  }
+
+  void __evacuate(void* __p) {
+    __vacancy_header* __h = static_cast<__vacancy_header*>(__p);
+    __h->__next_vacancy_  = __first_vacancy_;
+    __first_vacancy_      = __h;
+  }
+};
+
+size_t unsynchronized_pool_resource::__pool_block_size(int __i) const { return size_t(1) << __log2_pool_block_size(__i); }
+
+int unsynchronized_pool_resource::__log2_pool_block_size(int __i) const { return (__i + __log2_smallest_block_size); }
+
+int unsynchronized_pool_resource::__pool_index(size_t __bytes, size_t __align) const {
+  if (__align > alignof(max_align_t) || __bytes > __pool_block_size(__num_fixed_pools_ - 1))
+    return __num_fixed_pools_;
+  if (__bytes < __align)
+    __bytes = __align;
+  if (__bytes <= __smallest_block_size)
+    return 0;
+  return static_cast<int>(std::__bit_log2(__bytes - 1)) + 1 - __log2_smallest_block_size;
+}
+
+unsynchronized_pool_resource::unsynchronized_pool_resource(const pool_options& __opts, memory_resource* __upstream)
+    : __res_(__upstream), __fixed_pools_(nullptr) {
+  size_t __largest_block_size;
+  if (__opts.largest_required_pool_block == 0)
+    __largest_block_size = __default_largest_block_size;
+  else if (__opts.largest_required_pool_block < __smallest_block_size)
+    __largest_block_size = __smallest_block_size;
+  else if (__opts.largest_required_pool_block > __max_largest_block_size)
+    __largest_block_size = __max_largest_block_size;
+  else
+    __largest_block_size = __opts.largest_required_pool_block;
+
+  if (__opts.max_blocks_per_chunk == 0)
+    __options_max_blocks_per_chunk_ = __max_blocks_per_chunk;
+  else if (__opts.max_blocks_per_chunk < __min_blocks_per_chunk)
+    __options_max_blocks_per_chunk_ = __min_blocks_per_chunk;
+  else if (__opts.max_blocks_per_chunk > __max_blocks_per_chunk)
+    __options_max_blocks_per_chunk_ = __max_blocks_per_chunk;
+  else
+    __options_max_blocks_per_chunk_ = __opts.max_blocks_per_chunk;
+
+  __num_fixed_pools_ = 1;
+  size_t __capacity  = __smallest_block_size;
+  while (__capacity < __largest_block_size) {
+    __capacity <<= 1;
+    __num_fixed_pools_ += 1;
+  }
+}
+
+pool_options unsynchronized_pool_resource::options() const {
+  pool_options __p;
+  __p.max_blocks_per_chunk        = __options_max_blocks_per_chunk_;
+  __p.largest_required_pool_block = __pool_block_size(__num_fixed_pools_ - 1);
+  return __p;
+}
+
+void unsynchronized_pool_resource::release() {
+  __adhoc_pool_.__release(__res_);
+  if (__fixed_pools_ != nullptr) {
+    const int __n = __num_fixed_pools_;
+    for (int __i = 0; __i < __n; ++__i)
+      __fixed_pools_[__i].__release(__res_);
+    __res_->deallocate(__fixed_pools_, __num_fixed_pools_ * sizeof(__fixed_pool), alignof(__fixed_pool));
+    __fixed_pools_ = nullptr;
+  }
+}
+
+void* unsynchronized_pool_resource::do_allocate(size_t __bytes, size_t __align) {
+  // A pointer to allocated storage (6.6.4.4.1) with a size of at least bytes.
+  // The size and alignment of the allocated memory shall meet the requirements for
+  // a class derived from memory_resource (23.12).
+  // If the pool selected for a block of size bytes is unable to satisfy the memory request
+  // from its own internal data structures, it will call upstream_resource()->allocate()
+  // to obtain more memory. If bytes is larger than that which the largest pool can handle,
+  // then memory will be allocated using upstream_resource()->allocate().
+
+  int __i = __pool_index(__bytes, __align);
+  if (__i == __num_fixed_pools_)
+    return __adhoc_pool_.__do_allocate(__res_, __bytes, __align);
+
+  if (__fixed_pools_ == nullptr) {
+    __fixed_pools_ =
+        static_cast<__fixed_pool*>(__res_->allocate(__num_fixed_pools_ * sizeof(__fixed_pool), alignof(__fixed_pool)));
+    __fixed_pool* __first = __fixed_pools_;
+    __fixed_pool* __last  = __fixed_pools_ + __num_fixed_pools_;
+    for (__fixed_pool* __pool = __first; __pool != __last; ++__pool)
+      ::new ((void*)__pool) __fixed_pool;
+  }
+
+  return __fixed_pools_[__i].__allocate(__res_, __pool_block_size(__i), __options_max_blocks_per_chunk_);
+}
+
+void unsynchronized_pool_resource::do_deallocate(void* __p, size_t __bytes, size_t __align) {
+  // Returns the memory at p to the pool. It is unspecified if,
+  // or under what circumstances, this operation will result in
+  // a call to upstream_resource()->deallocate().
+
+  int __i = __pool_index(__bytes, __align);
+  if (__i == __num_fixed_pools_)
+    return __adhoc_pool_.__do_deallocate(__res_, __p, __bytes, __align);
+
+  _LIBCPP_ASSERT(__fixed_pools_ != nullptr, "deallocating a block that was not allocated with this allocator");
+  __fixed_pools_[__i].__evacuate(__p);
+}
+
+// 23.12.6, mem.res.monotonic.buffer
+
+static void* __try_allocate_from_buffer(char*& __cur, char* __end, size_t __bytes, size_t __align) {
+  if (__cur == nullptr)
+    return nullptr;
+  uintptr_t __c       = reinterpret_cast<uintptr_t>(__cur);
+  uintptr_t __aligned = (__c + (__align - 1)) & ~uintptr_t(__align - 1);
+  uintptr_t __e       = reinterpret_cast<uintptr_t>(__end);
+  if (__aligned < __c || __aligned > __e || __e - __aligned < __bytes)
+    return nullptr;
+  char* __result = __cur + (__aligned - __c);
+  __cur          = __result + __bytes;
+  return __result;
+}
+
+void* monotonic_buffer_resource::do_allocate(size_t __bytes, size_t __align) {
+  if (void* __result = __try_allocate_from_buffer(__cur_, __end_, __bytes, __align))
+    return __result;
+
+  // Allocate a new buffer from the upstream resource. The new buffer is at
+  // least as large as the request, and larger than the previous buffer by the
+  // growth factor.
+  const size_t __footer_size  = sizeof(__chunk_footer);
+  const size_t __footer_align = alignof(__chunk_footer);
+
+  if (__bytes > size_t(-1) - __footer_size - __footer_align)
+    __throw_bad_alloc();
+
+  size_t __capacity = __next_buffer_size_;
+  while (__capacity < __bytes)
+    __capacity = __next_buffer_size(__capacity);
+  if (__capacity > size_t(-1) - __footer_size - __footer_align)
+    __capacity = size_t(-1) - __footer_size - __footer_align;
+  __capacity = __roundup(__capacity, __footer_align);
+
+  if (__align < __footer_align)
+    __align = __footer_align;
+
+  char* __start = static_cast<char*>(__res_->allocate(__capacity + __footer_size, __align));
+
+  __chunk_footer* __h = reinterpret_cast<__chunk_footer*>(__start + __capacity);
+  __h->__next_        = __chunks_;
+  __h->__start_       = __start;
+  __h->__align_       = __align;
+  __chunks_           = __h;
+
+  __cur_              = __start + __bytes;
+  __end_              = __start + __capacity;
+  __next_buffer_size_ = __next_buffer_size(__capacity);
+  return __start;
+}
+
+} // namespace pmr
+
+_LIBCPP_END_NAMESPACE_STD
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03
+
+// <algorithm>
+
+// find, count, mismatch, equal and search compare integers a vector at a time.
+// Check them against plain loops for every length and position around the
+// vector and unrolling boundaries, and for values of a different type than the
+// elements.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "test_macros.h"
+
+// The point is to compare elements with values of another signedness.
+#if defined(TEST_COMPILER_CLANG) || defined(TEST_COMPILER_GCC)
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#endif
+
+template <class It, class T>
+It simple_find(It first, It last, const T& value) {
+  for (; first != last; ++first)
+    if (*first == value)
+      break;
+  return first;
+}
+
+template <class It, class T>
+std::ptrdiff_t simple_count(It first, It last, const T& value) {
+  std::ptrdiff_t n = 0;
+  for (; first != last; ++first)
+    if (*first == value)
+      ++n;
+  return n;
+}
+
+template <class T, class V>
+void test(V other_value) {
+  for (std::size_t n = 0; n != 300; ++n) {
+    std::vector<T> a(n, T(1));
+    for (std::size_t i = 0; i < n; i += 7)
+      a[i] = T(-1);
+
+    for (std::size_t pos = 0; pos <= n; ++pos) {
+      std::vector<T> b = a;
+      if (pos != n)
+        b[pos] = T(2);
+
+      auto f = std::find(b.begin(), b.end(), T(2));
+      assert(f == simple_find(b.begin(), b.end(), T(2)));
+      assert(static_cast<std::size_t>(f - b.begin()) == pos);
+      assert(std::find(b.data(), b.data() + n, other_value) == simple_find(b.data(), b.data() + n, other_value));
+      assert(std::count(b.begin(), b.end(), T(1)) == simple_count(b.begin(), b.end(), T(1)));
+      assert(std::count(b.begin(), b.end(), other_value) == simple_count(b.begin(), b.end(), other_value));
+
+      auto m = std::mismatch(a.begin(), a.end(), b.begin());
+      assert(static_cast<std::size_t>(m.first - a.begin()) == pos);
+      assert(static_cast<std::size_t>(m.second - b.begin()) == pos);
+      assert(std::equal(a.begin(), a.end(), b.begin()) == (pos == n));
+#if TEST_STD_VER >= 14
+      auto m2 = std::mismatch(a.begin(), a.end(), b.begin(), b.begin() + pos / 2);
+      assert(static_cast<std::size_t>(m2.first - a.begin()) == pos / 2);
+      assert(std::equal(a.begin(), a.begin() + pos, b.begin(), b.begin() + pos));
+#endif
+    }
+
+    // A pattern which occurs once, at the end, after many partial matches.
+    std::vector<T> needle(5, T(1));
+    needle[0] = T(-1);
+    needle.back() = T(3);
+    if (n >= needle.size()) {
+      std::vector<T> haystack = a;
+      std::copy(needle.begin(), needle.end(), haystack.end() - needle.size());
+      auto s = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end());
+      assert(s == haystack.end() - needle.size());
+      needle.back() = T(4);
+      assert(std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end()) == haystack.end());
+    }
+  }
+}
+
+int main(int, char**) {
+  test<char>(-1);
+  test<signed char>(255);
+  test<unsigned char>(-1);
+  test<unsigned char>(255);
+  test<short>(-1);
+  test<unsigned short>(65535);
+  test<int>(-1);
+  test<int>(4294967295u);
+  test<unsigned>(-1);
+  test<unsigned>(-1LL);
+  test<long long>(-1);
+  test<std::uint64_t>(-1);
+
+  return 0;
+}
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// <ext/flat_hash_map>
+
+#include <ext/flat_hash_map>
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+struct Counted {
+  static int live;
+  int value;
+  Counted(int v) : value(v) { ++live; }
+  Counted(const Counted& other) : value(other.value) { ++live; }
+  ~Counted() { --live; }
+};
+int Counted::live = 0;
+
+int main(int, char**) {
+  {
+    std::__flat_hash_map<int, std::vector<int> > m;
+    for (int i = 0; i < 1000; ++i)
+      m[i].push_back(i);
+    for (int i = 0; i < 1000; ++i)
+      m[i].push_back(-i);
+    assert(m.size() == 1000);
+    assert(m.at(7).size() == 2 && m.at(7)[1] == -7);
+
+    assert(!m.try_emplace(5, 3, 3).second);
+    assert(m.try_emplace(5000, 3, 3).second);
+    assert(m[5000].size() == 3);
+    assert(!m.insert_or_assign(5000, std::vector<int>{1}).second);
+    assert(m[5000].size() == 1);
+    assert(m.insert({6000, {}}).second);
+    assert(m.emplace(std::make_pair(6001, std::vector<int>())).second);
+    assert(m.emplace(6002, std::vector<int>()).second);
+    assert(!m.emplace(6002, std::vector<int>()).second);
+
+#ifndef TEST_HAS_NO_EXCEPTIONS
+    try {
+      (void)m.at(-5);
+      assert(false);
+    } catch (const std::out_of_range&) {
+    }
+#endif
+
+    auto c = m;
+    assert(c == m);
+    c[1].push_back(1);
+    assert(c != m);
+  }
+  {
+    // The argument refers to an element of the table which is about to grow.
+    std::__flat_hash_map<int, std::vector<int> > m;
+    m[0] = std::vector<int>(100, 7);
+    for (int i = 1; i < 2000; ++i)
+      assert(m.try_emplace(i, m.at(i - 1)).second);
+    for (int i = 0; i < 2000; ++i)
+      assert(m.at(i).size() == 100 && m.at(i)[99] == 7);
+  }
+  {
+    {
+      std::__flat_hash_map<int, Counted> m;
+      for (int i = 0; i < 1000; ++i)
+        m.try_emplace(i, i);
+      for (int i = 0; i < 1000; i += 2)
+        m.erase(i);
+      assert(Counted::live == 500);
+      auto copy = m;
+      assert(Counted::live == 1000);
+      copy.clear();
+      assert(Counted::live == 500);
+    }
+    assert(Counted::live == 0);
+  }
+
+  return 0;
+}
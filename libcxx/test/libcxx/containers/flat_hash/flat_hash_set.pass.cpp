@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// <ext/flat_hash_set>
+
+// Check the open addressing __flat_hash_set extension against a set which
+// grows, shrinks and churns through tombstones.
+
+#include <ext/flat_hash_set>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+#include "test_macros.h"
+
+struct BadHash {
+  std::size_t operator()(int) const { return 42; }
+};
+
+template <class Set>
+void test() {
+  Set s;
+  assert(s.empty());
+  assert(s.begin() == s.end());
+  assert(s.find(3) == s.end());
+  assert(s.bucket_count() == 0);
+
+  for (int i = 0; i < 2000; ++i)
+    assert(s.insert(i).second);
+  for (int i = 0; i < 2000; ++i)
+    assert(!s.insert(i).second);
+  assert(s.size() == 2000);
+  for (int i = 0; i < 2000; ++i)
+    assert(s.contains(i) && *s.find(i) == i);
+  assert(!s.contains(2000));
+  assert(!s.contains(-1));
+
+  std::size_t n = 0;
+  long sum = 0;
+  for (int v : s) {
+    ++n;
+    sum += v;
+  }
+  assert(n == 2000);
+  assert(sum == 1999L * 2000 / 2);
+
+  for (int i = 0; i < 2000; i += 2)
+    assert(s.erase(i) == 1);
+  assert(s.erase(0) == 0);
+  assert(s.size() == 1000);
+  for (int i = 0; i < 2000; ++i)
+    assert(s.contains(i) == (i % 2 == 1));
+
+  // Inserting and erasing the same number of elements must not grow the table
+  // without bound.
+  std::size_t buckets = s.bucket_count();
+  for (int r = 0; r < 20; ++r) {
+    for (int i = 0; i < 500; ++i)
+      s.insert(100000 + r * 500 + i);
+    for (int i = 0; i < 500; ++i)
+      assert(s.erase(100000 + r * 500 + i) == 1);
+  }
+  assert(s.size() == 1000);
+  assert(s.bucket_count() <= 2 * buckets);
+  for (int i = 0; i < 2000; ++i)
+    assert(s.contains(i) == (i % 2 == 1));
+
+  Set c = s;
+  assert(c == s);
+  Set m = std::move(c);
+  assert(m == s);
+  c = m;
+  assert(c == s);
+  c.erase(1);
+  assert(c != s);
+
+  assert(erase_if(c, [](int v) { return v < 1000; }) == 499);
+  assert(c.size() == 500);
+  for (int v : c)
+    assert(v >= 1000);
+  for (auto it = c.begin(); it != c.end();)
+    it = c.erase(it);
+  assert(c.empty());
+
+  s.clear();
+  assert(s.empty());
+  s.rehash(0);
+  assert(s.bucket_count() == 0);
+  s.reserve(100);
+  std::size_t reserved = s.bucket_count();
+  for (int i = 0; i < 100; ++i)
+    s.insert(i);
+  assert(s.bucket_count() == reserved);
+
+  auto r = s.equal_range(5);
+  assert(r.first != r.second && *r.first == 5);
+  r = s.equal_range(500);
+  assert(r.first == r.second);
+
+  for (int k = 0; k < 40; ++k) {
+    Set a;
+    for (int i = 0; i < k; ++i)
+      a.emplace(i * 7);
+    assert(static_cast<int>(a.size()) == k);
+    for (int i = 0; i < k; i += 3)
+      a.erase(i * 7);
+    for (int i = 0; i < k; ++i)
+      assert(a.count(i * 7) == (i % 3 != 0));
+    a.erase(a.begin(), a.end());
+    assert(a.empty());
+  }
+}
+
+int main(int, char**) {
+  test<std::__flat_hash_set<int> >();
+  test<std::__flat_hash_set<int, BadHash> >();
+
+  return 0;
+}
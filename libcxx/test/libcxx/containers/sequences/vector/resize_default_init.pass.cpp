@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <vector>
+
+// void __resize_default_init(size_type);
+
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+#include "min_allocator.h"
+#include "test_allocator.h"
+#include "test_macros.h"
+
+struct NonTrivial {
+  int value;
+  NonTrivial() : value(42) {}
+};
+
+// An allocator whose construct() must be called for every element.
+template <class T>
+struct ConstructingAllocator : std::allocator<T> {
+  template <class U>
+  struct rebind {
+    typedef ConstructingAllocator<U> other;
+  };
+
+  ConstructingAllocator() {}
+  template <class U>
+  ConstructingAllocator(const ConstructingAllocator<U>&) {}
+
+  template <class U>
+  void construct(U* p) {
+    ::new ((void*)p) U(7);
+  }
+};
+
+template <class Vector>
+void test_trivial() {
+  typedef typename Vector::value_type T;
+  Vector v;
+  v.__resize_default_init(3);
+  assert(v.size() == 3);
+  assert(v.capacity() >= 3);
+  for (std::size_t i = 0; i < 3; ++i)
+    v[i] = T(i);
+
+  // Growing within the capacity.
+  v.reserve(100);
+  v.__resize_default_init(50);
+  assert(v.size() == 50);
+  for (std::size_t i = 3; i < 50; ++i)
+    v[i] = T(i);
+
+  // Growing past the capacity keeps the existing elements.
+  v.__resize_default_init(1000);
+  assert(v.size() == 1000);
+  for (std::size_t i = 0; i < 50; ++i)
+    assert(v[i] == T(i));
+
+  // Shrinking.
+  v.__resize_default_init(10);
+  assert(v.size() == 10);
+  for (std::size_t i = 0; i < 10; ++i)
+    assert(v[i] == T(i));
+
+  v.__resize_default_init(0);
+  assert(v.empty());
+}
+
+int main(int, char**) {
+  test_trivial<std::vector<char> >();
+  test_trivial<std::vector<int> >();
+  test_trivial<std::vector<double> >();
+  test_trivial<std::vector<int, min_allocator<int> > >();
+  test_trivial<std::vector<int, test_allocator<int> > >();
+
+  // Types which cannot be default-initialized without running code are
+  // value-initialized, like with resize().
+  {
+    std::vector<NonTrivial> v;
+    v.__resize_default_init(5);
+    assert(v.size() == 5);
+    for (std::size_t i = 0; i < 5; ++i)
+      assert(v[i].value == 42);
+  }
+  {
+    std::vector<int, ConstructingAllocator<int> > v;
+    v.__resize_default_init(5);
+    assert(v.size() == 5);
+    for (std::size_t i = 0; i < 5; ++i)
+      assert(v[i] == 7);
+    v.__resize_default_init(500);
+    for (std::size_t i = 0; i < 500; ++i)
+      assert(v[i] == 7);
+  }
+
+  return 0;
+}
@@ -89,6 +89,8 @@
 #ifndef _LIBCPP_HAS_NO_FILESYSTEM_LIBRARY
 #    include <filesystem>
 #endif
+#include <flat_map>
+#include <flat_set>
 #include <float.h>
 #ifndef _LIBCPP_HAS_NO_INCOMPLETE_FORMAT
 #    include <format>
@@ -132,6 +134,7 @@
 #include <map>
 #include <math.h>
 #include <memory>
+#include <memory_resource>
 #ifndef _LIBCPP_HAS_NO_THREADS
 #    include <mutex>
 #endif
@@ -231,6 +234,8 @@
 #endif // __cplusplus >= 201103L
 
 // extended headers
+#include <ext/flat_hash_map>
+#include <ext/flat_hash_set>
 #include <ext/hash_map>
 #include <ext/hash_set>
 
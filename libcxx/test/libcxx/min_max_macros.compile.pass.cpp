@@ -136,6 +136,10 @@ TEST_MACROS();
 #    include <filesystem>
 TEST_MACROS();
 #endif
+#include <flat_map>
+TEST_MACROS();
+#include <flat_set>
+TEST_MACROS();
 #include <float.h>
 TEST_MACROS();
 #ifndef _LIBCPP_HAS_NO_INCOMPLETE_FORMAT
@@ -202,6 +206,8 @@ TEST_MACROS();
 TEST_MACROS();
 #include <memory>
 TEST_MACROS();
+#include <memory_resource>
+TEST_MACROS();
 #ifndef _LIBCPP_HAS_NO_THREADS
 #    include <mutex>
 TEST_MACROS();
@@ -366,6 +372,10 @@ TEST_MACROS();
 #endif // __cplusplus >= 201103L
 
 // extended headers
+#include <ext/flat_hash_map>
+TEST_MACROS();
+#include <ext/flat_hash_set>
+TEST_MACROS();
 #include <ext/hash_map>
 TEST_MACROS();
 #include <ext/hash_set>
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17
+// UNSUPPORTED: libcpp-no-concepts
+// UNSUPPORTED: libcpp-has-no-incomplete-format
+// TODO FMT Evaluate gcc-11 status
+// UNSUPPORTED: gcc-11
+
+// This test requires the dylib support introduced in D92214.
+// XFAIL: use_system_cxx_lib && target={{.+}}-apple-macosx10.{{9|10|11|12|13|14|15}}
+
+// <format>
+
+// Tests the output buffers used by the formatting functions. The output is
+// larger than the internal storage of the buffers, so every kind of buffer is
+// flushed multiple times.
+
+#include <format>
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "test_macros.h"
+#include "make_string.h"
+
+#define SV(S) MAKE_STRING_VIEW(CharT, S)
+
+template <class OutIt, class CharT, class Writer>
+constexpr bool uses_writer =
+    std::same_as<typename std::__format::__writer_selector<OutIt, CharT>::type, Writer>;
+
+static_assert(uses_writer<std::back_insert_iterator<std::string>, char,
+                          std::__format::__writer_container<std::string>>);
+static_assert(uses_writer<std::back_insert_iterator<std::vector<char>>, char,
+                          std::__format::__writer_container<std::vector<char>>>);
+static_assert(uses_writer<std::back_insert_iterator<std::vector<int>>, char,
+                          std::__format::__writer_iterator<std::back_insert_iterator<std::vector<int>>, char>>);
+static_assert(uses_writer<char*, char, std::__format::__writer_direct<char*, char>>);
+static_assert(uses_writer<std::string::iterator, char, std::__format::__writer_direct<std::string::iterator, char>>);
+static_assert(uses_writer<std::list<char>::iterator, char,
+                          std::__format::__writer_iterator<std::list<char>::iterator, char>>);
+
+template <class CharT>
+void test() {
+  // Literal text, escapes and replacement fields spanning several flushes.
+  std::basic_string<CharT> fmt;
+  std::basic_string<CharT> expected;
+  for (int i = 0; i < 50; ++i) {
+    fmt += SV("ab{{c}}d{:>7}");
+    expected += SV("ab{c}d");
+    expected += std::format(SV("{:>7}"), i % 10 * 11);
+  }
+  auto format_fmt = [&](auto out) {
+    return std::format_to(out, fmt, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99,
+                          0, 11, 22, 33, 44, 55, 66, 77, 88, 99, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99, 0, 11, 22, 33,
+                          44, 55, 66, 77, 88, 99);
+  };
+  {
+    std::basic_string<CharT> out = std::format(fmt, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99, 0, 11, 22, 33, 44, 55,
+                                               66, 77, 88, 99, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99, 0, 11, 22, 33, 44,
+                                               55, 66, 77, 88, 99, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99);
+    assert(out == expected);
+  }
+  {
+    std::vector<CharT> out;
+    format_fmt(std::back_inserter(out));
+    assert(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+  }
+  {
+    std::deque<CharT> out;
+    format_fmt(std::back_inserter(out));
+    assert(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+  }
+  {
+    std::list<CharT> out(expected.size());
+    auto it = format_fmt(out.begin());
+    assert(it == out.end());
+    assert(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+  }
+  {
+    std::basic_string<CharT> out(expected.size(), CharT(' '));
+    auto it = format_fmt(out.begin());
+    assert(it == out.end());
+    assert(out == expected);
+  }
+  {
+    std::vector<CharT> out(expected.size() + 1, CharT('*'));
+    CharT* it = format_fmt(out.data());
+    assert(it == out.data() + expected.size());
+    assert(std::equal(out.begin(), out.end() - 1, expected.begin(), expected.end()));
+    assert(out.back() == CharT('*'));
+  }
+
+  // A single large replacement field.
+  std::basic_string<CharT> large(1000, CharT('x'));
+  assert(std::formatted_size(SV("{}"), large) == 1000);
+  assert(std::formatted_size(SV("{:>2000}"), large) == 2000);
+  assert(std::formatted_size(fmt, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99,
+                             0, 11, 22, 33, 44, 55, 66, 77, 88, 99, 0, 11, 22, 33, 44, 55, 66, 77, 88, 99, 0, 11, 22, 33,
+                             44, 55, 66, 77, 88, 99) == expected.size());
+
+  for (std::ptrdiff_t n : {0, 1, 255, 256, 257, 999, 1000, 1001, 5000}) {
+    std::size_t written = std::min<std::size_t>(n, 1000);
+    {
+      std::vector<CharT> out(1001, CharT('*'));
+      auto result = std::format_to_n(out.data(), n, SV("{}"), large);
+      assert(result.size == 1000);
+      assert(result.out == out.data() + written);
+      assert(std::count(out.begin(), out.end(), CharT('x')) == static_cast<std::ptrdiff_t>(written));
+      assert(std::count(out.begin(), out.end(), CharT('*')) == static_cast<std::ptrdiff_t>(1001 - written));
+    }
+    {
+      std::basic_string<CharT> out;
+      auto result = std::format_to_n(std::back_inserter(out), n, SV("{}"), large);
+      assert(result.size == 1000);
+      assert(out == large.substr(0, written));
+    }
+    {
+      std::list<CharT> out;
+      auto result = std::format_to_n(std::back_inserter(out), n, SV("{}"), large);
+      assert(result.size == 1000);
+      assert(out.size() == written);
+    }
+  }
+}
+
+int main(int, char**) {
+  test<char>();
+#ifndef TEST_HAS_NO_WIDE_CHARACTERS
+  test<wchar_t>();
+#endif
+
+  return 0;
+}
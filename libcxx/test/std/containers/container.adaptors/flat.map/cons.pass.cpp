@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <flat_map>
+
+// flat_map(key_container_type key_cont, mapped_container_type mapped_cont,
+//          const key_compare& comp = key_compare());
+// flat_map(sorted_unique_t, key_container_type key_cont,
+//          mapped_container_type mapped_cont, const key_compare& comp = key_compare());
+// flat_map(initializer_list<value_type> il, const key_compare& comp = key_compare());
+
+#include <flat_map>
+#include <cassert>
+#include <functional>
+#include <vector>
+
+#include "test_macros.h"
+
+int main(int, char**) {
+  {
+    std::flat_map<int, int> m;
+    assert(m.empty() && m.begin() == m.end());
+  }
+  {
+    // The first of several equivalent keys is kept.
+    std::flat_map<int, int> m{{3, 30}, {1, 10}, {3, 31}, {2, 20}};
+    assert((m.keys() == std::vector<int>{1, 2, 3}));
+    assert((m.values() == std::vector<int>{10, 20, 30}));
+  }
+  {
+    std::flat_map<int, int> m(std::vector<int>{9, 1, 7, 1}, std::vector<int>{90, 10, 70, 11});
+    assert((m.keys() == std::vector<int>{1, 7, 9}));
+    assert((m.values() == std::vector<int>{10, 70, 90}));
+  }
+  {
+    std::flat_map<int, int, std::greater<int> > m(std::vector<int>{1, 2, 3}, std::vector<int>{1, 2, 3});
+    assert((m.keys() == std::vector<int>{3, 2, 1}));
+    assert((m.values() == std::vector<int>{3, 2, 1}));
+  }
+  {
+    std::flat_map<int, int> m(std::sorted_unique, std::vector<int>{1, 2}, std::vector<int>{2, 1});
+    assert(m.at(1) == 2 && m.at(2) == 1);
+  }
+
+  return 0;
+}
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <flat_map>
+
+// mapped_type& operator[](const key_type& x);
+// template <class... Args> pair<iterator, bool> try_emplace(const key_type& k, Args&&... args);
+// template <class M> pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj);
+// template <class InputIterator> void insert(InputIterator first, InputIterator last);
+
+#include <flat_map>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+int main(int, char**) {
+  std::flat_map<int, int> m{{1, 10}, {2, 20}, {3, 30}};
+  m[4] = 40;
+  assert(m[4] == 40 && m.size() == 4);
+
+  assert(!m.try_emplace(1, 11).second);
+  assert(m[1] == 10);
+  assert(!m.insert_or_assign(1, 11).second);
+  assert(m[1] == 11);
+  assert(m.insert_or_assign(m.end(), 5, 50)->second == 50);
+  assert(m.insert_or_assign(m.begin(), 5, 51)->second == 51);
+  assert(m.try_emplace(m.begin(), 0, 0)->first == 0);
+  assert(m.emplace(6, 60).second);
+  assert(!m.emplace(6, 61).second);
+  assert(m.insert(std::pair<int, int>(7, 70)).second);
+  assert(m.emplace_hint(m.end(), 8, 80)->second == 80);
+
+  m.insert({{10, 100}, {9, 90}, {4, 41}, {9, 91}});
+  assert((m.keys() == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+  assert((m.values() == std::vector<int>{0, 11, 20, 30, 40, 51, 60, 70, 80, 90, 100}));
+
+  auto c = std::move(m).extract();
+  assert(m.empty());
+  assert(c.keys.size() == 11 && c.values.size() == 11);
+  c.keys.pop_back();
+  c.values.pop_back();
+  m.replace(std::move(c.keys), std::move(c.values));
+  assert(m.size() == 10 && !m.contains(10));
+
+  return 0;
+}
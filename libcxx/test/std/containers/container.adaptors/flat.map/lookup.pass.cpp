@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <flat_map>
+
+// iterator find(const key_type& x);
+// mapped_type& at(const key_type& x);
+// pair<iterator, iterator> equal_range(const key_type& x);
+// iterator erase(const_iterator position);
+// size_type erase(const key_type& x);
+
+#include <flat_map>
+#include <cassert>
+#include <compare>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "test_macros.h"
+
+static_assert(std::random_access_iterator<std::flat_map<int, int>::iterator>);
+static_assert(std::random_access_iterator<std::flat_map<int, int>::const_iterator>);
+static_assert(std::is_convertible_v<std::flat_map<int, int>::iterator, std::flat_map<int, int>::const_iterator>);
+
+int main(int, char**) {
+  {
+    std::flat_map<int, int> m{{1, 10}, {3, 30}, {5, 50}, {7, 70}};
+    auto it = m.find(3);
+    assert(it->first == 3 && (*it).second == 30);
+    it->second = 31;
+    assert(m.at(3) == 31);
+    assert(m.find(4) == m.end());
+    assert(m.lower_bound(4)->first == 5);
+    assert(m.upper_bound(5)->first == 7);
+    auto r = m.equal_range(5);
+    assert(r.second - r.first == 1);
+    assert(m.end() - m.begin() == 4);
+    assert(m.begin()[2].second == 50);
+
+    std::flat_map<int, int>::const_iterator ci = m.begin();
+    assert(ci == m.begin() && ci < m.end());
+
+    for (auto [k, v] : m)
+      assert(v == k * 10 || (k == 3 && v == 31));
+
+#ifndef TEST_HAS_NO_EXCEPTIONS
+    try {
+      (void)m.at(100);
+      assert(false);
+    } catch (const std::out_of_range&) {
+    }
+#endif
+
+    assert(m.erase(5) == 1 && m.erase(5) == 0);
+    assert(m.erase(m.begin())->first == 3);
+    assert((m.keys() == std::vector<int>{3, 7}));
+  }
+  {
+    std::flat_map<int, int, std::less<> > m{{1, 1}};
+    assert(m.find(1L) != m.end() && m.contains(1L) && m.count(2L) == 0);
+  }
+  {
+    std::flat_map<int, int> a{{1, 1}, {2, 2}};
+    std::flat_map<int, int> b{{2, 2}, {1, 1}};
+    assert(a == b);
+    b[2] = 3;
+    assert(a != b && a < b);
+    assert((a <=> b) == std::strong_ordering::less);
+  }
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <flat_set>
+
+// flat_set(initializer_list<key_type> il, const key_compare& comp = key_compare());
+// flat_set(sorted_unique_t, container_type cont, const key_compare& comp = key_compare());
+// template <class InputIterator>
+//   flat_set(InputIterator first, InputIterator last, const key_compare& comp = key_compare());
+
+#include <flat_set>
+#include <cassert>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "test_macros.h"
+
+int main(int, char**) {
+  {
+    std::flat_set<int> s;
+    assert(s.empty() && s.begin() == s.end());
+  }
+  {
+    std::flat_set<int> s{5, 3, 1, 3, 5, 7};
+    assert((std::vector<int>(s.begin(), s.end()) == std::vector<int>{1, 3, 5, 7}));
+  }
+  {
+    int a[] = {4, 2, 2, 8, 6};
+    std::flat_set<int, std::greater<int> > s(a, a + 5);
+    assert((std::vector<int>(s.begin(), s.end()) == std::vector<int>{8, 6, 4, 2}));
+  }
+  {
+    std::flat_set<int> s(std::sorted_unique, std::vector<int>{1, 2, 3});
+    assert(s.size() == 3 && *s.begin() == 1 && *s.rbegin() == 3);
+  }
+  {
+    std::flat_set<int, std::less<int>, std::deque<int> > s(std::deque<int>{3, 1, 2, 1});
+    assert((std::vector<int>(s.begin(), s.end()) == std::vector<int>{1, 2, 3}));
+  }
+
+  return 0;
+}
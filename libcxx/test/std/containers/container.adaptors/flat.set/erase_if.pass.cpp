@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <flat_set>
+
+// template <class Key, class Compare, class KeyContainer, class Predicate>
+//   typename flat_set<Key, Compare, KeyContainer>::size_type
+//     erase_if(flat_set<Key, Compare, KeyContainer>& c, Predicate pred);
+
+#include <flat_set>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+
+int main(int, char**) {
+  std::flat_set<int> s{0, 1, 2, 3, 5, 7, 9};
+  assert(std::erase_if(s, [](int x) { return x % 2 == 1; }) == 5);
+  assert((std::vector<int>(s.begin(), s.end()) == std::vector<int>{0, 2}));
+  assert(std::erase_if(s, [](int) { return false; }) == 0);
+  assert(s.size() == 2);
+  assert(std::erase_if(s, [](int) { return true; }) == 2);
+  assert(s.empty());
+
+  return 0;
+}
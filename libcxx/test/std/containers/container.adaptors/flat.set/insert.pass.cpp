@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <flat_set>
+
+// pair<iterator, bool> insert(const value_type& x);
+// iterator insert(const_iterator position, const value_type& x);
+// template <class InputIterator> void insert(InputIterator first, InputIterator last);
+// template <class... Args> iterator emplace_hint(const_iterator position, Args&&... args);
+
+#include <flat_set>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+
+int main(int, char**) {
+  std::flat_set<int> s{5, 1, 3};
+  assert(s.insert(2).second);
+  assert(!s.insert(2).second);
+  assert(s.insert(s.begin(), 0) == s.begin());
+  assert(*s.emplace_hint(s.find(5), 4) == 4);
+  assert(*s.emplace_hint(s.begin(), 4) == 4);
+  assert((std::vector<int>(s.begin(), s.end()) == std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+  s.insert({9, 0, 7, 7, 1});
+  assert((std::vector<int>(s.begin(), s.end()) == std::vector<int>{0, 1, 2, 3, 4, 5, 7, 9}));
+
+  int a[] = {8, 6};
+  s.insert(std::sorted_unique, a + 1, a + 2);
+  assert(s.size() == 9 && s.contains(6) && !s.contains(8));
+
+  auto c = std::move(s).extract();
+  assert(s.empty());
+  assert((c == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 9}));
+  c.pop_back();
+  s.replace(std::move(c));
+  assert(s.size() == 8 && !s.contains(9));
+
+  return 0;
+}
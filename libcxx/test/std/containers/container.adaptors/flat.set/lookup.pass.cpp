@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <flat_set>
+
+// iterator find(const key_type& x);
+// size_type count(const key_type& x) const;
+// bool contains(const key_type& x) const;
+// iterator lower_bound(const key_type& x);
+// iterator upper_bound(const key_type& x);
+// pair<iterator, iterator> equal_range(const key_type& x);
+// friend bool operator==(const flat_set& x, const flat_set& y);
+// friend synth-three-way-result<value_type> operator<=>(const flat_set& x, const flat_set& y);
+
+#include <flat_set>
+#include <cassert>
+#include <compare>
+#include <functional>
+
+#include "test_macros.h"
+
+int main(int, char**) {
+  {
+    const std::flat_set<int> s{0, 1, 3, 4, 5, 7, 9};
+    assert(*s.find(4) == 4);
+    assert(s.find(2) == s.end());
+    assert(s.count(9) == 1 && s.count(8) == 0);
+    assert(s.contains(0) && !s.contains(-1));
+    assert(*s.lower_bound(2) == 3);
+    assert(*s.upper_bound(3) == 4);
+    assert(s.lower_bound(10) == s.end());
+    auto r = s.equal_range(5);
+    assert(r.second - r.first == 1 && *r.first == 5);
+    r = s.equal_range(6);
+    assert(r.first == r.second && *r.first == 7);
+  }
+  {
+    std::flat_set<int, std::less<> > s{1, 2, 3};
+    assert(s.find(2L) != s.end());
+    assert(s.contains(3L) && s.count(1L) == 1);
+    assert(s.erase(2L) == 1 && !s.contains(2));
+  }
+  {
+    std::flat_set<int> a{0, 2};
+    std::flat_set<int> b{2, 0};
+    assert(a == b);
+    b.insert(3);
+    assert(a != b);
+    assert(a < b);
+    assert((a <=> b) == std::strong_ordering::less);
+  }
+
+  return 0;
+}
@@ -117,7 +117,7 @@ LIBCPP_STATIC_ASSERT(
     std::is_same_v<
         std::format_context,
         std::basic_format_context<
-            std::back_insert_iterator<std::basic_string<char>>, char>>);
+            std::back_insert_iterator<std::__format::__output_buffer<char>>, char>>);
 
 #ifndef TEST_HAS_NO_WIDE_CHARACTERS
 static_assert(is_basic_format_context_specialization<std::wformat_context, wchar_t>);
@@ -125,7 +125,7 @@ LIBCPP_STATIC_ASSERT(
     std::is_same_v<
         std::wformat_context,
         std::basic_format_context<
-            std::back_insert_iterator<std::basic_string<wchar_t>>, wchar_t>>);
+            std::back_insert_iterator<std::__format::__output_buffer<wchar_t>>, wchar_t>>);
 #endif
 
 // Required for MSVC internal test runner compatibility.
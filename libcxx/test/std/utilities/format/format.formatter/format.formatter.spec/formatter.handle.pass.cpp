@@ -32,7 +32,8 @@ const char* color_names[] = {"black", "red", "gold"};
 
 template <>
 struct std::formatter<color> : std::formatter<const char*> {
-  auto format(color c, format_context& ctx) {
+  template <class FormatContext>
+  auto format(color c, FormatContext& ctx) {
     return formatter<const char*>::format(color_names[static_cast<int>(c)], ctx);
   }
 };
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// <memory_resource>
+
+// template <class T> class polymorphic_allocator
+
+// T* allocate(size_t n);
+// void deallocate(T* p, size_t n);
+// template <class U, class... Args> void construct(U* p, Args&&... args);
+
+#include <memory_resource>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+struct CountingResource : std::pmr::memory_resource {
+  int allocs = 0;
+  int deallocs = 0;
+  std::size_t last_bytes = 0;
+  std::size_t last_align = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    ++allocs;
+    last_bytes = bytes;
+    last_align = align;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    ++deallocs;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+struct UsesAlloc {
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+  UsesAlloc(int v, const allocator_type& a) : value(v), res(a.resource()) {}
+  int value;
+  std::pmr::memory_resource* res;
+};
+
+int main(int, char**) {
+  CountingResource r;
+  {
+    std::pmr::polymorphic_allocator<double> a(&r);
+    assert(a.resource() == &r);
+    double* p = a.allocate(3);
+    assert(r.allocs == 1 && r.last_bytes == 3 * sizeof(double) && r.last_align == alignof(double));
+    a.deallocate(p, 3);
+    assert(r.deallocs == 1);
+
+    std::pmr::polymorphic_allocator<int> b(a);
+    assert(a == b);
+    std::pmr::polymorphic_allocator<int> d;
+    assert(d.resource() == std::pmr::get_default_resource());
+    assert(a != d);
+    assert(d.select_on_container_copy_construction().resource() == std::pmr::get_default_resource());
+  }
+  {
+    // construct() passes the allocator along to allocator-aware types.
+    std::pmr::polymorphic_allocator<UsesAlloc> a(&r);
+    UsesAlloc* p = a.allocate(1);
+    a.construct(p, 42);
+    assert(p->value == 42 && p->res == &r);
+    a.destroy(p);
+    a.deallocate(p, 1);
+
+    using P = std::pair<UsesAlloc, int>;
+    std::pmr::polymorphic_allocator<P> pa(&r);
+    P* pp = pa.allocate(1);
+    pa.construct(pp, 1, 2);
+    assert(pp->first.value == 1 && pp->first.res == &r && pp->second == 2);
+    pa.destroy(pp);
+    pa.deallocate(pp, 1);
+  }
+  {
+    std::vector<int, std::pmr::polymorphic_allocator<int>> v(&r);
+    for (int i = 0; i != 100; ++i)
+      v.push_back(i);
+    assert(r.allocs > 0);
+    assert(v.get_allocator().resource() == &r);
+  }
+  assert(r.allocs == r.deallocs);
+#if TEST_STD_VER > 17
+  {
+    std::pmr::polymorphic_allocator<> a(&r);
+    static_assert(std::is_same_v<decltype(a)::value_type, std::byte>);
+    void* vp = a.allocate_bytes(10, 16);
+    assert(r.last_bytes == 10 && r.last_align == 16);
+    a.deallocate_bytes(vp, 10, 16);
+
+    long* lp = a.allocate_object<long>(4);
+    assert(r.last_bytes == 4 * sizeof(long) && r.last_align == alignof(long));
+    a.deallocate_object(lp, 4);
+
+    std::string* sp = a.new_object<std::string>(3, 'x');
+    assert(*sp == "xxx");
+    a.delete_object(sp);
+  }
+  assert(r.allocs == r.deallocs);
+#endif
+
+  return 0;
+}
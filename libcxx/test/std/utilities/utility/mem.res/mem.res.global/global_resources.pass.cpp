@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// <memory_resource>
+
+// memory_resource* new_delete_resource() noexcept;
+// memory_resource* null_memory_resource() noexcept;
+// memory_resource* get_default_resource() noexcept;
+// memory_resource* set_default_resource(memory_resource* r) noexcept;
+
+#include <memory_resource>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "test_macros.h"
+
+int main(int, char**) {
+  namespace pmr = std::pmr;
+  static_assert(noexcept(pmr::new_delete_resource()), "");
+  static_assert(noexcept(pmr::null_memory_resource()), "");
+  static_assert(noexcept(pmr::get_default_resource()), "");
+  static_assert(noexcept(pmr::set_default_resource(nullptr)), "");
+  static_assert(std::is_same<decltype(pmr::get_default_resource()), pmr::memory_resource*>::value, "");
+
+  pmr::memory_resource* ndr = pmr::new_delete_resource();
+  pmr::memory_resource* nr  = pmr::null_memory_resource();
+  assert(ndr != nullptr && nr != nullptr);
+  assert(ndr == pmr::new_delete_resource());
+  assert(nr == pmr::null_memory_resource());
+  assert(*ndr == *ndr);
+  assert(*ndr != *nr);
+
+  // The default resource is initially new_delete_resource().
+  assert(pmr::get_default_resource() == ndr);
+
+  // set_default_resource returns the previous value; nullptr resets it.
+  assert(pmr::set_default_resource(nr) == ndr);
+  assert(pmr::get_default_resource() == nr);
+  assert(pmr::set_default_resource(nullptr) == nr);
+  assert(pmr::get_default_resource() == ndr);
+
+  {
+    void* p = ndr->allocate(100, 64);
+    assert(p != nullptr);
+    assert(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+    ndr->deallocate(p, 100, 64);
+  }
+#ifndef TEST_HAS_NO_EXCEPTIONS
+  {
+    bool thrown = false;
+    try {
+      (void)nr->allocate(1);
+    } catch (const std::bad_alloc&) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// <memory_resource>
+
+// class monotonic_buffer_resource
+
+#include <memory_resource>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "test_macros.h"
+
+struct CountingResource : std::pmr::memory_resource {
+  int allocs = 0;
+  int deallocs = 0;
+  std::size_t last_bytes = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    ++allocs;
+    last_bytes = bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    ++deallocs;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+static bool is_aligned(void* p, std::size_t align) { return reinterpret_cast<std::uintptr_t>(p) % align == 0; }
+
+int main(int, char**) {
+  {
+    // Allocations are served from the initial buffer first.
+    CountingResource up;
+    alignas(16) char buffer[256];
+    std::pmr::monotonic_buffer_resource mono(buffer, sizeof(buffer), &up);
+    assert(mono.upstream_resource() == &up);
+    for (int i = 0; i != 8; ++i) {
+      void* p = mono.allocate(16, 16);
+      assert(static_cast<char*>(p) >= buffer && static_cast<char*>(p) < buffer + sizeof(buffer));
+      assert(is_aligned(p, 16));
+    }
+    assert(up.allocs == 0);
+
+    // Exhausting the buffer goes upstream with a geometrically growing size.
+    (void)mono.allocate(200, 8);
+    assert(up.allocs == 1);
+    std::size_t first = up.last_bytes;
+    assert(first >= 200);
+    for (int i = 0; i != 100 && up.allocs == 1; ++i)
+      (void)mono.allocate(first / 4, 1);
+    assert(up.allocs == 2);
+    assert(up.last_bytes > first);
+
+    // deallocate is a no-op; release returns everything and restarts at the initial buffer.
+    mono.deallocate(buffer, 16, 16);
+    assert(up.deallocs == 0);
+    mono.release();
+    assert(up.deallocs == up.allocs);
+    void* p = mono.allocate(1, 1);
+    assert(static_cast<char*>(p) >= buffer && static_cast<char*>(p) < buffer + sizeof(buffer));
+  }
+  {
+    CountingResource up;
+    {
+      std::pmr::monotonic_buffer_resource mono(100, &up);
+      assert(up.allocs == 0);
+      for (std::size_t i = 1; i != 500; ++i) {
+        std::size_t align = std::size_t(1) << (i % 7);
+        void* p = mono.allocate(i, align);
+        assert(is_aligned(p, align));
+      }
+      assert(up.allocs > 0);
+      assert(up.allocs < 50);
+      assert(mono == mono);
+    }
+    assert(up.deallocs == up.allocs);
+  }
+  {
+    std::pmr::monotonic_buffer_resource mono;
+    void* p = mono.allocate(0);
+    assert(p != nullptr);
+    assert(mono.upstream_resource() == std::pmr::get_default_resource());
+  }
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// UNSUPPORTED: no-threads
+
+// <memory_resource>
+
+// class synchronized_pool_resource
+
+#include <memory_resource>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "test_macros.h"
+
+int main(int, char**) {
+  std::pmr::synchronized_pool_resource pool;
+  assert(pool.upstream_resource() == std::pmr::get_default_resource());
+  assert(pool == pool);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 4; ++t) {
+    threads.emplace_back([&pool, t] {
+      std::vector<void*> ptrs;
+      for (std::size_t i = 0; i != 1000; ++i) {
+        void* p = pool.allocate(i % 128 + 1 + t, 8);
+        *static_cast<char*>(p) = static_cast<char>(t);
+        ptrs.push_back(p);
+      }
+      for (std::size_t i = 0; i != 1000; ++i) {
+        assert(*static_cast<char*>(ptrs[i]) == static_cast<char>(t));
+        pool.deallocate(ptrs[i], i % 128 + 1 + t, 8);
+      }
+    });
+  }
+  for (auto& th : threads)
+    th.join();
+
+  pool.release();
+  return 0;
+}
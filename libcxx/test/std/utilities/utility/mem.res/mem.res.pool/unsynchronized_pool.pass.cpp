@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// <memory_resource>
+
+// class unsynchronized_pool_resource
+
+#include <memory_resource>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "test_macros.h"
+
+struct CountingResource : std::pmr::memory_resource {
+  int allocs = 0;
+  int deallocs = 0;
+  std::size_t outstanding = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    ++allocs;
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    ++deallocs;
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+static bool is_aligned(void* p, std::size_t align) { return reinterpret_cast<std::uintptr_t>(p) % align == 0; }
+
+int main(int, char**) {
+  {
+    // Options are normalized.
+    std::pmr::unsynchronized_pool_resource def;
+    assert(def.upstream_resource() == std::pmr::get_default_resource());
+    assert(def.options().max_blocks_per_chunk > 0);
+    assert(def.options().largest_required_pool_block > 0);
+
+    std::pmr::pool_options opts;
+    opts.max_blocks_per_chunk        = 1;
+    opts.largest_required_pool_block = 1;
+    std::pmr::unsynchronized_pool_resource small(opts);
+    assert(small.options().max_blocks_per_chunk >= 1);
+    assert(small.options().largest_required_pool_block >= 1);
+
+    opts.largest_required_pool_block = 1000;
+    std::pmr::unsynchronized_pool_resource mid(opts);
+    assert(mid.options().largest_required_pool_block >= 1000);
+  }
+  {
+    CountingResource up;
+    {
+      std::pmr::unsynchronized_pool_resource pool(&up);
+      assert(pool.upstream_resource() == &up);
+      assert(pool == pool);
+
+      std::vector<void*> ptrs;
+      for (std::size_t i = 0; i != 2000; ++i) {
+        std::size_t bytes = i % 200 + 1;
+        std::size_t align = std::size_t(1) << (i % 4);
+        void* p = pool.allocate(bytes, align);
+        assert(is_aligned(p, align));
+        ptrs.push_back(p);
+      }
+      // Many small blocks are carved from few upstream chunks.
+      assert(up.allocs < 200);
+      for (std::size_t i = 0; i != 2000; ++i)
+        pool.deallocate(ptrs[i], i % 200 + 1, std::size_t(1) << (i % 4));
+
+      // Freed blocks are reused without going upstream.
+      int before = up.allocs;
+      for (std::size_t i = 0; i != 100; ++i)
+        ptrs[i] = pool.allocate(64, 8);
+      assert(up.allocs == before);
+      for (std::size_t i = 0; i != 100; ++i)
+        pool.deallocate(ptrs[i], 64, 8);
+
+      // Oversized and overaligned requests go straight upstream and back.
+      std::size_t huge = pool.options().largest_required_pool_block * 2;
+      before   = up.allocs;
+      void* p  = pool.allocate(huge, 128);
+      assert(up.allocs == before + 1);
+      assert(is_aligned(p, 128));
+      before = up.deallocs;
+      pool.deallocate(p, huge, 128);
+      assert(up.deallocs == before + 1);
+
+      pool.release();
+      assert(up.outstanding == 0);
+      (void)pool.allocate(16);
+    }
+    // The destructor releases everything.
+    assert(up.outstanding == 0);
+    assert(up.allocs == up.deallocs);
+  }
+  {
+    std::pmr::unsynchronized_pool_resource pool;
+    std::vector<int, std::pmr::polymorphic_allocator<int>> v(&pool);
+    for (int i = 0; i != 1000; ++i)
+      v.push_back(i);
+    for (int i = 0; i != 1000; ++i)
+      assert(v[i] == i);
+  }
+
+  return 0;
+}
@@ -8,6 +8,10 @@
 
 #include "lld/Common/Memory.h"
 #include "lld/Common/CommonLinkerContext.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/TimeProfiler.h"
 
 using namespace llvm;
 using namespace lld;
@@ -23,3 +27,46 @@ lld::SpecificAllocBase::getOrCreate(void *tag, size_t size, size_t align,
   }
   return instance;
 }
+
+void lld::reportArenaUsage(StringRef phase) {
+  CommonLinkerContext &ctx = context();
+  if (!ctx.printArenaUsage && !timeTraceProfilerEnabled())
+    return;
+
+  // Memory outside of make<T> arenas, e.g. saver() and bAlloc(), is attributed
+  // to the generic allocator.
+  SmallVector<std::pair<StringRef, int64_t>, 0> usage;
+  usage.emplace_back("BumpPtrAllocator", ctx.bAlloc.getTotalMemory());
+  for (auto &it : ctx.instances)
+    if (size_t bytes = it.second->getTotalMemory())
+      usage.emplace_back(it.second->getTypeName(), bytes);
+  llvm::sort(usage, [](const auto &a, const auto &b) {
+    return std::make_pair(-a.second, a.first) <
+           std::make_pair(-b.second, b.first);
+  });
+
+  size_t total = 0;
+  for (auto &u : usage)
+    total += u.second;
+  size_t mallocUsage = sys::Process::GetMallocUsage();
+
+  if (timeTraceProfilerEnabled()) {
+    timeTraceProfilerCounter("Arena usage", usage);
+    timeTraceProfilerCounter("Memory usage", {{"arenas", int64_t(total)},
+                                              {"malloc", int64_t(mallocUsage)}});
+  }
+
+  if (!ctx.printArenaUsage)
+    return;
+  int64_t delta = int64_t(total) - int64_t(ctx.lastArenaUsage);
+  ctx.lastArenaUsage = total;
+
+  std::string str;
+  raw_string_ostream os(str);
+  os << "arena usage after " << phase << ": " << total << " bytes ("
+     << (delta < 0 ? "" : "+") << delta << "), malloc: " << mallocUsage
+     << " bytes";
+  for (auto &u : usage)
+    os << "\n" << format_decimal(u.second, 14) << "  " << u.first;
+  message(os.str());
+}
@@ -11,6 +11,7 @@
 #include "lld/Common/LLVM.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/GlobPattern.h"
+#include "llvm/Support/Parallel.h"
 #include <algorithm>
 #include <mutex>
 #include <vector>
@@ -75,3 +76,36 @@ void lld::saveBuffer(StringRef buffer, const Twine &path) {
     error("cannot create " + path + ": " + ec.message());
   os << buffer;
 }
+
+void lld::writeStringTable(uint8_t *buf, ArrayRef<StringRef> strings) {
+  auto write = [&](uint8_t *p, ArrayRef<StringRef> shard) {
+    for (StringRef s : shard) {
+      memcpy(p, s.data(), s.size());
+      p[s.size()] = '\0';
+      p += s.size() + 1;
+    }
+  };
+
+  constexpr size_t numShards = 64;
+  if (strings.size() < numShards * 1024) {
+    write(buf, strings);
+    return;
+  }
+
+  // Compute the size of each shard, and then the start offset of each shard
+  // as the sum of the sizes of the shards before it.
+  size_t step = divideCeil(strings.size(), numShards);
+  uint64_t offsets[numShards + 1] = {};
+  parallelForEachN(0, numShards, [&](size_t i) {
+    for (StringRef s : strings.slice(std::min(i * step, strings.size()))
+                           .take_front(step))
+      offsets[i + 1] += s.size() + 1;
+  });
+  for (size_t i = 0; i != numShards; ++i)
+    offsets[i + 1] += offsets[i];
+
+  parallelForEachN(0, numShards, [&](size_t i) {
+    write(buf + offsets[i],
+          strings.slice(std::min(i * step, strings.size())).take_front(step));
+  });
+}
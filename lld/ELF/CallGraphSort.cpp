@@ -38,6 +38,12 @@
 ///   * If not, then combine the clusters.
 /// * Sort non-empty clusters by density
 ///
+/// With --call-graph-profile-sort=exttsp, sections are instead ordered by the
+/// Ext-TSP algorithm from llvm/Transforms/Utils/CodeLayout.h, which BOLT also
+/// uses for function reordering. It maximizes the number of calls whose caller
+/// and callee end up close to each other rather than greedily chaining hot
+/// callers and callees.
+///
 //===----------------------------------------------------------------------===//
 
 #include "CallGraphSort.h"
@@ -45,6 +51,7 @@
 #include "InputSection.h"
 #include "Symbols.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Transforms/Utils/CodeLayout.h"
 
 #include <numeric>
 
@@ -79,7 +86,7 @@ class CallGraphSort {
 public:
   CallGraphSort();
 
-  DenseMap<const InputSectionBase *, int> run();
+  std::vector<const InputSectionBase *> run();
 
 private:
   std::vector<Cluster> clusters;
@@ -179,7 +186,7 @@ static void mergeClusters(std::vector<Cluster> &cs, Cluster &into, int intoIdx,
 
 // Group InputSections into clusters using the Call-Chain Clustering heuristic
 // then sort the clusters by density.
-DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
+std::vector<const InputSectionBase *> CallGraphSort::run() {
   std::vector<int> sorted(clusters.size());
   std::vector<int> leaders(clusters.size());
 
@@ -222,16 +229,93 @@ DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
     return clusters[a].getDensity() > clusters[b].getDensity();
   });
 
-  DenseMap<const InputSectionBase *, int> orderMap;
-  int curOrder = 1;
+  std::vector<const InputSectionBase *> order;
   for (int leader : sorted) {
     for (int i = leader;;) {
-      orderMap[sections[i]] = curOrder++;
+      order.push_back(sections[i]);
       i = clusters[i].next;
       if (i == leader)
         break;
     }
   }
+  return order;
+}
+
+// Order sections with the Ext-TSP algorithm. Each section is a node whose
+// count is the total weight of its incoming edges.
+static std::vector<const InputSectionBase *> computeExtTspOrder() {
+  MapVector<SectionPair, uint64_t> &profile = config->callGraphProfile;
+  DenseMap<const InputSectionBase *, uint64_t> secToNode;
+  std::vector<const InputSectionBase *> sections;
+  std::vector<uint64_t> counts;
+  SmallVector<std::tuple<uint64_t, uint64_t, uint64_t>, 0> calls;
+
+  auto getOrCreateNode = [&](const InputSectionBase *isec) {
+    auto res = secToNode.try_emplace(isec, sections.size());
+    if (res.second) {
+      sections.push_back(isec);
+      counts.push_back(0);
+    }
+    return res.first->second;
+  };
+
+  for (std::pair<SectionPair, uint64_t> &c : profile) {
+    const auto *fromSB = cast<InputSectionBase>(c.first.first);
+    const auto *toSB = cast<InputSectionBase>(c.first.second);
+    // See the comment in the CallGraphSort constructor.
+    if (fromSB->getOutputSection() != toSB->getOutputSection())
+      continue;
+    uint64_t from = getOrCreateNode(fromSB);
+    uint64_t to = getOrCreateNode(toSB);
+    counts[to] += c.second;
+    if (from != to)
+      calls.emplace_back(from, to, c.second);
+  }
+
+  // applyExtTspLayout() keeps node 0 first as the entry block of a function.
+  // Renumber the nodes from hottest to coldest so that the hottest section
+  // plays that role.
+  std::vector<uint64_t> hotOrder(sections.size());
+  std::iota(hotOrder.begin(), hotOrder.end(), 0);
+  llvm::stable_sort(hotOrder,
+                    [&](uint64_t a, uint64_t b) { return counts[a] > counts[b]; });
+  if (sections.size() <= 2) {
+    std::vector<const InputSectionBase *> order;
+    for (uint64_t i : hotOrder)
+      order.push_back(sections[i]);
+    return order;
+  }
+
+  std::vector<uint64_t> nodeIndex(sections.size());
+  for (size_t i = 0, e = hotOrder.size(); i != e; ++i)
+    nodeIndex[hotOrder[i]] = i;
+
+  std::vector<uint64_t> nodeSizes(sections.size()), nodeCounts(sections.size());
+  for (size_t i = 0, e = hotOrder.size(); i != e; ++i) {
+    // Ext-TSP divides by node sizes.
+    nodeSizes[i] = std::max<uint64_t>(sections[hotOrder[i]]->getSize(), 1);
+    nodeCounts[i] = counts[hotOrder[i]];
+  }
+  DenseMap<std::pair<uint64_t, uint64_t>, uint64_t> edgeCounts;
+  for (auto &call : calls)
+    edgeCounts[{nodeIndex[std::get<0>(call)], nodeIndex[std::get<1>(call)]}] +=
+        std::get<2>(call);
+
+  std::vector<const InputSectionBase *> order;
+  for (uint64_t i : applyExtTspLayout(nodeSizes, nodeCounts, edgeCounts))
+    order.push_back(sections[hotOrder[i]]);
+  return order;
+}
+
+// Assigns priorities to sections in the given order, and prints the symbols
+// defined in them if --print-symbol-order= is specified.
+static DenseMap<const InputSectionBase *, int>
+getOrderMap(ArrayRef<const InputSectionBase *> order) {
+  DenseMap<const InputSectionBase *, int> orderMap;
+  int curOrder = 1;
+  for (const InputSectionBase *isec : order)
+    orderMap[isec] = curOrder++;
+
   if (!config->printSymbolOrder.empty()) {
     std::error_code ec;
     raw_fd_ostream os(config->printSymbolOrder, ec, sys::fs::OF_None);
@@ -240,21 +324,14 @@ DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
       return orderMap;
     }
 
-    // Print the symbols ordered by C3, in the order of increasing curOrder
-    // Instead of sorting all the orderMap, just repeat the loops above.
-    for (int leader : sorted)
-      for (int i = leader;;) {
-        // Search all the symbols in the file of the section
-        // and find out a Defined symbol with name that is within the section.
-        for (Symbol *sym : sections[i]->file->getSymbols())
-          if (!sym->isSection()) // Filter out section-type symbols here.
-            if (auto *d = dyn_cast<Defined>(sym))
-              if (sections[i] == d->section)
-                os << sym->getName() << "\n";
-        i = clusters[i].next;
-        if (i == leader)
-          break;
-      }
+    // Search all the symbols in the file of the section and find out a
+    // Defined symbol with name that is within the section.
+    for (const InputSectionBase *isec : order)
+      for (Symbol *sym : isec->file->getSymbols())
+        if (!sym->isSection()) // Filter out section-type symbols here.
+          if (auto *d = dyn_cast<Defined>(sym))
+            if (isec == d->section)
+              os << sym->getName() << "\n";
   }
 
   return orderMap;
@@ -262,9 +339,11 @@ DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
 
 // Sort sections by the profile data provided by --callgraph-profile-file.
 //
-// This first builds a call graph based on the profile data then merges sections
-// according to the C³ heuristic. All clusters are then sorted by a density
-// metric to further improve locality.
+// By default, this first builds a call graph based on the profile data then
+// merges sections according to the C³ heuristic. All clusters are then sorted
+// by a density metric to further improve locality.
 DenseMap<const InputSectionBase *, int> elf::computeCallGraphProfileOrder() {
-  return CallGraphSort().run();
+  if (config->callGraphProfileSort == CGProfileSortKind::ExtTsp)
+    return getOrderMap(computeExtTspOrder());
+  return getOrderMap(CallGraphSort().run());
 }
@@ -43,6 +43,12 @@ enum ELFKind : uint8_t {
 // -Bsymbolic.
 enum class BsymbolicKind { None, NonWeakFunctions, Functions, All };
 
+// For --call-graph-profile-sort.
+enum class CGProfileSortKind { None, Hfsort, ExtTsp };
+
+// For --compress-debug-sections.
+enum class DebugCompressionKind { None, Zlib, Zstd };
+
 // For --build-id.
 enum class BuildIdKind { None, Fast, Md5, Sha1, Hexstring, Uuid };
 
@@ -110,6 +116,7 @@ struct Configuration {
   llvm::StringRef emulation;
   llvm::StringRef fini;
   llvm::StringRef init;
+  llvm::StringRef linkStateFile;
   llvm::StringRef ltoAAPipeline;
   llvm::StringRef ltoCSProfileFile;
   llvm::StringRef ltoNewPmPasses;
@@ -126,7 +133,9 @@ struct Configuration {
   llvm::StringRef printSymbolOrder;
   llvm::StringRef soName;
   llvm::StringRef sysroot;
+  llvm::StringRef thinLTOBackendReport;
   llvm::StringRef thinLTOCacheDir;
+  llvm::StringRef thinLTORemoteCache;
   llvm::StringRef thinLTOIndexOnlyArg;
   llvm::StringRef whyExtract;
   StringRef zBtiReport = "none";
@@ -154,10 +163,10 @@ struct Configuration {
   bool armJ1J2BranchEncoding = false;
   bool asNeeded = false;
   BsymbolicKind bsymbolic = BsymbolicKind::None;
-  bool callGraphProfileSort;
+  CGProfileSortKind callGraphProfileSort;
   bool checkSections;
   bool checkDynamicRelocs;
-  bool compressDebugSections;
+  DebugCompressionKind compressDebugSections;
   bool cref;
   std::vector<std::pair<llvm::GlobPattern, uint64_t>> deadRelocInNonAlloc;
   bool demangle = true;
@@ -180,6 +189,7 @@ struct Configuration {
   bool hasDynSymTab;
   bool ignoreDataAddressEquality;
   bool ignoreFunctionAddressEquality;
+  bool ltoCachePartitions;
   bool ltoCSProfileGenerate;
   bool ltoPGOWarnMismatch;
   bool ltoDebugPassManager;
@@ -278,6 +288,7 @@ struct Configuration {
   unsigned ltoo;
   unsigned optimize;
   StringRef thinLTOJobs;
+  uint64_t thinLTOMemoryBudget;
   unsigned timeTraceGranularity;
   int32_t splitStackAdjustSize;
 
@@ -312,12 +323,12 @@ struct Configuration {
   bool isMips64EL;
 
   // True if we need to reserve two .got entries for local-dynamic TLS model.
-  bool needsTlsLd = false;
+  std::atomic<bool> needsTlsLd{false};
 
   // True if we need to set the DF_STATIC_TLS flag to an output file, which
   // works as a hint to the dynamic loader that the shared object contains code
   // compiled with the initial-exec TLS model.
-  bool hasTlsIe = false;
+  std::atomic<bool> hasTlsIe{false};
 
   // Holds set of ELF header flags for the target.
   uint32_t eflags = 0;
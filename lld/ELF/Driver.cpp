@@ -37,6 +37,7 @@
 #include "Target.h"
 #include "Writer.h"
 #include "lld/Common/Args.h"
+#include "lld/Common/CommonLinkerContext.h"
 #include "lld/Common/Driver.h"
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Filesystem.h"
@@ -46,8 +47,10 @@
 #include "lld/Common/Version.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Config/llvm-config.h"
+#include "llvm/Debuginfod/HTTPClient.h"
 #include "llvm/LTO/LTO.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Remarks/HotnessThresholdParser.h"
@@ -62,6 +65,7 @@
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 #include <cstdlib>
 #include <utility>
 
@@ -502,6 +506,160 @@ static void checkZOptions(opt::InputArgList &args) {
       warn("unknown -z value: " + StringRef(arg->getValue()));
 }
 
+static void writeDependencyFile();
+
+// --link-state-file records what a link depended on: the lld version, the
+// command line, the size and modification time of the output file and the
+// contents hashes of all files read by the driver. If a later link finds all
+// of them unchanged once the input files have been located, the existing
+// output is exactly what the link would produce, so the link is skipped. Any
+// difference results in a full link, after which the state is recorded again.
+//
+// The state file is a text file with one "<key> <value>" record per line,
+// preceded by a header covering the version and the command line.
+static std::string getLinkStateHeader(opt::InputArgList &args) {
+  std::string cmdline;
+  for (const opt::Arg *arg : args) {
+    cmdline += arg->getAsString(args);
+    cmdline += '\0';
+  }
+  return "lld-link-state-v1\nversion " + getLLDVersion() + "\nargs " +
+         utohexstr(xxHash64(cmdline)) + "\n";
+}
+
+// Options that emit files other than the output, or print to stdout, prevent
+// the link from being skipped because their output would not be produced.
+static bool canSkipLink(opt::InputArgList &args) {
+  return config->outputFile != "-" && config->mapFile.empty() &&
+         config->whyExtract.empty() && config->printArchiveStats.empty() &&
+         config->printSymbolOrder.empty() && config->ltoObjPath.empty() &&
+         !config->cref && !config->trace && !args.hasArg(OPT_trace_symbol) &&
+         !config->printGcSections && !config->printIcfSections &&
+         !config->saveTemps && !config->ltoEmitAsm &&
+         !config->ltoCSProfileGenerate && !config->thinLTOIndexOnly &&
+         !config->thinLTOEmitImportsFiles && !tar;
+}
+
+static uint64_t getModificationTime(const sys::fs::file_status &st) {
+  return st.getLastModificationTime().time_since_epoch().count();
+}
+
+// Files read by LTO rather than by the driver.
+static SmallVector<StringRef, 2> getLTOInputFiles() {
+  SmallVector<StringRef, 2> v;
+  if (!config->ltoSampleProfile.empty())
+    v.push_back(config->ltoSampleProfile);
+  if (!config->ltoCSProfileFile.empty())
+    v.push_back(config->ltoCSProfileFile);
+  return v;
+}
+
+static Optional<uint64_t> hashFile(StringRef path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr = MemoryBuffer::getFile(
+      path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!mbOrErr)
+    return None;
+  return xxHash64((*mbOrErr)->getBuffer());
+}
+
+// Returns the paths and contents hashes of all files read so far.
+static std::vector<std::pair<StringRef, uint64_t>> hashInputFiles() {
+  std::vector<std::pair<StringRef, uint64_t>> v(memoryBuffers.size());
+  parallelForEachN(0, v.size(), [&](size_t i) {
+    MemoryBuffer &mb = *memoryBuffers[i];
+    v[i] = {mb.getBufferIdentifier(), xxHash64(mb.getBuffer())};
+  });
+  return v;
+}
+
+static bool isLinkStateUpToDate(StringRef header) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      MemoryBuffer::getFile(config->linkStateFile, /*IsText=*/true);
+  if (!mbOrErr)
+    return false;
+  StringRef data = (*mbOrErr)->getBuffer();
+  if (!data.consume_front(header)) {
+    log("--link-state-file: version or options changed");
+    return false;
+  }
+
+  uint64_t outputSize = -1, outputTime = -1;
+  StringMap<uint64_t> recorded;
+  SmallVector<StringRef, 0> lines;
+  data.split(lines, '\n', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (StringRef line : lines) {
+    StringRef key, value;
+    std::tie(key, value) = line.split(' ');
+    if (key == "output") {
+      StringRef size, time;
+      std::tie(size, time) = value.split(' ');
+      if (size.getAsInteger(10, outputSize) || time.getAsInteger(10, outputTime))
+        return false;
+    } else if (key == "input") {
+      StringRef hash, path;
+      std::tie(hash, path) = value.split(' ');
+      if (hash.getAsInteger(16, recorded[path]))
+        return false;
+    } else {
+      return false;
+    }
+  }
+
+  auto changed = [](const Twine &path) {
+    log("--link-state-file: " + path + " changed");
+    return false;
+  };
+
+  sys::fs::file_status st;
+  if (sys::fs::status(config->outputFile, st) || st.getSize() != outputSize ||
+      getModificationTime(st) != outputTime)
+    return changed(config->outputFile);
+
+  // Every file read so far must have been read by the previous link and have
+  // the same contents.
+  StringSet<> checked;
+  for (const std::pair<StringRef, uint64_t> &file : hashInputFiles()) {
+    auto it = recorded.find(file.first);
+    if (it == recorded.end() || it->second != file.second)
+      return changed(file.first);
+    checked.insert(file.first);
+  }
+
+  // The previous link may have read more files later, e.g.
+  // --call-graph-ordering-file or LTO sample profiles. Check them directly.
+  for (const StringMapEntry<uint64_t> &file : recorded) {
+    if (checked.count(file.getKey()))
+      continue;
+    Optional<uint64_t> hash = hashFile(file.getKey());
+    if (!hash || *hash != file.getValue())
+      return changed(file.getKey());
+  }
+  return true;
+}
+
+static void writeLinkState(StringRef header) {
+  sys::fs::file_status st;
+  if (std::error_code ec = sys::fs::status(config->outputFile, st)) {
+    error("--link-state-file: cannot stat " + config->outputFile + ": " +
+          ec.message());
+    return;
+  }
+
+  std::error_code ec;
+  raw_fd_ostream os(config->linkStateFile, ec, sys::fs::OF_None);
+  if (ec) {
+    error("cannot open " + config->linkStateFile + ": " + ec.message());
+    return;
+  }
+  os << header;
+  os << "output " << st.getSize() << ' ' << getModificationTime(st) << '\n';
+  for (const std::pair<StringRef, uint64_t> &file : hashInputFiles())
+    os << "input " << utohexstr(file.second) << ' ' << file.first << '\n';
+  for (StringRef path : getLTOInputFiles())
+    if (Optional<uint64_t> hash = hashFile(path))
+      os << "input " << utohexstr(*hash) << ' ' << path << '\n';
+}
+
 void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
   ELFOptTable parser;
   opt::InputArgList args = parser.parse(argsArr.slice(1));
@@ -573,6 +731,15 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
     if (errorCount())
       return;
 
+    // Reading the IR symbol tables is most of the cost of loading bitcode
+    // files, and it is independent for each file, so do it in parallel.
+    parallelForEach(files, [](InputFile *file) {
+      if (auto *f = dyn_cast<BitcodeFile>(file))
+        f->readIRSymtab();
+    });
+    if (errorCount())
+      return;
+
     inferMachineType();
     setConfigs(args);
     checkOptions();
@@ -584,7 +751,20 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
     // values such as a default image base address.
     target = getTarget();
 
-    link(args);
+    if (config->linkStateFile.empty()) {
+      link(args);
+    } else {
+      std::string header = getLinkStateHeader(args);
+      if (canSkipLink(args) && isLinkStateUpToDate(header)) {
+        log("--link-state-file: " + config->outputFile + " is up to date");
+        if (!config->dependencyFile.empty())
+          writeDependencyFile();
+      } else {
+        link(args);
+        if (!errorCount())
+          writeLinkState(header);
+      }
+    }
   }
 
   if (config->timeTraceEnabled) {
@@ -689,6 +869,17 @@ static DiscardPolicy getDiscard(opt::InputArgList &args) {
   return DiscardPolicy::None;
 }
 
+static CGProfileSortKind getCGProfileSortKind(opt::InputArgList &args) {
+  StringRef s = args.getLastArgValue(OPT_call_graph_profile_sort_eq, "hfsort");
+  if (s == "none")
+    return CGProfileSortKind::None;
+  if (s == "exttsp")
+    return CGProfileSortKind::ExtTsp;
+  if (s != "hfsort")
+    error("unknown --call-graph-profile-sort= value: " + s);
+  return CGProfileSortKind::Hfsort;
+}
+
 static StringRef getDynamicLinker(opt::InputArgList &args) {
   auto *arg = args.getLastArg(OPT_dynamic_linker, OPT_no_dynamic_linker);
   if (!arg)
@@ -824,6 +1015,9 @@ static void readCallGraph(MemoryBufferRef mb) {
 
   auto findSection = [&](StringRef name) -> InputSectionBase * {
     Symbol *sym = map.lookup(name);
+    // BOLT names local functions <name>/<file>/<n>.
+    if (!sym && name.contains('/'))
+      sym = map.lookup(name.take_front(name.find('/')));
     if (!sym) {
       if (config->warnSymbolOrdering)
         warn(mb.getBufferIdentifier() + ": no such symbol: " + name);
@@ -836,18 +1030,32 @@ static void readCallGraph(MemoryBufferRef mb) {
     return nullptr;
   };
 
+  // Each line is either "<from> <to> <count>", or a branch record of a BOLT
+  // fdata profile as written by perf2bolt:
+  // "<is_sym> <from> <offset> <is_sym> <to> <offset> <mispreds> <count>".
+  // Branch records between two functions are treated as calls, and branches
+  // within a function are ignored.
   for (StringRef line : args::getLines(mb)) {
-    SmallVector<StringRef, 3> fields;
-    line.split(fields, ' ');
+    SmallVector<StringRef, 8> fields;
+    line.split(fields, ' ', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
     uint64_t count;
 
-    if (fields.size() != 3 || !to_integer(fields[2], count)) {
+    StringRef fromName, toName;
+    if (fields.size() == 3 && to_integer(fields[2], count)) {
+      fromName = fields[0];
+      toName = fields[1];
+    } else if (fields.size() == 8 && to_integer(fields[7], count)) {
+      if (fields[0] != "1" || fields[3] != "1" || fields[1] == fields[4])
+        continue;
+      fromName = fields[1];
+      toName = fields[4];
+    } else {
       error(mb.getBufferIdentifier() + ": parse error");
       return;
     }
 
-    if (InputSectionBase *from = findSection(fields[0]))
-      if (InputSectionBase *to = findSection(fields[1]))
+    if (InputSectionBase *from = findSection(fromName))
+      if (InputSectionBase *to = findSection(toName))
         config->callGraphProfile[std::make_pair(from, to)] += count;
   }
 }
@@ -922,15 +1130,21 @@ template <class ELFT> static void readCallGraphsFromObjectFiles() {
   }
 }
 
-static bool getCompressDebugSections(opt::InputArgList &args) {
+static DebugCompressionKind
+getCompressDebugSections(opt::InputArgList &args) {
   StringRef s = args.getLastArgValue(OPT_compress_debug_sections, "none");
   if (s == "none")
-    return false;
+    return DebugCompressionKind::None;
+  if (s == "zstd") {
+    if (!zstd::isAvailable())
+      error("--compress-debug-sections: zstd is not available");
+    return DebugCompressionKind::Zstd;
+  }
   if (s != "zlib")
     error("unknown --compress-debug-sections value: " + s);
   if (!zlib::isAvailable())
     error("--compress-debug-sections: zlib is not available");
-  return true;
+  return DebugCompressionKind::Zlib;
 }
 
 static StringRef getAliasSpelling(opt::Arg *arg) {
@@ -999,6 +1213,7 @@ static void readConfigs(opt::InputArgList &args) {
   errorHandler().verbose = args.hasArg(OPT_verbose);
   errorHandler().vsDiagnostics =
       args.hasArg(OPT_visual_studio_diagnostics_format, false);
+  context().printArenaUsage = args.hasArg(OPT_print_arena_usage);
 
   config->allowMultipleDefinition =
       args.hasFlag(OPT_allow_multiple_definition,
@@ -1033,8 +1248,7 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasFlag(OPT_eh_frame_hdr, OPT_no_eh_frame_hdr, false);
   config->emitLLVM = args.hasArg(OPT_plugin_opt_emit_llvm, false);
   config->emitRelocs = args.hasArg(OPT_emit_relocs);
-  config->callGraphProfileSort = args.hasFlag(
-      OPT_call_graph_profile_sort, OPT_no_call_graph_profile_sort, true);
+  config->callGraphProfileSort = getCGProfileSortKind(args);
   config->enableNewDtags =
       args.hasFlag(OPT_enable_new_dtags, OPT_disable_new_dtags, true);
   config->entry = args.getLastArgValue(OPT_entry);
@@ -1064,7 +1278,10 @@ static void readConfigs(opt::InputArgList &args) {
   config->ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
   config->init = args.getLastArgValue(OPT_init, "_init");
+  config->linkStateFile = args.getLastArgValue(OPT_link_state_file);
   config->ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
+  config->ltoCachePartitions = args.hasFlag(
+      OPT_lto_cache_partitions, OPT_no_lto_cache_partitions, false);
   config->ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
   config->ltoCSProfileFile = args.getLastArgValue(OPT_lto_cs_profile_file);
   config->ltoPGOWarnMismatch = args.hasFlag(OPT_lto_pgo_warn_mismatch,
@@ -1081,6 +1298,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->ltoo = args::getInteger(args, OPT_lto_O, 2);
   config->ltoObjPath = args.getLastArgValue(OPT_lto_obj_path_eq);
   config->ltoPartitions = args::getInteger(args, OPT_lto_partitions, 1);
+  config->thinLTOMemoryBudget =
+      uint64_t(args::getInteger(args, OPT_thinlto_memory_budget, 0)) << 20;
   config->ltoSampleProfile = args.getLastArgValue(OPT_lto_sample_profile);
   config->ltoBasicBlockSections =
       args.getLastArgValue(OPT_lto_basic_block_sections);
@@ -1139,7 +1358,10 @@ static void readConfigs(opt::InputArgList &args) {
   config->sysroot = args.getLastArgValue(OPT_sysroot);
   config->target1Rel = args.hasFlag(OPT_target1_rel, OPT_target1_abs, false);
   config->target2 = getTarget2(args);
+  config->thinLTOBackendReport =
+      args.getLastArgValue(OPT_thinlto_backend_report);
   config->thinLTOCacheDir = args.getLastArgValue(OPT_thinlto_cache_dir);
+  config->thinLTORemoteCache = args.getLastArgValue(OPT_thinlto_remote_cache);
   config->thinLTOCachePolicy = CHECK(
       parseCachePruningPolicy(args.getLastArgValue(OPT_thinlto_cache_policy)),
       "--thinlto-cache-policy: invalid cache policy");
@@ -1306,6 +1528,12 @@ static void readConfigs(opt::InputArgList &args) {
     error("--lto-partitions: number of threads must be > 0");
   if (!get_threadpool_strategy(config->thinLTOJobs))
     error("--thinlto-jobs: invalid job count: " + config->thinLTOJobs);
+  if (!config->thinLTORemoteCache.empty()) {
+    if (config->thinLTOCacheDir.empty())
+      error("--thinlto-remote-cache requires --thinlto-cache-dir");
+    // This must happen while lld is still single threaded.
+    HTTPClient::initialize();
+  }
 
   if (config->splitStackAdjustSize < 0)
     error("--split-stack-adjust-size: size must be >= 0");
@@ -1363,7 +1591,7 @@ static void readConfigs(opt::InputArgList &args) {
       config->symbolOrderingFile = getSymbolOrderingFile(*buffer);
       // Also need to disable CallGraphProfileSort to prevent
       // LLD order symbols with CGProfile
-      config->callGraphProfileSort = false;
+      config->callGraphProfileSort = CGProfileSortKind::None;
     }
   }
 
@@ -1741,6 +1969,7 @@ static void handleUndefinedGlob(StringRef arg) {
 
   // Calling sym->extract() in the loop is not safe because it may add new
   // symbols to the symbol table, invalidating the current iterator.
+  symtab->materializeLazy([&](StringRef name) { return pat->match(name); });
   SmallVector<Symbol *, 0> syms;
   for (Symbol *sym : symtab->symbols())
     if (!sym->isPlaceholder() && pat->match(sym->getName()))
@@ -2416,6 +2645,7 @@ void LinkerDriver::link(opt::InputArgList &args) {
       parseFile(files[i]);
     }
   }
+  reportArenaUsage("Parse input files");
 
   // Now that we have every file, we can decide if we will need a
   // dynamic symbol table.
@@ -2532,6 +2762,7 @@ void LinkerDriver::link(opt::InputArgList &args) {
   // except a few linker-synthesized ones will be added to the symbol table.
   const size_t numObjsBeforeLTO = objectFiles.size();
   invokeELFT(compileBitcodeFiles, skipLinkedOutput);
+  reportArenaUsage("LTO");
 
   // Symbol resolution finished. Report backward reference problems,
   // --print-archive-stats=, and --why-extract=.
@@ -2695,6 +2926,7 @@ void LinkerDriver::link(opt::InputArgList &args) {
       return isa<MergeInputSection>(s);
     });
   }
+  reportArenaUsage("Merge/finalize input sections");
 
   // Two input sections with different output sections should not be folded.
   // ICF runs after processSectionCommands() so that we know the output sections.
@@ -2704,7 +2936,7 @@ void LinkerDriver::link(opt::InputArgList &args) {
   }
 
   // Read the callgraph now that we know what was gced or icfed
-  if (config->callGraphProfileSort) {
+  if (config->callGraphProfileSort != CGProfileSortKind::None) {
     if (auto *arg = args.getLastArg(OPT_call_graph_ordering_file))
       if (Optional<MemoryBufferRef> buffer = readFile(arg->getValue()))
         readCallGraph(*buffer);
@@ -2713,4 +2945,5 @@ void LinkerDriver::link(opt::InputArgList &args) {
 
   // Write the result to the file.
   invokeELFT(writeResult);
+  reportArenaUsage("Write output file");
 }
@@ -80,6 +80,7 @@
 #include "SymbolTable.h"
 #include "Symbols.h"
 #include "SyntheticSections.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Object/ELF.h"
 #include "llvm/Support/Parallel.h"
@@ -449,6 +450,22 @@ static void combineRelocHashes(unsigned cnt, InputSection *isec,
   isec->eqClass[(cnt + 1) % 2] = hash | (1U << 31);
 }
 
+// Returns a hash of everything equalsConstant() compares that can be computed
+// without looking at relocation targets: the flags, the contents and the
+// offsets and types of the relocations. Sections with equal contents but
+// differently shaped relocations are then split before segregate() runs, which
+// keeps the classes it has to handle small.
+template <class RelTy>
+static uint32_t getConstantHash(const InputSection *isec,
+                                ArrayRef<RelTy> rels) {
+  hash_code hash = hash_combine(isec->flags, xxHash64(isec->rawData));
+  for (const RelTy &rel : rels)
+    hash = hash_combine(hash, static_cast<uint64_t>(rel.r_offset),
+                        rel.getType(config->isMips64EL));
+  // Set MSB to 1 to avoid collisions with unique IDs.
+  return static_cast<uint32_t>(hash) | (1U << 31);
+}
+
 static void print(const Twine &s) {
   if (config->printIcfSections)
     message(s);
@@ -491,8 +508,9 @@ template <class ELFT> void ICF<ELFT>::run() {
 
   // Initially, we use hash values to partition sections.
   parallelForEach(sections, [&](InputSection *s) {
-    // Set MSB to 1 to avoid collisions with unique IDs.
-    s->eqClass[0] = xxHash64(s->rawData) | (1U << 31);
+    const RelsOrRelas<ELFT> rels = s->template relsOrRelas<ELFT>();
+    s->eqClass[0] = rels.areRelocsRel() ? getConstantHash(s, rels.rels)
+                                        : getConstantHash(s, rels.relas);
   });
 
   // Perform 2 rounds of relocation hash propagation. 2 is an empirical value to
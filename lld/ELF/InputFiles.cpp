@@ -165,6 +165,11 @@ static bool isCompatible(InputFile *file) {
 }
 
 template <class ELFT> static void doParseFile(InputFile *file) {
+  // The IR symbol tables of the input files are read in parallel by the
+  // driver, but files can be added after that, e.g. by linker scripts.
+  if (auto *f = dyn_cast<BitcodeFile>(file))
+    if (!f->readIRSymtab())
+      return;
   if (!isCompatible(file))
     return;
 
@@ -1604,14 +1609,25 @@ BitcodeFile::BitcodeFile(MemoryBufferRef mb, StringRef archiveName,
                        ? saver().save(path)
                        : saver().save(archiveName + "(" + path::filename(path) +
                                       " at " + utostr(offsetInArchive) + ")");
-  MemoryBufferRef mbref(mb.getBuffer(), name);
+  irMB = MemoryBufferRef(mb.getBuffer(), name);
+}
 
-  obj = CHECK(lto::InputFile::create(mbref), this);
+bool BitcodeFile::readIRSymtab() {
+  if (obj)
+    return true;
+  Expected<std::unique_ptr<lto::InputFile>> objOrErr =
+      lto::InputFile::create(irMB);
+  if (!objOrErr) {
+    error(toString(this) + ": " + toString(objOrErr.takeError()));
+    return false;
+  }
+  obj = std::move(*objOrErr);
 
   Triple t(obj->getTargetTriple());
   ekind = getBitcodeELFKind(t);
   emachine = getBitcodeMachineKind(mb.getBufferIdentifier(), t);
   osabi = getOsAbi(t);
+  return true;
 }
 
 static uint8_t mapVisibility(GlobalValue::VisibilityTypes gvVisibility) {
@@ -1688,8 +1704,10 @@ void BitcodeFile::parseLazy() {
   symbols.resize(obj->symbols().size());
   for (auto it : llvm::enumerate(obj->symbols()))
     if (!it.value().isUndefined()) {
-      auto *sym = symtab.insert(saver().save(it.value().getName()));
-      sym->resolve(LazyObject{*this});
+      Symbol *sym =
+          symtab.insertLazy(saver().save(it.value().getName()), *this);
+      if (sym)
+        sym->resolve(LazyObject{*this});
       symbols[it.index()] = sym;
     }
 }
@@ -1773,7 +1791,8 @@ template <class ELFT> void ObjFile<ELFT>::parseLazy() {
   symbols.resize(eSyms.size());
   for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i)
     if (eSyms[i].st_shndx != SHN_UNDEF)
-      symbols[i] = symtab.insert(CHECK(eSyms[i].getName(stringTable), this));
+      symbols[i] =
+          symtab.insertLazy(CHECK(eSyms[i].getName(stringTable), this), *this);
 
   // Replace existing symbols with LazyObject symbols.
   //
@@ -320,11 +320,19 @@ public:
   BitcodeFile(MemoryBufferRef m, StringRef archiveName,
               uint64_t offsetInArchive, bool lazy);
   static bool classof(const InputFile *f) { return f->kind() == BitcodeKind; }
+  // Reads the IR symbol table into obj, and the target of the file from it.
+  // This only depends on the file, so it can be done in parallel for many
+  // files. Returns false on error.
+  bool readIRSymtab();
   template <class ELFT> void parse();
   void parseLazy();
   void postParse();
   std::unique_ptr<llvm::lto::InputFile> obj;
   std::vector<bool> keptComdats;
+
+private:
+  // The buffer of the file, with the unique name given to it for LTO.
+  MemoryBufferRef irMB;
 };
 
 // .so file.
@@ -70,16 +70,12 @@ InputSectionBase::InputSectionBase(InputFile *file, uint64_t flags,
     fatal(toString(this) + ": sh_addralign is not a power of 2");
   this->alignment = v;
 
-  // In ELF, each section can be compressed by zlib, and if compressed,
-  // section name may be mangled by appending "z" (e.g. ".zdebug_info").
-  // If that's the case, demangle section name so that we can handle a
-  // section as if it weren't compressed.
-  if ((flags & SHF_COMPRESSED) || name.startswith(".zdebug")) {
-    if (!zlib::isAvailable())
-      error(toString(file) + ": contains a compressed section, " +
-            "but zlib is not available");
+  // In ELF, each section can be compressed by zlib or zstd, and if
+  // compressed, section name may be mangled by appending "z" (e.g.
+  // ".zdebug_info"). If that's the case, demangle section name so that we can
+  // handle a section as if it weren't compressed.
+  if ((flags & SHF_COMPRESSED) || name.startswith(".zdebug"))
     invokeELFT(parseCompressedHeader);
-  }
 }
 
 // Drop SHF_GROUP bit unless we are producing a re-linkable object file.
@@ -115,6 +111,13 @@ size_t InputSectionBase::getSize() const {
   return rawData.size() - bytesDropped;
 }
 
+static Error uncompressSection(uint8_t type, ArrayRef<uint8_t> in, char *out,
+                               size_t &size) {
+  if (type == ELFCOMPRESS_ZSTD)
+    return zstd::uncompress(toStringRef(in), out, size);
+  return zlib::uncompress(toStringRef(in), out, size);
+}
+
 void InputSectionBase::uncompress() const {
   size_t size = uncompressedSize;
   char *uncompressedBuf;
@@ -124,7 +127,8 @@ void InputSectionBase::uncompress() const {
     uncompressedBuf = bAlloc().Allocate<char>(size);
   }
 
-  if (Error e = zlib::uncompress(toStringRef(rawData), uncompressedBuf, size))
+  if (Error e =
+          uncompressSection(compressionType, rawData, uncompressedBuf, size))
     fatal(toString(this) +
           ": uncompress failed: " + llvm::toString(std::move(e)));
   rawData = makeArrayRef((uint8_t *)uncompressedBuf, size);
@@ -193,12 +197,17 @@ OutputSection *SectionBase::getOutputSection() {
 }
 
 // When a section is compressed, `rawData` consists with a header followed
-// by zlib-compressed data. This function parses a header to initialize
-// `uncompressedSize` member and remove the header from `rawData`.
+// by zlib- or zstd-compressed data. This function parses a header to
+// initialize `uncompressedSize` member and remove the header from `rawData`.
 template <typename ELFT> void InputSectionBase::parseCompressedHeader() {
   // Old-style header
   if (!(flags & SHF_COMPRESSED)) {
     assert(name.startswith(".zdebug"));
+    if (!zlib::isAvailable()) {
+      error(toString(this) + ": contains a compressed section, " +
+            "but zlib is not available");
+      return;
+    }
     if (!toStringRef(rawData).startswith("ZLIB")) {
       error(toString(this) + ": corrupted compressed section header");
       return;
@@ -228,11 +237,26 @@ template <typename ELFT> void InputSectionBase::parseCompressedHeader() {
   }
 
   auto *hdr = reinterpret_cast<const typename ELFT::Chdr *>(rawData.data());
-  if (hdr->ch_type != ELFCOMPRESS_ZLIB) {
-    error(toString(this) + ": unsupported compression type");
+  if (hdr->ch_type == ELFCOMPRESS_ZLIB) {
+    if (!zlib::isAvailable()) {
+      error(toString(this) + ": contains a compressed section, " +
+            "but zlib is not available");
+      return;
+    }
+  } else if (hdr->ch_type == ELFCOMPRESS_ZSTD) {
+    if (!zstd::isAvailable()) {
+      error(toString(this) + ": contains a compressed section, " +
+            "but zstd is not available");
+      return;
+    }
+  } else {
+    error(toString(this) + ": unsupported compression type (" +
+          Twine(hdr->ch_type) + ")");
     return;
   }
 
+  compressionType = hdr->ch_type;
+
   uncompressedSize = hdr->ch_size;
   alignment = std::max<uint32_t>(hdr->ch_addralign, 1);
   rawData = rawData.slice(sizeof(*hdr));
@@ -1231,7 +1255,7 @@ template <class ELFT> void InputSection::writeTo(uint8_t *buf) {
   // to the buffer.
   if (uncompressedSize >= 0) {
     size_t size = uncompressedSize;
-    if (Error e = zlib::uncompress(toStringRef(rawData), (char *)buf, size))
+    if (Error e = uncompressSection(compressionType, rawData, (char *)buf, size))
       fatal(toString(this) +
             ": uncompress failed: " + llvm::toString(std::move(e)));
     uint8_t *bufEnd = buf + size;
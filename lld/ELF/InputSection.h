@@ -139,6 +139,10 @@ public:
   // deleteFallThruJmpInsn.
   bool nopFiller = false;
 
+  // The ch_type of a compressed section, which is ELFCOMPRESS_ZLIB for
+  // .zdebug sections. Only meaningful if uncompressedSize >= 0.
+  uint8_t compressionType = llvm::ELF::ELFCOMPRESS_ZLIB;
+
   void drop_back(unsigned num) {
     assert(bytesDropped + num < 256);
     bytesDropped += num;
@@ -20,6 +20,7 @@
 #include "llvm/ADT/Twine.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Debuginfod/RemoteCache.h"
 #include "llvm/LTO/Config.h"
 #include "llvm/LTO/LTO.h"
 #include "llvm/Support/Caching.h"
@@ -149,12 +150,17 @@ static lto::Config createConfig() {
 
   c.HasWholeProgramVisibility = config->ltoWholeProgramVisibility;
   c.AlwaysEmitRegularLTOObj = !config->ltoObjPath.empty();
+  // --lto-obj-path and --lto-emit-asm write out the buffers of the regular LTO
+  // partitions, which are left empty by cache hits.
+  c.CacheRegularLTO = config->ltoCachePartitions &&
+                      config->ltoObjPath.empty() && !config->ltoEmitAsm;
 
   for (const llvm::StringRef &name : config->thinLTOModulesToCompile)
     c.ThinLTOModulesToCompile.emplace_back(name);
 
   c.TimeTraceEnabled = config->timeTraceEnabled;
   c.TimeTraceGranularity = config->timeTraceGranularity;
+  c.ThinLTOBackendReportFile = std::string(config->thinLTOBackendReport);
 
   c.CSIRProfile = std::string(config->ltoCSProfileFile);
   c.RunCSIRInstr = config->ltoCSProfileGenerate;
@@ -193,7 +199,8 @@ BitcodeCompiler::BitcodeCompiler() {
         config->thinLTOEmitImportsFiles, indexFile.get(), onIndexWrite);
   } else {
     backend = lto::createInProcessThinBackend(
-        llvm::heavyweight_hardware_concurrency(config->thinLTOJobs));
+        llvm::heavyweight_hardware_concurrency(config->thinLTOJobs),
+        config->thinLTOMemoryBudget);
   }
 
   ltoObj = std::make_unique<lto::LTO>(createConfig(), backend,
@@ -202,6 +209,9 @@ BitcodeCompiler::BitcodeCompiler() {
   // Initialize usedStartStop.
   if (bitcodeFiles.empty())
     return;
+  symtab->materializeLazy([](StringRef s) {
+    return s.startswith("__start_") || s.startswith("__stop_");
+  });
   for (Symbol *sym : symtab->symbols()) {
     if (sym->isPlaceholder())
       continue;
@@ -311,6 +321,9 @@ std::vector<InputFile *> BitcodeCompiler::compile() {
                          [&](size_t task, std::unique_ptr<MemoryBuffer> mb) {
                            files[task] = std::move(mb);
                          }));
+  if (cache && !config->thinLTORemoteCache.empty())
+    cache = remoteCache(config->thinLTORemoteCache, std::move(cache),
+                        std::chrono::seconds(10));
 
   if (!bitcodeFiles.empty())
     checkError(ltoObj->run(
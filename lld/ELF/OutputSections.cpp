@@ -16,13 +16,17 @@
 #include "lld/Common/Arrays.h"
 #include "lld/Common/Memory.h"
 #include "llvm/BinaryFormat/Dwarf.h"
-#include "llvm/Config/llvm-config.h" // LLVM_ENABLE_ZLIB
+#include "llvm/Config/llvm-config.h" // LLVM_ENABLE_ZLIB, LLVM_ENABLE_ZSTD
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TimeProfiler.h"
 #if LLVM_ENABLE_ZLIB
 #include <zlib.h>
 #endif
+#if LLVM_ENABLE_ZSTD
+#include <zstd.h>
+#endif
 
 using namespace llvm;
 using namespace llvm::dwarf;
@@ -322,14 +326,31 @@ static SmallVector<uint8_t, 0> deflateShard(ArrayRef<uint8_t> in, int level,
 }
 #endif
 
+#if LLVM_ENABLE_ZSTD
+// Compress a shard into a self-contained zstd frame. A zstd decoder
+// decompresses concatenated frames as if they were a single frame, so shards
+// can be compressed independently and simply be written one after another.
+static SmallVector<uint8_t, 0> compressZstdShard(ArrayRef<uint8_t> in,
+                                                 int level) {
+  SmallVector<uint8_t, 0> out;
+  out.resize_for_overwrite(ZSTD_compressBound(in.size()));
+  size_t n =
+      ZSTD_compress(out.data(), out.size(), in.data(), in.size(), level);
+  if (ZSTD_isError(n))
+    fatal("zstd compression failed: " + Twine(ZSTD_getErrorName(n)));
+  out.truncate(n);
+  return out;
+}
+#endif
+
 // Compress section contents if this section contains debug info.
 template <class ELFT> void OutputSection::maybeCompress() {
-#if LLVM_ENABLE_ZLIB
+#if LLVM_ENABLE_ZLIB || LLVM_ENABLE_ZSTD
   using Elf_Chdr = typename ELFT::Chdr;
 
   // Compress only DWARF debug sections.
-  if (!config->compressDebugSections || (flags & SHF_ALLOC) ||
-      !name.startswith(".debug_") || size == 0)
+  if (config->compressDebugSections == DebugCompressionKind::None ||
+      (flags & SHF_ALLOC) || !name.startswith(".debug_") || size == 0)
     return;
 
   llvm::TimeTraceScope timeScope("Compress debug sections");
@@ -337,6 +358,34 @@ template <class ELFT> void OutputSection::maybeCompress() {
   // Write uncompressed data to a temporary zero-initialized buffer.
   auto buf = std::make_unique<uint8_t[]>(size);
   writeTo<ELFT>(buf.get());
+
+#if LLVM_ENABLE_ZSTD
+  if (config->compressDebugSections == DebugCompressionKind::Zstd) {
+    // As with zlib, the fastest level is the default and -O2 trades some
+    // link time for a better ratio.
+    const int level = config->optimize >= 2 ? zstd::DefaultCompression
+                                            : zstd::BestSpeedCompression;
+    constexpr size_t shardSize = 1 << 20;
+    auto shardsIn = split(makeArrayRef<uint8_t>(buf.get(), size), shardSize);
+    const size_t numShards = shardsIn.size();
+    auto shardsOut = std::make_unique<SmallVector<uint8_t, 0>[]>(numShards);
+    parallelForEachN(0, numShards, [&](size_t i) {
+      shardsOut[i] = compressZstdShard(shardsIn[i], level);
+    });
+
+    compressed.type = ELFCOMPRESS_ZSTD;
+    compressed.uncompressedSize = size;
+    size = sizeof(Elf_Chdr);
+    for (size_t i = 0; i != numShards; ++i)
+      size += shardsOut[i].size();
+    compressed.shards = std::move(shardsOut);
+    compressed.numShards = numShards;
+    flags |= SHF_COMPRESSED;
+    return;
+  }
+#endif
+
+#if LLVM_ENABLE_ZLIB
   // We chose 1 (Z_BEST_SPEED) as the default compression level because it is
   // the fastest. If -O2 is given, we use level 6 to compress debug info more by
   // ~15%. We found that level 7 to 9 doesn't make much difference (~1% more
@@ -370,11 +419,13 @@ template <class ELFT> void OutputSection::maybeCompress() {
   }
   size += 4; // checksum
 
+  compressed.type = ELFCOMPRESS_ZLIB;
   compressed.shards = std::move(shardsOut);
   compressed.numShards = numShards;
   compressed.checksum = checksum;
   flags |= SHF_COMPRESSED;
 #endif
+#endif
 }
 
 static void writeInt(uint8_t *buf, uint64_t data, uint64_t size) {
@@ -400,25 +451,32 @@ template <class ELFT> void OutputSection::writeTo(uint8_t *buf) {
   // just write it down.
   if (compressed.shards) {
     auto *chdr = reinterpret_cast<typename ELFT::Chdr *>(buf);
-    chdr->ch_type = ELFCOMPRESS_ZLIB;
+    chdr->ch_type = compressed.type;
     chdr->ch_size = compressed.uncompressedSize;
     chdr->ch_addralign = alignment;
     buf += sizeof(*chdr);
 
+    // zstd frames are self-contained. A zlib stream needs a header and a
+    // trailing checksum around the raw deflate shards.
+    bool isZlib = compressed.type == ELFCOMPRESS_ZLIB;
+
     // Compute shard offsets.
     auto offsets = std::make_unique<size_t[]>(compressed.numShards);
-    offsets[0] = 2; // zlib header
+    offsets[0] = isZlib ? 2 : 0; // zlib header
     for (size_t i = 1; i != compressed.numShards; ++i)
       offsets[i] = offsets[i - 1] + compressed.shards[i - 1].size();
 
-    buf[0] = 0x78; // CMF
-    buf[1] = 0x01; // FLG: best speed
+    if (isZlib) {
+      buf[0] = 0x78; // CMF
+      buf[1] = 0x01; // FLG: best speed
+    }
     parallelForEachN(0, compressed.numShards, [&](size_t i) {
       memcpy(buf + offsets[i], compressed.shards[i].data(),
              compressed.shards[i].size());
     });
 
-    write32be(buf + (size - sizeof(*chdr) - 4), compressed.checksum);
+    if (isZlib)
+      write32be(buf + (size - sizeof(*chdr) - 4), compressed.checksum);
     return;
   }
 
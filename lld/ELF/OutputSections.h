@@ -24,6 +24,7 @@ struct CompressedData {
   std::unique_ptr<SmallVector<uint8_t, 0>[]> shards;
   uint32_t numShards = 0;
   uint32_t checksum = 0;
+  uint32_t type = 0; // ELFCOMPRESS_ZLIB or ELFCOMPRESS_ZSTD
   uint64_t uncompressedSize;
 };
 
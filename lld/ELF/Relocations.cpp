@@ -55,6 +55,7 @@
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/Parallel.h"
 #include <algorithm>
 
 using namespace llvm;
@@ -402,6 +403,8 @@ static void addCopyRelSymbol(SharedSymbol &ss) {
   }
 }
 
+struct ScanShard;
+
 // .eh_frame sections are mergeable input sections, so their input
 // offsets are not linearly mapped to output section. For each input
 // offset, we need to find a section piece containing the offset and
@@ -448,16 +451,18 @@ private:
 };
 
 // This class encapsulates states needed to scan relocations for one
-// InputSectionBase.
+// InputSectionBase. State shared with other sections is recorded in a
+// ScanShard instead of being updated directly.
 class RelocationScanner {
 public:
-  explicit RelocationScanner(InputSectionBase &sec)
-      : sec(sec), getter(sec), config(elf::config.get()), target(*elf::target) {
-  }
+  RelocationScanner(InputSectionBase &sec, ScanShard &shard)
+      : sec(sec), shard(shard), getter(sec), config(elf::config.get()),
+        target(*elf::target) {}
   template <class ELFT, class RelTy> void scan(ArrayRef<RelTy> rels);
 
 private:
   InputSectionBase &sec;
+  ScanShard &shard;
   OffsetGetter getter;
   const Configuration *const config;
   const TargetInfo &target;
@@ -474,6 +479,9 @@ private:
                                 uint64_t relOff) const;
   void processAux(RelExpr expr, RelType type, uint64_t offset, Symbol &sym,
                   int64_t addend) const;
+  void addSymbolReloc(RelocationBaseSection &relSec, RelType dynType,
+                      uint64_t offset, Symbol &sym, int64_t addend,
+                      RelType addendRelType) const;
   template <class ELFT, class RelTy> void scanOne(RelTy *&i);
 };
 } // namespace
@@ -586,6 +594,72 @@ struct UndefinedDiag {
 
 static std::vector<UndefinedDiag> undefs;
 
+// Symbol flags requested by relocation scanning. See ScanShard::merge().
+enum : uint16_t {
+  NEEDS_COPY = 1 << 0,
+  NEEDS_GOT = 1 << 1,
+  NEEDS_PLT = 1 << 2,
+  NEEDS_TLSDESC = 1 << 3,
+  NEEDS_TLSGD = 1 << 4,
+  NEEDS_TLSGD_TO_IE = 1 << 5,
+  NEEDS_GOT_DTPREL = 1 << 6,
+  NEEDS_TLSIE = 1 << 7,
+  HAS_DIRECT_RELOC = 1 << 8,
+  EXPORT_DYNAMIC = 1 << 9,
+};
+
+// Relocation scanning processes input sections in shards, each of which is a
+// contiguous range of sections. Everything a scan would otherwise write to
+// state shared between sections (symbol flags, dynamic relocations and
+// undefined symbol diagnostics) is recorded in the shard and applied once all
+// shards have been scanned. Shards are applied in section order, so scanning
+// them in parallel produces the same output as a serial scan.
+struct ScanShard {
+  void setFlags(Symbol &sym, uint16_t flags) { symFlags[&sym] |= flags; }
+  void merge();
+
+  // Flags (NEEDS_GOT, etc.) to be set on symbols referenced by the shard.
+  DenseMap<Symbol *, uint16_t> symFlags;
+  // Dynamic relocations in the order they were requested.
+  SmallVector<std::pair<RelocationBaseSection *, DynamicReloc>, 0> dynRelocs;
+  SmallVector<std::pair<RelrBaseSection *, RelativeReloc>, 0> relrRelocs;
+  std::vector<UndefinedDiag> undefs;
+};
+
+void ScanShard::merge() {
+  // Flags are only ever set, so the iteration order does not matter.
+  for (const auto &it : symFlags) {
+    Symbol &sym = *it.first;
+    uint16_t flags = it.second;
+    if (flags & NEEDS_COPY)
+      sym.needsCopy = true;
+    if (flags & NEEDS_GOT)
+      sym.needsGot = true;
+    if (flags & NEEDS_PLT)
+      sym.needsPlt = true;
+    if (flags & NEEDS_TLSDESC)
+      sym.needsTlsDesc = true;
+    if (flags & NEEDS_TLSGD)
+      sym.needsTlsGd = true;
+    if (flags & NEEDS_TLSGD_TO_IE)
+      sym.needsTlsGdToIe = true;
+    if (flags & NEEDS_GOT_DTPREL)
+      sym.needsGotDtprel = true;
+    if (flags & NEEDS_TLSIE)
+      sym.needsTlsIe = true;
+    if (flags & HAS_DIRECT_RELOC)
+      sym.hasDirectReloc = true;
+    if (flags & EXPORT_DYNAMIC)
+      sym.exportDynamic = true;
+  }
+  for (const auto &it : dynRelocs)
+    it.first->addReloc(it.second);
+  for (const auto &it : relrRelocs)
+    it.first->relocs.push_back(it.second);
+  ::undefs.insert(::undefs.end(), std::make_move_iterator(undefs.begin()),
+                  std::make_move_iterator(undefs.end()));
+}
+
 // Check whether the definition name def is a mangled function name that matches
 // the reference name ref.
 static bool canSuggestExternCForCXX(StringRef ref, StringRef def) {
@@ -822,14 +896,16 @@ void elf::reportUndefinedSymbols() {
   undefs.clear();
 }
 
-// Report an undefined symbol if necessary.
+// Report an undefined symbol if necessary. The diagnostic is appended to
+// diags and emitted later by reportUndefinedSymbols().
 // Returns true if the undefined symbol will produce an error message.
 static bool maybeReportUndefined(Undefined &sym, InputSectionBase &sec,
-                                 uint64_t offset) {
+                                 uint64_t offset,
+                                 std::vector<UndefinedDiag> &diags) {
   // If versioned, issue an error (even if the symbol is weak) because we don't
   // know the defining filename which is required to construct a Verneed entry.
   if (sym.hasVersionSuffix) {
-    undefs.push_back({&sym, {{&sec, offset}}, false});
+    diags.push_back({&sym, {{&sec, offset}}, false});
     return true;
   }
   if (sym.isWeak())
@@ -854,7 +930,7 @@ static bool maybeReportUndefined(Undefined &sym, InputSectionBase &sec,
   bool isWarning =
       (config->unresolvedSymbols == UnresolvedPolicy::Warn && canBeExternal) ||
       config->noinhibitExec;
-  undefs.push_back({&sym, {{&sec, offset}}, isWarning});
+  diags.push_back({&sym, {{&sec, offset}}, isWarning});
   return !isWarning;
 }
 
@@ -874,9 +950,11 @@ RelType RelocationScanner::getMipsN32RelType(RelTy *&rel) const {
   return type;
 }
 
+// If shard is non-null, the dynamic relocation is recorded in the shard
+// instead of being added to .rela.dyn or .relr.dyn.
 static void addRelativeReloc(InputSectionBase &isec, uint64_t offsetInSec,
                              Symbol &sym, int64_t addend, RelExpr expr,
-                             RelType type) {
+                             RelType type, ScanShard *shard = nullptr) {
   Partition &part = isec.getPartition();
 
   // Add a relative relocation. If relrDyn section is enabled, and the
@@ -887,11 +965,24 @@ static void addRelativeReloc(InputSectionBase &isec, uint64_t offsetInSec,
   // address.
   if (part.relrDyn && isec.alignment >= 2 && offsetInSec % 2 == 0) {
     isec.relocations.push_back({expr, type, offsetInSec, addend, &sym});
-    part.relrDyn->relocs.push_back({&isec, offsetInSec});
+    if (shard)
+      shard->relrRelocs.push_back({part.relrDyn.get(), {&isec, offsetInSec}});
+    else
+      part.relrDyn->relocs.push_back({&isec, offsetInSec});
     return;
   }
-  part.relaDyn->addRelativeReloc(target->relativeRel, isec, offsetInSec, sym,
-                                 addend, type, expr);
+  if (!shard) {
+    part.relaDyn->addRelativeReloc(target->relativeRel, isec, offsetInSec, sym,
+                                   addend, type, expr);
+    return;
+  }
+  assert((!sym.isPreemptible || expr == R_GOT) &&
+         "cannot add relative relocation against preemptible symbol");
+  shard->dynRelocs.push_back(
+      {part.relaDyn.get(),
+       RelocationBaseSection::makeReloc(DynamicReloc::AddendOnlyWithTargetVA,
+                                        target->relativeRel, isec, offsetInSec,
+                                        sym, addend, expr, type)});
 }
 
 template <class PltSection, class GotPltSection>
@@ -1021,6 +1112,19 @@ bool RelocationScanner::isStaticLinkTimeConstant(RelExpr e, RelType type,
   return true;
 }
 
+// Record a dynamic relocation against sym in the shard. Like
+// RelocationBaseSection::addSymbolReloc(), the addend is written to the
+// section being scanned if required.
+void RelocationScanner::addSymbolReloc(RelocationBaseSection &relSec,
+                                       RelType dynType, uint64_t offset,
+                                       Symbol &sym, int64_t addend,
+                                       RelType addendRelType) const {
+  shard.dynRelocs.push_back(
+      {&relSec, RelocationBaseSection::makeReloc(
+                    DynamicReloc::AgainstSymbol, dynType, sec, offset, sym,
+                    addend, R_ADDEND, addendRelType)});
+}
+
 // The reason we have to do this early scan is as follows
 // * To mmap the output file, we need to know the size
 // * For that, we need to know how many dynamic relocs we will have.
@@ -1060,13 +1164,13 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
   if (canWrite) {
     RelType rel = target.getDynRel(type);
     if (expr == R_GOT || (rel == target.symbolicRel && !sym.isPreemptible)) {
-      addRelativeReloc(sec, offset, sym, addend, expr, type);
+      addRelativeReloc(sec, offset, sym, addend, expr, type, &shard);
       return;
     } else if (rel != 0) {
       if (config->emachine == EM_MIPS && rel == target.symbolicRel)
         rel = target.relativeRel;
-      sec.getPartition().relaDyn->addSymbolReloc(rel, sec, offset, sym, addend,
-                                                 type);
+      addSymbolReloc(*sec.getPartition().relaDyn, rel, offset, sym, addend,
+                     type);
 
       // MIPS ABI turns using of GOT and dynamic relocations inside out.
       // While regular ABI uses dynamic relocations to fill up GOT entries
@@ -1106,7 +1210,7 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
                 " against symbol '" + toString(*ss) +
                 "'; recompile with -fPIC or remove '-z nocopyreloc'" +
                 getLocation(sec, sym, offset));
-        sym.needsCopy = true;
+        shard.setFlags(sym, NEEDS_COPY);
       }
       sec.relocations.push_back({expr, type, offset, addend, &sym});
       return;
@@ -1144,8 +1248,7 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
         errorOrWarn("symbol '" + toString(sym) +
                     "' cannot be preempted; recompile with -fPIE" +
                     getLocation(sec, sym, offset));
-      sym.needsCopy = true;
-      sym.needsPlt = true;
+      shard.setFlags(sym, NEEDS_COPY | NEEDS_PLT);
       sec.relocations.push_back({expr, type, offset, addend, &sym});
       return;
     }
@@ -1188,7 +1291,8 @@ static unsigned handleMipsTlsRelocation(RelType type, Symbol &sym,
 // Returns the number of relocations processed.
 static unsigned handleTlsRelocation(RelType type, Symbol &sym,
                                     InputSectionBase &c, uint64_t offset,
-                                    int64_t addend, RelExpr expr) {
+                                    int64_t addend, RelExpr expr,
+                                    ScanShard &shard) {
   if (!sym.isTls())
     return 0;
 
@@ -1199,7 +1303,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
             R_TLSDESC_GOTPLT>(expr) &&
       config->shared) {
     if (expr != R_TLSDESC_CALL) {
-      sym.needsTlsDesc = true;
+      shard.setFlags(sym, NEEDS_TLSDESC);
       c.relocations.push_back({expr, type, offset, addend, &sym});
     }
     return 1;
@@ -1253,7 +1357,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
   // Local-Dynamic sequence where offset of tls variable relative to dynamic
   // thread pointer is stored in the got. This cannot be relaxed to Local-Exec.
   if (expr == R_TLSLD_GOT_OFF) {
-    sym.needsGotDtprel = true;
+    shard.setFlags(sym, NEEDS_GOT_DTPREL);
     c.relocations.push_back({expr, type, offset, addend, &sym});
     return 1;
   }
@@ -1261,7 +1365,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
   if (oneof<R_AARCH64_TLSDESC_PAGE, R_TLSDESC, R_TLSDESC_CALL, R_TLSDESC_PC,
             R_TLSDESC_GOTPLT, R_TLSGD_GOT, R_TLSGD_GOTPLT, R_TLSGD_PC>(expr)) {
     if (!toExecRelax) {
-      sym.needsTlsGd = true;
+      shard.setFlags(sym, NEEDS_TLSGD);
       c.relocations.push_back({expr, type, offset, addend, &sym});
       return 1;
     }
@@ -1269,7 +1373,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
     // Global-Dynamic relocs can be relaxed to Initial-Exec or Local-Exec
     // depending on the symbol being locally defined or not.
     if (sym.isPreemptible) {
-      sym.needsTlsGdToIe = true;
+      shard.setFlags(sym, NEEDS_TLSGD_TO_IE);
       c.relocations.push_back(
           {target->adjustTlsExpr(type, R_RELAX_TLS_GD_TO_IE), type, offset,
            addend, &sym});
@@ -1289,10 +1393,10 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
       c.relocations.push_back(
           {R_RELAX_TLS_IE_TO_LE, type, offset, addend, &sym});
     } else if (expr != R_TLSIE_HINT) {
-      sym.needsTlsIe = true;
+      shard.setFlags(sym, NEEDS_TLSIE);
       // R_GOT needs a relative relocation for PIC on i386 and Hexagon.
       if (expr == R_GOT && config->isPic && !target->usesOnlyLowPageBits(type))
-        addRelativeReloc(c, offset, sym, addend, expr, type);
+        addRelativeReloc(c, offset, sym, addend, expr, type, &shard);
       else
         c.relocations.push_back({expr, type, offset, addend, &sym});
     }
@@ -1324,7 +1428,7 @@ template <class ELFT, class RelTy> void RelocationScanner::scanOne(RelTy *&i) {
   // Error if the target symbol is undefined. Symbol index 0 may be used by
   // marker relocations, e.g. R_*_NONE and R_ARM_V4BX. Don't error on them.
   if (sym.isUndefined() && symIndex != 0 &&
-      maybeReportUndefined(cast<Undefined>(sym), sec, offset))
+      maybeReportUndefined(cast<Undefined>(sym), sec, offset, shard.undefs))
     return;
 
   const uint8_t *relocatedAddr = sec.rawData.begin() + offset;
@@ -1393,7 +1497,8 @@ template <class ELFT, class RelTy> void RelocationScanner::scanOne(RelTy *&i) {
       return;
     }
   } else if (unsigned processed =
-                 handleTlsRelocation(type, sym, sec, offset, addend, expr)) {
+                 handleTlsRelocation(type, sym, sec, offset, addend, expr,
+                                     shard)) {
     i += (processed - 1);
     return;
   }
@@ -1427,8 +1532,8 @@ template <class ELFT, class RelTy> void RelocationScanner::scanOne(RelTy *&i) {
   // We were asked not to generate PLT entries for ifuncs. Instead, pass the
   // direct relocation on through.
   if (sym.isGnuIFunc() && config->zIfuncNoplt) {
-    sym.exportDynamic = true;
-    mainPart->relaDyn->addSymbolReloc(type, sec, offset, sym, addend, type);
+    shard.setFlags(sym, EXPORT_DYNAMIC);
+    addSymbolReloc(*mainPart->relaDyn, type, offset, sym, addend, type);
     return;
   }
 
@@ -1443,12 +1548,14 @@ template <class ELFT, class RelTy> void RelocationScanner::scanOne(RelTy *&i) {
       // ftp://www.linux-mips.org/pub/linux/mips/doc/ABI/mipsabi.pdf
       in.mipsGot->addEntry(*sec.file, sym, addend, expr);
     } else {
-      sym.needsGot = true;
+      shard.setFlags(sym, NEEDS_GOT);
     }
   } else if (needsPlt(expr)) {
-    sym.needsPlt = true;
-  } else {
-    sym.hasDirectReloc = true;
+    shard.setFlags(sym, NEEDS_PLT);
+  } else if (sym.isGnuIFunc()) {
+    // hasDirectReloc is only used by handleNonPreemptibleIfunc(), so don't
+    // record it for other symbols.
+    shard.setFlags(sym, HAS_DIRECT_RELOC);
   }
 
   processAux(expr, type, offset, sym, addend);
@@ -1520,8 +1627,9 @@ void RelocationScanner::scan(ArrayRef<RelTy> rels) {
                       });
 }
 
-template <class ELFT> void elf::scanRelocations(InputSectionBase &s) {
-  RelocationScanner scanner(s);
+template <class ELFT>
+static void scanSection(InputSectionBase &s, ScanShard &shard) {
+  RelocationScanner scanner(s, shard);
   const RelsOrRelas<ELFT> rels = s.template relsOrRelas<ELFT>();
   if (rels.areRelocsRel())
     scanner.template scan<ELFT>(rels.rels);
@@ -1529,6 +1637,46 @@ template <class ELFT> void elf::scanRelocations(InputSectionBase &s) {
     scanner.template scan<ELFT>(rels.relas);
 }
 
+template <class ELFT> void elf::scanRelocations() {
+  // Scan all relocations. Each relocation goes through a series of tests to
+  // determine if it needs special treatment, such as creating GOT, PLT,
+  // copy relocations, etc. Note that relocations for non-alloc sections are
+  // directly processed by InputSection::relocateNonAlloc.
+  SmallVector<InputSectionBase *, 0> sections;
+  for (InputSectionBase *sec : inputSections)
+    if (sec->isLive() && isa<InputSection>(sec) && (sec->flags & SHF_ALLOC))
+      sections.push_back(sec);
+  for (Partition &part : partitions) {
+    for (EhInputSection *sec : part.ehFrame->sections)
+      sections.push_back(sec);
+    if (part.armExidx && part.armExidx->isLive())
+      for (InputSection *sec : part.armExidx->exidxSections)
+        sections.push_back(sec);
+  }
+
+  // Split the sections into a few shards per thread so that a shard with
+  // large sections does not leave other threads idle. MIPS and PPC64 update
+  // global state while scanning (the MIPS GOT, ppc64noTocRelax and per-file
+  // TLS relaxation flags), so they are scanned serially.
+  size_t numShards = 1;
+  if (config->emachine != EM_MIPS && config->emachine != EM_PPC64)
+    numShards = std::min<size_t>(
+        sections.size(), 4 * parallel::strategy.compute_thread_count());
+  numShards = std::max<size_t>(numShards, 1);
+  size_t shardSize = divideCeil(sections.size(), numShards);
+
+  std::vector<ScanShard> shards(numShards);
+  parallelForEachN(0, numShards, [&](size_t i) {
+    size_t begin = std::min(i * shardSize, sections.size());
+    size_t end = std::min(begin + shardSize, sections.size());
+    for (size_t j = begin; j != end; ++j)
+      scanSection<ELFT>(*sections[j], shards[i]);
+  });
+
+  for (ScanShard &shard : shards)
+    shard.merge();
+}
+
 static bool handleNonPreemptibleIfunc(Symbol &sym) {
   // Handle a reference to a non-preemptible ifunc. These are special in a
   // few ways:
@@ -2232,7 +2380,7 @@ void elf::hexagonTLSSymbolUpdate(ArrayRef<OutputSection *> outputSections) {
       });
 }
 
-template void elf::scanRelocations<ELF32LE>(InputSectionBase &);
-template void elf::scanRelocations<ELF32BE>(InputSectionBase &);
-template void elf::scanRelocations<ELF64LE>(InputSectionBase &);
-template void elf::scanRelocations<ELF64BE>(InputSectionBase &);
+template void elf::scanRelocations<ELF32LE>();
+template void elf::scanRelocations<ELF32BE>();
+template void elf::scanRelocations<ELF64LE>();
+template void elf::scanRelocations<ELF64BE>();
@@ -122,10 +122,11 @@ struct JumpInstrMod {
   unsigned size;
 };
 
-// This function writes undefined symbol diagnostics to an internal buffer.
-// Call reportUndefinedSymbols() after calling scanRelocations() to emit
+// Scan the relocations of all allocated input sections, in parallel if
+// possible. This function writes undefined symbol diagnostics to an internal
+// buffer. Call reportUndefinedSymbols() after calling scanRelocations() to emit
 // the diagnostics.
-template <class ELFT> void scanRelocations(InputSectionBase &);
+template <class ELFT> void scanRelocations();
 void reportUndefinedSymbols();
 void postScanRelocations();
 
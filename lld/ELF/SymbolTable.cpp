@@ -94,9 +94,61 @@ Symbol *SymbolTable::insert(StringRef name) {
   sym->versionId = VER_NDX_GLOBAL;
   if (pos != StringRef::npos)
     sym->hasVersionSuffix = true;
+  if (LLVM_UNLIKELY(!lazyNames.empty()))
+    resolveLazyName(sym, stem);
   return sym;
 }
 
+// If a lazy definition of a newly inserted symbol was recorded by
+// insertLazy(), turn the symbol into that LazyObject. The result is the same
+// as if the symbol had been created by insertLazy() in the first place.
+void SymbolTable::resolveLazyName(Symbol *sym, StringRef stem) {
+  auto it = lazyNames.find(CachedHashStringRef(stem));
+  if (it == lazyNames.end())
+    return;
+  StringRef lazyName(it->first.data(), it->second.nameSize);
+  InputFile *file = it->second.file;
+  lazyNames.erase(it);
+
+  // A name with a default version suffix takes precedence.
+  if (sym->getName().size() == stem.size() && lazyName.size() != stem.size()) {
+    sym->setName(lazyName);
+    sym->hasVersionSuffix = true;
+  }
+  sym->resolve(LazyObject{*file});
+}
+
+Symbol *SymbolTable::insertLazy(StringRef name, InputFile &file) {
+  StringRef stem = name;
+  size_t pos = name.find('@');
+  if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
+    stem = name.take_front(pos);
+
+  if (symMap.count(CachedHashStringRef(stem)))
+    return insert(name);
+  auto p = lazyNames.try_emplace(
+      CachedHashStringRef(stem),
+      LazyName{&file, uint32_t(name.size()), numLazyNames++});
+  // If the name was recorded by an earlier file, that file keeps the lazy
+  // definition. Only a default version suffix needs to be applied, which
+  // requires the symbol.
+  if (p.second || stem.size() == name.size())
+    return nullptr;
+  return insert(name);
+}
+
+void SymbolTable::materializeLazy(function_ref<bool(StringRef)> pred) {
+  SmallVector<std::pair<uint32_t, StringRef>, 0> names;
+  for (auto &p : lazyNames) {
+    StringRef name(p.first.data(), p.second.nameSize);
+    if (pred(name))
+      names.emplace_back(p.second.order, name);
+  }
+  llvm::sort(names);
+  for (std::pair<uint32_t, StringRef> &p : names)
+    insert(p.second);
+}
+
 Symbol *SymbolTable::addSymbol(const Symbol &newSym) {
   Symbol *sym = insert(newSym.getName());
   sym->resolve(newSym);
@@ -116,8 +168,12 @@ Symbol *SymbolTable::addAndCheckDuplicate(const Defined &newSym) {
 
 Symbol *SymbolTable::find(StringRef name) {
   auto it = symMap.find(CachedHashStringRef(name));
-  if (it == symMap.end())
-    return nullptr;
+  if (it == symMap.end()) {
+    if (LLVM_LIKELY(lazyNames.empty()) ||
+        !lazyNames.count(CachedHashStringRef(name)))
+      return nullptr;
+    return insert(name);
+  }
   return symVector[it->second];
 }
 
@@ -143,6 +199,7 @@ static bool canBeVersioned(const Symbol &sym) {
 // symbols.
 StringMap<SmallVector<Symbol *, 0>> &SymbolTable::getDemangledSyms() {
   if (!demangledSyms) {
+    materializeLazy([](StringRef) { return true; });
     demangledSyms.emplace();
     std::string demangled;
     for (Symbol *sym : symVector)
@@ -192,6 +249,8 @@ SmallVector<Symbol *, 0> SymbolTable::findAllByVersion(SymbolVersion ver,
     return res;
   }
 
+  materializeLazy(
+      [&](StringRef name) { return check(name) && m.match(name); });
   for (Symbol *sym : symVector)
     if (canBeVersioned(*sym) && check(sym->getName()) &&
         m.match(sym->getName()))
@@ -39,6 +39,17 @@ public:
 
   Symbol *insert(StringRef name);
 
+  // Like insert(), but for a definition in a lazy file (an archive member or a
+  // file within --start-lib). If no symbol of this name exists yet, the name is
+  // only recorded along with the file, and nullptr is returned. The symbol is
+  // created as a LazyObject when the name is first inserted or found, so lazy
+  // definitions that are never referenced do not cost a Symbol.
+  Symbol *insertLazy(StringRef name, InputFile &file);
+
+  // Creates the symbols for recorded lazy definitions whose names satisfy
+  // pred. Used by operations that match patterns against all symbols.
+  void materializeLazy(llvm::function_ref<bool(StringRef)> pred);
+
   Symbol *addSymbol(const Symbol &newSym);
   Symbol *addAndCheckDuplicate(const Defined &newSym);
 
@@ -77,6 +88,20 @@ private:
   llvm::DenseMap<llvm::CachedHashStringRef, int> symMap;
   SmallVector<Symbol *, 0> symVector;
 
+  // Lazy definitions recorded by insertLazy() for names that are not in
+  // symMap. The key is the name without a default version suffix (as in
+  // symMap), and nameSize gives the length of the full name, which starts at
+  // the same address. order is the insertion order, which keeps
+  // materializeLazy() reproducible.
+  struct LazyName {
+    InputFile *file;
+    uint32_t nameSize;
+    uint32_t order;
+  };
+  llvm::DenseMap<llvm::CachedHashStringRef, LazyName> lazyNames;
+  uint32_t numLazyNames = 0;
+  void resolveLazyName(Symbol *sym, StringRef stem);
+
   // A map from demangled symbol names to their symbol objects.
   // This mapping is 1:N because two symbols with different versions
   // can have the same name. We use this map to handle "extern C++ {}"
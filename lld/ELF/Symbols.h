@@ -273,7 +273,9 @@ public:
   uint8_t needsCopy : 1;
 
   // Temporary flags used to communicate which symbol entries need PLT and GOT
-  // entries during postScanRelocations();
+  // entries during postScanRelocations(). They are set after relocation
+  // scanning has finished (see ScanShard). hasDirectReloc is only set for
+  // ifuncs.
   uint8_t needsGot : 1;
   uint8_t needsPlt : 1;
   uint8_t needsTlsDesc : 1;
@@ -1253,11 +1253,7 @@ unsigned StringTableSection::addString(StringRef s, bool hashIt) {
 }
 
 void StringTableSection::writeTo(uint8_t *buf) {
-  for (StringRef s : strings) {
-    memcpy(buf, s.data(), s.size());
-    buf[s.size()] = '\0';
-    buf += s.size() + 1;
-  }
+  writeStringTable(buf, strings);
 }
 
 // Returns the number of entries in .gnu.version_d: the number of
@@ -1634,17 +1630,16 @@ void RelocationBaseSection::addAddendOnlyRelocIfNonPreemptible(
              sym, 0, R_ABS, addendRelType);
 }
 
-void RelocationBaseSection::addReloc(DynamicReloc::Kind kind, RelType dynType,
-                                     InputSectionBase &inputSec,
-                                     uint64_t offsetInSec, Symbol &sym,
-                                     int64_t addend, RelExpr expr,
-                                     RelType addendRelType) {
+DynamicReloc RelocationBaseSection::makeReloc(
+    DynamicReloc::Kind kind, RelType dynType, InputSectionBase &inputSec,
+    uint64_t offsetInSec, Symbol &sym, int64_t addend, RelExpr expr,
+    RelType addendRelType) {
   // Write the addends to the relocated address if required. We skip
   // it if the written value would be zero.
   if (config->writeAddends && (expr != R_ADDEND || addend != 0))
     inputSec.relocations.push_back(
         {expr, addendRelType, offsetInSec, addend, &sym});
-  addReloc({dynType, &inputSec, offsetInSec, kind, sym, addend, expr});
+  return {dynType, &inputSec, offsetInSec, kind, sym, addend, expr};
 }
 
 void RelocationBaseSection::partitionRels() {
@@ -2212,9 +2207,11 @@ template <class ELFT> void SymbolTableSection<ELFT>::writeTo(uint8_t *buf) {
   // The first entry is a null entry as per the ELF spec.
   buf += sizeof(Elf_Sym);
 
-  auto *eSym = reinterpret_cast<Elf_Sym *>(buf);
-
-  for (SymbolTableEntry &ent : symbols) {
+  // Entries are independent of each other, so large tables are written in
+  // parallel.
+  parallelForEachN(0, symbols.size(), [&](size_t i) {
+    const SymbolTableEntry &ent = symbols[i];
+    auto *eSym = reinterpret_cast<Elf_Sym *>(buf) + i;
     Symbol *sym = ent.sym;
     bool isDefinedHere = type == SHT_SYMTAB || sym->partition == partition;
 
@@ -2255,9 +2252,7 @@ template <class ELFT> void SymbolTableSection<ELFT>::writeTo(uint8_t *buf) {
         eSym->st_size = 0;
       }
     }
-
-    ++eSym;
-  }
+  });
 
   // On MIPS we need to mark symbol which has a PLT entry and requires
   // pointer equality by STO_MIPS_PLT flag. That is necessary to help
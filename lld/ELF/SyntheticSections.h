@@ -139,7 +139,7 @@ public:
 
   // Flag to force GOT to be in output if we have relocations
   // that relies on its address.
-  bool hasGotOffRel = false;
+  std::atomic<bool> hasGotOffRel{false};
 
 protected:
   size_t numEntries = 0;
@@ -383,7 +383,7 @@ public:
 
   // Flag to force GotPlt to be in output if we have relocations
   // that relies on its address.
-  bool hasGotPltOffRel = false;
+  std::atomic<bool> hasGotPltOffRel{false};
 
 private:
   SmallVector<const Symbol *, 0> entries;
@@ -534,7 +534,18 @@ public:
                                           RelType addendRelType);
   void addReloc(DynamicReloc::Kind kind, RelType dynType,
                 InputSectionBase &inputSec, uint64_t offsetInSec, Symbol &sym,
-                int64_t addend, RelExpr expr, RelType addendRelType);
+                int64_t addend, RelExpr expr, RelType addendRelType) {
+    addReloc(makeReloc(kind, dynType, inputSec, offsetInSec, sym, addend, expr,
+                       addendRelType));
+  }
+  /// Return the dynamic relocation that the above addReloc() would add. The
+  /// addend is written to \p inputSec if required. This is used by the
+  /// relocation scan, which adds dynamic relocations after scanning.
+  static DynamicReloc makeReloc(DynamicReloc::Kind kind, RelType dynType,
+                                InputSectionBase &inputSec,
+                                uint64_t offsetInSec, Symbol &sym,
+                                int64_t addend, RelExpr expr,
+                                RelType addendRelType);
   bool isNeeded() const override { return !relocs.empty(); }
   size_t getSize() const override { return relocs.size() * this->entsize; }
   size_t getRelativeRelocCount() const { return numRelativeRelocs; }
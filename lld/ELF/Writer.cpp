@@ -24,7 +24,9 @@
 #include "lld/Common/CommonLinkerContext.h"
 #include "lld/Common/Filesystem.h"
 #include "lld/Common/Strings.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/RandomNumberGenerator.h"
@@ -32,6 +34,10 @@
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
 #include <climits>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #define DEBUG_TYPE "lld"
 
@@ -44,6 +50,45 @@ using namespace lld;
 using namespace lld::elf;
 
 namespace {
+// If the output file is not mmap'ed, FileOutputBuffer keeps the image in
+// memory and writes all of it to the file in commit(). On slow filesystems
+// (e.g. NFS) that write can take longer than the rest of the link.
+//
+// OutputStreamer writes ranges of the in-memory image to the output file on a
+// background thread as soon as their contents are final, so that the I/O
+// overlaps with writing the remaining sections and computing the build ID.
+// finish() writes everything that has not been written yet (headers, padding
+// and sections written late, such as the build ID note).
+class OutputStreamer {
+public:
+  OutputStreamer(StringRef path, int fd, const uint8_t *buf, uint64_t size)
+      : path(path), os(fd, /*shouldClose=*/true, /*unbuffered=*/true),
+        buf(buf), fileSize(size), thread([this] { run(); }) {}
+  ~OutputStreamer();
+
+  void add(uint64_t offset, uint64_t size);
+  std::error_code finish();
+
+private:
+  void run();
+  void stop();
+
+  std::string path;
+  raw_fd_ostream os;
+  const uint8_t *buf;
+  uint64_t fileSize;
+  bool finished = false;
+
+  // Ranges passed to add(). Only accessed by the main thread.
+  SmallVector<std::pair<uint64_t, uint64_t>, 0> added;
+
+  std::mutex mu;
+  std::condition_variable cv;
+  std::deque<std::pair<uint64_t, uint64_t>> queue;
+  bool done = false;
+  std::thread thread;
+};
+
 // The writer writes a SymbolTable result to a file.
 template <class ELFT> class Writer {
 public:
@@ -81,6 +126,7 @@ private:
   void writeBuildId();
 
   std::unique_ptr<FileOutputBuffer> &buffer;
+  std::unique_ptr<OutputStreamer> streamer;
 
   void addRelIpltSymbols();
   void addStartEndSymbols();
@@ -91,6 +137,74 @@ private:
 };
 } // anonymous namespace
 
+OutputStreamer::~OutputStreamer() {
+  stop();
+  os.close();
+  os.clear_error();
+  // The output is incomplete, e.g. because of an error after openFile().
+  if (!finished)
+    sys::fs::remove(path);
+}
+
+void OutputStreamer::add(uint64_t offset, uint64_t size) {
+  if (size == 0)
+    return;
+  added.emplace_back(offset, size);
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    queue.emplace_back(offset, size);
+  }
+  cv.notify_one();
+}
+
+void OutputStreamer::run() {
+  for (;;) {
+    std::pair<uint64_t, uint64_t> range;
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      cv.wait(lock, [&] { return done || !queue.empty(); });
+      if (queue.empty())
+        return;
+      range = queue.front();
+      queue.pop_front();
+    }
+    if (os.has_error())
+      continue;
+    os.seek(range.first);
+    os.write(reinterpret_cast<const char *>(buf + range.first), range.second);
+  }
+}
+
+void OutputStreamer::stop() {
+  if (!thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    done = true;
+  }
+  cv.notify_one();
+  thread.join();
+}
+
+std::error_code OutputStreamer::finish() {
+  llvm::sort(added);
+  uint64_t off = 0;
+  for (std::pair<uint64_t, uint64_t> &range : added) {
+    if (off < range.first)
+      add(off, range.first - off);
+    off = std::max(off, range.first + range.second);
+  }
+  if (off < fileSize)
+    add(off, fileSize - off);
+  stop();
+
+  std::error_code ec = os.error();
+  os.clear_error();
+  if (!ec)
+    finished = true;
+  return ec;
+}
+
 static bool needsInterpSection() {
   return !config->relocatable && !config->shared &&
          !config->dynamicLinker.empty() && script->needsInterpSection();
@@ -595,8 +709,12 @@ template <class ELFT> void Writer<ELFT>::run() {
     if (errorCount())
       return;
 
-    if (auto e = buffer->commit())
+    if (streamer) {
+      if (std::error_code ec = streamer->finish())
+        error("failed to write to the output file: " + ec.message());
+    } else if (auto e = buffer->commit()) {
       error("failed to write to the output file: " + toString(std::move(e)));
+    }
   }
 }
 
@@ -688,8 +806,12 @@ template <class ELFT> void Writer<ELFT>::copyLocalSymbols() {
   llvm::TimeTraceScope timeScope("Add local symbols");
   if (config->copyRelocs && config->discard != DiscardPolicy::None)
     markUsedLocalSymbols<ELFT>();
-  for (ELFFileBase *file : objectFiles) {
-    for (Symbol *b : file->getLocalSymbols()) {
+
+  // Select the symbols to keep for each file in parallel, and then add them
+  // in file order so that the output is deterministic.
+  SmallVector<SmallVector<Symbol *, 0>, 0> kept(objectFiles.size());
+  parallelForEachN(0, objectFiles.size(), [&](size_t i) {
+    for (Symbol *b : objectFiles[i]->getLocalSymbols()) {
       assert(b->isLocal() && "should have been caught in initializeSymbols()");
       auto *dr = dyn_cast<Defined>(b);
 
@@ -697,9 +819,12 @@ template <class ELFT> void Writer<ELFT>::copyLocalSymbols() {
       if (!dr)
         continue;
       if (includeInSymtab(*b) && shouldKeepInSymtab(*dr))
-        in.symTab->addSymbol(b);
+        kept[i].push_back(b);
     }
-  }
+  });
+  for (ArrayRef<Symbol *> syms : kept)
+    for (Symbol *b : syms)
+      in.symTab->addSymbol(b);
 }
 
 // Create a section symbol for each output section so that we can represent
@@ -1893,21 +2018,7 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
     // a linker-script-defined symbol is absolute.
     ppc64noTocRelax.clear();
     if (!config->relocatable) {
-      // Scan all relocations. Each relocation goes through a series of tests to
-      // determine if it needs special treatment, such as creating GOT, PLT,
-      // copy relocations, etc. Note that relocations for non-alloc sections are
-      // directly processed by InputSection::relocateNonAlloc.
-      for (InputSectionBase *sec : inputSections)
-        if (sec->isLive() && isa<InputSection>(sec) && (sec->flags & SHF_ALLOC))
-          scanRelocations<ELFT>(*sec);
-      for (Partition &part : partitions) {
-        for (EhInputSection *sec : part.ehFrame->sections)
-          scanRelocations<ELFT>(*sec);
-        if (part.armExidx && part.armExidx->isLive())
-          for (InputSection *sec : part.armExidx->exidxSections)
-            scanRelocations<ELFT>(*sec);
-      }
-
+      scanRelocations<ELFT>();
       reportUndefinedSymbols();
       postScanRelocations();
     }
@@ -2818,6 +2929,23 @@ template <class ELFT> void Writer<ELFT>::openFile() {
   }
   buffer = std::move(*bufferOrErr);
   Out::bufferStart = buffer->getBufferStart();
+
+  // See OutputStreamer. unlinkAsync() has moved an existing regular file out
+  // of the way, so if the path still exists it is a special file (e.g.
+  // /dev/null) that is left to FileOutputBuffer.
+  if (config->mmapOutputFile || config->oFormatBinary ||
+      config->outputFile == "-" || parallel::strategy.ThreadsRequested == 1 ||
+      sys::fs::exists(config->outputFile))
+    return;
+  unsigned mode = sys::fs::all_read | sys::fs::all_write;
+  if (!config->relocatable)
+    mode |= sys::fs::all_exe;
+  int fd;
+  if (!sys::fs::openFileForWrite(config->outputFile, fd,
+                                 sys::fs::CD_CreateAlways, sys::fs::OF_None,
+                                 mode))
+    streamer = std::make_unique<OutputStreamer>(
+        config->outputFile, fd, Out::bufferStart, fileSize);
 }
 
 template <class ELFT> void Writer<ELFT>::writeSectionsBinary() {
@@ -2865,16 +2993,34 @@ template <class ELFT> void Writer<ELFT>::writeTrapInstr() {
 template <class ELFT> void Writer<ELFT>::writeSections() {
   llvm::TimeTraceScope timeScope("Write sections");
 
+  // If the output is streamed, hand each section to the streamer once it has
+  // been written. .eh_frame_hdr is written by .eh_frame's writeTo() and the
+  // build ID note by writeBuildId(), so they are left to
+  // OutputStreamer::finish().
+  SmallPtrSet<OutputSection *, 4> late;
+  if (streamer)
+    for (Partition &part : partitions) {
+      if (part.ehFrameHdr)
+        late.insert(part.ehFrameHdr->getParent());
+      if (part.buildId)
+        late.insert(part.buildId->getParent());
+    }
+  auto write = [&](OutputSection *sec) {
+    sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+    if (streamer && sec->type != SHT_NOBITS && !late.count(sec))
+      streamer->add(sec->offset, sec->size);
+  };
+
   // In -r or --emit-relocs mode, write the relocation sections first as in
   // ELf_Rel targets we might find out that we need to modify the relocated
   // section while doing it.
   for (OutputSection *sec : outputSections)
     if (sec->type == SHT_REL || sec->type == SHT_RELA)
-      sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      write(sec);
 
   for (OutputSection *sec : outputSections)
     if (sec->type != SHT_REL && sec->type != SHT_RELA)
-      sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      write(sec);
 
   // Finally, check that all dynamic relocation addends were written correctly.
   if (config->checkDynamicRelocs && config->writeAddends) {
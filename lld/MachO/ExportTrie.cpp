@@ -42,6 +42,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/BinaryFormat/MachO.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Parallel.h"
 
 using namespace llvm;
 using namespace lld;
@@ -83,16 +84,17 @@ struct macho::TrieNode {
   std::vector<Edge> edges;
   Optional<ExportInfo> info;
   // Estimated offset from the start of the serialized trie to the current node.
-  // This will converge to the true offset when updateOffset() is run to a
-  // fixpoint.
+  // This will converge to the true offset when TrieBuilder::build() lays out
+  // the nodes to a fixpoint.
   size_t offset = 0;
 
-  // Returns whether the new estimated offset differs from the old one.
-  bool updateOffset(size_t &nextOffset);
+  // Returns the size of the node given the current estimated offsets of its
+  // children.
+  size_t getSize() const;
   void writeTo(uint8_t *buf) const;
 };
 
-bool TrieNode::updateOffset(size_t &nextOffset) {
+size_t TrieNode::getSize() const {
   // Size of the whole node (including the terminalSize and the outgoing edges.)
   // In contrast, terminalSize only records the size of the other data in the
   // node.
@@ -112,12 +114,7 @@ bool TrieNode::updateOffset(size_t &nextOffset) {
     nodeSize += edge.substring.size() + 1             // String length.
                 + getULEB128Size(edge.child->offset); // Offset len.
   }
-  // On input, 'nextOffset' is the new preferred location for this node.
-  bool result = (offset != nextOffset);
-  // Store new location in node object for use by parents.
-  offset = nextOffset;
-  nextOffset += nodeSize;
-  return result;
+  return nodeSize;
 }
 
 void TrieNode::writeTo(uint8_t *buf) const {
@@ -225,22 +222,31 @@ size_t TrieBuilder::build() {
   sortAndBuild(exported, root, 0, 0);
 
   // Assign each node in the vector an offset in the trie stream, iterating
-  // until all uleb128 sizes have stabilized.
+  // until all uleb128 sizes have stabilized. Node sizes only depend on the
+  // offsets from the previous round, so they can be computed in parallel.
+  // Offsets only ever grow, so this converges to the same layout as updating
+  // the nodes one at a time would.
+  std::vector<size_t> sizes(nodes.size());
   size_t offset;
   bool more;
   do {
+    parallelForEachN(0, nodes.size(),
+                     [&](size_t i) { sizes[i] = nodes[i]->getSize(); });
     offset = 0;
     more = false;
-    for (TrieNode *node : nodes)
-      more |= node->updateOffset(offset);
+    for (size_t i = 0, e = nodes.size(); i != e; ++i) {
+      more |= nodes[i]->offset != offset;
+      nodes[i]->offset = offset;
+      offset += sizes[i];
+    }
   } while (more);
 
   return offset;
 }
 
 void TrieBuilder::writeTo(uint8_t *buf) const {
-  for (TrieNode *node : nodes)
-    node->writeTo(buf);
+  // Each node writes to its own, already laid out range.
+  parallelForEach(nodes, [&](TrieNode *node) { node->writeTo(buf); });
 }
 
 namespace {
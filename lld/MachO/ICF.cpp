@@ -13,6 +13,7 @@
 #include "UnwindInfoSection.h"
 
 #include "lld/Common/CommonLinkerContext.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
@@ -377,7 +378,13 @@ void macho::foldIdenticalSections() {
     assert(isec->icfEqClass[0] == 0); // don't overwrite a unique ID!
     // Turn-on the top bit to guarantee that valid hashes have no collisions
     // with the small-integer unique IDs for ICF-ineligible sections
-    isec->icfEqClass[0] = xxHash64(isec->data) | (1ull << 63);
+    // Fold in the parts of the relocations that equalsConstant() compares
+    // directly, so that sections with identical data but different relocs
+    // start out in different classes.
+    hash_code hash = hash_value(xxHash64(isec->data));
+    for (const Reloc &r : isec->relocs)
+      hash = hash_combine(hash, r.type, r.pcrel, r.length, r.offset, r.addend);
+    isec->icfEqClass[0] = static_cast<uint64_t>(hash) | (1ull << 63);
   });
   // Now that every input section is either hashed or marked as unique, run the
   // segregation algorithm to detect foldable subsections.
@@ -17,11 +17,13 @@
 #include "Symbols.h"
 
 #include "lld/Common/CommonLinkerContext.h"
+#include "lld/Common/Strings.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SHA256.h"
 
@@ -202,7 +204,7 @@ void RebaseSection::finalizeContents() {
 
   os << static_cast<uint8_t>(REBASE_OPCODE_SET_TYPE_IMM | REBASE_TYPE_POINTER);
 
-  llvm::sort(locations, [](const Location &a, const Location &b) {
+  parallelSort(locations, [](const Location &a, const Location &b) {
     return a.isec->getVA(a.offset) < b.isec->getVA(b.offset);
   });
   for (const Location &loc : locations)
@@ -455,13 +457,13 @@ std::vector<std::pair<const Sym *, std::vector<BindingEntry>>>
 sortBindings(const BindingsMap<const Sym *> &bindingsMap) {
   std::vector<std::pair<const Sym *, std::vector<BindingEntry>>> bindingsVec(
       bindingsMap.begin(), bindingsMap.end());
-  for (auto &p : bindingsVec) {
+  parallelForEach(bindingsVec, [](auto &p) {
     std::vector<BindingEntry> &bindings = p.second;
     llvm::sort(bindings, [](const BindingEntry &a, const BindingEntry &b) {
       return a.target.getVA() < b.target.getVA();
     });
-  }
-  llvm::sort(bindingsVec, [](const auto &a, const auto &b) {
+  });
+  parallelSort(bindingsVec, [](const auto &a, const auto &b) {
     return a.second[0].target.getVA() < b.second[0].target.getVA();
   });
   return bindingsVec;
@@ -1149,11 +1151,7 @@ uint32_t StringTableSection::addString(StringRef str) {
 }
 
 void StringTableSection::writeTo(uint8_t *buf) const {
-  uint32_t off = 0;
-  for (StringRef str : strings) {
-    memcpy(buf + off, str.data(), str.size());
-    off += str.size() + 1; // account for null terminator
-  }
+  writeStringTable(buf, strings);
 }
 
 static_assert((CodeSignatureSection::blobHeadersSize % 8) == 0, "");
@@ -40,6 +40,11 @@ public:
   llvm::StringSaver saver{bAlloc};
   llvm::DenseMap<void *, SpecificAllocBase *> instances;
 
+  // For --print-arena-usage. The last reported total is used to print how much
+  // each phase added.
+  bool printArenaUsage = false;
+  size_t lastArenaUsage = 0;
+
   ErrorHandler e;
 };
 
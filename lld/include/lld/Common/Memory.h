@@ -22,12 +22,16 @@
 #define LLD_COMMON_MEMORY_H
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/TypeName.h"
 
 namespace lld {
 // A base class only used by the CommonLinkerContext to keep track of the
 // SpecificAlloc<> instances.
 struct SpecificAllocBase {
   virtual ~SpecificAllocBase() = default;
+  // The memory held by the arena, and the name of the type it allocates.
+  virtual size_t getTotalMemory() const = 0;
+  virtual llvm::StringRef getTypeName() const = 0;
   static SpecificAllocBase *getOrCreate(void *tag, size_t size, size_t align,
                                         SpecificAllocBase *(&creator)(void *));
 };
@@ -37,6 +41,10 @@ template <class T> struct SpecificAlloc : public SpecificAllocBase {
   static SpecificAllocBase *create(void *storage) {
     return new (storage) SpecificAlloc<T>();
   }
+  size_t getTotalMemory() const override { return alloc.getTotalMemory(); }
+  llvm::StringRef getTypeName() const override {
+    return llvm::getTypeName<T>();
+  }
   llvm::SpecificBumpPtrAllocator<T> alloc;
   static int tag;
 };
@@ -62,6 +70,11 @@ template <typename T, typename... U> T *make(U &&... args) {
       T(std::forward<U>(args)...);
 }
 
+// Reports the memory held by the arenas above at the end of the link phase
+// `phase`. The numbers are recorded as counters in the --time-trace output, and
+// are printed if CommonLinkerContext::printArenaUsage is set.
+void reportArenaUsage(llvm::StringRef phase);
+
 } // namespace lld
 
 #endif
@@ -32,6 +32,11 @@ bool isValidCIdentifier(llvm::StringRef s);
 // Write the contents of the a buffer to a file
 void saveBuffer(llvm::StringRef buffer, const llvm::Twine &path);
 
+// Writes strings to buf back to back, each followed by a NUL byte. This is the
+// contents of a string table whose string offsets were assigned in the same
+// order. Large tables are written in parallel.
+void writeStringTable(uint8_t *buf, llvm::ArrayRef<llvm::StringRef> strings);
+
 // A single pattern to match against. A pattern can either be double-quoted
 // text that should be matched exactly after removing the quoting marks or a
 // glob pattern in the sense of GlobPattern.
@@ -902,6 +902,13 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
 
   createSyntheticSymbols();
 
+  // Parse the object files in parallel. Only adding them to the symbol table
+  // below has to be done sequentially, in command line order.
+  parallelForEach(files, [](InputFile *f) {
+    if (auto *obj = dyn_cast<ObjFile>(f))
+      obj->parseWasmObj();
+  });
+
   // Add all files to the symbol table. This will add almost all
   // symbols that we need to the symbol table.
   for (InputFile *f : files)
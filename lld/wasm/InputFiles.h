@@ -113,6 +113,11 @@ public:
 
   void parse(bool ignoreComdats = false);
 
+  // Parses the underlying wasm file. This does not touch the symbol table or
+  // allocate from the pools, so it may be called from parallelForEach. parse()
+  // calls it if it hasn't been called yet.
+  void parseWasmObj();
+
   // Returns the underlying wasm file.
   const WasmObjectFile *getWasmObj() const { return wasmObj.get(); }
 
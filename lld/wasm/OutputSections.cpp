@@ -88,10 +88,14 @@ void CodeSection::finalizeContents() {
   os.flush();
   bodySize = codeSectionHeader.size();
 
+  // Computing the size of a function with compressed relocations means
+  // evaluating all of its relocations, so do that in parallel and only assign
+  // the offsets sequentially.
+  parallelForEach(functions, [](InputFunction *func) { func->calculateSize(); });
+
   for (InputFunction *func : functions) {
     func->outputSec = this;
     func->outSecOff = bodySize;
-    func->calculateSize();
     // All functions should have a non-empty body at this point
     assert(func->getSize());
     bodySize += func->getSize();
@@ -114,9 +118,10 @@ void CodeSection::writeTo(uint8_t *buf) {
   // Write code section headers
   memcpy(buf, codeSectionHeader.data(), codeSectionHeader.size());
 
-  // Write code section bodies
-  for (const InputChunk *chunk : functions)
-    chunk->writeTo(buf);
+  // Write code section bodies. Each function has its own range of the output
+  // buffer, so they can be copied and relocated in parallel.
+  parallelForEach(functions,
+                  [buf](const InputChunk *chunk) { chunk->writeTo(buf); });
 }
 
 uint32_t CodeSection::getNumRelocations() const {
@@ -205,8 +210,8 @@ void DataSection::writeTo(uint8_t *buf) {
     memcpy(segStart, segment->header.data(), segment->header.size());
 
     // Write segment data payload
-    for (const InputChunk *chunk : segment->inputSegments)
-      chunk->writeTo(buf);
+    parallelForEach(segment->inputSegments,
+                    [buf](const InputChunk *chunk) { chunk->writeTo(buf); });
   }
 }
 
@@ -291,8 +296,8 @@ void CustomSection::writeTo(uint8_t *buf) {
   buf += nameData.size();
 
   // Write custom sections payload
-  for (const InputChunk *section : inputSections)
-    section->writeTo(buf);
+  parallelForEach(inputSections,
+                  [buf](const InputChunk *section) { section->writeTo(buf); });
 }
 
 uint32_t CustomSection::getNumRelocations() const {
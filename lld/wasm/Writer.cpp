@@ -29,7 +29,6 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/LEB128.h"
-#include "llvm/Support/Parallel.h"
 
 #include <cstdarg>
 #include <map>
@@ -209,12 +208,17 @@ void Writer::writeHeader() {
   memcpy(buffer->getBufferStart(), header.data(), header.size());
 }
 
+// The code, data and custom sections write their input chunks in parallel.
+// Nested parallelForEach calls run sequentially, so the sections themselves
+// are written one after the other.
 void Writer::writeSections() {
   uint8_t *buf = buffer->getBufferStart();
-  parallelForEach(outputSections, [buf](OutputSection *s) {
+  for (OutputSection *s : outputSections) {
     assert(s->isNeeded());
     s->writeTo(buf);
-  });
+    // Start writing the section to disk while the next ones are produced.
+    buffer->writeback(s->getOffset(), s->getSize());
+  }
 }
 
 static void setGlobalPtr(DefinedGlobal *g, uint64_t memoryPtr) {
@@ -1666,7 +1670,8 @@ void Writer::openFile() {
 
   Expected<std::unique_ptr<FileOutputBuffer>> bufferOrErr =
       FileOutputBuffer::create(config->outputFile, fileSize,
-                               FileOutputBuffer::F_executable);
+                               FileOutputBuffer::F_executable |
+                                   FileOutputBuffer::F_preallocate);
 
   if (!bufferOrErr)
     error("failed to open " + config->outputFile + ": " +
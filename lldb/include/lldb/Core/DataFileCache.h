@@ -72,8 +72,21 @@ public:
   bool SetCachedData(llvm::StringRef key, llvm::ArrayRef<uint8_t> data);
 
   /// Remove the cache file associated with the key.
+  ///
+  /// Clients call this when the cached data is out of date or can't be
+  /// decoded, which is counted as an invalidation in the statistics.
   Status RemoveCacheFile(llvm::StringRef key);
 
+  /// Counts of the cache lookups and invalidations since the cache was
+  /// created.
+  struct Stats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t invalidations = 0;
+  };
+
+  Stats GetStats();
+
 private:
   /// Return the cache file that is associated with the key.
   FileSpec GetCacheFilePath(llvm::StringRef key);
@@ -83,6 +96,7 @@ private:
   std::mutex m_mutex;
   std::unique_ptr<llvm::MemoryBuffer> m_mem_buff_up;
   bool m_take_ownership = false;
+  Stats m_stats;
 };
 
 /// A signature for a given file on disk.
@@ -9,6 +9,7 @@
 #ifndef LLDB_SYMBOL_DWARFCALLFRAMEINFO_H
 #define LLDB_SYMBOL_DWARFCALLFRAMEINFO_H
 
+#include <atomic>
 #include <map>
 #include <mutex>
 
@@ -146,12 +147,14 @@ private:
   lldb::SectionSP m_section_sp;
   Flags m_flags = 0;
   cie_map_t m_cie_map;
+  std::mutex m_cie_map_mutex; // CIEs are parsed lazily by concurrent unwinds
 
   DataExtractor m_cfi_data;
   bool m_cfi_data_initialized = false; // only copy the section into the DE once
 
   FDEEntryMap m_fde_index;
-  bool m_fde_index_initialized = false; // only scan the section for FDEs once
+  std::atomic<bool> m_fde_index_initialized{false}; // only scan the section
+                                                    // for FDEs once
   std::mutex m_fde_index_mutex; // and isolate the thread that does it
 
   Type m_type;
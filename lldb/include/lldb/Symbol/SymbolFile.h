@@ -326,6 +326,13 @@ public:
   /// hasn't been indexed yet, or a valid duration if it has.
   virtual StatsDuration::Duration GetDebugInfoIndexTime() { return {}; }
 
+  /// Return the number of debug information entries that were parsed to
+  /// create types and their members.
+  ///
+  /// \returns 0 if no information has been parsed or if the symbol file
+  /// doesn't count them.
+  virtual uint64_t GetNumDebugInfoEntriesParsed() { return 0; }
+
   /// Get the additional modules that this symbol file uses to parse debug info.
   ///
   /// Some debug info is stored in stand alone object files that are represented
@@ -9,6 +9,7 @@
 #ifndef LLDB_SYMBOL_UNWINDTABLE_H
 #define LLDB_SYMBOL_UNWINDTABLE_H
 
+#include <atomic>
 #include <map>
 #include <mutex>
 
@@ -70,7 +71,9 @@ private:
   Module &m_module;
   collection m_unwinds;
 
-  bool m_initialized; // delay some initialization until ObjectFile is set up
+  // Delay some initialization until ObjectFile is set up. This is only set
+  // once all the unwind sources below exist, as they are read without m_mutex.
+  std::atomic<bool> m_initialized;
   std::mutex m_mutex;
 
   std::unique_ptr<CallFrameInfo> m_object_file_unwind_up;
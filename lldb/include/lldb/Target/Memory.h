@@ -31,6 +31,10 @@ public:
 
   size_t Read(lldb::addr_t addr, void *dst, size_t dst_len, Status &error);
 
+  /// Returns true if reading \a dst_len bytes at \a addr doesn't need to
+  /// read from the process.
+  bool IsCached(lldb::addr_t addr, size_t dst_len);
+
   uint32_t GetMemoryCacheLineSize() const { return m_L2_cache_line_byte_size; }
 
   void AddInvalidRange(lldb::addr_t base_addr, lldb::addr_t byte_size);
@@ -57,6 +61,20 @@ protected:
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  // The address right after the last L2 cache line that was read from the
+  // process, and the number of lines that are read at once. Sequential misses
+  // double the number of lines up to the memory-cache-read-ahead setting,
+  // other misses start again from a single line.
+  lldb::addr_t m_L2_next_miss_addr = LLDB_INVALID_ADDRESS;
+  uint32_t m_L2_read_ahead_lines = 1;
+
+  // Returns the L1 cache chunk that contains all of [addr, addr + len), or
+  // the end of the L1 cache.
+  BlockMap::const_iterator FindL1CacheData(lldb::addr_t addr, size_t len);
+
+  // Reads at least the L2 cache line at line_addr from the process, and as
+  // many of the following lines as the read-ahead allows.
+  size_t ReadL2CacheLines(lldb::addr_t line_addr, Status &error);
 
 private:
   MemoryCache(const MemoryCache &) = delete;
@@ -75,6 +75,7 @@ public:
 
   bool GetDisableMemoryCache() const;
   uint64_t GetMemoryCacheLineSize() const;
+  uint64_t GetMemoryCacheReadAhead() const;
   Args GetExtraStartupCommands() const;
   void SetExtraStartupCommands(const Args &args);
   FileSpec GetPythonOSPluginPath() const;
@@ -1479,6 +1480,18 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  /// Read several ranges of memory at once into the memory cache.
+  ///
+  /// The reads of these ranges that follow are then served from the cache
+  /// instead of accessing the process for every one of them. This does
+  /// nothing when the memory cache is disabled, or when the process plugin
+  /// can't read several ranges at once.
+  ///
+  /// \param[in] ranges
+  ///     The ranges of memory to read. Ranges that are already cached are
+  ///     skipped, and ranges that can't be read are ignored.
+  void PrefetchMemory(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges);
+
   /// Read a NULL terminated C string from memory
   ///
   /// This function will read a cache page at a time until the NULL
@@ -2497,6 +2510,13 @@ void PruneThreadPlans();
   lldb::StructuredDataPluginSP
   GetStructuredDataPlugin(ConstString type_name) const;
 
+  /// Get the statistics of the process plugin for the "statistics dump"
+  /// command, like the cost of communicating with a remote stub.
+  ///
+  /// \return
+  ///     A JSON object, or a null JSON value if the plugin has none.
+  virtual llvm::json::Value GetPluginStatistics() { return nullptr; }
+
 protected:
   friend class Trace;
   ///  Get the processor tracing type supported for this process.
@@ -2602,6 +2622,23 @@ protected:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  /// Actually do the reading of several ranges of memory from a process.
+  ///
+  /// Subclasses that can read several ranges with fewer accesses to the
+  /// process than reading them one at a time should override this function.
+  ///
+  /// \param[in] ranges
+  ///     The ranges of memory to read.
+  ///
+  /// \return
+  ///     One buffer for each range with the bytes that were read from it, or
+  ///     an empty shared pointer if none could be read. An empty vector is
+  ///     returned if the ranges can't be read at once.
+  virtual std::vector<lldb::DataBufferSP>
+  DoReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges) {
+    return {};
+  }
+
   /// DoGetMemoryRegionInfo is called by GetMemoryRegionInfo after it has
   /// removed non address bits from load_addr. Override this method in
   /// subclasses of Process.
@@ -422,6 +422,16 @@ public:
   GetValueObjectForFrameVariable(const lldb::VariableSP &variable_sp,
                                  lldb::DynamicValueType use_dynamic);
 
+  /// Read the memory of the given variables of this StackFrame at once, so
+  /// that their ValueObjects can get their values without reading memory one
+  /// variable at a time.
+  ///
+  /// \param [in] variable_list
+  ///     The variables that are about to be displayed. Variables that aren't
+  ///     in memory at the current pc, or that are too large to be worth it,
+  ///     are skipped.
+  void PrefetchVariableMemory(const VariableList &variable_list);
+
   /// Query this frame to determine what the default language should be when
   /// parsing expressions given the execution context.
   ///
@@ -93,6 +93,21 @@ struct StatsSuccessFail {
   uint32_t failures = 0;
 };
 
+/// A class to count the debug information entries parsed and the declarations
+/// imported to parse expressions.
+struct ExpressionParseStats {
+  void Notify(uint64_t dies_parsed, uint64_t decls_imported);
+
+  llvm::json::Value ToJSON() const;
+  uint32_t parses = 0;
+  uint64_t total_dies_parsed = 0;
+  uint64_t total_decls_imported = 0;
+  uint64_t max_dies_parsed = 0;
+  uint64_t max_decls_imported = 0;
+  uint64_t last_dies_parsed = 0;
+  uint64_t last_decls_imported = 0;
+};
+
 /// A class that represents statistics for a since lldb_private::Module.
 struct ModuleStats {
   llvm::json::Value ToJSON() const;
@@ -135,6 +150,8 @@ public:
   StatsDuration &GetCreateTime() { return m_create_time; }
   StatsSuccessFail &GetExpressionStats() { return m_expr_eval; }
   StatsSuccessFail &GetFrameVariableStats() { return m_frame_var; }
+  ExpressionParseStats &GetExpressionParseStats() { return m_expr_parse; }
+  StatsSuccessFail &GetExpressionCacheStats() { return m_expr_cache; }
 
 protected:
   StatsDuration m_create_time;
@@ -143,6 +160,9 @@ protected:
   llvm::Optional<StatsTimepoint> m_first_public_stop_time;
   StatsSuccessFail m_expr_eval{"expressionEvaluation"};
   StatsSuccessFail m_frame_var{"frameVariable"};
+  ExpressionParseStats m_expr_parse;
+  /// Successes are cache hits and failures are cache misses.
+  StatsSuccessFail m_expr_cache{"expressionCache"};
   std::vector<intptr_t> m_module_identifiers;
   void CollectStats(Target &target);
 };
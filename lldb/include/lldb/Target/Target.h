@@ -96,6 +96,8 @@ public:
 
   void SetPreloadSymbols(bool b);
 
+  bool GetParallelModuleLoad() const;
+
   bool GetDisableASLR() const;
 
   void SetDisableASLR(bool b);
@@ -190,6 +192,8 @@ public:
 
   uint64_t GetExprErrorLimit() const;
 
+  uint64_t GetExprCacheSize() const;
+
   bool GetUseHexImmediates() const;
 
   bool GetUseFastStepping() const;
@@ -562,6 +566,16 @@ public:
   lldb::ModuleSP GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr = nullptr);
 
+  /// Create the modules for \a module_specs in the shared module list in
+  /// parallel, and parse their object files and symbol tables, and preload
+  /// their symbols if target.preload-symbols is set.
+  ///
+  /// Dynamic loaders call this before adding a batch of modules to the target
+  /// with GetOrCreateModule, which then finds the modules ready in the shared
+  /// module list. This does nothing unless target.parallel-module-load is set
+  /// and the modules are found on the host.
+  void PrefetchModules(llvm::ArrayRef<ModuleSpec> module_specs);
+
   // Settings accessors
 
   static TargetProperties &GetGlobalProperties();
@@ -1110,6 +1124,23 @@ public:
                                const EvaluateExpressionOptions &options,
                                ValueObject *ctx_obj, Status &error);
 
+  /// Finds an expression that was parsed for \a key and can be executed again
+  /// in \a exe_ctx, and removes it from the expression cache while the
+  /// caller is using it.
+  ///
+  /// \return
+  ///     The parsed expression, or an empty shared pointer if there is none.
+  lldb::UserExpressionSP TakeCachedUserExpression(llvm::StringRef key,
+                                                  ExecutionContext &exe_ctx);
+
+  /// Adds a parsed expression to the expression cache, evicting the least
+  /// recently cached expressions beyond target.expr-cache-size.
+  void CacheUserExpression(llvm::StringRef key,
+                           lldb::UserExpressionSP expr_sp);
+
+  /// Drops all the expressions in the expression cache.
+  void ClearUserExpressionCache();
+
   // Creates a FunctionCaller for the given language, the rest of the
   // parameters have the same meaning as for the FunctionCaller constructor.
   // Since a FunctionCaller can't be
@@ -1473,6 +1504,11 @@ protected:
   bool m_suppress_stop_hooks; /// Used to not run stop hooks for expressions
   bool m_is_dummy_target;
   unsigned m_next_persistent_variable_index = 0;
+  /// Parsed expressions and their keys, most recently cached first.
+  using ExpressionCache =
+      std::list<std::pair<std::string, lldb::UserExpressionSP>>;
+  ExpressionCache m_expression_cache;
+  std::mutex m_expression_cache_mutex;
   /// An optional \a lldb_private::Trace object containing processor trace
   /// information of this target.
   lldb::TraceSP m_trace_sp;
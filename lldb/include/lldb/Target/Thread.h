@@ -56,6 +56,8 @@ public:
   bool GetStepOutAvoidsNoDebug() const;
 
   uint64_t GetMaxBacktraceDepth() const;
+
+  bool GetParallelBacktrace() const;
 };
 
 class Thread : public std::enable_shared_from_this<Thread>,
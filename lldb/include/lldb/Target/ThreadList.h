@@ -17,6 +17,7 @@
 #include "lldb/Utility/Iterable.h"
 #include "lldb/Utility/UserID.h"
 #include "lldb/lldb-private.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace lldb_private {
 
@@ -98,6 +99,12 @@ public:
 
   lldb::ThreadSP FindThreadByIndexID(uint32_t index_id, bool can_update = true);
 
+  /// Unwind the first \a num_frames stack frames of each of the threads in
+  /// \a tids, in parallel when the "parallel-backtrace" thread setting is
+  /// on. This only fills the threads' stack frame lists so that printing them
+  /// afterwards is fast.
+  void UnwindThreads(llvm::ArrayRef<lldb::tid_t> tids, uint32_t num_frames);
+
   lldb::ThreadSP GetThreadSPForThreadPtr(Thread *thread_ptr);
 
   lldb::ThreadSP GetBackingThread(const lldb::ThreadSP &real_thread);
@@ -798,6 +798,7 @@ SBValueList SBFrame::GetVariables(const lldb::SBVariablesOptions &options) {
 
 
   std::set<VariableSP> variable_set;
+  VariableList prefetch_variables;
   Process *process = exe_ctx.GetProcessPtr();
   if (target && process) {
     Process::StopLocker stop_locker;
@@ -840,6 +841,7 @@ SBValueList SBFrame::GetVariables(const lldb::SBVariablesOptions &options) {
                   if (in_scope_only && !variable_sp->IsInScope(frame))
                     continue;
 
+                  prefetch_variables.AddVariable(variable_sp);
                   ValueObjectSP valobj_sp(frame->GetValueObjectForFrameVariable(
                       variable_sp, eNoDynamicValues));
 
@@ -853,6 +855,8 @@ SBValueList SBFrame::GetVariables(const lldb::SBVariablesOptions &options) {
                 }
               }
             }
+            // None of these values have been read yet.
+            frame->PrefetchVariableMemory(prefetch_variables);
           }
         }
         if (recognized_arguments) {
@@ -614,6 +614,7 @@ protected:
       {
         const size_t num_variables = variable_list->GetSize();
         if (num_variables > 0) {
+          frame->PrefetchVariableMemory(*variable_list);
           for (size_t i = 0; i < num_variables; i++) {
             var_sp = variable_list->GetVariableAtIndex(i);
             switch (var_sp->GetScope()) {
@@ -74,6 +74,9 @@ bool CommandObjectIterateOverThreads::DoExecute(Args &command,
     }
   }
 
+  if (tids.size() > 1)
+    WillHandleThreads(tids);
+
   if (m_unique_stacks) {
     // Iterate over threads, finding unique stack buckets.
     std::set<UniqueStack> unique_stacks;
@@ -10,6 +10,7 @@
 #define LLDB_SOURCE_COMMANDS_COMMANDOBJECTTHREADUTIL_H
 
 #include "lldb/Interpreter/CommandObjectMultiword.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace lldb_private {
 
@@ -68,6 +69,11 @@ protected:
 
   virtual bool HandleOneThread(lldb::tid_t, CommandReturnObject &result) = 0;
 
+  // Override this to do work for all the threads that will be handled before
+  // HandleOneThread is called on each of them, e.g. to unwind them in
+  // parallel. It is only called when there is more than one thread.
+  virtual void WillHandleThreads(llvm::ArrayRef<lldb::tid_t> tids) {}
+
   bool BucketThread(lldb::tid_t tid, std::set<UniqueStack> &unique_stacks,
                     CommandReturnObject &result);
 
@@ -86,14 +86,17 @@ DataFileCache::GetCachedData(StringRef key) {
     // and we would be expected to fill in the data. In this function we only
     // want to check if the data was cached, so we don't want to call
     // "add_stream" in this function.
-    if (!add_stream)
+    if (!add_stream) {
+      ++m_stats.hits;
       return std::move(m_mem_buff_up);
+    }
   } else {
     Log *log = GetLog(LLDBLog::Modules);
     LLDB_LOG_ERROR(log, add_stream_or_err.takeError(),
                    "failed to get the cache add stream callback for key: {0}");
   }
   // Data was not cached.
+  ++m_stats.misses;
   return std::unique_ptr<llvm::MemoryBuffer>();
 }
 
@@ -146,13 +149,20 @@ FileSpec DataFileCache::GetCacheFilePath(llvm::StringRef key) {
 }
 
 Status DataFileCache::RemoveCacheFile(llvm::StringRef key) {
+  std::lock_guard<std::mutex> guard(m_mutex);
   FileSpec cache_file = GetCacheFilePath(key);
   FileSystem &fs = FileSystem::Instance();
   if (!fs.Exists(cache_file))
     return Status();
+  ++m_stats.invalidations;
   return fs.RemoveFile(cache_file);
 }
 
+DataFileCache::Stats DataFileCache::GetStats() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_stats;
+}
+
 CacheSignature::CacheSignature(lldb_private::Module *module) {
   Clear();
   UUID uuid = module->GetUUID();
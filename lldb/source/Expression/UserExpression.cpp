@@ -136,6 +136,36 @@ lldb::addr_t UserExpression::GetObjectPointer(lldb::StackFrameSP frame_sp,
   return ret;
 }
 
+/// Returns the key of \a expr in the expression cache of the target, or an
+/// empty string if the expression must not be reused. Whatever affects how
+/// the expression is parsed must be part of the key; the location it is
+/// evaluated at is checked by MatchesContext when the key is found.
+static std::string GetExpressionCacheKey(
+    ExecutionContext &exe_ctx, const EvaluateExpressionOptions &options,
+    llvm::StringRef expr, llvm::StringRef prefix, lldb::LanguageType language,
+    Expression::ResultType desired_type, ExecutionPolicy execution_policy,
+    ValueObject *ctx_obj) {
+  // Top level expressions and expressions that may declare persistent
+  // variables or types change the state of the target. Expressions in a
+  // context object depend on the address of that object.
+  if (ctx_obj || execution_policy == eExecutionPolicyTopLevel ||
+      options.GetDebug() || options.GetREPLEnabled() || expr.contains('$'))
+    return std::string();
+  Target *target = exe_ctx.GetTargetPtr();
+  if (!target || target->GetExprCacheSize() == 0)
+    return std::string();
+
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << language << ':' << desired_type << ':' << execution_policy << ':'
+     << options.GetUseDynamic() << ':' << options.GetGenerateDebugInfo()
+     << ':' << (exe_ctx.GetFramePtr() != nullptr) << ':'
+     << llvm::StringRef(options.GetPoundLineFilePath()) << ':'
+     << options.GetPoundLineLine() << ':' << prefix.size() << ':' << prefix
+     << expr;
+  return os.str();
+}
+
 lldb::ExpressionResults
 UserExpression::Evaluate(ExecutionContext &exe_ctx,
                          const EvaluateExpressionOptions &options,
@@ -220,18 +250,36 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
       language = frame->GetLanguage();
   }
 
-  lldb::UserExpressionSP user_expression_sp(
-      target->GetUserExpressionForLanguage(expr, full_prefix, language,
-                                           desired_type, options, ctx_obj,
-                                           error));
-  if (error.Fail()) {
-    LLDB_LOG(log, "== [UserExpression::Evaluate] Getting expression: {0} ==",
-             error.AsCString());
-    return lldb::eExpressionSetupError;
+  // An expression that was parsed without fix-its can be executed again at
+  // the same location, only its variables are materialized again.
+  const std::string cache_key =
+      GetExpressionCacheKey(exe_ctx, options, expr, full_prefix, language,
+                            desired_type, execution_policy, ctx_obj);
+  lldb::UserExpressionSP user_expression_sp;
+  if (!cache_key.empty()) {
+    user_expression_sp = target->TakeCachedUserExpression(cache_key, exe_ctx);
+    StatsSuccessFail &cache_stats =
+        target->GetStatistics().GetExpressionCacheStats();
+    if (user_expression_sp)
+      cache_stats.NotifySuccess();
+    else
+      cache_stats.NotifyFailure();
+  }
+  const bool is_cached = static_cast<bool>(user_expression_sp);
+
+  if (!is_cached) {
+    user_expression_sp.reset(target->GetUserExpressionForLanguage(
+        expr, full_prefix, language, desired_type, options, ctx_obj, error));
+    if (error.Fail()) {
+      LLDB_LOG(log,
+               "== [UserExpression::Evaluate] Getting expression: {0} ==",
+               error.AsCString());
+      return lldb::eExpressionSetupError;
+    }
   }
 
-  LLDB_LOG(log, "== [UserExpression::Evaluate] Parsing expression {0} ==",
-           expr.str());
+  LLDB_LOG(log, "== [UserExpression::Evaluate] {0} expression {1} ==",
+           is_cached ? "Reusing parsed" : "Parsing", expr.str());
 
   const bool keep_expression_in_memory = true;
   const bool generate_debug_info = options.GetGenerateDebugInfo();
@@ -246,6 +294,7 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
   DiagnosticManager diagnostic_manager;
 
   bool parse_success =
+      is_cached ||
       user_expression_sp->Parse(diagnostic_manager, exe_ctx, execution_policy,
                                 keep_expression_in_memory, generate_debug_info);
 
@@ -256,6 +305,9 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
 
   *fixed_expression = user_expression_sp->GetFixedText().str();
 
+  const bool can_cache =
+      !cache_key.empty() && parse_success && fixed_expression->empty();
+
   // If there is a fixed expression, try to parse it:
   if (!parse_success) {
     // Delete the expression that failed to parse before attempting to parse
@@ -323,6 +375,9 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
         error.SetExpressionError(lldb::eExpressionSetupError,
                                  "expression needed to run but couldn't");
     } else if (execution_policy == eExecutionPolicyTopLevel) {
+      // The new top level declarations may hide the ones that the cached
+      // expressions found.
+      target->ClearUserExpressionCache();
       error.SetError(UserExpression::kNoResult, lldb::eErrorTypeGeneric);
       return lldb::eExpressionCompleted;
     } else {
@@ -369,6 +424,10 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
           error.SetError(UserExpression::kNoResult, lldb::eErrorTypeGeneric);
         }
       }
+
+      // Expressions that stopped may still be used by their thread plan.
+      if (can_cache && execution_results == lldb::eExpressionCompleted)
+        target->CacheUserExpression(cache_key, user_expression_sp);
     }
   }
 
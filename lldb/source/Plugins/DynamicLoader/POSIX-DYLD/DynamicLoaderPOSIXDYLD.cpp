@@ -410,6 +410,16 @@ bool DynamicLoaderPOSIXDYLD::RendezvousBreakpointHit(
   return stop_when_images_change;
 }
 
+/// Parse the shared libraries of the rendezvous entries in [begin, end) in
+/// parallel, before they are added to the target one at a time.
+static void PrefetchModules(Target &target, DYLDRendezvous::iterator begin,
+                            DYLDRendezvous::iterator end) {
+  std::vector<ModuleSpec> module_specs;
+  for (DYLDRendezvous::iterator I = begin; I != end; ++I)
+    module_specs.emplace_back(I->file_spec, target.GetArchitecture());
+  target.PrefetchModules(module_specs);
+}
+
 void DynamicLoaderPOSIXDYLD::RefreshModules() {
   if (!m_rendezvous.Resolve())
     return;
@@ -434,6 +444,7 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
       E = m_rendezvous.end();
       m_initial_modules_added = true;
     }
+    PrefetchModules(m_process->GetTarget(), I, E);
     for (; I != E; ++I) {
       ModuleSP module_sp =
           LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -605,6 +616,8 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
     module_names.push_back(I->file_spec);
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
+  PrefetchModules(m_process->GetTarget(), m_rendezvous.begin(),
+                  m_rendezvous.end());
 
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     ModuleSP module_sp =
@@ -1029,6 +1029,8 @@ void ClangASTImporter::ASTImporterDelegate::Imported(clang::Decl *from,
   if (m_decls_to_ignore.count(to))
     return clang::ASTImporter::Imported(from, to);
 
+  ++m_main.m_num_decls_imported;
+
   // Transfer module ownership information.
   auto *from_source = llvm::dyn_cast_or_null<ClangExternalASTSourceCallbacks>(
       getFromContext().getExternalSource());
@@ -157,6 +157,9 @@ public:
 
   bool RequireCompleteType(clang::QualType type);
 
+  /// Return the number of declarations that were imported by this importer.
+  uint64_t GetNumDeclsImported() const { return m_num_decls_imported; }
+
   /// Updates the internal origin-tracking information so that the given
   /// 'original' decl is from now on used to import additional information
   /// into the given decl.
@@ -454,6 +457,7 @@ public:
       RecordDeclToLayoutMap;
 
   RecordDeclToLayoutMap m_record_decl_to_layout_map;
+  uint64_t m_num_decls_imported = 0;
 };
 
 } // namespace lldb_private
@@ -1470,7 +1470,11 @@ bool ClangExpressionDeclMap::GetVariableValue(VariableSP &var,
     return false;
   }
 
-  CompilerType var_clang_type = var_type->GetFullCompilerType();
+  // Only the layout of the variable's type is needed to materialize it. The
+  // records that it points to or refers to are completed on demand, when the
+  // expression accesses their members, so that a simple expression doesn't
+  // parse the full definitions of all the types reachable from the variable.
+  CompilerType var_clang_type = var_type->GetLayoutCompilerType();
 
   if (!var_clang_type) {
     LLDB_LOG(log, "Skipped a definition because it has no Clang type");
@@ -16,6 +16,7 @@
 #include "ClangUserExpression.h"
 
 #include "ASTResultSynthesizer.h"
+#include "ClangASTImporter.h"
 #include "ClangASTMetadata.h"
 #include "ClangDiagnostic.h"
 #include "ClangExpressionDeclMap.h"
@@ -643,6 +644,30 @@ static bool shouldRetryWithCppModule(Target &target, ExecutionPolicy exe_policy)
   return target.GetImportStdModule() == eImportStdModuleFallback;
 }
 
+/// Return the number of debug information entries parsed so far by the symbol
+/// files of the modules of the target.
+static uint64_t GetNumDebugInfoEntriesParsed(Target &target) {
+  uint64_t count = 0;
+  for (const ModuleSP &module_sp : target.GetImages().Modules())
+    if (SymbolFile *sym_file = module_sp->GetSymbolFile(/*can_create=*/false))
+      count += sym_file->GetNumDebugInfoEntriesParsed();
+  return count;
+}
+
+/// Return the number of declarations imported so far by the importer that
+/// is shared by the Clang expressions of the target.
+static uint64_t GetNumDeclsImported(Target &target) {
+  auto *state =
+      target.GetPersistentExpressionStateForLanguage(lldb::eLanguageTypeC);
+  if (!state)
+    return 0;
+  auto *persistent_vars = llvm::cast<ClangPersistentVariables>(state);
+  if (std::shared_ptr<ClangASTImporter> importer =
+          persistent_vars->GetClangASTImporter())
+    return importer->GetNumDeclsImported();
+  return 0;
+}
+
 bool ClangUserExpression::Parse(DiagnosticManager &diagnostic_manager,
                                 ExecutionContext &exe_ctx,
                                 lldb_private::ExecutionPolicy execution_policy,
@@ -676,6 +701,16 @@ bool ClangUserExpression::Parse(DiagnosticManager &diagnostic_manager,
   if (!exe_scope)
     exe_scope = exe_ctx.GetTargetPtr();
 
+  // Record how much debug information had to be parsed and imported into the
+  // expression's AST to find the declarations that the expression uses.
+  const uint64_t dies_parsed_before = GetNumDebugInfoEntriesParsed(*target);
+  const uint64_t decls_imported_before = GetNumDeclsImported(*target);
+  auto record_parse_stats = llvm::make_scope_exit([&]() {
+    target->GetStatistics().GetExpressionParseStats().Notify(
+        GetNumDebugInfoEntriesParsed(*target) - dies_parsed_before,
+        GetNumDeclsImported(*target) - decls_imported_before);
+  });
+
   bool parse_success = TryParse(diagnostic_manager, exe_scope, exe_ctx,
                                 execution_policy, keep_result_in_memory,
                                 generate_debug_info);
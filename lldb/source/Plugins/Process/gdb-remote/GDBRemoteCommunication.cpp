@@ -174,6 +174,7 @@ GDBRemoteCommunication::SendRawPacketNoLock(llvm::StringRef packet,
                         GDBRemotePacket::ePacketTypeSend, bytes_written);
 
     if (bytes_written == packet_length) {
+      ++m_num_packets_sent;
       if (!skip_ack && GetSendAcks())
         return GetAck();
       else
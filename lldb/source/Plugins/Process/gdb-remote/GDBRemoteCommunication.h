@@ -11,6 +11,7 @@
 
 #include "GDBRemoteCommunicationHistory.h"
 
+#include <atomic>
 #include <condition_variable>
 #include <future>
 #include <mutex>
@@ -162,6 +163,10 @@ public:
 
   void DumpHistory(Stream &strm);
 
+  /// The number of packets that were sent over this connection, not counting
+  /// the acks.
+  uint64_t GetNumPacketsSent() const { return m_num_packets_sent; }
+
   void SetPacketRecorder(repro::PacketRecorder *recorder);
 
   static llvm::Error ConnectLocally(GDBRemoteCommunication &client,
@@ -175,6 +180,7 @@ protected:
   uint32_t m_echo_number;
   LazyBool m_supports_qEcho;
   GDBRemoteCommunicationHistory m_history;
+  std::atomic<uint64_t> m_num_packets_sent{0};
   bool m_send_acks;
   bool m_is_platform; // Set to true if this class represents a platform,
                       // false if this class represents a debug session for
@@ -276,6 +276,7 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_avoid_g_packets = eLazyBoolCalculate;
     m_supports_multiprocess = eLazyBoolCalculate;
     m_supports_qSaveCore = eLazyBoolCalculate;
+    m_supports_multi_mem_read = eLazyBoolCalculate;
     m_supports_qXfer_auxv_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
@@ -334,6 +335,7 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
   m_supports_qEcho = eLazyBoolNo;
   m_supports_QPassSignals = eLazyBoolNo;
   m_supports_memory_tagging = eLazyBoolNo;
+  m_supports_multi_mem_read = eLazyBoolNo;
   m_supports_qSaveCore = eLazyBoolNo;
   m_uses_native_signals = eLazyBoolNo;
 
@@ -382,6 +384,8 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
         m_supports_multiprocess = eLazyBoolYes;
       else if (x == "memory-tagging+")
         m_supports_memory_tagging = eLazyBoolYes;
+      else if (x == "MultiMemRead+")
+        m_supports_multi_mem_read = eLazyBoolYes;
       else if (x == "qSaveCore+")
         m_supports_qSaveCore = eLazyBoolYes;
       else if (x == "native-signals+")
@@ -614,6 +618,13 @@ bool GDBRemoteCommunicationClient::GetMemoryTaggingSupported() {
   return m_supports_memory_tagging == eLazyBoolYes;
 }
 
+bool GDBRemoteCommunicationClient::GetMultiMemReadSupported() {
+  if (m_supports_multi_mem_read == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_multi_mem_read == eLazyBoolYes;
+}
+
 DataBufferSP GDBRemoteCommunicationClient::ReadMemoryTags(lldb::addr_t addr,
                                                           size_t len,
                                                           int32_t type) {
@@ -658,6 +669,54 @@ DataBufferSP GDBRemoteCommunicationClient::ReadMemoryTags(lldb::addr_t addr,
   return buffer_sp;
 }
 
+llvm::Expected<std::vector<DataBufferSP>>
+GDBRemoteCommunicationClient::ReadMemoryRanges(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges) {
+  StreamString packet;
+  packet.PutCString("MultiMemRead:ranges:");
+  for (size_t i = 0; i < ranges.size(); ++i)
+    packet.Printf("%s%" PRIx64 ",%zx", i == 0 ? "" : ",",
+                  ranges[i].GetRangeBase(), ranges[i].GetByteSize());
+  packet.PutChar(';');
+
+  StringExtractorGDBRemote response;
+  if (SendPacketAndWaitForResponse(packet.GetString(), response) !=
+      PacketResult::Success)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "failed to send MultiMemRead packet");
+  if (!response.IsNormalResponse())
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "MultiMemRead packet failed");
+
+  // We are expecting
+  // <bytes read>[,<bytes read>]...;<binary bytes>
+  llvm::StringRef lengths_str, data;
+  std::tie(lengths_str, data) = response.GetStringRef().split(';');
+  llvm::SmallVector<llvm::StringRef, 32> lengths;
+  lengths_str.split(lengths, ',');
+  if (lengths.size() != ranges.size())
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "invalid MultiMemRead response");
+
+  std::vector<DataBufferSP> buffers;
+  buffers.reserve(ranges.size());
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    uint64_t length;
+    if (lengths[i].getAsInteger(16, length) ||
+        length > ranges[i].GetByteSize() || length > data.size())
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "invalid MultiMemRead response");
+    buffers.push_back(length ? std::make_shared<DataBufferHeap>(
+                                   data.data(), length)
+                             : DataBufferSP());
+    data = data.drop_front(length);
+  }
+  if (!data.empty())
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "invalid MultiMemRead response");
+  return buffers;
+}
+
 Status GDBRemoteCommunicationClient::WriteMemoryTags(
     lldb::addr_t addr, size_t len, int32_t type,
     const std::vector<uint8_t> &tags) {
@@ -190,6 +190,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_x,
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+      &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_Z,
                                 &GDBRemoteCommunicationServerLLGS::Handle_Z);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_z,
@@ -660,6 +663,56 @@ GetRegistersAsJSON(NativeThreadProtocol &thread) {
   return register_object;
 }
 
+// Appends the frame pointer backchain of the first frames of a thread to a
+// stop reply as expedited memory, so that the client can backtrace them
+// without reading any memory.
+static void WriteExpeditedStackMemory(StreamString &response,
+                                      NativeProcessProtocol &process,
+                                      NativeRegisterContext &reg_ctx,
+                                      uint32_t frame_limit) {
+  const uint32_t fp_num = reg_ctx.ConvertRegisterKindToRegisterNumber(
+      eRegisterKindGeneric, LLDB_REGNUM_GENERIC_FP);
+  const RegisterInfo *const fp_info = reg_ctx.GetRegisterInfoAtIndex(fp_num);
+  if (fp_info == nullptr)
+    return;
+
+  const uint32_t addr_size = process.GetArchitecture().GetAddressByteSize();
+  if ((addr_size != 4 && addr_size != 8) || fp_info->byte_size != addr_size)
+    return;
+
+  RegisterValue reg_value;
+  if (reg_ctx.ReadRegister(fp_info, reg_value).Fail())
+    return;
+
+  lldb::addr_t fp = reg_value.GetAsUInt64(0);
+  for (uint32_t frame = 0; frame < frame_limit && fp != 0; ++frame) {
+    // The saved frame pointer and the return address.
+    uint8_t bytes[16];
+    size_t bytes_read = 0;
+    if (process.ReadMemoryWithoutTrap(fp, bytes, 2 * addr_size, bytes_read)
+            .Fail() ||
+        bytes_read != 2 * addr_size)
+      break;
+
+    response.Printf("memory:0x%" PRIx64 "=", fp);
+    response.PutBytesAsRawHex8(bytes, bytes_read);
+    response.PutChar(';');
+
+    lldb::addr_t next_fp = 0;
+    if (addr_size == 4) {
+      uint32_t next_fp32;
+      memcpy(&next_fp32, bytes, sizeof(next_fp32));
+      next_fp = next_fp32;
+    } else {
+      memcpy(&next_fp, bytes, sizeof(next_fp));
+    }
+    // The backchain goes up the stack, anything else is not a frame pointer.
+    if (next_fp <= fp)
+      break;
+    fp = next_fp;
+  }
+}
+
 static const char *GetStopReasonString(StopReason stop_reason) {
   switch (stop_reason) {
   case eStopReasonTrace:
@@ -932,6 +985,9 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
     }
   }
 
+  WriteExpeditedStackMemory(response, *m_current_process, reg_ctx,
+                            /*frame_limit=*/2);
+
   const char *reason_str = GetStopReasonString(tid_stop_info.reason);
   if (reason_str != nullptr) {
     response.Printf("reason:%s;", reason_str);
@@ -2307,6 +2363,65 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead(
+    StringExtractorGDBRemote &packet) {
+  Log *log = GetLog(LLDBLog::Process);
+
+  if (!m_current_process ||
+      (m_current_process->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOGF(
+        log,
+        "GDBRemoteCommunicationServerLLGS::%s failed, no process available",
+        __FUNCTION__);
+    return SendErrorResponse(0x15);
+  }
+
+  // MultiMemRead:ranges:<addr>,<length>[,<addr>,<length>]...;
+  llvm::StringRef ranges_str = packet.GetStringRef();
+  if (!ranges_str.consume_front("MultiMemRead:ranges:") ||
+      !ranges_str.consume_back(";"))
+    return SendIllFormedResponse(packet, "Invalid MultiMemRead packet");
+
+  llvm::SmallVector<llvm::StringRef, 32> fields;
+  ranges_str.split(fields, ',');
+  if (fields.size() % 2 != 0)
+    return SendIllFormedResponse(packet, "Invalid range in MultiMemRead packet");
+
+  // The response has the number of bytes read for each range, followed by
+  // the bytes of all the ranges. Ranges that can't be read have no bytes.
+  StreamGDBRemote response;
+  std::string buf;
+  for (size_t i = 0; i < fields.size(); i += 2) {
+    lldb::addr_t read_addr;
+    uint64_t byte_count;
+    if (fields[i].getAsInteger(16, read_addr) ||
+        fields[i + 1].getAsInteger(16, byte_count))
+      return SendIllFormedResponse(packet,
+                                   "Invalid range in MultiMemRead packet");
+
+    const size_t offset = buf.size();
+    buf.resize(offset + byte_count);
+    size_t bytes_read = 0;
+    if (byte_count) {
+      Status error = m_current_process->ReadMemoryWithoutTrap(
+          read_addr, &buf[offset], byte_count, bytes_read);
+      if (error.Fail())
+        LLDB_LOGF(log,
+                  "GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64
+                  " mem 0x%" PRIx64 ": failed to read. Error: %s",
+                  __FUNCTION__, m_current_process->GetID(), read_addr,
+                  error.AsCString());
+    }
+    buf.resize(offset + bytes_read);
+    response.Printf(i == 0 ? "%" PRIx64 : ",%" PRIx64, (uint64_t)bytes_read);
+  }
+  response.PutChar(';');
+  response.PutEscapedBytes(buf.data(), buf.size());
+
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle__M(StringExtractorGDBRemote &packet) {
   Log *log = GetLog(LLDBLog::Process);
@@ -3840,6 +3955,7 @@ std::vector<std::string> GDBRemoteCommunicationServerLLGS::HandleFeatures(
                             "QThreadSuffixSupported+",
                             "QListThreadsInStopReply+",
                             "qXfer:features:read+",
+                            "MultiMemRead+",
                         });
 
   // report server-only features
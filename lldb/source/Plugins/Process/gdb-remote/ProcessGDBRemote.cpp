@@ -1181,6 +1181,17 @@ ProcessGDBRemote::TraceGetBinaryData(const TraceGetBinaryDataRequest &request) {
   return m_gdb_comm.SendTraceGetBinaryData(request, GetInterruptTimeout());
 }
 
+llvm::json::Value ProcessGDBRemote::GetPluginStatistics() {
+  const uint64_t packets_sent = m_gdb_comm.GetNumPacketsSent();
+  return llvm::json::Object{
+      {"packetsSent", (int64_t)packets_sent},
+      {"currentStopPacketsSent",
+       (int64_t)(packets_sent - m_packets_sent_at_resume)},
+      {"lastStopPacketsSent", (int64_t)m_last_stop_packets_sent},
+      {"maxStopPacketsSent", (int64_t)m_max_stop_packets_sent},
+  };
+}
+
 void ProcessGDBRemote::DidExit() {
   // When we exit, disconnect from the GDB server communications
   m_gdb_comm.Disconnect();
@@ -1207,6 +1218,14 @@ Status ProcessGDBRemote::DoResume() {
   Log *log = GetLog(GDBRLog::Process);
   LLDB_LOGF(log, "ProcessGDBRemote::Resume()");
 
+  // Everything that was sent since the last resume was needed to handle the
+  // last stop.
+  const uint64_t packets_sent = m_gdb_comm.GetNumPacketsSent();
+  m_last_stop_packets_sent = packets_sent - m_packets_sent_at_resume;
+  m_max_stop_packets_sent =
+      std::max(m_max_stop_packets_sent, m_last_stop_packets_sent);
+  m_packets_sent_at_resume = packets_sent;
+
   ListenerSP listener_sp(
       Listener::MakeListener("gdb-remote.resume-packet-sent"));
   if (listener_sp->StartListeningForEvents(
@@ -2682,6 +2701,44 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   return 0;
 }
 
+std::vector<DataBufferSP> ProcessGDBRemote::DoReadMemoryRanges(
+    llvm::ArrayRef<Range<addr_t, size_t>> ranges) {
+  if (!m_gdb_comm.GetMultiMemReadSupported())
+    return {};
+
+  GetMaxMemorySize();
+  // Keep the packets short enough for any stub that supports MultiMemRead.
+  const size_t max_ranges_per_packet = 64;
+
+  std::vector<DataBufferSP> buffers;
+  buffers.reserve(ranges.size());
+  while (!ranges.empty()) {
+    // Send as many ranges in each packet as the response can hold.
+    size_t num_ranges = 0;
+    uint64_t total_size = 0;
+    while (num_ranges < ranges.size() && num_ranges < max_ranges_per_packet &&
+           total_size + ranges[num_ranges].GetByteSize() <= m_max_memory_size)
+      total_size += ranges[num_ranges++].GetByteSize();
+    if (num_ranges == 0) {
+      // Too large to be batched, this range is read when it is needed.
+      buffers.push_back(DataBufferSP());
+      ranges = ranges.drop_front();
+      continue;
+    }
+
+    llvm::Expected<std::vector<DataBufferSP>> batch =
+        m_gdb_comm.ReadMemoryRanges(ranges.take_front(num_ranges));
+    if (!batch) {
+      LLDB_LOG_ERROR(GetLog(GDBRLog::Memory), batch.takeError(),
+                     "failed to read memory ranges: {0}");
+      return {};
+    }
+    buffers.insert(buffers.end(), batch->begin(), batch->end());
+    ranges = ranges.drop_front(num_ranges);
+  }
+  return buffers;
+}
+
 bool ProcessGDBRemote::SupportsMemoryTagging() {
   return m_gdb_comm.GetMemoryTaggingSupported();
 }
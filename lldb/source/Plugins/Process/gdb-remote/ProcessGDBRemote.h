@@ -134,6 +134,9 @@ public:
   size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                       Status &error) override;
 
+  std::vector<lldb::DataBufferSP> DoReadMemoryRanges(
+      llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges) override;
+
   Status
   WriteObjectFile(std::vector<ObjectFile::LoadableData> entries) override;
 
@@ -166,6 +169,8 @@ public:
 
   llvm::Error TraceStart(const llvm::json::Value &request) override;
 
+  llvm::json::Value GetPluginStatistics() override;
+
   llvm::Expected<std::string> TraceGetState(llvm::StringRef type) override;
 
   llvm::Expected<std::vector<uint8_t>>
@@ -294,6 +299,12 @@ protected:
 
   bool m_vfork_in_progress;
 
+  // The number of packets that were sent when the process was last resumed,
+  // and the most packets that were sent from one resume to the next.
+  uint64_t m_packets_sent_at_resume = 0;
+  uint64_t m_last_stop_packets_sent = 0;
+  uint64_t m_max_stop_packets_sent = 0;
+
   // Accessors
   bool IsRunning(lldb::StateType state) {
     return state == lldb::eStateRunning || IsStepping(state);
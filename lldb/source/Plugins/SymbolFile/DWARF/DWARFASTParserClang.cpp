@@ -464,6 +464,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
     return nullptr;
   if (type_ptr)
     return type_ptr->shared_from_this();
+  dwarf->NotifyDIEParsed();
   // Set a bit that lets us know that we are currently parsing this
   dwarf->GetDIEToType()[die.GetDIE()] = DIE_IS_BEING_PARSED;
 
@@ -2906,6 +2907,7 @@ bool DWARFASTParserClang::ParseChildMembers(
 
   for (DWARFDIE die : parent_die.children()) {
     dw_tag_t tag = die.Tag();
+    die.GetDWARF()->NotifyDIEParsed();
 
     switch (tag) {
     case DW_TAG_APPLE_property:
@@ -678,7 +678,9 @@ bool ManualDWARFIndex::LoadFromCache() {
   bool signature_mismatch = false;
   lldb::offset_t offset = 0;
   const bool result = Decode(data, &offset, signature_mismatch);
-  if (signature_mismatch)
+  // Remove cache files that are out of date or can't be decoded, since the
+  // cache never replaces an existing file when the index is saved again.
+  if (!result)
     cache->RemoveCacheFile(GetCacheKey());
   return result;
 }
@@ -9,6 +9,7 @@
 #ifndef LLDB_SOURCE_PLUGINS_SYMBOLFILE_DWARF_SYMBOLFILEDWARF_H
 #define LLDB_SOURCE_PLUGINS_SYMBOLFILE_DWARF_SYMBOLFILEDWARF_H
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <mutex>
@@ -328,6 +329,13 @@ public:
     return m_parse_time;
   }
 
+  uint64_t GetNumDebugInfoEntriesParsed() override {
+    return m_num_dies_parsed;
+  }
+
+  /// Count a DIE that is parsed into a type or a member of a type.
+  virtual void NotifyDIEParsed() { ++m_num_dies_parsed; }
+
 protected:
   typedef llvm::DenseMap<const DWARFDebugInfoEntry *, lldb_private::Type *>
       DIEToTypePtr;
@@ -560,6 +568,7 @@ protected:
   /// address in the module.
   lldb::addr_t m_first_code_address = LLDB_INVALID_ADDRESS;
   lldb_private::StatsDuration m_parse_time;
+  std::atomic<uint64_t> m_num_dies_parsed{0};
 };
 
 #endif // LLDB_SOURCE_PLUGINS_SYMBOLFILE_DWARF_SYMBOLFILEDWARF_H
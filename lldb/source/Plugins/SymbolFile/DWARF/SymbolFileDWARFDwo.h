@@ -62,6 +62,8 @@ protected:
 
   SymbolFileDWARF &GetBaseSymbolFile() { return m_base_symbol_file; }
 
+  void NotifyDIEParsed() override { m_base_symbol_file.NotifyDIEParsed(); }
+
   /// If this file contains exactly one compile unit, this function will return
   /// it. Otherwise it returns nullptr.
   DWARFCompileUnit *FindSingleCompileUnit();
@@ -229,6 +229,7 @@ void DWARFCallFrameInfo::GetFunctionAddressAndSizeVector(
 
 const DWARFCallFrameInfo::CIE *
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset) {
+  std::lock_guard<std::mutex> guard(m_cie_map_mutex);
   cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
   if (pos != m_cie_map.end()) {
@@ -21,6 +21,8 @@
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/SymbolVendor.h"
 
+#include "llvm/ADT/ScopeExit.h"
+
 // There is one UnwindTable object per ObjectFile. It contains a list of Unwind
 // objects -- one per function, populated lazily -- for the ObjectFile. Each
 // Unwind object has multiple UnwindPlans for different scenarios.
@@ -44,7 +46,7 @@ void UnwindTable::Initialize() {
 
   if (m_initialized) // check again once we've acquired the lock
     return;
-  m_initialized = true;
+  auto initialized = llvm::make_scope_exit([this]() { m_initialized = true; });
   ObjectFile *object_file = m_module.GetObjectFile();
   if (!object_file)
     return;
@@ -14,6 +14,7 @@
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/State.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
 
@@ -36,6 +37,8 @@ void MemoryCache::Clear(bool clear_invalid_ranges) {
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
   m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_L2_next_miss_addr = LLDB_INVALID_ADDRESS;
+  m_L2_read_ahead_lines = 1;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -123,6 +126,88 @@ bool MemoryCache::RemoveInvalidRange(lldb::addr_t base_addr,
   return false;
 }
 
+MemoryCache::BlockMap::const_iterator
+MemoryCache::FindL1CacheData(addr_t addr, size_t len) {
+  if (m_L1_cache.empty())
+    return m_L1_cache.end();
+  AddrRange read_range(addr, len);
+  BlockMap::iterator pos = m_L1_cache.upper_bound(addr);
+  if (pos != m_L1_cache.begin()) {
+    --pos;
+  }
+  AddrRange chunk_range(pos->first, pos->second->GetByteSize());
+  if (chunk_range.Contains(read_range))
+    return pos;
+  return m_L1_cache.end();
+}
+
+bool MemoryCache::IsCached(addr_t addr, size_t dst_len) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  if (FindL1CacheData(addr, dst_len) != m_L1_cache.end())
+    return true;
+
+  // Reads larger than a cache line don't use the L2 cache.
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+  if (dst_len > cache_line_byte_size)
+    return false;
+  for (addr_t curr_addr = addr - (addr % cache_line_byte_size);
+       curr_addr < addr + dst_len; curr_addr += cache_line_byte_size) {
+    BlockMap::const_iterator pos = m_L2_cache.find(curr_addr);
+    if (pos == m_L2_cache.end() ||
+        pos->second->GetByteSize() != cache_line_byte_size)
+      return false;
+  }
+  return true;
+}
+
+size_t MemoryCache::ReadL2CacheLines(addr_t line_addr, Status &error) {
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+
+  // Reading a few lines costs about as much as reading one over a slow
+  // connection, so sequential misses read more lines ahead each time.
+  if (line_addr == m_L2_next_miss_addr) {
+    const uint64_t max_lines =
+        std::max<uint64_t>(m_process.GetMemoryCacheReadAhead(), 1);
+    m_L2_read_ahead_lines = static_cast<uint32_t>(
+        std::min<uint64_t>(max_lines, 2 * uint64_t(m_L2_read_ahead_lines)));
+  } else {
+    m_L2_read_ahead_lines = 1;
+  }
+
+  // Stop reading ahead before lines that are already known.
+  uint32_t num_lines = 1;
+  for (; num_lines < m_L2_read_ahead_lines; ++num_lines) {
+    const addr_t next_line_addr = line_addr + num_lines * cache_line_byte_size;
+    if (next_line_addr < line_addr || m_L2_cache.count(next_line_addr) ||
+        m_invalid_ranges.FindEntryThatContains(next_line_addr))
+      break;
+  }
+
+  DataBufferHeap buffer(num_lines * cache_line_byte_size, 0);
+  size_t bytes_read = m_process.ReadMemoryFromInferior(
+      line_addr, buffer.GetBytes(), buffer.GetByteSize(), error);
+  if (bytes_read == 0 && num_lines > 1) {
+    // Some stubs fail the whole read when a part of it can't be read.
+    error.Clear();
+    num_lines = 1;
+    bytes_read = m_process.ReadMemoryFromInferior(
+        line_addr, buffer.GetBytes(), cache_line_byte_size, error);
+  }
+  if (bytes_read == 0) {
+    m_L2_next_miss_addr = LLDB_INVALID_ADDRESS;
+    return 0;
+  }
+  m_L2_next_miss_addr = line_addr + num_lines * cache_line_byte_size;
+
+  for (size_t offset = 0; offset < bytes_read; offset += cache_line_byte_size) {
+    const size_t line_bytes =
+        std::min<size_t>(cache_line_byte_size, bytes_read - offset);
+    m_L2_cache[line_addr + offset] =
+        std::make_shared<DataBufferHeap>(buffer.GetBytes() + offset, line_bytes);
+  }
+  return std::min<size_t>(bytes_read, cache_line_byte_size);
+}
+
 size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
                          Status &error) {
   size_t bytes_left = dst_len;
@@ -135,18 +220,10 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   // when reading from them (no partial reads from the L1 cache).
 
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  if (!m_L1_cache.empty()) {
-    AddrRange read_range(addr, dst_len);
-    BlockMap::iterator pos = m_L1_cache.upper_bound(addr);
-    if (pos != m_L1_cache.begin()) {
-      --pos;
-    }
-    AddrRange chunk_range(pos->first, pos->second->GetByteSize());
-    if (chunk_range.Contains(read_range)) {
-      memcpy(dst, pos->second->GetBytes() + (addr - chunk_range.GetRangeBase()),
-             dst_len);
-      return dst_len;
-    }
+  BlockMap::const_iterator chunk = FindL1CacheData(addr, dst_len);
+  if (chunk != m_L1_cache.end()) {
+    memcpy(dst, chunk->second->GetBytes() + (addr - chunk->first), dst_len);
+    return dst_len;
   }
 
   // If this memory read request is larger than the cache line size, then we
@@ -225,22 +302,14 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
 
       if (bytes_left > 0) {
         assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
-            new DataBufferHeap(cache_line_byte_size, 0));
-        size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_up->GetBytes(),
-            data_buffer_heap_up->GetByteSize(), error);
+        size_t process_bytes_read = ReadL2CacheLines(curr_addr, error);
         if (process_bytes_read == 0)
           return dst_len - bytes_left;
 
-        if (process_bytes_read != cache_line_byte_size) {
-          if (process_bytes_read < data_buffer_heap_up->GetByteSize()) {
-            dst_len -= data_buffer_heap_up->GetByteSize() - process_bytes_read;
-            bytes_left = process_bytes_read;
-          }
-          data_buffer_heap_up->SetByteSize(process_bytes_read);
+        if (process_bytes_read < cache_line_byte_size) {
+          dst_len -= cache_line_byte_size - process_bytes_read;
+          bytes_left = process_bytes_read;
         }
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_up.release());
         // We have read data and put it into the cache, continue through the
         // loop again to get the data out of the cache...
       }
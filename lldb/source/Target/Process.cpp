@@ -199,6 +199,12 @@ uint64_t ProcessProperties::GetMemoryCacheLineSize() const {
       nullptr, idx, g_process_properties[idx].default_uint_value);
 }
 
+uint64_t ProcessProperties::GetMemoryCacheReadAhead() const {
+  const uint32_t idx = ePropertyMemCacheReadAhead;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_process_properties[idx].default_uint_value);
+}
+
 Args ProcessProperties::GetExtraStartupCommands() const {
   Args args;
   const uint32_t idx = ePropertyExtraStartCommand;
@@ -2053,6 +2059,32 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+void Process::PrefetchMemory(llvm::ArrayRef<Range<addr_t, size_t>> ranges) {
+  if (GetDisableMemoryCache())
+    return;
+
+  std::vector<Range<addr_t, size_t>> uncached_ranges;
+  for (const Range<addr_t, size_t> &range : ranges)
+    if (range.GetByteSize() > 0 &&
+        !m_memory_cache.IsCached(range.GetRangeBase(), range.GetByteSize()))
+      uncached_ranges.push_back(range);
+  // A single range is read just as fast when it is needed.
+  if (uncached_ranges.size() < 2)
+    return;
+
+  std::vector<DataBufferSP> buffers = DoReadMemoryRanges(uncached_ranges);
+  if (buffers.size() != uncached_ranges.size())
+    return;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    if (!buffers[i])
+      continue;
+    const addr_t addr = uncached_ranges[i].GetRangeBase();
+    RemoveBreakpointOpcodesFromBuffer(addr, buffers[i]->GetByteSize(),
+                                      buffers[i]->GetBytes());
+    m_memory_cache.AddL1CacheData(addr, buffers[i]);
+  }
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
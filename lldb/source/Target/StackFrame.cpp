@@ -1167,6 +1167,53 @@ StackFrame::GetValueObjectForFrameVariable(const VariableSP &variable_sp,
   return valobj_sp;
 }
 
+void StackFrame::PrefetchVariableMemory(const VariableList &variable_list) {
+  if (IsHistorical())
+    return;
+  ProcessSP process_sp = CalculateProcess();
+  TargetSP target_sp = CalculateTarget();
+  if (!process_sp || !target_sp)
+    return;
+
+  // Larger variables are mostly arrays and aggregates that are only partially
+  // displayed.
+  const uint64_t max_byte_size = process_sp->GetMemoryCacheLineSize();
+  ExecutionContext exe_ctx;
+  CalculateExecutionContext(exe_ctx);
+
+  std::vector<Range<addr_t, size_t>> ranges;
+  for (const VariableSP &variable_sp : variable_list) {
+    if (!variable_sp || variable_sp->GetLocationIsConstantValueData())
+      continue;
+
+    DWARFExpression &expr = variable_sp->LocationExpression();
+    addr_t loclist_base_load_addr = LLDB_INVALID_ADDRESS;
+    if (expr.IsLocationList()) {
+      SymbolContext sc;
+      variable_sp->CalculateSymbolContext(&sc);
+      if (sc.function)
+        loclist_base_load_addr =
+            sc.function->GetAddressRange().GetBaseAddress().GetLoadAddress(
+                target_sp.get());
+    }
+    Value value;
+    if (!expr.Evaluate(&exe_ctx, nullptr, loclist_base_load_addr, nullptr,
+                       nullptr, value, nullptr) ||
+        value.GetValueType() != Value::ValueType::LoadAddress)
+      continue;
+
+    Type *type = variable_sp->GetType();
+    if (!type)
+      continue;
+    llvm::Optional<uint64_t> byte_size = type->GetByteSize(this);
+    if (!byte_size || *byte_size == 0 || *byte_size > max_byte_size)
+      continue;
+    ranges.emplace_back(value.GetScalar().ULongLong(LLDB_INVALID_ADDRESS),
+                        *byte_size);
+  }
+  process_sp->PrefetchMemory(ranges);
+}
+
 bool StackFrame::IsInlined() {
   if (m_sc.block == nullptr)
     GetSymbolContext(eSymbolContextBlock);
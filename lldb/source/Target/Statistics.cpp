@@ -8,6 +8,7 @@
 
 #include "lldb/Target/Statistics.h"
 
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Symbol/SymbolFile.h"
@@ -33,6 +34,29 @@ json::Value StatsSuccessFail::ToJSON() const {
   return json::Object{{"successes", successes}, {"failures", failures}};
 }
 
+void ExpressionParseStats::Notify(uint64_t dies_parsed,
+                                  uint64_t decls_imported) {
+  ++parses;
+  total_dies_parsed += dies_parsed;
+  total_decls_imported += decls_imported;
+  max_dies_parsed = std::max(max_dies_parsed, dies_parsed);
+  max_decls_imported = std::max(max_decls_imported, decls_imported);
+  last_dies_parsed = dies_parsed;
+  last_decls_imported = decls_imported;
+}
+
+json::Value ExpressionParseStats::ToJSON() const {
+  return json::Object{
+      {"parses", parses},
+      {"totalDIEsParsed", (int64_t)total_dies_parsed},
+      {"maxDIEsParsed", (int64_t)max_dies_parsed},
+      {"lastDIEsParsed", (int64_t)last_dies_parsed},
+      {"totalDeclsImported", (int64_t)total_decls_imported},
+      {"maxDeclsImported", (int64_t)max_decls_imported},
+      {"lastDeclsImported", (int64_t)last_decls_imported},
+  };
+}
+
 static double elapsed(const StatsTimepoint &start, const StatsTimepoint &end) {
   StatsDuration::Duration elapsed =
       end.time_since_epoch() - start.time_since_epoch();
@@ -92,6 +116,8 @@ json::Value TargetStats::ToJSON(Target &target) {
   json::Object target_metrics_json{
       {m_expr_eval.name, m_expr_eval.ToJSON()},
       {m_frame_var.name, m_frame_var.ToJSON()},
+      {"expressionParse", m_expr_parse.ToJSON()},
+      {m_expr_cache.name, m_expr_cache.ToJSON()},
       {"moduleIdentifiers", std::move(json_module_uuid_array)}};
 
   if (m_launch_or_attach_time && m_first_private_stop_time) {
@@ -130,6 +156,9 @@ json::Value TargetStats::ToJSON(Target &target) {
                                       unix_signals_sp->GetHitCountStatistics());
     uint32_t stop_id = process_sp->GetStopID();
     target_metrics_json.try_emplace("stopCount", stop_id);
+    json::Value plugin_stats = process_sp->GetPluginStatistics();
+    if (plugin_stats.kind() != json::Value::Null)
+      target_metrics_json.try_emplace("processPlugin", std::move(plugin_stats));
   }
   target_metrics_json.try_emplace("breakpoints", std::move(breakpoints_array));
   target_metrics_json.try_emplace("totalBreakpointResolveTime",
@@ -255,5 +284,14 @@ llvm::json::Value DebuggerStats::ReportStatistics(Debugger &debugger,
       {"totalDebugInfoIndexSavedToCache", debug_index_saved},
       {"totalDebugInfoByteSize", debug_info_size},
   };
+  if (DataFileCache *cache = Module::GetIndexCache()) {
+    DataFileCache::Stats cache_stats = cache->GetStats();
+    global_stats.try_emplace("indexCache",
+                             json::Object{
+                                 {"hits", cache_stats.hits},
+                                 {"misses", cache_stats.misses},
+                                 {"invalidations", cache_stats.invalidations},
+                             });
+  }
   return std::move(global_stats);
 }
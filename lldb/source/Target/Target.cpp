@@ -62,6 +62,7 @@
 
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/Support/ThreadPool.h"
 
 #include <memory>
 #include <mutex>
@@ -181,6 +182,8 @@ void Target::CleanupProcess() {
   ClearAllWatchpointHitCounts();
   ClearAllWatchpointHistoricValues();
   m_latest_stop_hook_id = 0;
+  // The cached expressions were JIT compiled into the process.
+  ClearUserExpressionCache();
 }
 
 void Target::DeleteCurrentProcess() {
@@ -1381,6 +1384,7 @@ void Target::ClearModules(bool delete_locations) {
   ModulesDidUnload(m_images, delete_locations);
   m_section_load_history.Clear();
   m_images.Clear();
+  ClearUserExpressionCache();
   m_scratch_type_system_map.Clear();
 }
 
@@ -1610,6 +1614,23 @@ void Target::NotifyModulesRemoved(lldb_private::ModuleList &module_list) {
 void Target::ModulesDidLoad(ModuleList &module_list) {
   const size_t num_images = module_list.GetSize();
   if (m_valid && num_images) {
+    // Names in the cached expressions may resolve differently now.
+    ClearUserExpressionCache();
+    // Index the symbols of all the modules in parallel, or load their indexes
+    // from the index cache. This does nothing for modules that were already
+    // preloaded when they were added to the target.
+    if (GetPreloadSymbols()) {
+      if (num_images == 1) {
+        module_list.GetModuleAtIndex(0)->PreloadSymbols();
+      } else {
+        llvm::ThreadPool pool(llvm::optimal_concurrency(num_images));
+        for (size_t idx = 0; idx < num_images; ++idx)
+          pool.async([module_sp = module_list.GetModuleAtIndex(idx)]() {
+            module_sp->PreloadSymbols();
+          });
+        pool.wait();
+      }
+    }
     for (size_t idx = 0; idx < num_images; ++idx) {
       ModuleSP module_sp(module_list.GetModuleAtIndex(idx));
       LoadScriptingResourceForModule(module_sp, this);
@@ -1641,6 +1662,7 @@ void Target::SymbolsDidLoad(ModuleList &module_list) {
 
 void Target::ModulesDidUnload(ModuleList &module_list, bool delete_locations) {
   if (m_valid && module_list.GetSize()) {
+    ClearUserExpressionCache();
     UnloadModuleSections(module_list);
     m_breakpoint_list.UpdateBreakpoints(module_list, false, delete_locations);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, false,
@@ -2037,6 +2059,42 @@ bool Target::ReadPointerFromMemory(const Address &addr, Status &error,
   return false;
 }
 
+void Target::PrefetchModules(llvm::ArrayRef<ModuleSpec> module_specs) {
+  // Modules of remote platforms are found through the platform, which may
+  // have to download them one at a time.
+  if (module_specs.size() < 2 || !GetParallelModuleLoad() || !m_platform_sp ||
+      !m_platform_sp->IsHost())
+    return;
+
+  const FileSpecList search_paths = GetExecutableSearchPaths();
+  const bool preload_symbols = GetPreloadSymbols();
+  auto prefetch_module = [&](const ModuleSpec &module_spec) {
+    ModuleSpec transformed_spec(module_spec);
+    if (m_image_search_paths.GetSize())
+      if (m_image_search_paths.RemapPath(
+              module_spec.GetFileSpec().GetDirectory(),
+              transformed_spec.GetFileSpec().GetDirectory()))
+        transformed_spec.GetFileSpec().GetFilename() =
+            module_spec.GetFileSpec().GetFilename();
+    ModuleSP module_sp;
+    ModuleList::GetSharedModule(transformed_spec, module_sp, &search_paths,
+                                nullptr, nullptr);
+    if (!module_sp)
+      return;
+    if (preload_symbols)
+      module_sp->PreloadSymbols();
+    else
+      module_sp->GetSymtab();
+  };
+
+  llvm::ThreadPool pool(llvm::optimal_concurrency(module_specs.size()));
+  for (const ModuleSpec &module_spec : module_specs)
+    pool.async([&prefetch_module, &module_spec]() {
+      prefetch_module(module_spec);
+    });
+  pool.wait();
+}
+
 ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr) {
   ModuleSP module_sp;
@@ -2159,8 +2217,10 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
         }
 
         // Preload symbols outside of any lock, so hopefully we can do this for
-        // each library in parallel.
-        if (GetPreloadSymbols())
+        // each library in parallel. Modules that are added without a
+        // notification are preloaded together in ModulesDidLoad, when the
+        // dynamic loader reports all the modules it has added.
+        if (GetPreloadSymbols() && notify)
           module_sp->PreloadSymbols();
 
         llvm::SmallVector<ModuleSP, 1> replaced_modules;
@@ -2353,6 +2413,46 @@ UserExpression *Target::GetUserExpressionForLanguage(
   return user_expr;
 }
 
+lldb::UserExpressionSP
+Target::TakeCachedUserExpression(llvm::StringRef key,
+                                 ExecutionContext &exe_ctx) {
+  std::lock_guard<std::mutex> guard(m_expression_cache_mutex);
+  for (auto pos = m_expression_cache.begin(), end = m_expression_cache.end();
+       pos != end; ++pos) {
+    if (pos->first == key && pos->second->MatchesContext(exe_ctx)) {
+      lldb::UserExpressionSP expr_sp = std::move(pos->second);
+      m_expression_cache.erase(pos);
+      return expr_sp;
+    }
+  }
+  return lldb::UserExpressionSP();
+}
+
+void Target::CacheUserExpression(llvm::StringRef key,
+                                 lldb::UserExpressionSP expr_sp) {
+  const uint64_t max_size = GetExprCacheSize();
+  if (max_size == 0)
+    return;
+  ExpressionCache evicted;
+  {
+    std::lock_guard<std::mutex> guard(m_expression_cache_mutex);
+    m_expression_cache.emplace_front(key.str(), std::move(expr_sp));
+    while (m_expression_cache.size() > max_size)
+      evicted.splice(evicted.end(), m_expression_cache,
+                     std::prev(m_expression_cache.end()));
+  }
+  // The evicted expressions free their memory in the process when they are
+  // destroyed here, without holding the lock.
+}
+
+void Target::ClearUserExpressionCache() {
+  ExpressionCache evicted;
+  {
+    std::lock_guard<std::mutex> guard(m_expression_cache_mutex);
+    evicted.swap(m_expression_cache);
+  }
+}
+
 FunctionCaller *Target::GetFunctionCallerForLanguage(
     lldb::LanguageType language, const CompilerType &return_type,
     const Address &function_address, const ValueList &arg_value_list,
@@ -3921,6 +4021,12 @@ void TargetProperties::SetPreloadSymbols(bool b) {
   m_collection_sp->SetPropertyAtIndexAsBoolean(nullptr, idx, b);
 }
 
+bool TargetProperties::GetParallelModuleLoad() const {
+  const uint32_t idx = ePropertyParallelModuleLoad;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_target_properties[idx].default_uint_value != 0);
+}
+
 bool TargetProperties::GetDisableASLR() const {
   const uint32_t idx = ePropertyDisableASLR;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
@@ -4260,6 +4366,12 @@ uint64_t TargetProperties::GetExprErrorLimit() const {
       nullptr, idx, g_target_properties[idx].default_uint_value);
 }
 
+uint64_t TargetProperties::GetExprCacheSize() const {
+  const uint32_t idx = ePropertyExprCacheSize;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_target_properties[idx].default_uint_value);
+}
+
 bool TargetProperties::GetBreakpointsConsultPlatformAvoidList() {
   const uint32_t idx = ePropertyBreakpointUseAvoidList;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
@@ -147,6 +147,12 @@ uint64_t ThreadProperties::GetMaxBacktraceDepth() const {
       nullptr, idx, g_thread_properties[idx].default_uint_value != 0);
 }
 
+bool ThreadProperties::GetParallelBacktrace() const {
+  const uint32_t idx = ePropertyParallelBacktrace;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_thread_properties[idx].default_uint_value != 0);
+}
+
 // Thread Event Data
 
 ConstString Thread::ThreadEventData::GetFlavorString() {
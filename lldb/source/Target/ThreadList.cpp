@@ -20,6 +20,8 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/State.h"
 
+#include "llvm/Support/ThreadPool.h"
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -223,6 +225,31 @@ ThreadSP ThreadList::FindThreadByIndexID(uint32_t index_id, bool can_update) {
   return thread_sp;
 }
 
+void ThreadList::UnwindThreads(llvm::ArrayRef<lldb::tid_t> tids,
+                               uint32_t num_frames) {
+  if (tids.size() < 2 || num_frames == 0 ||
+      !Thread::GetGlobalProperties().GetParallelBacktrace())
+    return;
+
+  std::vector<ThreadSP> threads;
+  for (lldb::tid_t tid : tids)
+    if (ThreadSP thread_sp = FindThreadByID(tid))
+      threads.push_back(thread_sp);
+
+  // Each thread has its own stack frame list and unwinder, and the unwind
+  // plans of the modules are shared and locked, so the threads can be
+  // unwound independently. Don't hold the thread list mutex while doing so.
+  llvm::ThreadPool pool(llvm::optimal_concurrency(threads.size()));
+  for (const ThreadSP &thread_sp : threads)
+    pool.async([&thread_sp, num_frames]() {
+      if (num_frames == UINT32_MAX)
+        thread_sp->GetStackFrameCount();
+      else
+        thread_sp->GetStackFrameAtIndex(num_frames - 1);
+    });
+  pool.wait();
+}
+
 bool ThreadList::ShouldStop(Event *event_ptr) {
   // Running events should never stop, obviously...
 
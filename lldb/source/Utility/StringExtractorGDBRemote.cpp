@@ -414,6 +414,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
     return eServerPacketType_m;
 
   case 'M':
+    if (PACKET_STARTS_WITH("MultiMemRead:"))
+      return eServerPacketType_MultiMemRead;
     return eServerPacketType_M;
 
   case 'p':
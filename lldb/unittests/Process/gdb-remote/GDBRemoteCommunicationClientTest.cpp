@@ -14,6 +14,7 @@
 #include "lldb/Utility/StructuredData.h"
 #include "lldb/lldb-enumerations.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gmock/gmock.h"
 #include <future>
@@ -591,3 +592,43 @@ TEST_F(GDBRemoteCommunicationClientTest, WriteMemoryTags) {
                  std::vector<uint8_t>{0x99}, "QMemTags:456789,0:80000000:99",
                  "E03", false);
 }
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRanges) {
+  using MemoryRange = Range<lldb::addr_t, size_t>;
+  std::vector<MemoryRange> ranges = {MemoryRange(0x1000, 4),
+                                     MemoryRange(0x2000, 2),
+                                     MemoryRange(0x3000, 3)};
+
+  std::future<llvm::Expected<std::vector<DataBufferSP>>> result =
+      std::async(std::launch::async,
+                 [&] { return client.ReadMemoryRanges(ranges); });
+  // The second range can't be read and the third one only partially.
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,2,3000,3;",
+               "4,0,1;ABCDE");
+  llvm::Expected<std::vector<DataBufferSP>> buffers = result.get();
+  ASSERT_THAT_EXPECTED(buffers, llvm::Succeeded());
+  ASSERT_EQ(3u, buffers->size());
+  ASSERT_TRUE((*buffers)[0]);
+  EXPECT_EQ("ABCD", llvm::toStringRef((*buffers)[0]->GetData()));
+  EXPECT_FALSE((*buffers)[1]);
+  ASSERT_TRUE((*buffers)[2]);
+  EXPECT_EQ("E", llvm::toStringRef((*buffers)[2]->GetData()));
+
+  // Responses with more bytes than requested are rejected.
+  result = std::async(std::launch::async,
+                      [&] { return client.ReadMemoryRanges(ranges); });
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,2,3000,3;",
+               "4,0,4;ABCDEFGH");
+  EXPECT_THAT_EXPECTED(result.get(), llvm::Failed());
+
+  // So are responses with a different number of ranges.
+  result = std::async(std::launch::async,
+                      [&] { return client.ReadMemoryRanges(ranges); });
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,2,3000,3;", "4;ABCD");
+  EXPECT_THAT_EXPECTED(result.get(), llvm::Failed());
+
+  result = std::async(std::launch::async,
+                      [&] { return client.ReadMemoryRanges(ranges); });
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,2,3000,3;", "E01");
+  EXPECT_THAT_EXPECTED(result.get(), llvm::Failed());
+}
@@ -0,0 +1,84 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/Twine.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+/// Symbol-like keys: a shared prefix followed by a distinct number, so that
+/// every comparison has to look past the prefix.
+std::vector<std::string> makeKeys(unsigned NumKeys, StringRef Prefix) {
+  std::vector<std::string> Keys;
+  Keys.reserve(NumKeys);
+  for (unsigned I = 0; I != NumKeys; ++I)
+    Keys.push_back((Prefix + Twine(I)).str());
+  return Keys;
+}
+} // namespace
+
+static void BM_StringMapInsert(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0), "_ZN4llvm6symbol");
+  for (auto _ : State) {
+    StringMap<unsigned> Map;
+    for (const std::string &Key : Keys)
+      Map.try_emplace(Key, 0);
+    benchmark::DoNotOptimize(Map.size());
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_StringMapInsert)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_StringMapLookupHit(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0), "_ZN4llvm6symbol");
+  StringMap<unsigned> Map;
+  for (const std::string &Key : Keys)
+    Map.try_emplace(Key, 0);
+  for (auto _ : State)
+    for (const std::string &Key : Keys)
+      benchmark::DoNotOptimize(Map.find(Key));
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_StringMapLookupHit)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_StringMapLookupMiss(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0), "_ZN4llvm6symbol");
+  std::vector<std::string> Missing =
+      makeKeys(State.range(0), "_ZN4llvm6absent");
+  StringMap<unsigned> Map;
+  for (const std::string &Key : Keys)
+    Map.try_emplace(Key, 0);
+  for (auto _ : State)
+    for (const std::string &Key : Missing)
+      benchmark::DoNotOptimize(Map.find(Key));
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_StringMapLookupMiss)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_DenseMapLookupHit(benchmark::State &State) {
+  std::vector<int> Objects(State.range(0));
+  DenseMap<const int *, unsigned> Map;
+  for (const int &Object : Objects)
+    Map.try_emplace(&Object, 0);
+  for (auto _ : State)
+    for (const int &Object : Objects)
+      benchmark::DoNotOptimize(Map.find(&Object));
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_DenseMapLookupHit)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+static void BM_DenseMapLookupMiss(benchmark::State &State) {
+  std::vector<int> Objects(2 * State.range(0));
+  DenseMap<const int *, unsigned> Map;
+  for (unsigned I = 0, E = State.range(0); I != E; ++I)
+    Map.try_emplace(&Objects[2 * I], 0);
+  for (auto _ : State)
+    for (unsigned I = 0, E = State.range(0); I != E; ++I)
+      benchmark::DoNotOptimize(Map.find(&Objects[2 * I + 1]));
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_DenseMapLookupMiss)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,126 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/ExecutorProcessControl.h"
+#include "llvm/ExecutionEngine/Orc/TaskDispatch.h"
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+/// Defines one symbol after a given amount of work, standing in for the
+/// compilation of a function.
+class BusyMaterializationUnit : public MaterializationUnit {
+public:
+  BusyMaterializationUnit(SymbolStringPtr Name, JITTargetAddress Addr,
+                          unsigned Work)
+      : MaterializationUnit(
+            Interface(SymbolFlagsMap({{Name, JITSymbolFlags::Exported}}),
+                      nullptr)),
+        Name(std::move(Name)), Addr(Addr), Work(Work) {}
+
+  StringRef getName() const override { return "Busy"; }
+
+  void materialize(std::unique_ptr<MaterializationResponsibility> R) override {
+    uint64_t Acc = Addr;
+    for (unsigned I = 0; I != Work; ++I) {
+      Acc = Acc * 6364136223846793005ULL + 1442695040888963407ULL;
+      benchmark::DoNotOptimize(Acc);
+    }
+    cantFail(R->notifyResolved(
+        {{Name, JITEvaluatedSymbol(Addr, JITSymbolFlags::Exported)}}));
+    cantFail(R->notifyEmitted());
+  }
+
+private:
+  void discard(const JITDylib &JD, const SymbolStringPtr &Sym) override {}
+
+  SymbolStringPtr Name;
+  JITTargetAddress Addr;
+  unsigned Work;
+};
+
+/// A session with a thread pool dispatcher and one JITDylib that defines
+/// symbols sym0 to symN-1, each with its own materialization unit.
+struct LookupSession {
+  std::unique_ptr<ExecutionSession> ES;
+  JITDylib *JD;
+  std::vector<SymbolStringPtr> Names;
+
+  LookupSession(unsigned NumSymbols, unsigned Work) {
+    ES = std::make_unique<ExecutionSession>(
+        cantFail(SelfExecutorProcessControl::Create(
+            nullptr, std::make_unique<DynamicThreadPoolTaskDispatcher>())));
+    JD = &ES->createBareJITDylib("main");
+    for (unsigned I = 0; I != NumSymbols; ++I) {
+      Names.push_back(ES->intern(("sym" + Twine(I)).str()));
+      cantFail(JD->define(std::make_unique<BusyMaterializationUnit>(
+          Names.back(), I + 1, Work)));
+    }
+  }
+
+  ~LookupSession() { cantFail(ES->endSession()); }
+};
+} // namespace
+
+// One blocking lookup per symbol, as done by clients that look symbols up as
+// they need them.
+static void BM_OrcSequentialLookups(benchmark::State &State) {
+  std::unique_ptr<LookupSession> S;
+  for (auto _ : State) {
+    // Tear down the previous session and set up the next one untimed.
+    State.PauseTiming();
+    S.reset();
+    S = std::make_unique<LookupSession>(State.range(0), State.range(1));
+    State.ResumeTiming();
+    for (const SymbolStringPtr &Name : S->Names)
+      benchmark::DoNotOptimize(
+          cantFail(S->ES->lookup(makeJITDylibSearchOrder(S->JD), Name)));
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_OrcSequentialLookups)
+    ->ArgsProduct({{16, 1024, 16384}, {0, 10000}})
+    ->UseRealTime();
+
+// One request per symbol, issued together with bulkLookup.
+static void BM_OrcBulkLookup(benchmark::State &State) {
+  std::unique_ptr<LookupSession> S;
+  for (auto _ : State) {
+    State.PauseTiming();
+    S.reset();
+    S = std::make_unique<LookupSession>(State.range(0), State.range(1));
+    std::vector<ExecutionSession::LookupRequest> Requests;
+    for (const SymbolStringPtr &Name : S->Names)
+      Requests.push_back(
+          {makeJITDylibSearchOrder(S->JD), SymbolLookupSet(Name)});
+    State.ResumeTiming();
+    benchmark::DoNotOptimize(cantFail(S->ES->bulkLookup(Requests)));
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_OrcBulkLookup)
+    ->ArgsProduct({{16, 1024, 16384}, {0, 10000}})
+    ->UseRealTime();
+
+// All the symbols in a single lookup set.
+static void BM_OrcSetLookup(benchmark::State &State) {
+  std::unique_ptr<LookupSession> S;
+  for (auto _ : State) {
+    State.PauseTiming();
+    S.reset();
+    S = std::make_unique<LookupSession>(State.range(0), State.range(1));
+    SymbolLookupSet Symbols(S->Names);
+    State.ResumeTiming();
+    benchmark::DoNotOptimize(
+        cantFail(S->ES->lookup(makeJITDylibSearchOrder(S->JD), Symbols)));
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_OrcSetLookup)
+    ->ArgsProduct({{16, 1024, 16384}, {0, 10000}})
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,72 @@
+#include "benchmark/benchmark.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+
+using namespace llvm;
+
+namespace {
+/// A function computing a chain of additions, each of which uses the first
+/// argument and the previous addition. The second argument is unused.
+struct AddChain {
+  LLVMContext Ctx;
+  Module M{"bench", Ctx};
+  Function *F;
+  Argument *A;
+  Argument *Unused;
+
+  explicit AddChain(unsigned NumInsts) {
+    Type *I64 = Type::getInt64Ty(Ctx);
+    F = Function::Create(FunctionType::get(I64, {I64, I64}, false),
+                         GlobalValue::ExternalLinkage, "f", M);
+    A = F->getArg(0);
+    Unused = F->getArg(1);
+    IRBuilder<> Builder(BasicBlock::Create(Ctx, "entry", F));
+    Value *Acc = A;
+    for (unsigned I = 0; I != NumInsts; ++I)
+      Acc = Builder.CreateAdd(A, Acc);
+    Builder.CreateRet(Acc);
+  }
+};
+} // namespace
+
+static void BM_UseListRAUW(benchmark::State &State) {
+  AddChain Chain(State.range(0));
+  for (auto _ : State) {
+    Chain.A->replaceAllUsesWith(Chain.Unused);
+    Chain.Unused->replaceAllUsesWith(Chain.A);
+  }
+  State.SetItemsProcessed(State.iterations() * 2 * State.range(0));
+}
+BENCHMARK(BM_UseListRAUW)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+static void BM_UseListIteration(benchmark::State &State) {
+  AddChain Chain(State.range(0));
+  for (auto _ : State) {
+    unsigned NumAdds = 0;
+    for (const Use &U : Chain.A->uses())
+      NumAdds += isa<BinaryOperator>(U.getUser());
+    benchmark::DoNotOptimize(NumAdds);
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_UseListIteration)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+static void BM_UseListBuildFunction(benchmark::State &State) {
+  for (auto _ : State) {
+    AddChain Chain(State.range(0));
+    benchmark::DoNotOptimize(Chain.F);
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+
+  // Report the memory taken by an addition, split into the instruction
+  // itself and its operands.
+  State.counters["InstBytes"] = sizeof(BinaryOperator);
+  State.counters["UseBytes"] = 2 * sizeof(Use);
+}
+BENCHMARK(BM_UseListBuildFunction)->RangeMultiplier(8)->Range(64, 1 << 15);
+
+BENCHMARK_MAIN();
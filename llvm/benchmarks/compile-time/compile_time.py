@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+#
+#===- compile_time.py - Measure the compile time of opt, llc and llvm-mc -===#
+#
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+#===------------------------------------------------------------------------===#
+
+"""
+Run opt and llc pipelines over a corpus of IR files, and llvm-mc over a corpus
+of assembly files, and report how long each pipeline and each pass took.
+Example usage:
+
+  compile_time.py --bindir build/bin --output new.json inputs/
+  compile_time.py --bindir build/bin --baseline old.json inputs/ my-corpus/
+
+Each pipeline is run --repeat times on every input and the fastest run is
+kept. Per pass times come from the -time-trace output of opt and llc. With
+--perf, the instructions retired by each run are counted with `perf stat`; they
+are much more stable than times and are preferred when comparing to a baseline.
+
+With --baseline, the totals are compared against a JSON file written by an
+earlier --output, and the script exits with an error if any of them regressed
+by more than --threshold percent.
+"""
+from __future__ import absolute_import, division, print_function
+
+import argparse
+import json
+import os
+import resource
+import subprocess
+import sys
+import tempfile
+
+PIPELINES = {
+    'opt-O3': ['opt', '-O3', '-disable-output'],
+    'llc-O2': ['llc', '-O2', '-filetype=obj', '-o', os.devnull],
+    'llc-O0': ['llc', '-O0', '-filetype=obj', '-o', os.devnull],
+    # Aligning branches to 32 byte boundaries creates a boundary align fragment
+    # for every branch, which stresses relaxation.
+    'mc-x86-align-branch': ['llvm-mc', '-triple=x86_64-unknown-linux-gnu',
+                            '-filetype=obj', '-x86-align-branch-boundary=32',
+                            '-x86-align-branch=fused+jcc+jmp', '-o',
+                            os.devnull],
+}
+
+# The inputs each tool runs on.
+INPUT_SUFFIXES = {
+    'opt': ('.ll', '.bc'),
+    'llc': ('.ll', '.bc'),
+    'llvm-mc': ('.s',),
+}
+
+# The tools that support -time-trace.
+TIME_TRACE_TOOLS = {'opt', 'llc'}
+
+FORMAT_VERSION = 1
+
+
+def find_inputs(paths):
+  for path in paths:
+    if not os.path.isdir(path):
+      yield path
+      continue
+    for root, _, files in os.walk(path):
+      for name in sorted(files):
+        if name.endswith(('.ll', '.bc', '.s')):
+          yield os.path.join(root, name)
+
+
+def read_pass_times(trace_path):
+  """Return the total microseconds spent in each pass of a time trace."""
+  with open(trace_path) as f:
+    trace = json.load(f)
+  times = {}
+  for event in trace.get('traceEvents', []):
+    name = event.get('name', '')
+    if event.get('ph') != 'X':
+      continue
+    if name == 'RunPass':
+      # The legacy pass manager, as used by llc, names the pass in the detail.
+      detail = event.get('args', {}).get('detail', '')
+      times[detail] = times.get(detail, 0) + event.get('dur', 0)
+    elif name.startswith('Total ') and name != 'Total RunPass':
+      # The new pass manager names events after the pass; use their totals.
+      times[name[len('Total '):]] = event.get('dur', 0)
+  return times
+
+
+def parse_perf_instructions(output):
+  # perf stat -x, prints "<count>,<unit>,<event>,...".
+  for line in output.splitlines():
+    fields = line.split(',')
+    if len(fields) > 2 and fields[2].startswith('instructions'):
+      try:
+        return int(fields[0])
+      except ValueError:
+        return None
+  return None
+
+
+def run_once(args, command, input_path, time_trace):
+  fd, trace_path = tempfile.mkstemp(suffix='.json')
+  os.close(fd)
+  try:
+    command = command + [input_path]
+    if time_trace:
+      command += ['-time-trace', '-time-trace-granularity=0',
+                  '-time-trace-file=' + trace_path]
+    if args.perf:
+      command = ['perf', 'stat', '-x,', '-e', 'instructions:u', '--'] + command
+    before = resource.getrusage(resource.RUSAGE_CHILDREN)
+    result = subprocess.run(command, stdout=subprocess.DEVNULL,
+                            stderr=subprocess.PIPE, universal_newlines=True)
+    after = resource.getrusage(resource.RUSAGE_CHILDREN)
+    if result.returncode != 0:
+      sys.exit('error: %s failed:\n%s' % (' '.join(command), result.stderr))
+    run = {
+        'user': after.ru_utime - before.ru_utime,
+        'passes': read_pass_times(trace_path) if time_trace else {},
+    }
+    if args.perf:
+      instructions = parse_perf_instructions(result.stderr)
+      if instructions is None:
+        sys.exit('error: could not read instruction count from perf:\n%s' %
+                 result.stderr)
+      run['instructions'] = instructions
+    return run
+  finally:
+    os.remove(trace_path)
+
+
+def measure(args, pipeline, input_path):
+  tool, options = PIPELINES[pipeline][0], PIPELINES[pipeline][1:]
+  command = [os.path.join(args.bindir, tool)] + options
+  best = None
+  for _ in range(args.repeat):
+    run = run_once(args, command, input_path, tool in TIME_TRACE_TOOLS)
+    if best is None:
+      best = run
+      continue
+    for metric in ('user', 'instructions'):
+      if metric in run:
+        best[metric] = min(best[metric], run[metric])
+    for name, dur in run['passes'].items():
+      best['passes'][name] = min(best['passes'].get(name, dur), dur)
+  return best
+
+
+def format_value(value):
+  return '%.4f' % value if isinstance(value, float) else str(value)
+
+
+def metric_of(results):
+  for result in results.values():
+    return 'instructions' if 'instructions' in result else 'user'
+  return 'user'
+
+
+def compare(results, baseline, threshold):
+  """Print the change of every total and return the regressed ones."""
+  metric = metric_of(results)
+  if any(metric not in r for r in baseline.values()):
+    metric = 'user'
+  regressions = []
+  print('%-50s %14s %14s %8s' % ('input / pipeline', 'baseline', 'current',
+                                  'change'))
+  for key in sorted(results):
+    if key not in baseline:
+      continue
+    old, new = baseline[key][metric], results[key][metric]
+    change = (new - old) * 100.0 / old if old else 0.0
+    print('%-50s %14s %14s %+7.2f%%' % (key, format_value(old),
+                                       format_value(new), change))
+    if change > threshold:
+      regressions.append(key)
+      # Show the passes that account for most of the regression.
+      deltas = []
+      old_passes = baseline[key].get('passes', {})
+      for name, dur in results[key]['passes'].items():
+        deltas.append((dur - old_passes.get(name, 0), name))
+      for delta, name in sorted(deltas, reverse=True)[:5]:
+        if delta > 0:
+          print('    %+10d us  %s' % (delta, name))
+  return regressions
+
+
+def main():
+  parser = argparse.ArgumentParser(
+      description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('inputs', nargs='+', metavar='PATH',
+                      help='IR or assembly file, or directory to search for '
+                      '.ll, .bc and .s files')
+  parser.add_argument('--bindir', required=True,
+                      help='directory containing opt, llc and llvm-mc')
+  parser.add_argument('--pipelines', default=','.join(sorted(PIPELINES)),
+                      help='comma separated pipelines to run, out of %s '
+                      '(default: all)' % ', '.join(sorted(PIPELINES)))
+  parser.add_argument('--repeat', type=int, default=3,
+                      help='number of runs of each pipeline, the fastest of '
+                      'which is kept (default: %(default)s)')
+  parser.add_argument('--perf', action='store_true',
+                      help='count instructions retired with perf stat')
+  parser.add_argument('--output', help='write the results to this JSON file')
+  parser.add_argument('--baseline',
+                      help='compare against the results in this JSON file')
+  parser.add_argument('--threshold', type=float, default=3.0,
+                      help='regression threshold in percent when comparing '
+                      'against a baseline (default: %(default)s)')
+  args = parser.parse_args()
+
+  pipelines = args.pipelines.split(',')
+  for pipeline in pipelines:
+    if pipeline not in PIPELINES:
+      parser.error('unknown pipeline %s' % pipeline)
+
+  results = {}
+  for input_path in find_inputs(args.inputs):
+    for pipeline in pipelines:
+      if not input_path.endswith(INPUT_SUFFIXES[PIPELINES[pipeline][0]]):
+        continue
+      key = '%s:%s' % (os.path.basename(input_path), pipeline)
+      results[key] = measure(args, pipeline, input_path)
+
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump({'version': FORMAT_VERSION, 'results': results}, f, indent=2,
+                sort_keys=True)
+
+  if not args.baseline:
+    metric = metric_of(results)
+    for key in sorted(results):
+      print('%-50s %14s' % (key, format_value(results[key][metric])))
+    return
+
+  with open(args.baseline) as f:
+    baseline = json.load(f)
+  if baseline.get('version') != FORMAT_VERSION:
+    sys.exit('error: %s has an unsupported format version' % args.baseline)
+  regressions = compare(results, baseline['results'], args.threshold)
+  if regressions:
+    sys.exit('error: %d compile time regressions over %.1f%%' %
+             (len(regressions), args.threshold))
+
+
+if __name__ == '__main__':
+  main()
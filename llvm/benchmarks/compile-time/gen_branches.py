@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+#
+#===- gen_branches.py - Generate an x86 assembly file full of branches ---===#
+#
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+#===------------------------------------------------------------------------===#
+
+"""
+Write an x86-64 assembly file with a large number of short and long, forward
+and backward branches, and a jump table, for measuring the relaxation of
+llvm-mc. Example usage:
+
+  gen_branches.py --branches 200000 -o branches.s
+"""
+from __future__ import absolute_import, division, print_function
+
+import argparse
+import random
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument('--branches', type=int, default=200000,
+                      help='number of branches (default: %(default)s)')
+  parser.add_argument('--seed', type=int, default=0,
+                      help='random seed (default: %(default)s)')
+  parser.add_argument('-o', dest='output', required=True,
+                      help='output file')
+  args = parser.parse_args()
+
+  rng = random.Random(args.seed)
+  with open(args.output, 'w') as f:
+    f.write('\t.text\n\t.globl\tbranches\n\t.p2align\t4\nbranches:\n')
+    for i in range(args.branches):
+      f.write('.Lb%d:\n' % i)
+      # Padding between the branches, so that some of them are just within
+      # and some just out of the range of a short jump.
+      for _ in range(rng.randrange(4)):
+        f.write('\taddq\t$%d, %%rax\n' % rng.randrange(1 << 20))
+      f.write('\tcmpq\t%rdi, %rax\n')
+      # Mostly short forward branches, with a few long and backward ones.
+      r = rng.random()
+      if r < 0.8:
+        target = min(i + rng.randrange(1, 16), args.branches)
+      elif r < 0.9:
+        target = min(i + rng.randrange(16, 4096), args.branches)
+      else:
+        target = max(i - rng.randrange(1, 64), 0)
+      f.write('\t%s\t.Lb%d\n' % (rng.choice(['jne', 'jl', 'jmp']), target))
+    f.write('.Lb%d:\n\tretq\n' % args.branches)
+
+    f.write('\t.section\t.rodata\n\t.p2align\t3\n.Ltable:\n')
+    for i in range(0, args.branches, 64):
+      f.write('\t.quad\t.Lb%d\n' % i)
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+#
+#===- gen_straight_line.py - Generate a long straight-line IR function ----===#
+#
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+#===------------------------------------------------------------------------===#
+
+"""
+Write an IR file with a single function made of many fully unrolled rounds of
+a ChaCha-like quarter round on 16 lanes of 32-bit state, which is the kind of
+long straight-line code that stresses the SLP vectorizer. Every round stores
+its state, so there are many chains of consecutive stores to start trees from.
+Example usage:
+
+  gen_straight_line.py --rounds 1000 -o straight_line.ll
+"""
+from __future__ import absolute_import, division, print_function
+
+import argparse
+
+# The quarter round as (destination, source, rotate) on the four rows of four
+# lanes: row[dest] += row[src] for additions, and row[dest] = rotl(row[dest] ^
+# row[src], rotate) for the others.
+STEPS = [
+    ('add', 0, 1, None), ('xor', 3, 0, 16),
+    ('add', 2, 3, None), ('xor', 1, 2, 12),
+    ('add', 0, 1, None), ('xor', 3, 0, 8),
+    ('add', 2, 3, None), ('xor', 1, 2, 7),
+]
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument('--rounds', type=int, default=1000,
+                      help='number of rounds (default: %(default)s)')
+  parser.add_argument('-o', dest='output', required=True,
+                      help='output file')
+  args = parser.parse_args()
+
+  with open(args.output, 'w') as f:
+    f.write('; Generated by gen_straight_line.py --rounds %d.\n\n' %
+            args.rounds)
+    f.write('target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-'
+            'i64:64-f80:128-n8:16:32:64-S128"\n')
+    f.write('target triple = "x86_64-unknown-linux-gnu"\n\n')
+    f.write('declare i32 @llvm.fshl.i32(i32, i32, i32)\n\n')
+    f.write('define void @rounds(ptr noalias %out, ptr noalias %in) {\n')
+    f.write('entry:\n')
+
+    # The current SSA value of each lane.
+    lanes = []
+    for i in range(16):
+      f.write('  %%in.%d = getelementptr inbounds i32, ptr %%in, i64 %d\n' %
+              (i, i))
+      f.write('  %%s.%d = load i32, ptr %%in.%d, align 4\n' % (i, i))
+      lanes.append('%%s.%d' % i)
+
+    for r in range(args.rounds):
+      for s, (op, dest, src, rotate) in enumerate(STEPS):
+        for col in range(4):
+          d, v = dest * 4 + col, src * 4 + col
+          name = '%%r%d.%d.%d' % (r, s, d)
+          if op == 'add':
+            f.write('  %s = add i32 %s, %s\n' % (name, lanes[d], lanes[v]))
+          else:
+            f.write('  %s.x = xor i32 %s, %s\n' % (name, lanes[d], lanes[v]))
+            f.write('  %s = call i32 @llvm.fshl.i32(i32 %s.x, i32 %s.x, '
+                    'i32 %d)\n' % (name, name, name, rotate))
+          lanes[d] = name
+      for i in range(16):
+        f.write('  %%out.%d.%d = getelementptr inbounds i32, ptr %%out, '
+                'i64 %d\n' % (r, i, r * 16 + i))
+        f.write('  store i32 %s, ptr %%out.%d.%d, align 4\n' %
+                (lanes[i], r, i))
+
+    f.write('  ret void\n}\n')
+
+
+if __name__ == '__main__':
+  main()
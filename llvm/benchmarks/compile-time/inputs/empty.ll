@@ -0,0 +1,12 @@
+; A module with a single trivial function. Compiling it is dominated by the
+; startup of the tools: static constructors, option parsing, target and pass
+; registration, and creating the TargetMachine and the pass pipelines, which
+; is what short compiles pay for every time.
+
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @empty() {
+entry:
+  ret void
+}
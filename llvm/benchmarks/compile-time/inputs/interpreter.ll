@@ -0,0 +1,237 @@
+; A bytecode interpreter: a dispatch loop over a large switch calling small
+; helper functions, exercising the inliner, SimplifyCFG, jump threading, GVN
+; and instruction selection of branchy scalar code.
+
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+%struct.vm = type { ptr, i64, [16 x i64], i64, i32 }
+
+declare void @trap(ptr, i32)
+
+define internal i64 @reg_get(ptr %vm, i32 %r) {
+entry:
+  %r.masked = and i32 %r, 15
+  %idx = zext i32 %r.masked to i64
+  %p = getelementptr inbounds %struct.vm, ptr %vm, i64 0, i32 2, i64 %idx
+  %v = load i64, ptr %p
+  ret i64 %v
+}
+
+define internal void @reg_set(ptr %vm, i32 %r, i64 %v) {
+entry:
+  %r.masked = and i32 %r, 15
+  %idx = zext i32 %r.masked to i64
+  %p = getelementptr inbounds %struct.vm, ptr %vm, i64 0, i32 2, i64 %idx
+  store i64 %v, ptr %p
+  ret void
+}
+
+define internal i32 @fetch(ptr %vm) {
+entry:
+  %code.p = getelementptr inbounds %struct.vm, ptr %vm, i64 0, i32 0
+  %code = load ptr, ptr %code.p
+  %pc.p = getelementptr inbounds %struct.vm, ptr %vm, i64 0, i32 1
+  %pc = load i64, ptr %pc.p
+  %insn.p = getelementptr inbounds i32, ptr %code, i64 %pc
+  %insn = load i32, ptr %insn.p
+  %pc.next = add i64 %pc, 1
+  store i64 %pc.next, ptr %pc.p
+  ret i32 %insn
+}
+
+define internal void @jump(ptr %vm, i64 %offset) {
+entry:
+  %pc.p = getelementptr inbounds %struct.vm, ptr %vm, i64 0, i32 1
+  %pc = load i64, ptr %pc.p
+  %pc.next = add i64 %pc, %offset
+  store i64 %pc.next, ptr %pc.p
+  ret void
+}
+
+define internal void @fail(ptr %vm, i32 %code) {
+entry:
+  %status.p = getelementptr inbounds %struct.vm, ptr %vm, i64 0, i32 4
+  store i32 %code, ptr %status.p
+  call void @trap(ptr %vm, i32 %code)
+  ret void
+}
+
+define internal i64 @checked_div(ptr %vm, i64 %a, i64 %b) {
+entry:
+  %zero = icmp eq i64 %b, 0
+  br i1 %zero, label %error, label %check.overflow
+
+check.overflow:
+  %min = icmp eq i64 %a, -9223372036854775808
+  %neg1 = icmp eq i64 %b, -1
+  %overflow = and i1 %min, %neg1
+  br i1 %overflow, label %error, label %divide
+
+divide:
+  %q = sdiv i64 %a, %b
+  ret i64 %q
+
+error:
+  call void @fail(ptr %vm, i32 2)
+  ret i64 0
+}
+
+; Instructions are encoded as opcode:8 dst:4 src1:4 src2:4 imm:12.
+define i64 @run(ptr %vm) {
+entry:
+  %steps.p = getelementptr inbounds %struct.vm, ptr %vm, i64 0, i32 3
+  %status.p = getelementptr inbounds %struct.vm, ptr %vm, i64 0, i32 4
+  br label %dispatch
+
+dispatch:
+  %status = load i32, ptr %status.p
+  %stopped = icmp ne i32 %status, 0
+  br i1 %stopped, label %exit, label %decode
+
+decode:
+  %steps = load i64, ptr %steps.p
+  %steps.next = add i64 %steps, 1
+  store i64 %steps.next, ptr %steps.p
+  %insn = call i32 @fetch(ptr %vm)
+  %op = lshr i32 %insn, 24
+  %dst.s = lshr i32 %insn, 20
+  %src1.s = lshr i32 %insn, 16
+  %src2.s = lshr i32 %insn, 12
+  %imm.u = and i32 %insn, 4095
+  %imm.sh = shl i32 %imm.u, 20
+  %imm.s = ashr i32 %imm.sh, 20
+  %imm = sext i32 %imm.s to i64
+  %a = call i64 @reg_get(ptr %vm, i32 %src1.s)
+  %b = call i64 @reg_get(ptr %vm, i32 %src2.s)
+  switch i32 %op, label %bad [
+    i32 0, label %op.halt
+    i32 1, label %op.add
+    i32 2, label %op.sub
+    i32 3, label %op.mul
+    i32 4, label %op.div
+    i32 5, label %op.and
+    i32 6, label %op.or
+    i32 7, label %op.xor
+    i32 8, label %op.shl
+    i32 9, label %op.shr
+    i32 10, label %op.li
+    i32 11, label %op.addi
+    i32 12, label %op.beq
+    i32 13, label %op.bne
+    i32 14, label %op.blt
+    i32 15, label %op.jmp
+    i32 16, label %op.min
+    i32 17, label %op.max
+    i32 18, label %op.abs
+    i32 19, label %op.popcnt
+  ]
+
+op.halt:
+  store i32 1, ptr %status.p
+  br label %dispatch
+
+op.add:
+  %add = add i64 %a, %b
+  br label %writeback
+
+op.sub:
+  %sub = sub i64 %a, %b
+  br label %writeback
+
+op.mul:
+  %mul = mul i64 %a, %b
+  br label %writeback
+
+op.div:
+  %div = call i64 @checked_div(ptr %vm, i64 %a, i64 %b)
+  br label %writeback
+
+op.and:
+  %and = and i64 %a, %b
+  br label %writeback
+
+op.or:
+  %or = or i64 %a, %b
+  br label %writeback
+
+op.xor:
+  %xor = xor i64 %a, %b
+  br label %writeback
+
+op.shl:
+  %shamt.l = and i64 %b, 63
+  %shl = shl i64 %a, %shamt.l
+  br label %writeback
+
+op.shr:
+  %shamt.r = and i64 %b, 63
+  %shr = ashr i64 %a, %shamt.r
+  br label %writeback
+
+op.li:
+  br label %writeback
+
+op.addi:
+  %addi = add i64 %a, %imm
+  br label %writeback
+
+op.beq:
+  %eq = icmp eq i64 %a, %b
+  br i1 %eq, label %take, label %dispatch
+
+op.bne:
+  %ne = icmp ne i64 %a, %b
+  br i1 %ne, label %take, label %dispatch
+
+op.blt:
+  %lt = icmp slt i64 %a, %b
+  br i1 %lt, label %take, label %dispatch
+
+op.jmp:
+  br label %take
+
+take:
+  call void @jump(ptr %vm, i64 %imm)
+  br label %dispatch
+
+op.min:
+  %min.c = icmp slt i64 %a, %b
+  %min = select i1 %min.c, i64 %a, i64 %b
+  br label %writeback
+
+op.max:
+  %max.c = icmp sgt i64 %a, %b
+  %max = select i1 %max.c, i64 %a, i64 %b
+  br label %writeback
+
+op.abs:
+  %neg = sub i64 0, %a
+  %isneg = icmp slt i64 %a, 0
+  %abs = select i1 %isneg, i64 %neg, i64 %a
+  br label %writeback
+
+op.popcnt:
+  %popcnt = call i64 @llvm.ctpop.i64(i64 %a)
+  br label %writeback
+
+writeback:
+  %result = phi i64 [ %add, %op.add ], [ %sub, %op.sub ], [ %mul, %op.mul ],
+                    [ %div, %op.div ], [ %and, %op.and ], [ %or, %op.or ],
+                    [ %xor, %op.xor ], [ %shl, %op.shl ], [ %shr, %op.shr ],
+                    [ %imm, %op.li ], [ %addi, %op.addi ], [ %min, %op.min ],
+                    [ %max, %op.max ], [ %abs, %op.abs ],
+                    [ %popcnt, %op.popcnt ]
+  call void @reg_set(ptr %vm, i32 %dst.s, i64 %result)
+  br label %dispatch
+
+bad:
+  call void @fail(ptr %vm, i32 3)
+  br label %dispatch
+
+exit:
+  %r0 = call i64 @reg_get(ptr %vm, i32 0)
+  ret i64 %r0
+}
+
+declare i64 @llvm.ctpop.i64(i64)
@@ -0,0 +1,174 @@
+; Numeric kernels with nested loops, exercising the loop optimizer, the
+; vectorizers and instruction selection of vector code.
+
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; C[i][j] += A[i][k] * B[k][j] for N x N row-major matrices.
+define void @matmul(ptr noalias %C, ptr noalias %A, ptr noalias %B, i64 %N) {
+entry:
+  %empty = icmp eq i64 %N, 0
+  br i1 %empty, label %exit, label %loop.i
+
+loop.i:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch.i ]
+  br label %loop.j
+
+loop.j:
+  %j = phi i64 [ 0, %loop.i ], [ %j.next, %latch.j ]
+  %row.i = mul i64 %i, %N
+  %c.idx = add i64 %row.i, %j
+  %c.ptr = getelementptr inbounds double, ptr %C, i64 %c.idx
+  %c.init = load double, ptr %c.ptr
+  br label %loop.k
+
+loop.k:
+  %k = phi i64 [ 0, %loop.j ], [ %k.next, %loop.k ]
+  %acc = phi double [ %c.init, %loop.j ], [ %acc.next, %loop.k ]
+  %a.idx = add i64 %row.i, %k
+  %a.ptr = getelementptr inbounds double, ptr %A, i64 %a.idx
+  %a = load double, ptr %a.ptr
+  %row.k = mul i64 %k, %N
+  %b.idx = add i64 %row.k, %j
+  %b.ptr = getelementptr inbounds double, ptr %B, i64 %b.idx
+  %b = load double, ptr %b.ptr
+  %mul = fmul fast double %a, %b
+  %acc.next = fadd fast double %acc, %mul
+  %k.next = add nuw i64 %k, 1
+  %k.done = icmp eq i64 %k.next, %N
+  br i1 %k.done, label %latch.j, label %loop.k
+
+latch.j:
+  store double %acc.next, ptr %c.ptr
+  %j.next = add nuw i64 %j, 1
+  %j.done = icmp eq i64 %j.next, %N
+  br i1 %j.done, label %latch.i, label %loop.j
+
+latch.i:
+  %i.next = add nuw i64 %i, 1
+  %i.done = icmp eq i64 %i.next, %N
+  br i1 %i.done, label %exit, label %loop.i
+
+exit:
+  ret void
+}
+
+; Y[i] = a * X[i] + Y[i]
+define void @saxpy(ptr %Y, ptr %X, float %a, i32 %n) {
+entry:
+  %empty = icmp slt i32 %n, 1
+  br i1 %empty, label %exit, label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %idx = sext i32 %i to i64
+  %x.ptr = getelementptr inbounds float, ptr %X, i64 %idx
+  %x = load float, ptr %x.ptr
+  %y.ptr = getelementptr inbounds float, ptr %Y, i64 %idx
+  %y = load float, ptr %y.ptr
+  %ax = fmul float %a, %x
+  %sum = fadd float %ax, %y
+  store float %sum, ptr %y.ptr
+  %i.next = add nsw i32 %i, 1
+  %done = icmp eq i32 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+; Sum of the elements of V that are greater than Threshold.
+define i64 @conditional_sum(ptr %V, i64 %n, i32 %Threshold) {
+entry:
+  %empty = icmp eq i64 %n, 0
+  br i1 %empty, label %exit, label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop.latch ]
+  %sum = phi i64 [ 0, %entry ], [ %sum.next, %loop.latch ]
+  %v.ptr = getelementptr inbounds i32, ptr %V, i64 %i
+  %v = load i32, ptr %v.ptr
+  %big = icmp sgt i32 %v, %Threshold
+  br i1 %big, label %add, label %loop.latch
+
+add:
+  %v.ext = sext i32 %v to i64
+  %sum.add = add i64 %sum, %v.ext
+  br label %loop.latch
+
+loop.latch:
+  %sum.next = phi i64 [ %sum, %loop ], [ %sum.add, %add ]
+  %i.next = add nuw i64 %i, 1
+  %done = icmp eq i64 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %result = phi i64 [ 0, %entry ], [ %sum.next, %loop.latch ]
+  ret i64 %result
+}
+
+; In-place prefix sum, a loop-carried dependence that cannot be vectorized.
+define void @prefix_sum(ptr %V, i64 %n) {
+entry:
+  %small = icmp ult i64 %n, 2
+  br i1 %small, label %exit, label %loop
+
+loop:
+  %i = phi i64 [ 1, %entry ], [ %i.next, %loop ]
+  %prev.idx = add nsw i64 %i, -1
+  %prev.ptr = getelementptr inbounds i64, ptr %V, i64 %prev.idx
+  %prev = load i64, ptr %prev.ptr
+  %cur.ptr = getelementptr inbounds i64, ptr %V, i64 %i
+  %cur = load i64, ptr %cur.ptr
+  %sum = add i64 %prev, %cur
+  store i64 %sum, ptr %cur.ptr
+  %i.next = add nuw i64 %i, 1
+  %done = icmp eq i64 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
+
+; A 3-point stencil over a 2D grid, with the bounds of the inner loop
+; depending on the outer one.
+define void @stencil(ptr noalias %Out, ptr noalias %In, i32 %rows, i32 %cols) {
+entry:
+  %r.end = add nsw i32 %rows, -1
+  %c.end = add nsw i32 %cols, -1
+  %no.rows = icmp slt i32 %r.end, 2
+  br i1 %no.rows, label %exit, label %loop.r
+
+loop.r:
+  %r = phi i32 [ 1, %entry ], [ %r.next, %latch.r ]
+  %no.cols = icmp slt i32 %c.end, 2
+  br i1 %no.cols, label %latch.r, label %loop.c
+
+loop.c:
+  %c = phi i32 [ 1, %loop.r ], [ %c.next, %loop.c ]
+  %row = mul nsw i32 %r, %cols
+  %idx = add nsw i32 %row, %c
+  %idx.ext = sext i32 %idx to i64
+  %mid.ptr = getelementptr inbounds float, ptr %In, i64 %idx.ext
+  %left.ptr = getelementptr inbounds float, ptr %mid.ptr, i64 -1
+  %right.ptr = getelementptr inbounds float, ptr %mid.ptr, i64 1
+  %left = load float, ptr %left.ptr
+  %mid = load float, ptr %mid.ptr
+  %right = load float, ptr %right.ptr
+  %lm = fadd float %left, %mid
+  %lmr = fadd float %lm, %right
+  %avg = fmul float %lmr, 0x3FD5555560000000
+  %out.ptr = getelementptr inbounds float, ptr %Out, i64 %idx.ext
+  store float %avg, ptr %out.ptr
+  %c.next = add nsw i32 %c, 1
+  %c.done = icmp eq i32 %c.next, %c.end
+  br i1 %c.done, label %latch.r, label %loop.c
+
+latch.r:
+  %r.next = add nsw i32 %r, 1
+  %r.done = icmp eq i32 %r.next, %r.end
+  br i1 %r.done, label %exit, label %loop.r
+
+exit:
+  ret void
+}
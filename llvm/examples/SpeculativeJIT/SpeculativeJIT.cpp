@@ -13,6 +13,7 @@
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
@@ -35,6 +36,11 @@ static cl::opt<unsigned> NumThreads("num-threads", cl::Optional,
                                     cl::desc("Number of compile threads"),
                                     cl::init(4));
 
+static cl::opt<std::string> SpeculationProfile(
+    "speculation-profile", cl::Optional,
+    cl::desc("Speculate from the call sequence recorded in the given file, "
+             "if it exists, and record the call sequence of this run to it"));
+
 ExitOnError ExitOnErr;
 
 // Add Layers
@@ -81,6 +87,8 @@ public:
 
   ExecutionSession &getES() { return *ES; }
 
+  Speculator &getSpeculator() { return S; }
+
   Error addModule(ThreadSafeModule TSM) {
     return CODLayer.add(MainJD, std::move(TSM));
   }
@@ -111,7 +119,7 @@ private:
         CompileLayer(*this->ES, ObjLayer,
                      std::make_unique<ConcurrentIRCompiler>(std::move(JTMB))),
         S(Imps, *this->ES),
-        SpeculateLayer(*this->ES, CompileLayer, S, Mangle, BlockFreqQuery()),
+        SpeculateLayer(*this->ES, CompileLayer, S, Mangle, getQuery()),
         CODLayer(*this->ES, SpeculateLayer, *this->LCTMgr,
                  std::move(ISMBuilder)) {
     MainJD.addGenerator(std::move(ProcessSymbolsGenerator));
@@ -129,6 +137,13 @@ private:
     ExitOnErr(CXXRuntimeoverrides.enable(MainJD, Mangle));
   }
 
+  static IRSpeculationLayer::ResultEval getQuery() {
+    // Profiles need every function to be instrumented.
+    if (!SpeculationProfile.empty())
+      return CallSequenceQuery();
+    return BlockFreqQuery();
+  }
+
   static std::unique_ptr<SectionMemoryManager> createMemMgr() {
     return std::make_unique<SectionMemoryManager>();
   }
@@ -169,6 +184,10 @@ int main(int argc, char *argv[]) {
   // Create a JIT instance.
   auto SJ = ExitOnErr(SpeculativeJIT::Create());
 
+  if (!SpeculationProfile.empty() && sys::fs::exists(SpeculationProfile))
+    SJ->getSpeculator().addProfileCandidates(ExitOnErr(
+        readSpeculationProfile(SpeculationProfile, SJ->getES())));
+
   // Load the IR inputs.
   for (const auto &InputFile : InputFiles) {
     SMDiagnostic Err;
@@ -186,7 +205,11 @@ int main(int argc, char *argv[]) {
   auto Main =
       jitTargetAddressToFunction<int (*)(int, char *[])>(MainSym.getAddress());
 
-  return runAsMain(Main, InputArgv, StringRef(InputFiles.front()));
+  int Result = runAsMain(Main, InputArgv, StringRef(InputFiles.front()));
+
+  if (!SpeculationProfile.empty())
+    ExitOnErr(writeSpeculationProfile(
+        SpeculationProfile, SJ->getSpeculator().getCallSequence()));
 
-  return 0;
+  return Result;
 }
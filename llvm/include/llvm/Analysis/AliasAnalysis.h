@@ -454,6 +454,9 @@ template <> struct DenseMapInfo<AACacheLoc> {
 /// where safe (due to the IR not changing), use a `BatchAAResults` wrapper.
 /// The information stored in an `AAQueryInfo` is currently limitted to the
 /// caches used by BasicAA, but can further be extended to fit other AA needs.
+/// This state must not outlive the batch: alias analyses are stateless and are
+/// preserved by passes that modify the IR, so nothing tells a longer-lived
+/// cache that its entries have become stale.
 class AAQueryInfo {
 public:
   using LocPair = std::pair<AACacheLoc, AACacheLoc>;
@@ -0,0 +1,69 @@
+//===- CompileTimeBudget.h - Per-function compile time budgets --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines CompileTimeBudget, a counter of the work an analysis or a
+// transform has done on a function. Expensive queries charge the budget as
+// they go and fall back to their conservative answer once it is exhausted, so
+// that the total cost stays linear in the size of the function instead of
+// being bounded per query only.
+//
+// Budgets are disabled unless -compile-time-budget is given, and then scale
+// with the number of instructions in the function.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_COMPILETIMEBUDGET_H
+#define LLVM_ANALYSIS_COMPILETIMEBUDGET_H
+
+#include <cstdint>
+
+namespace llvm {
+
+class Function;
+
+class CompileTimeBudget {
+public:
+  /// \p PassName is used as the pass name of the analysis remark that is
+  /// emitted when the budget of a function is exhausted, \p What describes
+  /// the work done (e.g. "instructions scanned").
+  CompileTimeBudget(const char *PassName, const char *What)
+      : PassName(PassName), What(What) {}
+
+  /// Returns true if budgets are enabled at all.
+  static bool isEnabled();
+
+  /// Charge \p Cost units of work done on \p F. Returns false if the budget
+  /// of \p F is exhausted, in which case the caller should give up and return
+  /// a conservative result. The first call that exhausts the budget emits an
+  /// analysis remark on \p F.
+  bool consume(const Function &F, uint64_t Cost = 1) {
+    if (!isEnabled())
+      return true;
+    return consumeSlow(F, Cost);
+  }
+
+  /// Returns true if \p F ran out of budget.
+  bool isExhausted(const Function &F) const {
+    return Exhausted && CurrentFn == &F;
+  }
+
+private:
+  bool consumeSlow(const Function &F, uint64_t Cost);
+
+  const char *PassName;
+  const char *What;
+  /// The function the budget is counting for. A budget is reset when it is
+  /// charged for another function.
+  const Function *CurrentFn = nullptr;
+  uint64_t Remaining = 0;
+  bool Exhausted = false;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ANALYSIS_COMPILETIMEBUDGET_H
@@ -19,6 +19,7 @@
 #include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/PointerSumType.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Analysis/CompileTimeBudget.h"
 #include "llvm/Analysis/MemoryLocation.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/PredIteratorCache.h"
@@ -353,6 +354,10 @@ private:
 
   unsigned DefaultBlockScanLimit;
 
+  /// Work done by all queries on the function, on top of the limits of each
+  /// query.
+  CompileTimeBudget Budget;
+
   /// Offsets to dependant clobber loads.
   using ClobberOffsetsMapType = DenseMap<LoadInst *, int32_t>;
   ClobberOffsetsMapType ClobberOffsets;
@@ -362,7 +367,8 @@ public:
                           const TargetLibraryInfo &TLI, DominatorTree &DT,
                           PhiValues &PV, unsigned DefaultBlockScanLimit)
       : AA(AA), AC(AC), TLI(TLI), DT(DT), PV(PV),
-        DefaultBlockScanLimit(DefaultBlockScanLimit) {}
+        DefaultBlockScanLimit(DefaultBlockScanLimit),
+        Budget("memdep", "instructions and blocks scanned") {}
 
   /// Handle invalidation in the new PM.
   bool invalidate(Function &F, const PreservedAnalyses &PA,
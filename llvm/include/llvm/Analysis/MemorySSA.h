@@ -78,6 +78,7 @@
 #include "llvm/ADT/ilist_node.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/CompileTimeBudget.h"
 #include "llvm/Analysis/MemoryLocation.h"
 #include "llvm/Analysis/PHITransAddr.h"
 #include "llvm/IR/DerivedUser.h"
@@ -886,6 +887,10 @@ private:
   std::unique_ptr<CachingWalker<AliasAnalysis>> Walker;
   std::unique_ptr<SkipSelfWalker<AliasAnalysis>> SkipWalker;
   unsigned NextID = 0;
+
+  // Alias checks done by all clobber walks on the function, both while
+  // optimizing uses and for later queries.
+  CompileTimeBudget WalkBudget;
 };
 
 /// Enables verification of MemorySSA.
@@ -421,6 +421,7 @@ enum Kind {
   kw_hot,
   kw_critical,
   kw_relbf,
+  kw_icpTarget,
   kw_variable,
   kw_vTableFuncs,
   kw_virtFunc,
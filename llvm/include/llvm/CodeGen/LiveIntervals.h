@@ -464,6 +464,9 @@ class VirtRegMap;
 
     static LiveInterval *createInterval(Register Reg);
 
+    /// Print the memory used by the live intervals of the current function.
+    void printMemoryUsage(raw_ostream &O) const;
+
     void printInstrs(raw_ostream &O) const;
     void dumpInstrs() const;
 
@@ -130,6 +130,32 @@ template<> struct FoldingSetTrait<SDVTListNode> : DefaultFoldingSetTrait<SDVTLis
   }
 };
 
+/// Specialize FoldingSetTrait for SDNode to compare the cached hash of a node
+/// before its full profile, and to avoid profiling the nodes again when the
+/// CSE map grows.
+template <> struct FoldingSetTrait<SDNode> : DefaultFoldingSetTrait<SDNode> {
+  static bool Equals(SDNode &X, const FoldingSetNodeID &ID, unsigned IDHash,
+                     FoldingSetNodeID &TempID) {
+    if (X.CSEHash && X.CSEHash != IDHash)
+      return false;
+    X.Profile(TempID);
+    if (TempID == ID) {
+      X.CSEHash = IDHash;
+      return true;
+    }
+    X.CSEHash = TempID.ComputeHash();
+    return false;
+  }
+
+  static unsigned ComputeHash(SDNode &X, FoldingSetNodeID &TempID) {
+    if (!X.CSEHash) {
+      X.Profile(TempID);
+      X.CSEHash = TempID.ComputeHash();
+    }
+    return X.CSEHash;
+  }
+};
+
 template <> struct ilist_alloc_traits<SDNode> {
   static void deleteNode(SDNode *) {
     llvm_unreachable("ilist_traits<SDNode> shouldn't see a deleteNode call!");
@@ -617,6 +617,18 @@ public:
   /// Used for debug printing.
   uint16_t PersistentId;
 
+private:
+  friend struct FoldingSetTrait<SDNode>;
+
+  /// The hash of the profile of this node in the CSE map, or 0 if it has not
+  /// been computed yet. This fits in the tail padding of the node, and saves
+  /// profiling the node again when the CSE map is searched or grown. It is
+  /// reset when the node is removed from the CSE map, so that it is
+  /// recomputed once the node is modified and added back.
+  unsigned CSEHash = 0;
+
+public:
+
   //===--------------------------------------------------------------------===//
   //  Accessors
   //
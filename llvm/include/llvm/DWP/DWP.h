@@ -11,6 +11,7 @@
 #include "llvm/MC/MCStreamer.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/Threading.h"
 #include <deque>
 #include <vector>
 
@@ -60,7 +61,10 @@ struct CompileUnitIdentifiers {
   const char *DWOName = "";
 };
 
-Error write(MCStreamer &Out, ArrayRef<std::string> Inputs);
+/// Writes the package of \p Inputs to \p Out. The inputs are read on the
+/// threads of \p S, ahead of being written in order.
+Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
+            ThreadPoolStrategy S = hardware_concurrency(1));
 
 unsigned getContributionIndex(DWARFSectionKind Kind, uint32_t IndexVersion);
 
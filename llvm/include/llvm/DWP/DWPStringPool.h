@@ -2,6 +2,7 @@
 #define LLVM_DWP_DWPSTRINGPOOL_H
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/StringSaver.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCStreamer.h"
 #include <cassert>
@@ -33,6 +34,10 @@ class DWPStringPool {
   MCStreamer &Out;
   MCSection *Sec;
   DenseMap<const char *, uint32_t, CStrDenseMapInfo> Pool;
+  // The strings of the pool are copied, so that the inputs they come from
+  // can be released once written.
+  BumpPtrAllocator Alloc;
+  StringSaver Saver{Alloc};
   uint32_t Offset = 0;
 
 public:
@@ -41,14 +46,17 @@ public:
   uint32_t getOffset(const char *Str, unsigned Length) {
     assert(strlen(Str) + 1 == Length && "Ensure length hint is correct");
 
-    auto Pair = Pool.insert(std::make_pair(Str, Offset));
-    if (Pair.second) {
-      Out.SwitchSection(Sec);
-      Out.emitBytes(StringRef(Str, Length));
-      Offset += Length;
-    }
+    auto It = Pool.find(Str);
+    if (It != Pool.end())
+      return It->second;
 
-    return Pair.first->second;
+    const char *Saved = Saver.save(StringRef(Str, Length - 1)).data();
+    Pool.insert(std::make_pair(Saved, Offset));
+    Out.SwitchSection(Sec);
+    Out.emitBytes(StringRef(Saved, Length));
+    uint32_t StrOffset = Offset;
+    Offset += Length;
+    return StrOffset;
   }
 };
 } // namespace llvm
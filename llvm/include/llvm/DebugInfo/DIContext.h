@@ -194,6 +194,12 @@ struct DIDumpOptions {
   bool SummarizeTypes = false;
   bool Verbose = false;
   bool DisplayRawContents = false;
+  /// The number of threads the verifier verifies units on, or 0 for one per
+  /// hardware thread.
+  unsigned VerifyNumThreads = 1;
+  /// When verifying .debug_names, only check that one in this number of the
+  /// DIEs of each unit is indexed.
+  unsigned VerifyNameIndexSampleRate = 1;
 
   /// Return default option set for printing a single DIE without children.
   static DIDumpOptions getForSingleDIE() {
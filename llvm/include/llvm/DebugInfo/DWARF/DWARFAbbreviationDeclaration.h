@@ -207,6 +207,10 @@ private:
   /// If this abbreviation has a fixed byte size then FixedAttributeSize member
   /// variable below will have a value.
   Optional<FixedSizeInfo> FixedAttributeSize;
+  /// The offsets of the leading attributes that are only preceded by fixed
+  /// size attributes, from the end of the abbreviation code, so that they can
+  /// be found without skipping the values of the attributes before them.
+  SmallVector<FixedSizeInfo, 8> FixedAttributeOffsets;
 };
 
 } // end namespace llvm
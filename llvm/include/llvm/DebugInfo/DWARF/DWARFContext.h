@@ -88,6 +88,22 @@ class DWARFContext : public DIContext {
       WithColor::defaultErrorHandler;
   std::function<void(Error)> WarningHandler = WithColor::defaultWarningHandler;
 
+  /// The units whose DIEs and line tables were parsed by address lookups,
+  /// tracked when a limit is set on the memory they use.
+  struct ParsedUnitInfo {
+    uint64_t LastLookup = 0;
+    uint64_t MemoryUsage = 0;
+  };
+  DenseMap<DWARFUnit *, ParsedUnitInfo> ParsedUnits;
+  uint64_t ParsedUnitsMemoryLimit = 0;
+  uint64_t ParsedUnitsMemoryUsage = 0;
+  uint64_t NumAddressLookups = 0;
+  DWARFUnit *LastLookupUnit = nullptr;
+
+  /// Record that \p U is used by an address lookup, and clear the least
+  /// recently looked up units if the memory limit is exceeded.
+  void noteAddressLookup(DWARFUnit *U);
+
   /// Read compile units from the debug_info section (if necessary)
   /// and type units from the debug_types sections (if necessary)
   /// and store them in NormalUnits.
@@ -290,6 +306,16 @@ public:
   /// Get a pointer to the parsed DebugAranges object.
   const DWARFDebugAranges *getDebugAranges();
 
+  /// Limit the memory used by the DIEs and line tables that address lookups
+  /// parse to about \p Bytes. Looking up an address only parses the compile
+  /// unit that contains it: when the limit is exceeded, the least recently
+  /// looked up units are cleared, keeping their unit DIE, and are parsed
+  /// again when needed. This invalidates the DIEs and line tables obtained
+  /// from the cleared units. Zero, the default, disables the limit.
+  void setParsedUnitsMemoryLimit(uint64_t Bytes) {
+    ParsedUnitsMemoryLimit = Bytes;
+  }
+
   /// Get a pointer to the parsed frame information object.
   Expected<const DWARFDebugFrame *> getDebugFrame();
 
@@ -300,6 +300,8 @@ public:
   };
 
   const LineTable *getLineTable(uint64_t Offset) const;
+  /// Free the line table parsed at \p Offset, if any.
+  void clearLineTable(uint64_t Offset) { LineTableMap.erase(Offset); }
   Expected<const LineTable *>
   getOrParseLineTable(DWARFDataExtractor &DebugLineData, uint64_t Offset,
                       const DWARFContext &Ctx, const DWARFUnit *U,
@@ -505,6 +505,15 @@ public:
 
   Error tryExtractDIEsIfNeeded(bool CUDieOnly);
 
+  /// clearDIEs - Clear parsed DIEs to keep memory usage low. This invalidates
+  /// the DWARFDie objects pointing into this unit, if \p KeepCUDie is set
+  /// except for the unit DIE, which is the only DIE kept.
+  void clearDIEs(bool KeepCUDie);
+
+  /// Returns an estimate of the memory used by the parsed DIEs of this unit,
+  /// in bytes.
+  size_t getDIEsMemoryUsage() const;
+
 private:
   /// Size in bytes of the .debug_info data associated with this compile unit.
   size_t getDebugInfoSize() const {
@@ -520,9 +529,6 @@ private:
   void extractDIEsToVector(bool AppendCUDie, bool AppendNonCUDIEs,
                            std::vector<DWARFDebugInfoEntry> &DIEs) const;
 
-  /// clearDIEs - Clear parsed DIEs to keep memory usage low.
-  void clearDIEs(bool KeepCUDie);
-
   /// parseDWO - Parses .dwo file for current compile unit. Returns true if
   /// it was actually constructed.
   bool parseDWO();
@@ -84,6 +84,20 @@ private:
   bool IsMachOObject;
   using ReferenceMap = std::map<uint64_t, std::set<uint64_t>>;
 
+  /// Runs \p Verify for each index in [0, \p Count). The runs are spread
+  /// over DumpOpts.VerifyNumThreads threads, each with its own verifier
+  /// buffering its output, and their output is printed in order, so that it
+  /// is the same as when running them serially on this verifier.
+  ///
+  /// \returns The sum of the number of errors returned by \p Verify.
+  unsigned
+  verifyInParallel(size_t Count,
+                   function_ref<unsigned(DWARFVerifier &, size_t)> Verify);
+
+  /// Parses the DIEs of \p Units and what their verification reads lazily
+  /// from the context, so that they can be verified in parallel.
+  void prepareUnitsForParallelVerification(const DWARFUnitVector &Units);
+
   raw_ostream &error() const;
   raw_ostream &warn() const;
   raw_ostream &note() const;
@@ -222,6 +236,7 @@ private:
   /// - addresses within a sequence that decrease in value
   /// - invalid file indexes
   void verifyDebugLineRows();
+  unsigned verifyDebugLineRows(DWARFUnit &CU);
 
   /// Verify that an Apple-style accelerator table is valid.
   ///
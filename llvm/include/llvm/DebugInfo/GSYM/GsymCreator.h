@@ -144,6 +144,12 @@ class GsymCreator {
   llvm::Optional<uint64_t> BaseAddress;
   bool Finalized = false;
   bool Quiet;
+  unsigned NumThreads = 1;
+
+  /// Encode the function infos on NumThreads threads. Mutex must be held.
+  llvm::Error
+  encodeFunctionInfosInParallel(FileWriter &O,
+                                std::vector<uint32_t> &AddrInfoOffsets) const;
 
 public:
   GsymCreator(bool Quiet = false);
@@ -291,6 +297,11 @@ public:
 
   /// Whether the transformation should be quiet, i.e. not output warnings.
   bool isQuiet() const { return Quiet; }
+
+  /// Set the number of threads used to encode the function infos when
+  /// saving the GSYM file. Zero means one per hardware thread. The output
+  /// does not depend on the number of threads.
+  void setNumThreads(unsigned N) { NumThreads = N; }
 };
 
 } // namespace gsym
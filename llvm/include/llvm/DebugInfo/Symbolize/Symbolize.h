@@ -66,6 +66,10 @@ public:
     size_t MaxCacheSize = sizeof(size_t) == 4
                               ? 512 * 1024 * 1024 /* 512 MiB */
                               : 4ULL * 1024 * 1024 * 1024 /* 4 GiB */;
+    /// Limit on the memory used by the compile units of a module parsed to
+    /// symbolize addresses, zero for no limit. See
+    /// DWARFContext::setParsedUnitsMemoryLimit.
+    uint64_t MaxDWARFUnitCacheSize = 0;
   };
 
   LLVMSymbolizer();
@@ -22,8 +22,10 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 
 #include <chrono>
+#include <vector>
 
 namespace llvm {
 
@@ -56,6 +58,12 @@ Expected<std::string> getCachedOrDownloadExecutable(BuildIDRef ID);
 /// server URLs.
 Expected<std::string> getCachedOrDownloadDebuginfo(BuildIDRef ID);
 
+/// Fetches the debug binaries of \p IDs that are missing from the default local
+/// cache from the default server URLs, so that later lookups of them hit the
+/// cache. Errors are ignored: they are reported again by those lookups.
+void prefetchDebuginfo(ArrayRef<BuildID> IDs,
+                       ThreadPoolStrategy S = hardware_concurrency(16));
+
 /// Fetches any debuginfod artifact using the default local cache directory and
 /// server URLs.
 Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
@@ -68,6 +76,19 @@ Expected<std::string> getCachedOrDownloadArtifact(
     StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
     ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout);
 
+/// Fetches the debuginfod artifacts identified by the distinct \p UniqueKeys
+/// and the corresponding \p UrlPaths, like getCachedOrDownloadArtifact. The
+/// artifacts are fetched in parallel on the threads of \p S, each of which
+/// reuses a single HTTP client, and so its connections to the servers, for
+/// all of its requests.
+///
+/// \returns the paths of the cached artifacts or the errors fetching them, in
+/// the order of \p UniqueKeys.
+std::vector<Expected<std::string>> getCachedOrDownloadArtifacts(
+    ArrayRef<std::string> UniqueKeys, ArrayRef<std::string> UrlPaths,
+    StringRef CacheDirectoryPath, ArrayRef<StringRef> DebuginfodUrls,
+    std::chrono::milliseconds Timeout, ThreadPoolStrategy S);
+
 } // end namespace llvm
 
 #endif
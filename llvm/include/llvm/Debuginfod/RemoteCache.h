@@ -0,0 +1,43 @@
+//===-- llvm/Debuginfod/RemoteCache.h - Remote file cache -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file declares remoteCache, a FileCache that looks up the files missing
+/// from a local cache in a content-addressed store served over HTTP, such as
+/// the one shared by the machines of a build farm.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFOD_REMOTECACHE_H
+#define LLVM_DEBUGINFOD_REMOTECACHE_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Caching.h"
+
+#include <chrono>
+
+namespace llvm {
+
+/// Create a file cache that first looks up a key in \p LocalCache, and on a
+/// miss fetches <ServerUrl>/llvmcache-<key>. A fetched file is written to the
+/// local cache, which adds it to the output the same way as a local hit. If
+/// the server does not have the file, cannot be reached, or does not answer
+/// within \p Timeout, the stream callback of the local cache is returned, so
+/// that the file is produced locally.
+///
+/// The store is read-only to the cache: populating it, for example by
+/// uploading the files of the local cache directories, is up to the build
+/// system. HTTPClient::initialize() must have been called for remote lookups
+/// to be made; otherwise, and when LLVM is built without an HTTP client, this
+/// behaves like \p LocalCache.
+FileCache remoteCache(StringRef ServerUrl, FileCache LocalCache,
+                      std::chrono::milliseconds Timeout);
+
+} // end namespace llvm
+
+#endif // LLVM_DEBUGINFOD_REMOTECACHE_H
@@ -1619,6 +1619,12 @@ struct PassConfiguration {
   ///
   /// Notable use cases: Testing and validation.
   LinkGraphPassList PostFixupPasses;
+
+  /// Apply the fixups of different blocks concurrently, on the threads of the
+  /// llvm::parallel executor (see llvm/Support/Parallel.h).
+  ///
+  /// Notable use cases: Linking large objects.
+  bool ConcurrentFixups = false;
 };
 
 /// Flags for symbol lookup.
@@ -0,0 +1,117 @@
+//===- SlabMemoryManager.h - Slab based JITLink memory manager --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A JITLinkMemoryManager that allocates from large, reused slabs of memory.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_JITLINK_SLABMEMORYMANAGER_H
+#define LLVM_EXECUTIONENGINE_JITLINK_SLABMEMORYMANAGER_H
+
+#include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+namespace jitlink {
+
+/// A JITLinkMemoryManager that carves allocations out of large slabs of
+/// memory and recycles the ranges of freed allocations.
+///
+/// InProcessMemoryManager maps fresh pages for each graph and unmaps them on
+/// deallocation. With many small graphs this means a lot of mmap calls, and
+/// code scattered over the address space. This manager instead maps slabs of
+/// SlabSize bytes (2Mb by default) with a hint to back them with huge pages,
+/// and places each graph in the lowest free range that fits, which keeps code
+/// contiguous. Graphs larger than a slab get a slab of their own. Slabs are
+/// only unmapped when the manager is destroyed.
+///
+/// With dual mapping, each slab is mapped twice: JITLink writes through a
+/// read-write view, while the code runs from a second view whose pages are
+/// never writable and executable at the same time. Dual mapping is only
+/// supported on Linux.
+class SlabMemoryManager : public JITLinkMemoryManager {
+public:
+  class SlabInFlightAlloc;
+
+  /// Create a manager with slabs of \p SlabSize bytes (rounded up to the page
+  /// size).
+  static Expected<std::unique_ptr<SlabMemoryManager>>
+  Create(uint64_t SlabSize = 2 * 1024 * 1024, bool DualMapping = false);
+
+  ~SlabMemoryManager();
+
+  void allocate(const JITLinkDylib *JD, LinkGraph &G,
+                OnAllocatedFunction OnAllocated) override;
+
+  // Use overloads from base class.
+  using JITLinkMemoryManager::allocate;
+
+  void deallocate(std::vector<FinalizedAlloc> Allocs,
+                  OnDeallocatedFunction OnDeallocated) override;
+
+  // Use overloads from base class.
+  using JITLinkMemoryManager::deallocate;
+
+  /// Returns the number of slabs mapped so far.
+  size_t getNumSlabs();
+
+private:
+  struct Slab {
+    /// The view that JITLink writes to.
+    char *WorkingMem = nullptr;
+    /// The view the code runs from. Same as WorkingMem unless dual mapped.
+    char *ExecMem = nullptr;
+    uint64_t Size = 0;
+    /// Free ranges, as offset to size. Adjacent ranges are always merged.
+    std::map<uint64_t, uint64_t> FreeRanges;
+  };
+
+  struct Range {
+    Slab *S = nullptr;
+    uint64_t Offset = 0;
+    uint64_t Size = 0;
+
+    char *getWorkingMem() const { return S->WorkingMem + Offset; }
+    char *getExecMem() const { return S->ExecMem + Offset; }
+  };
+
+  struct FinalizedAllocInfo {
+    Range R;
+    std::vector<orc::shared::WrapperFunctionCall> DeallocActions;
+  };
+
+  SlabMemoryManager(uint64_t PageSize, uint64_t SlabSize, bool DualMapping)
+      : PageSize(PageSize), SlabSize(SlabSize), DualMapping(DualMapping) {}
+
+  Error mapSlab(Slab &S, uint64_t Size);
+  Error unmapSlab(Slab &S);
+
+  Expected<Range> allocateRange(uint64_t Size);
+  Error releaseRange(Range R);
+
+  FinalizedAlloc
+  createFinalizedAlloc(Range R,
+                       std::vector<orc::shared::WrapperFunctionCall> Actions);
+
+  uint64_t PageSize;
+  uint64_t SlabSize;
+  bool DualMapping;
+
+  std::mutex SlabsMutex;
+  std::vector<std::unique_ptr<Slab>> Slabs;
+  RecyclingAllocator<BumpPtrAllocator, FinalizedAllocInfo> FinalizedAllocInfos;
+};
+
+} // end namespace jitlink
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_JITLINK_SLABMEMORYMANAGER_H
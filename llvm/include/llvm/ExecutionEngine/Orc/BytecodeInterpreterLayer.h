@@ -0,0 +1,75 @@
+//===- BytecodeInterpreterLayer.h - Interpreted IR layer --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A layer that runs the functions of the emitted modules in an interpreter.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_BYTECODEINTERPRETERLAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_BYTECODEINTERPRETERLAYER_H
+
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+/// Runs the functions of the emitted modules in an interpreter, instead of
+/// compiling them.
+///
+/// For code that only runs once, e.g. the expressions of a REPL, translating
+/// the IR is much cheaper than generating machine code, even without
+/// optimization. The functions of a module are translated to a compact,
+/// register based bytecode, which is run by an interpreter using threaded
+/// dispatch where the host compiler supports it. The exported functions are
+/// given native entry points, so they can be called as if they were compiled,
+/// and be put behind the stubs of TieredCompileLayer to be recompiled once
+/// they turn out to be hot.
+///
+/// The interpreter handles scalar integer, pointer and floating point code.
+/// Modules it can not handle, e.g. because they use vectors, exceptions or
+/// static initializers, are emitted through the fallback layer. The entry
+/// points are limited to six integer or pointer arguments: functions with
+/// other signatures can only be interpreted if they are not exported and do
+/// not have their address taken. Calls to native code have the same limits,
+/// and can not go to variadic functions.
+///
+/// The interpreter runs in this process, so the executor must be the JIT
+/// process itself. The memory of the interpreted modules and their entry
+/// points are released when the layer is destroyed.
+class BytecodeInterpreterLayer : public IRLayer {
+public:
+  class InterpretedModule;
+
+  BytecodeInterpreterLayer(ExecutionSession &ES, IRLayer &FallbackLayer);
+  ~BytecodeInterpreterLayer();
+
+  /// Returns the number of modules interpreted so far.
+  size_t getNumInterpretedModules() const;
+
+  /// Returns the number of modules emitted through the fallback layer so far.
+  size_t getNumFallbackModules() const;
+
+  /// Emits the given module. This should not be called by clients: it will be
+  /// called by the JIT when a definition added via the add method is requested.
+  void emit(std::unique_ptr<MaterializationResponsibility> R,
+            ThreadSafeModule TSM) override;
+
+private:
+  mutable std::mutex LayerMutex;
+  IRLayer &FallbackLayer;
+  std::vector<std::unique_ptr<InterpretedModule>> Modules;
+  size_t NumFallbackModules = 0;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_BYTECODEINTERPRETERLAYER_H
@@ -0,0 +1,122 @@
+//===--- CompileTimingPlugin.h - Timing of JIT materialization --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// ObjectLinkingLayer plugin that records where materialization time goes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_COMPILETIMINGPLUGIN_H
+#define LLVM_EXECUTIONENGINE_ORC_COMPILETIMINGPLUGIN_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+/// Records how long materialization units wait for a compile thread, and how
+/// long materialization takes in IR optimization, code generation and
+/// linking.
+///
+/// As an ObjectLinkingLayer plugin, it measures linking. The other phases are
+/// measured by wrapping the corresponding hooks:
+///   - instrumentDispatch wraps the task dispatch function of an
+///     ExecutionSession to measure the queue and run times of each
+///     materialization task,
+///   - wrapTransform wraps an IRTransformLayer transform, e.g. the
+///     optimization pipeline,
+///   - wrapCompiler wraps the compiler of an IRCompileLayer.
+///
+/// Times are accumulated in the Stats. The queue and run times of each
+/// materialization unit are kept as well. When the time trace profiler is
+/// enabled on the thread doing the work, materialization, optimization and
+/// code generation are also emitted as time sections, and the number of
+/// queued tasks as a counter.
+class CompileTimingPlugin : public ObjectLinkingLayer::Plugin {
+public:
+  using Duration = std::chrono::nanoseconds;
+
+  struct Stats {
+    uint64_t NumMaterializations = 0;
+    /// Time between dispatch of, and start of materialization tasks.
+    Duration QueueTime = Duration(0);
+    /// Time spent running materialization tasks.
+    Duration MaterializationTime = Duration(0);
+    Duration OptimizationTime = Duration(0);
+    Duration CodeGenTime = Duration(0);
+    /// Time from the start of a link until the code is emitted. This may
+    /// include time waiting for dependencies to be resolved.
+    Duration LinkTime = Duration(0);
+  };
+
+  struct MaterializationTiming {
+    std::string Description;
+    Duration QueueTime;
+    Duration RunTime;
+  };
+
+  /// Wrap the task dispatch function of \p ES. The plugin must outlive the
+  /// session.
+  void instrumentDispatch(ExecutionSession &ES);
+
+  /// Wrap \p Transform to measure it as optimization time.
+  IRTransformLayer::TransformFunction
+  wrapTransform(IRTransformLayer::TransformFunction Transform);
+
+  /// Wrap \p Compile to measure it as code generation time.
+  std::unique_ptr<IRCompileLayer::IRCompiler>
+  wrapCompiler(std::unique_ptr<IRCompileLayer::IRCompiler> Compile);
+
+  Stats getStats();
+
+  /// Returns the queue and run times of the materialization tasks run so far,
+  /// in the order they completed.
+  std::vector<MaterializationTiming> getMaterializationTimings();
+
+  void printStats(raw_ostream &OS);
+
+  void modifyPassConfig(MaterializationResponsibility &MR,
+                        jitlink::LinkGraph &G,
+                        jitlink::PassConfiguration &Config) override;
+  Error notifyEmitted(MaterializationResponsibility &MR) override;
+  Error notifyFailed(MaterializationResponsibility &MR) override;
+  Error notifyRemovingResources(ResourceKey K) override;
+  void notifyTransferringResources(ResourceKey DstKey,
+                                   ResourceKey SrcKey) override;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  class TimedCompiler;
+
+  void updateNumQueued(int64_t Delta);
+  void taskFinished(std::string Description, Clock::time_point Dispatched,
+                    Clock::time_point Started, Clock::time_point Finished);
+  void linkFinished(MaterializationResponsibility &MR);
+  void addTime(Duration Stats::*Field, Clock::duration D);
+
+  std::mutex StatsMutex;
+  Stats S;
+  std::vector<MaterializationTiming> Timings;
+  int64_t NumQueued = 0;
+  DenseMap<MaterializationResponsibility *, Clock::time_point> LinkStarts;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_COMPILETIMINGPLUGIN_H
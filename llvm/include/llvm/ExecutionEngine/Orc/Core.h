@@ -1480,6 +1480,14 @@ public:
     return *this;
   }
 
+  /// Replace the task dispatch function by the result of \p Wrap, which is
+  /// called with the current one, e.g. to instrument the dispatched tasks.
+  ExecutionSession &wrapDispatchTask(
+      unique_function<DispatchTaskFunction(DispatchTaskFunction)> Wrap) {
+    DispatchTask = Wrap(std::move(DispatchTask));
+    return *this;
+  }
+
   /// Search the given JITDylibs to find the flags associated with each of the
   /// given symbols.
   void lookupFlags(LookupKind K, JITDylibSearchOrder SearchOrder,
@@ -1550,6 +1558,27 @@ public:
   lookup(ArrayRef<JITDylib *> SearchOrder, StringRef Symbol,
          SymbolState RequiredState = SymbolState::Ready);
 
+  /// A set of symbols to search for in a search order. See bulkLookup.
+  struct LookupRequest {
+    JITDylibSearchOrder SearchOrder;
+    SymbolLookupSet Symbols;
+  };
+
+  /// Blocking lookup of several symbol sets, each in its own search order.
+  ///
+  /// All the lookups are issued before waiting for any of them, so the
+  /// materialization units they require are dispatched together and can run
+  /// concurrently if the TaskDispatcher is concurrent. For symbols that have
+  /// not been materialized yet, this is much faster than a sequence of
+  /// blocking lookups.
+  ///
+  /// Returns the results in the order of the requests, or the errors of all
+  /// the lookups that failed.
+  Expected<std::vector<SymbolMap>>
+  bulkLookup(ArrayRef<LookupRequest> Requests,
+             LookupKind K = LookupKind::Static,
+             SymbolState RequiredState = SymbolState::Ready);
+
   /// Materialize the given unit.
   void dispatchTask(std::unique_ptr<Task> T) {
     assert(T && "T must be non-null");
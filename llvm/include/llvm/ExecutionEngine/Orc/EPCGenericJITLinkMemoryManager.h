@@ -20,6 +20,7 @@
 
 #include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
 #include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/Support/Memory.h"
 
 namespace llvm {
 namespace orc {
@@ -32,6 +33,11 @@ public:
     ExecutorAddr Reserve;
     ExecutorAddr Finalize;
     ExecutorAddr Deallocate;
+    /// Function to reserve shared memory, if allocations should be made in
+    /// shared memory. The content is then written in place through a local
+    /// mapping of the memory, and finalize requests only carry protections
+    /// and actions. Requires the executor to run on the same host.
+    ExecutorAddr ReserveShared;
   };
 
   /// Create an EPCGenericJITLinkMemoryManager instance from a given set of
@@ -54,8 +60,12 @@ public:
 private:
   class InFlightAlloc;
 
+  void allocateShared(jitlink::BasicLayout BL, uint64_t Size,
+                      OnAllocatedFunction OnAllocated);
+
   void completeAllocation(ExecutorAddr AllocAddr, jitlink::BasicLayout BL,
-                          OnAllocatedFunction OnAllocated);
+                          OnAllocatedFunction OnAllocated,
+                          sys::MemoryBlock LocalMapping = sys::MemoryBlock());
 
   ExecutorProcessControl &EPC;
   SymbolAddrs SAs;
@@ -108,6 +108,17 @@ public:
     return addObjectFile(*Main, std::move(Obj));
   }
 
+  /// Compiles \p TSM with this JIT's compiler and writes the object file to
+  /// \p Path, so that later sessions can add it with addObjectSnapshot
+  /// instead of linking and compiling the IR again. The IR transform layer is
+  /// not run on TSM, so it should be optimized already.
+  Error writeObjectSnapshot(ThreadSafeModule TSM, StringRef Path);
+
+  /// Adds an object file written by writeObjectSnapshot to the given
+  /// JITDylib. The file is mapped rather than read, and is rejected if it was
+  /// compiled for another architecture.
+  Error addObjectSnapshot(JITDylib &JD, StringRef Path);
+
   /// Look up a symbol in JITDylib JD by the symbol's linker-mangled name (to
   /// look up symbols based on their IR name use the lookup function instead).
   Expected<JITEvaluatedSymbol> lookupLinkerMangled(JITDylib &JD,
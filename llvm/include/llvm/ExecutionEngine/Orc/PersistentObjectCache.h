@@ -0,0 +1,91 @@
+//===- PersistentObjectCache.h - On-disk object cache for ORC ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps the objects compiled by the JIT in a directory, so
+// that they can be reused by later runs.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/Error.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+/// An ObjectCache backed by a local file cache (see llvm/Support/Caching.h).
+///
+/// Objects are keyed by a hash of the bitcode of the module, of the target
+/// description of the JITTargetMachineBuilder the cache was created with, and
+/// of the version of LLVM. A module is hashed after the IR layers above the
+/// compiler have run, so any change to the optimization pipeline is part of
+/// the key as well. The TargetOptions are not hashed: clients that compile
+/// with different options should use different cache directories.
+///
+/// The cache can be passed to SimpleCompiler or ConcurrentIRCompiler, e.g.
+/// from the CompileFunctionCreator of an LLJITBuilder. On a hit, the compiler
+/// skips code generation and the cached object is handed to the object layer
+/// as is.
+///
+/// Errors accessing the cache are not fatal: the module is compiled and the
+/// error is passed to the ReportError callback.
+class PersistentObjectCache : public ObjectCache {
+public:
+  using ReportErrorFunction = std::function<void(Error)>;
+
+  /// Create a cache in \p CacheDir for the objects compiled by the target
+  /// machines of \p JTMB. The directory is created when the first object is
+  /// stored.
+  static Expected<std::unique_ptr<PersistentObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB,
+         ReportErrorFunction ReportError = ReportErrorFunction());
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+  /// Returns the key of \p M in this cache.
+  std::string getKey(const Module &M) const;
+
+  /// Returns the number of objects found in the cache.
+  unsigned getNumHits() const;
+
+  /// Returns the number of objects stored in the cache.
+  unsigned getNumMisses() const;
+
+private:
+  PersistentObjectCache(std::string TargetKey, ReportErrorFunction ReportError)
+      : TargetKey(std::move(TargetKey)), ReportError(std::move(ReportError)) {}
+
+  void reportError(Error Err);
+
+  mutable std::mutex CacheMutex;
+  FileCache Cache;
+  std::string TargetKey;
+  ReportErrorFunction ReportError;
+  /// The buffer found by the last lookup in Cache.
+  std::unique_ptr<MemoryBuffer> FoundObject;
+  /// The keys of the modules missing from the cache, until their objects are
+  /// stored.
+  DenseMap<const Module *, std::string> PendingKeys;
+  unsigned NumHits = 0;
+  unsigned NumMisses = 0;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
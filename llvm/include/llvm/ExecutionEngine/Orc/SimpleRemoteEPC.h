@@ -89,6 +89,13 @@ public:
 
   void handleDisconnect(Error Err) override;
 
+  /// Create a memory manager that allocates in memory shared with the
+  /// executor, so that the content of the allocations does not need to be
+  /// sent over the transport. The executor must run on the same host.
+  /// Can be used as the CreateMemoryManager function of the Setup.
+  static Expected<std::unique_ptr<jitlink::JITLinkMemoryManager>>
+  createSharedMemoryManager(SimpleRemoteEPC &SREPC);
+
 private:
   SimpleRemoteEPC(std::shared_ptr<SymbolStringPool> SSP,
                   std::unique_ptr<TaskDispatcher> D)
@@ -42,6 +42,15 @@ public:
   ResultTy operator()(Function &F);
 };
 
+// Every function with a body is selected, so that the Speculator records the
+// order of first calls and can speculate from a profile of previous runs (see
+// Speculator::addProfileCandidates). The candidates found by BlockFreqQuery
+// are speculated as well.
+class CallSequenceQuery : public SpeculateQuery {
+public:
+  ResultTy operator()(Function &F);
+};
+
 // This Query generates a sequence of basic blocks which follows the order of
 // execution.
 // A handful of BB with higher block frequencies are taken, then path to entry
@@ -22,6 +22,7 @@
 #include <mutex>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace llvm {
 namespace orc {
@@ -65,10 +66,11 @@ public:
   using StubAddrLikelies = DenseMap<TargetFAddr, SymbolNameSet>;
 
 private:
-  void registerSymbolsWithAddr(TargetFAddr ImplAddr,
+  void registerSymbolsWithAddr(TargetFAddr ImplAddr, SymbolStringPtr Target,
                                SymbolNameSet likelySymbols) {
     std::lock_guard<std::mutex> Lockit(ConcurrentAccess);
     GlobalSpecMap.insert({ImplAddr, std::move(likelySymbols)});
+    AddrToSymbol.insert({ImplAddr, std::move(Target)});
   }
 
   void launchCompile(JITTargetAddress FAddr) {
@@ -81,6 +83,16 @@ private:
       if (It == GlobalSpecMap.end())
         return;
       CandidateSet = It->getSecond();
+
+      // Functions are instrumented to come here on their first call only.
+      auto SymIt = AddrToSymbol.find(FAddr);
+      if (SymIt != AddrToSymbol.end()) {
+        CallSequence.push_back(SymIt->second);
+        auto ProfileIt = ProfileCandidates.find(SymIt->second);
+        if (ProfileIt != ProfileCandidates.end())
+          for (auto &Callee : ProfileIt->second)
+            CandidateSet.insert(Callee);
+      }
     }
 
     SymbolDependenceMap SpeculativeLookUpImpls;
@@ -136,6 +148,24 @@ public:
   // destination of __orc_speculate_for jump
   void speculateFor(TargetFAddr StubAddr) { launchCompile(StubAddr); }
 
+  /// Add candidates predicted from previous runs, e.g. by
+  /// readSpeculationProfile. When a function is called for the first time,
+  /// its profile candidates are compiled in addition to the ones found by
+  /// the IR query.
+  void addProfileCandidates(FunctionCandidatesMap Candidates) {
+    std::lock_guard<std::mutex> Lockit(ConcurrentAccess);
+    for (auto &KV : Candidates)
+      for (auto &Callee : KV.second)
+        ProfileCandidates[KV.first].insert(Callee);
+  }
+
+  /// Returns the instrumented functions called so far, in the order of their
+  /// first call. This can be saved with writeSpeculationProfile.
+  std::vector<SymbolStringPtr> getCallSequence() {
+    std::lock_guard<std::mutex> Lockit(ConcurrentAccess);
+    return CallSequence;
+  }
+
   // FIXME : Register with Stub Address, after JITLink Fix.
   void registerSymbols(FunctionCandidatesMap Candidates, JITDylib *JD) {
     for (auto &SymPair : Candidates) {
@@ -146,7 +176,7 @@ public:
                            this](Expected<SymbolMap> ReadySymbol) {
         if (ReadySymbol) {
           auto RAddr = (*ReadySymbol)[Target].getAddress();
-          registerSymbolsWithAddr(RAddr, std::move(Likely));
+          registerSymbolsWithAddr(RAddr, Target, std::move(Likely));
         } else
           this->getES().reportError(ReadySymbol.takeError());
       };
@@ -167,8 +197,23 @@ private:
   ImplSymbolMap &AliaseeImplTable;
   ExecutionSession &ES;
   StubAddrLikelies GlobalSpecMap;
+  DenseMap<TargetFAddr, SymbolStringPtr> AddrToSymbol;
+  FunctionCandidatesMap ProfileCandidates;
+  std::vector<SymbolStringPtr> CallSequence;
 };
 
+/// Write a call sequence recorded by Speculator::getCallSequence to \p Path,
+/// one linker-mangled symbol name per line.
+Error writeSpeculationProfile(StringRef Path,
+                              ArrayRef<SymbolStringPtr> CallSequence);
+
+/// Read a profile written by writeSpeculationProfile. Each function is mapped
+/// to the \p Lookahead functions that were first called right after it, to
+/// be passed to Speculator::addProfileCandidates.
+Expected<Speculator::FunctionCandidatesMap>
+readSpeculationProfile(StringRef Path, ExecutionSession &ES,
+                       unsigned Lookahead = 4);
+
 class IRSpeculationLayer : public IRLayer {
 public:
   using IRlikiesStrRef = Optional<DenseMap<StringRef, DenseSet<StringRef>>>;
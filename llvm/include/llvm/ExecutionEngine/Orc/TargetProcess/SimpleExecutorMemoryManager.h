@@ -23,6 +23,7 @@
 #include "llvm/Support/Error.h"
 
 #include <mutex>
+#include <string>
 
 namespace llvm {
 namespace orc {
@@ -34,6 +35,14 @@ public:
   virtual ~SimpleExecutorMemoryManager();
 
   Expected<ExecutorAddr> allocate(uint64_t Size);
+
+  /// Allocate memory backed by a named shared memory object, so that the
+  /// controller can map it and write the content in place. Returns the
+  /// address and the name of the object. The content of the segments of
+  /// such an allocation is not copied by finalize.
+  Expected<std::pair<ExecutorAddr, std::string>>
+  allocateShared(uint64_t Size);
+
   Error finalize(tpctypes::FinalizeRequest &FR);
   Error deallocate(const std::vector<ExecutorAddr> &Bases);
 
@@ -44,6 +53,8 @@ private:
   struct Allocation {
     size_t Size = 0;
     std::vector<shared::WrapperFunctionCall> DeallocationActions;
+    /// The name of the shared memory object, for shared allocations.
+    std::string SharedMemoryName;
   };
 
   using AllocationsMap = DenseMap<void *, Allocation>;
@@ -53,6 +64,9 @@ private:
   static llvm::orc::shared::CWrapperFunctionResult
   reserveWrapper(const char *ArgData, size_t ArgSize);
 
+  static llvm::orc::shared::CWrapperFunctionResult
+  reserveSharedWrapper(const char *ArgData, size_t ArgSize);
+
   static llvm::orc::shared::CWrapperFunctionResult
   finalizeWrapper(const char *ArgData, size_t ArgSize);
 
@@ -61,6 +75,7 @@ private:
 
   std::mutex M;
   AllocationsMap Allocations;
+  unsigned NextSharedMemoryID = 0;
 };
 
 } // end namespace rt_bootstrap
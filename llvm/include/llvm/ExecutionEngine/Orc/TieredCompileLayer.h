@@ -0,0 +1,129 @@
+//===--- TieredCompileLayer.h - Recompile hot functions ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A layer that compiles functions with a fast first tier, and recompiles the
+// functions that turn out to be hot with an optimizing second tier.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace llvm {
+namespace orc {
+
+/// Compiles the functions of the emitted modules with a first tier layer, and
+/// recompiles each function with a second tier layer once it has been called
+/// a given number of times.
+///
+/// Callable symbols are replaced with lazy reexports, as in
+/// CompileOnDemandLayer, so every call goes through an indirect stub. The
+/// first tier code counts the calls to each function. When a counter reaches
+/// the threshold, a task is dispatched on the ExecutionSession that extracts
+/// the function from a copy of the original IR, emits it through the second
+/// tier layer and points the stub at the new code. With a concurrent task
+/// dispatcher the recompilation happens on a background thread, otherwise it
+/// happens on the thread that made the call.
+///
+/// Typically, the first tier layer compiles without optimization and the
+/// second one runs the optimization pipeline before compiling at a higher
+/// optimization level.
+///
+/// The counters live in the memory of this process, so the executor must be
+/// the JIT process itself. Modules with static initializers are emitted
+/// through the first tier only.
+class TieredCompileLayer : public IRLayer {
+public:
+  /// Builder for IndirectStubsManagers.
+  using IndirectStubsManagerBuilder =
+      std::function<std::unique_ptr<IndirectStubsManager>()>;
+
+  /// Construct a TieredCompileLayer that recompiles the functions called
+  /// \p HotCallCount times.
+  TieredCompileLayer(ExecutionSession &ES, IRLayer &FirstTierLayer,
+                     IRLayer &SecondTierLayer, LazyCallThroughManager &LCTMgr,
+                     IndirectStubsManagerBuilder BuildIndirectStubsManager,
+                     uint64_t HotCallCount = 1000);
+
+  /// Returns the number of functions that were recompiled by the second tier.
+  size_t getNumRecompiledFunctions() const;
+
+  /// Emits the given module. This should not be called by clients: it will be
+  /// called by the JIT when a definition added via the add method is requested.
+  void emit(std::unique_ptr<MaterializationResponsibility> R,
+            ThreadSafeModule TSM) override;
+
+private:
+  struct PerDylibResources {
+  public:
+    PerDylibResources(JITDylib &ImplD,
+                      std::unique_ptr<IndirectStubsManager> ISMgr)
+        : ImplD(ImplD), ISMgr(std::move(ISMgr)) {}
+    JITDylib &getImplDylib() { return ImplD; }
+    IndirectStubsManager &getISManager() { return *ISMgr; }
+
+  private:
+    JITDylib &ImplD;
+    std::unique_ptr<IndirectStubsManager> ISMgr;
+  };
+
+  using PerDylibResourcesMap = std::map<const JITDylib *, PerDylibResources>;
+
+  /// A function compiled by the first tier.
+  struct TieredFunction {
+    PerDylibResources *PDR;
+    /// Name of the stub that calls the function.
+    SymbolStringPtr StubName;
+    /// Name of the function in the original IR.
+    std::string IRName;
+    /// Name of the second tier definition of the function.
+    SymbolStringPtr SecondTierName;
+    /// The original IR of the module that defines the function.
+    std::shared_ptr<ThreadSafeModule> Source;
+    /// Number of calls, incremented by the first tier code.
+    uint64_t CallCount = 0;
+  };
+
+  PerDylibResources &getPerDylibResources(JITDylib &TargetD);
+
+  void cleanUpModule(Module &M);
+
+  /// Called by the first tier code of \p TF when its call count reaches the
+  /// threshold.
+  static void notifyHot(TieredCompileLayer *Layer, TieredFunction *TF);
+
+  /// Emits \p TF through the second tier and updates its stub.
+  void recompile(TieredFunction &TF);
+
+  mutable std::mutex TieredLayerMutex;
+
+  IRLayer &FirstTierLayer;
+  IRLayer &SecondTierLayer;
+  LazyCallThroughManager &LCTMgr;
+  IndirectStubsManagerBuilder BuildIndirectStubsManager;
+  uint64_t HotCallCount;
+  PerDylibResourcesMap DylibResources;
+  SymbolLinkagePromoter PromoteSymbols;
+  std::deque<TieredFunction> Functions;
+  size_t NumRecompiledFunctions = 0;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
@@ -66,16 +66,23 @@ struct CalleeInfo {
   // added to HotnessType enum.
   uint32_t Hotness : 3;
 
+  /// The callee is a target of indirect calls in the caller that indirect
+  /// call promotion would promote, according to their value profile.
+  uint32_t IsICPTarget : 1;
+
   /// The value stored in RelBlockFreq has to be interpreted as the digits of
   /// a scaled number with a scale of \p -ScaleShift.
-  uint32_t RelBlockFreq : 29;
+  uint32_t RelBlockFreq : 28;
   static constexpr int32_t ScaleShift = 8;
-  static constexpr uint64_t MaxRelBlockFreq = (1 << 29) - 1;
+  static constexpr uint64_t MaxRelBlockFreq = (1 << 28) - 1;
 
   CalleeInfo()
-      : Hotness(static_cast<uint32_t>(HotnessType::Unknown)), RelBlockFreq(0) {}
-  explicit CalleeInfo(HotnessType Hotness, uint64_t RelBF)
-      : Hotness(static_cast<uint32_t>(Hotness)), RelBlockFreq(RelBF) {}
+      : Hotness(static_cast<uint32_t>(HotnessType::Unknown)), IsICPTarget(0),
+        RelBlockFreq(0) {}
+  explicit CalleeInfo(HotnessType Hotness, uint64_t RelBF,
+                      bool IsICPTarget = false)
+      : Hotness(static_cast<uint32_t>(Hotness)), IsICPTarget(IsICPTarget),
+        RelBlockFreq(RelBF) {}
 
   void updateHotness(const HotnessType OtherHotness) {
     Hotness = std::max(Hotness, static_cast<uint32_t>(OtherHotness));
@@ -83,6 +90,10 @@ struct CalleeInfo {
 
   HotnessType getHotness() const { return HotnessType(Hotness); }
 
+  void setICPTarget() { IsICPTarget = 1; }
+
+  bool isICPTarget() const { return IsICPTarget; }
+
   /// Update \p RelBlockFreq from \p BlockFreq and \p EntryFreq
   ///
   /// BlockFreq is divided by EntryFreq and added to RelBlockFreq. To represent
@@ -1180,7 +1191,7 @@ public:
   // in the way some record are interpreted, like flags for instance.
   // Note that incrementing this may require changes in both BitcodeReader.cpp
   // and BitcodeWriter.cpp.
-  static constexpr uint64_t BitcodeSummaryVersion = 9;
+  static constexpr uint64_t BitcodeSummaryVersion = 10;
 
   // Regular LTO module name for ASM writer
   static constexpr const char *getRegularLTOModuleName() {
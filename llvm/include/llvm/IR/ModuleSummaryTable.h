@@ -0,0 +1,129 @@
+//===- ModuleSummaryTable.h - Flat mmappable summary index ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+/// \file
+/// This file defines ModuleSummaryTable, a flat, read-only encoding of the
+/// global value summaries of a combined ModuleSummaryIndex.
+///
+/// A table consists of a header, followed by fixed size records for the
+/// modules, the summaries sorted by GUID and the call and reference edges of
+/// the summaries, and finally a string table with the module paths. Opening a
+/// table only checks its header, so it takes constant time and, on a memory
+/// mapped file, only the pages holding the summaries that are looked up are
+/// ever read. This makes it suitable for distributed ThinLTO jobs that only
+/// query a few summaries of a large combined index.
+///
+/// The table holds the flags, instruction count and edges of the summaries,
+/// but not the type identifier, virtual call or parameter access information.
+/// It is not a replacement for the bitcode encoding of the index when the
+/// full summaries are needed.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_IR_MODULESUMMARYTABLE_H
+#define LLVM_IR_MODULESUMMARYTABLE_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/ModuleSummaryIndex.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBufferRef.h"
+
+namespace llvm {
+
+class raw_ostream;
+
+class ModuleSummaryTable {
+public:
+  static const uint32_t CurrentVersion = 1;
+
+  struct Header {
+    char Magic[4];
+    support::ulittle32_t Version;
+    support::ulittle32_t NumModules;
+    support::ulittle32_t NumEntries;
+    support::ulittle32_t NumEdges;
+    support::ulittle32_t StringTableSize;
+  };
+
+  struct Module {
+    support::ulittle32_t PathOffset;
+    support::ulittle32_t PathSize;
+    support::ulittle32_t Hash[5];
+  };
+
+  /// Bits of Entry::Flags.
+  enum : uint32_t {
+    LinkageMask = 0xf,
+    LiveFlag = 1 << 4,
+    DSOLocalFlag = 1 << 5,
+    NotEligibleToImportFlag = 1 << 6,
+    CanAutoHideFlag = 1 << 7,
+    KindShift = 8,
+    KindMask = 0x3,
+  };
+
+  /// A global value summary. There is one entry per summary, so a GUID with
+  /// several copies has several consecutive entries. The edges of an entry
+  /// are its calls followed by its references; the aliasee of an alias is its
+  /// only reference.
+  struct Entry {
+    support::ulittle64_t GUID;
+    support::ulittle32_t ModuleIndex;
+    support::ulittle32_t Flags;
+    support::ulittle32_t InstCount;
+    support::ulittle32_t FirstEdge;
+    support::ulittle32_t NumCalls;
+    support::ulittle32_t NumRefs;
+
+    GlobalValue::LinkageTypes getLinkage() const {
+      return static_cast<GlobalValue::LinkageTypes>(Flags & LinkageMask);
+    }
+    GlobalValueSummary::SummaryKind getKind() const {
+      return static_cast<GlobalValueSummary::SummaryKind>(
+          (Flags >> KindShift) & KindMask);
+    }
+    bool isLive() const { return Flags & LiveFlag; }
+    bool isDSOLocal() const { return Flags & DSOLocalFlag; }
+    bool notEligibleToImport() const { return Flags & NotEligibleToImportFlag; }
+    bool canAutoHide() const { return Flags & CanAutoHideFlag; }
+  };
+
+  /// Open the table in \p Buffer, which must outlive the table.
+  static Expected<ModuleSummaryTable> create(MemoryBufferRef Buffer);
+
+  ArrayRef<Entry> entries() const { return Entries; }
+
+  /// Returns the entries of \p GUID, or an empty array if it has no summary.
+  ArrayRef<Entry> lookup(GlobalValue::GUID GUID) const;
+
+  unsigned getNumModules() const { return Modules.size(); }
+  StringRef getModulePath(unsigned ModuleIndex) const;
+  ModuleHash getModuleHash(unsigned ModuleIndex) const;
+
+  /// The GUIDs of the callees and of the values referenced by \p E. The edges
+  /// of an entry are only checked when they are accessed, and are empty if
+  /// they are out of the bounds of the table.
+  ArrayRef<support::ulittle64_t> calls(const Entry &E) const;
+  ArrayRef<support::ulittle64_t> refs(const Entry &E) const;
+
+private:
+  ArrayRef<Module> Modules;
+  ArrayRef<Entry> Entries;
+  ArrayRef<support::ulittle64_t> Edges;
+  StringRef Strings;
+};
+
+/// Write the summaries of the combined index \p Index to \p OS as a
+/// ModuleSummaryTable.
+void writeModuleSummaryTable(const ModuleSummaryIndex &Index, raw_ostream &OS);
+
+} // end namespace llvm
+
+#endif // LLVM_IR_MODULESUMMARYTABLE_H
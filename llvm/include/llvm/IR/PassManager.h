@@ -1196,6 +1196,18 @@ using ModuleAnalysisManagerFunctionProxy =
 /// Note that although function passes can access module analyses, module
 /// analyses are not invalidated while the function passes are running, so they
 /// may be stale.  Function analyses will not be stale.
+///
+/// Functions are visited in order on the calling thread. Running the pass over
+/// several functions at once additionally requires:
+///  - the uniquing tables of the LLVMContext (constants, types, metadata and
+///    attributes), which nearly every transform touches, to be safe to access
+///    from several threads, or to be split per thread;
+///  - the use lists of globals and constants, which are shared by all the
+///    functions using them, to be safe to update concurrently;
+///  - the FunctionAnalysisManager to cache and invalidate results of different
+///    functions concurrently.
+/// FIXME: None of these hold yet. Parallelism is currently only available by
+/// splitting the module into separate contexts, as done for code generation.
 class ModuleToFunctionPassAdaptor
     : public PassInfoMixin<ModuleToFunctionPassAdaptor> {
 public:
@@ -82,6 +82,13 @@ struct Config {
   /// want to know a priori all possible output files.
   bool AlwaysEmitRegularLTOObj = false;
 
+  /// Also store the object files of the regular LTO codegen partitions in the
+  /// cache passed to LTO::run, keyed by the optimized bitcode of each
+  /// partition, so that the partitions that did not change since a previous
+  /// link are not compiled again. The optimizer still runs on the whole
+  /// merged module.
+  bool CacheRegularLTO = false;
+
   /// Allows non-imported definitions to get the potentially more constraining
   /// visibility from the prevailing definition. FromPrevailing is the default
   /// because it works for many binary formats. ELF can use the more optimized
@@ -171,6 +178,11 @@ struct Config {
   /// Time trace granularity.
   unsigned TimeTraceGranularity = 500;
 
+  /// If not empty, the in-process ThinLTO backend writes a JSON report with
+  /// the wall time, heap usage, import count, optimized instruction count and
+  /// cache result of each backend job to this file, slowest job first.
+  std::string ThinLTOBackendReportFile;
+
   bool ShouldDiscardValueNames = true;
   DiagnosticHandlerFunction DiagHandler;
 
@@ -73,6 +73,12 @@ void computeLTOCacheKey(
     const std::set<GlobalValue::GUID> &CfiFunctionDefs = {},
     const std::set<GlobalValue::GUID> &CfiFunctionDecls = {});
 
+/// Computes the hash under which the object file of a regular LTO codegen
+/// partition is cached, from the optimized bitcode \p BC of the partition.
+/// The hash is produced in \p Key.
+void computeRegularLTOCacheKey(SmallString<40> &Key, const lto::Config &Conf,
+                               StringRef BC);
+
 namespace lto {
 
 /// Given the original \p Path to an output file, replace any path
@@ -197,7 +203,11 @@ using ThinBackend = std::function<std::unique_ptr<ThinBackendProc>(
 
 /// This ThinBackend runs the individual backend jobs in-process.
 /// The default value means to use one job per hardware core (not hyper-thread).
-ThinBackend createInProcessThinBackend(ThreadPoolStrategy Parallelism);
+/// If \p MemoryBudget is not zero, a job is only started once the estimated
+/// peak memory of the running jobs and of the new one fits in this many bytes,
+/// or when no other job is running.
+ThinBackend createInProcessThinBackend(ThreadPoolStrategy Parallelism,
+                                       uint64_t MemoryBudget = 0);
 
 /// This ThinBackend writes individual module indexes to files, instead of
 /// running the individual backend jobs. This backend is for distributed builds
@@ -397,7 +407,7 @@ private:
   Error addThinLTO(BitcodeModule BM, ArrayRef<InputFile::Symbol> Syms,
                    const SymbolResolution *&ResI, const SymbolResolution *ResE);
 
-  Error runRegularLTO(AddStreamFn AddStream);
+  Error runRegularLTO(AddStreamFn AddStream, FileCache Cache);
   Error runThinLTO(AddStreamFn AddStream, FileCache Cache,
                    const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols);
 
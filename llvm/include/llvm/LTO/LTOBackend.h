@@ -41,22 +41,36 @@ bool opt(const Config &Conf, TargetMachine *TM, unsigned Task, Module &Mod,
 
 /// Runs a regular LTO backend. The regular LTO backend can also act as the
 /// regular LTO phase of ThinLTO, which may need to access the combined index.
+/// If \p Cache is set, the object files of the codegen partitions are looked
+/// up in it before being compiled.
 Error backend(const Config &C, AddStreamFn AddStream,
               unsigned ParallelCodeGenParallelismLevel, Module &M,
-              ModuleSummaryIndex &CombinedIndex);
+              ModuleSummaryIndex &CombinedIndex, FileCache Cache = {});
+
+/// Costs of a ThinLTO backend job, filled in by thinBackend.
+struct ThinBackendStats {
+  /// The number of instructions of the module after optimization.
+  uint64_t OptimizedInstCount = 0;
+  /// The largest heap usage of the process seen after optimizing and after
+  /// generating code for the module. Backend jobs that run at the same time
+  /// share the heap, so this is an upper bound of the usage of this job.
+  size_t PeakMallocUsage = 0;
+};
 
 /// Runs a ThinLTO backend.
 /// If \p ModuleMap is not nullptr, all the module files to be imported have
 /// already been mapped to memory and the corresponding BitcodeModule objects
 /// are saved in the ModuleMap. If \p ModuleMap is nullptr, module files will
 /// be mapped to memory on demand and at any given time during importing, only
-/// one source module will be kept open at the most.
+/// one source module will be kept open at the most. If \p Stats is not
+/// nullptr, the costs of the job are recorded in it.
 Error thinBackend(const Config &C, unsigned Task, AddStreamFn AddStream,
                   Module &M, const ModuleSummaryIndex &CombinedIndex,
                   const FunctionImporter::ImportMapTy &ImportList,
                   const GVSummaryMapTy &DefinedGlobals,
                   MapVector<StringRef, BitcodeModule> *ModuleMap,
-                  const std::vector<uint8_t> &CmdArgs = std::vector<uint8_t>());
+                  const std::vector<uint8_t> &CmdArgs = std::vector<uint8_t>(),
+                  ThinBackendStats *Stats = nullptr);
 
 Error finalizeOptimizationRemarks(
     std::unique_ptr<ToolOutputFile> DiagOutputFile);
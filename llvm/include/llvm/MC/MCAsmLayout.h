@@ -43,6 +43,11 @@ class MCAsmLayout {
   /// Is the layout for this fragment valid?
   bool isFragmentValid(const MCFragment *F) const;
 
+  /// While recording, the section whose fragment offset queries are recorded
+  /// and the highest layout order of the queried fragments in it.
+  const MCSection *RecordedSection = nullptr;
+  mutable unsigned MaxRecordedLayoutOrder = 0;
+
 public:
   MCAsmLayout(MCAssembler &Assembler);
 
@@ -78,6 +83,21 @@ public:
   /// Get the offset of the given fragment inside its containing section.
   uint64_t getFragmentOffset(const MCFragment *F) const;
 
+  /// Start recording the offset queries for fragments in \p Sec. This is used
+  /// by relaxation to find out which fragments the size of a fragment depends
+  /// on.
+  void startRecordingOffsetQueries(const MCSection *Sec) {
+    RecordedSection = Sec;
+    MaxRecordedLayoutOrder = 0;
+  }
+
+  /// Stop recording and return the highest layout order of the fragments whose
+  /// offset was queried since startRecordingOffsetQueries(), or 0 if none.
+  unsigned stopRecordingOffsetQueries() {
+    RecordedSection = nullptr;
+    return MaxRecordedLayoutOrder;
+  }
+
   /// @}
   /// \name Utility Functions
   /// @{
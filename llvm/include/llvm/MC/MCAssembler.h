@@ -200,9 +200,9 @@ private:
   /// were adjusted.
   bool layoutOnce(MCAsmLayout &Layout);
 
-  /// Perform one layout iteration of the given section and return true
-  /// if any offsets were adjusted.
-  bool layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec);
+  /// Relax the fragments of the given section until none of them changes
+  /// size, and return true if any offsets were adjusted.
+  bool layoutSection(MCAsmLayout &Layout, MCSection &Sec);
 
   /// Perform relaxation on a single fragment - returns true if the fragment
   /// changes as a result of relaxation.
@@ -266,6 +266,12 @@ public:
   void writeSectionData(raw_ostream &OS, const MCSection *Section,
                         const MCAsmLayout &Layout) const;
 
+  /// Free the contents and fixups of the fragments of \p Section. The object
+  /// writer can call this once it has written the data of a section, to
+  /// reduce the peak memory use while the rest of the object is written. The
+  /// layout of the section cannot be recomputed after that.
+  void releaseSectionData(MCSection &Section);
+
   /// Check whether a given symbol has been flagged with .thumb_func.
   bool isThumbFunc(const MCSymbol *Func) const;
 
@@ -195,6 +195,13 @@ protected:
 public:
   SmallVectorImpl<char> &getContents() { return Contents; }
   const SmallVectorImpl<char> &getContents() const { return Contents; }
+
+  /// Free the memory of the contents, once they have been written out.
+  void releaseContents() {
+    // Moving the contents out leaves Contents with its inline storage.
+    SmallVector<char, ContentsSize> Released = std::move(Contents);
+    (void)Released;
+  }
 };
 
 /// Interface implemented by fragments that contain encoded instructions and/or
@@ -228,6 +235,14 @@ public:
   fixup_iterator fixup_end() { return Fixups.end(); }
   const_fixup_iterator fixup_end() const { return Fixups.end(); }
 
+  /// Free the memory of the contents and fixups, once the fixups have been
+  /// applied and the contents written out.
+  void releaseContentsAndFixups() {
+    this->releaseContents();
+    SmallVector<MCFixup, FixupsSize> Released = std::move(Fixups);
+    (void)Released;
+  }
+
   static bool classof(const MCFragment *F) {
     MCFragment::FragmentType Kind = F->getKind();
     return Kind == MCFragment::FT_Relaxable || Kind == MCFragment::FT_Data ||
@@ -13,6 +13,7 @@
 #ifndef LLVM_OBJECT_ARCHIVEWRITER_H
 #define LLVM_OBJECT_ARCHIVEWRITER_H
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/Object/Archive.h"
 
 namespace llvm {
@@ -22,6 +23,10 @@ struct NewArchiveMember {
   StringRef MemberName;
   sys::TimePoint<std::chrono::seconds> ModTime;
   unsigned UID = 0, GID = 0, Perms = 0644;
+  /// The names of the archive symbols defined by this member, if they are
+  /// already known, e.g. from the symbol table of the archive this member is
+  /// copied from. Otherwise the member is parsed to find them.
+  Optional<std::vector<StringRef>> Symbols;
 
   NewArchiveMember() = default;
   NewArchiveMember(MemoryBufferRef BufRef);
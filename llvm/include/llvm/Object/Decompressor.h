@@ -60,6 +60,9 @@ private:
 
   StringRef SectionData;
   uint64_t DecompressedSize;
+  /// The ch_type of the compression header, or ELFCOMPRESS_ZLIB for
+  /// gnu-styled sections.
+  uint64_t CompressionType;
 };
 
 } // end namespace object
@@ -17,6 +17,7 @@
 
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/OptBisect.h"
@@ -25,6 +26,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Transforms/IPO/SampleProfileProbe.h"
 
+#include <map>
 #include <string>
 #include <utility>
 
@@ -408,6 +410,49 @@ protected:
   bool UseColour;
 };
 
+/// Instrumentation to report, for each pass, how many cached analysis results
+/// it invalidated and how many of those had to be computed again afterwards,
+/// along with the time spent recomputing them. Analyses that a pass keeps up
+/// to date and preserves are not invalidated and do not show up. The report
+/// is printed when the instrumentation is destroyed.
+class AnalysisRecomputeReporter {
+public:
+  AnalysisRecomputeReporter(bool Enabled) : Enabled(Enabled) {}
+  ~AnalysisRecomputeReporter();
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+  void print(raw_ostream &OS) const;
+
+  /// Set a custom output stream for the report, stderr by default.
+  void setOutStream(raw_ostream &OS) { OutStream = &OS; }
+
+private:
+  struct RecomputeStats {
+    unsigned Invalidations = 0;
+    unsigned Recomputations = 0;
+    /// Wall time spent recomputing, including analyses required by the
+    /// recomputed one.
+    double Seconds = 0;
+  };
+
+  /// An analysis being computed, and the wall time at which it started.
+  struct RunningAnalysis {
+    std::string Key;
+    double Start;
+  };
+
+  /// Statistics keyed by the name of the invalidating pass and the name of
+  /// the analysis.
+  std::map<std::pair<std::string, std::string>, RecomputeStats> Stats;
+  /// For each analysis and IR unit, the pass that last invalidated its result
+  /// if it has not been recomputed since.
+  StringMap<std::string> InvalidatedBy;
+  SmallVector<RunningAnalysis, 4> Running;
+  /// The pass that ran last. Invalidation happens after a pass has run.
+  std::string LastPass;
+  raw_ostream *OutStream = nullptr;
+  bool Enabled;
+};
+
 class VerifyInstrumentation {
   bool DebugLogging;
 
@@ -505,6 +550,7 @@ class StandardInstrumentations {
   InLineChangePrinter PrintChangedDiff;
   DotCfgChangeReporter WebsiteChangeReporter;
   VerifyInstrumentation Verify;
+  AnalysisRecomputeReporter AnalysisRecomputes;
 
   bool VerifyEach;
 
@@ -28,6 +28,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 #include <cstdint>
@@ -42,9 +43,11 @@
 namespace llvm {
 
 class IndexedInstrProfReader;
+class ThreadPool;
 
 namespace coverage {
 
+class BinaryCoverageReader;
 class CoverageMappingReader;
 struct CoverageMappingRecord;
 
@@ -580,10 +583,29 @@ class CoverageMapping {
       ArrayRef<std::unique_ptr<CoverageMappingReader>> CoverageReaders,
       IndexedInstrProfReader &ProfileReader, CoverageMapping &Coverage);
 
+  // Load the coverage records of Reader, decoding them and evaluating their
+  // counters on Pool.
+  static Error loadFromReaderInParallel(const BinaryCoverageReader &Reader,
+                                        IndexedInstrProfReader &ProfileReader,
+                                        CoverageMapping &Coverage,
+                                        ThreadPool &Pool);
+
   /// Add a function record corresponding to \p Record.
   Error loadFunctionRecord(const CoverageMappingRecord &Record,
                            IndexedInstrProfReader &ProfileReader);
 
+  /// Read the counts of \p Record from the profile into \p Counts. Returns
+  /// false if the record should be ignored because its hash does not match the
+  /// profile.
+  Expected<bool> getFunctionCounts(const CoverageMappingRecord &Record,
+                                   IndexedInstrProfReader &ProfileReader,
+                                   std::vector<uint64_t> &Counts);
+
+  /// Add \p Function, built from \p Record, unless a function with the same
+  /// name and files was already added.
+  void addFunctionRecord(const CoverageMappingRecord &Record,
+                         FunctionRecord &&Function);
+
   /// Look up the indices for function records which are at least partially
   /// defined in the specified file. This is guaranteed to return a superset of
   /// such records: extra records not in the file may be included if there is
@@ -603,9 +625,12 @@ public:
   /// Load the coverage mapping from the given object files and profile. If
   /// \p Arches is non-empty, it must specify an architecture for each object.
   /// Ignores non-instrumented object files unless all are not instrumented.
+  /// With more than one thread, the objects are opened and their records
+  /// decoded in parallel. The result does not depend on the number of threads.
   static Expected<std::unique_ptr<CoverageMapping>>
   load(ArrayRef<StringRef> ObjectFilenames, StringRef ProfileFilename,
-       ArrayRef<StringRef> Arches = None, StringRef CompilationDir = "");
+       ArrayRef<StringRef> Arches = None, StringRef CompilationDir = "",
+       ThreadPoolStrategy S = hardware_concurrency(1));
 
   /// The number of functions that couldn't have their profiles mapped.
   ///
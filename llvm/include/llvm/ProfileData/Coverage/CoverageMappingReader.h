@@ -216,6 +216,17 @@ public:
                                  StringRef CompilationDir = "");
 
   Error readNextRecord(CoverageMappingRecord &Record) override;
+
+  /// Returns the number of function records.
+  size_t getNumRecords() const { return MappingRecords.size(); }
+
+  /// Decode the function record at \p Index into \p Record, whose arrays are
+  /// kept in the given vectors. Unlike readNextRecord, this can be called from
+  /// several threads at once.
+  Error readRecord(size_t Index, CoverageMappingRecord &Record,
+                   std::vector<StringRef> &FunctionsFilenames,
+                   std::vector<CounterExpression> &Expressions,
+                   std::vector<CounterMappingRegion> &MappingRegions) const;
 };
 
 /// Reader for the raw coverage filenames.
@@ -160,6 +160,18 @@ inline StringRef getInstrProfCounterBiasVarName() {
   return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_BIAS_VAR);
 }
 
+/// Return the name of the table of offsets of the counter shards from the
+/// counters.
+inline StringRef getInstrProfCounterShardBiasesVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_SHARD_BIASES_VAR);
+}
+
+/// Return the name of the thread-local variable whose address selects the
+/// counter shard of a thread.
+inline StringRef getInstrProfCounterShardAnchorVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_SHARD_ANCHOR_VAR);
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
@@ -295,9 +307,24 @@ enum class InstrProfKind {
   FunctionEntryOnly = 0x20,
   // A memory profile collected using -fprofile=memory.
   MemProf = 0x40,
-  LLVM_MARK_AS_BITMASK_ENUM(/*LargestValue=*/MemProf)
+  // A raw profile whose first counter of each function is the time of its
+  // first call.
+  TemporalProfile = 0x80,
+  LLVM_MARK_AS_BITMASK_ENUM(/*LargestValue=*/TemporalProfile)
 };
 
+/// The names of the functions of a profile, in the order they were first
+/// called.
+using TemporalProfTraceTy = std::vector<std::string>;
+
+/// Order the functions of the temporal profile \c Traces so that the
+/// functions called early in most traces come first. Functions are sorted by
+/// their average position in the traces, relative to the length of each
+/// trace. A function missing from a trace counts as being at its end. The
+/// functions that are not in any trace are not part of the order.
+std::vector<std::string>
+getTemporalProfFunctionOrder(ArrayRef<TemporalProfTraceTy> Traces);
+
 const std::error_category &instrprof_category();
 
 enum class instrprof_error {
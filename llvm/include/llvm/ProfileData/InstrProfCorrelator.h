@@ -6,7 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 // This file defines InstrProfCorrelator used to generate PGO profiles from
-// raw profile data and debug info.
+// raw profile data and debug info, or the profile data sections of a binary.
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_PROFILEDATA_INSTRPROFCORRELATOR_H
@@ -29,12 +29,22 @@ class ObjectFile;
 /// to their functions.
 class InstrProfCorrelator {
 public:
+  /// The source of the data used to correlate the profiles.
+  enum ProfCorrelatorKind {
+    /// The annotated counter variables of the DWARF debug info.
+    DEBUG_INFO,
+    /// The profile data and names sections that are emitted with
+    /// -binary-correlate, and are not loaded at run time.
+    BINARY,
+  };
+
   static llvm::Expected<std::unique_ptr<InstrProfCorrelator>>
-  get(StringRef DebugInfoFilename);
+  get(StringRef Filename, ProfCorrelatorKind FileKind = DEBUG_INFO);
 
   /// Construct a ProfileData vector used to correlate raw instrumentation data
-  /// to their functions.
-  virtual Error correlateProfileData() = 0;
+  /// to their functions. The DWARF units are searched with up to
+  /// \p NumThreads threads, where 0 means one per hardware thread.
+  virtual Error correlateProfileData(unsigned NumThreads = 1) = 0;
 
   /// Return the number of ProfileData elements.
   llvm::Optional<size_t> getDataSize() const;
@@ -61,11 +71,16 @@ public:
 protected:
   struct Context {
     static llvm::Expected<std::unique_ptr<Context>>
-    get(std::unique_ptr<MemoryBuffer> Buffer, const object::ObjectFile &Obj);
+    get(std::unique_ptr<MemoryBuffer> Buffer, const object::ObjectFile &Obj,
+        ProfCorrelatorKind FileKind);
     std::unique_ptr<MemoryBuffer> Buffer;
     /// The address range of the __llvm_prf_cnts section.
     uint64_t CountersSectionStart;
     uint64_t CountersSectionEnd;
+    /// The contents of the __llvm_covdata and __llvm_covnames sections, when
+    /// correlating with the binary.
+    StringRef DataSection;
+    StringRef NamesSection;
     /// True if target and host have different endian orders.
     bool ShouldSwapBytes;
   };
@@ -79,7 +94,7 @@ protected:
 
 private:
   static llvm::Expected<std::unique_ptr<InstrProfCorrelator>>
-  get(std::unique_ptr<MemoryBuffer> Buffer);
+  get(std::unique_ptr<MemoryBuffer> Buffer, ProfCorrelatorKind FileKind);
 
   const InstrProfCorrelatorKind Kind;
 };
@@ -103,27 +118,32 @@ public:
 
   static llvm::Expected<std::unique_ptr<InstrProfCorrelatorImpl<IntPtrT>>>
   get(std::unique_ptr<InstrProfCorrelator::Context> Ctx,
-      const object::ObjectFile &Obj);
+      const object::ObjectFile &Obj, ProfCorrelatorKind FileKind);
 
 protected:
   std::vector<RawInstrProf::ProfileData<IntPtrT>> Data;
 
-  Error correlateProfileData() override;
-  virtual void correlateProfileDataImpl() = 0;
+  Error correlateProfileData(unsigned NumThreads) override;
+  virtual void correlateProfileDataImpl(unsigned NumThreads) = 0;
 
   void addProbe(StringRef FunctionName, uint64_t CFGHash, IntPtrT CounterOffset,
                 IntPtrT FunctionPtr, uint32_t NumCounters);
 
-private:
-  InstrProfCorrelatorImpl(InstrProfCorrelatorKind Kind,
-                          std::unique_ptr<InstrProfCorrelator::Context> Ctx)
-      : InstrProfCorrelator(Kind, std::move(Ctx)){};
-  llvm::DenseSet<IntPtrT> CounterOffsets;
+  /// Add a probe whose name is already in the Names string, and return false
+  /// if one was already added for this counter offset.
+  bool addDataProbe(uint64_t NameRef, uint64_t CFGHash, IntPtrT CounterOffset,
+                    IntPtrT FunctionPtr, uint32_t NumCounters);
 
   // Byte-swap the value if necessary.
   template <class T> T maybeSwap(T Value) const {
     return Ctx->ShouldSwapBytes ? sys::getSwappedBytes(Value) : Value;
   }
+
+private:
+  InstrProfCorrelatorImpl(InstrProfCorrelatorKind Kind,
+                          std::unique_ptr<InstrProfCorrelator::Context> Ctx)
+      : InstrProfCorrelator(Kind, std::move(Ctx)){};
+  llvm::DenseSet<IntPtrT> CounterOffsets;
 };
 
 /// DwarfInstrProfCorrelator - A child of InstrProfCorrelatorImpl that takes
@@ -139,6 +159,17 @@ public:
 private:
   std::unique_ptr<DWARFContext> DICtx;
 
+  struct Probe {
+    const char *FunctionName;
+    uint64_t CFGHash;
+    IntPtrT CounterOffset;
+    IntPtrT FunctionPtr;
+    uint32_t NumCounters;
+  };
+
+  /// Return the probe that the provided DIE symbolizes, if any.
+  llvm::Optional<Probe> getProbe(const DWARFDie &Die) const;
+
   /// Return the address of the object that the provided DIE symbolizes.
   llvm::Optional<uint64_t> getLocation(const DWARFDie &Die) const;
 
@@ -147,7 +178,9 @@ private:
   static bool isDIEOfProbe(const DWARFDie &Die);
 
   /// Iterate over DWARF DIEs to find those that symbolize instrumentation
-  /// probes and construct the ProfileData vector and Names string.
+  /// probes and construct the ProfileData vector and Names string. The units
+  /// are searched in parallel, and their probes added in order, so the result
+  /// does not depend on the number of threads.
   ///
   /// Here is some example DWARF for an instrumentation probe we are looking
   /// for:
@@ -171,7 +204,24 @@ private:
   ///       NULL
   ///     NULL
   /// \endcode
-  void correlateProfileDataImpl() override;
+  void correlateProfileDataImpl(unsigned NumThreads) override;
+};
+
+/// BinaryInstrProfCorrelator - A child of InstrProfCorrelatorImpl that reads
+/// the profile data and names from the sections of the binary that are not
+/// loaded, so that neither debug info nor the names have to be shipped in the
+/// instrumented binary.
+template <class IntPtrT>
+class BinaryInstrProfCorrelator : public InstrProfCorrelatorImpl<IntPtrT> {
+public:
+  BinaryInstrProfCorrelator(std::unique_ptr<InstrProfCorrelator::Context> Ctx)
+      : InstrProfCorrelatorImpl<IntPtrT>(std::move(Ctx)) {}
+
+private:
+  /// Copy the records of the __llvm_covdata section, turning their counter
+  /// addresses into offsets in the counters section, and use the contents of
+  /// the __llvm_covnames section as the Names string.
+  void correlateProfileDataImpl(unsigned NumThreads) override;
 };
 
 } // end namespace llvm
@@ -118,6 +118,17 @@ public:
   /// Return true if the profile only instruments function entries.
   virtual bool functionEntryOnly() const = 0;
 
+  /// Return true if the profile records the time of the first call of each
+  /// function.
+  virtual bool hasTemporalProfile() const { return false; }
+
+  /// Return the temporal profile traces of the profiles read so far, one for
+  /// each raw profile. This is only complete once the reader hit the end of
+  /// the data.
+  ArrayRef<TemporalProfTraceTy> getTemporalProfTraces() const {
+    return TemporalProfTraces;
+  }
+
   /// Returns a BitsetEnum describing the attributes of the profile. To check
   /// individual attributes prefer using the helpers above.
   virtual InstrProfKind getProfileKind() const = 0;
@@ -139,6 +150,7 @@ public:
 
 protected:
   std::unique_ptr<InstrProfSymtab> Symtab;
+  std::vector<TemporalProfTraceTy> TemporalProfTraces;
 
   /// Set the current error and return same.
   Error error(instrprof_error Err, const std::string &ErrMsg = "") {
@@ -284,6 +296,10 @@ private:
   uint64_t BinaryIdsSize;
   const uint8_t *BinaryIdsStart;
 
+  /// The first call times and names of the called functions of the current
+  /// raw profile, if it is a temporal profile.
+  std::vector<std::pair<uint64_t, std::string>> TemporalProfTimestamps;
+
 public:
   RawInstrProfReader(std::unique_ptr<MemoryBuffer> DataBuffer,
                      const InstrProfCorrelator *Correlator)
@@ -322,6 +338,10 @@ public:
     return (Version & VARIANT_MASK_FUNCTION_ENTRY_ONLY) != 0;
   }
 
+  bool hasTemporalProfile() const override {
+    return (Version & VARIANT_MASK_TEMPORAL_PROF) != 0;
+  }
+
   /// Returns a BitsetEnum describing the attributes of the raw instr profile.
   InstrProfKind getProfileKind() const override;
 
@@ -355,8 +375,9 @@ private:
 
   Error readName(NamedInstrProfRecord &Record);
   Error readFuncHash(NamedInstrProfRecord &Record);
-  Error readRawCounts(InstrProfRecord &Record);
+  Error readRawCounts(NamedInstrProfRecord &Record);
   Error readValueProfilingData(InstrProfRecord &Record);
+  void finishTemporalProfTrace();
   bool atEnd() const { return Data == DataEnd; }
 
   void advanceData() {
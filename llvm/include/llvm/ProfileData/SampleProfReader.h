@@ -243,6 +243,7 @@
 #include <memory>
 #include <string>
 #include <system_error>
+#include <tuple>
 #include <unordered_set>
 #include <vector>
 
@@ -708,8 +709,22 @@ protected:
   std::error_code readMD5NameTable();
   std::error_code readNameTableSec(bool IsMD5);
   std::error_code readCSNameTableSec();
+  std::error_code readCSNameTableEntry(SampleContextFrameVector &Context);
   std::error_code readProfileSymbolList();
 
+  /// A frame of a context of the CS name table: the index of its function in
+  /// the name table, and its line offset and discriminator.
+  using RawContextFrame = std::tuple<uint32_t, uint64_t, uint64_t>;
+  /// Read the frames of context \p Idx of the CS name table without
+  /// materializing their names.
+  std::error_code readRawContext(uint32_t Idx,
+                                 SmallVectorImpl<RawContextFrame> &Frames);
+  /// Return the MD5 of name \p Idx of a fixed length MD5 name table.
+  ErrorOr<uint64_t> readFixedLengthMD5(uint32_t Idx);
+  /// Return name \p Idx of a fixed length MD5 name table, converting it to a
+  /// string the first time it is accessed.
+  ErrorOr<StringRef> readFixedLengthMD5Name(uint32_t Idx);
+
   virtual std::error_code readHeader() override;
   virtual std::error_code verifySPMagic(uint64_t Magic) override = 0;
   virtual std::error_code readOneSection(const uint8_t *Start, uint64_t Size,
@@ -719,6 +734,9 @@ protected:
   virtual ErrorOr<StringRef> readStringFromTable() override;
   virtual ErrorOr<SampleContext> readSampleContextFromTable() override;
   ErrorOr<SampleContextFrames> readContextFromTable();
+  /// Read a context like readSampleContextFromTable, but return None without
+  /// materializing it if no profile that was read can refer to it.
+  ErrorOr<Optional<SampleContext>> readSampleContextOfReadProfile();
 
   std::unique_ptr<ProfileSymbolList> ProfSymList;
 
@@ -730,8 +748,16 @@ protected:
   std::unique_ptr<std::vector<std::pair<SampleContext, uint64_t>>>
       OrderedFuncOffsets;
 
+  /// Function offset mapping of a CS profile keyed by the indices of the
+  /// contexts in the CS name table, in the order of the table. Used instead of
+  /// OrderedFuncOffsets when only the functions of a module are loaded, so
+  /// that the contexts of the other functions are never materialized.
+  std::vector<std::pair<uint32_t, uint64_t>> OrderedCSFuncOffsets;
+
   /// The set containing the functions to use when compiling a module.
   DenseSet<StringRef> FuncsToUse;
+  /// The GUIDs of FuncsToUse, if the names in the profile are MD5 numbers.
+  DenseSet<uint64_t> FuncGuidsToUse;
 
   /// Use fixed length MD5 instead of ULEB128 encoding so NameTable doesn't
   /// need to be read in up front and can be directly accessed using index.
@@ -749,8 +775,12 @@ protected:
   std::unique_ptr<std::vector<std::string>> MD5StringBuf;
 
   /// CSNameTable is used to save full context vectors. This serves as an
-  /// underlying immutable buffer for all clients.
-  std::unique_ptr<const std::vector<SampleContextFrameVector>> CSNameTable;
+  /// underlying buffer for all clients. Its size is fixed when the section is
+  /// read, but a context is only materialized when it is first used, from the
+  /// start of its entry in CSNameTableEntries.
+  std::unique_ptr<std::vector<SampleContextFrameVector>> CSNameTable;
+  std::vector<const uint8_t *> CSNameTableEntries;
+  const uint8_t *CSNameTableEnd = nullptr;
 
   /// If SkipFlatProf is true, skip the sections with
   /// SecFlagFlat flag.
@@ -34,6 +34,12 @@ public:
     /// Don't use mmap and instead write an in-memory buffer to a file when this
     /// buffer is closed.
     F_no_mmap = 2,
+
+    /// Reserve the disk space for the whole file when the buffer is created,
+    /// where the file system supports it. Running out of space is then
+    /// reported by create() rather than by a crash while the memory-mapped
+    /// buffer is being written, and the file is less fragmented.
+    F_preallocate = 4,
   };
 
   /// Factory method to create an OutputBuffer object which manages a read/write
@@ -67,6 +73,13 @@ public:
   /// initially requested.
   virtual Error commit() = 0;
 
+  /// Tells the buffer that [\p Offset, \p Offset + \p Size) won't be modified
+  /// anymore. A buffer backed by a file may then start writing that range to
+  /// disk in the background while the rest of the buffer is being filled in,
+  /// rather than leaving all of it to the OS after commit(). This is only a
+  /// hint, other buffers ignore it.
+  virtual void writeback(size_t Offset, size_t Size) {}
+
   /// If this object was previously committed, the destructor just deletes
   /// this object.  If this object was not committed, the destructor
   /// deallocates the buffer and the target file is never written.
@@ -426,6 +426,30 @@ inline std::error_code resize_file_before_mapping_readwrite(int FD,
 #endif
 }
 
+/// Reserve disk space for the first \p Size bytes of \p FD, growing the file
+/// if it is smaller. Writing to that range, including through a mapping, then
+/// can't fail for lack of space.
+///
+/// @param FD Input file descriptor.
+/// @param Size Number of bytes to reserve.
+/// @returns errc::success if the space has been reserved,
+///          errc::function_not_supported if the platform can't do it without
+///          writing to the file, otherwise a platform-specific error_code.
+std::error_code preallocate_file(int FD, uint64_t Size);
+
+/// Start writing the modified pages of \p FD in [\p Offset, \p Offset + \p
+/// Size) back to disk, including the pages modified through a
+/// mapped_file_region::readwrite mapping. This doesn't wait for the writes to
+/// complete.
+///
+/// @param FD Input file descriptor.
+/// @param Offset Offset of the first byte to write back.
+/// @param Size Number of bytes to write back.
+/// @returns errc::success if the writes have been started,
+///          errc::function_not_supported if the platform can't do it, otherwise
+///          a platform-specific error_code.
+std::error_code start_writeback(int FD, uint64_t Offset, uint64_t Size);
+
 /// Compute an MD5 hash of a file's contents.
 ///
 /// @param FD Input file descriptor.
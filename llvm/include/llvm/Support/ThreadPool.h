@@ -13,26 +13,34 @@
 #ifndef LLVM_SUPPORT_THREADPOOL_H
 #define LLVM_SUPPORT_THREADPOOL_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/thread.h"
 
 #include <future>
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <utility>
 
 namespace llvm {
 
+class ThreadPoolTaskGroup;
+
 /// A ThreadPool for asynchronous parallel execution on a defined number of
 /// threads.
 ///
 /// The pool keeps a vector of threads alive, waiting on a condition variable
 /// for some work to become available.
+///
+/// Tasks are run in the order they were submitted, except that tasks of a
+/// ThreadPoolTaskGroup with a higher priority are run before tasks with a
+/// lower one. Tasks that don't belong to a group have priority 0.
 class ThreadPool {
 public:
   /// Construct a pool using the hardware strategy \p S for mapping hardware
@@ -57,13 +65,41 @@ public:
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   template <typename Func>
   auto async(Func &&F) -> std::shared_future<decltype(F())> {
-    return asyncImpl(std::function<decltype(F())()>(std::forward<Func>(F)));
+    return asyncImpl(std::function<decltype(F())()>(std::forward<Func>(F)),
+                     nullptr);
+  }
+
+  /// Like async() above, but the task belongs to the given group of tasks.
+  template <typename Function, typename... Args>
+  inline auto async(ThreadPoolTaskGroup &Group, Function &&F,
+                    Args &&...ArgList) {
+    auto Task =
+        std::bind(std::forward<Function>(F), std::forward<Args>(ArgList)...);
+    return async(Group, std::move(Task));
+  }
+
+  /// Like async() above, but the task belongs to the given group of tasks.
+  template <typename Func>
+  auto async(ThreadPoolTaskGroup &Group, Func &&F)
+      -> std::shared_future<decltype(F())> {
+    return asyncImpl(std::function<decltype(F())()>(std::forward<Func>(F)),
+                     &Group);
   }
 
   /// Blocking wait for all the threads to complete and the queue to be empty.
   /// It is an error to try to add new tasks while blocking on this call.
+  /// Calling this function from a task (from a thread pool thread) will
+  /// deadlock.
   void wait();
 
+  /// Blocking wait for only all the tasks of the given group to complete.
+  /// It is possible to wait even inside a task of another group. When called
+  /// from a task, the calling thread runs queued tasks while waiting instead
+  /// of blocking, so that waiting from within the pool cannot deadlock and
+  /// does not leave the thread idle. Waiting for a group from one of its own
+  /// tasks is an error and deadlocks.
+  void wait(ThreadPoolTaskGroup &Group);
+
   // TODO: misleading legacy name warning!
   // Returns the maximum number of worker threads in the pool, not the current
   // number of threads!
@@ -78,7 +114,8 @@ private:
   /// result.
   template <typename ResTy>
   static std::pair<std::function<void()>, std::future<ResTy>>
-  createTaskAndFuture(std::function<ResTy()> Task) {
+  createTaskAndFuture(std::function<ResTy()> Task,
+                      ThreadPoolTaskGroup * /*Group*/) {
     std::shared_ptr<std::promise<ResTy>> Promise =
         std::make_shared<std::promise<ResTy>>();
     auto F = Promise->get_future();
@@ -86,29 +123,39 @@ private:
         [Promise = std::move(Promise), Task]() { Promise->set_value(Task()); },
         std::move(F)};
   }
+  /// Tasks returning void are skipped if their group has been cancelled by
+  /// the time they would start, and their future becomes ready.
   static std::pair<std::function<void()>, std::future<void>>
-  createTaskAndFuture(std::function<void()> Task) {
-    std::shared_ptr<std::promise<void>> Promise =
-        std::make_shared<std::promise<void>>();
-    auto F = Promise->get_future();
-    return {[Promise = std::move(Promise), Task]() {
-              Task();
-              Promise->set_value();
-            },
-            std::move(F)};
-  }
+  createTaskAndFuture(std::function<void()> Task, ThreadPoolTaskGroup *Group);
+
+  /// Returns true if all tasks in the given group have finished (nullptr means
+  /// all tasks regardless of their group). QueueLock must be locked.
+  bool workCompletedUnlocked(ThreadPoolTaskGroup *Group) const;
+
+  /// A task waiting in the queue.
+  struct QueuedTask {
+    std::function<void()> Run;
+    ThreadPoolTaskGroup *Group;
+    int Priority;
+  };
 
-  bool workCompletedUnlocked() { return !ActiveThreads && Tasks.empty(); }
+  /// Insert \p Task into the queue after all the tasks with the same or a
+  /// higher priority. QueueLock must be locked.
+  void enqueueUnlocked(QueuedTask Task);
+
+  /// Returns the priority of the tasks of \p Group.
+  static int getPriority(ThreadPoolTaskGroup *Group);
 
   /// Asynchronous submission of a task to the pool. The returned future can be
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   template <typename ResTy>
-  std::shared_future<ResTy> asyncImpl(std::function<ResTy()> Task) {
+  std::shared_future<ResTy> asyncImpl(std::function<ResTy()> Task,
+                                      ThreadPoolTaskGroup *Group) {
 
 #if LLVM_ENABLE_THREADS
     /// Wrap the Task in a std::function<void()> that sets the result of the
     /// corresponding future.
-    auto R = createTaskAndFuture(Task);
+    auto R = createTaskAndFuture(Task, Group);
 
     int requestedThreads;
     {
@@ -117,7 +164,7 @@ private:
 
       // Don't allow enqueueing after disabling the pool
       assert(EnableFlag && "Queuing a thread during ThreadPool destruction");
-      Tasks.push(std::move(R.first));
+      enqueueUnlocked({std::move(R.first), Group, getPriority(Group)});
       requestedThreads = ActiveThreads + Tasks.size();
     }
     QueueCondition.notify_one();
@@ -130,7 +177,7 @@ private:
     auto Future = std::async(std::launch::deferred, std::move(Task)).share();
     // Wrap the future so that both ThreadPool::wait() can operate and the
     // returned future can be sync'ed on.
-    Tasks.push([Future]() { Future.get(); });
+    enqueueUnlocked({[Future]() { Future.get(); }, Group, getPriority(Group)});
     return Future;
 #endif
   }
@@ -139,6 +186,11 @@ private:
   // Grow to ensure that we have at least `requested` Threads, but do not go
   // over MaxThreadCount.
   void grow(int requested);
+
+  /// Run tasks from the queue until the pool is destroyed or, if
+  /// \p WaitingForGroup is not null, until all the tasks of that group have
+  /// finished.
+  void processTasks(ThreadPoolTaskGroup *WaitingForGroup);
 #endif
 
   /// Threads in flight
@@ -146,8 +198,8 @@ private:
   /// Lock protecting access to the Threads vector.
   mutable std::mutex ThreadsLock;
 
-  /// Tasks waiting for execution in the pool.
-  std::queue<std::function<void()>> Tasks;
+  /// Tasks waiting for execution in the pool, highest priority first.
+  std::deque<QueuedTask> Tasks;
 
   /// Locking and signaling for accessing the Tasks queue.
   std::mutex QueueLock;
@@ -159,6 +211,11 @@ private:
   /// Keep track of the number of thread actually busy
   unsigned ActiveThreads = 0;
 
+#if LLVM_ENABLE_THREADS // avoids warning for unused variable
+  /// Number of threads active for tasks in the given group (only non-zero).
+  DenseMap<ThreadPoolTaskGroup *, unsigned> ActiveGroups;
+#endif
+
 #if LLVM_ENABLE_THREADS // avoids warning for unused variable
   /// Signal for the destruction of the pool, asking thread to exit.
   bool EnableFlag = true;
@@ -169,6 +226,52 @@ private:
   /// Maximum number of threads to potentially grow this pool to.
   const unsigned MaxThreadCount;
 };
-}
+
+/// A group of tasks to be run on a thread pool. Thread pool tasks in different
+/// groups can run on the same threadpool but can be waited for separately.
+/// It is even possible for tasks of one group to submit and wait for tasks
+/// of another group, as long as this does not form a loop.
+///
+/// Tasks of a group with a higher priority are started before the tasks of
+/// groups with a lower priority that are still queued.
+///
+/// A group can be cancelled. Cancellation is cooperative: queued tasks
+/// returning void are not started anymore, while running tasks and tasks
+/// returning a value are expected to check isCancelled() and finish early.
+class ThreadPoolTaskGroup {
+public:
+  /// The ThreadPool argument is the thread pool to forward calls to.
+  ThreadPoolTaskGroup(ThreadPool &Pool, int Priority = 0)
+      : Pool(Pool), Priority(Priority) {}
+
+  /// Blocking destructor: will wait for all the tasks in the group to complete
+  /// by calling ThreadPool::wait().
+  ~ThreadPoolTaskGroup() { wait(); }
+
+  /// Calls ThreadPool::async() for this group.
+  template <typename Function, typename... Args>
+  inline auto async(Function &&F, Args &&...ArgList) {
+    return Pool.async(*this, std::forward<Function>(F),
+                      std::forward<Args>(ArgList)...);
+  }
+
+  /// Calls ThreadPool::wait() for this group.
+  void wait() { Pool.wait(*this); }
+
+  /// Ask the tasks of this group to stop. See the class comment.
+  void cancel() { Cancelled.store(true, std::memory_order_relaxed); }
+
+  /// Returns true if cancel() has been called for this group.
+  bool isCancelled() const { return Cancelled.load(std::memory_order_relaxed); }
+
+  int getPriority() const { return Priority; }
+
+private:
+  ThreadPool &Pool;
+  const int Priority;
+  std::atomic<bool> Cancelled{false};
+};
+
+} // namespace llvm
 
 #endif // LLVM_SUPPORT_THREADPOOL_H
@@ -10,7 +10,10 @@
 #define LLVM_SUPPORT_TIMEPROFILER_H
 
 #include "llvm/Support/Error.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
+#include <functional>
+#include <utility>
 
 namespace llvm {
 
@@ -60,6 +63,29 @@ void timeTraceProfilerBegin(StringRef Name,
 /// Manually end the last time section.
 void timeTraceProfilerEnd();
 
+/// Record the current values of the counter \p Name, e.g. the number of bytes
+/// held by a set of allocators. Each value is a separate series of the
+/// counter, and shows up as a graph in trace viewers.
+void timeTraceProfilerCounter(
+    StringRef Name, ArrayRef<std::pair<StringRef, int64_t>> Values);
+
+/// How a metric registered with timeTraceProfilerAddMetric is reported.
+enum class TimeTraceMetricKind {
+  /// The change of the metric between the beginning and the end of an entry,
+  /// e.g. the number of bytes allocated within it.
+  Delta,
+  /// The value of the metric at the beginning of an entry, e.g. a nesting
+  /// depth.
+  Value,
+};
+
+/// Sample \p Sample at the beginning and end of every time section recorded by
+/// the profiler of the current thread, and write the result to the "args" of
+/// the section as \p Name. Zero results are omitted.
+void timeTraceProfilerAddMetric(StringRef Name,
+                                std::function<int64_t()> Sample,
+                                TimeTraceMetricKind Kind);
+
 /// The TimeTraceScope is a helper class to call the begin and end functions
 /// of the time trace profiler.  When the object is constructed, it begins
 /// the section; and when it is destroyed, it stops it. If the time profiler
@@ -13,6 +13,9 @@
 #ifndef LLVM_TABLEGEN_MAIN_H
 #define LLVM_TABLEGEN_MAIN_H
 
+#include "llvm/ADT/ArrayRef.h"
+#include <functional>
+
 namespace llvm {
 
 class raw_ostream;
@@ -24,6 +27,12 @@ using TableGenMainFn = bool (raw_ostream &OS, RecordKeeper &Records);
 
 int TableGenMain(const char *argv0, TableGenMainFn *MainFn);
 
+/// Perform several actions using one parse of the records. The output of the
+/// first action is written to the file given by -o, the output of each further
+/// action to the corresponding file given by -extra-o.
+int TableGenMain(const char *argv0,
+                 ArrayRef<std::function<TableGenMainFn>> MainFns);
+
 } // end namespace llvm
 
 #endif // LLVM_TABLEGEN_MAIN_H
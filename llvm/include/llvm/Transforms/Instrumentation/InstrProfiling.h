@@ -69,6 +69,9 @@ private:
   // vector of counter load/store pairs to be register promoted.
   std::vector<LoadStorePair> PromotionCandidates;
 
+  // The bias of the counter shard of the thread, for each function.
+  DenseMap<const Function *, Value *> CounterShardBiases;
+
   int64_t TotalCountersPromoted = 0;
 
   /// Lower instrumentation intrinsics in the function. Returns true if there
@@ -81,6 +84,9 @@ private:
   /// Returns true if relocating counters at runtime is enabled.
   bool isRuntimeCounterRelocationEnabled() const;
 
+  /// Returns true if threads update their own copies of the counters.
+  bool isCounterShardingEnabled() const;
+
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
@@ -93,6 +99,10 @@ private:
   /// Replace instrprof.cover with a store instruction to the coverage byte.
   void lowerCover(InstrProfCoverInst *Inc);
 
+  /// Replace instrprof.timestamp with a call to
+  /// INSTR_PROF_PROFILE_SET_TIMESTAMP.
+  void lowerTimestamp(InstrProfTimestampInst *TimestampInstruction);
+
   /// Replace instrprof.increment with an increment of the appropriate value.
   void lowerIncrement(InstrProfIncrementInst *Inc);
 
@@ -103,6 +113,10 @@ private:
   /// acts on.
   Value *getCounterAddress(InstrProfInstBase *I);
 
+  /// Compute the offset of the counters of the current thread from the
+  /// counters in the entry block of \p Fn.
+  Value *getCounterShardBias(Function *Fn);
+
   /// Get the region counters for an increment, creating them if necessary.
   ///
   /// If the counter array doesn't yet exist, the profile data variables
@@ -16,6 +16,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Pass.h"
+#include <string>
 
 namespace llvm {
 
@@ -42,6 +43,26 @@ public:
   static bool isRequired() { return true; }
 };
 
+/// Annotates the allocation calls with the behavior of the allocations they
+/// made in a memory profile.
+///
+/// The allocations are matched to the calls on their allocation site, i.e. the
+/// innermost frames of their call stacks, using the debug locations of the
+/// calls. Each call gets a "memprof" attribute with the hotness of its
+/// allocations ("cold", "notcold" or "hot"), and a "memprof-lifetime" one with
+/// their lifetime ("short" or "long"), if all the allocations made by the call
+/// agree. Optionally, calls to operator new are then replaced by calls to its
+/// variants taking a __hot_cold_t hint, for allocators to place the cold
+/// allocations apart from the hot ones.
+class MemProfUsePass : public PassInfoMixin<MemProfUsePass> {
+public:
+  explicit MemProfUsePass(std::string MemoryProfileFile = "");
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+
+private:
+  std::string MemoryProfileFileName;
+};
+
 // Insert MemProfiler instrumentation
 FunctionPass *createMemProfilerFunctionPass();
 ModulePass *createModuleMemProfilerLegacyPassPass();
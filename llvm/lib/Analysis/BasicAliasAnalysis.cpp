@@ -74,6 +74,12 @@ STATISTIC(SearchLimitReached, "Number of times the limit to "
                               "decompose GEPs is reached");
 STATISTIC(SearchTimes, "Number of times a GEP is decomposed");
 
+/// AliasCacheHits / AliasCacheMisses show how often a (possibly recursive)
+/// query is answered from the cache of its AAQueryInfo, which lives as long as
+/// the BatchAAResults or the single top-level query it belongs to.
+STATISTIC(AliasCacheHits, "Number of alias queries answered from the cache");
+STATISTIC(AliasCacheMisses, "Number of alias queries not in the cache");
+
 /// Cutoff after which to stop analysing a set of phi nodes potentially involved
 /// in a cycle. Because we are analysing 'through' phi nodes, we need to be
 /// careful with value equivalence. We use reachability to make sure a value
@@ -1641,6 +1647,7 @@ AliasResult BasicAAResult::aliasCheck(const Value *V1, LocationSize V1Size,
   const auto &Pair = AAQI.AliasCache.try_emplace(
       Locs, AAQueryInfo::CacheEntry{AliasResult::NoAlias, 0});
   if (!Pair.second) {
+    ++AliasCacheHits;
     auto &Entry = Pair.first->second;
     if (!Entry.isDefinitive()) {
       // Remember that we used an assumption.
@@ -1653,6 +1660,7 @@ AliasResult BasicAAResult::aliasCheck(const Value *V1, LocationSize V1Size,
     return Result;
   }
 
+  ++AliasCacheMisses;
   int OrigNumAssumptionUses = AAQI.NumAssumptionUses;
   unsigned OrigNumAssumptionBasedResults = AAQI.AssumptionBasedResults.size();
   AliasResult Result =
@@ -0,0 +1,59 @@
+//===- CompileTimeBudget.cpp - Per-function compile time budgets ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/CompileTimeBudget.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/CommandLine.h"
+#include <algorithm>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "compile-time-budget"
+
+STATISTIC(NumBudgetsExhausted,
+          "Number of functions that exhausted a compile time budget");
+
+static cl::opt<unsigned> CompileTimeBudgetPerInst(
+    "compile-time-budget", cl::Hidden, cl::init(0),
+    cl::desc("Units of work that an analysis using a compile time budget may "
+             "spend on a function per instruction in it (default = 0, "
+             "unlimited)"));
+
+/// Small functions get the budget of a function of this size, so that they
+/// are never limited in practice.
+static const uint64_t MinBudgetInstructions = 1000;
+
+bool CompileTimeBudget::isEnabled() { return CompileTimeBudgetPerInst != 0; }
+
+bool CompileTimeBudget::consumeSlow(const Function &F, uint64_t Cost) {
+  if (CurrentFn != &F) {
+    CurrentFn = &F;
+    Exhausted = false;
+    Remaining = CompileTimeBudgetPerInst *
+                std::max<uint64_t>(F.getInstructionCount(),
+                                   MinBudgetInstructions);
+  }
+  if (Exhausted)
+    return false;
+  if (Cost <= Remaining) {
+    Remaining -= Cost;
+    return true;
+  }
+
+  Exhausted = true;
+  ++NumBudgetsExhausted;
+  F.getContext().diagnose(OptimizationRemarkAnalysis(PassName,
+                                                     "BudgetExhausted", &F)
+                          << "compile time budget for " << What
+                          << " exhausted, giving conservative answers for "
+                             "the rest of the function");
+  return false;
+}
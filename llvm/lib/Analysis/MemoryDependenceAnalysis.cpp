@@ -194,7 +194,7 @@ MemDepResult MemoryDependenceResults::getCallDependencyFrom(
     // Limit the amount of scanning we do so we don't end up with quadratic
     // running time on extreme testcases.
     --Limit;
-    if (!Limit)
+    if (!Limit || !Budget.consume(*BB->getParent()))
       return MemDepResult::getUnknown();
 
     // If this inst is a memory op, get the pointer it accessed
@@ -432,7 +432,7 @@ MemDepResult MemoryDependenceResults::getSimplePointerDependencyFrom(
     // Limit the amount of scanning we do so we don't end up with quadratic
     // running time on extreme testcases.
     --*Limit;
-    if (!*Limit)
+    if (!*Limit || !Budget.consume(*BB->getParent()))
       return MemDepResult::getUnknown();
 
     if (IntrinsicInst *II = dyn_cast<IntrinsicInst>(Inst)) {
@@ -1263,7 +1263,8 @@ bool MemoryDependenceResults::getNonLocalPointerDepFromBB(
           goto PredTranslationFailure;
         }
       }
-      if (NewBlocks.size() > WorklistEntries) {
+      if (NewBlocks.size() > WorklistEntries ||
+          !Budget.consume(*BB->getParent(), NewBlocks.size())) {
         // Make sure to clean up the Visited map before continuing on to
         // PredTranslationFailure.
         for (unsigned i = 0; i < NewBlocks.size(); i++)
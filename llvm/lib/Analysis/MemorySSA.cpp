@@ -534,6 +534,7 @@ template <class AliasAnalysisType> class ClobberWalker {
   const MemorySSA &MSSA;
   AliasAnalysisType &AA;
   DominatorTree &DT;
+  CompileTimeBudget &Budget;
   UpwardsMemoryQuery *Query;
   unsigned *UpwardWalkLimit;
 
@@ -579,7 +580,7 @@ template <class AliasAnalysisType> class ClobberWalker {
   /// This does not test for whether StopAt is a clobber
   UpwardsWalkResult
   walkToPhiOrClobber(DefPath &Desc, const MemoryAccess *StopAt = nullptr,
-                     const MemoryAccess *SkipStopAt = nullptr) const {
+                     const MemoryAccess *SkipStopAt = nullptr) {
     assert(!isa<MemoryUse>(Desc.Last) && "Uses don't exist in my world");
     assert(UpwardWalkLimit && "Need a valid walk limit");
     bool LimitAlreadyReached = false;
@@ -604,6 +605,13 @@ template <class AliasAnalysisType> class ClobberWalker {
         if (!--*UpwardWalkLimit)
           return {Current, true, AliasResult(AliasResult::MayAlias)};
 
+        // Once the function is out of budget, every walk stops here as if it
+        // hit its own limit.
+        if (!Budget.consume(*MD->getBlock()->getParent())) {
+          *UpwardWalkLimit = 0;
+          return {Current, true, AliasResult(AliasResult::MayAlias)};
+        }
+
         ClobberAlias CA =
             instructionClobbersQuery(MD, Desc.Loc, Query->Inst, AA);
         if (CA.IsClobber)
@@ -959,8 +967,9 @@ template <class AliasAnalysisType> class ClobberWalker {
   }
 
 public:
-  ClobberWalker(const MemorySSA &MSSA, AliasAnalysisType &AA, DominatorTree &DT)
-      : MSSA(MSSA), AA(AA), DT(DT) {}
+  ClobberWalker(const MemorySSA &MSSA, AliasAnalysisType &AA, DominatorTree &DT,
+                CompileTimeBudget &Budget)
+      : MSSA(MSSA), AA(AA), DT(DT), Budget(Budget) {}
 
   AliasAnalysisType *getAA() { return &AA; }
   /// Finds the nearest clobber for the given query, optimizing phis if
@@ -1029,7 +1038,7 @@ template <class AliasAnalysisType> class MemorySSA::ClobberWalkerBase {
 
 public:
   ClobberWalkerBase(MemorySSA *M, AliasAnalysisType *A, DominatorTree *D)
-      : Walker(*M, *A, *D), MSSA(M) {}
+      : Walker(*M, *A, *D, M->WalkBudget), MSSA(M) {}
 
   MemoryAccess *getClobberingMemoryAccessBase(MemoryAccess *,
                                               const MemoryLocation &,
@@ -1266,7 +1275,8 @@ void MemorySSA::markUnreachableAsLiveOnEntry(BasicBlock *BB) {
 
 MemorySSA::MemorySSA(Function &Func, AliasAnalysis *AA, DominatorTree *DT)
     : DT(DT), F(Func), LiveOnEntryDef(nullptr), Walker(nullptr),
-      SkipWalker(nullptr) {
+      SkipWalker(nullptr),
+      WalkBudget(DEBUG_TYPE, "clobber walk alias checks") {
   // Build MemorySSA using a batch alias analysis. This reuses the internal
   // state that AA collects during an alias()/getModRefInfo() call. This is
   // safe because there are no CFG changes while building MemorySSA and can
@@ -1463,6 +1473,11 @@ void MemorySSA::OptimizeUses::optimizeUsesInBlock(
       LocInfo.LastKillValid = false;
       continue;
     }
+    // Likewise once the function is out of budget for alias checks.
+    if (!MSSA->WalkBudget.consume(MSSA->F, UpperBound - LocInfo.LowerBound)) {
+      LocInfo.LastKillValid = false;
+      continue;
+    }
     bool FoundClobberResult = false;
     unsigned UpwardWalkLimit = MaxCheckLimit;
     while (UpperBound > LocInfo.LowerBound) {
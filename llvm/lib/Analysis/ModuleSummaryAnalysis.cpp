@@ -412,9 +412,16 @@ static void computeFunctionSummary(
         auto CandidateProfileData =
             ICallAnalysis.getPromotionCandidatesForInstruction(
                 &I, NumVals, TotalCount, NumCandidates);
-        for (auto &Candidate : CandidateProfileData)
-          CallGraphEdges[Index.getOrInsertValueInfo(Candidate.Value)]
-              .updateHotness(getHotness(Candidate.Count, PSI));
+        // Only the first NumCandidates targets are profitable to promote;
+        // mark their edges so that the thin link can import them.
+        for (unsigned J = 0, E = CandidateProfileData.size(); J != E; ++J) {
+          auto &Candidate = CandidateProfileData[J];
+          CalleeInfo &Edge =
+              CallGraphEdges[Index.getOrInsertValueInfo(Candidate.Value)];
+          Edge.updateHotness(getHotness(Candidate.Count, PSI));
+          if (J < NumCandidates)
+            Edge.setICPTarget();
+        }
       }
     }
   }
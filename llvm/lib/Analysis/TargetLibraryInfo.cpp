@@ -28,6 +28,10 @@ static cl::opt<TargetLibraryInfoImpl::VectorLibrary> ClVectorLibrary(
                           "Darwin_libsystem_m", "Darwin libsystem_m"),
                clEnumValN(TargetLibraryInfoImpl::LIBMVEC_X86, "LIBMVEC-X86",
                           "GLIBC Vector Math library"),
+               clEnumValN(TargetLibraryInfoImpl::LLVMLIBC_AARCH64,
+                          "LLVMLibc-AArch64", "LLVM libc for AArch64"),
+               clEnumValN(TargetLibraryInfoImpl::LLVMLIBC_X86, "LLVMLibc-X86",
+                          "LLVM libc for x86-64"),
                clEnumValN(TargetLibraryInfoImpl::MASSV, "MASSV",
                           "IBM MASS vector library"),
                clEnumValN(TargetLibraryInfoImpl::SVML, "SVML",
@@ -445,6 +449,7 @@ static void initialize(TargetLibraryInfoImpl &TLI, const Triple &T,
     TLI.setUnavailable(LibFunc_ZnajSt11align_val_t);
     TLI.setUnavailable(LibFunc_ZnajSt11align_val_tRKSt9nothrow_t);
     TLI.setUnavailable(LibFunc_Znam);
+    TLI.setUnavailable(LibFunc_Znam12__hot_cold_t);
     TLI.setUnavailable(LibFunc_ZnamRKSt9nothrow_t);
     TLI.setUnavailable(LibFunc_ZnamSt11align_val_t);
     TLI.setUnavailable(LibFunc_ZnamSt11align_val_tRKSt9nothrow_t);
@@ -453,6 +458,7 @@ static void initialize(TargetLibraryInfoImpl &TLI, const Triple &T,
     TLI.setUnavailable(LibFunc_ZnwjSt11align_val_t);
     TLI.setUnavailable(LibFunc_ZnwjSt11align_val_tRKSt9nothrow_t);
     TLI.setUnavailable(LibFunc_Znwm);
+    TLI.setUnavailable(LibFunc_Znwm12__hot_cold_t);
     TLI.setUnavailable(LibFunc_ZnwmRKSt9nothrow_t);
     TLI.setUnavailable(LibFunc_ZnwmSt11align_val_t);
     TLI.setUnavailable(LibFunc_ZnwmSt11align_val_tRKSt9nothrow_t);
@@ -1448,6 +1454,13 @@ bool TargetLibraryInfoImpl::isValidProtoForLibFunc(const FunctionType &FTy,
   case LibFunc_ZnamSt11align_val_t:
     return (NumParams == 2 && FTy.getReturnType()->isPointerTy());
 
+  // new(unsigned long, __hot_cold_t)
+  case LibFunc_Znwm12__hot_cold_t:
+  // new[](unsigned long, __hot_cold_t)
+  case LibFunc_Znam12__hot_cold_t:
+    return (NumParams == 2 && FTy.getReturnType()->isPointerTy() &&
+            FTy.getParamType(1)->isIntegerTy(8));
+
   // new(unsigned int, align_val_t, nothrow)
   case LibFunc_ZnwjSt11align_val_tRKSt9nothrow_t:
   // new(unsigned long, align_val_t, nothrow)
@@ -1866,6 +1879,22 @@ void TargetLibraryInfoImpl::addVectorizableFunctionsFromVecLib(
     addVectorizableFunctions(VecFuncs);
     break;
   }
+  case LLVMLIBC_AARCH64: {
+    const VecDesc VecFuncs[] = {
+    #define TLI_DEFINE_LLVMLIBC_AARCH64_VECFUNCS
+    #include "llvm/Analysis/VecFuncs.def"
+    };
+    addVectorizableFunctions(VecFuncs);
+    break;
+  }
+  case LLVMLIBC_X86: {
+    const VecDesc VecFuncs[] = {
+    #define TLI_DEFINE_LLVMLIBC_X86_VECFUNCS
+    #include "llvm/Analysis/VecFuncs.def"
+    };
+    addVectorizableFunctions(VecFuncs);
+    break;
+  }
   case MASSV: {
     const VecDesc VecFuncs[] = {
     #define TLI_DEFINE_MASSV_VECFUNCS
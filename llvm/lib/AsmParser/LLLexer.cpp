@@ -787,6 +787,7 @@ lltok::Kind LLLexer::LexIdentifier() {
   KEYWORD(hot);
   KEYWORD(critical);
   KEYWORD(relbf);
+  KEYWORD(icpTarget);
   KEYWORD(variable);
   KEYWORD(vTableFuncs);
   KEYWORD(virtFunc);
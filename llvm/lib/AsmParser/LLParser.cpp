@@ -8673,7 +8673,8 @@ bool LLParser::parseOptionalFFlags(FunctionSummary::FFlags &FFlags) {
 /// OptionalCalls
 ///   := 'calls' ':' '(' Call [',' Call]* ')'
 /// Call ::= '(' 'callee' ':' GVReference
-///            [( ',' 'hotness' ':' Hotness | ',' 'relbf' ':' UInt32 )]? ')'
+///            [( ',' 'hotness' ':' Hotness | ',' 'relbf' ':' UInt32 )]?
+///            [ ',' 'icpTarget' ':' UInt32 ]? ')'
 bool LLParser::parseOptionalCalls(std::vector<FunctionSummary::EdgeTy> &Calls) {
   assert(Lex.getKind() == lltok::kw_calls);
   Lex.Lex();
@@ -8698,14 +8699,23 @@ bool LLParser::parseOptionalCalls(std::vector<FunctionSummary::EdgeTy> &Calls) {
 
     CalleeInfo::HotnessType Hotness = CalleeInfo::HotnessType::Unknown;
     unsigned RelBF = 0;
+    unsigned IsICPTarget = 0;
     if (EatIfPresent(lltok::comma)) {
-      // Expect either hotness or relbf
+      // Expect either hotness or relbf, or only icpTarget
       if (EatIfPresent(lltok::kw_hotness)) {
         if (parseToken(lltok::colon, "expected ':'") || parseHotness(Hotness))
           return true;
-      } else {
-        if (parseToken(lltok::kw_relbf, "expected relbf") ||
-            parseToken(lltok::colon, "expected ':'") || parseUInt32(RelBF))
+      } else if (EatIfPresent(lltok::kw_relbf)) {
+        if (parseToken(lltok::colon, "expected ':'") || parseUInt32(RelBF))
+          return true;
+      } else if (Lex.getKind() != lltok::kw_icpTarget) {
+        return error(Lex.getLoc(), "expected hotness, relbf or icpTarget");
+      }
+      if (Lex.getKind() == lltok::kw_icpTarget ||
+          EatIfPresent(lltok::comma)) {
+        if (parseToken(lltok::kw_icpTarget, "expected icpTarget") ||
+            parseToken(lltok::colon, "expected ':'") ||
+            parseUInt32(IsICPTarget))
           return true;
       }
     }
@@ -8714,7 +8724,8 @@ bool LLParser::parseOptionalCalls(std::vector<FunctionSummary::EdgeTy> &Calls) {
     // can only do so once the std::vector is finalized.
     if (VI.getRef() == FwdVIRef)
       IdToIndexMap[GVId].push_back(std::make_pair(Calls.size(), Loc));
-    Calls.push_back(FunctionSummary::EdgeTy{VI, CalleeInfo(Hotness, RelBF)});
+    Calls.push_back(FunctionSummary::EdgeTy{
+        VI, CalleeInfo(Hotness, RelBF, IsICPTarget)});
 
     if (parseToken(lltok::rparen, "expected ')' in call"))
       return true;
@@ -948,6 +948,17 @@ static FunctionSummary::FFlags getDecodedFFlags(uint64_t RawFlags) {
   return Flags;
 }
 
+// Decode the hotness of a call edge, and whether the callee is an ICP target.
+// The bits for each attribute:
+//
+// hotness: [0,3), isICPTarget: 3.
+static std::pair<CalleeInfo::HotnessType, bool>
+getDecodedHotnessCallEdgeInfo(uint64_t RawFlags) {
+  auto Hotness = static_cast<CalleeInfo::HotnessType>(RawFlags & 0x7);
+  bool IsICPTarget = (RawFlags >> 3) & 0x1;
+  return {Hotness, IsICPTarget};
+}
+
 // Decode the flags for GlobalValue in the summary. The bits for each attribute:
 //
 // linkage: [0,4), notEligibleToImport: 4, live: 5, local: 6, canAutoHide: 7,
@@ -4002,6 +4013,7 @@ Error BitcodeReader::parseBitcodeInto(Module *M, bool ShouldLazyLoadMetadata,
                                       DataLayoutCallbackTy DataLayoutCallback) {
   TheModule = M;
   MDLoader = MetadataLoader(Stream, *M, ValueList, IsImporting,
+                            ShouldLazyLoadMetadata,
                             [&](unsigned ID) { return getTypeByID(ID); });
   return parseModule(0, ShouldLazyLoadMetadata, DataLayoutCallback);
 }
@@ -6252,6 +6264,7 @@ ModuleSummaryIndexBitcodeReader::makeCallList(ArrayRef<uint64_t> Record,
   Ret.reserve(Record.size());
   for (unsigned I = 0, E = Record.size(); I != E; ++I) {
     CalleeInfo::HotnessType Hotness = CalleeInfo::HotnessType::Unknown;
+    bool IsICPTarget = false;
     uint64_t RelBF = 0;
     ValueInfo Callee = getValueInfoFromValueId(Record[I]).first;
     if (IsOldProfileFormat) {
@@ -6259,10 +6272,12 @@ ModuleSummaryIndexBitcodeReader::makeCallList(ArrayRef<uint64_t> Record,
       if (HasProfile)
         I += 1; // Skip old profilecount field
     } else if (HasProfile)
-      Hotness = static_cast<CalleeInfo::HotnessType>(Record[++I]);
+      std::tie(Hotness, IsICPTarget) =
+          getDecodedHotnessCallEdgeInfo(Record[++I]);
     else if (HasRelBF)
       RelBF = Record[++I];
-    Ret.push_back(FunctionSummary::EdgeTy{Callee, CalleeInfo(Hotness, RelBF)});
+    Ret.push_back(FunctionSummary::EdgeTy{
+        Callee, CalleeInfo(Hotness, RelBF, IsICPTarget)});
   }
   return Ret;
 }
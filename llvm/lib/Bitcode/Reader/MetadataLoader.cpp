@@ -83,6 +83,11 @@ static cl::opt<bool> DisableLazyLoading(
     cl::desc("Force disable the lazy-loading on-demand of metadata when "
              "loading bitcode for importing."));
 
+static cl::opt<bool> LazyLoadModuleMetadata(
+    "lazy-load-module-metadata", cl::init(false), cl::Hidden,
+    cl::desc("Load the module-level metadata of a module whose metadata is "
+             "lazily materialized on demand, as is done when importing."));
+
 namespace {
 
 static int64_t unrotateSign(uint64_t U) { return (U & 1) ? ~(U >> 1) : U >> 1; }
@@ -467,6 +472,10 @@ class MetadataLoader::MetadataLoaderImpl {
   /// True if metadata is being parsed for a module being ThinLTO imported.
   bool IsImporting = false;
 
+  /// True if module-level metadata can be loaded on demand from an index
+  /// instead of all at once.
+  bool IsLazyLoadingEnabled = false;
+
   Error parseOneMetadata(SmallVectorImpl<uint64_t> &Record, unsigned Code,
                          PlaceholderQueue &Placeholders, StringRef Blob,
                          unsigned &NextMetadataNo);
@@ -632,11 +641,14 @@ public:
   MetadataLoaderImpl(BitstreamCursor &Stream, Module &TheModule,
                      BitcodeReaderValueList &ValueList,
                      std::function<Type *(unsigned)> getTypeByID,
-                     bool IsImporting)
+                     bool IsImporting, bool ShouldLazyLoadMetadata)
       : MetadataList(TheModule.getContext(), Stream.SizeInBytes()),
         ValueList(ValueList), Stream(Stream), Context(TheModule.getContext()),
         TheModule(TheModule), getTypeByID(std::move(getTypeByID)),
-        IsImporting(IsImporting) {}
+        IsImporting(IsImporting),
+        IsLazyLoadingEnabled(!DisableLazyLoading &&
+                             (IsImporting || (ShouldLazyLoadMetadata &&
+                                              LazyLoadModuleMetadata))) {}
 
   Error parseMetadata(bool ModuleLevel);
 
@@ -970,8 +982,7 @@ Error MetadataLoader::MetadataLoaderImpl::parseMetadata(bool ModuleLevel) {
 
   // We lazy-load module-level metadata: we build an index for each record, and
   // then load individual record as needed, starting with the named metadata.
-  if (ModuleLevel && IsImporting && MetadataList.empty() &&
-      !DisableLazyLoading) {
+  if (ModuleLevel && IsLazyLoadingEnabled && MetadataList.empty()) {
     auto SuccessOrErr = lazyLoadModuleMetadataBlock();
     if (!SuccessOrErr)
       return SuccessOrErr.takeError();
@@ -2324,10 +2335,11 @@ MetadataLoader::MetadataLoader(MetadataLoader &&RHS)
 MetadataLoader::~MetadataLoader() = default;
 MetadataLoader::MetadataLoader(BitstreamCursor &Stream, Module &TheModule,
                                BitcodeReaderValueList &ValueList,
-                               bool IsImporting,
+                               bool IsImporting, bool ShouldLazyLoadMetadata,
                                std::function<Type *(unsigned)> getTypeByID)
     : Pimpl(std::make_unique<MetadataLoaderImpl>(
-          Stream, TheModule, ValueList, std::move(getTypeByID), IsImporting)) {}
+          Stream, TheModule, ValueList, std::move(getTypeByID), IsImporting,
+          ShouldLazyLoadMetadata)) {}
 
 Error MetadataLoader::parseMetadata(bool ModuleLevel) {
   return Pimpl->parseMetadata(ModuleLevel);
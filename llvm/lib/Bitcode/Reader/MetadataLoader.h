@@ -37,8 +37,13 @@ class MetadataLoader {
 
 public:
   ~MetadataLoader();
+  /// If \p ShouldLazyLoadMetadata is true, the module-level metadata block is
+  /// only parsed when the module's metadata is materialized, and may then be
+  /// loaded on demand with -lazy-load-module-metadata. Metadata of a module
+  /// being imported (\p IsImporting) is always loaded on demand.
   MetadataLoader(BitstreamCursor &Stream, Module &TheModule,
                  BitcodeReaderValueList &ValueList, bool IsImporting,
+                 bool ShouldLazyLoadMetadata,
                  std::function<Type *(unsigned)> getTypeByID);
   MetadataLoader &operator=(MetadataLoader &&);
   MetadataLoader(MetadataLoader &&);
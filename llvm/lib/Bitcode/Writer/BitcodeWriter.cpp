@@ -1072,6 +1072,15 @@ static uint64_t getEncodedFFlags(FunctionSummary::FFlags Flags) {
   return RawFlags;
 }
 
+// Encode the hotness of a call edge, with the ICP target flag in the bit above
+// it. See getDecodedHotnessCallEdgeInfo in BitcodeReader.cpp.
+static uint64_t getEncodedHotnessCallEdgeInfo(const CalleeInfo &CI) {
+  uint64_t RawFlags = 0;
+  RawFlags |= CI.Hotness;            // 3 bits
+  RawFlags |= (CI.IsICPTarget << 3); // 1 bit
+  return RawFlags;
+}
+
 // Decode the flags for GlobalValue in the summary. See getDecodedGVSummaryFlags
 // in BitcodeReader.cpp.
 static uint64_t getEncodedGVSummaryFlags(GlobalValueSummary::GVFlags Flags) {
@@ -3850,7 +3859,7 @@ void ModuleBitcodeWriterBase::writePerModuleFunctionSummaryRecord(
   for (auto &ECI : FS->calls()) {
     NameVals.push_back(getValueId(ECI.first));
     if (HasProfileData)
-      NameVals.push_back(static_cast<uint8_t>(ECI.second.Hotness));
+      NameVals.push_back(getEncodedHotnessCallEdgeInfo(ECI.second));
     else if (WriteRelBFToSummary)
       NameVals.push_back(ECI.second.RelBlockFreq);
   }
@@ -4268,7 +4277,7 @@ void IndexBitcodeWriter::writeCombinedGlobalValueSummary() {
         continue;
       NameVals.push_back(*CallValueId);
       if (HasProfileData)
-        NameVals.push_back(static_cast<uint8_t>(EI.second.Hotness));
+        NameVals.push_back(getEncodedHotnessCallEdgeInfo(EI.second));
     }
 
     unsigned FSAbbrev = (HasProfileData ? FSCallsProfileAbbrev : FSCallsAbbrev);
@@ -4677,11 +4686,14 @@ void llvm::writeIndexToFile(
   SmallVector<char, 0> Buffer;
   Buffer.reserve(256 * 1024);
 
-  BitcodeWriter Writer(Buffer);
+  // As for modules, stream to the file when possible, so that large combined
+  // indexes are not held in memory in full.
+  BitcodeWriter Writer(Buffer, dyn_cast<raw_fd_stream>(&Out));
   Writer.writeIndex(&Index, ModuleToSummariesForIndex);
   Writer.writeStrtab();
 
-  Out.write((char *)&Buffer.front(), Buffer.size());
+  if (!Buffer.empty())
+    Out.write((char *)&Buffer.front(), Buffer.size());
 }
 
 namespace {
@@ -81,6 +81,12 @@ static cl::opt<bool>
                            cl::desc("Generate DWARF4 type units."),
                            cl::init(false));
 
+static cl::opt<unsigned> TypeUnitsMinElements(
+    "type-units-min-elements", cl::Hidden,
+    cl::desc("Only place the types with at least this many members in type "
+             "units, and the smaller ones in the compile units."),
+    cl::init(0));
+
 static cl::opt<bool> SplitDwarfCrossCuReferences(
     "split-dwarf-cross-cu-references", cl::Hidden,
     cl::desc("Enable cross-cu references in DWO files"), cl::init(false));
@@ -3361,6 +3367,10 @@ uint64_t DwarfDebug::makeTypeSignature(StringRef Identifier) {
   return Result.high();
 }
 
+bool DwarfDebug::shouldPlaceInTypeUnit(const DICompositeType *CTy) const {
+  return CTy->getElements().size() >= TypeUnitsMinElements;
+}
+
 void DwarfDebug::addDwarfTypeUnitType(DwarfCompileUnit &CU,
                                       StringRef Identifier, DIE &RefDie,
                                       const DICompositeType *CTy) {
@@ -736,6 +736,12 @@ public:
   /// Returns whether to generate DWARF v4 type units.
   bool generateTypeUnits() const { return GenerateTypeUnits; }
 
+  /// Returns whether the type \p CTy is worth a type unit of its own. The
+  /// header and the section group of a type unit cost more than the
+  /// deduplication of a small type saves, so only the types with at least
+  /// -type-units-min-elements members are placed in type units.
+  bool shouldPlaceInTypeUnit(const DICompositeType *CTy) const;
+
   // Experimental DWARF5 features.
 
   /// Returns what kind (if any) of accelerator tables to emit.
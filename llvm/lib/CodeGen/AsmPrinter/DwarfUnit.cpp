@@ -596,7 +596,8 @@ DIE *DwarfUnit::createTypeDIE(const DIScope *Context, DIE &ContextDIE,
     if (DD->generateTypeUnits() && !Ty->isForwardDecl() &&
         (Ty->getRawName() || CTy->getRawIdentifier())) {
       // Skip updating the accelerator tables since this is not the full type.
-      if (MDString *TypeId = CTy->getRawIdentifier())
+      MDString *TypeId = CTy->getRawIdentifier();
+      if (TypeId && DD->shouldPlaceInTypeUnit(CTy))
         DD->addDwarfTypeUnitType(getCU(), TypeId->getString(), TyDIE, CTy);
       else {
         auto X = DD->enterNonTypeUnitContext();
@@ -15,6 +15,7 @@
 #include "llvm/CodeGen/GlobalISel/Legalizer.h"
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/CodeGen/GlobalISel/CSEInfo.h"
 #include "llvm/CodeGen/GlobalISel/CSEMIRBuilder.h"
 #include "llvm/CodeGen/GlobalISel/GISelChangeObserver.h"
@@ -38,6 +39,9 @@
 
 using namespace llvm;
 
+STATISTIC(NumAlreadyLegalFunctions,
+          "Number of functions that were already legal");
+
 static cl::opt<bool>
     EnableCSEInLegalizer("enable-cse-in-legalizer",
                          cl::desc("Should enable CSE in Legalizer"),
@@ -114,6 +118,30 @@ static bool isArtifact(const MachineInstr &MI) {
     return AllowGInsertAsArtifact;
   }
 }
+
+/// Returns true if legalizing \p MF would not change anything: every generic
+/// instruction is legal as it is, and none of them is an artifact that might
+/// be combined away or is dead. This is common at -O0, where it saves setting
+/// up the worklists and observers.
+static bool isAlreadyLegal(MachineFunction &MF, const LegalizerInfo &LI) {
+  const MachineRegisterInfo &MRI = MF.getRegInfo();
+  for (const MachineBasicBlock &MBB : MF) {
+    for (const MachineInstr &MI : MBB) {
+      if (!isPreISelGenericOpcode(MI.getOpcode()))
+        continue;
+      // Intrinsics are legalized by LegalizerInfo::legalizeIntrinsic, which
+      // may change them even if they are legal.
+      if (isArtifact(MI) || MI.getOpcode() == TargetOpcode::G_INTRINSIC ||
+          MI.getOpcode() == TargetOpcode::G_INTRINSIC_W_SIDE_EFFECTS)
+        return false;
+      if (isTriviallyDead(MI, MRI) ||
+          LI.getAction(MI, MRI).Action != LegalizeActions::Legal)
+        return false;
+    }
+  }
+  return true;
+}
+
 using InstListTy = GISelWorkList<256>;
 using ArtifactListTy = GISelWorkList<128>;
 
@@ -181,6 +209,12 @@ Legalizer::legalizeMachineFunction(MachineFunction &MF, const LegalizerInfo &LI,
   MIRBuilder.setMF(MF);
   MachineRegisterInfo &MRI = MF.getRegInfo();
 
+  if (isAlreadyLegal(MF, LI)) {
+    LLVM_DEBUG(dbgs() << ".. Function is already legal\n");
+    ++NumAlreadyLegalFunctions;
+    return {/*Changed*/ false, /*FailedOn*/ nullptr};
+  }
+
   // Populate worklists.
   InstListTy InstList;
   ArtifactListTy ArtifactList;
@@ -18,6 +18,7 @@
 #include "llvm/ADT/DepthFirstIterator.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/CodeGen/LiveInterval.h"
@@ -46,6 +47,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/CodeGen/StackMaps.h"
@@ -87,6 +89,11 @@ cl::opt<bool> UseSegmentSetForPhysRegs(
 
 } // end namespace llvm
 
+static cl::opt<bool> ReportLiveIntervalsMemory(
+    "report-live-intervals-memory", cl::Hidden,
+    cl::desc("Print the memory used by the live intervals of each function "
+             "when they are released"));
+
 void LiveIntervals::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.setPreservesCFG();
   AU.addRequired<AAResultsWrapperPass>();
@@ -107,6 +114,12 @@ LiveIntervals::LiveIntervals() : MachineFunctionPass(ID) {
 LiveIntervals::~LiveIntervals() { delete LICalc; }
 
 void LiveIntervals::releaseMemory() {
+  // Report before freeing anything, i.e. after every user of the intervals,
+  // including the splitting done by the register allocator, is done.
+  if (ReportLiveIntervalsMemory &&
+      (VirtRegIntervals.size() || !RegUnitRanges.empty()))
+    printMemoryUsage(*CreateInfoOutputFile());
+
   // Free the live intervals themselves.
   for (unsigned i = 0, e = VirtRegIntervals.size(); i != e; ++i)
     delete VirtRegIntervals[Register::index2VirtReg(i)];
@@ -123,6 +136,93 @@ void LiveIntervals::releaseMemory() {
   VNInfoAllocator.Reset();
 }
 
+namespace {
+
+/// The number of objects of some kind and the heap memory they use.
+struct MemoryUsage {
+  size_t Count = 0;
+  size_t Bytes = 0;
+};
+
+/// Memory used by a group of live ranges.
+struct LiveRangesMemory {
+  MemoryUsage Ranges;
+  MemoryUsage Segments;
+  MemoryUsage ValNos;
+
+  void add(const LiveRange &LR, size_t ObjectSize) {
+    ++Ranges.Count;
+    Ranges.Bytes += ObjectSize;
+    Segments.Count += LR.segments.size();
+    // Small vectors only use the heap once they grow past their inline size.
+    if (!LR.segments.empty() && LR.segments.capacity() > 2)
+      Segments.Bytes += LR.segments.capacity() * sizeof(LiveRange::Segment);
+    if (LR.segmentSet) {
+      // Count a tree node as the segment plus its parent, children and color.
+      Segments.Count += LR.segmentSet->size();
+      Segments.Bytes += LR.segmentSet->size() *
+                        (sizeof(LiveRange::Segment) + 4 * sizeof(void *));
+    }
+    ValNos.Count += LR.valnos.size();
+    if (LR.valnos.capacity() > 2)
+      ValNos.Bytes += LR.valnos.capacity() * sizeof(VNInfo *);
+  }
+};
+
+} // end anonymous namespace
+
+static void printMemoryUsageLine(raw_ostream &O, const MemoryUsage &Usage,
+                                 StringRef Name) {
+  O << format("%12zu  %12zu  ", Usage.Count, Usage.Bytes) << Name << '\n';
+}
+
+void LiveIntervals::printMemoryUsage(raw_ostream &O) const {
+  LiveRangesMemory VirtRegs, SubRanges, RegUnits;
+  for (unsigned I = 0, E = VirtRegIntervals.size(); I != E; ++I) {
+    const LiveInterval *LI = VirtRegIntervals[Register::index2VirtReg(I)];
+    if (!LI)
+      continue;
+    VirtRegs.add(*LI, sizeof(LiveInterval));
+    // Subranges are allocated with the VNInfos, count only their contents.
+    for (const LiveInterval::SubRange &SR : LI->subranges())
+      SubRanges.add(SR, 0);
+  }
+  for (const LiveRange *LR : RegUnitRanges)
+    if (LR)
+      RegUnits.add(*LR, sizeof(LiveRange));
+
+  MemoryUsage Allocator;
+  Allocator.Count = VirtRegs.ValNos.Count + SubRanges.ValNos.Count +
+                    RegUnits.ValNos.Count;
+  Allocator.Bytes = VNInfoAllocator.getTotalMemory();
+
+  // The total counts live ranges of all kinds.
+  MemoryUsage Total;
+  for (const LiveRangesMemory *M : {&VirtRegs, &SubRanges, &RegUnits}) {
+    Total.Count += M->Ranges.Count;
+    for (const MemoryUsage *U : {&M->Ranges, &M->Segments, &M->ValNos})
+      Total.Bytes += U->Bytes;
+  }
+  Total.Bytes += Allocator.Bytes;
+
+  O << "===" << std::string(73, '-') << "===\n"
+    << "  LiveIntervals memory usage for '" << MF->getName() << "'\n"
+    << "===" << std::string(73, '-') << "===\n"
+    << "       Count         Bytes  Name\n";
+  printMemoryUsageLine(O, VirtRegs.Ranges, "virtual register intervals");
+  printMemoryUsageLine(O, VirtRegs.Segments, "  segments");
+  printMemoryUsageLine(O, VirtRegs.ValNos, "  value number lists");
+  printMemoryUsageLine(O, SubRanges.Ranges, "subranges");
+  printMemoryUsageLine(O, SubRanges.Segments, "  segments");
+  printMemoryUsageLine(O, SubRanges.ValNos, "  value number lists");
+  printMemoryUsageLine(O, RegUnits.Ranges, "register unit ranges");
+  printMemoryUsageLine(O, RegUnits.Segments, "  segments");
+  printMemoryUsageLine(O, RegUnits.ValNos, "  value number lists");
+  printMemoryUsageLine(O, Allocator, "value numbers and subranges (allocator)");
+  printMemoryUsageLine(O, Total, "total");
+  O << '\n';
+}
+
 bool LiveIntervals::runOnMachineFunction(MachineFunction &fn) {
   MF = &fn;
   MRI = &MF->getRegInfo();
@@ -70,6 +70,7 @@
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SuffixTree.h"
 #include "llvm/Support/raw_ostream.h"
 #include <functional>
@@ -111,6 +112,13 @@ static cl::opt<unsigned> OutlinerReruns(
     cl::desc(
         "Number of times to rerun the outliner after the initial outline"));
 
+/// Ask the target about the outlining legality of the instructions in each
+/// function, and about the benefit of each set of candidates, in parallel.
+/// The target hooks involved only read the functions they are given.
+static cl::opt<bool> ParallelOutliner(
+    "machine-outliner-parallel", cl::init(false), cl::Hidden,
+    cl::desc("Run the target queries of the outliner in parallel"));
+
 namespace {
 
 /// Maps \p MachineInstrs to unsigned integers and stores the mappings.
@@ -240,6 +248,33 @@ struct InstructionMapper {
     return MINumber;
   }
 
+  /// What the target says about outlining from a \p MachineBasicBlock.
+  struct BlockOutliningInfo {
+    /// True if the block is safe to outline from.
+    bool IsSafe = false;
+
+    /// The target-defined flags of the block.
+    unsigned Flags = 0;
+
+    /// The outlining type of each instruction in the block, if it is safe.
+    std::vector<InstrType> Types;
+  };
+
+  /// Ask \p TII whether and how the instructions in \p MBB can be outlined.
+  /// This does not touch the mapper, so it can be done for many functions in
+  /// parallel.
+  static void classifyBlock(MachineBasicBlock &MBB, const TargetInstrInfo &TII,
+                            BlockOutliningInfo &Info) {
+    Info.Flags = 0;
+    Info.Types.clear();
+    Info.IsSafe = TII.isMBBSafeToOutlineFrom(MBB, Info.Flags);
+    if (!Info.IsSafe)
+      return;
+    for (MachineBasicBlock::iterator It = MBB.begin(), Et = MBB.end();
+         It != Et; ++It)
+      Info.Types.push_back(TII.getOutliningType(It, Info.Flags));
+  }
+
   /// Transforms a \p MachineBasicBlock into a \p vector of \p unsigneds
   /// and appends it to \p UnsignedVec and \p InstrList.
   ///
@@ -249,17 +284,15 @@ struct InstructionMapper {
   /// queried for candidates.
   ///
   /// \param MBB The \p MachineBasicBlock to be translated into integers.
-  /// \param TII \p TargetInstrInfo for the function.
+  /// \param Info The result of \p classifyBlock for \p MBB.
   void convertToUnsignedVec(MachineBasicBlock &MBB,
-                            const TargetInstrInfo &TII) {
-    unsigned Flags = 0;
-
+                            const BlockOutliningInfo &Info) {
     // Don't even map in this case.
-    if (!TII.isMBBSafeToOutlineFrom(MBB, Flags))
+    if (!Info.IsSafe)
       return;
 
     // Store info for the MBB for later outlining.
-    MBBFlagsMap[&MBB] = Flags;
+    MBBFlagsMap[&MBB] = Info.Flags;
 
     MachineBasicBlock::iterator It = MBB.begin();
 
@@ -280,9 +313,9 @@ struct InstructionMapper {
     std::vector<unsigned> UnsignedVecForMBB;
     std::vector<MachineBasicBlock::iterator> InstrListForMBB;
 
-    for (MachineBasicBlock::iterator Et = MBB.end(); It != Et; ++It) {
+    for (InstrType Type : Info.Types) {
       // Keep track of where this instruction is in the module.
-      switch (TII.getOutliningType(It, Flags)) {
+      switch (Type) {
       case InstrType::Illegal:
         mapToIllegalUnsigned(It, CanOutlineWithPrevInstr, UnsignedVecForMBB,
                              InstrListForMBB);
@@ -309,7 +342,9 @@ struct InstructionMapper {
         AddedIllegalLastTime = false;
         break;
       }
+      ++It;
     }
+    assert(It == MBB.end() && "Expected a type for every instruction");
 
     // Are there enough legal instructions in the block for outlining to be
     // possible?
@@ -399,6 +434,14 @@ struct MachineOutliner : public ModulePass {
   void findCandidates(InstructionMapper &Mapper,
                       std::vector<OutlinedFunction> &FunctionList);
 
+  /// Append \p OF, the result of evaluating the candidates of a repeated
+  /// sequence of length \p StringLen, to \p FunctionList if outlining it is
+  /// beneficial. Otherwise emit a remark saying why it is not outlined.
+  void addIfBeneficial(unsigned StringLen,
+                       std::vector<Candidate> &CandidatesForRepeatedSeq,
+                       OutlinedFunction &OF,
+                       std::vector<OutlinedFunction> &FunctionList);
+
   /// Replace the sequences of instructions represented by \p OutlinedFunctions
   /// with calls to functions.
   ///
@@ -528,6 +571,10 @@ void MachineOutliner::findCandidates(
   FunctionList.clear();
   SuffixTree ST(Mapper.UnsignedVec);
 
+  // When evaluating the candidates in parallel, the candidates for each
+  // repeated sequence are collected here first.
+  std::vector<std::pair<unsigned, std::vector<Candidate>>> RepeatedSeqs;
+
   // First, find all of the repeated substrings in the tree of minimum length
   // 2.
   std::vector<Candidate> CandidatesForRepeatedSeq;
@@ -581,6 +628,11 @@ void MachineOutliner::findCandidates(
     if (CandidatesForRepeatedSeq.size() < 2)
       continue;
 
+    if (ParallelOutliner) {
+      RepeatedSeqs.emplace_back(StringLen, CandidatesForRepeatedSeq);
+      continue;
+    }
+
     // Arbitrarily choose a TII from the first candidate.
     // FIXME: Should getOutliningCandidateInfo move to TargetMachine?
     const TargetInstrInfo *TII =
@@ -588,20 +640,43 @@ void MachineOutliner::findCandidates(
 
     OutlinedFunction OF =
         TII->getOutliningCandidateInfo(CandidatesForRepeatedSeq);
+    addIfBeneficial(StringLen, CandidatesForRepeatedSeq, OF, FunctionList);
+  }
 
-    // If we deleted too many candidates, then there's nothing worth outlining.
-    // FIXME: This should take target-specified instruction sizes into account.
-    if (OF.Candidates.size() < 2)
-      continue;
+  if (RepeatedSeqs.empty())
+    return;
 
-    // Is it better to outline this candidate than not?
-    if (OF.getBenefit() < 1) {
-      emitNotOutliningCheaperRemark(StringLen, CandidatesForRepeatedSeq, OF);
-      continue;
-    }
+  // Evaluate the benefit of each repeated sequence in parallel, then keep the
+  // beneficial ones in the order they were found in.
+  std::vector<OutlinedFunction> OFs(RepeatedSeqs.size());
+  parallelForEachN(0, RepeatedSeqs.size(), [&](size_t I) {
+    std::vector<Candidate> &Candidates = RepeatedSeqs[I].second;
+    const TargetInstrInfo *TII =
+        Candidates[0].getMF()->getSubtarget().getInstrInfo();
+    OFs[I] = TII->getOutliningCandidateInfo(Candidates);
+  });
+  for (size_t I = 0, E = RepeatedSeqs.size(); I != E; ++I)
+    addIfBeneficial(RepeatedSeqs[I].first, RepeatedSeqs[I].second, OFs[I],
+                    FunctionList);
+}
 
-    FunctionList.push_back(OF);
+void MachineOutliner::addIfBeneficial(
+    unsigned StringLen, std::vector<Candidate> &CandidatesForRepeatedSeq,
+    OutlinedFunction &OF, std::vector<OutlinedFunction> &FunctionList) {
+  // If we deleted too many candidates, then there's nothing worth outlining.
+  // FIXME: This should take target-specified instruction sizes into account.
+  if (OF.Candidates.size() < 2)
+    return;
+
+  // Is it better to outline this candidate than not?
+  if (OF.getBenefit() < 1) {
+    emitNotOutliningCheaperRemark(StringLen, CandidatesForRepeatedSeq, OF);
+    return;
   }
+
+  for (Candidate &C : OF.Candidates)
+    C.FunctionIdx = FunctionList.size();
+  FunctionList.push_back(OF);
 }
 
 MachineFunction *MachineOutliner::createOutlinedFunction(
@@ -869,6 +944,11 @@ bool MachineOutliner::outline(Module &M,
 
 void MachineOutliner::populateMapper(InstructionMapper &Mapper, Module &M,
                                      MachineModuleInfo &MMI) {
+  // The blocks to map, in order, and for each function that has blocks to
+  // map, its TargetInstrInfo and the index of its first block in Blocks.
+  std::vector<MachineBasicBlock *> Blocks;
+  std::vector<std::pair<const TargetInstrInfo *, size_t>> FunctionsToMap;
+
   // Build instruction mappings for each function in the module. Start by
   // iterating over each Function in M.
   for (Function &F : M) {
@@ -897,9 +977,10 @@ void MachineOutliner::populateMapper(InstructionMapper &Mapper, Module &M,
     if (!TII->isFunctionSafeToOutlineFrom(*MF, OutlineFromLinkOnceODRs))
       continue;
 
-    // We have a function suitable for outlining. Iterate over every
-    // MachineBasicBlock in MF and try to map its instructions to a list of
+    // We have a function suitable for outlining. Collect every
+    // MachineBasicBlock in MF whose instructions should be mapped to a list of
     // unsigned integers.
+    FunctionsToMap.push_back({TII, Blocks.size()});
     for (MachineBasicBlock &MBB : *MF) {
       // If there isn't anything in MBB, then there's no point in outlining from
       // it.
@@ -916,12 +997,39 @@ void MachineOutliner::populateMapper(InstructionMapper &Mapper, Module &M,
         continue;
 
       // MBB is suitable for outlining. Map it to a list of unsigneds.
-      Mapper.convertToUnsignedVec(MBB, *TII);
+      Blocks.push_back(&MBB);
     }
+  }
 
-    // Statistics.
-    UnsignedVecSize = Mapper.UnsignedVec.size();
+  if (!ParallelOutliner) {
+    InstructionMapper::BlockOutliningInfo Info;
+    for (unsigned FI = 0, FE = FunctionsToMap.size(); FI != FE; ++FI) {
+      size_t End = FI + 1 == FE ? Blocks.size() : FunctionsToMap[FI + 1].second;
+      for (size_t I = FunctionsToMap[FI].second; I != End; ++I) {
+        InstructionMapper::classifyBlock(*Blocks[I], *FunctionsToMap[FI].first,
+                                         Info);
+        Mapper.convertToUnsignedVec(*Blocks[I], Info);
+      }
+    }
+  } else {
+    // Classify the blocks of each function in parallel, then number the
+    // instructions in order so that the mapping does not depend on the
+    // scheduling.
+    std::vector<InstructionMapper::BlockOutliningInfo> Infos(Blocks.size());
+    parallelForEachN(0, FunctionsToMap.size(), [&](size_t FI) {
+      size_t End = FI + 1 == FunctionsToMap.size()
+                       ? Blocks.size()
+                       : FunctionsToMap[FI + 1].second;
+      for (size_t I = FunctionsToMap[FI].second; I != End; ++I)
+        InstructionMapper::classifyBlock(*Blocks[I], *FunctionsToMap[FI].first,
+                                         Infos[I]);
+    });
+    for (size_t I = 0, E = Blocks.size(); I != E; ++I)
+      Mapper.convertToUnsignedVec(*Blocks[I], Infos[I]);
   }
+
+  // Statistics.
+  UnsignedVecSize = Mapper.UnsignedVec.size();
 }
 
 void MachineOutliner::initSizeRemarkInfo(
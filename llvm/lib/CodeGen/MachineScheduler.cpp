@@ -30,6 +30,7 @@
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineLoopInfo.h"
 #include "llvm/CodeGen/MachineOperand.h"
+#include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
 #include "llvm/CodeGen/MachinePassRegistry.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
 #include "llvm/CodeGen/Passes.h"
@@ -75,6 +76,8 @@ using namespace llvm;
 #define DEBUG_TYPE "machine-scheduler"
 
 STATISTIC(NumClustered, "Number of load/store pairs clustered");
+STATISTIC(NumHugeRegionsSkipped,
+          "Number of scheduling regions left in source order for their size");
 
 namespace llvm {
 
@@ -124,6 +127,13 @@ static const bool PrintDAGs = false;
 static cl::opt<unsigned> ReadyListLimit("misched-limit", cl::Hidden,
   cl::desc("Limit ready list to N instructions"), cl::init(256));
 
+/// Building the DAG and scheduling a region is superlinear in its size, so
+/// leave regions larger than this in their original order.
+static cl::opt<unsigned> MaxRegionInstrs("misched-max-region-instrs",
+  cl::Hidden, cl::init(0),
+  cl::desc("Do not schedule regions with more than N instructions "
+           "(default = 0, unlimited)"));
+
 static cl::opt<bool> EnableRegPressure("misched-regpressure", cl::Hidden,
   cl::desc("Enable register pressure scheduling."), cl::init(true));
 
@@ -536,6 +546,7 @@ void MachineSchedulerBase::scheduleRegions(ScheduleDAGInstrs &Scheduler,
   //
   // TODO: Visit blocks in global postorder or postorder within the bottom-up
   // loop tree. Then we can optionally compute global RegPressure.
+  MachineOptimizationRemarkEmitter MORE(*MF, /*MBFI=*/nullptr);
   for (MachineFunction::iterator MBB = MF->begin(), MBBEnd = MF->end();
        MBB != MBBEnd; ++MBB) {
 
@@ -581,6 +592,22 @@ void MachineSchedulerBase::scheduleRegions(ScheduleDAGInstrs &Scheduler,
         Scheduler.exitRegion();
         continue;
       }
+      if (MaxRegionInstrs && NumRegionInstrs > MaxRegionInstrs) {
+        LLVM_DEBUG(dbgs() << "Not scheduling a region of " << NumRegionInstrs
+                          << " instructions in " << printMBBReference(*MBB)
+                          << "\n");
+        ++NumHugeRegionsSkipped;
+        MORE.emit([&]() {
+          return MachineOptimizationRemarkMissed(DEBUG_TYPE, "RegionTooLarge",
+                                                 I->getDebugLoc(), &*MBB)
+                 << "not scheduling a region of "
+                 << ore::NV("NumInstrs", NumRegionInstrs)
+                 << " instructions, larger than the limit of "
+                 << ore::NV("Limit", MaxRegionInstrs.getValue());
+        });
+        Scheduler.exitRegion();
+        continue;
+      }
       LLVM_DEBUG(dbgs() << "********** MI Scheduling **********\n");
       LLVM_DEBUG(dbgs() << MF->getName() << ":" << printMBBReference(*MBB)
                         << " " << MBB->getName() << "\n  From: " << *I
@@ -1089,6 +1089,8 @@ bool SelectionDAG::RemoveNodeFromCSEMaps(SDNode *N) {
     Erased = CSEMap.RemoveNode(N);
     break;
   }
+  // The node is about to be modified, forget the hash of its old profile.
+  N->CSEHash = 0;
 #ifndef NDEBUG
   // Verify that the node was actually in one of the CSE maps, unless it has a
   // flag result (which cannot be CSE'd) or is one of the special cases that are
@@ -12,11 +12,13 @@
 //===----------------------------------------------------------------------===//
 #include "llvm/DWP/DWP.h"
 #include "llvm/DWP/DWPError.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCObjectFileInfo.h"
 #include "llvm/MC/MCTargetOptionsCommandFlags.h"
 #include "llvm/Object/Decompressor.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 
 using namespace llvm;
 using namespace llvm::object;
@@ -465,19 +467,13 @@ Error buildDuplicateError(const std::pair<uint64_t, UnitIndexEntry> &PrevE,
       " and " + buildDWODescription(ID.Name, DWPName, ID.DWOName));
 }
 
-Error handleSection(
-    const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
-    const MCSection *StrSection, const MCSection *StrOffsetSection,
-    const MCSection *TypesSection, const MCSection *CUIndexSection,
-    const MCSection *TUIndexSection, const MCSection *InfoSection,
-    const SectionRef &Section, MCStreamer &Out,
-    std::deque<SmallString<32>> &UncompressedSections,
-    uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
-    StringRef &CurStrSection, StringRef &CurStrOffsetSection,
-    std::vector<StringRef> &CurTypesSection,
-    std::vector<StringRef> &CurInfoSection, StringRef &AbbrevSection,
-    StringRef &CurCUIndexSection, StringRef &CurTUIndexSection,
-    std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength) {
+// Reads the contents of \p Section, decompressing them into
+// \p UncompressedSections if needed. \p Name is set to the name of the
+// section without its leading dots and underscores, or left empty if the
+// section has no contents.
+static Error readSection(const SectionRef &Section,
+                         std::deque<SmallString<32>> &UncompressedSections,
+                         StringRef &Name, StringRef &Contents) {
   if (Section.isBSS())
     return Error::success();
 
@@ -487,21 +483,35 @@ Error handleSection(
   Expected<StringRef> NameOrErr = Section.getName();
   if (!NameOrErr)
     return NameOrErr.takeError();
-  StringRef Name = *NameOrErr;
+  StringRef SectionName = *NameOrErr;
 
   Expected<StringRef> ContentsOrErr = Section.getContents();
   if (!ContentsOrErr)
     return ContentsOrErr.takeError();
-  StringRef Contents = *ContentsOrErr;
+  Contents = *ContentsOrErr;
 
-  if (auto Err = handleCompressedSection(UncompressedSections, Name, Contents))
+  if (auto Err =
+          handleCompressedSection(UncompressedSections, SectionName, Contents))
     return Err;
 
-  Name = Name.substr(Name.find_first_not_of("._"));
+  Name = SectionName.substr(SectionName.find_first_not_of("._"));
+  return Error::success();
+}
 
+static void handleSectionContents(
+    const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
+    const MCSection *StrSection, const MCSection *StrOffsetSection,
+    const MCSection *TypesSection, const MCSection *CUIndexSection,
+    const MCSection *TUIndexSection, const MCSection *InfoSection,
+    StringRef Name, StringRef Contents, MCStreamer &Out,
+    StringRef &CurStrSection, StringRef &CurStrOffsetSection,
+    std::vector<StringRef> &CurTypesSection,
+    std::vector<StringRef> &CurInfoSection, StringRef &AbbrevSection,
+    StringRef &CurCUIndexSection, StringRef &CurTUIndexSection,
+    std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength) {
   auto SectionPair = KnownSections.find(Name);
   if (SectionPair == KnownSections.end())
-    return Error::success();
+    return;
 
   if (DWARFSectionKind Kind = SectionPair->second.second) {
     if (Kind != DW_SECT_EXT_TYPES && Kind != DW_SECT_INFO) {
@@ -530,10 +540,79 @@ Error handleSection(
     Out.SwitchSection(OutSection);
     Out.emitBytes(Contents);
   }
+}
+
+Error handleSection(
+    const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
+    const MCSection *StrSection, const MCSection *StrOffsetSection,
+    const MCSection *TypesSection, const MCSection *CUIndexSection,
+    const MCSection *TUIndexSection, const MCSection *InfoSection,
+    const SectionRef &Section, MCStreamer &Out,
+    std::deque<SmallString<32>> &UncompressedSections,
+    uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
+    StringRef &CurStrSection, StringRef &CurStrOffsetSection,
+    std::vector<StringRef> &CurTypesSection,
+    std::vector<StringRef> &CurInfoSection, StringRef &AbbrevSection,
+    StringRef &CurCUIndexSection, StringRef &CurTUIndexSection,
+    std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength) {
+  StringRef Name, Contents;
+  if (auto Err = readSection(Section, UncompressedSections, Name, Contents))
+    return Err;
+
+  handleSectionContents(KnownSections, StrSection, StrOffsetSection,
+                        TypesSection, CUIndexSection, TUIndexSection,
+                        InfoSection, Name, Contents, Out, CurStrSection,
+                        CurStrOffsetSection, CurTypesSection, CurInfoSection,
+                        AbbrevSection, CurCUIndexSection, CurTUIndexSection,
+                        SectionLength);
   return Error::success();
 }
 
-Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
+namespace {
+// An input file, read ahead of being written to the package.
+struct DWOInput {
+  std::unique_ptr<MemoryBuffer> Buffer;
+  std::unique_ptr<object::ObjectFile> Obj;
+  std::deque<SmallString<32>> UncompressedSections;
+  // The name, as returned by readSection, and contents of each section.
+  std::vector<std::pair<StringRef, StringRef>> Sections;
+};
+} // end anonymous namespace
+
+// Reads \p Input into memory and decompresses its sections. This does not
+// depend on the other inputs, so it can run in parallel with the writing of
+// the previous ones.
+static Expected<std::unique_ptr<DWOInput>> readDWOInput(StringRef Input) {
+  auto DWO = std::make_unique<DWOInput>();
+  // Read the file instead of mapping it: the input is released as soon as it
+  // has been written, and this makes sure the I/O happens on the thread
+  // reading it ahead.
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+      MemoryBuffer::getFile(Input, /*IsText=*/false,
+                            /*RequiresNullTerminator=*/false,
+                            /*IsVolatile=*/true);
+  if (!BufferOrErr)
+    return createFileError(Input, errorCodeToError(BufferOrErr.getError()));
+  DWO->Buffer = std::move(*BufferOrErr);
+
+  Expected<std::unique_ptr<object::ObjectFile>> ObjOrErr =
+      object::ObjectFile::createObjectFile(DWO->Buffer->getMemBufferRef());
+  if (!ObjOrErr)
+    return createFileError(Input, ObjOrErr.takeError());
+  DWO->Obj = std::move(*ObjOrErr);
+
+  for (const auto &Section : DWO->Obj->sections()) {
+    StringRef Name, Contents;
+    if (auto Err =
+            readSection(Section, DWO->UncompressedSections, Name, Contents))
+      return std::move(Err);
+    DWO->Sections.emplace_back(Name, Contents);
+  }
+  return std::move(DWO);
+}
+
+Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
+            ThreadPoolStrategy S) {
   const auto &MCOFI = *Out.getContext().getObjectFileInfo();
   MCSection *const StrSection = MCOFI.getDwarfStrDWOSection();
   MCSection *const StrOffsetSection = MCOFI.getDwarfStrOffDWOSection();
@@ -566,18 +645,47 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
 
   DWPStringPool Strings(Out, StrSection);
 
-  SmallVector<OwningBinary<object::ObjectFile>, 128> Objects;
-  Objects.reserve(Inputs.size());
-
-  std::deque<SmallString<32>> UncompressedSections;
-
-  for (const auto &Input : Inputs) {
-    auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
-    if (!ErrOrObj)
-      return ErrOrObj.takeError();
-
-    auto &Obj = *ErrOrObj->getBinary();
-    Objects.push_back(std::move(*ErrOrObj));
+  // The inputs are read on a thread pool, a bounded number of them ahead of
+  // the one being written, and released once written. The output still has
+  // to be written in order, as the offsets of the contributions and of the
+  // strings depend on all the previous inputs.
+  std::vector<Optional<Expected<std::unique_ptr<DWOInput>>>> DWOs(
+      Inputs.size());
+  std::vector<std::shared_future<void>> DWOsRead(Inputs.size());
+  Optional<ThreadPool> Pool;
+  if (S.compute_thread_count() > 1)
+    Pool.emplace(S);
+  auto WaitForPool = make_scope_exit([&] {
+    if (Pool)
+      Pool->wait();
+    // Inputs read ahead of an error.
+    for (auto &DWO : DWOs)
+      if (DWO)
+        consumeError(DWO->takeError());
+  });
+  size_t NumReadAhead = Pool ? 4 * Pool->getThreadCount() : 0;
+  size_t NumScheduled = 0;
+
+  for (size_t InputIndex = 0; InputIndex != Inputs.size(); ++InputIndex) {
+    const std::string &Input = Inputs[InputIndex];
+    for (; Pool && NumScheduled != Inputs.size() &&
+           NumScheduled <= InputIndex + NumReadAhead;
+         ++NumScheduled)
+      DWOsRead[NumScheduled] = Pool->async([&, I = NumScheduled] {
+        DWOs[I] = readDWOInput(Inputs[I]);
+      });
+    if (Pool)
+      DWOsRead[InputIndex].wait();
+    else
+      DWOs[InputIndex] = readDWOInput(Input);
+
+    Expected<std::unique_ptr<DWOInput>> DWOOrErr =
+        std::move(*DWOs[InputIndex]);
+    DWOs[InputIndex].reset();
+    if (!DWOOrErr)
+      return DWOOrErr.takeError();
+    std::unique_ptr<DWOInput> DWO = std::move(*DWOOrErr);
+    auto &Obj = *DWO->Obj;
 
     UnitIndexEntry CurEntry = {};
 
@@ -594,15 +702,14 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
     // i.e. offset and length, of each compile/type unit to a section.
     std::vector<std::pair<DWARFSectionKind, uint32_t>> SectionLength;
 
-    for (const auto &Section : Obj.sections())
-      if (auto Err = handleSection(
-              KnownSections, StrSection, StrOffsetSection, TypesSection,
-              CUIndexSection, TUIndexSection, InfoSection, Section, Out,
-              UncompressedSections, ContributionOffsets, CurEntry,
-              CurStrSection, CurStrOffsetSection, CurTypesSection,
-              CurInfoSection, AbbrevSection, CurCUIndexSection,
-              CurTUIndexSection, SectionLength))
-        return Err;
+    for (const auto &Section : DWO->Sections)
+      handleSectionContents(KnownSections, StrSection, StrOffsetSection,
+                            TypesSection, CUIndexSection, TUIndexSection,
+                            InfoSection, Section.first, Section.second, Out,
+                            CurStrSection, CurStrOffsetSection,
+                            CurTypesSection, CurInfoSection, AbbrevSection,
+                            CurCUIndexSection, CurTUIndexSection,
+                            SectionLength);
 
     if (CurInfoSection.empty())
       continue;
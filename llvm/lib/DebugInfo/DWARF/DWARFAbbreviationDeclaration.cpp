@@ -30,6 +30,7 @@ void DWARFAbbreviationDeclaration::clear() {
   HasChildren = false;
   AttributeSpecs.clear();
   FixedAttributeSize.reset();
+  FixedAttributeOffsets.clear();
 }
 
 DWARFAbbreviationDeclaration::DWARFAbbreviationDeclaration() {
@@ -63,6 +64,10 @@ DWARFAbbreviationDeclaration::extract(DataExtractor Data,
     auto A = static_cast<Attribute>(Data.getULEB128(OffsetPtr));
     auto F = static_cast<Form>(Data.getULEB128(OffsetPtr));
     if (A && F) {
+      // All the attributes so far have a fixed size, so the offset of this one
+      // is the size of the attributes before it.
+      if (FixedAttributeSize)
+        FixedAttributeOffsets.push_back(*FixedAttributeSize);
       bool IsImplicitConst = (F == DW_FORM_implicit_const);
       if (IsImplicitConst) {
         int64_t V = Data.getSLEB128(OffsetPtr);
@@ -154,7 +159,16 @@ uint64_t DWARFAbbreviationDeclaration::getAttributeOffsetFromIndex(
   // Add the byte size of ULEB that for the abbrev Code so we can start
   // skipping the attribute data.
   uint64_t Offset = DIEOffset + CodeByteSize;
-  for (uint32_t CurAttrIdx = 0; CurAttrIdx != AttrIndex; ++CurAttrIdx)
+  if (AttrIndex < FixedAttributeOffsets.size())
+    return Offset + FixedAttributeOffsets[AttrIndex].getByteSize(U);
+
+  // Skip the leading fixed size attributes at once, and the others one by one.
+  uint32_t CurAttrIdx = 0;
+  if (!FixedAttributeOffsets.empty()) {
+    CurAttrIdx = FixedAttributeOffsets.size() - 1;
+    Offset += FixedAttributeOffsets.back().getByteSize(U);
+  }
+  for (; CurAttrIdx != AttrIndex; ++CurAttrIdx)
     // Match Offset along until we get to the attribute we want.
     if (auto FixedSize = AttributeSpecs[CurAttrIdx].getByteSize(U))
       Offset += *FixedSize;
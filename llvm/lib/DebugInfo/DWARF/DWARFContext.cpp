@@ -724,7 +724,7 @@ DWARFTypeUnit *DWARFContext::getTypeUnitForHash(uint16_t Version, uint64_t Hash,
     }
   }
 
-  return (*Units.Map)[Hash];
+  return Units.Map->lookup(Hash);
 }
 
 DWARFCompileUnit *DWARFContext::getDWOCompileUnitForHash(uint64_t Hash) {
@@ -970,20 +970,29 @@ DWARFContext::getLineTableForUnit(DWARFUnit *U) {
   return *ExpectedLineTable;
 }
 
+/// Returns the offset of the line table of \p U in its line section.
+static Optional<uint64_t> getStmtListOffset(DWARFUnit *U) {
+  auto UnitDIE = U->getUnitDIE();
+  if (!UnitDIE)
+    return None;
+
+  auto Offset = toSectionOffset(UnitDIE.find(DW_AT_stmt_list));
+  if (!Offset)
+    return None; // No line table for this compile unit.
+
+  return *Offset + U->getLineTableOffset();
+}
+
 Expected<const DWARFDebugLine::LineTable *> DWARFContext::getLineTableForUnit(
     DWARFUnit *U, function_ref<void(Error)> RecoverableErrorHandler) {
   if (!Line)
     Line.reset(new DWARFDebugLine);
 
-  auto UnitDIE = U->getUnitDIE();
-  if (!UnitDIE)
-    return nullptr;
-
-  auto Offset = toSectionOffset(UnitDIE.find(DW_AT_stmt_list));
+  auto Offset = getStmtListOffset(U);
   if (!Offset)
-    return nullptr; // No line table for this compile unit.
+    return nullptr;
 
-  uint64_t stmtOffset = *Offset + U->getLineTableOffset();
+  uint64_t stmtOffset = *Offset;
   // See if the line table is cached.
   if (const DWARFLineTable *lt = Line->getLineTable(stmtOffset))
     return lt;
@@ -1033,7 +1042,54 @@ DWARFCompileUnit *DWARFContext::getCompileUnitForAddress(uint64_t Address) {
   // First, get the offset of the compile unit.
   uint64_t CUOffset = getDebugAranges()->findAddress(Address);
   // Retrieve the compile unit.
-  return getCompileUnitForOffset(CUOffset);
+  DWARFCompileUnit *CU = getCompileUnitForOffset(CUOffset);
+  if (CU && ParsedUnitsMemoryLimit)
+    noteAddressLookup(CU);
+  return CU;
+}
+
+void DWARFContext::noteAddressLookup(DWARFUnit *U) {
+  auto GetMemoryUsage = [&](DWARFUnit *U) -> uint64_t {
+    uint64_t Usage = U->getDIEsMemoryUsage();
+    if (Optional<uint64_t> Offset = Line ? getStmtListOffset(U) : None)
+      if (const DWARFDebugLine::LineTable *LT = Line->getLineTable(*Offset))
+        Usage += sizeof(*LT) +
+                 LT->Rows.capacity() * sizeof(DWARFDebugLine::Row) +
+                 LT->Sequences.capacity() * sizeof(DWARFDebugLine::Sequence) +
+                 LT->Prologue.FileNames.capacity() *
+                     sizeof(DWARFDebugLine::FileNameEntry);
+    return Usage;
+  };
+
+  // The DIEs and line table of a unit are parsed after its lookup, so the
+  // memory they use is only known by the next one.
+  if (LastLookupUnit && LastLookupUnit != U) {
+    ParsedUnitInfo &Info = ParsedUnits[LastLookupUnit];
+    ParsedUnitsMemoryUsage -= Info.MemoryUsage;
+    Info.MemoryUsage = GetMemoryUsage(LastLookupUnit);
+    ParsedUnitsMemoryUsage += Info.MemoryUsage;
+  }
+  ParsedUnits[U].LastLookup = ++NumAddressLookups;
+  LastLookupUnit = U;
+
+  // Clear the least recently looked up units, but not the one looked up now,
+  // whose DIEs the caller is about to use.
+  while (ParsedUnitsMemoryUsage > ParsedUnitsMemoryLimit) {
+    auto Oldest = ParsedUnits.end();
+    for (auto I = ParsedUnits.begin(), E = ParsedUnits.end(); I != E; ++I)
+      if (I->first != U && (Oldest == ParsedUnits.end() ||
+                            I->second.LastLookup < Oldest->second.LastLookup))
+        Oldest = I;
+    if (Oldest == ParsedUnits.end())
+      break;
+
+    DWARFUnit *Evicted = Oldest->first;
+    if (Optional<uint64_t> Offset = Line ? getStmtListOffset(Evicted) : None)
+      Line->clearLineTable(*Offset);
+    Evicted->clearDIEs(/*KeepCUDie=*/true);
+    ParsedUnitsMemoryUsage -= Oldest->second.MemoryUsage;
+    ParsedUnits.erase(Oldest);
+  }
 }
 
 DWARFContext::DIEsForAddress DWARFContext::getDIEsForAddress(uint64_t Address) {
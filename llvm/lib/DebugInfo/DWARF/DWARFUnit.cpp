@@ -626,6 +626,16 @@ void DWARFUnit::clearDIEs(bool KeepCUDie) {
   DieArray = (KeepCUDie && !DieArray.empty())
                  ? std::vector<DWARFDebugInfoEntry>({DieArray[0]})
                  : std::vector<DWARFDebugInfoEntry>();
+  // The address map refers to the DIEs that were just freed.
+  AddrDieMap.clear();
+}
+
+size_t DWARFUnit::getDIEsMemoryUsage() const {
+  // Account for the links and color of the red-black tree nodes of the
+  // address map.
+  return DieArray.capacity() * sizeof(DWARFDebugInfoEntry) +
+         AddrDieMap.size() *
+             (sizeof(decltype(AddrDieMap)::value_type) + 4 * sizeof(void *));
 }
 
 Expected<DWARFAddressRangesVector>
@@ -28,6 +28,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -332,23 +333,82 @@ bool DWARFVerifier::handleDebugAbbrev() {
   return NumErrors == 0;
 }
 
+unsigned DWARFVerifier::verifyInParallel(
+    size_t Count, function_ref<unsigned(DWARFVerifier &, size_t)> Verify) {
+  ThreadPoolStrategy S = hardware_concurrency(DumpOpts.VerifyNumThreads);
+  if (S.compute_thread_count() == 1 || Count < 2) {
+    unsigned NumErrors = 0;
+    for (size_t I = 0; I != Count; ++I)
+      NumErrors += Verify(*this, I);
+    return NumErrors;
+  }
+
+  struct Result {
+    std::string Output;
+    unsigned NumErrors = 0;
+  };
+  std::vector<Result> Results(Count);
+  std::vector<std::shared_future<void>> Done;
+  Done.reserve(Count);
+  ThreadPool Pool(S);
+  for (size_t I = 0; I != Count; ++I)
+    Done.push_back(Pool.async([&, I] {
+      raw_string_ostream BufferOS(Results[I].Output);
+      DWARFVerifier Verifier(BufferOS, DCtx, DumpOpts);
+      Results[I].NumErrors = Verify(Verifier, I);
+    }));
+
+  unsigned NumErrors = 0;
+  for (size_t I = 0; I != Count; ++I) {
+    Done[I].wait();
+    OS << Results[I].Output;
+    OS.flush();
+    NumErrors += Results[I].NumErrors;
+    Results[I] = Result();
+  }
+  return NumErrors;
+}
+
+void DWARFVerifier::prepareUnitsForParallelVerification(
+    const DWARFUnitVector &Units) {
+  if (hardware_concurrency(DumpOpts.VerifyNumThreads).compute_thread_count() ==
+      1)
+    return;
+  for (const auto &Unit : Units) {
+    Unit->getNumDIEs();
+    DCtx.getLineTableForUnit(Unit.get());
+  }
+  DCtx.getTypeUnitForHash(0, 0, /*IsDWO=*/false);
+  DCtx.getTypeUnitForHash(0, 0, /*IsDWO=*/true);
+}
+
 unsigned DWARFVerifier::verifyUnits(const DWARFUnitVector &Units) {
   unsigned NumDebugInfoErrors = 0;
   ReferenceMap CrossUnitReferences;
 
-  unsigned Index = 1;
-  for (const auto &Unit : Units) {
-    OS << "Verifying unit: " << Index << " / " << Units.getNumUnits();
-    if (const char* Name = Unit->getUnitDIE(true).getShortName())
-      OS << ", \"" << Name << '\"';
-    OS << '\n';
-    OS.flush();
-    ReferenceMap UnitLocalReferences;
-    NumDebugInfoErrors +=
-        verifyUnitContents(*Unit, UnitLocalReferences, CrossUnitReferences);
-    NumDebugInfoErrors += verifyDebugInfoReferences(
-        UnitLocalReferences, [&](uint64_t Offset) { return Unit.get(); });
-    ++Index;
+  prepareUnitsForParallelVerification(Units);
+  std::vector<ReferenceMap> UnitCrossReferences(Units.size());
+  NumDebugInfoErrors += verifyInParallel(
+      Units.size(), [&](DWARFVerifier &Verifier, size_t Index) {
+        DWARFUnit *Unit = Units[Index].get();
+        raw_ostream &OS = Verifier.OS;
+        OS << "Verifying unit: " << Index + 1 << " / " << Units.getNumUnits();
+        if (const char *Name = Unit->getUnitDIE(true).getShortName())
+          OS << ", \"" << Name << '\"';
+        OS << '\n';
+        OS.flush();
+        ReferenceMap UnitLocalReferences;
+        unsigned NumErrors = Verifier.verifyUnitContents(
+            *Unit, UnitLocalReferences, UnitCrossReferences[Index]);
+        NumErrors += Verifier.verifyDebugInfoReferences(
+            UnitLocalReferences, [&](uint64_t Offset) { return Unit; });
+        return NumErrors;
+      });
+  for (ReferenceMap &References : UnitCrossReferences) {
+    for (auto &Reference : References)
+      CrossUnitReferences[Reference.first].insert(Reference.second.begin(),
+                                                  Reference.second.end());
+    References.clear();
   }
 
   NumDebugInfoErrors += verifyDebugInfoReferences(
@@ -796,93 +856,102 @@ void DWARFVerifier::verifyDebugLineStmtOffsets() {
 }
 
 void DWARFVerifier::verifyDebugLineRows() {
-  for (const auto &CU : DCtx.compile_units()) {
-    auto Die = CU->getUnitDIE();
-    auto LineTable = DCtx.getLineTableForUnit(CU.get());
-    // If there is no line table we will have created an error in the
-    // .debug_info verifier or in verifyDebugLineStmtOffsets().
-    if (!LineTable)
-      continue;
+  // The line tables have been parsed by verifyDebugLineStmtOffsets, so the
+  // units can be verified in parallel.
+  NumDebugLineErrors += verifyInParallel(
+      DCtx.getNumCompileUnits(), [&](DWARFVerifier &Verifier, size_t Index) {
+        return Verifier.verifyDebugLineRows(*DCtx.getUnitAtIndex(Index));
+      });
+}
 
-    // Verify prologue.
-    uint32_t MaxDirIndex = LineTable->Prologue.IncludeDirectories.size();
-    uint32_t FileIndex = 1;
-    StringMap<uint16_t> FullPathMap;
-    for (const auto &FileName : LineTable->Prologue.FileNames) {
-      // Verify directory index.
-      if (FileName.DirIdx > MaxDirIndex) {
-        ++NumDebugLineErrors;
-        error() << ".debug_line["
-                << format("0x%08" PRIx64,
-                          *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                << "].prologue.file_names[" << FileIndex
-                << "].dir_idx contains an invalid index: " << FileName.DirIdx
-                << "\n";
-      }
+unsigned DWARFVerifier::verifyDebugLineRows(DWARFUnit &CU) {
+  unsigned NumErrors = 0;
+  auto Die = CU.getUnitDIE();
+  auto LineTable = DCtx.getLineTableForUnit(&CU);
+  // If there is no line table we will have created an error in the
+  // .debug_info verifier or in verifyDebugLineStmtOffsets().
+  if (!LineTable)
+    return 0;
 
-      // Check file paths for duplicates.
-      std::string FullPath;
-      const bool HasFullPath = LineTable->getFileNameByIndex(
-          FileIndex, CU->getCompilationDir(),
-          DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath, FullPath);
-      assert(HasFullPath && "Invalid index?");
-      (void)HasFullPath;
-      auto It = FullPathMap.find(FullPath);
-      if (It == FullPathMap.end())
-        FullPathMap[FullPath] = FileIndex;
-      else if (It->second != FileIndex) {
-        warn() << ".debug_line["
-               << format("0x%08" PRIx64,
-                         *toSectionOffset(Die.find(DW_AT_stmt_list)))
-               << "].prologue.file_names[" << FileIndex
-               << "] is a duplicate of file_names[" << It->second << "]\n";
-      }
+  // Verify prologue.
+  uint32_t MaxDirIndex = LineTable->Prologue.IncludeDirectories.size();
+  uint32_t FileIndex = 1;
+  StringMap<uint16_t> FullPathMap;
+  for (const auto &FileName : LineTable->Prologue.FileNames) {
+    // Verify directory index.
+    if (FileName.DirIdx > MaxDirIndex) {
+      ++NumErrors;
+      error() << ".debug_line["
+              << format("0x%08" PRIx64,
+                        *toSectionOffset(Die.find(DW_AT_stmt_list)))
+              << "].prologue.file_names[" << FileIndex
+              << "].dir_idx contains an invalid index: " << FileName.DirIdx
+              << "\n";
+    }
 
-      FileIndex++;
+    // Check file paths for duplicates.
+    std::string FullPath;
+    const bool HasFullPath = LineTable->getFileNameByIndex(
+        FileIndex, CU.getCompilationDir(),
+        DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath, FullPath);
+    assert(HasFullPath && "Invalid index?");
+    (void)HasFullPath;
+    auto It = FullPathMap.find(FullPath);
+    if (It == FullPathMap.end())
+      FullPathMap[FullPath] = FileIndex;
+    else if (It->second != FileIndex) {
+      warn() << ".debug_line["
+             << format("0x%08" PRIx64,
+                       *toSectionOffset(Die.find(DW_AT_stmt_list)))
+             << "].prologue.file_names[" << FileIndex
+             << "] is a duplicate of file_names[" << It->second << "]\n";
     }
 
-    // Verify rows.
-    uint64_t PrevAddress = 0;
-    uint32_t RowIndex = 0;
-    for (const auto &Row : LineTable->Rows) {
-      // Verify row address.
-      if (Row.Address.Address < PrevAddress) {
-        ++NumDebugLineErrors;
-        error() << ".debug_line["
-                << format("0x%08" PRIx64,
-                          *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                << "] row[" << RowIndex
-                << "] decreases in address from previous row:\n";
-
-        DWARFDebugLine::Row::dumpTableHeader(OS, 0);
-        if (RowIndex > 0)
-          LineTable->Rows[RowIndex - 1].dump(OS);
-        Row.dump(OS);
-        OS << '\n';
-      }
+    FileIndex++;
+  }
 
-      // Verify file index.
-      if (!LineTable->hasFileAtIndex(Row.File)) {
-        ++NumDebugLineErrors;
-        bool isDWARF5 = LineTable->Prologue.getVersion() >= 5;
-        error() << ".debug_line["
-                << format("0x%08" PRIx64,
-                          *toSectionOffset(Die.find(DW_AT_stmt_list)))
-                << "][" << RowIndex << "] has invalid file index " << Row.File
-                << " (valid values are [" << (isDWARF5 ? "0," : "1,")
-                << LineTable->Prologue.FileNames.size()
-                << (isDWARF5 ? ")" : "]") << "):\n";
-        DWARFDebugLine::Row::dumpTableHeader(OS, 0);
-        Row.dump(OS);
-        OS << '\n';
-      }
-      if (Row.EndSequence)
-        PrevAddress = 0;
-      else
-        PrevAddress = Row.Address.Address;
-      ++RowIndex;
+  // Verify rows.
+  uint64_t PrevAddress = 0;
+  uint32_t RowIndex = 0;
+  for (const auto &Row : LineTable->Rows) {
+    // Verify row address.
+    if (Row.Address.Address < PrevAddress) {
+      ++NumErrors;
+      error() << ".debug_line["
+              << format("0x%08" PRIx64,
+                        *toSectionOffset(Die.find(DW_AT_stmt_list)))
+              << "] row[" << RowIndex
+              << "] decreases in address from previous row:\n";
+
+      DWARFDebugLine::Row::dumpTableHeader(OS, 0);
+      if (RowIndex > 0)
+        LineTable->Rows[RowIndex - 1].dump(OS);
+      Row.dump(OS);
+      OS << '\n';
+    }
+
+    // Verify file index.
+    if (!LineTable->hasFileAtIndex(Row.File)) {
+      ++NumErrors;
+      bool isDWARF5 = LineTable->Prologue.getVersion() >= 5;
+      error() << ".debug_line["
+              << format("0x%08" PRIx64,
+                        *toSectionOffset(Die.find(DW_AT_stmt_list)))
+              << "][" << RowIndex << "] has invalid file index " << Row.File
+              << " (valid values are [" << (isDWARF5 ? "0," : "1,")
+              << LineTable->Prologue.FileNames.size()
+              << (isDWARF5 ? ")" : "]") << "):\n";
+      DWARFDebugLine::Row::dumpTableHeader(OS, 0);
+      Row.dump(OS);
+      OS << '\n';
     }
+    if (Row.EndSequence)
+      PrevAddress = 0;
+    else
+      PrevAddress = Row.Address.Address;
+    ++RowIndex;
   }
+  return NumErrors;
 }
 
 DWARFVerifier::DWARFVerifier(raw_ostream &S, DWARFContext &D,
@@ -1532,14 +1601,22 @@ unsigned DWARFVerifier::verifyDebugNames(const DWARFSection &AccelSection,
   if (NumErrors > 0)
     return NumErrors;
 
-  for (const std::unique_ptr<DWARFUnit> &U : DCtx.compile_units()) {
-    if (const DWARFDebugNames::NameIndex *NI =
-            AccelTable.getCUNameIndex(U->getOffset())) {
-      auto *CU = cast<DWARFCompileUnit>(U.get());
-      for (const DWARFDebugInfoEntry &Die : CU->dies())
-        NumErrors += verifyNameIndexCompleteness(DWARFDie(CU, &Die), *NI);
-    }
-  }
+  prepareUnitsForParallelVerification(DCtx.getNormalUnitsVector());
+  unsigned SampleRate = std::max(DumpOpts.VerifyNameIndexSampleRate, 1u);
+  NumErrors += verifyInParallel(
+      DCtx.getNumCompileUnits(), [&](DWARFVerifier &Verifier, size_t Index) {
+        DWARFUnit *U = DCtx.getUnitAtIndex(Index);
+        const DWARFDebugNames::NameIndex *NI =
+            AccelTable.getCUNameIndex(U->getOffset());
+        if (!NI)
+          return 0u;
+        unsigned NumErrors = 0;
+        auto *CU = cast<DWARFCompileUnit>(U);
+        for (size_t I = 0, E = CU->getNumDIEs(); I < E; I += SampleRate)
+          NumErrors += Verifier.verifyNameIndexCompleteness(
+              CU->getDIEAtIndex(I), *NI);
+        return NumErrors;
+      });
   return NumErrors;
 }
 
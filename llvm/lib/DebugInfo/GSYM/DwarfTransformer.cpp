@@ -452,6 +452,10 @@ Error DwarfTransformer::convert(uint32_t NumThreads) {
       DWARFDie Die = getDie(*CU.get());
       CUInfo CUI(DICtx, dyn_cast<DWARFCompileUnit>(CU.get()));
       handleDie(Log, CUI, Die);
+      // The DIEs of the unit are not needed anymore once it is converted, as
+      // the function infos only refer to the string and file tables. Free
+      // them to keep the memory use bounded.
+      CU->clearDIEs(/*KeepCUDie=*/true);
     }
   } else {
     // LLVM Dwarf parser is not thread-safe and we need to parse all DWARF up
@@ -10,6 +10,8 @@
 #include "llvm/DebugInfo/GSYM/Header.h"
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
@@ -147,13 +149,18 @@ llvm::Error GsymCreator::encode(FileWriter &O) const {
   StrTab.write(O.get_stream());
   const off_t StrtabSize = O.tell() - StrtabOffset;
   std::vector<uint32_t> AddrInfoOffsets;
+  AddrInfoOffsets.reserve(Funcs.size());
 
   // Write out the address infos for each function info.
-  for (const auto &FuncInfo : Funcs) {
-    if (Expected<uint64_t> OffsetOrErr = FuncInfo.encode(O))
-      AddrInfoOffsets.push_back(OffsetOrErr.get());
-    else
-      return OffsetOrErr.takeError();
+  if (NumThreads == 1) {
+    for (const auto &FuncInfo : Funcs) {
+      if (Expected<uint64_t> OffsetOrErr = FuncInfo.encode(O))
+        AddrInfoOffsets.push_back(OffsetOrErr.get());
+      else
+        return OffsetOrErr.takeError();
+    }
+  } else if (Error Err = encodeFunctionInfosInParallel(O, AddrInfoOffsets)) {
+    return Err;
   }
   // Fixup the string table offset and size in the header
   O.fixup32((uint32_t)StrtabOffset, offsetof(Header, StrtabOffset));
@@ -168,6 +175,63 @@ llvm::Error GsymCreator::encode(FileWriter &O) const {
   return ErrorSuccess();
 }
 
+llvm::Error GsymCreator::encodeFunctionInfosInParallel(
+    FileWriter &O, std::vector<uint32_t> &AddrInfoOffsets) const {
+  // Function infos are encoded independently of each other and of their
+  // position in the file, as they are aligned to 4 bytes and only refer to
+  // their own data. Encode them in slices on a thread pool, each slice into
+  // its own buffer, and write the buffers out in order. Slices are encoded a
+  // batch at a time so that the encoded data of a single batch is kept in
+  // memory.
+  struct EncodedSlice {
+    SmallVector<char, 0> Data;
+    std::vector<uint64_t> Offsets;
+    Error Err = Error::success();
+  };
+  const size_t SliceSize = 4096;
+  ThreadPool Pool(hardware_concurrency(NumThreads));
+  const size_t BatchSize = SliceSize * Pool.getThreadCount();
+  const size_t NumFuncs = Funcs.size();
+  for (size_t BatchBegin = 0; BatchBegin < NumFuncs; BatchBegin += BatchSize) {
+    const size_t BatchEnd = std::min(NumFuncs, BatchBegin + BatchSize);
+    std::vector<EncodedSlice> Slices(
+        divideCeil(BatchEnd - BatchBegin, SliceSize));
+    for (size_t I = 0, E = Slices.size(); I != E; ++I) {
+      Pool.async([&, I] {
+        EncodedSlice &Slice = Slices[I];
+        raw_svector_ostream OS(Slice.Data);
+        FileWriter SliceWriter(OS, O.getByteOrder());
+        const size_t Begin = BatchBegin + I * SliceSize;
+        const size_t End = std::min(BatchEnd, Begin + SliceSize);
+        for (size_t F = Begin; F != End; ++F) {
+          Expected<uint64_t> OffsetOrErr = Funcs[F].encode(SliceWriter);
+          if (!OffsetOrErr) {
+            Slice.Err = OffsetOrErr.takeError();
+            return;
+          }
+          Slice.Offsets.push_back(*OffsetOrErr);
+        }
+      });
+    }
+    Pool.wait();
+
+    Error Err = Error::success();
+    for (EncodedSlice &Slice : Slices)
+      Err = joinErrors(std::move(Err), std::move(Slice.Err));
+    if (Err)
+      return Err;
+
+    for (const EncodedSlice &Slice : Slices) {
+      O.alignTo(4);
+      const uint64_t SliceOffset = O.tell();
+      O.get_stream() << StringRef(Slice.Data.data(), Slice.Data.size());
+      for (uint64_t Offset : Slice.Offsets)
+        AddrInfoOffsets.push_back(SliceOffset + Offset);
+    }
+  }
+  return Error::success();
+}
+
 // Similar to std::remove_if, but the predicate is binary and it is passed both
 // the previous and the current element.
 template <class ForwardIt, class BinaryPredicate>
@@ -647,10 +647,13 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
       Context.reset(new PDBContext(*CoffObject, std::move(Session)));
     }
   }
-  if (!Context)
-    Context = DWARFContext::create(
+  if (!Context) {
+    std::unique_ptr<DWARFContext> DWARFCtx = DWARFContext::create(
         *Objects.second, DWARFContext::ProcessDebugRelocations::Process,
         nullptr, Opts.DWPName);
+    DWARFCtx->setParsedUnitsMemoryLimit(Opts.MaxDWARFUnitCacheSize);
+    Context = std::move(DWARFCtx);
+  }
   auto ModuleOrErr =
       createModuleInfo(Objects.first, std::move(Context), ModuleName);
   if (ModuleOrErr) {
@@ -669,7 +672,8 @@ LLVMSymbolizer::getOrCreateModuleInfo(const ObjectFile &Obj) {
   if (I != Modules.end())
     return I->second.get();
 
-  std::unique_ptr<DIContext> Context = DWARFContext::create(Obj);
+  std::unique_ptr<DWARFContext> Context = DWARFContext::create(Obj);
+  Context->setParsedUnitsMemoryLimit(Opts.MaxDWARFUnitCacheSize);
   // FIXME: handle COFF object with PDB info to use PDBContext
   return createModuleInfo(&Obj, std::move(Context), ObjName);
 }
@@ -17,6 +17,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Debuginfod/Debuginfod.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Debuginfod/HTTPClient.h"
 #include "llvm/Support/CachePruning.h"
@@ -25,8 +27,11 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/xxhash.h"
 
+#include <atomic>
+
 namespace llvm {
 static std::string uniqueKey(llvm::StringRef S) { return utostr(xxHash64(S)); }
 
@@ -88,13 +93,44 @@ Expected<std::string> getCachedOrDownloadExecutable(BuildIDRef ID) {
   return getCachedOrDownloadArtifact(uniqueKey(UrlPath), UrlPath);
 }
 
-Expected<std::string> getCachedOrDownloadDebuginfo(BuildIDRef ID) {
+static std::string getDebuginfoUrlPath(BuildIDRef ID) {
   SmallString<64> UrlPath;
   sys::path::append(UrlPath, sys::path::Style::posix, "buildid",
                     buildIDToString(ID), "debuginfo");
+  return std::string(UrlPath);
+}
+
+Expected<std::string> getCachedOrDownloadDebuginfo(BuildIDRef ID) {
+  std::string UrlPath = getDebuginfoUrlPath(ID);
   return getCachedOrDownloadArtifact(uniqueKey(UrlPath), UrlPath);
 }
 
+void prefetchDebuginfo(ArrayRef<BuildID> IDs, ThreadPoolStrategy S) {
+  Expected<std::string> CacheDirOrErr = getDefaultDebuginfodCacheDirectory();
+  Expected<SmallVector<StringRef>> DebuginfodUrlsOrErr =
+      getDefaultDebuginfodUrls();
+  if (!CacheDirOrErr || !DebuginfodUrlsOrErr) {
+    consumeError(CacheDirOrErr.takeError());
+    consumeError(DebuginfodUrlsOrErr.takeError());
+    return;
+  }
+
+  std::vector<std::string> UrlPaths;
+  for (BuildIDRef ID : IDs)
+    UrlPaths.push_back(getDebuginfoUrlPath(ID));
+  llvm::sort(UrlPaths);
+  UrlPaths.erase(std::unique(UrlPaths.begin(), UrlPaths.end()),
+                 UrlPaths.end());
+  std::vector<std::string> UniqueKeys;
+  for (const std::string &UrlPath : UrlPaths)
+    UniqueKeys.push_back(uniqueKey(UrlPath));
+
+  for (Expected<std::string> &PathOrErr : getCachedOrDownloadArtifacts(
+           UniqueKeys, UrlPaths, *CacheDirOrErr, *DebuginfodUrlsOrErr,
+           getDefaultDebuginfodTimeout(), S))
+    consumeError(PathOrErr.takeError());
+}
+
 // General fetching function.
 Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
                                                   StringRef UrlPath) {
@@ -115,9 +151,14 @@ Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
                                      getDefaultDebuginfodTimeout());
 }
 
-Expected<std::string> getCachedOrDownloadArtifact(
-    StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
-    ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout) {
+// Fetches an artifact like getCachedOrDownloadArtifact, creating \p Client on
+// the first cache miss and reusing it afterwards.
+static Expected<std::string>
+getCachedOrDownloadArtifact(StringRef UniqueKey, StringRef UrlPath,
+                            StringRef CacheDirectoryPath,
+                            ArrayRef<StringRef> DebuginfodUrls,
+                            std::chrono::milliseconds Timeout,
+                            Optional<HTTPClient> &Client) {
   SmallString<64> AbsCachedArtifactPath;
   sys::path::append(AbsCachedArtifactPath, CacheDirectoryPath,
                     "llvmcache-" + UniqueKey);
@@ -149,13 +190,15 @@ Expected<std::string> getCachedOrDownloadArtifact(
         "allow Debuginfod to make HTTP requests, call HTTPClient::initialize() "
         "at the beginning of main.");
 
-  HTTPClient Client;
-  Client.setTimeout(Timeout);
+  if (!Client) {
+    Client.emplace();
+    Client->setTimeout(Timeout);
+  }
   for (StringRef ServerUrl : DebuginfodUrls) {
     SmallString<64> ArtifactUrl;
     sys::path::append(ArtifactUrl, sys::path::Style::posix, ServerUrl, UrlPath);
 
-    Expected<HTTPResponseBuffer> ResponseOrErr = Client.get(ArtifactUrl);
+    Expected<HTTPResponseBuffer> ResponseOrErr = Client->get(ArtifactUrl);
     if (!ResponseOrErr)
       return ResponseOrErr.takeError();
 
@@ -183,4 +226,43 @@ Expected<std::string> getCachedOrDownloadArtifact(
 
   return createStringError(errc::argument_out_of_domain, "build id not found");
 }
+
+Expected<std::string> getCachedOrDownloadArtifact(
+    StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
+    ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout) {
+  Optional<HTTPClient> Client;
+  return getCachedOrDownloadArtifact(UniqueKey, UrlPath, CacheDirectoryPath,
+                                     DebuginfodUrls, Timeout, Client);
+}
+
+std::vector<Expected<std::string>> getCachedOrDownloadArtifacts(
+    ArrayRef<std::string> UniqueKeys, ArrayRef<std::string> UrlPaths,
+    StringRef CacheDirectoryPath, ArrayRef<StringRef> DebuginfodUrls,
+    std::chrono::milliseconds Timeout, ThreadPoolStrategy S) {
+  assert(UniqueKeys.size() == UrlPaths.size() &&
+         "every artifact needs a key and a URL path");
+  std::vector<Optional<Expected<std::string>>> Results(UniqueKeys.size());
+
+  // The threads pick the next artifact to fetch until there are none left,
+  // each with its own client.
+  std::atomic<size_t> Next(0);
+  ThreadPool Pool(S);
+  size_t NumWorkers = std::min<size_t>(Pool.getThreadCount(), Results.size());
+  for (size_t I = 0; I != NumWorkers; ++I)
+    Pool.async([&] {
+      Optional<HTTPClient> Client;
+      for (size_t J = Next++; J < Results.size(); J = Next++)
+        Results[J] = getCachedOrDownloadArtifact(UniqueKeys[J], UrlPaths[J],
+                                                 CacheDirectoryPath,
+                                                 DebuginfodUrls, Timeout,
+                                                 Client);
+    });
+  Pool.wait();
+
+  std::vector<Expected<std::string>> Paths;
+  Paths.reserve(Results.size());
+  for (Optional<Expected<std::string>> &Result : Results)
+    Paths.push_back(std::move(*Result));
+  return Paths;
+}
 } // namespace llvm
@@ -0,0 +1,55 @@
+//===-- llvm/Debuginfod/RemoteCache.cpp - Remote file cache ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Debuginfod/RemoteCache.h"
+#include "llvm/Debuginfod/HTTPClient.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+
+FileCache remoteCache(StringRef ServerUrl, FileCache LocalCache,
+                      std::chrono::milliseconds Timeout) {
+  return [ServerUrl = ServerUrl.str(), LocalCache = std::move(LocalCache),
+          Timeout](unsigned Task, StringRef Key) -> Expected<AddStreamFn> {
+    Expected<AddStreamFn> LocalAddStreamOrErr = LocalCache(Task, Key);
+    if (!LocalAddStreamOrErr || !*LocalAddStreamOrErr)
+      return LocalAddStreamOrErr;
+    AddStreamFn LocalAddStream = std::move(*LocalAddStreamOrErr);
+    if (!HTTPClient::isAvailable() || !HTTPClient::IsInitialized)
+      return LocalAddStream;
+
+    // Any failure to fetch the file just means that it is produced locally.
+    HTTPClient Client;
+    Client.setTimeout(Timeout);
+    SmallString<128> Url;
+    sys::path::append(Url, sys::path::Style::posix, ServerUrl,
+                      "llvmcache-" + Key);
+    Expected<HTTPResponseBuffer> ResponseOrErr = Client.get(Url);
+    if (!ResponseOrErr) {
+      consumeError(ResponseOrErr.takeError());
+      return LocalAddStream;
+    }
+    HTTPResponseBuffer &Response = *ResponseOrErr;
+    if (Response.Code != 200 || !Response.Body)
+      return LocalAddStream;
+
+    // Write the file to the local cache. Destroying the stream commits it and
+    // adds it to the output.
+    Expected<std::unique_ptr<CachedFileStream>> FileStreamOrErr =
+        LocalAddStream(Task);
+    if (!FileStreamOrErr)
+      return FileStreamOrErr.takeError();
+    *(*FileStreamOrErr)->OS << StringRef(Response.Body->getBufferStart(),
+                                         Response.Body->getBufferSize());
+    return AddStreamFn();
+  };
+}
+
+} // namespace llvm
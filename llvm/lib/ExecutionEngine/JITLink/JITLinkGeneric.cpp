@@ -149,7 +149,7 @@ void JITLinkerBase::linkPhase3(std::unique_ptr<JITLinkerBase> Self,
   });
 
   // Fix up block content.
-  if (auto Err = fixUpBlocks(*G))
+  if (auto Err = fixUpBlocks(*G, Passes.ConcurrentFixups))
     return abandonAllocAndBailOut(std::move(Self), std::move(Err));
 
   LLVM_DEBUG({
@@ -15,6 +15,10 @@
 
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/Support/Parallel.h"
+
+#include <mutex>
+#include <vector>
 
 #define DEBUG_TYPE "jitlink"
 
@@ -80,9 +84,9 @@ private:
   // returns an error.
   Error runPasses(LinkGraphPassList &Passes);
 
-  // Copy block contents and apply relocations.
+  // Copy block contents and apply relocations, concurrently if requested.
   // Implemented in JITLinker.
-  virtual Error fixUpBlocks(LinkGraph &G) const = 0;
+  virtual Error fixUpBlocks(LinkGraph &G, bool Concurrent) const = 0;
 
   JITLinkContext::LookupMap getExternalSymbolNames() const;
   void applyLookupResult(AsyncLookupResult LR);
@@ -120,30 +124,51 @@ private:
     return static_cast<const LinkerImpl &>(*this);
   }
 
-  Error fixUpBlocks(LinkGraph &G) const override {
+  Error fixUpBlocks(LinkGraph &G, bool Concurrent) const override {
     LLVM_DEBUG(dbgs() << "Fixing up blocks:\n");
 
+    if (Concurrent) {
+      // The fixups of a block only write to the content of that block, so
+      // blocks can be fixed up independently.
+      std::vector<Block *> Blocks(G.blocks().begin(), G.blocks().end());
+      std::mutex ErrMutex;
+      Error Err = Error::success();
+      parallelForEach(Blocks, [&](Block *B) {
+        if (auto BlockErr = fixUpBlock(G, *B)) {
+          std::lock_guard<std::mutex> Lock(ErrMutex);
+          Err = joinErrors(std::move(Err), std::move(BlockErr));
+        }
+      });
+      return Err;
+    }
+
     for (auto *B : G.blocks()) {
       LLVM_DEBUG(dbgs() << "  " << *B << ":\n");
 
       // Copy Block data and apply fixups.
       LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
-      assert((!B->isZeroFill() || B->edges_size() == 0) &&
-             "Edges in zero-fill block?");
-      for (auto &E : B->edges()) {
-
-        // Skip non-relocation edges.
-        if (!E.isRelocation())
-          continue;
-
-        // Dispatch to LinkerImpl for fixup.
-        if (auto Err = impl().applyFixup(G, *B, E))
-          return Err;
-      }
+      if (auto Err = fixUpBlock(G, *B))
+        return Err;
     }
 
     return Error::success();
   }
+
+  Error fixUpBlock(LinkGraph &G, Block &B) const {
+    assert((!B.isZeroFill() || B.edges_size() == 0) &&
+           "Edges in zero-fill block?");
+    for (auto &E : B.edges()) {
+
+      // Skip non-relocation edges.
+      if (!E.isRelocation())
+        continue;
+
+      // Dispatch to LinkerImpl for fixup.
+      if (auto Err = impl().applyFixup(G, B, E))
+        return Err;
+    }
+    return Error::success();
+  }
 };
 
 /// Removes dead symbols/blocks/addressables.
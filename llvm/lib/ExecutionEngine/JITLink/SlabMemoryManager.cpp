@@ -0,0 +1,366 @@
+//===---- SlabMemoryManager.cpp - Slab based JITLink memory manager -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/SlabMemoryManager.h"
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Process.h"
+
+#include <limits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define DEBUG_TYPE "jitlink"
+
+using namespace llvm;
+
+namespace llvm {
+namespace jitlink {
+
+static const sys::Memory::ProtectionFlags ReadWrite =
+    static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
+                                              sys::Memory::MF_WRITE);
+
+class SlabMemoryManager::SlabInFlightAlloc
+    : public JITLinkMemoryManager::InFlightAlloc {
+public:
+  SlabInFlightAlloc(SlabMemoryManager &MemMgr, LinkGraph &G, BasicLayout BL,
+                    Range StandardSegs, Range FinalizeSegs)
+      : MemMgr(MemMgr), G(G), BL(std::move(BL)), StandardSegs(StandardSegs),
+        FinalizeSegs(FinalizeSegs) {}
+
+  void finalize(OnFinalizedFunction OnFinalized) override {
+    // Apply memory protections to all segments.
+    if (auto Err = applyProtections()) {
+      OnFinalized(std::move(Err));
+      return;
+    }
+
+    // Run finalization actions.
+    auto DeallocActions = runFinalizeActions(G.allocActions());
+    if (!DeallocActions) {
+      OnFinalized(DeallocActions.takeError());
+      return;
+    }
+
+    // Recycle the finalize segments.
+    if (auto Err = MemMgr.releaseRange(FinalizeSegs)) {
+      OnFinalized(std::move(Err));
+      return;
+    }
+
+    OnFinalized(
+        MemMgr.createFinalizedAlloc(StandardSegs, std::move(*DeallocActions)));
+  }
+
+  void abandon(OnAbandonedFunction OnAbandoned) override {
+    OnAbandoned(joinErrors(MemMgr.releaseRange(FinalizeSegs),
+                           MemMgr.releaseRange(StandardSegs)));
+  }
+
+private:
+  Error applyProtections() {
+    for (auto &KV : BL.segments()) {
+      const auto &AG = KV.first;
+      auto &Seg = KV.second;
+
+      auto Prot = toSysMemoryProtectionFlags(AG.getMemProt());
+
+      uint64_t SegSize =
+          alignTo(Seg.ContentSize + Seg.ZeroFillSize, MemMgr.PageSize);
+      sys::MemoryBlock MB(Seg.Addr.toPtr<void *>(), SegSize);
+      if (auto EC = sys::Memory::protectMappedMemory(MB, Prot))
+        return errorCodeToError(EC);
+      if (Prot & sys::Memory::MF_EXEC)
+        sys::Memory::InvalidateInstructionCache(MB.base(), MB.allocatedSize());
+    }
+    return Error::success();
+  }
+
+  SlabMemoryManager &MemMgr;
+  LinkGraph &G;
+  BasicLayout BL;
+  Range StandardSegs;
+  Range FinalizeSegs;
+};
+
+Expected<std::unique_ptr<SlabMemoryManager>>
+SlabMemoryManager::Create(uint64_t SlabSize, bool DualMapping) {
+#if !defined(__linux__)
+  if (DualMapping)
+    return make_error<JITLinkError>(
+        "Dual mapping is not supported on this platform");
+#endif
+  auto PageSize = sys::Process::getPageSize();
+  if (!PageSize)
+    return PageSize.takeError();
+  if (!isPowerOf2_64((uint64_t)*PageSize))
+    return make_error<JITLinkError>("Page size is not a power of 2");
+  if (SlabSize == 0)
+    return make_error<JITLinkError>("Slab size can not be zero");
+  return std::unique_ptr<SlabMemoryManager>(
+      new SlabMemoryManager(*PageSize, alignTo(SlabSize, *PageSize),
+                            DualMapping));
+}
+
+SlabMemoryManager::~SlabMemoryManager() {
+  for (auto &S : Slabs)
+    cantFail(unmapSlab(*S));
+}
+
+void SlabMemoryManager::allocate(const JITLinkDylib *JD, LinkGraph &G,
+                                 OnAllocatedFunction OnAllocated) {
+  BasicLayout BL(G);
+
+  auto SegsSizes = BL.getContiguousPageBasedLayoutSizes(PageSize);
+  if (!SegsSizes) {
+    OnAllocated(SegsSizes.takeError());
+    return;
+  }
+
+  if (SegsSizes->total() > std::numeric_limits<size_t>::max()) {
+    OnAllocated(make_error<JITLinkError>(
+        "Total requested size " + formatv("{0:x}", SegsSizes->total()) +
+        " for graph " + G.getName() + " exceeds address space"));
+    return;
+  }
+
+  // Allocate a single range to keep the standard and finalize segments in
+  // range of each other. The finalize segments go last, so that they leave a
+  // hole at the end of the graph when they are freed.
+  auto R = allocateRange(SegsSizes->total());
+  if (!R) {
+    OnAllocated(R.takeError());
+    return;
+  }
+
+  // Recycled ranges are not zeroed yet.
+  memset(R->getWorkingMem(), 0, R->Size);
+
+  Range StandardSegs = {R->S, R->Offset, SegsSizes->StandardSegs};
+  Range FinalizeSegs = {R->S, R->Offset + SegsSizes->StandardSegs,
+                        SegsSizes->FinalizeSegs};
+
+  LLVM_DEBUG({
+    dbgs() << "SlabMemoryManager allocated:\n";
+    dbgs() << formatv("  [ {0:x16} -- {1:x16} ]",
+                      orc::ExecutorAddr::fromPtr(R->getExecMem()),
+                      orc::ExecutorAddr::fromPtr(R->getExecMem() + R->Size))
+           << " for " << G.getName() << "\n";
+  });
+
+  // Assign addresses.
+  uint64_t NextStandardSegOffset = 0;
+  uint64_t NextFinalizeSegOffset = 0;
+  for (auto &KV : BL.segments()) {
+    auto &AG = KV.first;
+    auto &Seg = KV.second;
+
+    bool IsStandard = AG.getMemDeallocPolicy() == MemDeallocPolicy::Standard;
+    Range &SegsRange = IsStandard ? StandardSegs : FinalizeSegs;
+    uint64_t &NextSegOffset =
+        IsStandard ? NextStandardSegOffset : NextFinalizeSegOffset;
+
+    Seg.WorkingMem = SegsRange.getWorkingMem() + NextSegOffset;
+    Seg.Addr = orc::ExecutorAddr::fromPtr(SegsRange.getExecMem() +
+                                          NextSegOffset);
+
+    NextSegOffset += alignTo(Seg.ContentSize + Seg.ZeroFillSize, PageSize);
+  }
+
+  if (auto Err = BL.apply()) {
+    OnAllocated(joinErrors(std::move(Err), releaseRange(*R)));
+    return;
+  }
+
+  OnAllocated(std::make_unique<SlabInFlightAlloc>(*this, G, std::move(BL),
+                                                  StandardSegs, FinalizeSegs));
+}
+
+void SlabMemoryManager::deallocate(std::vector<FinalizedAlloc> Allocs,
+                                   OnDeallocatedFunction OnDeallocated) {
+  std::vector<FinalizedAllocInfo> Infos;
+  {
+    std::lock_guard<std::mutex> Lock(SlabsMutex);
+    for (auto &Alloc : Allocs) {
+      auto *FA = Alloc.release().toPtr<FinalizedAllocInfo *>();
+      Infos.push_back(std::move(*FA));
+      FA->~FinalizedAllocInfo();
+      FinalizedAllocInfos.Deallocate(FA);
+    }
+  }
+
+  Error DeallocErr = Error::success();
+  while (!Infos.empty()) {
+    auto &Info = Infos.back();
+
+    /// Run any deallocate calls.
+    while (!Info.DeallocActions.empty()) {
+      if (auto Err = Info.DeallocActions.back().runWithSPSRetErrorMerged())
+        DeallocErr = joinErrors(std::move(DeallocErr), std::move(Err));
+      Info.DeallocActions.pop_back();
+    }
+
+    DeallocErr = joinErrors(std::move(DeallocErr), releaseRange(Info.R));
+    Infos.pop_back();
+  }
+
+  OnDeallocated(std::move(DeallocErr));
+}
+
+size_t SlabMemoryManager::getNumSlabs() {
+  std::lock_guard<std::mutex> Lock(SlabsMutex);
+  return Slabs.size();
+}
+
+Error SlabMemoryManager::mapSlab(Slab &S, uint64_t Size) {
+  S.Size = Size;
+
+  if (!DualMapping) {
+    std::error_code EC;
+    auto MB = sys::Memory::allocateMappedMemory(
+        Size, nullptr, ReadWrite | sys::Memory::MF_HUGE_HINT, EC);
+    if (EC)
+      return errorCodeToError(EC);
+    S.WorkingMem = S.ExecMem = static_cast<char *>(MB.base());
+    return Error::success();
+  }
+
+#if defined(__linux__)
+  auto SystemError = [](const Twine &What) {
+    std::error_code EC(errno, std::generic_category());
+    return make_error<StringError>(What + ": " + EC.message(), EC);
+  };
+
+  // Both views map the same anonymous file. The file is not needed anymore
+  // once it is mapped.
+  int FD = memfd_create("llvm-jitlink-slab", MFD_CLOEXEC);
+  if (FD < 0)
+    return SystemError("Cannot create slab");
+  if (ftruncate(FD, Size) < 0) {
+    auto Err = SystemError("Cannot resize slab");
+    close(FD);
+    return Err;
+  }
+
+  void *WorkingMem =
+      mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, FD, 0);
+  if (WorkingMem == MAP_FAILED) {
+    auto Err = SystemError("Cannot map slab");
+    close(FD);
+    return Err;
+  }
+  void *ExecMem =
+      mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, FD, 0);
+  if (ExecMem == MAP_FAILED) {
+    auto Err = SystemError("Cannot map slab");
+    munmap(WorkingMem, Size);
+    close(FD);
+    return Err;
+  }
+  close(FD);
+
+#if defined(MADV_HUGEPAGE)
+  madvise(WorkingMem, Size, MADV_HUGEPAGE);
+  madvise(ExecMem, Size, MADV_HUGEPAGE);
+#endif
+
+  S.WorkingMem = static_cast<char *>(WorkingMem);
+  S.ExecMem = static_cast<char *>(ExecMem);
+  return Error::success();
+#else
+  llvm_unreachable("Dual mapping is rejected by Create");
+#endif
+}
+
+Error SlabMemoryManager::unmapSlab(Slab &S) {
+  sys::MemoryBlock ExecMB(S.ExecMem, S.Size);
+  std::error_code EC = sys::Memory::releaseMappedMemory(ExecMB);
+  if (!EC && S.WorkingMem != S.ExecMem) {
+    sys::MemoryBlock WorkingMB(S.WorkingMem, S.Size);
+    EC = sys::Memory::releaseMappedMemory(WorkingMB);
+  }
+  return errorCodeToError(EC);
+}
+
+Expected<SlabMemoryManager::Range>
+SlabMemoryManager::allocateRange(uint64_t Size) {
+  std::lock_guard<std::mutex> Lock(SlabsMutex);
+
+  // Take the first fit, in the order the slabs were mapped, to pack the
+  // allocations in the oldest slabs.
+  for (auto &S : Slabs) {
+    for (auto I = S->FreeRanges.begin(), E = S->FreeRanges.end(); I != E;
+         ++I) {
+      if (I->second < Size)
+        continue;
+      Range R = {S.get(), I->first, Size};
+      uint64_t Remaining = I->second - Size;
+      S->FreeRanges.erase(I);
+      if (Remaining)
+        S->FreeRanges[R.Offset + Size] = Remaining;
+      return R;
+    }
+  }
+
+  auto S = std::make_unique<Slab>();
+  if (auto Err = mapSlab(*S, std::max(SlabSize, Size)))
+    return std::move(Err);
+  if (S->Size > Size)
+    S->FreeRanges[Size] = S->Size - Size;
+  Range R = {S.get(), 0, Size};
+  Slabs.push_back(std::move(S));
+  return R;
+}
+
+Error SlabMemoryManager::releaseRange(Range R) {
+  if (R.Size == 0)
+    return Error::success();
+
+  // Make the range writable again for the next allocation.
+  sys::MemoryBlock MB(R.getExecMem(), R.Size);
+  if (auto EC = sys::Memory::protectMappedMemory(MB, ReadWrite))
+    return errorCodeToError(EC);
+
+  std::lock_guard<std::mutex> Lock(SlabsMutex);
+  auto &FreeRanges = R.S->FreeRanges;
+  auto Next = FreeRanges.lower_bound(R.Offset);
+  assert((Next == FreeRanges.end() || Next->first >= R.Offset + R.Size) &&
+         "Range is already free");
+
+  // Merge with the previous and next free ranges.
+  if (Next != FreeRanges.begin()) {
+    auto Prev = std::prev(Next);
+    assert(Prev->first + Prev->second <= R.Offset && "Range is already free");
+    if (Prev->first + Prev->second == R.Offset) {
+      R.Offset = Prev->first;
+      R.Size += Prev->second;
+      FreeRanges.erase(Prev);
+    }
+  }
+  if (Next != FreeRanges.end() && Next->first == R.Offset + R.Size) {
+    R.Size += Next->second;
+    FreeRanges.erase(Next);
+  }
+  FreeRanges[R.Offset] = R.Size;
+  return Error::success();
+}
+
+JITLinkMemoryManager::FinalizedAlloc SlabMemoryManager::createFinalizedAlloc(
+    Range R, std::vector<orc::shared::WrapperFunctionCall> DeallocActions) {
+  std::lock_guard<std::mutex> Lock(SlabsMutex);
+  auto *FA = FinalizedAllocInfos.Allocate<FinalizedAllocInfo>();
+  new (FA) FinalizedAllocInfo({R, std::move(DeallocActions)});
+  return FinalizedAlloc(orc::ExecutorAddr::fromPtr(FA));
+}
+
+} // end namespace jitlink
+} // end namespace llvm
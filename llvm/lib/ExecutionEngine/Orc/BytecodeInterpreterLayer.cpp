@@ -0,0 +1,1545 @@
+//===--- BytecodeInterpreterLayer.cpp - Interpreted IR layer --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/BytecodeInterpreterLayer.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/ExecutionEngine/Orc/Mangling.h"
+#include "llvm/IR/GetElementPtrTypeIterator.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Operator.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/SwapByteOrder.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+#define DEBUG_TYPE "orc"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+// Use computed gotos to dispatch the bytecode where they are available: with
+// one indirect branch per handler instead of a single shared one, the branch
+// predictor can learn the sequences of instructions.
+#if defined(__GNUC__)
+#define BYTECODE_THREADED_DISPATCH 1
+#endif
+
+namespace {
+
+// Instructions are sequences of 32 bit words: the opcode, followed by the
+// operands listed below. Values live in registers of 64 bits, which hold
+// integers zero extended from their width, pointers, and the bits of floating
+// point values. Widths (W) are in bits.
+#define BYTECODE_OPCODES(X)                                                    \
+  /* Dst Src */                                                                \
+  X(Mov)                                                                       \
+  /* Dst LHS RHS W */                                                          \
+  X(Add) X(Sub) X(Mul) X(UDiv) X(SDiv) X(URem) X(SRem) X(Shl) X(LShr) X(AShr) \
+  X(And) X(Or) X(Xor) X(ICmpEQ) X(ICmpNE) X(ICmpUGT) X(ICmpUGE) X(ICmpULT)     \
+  X(ICmpULE) X(ICmpSGT) X(ICmpSGE) X(ICmpSLT) X(ICmpSLE) X(FAdd) X(FSub)       \
+  X(FMul) X(FDiv) X(FRem)                                                      \
+  /* Dst Src W */                                                              \
+  X(FNeg) X(Trunc)                                                             \
+  /* Dst LHS RHS Predicate W */                                                \
+  X(FCmp)                                                                      \
+  /* Dst Src SrcW DstW */                                                      \
+  X(SExt) X(FPToSI) X(FPToUI) X(SIToFP) X(UIToFP)                              \
+  /* Dst Src */                                                                \
+  X(FPTrunc) X(FPExt)                                                          \
+  /* Dst Cond TrueVal FalseVal */                                              \
+  X(Select)                                                                    \
+  /* Dst Ptr Size W */                                                         \
+  X(Load)                                                                      \
+  /* Ptr Val Size */                                                           \
+  X(Store)                                                                     \
+  /* Dst Offset */                                                             \
+  X(FrameAddr)                                                                 \
+  /* Dst Ptr Index Scale IndexW */                                             \
+  X(Gep)                                                                       \
+  /* Target */                                                                 \
+  X(Br)                                                                        \
+  /* Cond TrueTarget FalseTarget */                                            \
+  X(CondBr)                                                                    \
+  /* Val NumCases DefaultTarget, then NumCases times: ValLo ValHi Target */    \
+  X(Switch)                                                                    \
+  /* Dst Callee NumArgs, then NumArgs times: Arg */                            \
+  X(Call)                                                                      \
+  /* Dst Fn NumArgs RetW, then NumArgs times: Arg SExtW */                     \
+  X(CallNative)                                                                \
+  /* Val */                                                                    \
+  X(Ret)                                                                       \
+  /* No operands */                                                            \
+  X(RetVoid) X(Unreachable)
+
+namespace bc {
+enum Opcode : uint32_t {
+#define BYTECODE_OPCODE_ENUM(Name) Name,
+  BYTECODE_OPCODES(BYTECODE_OPCODE_ENUM)
+#undef BYTECODE_OPCODE_ENUM
+};
+} // end namespace bc
+
+constexpr unsigned PtrBits = sizeof(void *) * 8;
+
+/// Maximum number of arguments of the entry points and of native calls.
+constexpr unsigned MaxNativeArgs = 6;
+
+/// Number of entry points for each number of arguments.
+constexpr unsigned NumEntrySlots = 128;
+
+/// A function translated to bytecode.
+struct BCFunction {
+  std::string Name;
+  std::vector<uint32_t> Code;
+  /// Initial values of the registers from ConstBase on.
+  std::vector<uint64_t> Consts;
+  /// Functions called by Call instructions.
+  std::vector<const BCFunction *> Callees;
+  /// Widths of the arguments, which are in the first registers.
+  SmallVector<unsigned, 4> ArgWidths;
+  uint32_t ConstBase = 0;
+  /// Size and alignment of the memory for the static allocas.
+  uint64_t FrameSize = 0;
+  uint64_t FrameAlign = 1;
+  unsigned RetWidth = 0;
+  bool RetSExt = false;
+  /// The entry point calling this function from native code, as number of
+  /// arguments and slot, if any.
+  Optional<std::pair<unsigned, unsigned>> Entry;
+};
+
+} // end anonymous namespace
+
+static uint64_t mask(uint64_t V, unsigned W) {
+  return W >= 64 ? V : V & maskTrailingOnes<uint64_t>(W);
+}
+
+static uint64_t sdiv(uint64_t A, uint64_t B, unsigned W) {
+  int64_t SA = SignExtend64(A, W), SB = SignExtend64(B, W);
+  // Avoid the overflow of the minimum value divided by -1. Its result is
+  // poison in the IR.
+  if (SB == -1)
+    return 0 - static_cast<uint64_t>(SA);
+  return static_cast<uint64_t>(SA / SB);
+}
+
+static uint64_t srem(uint64_t A, uint64_t B, unsigned W) {
+  int64_t SA = SignExtend64(A, W), SB = SignExtend64(B, W);
+  if (SB == -1)
+    return 0;
+  return static_cast<uint64_t>(SA % SB);
+}
+
+static double toDouble(uint64_t V, unsigned W) {
+  if (W == 32)
+    return bit_cast<float>(static_cast<uint32_t>(V));
+  return bit_cast<double>(V);
+}
+
+static uint64_t fromDouble(double D, unsigned W) {
+  if (W == 32)
+    return bit_cast<uint32_t>(static_cast<float>(D));
+  return bit_cast<uint64_t>(D);
+}
+
+template <typename IntT> static uint64_t intToFP(IntT X, unsigned W) {
+  if (W == 32)
+    return bit_cast<uint32_t>(static_cast<float>(X));
+  return bit_cast<uint64_t>(static_cast<double>(X));
+}
+
+static bool fcmp(double X, double Y, unsigned Pred) {
+  bool Unordered = std::isnan(X) || std::isnan(Y);
+  switch (Pred) {
+  case CmpInst::FCMP_FALSE:
+    return false;
+  case CmpInst::FCMP_OEQ:
+    return !Unordered && X == Y;
+  case CmpInst::FCMP_OGT:
+    return !Unordered && X > Y;
+  case CmpInst::FCMP_OGE:
+    return !Unordered && X >= Y;
+  case CmpInst::FCMP_OLT:
+    return !Unordered && X < Y;
+  case CmpInst::FCMP_OLE:
+    return !Unordered && X <= Y;
+  case CmpInst::FCMP_ONE:
+    return !Unordered && X != Y;
+  case CmpInst::FCMP_ORD:
+    return !Unordered;
+  case CmpInst::FCMP_UNO:
+    return Unordered;
+  case CmpInst::FCMP_UEQ:
+    return Unordered || X == Y;
+  case CmpInst::FCMP_UGT:
+    return Unordered || X > Y;
+  case CmpInst::FCMP_UGE:
+    return Unordered || X >= Y;
+  case CmpInst::FCMP_ULT:
+    return Unordered || X < Y;
+  case CmpInst::FCMP_ULE:
+    return Unordered || X <= Y;
+  case CmpInst::FCMP_UNE:
+    return Unordered || X != Y;
+  default:
+    return true;
+  }
+}
+
+static uint64_t loadValue(const char *P, unsigned Size) {
+  switch (Size) {
+  case 1:
+    return *reinterpret_cast<const uint8_t *>(P);
+  case 2: {
+    uint16_t V;
+    memcpy(&V, P, sizeof(V));
+    return V;
+  }
+  case 4: {
+    uint32_t V;
+    memcpy(&V, P, sizeof(V));
+    return V;
+  }
+  default: {
+    uint64_t V;
+    memcpy(&V, P, sizeof(V));
+    return V;
+  }
+  }
+}
+
+static void storeValue(char *P, uint64_t V, unsigned Size) {
+  switch (Size) {
+  case 1:
+    *reinterpret_cast<uint8_t *>(P) = static_cast<uint8_t>(V);
+    return;
+  case 2: {
+    uint16_t X = static_cast<uint16_t>(V);
+    memcpy(P, &X, sizeof(X));
+    return;
+  }
+  case 4: {
+    uint32_t X = static_cast<uint32_t>(V);
+    memcpy(P, &X, sizeof(X));
+    return;
+  }
+  default:
+    memcpy(P, &V, sizeof(V));
+    return;
+  }
+}
+
+static uintptr_t callNative(uint64_t Addr, const uintptr_t *A, unsigned N) {
+  void *P = reinterpret_cast<void *>(static_cast<uintptr_t>(Addr));
+  switch (N) {
+  case 0:
+    return reinterpret_cast<uintptr_t (*)()>(P)();
+  case 1:
+    return reinterpret_cast<uintptr_t (*)(uintptr_t)>(P)(A[0]);
+  case 2:
+    return reinterpret_cast<uintptr_t (*)(uintptr_t, uintptr_t)>(P)(A[0],
+                                                                    A[1]);
+  case 3:
+    return reinterpret_cast<uintptr_t (*)(uintptr_t, uintptr_t, uintptr_t)>(
+        P)(A[0], A[1], A[2]);
+  case 4:
+    return reinterpret_cast<uintptr_t (*)(uintptr_t, uintptr_t, uintptr_t,
+                                          uintptr_t)>(P)(A[0], A[1], A[2],
+                                                         A[3]);
+  case 5:
+    return reinterpret_cast<uintptr_t (*)(uintptr_t, uintptr_t, uintptr_t,
+                                          uintptr_t, uintptr_t)>(P)(
+        A[0], A[1], A[2], A[3], A[4]);
+  default:
+    return reinterpret_cast<uintptr_t (*)(uintptr_t, uintptr_t, uintptr_t,
+                                          uintptr_t, uintptr_t, uintptr_t)>(
+        P)(A[0], A[1], A[2], A[3], A[4], A[5]);
+  }
+}
+
+#if BYTECODE_THREADED_DISPATCH
+// Labels as values are a GNU extension.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+/// Runs \p F on \p Args, and returns its result.
+static uint64_t run(const BCFunction &F, const uint64_t *Args) {
+  SmallVector<uint64_t, 32> Regs(F.ConstBase + F.Consts.size());
+  for (unsigned I = 0, E = F.ArgWidths.size(); I != E; ++I)
+    Regs[I] = mask(Args[I], F.ArgWidths[I]);
+  llvm::copy(F.Consts, Regs.begin() + F.ConstBase);
+
+  SmallVector<char, 128> Frame;
+  uintptr_t FrameBase = 0;
+  if (F.FrameSize) {
+    Frame.resize(F.FrameSize + F.FrameAlign - 1);
+    FrameBase = alignAddr(Frame.data(), Align(F.FrameAlign));
+  }
+
+  uint64_t *R = Regs.data();
+  const uint32_t *Code = F.Code.data();
+  const uint32_t *IP = Code;
+
+#if BYTECODE_THREADED_DISPATCH
+  static const void *const Handlers[] = {
+#define BYTECODE_OPCODE_LABEL(Name) &&Op_##Name,
+      BYTECODE_OPCODES(BYTECODE_OPCODE_LABEL)
+#undef BYTECODE_OPCODE_LABEL
+  };
+#define DISPATCH() goto *Handlers[*IP]
+#define OP(Name) Op_##Name:
+  DISPATCH();
+#else
+#define DISPATCH() continue
+#define OP(Name) case bc::Name:
+  for (;;) {
+    switch (*IP) {
+#endif
+
+#define BINARY_OP(Name, Expr)                                                  \
+  OP(Name) {                                                                   \
+    uint64_t A = R[IP[2]], B = R[IP[3]];                                       \
+    unsigned W = IP[4];                                                        \
+    (void)W;                                                                   \
+    R[IP[1]] = mask(Expr, W);                                                  \
+    IP += 5;                                                                   \
+    DISPATCH();                                                                \
+  }
+#define SIGNED_CMP_OP(Name, Op)                                                \
+  BINARY_OP(Name, SignExtend64(A, W) Op SignExtend64(B, W))
+#define FP_BINARY_OP(Name, Expr)                                               \
+  OP(Name) {                                                                   \
+    unsigned W = IP[4];                                                        \
+    double X = toDouble(R[IP[2]], W), Y = toDouble(R[IP[3]], W);               \
+    R[IP[1]] = fromDouble(Expr, W);                                            \
+    IP += 5;                                                                   \
+    DISPATCH();                                                                \
+  }
+
+  OP(Mov) {
+    R[IP[1]] = R[IP[2]];
+    IP += 3;
+    DISPATCH();
+  }
+  BINARY_OP(Add, A + B)
+  BINARY_OP(Sub, A - B)
+  BINARY_OP(Mul, A * B)
+  BINARY_OP(UDiv, A / B)
+  BINARY_OP(SDiv, sdiv(A, B, W))
+  BINARY_OP(URem, A % B)
+  BINARY_OP(SRem, srem(A, B, W))
+  // Shifts by the width or more are poison in the IR, but undefined in C++.
+  BINARY_OP(Shl, B >= W ? 0 : A << B)
+  BINARY_OP(LShr, B >= W ? 0 : A >> B)
+  BINARY_OP(AShr, static_cast<uint64_t>(SignExtend64(A, W) >>
+                                        std::min<uint64_t>(B, W - 1)))
+  BINARY_OP(And, A & B)
+  BINARY_OP(Or, A | B)
+  BINARY_OP(Xor, A ^ B)
+  BINARY_OP(ICmpEQ, A == B)
+  BINARY_OP(ICmpNE, A != B)
+  BINARY_OP(ICmpUGT, A > B)
+  BINARY_OP(ICmpUGE, A >= B)
+  BINARY_OP(ICmpULT, A < B)
+  BINARY_OP(ICmpULE, A <= B)
+  SIGNED_CMP_OP(ICmpSGT, >)
+  SIGNED_CMP_OP(ICmpSGE, >=)
+  SIGNED_CMP_OP(ICmpSLT, <)
+  SIGNED_CMP_OP(ICmpSLE, <=)
+  FP_BINARY_OP(FAdd, X + Y)
+  FP_BINARY_OP(FSub, X - Y)
+  FP_BINARY_OP(FMul, X * Y)
+  FP_BINARY_OP(FDiv, X / Y)
+  FP_BINARY_OP(FRem, std::fmod(X, Y))
+  OP(FNeg) {
+    R[IP[1]] = R[IP[2]] ^ (uint64_t(1) << (IP[3] - 1));
+    IP += 4;
+    DISPATCH();
+  }
+  OP(Trunc) {
+    R[IP[1]] = mask(R[IP[2]], IP[3]);
+    IP += 4;
+    DISPATCH();
+  }
+  OP(FCmp) {
+    unsigned W = IP[5];
+    R[IP[1]] = fcmp(toDouble(R[IP[2]], W), toDouble(R[IP[3]], W), IP[4]);
+    IP += 6;
+    DISPATCH();
+  }
+  OP(SExt) {
+    R[IP[1]] = mask(SignExtend64(R[IP[2]], IP[3]), IP[4]);
+    IP += 5;
+    DISPATCH();
+  }
+  OP(FPToSI) {
+    double D = toDouble(R[IP[2]], IP[3]);
+    R[IP[1]] = mask(static_cast<uint64_t>(static_cast<int64_t>(D)), IP[4]);
+    IP += 5;
+    DISPATCH();
+  }
+  OP(FPToUI) {
+    double D = toDouble(R[IP[2]], IP[3]);
+    R[IP[1]] = mask(static_cast<uint64_t>(D), IP[4]);
+    IP += 5;
+    DISPATCH();
+  }
+  OP(SIToFP) {
+    R[IP[1]] = intToFP(SignExtend64(R[IP[2]], IP[3]), IP[4]);
+    IP += 5;
+    DISPATCH();
+  }
+  OP(UIToFP) {
+    R[IP[1]] = intToFP(R[IP[2]], IP[4]);
+    IP += 5;
+    DISPATCH();
+  }
+  OP(FPTrunc) {
+    R[IP[1]] = fromDouble(toDouble(R[IP[2]], 64), 32);
+    IP += 3;
+    DISPATCH();
+  }
+  OP(FPExt) {
+    R[IP[1]] = fromDouble(toDouble(R[IP[2]], 32), 64);
+    IP += 3;
+    DISPATCH();
+  }
+  OP(Select) {
+    R[IP[1]] = (R[IP[2]] & 1) ? R[IP[3]] : R[IP[4]];
+    IP += 5;
+    DISPATCH();
+  }
+  OP(Load) {
+    const char *P = reinterpret_cast<const char *>(R[IP[2]]);
+    R[IP[1]] = mask(loadValue(P, IP[3]), IP[4]);
+    IP += 5;
+    DISPATCH();
+  }
+  OP(Store) {
+    storeValue(reinterpret_cast<char *>(R[IP[1]]), R[IP[2]], IP[3]);
+    IP += 4;
+    DISPATCH();
+  }
+  OP(FrameAddr) {
+    R[IP[1]] = FrameBase + IP[2];
+    IP += 3;
+    DISPATCH();
+  }
+  OP(Gep) {
+    uint64_t Index = static_cast<uint64_t>(SignExtend64(R[IP[3]], IP[5]));
+    R[IP[1]] = mask(R[IP[2]] + Index * R[IP[4]], PtrBits);
+    IP += 6;
+    DISPATCH();
+  }
+  OP(Br) {
+    IP = Code + IP[1];
+    DISPATCH();
+  }
+  OP(CondBr) {
+    IP = Code + ((R[IP[1]] & 1) ? IP[2] : IP[3]);
+    DISPATCH();
+  }
+  OP(Switch) {
+    uint64_t V = R[IP[1]];
+    uint32_t Target = IP[3];
+    for (const uint32_t *Case = IP + 4, *End = Case + 3 * IP[2]; Case != End;
+         Case += 3)
+      if (V == (Case[0] | uint64_t(Case[1]) << 32)) {
+        Target = Case[2];
+        break;
+      }
+    IP = Code + Target;
+    DISPATCH();
+  }
+  OP(Call) {
+    unsigned NumArgs = IP[3];
+    SmallVector<uint64_t, 8> CallArgs(NumArgs);
+    for (unsigned I = 0; I != NumArgs; ++I)
+      CallArgs[I] = R[IP[4 + I]];
+    R[IP[1]] = run(*F.Callees[IP[2]], CallArgs.data());
+    IP += 4 + NumArgs;
+    DISPATCH();
+  }
+  OP(CallNative) {
+    unsigned NumArgs = IP[3];
+    uintptr_t CallArgs[MaxNativeArgs];
+    for (unsigned I = 0; I != NumArgs; ++I) {
+      uint64_t V = R[IP[5 + 2 * I]];
+      if (unsigned SExtW = IP[6 + 2 * I])
+        V = static_cast<uint64_t>(SignExtend64(V, SExtW));
+      CallArgs[I] = static_cast<uintptr_t>(V);
+    }
+    uint64_t Result = callNative(R[IP[2]], CallArgs, NumArgs);
+    R[IP[1]] = IP[4] ? mask(Result, IP[4]) : 0;
+    IP += 5 + 2 * NumArgs;
+    DISPATCH();
+  }
+  OP(Ret) { return R[IP[1]]; }
+  OP(RetVoid) { return 0; }
+  OP(Unreachable) {
+    report_fatal_error("Unreachable executed in interpreted function " +
+                       Twine(F.Name));
+  }
+
+#if !BYTECODE_THREADED_DISPATCH
+    }
+    llvm_unreachable("Unknown bytecode opcode");
+  }
+#endif
+
+#undef FP_BINARY_OP
+#undef SIGNED_CMP_OP
+#undef BINARY_OP
+#undef OP
+#undef DISPATCH
+}
+
+#if BYTECODE_THREADED_DISPATCH
+#pragma GCC diagnostic pop
+#endif
+
+/// The functions called by the entry points, per number of arguments.
+static std::atomic<const BCFunction *> EntryTargets[MaxNativeArgs + 1]
+                                                   [NumEntrySlots];
+
+namespace {
+
+template <size_t> using EntryArg = uintptr_t;
+
+template <unsigned Slot, typename Indices> struct EntryPoint;
+
+template <unsigned Slot, size_t... Is>
+struct EntryPoint<Slot, std::index_sequence<Is...>> {
+  static uintptr_t call(EntryArg<Is>... Args) {
+    const BCFunction *F =
+        EntryTargets[sizeof...(Is)][Slot].load(std::memory_order_acquire);
+    uint64_t ArgValues[] = {static_cast<uint64_t>(Args)..., 0};
+    uint64_t Result = run(*F, ArgValues);
+    if (F->RetSExt)
+      Result = static_cast<uint64_t>(SignExtend64(Result, F->RetWidth));
+    return static_cast<uintptr_t>(Result);
+  }
+};
+
+} // end anonymous namespace
+
+template <size_t NumArgs, size_t... Slots>
+static JITTargetAddress getEntryPoint(unsigned Slot,
+                                      std::index_sequence<Slots...>) {
+  using ArgIndices = std::make_index_sequence<NumArgs>;
+  using EntryFn = decltype(&EntryPoint<0, ArgIndices>::call);
+  static const EntryFn Entries[] = {&EntryPoint<Slots, ArgIndices>::call...};
+  return pointerToJITTargetAddress(Entries[Slot]);
+}
+
+static JITTargetAddress getEntryPointAddress(unsigned NumArgs, unsigned Slot) {
+  using Slots = std::make_index_sequence<NumEntrySlots>;
+  switch (NumArgs) {
+  case 0:
+    return getEntryPoint<0>(Slot, Slots());
+  case 1:
+    return getEntryPoint<1>(Slot, Slots());
+  case 2:
+    return getEntryPoint<2>(Slot, Slots());
+  case 3:
+    return getEntryPoint<3>(Slot, Slots());
+  case 4:
+    return getEntryPoint<4>(Slot, Slots());
+  case 5:
+    return getEntryPoint<5>(Slot, Slots());
+  default:
+    return getEntryPoint<6>(Slot, Slots());
+  }
+}
+
+static Optional<unsigned> allocateEntrySlot(unsigned NumArgs,
+                                            const BCFunction *F) {
+  for (unsigned Slot = 0; Slot != NumEntrySlots; ++Slot) {
+    const BCFunction *Free = nullptr;
+    if (EntryTargets[NumArgs][Slot].compare_exchange_strong(
+            Free, F, std::memory_order_acq_rel))
+      return Slot;
+  }
+  return None;
+}
+
+static Error unsupported(const Twine &What) {
+  return make_error<StringError>("unsupported " + What,
+                                 inconvertibleErrorCode());
+}
+
+/// Returns the width of a register holding a value of type \p Ty, or None if
+/// values of this type can not be interpreted.
+static Optional<unsigned> getWidth(Type *Ty) {
+  if (auto *ITy = dyn_cast<IntegerType>(Ty)) {
+    if (ITy->getBitWidth() > 64)
+      return None;
+    return ITy->getBitWidth();
+  }
+  if (auto *PTy = dyn_cast<PointerType>(Ty)) {
+    if (PTy->getAddressSpace() != 0)
+      return None;
+    return PtrBits;
+  }
+  if (Ty->isFloatTy())
+    return 32;
+  if (Ty->isDoubleTy())
+    return 64;
+  return None;
+}
+
+/// Returns true if values of type \p Ty can be passed to and returned from
+/// native code in an integer register.
+static bool isNativeType(Type *Ty) {
+  if (!Ty->isIntegerTy() && !Ty->isPointerTy())
+    return false;
+  Optional<unsigned> W = getWidth(Ty);
+  return W && *W <= PtrBits;
+}
+
+/// Returns true if functions of type \p FTy can be called through an entry
+/// point, or from the interpreter through callNative.
+static bool isNativeSignature(FunctionType *FTy) {
+  if (FTy->isVarArg() || FTy->getNumParams() > MaxNativeArgs)
+    return false;
+  if (!FTy->getReturnType()->isVoidTy() && !isNativeType(FTy->getReturnType()))
+    return false;
+  return llvm::all_of(FTy->params(), isNativeType);
+}
+
+class BytecodeInterpreterLayer::InterpretedModule {
+public:
+  ~InterpretedModule();
+
+  /// Translates the definitions of \p M that \p R is responsible for.
+  /// Returns an error if \p M can not be interpreted.
+  Error compile(ExecutionSession &ES, MaterializationResponsibility &R,
+                Module &M);
+
+  /// Addresses of the symbols that the module defines.
+  const SymbolMap &getDefinitions() const { return Definitions; }
+
+  /// Symbols that the module refers to, but does not define.
+  SymbolLookupSet getExternalSymbols() const;
+
+  /// Writes the addresses of the symbols looked up for getExternalSymbols.
+  void applyFixups(const SymbolMap &Addrs);
+
+private:
+  class FunctionCompiler;
+
+  /// A constant address or value: the address of GV, if any, plus Offset.
+  struct ConstValue {
+    const GlobalValue *GV = nullptr;
+    uint64_t Offset = 0;
+  };
+
+  /// A use of the address of an external symbol, either in a constant
+  /// register of a function, or in the memory of a global variable.
+  struct Fixup {
+    SymbolStringPtr Name;
+    uint64_t Addend;
+    BCFunction *F;
+    uint32_t Const;
+    char *Mem;
+    unsigned Size;
+  };
+
+  Error evaluate(const Constant *C, ConstValue &CV);
+  Error initialize(const Constant *C, char *Mem);
+  void setValue(const ConstValue &CV, BCFunction *F, uint32_t Const, char *Mem,
+                unsigned Size);
+
+  const DataLayout *DL = nullptr;
+  std::unique_ptr<MangleAndInterner> Mangle;
+  BumpPtrAllocator GlobalMem;
+  std::vector<std::unique_ptr<BCFunction>> Functions;
+  DenseMap<const Function *, BCFunction *> BCFunctions;
+  /// Addresses of the global values defined by this module.
+  DenseMap<const GlobalValue *, uint64_t> LocalAddrs;
+  DenseMap<SymbolStringPtr, SymbolLookupFlags> Externals;
+  std::vector<Fixup> Fixups;
+  SymbolMap Definitions;
+};
+
+/// Translates the IR of one function to bytecode.
+class BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler {
+public:
+  FunctionCompiler(InterpretedModule &IM, Function &F, BCFunction &BF)
+      : IM(IM), F(F), BF(BF), DL(*IM.DL) {}
+
+  Error compile();
+
+private:
+  void emit(std::initializer_list<uint32_t> Words) {
+    BF.Code.insert(BF.Code.end(), Words);
+  }
+
+  Expected<uint32_t> getReg(Value *V);
+  uint32_t getImmReg(uint64_t V);
+
+  /// Emits the target of a branch from \p From to \p To.
+  void emitTarget(BasicBlock *From, BasicBlock *To);
+  /// Emits the copies to the phis of \p To along the edge from \p From.
+  Error emitPhiMoves(BasicBlock *From, BasicBlock *To);
+
+  Error compileInstruction(Instruction &I);
+  Error compileGEP(GetElementPtrInst &GEP);
+  Error compileCall(CallInst &CI);
+  Error compileNativeCall(CallInst &CI, uint32_t Fn, unsigned NumArgs);
+
+  InterpretedModule &IM;
+  Function &F;
+  BCFunction &BF;
+  const DataLayout &DL;
+
+  DenseMap<Value *, uint32_t> Regs;
+  DenseMap<PHINode *, uint32_t> PhiTemps;
+  DenseMap<Constant *, uint32_t> ConstRegs;
+  DenseMap<uint64_t, uint32_t> ImmRegs;
+  DenseMap<AllocaInst *, uint64_t> AllocaOffsets;
+  DenseMap<const Function *, uint32_t> CalleeIndices;
+  uint32_t ScratchReg = 0;
+
+  DenseMap<BasicBlock *, uint32_t> BlockStarts;
+  std::vector<std::pair<size_t, BasicBlock *>> BlockRefs;
+  std::vector<std::pair<size_t, std::pair<BasicBlock *, BasicBlock *>>>
+      EdgeRefs;
+};
+
+Error BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::compile() {
+  uint32_t NumRegs = 0;
+  for (Argument &A : F.args()) {
+    Optional<unsigned> W = getWidth(A.getType());
+    if (!W)
+      return unsupported("argument type");
+    Regs[&A] = NumRegs++;
+    BF.ArgWidths.push_back(*W);
+  }
+
+  if (!F.getReturnType()->isVoidTy()) {
+    Optional<unsigned> W = getWidth(F.getReturnType());
+    if (!W)
+      return unsupported("return type");
+    BF.RetWidth = *W;
+    BF.RetSExt = F.hasRetAttribute(Attribute::SExt);
+  }
+
+  // Give the static allocas a place in the frame.
+  for (Instruction &I : F.getEntryBlock()) {
+    auto *AI = dyn_cast<AllocaInst>(&I);
+    if (!AI || !AI->isStaticAlloca())
+      continue;
+    TypeSize Size = DL.getTypeAllocSize(AI->getAllocatedType());
+    if (Size.isScalable())
+      return unsupported("alloca type");
+    uint64_t Offset = alignTo(BF.FrameSize, AI->getAlign());
+    BF.FrameSize = Offset + Size.getFixedSize() *
+                                cast<ConstantInt>(AI->getArraySize())
+                                    ->getZExtValue();
+    BF.FrameAlign = std::max(BF.FrameAlign, AI->getAlign().value());
+    AllocaOffsets[AI] = Offset;
+  }
+  if (BF.FrameSize > std::numeric_limits<uint32_t>::max())
+    return unsupported("frame size");
+
+  // Number the values, then the constants.
+  for (BasicBlock &BB : F)
+    for (Instruction &I : BB) {
+      if (I.getType()->isVoidTy())
+        continue;
+      if (!getWidth(I.getType()))
+        return unsupported(Twine("type of ") + I.getOpcodeName());
+      Regs[&I] = NumRegs++;
+      if (auto *PN = dyn_cast<PHINode>(&I))
+        PhiTemps[PN] = NumRegs++;
+    }
+  ScratchReg = NumRegs++;
+  BF.ConstBase = NumRegs;
+
+  for (BasicBlock &BB : F) {
+    BlockStarts[&BB] = BF.Code.size();
+    for (Instruction &I : BB)
+      if (auto Err = compileInstruction(I))
+        return Err;
+  }
+
+  // Emit the edges with phi moves after the blocks.
+  std::map<std::pair<BasicBlock *, BasicBlock *>, uint32_t> EdgeStarts;
+  for (auto &EdgeRef : EdgeRefs) {
+    auto I = EdgeStarts.find(EdgeRef.second);
+    if (I == EdgeStarts.end()) {
+      I = EdgeStarts.insert({EdgeRef.second, BF.Code.size()}).first;
+      if (auto Err = emitPhiMoves(EdgeRef.second.first, EdgeRef.second.second))
+        return Err;
+      emit({bc::Br});
+      BlockRefs.push_back({BF.Code.size(), EdgeRef.second.second});
+      BF.Code.push_back(0);
+    }
+    BF.Code[EdgeRef.first] = I->second;
+  }
+  for (auto &BlockRef : BlockRefs)
+    BF.Code[BlockRef.first] = BlockStarts[BlockRef.second];
+
+  return Error::success();
+}
+
+Expected<uint32_t>
+BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::getReg(
+    Value *V) {
+  auto I = Regs.find(V);
+  if (I != Regs.end())
+    return I->second;
+
+  auto *C = dyn_cast<Constant>(V);
+  if (!C)
+    return unsupported("operand");
+  auto CI = ConstRegs.find(C);
+  if (CI != ConstRegs.end())
+    return CI->second;
+
+  ConstValue CV;
+  if (auto Err = IM.evaluate(C, CV))
+    return std::move(Err);
+  uint32_t Const = BF.Consts.size();
+  BF.Consts.push_back(0);
+  IM.setValue(CV, &BF, Const, nullptr, 0);
+  uint32_t Reg = BF.ConstBase + Const;
+  ConstRegs[C] = Reg;
+  return Reg;
+}
+
+uint32_t BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::
+    getImmReg(uint64_t V) {
+  auto I = ImmRegs.find(V);
+  if (I != ImmRegs.end())
+    return I->second;
+  uint32_t Reg = BF.ConstBase + BF.Consts.size();
+  BF.Consts.push_back(V);
+  ImmRegs[V] = Reg;
+  return Reg;
+}
+
+void BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::emitTarget(
+    BasicBlock *From, BasicBlock *To) {
+  size_t Pos = BF.Code.size();
+  BF.Code.push_back(0);
+  if (isa<PHINode>(To->front()))
+    EdgeRefs.push_back({Pos, {From, To}});
+  else
+    BlockRefs.push_back({Pos, To});
+}
+
+Error BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::
+    emitPhiMoves(BasicBlock *From, BasicBlock *To) {
+  SmallVector<std::pair<PHINode *, uint32_t>, 4> Moves;
+  for (PHINode &PN : To->phis()) {
+    auto Src = getReg(PN.getIncomingValueForBlock(From));
+    if (!Src)
+      return Src.takeError();
+    if (*Src != Regs[&PN])
+      Moves.push_back({&PN, *Src});
+  }
+
+  // The phis are assigned in parallel: go through temporaries if there is
+  // more than one, as a phi may use another one.
+  if (Moves.size() == 1) {
+    emit({bc::Mov, Regs[Moves[0].first], Moves[0].second});
+    return Error::success();
+  }
+  for (auto &Move : Moves)
+    emit({bc::Mov, PhiTemps[Move.first], Move.second});
+  for (auto &Move : Moves)
+    emit({bc::Mov, Regs[Move.first], PhiTemps[Move.first]});
+  return Error::success();
+}
+
+Error BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::
+    compileInstruction(Instruction &I) {
+  uint32_t Dst = I.getType()->isVoidTy() ? ScratchReg : Regs[&I];
+  // Calls and phis get the registers of their operands themselves.
+  SmallVector<uint32_t, 4> Ops;
+  if (!isa<CallInst>(I) && !isa<PHINode>(I))
+    for (Value *Op : I.operands()) {
+      if (isa<BasicBlock>(Op))
+        continue;
+      if (!getWidth(Op->getType()))
+        return unsupported(Twine("operand type of ") + I.getOpcodeName());
+      auto Reg = getReg(Op);
+      if (!Reg)
+        return Reg.takeError();
+      Ops.push_back(*Reg);
+    }
+
+  auto getOperandWidth = [&](unsigned Idx) {
+    return *getWidth(I.getOperand(Idx)->getType());
+  };
+
+  switch (I.getOpcode()) {
+  case Instruction::Add:
+  case Instruction::Sub:
+  case Instruction::Mul:
+  case Instruction::UDiv:
+  case Instruction::SDiv:
+  case Instruction::URem:
+  case Instruction::SRem:
+  case Instruction::Shl:
+  case Instruction::LShr:
+  case Instruction::AShr:
+  case Instruction::And:
+  case Instruction::Or:
+  case Instruction::Xor:
+  case Instruction::FAdd:
+  case Instruction::FSub:
+  case Instruction::FMul:
+  case Instruction::FDiv:
+  case Instruction::FRem: {
+    static const std::pair<unsigned, bc::Opcode> BinaryOps[] = {
+        {Instruction::Add, bc::Add},   {Instruction::Sub, bc::Sub},
+        {Instruction::Mul, bc::Mul},   {Instruction::UDiv, bc::UDiv},
+        {Instruction::SDiv, bc::SDiv}, {Instruction::URem, bc::URem},
+        {Instruction::SRem, bc::SRem}, {Instruction::Shl, bc::Shl},
+        {Instruction::LShr, bc::LShr}, {Instruction::AShr, bc::AShr},
+        {Instruction::And, bc::And},   {Instruction::Or, bc::Or},
+        {Instruction::Xor, bc::Xor},   {Instruction::FAdd, bc::FAdd},
+        {Instruction::FSub, bc::FSub}, {Instruction::FMul, bc::FMul},
+        {Instruction::FDiv, bc::FDiv}, {Instruction::FRem, bc::FRem}};
+    bc::Opcode Op = llvm::find_if(BinaryOps, [&](auto &P) {
+                      return P.first == I.getOpcode();
+                    })->second;
+    emit({Op, Dst, Ops[0], Ops[1], getOperandWidth(0)});
+    return Error::success();
+  }
+
+  case Instruction::FNeg:
+    emit({bc::FNeg, Dst, Ops[0], getOperandWidth(0)});
+    return Error::success();
+
+  case Instruction::ICmp: {
+    bc::Opcode Op;
+    switch (cast<ICmpInst>(I).getPredicate()) {
+    case CmpInst::ICMP_EQ:
+      Op = bc::ICmpEQ;
+      break;
+    case CmpInst::ICMP_NE:
+      Op = bc::ICmpNE;
+      break;
+    case CmpInst::ICMP_UGT:
+      Op = bc::ICmpUGT;
+      break;
+    case CmpInst::ICMP_UGE:
+      Op = bc::ICmpUGE;
+      break;
+    case CmpInst::ICMP_ULT:
+      Op = bc::ICmpULT;
+      break;
+    case CmpInst::ICMP_ULE:
+      Op = bc::ICmpULE;
+      break;
+    case CmpInst::ICMP_SGT:
+      Op = bc::ICmpSGT;
+      break;
+    case CmpInst::ICMP_SGE:
+      Op = bc::ICmpSGE;
+      break;
+    case CmpInst::ICMP_SLT:
+      Op = bc::ICmpSLT;
+      break;
+    default:
+      Op = bc::ICmpSLE;
+      break;
+    }
+    emit({Op, Dst, Ops[0], Ops[1], getOperandWidth(0)});
+    return Error::success();
+  }
+
+  case Instruction::FCmp:
+    emit({bc::FCmp, Dst, Ops[0], Ops[1],
+          static_cast<uint32_t>(cast<FCmpInst>(I).getPredicate()),
+          getOperandWidth(0)});
+    return Error::success();
+
+  case Instruction::Trunc:
+    emit({bc::Trunc, Dst, Ops[0], *getWidth(I.getType())});
+    return Error::success();
+
+  case Instruction::SExt:
+    emit({bc::SExt, Dst, Ops[0], getOperandWidth(0), *getWidth(I.getType())});
+    return Error::success();
+
+  case Instruction::FPToSI:
+  case Instruction::FPToUI:
+  case Instruction::SIToFP:
+  case Instruction::UIToFP: {
+    bc::Opcode Op = I.getOpcode() == Instruction::FPToSI   ? bc::FPToSI
+                    : I.getOpcode() == Instruction::FPToUI ? bc::FPToUI
+                    : I.getOpcode() == Instruction::SIToFP ? bc::SIToFP
+                                                           : bc::UIToFP;
+    emit({Op, Dst, Ops[0], getOperandWidth(0), *getWidth(I.getType())});
+    return Error::success();
+  }
+
+  case Instruction::FPTrunc:
+  case Instruction::FPExt:
+    if (getOperandWidth(0) == *getWidth(I.getType())) {
+      emit({bc::Mov, Dst, Ops[0]});
+      return Error::success();
+    }
+    emit({I.getOpcode() == Instruction::FPTrunc ? bc::FPTrunc : bc::FPExt, Dst,
+          Ops[0]});
+    return Error::success();
+
+  case Instruction::PtrToInt:
+  case Instruction::IntToPtr:
+    // Values are zero extended in registers, so only truncation is needed.
+    if (*getWidth(I.getType()) < getOperandWidth(0)) {
+      emit({bc::Trunc, Dst, Ops[0], *getWidth(I.getType())});
+      return Error::success();
+    }
+    emit({bc::Mov, Dst, Ops[0]});
+    return Error::success();
+
+  case Instruction::ZExt:
+  case Instruction::BitCast:
+  case Instruction::Freeze:
+    emit({bc::Mov, Dst, Ops[0]});
+    return Error::success();
+
+  case Instruction::Select:
+    emit({bc::Select, Dst, Ops[0], Ops[1], Ops[2]});
+    return Error::success();
+
+  case Instruction::Load:
+  case Instruction::Store: {
+    Type *Ty = isa<LoadInst>(I) ? I.getType() : I.getOperand(0)->getType();
+    if (I.isAtomic())
+      return unsupported("atomic memory access");
+    uint64_t Size = DL.getTypeStoreSize(Ty);
+    if (!isPowerOf2_64(Size) || Size > 8)
+      return unsupported("memory access type");
+    if (isa<LoadInst>(I))
+      emit({bc::Load, Dst, Ops[0], static_cast<uint32_t>(Size),
+            *getWidth(Ty)});
+    else
+      emit({bc::Store, Ops[1], Ops[0], static_cast<uint32_t>(Size)});
+    return Error::success();
+  }
+
+  case Instruction::Alloca: {
+    auto I2 = AllocaOffsets.find(cast<AllocaInst>(&I));
+    if (I2 == AllocaOffsets.end())
+      return unsupported("dynamic alloca");
+    emit({bc::FrameAddr, Dst, static_cast<uint32_t>(I2->second)});
+    return Error::success();
+  }
+
+  case Instruction::GetElementPtr:
+    return compileGEP(cast<GetElementPtrInst>(I));
+
+  case Instruction::Call:
+    return compileCall(cast<CallInst>(I));
+
+  case Instruction::PHI:
+    // Assigned on the incoming edges.
+    return Error::success();
+
+  case Instruction::Br: {
+    auto &BI = cast<BranchInst>(I);
+    BasicBlock *BB = BI.getParent();
+    if (BI.isUnconditional()) {
+      if (auto Err = emitPhiMoves(BB, BI.getSuccessor(0)))
+        return Err;
+      emit({bc::Br});
+      BlockRefs.push_back({BF.Code.size(), BI.getSuccessor(0)});
+      BF.Code.push_back(0);
+      return Error::success();
+    }
+    emit({bc::CondBr, Ops[0]});
+    emitTarget(BB, BI.getSuccessor(0));
+    emitTarget(BB, BI.getSuccessor(1));
+    return Error::success();
+  }
+
+  case Instruction::Switch: {
+    auto &SI = cast<SwitchInst>(I);
+    if (SI.getCondition()->getType()->getIntegerBitWidth() > 64)
+      return unsupported("switch type");
+    emit({bc::Switch, Ops[0], SI.getNumCases()});
+    emitTarget(SI.getParent(), SI.getDefaultDest());
+    for (auto &Case : SI.cases()) {
+      uint64_t V = Case.getCaseValue()->getZExtValue();
+      emit({static_cast<uint32_t>(V), static_cast<uint32_t>(V >> 32)});
+      emitTarget(SI.getParent(), Case.getCaseSuccessor());
+    }
+    return Error::success();
+  }
+
+  case Instruction::Ret:
+    if (Ops.empty())
+      emit({bc::RetVoid});
+    else
+      emit({bc::Ret, Ops[0]});
+    return Error::success();
+
+  case Instruction::Unreachable:
+    emit({bc::Unreachable});
+    return Error::success();
+
+  default:
+    return unsupported(Twine("instruction ") + I.getOpcodeName());
+  }
+}
+
+Error BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::
+    compileGEP(GetElementPtrInst &GEP) {
+  uint32_t Dst = Regs[&GEP];
+  auto Base = getReg(GEP.getPointerOperand());
+  if (!Base)
+    return Base.takeError();
+
+  uint32_t Cur = *Base;
+  uint64_t Offset = 0;
+  for (gep_type_iterator GTI = gep_type_begin(GEP), E = gep_type_end(GEP);
+       GTI != E; ++GTI) {
+    Value *Idx = GTI.getOperand();
+    if (StructType *STy = GTI.getStructTypeOrNull()) {
+      Offset += DL.getStructLayout(STy)->getElementOffset(
+          cast<ConstantInt>(Idx)->getZExtValue());
+      continue;
+    }
+    TypeSize Size = DL.getTypeAllocSize(GTI.getIndexedType());
+    Optional<unsigned> IdxW = getWidth(Idx->getType());
+    if (Size.isScalable() || !IdxW)
+      return unsupported("getelementptr");
+    if (auto *CI = dyn_cast<ConstantInt>(Idx)) {
+      Offset += static_cast<uint64_t>(CI->getSExtValue()) * Size.getFixedSize();
+      continue;
+    }
+    auto IdxReg = getReg(Idx);
+    if (!IdxReg)
+      return IdxReg.takeError();
+    emit({bc::Gep, Dst, Cur, *IdxReg, getImmReg(Size.getFixedSize()), *IdxW});
+    Cur = Dst;
+  }
+
+  if (Offset)
+    emit({bc::Add, Dst, Cur, getImmReg(mask(Offset, PtrBits)), PtrBits});
+  else if (Cur != Dst)
+    emit({bc::Mov, Dst, Cur});
+  return Error::success();
+}
+
+Error BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::
+    compileCall(CallInst &CI) {
+  if (CI.isInlineAsm())
+    return unsupported("inline assembly");
+
+  if (auto *II = dyn_cast<IntrinsicInst>(&CI)) {
+    switch (II->getIntrinsicID()) {
+    case Intrinsic::assume:
+    case Intrinsic::dbg_declare:
+    case Intrinsic::dbg_label:
+    case Intrinsic::dbg_value:
+    case Intrinsic::donothing:
+    case Intrinsic::experimental_noalias_scope_decl:
+    case Intrinsic::lifetime_end:
+    case Intrinsic::lifetime_start:
+    case Intrinsic::sideeffect:
+      return Error::success();
+    case Intrinsic::memcpy:
+      return compileNativeCall(
+          CI, getImmReg(pointerToJITTargetAddress(&::memcpy)), 3);
+    case Intrinsic::memmove:
+      return compileNativeCall(
+          CI, getImmReg(pointerToJITTargetAddress(&::memmove)), 3);
+    case Intrinsic::memset:
+      return compileNativeCall(
+          CI, getImmReg(pointerToJITTargetAddress(&::memset)), 3);
+    default:
+      return unsupported("intrinsic " + II->getCalledFunction()->getName());
+    }
+  }
+
+  // Calls to the functions of the module stay in the interpreter.
+  if (Function *Callee = CI.getCalledFunction()) {
+    auto I = IM.BCFunctions.find(Callee);
+    if (I != IM.BCFunctions.end()) {
+      auto Index = CalleeIndices.insert({Callee, BF.Callees.size()});
+      if (Index.second)
+        BF.Callees.push_back(I->second);
+      uint32_t Dst = CI.getType()->isVoidTy() ? ScratchReg : Regs[&CI];
+      emit({bc::Call, Dst, Index.first->second, CI.arg_size()});
+      for (Value *Arg : CI.args()) {
+        auto Reg = getReg(Arg);
+        if (!Reg)
+          return Reg.takeError();
+        BF.Code.push_back(*Reg);
+      }
+      return Error::success();
+    }
+  }
+
+  if (!isNativeSignature(CI.getFunctionType()))
+    return unsupported("signature of native call");
+  auto Fn = getReg(CI.getCalledOperand());
+  if (!Fn)
+    return Fn.takeError();
+  return compileNativeCall(CI, *Fn, CI.arg_size());
+}
+
+Error BytecodeInterpreterLayer::InterpretedModule::FunctionCompiler::
+    compileNativeCall(CallInst &CI, uint32_t Fn, unsigned NumArgs) {
+  uint32_t Dst = CI.getType()->isVoidTy() ? ScratchReg : Regs[&CI];
+  uint32_t RetW = CI.getType()->isVoidTy() ? 0 : *getWidth(CI.getType());
+  emit({bc::CallNative, Dst, Fn, NumArgs, RetW});
+  for (unsigned I = 0; I != NumArgs; ++I) {
+    Value *Arg = CI.getArgOperand(I);
+    auto Reg = getReg(Arg);
+    if (!Reg)
+      return Reg.takeError();
+    uint32_t SExtW =
+        CI.paramHasAttr(I, Attribute::SExt) ? *getWidth(Arg->getType()) : 0;
+    emit({*Reg, SExtW});
+  }
+  return Error::success();
+}
+
+BytecodeInterpreterLayer::InterpretedModule::~InterpretedModule() {
+  for (auto &BF : Functions)
+    if (BF->Entry)
+      EntryTargets[BF->Entry->first][BF->Entry->second].store(
+          nullptr, std::memory_order_release);
+}
+
+Error BytecodeInterpreterLayer::InterpretedModule::compile(
+    ExecutionSession &ES, MaterializationResponsibility &R, Module &M) {
+  DL = &M.getDataLayout();
+  if (DL->isLittleEndian() != sys::IsLittleEndianHost ||
+      DL->getPointerSizeInBits() != PtrBits)
+    return unsupported("data layout");
+  if (!M.alias_empty() || !M.ifunc_empty())
+    return unsupported("aliases");
+  Mangle = std::make_unique<MangleAndInterner>(ES, *DL);
+
+  const SymbolFlagsMap &Symbols = R.getSymbols();
+  // Definitions that were overridden in the JITDylib are treated like
+  // declarations.
+  auto isOwnedDefinition = [&](GlobalValue &GV) {
+    return !GV.isDeclaration() &&
+           (GV.hasLocalLinkage() || Symbols.count((*Mangle)(GV.getName())));
+  };
+
+  // Place the global variables first, so that the constants of the functions
+  // can refer to them.
+  SmallVector<GlobalVariable *, 8> Globals;
+  for (GlobalVariable &GV : M.globals()) {
+    if (GV.getName().startswith("llvm.")) {
+      if (GV.getName() == "llvm.used" || GV.getName() == "llvm.compiler.used")
+        continue;
+      return unsupported("global " + GV.getName());
+    }
+    if (!isOwnedDefinition(GV))
+      continue;
+    if (GV.isThreadLocal() || GV.getAddressSpace() != 0)
+      return unsupported("global variable");
+    Type *Ty = GV.getValueType();
+    TypeSize Size = DL->getTypeAllocSize(Ty);
+    if (Size.isScalable())
+      return unsupported("global variable type");
+    Align A = DL->getPreferredAlign(&GV);
+    char *Mem = static_cast<char *>(
+        GlobalMem.Allocate(std::max<uint64_t>(Size.getFixedSize(), 1), A));
+    memset(Mem, 0, Size.getFixedSize());
+    LocalAddrs[&GV] = pointerToJITTargetAddress(Mem);
+    Globals.push_back(&GV);
+  }
+
+  // Create the functions, with entry points for the ones that can be reached
+  // from native code.
+  SmallVector<Function *, 8> Defs;
+  for (Function &F : M.functions()) {
+    if (!isOwnedDefinition(F))
+      continue;
+    if (F.hasPersonalityFn() || F.isVarArg())
+      return unsupported("function " + F.getName());
+    Functions.push_back(std::make_unique<BCFunction>());
+    BCFunction &BF = *Functions.back();
+    BF.Name = F.getName().str();
+    BCFunctions[&F] = &BF;
+    Defs.push_back(&F);
+
+    if (!F.hasLocalLinkage() || F.hasAddressTaken()) {
+      if (!isNativeSignature(F.getFunctionType()))
+        return unsupported("signature of function " + F.getName());
+      unsigned NumArgs = F.arg_size();
+      Optional<unsigned> Slot = allocateEntrySlot(NumArgs, &BF);
+      if (!Slot)
+        return unsupported("number of functions: out of entry points");
+      BF.Entry = std::make_pair(NumArgs, *Slot);
+      LocalAddrs[&F] = getEntryPointAddress(NumArgs, *Slot);
+    }
+  }
+
+  for (GlobalVariable *GV : Globals)
+    if (GV->hasInitializer())
+      if (auto Err = initialize(
+              GV->getInitializer(),
+              jitTargetAddressToPointer<char *>(LocalAddrs[GV])))
+        return Err;
+
+  for (Function *F : Defs)
+    if (auto Err = FunctionCompiler(*this, *F, *BCFunctions[F]).compile())
+      return joinErrors(
+          make_error<StringError>("In function " + F->getName(),
+                                  inconvertibleErrorCode()),
+          std::move(Err));
+
+  for (auto &KV : LocalAddrs) {
+    if (KV.first->hasLocalLinkage())
+      continue;
+    SymbolStringPtr Name = (*Mangle)(KV.first->getName());
+    Definitions[Name] = JITEvaluatedSymbol(KV.second, Symbols.lookup(Name));
+  }
+  for (auto &KV : Symbols)
+    if (!Definitions.count(KV.first))
+      return unsupported("definition of " + *KV.first);
+  return Error::success();
+}
+
+SymbolLookupSet
+BytecodeInterpreterLayer::InterpretedModule::getExternalSymbols() const {
+  SymbolLookupSet Names;
+  for (auto &KV : Externals)
+    Names.add(KV.first, KV.second);
+  return Names;
+}
+
+void BytecodeInterpreterLayer::InterpretedModule::applyFixups(
+    const SymbolMap &Addrs) {
+  for (Fixup &FU : Fixups) {
+    // Missing weak references resolve to null.
+    auto I = Addrs.find(FU.Name);
+    uint64_t V = I == Addrs.end() ? 0 : I->second.getAddress() + FU.Addend;
+    if (FU.F)
+      FU.F->Consts[FU.Const] = mask(V, PtrBits);
+    else
+      storeValue(FU.Mem, V, FU.Size);
+  }
+  Fixups.clear();
+}
+
+Error BytecodeInterpreterLayer::InterpretedModule::evaluate(const Constant *C,
+                                                            ConstValue &CV) {
+  Type *Ty = C->getType();
+  Optional<unsigned> W = getWidth(Ty);
+  if (!W)
+    return unsupported("constant type");
+
+  if (auto *CI = dyn_cast<ConstantInt>(C)) {
+    CV.Offset = CI->getZExtValue();
+    return Error::success();
+  }
+  if (auto *CFP = dyn_cast<ConstantFP>(C)) {
+    CV.Offset = CFP->getValueAPF().bitcastToAPInt().getZExtValue();
+    return Error::success();
+  }
+  if (isa<ConstantPointerNull>(C) || isa<UndefValue>(C))
+    return Error::success();
+  if (auto *GV = dyn_cast<GlobalValue>(C)) {
+    CV.GV = GV;
+    return Error::success();
+  }
+
+  if (auto *CE = dyn_cast<ConstantExpr>(C)) {
+    switch (CE->getOpcode()) {
+    case Instruction::BitCast:
+    case Instruction::IntToPtr:
+    case Instruction::PtrToInt: {
+      if (auto Err = evaluate(CE->getOperand(0), CV))
+        return Err;
+      // Addresses can not be truncated before they are known.
+      if (CV.GV && *W < PtrBits)
+        return unsupported("truncated address");
+      CV.Offset = mask(CV.Offset, *W);
+      return Error::success();
+    }
+    case Instruction::GetElementPtr: {
+      auto *GEP = cast<GEPOperator>(CE);
+      APInt Offset(DL->getIndexTypeSizeInBits(GEP->getType()), 0);
+      if (!GEP->accumulateConstantOffset(*DL, Offset))
+        return unsupported("constant getelementptr");
+      if (auto Err = evaluate(cast<Constant>(GEP->getPointerOperand()), CV))
+        return Err;
+      CV.Offset = mask(CV.Offset + Offset.getSExtValue(), PtrBits);
+      return Error::success();
+    }
+    default:
+      break;
+    }
+  }
+  return unsupported("constant");
+}
+
+Error BytecodeInterpreterLayer::InterpretedModule::initialize(const Constant *C,
+                                                              char *Mem) {
+  // The memory of the global variables starts out zeroed.
+  if (C->isNullValue() || isa<UndefValue>(C))
+    return Error::success();
+
+  if (auto *CDS = dyn_cast<ConstantDataSequential>(C)) {
+    StringRef Data = CDS->getRawDataValues();
+    memcpy(Mem, Data.data(), Data.size());
+    return Error::success();
+  }
+  if (auto *CA = dyn_cast<ConstantArray>(C)) {
+    uint64_t ElemSize = DL->getTypeAllocSize(CA->getType()->getElementType());
+    for (unsigned I = 0, E = CA->getNumOperands(); I != E; ++I)
+      if (auto Err = initialize(CA->getOperand(I), Mem + I * ElemSize))
+        return Err;
+    return Error::success();
+  }
+  if (auto *CS = dyn_cast<ConstantStruct>(C)) {
+    const StructLayout *SL = DL->getStructLayout(CS->getType());
+    for (unsigned I = 0, E = CS->getNumOperands(); I != E; ++I)
+      if (auto Err = initialize(CS->getOperand(I),
+                                Mem + SL->getElementOffset(I)))
+        return Err;
+    return Error::success();
+  }
+
+  ConstValue CV;
+  if (auto Err = evaluate(C, CV))
+    return Err;
+  uint64_t Size = DL->getTypeStoreSize(C->getType());
+  if (!isPowerOf2_64(Size) || Size > 8)
+    return unsupported("initializer type");
+  setValue(CV, nullptr, 0, Mem, Size);
+  return Error::success();
+}
+
+void BytecodeInterpreterLayer::InterpretedModule::setValue(
+    const ConstValue &CV, BCFunction *F, uint32_t Const, char *Mem,
+    unsigned Size) {
+  uint64_t V = CV.Offset;
+  if (CV.GV) {
+    auto I = LocalAddrs.find(CV.GV);
+    if (I == LocalAddrs.end()) {
+      SymbolStringPtr Name = (*Mangle)(CV.GV->getName());
+      Externals[Name] = CV.GV->hasExternalWeakLinkage()
+                            ? SymbolLookupFlags::WeaklyReferencedSymbol
+                            : SymbolLookupFlags::RequiredSymbol;
+      Fixups.push_back({std::move(Name), CV.Offset, F, Const, Mem, Size});
+      return;
+    }
+    V = mask(I->second + CV.Offset, PtrBits);
+  }
+  if (F)
+    F->Consts[Const] = V;
+  else
+    storeValue(Mem, V, Size);
+}
+
+BytecodeInterpreterLayer::BytecodeInterpreterLayer(ExecutionSession &ES,
+                                                   IRLayer &FallbackLayer)
+    : IRLayer(ES, FallbackLayer.getManglingOptions()),
+      FallbackLayer(FallbackLayer) {}
+
+BytecodeInterpreterLayer::~BytecodeInterpreterLayer() = default;
+
+size_t BytecodeInterpreterLayer::getNumInterpretedModules() const {
+  std::lock_guard<std::mutex> Lock(LayerMutex);
+  return Modules.size();
+}
+
+size_t BytecodeInterpreterLayer::getNumFallbackModules() const {
+  std::lock_guard<std::mutex> Lock(LayerMutex);
+  return NumFallbackModules;
+}
+
+void BytecodeInterpreterLayer::emit(
+    std::unique_ptr<MaterializationResponsibility> R, ThreadSafeModule TSM) {
+  assert(TSM && "Null module");
+
+  auto &ES = getExecutionSession();
+
+  auto IM = std::make_unique<InterpretedModule>();
+  std::string ModuleName;
+  Error Err = TSM.withModuleDo([&](Module &M) -> Error {
+    ModuleName = M.getModuleIdentifier();
+    if (R->getInitializerSymbol())
+      return unsupported("static initializers");
+    return IM->compile(ES, *R, M);
+  });
+  if (Err) {
+    std::string Reason = toString(std::move(Err));
+    LLVM_DEBUG({
+      dbgs() << "Can not interpret " << ModuleName << ": " << Reason
+             << ", emitting it through the fallback layer\n";
+    });
+    (void)Reason;
+    {
+      std::lock_guard<std::mutex> Lock(LayerMutex);
+      ++NumFallbackModules;
+    }
+    FallbackLayer.emit(std::move(R), std::move(TSM));
+    return;
+  }
+
+  if (auto Err = R->notifyResolved(IM->getDefinitions())) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  InterpretedModule &Interpreted = *IM;
+  SymbolLookupSet Externals = IM->getExternalSymbols();
+  {
+    std::lock_guard<std::mutex> Lock(LayerMutex);
+    Modules.push_back(std::move(IM));
+  }
+
+  if (Externals.empty()) {
+    if (auto Err = R->notifyEmitted()) {
+      ES.reportError(std::move(Err));
+      R->failMaterialization();
+    }
+    return;
+  }
+
+  // Look up the symbols that the code refers to, as JITLink does for
+  // compiled code.
+  JITDylibSearchOrder LinkOrder;
+  R->getTargetJITDylib().withLinkOrderDo(
+      [&](const JITDylibSearchOrder &LO) { LinkOrder = LO; });
+  std::shared_ptr<MaterializationResponsibility> SharedR = std::move(R);
+  ES.lookup(
+      LookupKind::Static, LinkOrder, std::move(Externals),
+      SymbolState::Resolved,
+      [&ES, &Interpreted, SharedR](Expected<SymbolMap> Result) {
+        if (!Result) {
+          ES.reportError(Result.takeError());
+          SharedR->failMaterialization();
+          return;
+        }
+        Interpreted.applyFixups(*Result);
+        if (auto Err = SharedR->notifyEmitted()) {
+          ES.reportError(std::move(Err));
+          SharedR->failMaterialization();
+        }
+      },
+      [SharedR](const SymbolDependenceMap &Deps) {
+        SharedR->addDependenciesForAll(Deps);
+      });
+}
@@ -0,0 +1,173 @@
+//===--- CompileTimingPlugin.cpp - Timing of JIT materialization ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/CompileTimingPlugin.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/TimeProfiler.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+class CompileTimingPlugin::TimedCompiler : public IRCompileLayer::IRCompiler {
+public:
+  TimedCompiler(CompileTimingPlugin &Plugin,
+                std::unique_ptr<IRCompileLayer::IRCompiler> Compile)
+      : IRCompiler(Compile->getManglingOptions()), Plugin(Plugin),
+        Compile(std::move(Compile)) {}
+
+  Expected<std::unique_ptr<MemoryBuffer>> operator()(Module &M) override {
+    TimeTraceScope TTS("CodeGen", M.getModuleIdentifier());
+    auto Start = Clock::now();
+    auto Obj = (*Compile)(M);
+    Plugin.addTime(&Stats::CodeGenTime, Clock::now() - Start);
+    return Obj;
+  }
+
+private:
+  CompileTimingPlugin &Plugin;
+  std::unique_ptr<IRCompileLayer::IRCompiler> Compile;
+};
+
+void CompileTimingPlugin::instrumentDispatch(ExecutionSession &ES) {
+  ES.wrapDispatchTask([this](ExecutionSession::DispatchTaskFunction Dispatch)
+                          -> ExecutionSession::DispatchTaskFunction {
+    return [this, Dispatch = std::move(Dispatch)](
+               std::unique_ptr<Task> T) mutable {
+      if (!isa<MaterializationTask>(*T))
+        return Dispatch(std::move(T));
+
+      std::string Desc;
+      {
+        raw_string_ostream OS(Desc);
+        T->printDescription(OS);
+      }
+      auto Dispatched = Clock::now();
+      updateNumQueued(1);
+      Dispatch(makeGenericNamedTask(
+          [this, T = std::move(T), Desc, Dispatched]() mutable {
+            auto Started = Clock::now();
+            updateNumQueued(-1);
+            {
+              TimeTraceScope TTS("Materialize", Desc);
+              T->run();
+            }
+            taskFinished(std::move(Desc), Dispatched, Started, Clock::now());
+          },
+          Desc));
+    };
+  });
+}
+
+IRTransformLayer::TransformFunction CompileTimingPlugin::wrapTransform(
+    IRTransformLayer::TransformFunction Transform) {
+  return [this, Transform = std::move(Transform)](
+             ThreadSafeModule TSM, MaterializationResponsibility &R) mutable
+         -> Expected<ThreadSafeModule> {
+    std::string Name =
+        TSM.withModuleDo([](Module &M) { return M.getModuleIdentifier(); });
+    TimeTraceScope TTS("Optimize", Name);
+    auto Start = Clock::now();
+    auto Result = Transform(std::move(TSM), R);
+    addTime(&Stats::OptimizationTime, Clock::now() - Start);
+    return Result;
+  };
+}
+
+std::unique_ptr<IRCompileLayer::IRCompiler> CompileTimingPlugin::wrapCompiler(
+    std::unique_ptr<IRCompileLayer::IRCompiler> Compile) {
+  return std::make_unique<TimedCompiler>(*this, std::move(Compile));
+}
+
+CompileTimingPlugin::Stats CompileTimingPlugin::getStats() {
+  std::lock_guard<std::mutex> Lock(StatsMutex);
+  return S;
+}
+
+std::vector<CompileTimingPlugin::MaterializationTiming>
+CompileTimingPlugin::getMaterializationTimings() {
+  std::lock_guard<std::mutex> Lock(StatsMutex);
+  return Timings;
+}
+
+void CompileTimingPlugin::printStats(raw_ostream &OS) {
+  Stats Current = getStats();
+  auto Print = [&](StringRef Name, Duration D) {
+    OS << formatv("  {0,-21} {1,10:f3} ms\n", Name,
+                  std::chrono::duration<double, std::milli>(D).count());
+  };
+  OS << "Materializations: " << Current.NumMaterializations << "\n";
+  Print("Queue time:", Current.QueueTime);
+  Print("Materialization time:", Current.MaterializationTime);
+  Print("Optimization time:", Current.OptimizationTime);
+  Print("Code generation time:", Current.CodeGenTime);
+  Print("Link time:", Current.LinkTime);
+}
+
+void CompileTimingPlugin::modifyPassConfig(MaterializationResponsibility &MR,
+                                           jitlink::LinkGraph &G,
+                                           jitlink::PassConfiguration &Config) {
+  std::lock_guard<std::mutex> Lock(StatsMutex);
+  LinkStarts[&MR] = Clock::now();
+}
+
+Error CompileTimingPlugin::notifyEmitted(MaterializationResponsibility &MR) {
+  linkFinished(MR);
+  return Error::success();
+}
+
+Error CompileTimingPlugin::notifyFailed(MaterializationResponsibility &MR) {
+  linkFinished(MR);
+  return Error::success();
+}
+
+Error CompileTimingPlugin::notifyRemovingResources(ResourceKey K) {
+  return Error::success();
+}
+
+void CompileTimingPlugin::notifyTransferringResources(ResourceKey DstKey,
+                                                      ResourceKey SrcKey) {}
+
+void CompileTimingPlugin::updateNumQueued(int64_t Delta) {
+  int64_t Queued;
+  {
+    std::lock_guard<std::mutex> Lock(StatsMutex);
+    Queued = NumQueued += Delta;
+  }
+  if (timeTraceProfilerEnabled())
+    timeTraceProfilerCounter("ORC tasks", {{"queued", Queued}});
+}
+
+void CompileTimingPlugin::taskFinished(std::string Description,
+                                       Clock::time_point Dispatched,
+                                       Clock::time_point Started,
+                                       Clock::time_point Finished) {
+  auto QueueTime = std::chrono::duration_cast<Duration>(Started - Dispatched);
+  auto RunTime = std::chrono::duration_cast<Duration>(Finished - Started);
+  std::lock_guard<std::mutex> Lock(StatsMutex);
+  ++S.NumMaterializations;
+  S.QueueTime += QueueTime;
+  S.MaterializationTime += RunTime;
+  Timings.push_back({std::move(Description), QueueTime, RunTime});
+}
+
+void CompileTimingPlugin::linkFinished(MaterializationResponsibility &MR) {
+  auto Finished = Clock::now();
+  std::lock_guard<std::mutex> Lock(StatsMutex);
+  auto I = LinkStarts.find(&MR);
+  if (I == LinkStarts.end())
+    return;
+  S.LinkTime += std::chrono::duration_cast<Duration>(Finished - I->second);
+  LinkStarts.erase(I);
+}
+
+void CompileTimingPlugin::addTime(Duration Stats::*Field,
+                                  Clock::duration D) {
+  std::lock_guard<std::mutex> Lock(StatsMutex);
+  S.*Field += std::chrono::duration_cast<Duration>(D);
+}
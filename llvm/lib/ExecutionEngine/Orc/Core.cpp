@@ -2148,6 +2148,38 @@ ExecutionSession::lookup(ArrayRef<JITDylib *> SearchOrder, StringRef Name,
   return lookup(SearchOrder, intern(Name), RequiredState);
 }
 
+Expected<std::vector<SymbolMap>>
+ExecutionSession::bulkLookup(ArrayRef<LookupRequest> Requests, LookupKind K,
+                             SymbolState RequiredState) {
+  std::mutex ResultsMutex;
+  std::condition_variable ResultsCV;
+  size_t NumPending = Requests.size();
+  std::vector<SymbolMap> Results(Requests.size());
+  Error Err = Error::success();
+
+  // Issue all the lookups first, so that their materialization units can be
+  // dispatched together.
+  for (size_t I = 0; I != Requests.size(); ++I)
+    lookup(
+        K, Requests[I].SearchOrder, Requests[I].Symbols, RequiredState,
+        [&, I](Expected<SymbolMap> R) {
+          std::lock_guard<std::mutex> Lock(ResultsMutex);
+          if (R)
+            Results[I] = std::move(*R);
+          else
+            Err = joinErrors(std::move(Err), R.takeError());
+          if (--NumPending == 0)
+            ResultsCV.notify_all();
+        },
+        NoDependenciesToRegister);
+
+  std::unique_lock<std::mutex> Lock(ResultsMutex);
+  ResultsCV.wait(Lock, [&] { return NumPending == 0; });
+  if (Err)
+    return std::move(Err);
+  return std::move(Results);
+}
+
 Error ExecutionSession::registerJITDispatchHandlers(
     JITDylib &JD, JITDispatchHandlerAssociationMap WFs) {
 
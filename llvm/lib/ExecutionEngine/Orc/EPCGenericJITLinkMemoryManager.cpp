@@ -10,10 +10,17 @@
 
 #include "llvm/ExecutionEngine/JITLink/JITLink.h"
 #include "llvm/ExecutionEngine/Orc/LookupAndRecordAddrs.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/ExecutionEngine/Orc/Shared/OrcRTBridge.h"
 
 #include <limits>
 
+#if defined(LLVM_ON_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 using namespace llvm::jitlink;
 
 namespace llvm {
@@ -39,20 +46,35 @@ public:
   using SegInfoMap = AllocGroupSmallMap<SegInfo>;
 
   InFlightAlloc(EPCGenericJITLinkMemoryManager &Parent, LinkGraph &G,
-                ExecutorAddr AllocAddr, SegInfoMap Segs)
-      : Parent(Parent), G(G), AllocAddr(AllocAddr), Segs(std::move(Segs)) {}
+                ExecutorAddr AllocAddr, SegInfoMap Segs,
+                sys::MemoryBlock LocalMapping)
+      : Parent(Parent), G(G), AllocAddr(AllocAddr), Segs(std::move(Segs)),
+        LocalMapping(LocalMapping) {}
+
+  ~InFlightAlloc() {
+    // The graph may refer to the working memory until it is destroyed, so
+    // keep the local view of shared allocations until then.
+    if (LocalMapping.base())
+      if (auto EC = sys::Memory::releaseMappedMemory(LocalMapping))
+        Parent.EPC.getExecutionSession().reportError(errorCodeToError(EC));
+  }
 
   void finalize(OnFinalizedFunction OnFinalize) override {
     tpctypes::FinalizeRequest FR;
     for (auto &KV : Segs) {
       assert(KV.second.ContentSize <= std::numeric_limits<size_t>::max());
+      // The content of shared allocations is already in place.
+      ArrayRef<char> Content;
+      if (!LocalMapping.base())
+        Content = {KV.second.WorkingMem,
+                   static_cast<size_t>(KV.second.ContentSize)};
       FR.Segments.push_back(tpctypes::SegFinalizeRequest{
           tpctypes::toWireProtectionFlags(
               toSysMemoryProtectionFlags(KV.first.getMemProt())),
           KV.second.Addr,
           alignTo(KV.second.ContentSize + KV.second.ZeroFillSize,
                   Parent.EPC.getPageSize()),
-          {KV.second.WorkingMem, static_cast<size_t>(KV.second.ContentSize)}});
+          Content});
     }
 
     // Transfer allocation actions.
@@ -96,8 +118,41 @@ private:
   LinkGraph &G;
   ExecutorAddr AllocAddr;
   SegInfoMap Segs;
+  sys::MemoryBlock LocalMapping;
 };
 
+/// Map the shared memory object \p Name in this process.
+static Expected<sys::MemoryBlock> mapSharedMemory(const std::string &Name,
+                                                  uint64_t Size) {
+#if defined(LLVM_ON_UNIX)
+  auto SystemError = [&](const Twine &What) {
+    std::error_code EC(errno, std::generic_category());
+    return make_error<StringError>(What + " " + Name + ": " + EC.message(),
+                                   EC);
+  };
+
+  int FD = shm_open(Name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  if (FD < 0)
+    return SystemError("Cannot open shared memory object");
+  void *Mem = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, FD, 0);
+  if (Mem == MAP_FAILED) {
+    auto Err = SystemError("Cannot map shared memory object");
+    close(FD);
+    return std::move(Err);
+  }
+  close(FD);
+
+  // The memory stays alive while it is mapped, the name is not needed
+  // anymore.
+  shm_unlink(Name.c_str());
+  return sys::MemoryBlock(Mem, Size);
+#else
+  return make_error<StringError>(
+      "Shared memory allocations are not supported on this platform",
+      inconvertibleErrorCode());
+#endif
+}
+
 void EPCGenericJITLinkMemoryManager::allocate(const JITLinkDylib *JD,
                                               LinkGraph &G,
                                               OnAllocatedFunction OnAllocated) {
@@ -107,6 +162,10 @@ void EPCGenericJITLinkMemoryManager::allocate(const JITLinkDylib *JD,
   if (!Pages)
     return OnAllocated(Pages.takeError());
 
+  if (SAs.ReserveShared)
+    return allocateShared(std::move(BL), Pages->total(),
+                          std::move(OnAllocated));
+
   EPC.callSPSWrapperAsync<rt::SPSSimpleExecutorMemoryManagerReserveSignature>(
       SAs.Reserve,
       [this, BL = std::move(BL), OnAllocated = std::move(OnAllocated)](
@@ -123,6 +182,41 @@ void EPCGenericJITLinkMemoryManager::allocate(const JITLinkDylib *JD,
       SAs.Allocator, Pages->total());
 }
 
+void EPCGenericJITLinkMemoryManager::allocateShared(
+    BasicLayout BL, uint64_t Size, OnAllocatedFunction OnAllocated) {
+  using ReserveSharedResult = std::pair<ExecutorAddr, std::string>;
+  EPC.callSPSWrapperAsync<
+      rt::SPSSimpleExecutorMemoryManagerReserveSharedSignature>(
+      SAs.ReserveShared,
+      [this, BL = std::move(BL), Size, OnAllocated = std::move(OnAllocated)](
+          Error SerializationErr,
+          Expected<ReserveSharedResult> Result) mutable {
+        if (SerializationErr) {
+          cantFail(Result.takeError());
+          return OnAllocated(std::move(SerializationErr));
+        }
+        if (!Result)
+          return OnAllocated(Result.takeError());
+
+        auto LocalMapping = mapSharedMemory(Result->second, Size);
+        if (!LocalMapping) {
+          // Release the reservation before reporting the error.
+          auto Err = LocalMapping.takeError();
+          Error DeallocErr = Error::success();
+          if (auto SerErr = EPC.callSPSWrapper<
+                  rt::SPSSimpleExecutorMemoryManagerDeallocateSignature>(
+                  SAs.Deallocate, DeallocErr, SAs.Allocator,
+                  ArrayRef<ExecutorAddr>(Result->first)))
+            Err = joinErrors(std::move(Err), std::move(SerErr));
+          return OnAllocated(joinErrors(std::move(Err), std::move(DeallocErr)));
+        }
+
+        completeAllocation(Result->first, std::move(BL),
+                           std::move(OnAllocated), *LocalMapping);
+      },
+      SAs.Allocator, Size);
+}
+
 void EPCGenericJITLinkMemoryManager::deallocate(
     std::vector<FinalizedAlloc> Allocs, OnDeallocatedFunction OnDeallocated) {
   EPC.callSPSWrapperAsync<
@@ -142,7 +236,8 @@ void EPCGenericJITLinkMemoryManager::deallocate(
 }
 
 void EPCGenericJITLinkMemoryManager::completeAllocation(
-    ExecutorAddr AllocAddr, BasicLayout BL, OnAllocatedFunction OnAllocated) {
+    ExecutorAddr AllocAddr, BasicLayout BL, OnAllocatedFunction OnAllocated,
+    sys::MemoryBlock LocalMapping) {
 
   InFlightAlloc::SegInfoMap SegInfos;
 
@@ -152,7 +247,11 @@ void EPCGenericJITLinkMemoryManager::completeAllocation(
     auto &Seg = KV.second;
 
     Seg.Addr = NextSegAddr;
-    KV.second.WorkingMem = BL.getGraph().allocateBuffer(Seg.ContentSize).data();
+    if (LocalMapping.base())
+      Seg.WorkingMem = static_cast<char *>(LocalMapping.base()) +
+                       (NextSegAddr - AllocAddr);
+    else
+      Seg.WorkingMem = BL.getGraph().allocateBuffer(Seg.ContentSize).data();
     NextSegAddr += ExecutorAddrDiff(
         alignTo(Seg.ContentSize + Seg.ZeroFillSize, EPC.getPageSize()));
 
@@ -167,7 +266,8 @@ void EPCGenericJITLinkMemoryManager::completeAllocation(
     return OnAllocated(std::move(Err));
 
   OnAllocated(std::make_unique<InFlightAlloc>(*this, BL.getGraph(), AllocAddr,
-                                              std::move(SegInfos)));
+                                              std::move(SegInfos),
+                                              LocalMapping));
 }
 
 } // end namespace orc
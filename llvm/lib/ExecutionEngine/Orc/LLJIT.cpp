@@ -20,7 +20,10 @@
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include <map>
 
@@ -701,6 +704,54 @@ Error LLJIT::addObjectFile(JITDylib &JD, std::unique_ptr<MemoryBuffer> Obj) {
   return addObjectFile(JD.getDefaultResourceTracker(), std::move(Obj));
 }
 
+Error LLJIT::writeObjectSnapshot(ThreadSafeModule TSM, StringRef Path) {
+  assert(TSM && "Can not snapshot null module");
+
+  auto Obj = TSM.withModuleDo(
+      [&](Module &M) -> Expected<std::unique_ptr<MemoryBuffer>> {
+        if (auto Err = applyDataLayout(M))
+          return std::move(Err);
+        return CompileLayer->getCompiler()(M);
+      });
+  if (!Obj)
+    return Obj.takeError();
+
+  // Write to a temporary file first, so that concurrent sessions never see a
+  // partial snapshot.
+  auto Temp = sys::fs::TempFile::create(Path + ".tmp-%%%%%%");
+  if (!Temp)
+    return Temp.takeError();
+  raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+  OS << (*Obj)->getBuffer();
+  OS.flush();
+  if (OS.has_error()) {
+    std::error_code EC = OS.error();
+    OS.clear_error();
+    return joinErrors(errorCodeToError(EC), Temp->discard());
+  }
+  return Temp->keep(Path);
+}
+
+Error LLJIT::addObjectSnapshot(JITDylib &JD, StringRef Path) {
+  auto Obj = MemoryBuffer::getFile(Path, /*IsText=*/false,
+                                   /*RequiresNullTerminator=*/false);
+  if (!Obj)
+    return createFileError(Path, Obj.getError());
+
+  auto ObjFile =
+      object::ObjectFile::createObjectFile((*Obj)->getMemBufferRef());
+  if (!ObjFile)
+    return createFileError(Path, ObjFile.takeError());
+  if ((*ObjFile)->getArch() != TT.getArch())
+    return make_error<StringError>(
+        "Snapshot " + Path + " was compiled for " +
+            Triple::getArchTypeName((*ObjFile)->getArch()) + ", not " +
+            TT.getArchName(),
+        inconvertibleErrorCode());
+
+  return addObjectFile(JD, std::move(*Obj));
+}
+
 Expected<JITEvaluatedSymbol> LLJIT::lookupLinkerMangled(JITDylib &JD,
                                                         SymbolStringPtr Name) {
   return ES->lookup(
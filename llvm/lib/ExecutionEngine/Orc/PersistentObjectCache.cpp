@@ -0,0 +1,134 @@
+//===- PersistentObjectCache.cpp - On-disk object cache for ORC -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_sha1_ostream.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+Expected<std::unique_ptr<PersistentObjectCache>>
+PersistentObjectCache::Create(StringRef CacheDir,
+                              const JITTargetMachineBuilder &JTMB,
+                              ReportErrorFunction ReportError) {
+  std::string TargetKey;
+  raw_string_ostream OS(TargetKey);
+  OS << LLVM_VERSION_STRING << '\0' << JTMB.getTargetTriple().str() << '\0'
+     << JTMB.getCPU() << '\0' << JTMB.getFeatures().getString() << '\0'
+     << static_cast<int>(JTMB.getCodeGenOptLevel()) << '\0';
+  if (JTMB.getRelocationModel())
+    OS << static_cast<int>(*JTMB.getRelocationModel());
+  OS << '\0';
+  if (JTMB.getCodeModel())
+    OS << static_cast<int>(*JTMB.getCodeModel());
+  OS << '\0';
+  OS.flush();
+
+  std::unique_ptr<PersistentObjectCache> POC(
+      new PersistentObjectCache(std::move(TargetKey), std::move(ReportError)));
+
+  // The buffer callback is called with the mutex held, for hits as well as
+  // for the objects that are stored.
+  auto *Self = POC.get();
+  auto CacheOrErr = localCache(
+      "PersistentObjectCache", "orc", CacheDir,
+      [Self](unsigned Task, std::unique_ptr<MemoryBuffer> MB) {
+        Self->FoundObject = std::move(MB);
+      });
+  if (!CacheOrErr)
+    return CacheOrErr.takeError();
+  POC->Cache = std::move(*CacheOrErr);
+  return std::move(POC);
+}
+
+std::string PersistentObjectCache::getKey(const Module &M) const {
+  raw_sha1_ostream OS;
+  OS << TargetKey;
+  WriteBitcodeToFile(M, OS);
+  return toHex(OS.sha1());
+}
+
+std::unique_ptr<MemoryBuffer>
+PersistentObjectCache::getObject(const Module *M) {
+  std::string Key = getKey(*M);
+
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  auto AddStream = Cache(/*Task=*/0, Key);
+  if (!AddStream) {
+    reportError(AddStream.takeError());
+    return nullptr;
+  }
+  if (!*AddStream) {
+    ++NumHits;
+    return std::move(FoundObject);
+  }
+
+  // Remember the key for notifyObjectCompiled, to hash the module only once.
+  PendingKeys[M] = std::move(Key);
+  return nullptr;
+}
+
+void PersistentObjectCache::notifyObjectCompiled(const Module *M,
+                                                 MemoryBufferRef Obj) {
+  std::string Key;
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    auto I = PendingKeys.find(M);
+    if (I != PendingKeys.end()) {
+      Key = std::move(I->second);
+      PendingKeys.erase(I);
+    }
+  }
+  if (Key.empty())
+    Key = getKey(*M);
+
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  auto AddStream = Cache(/*Task=*/0, Key);
+  if (!AddStream) {
+    reportError(AddStream.takeError());
+    return;
+  }
+  // Another compilation of the same module may have stored it already.
+  if (!*AddStream) {
+    FoundObject.reset();
+    return;
+  }
+
+  auto Stream = (*AddStream)(/*Task=*/0);
+  if (!Stream) {
+    reportError(Stream.takeError());
+    return;
+  }
+  *(*Stream)->OS << Obj.getBuffer();
+  // Destroying the stream commits the file to the cache.
+  Stream->reset();
+  FoundObject.reset();
+  ++NumMisses;
+}
+
+unsigned PersistentObjectCache::getNumHits() const {
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  return NumHits;
+}
+
+unsigned PersistentObjectCache::getNumMisses() const {
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  return NumMisses;
+}
+
+void PersistentObjectCache::reportError(Error Err) {
+  if (ReportError)
+    ReportError(std::move(Err));
+  else
+    consumeError(std::move(Err));
+}
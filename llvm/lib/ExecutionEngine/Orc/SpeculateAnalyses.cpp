@@ -124,6 +124,18 @@ BlockFreqQuery::ResultTy BlockFreqQuery::operator()(Function &F) {
   return CallerAndCalles;
 }
 
+// CallSequenceQuery Implementations
+
+CallSequenceQuery::ResultTy CallSequenceQuery::operator()(Function &F) {
+  DenseMap<StringRef, DenseSet<StringRef>> CallerAndCalles;
+  auto &Calles = CallerAndCalles[F.getName()];
+  if (auto IRNames = BlockFreqQuery()(F))
+    for (auto &KV : *IRNames)
+      for (auto &Callee : KV.second)
+        Calles.insert(Callee);
+  return CallerAndCalles;
+}
+
 // SequenceBBQuery Implementation
 std::size_t SequenceBBQuery::getHottestBlocks(std::size_t TotalBlocks) {
   if (TotalBlocks == 1)
@@ -16,6 +16,10 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
 
@@ -52,6 +56,41 @@ Error Speculator::addSpeculationRuntime(JITDylib &JD,
   }));
 }
 
+Error writeSpeculationProfile(StringRef Path,
+                              ArrayRef<SymbolStringPtr> CallSequence) {
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_TextWithCRLF);
+  if (EC)
+    return createFileError(Path, EC);
+  for (auto &Name : CallSequence)
+    OS << *Name << '\n';
+  OS.close();
+  if (OS.has_error())
+    return createFileError(Path, OS.error());
+  return Error::success();
+}
+
+Expected<Speculator::FunctionCandidatesMap>
+readSpeculationProfile(StringRef Path, ExecutionSession &ES,
+                       unsigned Lookahead) {
+  auto MB = MemoryBuffer::getFile(Path, /*IsText=*/true);
+  if (!MB)
+    return createFileError(Path, MB.getError());
+
+  std::vector<SymbolStringPtr> CallSequence;
+  for (line_iterator I(**MB, /*SkipBlanks=*/true), E; I != E; ++I)
+    CallSequence.push_back(ES.intern(I->trim()));
+
+  Speculator::FunctionCandidatesMap Candidates;
+  for (size_t I = 0, N = CallSequence.size(); I != N; ++I) {
+    auto &Likely = Candidates[CallSequence[I]];
+    for (size_t J = I + 1; J != N && J <= I + Lookahead; ++J)
+      if (CallSequence[J] != CallSequence[I])
+        Likely.insert(CallSequence[J]);
+  }
+  return std::move(Candidates);
+}
+
 // If two modules, share the same LLVMContext, different threads must
 // not access them concurrently without locking the associated LLVMContext
 // this implementation follows this contract.
@@ -8,8 +8,16 @@
 
 #include "llvm/ExecutionEngine/Orc/TargetProcess/SimpleExecutorMemoryManager.h"
 
+#include "llvm/Config/llvm-config.h"
 #include "llvm/ExecutionEngine/Orc/Shared/OrcRTBridge.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Process.h"
+
+#if defined(LLVM_ON_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #define DEBUG_TYPE "orc"
 
@@ -33,6 +41,54 @@ Expected<ExecutorAddr> SimpleExecutorMemoryManager::allocate(uint64_t Size) {
   return ExecutorAddr::fromPtr(MB.base());
 }
 
+Expected<std::pair<ExecutorAddr, std::string>>
+SimpleExecutorMemoryManager::allocateShared(uint64_t Size) {
+#if defined(LLVM_ON_UNIX)
+  std::string Name;
+  {
+    std::lock_guard<std::mutex> Lock(M);
+    Name = formatv("/llvm-orc-{0}-{1}", sys::Process::getProcessId(),
+                   NextSharedMemoryID++);
+  }
+
+  auto SystemError = [&](const Twine &What) {
+    std::error_code EC(errno, std::generic_category());
+    return make_error<StringError>(What + " " + Name + ": " + EC.message(),
+                                   EC);
+  };
+
+  int FD =
+      shm_open(Name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (FD < 0)
+    return SystemError("Cannot create shared memory object");
+  if (ftruncate(FD, Size) < 0) {
+    auto Err = SystemError("Cannot resize shared memory object");
+    close(FD);
+    shm_unlink(Name.c_str());
+    return std::move(Err);
+  }
+  void *Base = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, FD, 0);
+  if (Base == MAP_FAILED) {
+    auto Err = SystemError("Cannot map shared memory object");
+    close(FD);
+    shm_unlink(Name.c_str());
+    return std::move(Err);
+  }
+  close(FD);
+
+  std::lock_guard<std::mutex> Lock(M);
+  assert(!Allocations.count(Base) && "Duplicate allocation addr");
+  auto &A = Allocations[Base];
+  A.Size = Size;
+  A.SharedMemoryName = Name;
+  return std::make_pair(ExecutorAddr::fromPtr(Base), std::move(Name));
+#else
+  return make_error<StringError>(
+      "Shared memory allocations are not supported on this platform",
+      inconvertibleErrorCode());
+#endif
+}
+
 Error SimpleExecutorMemoryManager::finalize(tpctypes::FinalizeRequest &FR) {
   ExecutorAddr Base(~0ULL);
   std::vector<shared::WrapperFunctionCall> DeallocationActions;
@@ -57,6 +113,7 @@ Error SimpleExecutorMemoryManager::finalize(tpctypes::FinalizeRequest &FR) {
 
   // Get the Allocation for this finalization.
   size_t AllocSize = 0;
+  bool IsShared = false;
   {
     std::lock_guard<std::mutex> Lock(M);
     auto I = Allocations.find(Base.toPtr<void *>());
@@ -66,6 +123,7 @@ Error SimpleExecutorMemoryManager::finalize(tpctypes::FinalizeRequest &FR) {
                                          formatv("{0:x}", Base.getValue()),
                                      inconvertibleErrorCode());
     AllocSize = I->second.Size;
+    IsShared = !I->second.SharedMemoryName.empty();
     I->second.DeallocationActions = std::move(DeallocationActions);
   }
   ExecutorAddr AllocEnd = Base + ExecutorAddrDiff(AllocSize);
@@ -125,9 +183,13 @@ Error SimpleExecutorMemoryManager::finalize(tpctypes::FinalizeRequest &FR) {
                   AllocEnd.getValue()),
           inconvertibleErrorCode()));
 
+    // The controller writes the content of shared allocations in place, and
+    // the rest of the shared memory is still zero.
     char *Mem = Seg.Addr.toPtr<char *>();
-    memcpy(Mem, Seg.Content.data(), Seg.Content.size());
-    memset(Mem + Seg.Content.size(), 0, Seg.Size - Seg.Content.size());
+    if (!IsShared) {
+      memcpy(Mem, Seg.Content.data(), Seg.Content.size());
+      memset(Mem + Seg.Content.size(), 0, Seg.Size - Seg.Content.size());
+    }
     assert(Seg.Size <= std::numeric_limits<size_t>::max());
     if (auto EC = sys::Memory::protectMappedMemory(
             {Mem, static_cast<size_t>(Seg.Size)},
@@ -201,6 +263,8 @@ void SimpleExecutorMemoryManager::addBootstrapSymbols(
   M[rt::SimpleExecutorMemoryManagerInstanceName] = ExecutorAddr::fromPtr(this);
   M[rt::SimpleExecutorMemoryManagerReserveWrapperName] =
       ExecutorAddr::fromPtr(&reserveWrapper);
+  M[rt::SimpleExecutorMemoryManagerReserveSharedWrapperName] =
+      ExecutorAddr::fromPtr(&reserveSharedWrapper);
   M[rt::SimpleExecutorMemoryManagerFinalizeWrapperName] =
       ExecutorAddr::fromPtr(&finalizeWrapper);
   M[rt::SimpleExecutorMemoryManagerDeallocateWrapperName] =
@@ -220,6 +284,13 @@ Error SimpleExecutorMemoryManager::deallocateImpl(void *Base, Allocation &A) {
   if (auto EC = sys::Memory::releaseMappedMemory(MB))
     Err = joinErrors(std::move(Err), errorCodeToError(EC));
 
+#if defined(LLVM_ON_UNIX)
+  // The controller removes the name once it has mapped the memory, this only
+  // cleans up after controllers that did not get that far.
+  if (!A.SharedMemoryName.empty())
+    shm_unlink(A.SharedMemoryName.c_str());
+#endif
+
   return Err;
 }
 
@@ -234,6 +305,17 @@ SimpleExecutorMemoryManager::reserveWrapper(const char *ArgData,
           .release();
 }
 
+llvm::orc::shared::CWrapperFunctionResult
+SimpleExecutorMemoryManager::reserveSharedWrapper(const char *ArgData,
+                                                  size_t ArgSize) {
+  return shared::WrapperFunction<
+             rt::SPSSimpleExecutorMemoryManagerReserveSharedSignature>::
+      handle(ArgData, ArgSize,
+             shared::makeMethodWrapperHandler(
+                 &SimpleExecutorMemoryManager::allocateShared))
+          .release();
+}
+
 llvm::orc::shared::CWrapperFunctionResult
 SimpleExecutorMemoryManager::finalizeWrapper(const char *ArgData,
                                              size_t ArgSize) {
@@ -0,0 +1,302 @@
+//===--- TieredCompileLayer.cpp - Recompile hot functions -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+/// Returns true if the body of \p F can be moved to a function with another
+/// name, leaving a declaration behind for its other uses.
+static bool canMoveBody(Function &F,
+                        SmallPtrSetImpl<GlobalObject *> &Aliasees) {
+  // Aliases and block addresses have to refer to the definition.
+  if (Aliasees.count(&F))
+    return false;
+  for (BasicBlock &BB : F)
+    if (BB.hasAddressTaken())
+      return false;
+  return true;
+}
+
+TieredCompileLayer::TieredCompileLayer(
+    ExecutionSession &ES, IRLayer &FirstTierLayer, IRLayer &SecondTierLayer,
+    LazyCallThroughManager &LCTMgr,
+    IndirectStubsManagerBuilder BuildIndirectStubsManager,
+    uint64_t HotCallCount)
+    : IRLayer(ES, FirstTierLayer.getManglingOptions()),
+      FirstTierLayer(FirstTierLayer), SecondTierLayer(SecondTierLayer),
+      LCTMgr(LCTMgr),
+      BuildIndirectStubsManager(std::move(BuildIndirectStubsManager)),
+      HotCallCount(HotCallCount) {
+  assert(HotCallCount > 0 && "Hot call count must be positive");
+}
+
+size_t TieredCompileLayer::getNumRecompiledFunctions() const {
+  std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+  return NumRecompiledFunctions;
+}
+
+void TieredCompileLayer::emit(std::unique_ptr<MaterializationResponsibility> R,
+                              ThreadSafeModule TSM) {
+  assert(TSM && "Null module");
+
+  auto &ES = getExecutionSession();
+
+  // The initializer symbol of the module cannot be reexported, so keep such
+  // modules in one piece.
+  if (R->getInitializerSymbol()) {
+    FirstTierLayer.emit(std::move(R), std::move(TSM));
+    return;
+  }
+
+  auto &PDR = getPerDylibResources(R->getTargetJITDylib());
+
+  SymbolAliasMap NonCallables;
+  SymbolAliasMap Callables;
+  auto Err = TSM.withModuleDo([&](Module &M) -> Error {
+    cleanUpModule(M);
+
+    // Promote the local symbols, so that the functions extracted for the
+    // second tier can refer to them.
+    std::vector<GlobalValue *> PromotedGlobals;
+    {
+      std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+      PromotedGlobals = PromoteSymbols(M);
+    }
+    if (!PromotedGlobals.empty()) {
+      SymbolFlagsMap SymbolFlags;
+      IRSymbolMapper::add(ES, *getManglingOptions(), PromotedGlobals,
+                          SymbolFlags);
+      if (auto Err = R->defineMaterializing(SymbolFlags))
+        return Err;
+    }
+
+    // Keep the IR of the functions, for the second tier.
+    auto Source = std::make_shared<ThreadSafeModule>(cloneToNewContext(TSM));
+
+    SmallPtrSet<GlobalObject *, 4> Aliasees;
+    for (auto &A : M.aliases())
+      Aliasees.insert(A.getAliaseeObject());
+
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    const SymbolFlagsMap &Symbols = R->getSymbols();
+    LLVMContext &Ctx = M.getContext();
+    Type *Int8PtrTy = Type::getInt8PtrTy(Ctx);
+    Type *Int64Ty = Type::getInt64Ty(Ctx);
+    auto *NotifyHotTy =
+        FunctionType::get(Type::getVoidTy(Ctx), {Int8PtrTy, Int8PtrTy}, false);
+    auto toPointer = [&](const void *P, Type *Ty) {
+      return ConstantExpr::getIntToPtr(
+          ConstantInt::get(Int64Ty, reinterpret_cast<uintptr_t>(P)), Ty);
+    };
+    auto *NotifyHot = toPointer(
+        reinterpret_cast<const void *>(&TieredCompileLayer::notifyHot),
+        NotifyHotTy->getPointerTo());
+
+    std::vector<Function *> Defs;
+    for (auto &F : M.functions())
+      if (!F.isDeclaration())
+        Defs.push_back(&F);
+
+    for (Function *F : Defs) {
+      SymbolStringPtr StubName = Mangle(F->getName());
+      auto I = Symbols.find(StubName);
+      if (I == Symbols.end() || !I->second.isCallable() ||
+          !canMoveBody(*F, Aliasees))
+        continue;
+
+      TieredFunction *TF;
+      {
+        std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+        Functions.emplace_back();
+        TF = &Functions.back();
+      }
+      TF->PDR = &PDR;
+      TF->StubName = StubName;
+      TF->IRName = F->getName().str();
+      TF->SecondTierName = Mangle(TF->IRName + ".tier1");
+      TF->Source = Source;
+
+      // Move the body of the function out of the way, and leave a declaration
+      // for the calls, which then go through the stub.
+      F->setName(TF->IRName + ".tier0");
+      Function *Decl = Function::Create(F->getFunctionType(),
+                                        GlobalValue::ExternalLinkage,
+                                        TF->IRName, M);
+      Decl->copyAttributesFrom(F);
+      Decl->setPersonalityFn(nullptr);
+      F->replaceAllUsesWith(Decl);
+      F->setLinkage(GlobalValue::ExternalLinkage);
+      F->setComdat(nullptr);
+      Callables[StubName] =
+          SymbolAliasMapEntry(Mangle(F->getName()), I->second);
+
+      // Count the calls after the static allocas, and notify the layer when
+      // the function becomes hot.
+      BasicBlock::iterator InsertPt = F->getEntryBlock().getFirstInsertionPt();
+      while (isa<AllocaInst>(*InsertPt))
+        ++InsertPt;
+      IRBuilder<> B(&*InsertPt);
+      Constant *Counter = toPointer(&TF->CallCount, Int64Ty->getPointerTo());
+      Value *Count = B.CreateAdd(B.CreateLoad(Int64Ty, Counter), B.getInt64(1));
+      B.CreateStore(Count, Counter);
+      Value *IsHot = B.CreateICmpEQ(Count, B.getInt64(HotCallCount));
+      Instruction *Then = SplitBlockAndInsertIfThen(
+          IsHot, &*InsertPt, /*Unreachable=*/false,
+          MDBuilder(Ctx).createBranchWeights(1, 1 << 20));
+      B.SetInsertPoint(Then);
+      B.CreateCall(NotifyHotTy, NotifyHot,
+                   {toPointer(this, Int8PtrTy), toPointer(TF, Int8PtrTy)});
+    }
+
+    for (auto &KV : Symbols) {
+      auto &Name = KV.first;
+      auto &Flags = KV.second;
+      if (Callables.count(Name))
+        continue;
+      if (Flags.isCallable())
+        Callables[Name] = SymbolAliasMapEntry(Name, Flags);
+      else
+        NonCallables[Name] = SymbolAliasMapEntry(Name, Flags);
+    }
+    return Error::success();
+  });
+
+  if (Err) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  // Lodge the first tier module with the implementation dylib, and replace
+  // the symbols of the target dylib with reexports.
+  if (auto Err = FirstTierLayer.add(PDR.getImplDylib(), std::move(TSM))) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  if (!NonCallables.empty())
+    if (auto Err =
+            R->replace(reexports(PDR.getImplDylib(), std::move(NonCallables),
+                                 JITDylibLookupFlags::MatchAllSymbols))) {
+      ES.reportError(std::move(Err));
+      R->failMaterialization();
+      return;
+    }
+  if (!Callables.empty()) {
+    if (auto Err = R->replace(lazyReexports(LCTMgr, PDR.getISManager(),
+                                            PDR.getImplDylib(),
+                                            std::move(Callables)))) {
+      ES.reportError(std::move(Err));
+      R->failMaterialization();
+      return;
+    }
+  }
+}
+
+TieredCompileLayer::PerDylibResources &
+TieredCompileLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+
+  auto I = DylibResources.find(&TargetD);
+  if (I == DylibResources.end()) {
+    auto &ImplD = getExecutionSession().createBareJITDylib(TargetD.getName() +
+                                                           ".tiered");
+    JITDylibSearchOrder NewLinkOrder;
+    TargetD.withLinkOrderDo([&](const JITDylibSearchOrder &TargetLinkOrder) {
+      NewLinkOrder = TargetLinkOrder;
+    });
+
+    assert(!NewLinkOrder.empty() && NewLinkOrder.front().first == &TargetD &&
+           NewLinkOrder.front().second ==
+               JITDylibLookupFlags::MatchAllSymbols &&
+           "TargetD must be at the front of its own search order and match "
+           "non-exported symbol");
+    NewLinkOrder.insert(std::next(NewLinkOrder.begin()),
+                        {&ImplD, JITDylibLookupFlags::MatchAllSymbols});
+    ImplD.setLinkOrder(NewLinkOrder, false);
+    TargetD.setLinkOrder(std::move(NewLinkOrder), false);
+
+    PerDylibResources PDR(ImplD, BuildIndirectStubsManager());
+    I = DylibResources.insert(std::make_pair(&TargetD, std::move(PDR))).first;
+  }
+
+  return I->second;
+}
+
+void TieredCompileLayer::cleanUpModule(Module &M) {
+  for (auto &F : M.functions()) {
+    if (F.isDeclaration())
+      continue;
+
+    if (F.hasAvailableExternallyLinkage()) {
+      F.deleteBody();
+      F.setPersonalityFn(nullptr);
+      continue;
+    }
+  }
+}
+
+void TieredCompileLayer::notifyHot(TieredCompileLayer *Layer,
+                                   TieredFunction *TF) {
+  Layer->getExecutionSession().dispatchTask(makeGenericNamedTask(
+      [Layer, TF]() { Layer->recompile(*TF); }, "recompile hot function"));
+}
+
+void TieredCompileLayer::recompile(TieredFunction &TF) {
+  auto &ES = getExecutionSession();
+  JITDylib &ImplD = TF.PDR->getImplDylib();
+
+  // Extract the function from the original IR. Everything else it refers to
+  // is defined by the first tier, and the calls it makes go through the stubs.
+  auto TSM = cloneToNewContext(*TF.Source, [&](const GlobalValue &GV) {
+    return GV.getName() == TF.IRName;
+  });
+  TSM.withModuleDo([&](Module &M) {
+    Function *F = M.getFunction(TF.IRName);
+    assert(F && !F->isDeclaration() && "Function was not extracted");
+    F->setName(TF.IRName + ".tier1");
+    F->setLinkage(GlobalValue::ExternalLinkage);
+    F->setComdat(nullptr);
+  });
+
+  if (auto Err = SecondTierLayer.add(ImplD, std::move(TSM))) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+
+  // Do not block the dispatcher while the module is compiled: with a fixed
+  // number of threads, that could starve the compilation itself.
+  ES.lookup(
+      LookupKind::Static,
+      makeJITDylibSearchOrder(&ImplD, JITDylibLookupFlags::MatchAllSymbols),
+      SymbolLookupSet(TF.SecondTierName), SymbolState::Ready,
+      [this, &TF](Expected<SymbolMap> Result) {
+        auto &ES = getExecutionSession();
+        if (!Result) {
+          ES.reportError(Result.takeError());
+          return;
+        }
+        JITTargetAddress Addr = (*Result)[TF.SecondTierName].getAddress();
+        if (auto Err = TF.PDR->getISManager().updatePointer(*TF.StubName,
+                                                           Addr)) {
+          ES.reportError(std::move(Err));
+          return;
+        }
+        std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+        ++NumRecompiledFunctions;
+      },
+      NoDependenciesToRegister);
+}
@@ -3170,6 +3170,8 @@ void AssemblyWriter::printFunctionSummary(const FunctionSummary *FS) {
         Out << ", hotness: " << getHotnessName(Call.second.getHotness());
       else if (Call.second.RelBlockFreq)
         Out << ", relbf: " << Call.second.RelBlockFreq;
+      if (Call.second.isICPTarget())
+        Out << ", icpTarget: 1";
       Out << ")";
     }
     Out << ")";
@@ -0,0 +1,200 @@
+//===- ModuleSummaryTable.cpp - Flat mmappable summary index --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the reader and the writer of ModuleSummaryTable.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/IR/ModuleSummaryTable.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace llvm;
+
+static const char Magic[4] = {'S', 'U', 'M', 'T'};
+
+static_assert(sizeof(ModuleSummaryTable::Header) == 24, "unexpected padding");
+static_assert(sizeof(ModuleSummaryTable::Module) == 28, "unexpected padding");
+static_assert(sizeof(ModuleSummaryTable::Entry) == 32, "unexpected padding");
+
+Expected<ModuleSummaryTable>
+ModuleSummaryTable::create(MemoryBufferRef Buffer) {
+  StringRef Data = Buffer.getBuffer();
+  if (Data.size() < sizeof(Header) ||
+      memcmp(Data.data(), Magic, sizeof(Magic)) != 0)
+    return createStringError(inconvertibleErrorCode(),
+                             "not a module summary table");
+  const auto *H = reinterpret_cast<const Header *>(Data.data());
+  if (H->Version != CurrentVersion)
+    return createStringError(inconvertibleErrorCode(),
+                             "unsupported module summary table version %u",
+                             uint32_t(H->Version));
+
+  uint64_t Size = sizeof(Header) + uint64_t(H->NumModules) * sizeof(Module) +
+                  uint64_t(H->NumEntries) * sizeof(Entry) +
+                  uint64_t(H->NumEdges) * sizeof(support::ulittle64_t) +
+                  H->StringTableSize;
+  if (Size != Data.size())
+    return createStringError(inconvertibleErrorCode(),
+                             "truncated or malformed module summary table");
+
+  ModuleSummaryTable Table;
+  const char *P = Data.data() + sizeof(Header);
+  Table.Modules = makeArrayRef(reinterpret_cast<const Module *>(P),
+                               H->NumModules);
+  P += H->NumModules * sizeof(Module);
+  Table.Entries = makeArrayRef(reinterpret_cast<const Entry *>(P),
+                               H->NumEntries);
+  P += H->NumEntries * sizeof(Entry);
+  Table.Edges = makeArrayRef(reinterpret_cast<const support::ulittle64_t *>(P),
+                             H->NumEdges);
+  P += H->NumEdges * sizeof(support::ulittle64_t);
+  Table.Strings = StringRef(P, H->StringTableSize);
+  return Table;
+}
+
+ArrayRef<ModuleSummaryTable::Entry>
+ModuleSummaryTable::lookup(GlobalValue::GUID GUID) const {
+  auto *Begin = partition_point(
+      Entries, [&](const Entry &E) { return E.GUID < GUID; });
+  auto *End = std::find_if(Begin, Entries.end(),
+                           [&](const Entry &E) { return E.GUID != GUID; });
+  return makeArrayRef(Begin, End);
+}
+
+StringRef ModuleSummaryTable::getModulePath(unsigned ModuleIndex) const {
+  if (ModuleIndex >= Modules.size())
+    return StringRef();
+  const Module &M = Modules[ModuleIndex];
+  if (uint64_t(M.PathOffset) + M.PathSize > Strings.size())
+    return StringRef();
+  return Strings.substr(M.PathOffset, M.PathSize);
+}
+
+ModuleHash ModuleSummaryTable::getModuleHash(unsigned ModuleIndex) const {
+  ModuleHash Hash = {{0}};
+  if (ModuleIndex < Modules.size())
+    std::copy(std::begin(Modules[ModuleIndex].Hash),
+              std::end(Modules[ModuleIndex].Hash), Hash.begin());
+  return Hash;
+}
+
+ArrayRef<support::ulittle64_t>
+ModuleSummaryTable::calls(const Entry &E) const {
+  if (uint64_t(E.FirstEdge) + E.NumCalls + E.NumRefs > Edges.size())
+    return None;
+  return Edges.slice(E.FirstEdge, E.NumCalls);
+}
+
+ArrayRef<support::ulittle64_t>
+ModuleSummaryTable::refs(const Entry &E) const {
+  if (uint64_t(E.FirstEdge) + E.NumCalls + E.NumRefs > Edges.size())
+    return None;
+  return Edges.slice(E.FirstEdge + E.NumCalls, E.NumRefs);
+}
+
+void llvm::writeModuleSummaryTable(const ModuleSummaryIndex &Index,
+                                   raw_ostream &OS) {
+  // Number the modules in the order of their paths, so that the table does
+  // not depend on the iteration order of the module path string table.
+  std::vector<StringRef> ModulePaths;
+  for (const auto &MPI : Index.modulePaths())
+    ModulePaths.push_back(MPI.first());
+  llvm::sort(ModulePaths);
+  DenseMap<StringRef, uint32_t> ModuleIndices;
+  for (StringRef Path : ModulePaths)
+    ModuleIndices.insert({Path, ModuleIndices.size()});
+
+  uint32_t NumEntries = 0, NumEdges = 0;
+  for (const auto &GVI : Index)
+    for (const auto &S : GVI.second.SummaryList) {
+      ++NumEntries;
+      if (const auto *FS = dyn_cast<FunctionSummary>(S.get()))
+        NumEdges += FS->calls().size();
+      if (const auto *AS = dyn_cast<AliasSummary>(S.get()))
+        NumEdges += AS->hasAliasee();
+      else
+        NumEdges += S->refs().size();
+    }
+  uint32_t StringTableSize = 0;
+  for (StringRef Path : ModulePaths)
+    StringTableSize += Path.size();
+
+  support::endian::Writer W(OS, support::little);
+  OS.write(Magic, sizeof(Magic));
+  W.write<uint32_t>(ModuleSummaryTable::CurrentVersion);
+  W.write<uint32_t>(ModulePaths.size());
+  W.write<uint32_t>(NumEntries);
+  W.write<uint32_t>(NumEdges);
+  W.write<uint32_t>(StringTableSize);
+
+  uint32_t PathOffset = 0;
+  for (StringRef Path : ModulePaths) {
+    W.write<uint32_t>(PathOffset);
+    W.write<uint32_t>(Path.size());
+    for (uint32_t H : Index.getModuleHash(Path))
+      W.write<uint32_t>(H);
+    PathOffset += Path.size();
+  }
+
+  // The global value map is ordered by GUID, which gives the order of the
+  // entries.
+  uint32_t FirstEdge = 0;
+  for (const auto &GVI : Index)
+    for (const auto &S : GVI.second.SummaryList) {
+      GlobalValueSummary::GVFlags Flags = S->flags();
+      uint32_t EntryFlags = Flags.Linkage |
+                            (uint32_t(S->getSummaryKind())
+                             << ModuleSummaryTable::KindShift);
+      if (Flags.Live)
+        EntryFlags |= ModuleSummaryTable::LiveFlag;
+      if (Flags.DSOLocal)
+        EntryFlags |= ModuleSummaryTable::DSOLocalFlag;
+      if (Flags.NotEligibleToImport)
+        EntryFlags |= ModuleSummaryTable::NotEligibleToImportFlag;
+      if (Flags.CanAutoHide)
+        EntryFlags |= ModuleSummaryTable::CanAutoHideFlag;
+
+      uint32_t InstCount = 0, NumCalls = 0, NumRefs = S->refs().size();
+      if (const auto *FS = dyn_cast<FunctionSummary>(S.get())) {
+        InstCount = FS->instCount();
+        NumCalls = FS->calls().size();
+      }
+      if (const auto *AS = dyn_cast<AliasSummary>(S.get()))
+        NumRefs = AS->hasAliasee();
+
+      W.write<uint64_t>(GVI.first);
+      W.write<uint32_t>(ModuleIndices.lookup(S->modulePath()));
+      W.write<uint32_t>(EntryFlags);
+      W.write<uint32_t>(InstCount);
+      W.write<uint32_t>(FirstEdge);
+      W.write<uint32_t>(NumCalls);
+      W.write<uint32_t>(NumRefs);
+      FirstEdge += NumCalls + NumRefs;
+    }
+
+  for (const auto &GVI : Index)
+    for (const auto &S : GVI.second.SummaryList) {
+      if (const auto *FS = dyn_cast<FunctionSummary>(S.get()))
+        for (const FunctionSummary::EdgeTy &Call : FS->calls())
+          W.write<uint64_t>(Call.first.getGUID());
+      if (const auto *AS = dyn_cast<AliasSummary>(S.get())) {
+        if (AS->hasAliasee())
+          W.write<uint64_t>(AS->getAliaseeGUID());
+        continue;
+      }
+      for (ValueInfo Ref : S->refs())
+        W.write<uint64_t>(Ref.getGUID());
+    }
+
+  for (StringRef Path : ModulePaths)
+    OS << Path;
+}
@@ -38,6 +38,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
@@ -57,6 +58,8 @@
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 #include "llvm/Transforms/Utils/SplitModule.h"
 
+#include <chrono>
+#include <condition_variable>
 #include <set>
 
 using namespace llvm;
@@ -74,23 +77,9 @@ cl::opt<bool> EnableLTOInternalization(
     "enable-lto-internalization", cl::init(true), cl::Hidden,
     cl::desc("Enable global value internalization in LTO"));
 
-// Computes a unique hash for the Module considering the current list of
-// export/import and other global analysis results.
-// The hash is produced in \p Key.
-void llvm::computeLTOCacheKey(
-    SmallString<40> &Key, const Config &Conf, const ModuleSummaryIndex &Index,
-    StringRef ModuleID, const FunctionImporter::ImportMapTy &ImportList,
-    const FunctionImporter::ExportSetTy &ExportList,
-    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
-    const GVSummaryMapTy &DefinedGlobals,
-    const std::set<GlobalValue::GUID> &CfiFunctionDefs,
-    const std::set<GlobalValue::GUID> &CfiFunctionDecls) {
-  // Compute the unique hash for this entry.
-  // This is based on the current compiler version, the module itself, the
-  // export list, the hash for every single module in the import list, the
-  // list of ResolvedODR for the module, and the list of preserved symbols.
-  SHA1 Hasher;
-
+/// Add the compiler version and the parts of \p Conf that affect code
+/// generation to a cache key.
+static void addConfigToCacheKey(SHA1 &Hasher, const Config &Conf) {
   // Start with the compiler revision
   Hasher.update(LLVM_VERSION_STRING);
 #ifdef LLVM_REVISION
@@ -107,11 +96,6 @@ void llvm::computeLTOCacheKey(
     support::endian::write32le(Data, I);
     Hasher.update(ArrayRef<uint8_t>{Data, 4});
   };
-  auto AddUint64 = [&](uint64_t I) {
-    uint8_t Data[8];
-    support::endian::write64le(Data, I);
-    Hasher.update(ArrayRef<uint8_t>{Data, 8});
-  };
   AddString(Conf.CPU);
   // FIXME: Hash more of Options. For now all clients initialize Options from
   // command-line flags (which is unsupported in production), but may set
@@ -141,6 +125,41 @@ void llvm::computeLTOCacheKey(
   AddString(Conf.OverrideTriple);
   AddString(Conf.DefaultTriple);
   AddString(Conf.DwoDir);
+}
+
+// Computes a unique hash for the Module considering the current list of
+// export/import and other global analysis results.
+// The hash is produced in \p Key.
+void llvm::computeLTOCacheKey(
+    SmallString<40> &Key, const Config &Conf, const ModuleSummaryIndex &Index,
+    StringRef ModuleID, const FunctionImporter::ImportMapTy &ImportList,
+    const FunctionImporter::ExportSetTy &ExportList,
+    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
+    const GVSummaryMapTy &DefinedGlobals,
+    const std::set<GlobalValue::GUID> &CfiFunctionDefs,
+    const std::set<GlobalValue::GUID> &CfiFunctionDecls) {
+  // Compute the unique hash for this entry.
+  // This is based on the current compiler version, the module itself, the
+  // export list, the hash for every single module in the import list, the
+  // list of ResolvedODR for the module, and the list of preserved symbols.
+  SHA1 Hasher;
+
+  addConfigToCacheKey(Hasher, Conf);
+
+  auto AddString = [&](StringRef Str) {
+    Hasher.update(Str);
+    Hasher.update(ArrayRef<uint8_t>{0});
+  };
+  auto AddUnsigned = [&](unsigned I) {
+    uint8_t Data[4];
+    support::endian::write32le(Data, I);
+    Hasher.update(ArrayRef<uint8_t>{Data, 4});
+  };
+  auto AddUint64 = [&](uint64_t I) {
+    uint8_t Data[8];
+    support::endian::write64le(Data, I);
+    Hasher.update(ArrayRef<uint8_t>{Data, 8});
+  };
 
   // Include the hash for the current module
   auto ModHash = Index.getModuleHash(ModuleID);
@@ -320,6 +339,15 @@ void llvm::computeLTOCacheKey(
   Key = toHex(Hasher.result());
 }
 
+void llvm::computeRegularLTOCacheKey(SmallString<40> &Key, const Config &Conf,
+                                     StringRef BC) {
+  SHA1 Hasher;
+  addConfigToCacheKey(Hasher, Conf);
+  Hasher.update("regular LTO partition");
+  Hasher.update(BC);
+  Key = toHex(Hasher.result());
+}
+
 static void thinLTOResolvePrevailingGUID(
     const Config &C, ValueInfo VI,
     DenseSet<GlobalValueSummary *> &GlobalInvolvedWithAlias,
@@ -1036,7 +1064,7 @@ Error LTO::run(AddStreamFn AddStream, FileCache Cache) {
     return StatsFileOrErr.takeError();
   std::unique_ptr<ToolOutputFile> StatsFile = std::move(StatsFileOrErr.get());
 
-  Error Result = runRegularLTO(AddStream);
+  Error Result = runRegularLTO(AddStream, Cache);
   if (!Result)
     Result = runThinLTO(AddStream, Cache, GUIDPreservedSymbols);
 
@@ -1046,7 +1074,7 @@ Error LTO::run(AddStreamFn AddStream, FileCache Cache) {
   return Result;
 }
 
-Error LTO::runRegularLTO(AddStreamFn AddStream) {
+Error LTO::runRegularLTO(AddStreamFn AddStream, FileCache Cache) {
   // Setup optimization remarks.
   auto DiagFileOrErr = lto::setupLLVMOptimizationRemarks(
       RegularLTO.CombinedModule->getContext(), Conf.RemarksFilename,
@@ -1139,7 +1167,8 @@ Error LTO::runRegularLTO(AddStreamFn AddStream) {
   if (!RegularLTO.EmptyCombinedModule || Conf.AlwaysEmitRegularLTOObj) {
     if (Error Err =
             backend(Conf, AddStream, RegularLTO.ParallelCodeGenParallelismLevel,
-                    *RegularLTO.CombinedModule, ThinLTO.CombinedIndex))
+                    *RegularLTO.CombinedModule, ThinLTO.CombinedIndex,
+                    Conf.CacheRegularLTO ? Cache : FileCache()))
       return Err;
   }
 
@@ -1181,6 +1210,28 @@ public:
 };
 
 namespace {
+/// A rough estimate of the peak memory used by the backend per IR
+/// instruction, covering the IR, the MIR and the codegen data structures.
+static const uint64_t BackendBytesPerInstruction = 1024;
+
+/// Estimate the work of the backend job of a module from the summaries: the
+/// number of instructions in the module and in the functions it imports.
+static uint64_t
+estimateBackendCost(const ModuleSummaryIndex &Index,
+                    const GVSummaryMapTy &DefinedGlobals,
+                    const FunctionImporter::ImportMapTy &ImportList) {
+  uint64_t NumInsts = 0;
+  for (auto &DefinedGlobal : DefinedGlobals)
+    if (auto *FS = dyn_cast<FunctionSummary>(DefinedGlobal.second))
+      NumInsts += FS->instCount();
+  for (auto &ImportedModule : ImportList)
+    for (GlobalValue::GUID GUID : ImportedModule.second)
+      if (auto *FS = dyn_cast_or_null<FunctionSummary>(
+              Index.findSummaryInModule(GUID, ImportedModule.first())))
+        NumInsts += FS->instCount();
+  return NumInsts;
+}
+
 class InProcessThinBackend : public ThinBackendProc {
   ThreadPool BackendThreadPool;
   AddStreamFn AddStream;
@@ -1191,15 +1242,34 @@ class InProcessThinBackend : public ThinBackendProc {
   Optional<Error> Err;
   std::mutex ErrMu;
 
+  /// The estimated peak memory that the running jobs may use together, or 0
+  /// for no limit, and the estimate for the jobs that are currently running.
+  uint64_t MemoryBudget;
+  uint64_t MemoryInUse = 0;
+  std::mutex MemoryMu;
+  std::condition_variable MemoryReleased;
+
+  /// The costs of a backend job, for Config::ThinLTOBackendReportFile.
+  struct JobReport {
+    std::string ModuleID;
+    unsigned Task = 0;
+    double WallSeconds = 0;
+    uint64_t NumImports = 0;
+    lto::ThinBackendStats Stats;
+    const char *CacheResult = "disabled";
+  };
+  std::vector<JobReport> Reports;
+  std::mutex ReportsMu;
+
 public:
   InProcessThinBackend(
       const Config &Conf, ModuleSummaryIndex &CombinedIndex,
-      ThreadPoolStrategy ThinLTOParallelism,
+      ThreadPoolStrategy ThinLTOParallelism, uint64_t MemoryBudget,
       const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
       AddStreamFn AddStream, FileCache Cache)
       : ThinBackendProc(Conf, CombinedIndex, ModuleToDefinedGVSummaries),
         BackendThreadPool(ThinLTOParallelism), AddStream(std::move(AddStream)),
-        Cache(std::move(Cache)) {
+        Cache(std::move(Cache)), MemoryBudget(MemoryBudget) {
     for (auto &Name : CombinedIndex.cfiFunctionDefs())
       CfiFunctionDefs.insert(
           GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
@@ -1215,7 +1285,10 @@ public:
       const FunctionImporter::ExportSetTy &ExportList,
       const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
       const GVSummaryMapTy &DefinedGlobals,
-      MapVector<StringRef, BitcodeModule> &ModuleMap) {
+      MapVector<StringRef, BitcodeModule> &ModuleMap, JobReport *Report) {
+    auto ModuleID = BM.getModuleIdentifier();
+    TimeTraceScope TimeScope("ThinLTO backend", ModuleID);
+
     auto RunThinBackend = [&](AddStreamFn AddStream) {
       LTOLLVMContext BackendContext(Conf);
       Expected<std::unique_ptr<Module>> MOrErr = BM.parseModule(BackendContext);
@@ -1223,11 +1296,11 @@ public:
         return MOrErr.takeError();
 
       return thinBackend(Conf, Task, AddStream, **MOrErr, CombinedIndex,
-                         ImportList, DefinedGlobals, &ModuleMap);
+                         ImportList, DefinedGlobals, &ModuleMap,
+                         std::vector<uint8_t>(),
+                         Report ? &Report->Stats : nullptr);
     };
 
-    auto ModuleID = BM.getModuleIdentifier();
-
     if (!Cache || !CombinedIndex.modulePaths().count(ModuleID) ||
         all_of(CombinedIndex.getModuleHash(ModuleID),
                [](uint32_t V) { return V == 0; }))
@@ -1244,6 +1317,8 @@ public:
     if (Error Err = CacheAddStreamOrErr.takeError())
       return Err;
     AddStreamFn &CacheAddStream = *CacheAddStreamOrErr;
+    if (Report)
+      Report->CacheResult = CacheAddStream ? "miss" : "hit";
     if (CacheAddStream)
       return RunThinBackend(CacheAddStream);
 
@@ -1260,6 +1335,21 @@ public:
     assert(ModuleToDefinedGVSummaries.count(ModulePath));
     const GVSummaryMapTy &DefinedGlobals =
         ModuleToDefinedGVSummaries.find(ModulePath)->second;
+
+    // Wait for enough of the budget to be released by the running jobs. A
+    // job that is larger than the whole budget still runs on its own.
+    uint64_t MemoryEstimate = 0;
+    if (MemoryBudget) {
+      MemoryEstimate =
+          estimateBackendCost(CombinedIndex, DefinedGlobals, ImportList) *
+          BackendBytesPerInstruction;
+      std::unique_lock<std::mutex> L(MemoryMu);
+      MemoryReleased.wait(L, [&] {
+        return MemoryInUse == 0 || MemoryInUse + MemoryEstimate <= MemoryBudget;
+      });
+      MemoryInUse += MemoryEstimate;
+    }
+
     BackendThreadPool.async(
         [=](BitcodeModule BM, ModuleSummaryIndex &CombinedIndex,
             const FunctionImporter::ImportMapTy &ImportList,
@@ -1271,9 +1361,27 @@ public:
           if (LLVM_ENABLE_THREADS && Conf.TimeTraceEnabled)
             timeTraceProfilerInitialize(Conf.TimeTraceGranularity,
                                         "thin backend");
+          Optional<JobReport> Report;
+          auto StartTime = std::chrono::steady_clock::now();
+          if (!Conf.ThinLTOBackendReportFile.empty()) {
+            Report.emplace();
+            Report->ModuleID = BM.getModuleIdentifier().str();
+            Report->Task = Task;
+            for (auto &ImportedModule : ImportList)
+              Report->NumImports += ImportedModule.second.size();
+          }
           Error E = runThinLTOBackendThread(
               AddStream, Cache, Task, BM, CombinedIndex, ImportList, ExportList,
-              ResolvedODR, DefinedGlobals, ModuleMap);
+              ResolvedODR, DefinedGlobals, ModuleMap,
+              Report ? Report.getPointer() : nullptr);
+          if (Report) {
+            Report->WallSeconds = std::chrono::duration<double>(
+                                      std::chrono::steady_clock::now() -
+                                      StartTime)
+                                      .count();
+            std::unique_lock<std::mutex> L(ReportsMu);
+            Reports.push_back(std::move(*Report));
+          }
           if (E) {
             std::unique_lock<std::mutex> L(ErrMu);
             if (Err)
@@ -1283,6 +1391,11 @@ public:
           }
           if (LLVM_ENABLE_THREADS && Conf.TimeTraceEnabled)
             timeTraceProfilerFinishThread();
+          if (MemoryEstimate) {
+            std::unique_lock<std::mutex> L(MemoryMu);
+            MemoryInUse -= MemoryEstimate;
+            MemoryReleased.notify_all();
+          }
         },
         BM, std::ref(CombinedIndex), std::ref(ImportList), std::ref(ExportList),
         std::ref(ResolvedODR), std::ref(DefinedGlobals), std::ref(ModuleMap));
@@ -1291,6 +1404,13 @@ public:
 
   Error wait() override {
     BackendThreadPool.wait();
+    if (!Conf.ThinLTOBackendReportFile.empty())
+      if (Error E = writeReport()) {
+        if (Err)
+          Err = joinErrors(std::move(*Err), std::move(E));
+        else
+          Err = std::move(E);
+      }
     if (Err)
       return std::move(*Err);
     else
@@ -1300,16 +1420,47 @@ public:
   unsigned getThreadCount() override {
     return BackendThreadPool.getThreadCount();
   }
+
+private:
+  Error writeReport() {
+    std::error_code EC;
+    raw_fd_ostream OS(Conf.ThinLTOBackendReportFile, EC, sys::fs::OF_Text);
+    if (EC)
+      return createFileError(Conf.ThinLTOBackendReportFile, EC);
+
+    // List the slowest jobs first, so that the stragglers are easy to spot.
+    llvm::stable_sort(Reports, [](const JobReport &A, const JobReport &B) {
+      return A.WallSeconds > B.WallSeconds;
+    });
+    json::OStream J(OS, 2);
+    J.array([&] {
+      for (const JobReport &R : Reports)
+        J.object([&] {
+          J.attribute("module", R.ModuleID);
+          J.attribute("task", int64_t(R.Task));
+          J.attribute("wall_seconds", R.WallSeconds);
+          J.attribute("peak_malloc_bytes", int64_t(R.Stats.PeakMallocUsage));
+          J.attribute("imports", int64_t(R.NumImports));
+          J.attribute("optimized_instructions",
+                      int64_t(R.Stats.OptimizedInstCount));
+          J.attribute("cache", R.CacheResult);
+        });
+    });
+    OS << '\n';
+    Reports.clear();
+    return Error::success();
+  }
 };
 } // end anonymous namespace
 
-ThinBackend lto::createInProcessThinBackend(ThreadPoolStrategy Parallelism) {
+ThinBackend lto::createInProcessThinBackend(ThreadPoolStrategy Parallelism,
+                                            uint64_t MemoryBudget) {
   return [=](const Config &Conf, ModuleSummaryIndex &CombinedIndex,
              const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
              AddStreamFn AddStream, FileCache Cache) {
     return std::make_unique<InProcessThinBackend>(
-        Conf, CombinedIndex, Parallelism, ModuleToDefinedGVSummaries, AddStream,
-        Cache);
+        Conf, CombinedIndex, Parallelism, MemoryBudget,
+        ModuleToDefinedGVSummaries, AddStream, Cache);
   };
 }
 
@@ -1369,8 +1520,7 @@ public:
                                      ImportList, ModuleToSummariesForIndex);
 
     std::error_code EC;
-    raw_fd_ostream OS(NewModulePath + ".thinlto.bc", EC,
-                      sys::fs::OpenFlags::OF_None);
+    raw_fd_stream OS(NewModulePath + ".thinlto.bc", EC);
     if (EC)
       return errorCodeToError(EC);
     writeIndexToFile(CombinedIndex, OS, &ModuleToSummariesForIndex);
@@ -1561,15 +1711,27 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
       if (Error E = ProcessOneModule(I))
         return E;
   } else {
-    // When executing in parallel, process largest bitsize modules first to
+    // When executing in parallel, process the largest modules first to
     // improve parallelism, and avoid starving the thread pool near the end.
     // This saves about 15 sec on a 36-core machine while link `clang.exe` (out
-    // of 100 sec).
+    // of 100 sec). The size of a module is estimated from the summaries of the
+    // functions it defines and imports; the bitcode size breaks ties, and is
+    // all there is for modules without function summaries.
     std::vector<BitcodeModule *> ModulesVec;
     ModulesVec.reserve(ModuleMap.size());
     for (auto &Mod : ModuleMap)
       ModulesVec.push_back(&Mod.second);
-    for (int I : generateModulesOrdering(ModulesVec))
+    std::vector<int> ModulesOrdering = generateModulesOrdering(ModulesVec);
+    std::vector<uint64_t> Costs;
+    Costs.reserve(ModuleMap.size());
+    for (auto &Mod : ModuleMap)
+      Costs.push_back(estimateBackendCost(
+          ThinLTO.CombinedIndex, ModuleToDefinedGVSummaries[Mod.first],
+          ImportLists[Mod.first]));
+    llvm::stable_sort(ModulesOrdering, [&](int LeftIndex, int RightIndex) {
+      return Costs[LeftIndex] > Costs[RightIndex];
+    });
+    for (int I : ModulesOrdering)
       if (Error E = ProcessOneModule(I))
         return E;
   }
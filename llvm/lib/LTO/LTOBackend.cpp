@@ -36,6 +36,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -118,7 +119,9 @@ Error Config::addSaveTemps(std::string OutputFileName,
         PathPrefix = M.getModuleIdentifier() + ".";
       std::string Path = PathPrefix + PathSuffix + ".bc";
       std::error_code EC;
-      raw_fd_ostream OS(Path, EC, sys::fs::OpenFlags::OF_None);
+      // A raw_fd_stream lets the bitcode writer stream to the file instead of
+      // buffering the whole module first.
+      raw_fd_stream OS(Path, EC);
       // Because -save-temps is a debugging feature, we report the error
       // directly and exit.
       if (EC)
@@ -140,7 +143,7 @@ Error Config::addSaveTemps(std::string OutputFileName,
           const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
         std::string Path = OutputFileName + "index.bc";
         std::error_code EC;
-        raw_fd_ostream OS(Path, EC, sys::fs::OpenFlags::OF_None);
+        raw_fd_stream OS(Path, EC);
         // Because -save-temps is a debugging feature, we report the error
         // directly and exit.
         if (EC)
@@ -431,14 +434,36 @@ static void codegen(const Config &Conf, TargetMachine *TM,
     DwoOut->keep();
 }
 
-static void splitCodeGen(const Config &C, TargetMachine *TM,
-                         AddStreamFn AddStream,
-                         unsigned ParallelCodeGenParallelismLevel, Module &Mod,
-                         const ModuleSummaryIndex &CombinedIndex) {
+/// Returns true if the object file of a codegen partition only depends on its
+/// bitcode and on the configuration, so that it can be reused from a cache.
+static bool canCacheCodeGen(const Config &Conf) {
+  return !Conf.PreCodeGenModuleHook && !Conf.PreCodeGenPassesHook &&
+         Conf.DwoDir.empty() && Conf.SplitDwarfOutput.empty() &&
+         EmbedBitcode != LTOBitcodeEmbedding::EmbedOptimized;
+}
+
+/// Look up the object file of the codegen partition \p Task, whose bitcode is
+/// \p BC, in \p Cache. Returns a null stream callback if it was found, in
+/// which case the cache has already added it to the output, and otherwise the
+/// callback to store the object file with.
+static Expected<AddStreamFn> lookupCodeGenCache(const Config &Conf,
+                                                FileCache Cache, unsigned Task,
+                                                StringRef BC) {
+  SmallString<40> Key;
+  computeRegularLTOCacheKey(Key, Conf, BC);
+  return Cache(Task, Key);
+}
+
+static Error splitCodeGen(const Config &C, TargetMachine *TM,
+                          AddStreamFn AddStream,
+                          unsigned ParallelCodeGenParallelismLevel, Module &Mod,
+                          const ModuleSummaryIndex &CombinedIndex,
+                          FileCache Cache) {
   ThreadPool CodegenThreadPool(
       heavyweight_hardware_concurrency(ParallelCodeGenParallelismLevel));
   unsigned ThreadCount = 0;
   const Target *T = &TM->getTarget();
+  Error CacheErr = Error::success();
 
   SplitModule(
       Mod, ParallelCodeGenParallelismLevel,
@@ -453,9 +478,30 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
         raw_svector_ostream BCOS(BC);
         WriteBitcodeToFile(*MPart, BCOS);
 
+        // SplitModule assigns globals to partitions by the hash of their
+        // names, so a change to a few functions only changes the bitcode of
+        // the partitions holding them, and the other ones can be taken from
+        // the cache.
+        unsigned Task = ThreadCount++;
+        if (CacheErr)
+          return;
+        AddStreamFn PartAddStream = AddStream;
+        if (Cache) {
+          Expected<AddStreamFn> CacheAddStreamOrErr =
+              lookupCodeGenCache(C, Cache, Task, BC);
+          if (!CacheAddStreamOrErr) {
+            CacheErr = CacheAddStreamOrErr.takeError();
+            return;
+          }
+          if (!*CacheAddStreamOrErr)
+            return;
+          PartAddStream = std::move(*CacheAddStreamOrErr);
+        }
+
         // Enqueue the task
         CodegenThreadPool.async(
-            [&](const SmallString<0> &BC, unsigned ThreadId) {
+            [&](const SmallString<0> &BC, unsigned ThreadId,
+                const AddStreamFn &PartAddStream) {
               LTOLLVMContext Ctx(C);
               Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
                   MemoryBufferRef(StringRef(BC.data(), BC.size()), "ld-temp.o"),
@@ -467,12 +513,12 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
               std::unique_ptr<TargetMachine> TM =
                   createTargetMachine(C, T, *MPartInCtx);
 
-              codegen(C, TM.get(), AddStream, ThreadId, *MPartInCtx,
+              codegen(C, TM.get(), PartAddStream, ThreadId, *MPartInCtx,
                       CombinedIndex);
             },
             // Pass BC using std::move to ensure that it get moved rather than
             // copied into the thread's context.
-            std::move(BC), ThreadCount++);
+            std::move(BC), Task, std::move(PartAddStream));
       },
       false);
 
@@ -480,6 +526,7 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
   // variables, we need to wait for the worker threads to terminate before we
   // can leave the function scope.
   CodegenThreadPool.wait();
+  return CacheErr;
 }
 
 static Expected<const Target *> initAndLookupTarget(const Config &C,
@@ -509,7 +556,7 @@ Error lto::finalizeOptimizationRemarks(
 
 Error lto::backend(const Config &C, AddStreamFn AddStream,
                    unsigned ParallelCodeGenParallelismLevel, Module &Mod,
-                   ModuleSummaryIndex &CombinedIndex) {
+                   ModuleSummaryIndex &CombinedIndex, FileCache Cache) {
   Expected<const Target *> TOrErr = initAndLookupTarget(C, Mod);
   if (!TOrErr)
     return TOrErr.takeError();
@@ -523,13 +570,27 @@ Error lto::backend(const Config &C, AddStreamFn AddStream,
       return Error::success();
   }
 
+  if (Cache && !canCacheCodeGen(C))
+    Cache = nullptr;
+
   if (ParallelCodeGenParallelismLevel == 1) {
+    if (Cache) {
+      SmallString<0> BC;
+      raw_svector_ostream BCOS(BC);
+      WriteBitcodeToFile(Mod, BCOS);
+      Expected<AddStreamFn> CacheAddStreamOrErr =
+          lookupCodeGenCache(C, Cache, 0, BC);
+      if (!CacheAddStreamOrErr)
+        return CacheAddStreamOrErr.takeError();
+      if (!*CacheAddStreamOrErr)
+        return Error::success();
+      AddStream = std::move(*CacheAddStreamOrErr);
+    }
     codegen(C, TM.get(), AddStream, 0, Mod, CombinedIndex);
-  } else {
-    splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel, Mod,
-                 CombinedIndex);
+    return Error::success();
   }
-  return Error::success();
+  return splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel,
+                      Mod, CombinedIndex, Cache);
 }
 
 static void dropDeadSymbols(Module &Mod, const GVSummaryMapTy &DefinedGlobals,
@@ -558,7 +619,8 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
                        const FunctionImporter::ImportMapTy &ImportList,
                        const GVSummaryMapTy &DefinedGlobals,
                        MapVector<StringRef, BitcodeModule> *ModuleMap,
-                       const std::vector<uint8_t> &CmdArgs) {
+                       const std::vector<uint8_t> &CmdArgs,
+                       ThinBackendStats *Stats) {
   Expected<const Target *> TOrErr = initAndLookupTarget(Conf, Mod);
   if (!TOrErr)
     return TOrErr.takeError();
@@ -594,7 +656,14 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
                  CmdArgs))
           return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
 
+        if (Stats) {
+          Stats->OptimizedInstCount = Mod.getInstructionCount();
+          Stats->PeakMallocUsage = sys::Process::GetMallocUsage();
+        }
         codegen(Conf, TM, AddStream, Task, Mod, CombinedIndex);
+        if (Stats)
+          Stats->PeakMallocUsage =
+              std::max(Stats->PeakMallocUsage, sys::Process::GetMallocUsage());
         return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
       };
 
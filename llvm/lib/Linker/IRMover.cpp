@@ -8,6 +8,7 @@
 
 #include "llvm/Linker/IRMover.h"
 #include "LinkDiagnosticInfo.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/Triple.h"
@@ -49,6 +50,12 @@ class TypeMapTy : public ValueMapTypeRemapper {
   /// getting a body from the source module.
   SmallPtrSet<StructType *, 16> DstResolvedOpaqueTypes;
 
+  /// This is the set of (destination, source) type pairs that were found not
+  /// to be isomorphic. Mappings are only added while the type map is being
+  /// computed, so a pair that was rejected once is rejected again, and the
+  /// walk of the two types can be skipped when many globals refer to them.
+  DenseSet<std::pair<Type *, Type *>> NonIsomorphicTypes;
+
 public:
   TypeMapTy(IRMover::IdentifiedStructTypeSet &DstStructTypesSet)
       : DstStructTypesSet(DstStructTypesSet) {}
@@ -84,6 +91,9 @@ void TypeMapTy::addTypeMapping(Type *DstTy, Type *SrcTy) {
   assert(SpeculativeTypes.empty());
   assert(SpeculativeDstOpaqueTypes.empty());
 
+  if (NonIsomorphicTypes.count({DstTy, SrcTy}))
+    return;
+
   // Check to see if these types are recursively isomorphic and establish a
   // mapping between them if so.
   if (!areTypesIsomorphic(DstTy, SrcTy)) {
@@ -96,6 +106,7 @@ void TypeMapTy::addTypeMapping(Type *DstTy, Type *SrcTy) {
                                    SpeculativeDstOpaqueTypes.size());
     for (StructType *Ty : SpeculativeDstOpaqueTypes)
       DstResolvedOpaqueTypes.erase(Ty);
+    NonIsomorphicTypes.insert({DstTy, SrcTy});
   } else {
     // SrcTy and DstTy are recursively ismorphic. We clear names of SrcTy
     // and all its descendants to lower amount of renaming in LLVM context
@@ -214,6 +225,7 @@ void TypeMapTy::linkDefinedTypeBodies() {
   }
   SrcDefinitionsToResolve.clear();
   DstResolvedOpaqueTypes.clear();
+  NonIsomorphicTypes.clear();
 }
 
 void TypeMapTy::finishType(StructType *DTy, StructType *STy,
@@ -245,7 +257,9 @@ Type *TypeMapTy::get(Type *Ty, SmallPtrSet<StructType *, 8> &Visited) {
   bool IsUniqued = !isa<StructType>(Ty) || cast<StructType>(Ty)->isLiteral();
 
   if (!IsUniqued) {
-#ifndef NDEBUG
+    // This walks the whole map for each identified struct, which is quadratic
+    // when linking many modules, so only do it with expensive checks.
+#ifdef EXPENSIVE_CHECKS
     for (auto &Pair : MappedTypes) {
       assert(!(Pair.first != Ty && Pair.second == Ty) &&
              "mapping to a source type");
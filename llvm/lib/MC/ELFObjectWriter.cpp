@@ -196,7 +196,7 @@ public:
                           const SectionIndexMapTy &SectionIndexMap,
                           const SectionOffsetsTy &SectionOffsets);
 
-  void writeSectionData(const MCAssembler &Asm, MCSection &Sec,
+  void writeSectionData(MCAssembler &Asm, MCSection &Sec,
                         const MCAsmLayout &Layout);
 
   void WriteSecHdrEntry(uint32_t Name, uint32_t Type, uint64_t Flags,
@@ -840,7 +840,7 @@ bool ELFWriter::maybeWriteCompression(
   return true;
 }
 
-void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
+void ELFWriter::writeSectionData(MCAssembler &Asm, MCSection &Sec,
                                  const MCAsmLayout &Layout) {
   MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
   StringRef SectionName = Section.getName();
@@ -856,6 +856,7 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
   if (!CompressionEnabled || !SectionName.startswith(".debug_") ||
       SectionName == ".debug_frame") {
     Asm.writeSectionData(W.OS, &Section, Layout);
+    Asm.releaseSectionData(Section);
     return;
   }
 
@@ -866,6 +867,8 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
   SmallVector<char, 128> UncompressedData;
   raw_svector_ostream VecOS(UncompressedData);
   Asm.writeSectionData(VecOS, &Section, Layout);
+  // Free the fragments before making another copy of the section.
+  Asm.releaseSectionData(Section);
 
   SmallVector<char, 128> CompressedContents;
   if (Error E = zlib::compress(
@@ -70,6 +70,9 @@ STATISTIC(FragmentLayouts, "Number of fragment layouts");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
+STATISTIC(SkippedRelaxations,
+          "Number of fragments not revisited because no fragment they depend "
+          "on changed size");
 
 } // end namespace stats
 } // end anonymous namespace
@@ -788,6 +791,36 @@ void MCAssembler::writeSectionData(raw_ostream &OS, const MCSection *Sec,
          OS.tell() - Start == Layout.getSectionAddressSize(Sec));
 }
 
+void MCAssembler::releaseSectionData(MCSection &Sec) {
+  // The size of a virtual section is still needed for its section header.
+  if (Sec.isVirtualSection())
+    return;
+  for (MCFragment &F : Sec) {
+    switch (F.getKind()) {
+    default:
+      break;
+    case MCFragment::FT_Data:
+      cast<MCDataFragment>(F).releaseContentsAndFixups();
+      break;
+    case MCFragment::FT_Relaxable:
+      cast<MCRelaxableFragment>(F).releaseContentsAndFixups();
+      break;
+    case MCFragment::FT_Dwarf:
+      cast<MCDwarfLineAddrFragment>(F).releaseContentsAndFixups();
+      break;
+    case MCFragment::FT_DwarfFrame:
+      cast<MCDwarfCallFrameFragment>(F).releaseContentsAndFixups();
+      break;
+    case MCFragment::FT_CVDefRange:
+      cast<MCCVDefRangeFragment>(F).releaseContentsAndFixups();
+      break;
+    case MCFragment::FT_PseudoProbe:
+      cast<MCPseudoProbeAddrFragment>(F).releaseContentsAndFixups();
+      break;
+    }
+  }
+}
+
 std::tuple<MCValue, uint64_t, bool>
 MCAssembler::handleFixup(const MCAsmLayout &Layout, MCFragment &F,
                          const MCFixup &Fixup) {
@@ -1191,25 +1224,74 @@ bool MCAssembler::relaxFragment(MCAsmLayout &Layout, MCFragment &F) {
   }
 }
 
-bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
-  // Holds the first fragment which needed relaxing during this layout. It will
-  // remain NULL if none were relaxed.
-  // When a fragment is relaxed, all the fragments following it should get
-  // invalidated because their offset is going to change.
-  MCFragment *FirstRelaxedFragment = nullptr;
-
-  // Attempt to relax all the fragments in the section.
-  for (MCFragment &Frag : Sec) {
-    // Check if this is a fragment that needs relaxation.
-    bool RelaxedFrag = relaxFragment(Layout, Frag);
-    if (RelaxedFrag && !FirstRelaxedFragment)
-      FirstRelaxedFragment = &Frag;
+/// Returns true if relaxFragment() may change the size of \p F.
+static bool mayRelax(const MCFragment &F) {
+  switch (F.getKind()) {
+  default:
+    return false;
+  case MCFragment::FT_Relaxable:
+  case MCFragment::FT_Dwarf:
+  case MCFragment::FT_DwarfFrame:
+  case MCFragment::FT_LEB:
+  case MCFragment::FT_BoundaryAlign:
+  case MCFragment::FT_CVInlineLines:
+  case MCFragment::FT_CVDefRange:
+  case MCFragment::FT_PseudoProbe:
+    return true;
   }
-  if (FirstRelaxedFragment) {
+}
+
+bool MCAssembler::layoutSection(MCAsmLayout &Layout, MCSection &Sec) {
+  // The fragments that may be relaxed, along with the highest layout order of
+  // the fragments their size depended on when they were last visited. A
+  // fragment only needs to be visited again if one of those fragments moved,
+  // i.e. if a fragment in front of it changed size. The other sections do not
+  // change while this one is relaxed.
+  struct Candidate {
+    MCFragment *Frag;
+    unsigned DependsOn;
+  };
+  SmallVector<Candidate, 0> Candidates;
+  for (MCFragment &Frag : Sec)
+    if (mayRelax(Frag))
+      Candidates.push_back({&Frag, ~0U});
+
+  bool WasRelaxed = false;
+  // Fragments up to and including this one kept their offset in the last
+  // iteration.
+  unsigned FirstMoved = 0;
+  while (true) {
+    // Holds the first fragment which needed relaxing during this iteration.
+    // It will remain NULL if none were relaxed. When a fragment is relaxed,
+    // all the fragments following it should get invalidated because their
+    // offset is going to change.
+    MCFragment *FirstRelaxedFragment = nullptr;
+    for (Candidate &C : Candidates) {
+      if (C.DependsOn <= FirstMoved) {
+        ++stats::SkippedRelaxations;
+        continue;
+      }
+      Layout.startRecordingOffsetQueries(&Sec);
+      bool RelaxedFrag = relaxFragment(Layout, *C.Frag);
+      C.DependsOn = Layout.stopRecordingOffsetQueries();
+      // The padding of a boundary align fragment also depends on the size of
+      // the fragments it aligns.
+      if (auto *BF = dyn_cast<MCBoundaryAlignFragment>(C.Frag))
+        if (const MCFragment *Last = BF->getLastFragment())
+          C.DependsOn = std::max(C.DependsOn, Last->getLayoutOrder());
+      // A fragment that was relaxed may need to be relaxed again.
+      if (RelaxedFrag) {
+        C.DependsOn = ~0U;
+        if (!FirstRelaxedFragment)
+          FirstRelaxedFragment = C.Frag;
+      }
+    }
+    if (!FirstRelaxedFragment)
+      return WasRelaxed;
     Layout.invalidateFragmentsFrom(FirstRelaxedFragment);
-    return true;
+    FirstMoved = FirstRelaxedFragment->getLayoutOrder();
+    WasRelaxed = true;
   }
-  return false;
 }
 
 bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
@@ -1217,7 +1299,7 @@ bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
 
   bool WasRelaxed = false;
   for (MCSection &Sec : *this) {
-    while (layoutSectionOnce(Layout, Sec))
+    if (layoutSection(Layout, Sec))
       WasRelaxed = true;
   }
 
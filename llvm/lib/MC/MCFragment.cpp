@@ -23,6 +23,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <utility>
@@ -94,6 +95,9 @@ void MCAsmLayout::ensureValid(const MCFragment *F) const {
 }
 
 uint64_t MCAsmLayout::getFragmentOffset(const MCFragment *F) const {
+  if (F->getParent() == RecordedSection)
+    MaxRecordedLayoutOrder =
+        std::max(MaxRecordedLayoutOrder, F->getLayoutOrder());
   ensureValid(F);
   assert(F->Offset != ~UINT64_C(0) && "Address not set!");
   return F->Offset;
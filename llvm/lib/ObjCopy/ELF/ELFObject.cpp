@@ -2102,8 +2102,9 @@ template <class ELFT> Error ELFWriter<ELFT>::writeSectionData() {
   for (SectionBase &Sec : Obj.sections())
     // Segments are responsible for writing their contents, so only write the
     // section data if the section is not in a segment. Note that this renders
-    // sections in segments effectively immutable.
-    if (Sec.ParentSegment == nullptr)
+    // sections in segments effectively immutable. Unchanged contents have
+    // been added as chunks already.
+    if (Sec.ParentSegment == nullptr && Sec.getUnchangedContents().empty())
       if (Error Err = Sec.accept(*SecWriter))
         return Err;
 
@@ -2113,8 +2114,7 @@ template <class ELFT> Error ELFWriter<ELFT>::writeSectionData() {
 template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
   for (Segment &Seg : Obj.segments()) {
     size_t Size = std::min<size_t>(Seg.FileSize, Seg.getContents().size());
-    std::memcpy(Buf->getBufferStart() + Seg.Offset, Seg.getContents().data(),
-                Size);
+    addChunk(Seg.Offset, Seg.getContents().take_front(Size));
   }
 
   for (auto it : Obj.getUpdatedSections()) {
@@ -2125,7 +2125,7 @@ template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
     assert(Parent && "This section should've been part of a segment.");
     uint64_t Offset =
         Sec->OriginalOffset - Parent->OriginalOffset + Parent->Offset;
-    llvm::copy(Data, Buf->getBufferStart() + Offset);
+    addChunk(Offset, Data);
   }
 
   // Iterate over removed sections and overwrite their old data with zeroes.
@@ -2135,10 +2135,58 @@ template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
       continue;
     uint64_t Offset =
         Sec.OriginalOffset - Parent->OriginalOffset + Parent->Offset;
-    std::memset(Buf->getBufferStart() + Offset, 0, Sec.Size);
+    removeChunks(Offset, Sec.Size);
   }
 }
 
+template <class ELFT>
+void ELFWriter<ELFT>::addChunk(uint64_t Offset, ArrayRef<uint8_t> Data) {
+  if (Data.empty())
+    return;
+  // Later data overwrites earlier data, as if both were copied into Buf.
+  removeChunks(Offset, Data.size());
+  Chunks.emplace(Offset, Data);
+}
+
+template <class ELFT>
+void ELFWriter<ELFT>::removeChunks(uint64_t Offset, uint64_t Size) {
+  if (Size == 0)
+    return;
+  uint64_t End = Offset + Size;
+  auto It = Chunks.lower_bound(Offset);
+  if (It != Chunks.begin()) {
+    // Trim a chunk that starts before the range, keeping what follows it.
+    auto Prev = std::prev(It);
+    ArrayRef<uint8_t> Data = Prev->second;
+    uint64_t PrevEnd = Prev->first + Data.size();
+    if (PrevEnd > Offset) {
+      Prev->second = Data.take_front(Offset - Prev->first);
+      if (PrevEnd > End)
+        Chunks.emplace(End, Data.drop_front(End - Prev->first));
+    }
+  }
+  while (It != Chunks.end() && It->first < End) {
+    uint64_t ChunkEnd = It->first + It->second.size();
+    ArrayRef<uint8_t> Data = It->second;
+    uint64_t ChunkOffset = It->first;
+    It = Chunks.erase(It);
+    if (ChunkEnd > End) {
+      Chunks.emplace(End, Data.drop_front(End - ChunkOffset));
+      break;
+    }
+  }
+}
+
+template <class ELFT> void ELFWriter<ELFT>::zeroUnchunkedData() {
+  uint8_t *Start = reinterpret_cast<uint8_t *>(Buf->getBufferStart());
+  uint64_t Offset = 0;
+  for (const auto &Chunk : Chunks) {
+    std::memset(Start + Offset, 0, Chunk.first - Offset);
+    Offset = Chunk.first + Chunk.second.size();
+  }
+  std::memset(Start + Offset, 0, Buf->getBufferSize() - Offset);
+}
+
 template <class ELFT>
 ELFWriter<ELFT>::ELFWriter(Object &Obj, raw_ostream &Buf, bool WSH,
                            bool OnlyKeepDebug)
@@ -2511,9 +2559,20 @@ template <class ELFT> size_t ELFWriter<ELFT>::totalSize() const {
 }
 
 template <class ELFT> Error ELFWriter<ELFT>::write() {
-  // Segment data must be written first, so that the ELF header and program
+  // Segment data must be added first, so that the ELF header and program
   // header tables can overwrite it, if covered by a segment.
   writeSegmentData();
+  for (const SectionBase &Sec : Obj.sections())
+    if (Sec.ParentSegment == nullptr)
+      addChunk(Sec.Offset, Sec.getUnchangedContents());
+  removeChunks(0, sizeof(Elf_Ehdr));
+  removeChunks(Obj.ProgramHdrSegment.Offset,
+               llvm::size(Obj.segments()) * sizeof(Elf_Phdr));
+  if (WriteSectionHeaders)
+    removeChunks(Obj.SHOff, Buf->getBufferSize() - Obj.SHOff);
+
+  // Everything else is generated in Buf, which is not initialized.
+  zeroUnchunkedData();
   writeEhdr();
   writePhdrs();
   if (Error E = writeSectionData())
@@ -2521,9 +2580,17 @@ template <class ELFT> Error ELFWriter<ELFT>::write() {
   if (WriteSectionHeaders)
     writeShdrs();
 
-  // TODO: Implement direct writing to the output stream (without intermediate
-  // memory buffer Buf).
-  Out.write(Buf->getBufferStart(), Buf->getBufferSize());
+  // Interleave the generated data with the chunks, in file order.
+  const char *Start = Buf->getBufferStart();
+  uint64_t Offset = 0;
+  for (const auto &Chunk : Chunks) {
+    Out.write(Start + Offset, Chunk.first - Offset);
+    Out.write(reinterpret_cast<const char *>(Chunk.second.data()),
+              Chunk.second.size());
+    Offset = Chunk.first + Chunk.second.size();
+  }
+  Out.write(Start + Offset, Buf->getBufferSize() - Offset);
+  Chunks.clear();
   return Error::success();
 }
 
@@ -2646,7 +2713,9 @@ template <class ELFT> Error ELFWriter<ELFT>::finalize() {
   }
 
   size_t TotalSize = totalSize();
-  Buf = WritableMemoryBuffer::getNewMemBuffer(TotalSize);
+  // Only the parts of Buf that are not streamed from the input are written,
+  // see write(), so don't touch the rest by zeroing it here.
+  Buf = WritableMemoryBuffer::getNewUninitMemBuffer(TotalSize);
   if (!Buf)
     return createStringError(errc::not_enough_memory,
                              "failed to allocate memory buffer of " +
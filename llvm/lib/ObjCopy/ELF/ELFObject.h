@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <vector>
@@ -336,6 +337,15 @@ private:
   Error writeSectionData();
   void writeSegmentData();
 
+  // Data that is written out as is, keyed by its offset in the output. write()
+  // streams these ranges directly from where they live (usually the mapped
+  // input file) rather than copying them into Buf, so the pages of Buf that
+  // they cover are never touched. The ranges never overlap.
+  std::map<uint64_t, ArrayRef<uint8_t>> Chunks;
+  void addChunk(uint64_t Offset, ArrayRef<uint8_t> Data);
+  void removeChunks(uint64_t Offset, uint64_t Size);
+  void zeroUnchunkedData();
+
   void assignOffsets();
 
   std::unique_ptr<ELFSectionWriter<ELFT>> SecWriter;
@@ -430,6 +440,9 @@ public:
   virtual void
   replaceSectionReferences(const DenseMap<SectionBase *, SectionBase *> &);
   virtual bool hasContents() const { return false; }
+  // Returns the contents of the section if they are written out unchanged, so
+  // that the writer can stream them instead of copying them.
+  virtual ArrayRef<uint8_t> getUnchangedContents() const { return {}; }
   // Notify the section that it is subject to removal.
   virtual void onRemove();
 };
@@ -497,6 +510,9 @@ public:
   bool hasContents() const override {
     return Type != ELF::SHT_NOBITS && Type != ELF::SHT_NULL;
   }
+  ArrayRef<uint8_t> getUnchangedContents() const override {
+    return Type == ELF::SHT_NOBITS ? ArrayRef<uint8_t>() : Contents;
+  }
 };
 
 class OwnedDataSection : public SectionBase {
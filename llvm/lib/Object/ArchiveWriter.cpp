@@ -25,6 +25,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -403,6 +404,38 @@ getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
   return Ret;
 }
 
+namespace {
+// The archive symbols of one member, with offsets relative to Names.
+struct MemberSymbols {
+  SmallString<0> Names;
+  std::vector<unsigned> Offsets;
+  bool HasObject = false;
+  Error Err = Error::success();
+};
+} // namespace
+
+static void computeMemberSymbols(const NewArchiveMember &M,
+                                 MemberSymbols &Syms) {
+  raw_svector_ostream Names(Syms.Names);
+  if (M.Symbols) {
+    const file_magic Type = identify_magic(M.Buf->getBuffer());
+    Syms.HasObject = !M.Symbols->empty() || Type == file_magic::bitcode ||
+                     object::SymbolicFile::isSymbolicFile(Type, nullptr);
+    for (StringRef Name : *M.Symbols) {
+      Syms.Offsets.push_back(Names.tell());
+      Names << Name << '\0';
+    }
+    return;
+  }
+  Expected<std::vector<unsigned>> OffsetsOrErr =
+      getSymbols(M.Buf->getMemBufferRef(), Names, Syms.HasObject);
+  if (!OffsetsOrErr) {
+    Syms.Err = OffsetsOrErr.takeError();
+    return;
+  }
+  Syms.Offsets = std::move(*OffsetsOrErr);
+}
+
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, bool Deterministic,
@@ -471,7 +504,23 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  // Parsing the members for their symbols is the expensive part, so do it in
+  // parallel into separate buffers, which are then appended to SymNames in
+  // member order to keep the output deterministic.
+  std::vector<MemberSymbols> AllSymbols(NeedSymbols ? NewMembers.size() : 0);
+  parallelForEachN(0, AllSymbols.size(), [&](size_t I) {
+    computeMemberSymbols(NewMembers[I], AllSymbols[I]);
+  });
+  for (size_t I = 0, E = AllSymbols.size(); I != E; ++I) {
+    if (!AllSymbols[I].Err)
+      continue;
+    for (size_t Rest = I + 1; Rest != E; ++Rest)
+      consumeError(std::move(AllSymbols[Rest].Err));
+    return std::move(AllSymbols[I].Err);
+  }
+
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -509,11 +558,13 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
 
     std::vector<unsigned> Symbols;
     if (NeedSymbols) {
-      Expected<std::vector<unsigned>> SymbolsOrErr =
-          getSymbols(Buf, SymNames, HasObject);
-      if (auto E = SymbolsOrErr.takeError())
-        return std::move(E);
-      Symbols = std::move(*SymbolsOrErr);
+      MemberSymbols &Syms = AllSymbols[I];
+      unsigned Base = SymNames.tell();
+      SymNames << Syms.Names;
+      Symbols = std::move(Syms.Offsets);
+      for (unsigned &Offset : Symbols)
+        Offset += Base;
+      HasObject |= Syms.HasObject;
     }
 
     Pos += Header.size() + Data.size() + Padding.size();
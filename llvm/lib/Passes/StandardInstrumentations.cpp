@@ -29,6 +29,7 @@
 #include "llvm/IR/Verifier.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -160,6 +161,11 @@ cl::opt<std::string>
 
 // An option that determines where the generated website file (named
 // passes.html) and the associated pdf files (named diff_*.pdf) are saved.
+static cl::opt<bool> PrintAnalysisRecomputes(
+    "print-analysis-recomputes", cl::init(false), cl::Hidden,
+    cl::desc("Report how often each pass invalidated analyses that then had "
+             "to be recomputed, and how long recomputing them took"));
+
 static cl::opt<std::string> DotCfgDir(
     "dot-cfg-dir",
     cl::desc("Generate dot files into specified directory for changed IRs"),
@@ -2105,6 +2111,68 @@ void DotCfgChangeReporter::registerCallbacks(
   }
 }
 
+AnalysisRecomputeReporter::~AnalysisRecomputeReporter() {
+  if (Enabled)
+    print(OutStream ? *OutStream : errs());
+}
+
+void AnalysisRecomputeReporter::registerCallbacks(
+    PassInstrumentationCallbacks &PIC) {
+  if (!Enabled)
+    return;
+
+  auto GetKey = [](StringRef AnalysisID, Any IR) {
+    return (AnalysisID + Twine('\0') + getIRName(IR)).str();
+  };
+
+  PIC.registerAfterPassCallback(
+      [this](StringRef P, Any, const PreservedAnalyses &) { LastPass = P; });
+  PIC.registerAfterPassInvalidatedCallback(
+      [this](StringRef P, const PreservedAnalyses &) { LastPass = P; });
+
+  PIC.registerAnalysisInvalidatedCallback(
+      [this, GetKey](StringRef A, Any IR) {
+        ++Stats[{LastPass, A.str()}].Invalidations;
+        InvalidatedBy[GetKey(A, IR)] = LastPass;
+      });
+
+  PIC.registerBeforeAnalysisCallback([this, GetKey](StringRef A, Any IR) {
+    Running.push_back(
+        {GetKey(A, IR), TimeRecord::getCurrentTime(true).getWallTime()});
+  });
+  PIC.registerAfterAnalysisCallback([this](StringRef A, Any) {
+    assert(!Running.empty() && "unbalanced analysis callbacks");
+    RunningAnalysis R = Running.pop_back_val();
+    auto It = InvalidatedBy.find(R.Key);
+    if (It == InvalidatedBy.end())
+      return; // The first time this result is computed.
+    RecomputeStats &S = Stats[{It->second, A.str()}];
+    ++S.Recomputations;
+    S.Seconds += TimeRecord::getCurrentTime(false).getWallTime() - R.Start;
+    InvalidatedBy.erase(It);
+  });
+}
+
+void AnalysisRecomputeReporter::print(raw_ostream &OS) const {
+  using Entry = std::pair<const std::pair<std::string, std::string>,
+                          RecomputeStats>;
+  std::vector<const Entry *> Entries;
+  for (const Entry &E : Stats)
+    Entries.push_back(&E);
+  llvm::stable_sort(Entries, [](const Entry *L, const Entry *R) {
+    return L->second.Seconds > R->second.Seconds;
+  });
+
+  OS << "===" << std::string(73, '-') << "===\n"
+     << "                       Analysis recomputation report\n"
+     << "===" << std::string(73, '-') << "===\n"
+     << "  Recompute time  Recomputed  Invalidated  Pass / Analysis\n";
+  for (const Entry *E : Entries)
+    OS << format("  %12.4fs  %10u  %11u  ", E->second.Seconds,
+                 E->second.Recomputations, E->second.Invalidations)
+       << E->first.first << " / " << E->first.second << '\n';
+}
+
 StandardInstrumentations::StandardInstrumentations(
     bool DebugLogging, bool VerifyEach, PrintPassOptions PrintPassOpts)
     : PrintPass(DebugLogging, PrintPassOpts), OptNone(DebugLogging),
@@ -2116,7 +2184,8 @@ StandardInstrumentations::StandardInstrumentations(
               PrintChanged == ChangePrinter::PrintChangedColourDiffQuiet),
       WebsiteChangeReporter(PrintChanged ==
                             ChangePrinter::PrintChangedDotCfgVerbose),
-      Verify(DebugLogging), VerifyEach(VerifyEach) {}
+      Verify(DebugLogging), AnalysisRecomputes(PrintAnalysisRecomputes),
+      VerifyEach(VerifyEach) {}
 
 void StandardInstrumentations::registerCallbacks(
     PassInstrumentationCallbacks &PIC, FunctionAnalysisManager *FAM) {
@@ -2133,6 +2202,7 @@ void StandardInstrumentations::registerCallbacks(
     Verify.registerCallbacks(PIC);
   PrintChangedDiff.registerCallbacks(PIC);
   WebsiteChangeReporter.registerCallbacks(PIC);
+  AnalysisRecomputes.registerCallbacks(PIC);
 }
 
 template class ChangeReporter<std::string>;
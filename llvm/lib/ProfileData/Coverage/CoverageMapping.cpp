@@ -27,6 +27,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -228,32 +229,40 @@ static unsigned getMaxCounterID(const CounterMappingContext &Ctx,
   return MaxCounterID;
 }
 
-Error CoverageMapping::loadFunctionRecord(
-    const CoverageMappingRecord &Record,
-    IndexedInstrProfReader &ProfileReader) {
-  StringRef OrigFuncName = Record.FunctionName;
-  if (OrigFuncName.empty())
+Expected<bool>
+CoverageMapping::getFunctionCounts(const CoverageMappingRecord &Record,
+                                   IndexedInstrProfReader &ProfileReader,
+                                   std::vector<uint64_t> &Counts) {
+  if (Record.FunctionName.empty())
     return make_error<CoverageMapError>(coveragemap_error::malformed);
 
-  if (Record.Filenames.empty())
-    OrigFuncName = getFuncNameWithoutPrefix(OrigFuncName);
-  else
-    OrigFuncName = getFuncNameWithoutPrefix(OrigFuncName, Record.Filenames[0]);
-
-  CounterMappingContext Ctx(Record.Expressions);
-
-  std::vector<uint64_t> Counts;
   if (Error E = ProfileReader.getFunctionCounts(Record.FunctionName,
                                                 Record.FunctionHash, Counts)) {
     instrprof_error IPE = InstrProfError::take(std::move(E));
     if (IPE == instrprof_error::hash_mismatch) {
       FuncHashMismatches.emplace_back(std::string(Record.FunctionName),
                                       Record.FunctionHash);
-      return Error::success();
+      return false;
     } else if (IPE != instrprof_error::unknown_function)
       return make_error<InstrProfError>(IPE);
+    CounterMappingContext Ctx(Record.Expressions);
     Counts.assign(getMaxCounterID(Ctx, Record) + 1, 0);
   }
+  return true;
+}
+
+/// Evaluate the regions of \p Record with \p Counts, or return None if the
+/// record should be ignored.
+static Optional<FunctionRecord>
+buildFunctionRecord(const CoverageMappingRecord &Record,
+                    ArrayRef<uint64_t> Counts) {
+  StringRef OrigFuncName = Record.FunctionName;
+  if (Record.Filenames.empty())
+    OrigFuncName = getFuncNameWithoutPrefix(OrigFuncName);
+  else
+    OrigFuncName = getFuncNameWithoutPrefix(OrigFuncName, Record.Filenames[0]);
+
+  CounterMappingContext Ctx(Record.Expressions);
   Ctx.setCounts(Counts);
 
   assert(!Record.MappingRegions.empty() && "Function has no regions");
@@ -265,28 +274,33 @@ Error CoverageMapping::loadFunctionRecord(
   // when they have non-zero counts in the profile).
   if (Record.MappingRegions.size() == 1 &&
       Record.MappingRegions[0].Count.isZero() && Counts[0] > 0)
-    return Error::success();
+    return None;
 
   FunctionRecord Function(OrigFuncName, Record.Filenames);
   for (const auto &Region : Record.MappingRegions) {
     Expected<int64_t> ExecutionCount = Ctx.evaluate(Region.Count);
     if (auto E = ExecutionCount.takeError()) {
       consumeError(std::move(E));
-      return Error::success();
+      return None;
     }
     Expected<int64_t> AltExecutionCount = Ctx.evaluate(Region.FalseCount);
     if (auto E = AltExecutionCount.takeError()) {
       consumeError(std::move(E));
-      return Error::success();
+      return None;
     }
     Function.pushRegion(Region, *ExecutionCount, *AltExecutionCount);
   }
+  return std::move(Function);
+}
 
+void CoverageMapping::addFunctionRecord(const CoverageMappingRecord &Record,
+                                        FunctionRecord &&Function) {
   // Don't create records for (filenames, function) pairs we've already seen.
   auto FilenamesHash = hash_combine_range(Record.Filenames.begin(),
                                           Record.Filenames.end());
-  if (!RecordProvenance[FilenamesHash].insert(hash_value(OrigFuncName)).second)
-    return Error::success();
+  if (!RecordProvenance[FilenamesHash].insert(hash_value(Function.Name))
+           .second)
+    return;
 
   Functions.push_back(std::move(Function));
 
@@ -302,7 +316,20 @@ Error CoverageMapping::loadFunctionRecord(
     if (RecordIndices.empty() || RecordIndices.back() != RecordIndex)
       RecordIndices.push_back(RecordIndex);
   }
+}
+
+Error CoverageMapping::loadFunctionRecord(
+    const CoverageMappingRecord &Record,
+    IndexedInstrProfReader &ProfileReader) {
+  std::vector<uint64_t> Counts;
+  Expected<bool> HasCounts = getFunctionCounts(Record, ProfileReader, Counts);
+  if (!HasCounts)
+    return HasCounts.takeError();
+  if (!*HasCounts)
+    return Error::success();
 
+  if (Optional<FunctionRecord> Function = buildFunctionRecord(Record, Counts))
+    addFunctionRecord(Record, std::move(*Function));
   return Error::success();
 }
 
@@ -323,6 +350,79 @@ Error CoverageMapping::loadFromReaders(
   return Error::success();
 }
 
+Error CoverageMapping::loadFromReaderInParallel(
+    const BinaryCoverageReader &Reader, IndexedInstrProfReader &ProfileReader,
+    CoverageMapping &Coverage, ThreadPool &Pool) {
+  struct DecodedRecord {
+    CoverageMappingRecord Record;
+    std::vector<StringRef> Filenames;
+    std::vector<CounterExpression> Expressions;
+    std::vector<CounterMappingRegion> MappingRegions;
+    Optional<Error> Err;
+    std::vector<uint64_t> Counts;
+    bool HasCounts = false;
+    Optional<FunctionRecord> Function;
+  };
+  // The records are decoded in batches, to bound the memory they use. Within
+  // a batch, the profile is read on this thread, and the records are added in
+  // order, so the result is the same as that of loadFromReaders.
+  const size_t BatchSize = 4096;
+  const size_t RecordsPerTask = 64;
+  ThreadPoolTaskGroup Group(Pool, /*Priority=*/1);
+  std::unique_ptr<DecodedRecord[]> Batch;
+  size_t BatchLen = 0;
+  auto ForEachRecord = [&](function_ref<void(DecodedRecord &)> Fn) {
+    for (size_t Begin = 0; Begin < BatchLen; Begin += RecordsPerTask)
+      Group.async([&, Begin] {
+        size_t End = std::min(BatchLen, Begin + RecordsPerTask);
+        for (size_t I = Begin; I != End; ++I)
+          Fn(Batch[I]);
+      });
+    Group.wait();
+  };
+  auto ConsumeErrors = [&](size_t Begin) {
+    for (size_t I = Begin; I != BatchLen; ++I)
+      consumeError(std::move(*Batch[I].Err));
+  };
+
+  size_t NumRecords = Reader.getNumRecords();
+  for (size_t BatchBegin = 0; BatchBegin < NumRecords;
+       BatchBegin += BatchSize) {
+    BatchLen = std::min(BatchSize, NumRecords - BatchBegin);
+    Batch.reset(new DecodedRecord[BatchLen]);
+    ForEachRecord([&](DecodedRecord &R) {
+      size_t Index = BatchBegin + (&R - Batch.get());
+      R.Err.emplace(Reader.readRecord(Index, R.Record, R.Filenames,
+                                      R.Expressions, R.MappingRegions));
+    });
+
+    for (size_t I = 0; I != BatchLen; ++I) {
+      DecodedRecord &R = Batch[I];
+      if (Error E = std::move(*R.Err)) {
+        ConsumeErrors(I + 1);
+        return E;
+      }
+      Expected<bool> HasCounts =
+          Coverage.getFunctionCounts(R.Record, ProfileReader, R.Counts);
+      if (!HasCounts) {
+        ConsumeErrors(I + 1);
+        return HasCounts.takeError();
+      }
+      R.HasCounts = *HasCounts;
+    }
+
+    ForEachRecord([&](DecodedRecord &R) {
+      if (R.HasCounts)
+        R.Function = buildFunctionRecord(R.Record, R.Counts);
+    });
+    for (size_t I = 0; I != BatchLen; ++I)
+      if (Batch[I].Function)
+        Coverage.addFunctionRecord(Batch[I].Record,
+                                   std::move(*Batch[I].Function));
+  }
+  return Error::success();
+}
+
 Expected<std::unique_ptr<CoverageMapping>> CoverageMapping::load(
     ArrayRef<std::unique_ptr<CoverageMappingReader>> CoverageReaders,
     IndexedInstrProfReader &ProfileReader) {
@@ -342,42 +442,117 @@ static Error handleMaybeNoDataFoundError(Error E) {
       });
 }
 
+namespace {
+
+/// The coverage readers of an object file, and the buffers they refer to.
+struct ObjectCoverageReaders {
+  std::unique_ptr<MemoryBuffer> CovMappingBuf;
+  SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
+  std::vector<std::unique_ptr<BinaryCoverageReader>> Readers;
+};
+
+} // end anonymous namespace
+
+/// Create the coverage readers of \p ObjectFilename. They are empty if the
+/// object has no coverage data.
+static Expected<ObjectCoverageReaders>
+createObjectCoverageReaders(StringRef ObjectFilename, StringRef Arch,
+                            StringRef CompilationDir) {
+  ObjectCoverageReaders Result;
+  auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(
+      ObjectFilename, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (std::error_code EC = CovMappingBufOrErr.getError())
+    return errorCodeToError(EC);
+  Result.CovMappingBuf = std::move(CovMappingBufOrErr.get());
+  auto CoverageReadersOrErr = BinaryCoverageReader::create(
+      Result.CovMappingBuf->getMemBufferRef(), Arch, Result.Buffers,
+      CompilationDir);
+  if (Error E = CoverageReadersOrErr.takeError()) {
+    E = handleMaybeNoDataFoundError(std::move(E));
+    if (E)
+      return std::move(E);
+    // E == success (originally a no_data_found error).
+    return std::move(Result);
+  }
+  Result.Readers = std::move(CoverageReadersOrErr.get());
+  return std::move(Result);
+}
+
 Expected<std::unique_ptr<CoverageMapping>>
 CoverageMapping::load(ArrayRef<StringRef> ObjectFilenames,
                       StringRef ProfileFilename, ArrayRef<StringRef> Arches,
-                      StringRef CompilationDir) {
+                      StringRef CompilationDir, ThreadPoolStrategy S) {
   auto ProfileReaderOrErr = IndexedInstrProfReader::create(ProfileFilename);
   if (Error E = ProfileReaderOrErr.takeError())
     return std::move(E);
   auto ProfileReader = std::move(ProfileReaderOrErr.get());
   auto Coverage = std::unique_ptr<CoverageMapping>(new CoverageMapping());
   bool DataFound = false;
+  auto GetArch = [&](size_t Index) {
+    return Arches.empty() ? StringRef() : Arches[Index];
+  };
 
-  for (const auto &File : llvm::enumerate(ObjectFilenames)) {
-    auto CovMappingBufOrErr = MemoryBuffer::getFileOrSTDIN(
-        File.value(), /*IsText=*/false, /*RequiresNullTerminator=*/false);
-    if (std::error_code EC = CovMappingBufOrErr.getError())
-      return errorCodeToError(EC);
-    StringRef Arch = Arches.empty() ? StringRef() : Arches[File.index()];
-    MemoryBufferRef CovMappingBufRef =
-        CovMappingBufOrErr.get()->getMemBufferRef();
-    SmallVector<std::unique_ptr<MemoryBuffer>, 4> Buffers;
-    auto CoverageReadersOrErr = BinaryCoverageReader::create(
-        CovMappingBufRef, Arch, Buffers, CompilationDir);
-    if (Error E = CoverageReadersOrErr.takeError()) {
-      E = handleMaybeNoDataFoundError(std::move(E));
-      if (E)
+  unsigned NumThreads = S.compute_thread_count();
+  if (NumThreads <= 1 || ObjectFilenames.empty()) {
+    for (const auto &File : llvm::enumerate(ObjectFilenames)) {
+      Expected<ObjectCoverageReaders> ObjectReaders =
+          createObjectCoverageReaders(File.value(), GetArch(File.index()),
+                                      CompilationDir);
+      if (!ObjectReaders)
+        return ObjectReaders.takeError();
+
+      SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
+      for (auto &Reader : ObjectReaders->Readers)
+        Readers.push_back(std::move(Reader));
+      DataFound |= !Readers.empty();
+      if (Error E = loadFromReaders(Readers, *ProfileReader, *Coverage))
         return std::move(E);
-      // E == success (originally a no_data_found error).
-      continue;
     }
+  } else {
+    // The objects are opened ahead of the one being loaded, a few at a time
+    // so that only a few of them are in memory at once. The records of each
+    // one are then decoded and evaluated on the pool, in order.
+    std::vector<Optional<Expected<ObjectCoverageReaders>>> Objects(
+        ObjectFilenames.size());
+    std::vector<std::shared_future<void>> Opened;
+    ThreadPool Pool(S);
+    ThreadPoolTaskGroup OpenGroup(Pool);
+    auto OpenObject = [&](size_t Index) {
+      Opened.push_back(OpenGroup.async([&, Index] {
+        Objects[Index].emplace(createObjectCoverageReaders(
+            ObjectFilenames[Index], GetArch(Index), CompilationDir));
+      }));
+    };
+    auto ConsumeErrors = [&](size_t Begin) {
+      OpenGroup.wait();
+      for (size_t I = Begin; I != Objects.size(); ++I)
+        if (Objects[I] && !*Objects[I])
+          consumeError(Objects[I]->takeError());
+    };
+
+    for (size_t I = 0; I != std::min<size_t>(NumThreads, Objects.size()); ++I)
+      OpenObject(I);
+    for (size_t I = 0; I != Objects.size(); ++I) {
+      Opened[I].wait();
+      if (I + NumThreads < Objects.size())
+        OpenObject(I + NumThreads);
+      Expected<ObjectCoverageReaders> &ObjectReaders = *Objects[I];
+      if (!ObjectReaders) {
+        Error E = ObjectReaders.takeError();
+        ConsumeErrors(I + 1);
+        return std::move(E);
+      }
 
-    SmallVector<std::unique_ptr<CoverageMappingReader>, 4> Readers;
-    for (auto &Reader : CoverageReadersOrErr.get())
-      Readers.push_back(std::move(Reader));
-    DataFound |= !Readers.empty();
-    if (Error E = loadFromReaders(Readers, *ProfileReader, *Coverage))
-      return std::move(E);
+      DataFound |= !ObjectReaders->Readers.empty();
+      for (const auto &Reader : ObjectReaders->Readers) {
+        if (Error E = loadFromReaderInParallel(*Reader, *ProfileReader,
+                                               *Coverage, Pool)) {
+          ConsumeErrors(I + 1);
+          return std::move(E);
+        }
+      }
+      Objects[I].reset();
+    }
   }
   // If no readers were created, either no objects were provided or none of them
   // had coverage data. Return an error in the latter case.
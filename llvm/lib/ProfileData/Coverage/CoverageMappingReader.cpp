@@ -1152,14 +1152,15 @@ BinaryCoverageReader::create(
   return std::move(Readers);
 }
 
-Error BinaryCoverageReader::readNextRecord(CoverageMappingRecord &Record) {
-  if (CurrentRecord >= MappingRecords.size())
-    return make_error<CoverageMapError>(coveragemap_error::eof);
-
+Error BinaryCoverageReader::readRecord(
+    size_t Index, CoverageMappingRecord &Record,
+    std::vector<StringRef> &FunctionsFilenames,
+    std::vector<CounterExpression> &Expressions,
+    std::vector<CounterMappingRegion> &MappingRegions) const {
   FunctionsFilenames.clear();
   Expressions.clear();
   MappingRegions.clear();
-  auto &R = MappingRecords[CurrentRecord];
+  auto &R = MappingRecords[Index];
   auto F = makeArrayRef(Filenames).slice(R.FilenamesBegin, R.FilenamesSize);
   RawCoverageMappingReader Reader(R.CoverageMapping, F, FunctionsFilenames,
                                   Expressions, MappingRegions);
@@ -1171,6 +1172,16 @@ Error BinaryCoverageReader::readNextRecord(CoverageMappingRecord &Record) {
   Record.Filenames = FunctionsFilenames;
   Record.Expressions = Expressions;
   Record.MappingRegions = MappingRegions;
+  return Error::success();
+}
+
+Error BinaryCoverageReader::readNextRecord(CoverageMappingRecord &Record) {
+  if (CurrentRecord >= MappingRecords.size())
+    return make_error<CoverageMapError>(coveragemap_error::eof);
+
+  if (auto Err = readRecord(CurrentRecord, Record, FunctionsFilenames,
+                            Expressions, MappingRegions))
+    return Err;
 
   ++CurrentRecord;
   return Error::success();
@@ -15,6 +15,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
@@ -1159,6 +1160,35 @@ bool isIRPGOFlagSet(const Module *M) {
   return (InitVal->getZExtValue() & VARIANT_MASK_IR_PROF) != 0;
 }
 
+std::vector<std::string>
+getTemporalProfFunctionOrder(ArrayRef<TemporalProfTraceTy> Traces) {
+  // The sum of the relative positions of each function in the traces it is
+  // part of, and the number of those traces.
+  StringMap<std::pair<double, size_t>> Positions;
+  for (const auto &Trace : Traces)
+    for (size_t I = 0, E = Trace.size(); I != E; ++I) {
+      auto &Position = Positions[Trace[I]];
+      Position.first += double(I) / E;
+      ++Position.second;
+    }
+
+  std::vector<std::pair<double, StringRef>> Order;
+  Order.reserve(Positions.size());
+  for (const auto &Entry : Positions) {
+    // Each trace a function is missing from adds a position of one.
+    double Sum =
+        Entry.second.first + double(Traces.size() - Entry.second.second);
+    Order.emplace_back(Sum / Traces.size(), Entry.getKey());
+  }
+  llvm::sort(Order);
+
+  std::vector<std::string> Names;
+  Names.reserve(Order.size());
+  for (const auto &Entry : Order)
+    Names.push_back(Entry.second.str());
+  return Names;
+}
+
 // Check if we can safely rename this Comdat function.
 bool canRenameComdatFunc(const Function &F, bool CheckAddressTaken) {
   if (F.getName().empty())
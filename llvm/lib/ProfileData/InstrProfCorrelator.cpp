@@ -16,20 +16,22 @@
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
 #include "llvm/Object/MachO.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/ThreadPool.h"
 
 #define DEBUG_TYPE "correlator"
 
 using namespace llvm;
 
-/// Get the __llvm_prf_cnts section.
-Expected<object::SectionRef> getCountersSection(const object::ObjectFile &Obj) {
+/// Get the section with the given name, e.g. __llvm_prf_cnts.
+static Expected<object::SectionRef> getSection(const object::ObjectFile &Obj,
+                                               StringRef Name) {
   for (auto &Section : Obj.sections())
     if (auto SectionName = Section.getName())
-      if (SectionName.get() == INSTR_PROF_CNTS_SECT_NAME)
+      if (SectionName.get() == Name)
         return Section;
   return make_error<InstrProfError>(
       instrprof_error::unable_to_correlate_profile,
-      "could not find counter section (" INSTR_PROF_CNTS_SECT_NAME ")");
+      "could not find section (" + Name + ")");
 }
 
 const char *InstrProfCorrelator::FunctionNameAttributeName = "Function Name";
@@ -38,11 +40,24 @@ const char *InstrProfCorrelator::NumCountersAttributeName = "Num Counters";
 
 llvm::Expected<std::unique_ptr<InstrProfCorrelator::Context>>
 InstrProfCorrelator::Context::get(std::unique_ptr<MemoryBuffer> Buffer,
-                                  const object::ObjectFile &Obj) {
-  auto CountersSection = getCountersSection(Obj);
+                                  const object::ObjectFile &Obj,
+                                  ProfCorrelatorKind FileKind) {
+  auto CountersSection = getSection(Obj, INSTR_PROF_CNTS_SECT_NAME);
   if (auto Err = CountersSection.takeError())
     return std::move(Err);
   auto C = std::make_unique<Context>();
+  if (FileKind == BINARY) {
+    auto DataSection = getSection(Obj, INSTR_PROF_COVDATA_SECT_NAME);
+    if (auto Err = DataSection.takeError())
+      return std::move(Err);
+    auto NamesSection = getSection(Obj, INSTR_PROF_COVNAME_SECT_NAME);
+    if (auto Err = NamesSection.takeError())
+      return std::move(Err);
+    if (auto Err = DataSection->getContents().moveInto(C->DataSection))
+      return std::move(Err);
+    if (auto Err = NamesSection->getContents().moveInto(C->NamesSection))
+      return std::move(Err);
+  }
   C->Buffer = std::move(Buffer);
   C->CountersSectionStart = CountersSection->getAddress();
   C->CountersSectionEnd = C->CountersSectionStart + CountersSection->getSize();
@@ -51,43 +66,47 @@ InstrProfCorrelator::Context::get(std::unique_ptr<MemoryBuffer> Buffer,
 }
 
 llvm::Expected<std::unique_ptr<InstrProfCorrelator>>
-InstrProfCorrelator::get(StringRef DebugInfoFilename) {
-  auto DsymObjectsOrErr =
-      object::MachOObjectFile::findDsymObjectMembers(DebugInfoFilename);
-  if (auto Err = DsymObjectsOrErr.takeError())
-    return std::move(Err);
-  if (!DsymObjectsOrErr->empty()) {
-    // TODO: Enable profile correlation when there are multiple objects in a
-    // dSYM bundle.
-    if (DsymObjectsOrErr->size() > 1)
-      return make_error<InstrProfError>(
-          instrprof_error::unable_to_correlate_profile,
-          "using multiple objects is not yet supported");
-    DebugInfoFilename = *DsymObjectsOrErr->begin();
+InstrProfCorrelator::get(StringRef Filename, ProfCorrelatorKind FileKind) {
+  if (FileKind == DEBUG_INFO) {
+    auto DsymObjectsOrErr =
+        object::MachOObjectFile::findDsymObjectMembers(Filename);
+    if (auto Err = DsymObjectsOrErr.takeError())
+      return std::move(Err);
+    if (!DsymObjectsOrErr->empty()) {
+      // TODO: Enable profile correlation when there are multiple objects in a
+      // dSYM bundle.
+      if (DsymObjectsOrErr->size() > 1)
+        return make_error<InstrProfError>(
+            instrprof_error::unable_to_correlate_profile,
+            "using multiple objects is not yet supported");
+      Filename = *DsymObjectsOrErr->begin();
+    }
   }
-  auto BufferOrErr =
-      errorOrToExpected(MemoryBuffer::getFile(DebugInfoFilename));
+  auto BufferOrErr = errorOrToExpected(MemoryBuffer::getFile(Filename));
   if (auto Err = BufferOrErr.takeError())
     return std::move(Err);
 
-  return get(std::move(*BufferOrErr));
+  return get(std::move(*BufferOrErr), FileKind);
 }
 
 llvm::Expected<std::unique_ptr<InstrProfCorrelator>>
-InstrProfCorrelator::get(std::unique_ptr<MemoryBuffer> Buffer) {
+InstrProfCorrelator::get(std::unique_ptr<MemoryBuffer> Buffer,
+                         ProfCorrelatorKind FileKind) {
   auto BinOrErr = object::createBinary(*Buffer);
   if (auto Err = BinOrErr.takeError())
     return std::move(Err);
 
   if (auto *Obj = dyn_cast<object::ObjectFile>(BinOrErr->get())) {
-    auto CtxOrErr = Context::get(std::move(Buffer), *Obj);
+    auto CtxOrErr = Context::get(std::move(Buffer), *Obj, FileKind);
     if (auto Err = CtxOrErr.takeError())
       return std::move(Err);
     auto T = Obj->makeTriple();
     if (T.isArch64Bit())
-      return InstrProfCorrelatorImpl<uint64_t>::get(std::move(*CtxOrErr), *Obj);
+      return InstrProfCorrelatorImpl<uint64_t>::get(std::move(*CtxOrErr), *Obj,
+                                                    FileKind);
     if (T.isArch32Bit())
-      return InstrProfCorrelatorImpl<uint32_t>::get(std::move(*CtxOrErr), *Obj);
+      return InstrProfCorrelatorImpl<uint32_t>::get(std::move(*CtxOrErr), *Obj,
+                                                    FileKind);
   }
   return make_error<InstrProfError>(
       instrprof_error::unable_to_correlate_profile, "not an object file");
@@ -129,7 +148,15 @@ template <class IntPtrT>
 llvm::Expected<std::unique_ptr<InstrProfCorrelatorImpl<IntPtrT>>>
 InstrProfCorrelatorImpl<IntPtrT>::get(
     std::unique_ptr<InstrProfCorrelator::Context> Ctx,
-    const object::ObjectFile &Obj) {
+    const object::ObjectFile &Obj, ProfCorrelatorKind FileKind) {
+  if (FileKind == BINARY) {
+    if (Obj.isELF())
+      return std::make_unique<BinaryInstrProfCorrelator<IntPtrT>>(
+          std::move(Ctx));
+    return make_error<InstrProfError>(
+        instrprof_error::unable_to_correlate_profile,
+        "unsupported binary format (only ELF is supported)");
+  }
   if (Obj.isELF() || Obj.isMachO()) {
     auto DICtx = DWARFContext::create(Obj);
     return std::make_unique<DwarfInstrProfCorrelator<IntPtrT>>(std::move(DICtx),
@@ -141,15 +168,18 @@ InstrProfCorrelatorImpl<IntPtrT>::get(
 }
 
 template <class IntPtrT>
-Error InstrProfCorrelatorImpl<IntPtrT>::correlateProfileData() {
+Error InstrProfCorrelatorImpl<IntPtrT>::correlateProfileData(
+    unsigned NumThreads) {
   assert(Data.empty() && Names.empty() && NamesVec.empty());
-  correlateProfileDataImpl();
-  if (Data.empty() || NamesVec.empty())
+  correlateProfileDataImpl(NumThreads);
+  if (Data.empty() || (NamesVec.empty() && Names.empty()))
     return make_error<InstrProfError>(
         instrprof_error::unable_to_correlate_profile,
-        "could not find any profile metadata in debug info");
-  auto Result =
-      collectPGOFuncNameStrings(NamesVec, /*doCompression=*/false, Names);
+        "could not find any profile metadata in the binary or debug info");
+  Error Result = Error::success();
+  if (!NamesVec.empty())
+    Result =
+        collectPGOFuncNameStrings(NamesVec, /*doCompression=*/false, Names);
   CounterOffsets.clear();
   NamesVec.clear();
   return Result;
@@ -161,11 +191,22 @@ void InstrProfCorrelatorImpl<IntPtrT>::addProbe(StringRef FunctionName,
                                                 IntPtrT CounterOffset,
                                                 IntPtrT FunctionPtr,
                                                 uint32_t NumCounters) {
+  if (addDataProbe(IndexedInstrProf::ComputeHash(FunctionName), CFGHash,
+                   CounterOffset, FunctionPtr, NumCounters))
+    NamesVec.push_back(FunctionName.str());
+}
+
+template <class IntPtrT>
+bool InstrProfCorrelatorImpl<IntPtrT>::addDataProbe(uint64_t NameRef,
+                                                    uint64_t CFGHash,
+                                                    IntPtrT CounterOffset,
+                                                    IntPtrT FunctionPtr,
+                                                    uint32_t NumCounters) {
   // Check if a probe was already added for this counter offset.
   if (!CounterOffsets.insert(CounterOffset).second)
-    return;
+    return false;
   Data.push_back({
-      maybeSwap<uint64_t>(IndexedInstrProf::ComputeHash(FunctionName)),
+      maybeSwap<uint64_t>(NameRef),
       maybeSwap<uint64_t>(CFGHash),
       // In this mode, CounterPtr actually stores the section relative address
       // of the counter.
@@ -176,7 +217,7 @@ void InstrProfCorrelatorImpl<IntPtrT>::addProbe(StringRef FunctionName,
       maybeSwap<uint32_t>(NumCounters),
       /*NumValueSites=*/{maybeSwap<uint16_t>(0), maybeSwap<uint16_t>(0)},
   });
-  NamesVec.push_back(FunctionName.str());
+  return true;
 }
 
 template <class IntPtrT>
@@ -216,80 +257,145 @@ bool DwarfInstrProfCorrelator<IntPtrT>::isDIEOfProbe(const DWARFDie &Die) {
     return false;
   if (!Die.hasChildren())
     return false;
-  if (const char *Name = Die.getName(DINameKind::ShortName))
+  // Only look at the name of the DIE itself, rather than following references
+  // that may lead into other units.
+  if (const char *Name = dwarf::toString(Die.find(dwarf::DW_AT_name), nullptr))
     return StringRef(Name).startswith(getInstrProfCountersVarPrefix());
   return false;
 }
 
 template <class IntPtrT>
-void DwarfInstrProfCorrelator<IntPtrT>::correlateProfileDataImpl() {
-  auto maybeAddProbe = [&](DWARFDie Die) {
-    if (!isDIEOfProbe(Die))
-      return;
-    Optional<const char *> FunctionName;
-    Optional<uint64_t> CFGHash;
-    Optional<uint64_t> CounterPtr = getLocation(Die);
-    auto FunctionPtr =
-        dwarf::toAddress(Die.getParent().find(dwarf::DW_AT_low_pc));
-    Optional<uint64_t> NumCounters;
-    for (const DWARFDie &Child : Die.children()) {
-      if (Child.getTag() != dwarf::DW_TAG_LLVM_annotation)
-        continue;
-      auto AnnotationFormName = Child.find(dwarf::DW_AT_name);
-      auto AnnotationFormValue = Child.find(dwarf::DW_AT_const_value);
-      if (!AnnotationFormName || !AnnotationFormValue)
-        continue;
-      auto AnnotationNameOrErr = AnnotationFormName->getAsCString();
-      if (auto Err = AnnotationNameOrErr.takeError()) {
-        consumeError(std::move(Err));
-        continue;
-      }
-      StringRef AnnotationName = *AnnotationNameOrErr;
-      if (AnnotationName.compare(
-              InstrProfCorrelator::FunctionNameAttributeName) == 0) {
-        if (auto EC =
-                AnnotationFormValue->getAsCString().moveInto(FunctionName))
-          consumeError(std::move(EC));
-      } else if (AnnotationName.compare(
-                     InstrProfCorrelator::CFGHashAttributeName) == 0) {
-        CFGHash = AnnotationFormValue->getAsUnsignedConstant();
-      } else if (AnnotationName.compare(
-                     InstrProfCorrelator::NumCountersAttributeName) == 0) {
-        NumCounters = AnnotationFormValue->getAsUnsignedConstant();
-      }
-    }
-    if (!FunctionName || !CFGHash || !CounterPtr || !NumCounters) {
-      LLVM_DEBUG(dbgs() << "Incomplete DIE for probe\n\tFunctionName: "
-                        << FunctionName << "\n\tCFGHash: " << CFGHash
-                        << "\n\tCounterPtr: " << CounterPtr
-                        << "\n\tNumCounters: " << NumCounters);
-      LLVM_DEBUG(Die.dump(dbgs()));
-      return;
+Optional<typename DwarfInstrProfCorrelator<IntPtrT>::Probe>
+DwarfInstrProfCorrelator<IntPtrT>::getProbe(const DWARFDie &Die) const {
+  if (!isDIEOfProbe(Die))
+    return None;
+  Optional<const char *> FunctionName;
+  Optional<uint64_t> CFGHash;
+  Optional<uint64_t> CounterPtr = getLocation(Die);
+  auto FunctionPtr =
+      dwarf::toAddress(Die.getParent().find(dwarf::DW_AT_low_pc));
+  Optional<uint64_t> NumCounters;
+  for (const DWARFDie &Child : Die.children()) {
+    if (Child.getTag() != dwarf::DW_TAG_LLVM_annotation)
+      continue;
+    auto AnnotationFormName = Child.find(dwarf::DW_AT_name);
+    auto AnnotationFormValue = Child.find(dwarf::DW_AT_const_value);
+    if (!AnnotationFormName || !AnnotationFormValue)
+      continue;
+    auto AnnotationNameOrErr = AnnotationFormName->getAsCString();
+    if (auto Err = AnnotationNameOrErr.takeError()) {
+      consumeError(std::move(Err));
+      continue;
     }
-    uint64_t CountersStart = this->Ctx->CountersSectionStart;
-    uint64_t CountersEnd = this->Ctx->CountersSectionEnd;
-    if (*CounterPtr < CountersStart || *CounterPtr >= CountersEnd) {
-      LLVM_DEBUG(
-          dbgs() << "CounterPtr out of range for probe\n\tFunction Name: "
-                 << FunctionName << "\n\tExpected: [0x"
-                 << Twine::utohexstr(CountersStart) << ", 0x"
-                 << Twine::utohexstr(CountersEnd) << ")\n\tActual: 0x"
-                 << Twine::utohexstr(*CounterPtr));
-      LLVM_DEBUG(Die.dump(dbgs()));
-      return;
+    StringRef AnnotationName = *AnnotationNameOrErr;
+    if (AnnotationName.compare(
+            InstrProfCorrelator::FunctionNameAttributeName) == 0) {
+      if (auto EC = AnnotationFormValue->getAsCString().moveInto(FunctionName))
+        consumeError(std::move(EC));
+    } else if (AnnotationName.compare(
+                   InstrProfCorrelator::CFGHashAttributeName) == 0) {
+      CFGHash = AnnotationFormValue->getAsUnsignedConstant();
+    } else if (AnnotationName.compare(
+                   InstrProfCorrelator::NumCountersAttributeName) == 0) {
+      NumCounters = AnnotationFormValue->getAsUnsignedConstant();
     }
-    if (!FunctionPtr) {
-      LLVM_DEBUG(dbgs() << "Could not find address of " << *FunctionName
-                        << "\n");
-      LLVM_DEBUG(Die.dump(dbgs()));
-    }
-    this->addProbe(*FunctionName, *CFGHash, *CounterPtr - CountersStart,
-                   FunctionPtr.getValueOr(0), *NumCounters);
-  };
+  }
+  if (!FunctionName || !CFGHash || !CounterPtr || !NumCounters) {
+    LLVM_DEBUG(dbgs() << "Incomplete DIE for probe\n\tFunctionName: "
+                      << FunctionName << "\n\tCFGHash: " << CFGHash
+                      << "\n\tCounterPtr: " << CounterPtr
+                      << "\n\tNumCounters: " << NumCounters);
+    LLVM_DEBUG(Die.dump(dbgs()));
+    return None;
+  }
+  uint64_t CountersStart = this->Ctx->CountersSectionStart;
+  uint64_t CountersEnd = this->Ctx->CountersSectionEnd;
+  if (*CounterPtr < CountersStart || *CounterPtr >= CountersEnd) {
+    LLVM_DEBUG(
+        dbgs() << "CounterPtr out of range for probe\n\tFunction Name: "
+               << FunctionName << "\n\tExpected: [0x"
+               << Twine::utohexstr(CountersStart) << ", 0x"
+               << Twine::utohexstr(CountersEnd) << ")\n\tActual: 0x"
+               << Twine::utohexstr(*CounterPtr));
+    LLVM_DEBUG(Die.dump(dbgs()));
+    return None;
+  }
+  if (!FunctionPtr) {
+    LLVM_DEBUG(dbgs() << "Could not find address of " << *FunctionName
+                      << "\n");
+    LLVM_DEBUG(Die.dump(dbgs()));
+  }
+  return Probe{*FunctionName, *CFGHash,
+               static_cast<IntPtrT>(*CounterPtr - CountersStart),
+               static_cast<IntPtrT>(FunctionPtr.getValueOr(0)),
+               static_cast<uint32_t>(*NumCounters)};
+}
+
+template <class IntPtrT>
+void DwarfInstrProfCorrelator<IntPtrT>::correlateProfileDataImpl(
+    unsigned NumThreads) {
+  std::vector<DWARFUnit *> Units;
   for (auto &CU : DICtx->normal_units())
-    for (const auto &Entry : CU->dies())
-      maybeAddProbe(DWARFDie(CU.get(), &Entry));
+    Units.push_back(CU.get());
   for (auto &CU : DICtx->dwo_units())
-    for (const auto &Entry : CU->dies())
-      maybeAddProbe(DWARFDie(CU.get(), &Entry));
+    Units.push_back(CU.get());
+
+  auto AddProbe = [&](const Probe &P) {
+    this->addProbe(P.FunctionName, P.CFGHash, P.CounterOffset, P.FunctionPtr,
+                   P.NumCounters);
+  };
+  ThreadPoolStrategy S = hardware_concurrency(NumThreads);
+  if (S.compute_thread_count() == 1 || Units.size() < 2) {
+    for (DWARFUnit *Unit : Units)
+      for (const auto &Entry : Unit->dies())
+        if (Optional<Probe> P = getProbe(DWARFDie(Unit, &Entry)))
+          AddProbe(*P);
+    return;
+  }
+
+  // Extract the DIEs of all units up front, as that is not thread safe. The
+  // units are then only read while they are searched.
+  for (DWARFUnit *Unit : Units)
+    Unit->getNumDIEs();
+  std::vector<std::vector<Probe>> UnitProbes(Units.size());
+  ThreadPool Pool(S);
+  for (size_t I = 0, E = Units.size(); I != E; ++I)
+    Pool.async([&, I] {
+      DWARFUnit *Unit = Units[I];
+      for (const auto &Entry : Unit->dies())
+        if (Optional<Probe> P = getProbe(DWARFDie(Unit, &Entry)))
+          UnitProbes[I].push_back(*P);
+    });
+  Pool.wait();
+  for (const std::vector<Probe> &Probes : UnitProbes)
+    for (const Probe &P : Probes)
+      AddProbe(P);
+}
+
+template <class IntPtrT>
+void BinaryInstrProfCorrelator<IntPtrT>::correlateProfileDataImpl(
+    unsigned NumThreads) {
+  using RawProfData = RawInstrProf::ProfileData<IntPtrT>;
+  StringRef DataSection = this->Ctx->DataSection;
+  const auto *DataStart =
+      reinterpret_cast<const RawProfData *>(DataSection.data());
+  const auto *DataEnd = DataStart + DataSection.size() / sizeof(RawProfData);
+  uint64_t CountersStart = this->Ctx->CountersSectionStart;
+  uint64_t CountersEnd = this->Ctx->CountersSectionEnd;
+  for (const RawProfData *I = DataStart; I != DataEnd; ++I) {
+    // The records of functions whose counters were garbage collected by the
+    // linker do not point into the counters section.
+    uint64_t CounterPtr = this->maybeSwap(I->CounterPtr);
+    if (CounterPtr < CountersStart || CounterPtr >= CountersEnd) {
+      LLVM_DEBUG(dbgs() << "CounterPtr out of range for data record "
+                        << I - DataStart << "\n\tActual: 0x"
+                        << Twine::utohexstr(CounterPtr) << "\n");
+      continue;
+    }
+    this->addDataProbe(this->maybeSwap(I->NameRef),
+                       this->maybeSwap(I->FuncHash), CounterPtr - CountersStart,
+                       this->maybeSwap(I->FunctionPointer),
+                       this->maybeSwap(I->NumCounters));
+  }
+  this->Names = this->Ctx->NamesSection.str();
 }
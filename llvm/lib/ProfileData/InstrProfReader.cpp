@@ -59,13 +59,17 @@ static InstrProfKind getProfileKindFromVersion(uint64_t Version) {
   if (Version & VARIANT_MASK_MEMPROF) {
     ProfileKind |= InstrProfKind::MemProf;
   }
+  if (Version & VARIANT_MASK_TEMPORAL_PROF) {
+    ProfileKind |= InstrProfKind::TemporalProfile;
+  }
   return ProfileKind;
 }
 
 static Expected<std::unique_ptr<MemoryBuffer>>
-setupMemoryBuffer(const Twine &Path) {
+setupMemoryBuffer(const Twine &Path, bool IsText = true,
+                  bool RequiresNullTerminator = true) {
   ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
-      MemoryBuffer::getFileOrSTDIN(Path, /*IsText=*/true);
+      MemoryBuffer::getFileOrSTDIN(Path, IsText, RequiresNullTerminator);
   if (std::error_code EC = BufferOrErr.getError())
     return errorCodeToError(EC);
   return std::move(BufferOrErr.get());
@@ -117,8 +121,11 @@ InstrProfReader::create(std::unique_ptr<MemoryBuffer> Buffer,
 
 Expected<std::unique_ptr<IndexedInstrProfReader>>
 IndexedInstrProfReader::create(const Twine &Path, const Twine &RemappingPath) {
-  // Set up the buffer to read.
-  auto BufferOrError = setupMemoryBuffer(Path);
+  // Set up the buffer to read. The indexed format is binary and does not need
+  // a null terminator, so the file is always mapped rather than read: only the
+  // pages of the header and of the records looked up are then loaded.
+  auto BufferOrError = setupMemoryBuffer(Path, /*IsText=*/false,
+                                         /*RequiresNullTerminator=*/false);
   if (Error E = BufferOrError.takeError())
     return std::move(E);
 
@@ -469,7 +476,7 @@ Error RawInstrProfReader<IntPtrT>::readFuncHash(NamedInstrProfRecord &Record) {
 
 template <class IntPtrT>
 Error RawInstrProfReader<IntPtrT>::readRawCounts(
-    InstrProfRecord &Record) {
+    NamedInstrProfRecord &Record) {
   uint32_t NumCounters = swap(Data->NumCounters);
   if (NumCounters == 0)
     return error(instrprof_error::malformed, "number of counters is zero");
@@ -497,9 +504,23 @@ Error RawInstrProfReader<IntPtrT>::readRawCounts(
                   Twine(MaxNumCounters))
                      .str());
 
+  // The first counter of a temporal profile is the time of the first call,
+  // which is not part of the counts of the record.
+  uint32_t FirstCounter = 0;
+  if (hasTemporalProfile()) {
+    if (NumCounters < 2)
+      return error(instrprof_error::malformed,
+                   "temporal profile record has no counters");
+    const auto *Timestamp = reinterpret_cast<const uint64_t *>(
+        CountersStart + CounterBaseOffset);
+    if (uint64_t Time = swap(*Timestamp))
+      TemporalProfTimestamps.emplace_back(Time, Record.Name.str());
+    FirstCounter = 1;
+  }
+
   Record.Counts.clear();
-  Record.Counts.reserve(NumCounters);
-  for (uint32_t I = 0; I < NumCounters; I++) {
+  Record.Counts.reserve(NumCounters - FirstCounter);
+  for (uint32_t I = FirstCounter; I < NumCounters; I++) {
     const char *Ptr =
         CountersStart + CounterBaseOffset + I * getCounterTypeSize();
     if (hasSingleByteCoverage()) {
@@ -514,6 +535,19 @@ Error RawInstrProfReader<IntPtrT>::readRawCounts(
   return success();
 }
 
+template <class IntPtrT>
+void RawInstrProfReader<IntPtrT>::finishTemporalProfTrace() {
+  if (TemporalProfTimestamps.empty())
+    return;
+  llvm::stable_sort(TemporalProfTimestamps, less_first());
+  TemporalProfTraceTy Trace;
+  Trace.reserve(TemporalProfTimestamps.size());
+  for (auto &Timestamp : TemporalProfTimestamps)
+    Trace.push_back(std::move(Timestamp.second));
+  TemporalProfTraces.push_back(std::move(Trace));
+  TemporalProfTimestamps.clear();
+}
+
 template <class IntPtrT>
 Error RawInstrProfReader<IntPtrT>::readValueProfilingData(
     InstrProfRecord &Record) {
@@ -545,10 +579,13 @@ Error RawInstrProfReader<IntPtrT>::readValueProfilingData(
 
 template <class IntPtrT>
 Error RawInstrProfReader<IntPtrT>::readNextRecord(NamedInstrProfRecord &Record) {
-  if (atEnd())
+  if (atEnd()) {
+    // Each raw profile is a trace of its own.
+    finishTemporalProfTrace();
     // At this point, ValueDataStart field points to the next header.
     if (Error E = readNextHeader(getNextHeaderPos()))
       return error(std::move(E));
+  }
 
   // Read name ad set it in Record.
   if (Error E = readName(Record))
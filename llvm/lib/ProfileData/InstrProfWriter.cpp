@@ -259,11 +259,12 @@ void InstrProfWriter::addRecord(const memprof::MemProfRecord &MR,
   // of a 128 bit md5 hash will be all zeros.
   // TODO: Move this Key frame detection to the contructor to avoid having to
   // scan all the callstacks again when adding a new record.
+  // The call stack starts at the allocation, so the records are keyed by the
+  // function making the allocation, where the profile use looks them up.
   uint64_t Key = 0;
-  for (auto Iter = MR.CallStack.rbegin(), End = MR.CallStack.rend();
-       Iter != End; Iter++) {
-    if (!Iter->IsInlineFrame) {
-      Key = Iter->Function;
+  for (const memprof::MemProfRecord::Frame &F : MR.CallStack) {
+    if (!F.IsInlineFrame) {
+      Key = F.Function;
       break;
     }
   }
@@ -22,6 +22,7 @@
 #include "llvm/ProfileData/SampleProfReader.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ProfileSummary.h"
@@ -473,13 +474,25 @@ ErrorOr<StringRef> SampleProfileReaderExtBinaryBase::readStringFromTable() {
   if (std::error_code EC = Idx.getError())
     return EC;
 
+  return readFixedLengthMD5Name(*Idx);
+}
+
+ErrorOr<uint64_t>
+SampleProfileReaderExtBinaryBase::readFixedLengthMD5(uint32_t Idx) {
+  const uint8_t *SavedData = Data;
+  Data = MD5NameMemStart + (Idx * sizeof(uint64_t));
+  auto FID = readUnencodedNumber<uint64_t>();
+  Data = SavedData;
+  return FID;
+}
+
+ErrorOr<StringRef>
+SampleProfileReaderExtBinaryBase::readFixedLengthMD5Name(uint32_t Idx) {
   // Check whether the name to be accessed has been accessed before,
   // if not, read it from memory directly.
-  StringRef &SR = NameTable[*Idx];
+  StringRef &SR = NameTable[Idx];
   if (SR.empty()) {
-    const uint8_t *SavedData = Data;
-    Data = MD5NameMemStart + ((*Idx) * sizeof(uint64_t));
-    auto FID = readUnencodedNumber<uint64_t>();
+    auto FID = readFixedLengthMD5(Idx);
     if (std::error_code EC = FID.getError())
       return EC;
     // Save the string converted from uint64_t in MD5StringBuf. All the
@@ -487,7 +500,6 @@ ErrorOr<StringRef> SampleProfileReaderExtBinaryBase::readStringFromTable() {
     // in MD5StringBuf.
     MD5StringBuf->push_back(std::to_string(*FID));
     SR = MD5StringBuf->back();
-    Data = SavedData;
   }
   return SR;
 }
@@ -625,7 +637,76 @@ SampleProfileReaderExtBinaryBase::readContextFromTable() {
     return EC;
   if (*ContextIdx >= CSNameTable->size())
     return sampleprof_error::truncated_name_table;
-  return (*CSNameTable)[*ContextIdx];
+  // Contexts are materialized the first time they are used. Every context
+  // has at least one frame, so an empty one has not been read yet.
+  SampleContextFrameVector &Context = (*CSNameTable)[*ContextIdx];
+  if (Context.empty()) {
+    const uint8_t *SavedData = Data;
+    const uint8_t *SavedEnd = End;
+    Data = CSNameTableEntries[*ContextIdx];
+    End = CSNameTableEnd;
+    std::error_code EC = readCSNameTableEntry(Context);
+    Data = SavedData;
+    End = SavedEnd;
+    if (EC)
+      return EC;
+  }
+  return Context;
+}
+
+std::error_code SampleProfileReaderExtBinaryBase::readRawContext(
+    uint32_t Idx, SmallVectorImpl<RawContextFrame> &Frames) {
+  Frames.clear();
+  if (Idx >= CSNameTableEntries.size())
+    return sampleprof_error::truncated_name_table;
+  const uint8_t *SavedData = Data;
+  const uint8_t *SavedEnd = End;
+  Data = CSNameTableEntries[Idx];
+  End = CSNameTableEnd;
+  auto Restore = make_scope_exit([&]() {
+    Data = SavedData;
+    End = SavedEnd;
+  });
+
+  auto ContextSize = readNumber<uint32_t>();
+  if (std::error_code EC = ContextSize.getError())
+    return EC;
+  for (uint32_t J = 0; J < *ContextSize; ++J) {
+    auto NameIdx = readStringIndex(NameTable);
+    if (std::error_code EC = NameIdx.getError())
+      return EC;
+    auto LineOffset = readNumber<uint64_t>();
+    if (std::error_code EC = LineOffset.getError())
+      return EC;
+    auto Discriminator = readNumber<uint64_t>();
+    if (std::error_code EC = Discriminator.getError())
+      return EC;
+    Frames.emplace_back(*NameIdx, *LineOffset, *Discriminator);
+  }
+  return sampleprof_error::success;
+}
+
+ErrorOr<Optional<SampleContext>>
+SampleProfileReaderExtBinaryBase::readSampleContextOfReadProfile() {
+  // A context or a fixed length MD5 name that was never materialized is not
+  // referred to by any profile that was read, so skip it instead of
+  // materializing it.
+  const uint8_t *SavedData = Data;
+  auto Idx = readNumber<uint32_t>();
+  if (std::error_code EC = Idx.getError())
+    return EC;
+  if (ProfileIsCSFlat) {
+    if (*Idx < CSNameTable->size() && (*CSNameTable)[*Idx].empty())
+      return Optional<SampleContext>();
+  } else if (FixedLengthMD5) {
+    if (*Idx < NameTable.size() && NameTable[*Idx].empty())
+      return Optional<SampleContext>();
+  }
+  Data = SavedData;
+  auto FContext(readSampleContextFromTable());
+  if (std::error_code EC = FContext.getError())
+    return EC;
+  return Optional<SampleContext>(*FContext);
 }
 
 ErrorOr<SampleContext>
@@ -712,8 +793,13 @@ bool SampleProfileReaderExtBinaryBase::collectFuncsFromModule() {
   if (!M)
     return false;
   FuncsToUse.clear();
+  FuncGuidsToUse.clear();
   for (auto &F : *M)
     FuncsToUse.insert(FunctionSamples::getCanonicalFnName(F));
+  if (useMD5()) {
+    for (auto Name : FuncsToUse)
+      FuncGuidsToUse.insert(MD5Hash(Name));
+  }
   return true;
 }
 
@@ -722,11 +808,55 @@ std::error_code SampleProfileReaderExtBinaryBase::readFuncOffsetTable() {
   // with previous FuncOffsetTable has to be done before next FuncOffsetTable
   // is read.
   FuncOffsetTable.clear();
+  OrderedCSFuncOffsets.clear();
 
   auto Size = readNumber<uint64_t>();
   if (std::error_code EC = Size.getError())
     return EC;
 
+  // When only the functions of a module are loaded, avoid materializing the
+  // names and contexts of the other functions: keep the raw context indices
+  // of a CS profile, and the entries of the functions to use of a fixed
+  // length MD5 profile.
+  bool LoadFuncsToBeUsed = collectFuncsFromModule();
+  if (LoadFuncsToBeUsed && ProfileIsCSFlat && FuncOffsetsOrdered) {
+    OrderedFuncOffsets.reset();
+    OrderedCSFuncOffsets.reserve(*Size);
+    for (uint64_t I = 0; I < *Size; ++I) {
+      auto ContextIdx = readNumber<uint32_t>();
+      if (std::error_code EC = ContextIdx.getError())
+        return EC;
+      if (*ContextIdx >= CSNameTableEntries.size())
+        return sampleprof_error::truncated_name_table;
+      auto Offset = readNumber<uint64_t>();
+      if (std::error_code EC = Offset.getError())
+        return EC;
+      OrderedCSFuncOffsets.emplace_back(*ContextIdx, *Offset);
+    }
+    return sampleprof_error::success;
+  }
+
+  if (LoadFuncsToBeUsed && !ProfileIsCSFlat && FixedLengthMD5) {
+    for (uint64_t I = 0; I < *Size; ++I) {
+      auto NameIdx = readStringIndex(NameTable);
+      if (std::error_code EC = NameIdx.getError())
+        return EC;
+      auto Offset = readNumber<uint64_t>();
+      if (std::error_code EC = Offset.getError())
+        return EC;
+      auto FID = readFixedLengthMD5(*NameIdx);
+      if (std::error_code EC = FID.getError())
+        return EC;
+      if (!FuncGuidsToUse.count(*FID))
+        continue;
+      auto FName = readFixedLengthMD5Name(*NameIdx);
+      if (std::error_code EC = FName.getError())
+        return EC;
+      FuncOffsetTable[SampleContext(*FName)] = *Offset;
+    }
+    return sampleprof_error::success;
+  }
+
   FuncOffsetTable.reserve(*Size);
 
   if (FuncOffsetsOrdered) {
@@ -777,13 +907,58 @@ std::error_code SampleProfileReaderExtBinaryBase::readFuncProfiles() {
       }
     }
 
-    if (ProfileIsCSFlat) {
-      DenseSet<uint64_t> FuncGuidsToUse;
-      if (useMD5()) {
-        for (auto Name : FuncsToUse)
-          FuncGuidsToUse.insert(Function::getGUID(Name));
-      }
+    if (ProfileIsCSFlat && !OrderedFuncOffsets) {
+      assert(FuncOffsetsOrdered &&
+             "func offset table should always be sorted in CS profile");
+      // Same as below, but on the raw frames of the contexts, so that only
+      // the contexts of the profiles that are loaded are materialized. A
+      // context is a prefix of another one if their leaf functions are the
+      // same, and all its other frames are the leading frames of the other.
+      auto IsFuncToUse = [&](uint32_t NameIdx) -> ErrorOr<bool> {
+        if (FixedLengthMD5) {
+          auto FID = readFixedLengthMD5(NameIdx);
+          if (std::error_code EC = FID.getError())
+            return EC;
+          return FuncGuidsToUse.count(*FID) != 0;
+        }
+        StringRef FName = NameTable[NameIdx];
+        if (useMD5())
+          return FuncGuidsToUse.count(std::stoull(FName.data())) != 0;
+        return FuncsToUse.count(FName) || (Remapper && Remapper->exist(FName));
+      };
+      auto IsPrefixOf = [](ArrayRef<RawContextFrame> Prefix,
+                           ArrayRef<RawContextFrame> Context) {
+        size_t Size = Prefix.size();
+        if (Size > Context.size() ||
+            std::get<0>(Prefix.back()) != std::get<0>(Context[Size - 1]))
+          return false;
+        return std::equal(Prefix.begin(), Prefix.end() - 1, Context.begin());
+      };
 
+      SmallVector<RawContextFrame, 16> CommonContext;
+      SmallVector<RawContextFrame, 16> FContext;
+      for (const auto &IdxOffset : OrderedCSFuncOffsets) {
+        if (std::error_code EC = readRawContext(IdxOffset.first, FContext))
+          return EC;
+        if (FContext.empty())
+          return sampleprof_error::malformed;
+        auto UseFunc = IsFuncToUse(std::get<0>(FContext.back()));
+        if (std::error_code EC = UseFunc.getError())
+          return EC;
+        bool InCommonContext =
+            !CommonContext.empty() && IsPrefixOf(CommonContext, FContext);
+        if (*UseFunc && !InCommonContext) {
+          CommonContext = FContext;
+          InCommonContext = true;
+        }
+        if (!InCommonContext)
+          continue;
+        const uint8_t *FuncProfileAddr = Start + IdxOffset.second;
+        assert(FuncProfileAddr < End && "out of LBRProfile section");
+        if (std::error_code EC = readFuncProfile(FuncProfileAddr))
+          return EC;
+      }
+    } else if (ProfileIsCSFlat) {
       // For each function in current module, load all context profiles for
       // the function as well as their callee contexts which can help profile
       // guided importing for ThinLTO. This can be achieved by walking
@@ -1051,36 +1226,64 @@ std::error_code SampleProfileReaderExtBinaryBase::readCSNameTableSec() {
   if (std::error_code EC = Size.getError())
     return EC;
 
-  std::vector<SampleContextFrameVector> *PNameVec =
-      new std::vector<SampleContextFrameVector>();
-  PNameVec->reserve(*Size);
+  // Only record where each context starts: they are read on demand by
+  // readContextFromTable, so that a profile loaded for a module only has to
+  // materialize the contexts of the functions it uses. The table is sized
+  // here, and must not be resized afterwards since SampleContexts refer to
+  // its elements.
+  CSNameTableEntries.clear();
+  CSNameTableEntries.reserve(*Size);
   for (uint32_t I = 0; I < *Size; ++I) {
-    PNameVec->emplace_back(SampleContextFrameVector());
+    CSNameTableEntries.push_back(Data);
     auto ContextSize = readNumber<uint32_t>();
     if (std::error_code EC = ContextSize.getError())
       return EC;
+    if (*ContextSize == 0)
+      return sampleprof_error::malformed;
     for (uint32_t J = 0; J < *ContextSize; ++J) {
-      auto FName(readStringFromTable());
-      if (std::error_code EC = FName.getError())
+      auto NameIdx = readStringIndex(NameTable);
+      if (std::error_code EC = NameIdx.getError())
         return EC;
       auto LineOffset = readNumber<uint64_t>();
       if (std::error_code EC = LineOffset.getError())
         return EC;
-
-      if (!isOffsetLegal(*LineOffset))
-        return std::error_code();
-
       auto Discriminator = readNumber<uint64_t>();
       if (std::error_code EC = Discriminator.getError())
         return EC;
-
-      PNameVec->back().emplace_back(
-          FName.get(), LineLocation(LineOffset.get(), Discriminator.get()));
     }
   }
+  CSNameTableEnd = Data;
+  CSNameTable = std::make_unique<std::vector<SampleContextFrameVector>>(
+      CSNameTableEntries.size());
+  return sampleprof_error::success;
+}
+
+std::error_code SampleProfileReaderExtBinaryBase::readCSNameTableEntry(
+    SampleContextFrameVector &Context) {
+  auto ContextSize = readNumber<uint32_t>();
+  if (std::error_code EC = ContextSize.getError())
+    return EC;
+  Context.reserve(*ContextSize);
+  for (uint32_t J = 0; J < *ContextSize; ++J) {
+    auto FName(readStringFromTable());
+    if (std::error_code EC = FName.getError())
+      return EC;
+    auto LineOffset = readNumber<uint64_t>();
+    if (std::error_code EC = LineOffset.getError())
+      return EC;
+
+    if (!isOffsetLegal(*LineOffset)) {
+      Context.clear();
+      return sampleprof_error::malformed;
+    }
+
+    auto Discriminator = readNumber<uint64_t>();
+    if (std::error_code EC = Discriminator.getError())
+      return EC;
 
-  // From this point the underlying object of CSNameTable should be immutable.
-  CSNameTable.reset(PNameVec);
+    Context.emplace_back(FName.get(),
+                         LineLocation(LineOffset.get(), Discriminator.get()));
+  }
   return sampleprof_error::success;
 }
 
@@ -1120,16 +1323,18 @@ SampleProfileReaderExtBinaryBase::readFuncMetadata(bool ProfileHasAttribute,
         if (std::error_code EC = Discriminator.getError())
           return EC;
 
-        auto FContext(readSampleContextFromTable());
-        if (std::error_code EC = FContext.getError())
-          return EC;
-
         FunctionSamples *CalleeProfile = nullptr;
         if (FProfile) {
+          auto FContext(readSampleContextFromTable());
+          if (std::error_code EC = FContext.getError())
+            return EC;
           CalleeProfile = const_cast<FunctionSamples *>(
               &FProfile->functionSamplesAt(LineLocation(
                   *LineOffset,
                   *Discriminator))[std::string(FContext.get().getName())]);
+        } else if (std::error_code EC = readNumber<uint32_t>().getError()) {
+          // The callee name is not needed for a profile that was not read.
+          return EC;
         }
         if (std::error_code EC =
                 readFuncMetadata(ProfileHasAttribute, CalleeProfile))
@@ -1144,13 +1349,15 @@ SampleProfileReaderExtBinaryBase::readFuncMetadata(bool ProfileHasAttribute,
 std::error_code
 SampleProfileReaderExtBinaryBase::readFuncMetadata(bool ProfileHasAttribute) {
   while (Data < End) {
-    auto FContext(readSampleContextFromTable());
+    auto FContext(readSampleContextOfReadProfile());
     if (std::error_code EC = FContext.getError())
       return EC;
     FunctionSamples *FProfile = nullptr;
-    auto It = Profiles.find(*FContext);
-    if (It != Profiles.end())
-      FProfile = &It->second;
+    if (FContext->hasValue()) {
+      auto It = Profiles.find(**FContext);
+      if (It != Profiles.end())
+        FProfile = &It->second;
+    }
 
     if (std::error_code EC = readFuncMetadata(ProfileHasAttribute, FProfile))
       return EC;
@@ -50,6 +50,14 @@ public:
     return Temp.keep(FinalPath);
   }
 
+  void writeback(size_t Offset, size_t Size) override {
+    assert(Offset + Size <= Buffer.size() && "range is outside the buffer");
+    // This is best effort, pages that aren't written back here are flushed
+    // by the OS after commit() anyway.
+    if (Temp.FD != -1)
+      (void)fs::start_writeback(Temp.FD, Offset, Size);
+  }
+
   ~OnDiskBuffer() override {
     // Close the mapping before deleting the temp file, so that the removal
     // succeeds.
@@ -122,13 +130,24 @@ createInMemoryBuffer(StringRef Path, size_t Size, unsigned Mode) {
 }
 
 static Expected<std::unique_ptr<FileOutputBuffer>>
-createOnDiskBuffer(StringRef Path, size_t Size, unsigned Mode) {
+createOnDiskBuffer(StringRef Path, size_t Size, unsigned Mode,
+                   bool Preallocate) {
   Expected<fs::TempFile> FileOrErr =
       fs::TempFile::create(Path + ".tmp%%%%%%%", Mode);
   if (!FileOrErr)
     return FileOrErr.takeError();
   fs::TempFile File = std::move(*FileOrErr);
 
+  // Preallocating is only an optimization, so only give up if the space isn't
+  // there.
+  if (Preallocate) {
+    std::error_code EC = fs::preallocate_file(File.FD, Size);
+    if (EC == errc::no_space_on_device) {
+      consumeError(File.discard());
+      return errorCodeToError(EC);
+    }
+  }
+
   if (auto EC = fs::resize_file_before_mapping_readwrite(File.FD, Size)) {
     consumeError(File.discard());
     return errorCodeToError(EC);
@@ -186,7 +205,7 @@ FileOutputBuffer::create(StringRef Path, size_t Size, unsigned Flags) {
     if (Flags & F_no_mmap)
       return createInMemoryBuffer(Path, Size, Mode);
     else
-      return createOnDiskBuffer(Path, Size, Mode);
+      return createOnDiskBuffer(Path, Size, Mode, Flags & F_preallocate);
   default:
     return createInMemoryBuffer(Path, Size, Mode);
   }
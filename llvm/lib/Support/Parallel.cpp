@@ -8,12 +8,13 @@
 
 #include "llvm/Support/Parallel.h"
 #include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Threading.h"
 
 #include <atomic>
+#include <deque>
 #include <future>
-#include <stack>
 #include <thread>
 #include <vector>
 
@@ -36,12 +37,25 @@ public:
   static Executor *getDefaultExecutor();
 };
 
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// The index of the ThreadPoolExecutor worker running on this thread, or -1u
+/// if this thread is not a worker.
+static LLVM_THREAD_LOCAL unsigned WorkerIndex = -1u;
+
+/// An implementation of an Executor that runs closures on a thread pool.
+///
+/// Each worker has its own queue. Closures added by a worker, e.g. by a task
+/// spawning more tasks, go to the back of its queue and are run in filo order
+/// by that worker. Closures added by other threads are distributed over the
+/// queues round-robin. A worker whose queue is empty steals the oldest
+/// closure of another worker's queue, so workers only contend on a queue when
+/// stealing instead of on every push and pop.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(ThreadPoolStrategy S = hardware_concurrency()) {
     unsigned ThreadCount = S.compute_thread_count();
+    Queues.reserve(ThreadCount);
+    for (unsigned I = 0; I < ThreadCount; ++I)
+      Queues.push_back(std::make_unique<WorkQueue>());
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     Threads.reserve(ThreadCount);
@@ -87,30 +101,76 @@ public:
   };
 
   void add(std::function<void()> F) override {
+    unsigned Index = WorkerIndex;
+    if (Index >= Queues.size())
+      Index = NextQueue.fetch_add(1, std::memory_order_relaxed) % Queues.size();
+    {
+      std::lock_guard<std::mutex> Lock(Queues[Index]->Mutex);
+      Queues[Index]->Tasks.push_back(std::move(F));
+    }
     {
       std::lock_guard<std::mutex> Lock(Mutex);
-      WorkStack.push(F);
+      ++NumQueued;
     }
     Cond.notify_one();
   }
 
 private:
+  struct WorkQueue {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Tasks;
+  };
+
+  /// Take a closure from the back of the queue of worker \p ThreadID or, if
+  /// that is empty, from the front of another worker's queue. The caller must
+  /// have claimed one of the queued closures by decrementing NumQueued.
+  std::function<void()> take(unsigned ThreadID) {
+    unsigned NumQueues = Queues.size();
+    while (true) {
+      {
+        WorkQueue &Own = *Queues[ThreadID];
+        std::lock_guard<std::mutex> Lock(Own.Mutex);
+        if (!Own.Tasks.empty()) {
+          std::function<void()> Task = std::move(Own.Tasks.back());
+          Own.Tasks.pop_back();
+          return Task;
+        }
+      }
+      for (unsigned I = 1; I < NumQueues; ++I) {
+        WorkQueue &Victim = *Queues[(ThreadID + I) % NumQueues];
+        std::lock_guard<std::mutex> Lock(Victim.Mutex);
+        if (!Victim.Tasks.empty()) {
+          std::function<void()> Task = std::move(Victim.Tasks.front());
+          Victim.Tasks.pop_front();
+          return Task;
+        }
+      }
+      // A closure was queued and not yet taken, but it moved past us while we
+      // were scanning. Try again.
+      std::this_thread::yield();
+    }
+  }
+
   void work(ThreadPoolStrategy S, unsigned ThreadID) {
     S.apply_thread_strategy(ThreadID);
+    WorkerIndex = ThreadID;
     while (true) {
-      std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
-      if (Stop)
-        break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
-      Lock.unlock();
-      Task();
+      {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        Cond.wait(Lock, [&] { return Stop || NumQueued != 0; });
+        if (Stop)
+          break;
+        --NumQueued;
+      }
+      take(ThreadID)();
     }
   }
 
   std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
+  /// The number of queued closures that no worker has claimed yet.
+  size_t NumQueued = 0;
+  std::vector<std::unique_ptr<WorkQueue>> Queues;
+  std::atomic<unsigned> NextQueue{0};
   std::mutex Mutex;
   std::condition_variable Cond;
   std::promise<void> ThreadsCreated;
@@ -51,6 +51,8 @@ struct Entry {
   TimePointType End;
   const std::string Name;
   const std::string Detail;
+  // One value per metric of the profiler, see timeTraceProfilerAddMetric.
+  SmallVector<int64_t, 0> MetricValues;
 
   Entry(TimePointType &&S, TimePointType &&E, std::string &&N, std::string &&Dt)
       : Start(std::move(S)), End(std::move(E)), Name(std::move(N)),
@@ -71,6 +73,22 @@ struct Entry {
         .count();
   }
 };
+
+struct CounterEntry {
+  const TimePointType Time;
+  const std::string Name;
+  const std::vector<std::pair<std::string, int64_t>> Values;
+
+  CounterEntry(TimePointType &&T, std::string &&N,
+               std::vector<std::pair<std::string, int64_t>> &&V)
+      : Time(std::move(T)), Name(std::move(N)), Values(std::move(V)) {}
+};
+
+struct Metric {
+  std::string Name;
+  std::function<int64_t()> Sample;
+  TimeTraceMetricKind Kind;
+};
 } // namespace
 
 struct llvm::TimeTraceProfiler {
@@ -84,12 +102,17 @@ struct llvm::TimeTraceProfiler {
   void begin(std::string Name, llvm::function_ref<std::string()> Detail) {
     Stack.emplace_back(steady_clock::now(), TimePointType(), std::move(Name),
                        Detail());
+    for (const Metric &M : Metrics)
+      Stack.back().MetricValues.push_back(M.Sample());
   }
 
   void end() {
     assert(!Stack.empty() && "Must call begin() first");
     Entry &E = Stack.back();
     E.End = steady_clock::now();
+    for (size_t I = 0, N = Metrics.size(); I != N; ++I)
+      if (Metrics[I].Kind == TimeTraceMetricKind::Delta)
+        E.MetricValues[I] = Metrics[I].Sample() - E.MetricValues[I];
 
     // Check that end times monotonically increase.
     assert((Entries.empty() ||
@@ -120,6 +143,15 @@ struct llvm::TimeTraceProfiler {
     Stack.pop_back();
   }
 
+  void counter(std::string Name,
+               ArrayRef<std::pair<StringRef, int64_t>> Values) {
+    std::vector<std::pair<std::string, int64_t>> V;
+    V.reserve(Values.size());
+    for (const auto &Value : Values)
+      V.emplace_back(Value.first.str(), Value.second);
+    Counters.emplace_back(steady_clock::now(), std::move(Name), std::move(V));
+  }
+
   // Write events from this TimeTraceProfilerInstance and
   // ThreadTimeTraceProfilerInstances.
   void write(raw_pwrite_stream &OS) {
@@ -137,27 +169,58 @@ struct llvm::TimeTraceProfiler {
     J.arrayBegin();
 
     // Emit all events for the main flame graph.
-    auto writeEvent = [&](const auto &E, uint64_t Tid) {
+    auto writeEvent = [&](const auto &E, const TimeTraceProfiler &TTP) {
       auto StartUs = E.getFlameGraphStartUs(StartTime);
       auto DurUs = E.getFlameGraphDurUs();
+      bool HasMetrics = llvm::any_of(E.MetricValues,
+                                     [](int64_t V) { return V != 0; });
 
       J.object([&] {
         J.attribute("pid", Pid);
-        J.attribute("tid", int64_t(Tid));
+        J.attribute("tid", int64_t(TTP.Tid));
         J.attribute("ph", "X");
         J.attribute("ts", StartUs);
         J.attribute("dur", DurUs);
         J.attribute("name", E.Name);
-        if (!E.Detail.empty()) {
-          J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
+        if (!E.Detail.empty() || HasMetrics) {
+          J.attributeObject("args", [&] {
+            if (!E.Detail.empty())
+              J.attribute("detail", E.Detail);
+            for (size_t I = 0, N = E.MetricValues.size(); I != N; ++I)
+              if (E.MetricValues[I] != 0)
+                J.attribute(TTP.Metrics[I].Name, E.MetricValues[I]);
+          });
         }
       });
     };
     for (const Entry &E : Entries)
-      writeEvent(E, this->Tid);
+      writeEvent(E, *this);
     for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
       for (const Entry &E : TTP->Entries)
-        writeEvent(E, TTP->Tid);
+        writeEvent(E, *TTP);
+
+    // Emit counter events. Counters are per process, so the thread they were
+    // recorded on does not matter.
+    auto writeCounter = [&](const CounterEntry &C, uint64_t Tid) {
+      J.object([&] {
+        J.attribute("pid", Pid);
+        J.attribute("tid", int64_t(Tid));
+        J.attribute("ph", "C");
+        J.attribute("ts", (time_point_cast<microseconds>(C.Time) -
+                           time_point_cast<microseconds>(StartTime))
+                              .count());
+        J.attribute("name", C.Name);
+        J.attributeObject("args", [&] {
+          for (const auto &Value : C.Values)
+            J.attribute(Value.first, Value.second);
+        });
+      });
+    };
+    for (const CounterEntry &C : Counters)
+      writeCounter(C, this->Tid);
+    for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
+      for (const CounterEntry &C : TTP->Counters)
+        writeCounter(C, TTP->Tid);
 
     // Emit totals by section name as additional "thread" events, sorted from
     // longest one.
@@ -247,6 +310,8 @@ struct llvm::TimeTraceProfiler {
 
   SmallVector<Entry, 16> Stack;
   SmallVector<Entry, 128> Entries;
+  std::vector<CounterEntry> Counters;
+  std::vector<Metric> Metrics;
   StringMap<CountAndDurationType> CountAndTotalPerName;
   const time_point<system_clock> BeginningOfTime;
   const TimePointType StartTime;
@@ -328,3 +393,20 @@ void llvm::timeTraceProfilerEnd() {
   if (TimeTraceProfilerInstance != nullptr)
     TimeTraceProfilerInstance->end();
 }
+
+void llvm::timeTraceProfilerAddMetric(StringRef Name,
+                                      std::function<int64_t()> Sample,
+                                      TimeTraceMetricKind Kind) {
+  if (TimeTraceProfilerInstance != nullptr) {
+    assert(TimeTraceProfilerInstance->Stack.empty() &&
+           "Metrics must be added outside of any time section");
+    TimeTraceProfilerInstance->Metrics.push_back(
+        {Name.str(), std::move(Sample), Kind});
+  }
+}
+
+void llvm::timeTraceProfilerCounter(
+    StringRef Name, ArrayRef<std::pair<StringRef, int64_t>> Values) {
+  if (TimeTraceProfilerInstance != nullptr)
+    TimeTraceProfilerInstance->counter(std::string(Name), Values);
+}
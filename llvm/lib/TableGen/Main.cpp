@@ -30,6 +30,11 @@ static cl::opt<std::string>
 OutputFilename("o", cl::desc("Output filename"), cl::value_desc("filename"),
                cl::init("-"));
 
+static cl::list<std::string>
+ExtraOutputFilenames("extra-o",
+                     cl::desc("Output filename of each additional action"),
+                     cl::value_desc("filename"));
+
 static cl::opt<std::string>
 DependFilename("d",
                cl::desc("Dependency filename"),
@@ -76,7 +81,10 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   if (EC)
     return reportError(argv0, "error opening " + DependFilename + ":" +
                                   EC.message() + "\n");
-  DepOut.os() << OutputFilename << ":";
+  DepOut.os() << OutputFilename;
+  for (const auto &Extra : ExtraOutputFilenames)
+    DepOut.os() << ' ' << Extra;
+  DepOut.os() << ":";
   for (const auto &Dep : Parser.getDependencies()) {
     DepOut.os() << ' ' << Dep;
   }
@@ -85,7 +93,40 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
+/// Write \p Contents to \p Filename, or leave an existing file alone if it
+/// already has these contents and -write-if-changed is given.
+static int writeOutput(const char *argv0, StringRef Filename,
+                       StringRef Contents) {
+  if (WriteIfChanged) {
+    // Only updates the real output file if there are any differences.
+    // This prevents recompilation of all the files depending on it if there
+    // aren't any.
+    if (auto ExistingOrErr = MemoryBuffer::getFile(Filename, /*IsText=*/true))
+      if (std::move(ExistingOrErr.get())->getBuffer() == Contents)
+        return 0;
+  }
+  std::error_code EC;
+  ToolOutputFile OutFile(Filename, EC, sys::fs::OF_Text);
+  if (EC)
+    return reportError(argv0, "error opening " + Filename + ": " +
+                                  EC.message() + "\n");
+  OutFile.os() << Contents;
+  if (ErrorsPrinted == 0)
+    OutFile.keep();
+  return 0;
+}
+
 int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn) {
+  return TableGenMain(argv0, std::function<TableGenMainFn>(MainFn));
+}
+
+int llvm::TableGenMain(const char *argv0,
+                       ArrayRef<std::function<TableGenMainFn>> MainFns) {
+  if (MainFns.size() != ExtraOutputFilenames.size() + 1)
+    return reportError(argv0, "expected " + Twine(MainFns.size() - 1) +
+                                  " -extra-o options, got " +
+                                  Twine(ExtraOutputFilenames.size()) + "\n");
+
   RecordKeeper Records;
 
   if (TimePhases)
@@ -115,14 +156,18 @@ int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn) {
     return 1;
   Records.stopTimer();
 
-  // Write output to memory.
+  // Write output to memory. All actions run on the same records, one after
+  // the other, as the backends are not safe to run concurrently.
   Records.startBackendTimer("Backend overall");
-  std::string OutString;
-  raw_string_ostream Out(OutString);
-  unsigned status = MainFn(Out, Records);
+  std::vector<std::string> OutStrings(MainFns.size());
+  for (unsigned I = 0, E = MainFns.size(); I != E; ++I) {
+    raw_string_ostream Out(OutStrings[I]);
+    if (MainFns[I](Out, Records)) {
+      Records.stopBackendTimer();
+      return 1;
+    }
+  }
   Records.stopBackendTimer();
-  if (status)
-    return 1;
 
   // Always write the depfile, even if the main output hasn't changed.
   // If it's missing, Ninja considers the output dirty.  If this was below
@@ -134,26 +179,12 @@ int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn) {
   }
 
   Records.startTimer("Write output");
-  bool WriteFile = true;
-  if (WriteIfChanged) {
-    // Only updates the real output file if there are any differences.
-    // This prevents recompilation of all the files depending on it if there
-    // aren't any.
-    if (auto ExistingOrErr =
-            MemoryBuffer::getFile(OutputFilename, /*IsText=*/true))
-      if (std::move(ExistingOrErr.get())->getBuffer() == Out.str())
-        WriteFile = false;
-  }
-  if (WriteFile) {
-    std::error_code EC;
-    ToolOutputFile OutFile(OutputFilename, EC, sys::fs::OF_Text);
-    if (EC)
-      return reportError(argv0, "error opening " + OutputFilename + ": " +
-                                    EC.message() + "\n");
-    OutFile.os() << Out.str();
-    if (ErrorsPrinted == 0)
-      OutFile.keep();
-  }
+  if (int Ret = writeOutput(argv0, OutputFilename, OutStrings[0]))
+    return Ret;
+  for (unsigned I = 1, E = MainFns.size(); I != E; ++I)
+    if (int Ret = writeOutput(argv0, ExtraOutputFilenames[I - 1],
+                              OutStrings[I]))
+      return Ret;
   
   Records.stopTimer();
   Records.stopPhaseTiming();
@@ -43,6 +43,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
@@ -67,8 +68,14 @@ STATISTIC(NumImportedHotFunctionsThinLink,
           "Number of hot functions thin link decided to import");
 STATISTIC(NumImportedCriticalFunctionsThinLink,
           "Number of critical functions thin link decided to import");
+STATISTIC(NumImportedICPTargetsThinLink,
+          "Number of indirect call promotion targets thin link decided to "
+          "import regardless of their size");
 STATISTIC(NumImportedGlobalVarsThinLink,
           "Number of global variables thin link decided to import");
+STATISTIC(NumImportsOverBudget,
+          "Number of function imports dropped to stay within "
+          "-import-total-instr-limit");
 STATISTIC(NumImportedFunctions, "Number of functions imported in backend");
 STATISTIC(NumImportedGlobalVars,
           "Number of global variables imported in backend");
@@ -81,6 +88,12 @@ static cl::opt<unsigned> ImportInstrLimit(
     "import-instr-limit", cl::init(100), cl::Hidden, cl::value_desc("N"),
     cl::desc("Only import functions with less than N instructions"));
 
+static cl::opt<unsigned> ImportTotalInstrLimit(
+    "import-total-instr-limit", cl::init(0), cl::Hidden, cl::value_desc("N"),
+    cl::desc("Limit the total number of instructions imported into all the "
+             "modules of the link to N, keeping the imports with the highest "
+             "estimated benefit per instruction (default 0, unlimited)"));
+
 static cl::opt<int> ImportCutoff(
     "import-cutoff", cl::init(-1), cl::Hidden, cl::value_desc("N"),
     cl::desc("Only import first N functions if N>=0 (default -1)"));
@@ -89,6 +102,13 @@ static cl::opt<bool>
     ForceImportAll("force-import-all", cl::init(false), cl::Hidden,
                    cl::desc("Import functions with noinline attribute"));
 
+static cl::opt<bool> ForceImportICPTargets(
+    "force-import-icp-targets", cl::init(false), cl::Hidden,
+    cl::desc("Import the profitable indirect call promotion targets of a "
+             "call site regardless of their size and noinline attribute, so "
+             "that the functions can be promoted in the backends. The "
+             "imports are still subject to -import-total-instr-limit"));
+
 static cl::opt<float>
     ImportInstrFactor("import-instr-evolution-factor", cl::init(0.7),
                       cl::Hidden, cl::value_desc("x"),
@@ -163,7 +183,9 @@ static std::unique_ptr<Module> loadFile(const std::string &FileName,
 }
 
 /// Given a list of possible callee implementation for a call site, select one
-/// that fits the \p Threshold.
+/// that fits the \p Threshold. If \p IgnoreSizeAndNoInline is set, e.g. for a
+/// forced indirect call promotion target, neither the threshold nor the
+/// noinline attribute are checked.
 ///
 /// FIXME: select "best" instead of first that fits. But what is "best"?
 /// - The smallest: more likely to be inlined.
@@ -177,7 +199,7 @@ selectCallee(const ModuleSummaryIndex &Index,
              ArrayRef<std::unique_ptr<GlobalValueSummary>> CalleeSummaryList,
              unsigned Threshold, StringRef CallerModulePath,
              FunctionImporter::ImportFailureReason &Reason,
-             GlobalValue::GUID GUID) {
+             GlobalValue::GUID GUID, bool IgnoreSizeAndNoInline = false) {
   Reason = FunctionImporter::ImportFailureReason::None;
   auto It = llvm::find_if(
       CalleeSummaryList,
@@ -215,7 +237,8 @@ selectCallee(const ModuleSummaryIndex &Index,
         }
 
         if ((Summary->instCount() > Threshold) &&
-            !Summary->fflags().AlwaysInline && !ForceImportAll) {
+            !Summary->fflags().AlwaysInline && !ForceImportAll &&
+            !IgnoreSizeAndNoInline) {
           Reason = FunctionImporter::ImportFailureReason::TooLarge;
           return false;
         }
@@ -228,7 +251,8 @@ selectCallee(const ModuleSummaryIndex &Index,
         }
 
         // Don't bother importing if we can't inline it anyway.
-        if (Summary->fflags().NoInline && !ForceImportAll) {
+        if (Summary->fflags().NoInline && !ForceImportAll &&
+            !IgnoreSizeAndNoInline) {
           Reason = FunctionImporter::ImportFailureReason::NoInline;
           return false;
         }
@@ -345,6 +369,18 @@ getFailureName(FunctionImporter::ImportFailureReason Reason) {
   llvm_unreachable("invalid reason");
 }
 
+/// Returns the factor applied to the import threshold of a callee for a call
+/// site of the given hotness.
+static float getHotnessMultiplier(CalleeInfo::HotnessType Hotness) {
+  if (Hotness == CalleeInfo::HotnessType::Hot)
+    return ImportHotMultiplier;
+  if (Hotness == CalleeInfo::HotnessType::Cold)
+    return ImportColdMultiplier;
+  if (Hotness == CalleeInfo::HotnessType::Critical)
+    return ImportCriticalMultiplier;
+  return 1.0;
+}
+
 /// Compute the list of functions to import for a given caller. Mark these
 /// imported functions and the symbols they reference in their source module as
 /// exported from their source module.
@@ -377,18 +413,8 @@ static void computeImportForFunction(
       continue;
     }
 
-    auto GetBonusMultiplier = [](CalleeInfo::HotnessType Hotness) -> float {
-      if (Hotness == CalleeInfo::HotnessType::Hot)
-        return ImportHotMultiplier;
-      if (Hotness == CalleeInfo::HotnessType::Cold)
-        return ImportColdMultiplier;
-      if (Hotness == CalleeInfo::HotnessType::Critical)
-        return ImportCriticalMultiplier;
-      return 1.0;
-    };
-
     const auto NewThreshold =
-        Threshold * GetBonusMultiplier(Edge.second.getHotness());
+        Threshold * getHotnessMultiplier(Edge.second.getHotness());
 
     auto IT = ImportThresholds.insert(std::make_pair(
         VI.getGUID(), std::make_tuple(NewThreshold, nullptr, nullptr)));
@@ -401,6 +427,11 @@ static void computeImportForFunction(
         Edge.second.getHotness() == CalleeInfo::HotnessType::Hot;
     bool IsCriticalCallsite =
         Edge.second.getHotness() == CalleeInfo::HotnessType::Critical;
+    // Import the targets that the backend would promote an indirect call to
+    // regardless of the threshold, since the call can only be promoted if
+    // the target is available in the module.
+    bool IsForcedICPTarget =
+        ForceImportICPTargets && Edge.second.isICPTarget();
 
     const FunctionSummary *ResolvedCalleeSummary = nullptr;
     if (CalleeSummary) {
@@ -421,7 +452,8 @@ static void computeImportForFunction(
     } else {
       // If we already rejected importing a callee at the same or higher
       // threshold, don't waste time calling selectCallee.
-      if (PreviouslyVisited && NewThreshold <= ProcessedThreshold) {
+      if (PreviouslyVisited && NewThreshold <= ProcessedThreshold &&
+          !IsForcedICPTarget) {
         LLVM_DEBUG(
             dbgs() << "ignored! Target was already rejected with Threshold "
             << ProcessedThreshold << "\n");
@@ -434,8 +466,10 @@ static void computeImportForFunction(
       }
 
       FunctionImporter::ImportFailureReason Reason;
-      CalleeSummary = selectCallee(Index, VI.getSummaryList(), NewThreshold,
-                                   Summary.modulePath(), Reason, VI.getGUID());
+      CalleeSummary =
+          selectCallee(Index, VI.getSummaryList(), NewThreshold,
+                       Summary.modulePath(), Reason, VI.getGUID(),
+                       IsForcedICPTarget);
       if (!CalleeSummary) {
         // Update with new larger threshold if this was a retry (otherwise
         // we would have already inserted with NewThreshold above). Also
@@ -477,6 +511,7 @@ static void computeImportForFunction(
       ResolvedCalleeSummary = cast<FunctionSummary>(CalleeSummary);
 
       assert((ResolvedCalleeSummary->fflags().AlwaysInline || ForceImportAll ||
+              IsForcedICPTarget ||
               (ResolvedCalleeSummary->instCount() <= NewThreshold)) &&
              "selectCallee() didn't honor the threshold");
 
@@ -491,6 +526,9 @@ static void computeImportForFunction(
           NumImportedHotFunctionsThinLink++;
         if (IsCriticalCallsite)
           NumImportedCriticalFunctionsThinLink++;
+        if (IsForcedICPTarget &&
+            ResolvedCalleeSummary->instCount() > NewThreshold)
+          NumImportedICPTargetsThinLink++;
       }
 
       // Any calls/references made by this function will be marked exported
@@ -652,6 +690,103 @@ checkVariableImport(const ModuleSummaryIndex &Index,
 }
 #endif
 
+/// Drop the function imports with the lowest estimated benefit per imported
+/// instruction, across all the modules, until the total size of the imported
+/// functions is within -import-total-instr-limit. The benefit of importing a
+/// function into a module is the sum, over the calls to it from the functions
+/// defined in or imported into the module, of the hotness multiplier of the
+/// call, scaled by its relative block frequency when the summary has it.
+///
+/// Only function imports are dropped, and always_inline functions are neither
+/// counted nor dropped. Variable imports are cheap, and the read-only and
+/// write-only variables that get internalized in their module must stay
+/// imported wherever they are exported. The export lists are left as
+/// computed, which is conservative.
+static void
+applyImportBudget(const ModuleSummaryIndex &Index,
+                  const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
+                  StringMap<FunctionImporter::ImportMapTy> &ImportLists) {
+  struct Candidate {
+    FunctionImporter::FunctionsToImportTy *Functions;
+    StringRef ModulePath;
+    GlobalValue::GUID GUID;
+    unsigned InstCount;
+    float Score;
+  };
+  std::vector<Candidate> Candidates;
+  uint64_t TotalInstCount = 0;
+
+  for (auto &ModuleImports : ImportLists) {
+    // Add up the weights of the calls to each callee from the functions
+    // that will be in the module after importing.
+    DenseMap<GlobalValue::GUID, float> Benefit;
+    auto AddCalls = [&](const GlobalValueSummary *S) {
+      if (const auto *FS = dyn_cast<FunctionSummary>(S->getBaseObject()))
+        for (const FunctionSummary::EdgeTy &Edge : FS->calls()) {
+          float Weight = getHotnessMultiplier(Edge.second.getHotness());
+          if (Edge.second.RelBlockFreq)
+            Weight *= float(Edge.second.RelBlockFreq) /
+                      (1 << CalleeInfo::ScaleShift);
+          Benefit[Edge.first.getGUID()] += Weight;
+        }
+    };
+    for (auto &GVS : ModuleToDefinedGVSummaries.lookup(ModuleImports.first()))
+      AddCalls(GVS.second);
+    for (auto &FromModule : ModuleImports.second)
+      for (GlobalValue::GUID GUID : FromModule.second)
+        if (const GlobalValueSummary *S =
+                Index.findSummaryInModule(GUID, FromModule.first()))
+          AddCalls(S);
+
+    for (auto &FromModule : ModuleImports.second)
+      for (GlobalValue::GUID GUID : FromModule.second) {
+        const GlobalValueSummary *S =
+            Index.findSummaryInModule(GUID, FromModule.first());
+        const auto *FS =
+            S ? dyn_cast<FunctionSummary>(S->getBaseObject()) : nullptr;
+        if (!FS || FS->fflags().AlwaysInline)
+          continue;
+        TotalInstCount += FS->instCount();
+        Candidates.push_back({&FromModule.second, ModuleImports.first(), GUID,
+                              FS->instCount(),
+                              Benefit.lookup(GUID) /
+                                  std::max(FS->instCount(), 1u)});
+      }
+  }
+  if (TotalInstCount <= ImportTotalInstrLimit)
+    return;
+
+  // The tie breaks make the result independent of the iteration order of the
+  // import lists.
+  llvm::sort(Candidates, [](const Candidate &L, const Candidate &R) {
+    return std::make_tuple(-L.Score, L.InstCount, L.ModulePath, L.GUID) <
+           std::make_tuple(-R.Score, R.InstCount, R.ModulePath, R.GUID);
+  });
+  uint64_t Remaining = ImportTotalInstrLimit;
+  for (const Candidate &C : Candidates) {
+    if (C.InstCount <= Remaining) {
+      Remaining -= C.InstCount;
+      continue;
+    }
+    LLVM_DEBUG(dbgs() << "Dropping import of " << C.GUID << " into "
+                      << C.ModulePath << ": over -import-total-instr-limit\n");
+    C.Functions->erase(C.GUID);
+    ++NumImportsOverBudget;
+  }
+
+  // Don't leave empty entries, which would make the modules still appear as
+  // imported from.
+  for (auto &ModuleImports : ImportLists) {
+    FunctionImporter::ImportMapTy &ImportList = ModuleImports.second;
+    for (auto I = ImportList.begin(), E = ImportList.end(); I != E;) {
+      auto Next = std::next(I);
+      if (I->second.empty())
+        ImportList.erase(I);
+      I = Next;
+    }
+  }
+}
+
 /// Compute all the import and export for every module using the Index.
 void llvm::ComputeCrossModuleImport(
     const ModuleSummaryIndex &Index,
@@ -659,14 +794,37 @@ void llvm::ComputeCrossModuleImport(
     StringMap<FunctionImporter::ImportMapTy> &ImportLists,
     StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
   // For each module that has function defined, compute the import/export lists.
+  // The modules only read the index, so they are processed in parallel. Each
+  // of them records its exports in its own map, and the maps are merged in
+  // module order, so that the result does not depend on the scheduling.
+  std::vector<const StringMapEntry<GVSummaryMapTy> *> Modules;
+  std::vector<FunctionImporter::ImportMapTy *> ModuleImportLists;
   for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
-    auto &ImportList = ImportLists[DefinedGVSummaries.first()];
+    Modules.push_back(&DefinedGVSummaries);
+    ModuleImportLists.push_back(&ImportLists[DefinedGVSummaries.first()]);
+  }
+  std::vector<StringMap<FunctionImporter::ExportSetTy>> ModuleExportLists(
+      Modules.size());
+  auto ComputeImports = [&](size_t I) {
     LLVM_DEBUG(dbgs() << "Computing import for Module '"
-                      << DefinedGVSummaries.first() << "'\n");
-    ComputeImportForModule(DefinedGVSummaries.second, Index,
-                           DefinedGVSummaries.first(), ImportList,
-                           &ExportLists);
+                      << Modules[I]->first() << "'\n");
+    ComputeImportForModule(Modules[I]->second, Index, Modules[I]->first(),
+                           *ModuleImportLists[I], &ModuleExportLists[I]);
+  };
+  // Keep the output of -print-import-failures and -debug readable.
+  if (PrintImportFailures || DebugFlag) {
+    for (size_t I = 0, E = Modules.size(); I != E; ++I)
+      ComputeImports(I);
+  } else {
+    parallelForEachN(0, Modules.size(), ComputeImports);
   }
+  for (StringMap<FunctionImporter::ExportSetTy> &ModuleExports :
+       ModuleExportLists)
+    for (auto &ELI : ModuleExports)
+      ExportLists[ELI.first()].insert(ELI.second.begin(), ELI.second.end());
+
+  if (ImportTotalInstrLimit)
+    applyImportBudget(Index, ModuleToDefinedGVSummaries, ImportLists);
 
   // When computing imports we only added the variables and functions being
   // imported to the export list. We also need to mark any references and calls
@@ -60,6 +60,13 @@ using namespace llvm;
 
 STATISTIC(NumOfPGOICallPromotion, "Number of indirect call promotions.");
 STATISTIC(NumOfPGOICallsites, "Number of indirect call candidate sites.");
+STATISTIC(NumOfPGOICallProfiledCount,
+          "Total profiled count of the indirect call candidate sites.");
+STATISTIC(NumOfPGOICallPromotedCount,
+          "Profiled count of the promoted indirect call targets.");
+STATISTIC(NumOfPGOICallTargetNotFoundCount,
+          "Profiled count of the indirect call targets that could not be "
+          "promoted because they are not available in the module.");
 
 // Command line option to disable indirect-call promotion with the default as
 // false. This is for debug purpose.
@@ -274,10 +281,12 @@ ICallPromotionFunc::getPromotionCandidatesForCallSite(
     Function *TargetFunction = Symtab->getFunction(Target);
     if (TargetFunction == nullptr || TargetFunction->isDeclaration()) {
       LLVM_DEBUG(dbgs() << " Not promote: Cannot find the target\n");
+      NumOfPGOICallTargetNotFoundCount += Count;
       ORE.emit([&]() {
         return OptimizationRemarkMissed(DEBUG_TYPE, "UnableToFindTarget", &CB)
                << "Cannot promote indirect call: target with md5sum "
-               << ore::NV("target md5sum", Target) << " not found";
+               << ore::NV("target md5sum", Target) << " with count of "
+               << ore::NV("Count", Count) << " not found";
       });
       break;
     }
@@ -348,6 +357,7 @@ uint32_t ICallPromotionFunc::tryToPromote(
     assert(TotalCount >= Count);
     TotalCount -= Count;
     NumOfPGOICallPromotion++;
+    NumOfPGOICallPromotedCount += Count;
     NumPromoted++;
   }
   return NumPromoted;
@@ -366,6 +376,7 @@ bool ICallPromotionFunc::processFunction(ProfileSummaryInfo *PSI) {
     if (!NumCandidates ||
         (PSI && PSI->hasProfileSummary() && !PSI->isHotCount(TotalCount)))
       continue;
+    NumOfPGOICallProfiledCount += TotalCount;
     auto PromotionCandidates = getPromotionCandidatesForCallSite(
         *CB, ICallProfDataRef, TotalCount, NumCandidates);
     uint32_t NumPromoted = tryToPromote(*CB, PromotionCandidates, TotalCount);
@@ -65,6 +65,11 @@ cl::opt<bool>
     DebugInfoCorrelate("debug-info-correlate", cl::ZeroOrMore,
                        cl::desc("Use debug info to correlate profiles."),
                        cl::init(false));
+cl::opt<bool> BinaryCorrelate(
+    "binary-correlate", cl::ZeroOrMore,
+    cl::desc("Place the profile data and names in sections that are not "
+             "loaded, and use the binary to correlate profiles (ELF only)."),
+    cl::init(false));
 } // namespace llvm
 
 namespace {
@@ -79,6 +84,13 @@ cl::opt<bool>
                              cl::desc("Enable relocating counters at runtime."),
                              cl::init(false));
 
+cl::opt<bool> ShardCounters(
+    "instrprof-shard-counters",
+    cl::desc("Give groups of threads their own copies of the counters, to "
+             "avoid contention on them. The copies are folded into the "
+             "counters when the profile is written."),
+    cl::init(false));
+
 cl::opt<bool> ValueProfileStaticAlloc(
     "vp-static-alloc",
     cl::desc("Do static counter allocation for value profiler"),
@@ -211,6 +223,18 @@ public:
       Value *Addr = cast<StoreInst>(Store)->getPointerOperand();
       Type *Ty = LiveInValue->getType();
       IRBuilder<> Builder(InsertPos);
+      if (auto *AddrInst = dyn_cast<IntToPtrInst>(Addr)) {
+        // With runtime counter relocation or sharded counters, the address of
+        // the counter is computed by adding a bias to it, see
+        // InstrProfiling::getCounterAddress. That add may not dominate the
+        // exit block, so recompute the address here.
+        //   %BiasAdd = add i64 ptrtoint <__profc_>, <bias>
+        //   %Addr = inttoptr i64 %BiasAdd to i64*
+        auto *OrigBiasInst = cast<BinaryOperator>(AddrInst->getOperand(0));
+        assert(OrigBiasInst->getOpcode() == Instruction::BinaryOps::Add);
+        Value *BiasInst = Builder.Insert(OrigBiasInst->clone());
+        Addr = Builder.CreateIntToPtr(BiasInst, AddrInst->getType());
+      }
       if (AtomicCounterUpdatePromoted)
         // automic update currently can only be promoted across the current
         // loop, not the whole loop nest.
@@ -459,6 +483,9 @@ bool InstrProfiling::lowerIntrinsics(Function *F) {
       } else if (auto *IPC = dyn_cast<InstrProfCoverInst>(&Instr)) {
         lowerCover(IPC);
         MadeChange = true;
+      } else if (auto *IPT = dyn_cast<InstrProfTimestampInst>(&Instr)) {
+        lowerTimestamp(IPT);
+        MadeChange = true;
       } else if (auto *IPVP = dyn_cast<InstrProfValueProfileInst>(&Instr)) {
         lowerValueProfileInst(IPVP);
         MadeChange = true;
@@ -485,6 +512,15 @@ bool InstrProfiling::isRuntimeCounterRelocationEnabled() const {
   return TT.isOSFuchsia();
 }
 
+bool InstrProfiling::isCounterShardingEnabled() const {
+  // The runtime finds the shards through a weak external reference, and
+  // they are selected through the address of a thread-local variable.
+  if (!TT.isOSBinFormatELF() || isRuntimeCounterRelocationEnabled())
+    return false;
+
+  return ShardCounters;
+}
+
 bool InstrProfiling::isCounterPromotionEnabled() const {
   if (DoCounterPromotion.getNumOccurrences() > 0)
     return DoCounterPromotion;
@@ -543,6 +579,7 @@ static bool containsProfilingIntrinsics(Module &M) {
     return false;
   };
   return containsIntrinsic(llvm::Intrinsic::instrprof_cover) ||
+         containsIntrinsic(llvm::Intrinsic::instrprof_timestamp) ||
          containsIntrinsic(llvm::Intrinsic::instrprof_increment) ||
          containsIntrinsic(llvm::Intrinsic::instrprof_increment_step) ||
          containsIntrinsic(llvm::Intrinsic::instrprof_value_profile);
@@ -559,6 +596,10 @@ bool InstrProfiling::run(
   UsedVars.clear();
   TT = Triple(M.getTargetTriple());
 
+  if (BinaryCorrelate && !TT.isOSBinFormatELF())
+    report_fatal_error("binary profile correlation is only supported for ELF",
+                       false);
+
   bool MadeChange = false;
 
   // Emit the runtime hook even if no counters are present.
@@ -648,7 +689,7 @@ void InstrProfiling::lowerValueProfileInst(InstrProfValueProfileInst *Ind) {
   // in lightweight mode. We need to move the value profile pointer to the
   // Counter struct to get this working.
   assert(
-      !DebugInfoCorrelate &&
+      !DebugInfoCorrelate && !BinaryCorrelate &&
       "Value profiling is not yet supported with lightweight instrumentation");
   GlobalVariable *Name = Ind->getName();
   auto It = ProfileDataMap.find(Name);
@@ -700,11 +741,17 @@ Value *InstrProfiling::getCounterAddress(InstrProfInstBase *I) {
   auto *Addr = Builder.CreateConstInBoundsGEP2_32(
       Counters->getValueType(), Counters, 0, I->getIndex()->getZExtValue());
 
+  Type *Int64Ty = Type::getInt64Ty(M->getContext());
+  Function *Fn = I->getParent()->getParent();
+  if (isCounterShardingEnabled()) {
+    auto *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty),
+                                  getCounterShardBias(Fn));
+    return Builder.CreateIntToPtr(Add, Addr->getType());
+  }
+
   if (!isRuntimeCounterRelocationEnabled())
     return Addr;
 
-  Type *Int64Ty = Type::getInt64Ty(M->getContext());
-  Function *Fn = I->getParent()->getParent();
   Instruction &EntryI = Fn->getEntryBlock().front();
   LoadInst *LI = dyn_cast<LoadInst>(&EntryI);
   if (!LI) {
@@ -731,6 +778,52 @@ Value *InstrProfiling::getCounterAddress(InstrProfInstBase *I) {
   return Builder.CreateIntToPtr(Add, Addr->getType());
 }
 
+Value *InstrProfiling::getCounterShardBias(Function *Fn) {
+  Value *&Bias = CounterShardBiases[Fn];
+  if (Bias)
+    return Bias;
+
+  LLVMContext &Ctx = M->getContext();
+  Type *Int8Ty = Type::getInt8Ty(Ctx);
+  Type *Int64Ty = Type::getInt64Ty(Ctx);
+  auto *BiasesTy = ArrayType::get(Int64Ty, INSTR_PROF_MAX_COUNTER_SHARDS);
+  // Like the counter bias, the compiler defines these variables and the
+  // runtime has a weak external reference to the biases, which it uses to
+  // check whether the counters are sharded. The biases are zero, so all
+  // threads update the counters themselves, unless the runtime sets them up.
+  auto GetOrCreateVar = [&](StringRef Name, Type *Ty, bool IsThreadLocal) {
+    if (auto *GV = M->getGlobalVariable(Name))
+      return GV;
+    auto *GV = new GlobalVariable(*M, Ty, false,
+                                  GlobalValue::LinkOnceODRLinkage,
+                                  Constant::getNullValue(Ty), Name);
+    GV->setVisibility(GlobalVariable::HiddenVisibility);
+    if (IsThreadLocal)
+      GV->setThreadLocalMode(GlobalVariable::InitialExecTLSModel);
+    if (TT.supportsCOMDAT())
+      GV->setComdat(M->getOrInsertComdat(GV->getName()));
+    return GV;
+  };
+  GlobalVariable *Biases =
+      GetOrCreateVar(getInstrProfCounterShardBiasesVarName(), BiasesTy, false);
+  GlobalVariable *Anchor =
+      GetOrCreateVar(getInstrProfCounterShardAnchorVarName(), Int8Ty, true);
+
+  // The shard of the thread is picked by a multiplicative hash of the address
+  // of its copy of the anchor, which is computed once in the entry block.
+  IRBuilder<> EntryBuilder(&*Fn->getEntryBlock().getFirstInsertionPt());
+  Value *Hash = EntryBuilder.CreateLShr(
+      EntryBuilder.CreatePtrToInt(Anchor, Int64Ty), 12);
+  Hash = EntryBuilder.CreateMul(Hash,
+                                EntryBuilder.getInt64(0x9E3779B97F4A7C15ULL));
+  Value *Shard = EntryBuilder.CreateLShr(
+      Hash, 64 - Log2_64(INSTR_PROF_MAX_COUNTER_SHARDS));
+  Value *BiasAddr = EntryBuilder.CreateInBoundsGEP(
+      BiasesTy, Biases, {EntryBuilder.getInt64(0), Shard});
+  Bias = EntryBuilder.CreateLoad(Int64Ty, BiasAddr, "pgocount.shard.bias");
+  return Bias;
+}
+
 void InstrProfiling::lowerCover(InstrProfCoverInst *CoverInstruction) {
   auto *Addr = getCounterAddress(CoverInstruction);
   IRBuilder<> Builder(CoverInstruction);
@@ -739,6 +832,21 @@ void InstrProfiling::lowerCover(InstrProfCoverInst *CoverInstruction) {
   CoverInstruction->eraseFromParent();
 }
 
+void InstrProfiling::lowerTimestamp(
+    InstrProfTimestampInst *TimestampInstruction) {
+  assert(TimestampInstruction->getIndex()->isZeroValue() &&
+         "timestamp probes are always the first probe for a function");
+  auto &Ctx = M->getContext();
+  auto *TimestampAddr = getCounterAddress(TimestampInstruction);
+  IRBuilder<> Builder(TimestampInstruction);
+  auto *CalleeTy =
+      FunctionType::get(Type::getVoidTy(Ctx), TimestampAddr->getType(), false);
+  auto Callee = M->getOrInsertFunction(
+      INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_SET_TIMESTAMP), CalleeTy);
+  Builder.CreateCall(Callee, {TimestampAddr});
+  TimestampInstruction->eraseFromParent();
+}
+
 void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
   auto *Addr = getCounterAddress(Inc);
 
@@ -1065,10 +1173,13 @@ InstrProfiling::getOrCreateRegionCounters(InstrProfInstBase *Inc) {
   auto *Data =
       new GlobalVariable(*M, DataTy, false, Linkage, nullptr, DataVarName);
   // Reference the counter variable with a label difference (link-time
-  // constant).
-  auto *RelativeCounterPtr =
-      ConstantExpr::getSub(ConstantExpr::getPtrToInt(CounterPtr, IntPtrTy),
-                           ConstantExpr::getPtrToInt(Data, IntPtrTy));
+  // constant). When correlating with the binary, the data is not loaded, so
+  // the linked address of the counters is recorded instead.
+  Constant *RelativeCounterPtr =
+      ConstantExpr::getPtrToInt(CounterPtr, IntPtrTy);
+  if (!BinaryCorrelate)
+    RelativeCounterPtr = ConstantExpr::getSub(
+        RelativeCounterPtr, ConstantExpr::getPtrToInt(Data, IntPtrTy));
 
   Constant *DataVals[] = {
 #define INSTR_PROF_DATA(Type, LLVMType, Name, Init) Init,
@@ -1077,7 +1188,8 @@ InstrProfiling::getOrCreateRegionCounters(InstrProfInstBase *Inc) {
   Data->setInitializer(ConstantStruct::get(DataTy, DataVals));
 
   Data->setVisibility(Visibility);
-  Data->setSection(getInstrProfSectionName(IPSK_data, TT.getObjectFormat()));
+  Data->setSection(getInstrProfSectionName(
+      BinaryCorrelate ? IPSK_covdata : IPSK_data, TT.getObjectFormat()));
   Data->setAlignment(Align(INSTR_PROF_DATA_ALIGNMENT));
   MaybeSetComdat(Data);
   Data->setLinkage(Linkage);
@@ -1164,8 +1276,8 @@ void InstrProfiling::emitNameData() {
                                 GlobalValue::PrivateLinkage, NamesVal,
                                 getInstrProfNamesVarName());
   NamesSize = CompressedNameStr.size();
-  NamesVar->setSection(
-      getInstrProfSectionName(IPSK_name, TT.getObjectFormat()));
+  NamesVar->setSection(getInstrProfSectionName(
+      BinaryCorrelate ? IPSK_covname : IPSK_name, TT.getObjectFormat()));
   // On COFF, it's important to reduce the alignment down to 1 to prevent the
   // linker from inserting padding before the start of the names section or
   // between names entries.
@@ -15,16 +15,22 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Transforms/Instrumentation/MemProfiler.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/MemoryBuiltins.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/LLVMContext.h"
@@ -33,6 +39,8 @@
 #include "llvm/IR/Value.h"
 #include "llvm/InitializePasses.h"
 #include "llvm/Pass.h"
+#include "llvm/ProfileData/InstrProfReader.h"
+#include "llvm/ProfileData/MemProf.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Transforms/Instrumentation.h"
@@ -127,10 +135,55 @@ static cl::opt<int> ClDebugMin("memprof-debug-min", cl::desc("Debug min inst"),
 static cl::opt<int> ClDebugMax("memprof-debug-max", cl::desc("Debug max inst"),
                                cl::Hidden, cl::init(-1));
 
+// Memory profile use flags.
+
+static cl::opt<std::string>
+    MemProfUseTestProfileFile("memprof-use-test-profile-file", cl::init(""),
+                              cl::Hidden, cl::value_desc("filename"),
+                              cl::desc("Specify the path of the memory profile "
+                                       "to use. This is mainly for testing."));
+
+static cl::opt<float> MemProfAccessesPerByteColdThreshold(
+    "memprof-accesses-per-byte-cold-threshold", cl::init(10.0), cl::Hidden,
+    cl::desc("Long-lived allocations with fewer accesses per byte are cold"));
+
+static cl::opt<float> MemProfAccessesPerByteHotThreshold(
+    "memprof-accesses-per-byte-hot-threshold", cl::init(1000.0), cl::Hidden,
+    cl::desc("Allocations with at least this many accesses per byte are hot"));
+
+static cl::opt<unsigned> MemProfMinLifetimeLongThreshold(
+    "memprof-min-lifetime-long-threshold", cl::init(200), cl::Hidden,
+    cl::desc("Minimum average lifetime, in seconds, of long-lived "
+             "allocations"));
+
+static cl::opt<bool> MemProfHotColdNew(
+    "memprof-hot-cold-new", cl::init(false), cl::Hidden,
+    cl::desc("Replace the calls to operator new of the annotated allocations "
+             "by calls to its variants taking a __hot_cold_t hint"));
+
+static cl::opt<unsigned> MemProfColdNewHintValue(
+    "memprof-cold-new-hint-value", cl::init(1), cl::Hidden,
+    cl::desc("Value of the __hot_cold_t hint of cold allocations"));
+
+static cl::opt<unsigned> MemProfNotColdNewHintValue(
+    "memprof-notcold-new-hint-value", cl::init(128), cl::Hidden,
+    cl::desc("Value of the __hot_cold_t hint of allocations that are not "
+             "cold"));
+
+static cl::opt<unsigned> MemProfHotNewHintValue(
+    "memprof-hot-new-hint-value", cl::init(254), cl::Hidden,
+    cl::desc("Value of the __hot_cold_t hint of hot allocations"));
+
 STATISTIC(NumInstrumentedReads, "Number of instrumented reads");
 STATISTIC(NumInstrumentedWrites, "Number of instrumented writes");
 STATISTIC(NumSkippedStackReads, "Number of non-instrumented stack reads");
 STATISTIC(NumSkippedStackWrites, "Number of non-instrumented stack writes");
+STATISTIC(NumOfMemProfColdAllocs, "Number of allocations annotated as cold");
+STATISTIC(NumOfMemProfNotColdAllocs,
+          "Number of allocations annotated as not cold");
+STATISTIC(NumOfMemProfHotAllocs, "Number of allocations annotated as hot");
+STATISTIC(NumOfMemProfHotColdNews,
+          "Number of calls to operator new given a hot/cold hint");
 
 namespace {
 
@@ -649,3 +702,238 @@ bool MemProfiler::instrumentFunction(Function &F) {
 
   return FunctionModified;
 }
+
+namespace {
+
+enum class AllocationType { NotCold, Cold, Hot };
+enum class AllocationLifetime { Short, Long };
+
+/// The behavior of the allocations made at an allocation site.
+struct AllocationInfo {
+  AllocationType Type;
+  AllocationLifetime Lifetime;
+};
+
+} // end anonymous namespace
+
+static AllocationInfo
+getAllocationInfo(const memprof::PortableMemInfoBlock &B) {
+  // Lifetimes are in milliseconds.
+  double AveLifetime =
+      B.getAllocCount() ? double(B.getTotalLifetime()) / B.getAllocCount() : 0;
+  double AccessesPerByte =
+      B.getTotalSize() ? double(B.getTotalAccessCount()) / B.getTotalSize() : 0;
+  AllocationInfo Info;
+  Info.Lifetime = AveLifetime >= MemProfMinLifetimeLongThreshold * 1000.0
+                      ? AllocationLifetime::Long
+                      : AllocationLifetime::Short;
+  if (Info.Lifetime == AllocationLifetime::Long &&
+      AccessesPerByte < MemProfAccessesPerByteColdThreshold)
+    Info.Type = AllocationType::Cold;
+  else if (AccessesPerByte >= MemProfAccessesPerByteHotThreshold)
+    Info.Type = AllocationType::Hot;
+  else
+    Info.Type = AllocationType::NotCold;
+  return Info;
+}
+
+static StringRef getAllocTypeAttributeString(AllocationType Type) {
+  switch (Type) {
+  case AllocationType::NotCold:
+    return "notcold";
+  case AllocationType::Cold:
+    return "cold";
+  case AllocationType::Hot:
+    return "hot";
+  }
+  llvm_unreachable("Unexpected alloc type");
+}
+
+static uint64_t getGUID(const DISubprogram *SP) {
+  // The profile identifies functions by their linkage names, without any
+  // suffix added by ThinLTO promotion.
+  StringRef Name = SP->getLinkageName();
+  if (Name.empty())
+    Name = SP->getName();
+  return Function::getGUID(Name);
+}
+
+/// Returns whether the call stack of \p Record starts with the frames of the
+/// inlined call stack of \p DIL.
+static bool stackFrameIncludesInlinedCallStack(
+    const memprof::MemProfRecord &Record, const DILocation *DIL) {
+  ArrayRef<memprof::MemProfRecord::Frame> Frames = Record.CallStack;
+  for (; DIL; DIL = DIL->getInlinedAt(), Frames = Frames.drop_front()) {
+    if (Frames.empty())
+      return false;
+    const DISubprogram *SP = DIL->getScope()->getSubprogram();
+    if (!SP || Frames.front().Function != getGUID(SP) ||
+        Frames.front().LineOffset != DIL->getLine() - SP->getLine() ||
+        Frames.front().Column != DIL->getColumn())
+      return false;
+  }
+  return true;
+}
+
+/// Replaces the call \p CB to operator new by a call to its variant taking
+/// the hint for \p AllocType. Returns whether the call was replaced.
+static bool addHotColdHint(CallBase *CB, AllocationType AllocType,
+                           const TargetLibraryInfo &TLI) {
+  LibFunc Func;
+  Function *Callee = CB->getCalledFunction();
+  if (!Callee || !TLI.getLibFunc(*Callee, Func))
+    return false;
+  LibFunc HintedFunc;
+  if (Func == LibFunc_Znwm)
+    HintedFunc = LibFunc_Znwm12__hot_cold_t;
+  else if (Func == LibFunc_Znam)
+    HintedFunc = LibFunc_Znam12__hot_cold_t;
+  else
+    return false;
+  if (!TLI.has(HintedFunc))
+    return false;
+
+  unsigned Hint;
+  switch (AllocType) {
+  case AllocationType::NotCold:
+    Hint = MemProfNotColdNewHintValue;
+    break;
+  case AllocationType::Cold:
+    Hint = MemProfColdNewHintValue;
+    break;
+  case AllocationType::Hot:
+    Hint = MemProfHotNewHintValue;
+    break;
+  }
+
+  Module &M = *CB->getModule();
+  LLVMContext &Ctx = M.getContext();
+  Type *Int8Ty = Type::getInt8Ty(Ctx);
+  Value *Size = CB->getArgOperand(0);
+  FunctionCallee HintedNew = M.getOrInsertFunction(
+      TLI.getName(HintedFunc),
+      FunctionType::get(CB->getType(), {Size->getType(), Int8Ty},
+                        /*isVarArg=*/false));
+  Value *Args[] = {Size, ConstantInt::get(Int8Ty, Hint)};
+  SmallVector<OperandBundleDef, 1> Bundles;
+  CB->getOperandBundlesAsDefs(Bundles);
+  CallBase *NewCB;
+  if (auto *II = dyn_cast<InvokeInst>(CB))
+    NewCB = InvokeInst::Create(HintedNew, II->getNormalDest(),
+                               II->getUnwindDest(), Args, Bundles, "", CB);
+  else
+    NewCB = CallInst::Create(HintedNew, Args, Bundles, "", CB);
+  AttributeList Attrs = CB->getAttributes();
+  NewCB->setAttributes(AttributeList::get(Ctx, Attrs.getFnAttrs(),
+                                          Attrs.getRetAttrs(),
+                                          {Attrs.getParamAttrs(0)}));
+  NewCB->setCallingConv(CB->getCallingConv());
+  NewCB->copyMetadata(*CB);
+  NewCB->takeName(CB);
+  CB->replaceAllUsesWith(NewCB);
+  CB->eraseFromParent();
+  ++NumOfMemProfHotColdNews;
+  return true;
+}
+
+MemProfUsePass::MemProfUsePass(std::string MemoryProfileFile)
+    : MemoryProfileFileName(std::move(MemoryProfileFile)) {
+  if (!MemProfUseTestProfileFile.empty())
+    MemoryProfileFileName = MemProfUseTestProfileFile;
+}
+
+PreservedAnalyses MemProfUsePass::run(Module &M, ModuleAnalysisManager &AM) {
+  LLVMContext &Ctx = M.getContext();
+  auto ReaderOrErr = IndexedInstrProfReader::create(MemoryProfileFileName);
+  if (Error E = ReaderOrErr.takeError()) {
+    handleAllErrors(std::move(E), [&](const ErrorInfoBase &EI) {
+      Ctx.diagnose(
+          DiagnosticInfoPGOProfile(MemoryProfileFileName.data(), EI.message()));
+    });
+    return PreservedAnalyses::all();
+  }
+  std::unique_ptr<IndexedInstrProfReader> Reader = std::move(ReaderOrErr.get());
+  if (!static_cast<bool>(Reader->getProfileKind() & InstrProfKind::MemProf)) {
+    Ctx.diagnose(DiagnosticInfoPGOProfile(MemoryProfileFileName.data(),
+                                          "Not a memory profile"));
+    return PreservedAnalyses::all();
+  }
+
+  // Collect the allocation calls with a debug location, by the function
+  // their allocation site is in, so that the records of each function are
+  // only looked up once.
+  auto &FAM = AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+  MapVector<uint64_t, SmallVector<CallBase *, 4>> AllocCallsByFunction;
+  for (Function &F : M) {
+    if (F.isDeclaration())
+      continue;
+    const TargetLibraryInfo &TLI = FAM.getResult<TargetLibraryAnalysis>(F);
+    for (Instruction &I : instructions(F)) {
+      auto *CB = dyn_cast<CallBase>(&I);
+      if (!CB || isa<IntrinsicInst>(CB) || !isAllocationFn(CB, &TLI))
+        continue;
+      const DILocation *DIL = CB->getDebugLoc();
+      if (!DIL || !DIL->getScope()->getSubprogram())
+        continue;
+      AllocCallsByFunction[getGUID(DIL->getScope()->getSubprogram())]
+          .push_back(CB);
+    }
+  }
+
+  bool Changed = false;
+  for (auto &FunctionCalls : AllocCallsByFunction) {
+    auto RecordsOr = Reader->getMemProfRecord(FunctionCalls.first);
+    if (!RecordsOr) {
+      consumeError(RecordsOr.takeError());
+      continue;
+    }
+    // The records are only valid until the next lookup.
+    ArrayRef<memprof::MemProfRecord> Records = *RecordsOr;
+    for (CallBase *CB : FunctionCalls.second) {
+      Optional<AllocationType> Type;
+      Optional<AllocationLifetime> Lifetime;
+      bool MixedTypes = false, MixedLifetimes = false;
+      for (const memprof::MemProfRecord &Record : Records) {
+        if (!stackFrameIncludesInlinedCallStack(Record, CB->getDebugLoc()))
+          continue;
+        AllocationInfo Info = getAllocationInfo(Record.Info);
+        MixedTypes |= Type && *Type != Info.Type;
+        MixedLifetimes |= Lifetime && *Lifetime != Info.Lifetime;
+        Type = Info.Type;
+        Lifetime = Info.Lifetime;
+      }
+      if (!Type)
+        continue;
+
+      // Without context disambiguation, the allocations of a site made from
+      // different contexts need to agree.
+      if (MixedTypes)
+        Type = AllocationType::NotCold;
+      CB->addFnAttr(
+          Attribute::get(Ctx, "memprof", getAllocTypeAttributeString(*Type)));
+      if (!MixedLifetimes)
+        CB->addFnAttr(Attribute::get(
+            Ctx, "memprof-lifetime",
+            *Lifetime == AllocationLifetime::Long ? "long" : "short"));
+      switch (*Type) {
+      case AllocationType::NotCold:
+        ++NumOfMemProfNotColdAllocs;
+        break;
+      case AllocationType::Cold:
+        ++NumOfMemProfColdAllocs;
+        break;
+      case AllocationType::Hot:
+        ++NumOfMemProfHotAllocs;
+        break;
+      }
+      Changed = true;
+
+      if (MemProfHotColdNew) {
+        Function &F = *CB->getFunction();
+        addHotColdHint(CB, *Type, FAM.getResult<TargetLibraryAnalysis>(F));
+      }
+    }
+  }
+
+  return Changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
+}
@@ -146,6 +146,16 @@ static cl::opt<int>
 ScheduleRegionSizeBudget("slp-schedule-budget", cl::init(100000), cl::Hidden,
     cl::desc("Limit the size of the SLP scheduling region per block"));
 
+/// Limits the number of tree entries built per function, over all the trees
+/// that are tried. Very long straight-line code, e.g. unrolled crypto kernels,
+/// can otherwise spend most of the compile time building trees that are
+/// thrown away. Like the scheduling budget, this is way higher than needed by
+/// real-world functions.
+static cl::opt<unsigned> FunctionBudget(
+    "slp-function-budget", cl::init(1000000), cl::Hidden,
+    cl::desc("Limit the number of SLP tree entries built per function "
+             "(0=unlimited)"));
+
 static cl::opt<int> MinVectorRegSizeOption(
     "slp-min-reg-size", cl::init(128), cl::Hidden,
     cl::desc("Attempt to vectorize for this register size in bits"));
@@ -859,6 +869,12 @@ public:
 
   unsigned getTreeSize() const { return VectorizableTree.size(); }
 
+  /// \returns true if the trees built for this function so far exhausted the
+  /// budget given by -slp-function-budget. New trees are gathered right away.
+  bool isFunctionBudgetExhausted() const {
+    return FunctionBudget && NumTreeEntriesBuilt >= FunctionBudget;
+  }
+
   /// Perform LICM and CSE on the newly generated gather sequences.
   void optimizeGatherSequence();
 
@@ -2322,6 +2338,7 @@ private:
             (Bundle && EntryState != TreeEntry::NeedToGather)) &&
            "Need to vectorize gather entry?");
     VectorizableTree.push_back(std::make_unique<TreeEntry>(VectorizableTree));
+    ++NumTreeEntriesBuilt;
     TreeEntry *Last = VectorizableTree.back().get();
     Last->Idx = VectorizableTree.size() - 1;
     Last->State = EntryState;
@@ -2993,6 +3010,16 @@ private:
   /// value must be signed-extended, rather than zero-extended, back to its
   /// original width.
   MapVector<Value *, std::pair<uint64_t, bool>> MinBWs;
+
+  /// The cost of inserting the scalars into a vector of the given type, for
+  /// the given mask of elements that do not need to be inserted. The same
+  /// gathers show up in many of the trees that are tried for a function.
+  mutable DenseMap<std::pair<FixedVectorType *, APInt>, InstructionCost>
+      ScalarizationCosts;
+
+  /// The number of tree entries built for this function, see
+  /// isFunctionBudgetExhausted().
+  unsigned NumTreeEntriesBuilt = 0;
 };
 
 } // end namespace slpvectorizer
@@ -3893,6 +3920,14 @@ void BoUpSLP::buildTree_rec(ArrayRef<Value *> VL, unsigned Depth,
     return;
   }
 
+  if (isFunctionBudgetExhausted()) {
+    LLVM_DEBUG(dbgs() << "SLP: Gathering due to exhausted function budget.\n");
+    if (TryToFindDuplicates(S))
+      newTreeEntry(VL, None /*not vectorized*/, S, UserTreeIdx,
+                   ReuseShuffleIndicies);
+    return;
+  }
+
   // Don't handle scalable vectors
   if (S.getOpcode() == Instruction::ExtractElement &&
       isa<ScalableVectorType>(
@@ -6319,9 +6354,15 @@ BoUpSLP::isGatherShuffledEntry(const TreeEntry *TE, SmallVectorImpl<int> &Mask,
 InstructionCost BoUpSLP::getGatherCost(FixedVectorType *Ty,
                                        const APInt &ShuffledIndices,
                                        bool NeedToShuffle) const {
-  InstructionCost Cost =
-      TTI->getScalarizationOverhead(Ty, ~ShuffledIndices, /*Insert*/ true,
-                                    /*Extract*/ false);
+  auto It = ScalarizationCosts.find({Ty, ShuffledIndices});
+  if (It == ScalarizationCosts.end())
+    It = ScalarizationCosts
+             .try_emplace({Ty, ShuffledIndices},
+                          TTI->getScalarizationOverhead(
+                              Ty, ~ShuffledIndices, /*Insert*/ true,
+                              /*Extract*/ false))
+             .first;
+  InstructionCost Cost = It->second;
   if (NeedToShuffle)
     Cost += TTI->getShuffleCost(TargetTransformInfo::SK_PermuteSingleSrc, Ty);
   return Cost;
@@ -8491,6 +8532,17 @@ bool SLPVectorizerPass::runImpl(Function &F, ScalarEvolution *SE_,
     }
   }
 
+  if (R.isFunctionBudgetExhausted()) {
+    LLVM_DEBUG(dbgs() << "SLP: Exhausted the function budget in "
+                      << F.getName() << ".\n");
+    R.getORE()->emit([&]() {
+      return OptimizationRemarkMissed(SV_NAME, "FunctionBudgetExhausted", &F)
+             << "Stopped SLP vectorizing the function after building "
+             << ore::NV("Budget", FunctionBudget.getValue())
+             << " tree entries";
+    });
+  }
+
   if (Changed) {
     R.optimizeGatherSequence();
     LLVM_DEBUG(dbgs() << "SLP: vectorized \"" << F.getName() << "\"\n");
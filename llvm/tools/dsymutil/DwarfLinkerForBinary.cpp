@@ -23,6 +23,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
@@ -143,11 +144,24 @@ static Error copySwiftInterfaces(
   return Error::success();
 }
 
+/// When set, the diagnostics of the current thread are recorded here instead
+/// of being printed. See DwarfLinkerForBinary::preloadObject.
+static LLVM_THREAD_LOCAL std::vector<unique_function<void()>>
+    *DeferredDiagnostics = nullptr;
+
 /// Report a warning to the user, optionally including information about a
 /// specific \p DIE related to the warning.
 void DwarfLinkerForBinary::reportWarning(const Twine &Warning,
                                          StringRef Context,
                                          const DWARFDie *DIE) const {
+  if (DeferredDiagnostics) {
+    assert(!DIE && "DIEs are not reported while preloading objects");
+    DeferredDiagnostics->push_back(
+        [Warning = Warning.str(), Context = Context.str()] {
+          warn(Warning, Context);
+        });
+    return;
+  }
 
   warn(Warning, Context);
 
@@ -266,34 +280,85 @@ static Error emitRemarks(const LinkOptions &Options, StringRef BinaryPath,
   return Error::success();
 }
 
+DwarfLinkerForBinary::PreloadedObject
+DwarfLinkerForBinary::preloadObject(const DebugMapObject &Obj,
+                                    const Triple &Triple,
+                                    bool DeferDiagnostics) {
+  PreloadedObject Result;
+  if (DeferDiagnostics)
+    DeferredDiagnostics = &Result.Diagnostics;
+  auto Restore = make_scope_exit([&] {
+    if (DeferDiagnostics)
+      DeferredDiagnostics = nullptr;
+  });
+
+  auto ErrorOrObj = loadObject(Obj, Triple);
+  if (!ErrorOrObj) {
+    Result.EC = ErrorOrObj.getError();
+    return Result;
+  }
+  Result.Object = &*ErrorOrObj;
+
+  std::function<void(Error)> RecoverableErrorHandler =
+      WithColor::defaultErrorHandler;
+  std::function<void(Error)> WarningHandler = WithColor::defaultWarningHandler;
+  if (DeferDiagnostics) {
+    // The context keeps using these handlers once the linking has started:
+    // only defer what is reported while it is created on this thread.
+    auto Defer = [](void (*Handler)(Error)) -> std::function<void(Error)> {
+      return [Handler](Error E) {
+        if (!DeferredDiagnostics)
+          return Handler(std::move(E));
+        DeferredDiagnostics->push_back(
+            [Handler, E = std::move(E)]() mutable { Handler(std::move(E)); });
+      };
+    };
+    RecoverableErrorHandler = Defer(WithColor::defaultErrorHandler);
+    WarningHandler = Defer(WithColor::defaultWarningHandler);
+  }
+  Result.Context = DWARFContext::create(
+      *ErrorOrObj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
+      std::move(RecoverableErrorHandler), std::move(WarningHandler));
+  Result.AddressMap = std::make_unique<AddressManager>(*this, *ErrorOrObj, Obj);
+  return Result;
+}
+
 ErrorOr<DWARFFile &>
 DwarfLinkerForBinary::loadObject(const DebugMapObject &Obj,
                                  const DebugMap &DebugMap,
                                  remarks::RemarkLinker &RL) {
-  auto ErrorOrObj = loadObject(Obj, DebugMap.getTriple());
-
-  if (ErrorOrObj) {
-    ContextForLinking.push_back(
-        std::unique_ptr<DWARFContext>(DWARFContext::create(*ErrorOrObj)));
-    AddressMapForLinking.push_back(
-        std::make_unique<AddressManager>(*this, *ErrorOrObj, Obj));
-
-    ObjectsForLinking.push_back(std::make_unique<DWARFFile>(
-        Obj.getObjectFilename(), ContextForLinking.back().get(),
-        AddressMapForLinking.back().get(),
-        Obj.empty() ? Obj.getWarnings() : EmptyWarnings));
-
-    Error E = RL.link(*ErrorOrObj);
-    if (Error NewE = handleErrors(
-            std::move(E), [&](std::unique_ptr<FileError> EC) -> Error {
-              return remarksErrorHandler(Obj, *this, std::move(EC));
-            }))
-      return errorToErrorCode(std::move(NewE));
-
-    return *ObjectsForLinking.back();
-  }
+  return loadObject(Obj,
+                    preloadObject(Obj, DebugMap.getTriple(),
+                                  /*DeferDiagnostics=*/false),
+                    RL);
+}
 
-  return ErrorOrObj.getError();
+ErrorOr<DWARFFile &>
+DwarfLinkerForBinary::loadObject(const DebugMapObject &Obj,
+                                 PreloadedObject Preloaded,
+                                 remarks::RemarkLinker &RL) {
+  for (auto &Diagnostic : Preloaded.Diagnostics)
+    Diagnostic();
+
+  if (!Preloaded.Object)
+    return Preloaded.EC;
+
+  ContextForLinking.push_back(std::move(Preloaded.Context));
+  AddressMapForLinking.push_back(std::move(Preloaded.AddressMap));
+
+  ObjectsForLinking.push_back(std::make_unique<DWARFFile>(
+      Obj.getObjectFilename(), ContextForLinking.back().get(),
+      AddressMapForLinking.back().get(),
+      Obj.empty() ? Obj.getWarnings() : EmptyWarnings));
+
+  Error E = RL.link(*Preloaded.Object);
+  if (Error NewE = handleErrors(
+          std::move(E), [&](std::unique_ptr<FileError> EC) -> Error {
+            return remarksErrorHandler(Obj, *this, std::move(EC));
+          }))
+    return errorToErrorCode(std::move(NewE));
+
+  return *ObjectsForLinking.back();
 }
 
 static bool binaryHasSwiftReflectionSections(const DebugMap &Map,
@@ -470,7 +535,28 @@ bool DwarfLinkerForBinary::link(const DebugMap &Map) {
         binaryHasSwiftReflectionSections(Map, Options, BinHolder);
   }
 
+  // Reading the object files and scanning their relocations is independent
+  // for each object, so it is done in parallel ahead of the linking. The
+  // objects are then added to the linker, and their diagnostics are reported,
+  // in debug map order to keep the output deterministic.
+  std::vector<PreloadedObject> Preloaded(Map.getNumberOfObjects());
+  if (Options.Threads != 1) {
+    ThreadPool Pool(hardware_concurrency(Options.Threads));
+    for (const auto &Obj : enumerate(Map.objects())) {
+      if (Obj.value()->getType() == MachO::N_AST)
+        continue;
+      Pool.async([&, I = Obj.index(), &DMO = *Obj.value()] {
+        Preloaded[I] = preloadObject(DMO, Map.getTriple(),
+                                     /*DeferDiagnostics=*/true);
+      });
+    }
+    Pool.wait();
+  }
+
+  unsigned ObjectIndex = 0;
   for (const auto &Obj : Map.objects()) {
+    PreloadedObject Object = std::move(Preloaded[ObjectIndex++]);
+
     // If there is no output specified or the reflection sections are present in
     // the Input binary, there is no need to copy the Swift Reflection Metadata
     if (!Options.NoOutput && !ReflectionSectionsPresentInBinary)
@@ -516,7 +602,9 @@ bool DwarfLinkerForBinary::link(const DebugMap &Map) {
 
       continue;
     }
-    if (auto ErrorOrObj = loadObject(*Obj, Map, RL))
+    if (Options.Threads == 1)
+      Object = preloadObject(*Obj, Map.getTriple(), /*DeferDiagnostics=*/false);
+    if (auto ErrorOrObj = loadObject(*Obj, std::move(Object), RL))
       GeneralLinker.addObjectFile(*ErrorOrObj);
     else {
       ObjectsForLinking.push_back(std::make_unique<DWARFFile>(
@@ -12,6 +12,7 @@
 #include "BinaryHolder.h"
 #include "DebugMap.h"
 #include "LinkUtils.h"
+#include "llvm/ADT/FunctionExtras.h"
 #include "llvm/DWARFLinker/DWARFLinker.h"
 #include "llvm/DWARFLinker/DWARFLinkerCompileUnit.h"
 #include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
@@ -196,12 +197,33 @@ private:
   /// @{
   bool createStreamer(const Triple &TheTriple, raw_fd_ostream &OutFile);
 
+  /// A debug object loaded from disk, along with its DWARF context and the
+  /// relocations found in its debug sections.
+  struct PreloadedObject {
+    const object::ObjectFile *Object = nullptr;
+    std::error_code EC;
+    std::unique_ptr<DWARFContext> Context;
+    std::unique_ptr<AddressManager> AddressMap;
+    /// Diagnostics reported while loading the object, when it was loaded on
+    /// a worker thread. They are replayed in debug map order.
+    std::vector<unique_function<void()>> Diagnostics;
+  };
+
   /// Attempt to load a debug object from disk.
   ErrorOr<const object::ObjectFile &> loadObject(const DebugMapObject &Obj,
                                                  const Triple &triple);
   ErrorOr<DWARFFile &> loadObject(const DebugMapObject &Obj,
                                   const DebugMap &DebugMap,
                                   remarks::RemarkLinker &RL);
+  ErrorOr<DWARFFile &> loadObject(const DebugMapObject &Obj,
+                                  PreloadedObject Preloaded,
+                                  remarks::RemarkLinker &RL);
+
+  /// Load \p Obj and scan its relocations. This is thread safe: when it
+  /// runs on a worker thread with \p DeferDiagnostics, the diagnostics are
+  /// recorded in the result instead of being printed.
+  PreloadedObject preloadObject(const DebugMapObject &Obj,
+                                const Triple &Triple, bool DeferDiagnostics);
 
   raw_fd_ostream &OutFile;
   BinaryHolder &BinHolder;
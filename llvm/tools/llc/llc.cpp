@@ -22,6 +22,7 @@
 #include "llvm/CodeGen/MIRParser/MIRParser.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/IR/AutoUpgrade.h"
@@ -156,6 +157,14 @@ static cl::opt<bool>
                           "manager and verify the result is the same."),
                  cl::init(false));
 
+static cl::opt<unsigned> CodeGenPartitions(
+    "codegen-partitions",
+    cl::desc("Split the module into this many partitions and generate code "
+             "for them in parallel. Partition N > 0 is written to "
+             "<output>.N; the outputs linked together are equivalent to the "
+             "output of a single partition"),
+    cl::value_desc("N"), cl::init(1));
+
 static cl::opt<bool> DiscardValueNames(
     "discard-value-names",
     cl::desc("Discard names from Value (other than GlobalValue)."),
@@ -215,6 +224,9 @@ static cl::opt<RunPassOption, true, cl::parser<std::string>> RunPass(
     cl::value_desc("pass-name"), cl::ZeroOrMore, cl::location(RunPassOpt));
 
 static int compileModule(char **, LLVMContext &);
+static int compileModuleInPartitions(
+    char **argv, Module &M, ToolOutputFile &Out,
+    const std::function<std::unique_ptr<TargetMachine>()> &TMFactory);
 
 [[noreturn]] static void reportError(Twine Msg, StringRef Filename = "") {
   SmallString<256> Prefix;
@@ -641,6 +653,18 @@ static int compileModule(char **argv, LLVMContext &Context) {
     WithColor::warning(errs(), argv[0])
         << ": warning: ignoring -mc-relax-all because filetype != obj";
 
+  if (CodeGenPartitions > 1) {
+    if (MIR || !RunPassNames->empty() || DwoOut || CompileTwice)
+      reportError("-codegen-partitions cannot be used with MIR input, "
+                  "-run-pass, -split-dwarf-output or -compile-twice");
+    auto TMFactory = [&]() {
+      return std::unique_ptr<TargetMachine>(TheTarget->createTargetMachine(
+          TheTriple.getTriple(), CPUStr, FeaturesStr, Options, RM,
+          codegen::getExplicitCodeModel(), OLvl));
+    };
+    return compileModuleInPartitions(argv, *M, *Out, TMFactory);
+  }
+
   {
     raw_pwrite_stream *OS = &Out->os();
 
@@ -751,3 +775,42 @@ static int compileModule(char **argv, LLVMContext &Context) {
 
   return 0;
 }
+
+/// Generate code for \p M in CodeGenPartitions partitions in parallel. The
+/// first partition is written to \p Out, and the others to files named after
+/// it.
+static int compileModuleInPartitions(
+    char **argv, Module &M, ToolOutputFile &Out,
+    const std::function<std::unique_ptr<TargetMachine>()> &TMFactory) {
+  if (Out.outputFilename() == "-")
+    reportError("-codegen-partitions requires an output file");
+
+  std::vector<std::unique_ptr<ToolOutputFile>> PartitionOuts;
+  SmallVector<raw_pwrite_stream *, 8> OSs = {&Out.os()};
+  sys::fs::OpenFlags OpenFlags = codegen::getFileType() == CGFT_AssemblyFile
+                                     ? sys::fs::OF_TextWithCRLF
+                                     : sys::fs::OF_None;
+  for (unsigned I = 1; I != CodeGenPartitions; ++I) {
+    std::string Filename = (Out.outputFilename() + "." + Twine(I)).str();
+    std::error_code EC;
+    PartitionOuts.push_back(
+        std::make_unique<ToolOutputFile>(Filename, EC, OpenFlags));
+    if (EC)
+      reportError(EC.message(), Filename);
+    OSs.push_back(&PartitionOuts.back()->os());
+  }
+
+  // Each partition is compiled in its own context, on a separate thread.
+  splitCodeGen(M, OSs, /*BCOSs=*/{}, TMFactory, codegen::getFileType());
+
+  auto HasError =
+      ((const LLCDiagnosticHandler *)(M.getContext().getDiagHandlerPtr()))
+          ->HasError;
+  if (*HasError)
+    return 1;
+
+  Out.keep();
+  for (std::unique_ptr<ToolOutputFile> &PartitionOut : PartitionOuts)
+    PartitionOut->keep();
+  return 0;
+}
@@ -43,6 +43,8 @@
 #include "llvm/ToolDrivers/llvm-dlltool/DlltoolDriver.h"
 #include "llvm/ToolDrivers/llvm-lib/LibDriver.h"
 
+#include <map>
+
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
 #else
@@ -649,9 +651,34 @@ static void performReadOperation(ArchiveOperation Operation,
   exit(1);
 }
 
+// The archive symbols of the members of an archive, keyed by member offset.
+using MemberSymbolMap = std::map<uint64_t, std::vector<StringRef>>;
+
+// Returns the symbols of the members of an archive as recorded in its symbol
+// table, so that members copied unchanged do not have to be parsed again.
+static Optional<MemberSymbolMap>
+getMemberSymbols(const object::Archive &Archive) {
+  // The members of thin archives live in separate files, which may have
+  // changed since the symbol table was written.
+  if (Archive.isThin() || !Archive.hasSymbolTable())
+    return None;
+  MemberSymbolMap Ret;
+  for (const object::Archive::Symbol &Sym : Archive.symbols()) {
+    Expected<object::Archive::Child> ChildOrErr = Sym.getMember();
+    if (!ChildOrErr) {
+      // Let the writer parse the members instead.
+      consumeError(ChildOrErr.takeError());
+      return None;
+    }
+    Ret[ChildOrErr->getChildOffset()].push_back(Sym.getName());
+  }
+  return Ret;
+}
+
 static void addChildMember(std::vector<NewArchiveMember> &Members,
                            const object::Archive::Child &M,
-                           bool FlattenArchive = false) {
+                           bool FlattenArchive = false,
+                           const MemberSymbolMap *OldSymbols = nullptr) {
   if (Thin && !M.getParent()->isThin())
     fail("cannot convert a regular archive to a thin one");
 
@@ -694,6 +721,11 @@ static void addChildMember(std::vector<NewArchiveMember> &Members,
       return;
     }
   }
+  if (OldSymbols) {
+    auto It = OldSymbols->find(M.getChildOffset());
+    NMOrErr->Symbols =
+        It == OldSymbols->end() ? std::vector<StringRef>() : It->second;
+  }
   Members.push_back(std::move(*NMOrErr));
 }
 
@@ -802,6 +834,10 @@ computeNewArchiveMembers(ArchiveOperation Operation,
   std::vector<NewArchiveMember> Moved;
   int InsertPos = -1;
   if (OldArchive) {
+    Optional<MemberSymbolMap> OldSymbols;
+    if (Symtab)
+      OldSymbols = getMemberSymbols(*OldArchive);
+    const MemberSymbolMap *OldSymbolsPtr = OldSymbols.getPointer();
     Error Err = Error::success();
     StringMap<int> MemberCount;
     for (auto &Child : OldArchive->children(Err)) {
@@ -822,7 +858,7 @@ computeNewArchiveMembers(ArchiveOperation Operation,
           computeInsertAction(Operation, Child, Name, MemberI, MemberCount);
       switch (Action) {
       case IA_AddOldMember:
-        addChildMember(Ret, Child, /*FlattenArchive=*/Thin);
+        addChildMember(Ret, Child, /*FlattenArchive=*/Thin, OldSymbolsPtr);
         break;
       case IA_AddNewMember:
         addMember(Ret, *MemberI);
@@ -830,7 +866,7 @@ computeNewArchiveMembers(ArchiveOperation Operation,
       case IA_Delete:
         break;
       case IA_MoveOldMember:
-        addChildMember(Moved, Child, /*FlattenArchive=*/Thin);
+        addChildMember(Moved, Child, /*FlattenArchive=*/Thin, OldSymbolsPtr);
         break;
       case IA_MoveNewMember:
         addMember(Moved, *MemberI);
@@ -14,6 +14,7 @@
 #include "llvm/DebugInfo/DWARF/DWARFExpression.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/ThreadPool.h"
 
 #define DEBUG_TYPE "dwarfdump"
 using namespace llvm;
@@ -51,6 +52,7 @@ struct SaturatingUINT64 {
   SaturatingUINT64(uint64_t Value_) : Value(Value_) {}
 
   void operator++(int) { return *this += 1; }
+  void operator+=(SaturatingUINT64 Other) { *this += Other.Value; }
   void operator+=(uint64_t Value_) {
     if (Value != OverflowValue) {
       if (Value < OverflowValue - Value_)
@@ -112,6 +114,28 @@ struct PerFunctionStats {
   uint64_t NumLocalVarTypes = 0;
   /// Number of local variables with DW_AT_location.
   uint64_t NumLocalVarLocations = 0;
+
+  /// Add the statistics of other instances of this function.
+  void merge(const PerFunctionStats &Other) {
+    NumFnInlined += Other.NumFnInlined;
+    NumFnOutOfLine += Other.NumFnOutOfLine;
+    NumAbstractOrigins += Other.NumAbstractOrigins;
+    TotalVarWithLoc += Other.TotalVarWithLoc;
+    ConstantMembers += Other.ConstantMembers;
+    NumArtificial += Other.NumArtificial;
+    for (const auto &Var : Other.VarsInFunction)
+      VarsInFunction.insert(Var.getKey());
+    IsFunction |= Other.IsFunction;
+    HasSourceLocation |= Other.HasSourceLocation;
+    NumParams += Other.NumParams;
+    NumParamSourceLocations += Other.NumParamSourceLocations;
+    NumParamTypes += Other.NumParamTypes;
+    NumParamLocations += Other.NumParamLocations;
+    NumLocalVars += Other.NumLocalVars;
+    NumLocalVarSourceLocations += Other.NumLocalVarSourceLocations;
+    NumLocalVarTypes += Other.NumLocalVarTypes;
+    NumLocalVarLocations += Other.NumLocalVarLocations;
+  }
 };
 
 /// Holds accumulated global statistics about DIEs.
@@ -154,6 +178,25 @@ struct GlobalStats {
   /// for the top inline functions within concrete functions. This can help
   /// tune the inline settings when compiling to match user expectations.
   SaturatingUINT64 InlineFunctionSize = 0;
+
+  void merge(const GlobalStats &Other) {
+    TotalBytesCovered += Other.TotalBytesCovered;
+    ScopeBytesCovered += Other.ScopeBytesCovered;
+    ScopeBytes += Other.ScopeBytes;
+    ScopeEntryValueBytesCovered += Other.ScopeEntryValueBytesCovered;
+    ParamScopeBytesCovered += Other.ParamScopeBytesCovered;
+    ParamScopeBytes += Other.ParamScopeBytes;
+    ParamScopeEntryValueBytesCovered += Other.ParamScopeEntryValueBytesCovered;
+    LocalVarScopeBytesCovered += Other.LocalVarScopeBytesCovered;
+    LocalVarScopeBytes += Other.LocalVarScopeBytes;
+    LocalVarScopeEntryValueBytesCovered +=
+        Other.LocalVarScopeEntryValueBytesCovered;
+    CallSiteEntries += Other.CallSiteEntries;
+    CallSiteDIEs += Other.CallSiteDIEs;
+    CallSiteParamDIEs += Other.CallSiteParamDIEs;
+    FunctionSize += Other.FunctionSize;
+    InlineFunctionSize += Other.InlineFunctionSize;
+  }
 };
 
 /// Holds accumulated debug location statistics about local variables and
@@ -187,6 +230,40 @@ struct LocationStats {
   SaturatingUINT64 NumParam = 0;
   /// Total number of local variables processed.
   SaturatingUINT64 NumVar = 0;
+
+  void merge(const LocationStats &Other) {
+    auto MergeBuckets = [](std::vector<SaturatingUINT64> &Buckets,
+                           const std::vector<SaturatingUINT64> &OtherBuckets) {
+      for (size_t I = 0, E = Buckets.size(); I != E; ++I)
+        Buckets[I] += OtherBuckets[I];
+    };
+    MergeBuckets(VarParamLocStats, Other.VarParamLocStats);
+    MergeBuckets(VarParamNonEntryValLocStats,
+                 Other.VarParamNonEntryValLocStats);
+    MergeBuckets(ParamLocStats, Other.ParamLocStats);
+    MergeBuckets(ParamNonEntryValLocStats, Other.ParamNonEntryValLocStats);
+    MergeBuckets(LocalVarLocStats, Other.LocalVarLocStats);
+    MergeBuckets(LocalVarNonEntryValLocStats,
+                 Other.LocalVarNonEntryValLocStats);
+    NumVarParam += Other.NumVarParam;
+    NumParam += Other.NumParam;
+    NumVar += Other.NumVar;
+  }
+};
+
+/// Holds the statistics collected from one compile unit. The units can be
+/// processed independently, in parallel, and their statistics merged in order
+/// afterwards.
+struct UnitStats {
+  StringMap<PerFunctionStats> FnStatMap;
+  GlobalStats Globals;
+  LocationStats LocStats;
+  /// Variables of the functions with DW_AT_inline of this unit.
+  AbstractOriginVarsTyMap AbstractOriginFnInfo;
+  /// The unit of the functions with DW_AT_inline of this unit.
+  FunctionDIECUTyMap AbstractOriginFnCUs;
+  /// DIEs referencing an abstract origin that is not in this unit.
+  CrossCUReferencingDIELocationTy CrossCUReferences;
 };
 } // namespace
 
@@ -833,6 +910,35 @@ static void collectZeroLocCovForVarsWithCrossCUReferencingAbstractOrigin(
 
 /// \}
 
+/// Collect debug info quality metrics for one compile unit.
+static void collectStatsForUnit(DWARFUnit &CU, UnitStats &Unit) {
+  DWARFDie CUDie = CU.getNonSkeletonUnitDIE(false);
+  if (!CUDie)
+    return;
+  // This variable holds variable information for functions with
+  // abstract_origin, but just for the current CU.
+  AbstractOriginVarsTyMap LocalAbstractOriginFnInfo;
+  FunctionsWithAbstractOriginTy FnsWithAbstractOriginToBeProcessed;
+
+  collectStatsRecursive(CUDie, "/", "g", 0, 0, Unit.FnStatMap, Unit.Globals,
+                        Unit.LocStats, Unit.AbstractOriginFnCUs,
+                        Unit.AbstractOriginFnInfo, LocalAbstractOriginFnInfo,
+                        FnsWithAbstractOriginToBeProcessed);
+
+  // collectZeroLocCovForVarsWithAbstractOrigin will filter out all
+  // out-of-order DWARF functions that have been processed within it,
+  // leaving FnsWithAbstractOriginToBeProcessed with only CrossCU
+  // references.
+  collectZeroLocCovForVarsWithAbstractOrigin(
+      CUDie.getDwarfUnit(), Unit.Globals, Unit.LocStats,
+      LocalAbstractOriginFnInfo, FnsWithAbstractOriginToBeProcessed);
+
+  // Collect all CrossCU references into CrossCUReferences.
+  for (auto CrossCUReferencingDIEOffset : FnsWithAbstractOriginToBeProcessed)
+    Unit.CrossCUReferences.push_back(
+        DIELocation(CUDie.getDwarfUnit(), CrossCUReferencingDIEOffset));
+}
+
 /// Collect debug info quality metrics for an entire DIContext.
 ///
 /// Do the impossible and reduce the quality of the debug info down to a few
@@ -843,7 +949,8 @@ static void collectZeroLocCovForVarsWithCrossCUReferencingAbstractOrigin(
 /// compilers is.
 bool dwarfdump::collectStatsForObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
                                           const Twine &Filename,
-                                          raw_ostream &OS) {
+                                          raw_ostream &OS,
+                                          unsigned NumThreads) {
   StringRef FormatName = Obj.getFileFormatName();
   GlobalStats GlobalStats;
   LocationStats LocStats;
@@ -855,32 +962,48 @@ bool dwarfdump::collectStatsForObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
   // abstract_origin.
   FunctionDIECUTyMap AbstractOriginFnCUs;
   CrossCUReferencingDIELocationTy CrossCUReferencesToBeResolved;
-  for (const auto &CU : static_cast<DWARFContext *>(&DICtx)->compile_units()) {
-    if (DWARFDie CUDie = CU->getNonSkeletonUnitDIE(false)) {
-      // This variable holds variable information for functions with
-      // abstract_origin, but just for the current CU.
-      AbstractOriginVarsTyMap LocalAbstractOriginFnInfo;
-      FunctionsWithAbstractOriginTy FnsWithAbstractOriginToBeProcessed;
-
-      collectStatsRecursive(
-          CUDie, "/", "g", 0, 0, Statistics, GlobalStats, LocStats,
-          AbstractOriginFnCUs, GlobalAbstractOriginFnInfo,
-          LocalAbstractOriginFnInfo, FnsWithAbstractOriginToBeProcessed);
-
-      // collectZeroLocCovForVarsWithAbstractOrigin will filter out all
-      // out-of-order DWARF functions that have been processed within it,
-      // leaving FnsWithAbstractOriginToBeProcessed with only CrossCU
-      // references.
-      collectZeroLocCovForVarsWithAbstractOrigin(
-          CUDie.getDwarfUnit(), GlobalStats, LocStats,
-          LocalAbstractOriginFnInfo, FnsWithAbstractOriginToBeProcessed);
-
-      // Collect all CrossCU references into CrossCUReferencesToBeResolved.
-      for (auto CrossCUReferencingDIEOffset :
-           FnsWithAbstractOriginToBeProcessed)
-        CrossCUReferencesToBeResolved.push_back(
-            DIELocation(CUDie.getDwarfUnit(), CrossCUReferencingDIEOffset));
+  auto MergeUnitStats = [&](UnitStats &Unit) {
+    for (auto &Entry : Unit.FnStatMap)
+      Statistics[Entry.getKey()].merge(Entry.getValue());
+    GlobalStats.merge(Unit.Globals);
+    LocStats.merge(Unit.LocStats);
+    for (auto &Entry : Unit.AbstractOriginFnInfo)
+      llvm::append_range(GlobalAbstractOriginFnInfo[Entry.first],
+                         Entry.second);
+    for (auto &Entry : Unit.AbstractOriginFnCUs)
+      AbstractOriginFnCUs[Entry.first] = Entry.second;
+    llvm::append_range(CrossCUReferencesToBeResolved, Unit.CrossCUReferences);
+    Unit = UnitStats();
+  };
+
+  std::vector<DWARFUnit *> CUs;
+  for (const auto &CU : static_cast<DWARFContext *>(&DICtx)->compile_units())
+    CUs.push_back(CU.get());
+  ThreadPoolStrategy S = hardware_concurrency(NumThreads);
+  if (S.compute_thread_count() == 1 || CUs.size() < 2) {
+    UnitStats Unit;
+    for (DWARFUnit *CU : CUs) {
+      collectStatsForUnit(*CU, Unit);
+      MergeUnitStats(Unit);
     }
+  } else {
+    // Parse the units, their split DWARF units and their line tables
+    // beforehand, so that the units can then be walked in parallel without
+    // modifying the context. References to DIEs of other units only read
+    // them.
+    for (DWARFUnit *CU : CUs)
+      if (DWARFDie CUDie = CU->getNonSkeletonUnitDIE(false)) {
+        DWARFUnit *U = CUDie.getDwarfUnit();
+        U->getContext().getLineTableForUnit(U);
+      }
+
+    std::vector<UnitStats> Units(CUs.size());
+    ThreadPool Pool(S);
+    for (size_t I = 0, E = CUs.size(); I != E; ++I)
+      Pool.async([&, I] { collectStatsForUnit(*CUs[I], Units[I]); });
+    Pool.wait();
+    for (UnitStats &Unit : Units)
+      MergeUnitStats(Unit);
   }
 
   /// Resolve CrossCU references.
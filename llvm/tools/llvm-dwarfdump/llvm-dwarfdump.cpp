@@ -251,6 +251,17 @@ static opt<bool> Verify("verify", desc("Verify the DWARF debug info."),
                         cat(DwarfDumpCategory));
 static opt<bool> Quiet("quiet", desc("Use with -verify to not emit to STDOUT."),
                        cat(DwarfDumpCategory));
+static opt<unsigned>
+    NumThreads("num-threads",
+               desc("Use with -verify or --statistics to process units on "
+                    "<n> threads (default: 1, 0 for one thread per hardware "
+                    "thread)."),
+               value_desc("n"), init(1), cat(DwarfDumpCategory));
+static opt<unsigned> VerifyNamesSampleRate(
+    "verify-debug-names-sample-rate",
+    desc("Use with -verify to only check that one in <n> DIEs of each unit "
+         "is in .debug_names."),
+    value_desc("n"), init(1), cat(DwarfDumpCategory));
 static opt<bool> DumpUUID("uuid", desc("Show the UUID for each architecture."),
                           cat(DwarfDumpCategory));
 static alias DumpUUIDAlias("u", desc("Alias for --uuid."), aliasopt(DumpUUID),
@@ -299,6 +310,8 @@ static DIDumpOptions getDumpOpts(DWARFContext &C) {
   // In -verify mode, print DIEs without children in error messages.
   if (Verify) {
     DumpOpts.Verbose = true;
+    DumpOpts.VerifyNumThreads = NumThreads;
+    DumpOpts.VerifyNameIndexSampleRate = VerifyNamesSampleRate;
     return DumpOpts.noImplicitRecursion();
   }
   return DumpOpts;
@@ -674,8 +687,12 @@ int main(int argc, char **argv) {
     for (auto Object : Objects)
       Success &= handleFile(Object, verifyObjectFile, OutputFile.os());
   } else if (Statistics) {
+    auto CollectStats = [](ObjectFile &Obj, DWARFContext &DICtx,
+                           const Twine &Filename, raw_ostream &OS) {
+      return collectStatsForObjectFile(Obj, DICtx, Filename, OS, NumThreads);
+    };
     for (auto Object : Objects)
-      Success &= handleFile(Object, collectStatsForObjectFile, OutputFile.os());
+      Success &= handleFile(Object, CollectStats, OutputFile.os());
   } else if (ShowSectionSizes) {
     for (auto Object : Objects)
       Success &= handleFile(Object, collectObjectSectionSizes, OutputFile.os());
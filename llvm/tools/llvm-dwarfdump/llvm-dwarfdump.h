@@ -34,8 +34,11 @@ struct SectionSizes {
 void calculateSectionSizes(const object::ObjectFile &Obj, SectionSizes &Sizes,
                            const Twine &Filename);
 
+/// Collect the statistics of the compile units on \p NumThreads threads, or one
+/// thread per hardware thread if it is 0.
 bool collectStatsForObjectFile(object::ObjectFile &Obj, DWARFContext &DICtx,
-                               const Twine &Filename, raw_ostream &OS);
+                               const Twine &Filename, raw_ostream &OS,
+                               unsigned NumThreads = 1);
 bool collectObjectSectionSizes(object::ObjectFile &Obj, DWARFContext &DICtx,
                                const Twine &Filename, raw_ostream &OS);
 
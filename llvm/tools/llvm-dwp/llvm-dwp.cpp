@@ -50,6 +50,12 @@ static cl::opt<std::string> OutputFilename(cl::Required, "o",
                                            cl::value_desc("filename"),
                                            cl::cat(DwpCategory));
 
+static cl::opt<unsigned>
+    NumThreads("num-threads",
+               cl::desc("Number of threads reading the input files (default: "
+                        "one per hardware thread)"),
+               cl::init(0), cl::cat(DwpCategory));
+
 static Expected<SmallVector<std::string, 16>>
 getDWOFilenames(StringRef ExecFilename) {
   auto ErrOrObj = object::ObjectFile::createObjectFile(ExecFilename);
@@ -191,7 +197,7 @@ int main(int argc, char **argv) {
   if (!MS)
     return error("no object streamer for target " + TripleName, Context);
 
-  if (auto Err = write(*MS, DWOFilenames)) {
+  if (auto Err = write(*MS, DWOFilenames, hardware_concurrency(NumThreads))) {
     logAllUnhandledErrors(std::move(Err), WithColor::error());
     return 1;
   }
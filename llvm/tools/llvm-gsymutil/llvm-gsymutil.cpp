@@ -308,6 +308,7 @@ static llvm::Error handleObjectFile(ObjectFile &Obj,
     return Err;
 
   // Save the GSYM file to disk.
+  Gsym.setNumThreads(ThreadCount);
   support::endianness Endian =
       Obj.makeTriple().isLittleEndian() ? support::little : support::big;
   if (auto Err = Gsym.save(OutFile, Endian))
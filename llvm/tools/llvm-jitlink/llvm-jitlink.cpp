@@ -44,6 +44,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/TargetSelect.h"
@@ -215,10 +216,22 @@ static cl::opt<std::string> OutOfProcessExecutorConnect(
     cl::desc("Connect to an out-of-process executor via TCP"),
     cl::cat(JITLinkCategory));
 
+static cl::opt<bool> UseSharedMemory(
+    "use-shared-memory",
+    cl::desc("Allocate JIT'd code in memory shared with the out-of-process "
+             "executor (the executor must run on the same host)"),
+    cl::init(false), cl::cat(JITLinkCategory));
+
 static cl::opt<std::string>
     OrcRuntime("orc-runtime", cl::desc("Use ORC runtime from given path"),
                cl::init(""), cl::cat(JITLinkCategory));
 
+static cl::opt<unsigned> NumThreads(
+    "num-threads",
+    cl::desc("Number of threads to apply fixups with (0 = all hardware "
+             "threads, default = 1: apply fixups on the linking thread)"),
+    cl::init(1), cl::cat(JITLinkCategory));
+
 static cl::opt<bool> AddSelfRelocations(
     "add-self-relocations",
     cl::desc("Add relocations to function pointers to the current function"),
@@ -773,6 +786,15 @@ static Error loadDylibs(Session &S) {
   return Error::success();
 }
 
+#if LLVM_ON_UNIX && LLVM_ENABLE_THREADS
+static SimpleRemoteEPC::Setup getEPCSetup() {
+  SimpleRemoteEPC::Setup S;
+  if (UseSharedMemory)
+    S.CreateMemoryManager = SimpleRemoteEPC::createSharedMemoryManager;
+  return S;
+}
+#endif
+
 static Expected<std::unique_ptr<ExecutorProcessControl>> launchExecutor() {
 #ifndef LLVM_ON_UNIX
   // FIXME: Add support for Windows.
@@ -840,8 +862,8 @@ static Expected<std::unique_ptr<ExecutorProcessControl>> launchExecutor() {
   close(FromExecutor[WriteEnd]);
 
   return SimpleRemoteEPC::Create<FDSimpleRemoteEPCTransport>(
-      std::make_unique<DynamicThreadPoolTaskDispatcher>(),
-      SimpleRemoteEPC::Setup(), FromExecutor[ReadEnd], ToExecutor[WriteEnd]);
+      std::make_unique<DynamicThreadPoolTaskDispatcher>(), getEPCSetup(),
+      FromExecutor[ReadEnd], ToExecutor[WriteEnd]);
 #endif
 }
 
@@ -926,8 +948,8 @@ static Expected<std::unique_ptr<ExecutorProcessControl>> connectToExecutor() {
     return SockFD.takeError();
 
   return SimpleRemoteEPC::Create<FDSimpleRemoteEPCTransport>(
-      std::make_unique<DynamicThreadPoolTaskDispatcher>(),
-      SimpleRemoteEPC::Setup(), *SockFD, *SockFD);
+      std::make_unique<DynamicThreadPoolTaskDispatcher>(), getEPCSetup(),
+      *SockFD, *SockFD);
 #endif
 }
 
@@ -1116,6 +1138,8 @@ void Session::modifyPassConfig(const Triple &TT,
       return Error::success();
     });
 
+  PassConfig.ConcurrentFixups = NumThreads != 1;
+
   PassConfig.PrePrunePasses.push_back(
       [this](LinkGraph &G) { return applyHarnessPromotions(*this, G); });
 
@@ -1303,6 +1327,14 @@ static Error sanitizeArguments(const Triple &TT, const char *ArgV0) {
             OutOfProcessExecutorConnect.ArgStr + " can be specified",
         inconvertibleErrorCode());
 
+  if (UseSharedMemory && !OutOfProcessExecutor.getNumOccurrences() &&
+      !OutOfProcessExecutorConnect.getNumOccurrences())
+    return make_error<StringError>(
+        "-" + UseSharedMemory.ArgStr + " requires -" +
+            OutOfProcessExecutor.ArgStr + " or -" +
+            OutOfProcessExecutorConnect.ArgStr,
+        inconvertibleErrorCode());
+
   // If -oop-executor was used but no value was specified then use a sensible
   // default.
   if (!!OutOfProcessExecutor.getNumOccurrences() &&
@@ -1943,6 +1975,9 @@ int main(int argc, char *argv[]) {
   cl::ParseCommandLineOptions(argc, argv, "llvm jitlink tool");
   ExitOnErr.setBanner(std::string(argv[0]) + ": ");
 
+  if (NumThreads != 1)
+    parallel::strategy = hardware_concurrency(NumThreads);
+
   /// If timers are enabled, create a JITLinkTimers instance.
   std::unique_ptr<JITLinkTimers> Timers =
       ShowTimes ? std::make_unique<JITLinkTimers>() : nullptr;
@@ -27,6 +27,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ModuleSummaryIndex.h"
+#include "llvm/IR/ModuleSummaryTable.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/LTO/legacy/LTOCodeGenerator.h"
@@ -154,6 +155,12 @@ static cl::opt<std::string> ThinLTOModuleId(
              "match what is in the index."),
     cl::cat(LTOCategory));
 
+static cl::opt<std::string> ThinLTOSummaryTable(
+    "thinlto-summary-table",
+    cl::desc("With -thinlto-action=thinlink, also write the summaries of the "
+             "combined index to this file as a module summary table"),
+    cl::cat(LTOCategory));
+
 static cl::opt<std::string> ThinLTOCacheDir("thinlto-cache-dir",
                                             cl::desc("Enable ThinLTO caching."),
                                             cl::cat(LTOCategory));
@@ -661,6 +668,13 @@ private:
     raw_fd_ostream OS(OutputFilename, EC, sys::fs::OpenFlags::OF_None);
     error(EC, "error opening the file '" + OutputFilename + "'");
     writeIndexToFile(*CombinedIndex, OS);
+
+    if (!ThinLTOSummaryTable.empty()) {
+      raw_fd_ostream TableOS(ThinLTOSummaryTable, EC,
+                             sys::fs::OpenFlags::OF_None);
+      error(EC, "error opening the file '" + ThinLTOSummaryTable + "'");
+      writeModuleSummaryTable(*CombinedIndex, TableOS);
+    }
   }
 
   /// Load the combined index from disk, then compute and generate
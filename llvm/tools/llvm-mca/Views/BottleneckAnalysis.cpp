@@ -640,5 +640,29 @@ void BottleneckAnalysis::printView(raw_ostream &OS) const {
   printCriticalSequence(OS);
 }
 
+json::Value BottleneckAnalysis::toJSON() const {
+  json::Array Resources;
+  if (BPI.PressureIncreaseCycles) {
+    ArrayRef<unsigned> Distribution = Tracker.getResourcePressureDistribution();
+    const MCSchedModel &SM = getSubTargetInfo().getSchedModel();
+    for (unsigned I = 0, E = Distribution.size(); I < E; ++I) {
+      if (!Distribution[I])
+        continue;
+      const MCProcResourceDesc &PRDesc = *SM.getProcResource(I);
+      Resources.push_back(
+          json::Object({{"Name", PRDesc.Name}, {"Cycles", Distribution[I]}}));
+    }
+  }
+
+  json::Object JO({{"TotalCycles", TotalCycles},
+                   {"PressureIncreaseCycles", BPI.PressureIncreaseCycles},
+                   {"ResourcePressureCycles", BPI.ResourcePressureCycles},
+                   {"ResourcePressure", std::move(Resources)},
+                   {"DataDependencyCycles", BPI.DataDependencyCycles},
+                   {"RegisterDependencyCycles", BPI.RegisterDependencyCycles},
+                   {"MemoryDependencyCycles", BPI.MemoryDependencyCycles}});
+  return JO;
+}
+
 } // namespace mca.
 } // namespace llvm
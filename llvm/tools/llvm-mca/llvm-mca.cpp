@@ -58,6 +58,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 
@@ -230,6 +231,13 @@ static cl::opt<bool> DisableCustomBehaviour(
         "Disable custom behaviour (use the default class which does nothing)."),
     cl::cat(ViewOptions), cl::init(false));
 
+static cl::opt<unsigned>
+    NumThreads("j",
+               cl::desc("Number of threads used to simulate code regions "
+                        "(0 = all available). Regions are still reported in "
+                        "order"),
+               cl::cat(ToolOptions), cl::init(1));
+
 namespace {
 
 const Target *getTarget(const char *ProgName) {
@@ -295,15 +303,38 @@ static void processViewOptions(bool IsOutOfOrder) {
     processOptionImpl(PrintRetireStats, Default);
 }
 
-// Returns true on success.
-static bool runPipeline(mca::Pipeline &P) {
+namespace {
+/// The state of the analysis of one code region. It is kept alive from the
+/// simulation until the region is reported, as the views refer to it.
+struct RegionAnalysis {
+  const mca::CodeRegion *Region;
+  unsigned RegionIdx;
+
+  std::unique_ptr<mca::InstrBuilder> IB;
+  // Controls ownership of the pipeline hardware.
+  std::unique_ptr<mca::Context> MCA;
+  std::unique_ptr<mca::CodeEmitter> CE;
+  SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
+  std::unique_ptr<mca::SourceMgr> S;
+  std::unique_ptr<mca::CustomBehaviour> CB;
+  std::unique_ptr<mca::Pipeline> P;
+  std::unique_ptr<mca::PipelinePrinter> Printer;
+
+  // The error that stopped the analysis, if any, and the instruction that
+  // could not be lowered.
+  std::string Error;
+  Optional<MCInst> ErrorInst;
+
+  RegionAnalysis(const mca::CodeRegion &Region, unsigned RegionIdx)
+      : Region(&Region), RegionIdx(RegionIdx) {}
+};
+} // end of anonymous namespace
+
+static void runPipeline(RegionAnalysis &RA) {
   // Handle pipeline errors here.
-  Expected<unsigned> Cycles = P.run();
-  if (!Cycles) {
-    WithColor::error() << toString(Cycles.takeError());
-    return false;
-  }
-  return true;
+  Expected<unsigned> Cycles = RA.P->run();
+  if (!Cycles)
+    RA.Error = toString(Cycles.takeError());
 }
 
 int main(int argc, char **argv) {
@@ -465,19 +496,10 @@ int main(int argc, char **argv) {
 
   const MCSchedModel &SM = STI->getSchedModel();
 
-  // Create an instruction builder.
-  mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get());
-
-  // Create a context to control ownership of the pipeline hardware.
-  mca::Context MCA(*MRI, *STI);
-
   mca::PipelineOptions PO(MicroOpQueue, DecoderThroughput, DispatchWidth,
                           RegisterFileSize, LoadQueueSize, StoreQueueSize,
                           AssumeNoAlias, EnableBottleneckAnalysis);
 
-  // Number each region in the sequence.
-  unsigned RegionIdx = 0;
-
   std::unique_ptr<MCCodeEmitter> MCE(
       TheTarget->createMCCodeEmitter(*MCII, Ctx));
   assert(MCE && "Unable to create code emitter!");
@@ -486,17 +508,18 @@ int main(int argc, char **argv) {
       *STI, *MRI, mc::InitMCTargetOptionsFromFlags()));
   assert(MAB && "Unable to create asm backend!");
 
-  json::Object JSONOutput;
-  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions) {
-    // Skip empty code regions.
-    if (Region->empty())
-      continue;
-
-    IB.clear();
+  // Lower the instructions of a region and simulate them. This only uses the
+  // state of the RegionAnalysis and the target description, which is never
+  // modified, so regions can be simulated on different threads. Printing and
+  // encoding instructions is left to the report below.
+  auto SimulateRegion = [&](RegionAnalysis &RA) {
+    const mca::CodeRegion &Region = *RA.Region;
+    RA.IB = std::make_unique<mca::InstrBuilder>(*STI, *MCII, *MRI, MCIA.get());
+    RA.MCA = std::make_unique<mca::Context>(*MRI, *STI);
 
     // Lower the MCInst sequence into an mca::Instruction sequence.
-    ArrayRef<MCInst> Insts = Region->getInstructions();
-    mca::CodeEmitter CE(*STI, *MAB, *MCE, Insts);
+    ArrayRef<MCInst> Insts = Region.getInstructions();
+    RA.CE = std::make_unique<mca::CodeEmitter>(*STI, *MAB, *MCE, Insts);
 
     std::unique_ptr<mca::InstrPostProcess> IPP;
     if (!DisableCustomBehaviour) {
@@ -509,42 +532,40 @@ int main(int argc, char **argv) {
       // (which does nothing).
       IPP = std::make_unique<mca::InstrPostProcess>(*STI, *MCII);
 
-    SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
     for (const MCInst &MCI : Insts) {
       Expected<std::unique_ptr<mca::Instruction>> Inst =
-          IB.createInstruction(MCI);
+          RA.IB->createInstruction(MCI);
       if (!Inst) {
         if (auto NewE = handleErrors(
                 Inst.takeError(),
-                [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
-                  std::string InstructionStr;
-                  raw_string_ostream SS(InstructionStr);
-                  WithColor::error() << IE.Message << '\n';
-                  IP->printInst(&IE.Inst, 0, "", *STI, SS);
-                  SS.flush();
-                  WithColor::note()
-                      << "instruction: " << InstructionStr << '\n';
+                [&RA](const mca::InstructionError<MCInst> &IE) {
+                  RA.Error = IE.Message + "\n";
+                  RA.ErrorInst = IE.Inst;
                 })) {
           // Default case.
-          WithColor::error() << toString(std::move(NewE));
+          RA.Error = toString(std::move(NewE));
         }
-        return 1;
+        return;
       }
 
       IPP->postProcessInstruction(Inst.get(), MCI);
 
-      LoweredSequence.emplace_back(std::move(Inst.get()));
+      RA.LoweredSequence.emplace_back(std::move(Inst.get()));
     }
 
-    mca::SourceMgr S(LoweredSequence, PrintInstructionTables ? 1 : Iterations);
+    RA.S = std::make_unique<mca::SourceMgr>(
+        RA.LoweredSequence, PrintInstructionTables ? 1 : Iterations);
+    mca::SourceMgr &S = *RA.S;
 
     if (PrintInstructionTables) {
       //  Create a pipeline, stages, and a printer.
-      auto P = std::make_unique<mca::Pipeline>();
-      P->appendStage(std::make_unique<mca::EntryStage>(S));
-      P->appendStage(std::make_unique<mca::InstructionTables>(SM));
+      RA.P = std::make_unique<mca::Pipeline>();
+      RA.P->appendStage(std::make_unique<mca::EntryStage>(S));
+      RA.P->appendStage(std::make_unique<mca::InstructionTables>(SM));
 
-      mca::PipelinePrinter Printer(*P, *Region, RegionIdx, *STI, PO);
+      RA.Printer = std::make_unique<mca::PipelinePrinter>(
+          *RA.P, Region, RA.RegionIdx, *STI, PO);
+      mca::PipelinePrinter &Printer = *RA.Printer;
       if (PrintJson) {
         Printer.addView(
             std::make_unique<mca::InstructionView>(*STI, *IP, Insts));
@@ -553,23 +574,14 @@ int main(int argc, char **argv) {
       // Create the views for this pipeline, execute, and emit a report.
       if (PrintInstructionInfoView) {
         Printer.addView(std::make_unique<mca::InstructionInfoView>(
-            *STI, *MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
+            *STI, *MCII, *RA.CE, ShowEncoding, Insts, *IP, RA.LoweredSequence,
             ShowBarriers));
       }
       Printer.addView(
           std::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
 
-      if (!runPipeline(*P))
-        return 1;
-
-      if (PrintJson) {
-        Printer.printReport(JSONOutput);
-      } else {
-        Printer.printReport(TOF->os());
-      }
-
-      ++RegionIdx;
-      continue;
+      runPipeline(RA);
+      return;
     }
 
     // Create the CustomBehaviour object for enforcing Target Specific
@@ -578,19 +590,21 @@ int main(int argc, char **argv) {
     // the source code (but it can depend on the list of
     // mca::Instruction or any objects that can be reconstructed
     // from the target information).
-    std::unique_ptr<mca::CustomBehaviour> CB;
     if (!DisableCustomBehaviour)
-      CB = std::unique_ptr<mca::CustomBehaviour>(
+      RA.CB = std::unique_ptr<mca::CustomBehaviour>(
           TheTarget->createCustomBehaviour(*STI, S, *MCII));
-    if (!CB)
+    if (!RA.CB)
       // If the target doesn't have its own CB implemented (or the -disable-cb
       // flag is set) then we use the base class (which does nothing).
-      CB = std::make_unique<mca::CustomBehaviour>(*STI, S, *MCII);
+      RA.CB = std::make_unique<mca::CustomBehaviour>(*STI, S, *MCII);
+    mca::CustomBehaviour *CB = RA.CB.get();
 
     // Create a basic pipeline simulating an out-of-order backend.
-    auto P = MCA.createDefaultPipeline(PO, S, *CB);
+    RA.P = RA.MCA->createDefaultPipeline(PO, S, *CB);
 
-    mca::PipelinePrinter Printer(*P, *Region, RegionIdx, *STI, PO);
+    RA.Printer = std::make_unique<mca::PipelinePrinter>(*RA.P, Region,
+                                                        RA.RegionIdx, *STI, PO);
+    mca::PipelinePrinter &Printer = *RA.Printer;
 
     // Targets can define their own custom Views that exist within their
     // /lib/Target/ directory so that the View can utilize their CustomBehaviour
@@ -618,19 +632,13 @@ int main(int argc, char **argv) {
       Printer.addView(
           std::make_unique<mca::SummaryView>(SM, Insts, DispatchWidth));
 
-    if (EnableBottleneckAnalysis) {
-      if (!IsOutOfOrder) {
-        WithColor::warning()
-            << "bottleneck analysis is not supported for in-order CPU '" << MCPU
-            << "'.\n";
-      }
+    if (EnableBottleneckAnalysis)
       Printer.addView(std::make_unique<mca::BottleneckAnalysis>(
           *STI, *IP, Insts, S.getNumIterations()));
-    }
 
     if (PrintInstructionInfoView)
       Printer.addView(std::make_unique<mca::InstructionInfoView>(
-          *STI, *MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
+          *STI, *MCII, *RA.CE, ShowEncoding, Insts, *IP, RA.LoweredSequence,
           ShowBarriers));
 
     // Fetch custom Views that are to be placed after the InstructionInfoView.
@@ -677,16 +685,69 @@ int main(int argc, char **argv) {
         Printer.addView(std::move(CBView));
     }
 
-    if (!runPipeline(*P))
-      return 1;
+    runPipeline(RA);
+  };
+
+  // Report the simulation of a region, or the error that stopped it. Returns
+  // true on success.
+  json::Object JSONOutput;
+  auto ReportRegion = [&](RegionAnalysis &RA) {
+    if (!RA.Error.empty()) {
+      WithColor::error() << RA.Error;
+      if (RA.ErrorInst) {
+        std::string InstructionStr;
+        raw_string_ostream SS(InstructionStr);
+        IP->printInst(&*RA.ErrorInst, 0, "", *STI, SS);
+        SS.flush();
+        WithColor::note() << "instruction: " << InstructionStr << '\n';
+      }
+      return false;
+    }
+
+    if (EnableBottleneckAnalysis && !PrintInstructionTables && !IsOutOfOrder) {
+      WithColor::warning()
+          << "bottleneck analysis is not supported for in-order CPU '" << MCPU
+          << "'.\n";
+    }
 
     if (PrintJson) {
-      Printer.printReport(JSONOutput);
+      RA.Printer->printReport(JSONOutput);
     } else {
-      Printer.printReport(TOF->os());
+      RA.Printer->printReport(TOF->os());
     }
-
-    ++RegionIdx;
+    return true;
+  };
+
+  // Number each region in the sequence, skipping empty code regions.
+  std::vector<const mca::CodeRegion *> NonEmptyRegions;
+  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions)
+    if (!Region->empty())
+      NonEmptyRegions.push_back(Region.get());
+
+  if (NumThreads == 1) {
+    // Keep only one region's simulation alive at a time.
+    for (unsigned RegionIdx = 0, E = NonEmptyRegions.size(); RegionIdx != E;
+         ++RegionIdx) {
+      RegionAnalysis RA(*NonEmptyRegions[RegionIdx], RegionIdx);
+      SimulateRegion(RA);
+      if (!ReportRegion(RA))
+        return 1;
+    }
+  } else {
+    // Simulate all regions first, then report them in order.
+    std::vector<RegionAnalysis> Analyses;
+    Analyses.reserve(NonEmptyRegions.size());
+    for (unsigned RegionIdx = 0, E = NonEmptyRegions.size(); RegionIdx != E;
+         ++RegionIdx)
+      Analyses.emplace_back(*NonEmptyRegions[RegionIdx], RegionIdx);
+
+    ThreadPool Pool(hardware_concurrency(NumThreads));
+    for (RegionAnalysis &RA : Analyses)
+      Pool.async([&SimulateRegion, &RA] { SimulateRegion(RA); });
+    Pool.wait();
+    for (RegionAnalysis &RA : Analyses)
+      if (!ReportRegion(RA))
+        return 1;
   }
 
   if (PrintJson)
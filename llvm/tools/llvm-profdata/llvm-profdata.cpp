@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -196,6 +197,36 @@ struct WeightedFile {
 };
 typedef SmallVector<WeightedFile, 5> WeightedFileVector;
 
+/// The profile the inputs are merged into as they are read, when they are read
+/// on several threads. It is sharded by function name, so that the threads can
+/// merge their records into it concurrently.
+struct MergedProfile {
+  struct Shard {
+    std::mutex Lock;
+    InstrProfWriter Writer;
+
+    Shard(bool IsSparse) : Writer(IsSparse) {}
+  };
+  SmallVector<std::unique_ptr<Shard>, 0> Shards;
+
+  MergedProfile(bool IsSparse, unsigned NumShards) {
+    for (unsigned I = 0; I < NumShards; ++I)
+      Shards.push_back(std::make_unique<Shard>(IsSparse));
+  }
+
+  size_t getShardIndex(StringRef FuncName) const {
+    return hash_value(FuncName) % Shards.size();
+  }
+
+  /// Returns the shard which also holds the profile kind and the MemProf
+  /// records.
+  Shard &getMainShard() { return *Shards[0]; }
+};
+
+/// The number of functions whose records a writer context merged into a
+/// MergedProfile buffers before moving them to it.
+static constexpr size_t MaxBufferedFunctions = 4096;
+
 /// Keep track of merged data and reported errors.
 struct WriterContext {
   std::mutex Lock;
@@ -203,6 +234,9 @@ struct WriterContext {
   std::vector<std::pair<Error, std::string>> Errors;
   std::mutex &ErrLock;
   SmallSet<instrprof_error, 4> &WriterErrorCodes;
+  /// If set, Writer only buffers the records read until they are moved to
+  /// this profile, so that its memory use is bounded.
+  MergedProfile *Dest = nullptr;
 
   WriterContext(bool IsSparse, std::mutex &ErrLock,
                 SmallSet<instrprof_error, 4> &WriterErrorCodes)
@@ -236,6 +270,55 @@ static void overlapInput(const std::string &BaseFilename,
   }
 }
 
+/// Report an error merging records into the writer of \p WC, the first time
+/// it occurs.
+static void warnMergeError(WriterContext *WC, Error E) {
+  instrprof_error IPE = InstrProfError::take(std::move(E));
+  std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
+  bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
+  if (firstTime)
+    warn(toString(make_error<InstrProfError>(IPE)));
+}
+
+/// Move the records buffered in the writer of \p WC to its destination.
+static void flushWriterContext(WriterContext *WC) {
+  StringMap<InstrProfWriter::ProfilingData> &Buffered =
+      WC->Writer.getProfileData();
+  SmallVector<SmallVector<StringMapEntry<InstrProfWriter::ProfilingData> *, 0>,
+              0>
+      ByShard(WC->Dest->Shards.size());
+  for (auto &Entry : Buffered)
+    ByShard[WC->Dest->getShardIndex(Entry.getKey())].push_back(&Entry);
+
+  for (size_t I = 0, E = ByShard.size(); I < E; ++I) {
+    if (ByShard[I].empty())
+      continue;
+    MergedProfile::Shard &Shard = *WC->Dest->Shards[I];
+    std::unique_lock<std::mutex> ShardGuard{Shard.Lock};
+    for (auto *Entry : ByShard[I]) {
+      for (auto &Func : Entry->getValue()) {
+        NamedInstrProfRecord Record;
+        static_cast<InstrProfRecord &>(Record) = std::move(Func.second);
+        Record.Name = Entry->getKey();
+        Record.Hash = Func.first;
+        Shard.Writer.addRecord(std::move(Record), [&](Error E) {
+          warnMergeError(WC, std::move(E));
+        });
+      }
+    }
+  }
+  Buffered.clear();
+}
+
+/// Update the profile kind of the profile \p WC merges into.
+static Error mergeProfileKind(WriterContext *WC, InstrProfKind Kind) {
+  if (!WC->Dest)
+    return WC->Writer.mergeProfileKind(Kind);
+  MergedProfile::Shard &Main = WC->Dest->getMainShard();
+  std::unique_lock<std::mutex> MainGuard{Main.Lock};
+  return Main.Writer.mergeProfileKind(Kind);
+}
+
 /// Load an input into a writer context.
 static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
                       const InstrProfCorrelator *Correlator,
@@ -256,7 +339,7 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
     std::unique_ptr<RawMemProfReader> Reader = std::move(ReaderOrErr.get());
     // Check if the profile types can be merged, e.g. clang frontend profiles
     // should not be merged with memprof profiles.
-    if (Error E = WC->Writer.mergeProfileKind(Reader->getProfileKind())) {
+    if (Error E = mergeProfileKind(WC, Reader->getProfileKind())) {
       consumeError(std::move(E));
       WC->Errors.emplace_back(
           make_error<StringError>(
@@ -266,9 +349,17 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
       return;
     }
 
-    // Add the records into the writer context.
+    // Add the records into the writer context, or directly into the main
+    // shard of its destination.
+    InstrProfWriter *Writer = &WC->Writer;
+    std::unique_lock<std::mutex> MainGuard;
+    if (WC->Dest) {
+      MergedProfile::Shard &Main = WC->Dest->getMainShard();
+      MainGuard = std::unique_lock<std::mutex>(Main.Lock);
+      Writer = &Main.Writer;
+    }
     for (const memprof::MemProfRecord &MR : *Reader) {
-      WC->Writer.addRecord(MR, [&](Error E) {
+      Writer->addRecord(MR, [&](Error E) {
         instrprof_error IPE = InstrProfError::take(std::move(E));
         WC->Errors.emplace_back(make_error<InstrProfError>(IPE), Filename);
       });
@@ -286,7 +377,7 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   }
 
   auto Reader = std::move(ReaderOrErr.get());
-  if (Error E = WC->Writer.mergeProfileKind(Reader->getProfileKind())) {
+  if (Error E = mergeProfileKind(WC, Reader->getProfileKind())) {
     consumeError(std::move(E));
     WC->Errors.emplace_back(
         make_error<StringError>(
@@ -314,27 +405,16 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
       handleMergeWriterError(make_error<InstrProfError>(IPE), Input.Filename,
                              FuncName, firstTime);
     });
+    if (WC->Dest && WC->Writer.getProfileData().size() >= MaxBufferedFunctions)
+      flushWriterContext(WC);
   }
+  if (WC->Dest)
+    flushWriterContext(WC);
   if (Reader->hasError())
     if (Error E = Reader->getError())
       WC->Errors.emplace_back(std::move(E), Filename);
 }
 
-/// Merge the \p Src writer context into \p Dst.
-static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
-  for (auto &ErrorPair : Src->Errors)
-    Dst->Errors.push_back(std::move(ErrorPair));
-  Src->Errors.clear();
-
-  Dst->Writer.mergeRecordsFromWriter(std::move(Src->Writer), [&](Error E) {
-    instrprof_error IPE = InstrProfError::take(std::move(E));
-    std::unique_lock<std::mutex> ErrGuard{Dst->ErrLock};
-    bool firstTime = Dst->WriterErrorCodes.insert(IPE).second;
-    if (firstTime)
-      warn(toString(make_error<InstrProfError>(IPE)));
-  });
-}
-
 static void writeInstrProfile(StringRef OutputFilename,
                               ProfileFormat OutputFormat,
                               InstrProfWriter &Writer) {
@@ -357,7 +437,9 @@ static void writeInstrProfile(StringRef OutputFilename,
 }
 
 static void mergeInstrProfile(const WeightedFileVector &Inputs,
-                              StringRef DebugInfoFilename,
+                              StringRef CorrelateFilename,
+                              InstrProfCorrelator::ProfCorrelatorKind
+                                  CorrelateKind,
                               SymbolRemapper *Remapper,
                               StringRef OutputFilename,
                               ProfileFormat OutputFormat, bool OutputSparse,
@@ -368,12 +450,12 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
     exitWithError("unknown format is specified");
 
   std::unique_ptr<InstrProfCorrelator> Correlator;
-  if (!DebugInfoFilename.empty()) {
-    if (auto Err =
-            InstrProfCorrelator::get(DebugInfoFilename).moveInto(Correlator))
-      exitWithError(std::move(Err), DebugInfoFilename);
-    if (auto Err = Correlator->correlateProfileData())
-      exitWithError(std::move(Err), DebugInfoFilename);
+  if (!CorrelateFilename.empty()) {
+    if (auto Err = InstrProfCorrelator::get(CorrelateFilename, CorrelateKind)
+                       .moveInto(Correlator))
+      exitWithError(std::move(Err), CorrelateFilename);
+    if (auto Err = Correlator->correlateProfileData(NumThreads))
+      exitWithError(std::move(Err), CorrelateFilename);
   }
 
   std::mutex ErrorLock;
@@ -383,9 +465,6 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   if (NumThreads == 0)
     NumThreads = std::min(hardware_concurrency().compute_thread_count(),
                           unsigned((Inputs.size() + 1) / 2));
-  // FIXME: There's a bug here, where setting NumThreads = Inputs.size() fails
-  // the merge_empty_profile.test because the InstrProfWriter.ProfileKind isn't
-  // merged, thus the emitted file ends up with a PF_Unknown kind.
 
   // Initialize the writer contexts.
   SmallVector<std::unique_ptr<WriterContext>, 4> Contexts;
@@ -393,11 +472,19 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
     Contexts.emplace_back(std::make_unique<WriterContext>(
         OutputSparse, ErrorLock, WriterErrorCodes));
 
+  InstrProfWriter *Writer = &Contexts[0]->Writer;
+  std::unique_ptr<MergedProfile> Merged;
   if (NumThreads == 1) {
     for (const auto &Input : Inputs)
       loadInput(Input, Remapper, Correlator.get(), ProfiledBinary,
                 Contexts[0].get());
   } else {
+    // Merge the records into a single profile as they are read, instead of
+    // into one profile per thread, to keep the memory use proportional to the
+    // size of the merged profile rather than to the number of threads.
+    Merged = std::make_unique<MergedProfile>(OutputSparse, NumThreads * 4);
+    for (std::unique_ptr<WriterContext> &WC : Contexts)
+      WC->Dest = Merged.get();
     ThreadPool Pool(hardware_concurrency(NumThreads));
 
     // Load the inputs in parallel (N/NumThreads serial steps).
@@ -409,23 +496,15 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
     }
     Pool.wait();
 
-    // Merge the writer contexts together (~ lg(NumThreads) serial steps).
-    unsigned Mid = Contexts.size() / 2;
-    unsigned End = Contexts.size();
-    assert(Mid > 0 && "Expected more than one context");
-    do {
-      for (unsigned I = 0; I < Mid; ++I)
-        Pool.async(mergeWriterContexts, Contexts[I].get(),
-                   Contexts[I + Mid].get());
-      Pool.wait();
-      if (End & 1) {
-        Pool.async(mergeWriterContexts, Contexts[0].get(),
-                   Contexts[End - 1].get());
-        Pool.wait();
-      }
-      End = Mid;
-      Mid /= 2;
-    } while (Mid > 0);
+    // The shards hold distinct functions, so gathering them into the main
+    // one only moves their records.
+    Writer = &Merged->getMainShard().Writer;
+    for (size_t I = 1, E = Merged->Shards.size(); I < E; ++I) {
+      Writer->mergeRecordsFromWriter(
+          std::move(Merged->Shards[I]->Writer),
+          [&](Error E) { warnMergeError(Contexts[0].get(), std::move(E)); });
+      Merged->Shards[I].reset();
+    }
   }
 
   // Handle deferred errors encountered during merging. If the number of errors
@@ -441,7 +520,7 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
       (NumErrors > 0 && FailMode == failIfAnyAreInvalid))
     exitWithError("no profile can be merged");
 
-  writeInstrProfile(OutputFilename, OutputFormat, Contexts[0]->Writer);
+  writeInstrProfile(OutputFilename, OutputFormat, *Writer);
 }
 
 /// The profile entry for a function in instrumentation profile.
@@ -1000,6 +1079,10 @@ static int merge_main(int argc, const char *argv[]) {
   cl::opt<std::string> DebugInfoFilename(
       "debug-info", cl::init(""),
       cl::desc("Use the provided debug info to correlate the raw profile."));
+  cl::opt<std::string> BinaryFilename(
+      "binary-file", cl::init(""),
+      cl::desc("Use the profile data sections of the provided binary, built "
+               "with -binary-correlate, to correlate the raw profile."));
   cl::opt<std::string> ProfiledBinary(
       "profiled-binary", cl::init(""),
       cl::desc("Path to binary from which the profile was collected."));
@@ -1042,10 +1125,18 @@ static int merge_main(int argc, const char *argv[]) {
     return 0;
   }
 
+  if (!DebugInfoFilename.empty() && !BinaryFilename.empty())
+    exitWithError("only one of '--" + DebugInfoFilename.ArgStr + "' and '--" +
+                  BinaryFilename.ArgStr + "' can be provided");
+
   if (ProfileKind == instr)
-    mergeInstrProfile(WeightedInputs, DebugInfoFilename, Remapper.get(),
-                      OutputFilename, OutputFormat, OutputSparse, NumThreads,
-                      FailureMode, ProfiledBinary);
+    mergeInstrProfile(
+        WeightedInputs,
+        BinaryFilename.empty() ? DebugInfoFilename : BinaryFilename,
+        BinaryFilename.empty() ? InstrProfCorrelator::DEBUG_INFO
+                               : InstrProfCorrelator::BINARY,
+        Remapper.get(), OutputFilename, OutputFormat, OutputSparse, NumThreads,
+        FailureMode, ProfiledBinary);
   else
     mergeSampleProfile(WeightedInputs, Remapper.get(), OutputFilename,
                        OutputFormat, ProfileSymbolListFile, CompressAllSections,
@@ -2061,6 +2152,77 @@ static int overlap_main(int argc, const char *argv[]) {
   return 0;
 }
 
+namespace {
+enum OrderFileFormat { OFF_ELF, OFF_MachO };
+} // namespace
+
+/// Returns the symbol of the function with the PGO name \p PGOFuncName, as
+/// the linker sees it.
+static std::string getOrderFileSymbol(StringRef PGOFuncName,
+                                      OrderFileFormat Format) {
+  // The names of local functions are prefixed with their file name and a
+  // colon. Otherwise only Objective-C methods, "-[Class selector:]", have
+  // colons in their name.
+  StringRef Name = PGOFuncName;
+  size_t ObjCStart = std::min(Name.find("-["), Name.find("+["));
+  size_t Colon = Name.take_front(ObjCStart).rfind(':');
+  if (Colon != StringRef::npos)
+    Name = Name.drop_front(Colon + 1);
+
+  // Objective-C methods are the only symbols without the Mach-O global prefix.
+  bool IsObjCMethod = Name.startswith("-[") || Name.startswith("+[");
+  if (Format == OFF_MachO && !IsObjCMethod)
+    return ("_" + Name).str();
+  return Name.str();
+}
+
+static int order_main(int argc, const char *argv[]) {
+  cl::list<std::string> InputFilenames(cl::Positional, cl::OneOrMore,
+                                       cl::desc("<raw temporal profiles...>"));
+  cl::opt<std::string> Output("output", cl::value_desc("output"), cl::init("-"),
+                              cl::desc("Output file"));
+  cl::alias OutputA("o", cl::desc("Alias for --output"), cl::aliasopt(Output));
+  cl::opt<OrderFileFormat> Format(
+      "format", cl::init(OFF_ELF), cl::desc("Format of the symbols:"),
+      cl::values(
+          clEnumValN(OFF_ELF, "elf",
+                     "ELF symbols, for --symbol-ordering-file (default)"),
+          clEnumValN(OFF_MachO, "macho", "Mach-O symbols, for -order_file")));
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "LLVM profile data order file tool\n\n"
+      "Orders the functions of temporal profiles, collected with "
+      "-pgo-temporal-instrumentation, by the time of their first call. The "
+      "output can be passed to the linker to put the functions used at "
+      "startup next to each other.\n");
+
+  std::vector<TemporalProfTraceTy> Traces;
+  for (const auto &Filename : InputFilenames) {
+    auto ReaderOrErr = InstrProfReader::create(Filename);
+    if (Error E = ReaderOrErr.takeError())
+      exitWithError(std::move(E), Filename);
+    auto Reader = std::move(ReaderOrErr.get());
+    if (!Reader->hasTemporalProfile())
+      exitWithError("profile is not a raw temporal profile", Filename,
+                    "the profile must be collected from a binary built with "
+                    "-pgo-temporal-instrumentation");
+    for (const auto &Record : *Reader)
+      (void)Record;
+    if (Reader->hasError())
+      exitWithError(Reader->getError(), Filename);
+    llvm::append_range(Traces, Reader->getTemporalProfTraces());
+  }
+
+  std::error_code EC;
+  raw_fd_ostream OS(Output.data(), EC, sys::fs::OF_TextWithCRLF);
+  if (EC)
+    exitWithErrorCode(EC, Output);
+
+  for (const auto &Name : getTemporalProfFunctionOrder(Traces))
+    OS << getOrderFileSymbol(Name, Format) << "\n";
+  return 0;
+}
+
 namespace {
 struct ValueSitesStats {
   ValueSitesStats()
@@ -2534,12 +2696,14 @@ static int showMemProfProfile(const std::string &Filename,
   return 0;
 }
 
-static int showDebugInfoCorrelation(const std::string &Filename,
-                                    bool ShowDetailedSummary,
-                                    bool ShowProfileSymbolList,
-                                    raw_fd_ostream &OS) {
+static int
+showCorrelation(const std::string &Filename,
+                InstrProfCorrelator::ProfCorrelatorKind CorrelateKind,
+                bool ShowDetailedSummary, bool ShowProfileSymbolList,
+                raw_fd_ostream &OS) {
   std::unique_ptr<InstrProfCorrelator> Correlator;
-  if (auto Err = InstrProfCorrelator::get(Filename).moveInto(Correlator))
+  if (auto Err = InstrProfCorrelator::get(Filename, CorrelateKind)
+                     .moveInto(Correlator))
     exitWithError(std::move(Err), Filename);
   if (auto Err = Correlator->correlateProfileData())
     exitWithError(std::move(Err), Filename);
@@ -2627,6 +2791,10 @@ static int show_main(int argc, const char *argv[]) {
       "debug-info", cl::init(""),
       cl::desc("Read and extract profile metadata from debug info and show "
                "the functions it found."));
+  cl::opt<std::string> BinaryFilename(
+      "binary-file", cl::init(""),
+      cl::desc("Read and extract profile metadata from the profile data "
+               "sections of a binary and show the functions it found."));
   cl::opt<bool> ShowCovered(
       "covered", cl::init(false),
       cl::desc("Show only the functions that have been executed."));
@@ -2636,10 +2804,11 @@ static int show_main(int argc, const char *argv[]) {
 
   cl::ParseCommandLineOptions(argc, argv, "LLVM profile data summary\n");
 
-  if (Filename.empty() && DebugInfoFilename.empty())
+  if (Filename.empty() && DebugInfoFilename.empty() && BinaryFilename.empty())
     exitWithError(
         "the positional argument '<profdata-file>' is required unless '--" +
-        DebugInfoFilename.ArgStr + "' is provided");
+        DebugInfoFilename.ArgStr + "' or '--" + BinaryFilename.ArgStr +
+        "' is provided");
 
   if (Filename == OutputFilename) {
     errs() << sys::path::filename(argv[0])
@@ -2656,8 +2825,11 @@ static int show_main(int argc, const char *argv[]) {
     WithColor::warning() << "-function argument ignored: showing all functions\n";
 
   if (!DebugInfoFilename.empty())
-    return showDebugInfoCorrelation(DebugInfoFilename, ShowDetailedSummary,
-                                    ShowProfileSymbolList, OS);
+    return showCorrelation(DebugInfoFilename, InstrProfCorrelator::DEBUG_INFO,
+                           ShowDetailedSummary, ShowProfileSymbolList, OS);
+  if (!BinaryFilename.empty())
+    return showCorrelation(BinaryFilename, InstrProfCorrelator::BINARY,
+                           ShowDetailedSummary, ShowProfileSymbolList, OS);
 
   if (ProfileKind == instr)
     return showInstrProfile(
@@ -2686,6 +2858,8 @@ int main(int argc, const char *argv[]) {
       func = show_main;
     else if (strcmp(argv[1], "overlap") == 0)
       func = overlap_main;
+    else if (strcmp(argv[1], "order") == 0)
+      func = order_main;
 
     if (func) {
       std::string Invocation(ProgName.str() + " " + argv[1]);
@@ -2700,7 +2874,7 @@ int main(int argc, const char *argv[]) {
              << "USAGE: " << ProgName << " <command> [args...]\n"
              << "USAGE: " << ProgName << " <command> -help\n\n"
              << "See each individual command --help for more details.\n"
-             << "Available commands: merge, show, overlap\n";
+             << "Available commands: merge, show, overlap, order\n";
       return 0;
     }
   }
@@ -2710,6 +2884,7 @@ int main(int argc, const char *argv[]) {
   else
     errs() << ProgName << ": Unknown command!\n";
 
-  errs() << "USAGE: " << ProgName << " <merge|show|overlap> [args...]\n";
+  errs() << "USAGE: " << ProgName
+         << " <merge|show|overlap|order> [args...]\n";
   return 1;
 }
@@ -10,6 +10,7 @@
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/ThreadPool.h"
 
 #define DEBUG_TYPE "perf-reader"
 
@@ -43,6 +44,17 @@ cl::opt<bool> ShowDetailedWarning("show-detailed-warning", cl::init(false),
                                   cl::ZeroOrMore,
                                   cl::desc("Show detailed warning message."));
 
+static cl::opt<unsigned>
+    NumThreads("num-threads", cl::init(1), cl::ZeroOrMore,
+               cl::desc("Number of threads used to unwind the hybrid samples "
+                        "(0 = one per hardware thread)."));
+
+static cl::opt<uint64_t> MaxUnwoundContexts(
+    "max-unwound-contexts", cl::init(0), cl::ZeroOrMore,
+    cl::desc("Bound the memory used to unwind the hybrid samples by dropping "
+             "the coldest contexts whenever a thread holds more than this "
+             "many (0 = no limit)."));
+
 extern cl::opt<std::string> PerfTraceFilename;
 extern cl::opt<bool> ShowDisassemblyOnly;
 extern cl::opt<bool> ShowSourceLocations;
@@ -474,42 +486,119 @@ static std::string getContextKeyStr(ContextKey *K,
   }
 }
 
+// Drop the coldest half of the contexts once there are more than
+// MaxUnwoundContexts, and return the number of contexts dropped.
+static uint64_t trimColdContexts(ContextSampleCounterMap &Counters) {
+  if (!MaxUnwoundContexts || Counters.size() <= MaxUnwoundContexts)
+    return 0;
+  std::vector<std::pair<uint64_t, ContextSampleCounterMap::iterator>> Contexts;
+  Contexts.reserve(Counters.size());
+  for (auto I = Counters.begin(), E = Counters.end(); I != E; ++I)
+    Contexts.emplace_back(I->second.getTotalCount(), I);
+  size_t NumKept = MaxUnwoundContexts / 2;
+  std::nth_element(
+      Contexts.begin(), Contexts.begin() + NumKept, Contexts.end(),
+      [](const auto &LHS, const auto &RHS) { return LHS.first > RHS.first; });
+  for (auto I = Contexts.begin() + NumKept, E = Contexts.end(); I != E; ++I)
+    Counters.erase(I->second);
+  return Contexts.size() - NumKept;
+}
+
 void HybridPerfReader::unwindSamples() {
   if (Binary->useFSDiscriminator())
     exitWithError("FS discriminator is not supported in CS profile.");
-  VirtualUnwinder Unwinder(&SampleCounters, Binary);
-  for (const auto &Item : AggregatedSamples) {
-    const PerfSample *Sample = Item.first.getPtr();
-    Unwinder.unwind(Sample, Item.second);
+
+  ThreadPoolStrategy S = hardware_concurrency(NumThreads);
+  size_t NumChunks = std::max<size_t>(
+      1, std::min<size_t>(S.compute_thread_count(), AggregatedSamples.size()));
+  uint64_t NumTrimmedContexts = 0;
+  std::vector<std::unique_ptr<VirtualUnwinder>> Unwinders;
+  if (NumChunks == 1) {
+    Unwinders.push_back(
+        std::make_unique<VirtualUnwinder>(&SampleCounters, Binary));
+    for (const auto &Item : AggregatedSamples) {
+      Unwinders[0]->unwind(Item.first.getPtr(), Item.second);
+      NumTrimmedContexts += trimColdContexts(SampleCounters);
+    }
+  } else {
+    std::vector<const AggregatedCounter::value_type *> Samples;
+    Samples.reserve(AggregatedSamples.size());
+    for (const auto &Item : AggregatedSamples)
+      Samples.push_back(&Item);
+
+    std::vector<ContextSampleCounterMap> ChunkCounters(NumChunks);
+    std::vector<uint64_t> ChunkTrimmedContexts(NumChunks);
+    for (size_t I = 0; I != NumChunks; ++I)
+      Unwinders.push_back(
+          std::make_unique<VirtualUnwinder>(&ChunkCounters[I], Binary));
+    ThreadPool Pool(S);
+    for (size_t I = 0; I != NumChunks; ++I)
+      Pool.async([&, I] {
+        size_t Begin = Samples.size() * I / NumChunks;
+        size_t End = Samples.size() * (I + 1) / NumChunks;
+        for (size_t J = Begin; J != End; ++J) {
+          Unwinders[I]->unwind(Samples[J]->first.getPtr(), Samples[J]->second);
+          ChunkTrimmedContexts[I] += trimColdContexts(ChunkCounters[I]);
+        }
+      });
+    Pool.wait();
+
+    // Merge the counters of the threads, releasing them as we go.
+    for (size_t I = 0; I != NumChunks; ++I) {
+      for (const auto &Item : ChunkCounters[I])
+        SampleCounters[Item.first].merge(Item.second);
+      ChunkCounters[I] = ContextSampleCounterMap();
+      NumTrimmedContexts +=
+          ChunkTrimmedContexts[I] + trimColdContexts(SampleCounters);
+    }
+  }
+
+  std::set<uint64_t> UntrackedCallsites;
+  uint64_t NumTotalBranches = 0;
+  uint64_t NumExtCallBranch = 0;
+  uint64_t NumMissingExternalFrame = 0;
+  uint64_t NumMismatchedProEpiBranch = 0;
+  uint64_t NumMismatchedExtCallBranch = 0;
+  for (const auto &Unwinder : Unwinders) {
+    UntrackedCallsites.insert(Unwinder->getUntrackedCallsites().begin(),
+                              Unwinder->getUntrackedCallsites().end());
+    NumTotalBranches += Unwinder->NumTotalBranches;
+    NumExtCallBranch += Unwinder->NumExtCallBranch;
+    NumMissingExternalFrame += Unwinder->NumMissingExternalFrame;
+    NumMismatchedProEpiBranch += Unwinder->NumMismatchedProEpiBranch;
+    NumMismatchedExtCallBranch += Unwinder->NumMismatchedExtCallBranch;
   }
 
   // Warn about untracked frames due to missing probes.
   if (ShowDetailedWarning) {
-    for (auto Address : Unwinder.getUntrackedCallsites())
+    for (auto Address : UntrackedCallsites)
       WithColor::warning() << "Profile context truncated due to missing probe "
                            << "for call instruction at "
                            << format("0x%" PRIx64, Address) << "\n";
   }
 
-  emitWarningSummary(Unwinder.getUntrackedCallsites().size(),
-                     SampleCounters.size(),
+  emitWarningSummary(UntrackedCallsites.size(), SampleCounters.size(),
                      "of profiled contexts are truncated due to missing probe "
                      "for call instruction.");
 
   emitWarningSummary(
-      Unwinder.NumMismatchedExtCallBranch, Unwinder.NumTotalBranches,
+      NumMismatchedExtCallBranch, NumTotalBranches,
       "of branches'source is a call instruction but doesn't match call frame "
       "stack, likely due to unwinding error of external frame.");
 
   emitWarningSummary(
-      Unwinder.NumMismatchedProEpiBranch, Unwinder.NumTotalBranches,
+      NumMismatchedProEpiBranch, NumTotalBranches,
       "of branches'source is a call instruction but doesn't match call frame "
       "stack, likely due to frame in prolog/epilog.");
 
-  emitWarningSummary(Unwinder.NumMissingExternalFrame,
-                     Unwinder.NumExtCallBranch,
+  emitWarningSummary(NumMissingExternalFrame, NumExtCallBranch,
                      "of artificial call branches but doesn't have an external "
                      "frame to match.");
+
+  emitWarningSummary(NumTrimmedContexts,
+                     NumTrimmedContexts + SampleCounters.size(),
+                     "of unwound contexts are dropped as cold to bound the "
+                     "memory usage (--max-unwound-contexts).");
 }
 
 bool PerfScriptReader::extractLBRStack(TraceStream &TraceIt,
@@ -408,6 +408,20 @@ struct SampleCounter {
   void recordBranchCount(uint64_t Source, uint64_t Target, uint64_t Repeat) {
     BranchCounter[{Source, Target}] += Repeat;
   }
+  void merge(const SampleCounter &Other) {
+    for (const auto &Item : Other.RangeCounter)
+      RangeCounter[Item.first] += Item.second;
+    for (const auto &Item : Other.BranchCounter)
+      BranchCounter[Item.first] += Item.second;
+  }
+  uint64_t getTotalCount() const {
+    uint64_t Total = 0;
+    for (const auto &Item : RangeCounter)
+      Total += Item.second;
+    for (const auto &Item : BranchCounter)
+      Total += Item.second;
+    return Total;
+  }
 };
 
 // Sample counter with context to support context-sensitive profile
@@ -686,7 +700,9 @@ public:
   void generateUnsymbolizedProfile() override;
 
 private:
-  // Unwind the hybrid samples after aggregration
+  // Unwind the hybrid samples after aggregration. The samples are split
+  // between the threads, which unwind them into their own counters. These are
+  // merged at the end.
   void unwindSamples();
 };
 
@@ -35,6 +35,7 @@
 #include "llvm/Transforms/IPO/SampleContextTracker.h"
 #include <list>
 #include <map>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
@@ -225,6 +226,9 @@ class ProfiledBinary {
 
   // Offset to context location map. Used to expand the context.
   std::unordered_map<uint64_t, SampleContextFrameVector> Offset2LocStackMap;
+  // Guards Offset2LocStackMap and the symbolizer, as the samples may be
+  // unwound on several threads.
+  std::mutex LocStackMutex;
 
   // Offset to instruction size map. Also used for quick offset lookup.
   std::unordered_map<uint64_t, uint64_t> Offset2InstSizeMap;
@@ -469,6 +473,9 @@ public:
 
   const SampleContextFrameVector &
   getFrameLocationStack(uint64_t Offset, bool UseProbeDiscriminator = false) {
+    // The returned reference stays valid after the lock is released, since
+    // the entries are never removed.
+    std::lock_guard<std::mutex> Lock(LocStackMutex);
     auto I = Offset2LocStackMap.emplace(Offset, SampleContextFrameVector());
     if (I.second) {
       InstructionPointer IP(this, Offset);
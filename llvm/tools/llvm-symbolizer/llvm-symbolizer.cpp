@@ -34,12 +34,26 @@
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/StringSaver.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <string>
 
+#if defined(LLVM_ON_UNIX) && LLVM_ENABLE_THREADS
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <future>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#endif
+
 using namespace llvm;
 using namespace symbolize;
 
@@ -106,16 +120,49 @@ enum class Command {
   Frame,
 };
 
-static void enableDebuginfod(LLVMSymbolizer &Symbolizer) {
-  static bool IsEnabled = false;
-  if (IsEnabled)
-    return;
-  IsEnabled = true;
-  // Look up symbols using the debuginfod client.
-  Symbolizer.addDIFetcher(std::make_unique<DebuginfodDIFetcher>());
-  // The HTTPClient must be initialized for use by the debuginfod client.
-  HTTPClient::initialize();
-}
+namespace {
+/// The symbolizers serving the requests. Each of them caches the modules
+/// whose name hashes to it, and serves one request at a time, so that
+/// requests for modules of different symbolizers can be served in parallel
+/// while each module is only loaded once.
+class SymbolizerSet {
+public:
+  SymbolizerSet(const LLVMSymbolizer::Options &Opts, unsigned NumSymbolizers) {
+    LLVMSymbolizer::Options SymbolizerOpts = Opts;
+    SymbolizerOpts.MaxCacheSize = Opts.MaxCacheSize / NumSymbolizers;
+    for (unsigned I = 0; I != NumSymbolizers; ++I)
+      Symbolizers.push_back(std::make_unique<Entry>(SymbolizerOpts));
+  }
+
+  /// Calls \p Fn with the symbolizer caching the module named \p Key.
+  void withSymbolizer(StringRef Key, function_ref<void(LLVMSymbolizer &)> Fn) {
+    Entry &E = *Symbolizers[xxHash64(Key) % Symbolizers.size()];
+    std::lock_guard<std::mutex> Lock(E.Mutex);
+    Fn(E.Symbolizer);
+  }
+
+  void enableDebuginfod() {
+    std::call_once(DebuginfodEnabled, [this] {
+      // Look up symbols using the debuginfod client.
+      for (auto &E : Symbolizers) {
+        std::lock_guard<std::mutex> Lock(E->Mutex);
+        E->Symbolizer.addDIFetcher(std::make_unique<DebuginfodDIFetcher>());
+      }
+      // The HTTPClient must be initialized for use by the debuginfod client.
+      HTTPClient::initialize();
+    });
+  }
+
+private:
+  struct Entry {
+    Entry(const LLVMSymbolizer::Options &Opts) : Symbolizer(Opts) {}
+    std::mutex Mutex;
+    LLVMSymbolizer Symbolizer;
+  };
+  std::vector<std::unique_ptr<Entry>> Symbolizers;
+  std::once_flag DebuginfodEnabled;
+};
+} // namespace
 
 static SmallVector<uint8_t> parseBuildID(StringRef Str) {
   std::string Bytes;
@@ -203,6 +250,27 @@ static bool parseCommand(StringRef BinaryName, bool IsAddr2Line,
   return !Offset.getAsInteger(IsAddr2Line ? 16 : 0, ModuleOffset);
 }
 
+// Fetches the debug binaries of all the modules named by build ID in \p Inputs
+// in parallel, instead of one at a time as their addresses are symbolized.
+static void prefetchInputDebuginfo(const opt::InputArgList &Args,
+                                   ArrayRef<uint8_t> IncomingBuildID,
+                                   bool IsAddr2Line,
+                                   ArrayRef<std::string> Inputs) {
+  SmallVector<BuildID> BuildIDs;
+  for (StringRef Input : Inputs) {
+    Command Cmd;
+    std::string ModuleName;
+    SmallVector<uint8_t> ID(IncomingBuildID.begin(), IncomingBuildID.end());
+    uint64_t Offset;
+    if (parseCommand(Args.getLastArgValue(OPT_obj_EQ), IsAddr2Line, Input, Cmd,
+                     ModuleName, ID, Offset) &&
+        !ID.empty())
+      BuildIDs.emplace_back(ID.begin(), ID.end());
+  }
+  if (!BuildIDs.empty())
+    prefetchDebuginfo(BuildIDs);
+}
+
 template <typename T>
 void executeCommand(StringRef ModuleName, const T &ModuleSpec, Command Cmd,
                     uint64_t Offset, uint64_t AdjustVMA, bool ShouldInline,
@@ -249,7 +317,7 @@ static void symbolizeInput(const opt::InputArgList &Args,
                            ArrayRef<uint8_t> IncomingBuildID,
                            uint64_t AdjustVMA, bool IsAddr2Line,
                            OutputStyle Style, StringRef InputString,
-                           LLVMSymbolizer &Symbolizer, DIPrinter &Printer) {
+                           SymbolizerSet &Symbolizers, DIPrinter &Printer) {
   Command Cmd;
   std::string ModuleName;
   SmallVector<uint8_t> BuildID(IncomingBuildID.begin(), IncomingBuildID.end());
@@ -263,13 +331,17 @@ static void symbolizeInput(const opt::InputArgList &Args,
   if (!BuildID.empty()) {
     assert(ModuleName.empty());
     if (!Args.hasArg(OPT_no_debuginfod))
-      enableDebuginfod(Symbolizer);
+      Symbolizers.enableDebuginfod();
     std::string BuildIDStr = toHex(BuildID);
-    executeCommand(BuildIDStr, BuildID, Cmd, Offset, AdjustVMA, ShouldInline,
-                   Style, Symbolizer, Printer);
+    Symbolizers.withSymbolizer(BuildIDStr, [&](LLVMSymbolizer &Symbolizer) {
+      executeCommand(BuildIDStr, BuildID, Cmd, Offset, AdjustVMA, ShouldInline,
+                     Style, Symbolizer, Printer);
+    });
   } else {
-    executeCommand(ModuleName, ModuleName, Cmd, Offset, AdjustVMA, ShouldInline,
-                   Style, Symbolizer, Printer);
+    Symbolizers.withSymbolizer(ModuleName, [&](LLVMSymbolizer &Symbolizer) {
+      executeCommand(ModuleName, ModuleName, Cmd, Offset, AdjustVMA,
+                     ShouldInline, Style, Symbolizer, Printer);
+    });
   }
 }
 
@@ -352,6 +424,153 @@ static SmallVector<uint8_t> parseBuildIDArg(const opt::InputArgList &Args,
   return BuildID;
 }
 
+static std::unique_ptr<DIPrinter> createPrinter(OutputStyle Style,
+                                                raw_ostream &OS,
+                                                raw_ostream &ES,
+                                                PrinterConfig &Config) {
+  if (Style == OutputStyle::GNU)
+    return std::make_unique<GNUPrinter>(OS, ES, Config);
+  if (Style == OutputStyle::JSON)
+    return std::make_unique<JSONPrinter>(OS, Config);
+  return std::make_unique<LLVMPrinter>(OS, ES, Config);
+}
+
+#if defined(LLVM_ON_UNIX) && LLVM_ENABLE_THREADS
+/// Symbolizes a request, printing the result to the first stream and the
+/// errors to the second one.
+using RequestHandler =
+    std::function<void(StringRef, raw_ostream &, raw_ostream &)>;
+
+static bool writeAll(int FD, StringRef Data) {
+  while (!Data.empty()) {
+    ssize_t Written = ::write(FD, Data.data(), Data.size());
+    if (Written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    Data = Data.drop_front(Written);
+  }
+  return true;
+}
+
+/// Serves the requests sent by a client on \p FD, one per line. They are
+/// symbolized in parallel on \p Pool, and their results are written back in
+/// the order of the requests.
+static void serveClient(int FD, ThreadPool &Pool, const RequestHandler &Handle,
+                        std::mutex &ErrorsMutex) {
+  std::mutex ResultsMutex;
+  std::condition_variable ResultsChanged;
+  std::deque<std::shared_future<std::string>> Results;
+  bool Done = false;
+
+  std::thread Writer([&] {
+    bool Connected = true;
+    while (true) {
+      std::shared_future<std::string> Result;
+      {
+        std::unique_lock<std::mutex> Lock(ResultsMutex);
+        ResultsChanged.wait(Lock, [&] { return Done || !Results.empty(); });
+        if (Results.empty())
+          return;
+        Result = std::move(Results.front());
+        Results.pop_front();
+      }
+      // Keep waiting for the results of a client that went away, as they
+      // refer to this frame.
+      if (Connected)
+        Connected = writeAll(FD, Result.get());
+      else
+        Result.wait();
+    }
+  });
+
+  std::string Buffer;
+  char Chunk[4096];
+  while (true) {
+    ssize_t Read = ::read(FD, Chunk, sizeof(Chunk));
+    if (Read < 0 && errno == EINTR)
+      continue;
+    if (Read <= 0)
+      break;
+    Buffer.append(Chunk, Read);
+
+    size_t Start = 0;
+    for (size_t End; (End = Buffer.find('\n', Start)) != std::string::npos;
+         Start = End + 1) {
+      std::string Line = Buffer.substr(Start, End - Start);
+      llvm::erase_value(Line, '\r');
+      std::shared_future<std::string> Result =
+          Pool.async([&Handle, &ErrorsMutex, Line = std::move(Line)] {
+            std::string Output, Errors;
+            raw_string_ostream OS(Output), ES(Errors);
+            Handle(Line, OS, ES);
+            if (!ES.str().empty()) {
+              std::lock_guard<std::mutex> Lock(ErrorsMutex);
+              errs() << Errors;
+            }
+            return std::move(OS.str());
+          });
+      {
+        std::lock_guard<std::mutex> Lock(ResultsMutex);
+        Results.push_back(std::move(Result));
+      }
+      ResultsChanged.notify_one();
+    }
+    Buffer.erase(0, Start);
+  }
+
+  {
+    std::lock_guard<std::mutex> Lock(ResultsMutex);
+    Done = true;
+  }
+  ResultsChanged.notify_one();
+  Writer.join();
+  ::close(FD);
+}
+
+/// Serves the clients connecting to the Unix domain socket at \p SocketPath
+/// until the process is killed.
+static int serve(StringRef SocketPath, unsigned NumThreads,
+                 const RequestHandler &Handle) {
+  sockaddr_un Addr{};
+  Addr.sun_family = AF_UNIX;
+  if (SocketPath.size() >= sizeof(Addr.sun_path)) {
+    errs() << "error: socket path is too long: '" << SocketPath << "'\n";
+    return EXIT_FAILURE;
+  }
+  memcpy(Addr.sun_path, SocketPath.data(), SocketPath.size());
+
+  int ListenFD = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (ListenFD < 0 ||
+      bind(ListenFD, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) < 0 ||
+      listen(ListenFD, SOMAXCONN) < 0) {
+    errs() << "error: cannot listen on '" << SocketPath
+           << "': " << std::strerror(errno) << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // Writing to a client that went away must not terminate the server.
+  signal(SIGPIPE, SIG_IGN);
+
+  ThreadPool Pool(hardware_concurrency(NumThreads));
+  std::mutex ErrorsMutex;
+  while (true) {
+    int FD = accept(ListenFD, nullptr, nullptr);
+    if (FD < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      errs() << "error: cannot accept connections on '" << SocketPath
+             << "': " << std::strerror(errno) << "\n";
+      return EXIT_FAILURE;
+    }
+    std::thread([FD, &Pool, &Handle, &ErrorsMutex] {
+      serveClient(FD, Pool, Handle, ErrorsMutex);
+    }).detach();
+  }
+}
+#endif
+
 ExitOnError ExitOnErr;
 
 int main(int argc, char **argv) {
@@ -398,6 +617,7 @@ int main(int argc, char **argv) {
   Opts.UseSymbolTable = true;
   if (Args.hasArg(OPT_cache_size_EQ))
     parseIntArg(Args, OPT_cache_size_EQ, Opts.MaxCacheSize);
+  parseIntArg(Args, OPT_dwarf_unit_cache_size_EQ, Opts.MaxDWARFUnitCacheSize);
   Config.PrintAddress = Args.hasArg(OPT_addresses);
   Config.PrintFunctions = Opts.PrintFunctions != FunctionNameKind::None;
   Config.Pretty = Args.hasArg(OPT_pretty_print);
@@ -429,24 +649,48 @@ int main(int argc, char **argv) {
   }
   SmallVector<uint8_t> BuildID = parseBuildIDArg(Args, OPT_build_id_EQ);
 
-  LLVMSymbolizer Symbolizer(Opts);
+  StringRef ListenPath = Args.getLastArgValue(OPT_listen_EQ);
+  unsigned NumThreads;
+  parseIntArg(Args, OPT_num_threads_EQ, NumThreads);
+  if (!ListenPath.empty() && Args.hasArg(OPT_INPUT)) {
+    errs() << "error: cannot specify both --listen and addresses\n";
+    return EXIT_FAILURE;
+  }
+
+  // When serving clients, the modules are spread over one symbolizer per
+  // thread, so that requests for different modules can be served in parallel.
+  SymbolizerSet Symbolizers(
+      Opts, ListenPath.empty()
+                ? 1
+                : hardware_concurrency(NumThreads).compute_thread_count());
 
   // A debuginfod lookup could succeed if a HTTP client is available and at
   // least one backing URL is configured.
   bool ShouldUseDebuginfodByDefault =
       HTTPClient::isAvailable() &&
       !ExitOnErr(getDefaultDebuginfodUrls()).empty();
-  if (Args.hasFlag(OPT_debuginfod, OPT_no_debuginfod,
-                   ShouldUseDebuginfodByDefault))
-    enableDebuginfod(Symbolizer);
+  bool UseDebuginfod = Args.hasFlag(OPT_debuginfod, OPT_no_debuginfod,
+                                    ShouldUseDebuginfodByDefault);
+  if (UseDebuginfod)
+    Symbolizers.enableDebuginfod();
+
+  if (!ListenPath.empty()) {
+#if defined(LLVM_ON_UNIX) && LLVM_ENABLE_THREADS
+    return serve(ListenPath, NumThreads,
+                 [&](StringRef Request, raw_ostream &OS, raw_ostream &ES) {
+                   std::unique_ptr<DIPrinter> Printer =
+                       createPrinter(Style, OS, ES, Config);
+                   symbolizeInput(Args, BuildID, AdjustVMA, IsAddr2Line,
+                                  Style, Request, Symbolizers, *Printer);
+                 });
+#else
+    errs() << "error: --listen is not supported on this platform\n";
+    return EXIT_FAILURE;
+#endif
+  }
 
-  std::unique_ptr<DIPrinter> Printer;
-  if (Style == OutputStyle::GNU)
-    Printer = std::make_unique<GNUPrinter>(outs(), errs(), Config);
-  else if (Style == OutputStyle::JSON)
-    Printer = std::make_unique<JSONPrinter>(outs(), Config);
-  else
-    Printer = std::make_unique<LLVMPrinter>(outs(), errs(), Config);
+  std::unique_ptr<DIPrinter> Printer =
+      createPrinter(Style, outs(), errs(), Config);
 
   std::vector<std::string> InputAddresses = Args.getAllArgValues(OPT_INPUT);
   if (InputAddresses.empty()) {
@@ -459,14 +703,16 @@ int main(int argc, char **argv) {
       llvm::erase_if(StrippedInputString,
                      [](char c) { return c == '\r' || c == '\n'; });
       symbolizeInput(Args, BuildID, AdjustVMA, IsAddr2Line, Style,
-                     StrippedInputString, Symbolizer, *Printer);
+                     StrippedInputString, Symbolizers, *Printer);
       outs().flush();
     }
   } else {
+    if (UseDebuginfod)
+      prefetchInputDebuginfo(Args, BuildID, IsAddr2Line, InputAddresses);
     Printer->listBegin();
     for (StringRef Address : InputAddresses)
       symbolizeInput(Args, BuildID, AdjustVMA, IsAddr2Line, Style, Address,
-                     Symbolizer, *Printer);
+                     Symbolizers, *Printer);
     Printer->listEnd();
   }
 
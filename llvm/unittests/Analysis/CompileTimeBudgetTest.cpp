@@ -0,0 +1,96 @@
+//===- CompileTimeBudgetTest.cpp - CompileTimeBudget unit tests -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/CompileTimeBudget.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+/// Sets -compile-time-budget for the lifetime of the object.
+class ScopedBudgetOption {
+  cl::opt<unsigned> *Opt;
+  unsigned OldValue;
+
+public:
+  ScopedBudgetOption(unsigned Value) {
+    Opt = static_cast<cl::opt<unsigned> *>(
+        cl::getRegisteredOptions()["compile-time-budget"]);
+    OldValue = *Opt;
+    *Opt = Value;
+  }
+  ~ScopedBudgetOption() { *Opt = OldValue; }
+};
+
+void countRemarks(const DiagnosticInfo &DI, void *Context) {
+  if (auto *Remark = dyn_cast<OptimizationRemarkAnalysis>(&DI))
+    if (Remark->getRemarkName() == "BudgetExhausted")
+      ++*static_cast<unsigned *>(Context);
+}
+
+Function *createFunction(Module &M, StringRef Name) {
+  LLVMContext &C = M.getContext();
+  Function *F = Function::Create(FunctionType::get(Type::getVoidTy(C), false),
+                                 Function::ExternalLinkage, Name, M);
+  ReturnInst::Create(C, BasicBlock::Create(C, "entry", F));
+  return F;
+}
+
+TEST(CompileTimeBudgetTest, DisabledByDefault) {
+  LLVMContext C;
+  Module M("CompileTimeBudgetTest", C);
+  Function *F = createFunction(M, "f");
+
+  EXPECT_FALSE(CompileTimeBudget::isEnabled());
+  CompileTimeBudget Budget("test", "units");
+  EXPECT_TRUE(Budget.consume(*F, ~0ULL));
+  EXPECT_TRUE(Budget.consume(*F, ~0ULL));
+  EXPECT_FALSE(Budget.isExhausted(*F));
+}
+
+TEST(CompileTimeBudgetTest, Exhaust) {
+  ScopedBudgetOption Option(2);
+  LLVMContext C;
+  unsigned NumRemarks = 0;
+  C.setDiagnosticHandlerCallBack(countRemarks, &NumRemarks);
+  Module M("CompileTimeBudgetTest", C);
+  Function *F = createFunction(M, "f");
+  Function *G = createFunction(M, "g");
+
+  // Small functions get the budget of a function of 1000 instructions.
+  CompileTimeBudget Budget("test", "units");
+  EXPECT_TRUE(Budget.consume(*F, 1999));
+  EXPECT_TRUE(Budget.consume(*F));
+  EXPECT_FALSE(Budget.isExhausted(*F));
+  EXPECT_EQ(NumRemarks, 0u);
+
+  EXPECT_FALSE(Budget.consume(*F));
+  EXPECT_TRUE(Budget.isExhausted(*F));
+  EXPECT_EQ(NumRemarks, 1u);
+
+  // The budget stays exhausted, and there is only one remark per function.
+  EXPECT_FALSE(Budget.consume(*F, 0));
+  EXPECT_EQ(NumRemarks, 1u);
+
+  // Another function starts with a full budget.
+  EXPECT_TRUE(Budget.consume(*G, 2000));
+  EXPECT_FALSE(Budget.isExhausted(*G));
+  EXPECT_FALSE(Budget.isExhausted(*F));
+  EXPECT_FALSE(Budget.consume(*G, 1));
+  EXPECT_EQ(NumRemarks, 2u);
+}
+
+} // end anonymous namespace
@@ -15,10 +15,12 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -255,4 +257,57 @@ TEST(BitReaderTest, MaterializeFunctionsForBlockAddrInFunctionAfter) {
   EXPECT_FALSE(verifyModule(*M, &dbgs()));
 }
 
+// Tests that module-level metadata loaded on demand from a module with lazily
+// loaded metadata matches the metadata of the original module.
+TEST(BitReaderTest, LazyLoadModuleMetadata) {
+  // Use enough metadata for the writer to emit an index.
+  std::string Assembly;
+  raw_string_ostream OS(Assembly);
+  OS << "define void @f() {\n"
+        "  ret void, !attach !0\n"
+        "}\n"
+        "define void @g() {\n"
+        "  ret void, !attach !20\n"
+        "}\n"
+        "!named = !{!0}\n";
+  const unsigned NumNodes = 100;
+  for (unsigned I = 0; I + 1 < NumNodes; ++I)
+    OS << "!" << I << " = !{!" << I + 1 << ", !\"node" << I << "\"}\n";
+  OS << "!" << NumNodes - 1 << " = !{!\"leaf\"}\n";
+
+  LLVMContext Context;
+  std::unique_ptr<Module> Original = parseAssembly(Context, OS.str().c_str());
+  std::string ExpectedIR;
+  raw_string_ostream(ExpectedIR) << *Original;
+  SmallString<1024> Mem;
+  writeModuleToBuffer(std::move(Original), Mem);
+
+  StringMap<cl::Option *> &Opts = cl::getRegisteredOptions();
+  auto *LazyLoad =
+      static_cast<cl::opt<bool> *>(Opts["lazy-load-module-metadata"]);
+  ASSERT_TRUE(LazyLoad);
+  LazyLoad->setValue(true);
+
+  LLVMContext LazyContext;
+  Expected<std::unique_ptr<Module>> ModuleOrErr =
+      getLazyBitcodeModule(MemoryBufferRef(Mem.str(), "test"), LazyContext,
+                           /*ShouldLazyLoadMetadata=*/true);
+  LazyLoad->setValue(false);
+  ASSERT_TRUE(!!ModuleOrErr);
+  std::unique_ptr<Module> M = std::move(ModuleOrErr.get());
+
+  EXPECT_FALSE(M->materializeMetadata());
+  ASSERT_TRUE(M->getNamedMetadata("named"));
+  EXPECT_EQ(1u, M->getNamedMetadata("named")->getNumOperands());
+
+  EXPECT_FALSE(M->getFunction("g")->materialize());
+  EXPECT_TRUE(M->getFunction("f")->empty());
+  EXPECT_FALSE(M->materializeAll());
+  EXPECT_FALSE(verifyModule(*M, &dbgs()));
+
+  std::string ActualIR;
+  raw_string_ostream(ActualIR) << *M;
+  EXPECT_EQ(ExpectedIR, ActualIR);
+}
+
 } // end namespace
@@ -222,4 +222,50 @@ TEST_F(AArch64GISelMITest, UnorderedArtifactCombiningManyCopiesTest) {
   EXPECT_TRUE(CheckMachineFunction(*MF, CheckString)) << *MF;
 }
 
+// A function that is already legal is left alone, but trivially dead
+// instructions are still erased even if they are legal.
+TEST_F(AArch64GISelMITest, AlreadyLegalTest) {
+  StringRef MIRString = R"(
+    %a:_(s32) = G_CONSTANT i32 1
+    %b:_(s32) = G_SHL %a:_, %a:_(s32)
+    $w4 = COPY %b:_(s32)
+  )";
+  setUp(MIRString.rtrim(' '));
+  if (!TM)
+    return;
+
+  ALegalizerInfo LI(MF->getSubtarget());
+  LostDebugLocObserver LocObserver(DEBUG_TYPE);
+
+  Legalizer::MFResult Result = Legalizer::legalizeMachineFunction(
+      *MF, LI, {&LocObserver}, LocObserver, B);
+
+  EXPECT_TRUE(isNullMIPtr(Result.FailedOn));
+  EXPECT_FALSE(Result.Changed);
+
+  StringRef CheckString = R"(
+    CHECK:      %a:_(s32) = G_CONSTANT i32 1
+    CHECK-NEXT: %b:_(s32) = G_SHL %a:_, %a:_(s32)
+    CHECK-NEXT: $w4 = COPY %b:_(s32)
+  )";
+  EXPECT_TRUE(CheckMachineFunction(*MF, CheckString)) << *MF;
+
+  // Now add a dead instruction.
+  B.setInsertPt(*EntryMBB, EntryMBB->begin());
+  B.buildAnd(LLT::scalar(32), B.buildConstant(LLT::scalar(32), 2),
+             B.buildConstant(LLT::scalar(32), 3));
+
+  Result = Legalizer::legalizeMachineFunction(*MF, LI, {&LocObserver},
+                                              LocObserver, B);
+  EXPECT_TRUE(isNullMIPtr(Result.FailedOn));
+
+  CheckString = R"(
+    CHECK-NOT:  G_AND
+    CHECK:      %a:_(s32) = G_CONSTANT i32 1
+    CHECK-NEXT: %b:_(s32) = G_SHL %a:_, %a:_(s32)
+    CHECK-NEXT: $w4 = COPY %b:_(s32)
+  )";
+  EXPECT_TRUE(CheckMachineFunction(*MF, CheckString)) << *MF;
+}
+
 } // namespace
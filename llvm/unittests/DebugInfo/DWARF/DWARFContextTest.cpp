@@ -0,0 +1,205 @@
+//===- llvm/unittest/DebugInfo/DWARFContextTest.cpp -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/DebugInfo/DWARF/DWARFCompileUnit.h"
+#include "llvm/ObjectYAML/DWARFEmitter.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::dwarf;
+
+namespace {
+
+// Two compile units, covering [0x1000, 0x1100) and [0x2000, 0x2100), with a
+// subprogram each.
+const char *TwoUnitsYAML = R"(
+  debug_abbrev:
+    - ID:              0
+      Table:
+        - Code:            0x1
+          Tag:             DW_TAG_compile_unit
+          Children:        DW_CHILDREN_yes
+          Attributes:
+            - Attribute:       DW_AT_low_pc
+              Form:            DW_FORM_addr
+            - Attribute:       DW_AT_high_pc
+              Form:            DW_FORM_data4
+        - Code:            0x2
+          Tag:             DW_TAG_subprogram
+          Children:        DW_CHILDREN_no
+          Attributes:
+            - Attribute:       DW_AT_low_pc
+              Form:            DW_FORM_addr
+            - Attribute:       DW_AT_high_pc
+              Form:            DW_FORM_data4
+  debug_info:
+    - Version:         4
+      AbbrevTableID:   0
+      AbbrOffset:      0x0
+      AddrSize:        8
+      Entries:
+        - AbbrCode:        0x1
+          Values:
+            - Value:           0x1000
+            - Value:           0x100
+        - AbbrCode:        0x2
+          Values:
+            - Value:           0x1000
+            - Value:           0x100
+        - AbbrCode:        0x0
+    - Version:         4
+      AbbrevTableID:   0
+      AbbrOffset:      0x0
+      AddrSize:        8
+      Entries:
+        - AbbrCode:        0x1
+          Values:
+            - Value:           0x2000
+            - Value:           0x100
+        - AbbrCode:        0x2
+          Values:
+            - Value:           0x2000
+            - Value:           0x100
+        - AbbrCode:        0x0
+)";
+
+TEST(DWARFContext, ParsedUnitsAreKeptWithoutLimit) {
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(TwoUnitsYAML),
+                                   /*IsLittleEndian=*/true,
+                                   /*Is64BitAddrSize=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  std::unique_ptr<DWARFContext> Ctx =
+      DWARFContext::create(*Sections, 8, /*isLittleEndian=*/true);
+
+  EXPECT_TRUE(Ctx->getDIEsForAddress(0x1010).FunctionDIE.isValid());
+  EXPECT_TRUE(Ctx->getDIEsForAddress(0x2010).FunctionDIE.isValid());
+  EXPECT_TRUE(Ctx->getDIEsForAddress(0x1020).FunctionDIE.isValid());
+
+  ASSERT_EQ(Ctx->getNumCompileUnits(), 2u);
+  for (unsigned I = 0; I != 2; ++I)
+    EXPECT_GT(Ctx->getUnitAtIndex(I)->getDIEsMemoryUsage(),
+              sizeof(DWARFDebugInfoEntry));
+}
+
+TEST(DWARFContext, ParsedUnitsMemoryLimit) {
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(TwoUnitsYAML),
+                                   /*IsLittleEndian=*/true,
+                                   /*Is64BitAddrSize=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  std::unique_ptr<DWARFContext> Ctx =
+      DWARFContext::create(*Sections, 8, /*isLittleEndian=*/true);
+  // Only allow a single unit to be parsed at any time.
+  Ctx->setParsedUnitsMemoryLimit(1);
+
+  DWARFContext::DIEsForAddress First = Ctx->getDIEsForAddress(0x1010);
+  ASSERT_TRUE(First.FunctionDIE.isValid());
+  EXPECT_EQ(First.FunctionDIE.getTag(), DW_TAG_subprogram);
+  DWARFUnit *FirstUnit = First.CompileUnit;
+  EXPECT_GT(FirstUnit->getDIEsMemoryUsage(), sizeof(DWARFDebugInfoEntry));
+
+  // Looking up an address in the second unit clears the first one, but keeps
+  // its unit DIE.
+  DWARFContext::DIEsForAddress Second = Ctx->getDIEsForAddress(0x2010);
+  ASSERT_TRUE(Second.FunctionDIE.isValid());
+  EXPECT_NE(Second.CompileUnit, FirstUnit);
+  EXPECT_EQ(FirstUnit->getDIEsMemoryUsage(), sizeof(DWARFDebugInfoEntry));
+  EXPECT_EQ(toAddress(FirstUnit->getUnitDIE().find(DW_AT_low_pc)),
+            Optional<uint64_t>(0x1000));
+
+  // The first unit is parsed again when needed, and the second one cleared.
+  First = Ctx->getDIEsForAddress(0x1020);
+  ASSERT_TRUE(First.FunctionDIE.isValid());
+  EXPECT_EQ(First.CompileUnit, FirstUnit);
+  EXPECT_EQ(toAddress(First.FunctionDIE.find(DW_AT_low_pc)),
+            Optional<uint64_t>(0x1000));
+  EXPECT_EQ(Second.CompileUnit->getDIEsMemoryUsage(),
+            sizeof(DWARFDebugInfoEntry));
+}
+
+// Two compile units, with a subprogram each whose DW_AT_type is past the end
+// of the unit.
+const char *TwoInvalidUnitsYAML = R"(
+  debug_abbrev:
+    - ID:              0
+      Table:
+        - Code:            0x1
+          Tag:             DW_TAG_compile_unit
+          Children:        DW_CHILDREN_yes
+          Attributes:
+            - Attribute:       DW_AT_name
+              Form:            DW_FORM_string
+        - Code:            0x2
+          Tag:             DW_TAG_subprogram
+          Children:        DW_CHILDREN_no
+          Attributes:
+            - Attribute:       DW_AT_type
+              Form:            DW_FORM_ref4
+  debug_info:
+    - Version:         4
+      AbbrevTableID:   0
+      AbbrOffset:      0x0
+      AddrSize:        8
+      Entries:
+        - AbbrCode:        0x1
+          Values:
+            - CStr:            first
+        - AbbrCode:        0x2
+          Values:
+            - Value:           0x1000
+        - AbbrCode:        0x0
+    - Version:         4
+      AbbrevTableID:   0
+      AbbrOffset:      0x0
+      AddrSize:        8
+      Entries:
+        - AbbrCode:        0x1
+          Values:
+            - CStr:            second
+        - AbbrCode:        0x2
+          Values:
+            - Value:           0x2000
+        - AbbrCode:        0x0
+)";
+
+TEST(DWARFContext, VerifyUnitsInParallel) {
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(TwoInvalidUnitsYAML),
+                                   /*IsLittleEndian=*/true,
+                                   /*Is64BitAddrSize=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  auto Verify = [&](unsigned NumThreads) {
+    std::unique_ptr<DWARFContext> Ctx =
+        DWARFContext::create(*Sections, 8, /*isLittleEndian=*/true);
+    DIDumpOptions DumpOpts = DIDumpOptions::getForSingleDIE();
+    DumpOpts.VerifyNumThreads = NumThreads;
+    std::string Output;
+    raw_string_ostream OS(Output);
+    EXPECT_FALSE(Ctx->verify(OS, DumpOpts));
+    return OS.str();
+  };
+
+  std::string Serial = Verify(1);
+  size_t First = Serial.find("Verifying unit: 1 / 2, \"first\"");
+  size_t FirstError = Serial.find("CU offset 0x00001000 is invalid");
+  size_t Second = Serial.find("Verifying unit: 2 / 2, \"second\"");
+  size_t SecondError = Serial.find("CU offset 0x00002000 is invalid");
+  ASSERT_NE(SecondError, std::string::npos);
+  EXPECT_LT(First, FirstError);
+  EXPECT_LT(FirstError, Second);
+  EXPECT_LT(Second, SecondError);
+
+  // The output of the units verified in parallel is printed in order.
+  EXPECT_EQ(Verify(2), Serial);
+}
+
+} // end anonymous namespace
@@ -644,4 +644,82 @@ TEST(DWARFDie, getDeclFileSpecificationAcrossCUBoundary) {
   EXPECT_EQ(DeclFile, Ref);
 }
 
+TEST(DWARFDie, findAttributesAfterFixedAndVariableSizeForms) {
+  // Both units share the abbreviation, but the offsets of the attributes after
+  // DW_AT_low_pc depend on their address size.
+  const char *yamldata = R"(
+    debug_abbrev:
+      - Table:
+          - Code:            0x00000001
+            Tag:             DW_TAG_compile_unit
+            Children:        DW_CHILDREN_no
+            Attributes:
+              - Attribute:       DW_AT_language
+                Form:            DW_FORM_data2
+              - Attribute:       DW_AT_low_pc
+                Form:            DW_FORM_addr
+              - Attribute:       DW_AT_high_pc
+                Form:            DW_FORM_data4
+              - Attribute:       DW_AT_name
+                Form:            DW_FORM_string
+              - Attribute:       DW_AT_stmt_list
+                Form:            DW_FORM_sec_offset
+              - Attribute:       DW_AT_producer
+                Form:            DW_FORM_string
+    debug_info:
+      - Version:         4
+        AbbrevTableID:   0
+        AddrSize:        4
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0004
+              - Value:           0x1000
+              - Value:           0x10
+              - CStr:            a.c
+              - Value:           0x20
+              - CStr:            first
+      - Version:         4
+        AbbrevTableID:   0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x000c
+              - Value:           0x2000
+              - Value:           0x30
+              - CStr:            bb.c
+              - Value:           0x40
+              - CStr:            second
+  )";
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(yamldata),
+                                   /*IsLittleEndian=*/true,
+                                   /*Is64BitAddrSize=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  std::unique_ptr<DWARFContext> Ctx =
+      DWARFContext::create(*Sections, 8, /*isLittleEndian=*/true);
+  ASSERT_EQ(Ctx->getNumCompileUnits(), 2u);
+
+  DWARFDie First = Ctx->getUnitAtIndex(0)->getUnitDIE();
+  ASSERT_TRUE(First.isValid());
+  EXPECT_EQ(toUnsigned(First.find(DW_AT_language)), Optional<uint64_t>(0x4));
+  EXPECT_EQ(toAddress(First.find(DW_AT_low_pc)), Optional<uint64_t>(0x1000));
+  EXPECT_EQ(toUnsigned(First.find(DW_AT_high_pc)), Optional<uint64_t>(0x10));
+  EXPECT_STREQ(toString(First.find(DW_AT_name), nullptr), "a.c");
+  EXPECT_EQ(toSectionOffset(First.find(DW_AT_stmt_list)),
+            Optional<uint64_t>(0x20));
+  EXPECT_STREQ(toString(First.find(DW_AT_producer), nullptr), "first");
+
+  DWARFDie Second = Ctx->getUnitAtIndex(1)->getUnitDIE();
+  ASSERT_TRUE(Second.isValid());
+  EXPECT_EQ(toUnsigned(Second.find(DW_AT_language)), Optional<uint64_t>(0xc));
+  EXPECT_EQ(toAddress(Second.find(DW_AT_low_pc)), Optional<uint64_t>(0x2000));
+  EXPECT_EQ(toUnsigned(Second.find(DW_AT_high_pc)), Optional<uint64_t>(0x30));
+  EXPECT_STREQ(toString(Second.find(DW_AT_name), nullptr), "bb.c");
+  EXPECT_EQ(toSectionOffset(Second.find(DW_AT_stmt_list)),
+            Optional<uint64_t>(0x40));
+  EXPECT_STREQ(toString(Second.find(DW_AT_producer), nullptr), "second");
+}
+
 } // end anonymous namespace
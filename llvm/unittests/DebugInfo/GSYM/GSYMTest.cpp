@@ -2541,3 +2541,49 @@ TEST(GSYMTest, TestGsymCreatorMultipleSymbolsWithNoSize) {
                    1, // NumAddresses
                    ArrayRef<uint8_t>(UUID));
 }
+
+TEST(GSYMTest, TestGsymCreatorParallelEncode) {
+  // Encoding the function infos on multiple threads must produce the same
+  // bytes as encoding them serially. Use enough function infos to need
+  // several slices and batches.
+  GsymCreator GC;
+  constexpr uint64_t BaseAddr = 0x1000;
+  constexpr uint32_t NumFuncs = 20000;
+  const uint32_t FileIdx = GC.insertFile("/tmp/main.cpp");
+  for (uint32_t I = 0; I < NumFuncs; ++I) {
+    const uint64_t FuncAddr = BaseAddr + I * 0x20;
+    FunctionInfo FI(FuncAddr, 0x20,
+                    GC.insertString("func" + std::to_string(I)));
+    FI.OptLineTable = LineTable();
+    for (uint64_t Line = 0; Line < I % 4 + 1; ++Line)
+      FI.OptLineTable->push(
+          LineEntry(FuncAddr + Line * 8, FileIdx, 10 + I + Line));
+    GC.addFunctionInfo(std::move(FI));
+  }
+  ASSERT_FALSE((bool)GC.finalize(llvm::nulls()));
+
+  auto Encode = [&](unsigned NumThreads) {
+    GC.setNumThreads(NumThreads);
+    SmallString<512> Str;
+    raw_svector_ostream OutStrm(Str);
+    FileWriter FW(OutStrm, llvm::support::little);
+    llvm::Error Err = GC.encode(FW);
+    EXPECT_FALSE((bool)Err);
+    return std::string(Str.str());
+  };
+  const std::string Serial = Encode(1);
+  EXPECT_EQ(Serial, Encode(2));
+  EXPECT_EQ(Serial, Encode(3));
+  TestEncodeDecode(GC, llvm::support::big, GSYM_VERSION, 4, BaseAddr,
+                   NumFuncs, ArrayRef<uint8_t>());
+
+  // Errors are reported from the threads encoding the function infos.
+  GC.forEachFunctionInfo([&](FunctionInfo &FI) -> bool {
+    if (FI.startAddress() != BaseAddr + (NumFuncs - 1) * 0x20)
+      return true;
+    FI.Inline = InlineInfo(); // Invalid InlineInfo.
+    return false;
+  });
+  TestGsymCreatorEncodeError(llvm::support::little, GC,
+                             "attempted to encode invalid InlineInfo object");
+}
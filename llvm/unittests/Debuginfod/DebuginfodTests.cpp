@@ -48,6 +48,32 @@ TEST(DebuginfodClient, CacheHit) {
   EXPECT_THAT_EXPECTED(PathOrErr, HasValue(CachedFilePath));
 }
 
+// Check that the Debuginfod client fetches batches of artifacts, and returns
+// their results in order.
+TEST(DebuginfodClient, CacheHitsAndMisses) {
+  int FD;
+  SmallString<64> CachedFilePath;
+  sys::fs::createTemporaryFile("llvmcache-key", "temp", FD, CachedFilePath);
+  StringRef CacheDir = sys::path::parent_path(CachedFilePath);
+  StringRef UniqueKey = sys::path::filename(CachedFilePath);
+  EXPECT_TRUE(UniqueKey.consume_front("llvmcache-"));
+  raw_fd_ostream OF(FD, true, /*unbuffered=*/true);
+  OF << "contents\n";
+  OF.close();
+  std::vector<std::string> UniqueKeys = {"nonexistent-key", UniqueKey.str(),
+                                         "other-nonexistent-key"};
+  std::vector<std::string> UrlPaths(UniqueKeys.size(), "/null");
+  std::vector<Expected<std::string>> PathsOrErrs =
+      getCachedOrDownloadArtifacts(UniqueKeys, UrlPaths, CacheDir,
+                                   /*DebuginfodUrls=*/{},
+                                   /*Timeout=*/std::chrono::milliseconds(1),
+                                   hardware_concurrency(2));
+  ASSERT_EQ(PathsOrErrs.size(), 3u);
+  EXPECT_THAT_EXPECTED(PathsOrErrs[0], Failed<StringError>());
+  EXPECT_THAT_EXPECTED(PathsOrErrs[1], HasValue(std::string(CachedFilePath)));
+  EXPECT_THAT_EXPECTED(PathsOrErrs[2], Failed<StringError>());
+}
+
 // Check that the Debuginfod client returns an Error when it fails to find an
 // artifact.
 TEST(DebuginfodClient, CacheMiss) {
@@ -0,0 +1,49 @@
+//===-- llvm/unittest/Debuginfod/RemoteCacheTests.cpp - unit tests --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Debuginfod/RemoteCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using llvm::unittest::TempDir;
+
+// Without a reachable server, misses are produced locally and then hit in the
+// local cache.
+TEST(RemoteCache, FallBackToLocal) {
+  TempDir CacheDir("remote-cache-test", /*Unique=*/true);
+  std::string Added;
+  Expected<FileCache> LocalCacheOrErr = localCache(
+      "RemoteCacheTest", "Test", CacheDir.path(),
+      [&](size_t Task, std::unique_ptr<MemoryBuffer> MB) {
+        Added = MB->getBuffer().str();
+      });
+  ASSERT_THAT_EXPECTED(LocalCacheOrErr, Succeeded());
+  FileCache Cache = remoteCache("http://localhost:0", *LocalCacheOrErr,
+                                std::chrono::milliseconds(100));
+
+  Expected<AddStreamFn> AddStreamOrErr = Cache(0, "key");
+  ASSERT_THAT_EXPECTED(AddStreamOrErr, Succeeded());
+  ASSERT_TRUE(*AddStreamOrErr);
+  {
+    Expected<std::unique_ptr<CachedFileStream>> StreamOrErr =
+        (*AddStreamOrErr)(0);
+    ASSERT_THAT_EXPECTED(StreamOrErr, Succeeded());
+    *(*StreamOrErr)->OS << "contents";
+  }
+  EXPECT_EQ(Added, "contents");
+
+  Added.clear();
+  AddStreamOrErr = Cache(0, "key");
+  ASSERT_THAT_EXPECTED(AddStreamOrErr, Succeeded());
+  EXPECT_FALSE(*AddStreamOrErr);
+  EXPECT_EQ(Added, "contents");
+}
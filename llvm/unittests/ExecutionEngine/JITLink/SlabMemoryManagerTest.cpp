@@ -0,0 +1,126 @@
+//===--- SlabMemoryManagerTest.cpp - Unit tests for the slab allocator ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/SlabMemoryManager.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+
+namespace {
+
+static Expected<SimpleSegmentAlloc> allocateHello(SlabMemoryManager &MemMgr,
+                                                  uint64_t Size = 5) {
+  return SimpleSegmentAlloc::Create(
+      MemMgr, nullptr,
+      {{MemProt::Read, {static_cast<size_t>(Size), Align(1)}},
+       {MemProt::Read | MemProt::Write, {8, Align(8)}}});
+}
+
+static void writeAndFinalizeHello(SlabMemoryManager &MemMgr,
+                                  SimpleSegmentAlloc &SSA,
+                                  JITLinkMemoryManager::FinalizedAlloc &FA) {
+  StringRef Hello = "hello";
+  auto SegInfo = SSA.getSegInfo(MemProt::Read);
+  memcpy(SegInfo.WorkingMem.data(), Hello.data(), Hello.size());
+
+  auto FinalizedOrErr = SSA.finalize();
+  ASSERT_THAT_EXPECTED(FinalizedOrErr, Succeeded());
+  FA = std::move(*FinalizedOrErr);
+  EXPECT_EQ(Hello, StringRef(SegInfo.Addr.toPtr<const char *>(), Hello.size()));
+}
+
+TEST(SlabMemoryManagerTest, AllocFinalizeFree) {
+  auto MemMgr = cantFail(SlabMemoryManager::Create());
+
+  auto SSA = allocateHello(*MemMgr);
+  ASSERT_THAT_EXPECTED(SSA, Succeeded());
+  JITLinkMemoryManager::FinalizedAlloc FA;
+  writeAndFinalizeHello(*MemMgr, *SSA, FA);
+
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FA)), Succeeded());
+  EXPECT_EQ(MemMgr->getNumSlabs(), 1U);
+}
+
+TEST(SlabMemoryManagerTest, RecycleRanges) {
+  auto MemMgr = cantFail(SlabMemoryManager::Create());
+
+  auto SSA1 = allocateHello(*MemMgr);
+  ASSERT_THAT_EXPECTED(SSA1, Succeeded());
+  auto SSA2 = allocateHello(*MemMgr);
+  ASSERT_THAT_EXPECTED(SSA2, Succeeded());
+
+  // Allocations are packed together.
+  uint64_t PageSize = cantFail(sys::Process::getPageSize());
+  auto Addr1 = SSA1->getSegInfo(MemProt::Read).Addr;
+  auto Addr2 = SSA2->getSegInfo(MemProt::Read).Addr;
+  EXPECT_EQ(Addr2, Addr1 + 2 * PageSize);
+
+  JITLinkMemoryManager::FinalizedAlloc FA1, FA2;
+  writeAndFinalizeHello(*MemMgr, *SSA1, FA1);
+  writeAndFinalizeHello(*MemMgr, *SSA2, FA2);
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FA1)), Succeeded());
+
+  // The range of the first allocation is reused, and zeroed again.
+  auto SSA3 = allocateHello(*MemMgr);
+  ASSERT_THAT_EXPECTED(SSA3, Succeeded());
+  auto SegInfo3 = SSA3->getSegInfo(MemProt::Read);
+  EXPECT_EQ(SegInfo3.Addr, Addr1);
+  EXPECT_EQ(SegInfo3.WorkingMem[0], 0);
+
+  JITLinkMemoryManager::FinalizedAlloc FA3;
+  writeAndFinalizeHello(*MemMgr, *SSA3, FA3);
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FA2)), Succeeded());
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FA3)), Succeeded());
+  EXPECT_EQ(MemMgr->getNumSlabs(), 1U);
+}
+
+TEST(SlabMemoryManagerTest, LargeAllocation) {
+  uint64_t PageSize = cantFail(sys::Process::getPageSize());
+  auto MemMgr = cantFail(SlabMemoryManager::Create(4 * PageSize));
+
+  // A graph that does not fit in a slab gets its own.
+  auto SSA = allocateHello(*MemMgr, 8 * PageSize);
+  ASSERT_THAT_EXPECTED(SSA, Succeeded());
+  JITLinkMemoryManager::FinalizedAlloc FA;
+  writeAndFinalizeHello(*MemMgr, *SSA, FA);
+  EXPECT_EQ(MemMgr->getNumSlabs(), 1U);
+
+  auto SSA2 = allocateHello(*MemMgr);
+  ASSERT_THAT_EXPECTED(SSA2, Succeeded());
+  JITLinkMemoryManager::FinalizedAlloc FA2;
+  writeAndFinalizeHello(*MemMgr, *SSA2, FA2);
+  EXPECT_EQ(MemMgr->getNumSlabs(), 2U);
+
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FA)), Succeeded());
+  EXPECT_THAT_ERROR(MemMgr->deallocate(std::move(FA2)), Succeeded());
+}
+
+#if defined(__linux__)
+TEST(SlabMemoryManagerTest, DualMapping) {
+  auto MemMgr = SlabMemoryManager::Create(2 * 1024 * 1024, true);
+  ASSERT_THAT_EXPECTED(MemMgr, Succeeded());
+
+  auto SSA = allocateHello(**MemMgr);
+  // Bail out if memfd_create is not available.
+  if (!SSA) {
+    consumeError(SSA.takeError());
+    return;
+  }
+  auto SegInfo = SSA->getSegInfo(MemProt::Read);
+  EXPECT_NE(SegInfo.Addr.toPtr<char *>(), SegInfo.WorkingMem.data());
+
+  JITLinkMemoryManager::FinalizedAlloc FA;
+  writeAndFinalizeHello(**MemMgr, *SSA, FA);
+  EXPECT_THAT_ERROR((*MemMgr)->deallocate(std::move(FA)), Succeeded());
+}
+#endif
+
+} // end anonymous namespace
@@ -0,0 +1,366 @@
+//===--- BytecodeInterpreterLayerTest.cpp - Unit tests for the interpreter ===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/BytecodeInterpreterLayer.h"
+#include "OrcTestCommon.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+static std::string getHostDataLayout() {
+  std::string DL = sys::IsLittleEndianHost ? "e" : "E";
+  if (sizeof(void *) == 4)
+    DL += "-p:32:32";
+  return DL;
+}
+
+class BytecodeInterpreterLayerTest : public CoreAPIsBasedStandardTest {
+protected:
+  /// Stands in for a compiling layer, and fails to materialize the modules.
+  class FallbackLayer : public IRLayer {
+  public:
+    FallbackLayer(ExecutionSession &ES,
+                  const IRSymbolMapper::ManglingOptions *&MO)
+        : IRLayer(ES, MO) {}
+
+    void emit(std::unique_ptr<MaterializationResponsibility> R,
+              ThreadSafeModule TSM) override {
+      ++NumModules;
+      R->failMaterialization();
+    }
+
+    unsigned NumModules = 0;
+  };
+
+  void addModule(StringRef Source) {
+    auto Ctx = std::make_unique<LLVMContext>();
+    SMDiagnostic Err;
+    auto M = parseAssemblyString(Source, Err, *Ctx);
+    ASSERT_TRUE(M) << Err.getMessage();
+    M->setDataLayout(getHostDataLayout());
+    cantFail(
+        Layer.add(JD, ThreadSafeModule(std::move(M), std::move(Ctx))));
+  }
+
+  template <typename T> T lookup(StringRef Name) {
+    return jitTargetAddressToPointer<T>(
+        cantFail(ES.lookup({&JD}, Name)).getAddress());
+  }
+
+  IRSymbolMapper::ManglingOptions MO;
+  const IRSymbolMapper::ManglingOptions *MOPtr = &MO;
+  FallbackLayer Fallback{ES, MOPtr};
+  BytecodeInterpreterLayer Layer{ES, Fallback};
+};
+
+TEST_F(BytecodeInterpreterLayerTest, ControlFlowAndArithmetic) {
+  addModule(R"(
+    define i64 @fib(i64 %n) {
+    entry:
+      %small = icmp slt i64 %n, 2
+      br i1 %small, label %done, label %recurse
+    recurse:
+      %n1 = sub i64 %n, 1
+      %f1 = call i64 @fib(i64 %n1)
+      %n2 = sub i64 %n, 2
+      %f2 = call i64 @fib(i64 %n2)
+      %sum = add i64 %f1, %f2
+      ret i64 %sum
+    done:
+      ret i64 %n
+    }
+
+    ; Swaps a and b in each iteration, which needs parallel phi moves.
+    define i32 @swap(i32 %n) {
+    entry:
+      br label %loop
+    loop:
+      %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+      %a = phi i32 [ 1, %entry ], [ %b, %loop ]
+      %b = phi i32 [ 2, %entry ], [ %a, %loop ]
+      %i.next = add i32 %i, 1
+      %more = icmp ult i32 %i.next, %n
+      br i1 %more, label %loop, label %exit
+    exit:
+      %a10 = mul i32 %a, 10
+      %r = add i32 %a10, %b
+      ret i32 %r
+    }
+
+    define i32 @classify(i32 %x) {
+    entry:
+      switch i32 %x, label %other [ i32 1, label %one
+                                    i32 -5, label %minus5 ]
+    one:
+      ret i32 10
+    minus5:
+      ret i32 20
+    other:
+      %d = sdiv i32 %x, -2
+      %neg = icmp slt i32 %d, 0
+      %s = select i1 %neg, i32 %d, i32 100
+      ret i32 %s
+    }
+
+    define signext i8 @negate(i8 signext %x) {
+    entry:
+      %r = sub i8 0, %x
+      ret i8 %r
+    }
+
+    ; Internal functions with floating point arguments stay in the
+    ; interpreter.
+    define internal double @scale(double %x, float %f) {
+    entry:
+      %fd = fpext float %f to double
+      %r = fmul double %x, %fd
+      ret double %r
+    }
+
+    define i32 @fp(i32 %x) {
+    entry:
+      %d = sitofp i32 %x to double
+      %s = call double @scale(double %d, float 2.5)
+      %i = fptosi double %s to i32
+      ret i32 %i
+    }
+  )");
+
+  auto Fib = lookup<int64_t (*)(int64_t)>("fib");
+  EXPECT_EQ(Fib(20), 6765);
+
+  auto Swap = lookup<int32_t (*)(int32_t)>("swap");
+  EXPECT_EQ(Swap(1), 12);
+  EXPECT_EQ(Swap(2), 21);
+  EXPECT_EQ(Swap(5), 12);
+
+  auto Classify = lookup<int32_t (*)(int32_t)>("classify");
+  EXPECT_EQ(Classify(1), 10);
+  EXPECT_EQ(Classify(-5), 20);
+  EXPECT_EQ(Classify(7), -3);
+  EXPECT_EQ(Classify(-7), 100);
+
+  auto Negate = lookup<int8_t (*)(int8_t)>("negate");
+  EXPECT_EQ(Negate(3), -3);
+  EXPECT_EQ(Negate(-128), -128);
+
+  auto FP = lookup<int32_t (*)(int32_t)>("fp");
+  EXPECT_EQ(FP(-3), -7);
+
+  EXPECT_EQ(Layer.getNumInterpretedModules(), 1U);
+  EXPECT_EQ(Layer.getNumFallbackModules(), 0U);
+}
+
+TEST_F(BytecodeInterpreterLayerTest, Memory) {
+  addModule(R"(
+    %pair = type { i8, i64 }
+
+    @table = global [4 x i32] [i32 1, i32 2, i32 3, i32 4]
+    @second = global i32* getelementptr inbounds ([4 x i32],
+                                                  [4 x i32]* @table,
+                                                  i64 0, i64 1)
+    @pair = internal global %pair { i8 1, i64 40 }
+    @counter = global i64 0
+
+    define i64 @sumTable(i64 %n) {
+    entry:
+      %buf = alloca [4 x i32], align 4
+      br label %copy
+    copy:
+      %i = phi i64 [ 0, %entry ], [ %i.next, %copy ]
+      %src = getelementptr [4 x i32], [4 x i32]* @table, i64 0, i64 %i
+      %dst = getelementptr [4 x i32], [4 x i32]* %buf, i64 0, i64 %i
+      %v = load i32, i32* %src
+      store i32 %v, i32* %dst
+      %i.next = add i64 %i, 1
+      %more = icmp ult i64 %i.next, %n
+      br i1 %more, label %copy, label %sum
+    sum:
+      %p = load i32*, i32** @second
+      %s = load i32, i32* %p
+      %last = getelementptr [4 x i32], [4 x i32]* %buf, i64 0, i64 3
+      %l = load i32, i32* %last
+      %sl = add i32 %s, %l
+      %sl64 = zext i32 %sl to i64
+      %field = getelementptr %pair, %pair* @pair, i64 0, i32 1
+      %f = load i64, i64* %field
+      %r = add i64 %sl64, %f
+      %c = load i64, i64* @counter
+      %c.next = add i64 %c, 1
+      store i64 %c.next, i64* @counter
+      ret i64 %r
+    }
+  )");
+
+  auto SumTable = lookup<int64_t (*)(int64_t)>("sumTable");
+  auto *Counter = lookup<int64_t *>("counter");
+  auto *Table = lookup<int32_t *>("table");
+  EXPECT_EQ(SumTable(4), 46);
+  EXPECT_EQ(*Counter, 1);
+
+  Table[1] = 10;
+  EXPECT_EQ(SumTable(4), 54);
+  EXPECT_EQ(*Counter, 2);
+}
+
+static int64_t twice(int64_t X) { return 2 * X; }
+
+static int64_t applyTwice(int64_t (*F)(int64_t), int64_t X) {
+  return F(F(X));
+}
+
+TEST_F(BytecodeInterpreterLayerTest, NativeCalls) {
+  cantFail(JD.define(absoluteSymbols(
+      {{ES.intern("twice"),
+        JITEvaluatedSymbol(pointerToJITTargetAddress(&twice),
+                           JITSymbolFlags::Exported)},
+       {ES.intern("applyTwice"),
+        JITEvaluatedSymbol(pointerToJITTargetAddress(&applyTwice),
+                           JITSymbolFlags::Exported)}})));
+
+  addModule(R"(
+    declare i64 @twice(i64)
+    declare i64 @applyTwice(i64 (i64)*, i64)
+    declare extern_weak void @missing()
+
+    define internal i64 @inc(i64 %x) {
+    entry:
+      %r = add i64 %x, 1
+      ret i64 %r
+    }
+
+    define i64 @test(i64 %x) {
+    entry:
+      %a = call i64 @twice(i64 %x)
+      %b = call i64 @applyTwice(i64 (i64)* @inc, i64 %a)
+      ret i64 %b
+    }
+
+    define i1 @hasMissing() {
+    entry:
+      %r = icmp ne void ()* @missing, null
+      ret i1 %r
+    }
+  )");
+
+  auto Test = lookup<int64_t (*)(int64_t)>("test");
+  EXPECT_EQ(Test(5), 12);
+
+  auto HasMissing = lookup<bool (*)()>("hasMissing");
+  EXPECT_FALSE(HasMissing());
+}
+
+TEST_F(BytecodeInterpreterLayerTest, Fallback) {
+  // Exported functions need entry points, which do not take floating point
+  // arguments.
+  addModule(R"(
+    define double @half(double %x) {
+    entry:
+      %r = fmul double %x, 0.5
+      ret double %r
+    }
+  )");
+
+  auto Sym = ES.lookup({&JD}, "half");
+  EXPECT_FALSE(!!Sym);
+  consumeError(Sym.takeError());
+  EXPECT_EQ(Fallback.NumModules, 1U);
+  EXPECT_EQ(Layer.getNumFallbackModules(), 1U);
+  EXPECT_EQ(Layer.getNumInterpretedModules(), 0U);
+}
+
+TEST(BytecodeInterpreterTieringTest, RecompileHotFunction) {
+  OrcNativeTarget::initialize();
+
+  auto J = LLJITBuilder().create();
+  // Bail out if we can not create a JIT for the host.
+  if (!J) {
+    consumeError(J.takeError());
+    return;
+  }
+  ExecutionSession &ES = (*J)->getExecutionSession();
+  const Triple &TT = (*J)->getTargetTriple();
+
+  // Bail out if we can not build a local call-through manager.
+  auto LCTMgr = createLocalLazyCallThroughManager(TT, ES, 0);
+  if (!LCTMgr) {
+    consumeError(LCTMgr.takeError());
+    return;
+  }
+
+  // The second tier makes foo return 2 instead of 1, so that the test can
+  // tell which code is called.
+  IRTransformLayer SecondTierLayer(
+      ES, (*J)->getIRCompileLayer(),
+      [&](ThreadSafeModule TSM,
+          MaterializationResponsibility &R) -> Expected<ThreadSafeModule> {
+        TSM.withModuleDo([](Module &M) {
+          if (Function *F = M.getFunction("foo.tier1"))
+            for (BasicBlock &BB : *F)
+              if (auto *Ret = dyn_cast<ReturnInst>(BB.getTerminator()))
+                Ret->setOperand(
+                    0, ConstantInt::get(Ret->getOperand(0)->getType(), 2));
+        });
+        return std::move(TSM);
+      });
+  BytecodeInterpreterLayer FirstTierLayer(ES, (*J)->getIRCompileLayer());
+  TieredCompileLayer TieredLayer(ES, FirstTierLayer, SecondTierLayer,
+                                 **LCTMgr,
+                                 createLocalIndirectStubsManagerBuilder(TT),
+                                 /*HotCallCount=*/3);
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(R"(
+    define i32 @foo() {
+    entry:
+      ret i32 1
+    }
+
+    define i32 @bar() {
+    entry:
+      %r = call i32 @foo()
+      ret i32 %r
+    }
+  )",
+                                                  Err, *Ctx);
+  ASSERT_TRUE(M) << Err.getMessage();
+  M->setDataLayout((*J)->getDataLayout());
+  cantFail(TieredLayer.add((*J)->getMainJITDylib(),
+                           ThreadSafeModule(std::move(M), std::move(Ctx))));
+
+  auto Foo = jitTargetAddressToFunction<int (*)()>(
+      cantFail((*J)->lookup("foo")).getAddress());
+  auto Bar = jitTargetAddressToFunction<int (*)()>(
+      cantFail((*J)->lookup("bar")).getAddress());
+
+  // The first tier is interpreted, and counts the calls. The third call to
+  // foo recompiles it.
+  EXPECT_EQ(Foo(), 1);
+  EXPECT_EQ(Bar(), 1);
+  EXPECT_EQ(TieredLayer.getNumRecompiledFunctions(), 0U);
+  EXPECT_EQ(Foo(), 1);
+  EXPECT_EQ(FirstTierLayer.getNumInterpretedModules(), 1U);
+  EXPECT_EQ(FirstTierLayer.getNumFallbackModules(), 0U);
+  EXPECT_EQ(TieredLayer.getNumRecompiledFunctions(), 1U);
+
+  // Both the native and the interpreted callers reach the compiled code.
+  EXPECT_EQ(Foo(), 2);
+  EXPECT_EQ(Bar(), 2);
+}
+
+} // end anonymous namespace
@@ -0,0 +1,96 @@
+//===-- CompileTimingPluginTest.cpp - Unit tests for CompileTimingPlugin --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/CompileTimingPlugin.h"
+#include "OrcTestCommon.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+TEST(CompileTimingPluginTest, RecordsPhases) {
+  OrcNativeTarget::initialize();
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    return;
+  }
+
+  CompileTimingPlugin *Timing = nullptr;
+  auto J =
+      LLJITBuilder()
+          .setJITTargetMachineBuilder(std::move(*JTMB))
+          .setObjectLinkingLayerCreator(
+              [&](ExecutionSession &ES,
+                  const Triple &TT) -> Expected<std::unique_ptr<ObjectLayer>> {
+                auto MemMgr = jitlink::InProcessMemoryManager::Create();
+                if (!MemMgr)
+                  return MemMgr.takeError();
+                auto Layer = std::make_unique<ObjectLinkingLayer>(
+                    ES, std::move(*MemMgr));
+                auto Plugin = std::make_unique<CompileTimingPlugin>();
+                Timing = Plugin.get();
+                Layer->addPlugin(std::move(Plugin));
+                return std::move(Layer);
+              })
+          .setCompileFunctionCreator(
+              [&](JITTargetMachineBuilder JTMB)
+                  -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+                return Timing->wrapCompiler(
+                    std::make_unique<ConcurrentIRCompiler>(std::move(JTMB)));
+              })
+          .create();
+  // Bail out if we can not create a JIT for the host.
+  if (!J) {
+    consumeError(J.takeError());
+    return;
+  }
+  ASSERT_TRUE(Timing);
+  Timing->instrumentDispatch((*J)->getExecutionSession());
+  (*J)->getIRTransformLayer().setTransform(Timing->wrapTransform(
+      [](ThreadSafeModule TSM, MaterializationResponsibility &R) {
+        return std::move(TSM);
+      }));
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Err;
+  auto M = parseAssemblyString(R"(
+    define i32 @foo() {
+    entry:
+      ret i32 7
+    }
+  )",
+                               Err, *Ctx);
+  ASSERT_TRUE(M) << Err.getMessage();
+  cantFail((*J)->addIRModule(ThreadSafeModule(std::move(M), std::move(Ctx))));
+
+  auto Foo = jitTargetAddressToFunction<int (*)()>(
+      cantFail((*J)->lookup("foo")).getAddress());
+  EXPECT_EQ(Foo(), 7);
+
+  auto Stats = Timing->getStats();
+  EXPECT_GE(Stats.NumMaterializations, 1U);
+  EXPECT_GT(Stats.MaterializationTime.count(), 0);
+  EXPECT_GT(Stats.CodeGenTime.count(), 0);
+  EXPECT_GT(Stats.LinkTime.count(), 0);
+  EXPECT_LE(Stats.CodeGenTime, Stats.MaterializationTime);
+
+  auto Timings = Timing->getMaterializationTimings();
+  EXPECT_EQ(Timings.size(), Stats.NumMaterializations);
+  ASSERT_FALSE(Timings.empty());
+  EXPECT_NE(Timings.front().Description.find("Materialization task"),
+            std::string::npos);
+}
+
+} // end anonymous namespace
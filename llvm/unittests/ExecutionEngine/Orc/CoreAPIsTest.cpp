@@ -72,6 +72,50 @@ TEST_F(CoreAPIsStandardTest, EmptyLookup) {
   EXPECT_TRUE(OnCompletionRun) << "OnCompletion was not run for empty query";
 }
 
+TEST_F(CoreAPIsStandardTest, BulkLookup) {
+  // Test that a bulk lookup returns the results of each request, and
+  // dispatches the materialization units of all requests before waiting.
+  auto &JD2 = ES.createBareJITDylib("JD2");
+  cantFail(JD.define(absoluteSymbols({{Foo, FooSym}})));
+
+  std::unique_ptr<MaterializationResponsibility> BarMR;
+  cantFail(JD2.define(std::make_unique<SimpleMaterializationUnit>(
+      SymbolFlagsMap({{Bar, BarSym.getFlags()}}),
+      [&](std::unique_ptr<MaterializationResponsibility> R) {
+        // Resolving bar before baz is materialized would deadlock a sequence
+        // of blocking lookups.
+        BarMR = std::move(R);
+      })));
+  cantFail(JD2.define(std::make_unique<SimpleMaterializationUnit>(
+      SymbolFlagsMap({{Baz, BazSym.getFlags()}}),
+      [&](std::unique_ptr<MaterializationResponsibility> R) {
+        ASSERT_TRUE(BarMR) << "Bar should have been materialized first";
+        cantFail(BarMR->notifyResolved({{Bar, BarSym}}));
+        cantFail(BarMR->notifyEmitted());
+        cantFail(R->notifyResolved({{Baz, BazSym}}));
+        cantFail(R->notifyEmitted());
+      })));
+
+  auto Results = ES.bulkLookup(
+      {{makeJITDylibSearchOrder(&JD), SymbolLookupSet(Foo)},
+       {makeJITDylibSearchOrder({&JD, &JD2}), SymbolLookupSet(Bar)},
+       {makeJITDylibSearchOrder(&JD2), SymbolLookupSet(Baz)}});
+  ASSERT_THAT_EXPECTED(Results, Succeeded());
+  ASSERT_EQ(Results->size(), 3U);
+  EXPECT_EQ((*Results)[0].size(), 1U);
+  EXPECT_EQ((*Results)[0][Foo].getAddress(), FooAddr);
+  EXPECT_EQ((*Results)[1].size(), 1U);
+  EXPECT_EQ((*Results)[1][Bar].getAddress(), BarAddr);
+  EXPECT_EQ((*Results)[2].size(), 1U);
+  EXPECT_EQ((*Results)[2][Baz].getAddress(), BazAddr);
+
+  // A failing request fails the whole lookup.
+  EXPECT_THAT_EXPECTED(
+      ES.bulkLookup({{makeJITDylibSearchOrder(&JD), SymbolLookupSet(Foo)},
+                     {makeJITDylibSearchOrder(&JD), SymbolLookupSet(Qux)}}),
+      Failed());
+}
+
 TEST_F(CoreAPIsStandardTest, ResolveUnrequestedSymbol) {
   // Test that all symbols in a MaterializationUnit materialize corretly when
   // only a subset of symbols is looked up.
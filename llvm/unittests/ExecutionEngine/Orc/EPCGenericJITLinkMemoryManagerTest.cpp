@@ -13,6 +13,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ExecutionEngine/Orc/Shared/OrcRTBridge.h"
 #include "llvm/ExecutionEngine/Orc/Shared/TargetProcessControlTypes.h"
+#include "llvm/ExecutionEngine/Orc/TargetProcess/SimpleExecutorMemoryManager.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Memory.h"
 #include "llvm/Testing/Support/Error.h"
@@ -138,4 +139,54 @@ TEST(EPCGenericJITLinkMemoryManagerTest, AllocFinalizeFree) {
   cantFail(SelfEPC->disconnect());
 }
 
+#if defined(LLVM_ON_UNIX)
+TEST(EPCGenericJITLinkMemoryManagerTest, SharedMemory) {
+  auto SelfEPC = cantFail(SelfExecutorProcessControl::Create());
+  rt_bootstrap::SimpleExecutorMemoryManager SEMM;
+  StringMap<ExecutorAddr> Bootstrap;
+  SEMM.addBootstrapSymbols(Bootstrap);
+
+  EPCGenericJITLinkMemoryManager::SymbolAddrs SAs;
+  SAs.Allocator = Bootstrap[rt::SimpleExecutorMemoryManagerInstanceName];
+  SAs.Reserve = Bootstrap[rt::SimpleExecutorMemoryManagerReserveWrapperName];
+  SAs.Finalize = Bootstrap[rt::SimpleExecutorMemoryManagerFinalizeWrapperName];
+  SAs.Deallocate =
+      Bootstrap[rt::SimpleExecutorMemoryManagerDeallocateWrapperName];
+  SAs.ReserveShared =
+      Bootstrap[rt::SimpleExecutorMemoryManagerReserveSharedWrapperName];
+
+  auto MemMgr = std::make_unique<EPCGenericJITLinkMemoryManager>(*SelfEPC, SAs);
+
+  StringRef Hello = "hello";
+  auto SSA = jitlink::SimpleSegmentAlloc::Create(
+      *MemMgr, nullptr, {{jitlink::MemProt::Read, {Hello.size(), Align(1)}}});
+  // Bail out if shared memory is not available on this host.
+  if (!SSA) {
+    consumeError(SSA.takeError());
+    cantFail(SEMM.shutdown());
+    cantFail(SelfEPC->disconnect());
+    return;
+  }
+  auto SegInfo = SSA->getSegInfo(jitlink::MemProt::Read);
+  memcpy(SegInfo.WorkingMem.data(), Hello.data(), Hello.size());
+
+  // The working memory is a second view of the target memory, so the
+  // content is visible before finalization.
+  ExecutorAddr TargetAddr(SegInfo.Addr);
+  const char *TargetMem = TargetAddr.toPtr<const char *>();
+  EXPECT_NE(TargetMem, SegInfo.WorkingMem.data());
+  EXPECT_EQ(Hello, StringRef(TargetMem, Hello.size()));
+
+  auto FA = SSA->finalize();
+  EXPECT_THAT_EXPECTED(FA, Succeeded());
+  EXPECT_EQ(Hello, StringRef(TargetMem, Hello.size()));
+
+  auto Err2 = MemMgr->deallocate(std::move(*FA));
+  EXPECT_THAT_ERROR(std::move(Err2), Succeeded());
+
+  cantFail(SEMM.shutdown());
+  cantFail(SelfEPC->disconnect());
+}
+#endif
+
 } // namespace
@@ -0,0 +1,85 @@
+//===------ LLJITObjectSnapshotTest.cpp - Unit tests for LLJIT snapshots --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+static std::unique_ptr<LLJIT> createHostJIT() {
+  OrcNativeTarget::initialize();
+  auto J = LLJITBuilder().create();
+  // Bail out if we can not create a JIT for the host.
+  if (!J) {
+    consumeError(J.takeError());
+    return nullptr;
+  }
+  return std::move(*J);
+}
+
+TEST(LLJITObjectSnapshotTest, WriteAndAdd) {
+  unittest::TempDir Dir("orc-snapshot", /*Unique=*/true);
+  SmallString<128> Path(Dir.path());
+  sys::path::append(Path, "runtime.o");
+
+  {
+    auto J = createHostJIT();
+    if (!J)
+      return;
+    auto Ctx = std::make_unique<LLVMContext>();
+    SMDiagnostic Err;
+    auto M = parseAssemblyString(R"(
+      define i32 @helper() {
+      entry:
+        ret i32 42
+      }
+    )",
+                                 Err, *Ctx);
+    ASSERT_TRUE(M) << Err.getMessage();
+    EXPECT_THAT_ERROR(J->writeObjectSnapshot(
+                          ThreadSafeModule(std::move(M), std::move(Ctx)), Path),
+                      Succeeded());
+  }
+  ASSERT_TRUE(sys::fs::exists(Path));
+
+  // A later session uses the snapshot without the IR.
+  auto J = createHostJIT();
+  ASSERT_TRUE(J);
+  EXPECT_THAT_ERROR(J->addObjectSnapshot(J->getMainJITDylib(), Path),
+                    Succeeded());
+  auto Helper = J->lookup("helper");
+  ASSERT_THAT_EXPECTED(Helper, Succeeded());
+  auto *HelperFn = jitTargetAddressToFunction<int (*)()>(Helper->getAddress());
+  EXPECT_EQ(HelperFn(), 42);
+}
+
+TEST(LLJITObjectSnapshotTest, RejectInvalidSnapshot) {
+  auto J = createHostJIT();
+  if (!J)
+    return;
+
+  unittest::TempDir Dir("orc-snapshot", /*Unique=*/true);
+  SmallString<128> Path(Dir.path());
+  sys::path::append(Path, "missing.o");
+  EXPECT_THAT_ERROR(J->addObjectSnapshot(J->getMainJITDylib(), Path), Failed());
+
+  unittest::TempFile NotAnObject(Path, "", "not an object");
+  EXPECT_THAT_ERROR(J->addObjectSnapshot(J->getMainJITDylib(), Path), Failed());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,133 @@
+//===--- PersistentObjectCacheTest.cpp - Unit tests for the object cache --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "OrcTestCommon.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+/// Runs foo from \p Source in a new JIT that uses a cache in \p CacheDir, and
+/// returns the cache.
+static std::unique_ptr<PersistentObjectCache> runFoo(StringRef CacheDir,
+                                                     StringRef Source,
+                                                     int ExpectedResult) {
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    return nullptr;
+  }
+  auto Cache = cantFail(
+      PersistentObjectCache::Create(CacheDir, *JTMB, [](Error Err) {
+        ADD_FAILURE() << toString(std::move(Err));
+      }));
+
+  auto J =
+      LLJITBuilder()
+          .setJITTargetMachineBuilder(std::move(*JTMB))
+          .setCompileFunctionCreator(
+              [&](JITTargetMachineBuilder JTMB)
+                  -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+                return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB),
+                                                              Cache.get());
+              })
+          .create();
+  // Bail out if we can not create a JIT for the host.
+  if (!J) {
+    consumeError(J.takeError());
+    return nullptr;
+  }
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(Source, Err, *Ctx);
+  EXPECT_TRUE(M) << Err.getMessage();
+  if (!M)
+    return nullptr;
+  M->setDataLayout((*J)->getDataLayout());
+  cantFail((*J)->addIRModule(ThreadSafeModule(std::move(M), std::move(Ctx))));
+
+  auto Foo = jitTargetAddressToFunction<int (*)()>(
+      cantFail((*J)->lookup("foo")).getAddress());
+  EXPECT_EQ(Foo(), ExpectedResult);
+  return Cache;
+}
+
+TEST(PersistentObjectCacheTest, ReuseObjects) {
+  OrcNativeTarget::initialize();
+  unittest::TempDir CacheDir("orc-object-cache", /*Unique=*/true);
+
+  const char *Foo1 = R"(
+    define i32 @foo() {
+    entry:
+      ret i32 1
+    }
+  )";
+  const char *Foo2 = R"(
+    define i32 @foo() {
+    entry:
+      ret i32 2
+    }
+  )";
+
+  // The first run compiles the module.
+  auto Cache = runFoo(CacheDir.path(), Foo1, 1);
+  if (!Cache)
+    return;
+  EXPECT_EQ(Cache->getNumHits(), 0U);
+  EXPECT_EQ(Cache->getNumMisses(), 1U);
+
+  // The next run of the same module loads the object from the directory.
+  Cache = runFoo(CacheDir.path(), Foo1, 1);
+  ASSERT_TRUE(Cache);
+  EXPECT_EQ(Cache->getNumHits(), 1U);
+  EXPECT_EQ(Cache->getNumMisses(), 0U);
+
+  // A different module is compiled again.
+  Cache = runFoo(CacheDir.path(), Foo2, 2);
+  ASSERT_TRUE(Cache);
+  EXPECT_EQ(Cache->getNumHits(), 0U);
+  EXPECT_EQ(Cache->getNumMisses(), 1U);
+}
+
+TEST(PersistentObjectCacheTest, KeyDependsOnTarget) {
+  LLVMContext Ctx;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(R"(
+    define i32 @foo() {
+    entry:
+      ret i32 1
+    }
+  )",
+                                                  Err, Ctx);
+  ASSERT_TRUE(M) << Err.getMessage();
+
+  JITTargetMachineBuilder JTMB((Triple("x86_64-pc-linux-gnu")));
+  auto Cache = cantFail(PersistentObjectCache::Create("unused", JTMB));
+  std::string Key = Cache->getKey(*M);
+  EXPECT_EQ(Key, Cache->getKey(*M));
+
+  JTMB.setCPU("skylake");
+  auto CPUCache = cantFail(PersistentObjectCache::Create("unused", JTMB));
+  EXPECT_NE(Key, CPUCache->getKey(*M));
+
+  JTMB.setCPU("");
+  JTMB.setCodeGenOptLevel(CodeGenOpt::None);
+  auto OptLevelCache = cantFail(PersistentObjectCache::Create("unused", JTMB));
+  EXPECT_NE(Key, OptLevelCache->getKey(*M));
+}
+
+} // end anonymous namespace
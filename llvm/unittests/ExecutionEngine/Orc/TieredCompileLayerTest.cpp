@@ -0,0 +1,116 @@
+//===------ TieredCompileLayerTest.cpp - Unit tests for tiered JIT --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "OrcTestCommon.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+TEST(TieredCompileLayerTest, RecompileHotFunction) {
+  OrcNativeTarget::initialize();
+
+  auto J = LLJITBuilder().create();
+  // Bail out if we can not create a JIT for the host.
+  if (!J) {
+    consumeError(J.takeError());
+    return;
+  }
+  ExecutionSession &ES = (*J)->getExecutionSession();
+  const Triple &TT = (*J)->getTargetTriple();
+
+  // Bail out if we can not build a local call-through manager.
+  auto LCTMgr = createLocalLazyCallThroughManager(TT, ES, 0);
+  if (!LCTMgr) {
+    consumeError(LCTMgr.takeError());
+    return;
+  }
+
+  // The second tier makes foo return 2 instead of 1, so that the tests can
+  // tell which code is called.
+  unsigned NumSecondTierModules = 0;
+  IRTransformLayer SecondTierLayer(
+      ES, (*J)->getIRCompileLayer(),
+      [&](ThreadSafeModule TSM,
+          MaterializationResponsibility &R) -> Expected<ThreadSafeModule> {
+        ++NumSecondTierModules;
+        TSM.withModuleDo([](Module &M) {
+          if (Function *F = M.getFunction("foo.tier1"))
+            for (BasicBlock &BB : *F)
+              if (auto *Ret = dyn_cast<ReturnInst>(BB.getTerminator()))
+                Ret->setOperand(
+                    0, ConstantInt::get(Ret->getOperand(0)->getType(), 2));
+        });
+        return std::move(TSM);
+      });
+  TieredCompileLayer TieredLayer(ES, (*J)->getIRCompileLayer(),
+                                 SecondTierLayer, **LCTMgr,
+                                 createLocalIndirectStubsManagerBuilder(TT),
+                                 /*HotCallCount=*/3);
+
+  auto Ctx = std::make_unique<LLVMContext>();
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(R"(
+    define i32 @foo() {
+    entry:
+      ret i32 1
+    }
+
+    define internal i32 @baz() {
+    entry:
+      %r = call i32 @foo()
+      ret i32 %r
+    }
+
+    define i32 @bar() {
+    entry:
+      %r = call i32 @baz()
+      ret i32 %r
+    }
+  )",
+                                                  Err, *Ctx);
+  ASSERT_TRUE(M) << Err.getMessage();
+  M->setDataLayout((*J)->getDataLayout());
+  cantFail(TieredLayer.add((*J)->getMainJITDylib(),
+                           ThreadSafeModule(std::move(M), std::move(Ctx))));
+
+  auto Foo = jitTargetAddressToFunction<int (*)()>(
+      cantFail((*J)->lookup("foo")).getAddress());
+  auto Bar = jitTargetAddressToFunction<int (*)()>(
+      cantFail((*J)->lookup("bar")).getAddress());
+
+  // The third call to foo dispatches the recompilation, which the in-place
+  // dispatcher of the JIT runs before the call returns.
+  EXPECT_EQ(Foo(), 1);
+  EXPECT_EQ(Bar(), 1);
+  EXPECT_EQ(NumSecondTierModules, 0U);
+  EXPECT_EQ(Foo(), 1);
+  EXPECT_EQ(NumSecondTierModules, 1U);
+  EXPECT_EQ(TieredLayer.getNumRecompiledFunctions(), 1U);
+
+  // All the calls, including the ones from the first tier code of other
+  // functions, now reach the second tier code.
+  EXPECT_EQ(Foo(), 2);
+  EXPECT_EQ(Bar(), 2);
+
+  // The third call to bar makes both bar and the internal function baz hot.
+  EXPECT_EQ(Bar(), 2);
+  EXPECT_EQ(NumSecondTierModules, 3U);
+  EXPECT_EQ(TieredLayer.getNumRecompiledFunctions(), 3U);
+  EXPECT_EQ(Bar(), 2);
+}
+
+} // end anonymous namespace
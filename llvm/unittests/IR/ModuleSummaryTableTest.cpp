@@ -0,0 +1,103 @@
+//===- ModuleSummaryTableTest.cpp - ModuleSummaryTable unit tests ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/IR/ModuleSummaryTable.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+std::unique_ptr<ModuleSummaryIndex> parseIndex(StringRef Assembly) {
+  SMDiagnostic Err;
+  std::unique_ptr<ModuleSummaryIndex> Index =
+      parseSummaryIndexAssembly(MemoryBufferRef(Assembly, "index"), Err);
+  if (!Index)
+    Err.print("ModuleSummaryTableTest", errs());
+  return Index;
+}
+
+TEST(ModuleSummaryTableTest, RoundTrip) {
+  std::unique_ptr<ModuleSummaryIndex> Index = parseIndex(R"(
+^0 = module: (path: "b.o", hash: (1, 2, 3, 4, 5))
+^1 = module: (path: "a.o", hash: (0, 0, 0, 0, 0))
+^2 = gv: (guid: 1, summaries: (function: (module: ^0, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 1, canAutoHide: 0), insts: 10, calls: ((callee: ^3)), refs: (^4))))
+^3 = gv: (guid: 2, summaries: (function: (module: ^1, flags: (linkage: internal, visibility: default, notEligibleToImport: 1, live: 0, dsoLocal: 0, canAutoHide: 0), insts: 3), function: (module: ^0, flags: (linkage: internal, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), insts: 4)))
+^4 = gv: (guid: 3, summaries: (variable: (module: ^1, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), varFlags: (readonly: 1, writeonly: 0, constant: 0))))
+)");
+  ASSERT_TRUE(Index);
+
+  std::string Data;
+  raw_string_ostream OS(Data);
+  writeModuleSummaryTable(*Index, OS);
+  Expected<ModuleSummaryTable> TableOrErr =
+      ModuleSummaryTable::create(MemoryBufferRef(OS.str(), "table"));
+  ASSERT_THAT_EXPECTED(TableOrErr, Succeeded());
+  const ModuleSummaryTable &Table = *TableOrErr;
+
+  // Modules are numbered in the order of their paths.
+  ASSERT_EQ(Table.getNumModules(), 2u);
+  EXPECT_EQ(Table.getModulePath(0), "a.o");
+  EXPECT_EQ(Table.getModulePath(1), "b.o");
+  EXPECT_EQ(Table.getModuleHash(1), (ModuleHash{{1, 2, 3, 4, 5}}));
+
+  EXPECT_EQ(Table.entries().size(), 4u);
+  EXPECT_TRUE(Table.lookup(4).empty());
+
+  ArrayRef<ModuleSummaryTable::Entry> F = Table.lookup(1);
+  ASSERT_EQ(F.size(), 1u);
+  EXPECT_EQ(F[0].getKind(), GlobalValueSummary::FunctionKind);
+  EXPECT_EQ(F[0].getLinkage(), GlobalValue::ExternalLinkage);
+  EXPECT_EQ(Table.getModulePath(F[0].ModuleIndex), "b.o");
+  EXPECT_EQ(F[0].InstCount, 10u);
+  EXPECT_TRUE(F[0].isLive());
+  EXPECT_TRUE(F[0].isDSOLocal());
+  ASSERT_EQ(Table.calls(F[0]).size(), 1u);
+  EXPECT_EQ(Table.calls(F[0])[0], 2u);
+  ASSERT_EQ(Table.refs(F[0]).size(), 1u);
+  EXPECT_EQ(Table.refs(F[0])[0], 3u);
+
+  ArrayRef<ModuleSummaryTable::Entry> G = Table.lookup(2);
+  ASSERT_EQ(G.size(), 2u);
+  EXPECT_EQ(G[0].getLinkage(), GlobalValue::InternalLinkage);
+  EXPECT_TRUE(G[0].notEligibleToImport());
+  EXPECT_FALSE(G[0].isLive());
+  EXPECT_TRUE(Table.calls(G[0]).empty());
+
+  ArrayRef<ModuleSummaryTable::Entry> V = Table.lookup(3);
+  ASSERT_EQ(V.size(), 1u);
+  EXPECT_EQ(V[0].getKind(), GlobalValueSummary::GlobalVarKind);
+  EXPECT_EQ(Table.getModulePath(V[0].ModuleIndex), "a.o");
+}
+
+TEST(ModuleSummaryTableTest, Malformed) {
+  EXPECT_THAT_EXPECTED(
+      ModuleSummaryTable::create(MemoryBufferRef("SUMT", "table")), Failed());
+  EXPECT_THAT_EXPECTED(
+      ModuleSummaryTable::create(MemoryBufferRef(
+          StringRef("BC\xC0\xDE\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 24),
+          "table")),
+      Failed());
+
+  ModuleSummaryIndex Index(/*HaveGVs=*/false);
+  std::string Data;
+  raw_string_ostream OS(Data);
+  writeModuleSummaryTable(Index, OS);
+  EXPECT_THAT_EXPECTED(
+      ModuleSummaryTable::create(MemoryBufferRef(OS.str(), "table")),
+      Succeeded());
+  EXPECT_THAT_EXPECTED(ModuleSummaryTable::create(MemoryBufferRef(
+                           StringRef(Data).drop_back(1), "table")),
+                       Failed());
+}
+
+} // end anonymous namespace
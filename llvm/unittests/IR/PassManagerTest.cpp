@@ -950,4 +950,40 @@ TEST_F(PassManagerTest, FunctionPassCFGCheckerWrapped) {
   FPM.addPass(TestSimplifyCFGWrapperPass(InnerFPM));
   FPM.run(*F, FAM);
 }
+
+// Check that the pass invalidating an analysis that is then requested again is
+// charged with the recomputation.
+TEST(AnalysisRecomputeReporterTest, ChargesInvalidatingPass) {
+  LLVMContext Context;
+  auto M = parseIR(Context, "define void @foo() {\n"
+                            "  ret void\n"
+                            "}\n");
+
+  std::string Report;
+  {
+    raw_string_ostream OS(Report);
+    AnalysisRecomputeReporter Reporter(/*Enabled=*/true);
+    Reporter.setOutStream(OS);
+
+    FunctionAnalysisManager FAM;
+    PassInstrumentationCallbacks PIC;
+    Reporter.registerCallbacks(PIC);
+    FAM.registerPass([&] { return PassInstrumentationAnalysis(&PIC); });
+    FAM.registerPass([&] { return DominatorTreeAnalysis(); });
+
+    FunctionPassManager FPM;
+    FPM.addPass(RequireAnalysisPass<DominatorTreeAnalysis, Function>());
+    FPM.addPass(InvalidateAnalysisPass<DominatorTreeAnalysis>());
+    FPM.addPass(RequireAnalysisPass<DominatorTreeAnalysis, Function>());
+    FPM.addPass(InvalidateAnalysisPass<DominatorTreeAnalysis>());
+    FPM.run(*M->getFunction("foo"), FAM);
+  }
+
+  // Both invalidations are charged, one of which had to be recomputed.
+  EXPECT_NE(Report.find("1            2  InvalidateAnalysisPass"),
+            std::string::npos)
+      << Report;
+  EXPECT_NE(Report.find(" / DominatorTreeAnalysis"), std::string::npos);
+}
+
 }
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Object/Archive.h"
+#include "llvm/Object/ArchiveWriter.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
 
@@ -91,3 +92,35 @@ TEST_F(ArchiveTestsFixture, ArchiveChildGetBuffer) {
   EXPECT_EQ(MemberSize, Buffer->size());
   EXPECT_EQ(ArchiveWithMember + sizeof(ArchiveWithMember) - 1, Buffer->data());
 }
+
+TEST(ArchiveWriterTest, KnownMemberSymbols) {
+  // Members with known symbols are not parsed, so their contents do not have
+  // to be object files.
+  std::vector<NewArchiveMember> Members;
+  Members.emplace_back(MemoryBufferRef("first member", "first.o"));
+  Members.back().Symbols = std::vector<StringRef>{"foo", "bar"};
+  Members.emplace_back(MemoryBufferRef("no symbols", "none.o"));
+  Members.back().Symbols = std::vector<StringRef>();
+  Members.emplace_back(MemoryBufferRef("second member", "second.o"));
+  Members.back().Symbols = std::vector<StringRef>{"baz"};
+
+  Expected<std::unique_ptr<MemoryBuffer>> BufOrErr =
+      writeArchiveToBuffer(Members, /*WriteSymtab=*/true, Archive::K_GNU,
+                           /*Deterministic=*/true, /*Thin=*/false);
+  ASSERT_THAT_EXPECTED(BufOrErr, Succeeded());
+  Expected<std::unique_ptr<Archive>> AOrErr =
+      Archive::create((*BufOrErr)->getMemBufferRef());
+  ASSERT_THAT_EXPECTED(AOrErr, Succeeded());
+
+  std::vector<std::pair<std::string, std::string>> Symbols;
+  for (const Archive::Symbol &Sym : (*AOrErr)->symbols()) {
+    Expected<Archive::Child> ChildOrErr = Sym.getMember();
+    ASSERT_THAT_EXPECTED(ChildOrErr, Succeeded());
+    Expected<StringRef> NameOrErr = ChildOrErr->getName();
+    ASSERT_THAT_EXPECTED(NameOrErr, Succeeded());
+    Symbols.emplace_back(Sym.getName().str(), NameOrErr->str());
+  }
+  std::vector<std::pair<std::string, std::string>> ExpectedSymbols = {
+      {"foo", "first.o"}, {"bar", "first.o"}, {"baz", "second.o"}};
+  EXPECT_EQ(ExpectedSymbols, Symbols);
+}
@@ -1106,6 +1106,105 @@ TEST_F(SparseInstrProfTest, preserve_no_records) {
 INSTANTIATE_TEST_SUITE_P(MaybeSparse, MaybeSparseInstrProfTest,
                          ::testing::Bool());
 
+// Appends a 64-bit raw temporal profile of the functions \p Names, with the
+// counters \p Counts, to \p Profile. The first counter of each function is
+// its timestamp.
+static void
+appendRawTemporalProfile(std::string &Profile, ArrayRef<std::string> Names,
+                         ArrayRef<std::vector<uint64_t>> Counts) {
+  using DataT = RawInstrProf::ProfileData<uint64_t>;
+  std::string NameStrings;
+  ASSERT_THAT_ERROR(collectPGOFuncNameStrings(Names, /*doCompression=*/false,
+                                              NameStrings),
+                    Succeeded());
+  uint64_t NumCounters = 0;
+  for (const auto &C : Counts)
+    NumCounters += C.size();
+  uint64_t CountersDelta = Names.size() * sizeof(DataT);
+  const RawInstrProf::Header Header{RawInstrProf::getMagic<uint64_t>(),
+                                    RawInstrProf::Version |
+                                        VARIANT_MASK_IR_PROF |
+                                        VARIANT_MASK_TEMPORAL_PROF,
+                                    /*BinaryIdsSize=*/0,
+                                    Names.size(),
+                                    /*PaddingBytesBeforeCounters=*/0,
+                                    NumCounters,
+                                    /*PaddingBytesAfterCounters=*/0,
+                                    NameStrings.size(),
+                                    CountersDelta,
+                                    /*NamesDelta=*/0,
+                                    IPVK_Last};
+  Profile.append(reinterpret_cast<const char *>(&Header), sizeof(Header));
+
+  uint64_t CounterOffset = 0;
+  for (size_t I = 0; I != Names.size(); ++I) {
+    const DataT Data{IndexedInstrProf::ComputeHash(Names[I]),
+                     /*FuncHash=*/0x1234,
+                     CountersDelta - I * sizeof(DataT) + CounterOffset,
+                     /*FunctionPointer=*/0,
+                     /*Values=*/0,
+                     static_cast<uint32_t>(Counts[I].size()),
+                     {}};
+    Profile.append(reinterpret_cast<const char *>(&Data), sizeof(Data));
+    CounterOffset += Counts[I].size() * sizeof(uint64_t);
+  }
+  for (const auto &C : Counts)
+    Profile.append(reinterpret_cast<const char *>(C.data()),
+                   C.size() * sizeof(uint64_t));
+  Profile.append(NameStrings);
+  Profile.append(7 & (8 - NameStrings.size() % 8), '\0');
+}
+
+TEST(InstrProfTest, raw_temporal_profile) {
+  std::vector<std::string> Names = {"foo", "bar", "file.c:baz"};
+  std::string Profile;
+  appendRawTemporalProfile(Profile, Names, {{2, 5}, {1, 3}, {0, 0}});
+  appendRawTemporalProfile(Profile, Names, {{1, 4}, {0, 0}, {2, 1}});
+
+  auto ReaderOrErr = InstrProfReader::create(
+      MemoryBuffer::getMemBufferCopy(Profile, "temporal.profraw"));
+  ASSERT_THAT_ERROR(ReaderOrErr.takeError(), Succeeded());
+  auto Reader = std::move(ReaderOrErr.get());
+  EXPECT_TRUE(Reader->hasTemporalProfile());
+  EXPECT_TRUE(static_cast<bool>(Reader->getProfileKind() &
+                                InstrProfKind::TemporalProfile));
+
+  // The timestamps are not part of the counts.
+  std::vector<uint64_t> FooCounts;
+  for (const auto &Record : *Reader) {
+    ASSERT_EQ(1U, Record.Counts.size());
+    if (Record.Name == "foo")
+      FooCounts.push_back(Record.Counts[0]);
+  }
+  ASSERT_THAT_ERROR(Reader->getError(), Succeeded());
+  EXPECT_EQ(FooCounts, std::vector<uint64_t>({5, 4}));
+
+  // Each raw profile is a trace, without the functions that were not called.
+  ArrayRef<TemporalProfTraceTy> Traces = Reader->getTemporalProfTraces();
+  ASSERT_EQ(2U, Traces.size());
+  EXPECT_EQ(Traces[0], TemporalProfTraceTy({"bar", "foo"}));
+  EXPECT_EQ(Traces[1], TemporalProfTraceTy({"foo", "file.c:baz"}));
+
+  EXPECT_EQ(getTemporalProfFunctionOrder(Traces),
+            std::vector<std::string>({"foo", "bar", "file.c:baz"}));
+}
+
+TEST(InstrProfTest, temporal_profile_function_order) {
+  EXPECT_TRUE(getTemporalProfFunctionOrder({}).empty());
+
+  // "a" is first in two of the three traces, "c" is missing from the first
+  // one.
+  std::vector<TemporalProfTraceTy> Traces = {
+      {"a", "b"}, {"a", "b", "c", "d"}, {"b", "c", "a", "d"}};
+  EXPECT_EQ(getTemporalProfFunctionOrder(Traces),
+            std::vector<std::string>({"a", "b", "c", "d"}));
+
+  // Ties are broken by name.
+  Traces = {{"x", "y"}, {"y", "x"}};
+  EXPECT_EQ(getTemporalProfFunctionOrder(Traces),
+            std::vector<std::string>({"x", "y"}));
+}
+
 #if defined(_LP64) && defined(EXPENSIVE_CHECKS)
 TEST(ProfileReaderTest, ReadsLargeFiles) {
   const size_t LargeSize = 1ULL << 32; // 4GB
@@ -396,6 +396,64 @@ struct SampleProfTest : ::testing::Test {
       ASSERT_EQ(I->getValue(), Esamples);
     }
   }
+
+  // Write a CS profile, and check that reading it for a module that only
+  // has foo loads the contexts of foo and their callee contexts only.
+  void testOnDemandCSProfile(bool UseMD5) {
+    TempFile ProfileFile("profile", "", "", /*Unique*/ true);
+    createWriter(SampleProfileFormat::SPF_Ext_Binary, ProfileFile.path());
+    if (UseMD5)
+      Writer->setUseMD5();
+
+    SampleContextFrameVector MainFoo = {{"main", LineLocation(1, 0)},
+                                        {"foo", LineLocation(0, 0)}};
+    SampleContextFrameVector MainFooBar = {{"main", LineLocation(1, 0)},
+                                           {"foo", LineLocation(2, 0)},
+                                           {"bar", LineLocation(0, 0)}};
+    SampleContextFrameVector BazBar = {{"baz", LineLocation(3, 0)},
+                                       {"bar", LineLocation(0, 0)}};
+    SampleContextFrameVector Main = {{"main", LineLocation(0, 0)}};
+
+    // The head samples identify the profiles, since the names are read as
+    // MD5 numbers in an MD5 profile.
+    SampleProfileMap ProfMap;
+    uint64_t HeadSamples = 100;
+    for (const auto *Frames : {&MainFoo, &MainFooBar, &BazBar, &Main}) {
+      SampleContext FContext(*Frames);
+      FunctionSamples &FProfile = ProfMap[FContext];
+      FProfile.setContext(FContext);
+      FProfile.addHeadSamples(HeadSamples++);
+      FProfile.addTotalSamples(10);
+      FProfile.addBodySamples(1, 0, 10);
+    }
+
+    bool SavedProfileIsCSFlat = FunctionSamples::ProfileIsCSFlat;
+    FunctionSamples::ProfileIsCSFlat = true;
+    ASSERT_TRUE(NoError(Writer->write(ProfMap)));
+    Writer->getOutputStream().flush();
+
+    Module M("my_module", Context);
+    FunctionType *fn_type =
+        FunctionType::get(Type::getVoidTy(Context), {}, false);
+    M.getOrInsertFunction("foo", fn_type);
+    readProfile(M, ProfileFile.path());
+    std::error_code EC = Reader->read();
+    FunctionSamples::ProfileIsCSFlat = SavedProfileIsCSFlat;
+    ASSERT_TRUE(NoError(EC));
+
+    ASSERT_TRUE(Reader->profileIsCSFlat());
+    std::vector<uint64_t> ReadHeadSamples;
+    for (const auto &I : Reader->getProfiles()) {
+      ReadHeadSamples.push_back(I.second.getHeadSamples());
+      ASSERT_EQ(10u, I.second.getTotalSamples());
+    }
+    llvm::sort(ReadHeadSamples);
+    ASSERT_EQ(ReadHeadSamples, std::vector<uint64_t>({100, 101}));
+    if (!UseMD5) {
+      ASSERT_EQ(1u, Reader->getProfiles().count(SampleContext(MainFoo)));
+      ASSERT_EQ(1u, Reader->getProfiles().count(SampleContext(MainFooBar)));
+    }
+  }
 };
 
 TEST_F(SampleProfTest, roundtrip_text_profile) {
@@ -418,6 +476,14 @@ TEST_F(SampleProfTest, roundtrip_md5_ext_binary_profile) {
   testRoundTrip(SampleProfileFormat::SPF_Ext_Binary, false, true);
 }
 
+TEST_F(SampleProfTest, on_demand_cs_ext_binary_profile) {
+  testOnDemandCSProfile(false);
+}
+
+TEST_F(SampleProfTest, on_demand_cs_md5_ext_binary_profile) {
+  testOnDemandCSProfile(true);
+}
+
 TEST_F(SampleProfTest, remap_text_profile) {
   testRoundTrip(SampleProfileFormat::SPF_Text, true, false);
 }
@@ -155,6 +155,33 @@ TEST(FileOutputBuffer, Test) {
   ASSERT_EQ(File6Size, 0ULL);
   ASSERT_NO_ERROR(fs::remove(File6.str()));
 
+  // TEST 7: Preallocated buffer written back in ranges before the commit.
+  SmallString<128> File7(TestDirectory);
+  File7.append("/file7");
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File7, 8192, FileOutputBuffer::F_preallocate);
+    ASSERT_NO_ERROR(errorToErrorCode(BufferOrErr.takeError()));
+    std::unique_ptr<FileOutputBuffer> &Buffer = *BufferOrErr;
+    memcpy(Buffer->getBufferStart(), "AABBCCDDEEFFGGHHIIJJ", 20);
+    Buffer->writeback(0, 4096);
+    memcpy(Buffer->getBufferEnd() - 20, "AABBCCDDEEFFGGHHIIJJ", 20);
+    Buffer->writeback(4096, 4096);
+    ASSERT_NO_ERROR(errorToErrorCode(Buffer->commit()));
+  }
+
+  // Verify the file has the size and content of the buffer.
+  {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+        MemoryBuffer::getFile(File7);
+    ASSERT_TRUE(!!BufferOrErr);
+    StringRef Contents = (*BufferOrErr)->getBuffer();
+    ASSERT_EQ(Contents.size(), 8192U);
+    EXPECT_TRUE(Contents.startswith("AABBCCDDEEFFGGHHIIJJ"));
+    EXPECT_TRUE(Contents.endswith("AABBCCDDEEFFGGHHIIJJ"));
+  }
+  ASSERT_NO_ERROR(fs::remove(File7.str()));
+
   // Clean up.
   ASSERT_NO_ERROR(fs::remove(TestDirectory.str()));
 }
@@ -14,6 +14,7 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
 #include <random>
 
 uint32_t array[1024 * 1024];
@@ -80,6 +81,24 @@ TEST(Parallel, TransformReduce) {
   EXPECT_EQ(sum, 3060U);
 }
 
+TEST(Parallel, TaskGroupSpawnFromTasks) {
+  // Tasks spawned by a worker go to that worker's own queue and may be stolen
+  // by the others. Check that every one of them runs exactly once.
+  std::array<std::atomic<unsigned>, 64 * 64> Counts;
+  for (auto &Count : Counts)
+    Count = 0;
+  {
+    parallel::detail::TaskGroup TG;
+    for (size_t I = 0; I < 64; ++I)
+      TG.spawn([I, &TG, &Counts] {
+        for (size_t J = 0; J < 64; ++J)
+          TG.spawn([=, &Counts] { ++Counts[I * 64 + J]; });
+      });
+  }
+  for (auto &Count : Counts)
+    EXPECT_EQ(Count, 1u);
+}
+
 TEST(Parallel, ForEachError) {
   int nums[] = {1, 2, 3, 4, 5, 6};
   Error e = parallelForEachError(nums, [](int v) -> Error {
@@ -196,6 +196,97 @@ TEST_F(ThreadPoolTest, PoolDestruction) {
 
 #if LLVM_ENABLE_THREADS == 1
 
+// Check running tasks in different groups.
+TEST_F(ThreadPoolTest, Groups) {
+  CHECK_UNSUPPORTED();
+  // Need at least two threads, as the task in group2
+  // might block a thread until all tasks in group1 finish.
+  ThreadPoolStrategy S = hardware_concurrency(2);
+  if (S.compute_thread_count() < 2)
+    return;
+  ThreadPool Pool(S);
+  std::atomic_int checked_in1{0};
+  std::atomic_int checked_in2{0};
+  ThreadPoolTaskGroup Group1(Pool);
+  ThreadPoolTaskGroup Group2(Pool);
+
+  // Launch first task in group1.
+  Group1.async([this, &checked_in1] {
+    waitForMainThread();
+    ++checked_in1;
+  });
+  // Launch second task in group2.
+  Group2.async([&checked_in2] { ++checked_in2; });
+  // Wait for group2 to finish; the task in group1 is still waiting.
+  Group2.wait();
+  ASSERT_EQ(0, checked_in1);
+  ASSERT_EQ(1, checked_in2);
+  // Let the task in group1 finish.
+  setMainThreadReady();
+  Group1.wait();
+  ASSERT_EQ(1, checked_in1);
+}
+
+// Check recursive tasks.
+TEST_F(ThreadPoolTest, RecursiveWaitDeadlock) {
+  CHECK_UNSUPPORTED();
+  // A single thread would deadlock if waiting for a group blocked it.
+  ThreadPool Pool(hardware_concurrency(1));
+  ThreadPoolTaskGroup Group1(Pool);
+  std::atomic_int checked_in{0};
+  Group1.async([&Pool, &checked_in] {
+    ThreadPoolTaskGroup Group2(Pool);
+    Group2.async([&checked_in] { ++checked_in; });
+    Group2.wait();
+    ++checked_in;
+  });
+  Group1.wait();
+  ASSERT_EQ(2, checked_in);
+}
+
+// Check that queued tasks of a higher priority group run first.
+TEST_F(ThreadPoolTest, GroupPriorities) {
+  CHECK_UNSUPPORTED();
+  ThreadPool Pool(hardware_concurrency(1));
+  ThreadPoolTaskGroup Low(Pool, -1);
+  ThreadPoolTaskGroup High(Pool, 1);
+  std::mutex OrderLock;
+  std::vector<int> Order;
+  auto Record = [&](int I) {
+    std::lock_guard<std::mutex> Guard(OrderLock);
+    Order.push_back(I);
+  };
+  // Keep the only thread busy until all the tasks are queued.
+  Pool.async([this] { waitForMainThread(); });
+  Low.async([&] { Record(0); });
+  Pool.async([&] { Record(1); });
+  High.async([&] { Record(2); });
+  High.async([&] { Record(3); });
+  Pool.async([&] { Record(4); });
+  setMainThreadReady();
+  Pool.wait();
+  ASSERT_EQ(std::vector<int>({2, 3, 1, 4, 0}), Order);
+}
+
+// Check that queued tasks of a cancelled group are not run.
+TEST_F(ThreadPoolTest, GroupCancel) {
+  CHECK_UNSUPPORTED();
+  ThreadPool Pool(hardware_concurrency(1));
+  ThreadPoolTaskGroup Group(Pool);
+  std::atomic_int checked_in{0};
+  Pool.async([this] { waitForMainThread(); });
+  std::shared_future<void> Skipped = Group.async([&] { ++checked_in; });
+  std::shared_future<int> Run =
+      Group.async([&] { return Group.isCancelled() ? 1 : 2; });
+  Group.cancel();
+  EXPECT_TRUE(Group.isCancelled());
+  setMainThreadReady();
+  Skipped.wait();
+  ASSERT_EQ(1, Run.get());
+  Group.wait();
+  ASSERT_EQ(0, checked_in);
+}
+
 // FIXME: Skip some tests below on non-Windows because multi-socket systems
 // were not fully tested on Unix yet, and llvm::get_thread_affinity_mask()
 // isn't implemented for Unix (need AffinityMask in Support/Unix/Program.inc).
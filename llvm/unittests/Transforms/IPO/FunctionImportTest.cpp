@@ -0,0 +1,118 @@
+//===- FunctionImportTest.cpp - Unit tests for the import computation -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/FunctionImport.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/ModuleSummaryIndex.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+/// Sets the option \p Name for the lifetime of the object.
+template <typename T> class ScopedOption {
+  cl::opt<T> *Opt;
+  T OldValue;
+
+public:
+  ScopedOption(StringRef Name, T Value) {
+    Opt = static_cast<cl::opt<T> *>(cl::getRegisteredOptions()[Name]);
+    OldValue = *Opt;
+    *Opt = Value;
+  }
+  ~ScopedOption() { *Opt = OldValue; }
+};
+
+/// Sets -import-total-instr-limit for the lifetime of the object.
+struct ScopedImportLimit : ScopedOption<unsigned> {
+  ScopedImportLimit(unsigned Value)
+      : ScopedOption("import-total-instr-limit", Value) {}
+};
+
+// a.o defines main (GUID 1), which has a hot call to 2 and plain calls to 3
+// and 4, all defined in b.o with 10, 10 and 30 instructions.
+const char *IndexAssembly = R"(
+^0 = module: (path: "a.o", hash: (0, 0, 0, 0, 0))
+^1 = module: (path: "b.o", hash: (0, 0, 0, 0, 0))
+^2 = gv: (guid: 1, summaries: (function: (module: ^0, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), insts: 5, calls: ((callee: ^3, hotness: hot), (callee: ^4), (callee: ^5)))))
+^3 = gv: (guid: 2, summaries: (function: (module: ^1, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), insts: 10)))
+^4 = gv: (guid: 3, summaries: (function: (module: ^1, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), insts: 10)))
+^5 = gv: (guid: 4, summaries: (function: (module: ^1, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), insts: 30)))
+)";
+
+// a.o defines main (GUID 1), which has a call promotable to 2, defined in b.o
+// with 500 instructions, and a cold call to 3, defined in b.o as well.
+const char *ICPIndexAssembly = R"(
+^0 = module: (path: "a.o", hash: (0, 0, 0, 0, 0))
+^1 = module: (path: "b.o", hash: (0, 0, 0, 0, 0))
+^2 = gv: (guid: 1, summaries: (function: (module: ^0, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), insts: 5, calls: ((callee: ^3, hotness: hot, icpTarget: 1), (callee: ^4, hotness: cold)))))
+^3 = gv: (guid: 2, summaries: (function: (module: ^1, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), insts: 500)))
+^4 = gv: (guid: 3, summaries: (function: (module: ^1, flags: (linkage: external, visibility: default, notEligibleToImport: 0, live: 1, dsoLocal: 0, canAutoHide: 0), insts: 10)))
+)";
+
+FunctionImporter::FunctionsToImportTy
+computeImportsIntoA(const char *Assembly = IndexAssembly) {
+  SMDiagnostic Err;
+  std::unique_ptr<ModuleSummaryIndex> Index =
+      parseSummaryIndexAssembly(MemoryBufferRef(Assembly, "index"), Err);
+  EXPECT_TRUE(Index);
+  if (!Index)
+    return {};
+
+  StringMap<GVSummaryMapTy> ModuleToDefinedGVSummaries;
+  Index->collectDefinedGVSummariesPerModule(ModuleToDefinedGVSummaries);
+  StringMap<FunctionImporter::ImportMapTy> ImportLists;
+  StringMap<FunctionImporter::ExportSetTy> ExportLists;
+  ComputeCrossModuleImport(*Index, ModuleToDefinedGVSummaries, ImportLists,
+                           ExportLists);
+  EXPECT_TRUE(ImportLists["b.o"].empty());
+  return ImportLists["a.o"].lookup("b.o");
+}
+
+TEST(FunctionImportTest, NoTotalLimit) {
+  EXPECT_EQ(computeImportsIntoA(),
+            (FunctionImporter::FunctionsToImportTy{2, 3, 4}));
+}
+
+TEST(FunctionImportTest, TotalLimit) {
+  // The imports are taken by benefit per instruction: the hot callee first,
+  // then the smaller of the other two, which leaves no room for the last one.
+  {
+    ScopedImportLimit Limit(25);
+    EXPECT_EQ(computeImportsIntoA(),
+              (FunctionImporter::FunctionsToImportTy{2, 3}));
+  }
+  {
+    ScopedImportLimit Limit(50);
+    EXPECT_EQ(computeImportsIntoA(),
+              (FunctionImporter::FunctionsToImportTy{2, 3, 4}));
+  }
+  {
+    ScopedImportLimit Limit(5);
+    EXPECT_TRUE(computeImportsIntoA().empty());
+  }
+}
+
+TEST(FunctionImportTest, ForceImportICPTargets) {
+  // The promotion target is too large to be imported by default.
+  EXPECT_TRUE(computeImportsIntoA(ICPIndexAssembly).empty());
+
+  ScopedOption<bool> Force("force-import-icp-targets", true);
+  EXPECT_EQ(computeImportsIntoA(ICPIndexAssembly),
+            (FunctionImporter::FunctionsToImportTy{2}));
+  // It is still subject to the total limit.
+  {
+    ScopedImportLimit Limit(100);
+    EXPECT_TRUE(computeImportsIntoA(ICPIndexAssembly).empty());
+  }
+}
+
+} // end anonymous namespace
@@ -0,0 +1,212 @@
+//===- MemProfUseTest.cpp - Memory profile use tests ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/ProfileData/InstrProfWriter.h"
+#include "llvm/ProfileData/MemProf.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Transforms/Instrumentation/MemProfiler.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// foo allocates at lines 3, 4 and 5 of the file, and at line 6 of bar inlined
+// at line 7.
+const char *ModuleIR = R"IR(
+define i8* @_Z3foov() !dbg !4 {
+  %cold = call i8* @_Znwm(i64 8), !dbg !6
+  %hot = call i8* @malloc(i64 8), !dbg !7
+  %mixed = call i8* @_Znam(i64 8), !dbg !8
+  %inlined = call i8* @_Znwm(i64 8), !dbg !10
+  %unknown = call i8* @_Znwm(i64 8), !dbg !12
+  ret i8* %cold
+}
+
+declare i8* @_Znwm(i64)
+declare i8* @_Znam(i64)
+declare i8* @malloc(i64)
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!2}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C_plus_plus, file: !1, producer: "", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug)
+!1 = !DIFile(filename: "t.cpp", directory: "/")
+!2 = !{i32 2, !"Debug Info Version", i32 3}
+!3 = !DISubroutineType(types: !{})
+!4 = distinct !DISubprogram(name: "foo", linkageName: "_Z3foov", scope: !1, file: !1, line: 1, type: !3, unit: !0, spFlags: DISPFlagDefinition)
+!5 = distinct !DISubprogram(name: "bar", linkageName: "_Z3barv", scope: !1, file: !1, line: 5, type: !3, unit: !0, spFlags: DISPFlagDefinition)
+!6 = !DILocation(line: 3, column: 10, scope: !4)
+!7 = !DILocation(line: 4, column: 10, scope: !4)
+!8 = !DILocation(line: 5, column: 10, scope: !4)
+!9 = !DILocation(line: 7, column: 3, scope: !4)
+!10 = !DILocation(line: 6, column: 10, scope: !5, inlinedAt: !9)
+!11 = !DILocation(line: 8, column: 3, scope: !4)
+!12 = !DILocation(line: 6, column: 10, scope: !5, inlinedAt: !11)
+)IR";
+
+memprof::MemProfRecord makeRecord(
+    std::initializer_list<memprof::MemProfRecord::Frame> CallStack,
+    uint32_t Size, uint64_t AccessCount, uint32_t Lifetime) {
+  memprof::MemProfRecord Record;
+  Record.CallStack = CallStack;
+  Record.Info = memprof::PortableMemInfoBlock(
+      memprof::MemInfoBlock(Size, AccessCount, /*alloc_timestamp=*/0,
+                            /*dealloc_timestamp=*/Lifetime, 0, 0));
+  return Record;
+}
+
+class ScopedHotColdNew {
+  cl::opt<bool> *Opt;
+  bool OldValue;
+
+public:
+  ScopedHotColdNew(bool Value) {
+    Opt = static_cast<cl::opt<bool> *>(
+        cl::getRegisteredOptions()["memprof-hot-cold-new"]);
+    OldValue = *Opt;
+    *Opt = Value;
+  }
+  ~ScopedHotColdNew() { *Opt = OldValue; }
+};
+
+class MemProfUseTest : public testing::Test {
+protected:
+  void SetUp() override {
+    uint64_t Foo = Function::getGUID("_Z3foov");
+    uint64_t Bar = Function::getGUID("_Z3barv");
+    uint64_t Main = Function::getGUID("main");
+    // Lifetimes are in milliseconds: the long-lived allocations live 300s.
+    InstrProfWriter Writer;
+    ASSERT_THAT_ERROR(Writer.mergeProfileKind(InstrProfKind::MemProf),
+                      Succeeded());
+    auto Warn = [](Error E) { consumeError(std::move(E)); };
+    Writer.addRecord(
+        makeRecord({{Foo, 2, 10, false}, {Main, 1, 3, false}}, 8, 1, 300000),
+        Warn);
+    Writer.addRecord(
+        makeRecord({{Foo, 3, 10, false}, {Main, 1, 3, false}}, 8, 80000, 10),
+        Warn);
+    Writer.addRecord(
+        makeRecord({{Foo, 4, 10, false}, {Main, 1, 3, false}}, 8, 1, 300000),
+        Warn);
+    Writer.addRecord(
+        makeRecord({{Foo, 4, 10, false}, {Main, 2, 3, false}}, 8, 80000, 10),
+        Warn);
+    // As symbolized, the first frame of each address is marked as not inline.
+    Writer.addRecord(makeRecord({{Bar, 1, 10, false},
+                                 {Foo, 6, 3, true},
+                                 {Main, 1, 3, false}},
+                                8, 1, 300000),
+                     Warn);
+
+    ASSERT_FALSE(sys::fs::createTemporaryFile("memprof", "profdata",
+                                              ProfilePath));
+    Remover.setFile(ProfilePath);
+    std::error_code EC;
+    raw_fd_ostream OS(ProfilePath, EC, sys::fs::OF_None);
+    ASSERT_FALSE(EC);
+    Writer.write(OS);
+  }
+
+  std::unique_ptr<Module> runMemProfUse() {
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(ModuleIR, Err, Ctx);
+    if (!M)
+      Err.print("MemProfUseTest", errs());
+    EXPECT_TRUE(M);
+
+    LoopAnalysisManager LAM;
+    FunctionAnalysisManager FAM;
+    CGSCCAnalysisManager CGAM;
+    ModuleAnalysisManager MAM;
+    PassBuilder PB;
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    MemProfUsePass(std::string(ProfilePath)).run(*M, MAM);
+    return M;
+  }
+
+  static CallBase *getCall(Module &M, StringRef Name) {
+    Function *F = M.getFunction("_Z3foov");
+    for (Instruction &I : F->getEntryBlock())
+      if (I.getName() == Name)
+        return cast<CallBase>(&I);
+    return nullptr;
+  }
+
+  static std::string getAttribute(CallBase *CB, StringRef Kind) {
+    return CB->getFnAttr(Kind).getValueAsString().str();
+  }
+
+  LLVMContext Ctx;
+  SmallString<128> ProfilePath;
+  FileRemover Remover;
+};
+
+TEST_F(MemProfUseTest, AnnotatesAllocations) {
+  std::unique_ptr<Module> M = runMemProfUse();
+  ASSERT_TRUE(M);
+
+  CallBase *Cold = getCall(*M, "cold");
+  EXPECT_EQ(getAttribute(Cold, "memprof"), "cold");
+  EXPECT_EQ(getAttribute(Cold, "memprof-lifetime"), "long");
+
+  CallBase *Hot = getCall(*M, "hot");
+  EXPECT_EQ(getAttribute(Hot, "memprof"), "hot");
+  EXPECT_EQ(getAttribute(Hot, "memprof-lifetime"), "short");
+
+  // The allocations made from different contexts disagree.
+  CallBase *Mixed = getCall(*M, "mixed");
+  EXPECT_EQ(getAttribute(Mixed, "memprof"), "notcold");
+  EXPECT_FALSE(Mixed->hasFnAttr("memprof-lifetime"));
+
+  // Inlined allocation sites are matched on their whole inlined call stack.
+  CallBase *Inlined = getCall(*M, "inlined");
+  EXPECT_EQ(getAttribute(Inlined, "memprof"), "cold");
+  CallBase *Unknown = getCall(*M, "unknown");
+  EXPECT_FALSE(Unknown->hasFnAttr("memprof"));
+  EXPECT_EQ(Unknown->getCalledFunction()->getName(), "_Znwm");
+}
+
+TEST_F(MemProfUseTest, HotColdNew) {
+  ScopedHotColdNew HotColdNew(true);
+  std::unique_ptr<Module> M = runMemProfUse();
+  ASSERT_TRUE(M);
+
+  auto ExpectHint = [&](StringRef Name, StringRef Callee, unsigned Hint) {
+    CallBase *CB = getCall(*M, Name);
+    ASSERT_TRUE(CB);
+    EXPECT_EQ(CB->getCalledFunction()->getName(), Callee);
+    ASSERT_EQ(CB->arg_size(), 2u);
+    EXPECT_EQ(cast<ConstantInt>(CB->getArgOperand(1))->getZExtValue(), Hint);
+    EXPECT_EQ(getAttribute(CB, "memprof"), Hint == 1 ? "cold" : "notcold");
+  };
+  ExpectHint("cold", "_Znwm12__hot_cold_t", 1);
+  ExpectHint("mixed", "_Znam12__hot_cold_t", 128);
+  ExpectHint("inlined", "_Znwm12__hot_cold_t", 1);
+
+  // malloc has no hinted variant.
+  CallBase *Hot = getCall(*M, "hot");
+  EXPECT_EQ(Hot->getCalledFunction()->getName(), "malloc");
+  EXPECT_EQ(getAttribute(Hot, "memprof"), "hot");
+}
+
+} // end anonymous namespace
@@ -18,6 +18,7 @@
 #include "CodeGenIntrinsics.h"
 #include "CodeGenSchedule.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Timer.h"
@@ -530,6 +531,12 @@ void CodeGenTarget::reverseBitsForLittleEndianEncoding() {
   if (!isLittleEndianEncoding())
     return;
 
+  // Several backends may run on the same records, e.g. with both
+  // -gen-emitter and -gen-disassembler. Reverse the bits only once.
+  static SmallPtrSet<const RecordKeeper *, 1> ReversedRecords;
+  if (!ReversedRecords.insert(&Records).second)
+    return;
+
   std::vector<Record *> Insts =
       Records.getAllDerivedDefinitions("InstructionEncoding");
   for (Record *R : Insts) {
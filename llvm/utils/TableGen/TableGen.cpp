@@ -69,8 +69,10 @@ cl::opt<bool> EmitLongStrLiterals(
 } // end namespace llvm
 
 namespace {
-cl::opt<ActionType> Action(
-    cl::desc("Action to perform:"),
+cl::list<ActionType> Actions(
+    cl::desc("Actions to perform, each on the same parse of the records. The "
+             "output of the first one is written to -o, that of the others to "
+             "the -extra-o files:"),
     cl::values(
         clEnumValN(PrintRecords, "print-records",
                    "Print all records to stdout (default)"),
@@ -145,7 +147,8 @@ cl::opt<std::string> Class("class", cl::desc("Print Enum list for this class"),
                            cl::value_desc("class name"),
                            cl::cat(PrintEnumsCat));
 
-bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
+bool LLVMTableGenMain(ActionType Action, raw_ostream &OS,
+                      RecordKeeper &Records) {
   switch (Action) {
   case PrintRecords:
     OS << Records;              // No argument, dump all contents
@@ -282,7 +285,16 @@ int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
   cl::ParseCommandLineOptions(argc, argv);
 
-  return TableGenMain(argv[0], &LLVMTableGenMain);
+  // Without an explicit action, print all records.
+  if (Actions.empty())
+    Actions.push_back(PrintRecords);
+
+  std::vector<std::function<TableGenMainFn>> MainFns;
+  for (ActionType Action : Actions)
+    MainFns.push_back([Action](raw_ostream &OS, RecordKeeper &Records) {
+      return LLVMTableGenMain(Action, OS, Records);
+    });
+  return TableGenMain(argv[0], MainFns);
 }
 
 #ifndef __has_feature
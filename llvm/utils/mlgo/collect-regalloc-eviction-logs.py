@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+#
+#===- collect-regalloc-eviction-logs.py - Collect eviction training logs -===#
+#
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+#===------------------------------------------------------------------------===#
+
+"""
+Compile a corpus of IR files with llc in the development mode of the ML
+register allocation eviction advisor, and collect a training log for each of
+them. Example usage:
+
+  collect-regalloc-eviction-logs.py --llc build/bin/llc -o logs/ corpus/
+  collect-regalloc-eviction-logs.py --llc build/bin/llc -o logs/ \\
+      --model saved-model/ corpus/ -- -mcpu=skylake
+
+The logs record the features the advisor sees at each eviction decision, the
+decision taken, and the reward computed from RegAllocScore for the function.
+Without --model, the decisions are those of the default advisor, which is
+what a first model is trained to imitate; with --model they are those of the
+given model under training.
+
+The directory written with -o also contains a manifest.json with the list of
+logs, for use by the trainer. Training itself is done with the tools of
+https://github.com/google/ml-compiler-opt. The resulting saved model can then
+be compiled into llc by configuring LLVM with -DLLVM_HAVE_TF_AOT=ON and
+-DLLVM_RAEVICT_MODEL_PATH=<saved model>, and used with
+-regalloc-enable-advisor=release.
+
+llc must be built with LLVM_HAVE_TF_API for the development mode to be
+available.
+"""
+from __future__ import absolute_import, division, print_function
+
+import argparse
+import json
+import multiprocessing
+import os
+import subprocess
+import sys
+
+
+def find_inputs(paths):
+  for path in paths:
+    if not os.path.isdir(path):
+      yield path
+      continue
+    for root, _, files in os.walk(path):
+      for name in sorted(files):
+        if name.endswith(('.ll', '.bc')):
+          yield os.path.join(root, name)
+
+
+def log_path_for(args, input_path):
+  name = os.path.relpath(os.path.abspath(input_path), args.common_root)
+  return os.path.join(args.output, name.replace(os.sep, '_') + '.log')
+
+
+def collect(job):
+  args, input_path = job
+  log_path = log_path_for(args, input_path)
+  command = [args.llc, input_path, '-O2', '-filetype=obj', '-o', os.devnull,
+             '-regalloc-enable-advisor=development',
+             '-regalloc-training-log=' + log_path]
+  if args.model:
+    command.append('-regalloc-model=' + args.model)
+  command += args.llc_args
+  result = subprocess.run(command, stdout=subprocess.DEVNULL,
+                          stderr=subprocess.PIPE, universal_newlines=True)
+  return input_path, log_path, result.returncode, result.stderr
+
+
+def main():
+  parser = argparse.ArgumentParser(
+      description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('inputs', nargs='+', metavar='PATH',
+                      help='IR file, or directory to search for .ll and .bc '
+                      'files')
+  parser.add_argument('--llc', required=True, help='path to llc')
+  parser.add_argument('-o', dest='output', required=True,
+                      help='directory to write the logs to')
+  parser.add_argument('--model',
+                      help='saved model under training to take the eviction '
+                      'decisions')
+  parser.add_argument('-j', dest='jobs', type=int,
+                      default=multiprocessing.cpu_count(),
+                      help='number of llc processes to run in parallel '
+                      '(default: %(default)s)')
+  # Everything after -- is passed to llc.
+  argv = sys.argv[1:]
+  llc_args = []
+  if '--' in argv:
+    llc_args = argv[argv.index('--') + 1:]
+    argv = argv[:argv.index('--')]
+  args = parser.parse_args(argv)
+  args.llc_args = llc_args
+
+  inputs = list(find_inputs(args.inputs))
+  if not inputs:
+    sys.exit('error: no .ll or .bc files found')
+  args.common_root = os.path.commonpath(
+      [os.path.dirname(os.path.abspath(p)) for p in inputs])
+  if not os.path.isdir(args.output):
+    os.makedirs(args.output)
+
+  logs = []
+  failures = 0
+  pool = multiprocessing.Pool(args.jobs)
+  try:
+    results = pool.imap(collect, [(args, p) for p in inputs])
+    for input_path, log_path, returncode, stderr in results:
+      if returncode != 0:
+        if 'Unknown command line argument' in stderr and \
+            'regalloc-training-log' in stderr:
+          sys.exit('error: %s does not support the development mode of the '
+                   'eviction advisor; build it with LLVM_HAVE_TF_API:\n%s' %
+                   (args.llc, stderr))
+        print('warning: %s failed:\n%s' % (input_path, stderr),
+              file=sys.stderr)
+        failures += 1
+        continue
+      # Skip the logs of modules without any eviction decision.
+      if os.path.exists(log_path) and os.path.getsize(log_path):
+        logs.append(os.path.relpath(log_path, args.output))
+  finally:
+    pool.close()
+    pool.join()
+
+  with open(os.path.join(args.output, 'manifest.json'), 'w') as f:
+    json.dump({'logs': sorted(logs), 'model': args.model,
+               'llc_args': args.llc_args}, f, indent=2)
+  print('%d logs from %d inputs, %d failed' % (len(logs), len(inputs),
+                                               failures))
+  if failures:
+    sys.exit(1)
+
+
+if __name__ == '__main__':
+  main()
@@ -226,7 +226,9 @@ MLIR_CAPI_EXPORTED void mlirLocationPrint(MlirLocation location,
 /// Creates a new, empty module and transfers ownership to the caller.
 MLIR_CAPI_EXPORTED MlirModule mlirModuleCreateEmpty(MlirLocation location);
 
-/// Parses a module from the string and transfers ownership to the caller.
+/// Parses a module from the string and transfers ownership to the caller. The
+/// string may either contain textual IR or bytecode, such as the output of
+/// mlirOperationWriteBytecode.
 MLIR_CAPI_EXPORTED MlirModule mlirModuleCreateParse(MlirContext context,
                                                     MlirStringRef module);
 
@@ -476,6 +478,11 @@ MLIR_CAPI_EXPORTED void mlirOperationPrintWithFlags(MlirOperation op,
                                                     MlirStringCallback callback,
                                                     void *userData);
 
+/// Same as mlirOperationPrint but writing the bytecode format out.
+MLIR_CAPI_EXPORTED void mlirOperationWriteBytecode(MlirOperation op,
+                                                   MlirStringCallback callback,
+                                                   void *userData);
+
 /// Prints an operation to stderr.
 MLIR_CAPI_EXPORTED void mlirOperationDump(MlirOperation op);
 
@@ -0,0 +1,88 @@
+//===- BytecodeReader.h - MLIR Bytecode Reader ------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header defines interfaces to read MLIR bytecode files/streams.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_BYTECODE_BYTECODEREADER_H
+#define MLIR_BYTECODE_BYTECODEREADER_H
+
+#include "mlir/IR/Location.h"
+#include "mlir/Support/LLVM.h"
+#include "mlir/Support/LogicalResult.h"
+#include <memory>
+
+namespace llvm {
+class MemoryBufferRef;
+} // namespace llvm
+
+namespace mlir {
+class Block;
+class MLIRContext;
+class Operation;
+
+/// The BytecodeReader allows to load MLIR bytecode files, while keeping the
+/// state explicitly available in order to support lazy loading. With lazy
+/// loading, the regions of operations that are isolated from above are not
+/// parsed when the top level is read, but only when the operation is
+/// materialized, for example when a pass needs to look at them. The
+/// `buffer` must outlive the reader, and the reader must outlive the
+/// operations that haven't been materialized yet. Operations that haven't been
+/// materialized must not be erased, or verified.
+class BytecodeReader {
+public:
+  /// Create a bytecode reader for the given buffer. If `lazyLoad` is true,
+  /// the regions of operations that are isolated from above are only read
+  /// when they are materialized.
+  BytecodeReader(llvm::MemoryBufferRef buffer, MLIRContext *context,
+                 bool lazyLoad = false);
+  ~BytecodeReader();
+
+  /// Read the operations defined within the bytecode into the given block. If
+  /// `sourceFileLoc` is non-null, it is populated with a file location
+  /// representing the start of the bytecode buffer.
+  LogicalResult readTopLevel(Block *block,
+                             LocationAttr *sourceFileLoc = nullptr);
+
+  /// Return the number of ops that haven't been materialized yet.
+  int64_t getNumOpsToMaterialize() const;
+
+  /// Return true if the provided op is materializable, i.e. its regions
+  /// haven't been read yet.
+  bool isMaterializable(Operation *op);
+
+  /// Materialize the provided operation, reading its regions from the
+  /// bytecode. Operations nested in these regions that are isolated from above
+  /// become materializable in turn.
+  LogicalResult materialize(Operation *op);
+
+  /// Materialize all the operations that haven't been materialized yet,
+  /// including the ones that become materializable in the process.
+  LogicalResult materializeAll();
+
+  class Impl;
+
+private:
+  std::unique_ptr<Impl> impl;
+};
+
+/// Returns true if the given buffer starts with the magic bytes that signal
+/// MLIR bytecode.
+bool isBytecode(llvm::MemoryBufferRef buffer);
+
+/// Read the operations defined within the given memory buffer, containing MLIR
+/// bytecode, into the provided block. If `sourceFileLoc` is non-null, it is
+/// populated with a file location representing the start of the buffer.
+LogicalResult readBytecodeFile(llvm::MemoryBufferRef buffer, Block *block,
+                               MLIRContext *context,
+                               LocationAttr *sourceFileLoc = nullptr);
+
+} // namespace mlir
+
+#endif // MLIR_BYTECODE_BYTECODEREADER_H
@@ -0,0 +1,76 @@
+//===- TileSizeSelection.h - Cost model driven tile sizes -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares a simple target-aware cost model that selects tile sizes
+// for Linalg operations, and groups contractions and convolutions with the
+// producers that tiling and fusion on tensors would fuse into them.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_DIALECT_LINALG_TRANSFORMS_TILESIZESELECTION_H
+#define MLIR_DIALECT_LINALG_TRANSFORMS_TILESIZESELECTION_H
+
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Utils/Utils.h"
+
+namespace mlir {
+namespace linalg {
+
+/// Target properties that drive the tile size selection.
+struct TileSizeSelectionTarget {
+  /// The size of the innermost data cache. Tiles are sized such that the data
+  /// they access fits into half of it.
+  int64_t l1CacheSizeInBytes = 32 * 1024;
+
+  /// The width of the vector registers. The innermost, unit-stride parallel
+  /// loop gets a tile size that is a multiple of the number of lanes.
+  int64_t vectorSizeInBits = 256;
+
+  /// Returns the target properties for `op`, with the defaults overridden by
+  /// the `dlti.l1_cache_size_in_bytes` and `dlti.vector_size_in_bits` entries
+  /// of the closest data layout specification enclosing `op`.
+  static TileSizeSelectionTarget get(Operation *op);
+};
+
+/// Selects a tile size for every loop of `op`, where 0 means that the loop is
+/// not tiled. The tile sizes are grown greedily, each time doubling the tile
+/// size of the loop that most improves the ratio of the iterations to the
+/// bytes accessed by a tile, as long as the accessed data fits into the cache
+/// budget of `target`. Loops with a dynamic range are considered unbounded.
+SmallVector<int64_t> selectTileSizes(LinalgOp op,
+                                     const TileSizeSelectionTarget &target);
+
+/// A tiling and fusion schedule for a contraction or convolution on tensors.
+struct TileAndFuseSchedule {
+  /// The operation that is tiled.
+  LinalgOp rootOp;
+
+  /// The tile sizes of the loops of `rootOp`, see `selectTileSizes`.
+  SmallVector<int64_t> tileSizes;
+
+  /// The Linalg operations on tensors producing the operands of `rootOp`,
+  /// directly or transitively, to fuse into the tile loop nest of `rootOp`.
+  SmallVector<LinalgOp> fusedProducers;
+};
+
+/// Computes the tiling and fusion schedules for all contractions and
+/// convolutions on tensors nested in `op`, using the target properties of each
+/// of them. Other Linalg operations only appear as producers fused into a
+/// schedule, while producers that are contractions or convolutions get their
+/// own schedule instead of being recomputed for every tile.
+SmallVector<TileAndFuseSchedule> computeTileAndFuseSchedules(Operation *op);
+
+/// Applies `schedule` using `tileConsumerAndFuseProducers`, only fusing the
+/// producers of the schedule. Returns failure if no loop is tiled.
+FailureOr<TileLoopNest>
+applyTileAndFuseSchedule(OpBuilder &b, const TileAndFuseSchedule &schedule);
+
+} // namespace linalg
+} // namespace mlir
+
+#endif // MLIR_DIALECT_LINALG_TRANSFORMS_TILESIZESELECTION_H
@@ -345,8 +345,11 @@ public:
              Optional<LinalgLoopDistributionOptions> tileDistribution);
 
   /// Fuse the producer of `consumerOpOperand` into the tile loop nest. Returns
-  /// the fused producer or fails if fusion is not possible.
-  FailureOr<LinalgOp> fuseProducer(OpBuilder &b, OpOperand *consumerOpOperand);
+  /// the fused producer or fails if fusion is not possible, or if
+  /// `controlFn` is provided and returns false for the producer.
+  FailureOr<LinalgOp>
+  fuseProducer(OpBuilder &b, OpOperand *consumerOpOperand,
+               function_ref<bool(LinalgOp)> controlFn = nullptr);
 
   /// Returns the replacement results for the original untiled root operation.
   ValueRange getRootOpReplacementResults();
@@ -393,11 +396,13 @@ private:
 
 /// Tiles `consumerOp` and fuses its dependencies if possible. Uses the
 /// `tileSizes`, `tileInterchange`, and `tileDistribution` parameters to control
-/// the tiling.
+/// the tiling. If `controlFn` is provided, only the producers (of the original
+/// untiled IR) for which it returns true are fused.
 FailureOr<TileLoopNest> tileConsumerAndFuseProducers(
     OpBuilder &b, LinalgOp consumerOp, ArrayRef<int64_t> tileSizes,
     ArrayRef<int64_t> tileInterchange,
-    Optional<LinalgLoopDistributionOptions> tileDistribution);
+    Optional<LinalgLoopDistributionOptions> tileDistribution,
+    function_ref<bool(LinalgOp)> controlFn = nullptr);
 
 //===----------------------------------------------------------------------===//
 // Generic op region utilities
@@ -22,17 +22,17 @@ namespace mlir {
 class TypeConverter;
 
 /// Defines a parallelization strategy. Any independent loop is a candidate
-/// for parallelization. The loop is made parallel if (1) allowed by the
-/// strategy (e.g., AnyStorageOuterLoop considers either a dense or sparse
-/// outermost loop only), and (2) the generated code is an actual for-loop
-/// (and not a co-iterating while-loop).
+/// for parallelization, as well as any reduction loop whose reduction has been
+/// scalarized (which is then combined with an `scf.reduce`). The loop is made
+/// parallel if (1) allowed by the strategy (e.g., AnyStorageOuterLoop
+/// considers either a dense or sparse outermost loop only), and (2) the
+/// generated code is an actual for-loop (and not a co-iterating while-loop).
 enum class SparseParallelizationStrategy {
   kNone,
   kDenseOuterLoop,
   kAnyStorageOuterLoop,
   kDenseAnyLoop,
   kAnyStorageAnyLoop
-  // TODO: support reduction parallelization too?
 };
 
 /// Converts command-line parallelization flag to the strategy enum.
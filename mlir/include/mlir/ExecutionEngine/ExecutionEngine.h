@@ -22,6 +22,7 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 
 namespace llvm {
 template <typename T> class Expected;
@@ -35,9 +36,16 @@ namespace mlir {
 
 class ModuleOp;
 
-/// A simple object cache following Lang's LLJITWithObjectCache example.
+/// A simple object cache following Lang's LLJITWithObjectCache example. The
+/// objects are keyed by module identifier. If a cache directory is provided,
+/// the objects are also persisted to and loaded from files in that directory,
+/// which requires module identifiers that uniquely identify the compiled code.
+/// The cache is safe to use from concurrent compile threads.
 class SimpleObjectCache : public llvm::ObjectCache {
 public:
+  explicit SimpleObjectCache(StringRef cacheDir = {})
+      : cacheDir(cacheDir.str()) {}
+
   void notifyObjectCompiled(const llvm::Module *m,
                             llvm::MemoryBufferRef objBuffer) override;
   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *m) override;
@@ -45,7 +53,15 @@ public:
   /// Dump cached object to output file `filename`.
   void dumpToObjectFile(StringRef filename);
 
+  /// Returns true if the objects are persisted in a cache directory.
+  bool isPersistent() const { return !cacheDir.empty(); }
+
 private:
+  /// Returns the path of the file persisting the object of `m`.
+  std::string getObjectPath(const llvm::Module *m) const;
+
+  std::string cacheDir;
+  std::mutex mutex;
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cachedObjects;
 };
 
@@ -78,6 +94,18 @@ struct ExecutionEngineOptions {
   /// the object generated for the given module.
   bool enableObjectCache = true;
 
+  /// If `objectCacheDir` is provided along with `enableObjectCache`, the
+  /// generated objects are persisted in this directory, keyed by a hash of the
+  /// LLVM module after the `transformer` ran and of the target machine, and
+  /// reused by later execution engines instead of generating code again.
+  StringRef objectCacheDir = {};
+
+  /// If `numCompileThreads` is non-zero, the LLVM module is split into
+  /// partitions of functions that are compiled concurrently on that many
+  /// threads when the engine is created. Dumping the object code to a file is
+  /// only supported for a single partition.
+  unsigned numCompileThreads = 0;
+
   /// If enable `enableGDBNotificationListener` is set, the JIT compiler will
   /// notify the llvm's global GDB notification listener.
   bool enableGDBNotificationListener = true;
@@ -100,7 +128,8 @@ struct ExecutionEngineOptions {
 class ExecutionEngine {
 public:
   ExecutionEngine(bool enableObjectCache, bool enableGDBNotificationListener,
-                  bool enablePerfNotificationListener);
+                  bool enablePerfNotificationListener,
+                  StringRef objectCacheDir = {});
 
   /// Creates an execution engine for the given module.
   static llvm::Expected<std::unique_ptr<ExecutionEngine>>
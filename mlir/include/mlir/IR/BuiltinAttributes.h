@@ -10,6 +10,7 @@
 #define MLIR_IR_BUILTINATTRIBUTES_H
 
 #include "mlir/IR/BuiltinAttributeInterfaces.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/IR/SubElementInterfaces.h"
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/Sequence.h"
@@ -736,6 +737,22 @@ public:
 };
 } // namespace mlir
 
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr
+//===----------------------------------------------------------------------===//
+
+namespace mlir {
+class BuiltinDialect;
+
+/// A handle to a resource blob of the builtin dialect, referenced by a
+/// DenseResourceElementsAttr.
+using DenseResourceElementsHandle = DialectResourceBlobHandle<BuiltinDialect>;
+
+/// The interface providing the resource blob manager of the builtin dialect.
+using BuiltinBlobManagerInterface =
+    ResourceBlobManagerDialectInterfaceBase<DenseResourceElementsHandle>;
+} // namespace mlir
+
 //===----------------------------------------------------------------------===//
 // Tablegen Attribute Declarations
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,359 @@
+//===- DialectResourceBlobManager.h - Dialect Blob Management ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines utility classes for referencing and managing resource
+// blobs, i.e. large chunks of binary data owned outside of the MLIRContext.
+// Attributes refer to these blobs through a handle, which allows for large
+// constants to be shared without copying or hashing their contents.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_IR_DIALECTRESOURCEBLOBMANAGER_H
+#define MLIR_IR_DIALECTRESOURCEBLOBMANAGER_H
+
+#include "mlir/IR/DialectInterface.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/FunctionExtras.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/RWMutex.h"
+#include <memory>
+
+namespace mlir {
+
+//===----------------------------------------------------------------------===//
+// AsmResourceBlob
+//===----------------------------------------------------------------------===//
+
+/// This class represents a processed binary blob of data. A resource blob is
+/// essentially a collection of data, potentially mutable, with an associated
+/// deleter function (used if the data needs to be destroyed).
+class AsmResourceBlob {
+public:
+  /// A deleter function that frees a blob given the data, allocation size, and
+  /// allocation aligment.
+  using DeleterFn =
+      llvm::unique_function<void(void *data, size_t size, size_t align)>;
+
+  AsmResourceBlob() = default;
+  AsmResourceBlob(ArrayRef<char> data, size_t dataAlignment, DeleterFn deleter,
+                  bool dataIsMutable)
+      : data(data), dataAlignment(dataAlignment), deleter(std::move(deleter)),
+        dataIsMutable(dataIsMutable) {}
+  AsmResourceBlob(AsmResourceBlob &&) = default;
+  AsmResourceBlob &operator=(AsmResourceBlob &&rhs) {
+    // Delete the current blob if necessary.
+    if (deleter)
+      deleter(const_cast<char *>(data.data()), data.size(), dataAlignment);
+
+    // Take the data entries from rhs.
+    data = rhs.data;
+    dataAlignment = rhs.dataAlignment;
+    deleter = std::move(rhs.deleter);
+    dataIsMutable = rhs.dataIsMutable;
+    return *this;
+  }
+  AsmResourceBlob(const AsmResourceBlob &) = delete;
+  AsmResourceBlob &operator=(const AsmResourceBlob &) = delete;
+  ~AsmResourceBlob() {
+    if (deleter)
+      deleter(const_cast<char *>(data.data()), data.size(), dataAlignment);
+  }
+
+  /// Return the alignment of the underlying data.
+  size_t getDataAlignment() const { return dataAlignment; }
+
+  /// Return the raw underlying data of this blob.
+  ArrayRef<char> getData() const { return data; }
+
+  /// Return a mutable reference to the raw underlying data of this blob.
+  /// Asserts that the blob `isMutable`.
+  MutableArrayRef<char> getMutableData() {
+    assert(isMutable() &&
+           "cannot access mutable reference to non-mutable data");
+    return MutableArrayRef<char>(const_cast<char *>(data.data()), data.size());
+  }
+
+  /// Return if the data of this blob is mutable.
+  bool isMutable() const { return dataIsMutable; }
+
+  /// Return the deleter function of this blob.
+  DeleterFn &getDeleter() { return deleter; }
+  const DeleterFn &getDeleter() const { return deleter; }
+
+private:
+  /// The raw, properly aligned, blob data.
+  ArrayRef<char> data;
+
+  /// The alignment of the data.
+  size_t dataAlignment = 0;
+
+  /// An optional deleter function used to deallocate the underlying data when
+  /// necessary.
+  DeleterFn deleter;
+
+  /// Whether the data is mutable.
+  bool dataIsMutable = false;
+};
+
+/// This class provides a utility wrapper for creating heap allocated
+/// AsmResourceBlobs.
+class HeapAsmResourceBlob {
+public:
+  /// Create a new heap allocated blob with the given size and alignment.
+  /// `dataIsMutable` indicates if the allocated data can be mutated. By
+  /// default, we treat heap allocated blobs as mutable.
+  static AsmResourceBlob allocate(size_t size, size_t align,
+                                  bool dataIsMutable = true);
+
+  /// Create a new heap allocated blob and copy the provided data into it.
+  static AsmResourceBlob allocateAndCopy(ArrayRef<char> data, size_t align,
+                                         bool dataIsMutable = true);
+};
+
+/// This class provides a utility wrapper for creating "unmanaged"
+/// AsmResourceBlobs. The term "unmanaged" means that the blob data is owned by
+/// the user, unless a deleter is provided, and must outlive the blob.
+class UnmanagedAsmResourceBlob {
+public:
+  /// Create an unmanaged blob, referencing the provided data with the given
+  /// alignment. The data is not copied.
+  static AsmResourceBlob
+  allocate(ArrayRef<char> data, size_t align,
+           AsmResourceBlob::DeleterFn deleter = {},
+           bool dataIsMutable = false) {
+    return AsmResourceBlob(data, align, std::move(deleter), dataIsMutable);
+  }
+};
+
+/// Load the contents of the file at `path` into a blob with the given
+/// alignment, which must be a power of two. The file is memory mapped when
+/// possible, in which case the contents are not copied and the file is only
+/// paged in when the data is accessed. Returns failure, and sets
+/// `errorMessage` if provided, if the file could not be loaded.
+FailureOr<AsmResourceBlob>
+loadAsmResourceBlobFromFile(StringRef path, size_t align,
+                            std::string *errorMessage = nullptr);
+
+//===----------------------------------------------------------------------===//
+// DialectResourceBlobManager
+//===----------------------------------------------------------------------===//
+
+/// This class defines a manager for dialect resource blobs. Blobs are uniqued
+/// by a given key, and represented using AsmResourceBlobs. The contents of a
+/// blob are never hashed or copied by the manager.
+class DialectResourceBlobManager {
+public:
+  /// The class represents an individual entry of a blob.
+  class BlobEntry {
+  public:
+    /// Return the key used to reference this blob.
+    StringRef getKey() const { return key; }
+
+    /// Return the blob owned by this entry if one has been initialized. Returns
+    /// nullptr otherwise.
+    const AsmResourceBlob *getBlob() const { return blob ? &*blob : nullptr; }
+    AsmResourceBlob *getBlob() { return blob ? &*blob : nullptr; }
+
+    /// Set the blob owned by this entry.
+    void setBlob(AsmResourceBlob &&newBlob) { blob = std::move(newBlob); }
+
+  private:
+    /// Initialize this entry with the given key and blob.
+    void initialize(StringRef newKey, Optional<AsmResourceBlob> newBlob) {
+      key = newKey;
+      blob = std::move(newBlob);
+    }
+
+    /// The key used for this blob.
+    StringRef key;
+
+    /// The blob that is referenced by this entry if it is valid.
+    Optional<AsmResourceBlob> blob;
+
+    /// Allow access to the initialize method.
+    friend class DialectResourceBlobManager;
+  };
+
+  /// Return the blob registered for the given name, or nullptr if no blob
+  /// is registered.
+  BlobEntry *lookup(StringRef name);
+  const BlobEntry *lookup(StringRef name) const {
+    return const_cast<DialectResourceBlobManager *>(this)->lookup(name);
+  }
+
+  /// Update the blob for the entry defined by the provided name. This method
+  /// asserts that an entry for the given name exists in the manager.
+  void update(StringRef name, AsmResourceBlob &&newBlob);
+
+  /// Insert a new entry with the provided name and optional blob data. The name
+  /// may be modified during insertion if another entry already exists with
+  /// that name. Returns the inserted entry.
+  BlobEntry &insert(StringRef name, Optional<AsmResourceBlob> blob = {});
+
+  /// Insertion method that returns a dialect specific handle to the inserted
+  /// entry.
+  template <typename HandleT>
+  HandleT insert(typename HandleT::Dialect *dialect, StringRef name,
+                 Optional<AsmResourceBlob> blob = {}) {
+    BlobEntry &entry = insert(name, std::move(blob));
+    return HandleT(&entry, dialect);
+  }
+
+private:
+  /// A mutex to protect access to the blob map.
+  llvm::sys::SmartRWMutex<true> blobMapLock;
+
+  /// The internal map of tracked blobs. StringMap stores entries in distinct
+  /// allocations, so we can freely take references to the data without fear of
+  /// invalidation during additional insertion/deletion.
+  llvm::StringMap<BlobEntry> blobMap;
+};
+
+//===----------------------------------------------------------------------===//
+// DialectResourceBlobHandle
+//===----------------------------------------------------------------------===//
+
+/// This class defines a dialect specific handle to a resource blob. These
+/// handles are used by attributes to reference a blob, and are hashed and
+/// compared by the address of the referenced entry instead of its contents.
+template <typename DialectT>
+class DialectResourceBlobHandle {
+public:
+  using Dialect = DialectT;
+
+  DialectResourceBlobHandle(DialectResourceBlobManager::BlobEntry *entry,
+                            DialectT *dialect)
+      : entry(entry), dialect(dialect) {}
+
+  /// Return the human readable string key for this handle.
+  StringRef getKey() const { return entry->getKey(); }
+
+  /// Return the blob referenced by this handle if the underlying resource has
+  /// been initialized. Returns nullptr otherwise.
+  AsmResourceBlob *getBlob() { return entry->getBlob(); }
+  const AsmResourceBlob *getBlob() const { return entry->getBlob(); }
+
+  /// Return the dialect that owns the resource.
+  DialectT *getDialect() const { return dialect; }
+
+  /// Return the entry referenced by this handle.
+  DialectResourceBlobManager::BlobEntry *getEntry() const { return entry; }
+
+  bool operator==(const DialectResourceBlobHandle &other) const {
+    return entry == other.entry;
+  }
+  bool operator!=(const DialectResourceBlobHandle &other) const {
+    return !(*this == other);
+  }
+
+  /// Hash the handle by the referenced entry, the contents of the blob are
+  /// never hashed.
+  friend llvm::hash_code hash_value(const DialectResourceBlobHandle &handle) {
+    return llvm::hash_value(handle.entry);
+  }
+
+private:
+  /// The entry referenced by this handle.
+  DialectResourceBlobManager::BlobEntry *entry;
+
+  /// The dialect that owns the resource.
+  DialectT *dialect;
+};
+
+//===----------------------------------------------------------------------===//
+// ResourceBlobManagerDialectInterface
+//===----------------------------------------------------------------------===//
+
+/// This class implements a dialect interface that provides common functionality
+/// for interacting with a resource blob manager.
+class ResourceBlobManagerDialectInterface
+    : public DialectInterface::Base<ResourceBlobManagerDialectInterface> {
+public:
+  ResourceBlobManagerDialectInterface(Dialect *dialect)
+      : Base(dialect),
+        blobManager(std::make_shared<DialectResourceBlobManager>()) {}
+
+  /// Return the blob manager held by this interface.
+  DialectResourceBlobManager &getBlobManager() { return *blobManager; }
+  const DialectResourceBlobManager &getBlobManager() const {
+    return *blobManager;
+  }
+
+  /// Set the blob manager held by this interface, which allows for sharing the
+  /// blobs between different contexts.
+  void
+  setBlobManager(std::shared_ptr<DialectResourceBlobManager> newBlobManager) {
+    blobManager = std::move(newBlobManager);
+  }
+
+private:
+  /// The blob manager owned by the dialect implementing this interface.
+  std::shared_ptr<DialectResourceBlobManager> blobManager;
+};
+
+/// This class provides a base class for dialects implementing the resource
+/// blob interface. It provides several additional dialect specific utilities on
+/// top of the generic interface. `HandleT` is the type of the handle used to
+/// reference a resource blob.
+template <typename HandleT>
+class ResourceBlobManagerDialectInterfaceBase
+    : public ResourceBlobManagerDialectInterface {
+public:
+  using ResourceBlobManagerDialectInterface::
+      ResourceBlobManagerDialectInterface;
+
+  /// Update the blob for the entry defined by the provided name. This method
+  /// asserts that an entry for the given name exists in the manager.
+  void update(StringRef name, AsmResourceBlob &&newBlob) {
+    getBlobManager().update(name, std::move(newBlob));
+  }
+
+  /// Insert a new resource blob entry with the provided name and optional blob
+  /// data. The name may be modified during insertion if another entry already
+  /// exists with that name. Returns a dialect specific handle to the inserted
+  /// entry.
+  HandleT insert(StringRef name, Optional<AsmResourceBlob> blob = {}) {
+    return getBlobManager().template insert<HandleT>(
+        static_cast<typename HandleT::Dialect *>(getDialect()), name,
+        std::move(blob));
+  }
+
+  /// Return a handle to the entry registered for the given name, inserting an
+  /// entry without a blob if there isn't one yet.
+  HandleT lookupOrInsert(StringRef name) {
+    if (DialectResourceBlobManager::BlobEntry *entry =
+            getBlobManager().lookup(name)) {
+      return HandleT(entry,
+                     static_cast<typename HandleT::Dialect *>(getDialect()));
+    }
+    return insert(name);
+  }
+
+  /// Return the interface of the dialect owning `HandleT` within the given
+  /// context, loading the dialect if necessary.
+  static ResourceBlobManagerDialectInterfaceBase &get(MLIRContext *ctx) {
+    auto *dialect = ctx->getOrLoadDialect<typename HandleT::Dialect>();
+    auto *interface = dialect->template getRegisteredInterface<
+        ResourceBlobManagerDialectInterface>();
+    assert(interface && "dialect does not provide a resource blob manager");
+    return static_cast<ResourceBlobManagerDialectInterfaceBase &>(*interface);
+  }
+
+  /// Insert a new resource blob entry within the given context. See `insert`
+  /// above for details.
+  static HandleT insert(MLIRContext *ctx, StringRef name,
+                        Optional<AsmResourceBlob> blob = {}) {
+    return get(ctx).insert(name, std::move(blob));
+  }
+};
+
+} // namespace mlir
+
+#endif // MLIR_IR_DIALECTRESOURCEBLOBMANAGER_H
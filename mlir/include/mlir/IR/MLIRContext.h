@@ -136,6 +136,15 @@ public:
     disableMultithreading(!enable);
   }
 
+  /// Set the flag specifying if statistics about the uniquing of attributes,
+  /// types, and affine structures are collected by the context. The command
+  /// line flag `--mlir-print-uniquer-statistics` enables the collection and
+  /// prints the statistics when the context is destroyed.
+  void enableUniquerStatistics(bool enable = true);
+
+  /// Print the uniquing statistics collected by the context to `os`.
+  void printUniquerStatistics(raw_ostream &os);
+
   /// Set a new thread pool to be used in this context. This method requires
   /// that multithreading is disabled for this context prior to the call. This
   /// allows to share a thread pool across multiple contexts, as well as
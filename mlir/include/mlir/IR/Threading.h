@@ -21,8 +21,50 @@
 #include "llvm/ADT/Sequence.h"
 #include "llvm/Support/ThreadPool.h"
 #include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
 namespace mlir {
+namespace detail {
+/// This class tracks the helper threads that joined a parallel loop. It is
+/// shared with the tasks enqueued on the thread pool, which may outlive the
+/// loop if they are only started once all of the elements have been processed.
+class ParallelForEachState {
+public:
+  /// Try to join the parallel loop as a helper. Returns false if the loop has
+  /// already been closed, in which case the helper must not touch any of the
+  /// state of the loop.
+  bool tryJoin() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed)
+      return false;
+    ++numActiveHelpers;
+    return true;
+  }
+
+  /// Signal that a helper that successfully joined has finished.
+  void leave() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--numActiveHelpers == 0)
+      helpersDone.notify_all();
+  }
+
+  /// Prevent any new helper from joining, and wait for the active ones to
+  /// finish.
+  void close() {
+    std::unique_lock<std::mutex> lock(mutex);
+    closed = true;
+    helpersDone.wait(lock, [&] { return numActiveHelpers == 0; });
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable helpersDone;
+  unsigned numActiveHelpers = 0;
+  bool closed = false;
+};
+} // namespace detail
 
 /// Invoke the given function on the elements between [begin, end)
 /// asynchronously. If the given function returns a failure when processing any
@@ -41,10 +83,7 @@ LogicalResult failableParallelForEach(MLIRContext *context, IteratorT begin,
 
   // If multithreading is disabled or there is a small number of elements,
   // process the elements directly on this thread.
-  // FIXME: ThreadPool should allow work stealing to avoid deadlocks when
-  // scheduling work within a worker thread.
-  if (!context->isMultithreadingEnabled() || numElements <= 1 ||
-      context->getThreadPool().isWorkerThread()) {
+  if (!context->isMultithreadingEnabled() || numElements <= 1) {
     for (; begin != end; ++begin)
       if (failed(func(*begin)))
         return failure();
@@ -68,18 +107,31 @@ LogicalResult failableParallelForEach(MLIRContext *context, IteratorT begin,
     }
   };
 
-  // Otherwise, process the elements in parallel.
+  // Otherwise, process the elements in parallel. The calling thread processes
+  // elements itself, and idle threads of the pool join in as they become
+  // available. This function may be invoked from within a worker thread (e.g.
+  // when running nested pass pipelines), so we never block on helpers that
+  // have not started: once the calling thread has run out of elements, it only
+  // waits for the helpers that are actively processing. Helpers that start
+  // afterwards find nothing left to do and return immediately. This keeps
+  // nested parallel regions from deadlocking the pool when all of its threads
+  // are waiting, and keeps each thread processing at most one element of this
+  // range at a time.
   llvm::ThreadPool &threadPool = context->getThreadPool();
   size_t numActions = std::min(numElements, threadPool.getThreadCount());
-  SmallVector<std::shared_future<void>> threadFutures;
-  threadFutures.reserve(numActions - 1);
-  for (unsigned i = 1; i < numActions; ++i)
-    threadFutures.emplace_back(threadPool.async(processFn));
+  auto state = std::make_shared<detail::ParallelForEachState>();
+  for (unsigned i = 1; i < numActions; ++i) {
+    threadPool.async([state, &processFn] {
+      if (state->tryJoin()) {
+        processFn();
+        state->leave();
+      }
+    });
+  }
   processFn();
 
-  // Wait for all of the threads to finish.
-  for (std::shared_future<void> &future : threadFutures)
-    future.wait();
+  // Wait for all of the active helpers to finish.
+  state->close();
   return failure(processingFailed);
 }
 
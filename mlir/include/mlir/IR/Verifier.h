@@ -10,6 +10,7 @@
 #define MLIR_IR_VERIFIER_H
 
 namespace mlir {
+class DominanceInfo;
 struct LogicalResult;
 class Operation;
 
@@ -17,6 +18,13 @@ class Operation;
 /// compiler bugs, on this operation and any nested operations. On error, this
 /// reports the error through the MLIRContext and returns failure.
 LogicalResult verify(Operation *op);
+
+/// Same as above, but check the dominance relationships within the regions of
+/// `op` with `domInfo`, which allows reusing dominance information that is
+/// already computed or caching it for later. Operations nested under `op` that
+/// are IsolatedFromAbove are still verified with their own dominance
+/// information.
+LogicalResult verify(Operation *op, DominanceInfo &domInfo);
 } // namespace mlir
 
 #endif
@@ -40,6 +40,10 @@ struct PassExecutionState {
   /// The set of preserved analyses for the current execution.
   detail::PreservedAnalyses preservedAnalyses;
 
+  /// The operations reported as changed by the current execution, if the pass
+  /// tracks its changes.
+  SmallVector<Operation *, 4> changedOps;
+
   /// This is a callback in the PassManager that allows to schedule dynamic
   /// pipelines that will be rooted at the provided operation.
   function_ref<LogicalResult(OpPassManager &, Operation *)> pipelineExecutor;
@@ -239,6 +243,17 @@ protected:
     getPassState().preservedAnalyses.preserve(id);
   }
 
+  /// Report that `op` was created or modified by the current execution of this
+  /// pass. If a pass reports the operations it changed, only the regions that
+  /// hold them are verified after the pass, instead of the whole current
+  /// operation, so any change must be reported. Erased operations must not be
+  /// reported, their parent operation should be reported instead.
+  void markOperationChanged(Operation *op) {
+    assert(getOperation()->isAncestor(op) &&
+           "expected an operation nested under the current operation");
+    getPassState().changedOps.push_back(op);
+  }
+
   /// Returns the analysis for the given parent operation if it exists.
   template <typename AnalysisT>
   Optional<std::reference_wrapper<AnalysisT>>
@@ -138,6 +138,28 @@ public:
   /// Set the flag specifying if multi-threading is disabled within the uniquer.
   void disableMultithreading(bool disable = true);
 
+  /// Statistics about the uniquing of parametric storage instances.
+  struct Statistics {
+    /// The number of requests for a storage instance.
+    uint64_t numLookups = 0;
+    /// The number of requests that returned an existing storage instance.
+    uint64_t numHits = 0;
+    /// The number of storage instances that have been created.
+    uint64_t numInstances = 0;
+    /// The number of requests that had to wait for another thread to finish
+    /// inserting a storage instance into the same shard.
+    uint64_t numContendedInsertions = 0;
+  };
+
+  /// Set the flag specifying if uniquing statistics are collected. Collecting
+  /// statistics adds shared counter updates to each request, and should only
+  /// be enabled when investigating the performance of the uniquer.
+  void enableStatistics(bool enable = true);
+
+  /// Return the statistics collected for parametric storage instances. Only
+  /// `numInstances` is available when statistics are disabled.
+  Statistics getStatistics() const;
+
   /// Register a new parametric storage class, this is necessary to create
   /// instances of this class type. `id` is the type identifier that will be
   /// used to identify this type when creating instances of it via 'get'.
@@ -370,6 +370,14 @@ public:
   /// Return the current display mode;
   DisplayMode getDisplayMode() const;
 
+  /// Enable or disable the display of the thread utilization of timers whose
+  /// work was spread across multiple threads, such as the pipelines of a pass
+  /// manager running in parallel. Only applies to `DisplayMode::Tree`.
+  void setShowThreadUtilization(bool show);
+
+  /// Return whether the thread utilization of timers is displayed.
+  bool getShowThreadUtilization() const;
+
   /// Change the stream where the output will be printed to.
   void setOutput(raw_ostream &os);
 
@@ -37,6 +37,17 @@ public:
   /// to disable this iteration limit.
   int64_t maxIterations = 10;
 
+  /// When set to true, the worklist is only seeded with all of the operations
+  /// of the regions on the first iteration. Afterwards, only operations that
+  /// were affected by a change are revisited: newly inserted operations,
+  /// operations updated in place, and the users and producers of replaced or
+  /// erased operations. A new iteration over all operations is only started
+  /// when region simplification changed the IR. This avoids rematching every
+  /// operation in the regions on each iteration, which dominates the cost of
+  /// the driver on large inputs, but relies on patterns notifying the rewriter
+  /// of all of the changes they make.
+  bool enableChangeDrivenIteration = false;
+
   static constexpr int64_t kNoIterationLimit = -1;
 };
 
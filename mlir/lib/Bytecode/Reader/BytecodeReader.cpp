@@ -0,0 +1,1456 @@
+//===- BytecodeReader.cpp - MLIR Bytecode Reader --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Bytecode/BytecodeReader.h"
+#include "../Encoding.h"
+#include "mlir/Bytecode/BytecodeImplementation.h"
+#include "mlir/IR/BuiltinDialect.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OpImplementation.h"
+#include "mlir/Parser.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBufferRef.h"
+
+using namespace mlir;
+
+/// Stringify the given section ID.
+static std::string toString(bytecode::Section::ID sectionID) {
+  switch (sectionID) {
+  case bytecode::Section::kString:
+    return "String (0)";
+  case bytecode::Section::kDialect:
+    return "Dialect (1)";
+  case bytecode::Section::kAttrType:
+    return "AttrType (2)";
+  case bytecode::Section::kAttrTypeOffset:
+    return "AttrTypeOffset (3)";
+  case bytecode::Section::kIR:
+    return "IR (4)";
+  default:
+    return ("Unknown (" + Twine(static_cast<unsigned>(sectionID)) + ")").str();
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// EncodingReader
+//===----------------------------------------------------------------------===//
+
+namespace {
+class EncodingReader {
+public:
+  explicit EncodingReader(ArrayRef<uint8_t> contents, Location fileLoc)
+      : dataIt(contents.data()), dataEnd(contents.end()), fileLoc(fileLoc) {}
+  explicit EncodingReader(StringRef contents, Location fileLoc)
+      : EncodingReader({reinterpret_cast<const uint8_t *>(contents.data()),
+                        contents.size()},
+                       fileLoc) {}
+
+  /// Returns true if the entire section has been read.
+  bool empty() const { return dataIt == dataEnd; }
+
+  /// Returns the remaining size of the bytecode.
+  size_t size() const { return dataEnd - dataIt; }
+
+  /// Emit an error using the given arguments.
+  template <typename... Args>
+  InFlightDiagnostic emitError(Args &&...args) const {
+    return ::emitError(fileLoc).append(std::forward<Args>(args)...);
+  }
+
+  /// Parse a single byte from the stream.
+  template <typename T>
+  LogicalResult parseByte(T &value) {
+    if (empty())
+      return emitError("attempting to parse a byte at the end of the bytecode");
+    value = static_cast<T>(*dataIt++);
+    return success();
+  }
+
+  /// Parse a range of bytes of 'length' into the given result.
+  LogicalResult parseBytes(size_t length, ArrayRef<uint8_t> &result) {
+    if (length > size()) {
+      return emitError("attempting to parse ", length, " bytes when only ",
+                       size(), " remain");
+    }
+    result = {dataIt, length};
+    dataIt += length;
+    return success();
+  }
+
+  /// Parse a variable length encoded integer from the byte stream. The first
+  /// encoded byte contains a prefix in the low bits indicating the encoded
+  /// length of the value. This length prefix is a bit sequence of '0's
+  /// followed by a '1'. The number of '0' bits indicate the number of
+  /// _additional_ bytes (not including the prefix byte). All remaining bits in
+  /// the first byte, along with all of the bits in additional bytes, provide
+  /// the value of the integer encoded in little-endian order.
+  LogicalResult parseVarInt(uint64_t &result) {
+    // Parse the first byte of the encoding, which contains the length prefix.
+    if (failed(parseByte(result)))
+      return failure();
+
+    // Handle the overwhelmingly common case where the value is stored in a
+    // single byte. In this case, the first bit is the `1` marker bit.
+    if (LLVM_LIKELY(result & 1)) {
+      result >>= 1;
+      return success();
+    }
+
+    // Handle the overwhelming uncommon case where the value required all 8
+    // bytes (i.e. a really really big number). In this case, the marker byte is
+    // all zeros: `00000000`.
+    if (LLVM_UNLIKELY(result == 0))
+      return parseLittleEndianBytes(/*numBytes=*/8, /*shift=*/0, result);
+    return parseMultiByteVarInt(result);
+  }
+
+  /// Parse a signed variable length encoded integer from the byte stream. A
+  /// signed varint is encoded as a normal varint with zigzag encoding applied,
+  /// i.e. the low bit of the value is used to indicate the sign.
+  LogicalResult parseSignedVarInt(uint64_t &result) {
+    if (failed(parseVarInt(result)))
+      return failure();
+    // Essentially (but using unsigned): (x >> 1) ^ -(x & 1)
+    result = (result >> 1) ^ (~(result & 1) + 1);
+    return success();
+  }
+
+  /// Parse a variable length encoded integer whose low bit is used to encode an
+  /// unrelated flag, i.e: `(integerValue << 1) | (flag ? 1 : 0)`.
+  LogicalResult parseVarIntWithFlag(uint64_t &result, bool &flag) {
+    if (failed(parseVarInt(result)))
+      return failure();
+    flag = result & 1;
+    result >>= 1;
+    return success();
+  }
+
+  /// Skip the first `length` bytes within the reader.
+  LogicalResult skipBytes(size_t length) {
+    if (length > size()) {
+      return emitError("attempting to skip ", length, " bytes when only ",
+                       size(), " remain");
+    }
+    dataIt += length;
+    return success();
+  }
+
+  /// Parse a null-terminated string into `result` (without including the NUL
+  /// terminator).
+  LogicalResult parseNullTerminatedString(StringRef &result) {
+    const char *startIt = reinterpret_cast<const char *>(dataIt);
+    const char *nulIt =
+        reinterpret_cast<const char *>(memchr(startIt, 0, size()));
+    if (!nulIt)
+      return emitError(
+          "malformed null-terminated string, no null character found");
+
+    result = StringRef(startIt, nulIt - startIt);
+    dataIt = reinterpret_cast<const uint8_t *>(nulIt) + 1;
+    return success();
+  }
+
+  /// Parse a section header, placing the kind of section in `sectionID` and the
+  /// contents of the section in `sectionData`.
+  LogicalResult parseSection(bytecode::Section::ID &sectionID,
+                             ArrayRef<uint8_t> &sectionData) {
+    uint64_t length;
+    if (failed(parseByte(sectionID)) || failed(parseVarInt(length)))
+      return failure();
+
+    // Validate that the section ID is valid.
+    if (sectionID >= bytecode::Section::kNumSections)
+      return emitError("invalid section ID: ", unsigned(sectionID));
+
+    // Parse the actual section data now that we have its length.
+    return parseBytes(static_cast<size_t>(length), sectionData);
+  }
+
+  /// Return the location of the bytecode buffer being read.
+  Location getLoc() const { return fileLoc; }
+
+private:
+  /// Parse a variable length encoded integer from the byte stream. This method
+  /// is a fallback when the number of bytes used to encode the value is greater
+  /// than 1, but less than the max (9). The provided `result` value contains
+  /// the first byte of the encoding. We mark it noinline here so that the
+  /// single byte hot path isn't pessimized.
+  LLVM_ATTRIBUTE_NOINLINE LogicalResult parseMultiByteVarInt(uint64_t &result) {
+    // Count the number of trailing zeros in the marker byte, this signifies the
+    // number of additional bytes to read.
+    uint32_t numBytes = llvm::countTrailingZeros<uint32_t>(result);
+    assert(numBytes > 0 && numBytes <= 7 &&
+           "unexpected number of trailing zeros in varint encoding");
+
+    // Parse in the remaining bytes of the value, and drop the length prefix.
+    if (failed(parseLittleEndianBytes(numBytes, /*shift=*/8, result)))
+      return failure();
+    result >>= (numBytes + 1);
+    return success();
+  }
+
+  /// Parse `numBytes` bytes encoded in little-endian order, and merge them into
+  /// `result` starting at the bit offset `shift`.
+  LogicalResult parseLittleEndianBytes(unsigned numBytes, unsigned shift,
+                                       uint64_t &result) {
+    ArrayRef<uint8_t> bytes;
+    if (failed(parseBytes(numBytes, bytes)))
+      return failure();
+    for (uint8_t byte : bytes) {
+      result |= static_cast<uint64_t>(byte) << shift;
+      shift += 8;
+    }
+    return success();
+  }
+
+  /// The current data iterator, and an iterator to the end of the buffer.
+  const uint8_t *dataIt, *dataEnd;
+
+  /// A location for the bytecode used to report errors.
+  Location fileLoc;
+};
+} // namespace
+
+/// Assign the given entry to `result`. If `result` is a pointer, it is set to
+/// the address of the entry.
+template <typename T>
+static void assignEntry(T &result, const T &entry) {
+  result = entry;
+}
+template <typename T>
+static void assignEntry(T *&result, T &entry) {
+  result = &entry;
+}
+
+/// Resolve an index into the given entry list. `entryStr` is used to provide
+/// context for error messages.
+template <typename RangeT, typename T>
+static LogicalResult resolveEntry(EncodingReader &reader, RangeT &entries,
+                                  uint64_t index, T &entry,
+                                  StringRef entryStr) {
+  if (index >= entries.size())
+    return reader.emitError("invalid ", entryStr, " index: ", index);
+  assignEntry(entry, entries[index]);
+  return success();
+}
+
+/// Parse and resolve an index into the given entry list.
+template <typename RangeT, typename T>
+static LogicalResult parseEntry(EncodingReader &reader, RangeT &entries,
+                                T &entry, StringRef entryStr) {
+  uint64_t entryIdx;
+  if (failed(reader.parseVarInt(entryIdx)))
+    return failure();
+  return resolveEntry(reader, entries, entryIdx, entry, entryStr);
+}
+
+//===----------------------------------------------------------------------===//
+// StringSectionReader
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class is used to read references to the string section from the
+/// bytecode.
+class StringSectionReader {
+public:
+  /// Initialize the string section reader with the given section data.
+  LogicalResult initialize(Location fileLoc, ArrayRef<uint8_t> sectionData);
+
+  /// Parse a shared string from the string section. The shared string is
+  /// encoded using an index to a corresponding string in the string section.
+  LogicalResult parseString(EncodingReader &reader, StringRef &result) {
+    return parseEntry(reader, strings, result, "string");
+  }
+
+private:
+  /// The table of strings referenced within the bytecode file.
+  SmallVector<StringRef> strings;
+};
+} // namespace
+
+LogicalResult StringSectionReader::initialize(Location fileLoc,
+                                              ArrayRef<uint8_t> sectionData) {
+  EncodingReader stringReader(sectionData, fileLoc);
+
+  // Parse the number of strings in the section. Each string requires at least
+  // one byte to encode its size, which prevents reserving a bogus amount of
+  // memory for malformed inputs.
+  uint64_t numStrings;
+  if (failed(stringReader.parseVarInt(numStrings)))
+    return failure();
+  if (numStrings > stringReader.size())
+    return stringReader.emitError("invalid number of strings: ", numStrings);
+
+  // Parse each of the string sizes.
+  SmallVector<uint64_t> stringSizes(numStrings);
+  for (uint64_t &stringSize : stringSizes)
+    if (failed(stringReader.parseVarInt(stringSize)))
+      return failure();
+
+  // Parse each of the strings. The sizes include the nul terminator.
+  strings.resize(numStrings);
+  for (auto it : llvm::enumerate(stringSizes)) {
+    uint64_t stringSize = it.value();
+    ArrayRef<uint8_t> stringData;
+    if (stringSize == 0 ||
+        failed(stringReader.parseBytes(stringSize, stringData)) ||
+        stringData.back() != 0) {
+      return stringReader.emitError("malformed string entry #", it.index(),
+                                    " in the string section");
+    }
+    strings[it.index()] = StringRef(
+        reinterpret_cast<const char *>(stringData.data()), stringSize - 1);
+  }
+  if (!stringReader.empty()) {
+    return stringReader.emitError(
+        "unexpected trailing data in the string section");
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// BytecodeDialect
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This struct represents a dialect entry within the bytecode.
+struct BytecodeDialect {
+  /// Load the dialect into the provided context if it hasn't been loaded yet.
+  /// Returns failure if the dialect couldn't be loaded *and* the provided
+  /// context does not allow unregistered dialects. The provided reader is used
+  /// for error emission if necessary.
+  LogicalResult load(EncodingReader &reader, MLIRContext *ctx) {
+    if (dialect)
+      return success();
+    Dialect *loadedDialect = ctx->getOrLoadDialect(name);
+    if (!loadedDialect && !ctx->allowsUnregisteredDialects()) {
+      return reader.emitError(
+          "dialect '", name,
+          "' is unknown. If this is intended, please call "
+          "allowUnregisteredDialects() on the MLIRContext, or use "
+          "-allow-unregistered-dialect with the MLIR tool used.");
+    }
+    dialect = loadedDialect;
+
+    // If the dialect was actually loaded, check to see if it has a bytecode
+    // interface.
+    if (loadedDialect)
+      interface =
+          loadedDialect->getRegisteredInterface<BytecodeDialectInterface>();
+    return success();
+  }
+
+  /// Return the loaded dialect, or nullptr if the dialect is unknown. This can
+  /// only be called after `load`.
+  Dialect *getLoadedDialect() const {
+    assert(dialect &&
+           "expected `load` to be invoked before `getLoadedDialect`");
+    return *dialect;
+  }
+
+  /// The loaded dialect entry. This field is None if we haven't attempted to
+  /// load, nullptr if we failed to load, otherwise the loaded dialect.
+  Optional<Dialect *> dialect;
+
+  /// The bytecode interface of the dialect, or nullptr if the dialect does not
+  /// implement the bytecode interface. This field should only be checked if
+  /// the `dialect` field is non-None.
+  const BytecodeDialectInterface *interface = nullptr;
+
+  /// The name of the dialect.
+  StringRef name;
+};
+
+/// This struct represents an operation name entry within the bytecode.
+struct BytecodeOperationName {
+  BytecodeOperationName(BytecodeDialect *dialect, StringRef name)
+      : dialect(dialect), name(name) {}
+
+  /// The loaded operation name, or None if it hasn't been processed yet.
+  Optional<OperationName> opName;
+
+  /// The dialect that owns this operation name.
+  BytecodeDialect *dialect;
+
+  /// The full name of the operation, including the dialect prefix.
+  StringRef name;
+};
+} // namespace
+
+/// Parse a single dialect group encoded in the byte stream.
+template <typename EntryCallbackT>
+static LogicalResult parseDialectGrouping(
+    EncodingReader &reader, MutableArrayRef<BytecodeDialect> dialects,
+    EntryCallbackT &&entryCallback) {
+  // Parse the dialect and the number of entries in the group.
+  BytecodeDialect *dialect;
+  if (failed(parseEntry(reader, dialects, dialect, "dialect")))
+    return failure();
+  uint64_t numEntries;
+  if (failed(reader.parseVarInt(numEntries)))
+    return failure();
+
+  for (uint64_t i = 0; i < numEntries; ++i)
+    if (failed(entryCallback(dialect)))
+      return failure();
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Attribute/Type Reader
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class provides support for reading attribute and type entries from the
+/// bytecode. Attribute and Type entries are read lazily on demand, so we use
+/// this reader to manage when to actually parse them from the bytecode.
+class AttrTypeReader {
+  /// This class represents a single attribute or type entry.
+  template <typename T>
+  struct Entry {
+    /// The entry, or null if it hasn't been resolved yet.
+    T entry = {};
+    /// The parent dialect of this entry.
+    BytecodeDialect *dialect = nullptr;
+    /// A flag indicating if the entry was encoded using a custom encoding,
+    /// instead of using the textual assembly format.
+    bool hasCustomEncoding = false;
+    /// The raw data of this entry in the bytecode.
+    ArrayRef<uint8_t> data;
+  };
+  using AttrEntry = Entry<Attribute>;
+  using TypeEntry = Entry<Type>;
+
+public:
+  AttrTypeReader(StringSectionReader &stringReader, Location fileLoc)
+      : stringReader(stringReader), fileLoc(fileLoc) {}
+
+  /// Initialize the attribute and type information within the reader.
+  LogicalResult initialize(MutableArrayRef<BytecodeDialect> dialects,
+                           ArrayRef<uint8_t> sectionData,
+                           ArrayRef<uint8_t> offsetSectionData);
+
+  /// Resolve the attribute or type at the given index. Returns nullptr on
+  /// failure.
+  Attribute resolveAttribute(size_t index) {
+    return resolveEntry(attributes, index, "Attribute");
+  }
+  Type resolveType(size_t index) { return resolveEntry(types, index, "Type"); }
+
+  /// Parse a reference to an attribute or type using the given reader.
+  LogicalResult parseAttribute(EncodingReader &reader, Attribute &result) {
+    uint64_t attrIdx;
+    if (failed(reader.parseVarInt(attrIdx)))
+      return failure();
+    result = resolveAttribute(attrIdx);
+    return success(!!result);
+  }
+  LogicalResult parseType(EncodingReader &reader, Type &result) {
+    uint64_t typeIdx;
+    if (failed(reader.parseVarInt(typeIdx)))
+      return failure();
+    result = resolveType(typeIdx);
+    return success(!!result);
+  }
+
+  template <typename T>
+  LogicalResult parseAttribute(EncodingReader &reader, T &result) {
+    Attribute baseResult;
+    if (failed(parseAttribute(reader, baseResult)))
+      return failure();
+    if ((result = baseResult.dyn_cast<T>()))
+      return success();
+    return reader.emitError("expected attribute of type: ",
+                            llvm::getTypeName<T>(), ", but got: ", baseResult);
+  }
+
+private:
+  /// Resolve the given entry at `index`.
+  template <typename T>
+  T resolveEntry(SmallVectorImpl<Entry<T>> &entries, size_t index,
+                 StringRef entryType);
+
+  /// Parse an entry using the parseAsm method of the assembly format.
+  template <typename T>
+  LogicalResult parseAsmEntry(T &result, EncodingReader &reader,
+                              StringRef entryType);
+
+  /// Parse an entry using the custom bytecode format of its dialect.
+  template <typename T>
+  LogicalResult parseCustomEntry(Entry<T> &entry, EncodingReader &reader,
+                                 StringRef entryType);
+
+  /// The string section reader used to resolve string references when parsing
+  /// custom encoded attribute/type entries.
+  StringSectionReader &stringReader;
+
+  /// The set of attribute and type entries.
+  SmallVector<AttrEntry> attributes;
+  SmallVector<TypeEntry> types;
+
+  /// A location used for error emission.
+  Location fileLoc;
+};
+
+class DialectReader : public DialectBytecodeReader {
+public:
+  DialectReader(AttrTypeReader &attrTypeReader,
+                StringSectionReader &stringReader, EncodingReader &reader)
+      : attrTypeReader(attrTypeReader), stringReader(stringReader),
+        reader(reader) {}
+
+  InFlightDiagnostic emitError(const Twine &msg) override {
+    return reader.emitError(msg);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // IR
+  //===--------------------------------------------------------------------===//
+
+  LogicalResult readAttribute(Attribute &result) override {
+    return attrTypeReader.parseAttribute(reader, result);
+  }
+
+  LogicalResult readType(Type &result) override {
+    return attrTypeReader.parseType(reader, result);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Primitives
+  //===--------------------------------------------------------------------===//
+
+  LogicalResult readVarInt(uint64_t &result) override {
+    return reader.parseVarInt(result);
+  }
+
+  LogicalResult readSignedVarInt(int64_t &result) override {
+    uint64_t unsignedResult;
+    if (failed(reader.parseSignedVarInt(unsignedResult)))
+      return failure();
+    result = static_cast<int64_t>(unsignedResult);
+    return success();
+  }
+
+  FailureOr<APInt> readAPIntWithKnownWidth(unsigned bitWidth) override {
+    // Small values are encoded using a single byte.
+    if (bitWidth <= 8) {
+      uint8_t value;
+      if (failed(reader.parseByte(value)))
+        return failure();
+      return APInt(bitWidth, value);
+    }
+
+    // Large values up to 64 bits are encoded using a single varint.
+    if (bitWidth <= 64) {
+      uint64_t value;
+      if (failed(reader.parseSignedVarInt(value)))
+        return failure();
+      return APInt(bitWidth, value);
+    }
+
+    // Otherwise, for really big values we encode the array of active words in
+    // the value.
+    uint64_t numActiveWords;
+    if (failed(reader.parseVarInt(numActiveWords)))
+      return failure();
+    unsigned numWords = APInt::getNumWords(bitWidth);
+    if (numActiveWords > numWords) {
+      reader.emitError("invalid APInt of bit width ", bitWidth,
+                       ", expected at most ", numWords,
+                       " active words but got ", numActiveWords);
+      return failure();
+    }
+    SmallVector<uint64_t, 4> words(numActiveWords);
+    for (uint64_t &word : words)
+      if (failed(reader.parseSignedVarInt(word)))
+        return failure();
+    return APInt(bitWidth, words);
+  }
+
+  FailureOr<APFloat>
+  readAPFloatWithKnownSemantics(const llvm::fltSemantics &semantics) override {
+    FailureOr<APInt> intVal =
+        readAPIntWithKnownWidth(APFloat::getSizeInBits(semantics));
+    if (failed(intVal))
+      return failure();
+    return APFloat(semantics, *intVal);
+  }
+
+  LogicalResult readString(StringRef &result) override {
+    return stringReader.parseString(reader, result);
+  }
+
+  LogicalResult readBlob(ArrayRef<char> &result) override {
+    uint64_t dataSize;
+    ArrayRef<uint8_t> data;
+    if (failed(reader.parseVarInt(dataSize)) ||
+        failed(reader.parseBytes(dataSize, data)))
+      return failure();
+    result = llvm::makeArrayRef(reinterpret_cast<const char *>(data.data()),
+                                data.size());
+    return success();
+  }
+
+private:
+  AttrTypeReader &attrTypeReader;
+  StringSectionReader &stringReader;
+  EncodingReader &reader;
+};
+} // namespace
+
+LogicalResult
+AttrTypeReader::initialize(MutableArrayRef<BytecodeDialect> dialects,
+                           ArrayRef<uint8_t> sectionData,
+                           ArrayRef<uint8_t> offsetSectionData) {
+  EncodingReader offsetReader(offsetSectionData, fileLoc);
+
+  // Parse the number of attribute and type entries. Each entry requires at
+  // least one byte to encode its offset.
+  uint64_t numAttributes, numTypes;
+  if (failed(offsetReader.parseVarInt(numAttributes)) ||
+      failed(offsetReader.parseVarInt(numTypes)))
+    return failure();
+  if (numAttributes + numTypes > offsetReader.size()) {
+    return offsetReader.emitError("invalid number of Attribute/Type entries: ",
+                                  numAttributes, " attributes and ", numTypes,
+                                  " types");
+  }
+  attributes.resize(numAttributes);
+  types.resize(numTypes);
+
+  // A functor used to accumulate the offsets for the entries in the given
+  // range.
+  uint64_t currentOffset = 0;
+  auto parseEntries = [&](auto &&range) {
+    size_t currentIndex = 0, endIndex = range.size();
+
+    // Parse an individual entry.
+    auto parseEntryFn = [&](BytecodeDialect *dialect) -> LogicalResult {
+      if (currentIndex == endIndex) {
+        return offsetReader.emitError(
+            "too many entries in the Attribute/Type offset section");
+      }
+      auto &entry = range[currentIndex++];
+
+      uint64_t entrySize;
+      if (failed(offsetReader.parseVarIntWithFlag(entrySize,
+                                                  entry.hasCustomEncoding)))
+        return failure();
+
+      // Verify that the offset is actually valid.
+      if (currentOffset + entrySize > sectionData.size()) {
+        return offsetReader.emitError(
+            "Attribute or Type entry offset points past the end of section");
+      }
+
+      entry.data = sectionData.slice(currentOffset, entrySize);
+      entry.dialect = dialect;
+      currentOffset += entrySize;
+      return success();
+    };
+    while (currentIndex != endIndex)
+      if (failed(parseDialectGrouping(offsetReader, dialects, parseEntryFn)))
+        return failure();
+    return success();
+  };
+
+  // Process each of the attributes, and then the types.
+  if (failed(parseEntries(attributes)) || failed(parseEntries(types)))
+    return failure();
+
+  // Ensure that we read everything from the section.
+  if (!offsetReader.empty()) {
+    return offsetReader.emitError(
+        "unexpected trailing data in the Attribute/Type offset section");
+  }
+  return success();
+}
+
+template <typename T>
+T AttrTypeReader::resolveEntry(SmallVectorImpl<Entry<T>> &entries, size_t index,
+                               StringRef entryType) {
+  if (index >= entries.size()) {
+    emitError(fileLoc) << "invalid " << entryType << " index: " << index;
+    return {};
+  }
+
+  // If the entry has already been resolved, there is nothing left to do.
+  Entry<T> &entry = entries[index];
+  if (entry.entry)
+    return entry.entry;
+
+  // Parse the entry.
+  EncodingReader reader(entry.data, fileLoc);
+  if (failed(entry.dialect->load(reader, fileLoc.getContext())))
+    return T();
+
+  // Parse based on how the entry was encoded.
+  if (entry.hasCustomEncoding) {
+    if (failed(parseCustomEntry(entry, reader, entryType)))
+      return T();
+  } else if (failed(parseAsmEntry(entry.entry, reader, entryType))) {
+    return T();
+  }
+
+  if (!reader.empty()) {
+    reader.emitError("unexpected trailing bytes after " + entryType + " entry");
+    return T();
+  }
+  return entry.entry;
+}
+
+/// Invoke the MLIR assembly parser on the given attribute or type string.
+static void parseAsmString(StringRef asmStr, MLIRContext *context,
+                           size_t &numRead, Attribute &result) {
+  result = ::mlir::parseAttribute(asmStr, context, numRead);
+}
+static void parseAsmString(StringRef asmStr, MLIRContext *context,
+                           size_t &numRead, Type &result) {
+  result = ::mlir::parseType(asmStr, context, numRead);
+}
+
+template <typename T>
+LogicalResult AttrTypeReader::parseAsmEntry(T &result, EncodingReader &reader,
+                                            StringRef entryType) {
+  StringRef asmStr;
+  if (failed(reader.parseNullTerminatedString(asmStr)))
+    return failure();
+
+  // Invoke the MLIR assembly parser to parse the entry text.
+  size_t numRead = 0;
+  parseAsmString(asmStr, fileLoc.getContext(), numRead, result);
+  if (!result)
+    return failure();
+
+  // Ensure there weren't dangling characters after the entry.
+  if (numRead != asmStr.size()) {
+    return reader.emitError("trailing characters found after ", entryType,
+                            " assembly format: ", asmStr.drop_front(numRead));
+  }
+  return success();
+}
+
+/// Invoke the dialect bytecode interface to read the given attribute or type.
+static void readCustomEncoding(const BytecodeDialectInterface *interface,
+                               DialectReader &reader, Attribute &result) {
+  result = interface->readAttribute(reader);
+}
+static void readCustomEncoding(const BytecodeDialectInterface *interface,
+                               DialectReader &reader, Type &result) {
+  result = interface->readType(reader);
+}
+
+template <typename T>
+LogicalResult AttrTypeReader::parseCustomEntry(Entry<T> &entry,
+                                               EncodingReader &reader,
+                                               StringRef entryType) {
+  if (!entry.dialect->interface) {
+    return reader.emitError("dialect '", entry.dialect->name,
+                            "' does not implement the bytecode interface");
+  }
+
+  // Ask the dialect to parse the entry.
+  DialectReader dialectReader(*this, stringReader, reader);
+  readCustomEncoding(entry.dialect->interface, dialectReader, entry.entry);
+  return success(!!entry.entry);
+}
+
+//===----------------------------------------------------------------------===//
+// Bytecode Reader
+//===----------------------------------------------------------------------===//
+
+/// This class is used to read a bytecode buffer and translate it into MLIR.
+class mlir::BytecodeReader::Impl {
+public:
+  Impl(llvm::MemoryBufferRef buffer, Location fileLoc, bool lazyLoad)
+      : buffer(buffer), fileLoc(fileLoc), lazyLoad(lazyLoad),
+        attrTypeReader(stringReader, fileLoc) {}
+  ~Impl() {
+    // Drop the uses of any forward references that haven't been resolved, the
+    // users of these references may outlive the reader (e.g. when parsing
+    // failed).
+    for (Operation &op : forwardRefOps)
+      op.dropAllUses();
+  }
+
+  /// Read the bytecode defined within `buffer` into the given block.
+  LogicalResult read(Block *block);
+
+  /// Return the location of the bytecode buffer.
+  Location getFileLoc() const { return fileLoc; }
+
+  //===--------------------------------------------------------------------===//
+  // Lazy Loading
+
+  int64_t getNumOpsToMaterialize() const { return lazyLoadableOps.size(); }
+  bool isMaterializable(Operation *op) { return lazyLoadableOps.count(op); }
+  LogicalResult materialize(Operation *op);
+  LogicalResult materializeAll();
+
+private:
+  /// Return the context for this config.
+  MLIRContext *getContext() const { return fileLoc->getContext(); }
+
+  /// Parse the bytecode version.
+  LogicalResult parseVersion(EncodingReader &reader);
+
+  //===--------------------------------------------------------------------===//
+  // Dialect Section
+
+  LogicalResult parseDialectSection(ArrayRef<uint8_t> sectionData);
+
+  /// Parse an operation name reference using the given reader.
+  FailureOr<OperationName> parseOpName(EncodingReader &reader);
+
+  //===--------------------------------------------------------------------===//
+  // Attribute/Type Section
+
+  /// Parse an attribute or type using the given reader.
+  template <typename T>
+  LogicalResult parseAttribute(EncodingReader &reader, T &result) {
+    return attrTypeReader.parseAttribute(reader, result);
+  }
+  LogicalResult parseType(EncodingReader &reader, Type &result) {
+    return attrTypeReader.parseType(reader, result);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // IR Section
+
+  /// This struct represents the current read state of a set of values that
+  /// share a numbering scope, i.e. the values defined within the top level, or
+  /// within a region of an operation that is isolated from above.
+  struct ValueScope {
+    ValueScope(unsigned numValues) : values(numValues) {}
+
+    /// The set of values defined within the scope, indexed by their ID.
+    std::vector<Value> values;
+
+    /// The ID of the next value to be defined within the scope.
+    unsigned nextValueID = 0;
+
+    /// The number of forward references within the scope that haven't been
+    /// resolved yet.
+    unsigned numForwardRefs = 0;
+  };
+
+  LogicalResult parseIRSection(ArrayRef<uint8_t> sectionData, Block *block);
+  LogicalResult parseBlockOps(EncodingReader &reader, Block *block,
+                              uint64_t numOps, ArrayRef<Block *> regionBlocks);
+  LogicalResult parseOperation(EncodingReader &reader, Block *block,
+                               ArrayRef<Block *> regionBlocks);
+  LogicalResult parseRegion(EncodingReader &reader, Region &region,
+                            bool isIsolatedFromAbove);
+  LogicalResult parseIsolatedRegions(Operation *op,
+                                     ArrayRef<uint8_t> regionsData);
+  LogicalResult parseBlockArguments(EncodingReader &reader, Block *block);
+
+  //===--------------------------------------------------------------------===//
+  // Value Processing
+
+  /// Parse an operand reference using the given reader. Returns nullptr in the
+  /// case of failure.
+  Value parseOperand(EncodingReader &reader);
+
+  /// Sequentially define the given value range.
+  LogicalResult defineValues(EncodingReader &reader, ValueRange values);
+
+  /// Create a value to use for a forward reference.
+  Value createForwardRef();
+
+  /// Push a new value scope, reserving `numValues` values.
+  void pushScope(uint64_t numValues) { valueScopes.emplace_back(numValues); }
+
+  /// Pop the current value scope, checking that all of its forward references
+  /// were resolved.
+  LogicalResult popScope(EncodingReader &reader);
+
+  //===--------------------------------------------------------------------===//
+  // Fields
+
+  /// The buffer containing the bytecode.
+  llvm::MemoryBufferRef buffer;
+
+  /// A location to use when emitting errors.
+  Location fileLoc;
+
+  /// Whether the regions of operations isolated from above should be read
+  /// lazily, i.e. only when the operation is materialized.
+  bool lazyLoad;
+
+  /// The producer of the bytecode, as encoded in the header.
+  StringRef producer;
+
+  /// The reader used to process attribute and types within the bytecode.
+  StringSectionReader stringReader;
+  AttrTypeReader attrTypeReader;
+
+  /// The table of dialects and operation names referenced within the bytecode.
+  SmallVector<BytecodeDialect> dialects;
+  SmallVector<BytecodeOperationName> opNames;
+
+  /// The current set of available IR value scopes.
+  std::vector<ValueScope> valueScopes;
+
+  /// A block containing the set of operations defined to create forward
+  /// references.
+  Block forwardRefOps;
+
+  /// The operations whose regions haven't been materialized yet, mapped to the
+  /// encoded data for their regions.
+  DenseMap<Operation *, ArrayRef<uint8_t>> lazyLoadableOps;
+};
+
+LogicalResult BytecodeReader::Impl::read(Block *block) {
+  EncodingReader reader(buffer.getBuffer(), fileLoc);
+
+  // Check that the buffer starts with the bytecode header.
+  ArrayRef<uint8_t> magic;
+  if (failed(reader.parseBytes(sizeof(bytecode::kMagic), magic)) ||
+      memcmp(magic.data(), bytecode::kMagic, sizeof(bytecode::kMagic)) != 0)
+    return reader.emitError("input buffer is not an MLIR bytecode file");
+
+  // Parse the bytecode version and producer.
+  if (failed(parseVersion(reader)) ||
+      failed(reader.parseNullTerminatedString(producer)))
+    return failure();
+
+  // Parse the raw data for each of the top-level sections of the bytecode.
+  Optional<ArrayRef<uint8_t>> sectionDatas[bytecode::Section::kNumSections];
+  while (!reader.empty()) {
+    // Read the next section from the bytecode.
+    bytecode::Section::ID sectionID;
+    ArrayRef<uint8_t> sectionData;
+    if (failed(reader.parseSection(sectionID, sectionData)))
+      return failure();
+
+    // Check for duplicate sections, we only expect one instance of each.
+    if (sectionDatas[sectionID]) {
+      return reader.emitError("duplicate top-level section: ",
+                              toString(sectionID));
+    }
+    sectionDatas[sectionID] = sectionData;
+  }
+  // Check that all of the sections were found.
+  for (int i = 0; i < bytecode::Section::kNumSections; ++i) {
+    if (!sectionDatas[i]) {
+      return reader.emitError("missing data for top-level section: ",
+                              toString(bytecode::Section::ID(i)));
+    }
+  }
+
+  // Process the string section first.
+  if (failed(stringReader.initialize(
+          fileLoc, *sectionDatas[bytecode::Section::kString])))
+    return failure();
+
+  // Process the dialect section.
+  if (failed(parseDialectSection(*sectionDatas[bytecode::Section::kDialect])))
+    return failure();
+
+  // Process the attribute and type section.
+  if (failed(attrTypeReader.initialize(
+          dialects, *sectionDatas[bytecode::Section::kAttrType],
+          *sectionDatas[bytecode::Section::kAttrTypeOffset])))
+    return failure();
+
+  // Finally, process the IR section.
+  return parseIRSection(*sectionDatas[bytecode::Section::kIR], block);
+}
+
+LogicalResult BytecodeReader::Impl::parseVersion(EncodingReader &reader) {
+  uint64_t version;
+  if (failed(reader.parseVarInt(version)))
+    return failure();
+
+  // Validate the bytecode version.
+  uint64_t currentVersion = bytecode::kVersion;
+  if (version > currentVersion) {
+    return reader.emitError("bytecode version ", version,
+                            " is newer than the current version ",
+                            currentVersion);
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Dialect Section
+
+LogicalResult
+BytecodeReader::Impl::parseDialectSection(ArrayRef<uint8_t> sectionData) {
+  EncodingReader sectionReader(sectionData, fileLoc);
+
+  // Parse the number of dialects in the section.
+  uint64_t numDialects;
+  if (failed(sectionReader.parseVarInt(numDialects)))
+    return failure();
+  if (numDialects > sectionReader.size()) {
+    return sectionReader.emitError("invalid number of dialects: ",
+                                   numDialects);
+  }
+  dialects.resize(numDialects);
+
+  // Parse each of the dialects.
+  for (uint64_t i = 0; i < numDialects; ++i)
+    if (failed(stringReader.parseString(sectionReader, dialects[i].name)))
+      return failure();
+
+  // Parse the operation names, which are grouped by dialect.
+  auto parseOpName = [&](BytecodeDialect *dialect) -> LogicalResult {
+    StringRef opName;
+    if (failed(stringReader.parseString(sectionReader, opName)))
+      return failure();
+    opNames.emplace_back(dialect, opName);
+    return success();
+  };
+  while (!sectionReader.empty())
+    if (failed(parseDialectGrouping(sectionReader, dialects, parseOpName)))
+      return failure();
+  return success();
+}
+
+FailureOr<OperationName>
+BytecodeReader::Impl::parseOpName(EncodingReader &reader) {
+  BytecodeOperationName *opName = nullptr;
+  if (failed(parseEntry(reader, opNames, opName, "operation name")))
+    return failure();
+
+  // Check to see if this operation name has already been resolved. If we
+  // haven't, load the dialect and build the operation name.
+  if (!opName->opName) {
+    if (failed(opName->dialect->load(reader, getContext())))
+      return failure();
+    OperationName name(opName->name, getContext());
+
+    // Unregistered operations are only allowed if the context allows
+    // unregistered dialects, or if their dialect allows unknown operations.
+    if (!name.isRegistered() && !getContext()->allowsUnregisteredDialects()) {
+      Dialect *dialect = opName->dialect->getLoadedDialect();
+      if (!dialect || !dialect->allowsUnknownOperations()) {
+        reader.emitError(
+            "operation '", opName->name,
+            "' is not registered. If this is intended, please call "
+            "allowUnregisteredDialects() on the MLIRContext, or use "
+            "-allow-unregistered-dialect with the MLIR tool used.");
+        return failure();
+      }
+    }
+    opName->opName.emplace(name);
+  }
+  return *opName->opName;
+}
+
+//===----------------------------------------------------------------------===//
+// IR Section
+
+LogicalResult
+BytecodeReader::Impl::parseIRSection(ArrayRef<uint8_t> sectionData,
+                                     Block *block) {
+  EncodingReader reader(sectionData, fileLoc);
+
+  // The top level is encoded like a region with a single block, which doesn't
+  // have any arguments.
+  uint64_t numBlocks, numValues, numOps;
+  bool hasArgs;
+  if (failed(reader.parseVarInt(numBlocks)) ||
+      failed(reader.parseVarInt(numValues)) ||
+      failed(reader.parseVarIntWithFlag(numOps, hasArgs)))
+    return failure();
+  if (numBlocks != 1) {
+    return reader.emitError("expected a single top-level block, but got ",
+                            numBlocks);
+  }
+  if (hasArgs)
+    return reader.emitError("the top-level block can't have arguments");
+  if (numValues > sectionData.size())
+    return reader.emitError("invalid number of values: ", numValues);
+
+  // Parse the operations into a temporary block, so that `block` isn't
+  // modified in the case of failure.
+  pushScope(numValues);
+  Block topLevelBlock;
+  if (failed(parseBlockOps(reader, &topLevelBlock, numOps, llvm::None)) ||
+      failed(popScope(reader))) {
+    lazyLoadableOps.clear();
+    return failure();
+  }
+  if (!reader.empty()) {
+    lazyLoadableOps.clear();
+    return reader.emitError("unexpected trailing data in the IR section");
+  }
+
+  // Splice the parsed operations over to the provided top-level block.
+  auto &parsedOps = topLevelBlock.getOperations();
+  block->getOperations().splice(block->end(), parsedOps, parsedOps.begin(),
+                                parsedOps.end());
+  return success();
+}
+
+LogicalResult
+BytecodeReader::Impl::parseBlockOps(EncodingReader &reader, Block *block,
+                                    uint64_t numOps,
+                                    ArrayRef<Block *> regionBlocks) {
+  for (uint64_t i = 0; i < numOps; ++i)
+    if (failed(parseOperation(reader, block, regionBlocks)))
+      return failure();
+  return success();
+}
+
+LogicalResult
+BytecodeReader::Impl::parseOperation(EncodingReader &reader, Block *block,
+                                     ArrayRef<Block *> regionBlocks) {
+  // Parse the name of the operation.
+  FailureOr<OperationName> opName = parseOpName(reader);
+  if (failed(opName))
+    return failure();
+
+  // Parse the operation mask, which indicates which components of the
+  // operation are present.
+  uint8_t opMask;
+  if (failed(reader.parseByte(opMask)))
+    return failure();
+
+  /// Parse the location.
+  LocationAttr opLoc;
+  if (failed(parseAttribute(reader, opLoc)))
+    return failure();
+
+  // With the location and name resolved, we can start building the operation
+  // state.
+  DictionaryAttr dictAttr;
+  if (opMask & bytecode::OpEncodingMask::kHasAttrs) {
+    if (failed(parseAttribute(reader, dictAttr)))
+      return failure();
+  } else {
+    dictAttr = DictionaryAttr::get(getContext());
+  }
+
+  // Parse the results of the operation.
+  SmallVector<Type> resultTypes;
+  if (opMask & bytecode::OpEncodingMask::kHasResults) {
+    uint64_t numResults;
+    if (failed(reader.parseVarInt(numResults)))
+      return failure();
+    if (numResults > reader.size())
+      return reader.emitError("invalid number of results: ", numResults);
+    resultTypes.resize(numResults);
+    for (Type &resultType : resultTypes)
+      if (failed(parseType(reader, resultType)))
+        return failure();
+  }
+
+  // Parse the operands of the operation.
+  SmallVector<Value> operands;
+  if (opMask & bytecode::OpEncodingMask::kHasOperands) {
+    uint64_t numOperands;
+    if (failed(reader.parseVarInt(numOperands)))
+      return failure();
+    if (numOperands > reader.size())
+      return reader.emitError("invalid number of operands: ", numOperands);
+    operands.resize(numOperands);
+    for (Value &operand : operands)
+      if (!(operand = parseOperand(reader)))
+        return failure();
+  }
+
+  // Parse the successors of the operation.
+  SmallVector<Block *> successors;
+  if (opMask & bytecode::OpEncodingMask::kHasSuccessors) {
+    uint64_t numSuccs;
+    if (failed(reader.parseVarInt(numSuccs)))
+      return failure();
+    if (numSuccs > reader.size())
+      return reader.emitError("invalid number of successors: ", numSuccs);
+    successors.resize(numSuccs);
+    for (Block *&succ : successors)
+      if (failed(parseEntry(reader, regionBlocks, succ, "successor")))
+        return failure();
+  }
+
+  // Parse the number of regions, and whether they are isolated from above.
+  uint64_t numRegions = 0;
+  bool isIsolatedFromAbove = false;
+  if (opMask & bytecode::OpEncodingMask::kHasInlineRegions) {
+    if (failed(reader.parseVarIntWithFlag(numRegions, isIsolatedFromAbove)))
+      return failure();
+    if (numRegions > reader.size())
+      return reader.emitError("invalid number of regions: ", numRegions);
+  }
+
+  // Create the operation at the back of the current block, and define its
+  // results.
+  Operation *op =
+      Operation::create(Location(opLoc), *opName, resultTypes, operands,
+                        dictAttr, successors, numRegions);
+  block->push_back(op);
+  if (op->getNumResults() && failed(defineValues(reader, op->getResults())))
+    return failure();
+
+  if (!numRegions)
+    return success();
+
+  // Regions that aren't isolated from above are read inline, as they share the
+  // value scope of the parent operation.
+  if (!isIsolatedFromAbove) {
+    for (Region &region : op->getRegions())
+      if (failed(parseRegion(reader, region, /*isIsolatedFromAbove=*/false)))
+        return failure();
+    return success();
+  }
+
+  // Otherwise, the regions are prefixed with their encoded size, which allows
+  // for deferring their parsing until the operation is materialized.
+  uint64_t regionsSize;
+  ArrayRef<uint8_t> regionsData;
+  if (failed(reader.parseVarInt(regionsSize)) ||
+      failed(reader.parseBytes(regionsSize, regionsData)))
+    return failure();
+  if (lazyLoad) {
+    lazyLoadableOps.try_emplace(op, regionsData);
+    return success();
+  }
+  return parseIsolatedRegions(op, regionsData);
+}
+
+LogicalResult
+BytecodeReader::Impl::parseIsolatedRegions(Operation *op,
+                                           ArrayRef<uint8_t> regionsData) {
+  EncodingReader reader(regionsData, fileLoc);
+  for (Region &region : op->getRegions())
+    if (failed(parseRegion(reader, region, /*isIsolatedFromAbove=*/true)))
+      return failure();
+  if (!reader.empty()) {
+    return reader.emitError("unexpected trailing data after the regions of '",
+                            op->getName(), "'");
+  }
+  return success();
+}
+
+LogicalResult BytecodeReader::Impl::parseRegion(EncodingReader &reader,
+                                                Region &region,
+                                                bool isIsolatedFromAbove) {
+  // Parse the number of blocks in the region.
+  uint64_t numBlocks;
+  if (failed(reader.parseVarInt(numBlocks)))
+    return failure();
+
+  // If the region is empty, there is nothing else to do.
+  if (numBlocks == 0)
+    return success();
+
+  // Parse the number of values defined within this region. This includes the
+  // values defined in nested regions that aren't isolated from above, and is
+  // only used when the region starts a new value scope.
+  uint64_t numValues;
+  if (failed(reader.parseVarInt(numValues)))
+    return failure();
+  if (numBlocks > reader.size() || numValues > reader.size())
+    return reader.emitError("invalid number of blocks or values in region");
+  if (isIsolatedFromAbove)
+    pushScope(numValues);
+
+  // Create the blocks within this region. We do this before processing so that
+  // we can rely on the blocks existing when creating operations.
+  SmallVector<Block *> blocks;
+  blocks.reserve(numBlocks);
+  for (uint64_t i = 0; i < numBlocks; ++i) {
+    blocks.push_back(new Block());
+    region.push_back(blocks.back());
+  }
+
+  // Parse each of the blocks.
+  for (Block *block : blocks) {
+    uint64_t numOps;
+    bool hasArgs;
+    if (failed(reader.parseVarIntWithFlag(numOps, hasArgs)) ||
+        (hasArgs && failed(parseBlockArguments(reader, block))) ||
+        failed(parseBlockOps(reader, block, numOps, blocks)))
+      return failure();
+  }
+
+  if (isIsolatedFromAbove)
+    return popScope(reader);
+  return success();
+}
+
+LogicalResult BytecodeReader::Impl::parseBlockArguments(EncodingReader &reader,
+                                                        Block *block) {
+  // Parse the number of arguments.
+  uint64_t numArgs;
+  if (failed(reader.parseVarInt(numArgs)))
+    return failure();
+  if (numArgs > reader.size())
+    return reader.emitError("invalid number of block arguments: ", numArgs);
+
+  SmallVector<Type> argTypes;
+  SmallVector<Location> argLocs;
+  argTypes.reserve(numArgs);
+  argLocs.reserve(numArgs);
+
+  while (numArgs--) {
+    Type argType;
+    LocationAttr argLoc;
+    if (failed(parseType(reader, argType)) ||
+        failed(parseAttribute(reader, argLoc)))
+      return failure();
+
+    argTypes.push_back(argType);
+    argLocs.push_back(argLoc);
+  }
+  block->addArguments(argTypes, argLocs);
+  return defineValues(reader, block->getArguments());
+}
+
+//===----------------------------------------------------------------------===//
+// Value Processing
+
+Value BytecodeReader::Impl::parseOperand(EncodingReader &reader) {
+  ValueScope &scope = valueScopes.back();
+  uint64_t valueIdx;
+  if (failed(reader.parseVarInt(valueIdx)))
+    return Value();
+  if (valueIdx >= scope.values.size()) {
+    reader.emitError("invalid value index: ", valueIdx);
+    return Value();
+  }
+
+  // Create a new forward reference if necessary.
+  Value &value = scope.values[valueIdx];
+  if (!value) {
+    value = createForwardRef();
+    ++scope.numForwardRefs;
+  }
+  return value;
+}
+
+LogicalResult BytecodeReader::Impl::defineValues(EncodingReader &reader,
+                                                 ValueRange newValues) {
+  ValueScope &scope = valueScopes.back();
+  std::vector<Value> &values = scope.values;
+
+  unsigned &valueID = scope.nextValueID;
+  unsigned valueIDEnd = valueID + newValues.size();
+  if (valueIDEnd > values.size()) {
+    return reader.emitError(
+        "value index range was outside of the expected range for "
+        "the parent region, got [",
+        valueID, ", ", valueIDEnd, "), but the maximum index was ",
+        values.size() - 1);
+  }
+
+  // Assign the values and update any forward references.
+  for (unsigned i = 0, e = newValues.size(); i != e; ++i, ++valueID) {
+    Value newValue = newValues[i];
+
+    // Check to see if a definition for this value already exists.
+    if (Value oldValue = std::exchange(values[valueID], newValue)) {
+      Operation *forwardRefOp = oldValue.getDefiningOp();
+
+      // Assert that this is a forward reference operation. Given how we compute
+      // definition ids (incrementally as we parse), it shouldn't be possible
+      // for the value to be defined any other way.
+      assert(forwardRefOp && forwardRefOp->getBlock() == &forwardRefOps &&
+             "value index was already defined?");
+
+      oldValue.replaceAllUsesWith(newValue);
+      forwardRefOp->erase();
+      --scope.numForwardRefs;
+    }
+  }
+  return success();
+}
+
+Value BytecodeReader::Impl::createForwardRef() {
+  // Create a new fake operation to use for the reference. The type of the
+  // reference doesn't matter, as all of its uses are replaced once the value is
+  // defined.
+  OperationState state(fileLoc,
+                       UnrealizedConversionCastOp::getOperationName());
+  state.addTypes(NoneType::get(getContext()));
+  Operation *op = Operation::create(state);
+  forwardRefOps.push_back(op);
+  return op->getResult(0);
+}
+
+LogicalResult BytecodeReader::Impl::popScope(EncodingReader &reader) {
+  if (valueScopes.back().numForwardRefs) {
+    return reader.emitError(
+        "not all forward unresolved forward operand references");
+  }
+  valueScopes.pop_back();
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Lazy Loading
+
+LogicalResult BytecodeReader::Impl::materialize(Operation *op) {
+  auto it = lazyLoadableOps.find(op);
+  assert(it != lazyLoadableOps.end() &&
+         "expected op to be materializable");
+  ArrayRef<uint8_t> regionsData = it->second;
+  lazyLoadableOps.erase(it);
+  return parseIsolatedRegions(op, regionsData);
+}
+
+LogicalResult BytecodeReader::Impl::materializeAll() {
+  while (!lazyLoadableOps.empty())
+    if (failed(materialize(lazyLoadableOps.begin()->first)))
+      return failure();
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Entry Points
+//===----------------------------------------------------------------------===//
+
+BytecodeReader::BytecodeReader(llvm::MemoryBufferRef buffer,
+                               MLIRContext *context, bool lazyLoad) {
+  Location fileLoc =
+      FileLineColLoc::get(context, buffer.getBufferIdentifier(), /*line=*/0,
+                          /*column=*/0);
+  impl = std::make_unique<Impl>(buffer, fileLoc, lazyLoad);
+}
+
+BytecodeReader::~BytecodeReader() = default;
+
+LogicalResult BytecodeReader::readTopLevel(Block *block,
+                                           LocationAttr *sourceFileLoc) {
+  if (sourceFileLoc)
+    *sourceFileLoc = impl->getFileLoc();
+  return impl->read(block);
+}
+
+int64_t BytecodeReader::getNumOpsToMaterialize() const {
+  return impl->getNumOpsToMaterialize();
+}
+
+bool BytecodeReader::isMaterializable(Operation *op) {
+  return impl->isMaterializable(op);
+}
+
+LogicalResult BytecodeReader::materialize(Operation *op) {
+  return impl->materialize(op);
+}
+
+LogicalResult BytecodeReader::materializeAll() {
+  return impl->materializeAll();
+}
+
+bool mlir::isBytecode(llvm::MemoryBufferRef buffer) {
+  return buffer.getBuffer().startswith(
+      StringRef(bytecode::kMagic, sizeof(bytecode::kMagic)));
+}
+
+LogicalResult mlir::readBytecodeFile(llvm::MemoryBufferRef buffer,
+                                     Block *block, MLIRContext *context,
+                                     LocationAttr *sourceFileLoc) {
+  BytecodeReader reader(buffer, context);
+  return reader.readTopLevel(block, sourceFileLoc);
+}
@@ -0,0 +1,198 @@
+//===- IRNumbering.cpp - MLIR Bytecode IR numbering -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "IRNumbering.h"
+#include "mlir/Bytecode/BytecodeImplementation.h"
+#include "mlir/IR/OpDefinition.h"
+
+using namespace mlir;
+using namespace mlir::bytecode::detail;
+
+//===----------------------------------------------------------------------===//
+// NumberingDialectWriter
+//===----------------------------------------------------------------------===//
+
+struct mlir::bytecode::detail::NumberingDialectWriter
+    : public DialectBytecodeWriter {
+  NumberingDialectWriter(IRNumberingState &state) : state(state) {}
+
+  void writeAttribute(Attribute attr) override { state.number(attr); }
+  void writeType(Type type) override { state.number(type); }
+
+  /// Stubbed out methods that are not used for numbering.
+  void writeVarInt(uint64_t) override {}
+  void writeSignedVarInt(int64_t value) override {}
+  void writeAPIntWithKnownWidth(const APInt &value) override {}
+  void writeAPFloatWithKnownSemantics(const APFloat &value) override {}
+  void writeOwnedString(StringRef) override {
+    // TODO: It might be nice to prenumber strings and sort by the number of
+    // references. This could potentially be useful for optimizing things like
+    // file locations.
+  }
+  void writeOwnedBlob(ArrayRef<char> blob) override {}
+
+  /// The parent numbering state that is populated by this writer.
+  IRNumberingState &state;
+};
+
+//===----------------------------------------------------------------------===//
+// IRNumberingState
+//===----------------------------------------------------------------------===//
+
+/// Group and sort the elements of the given range by their parent dialect. This
+/// grouping is applied to sub-sections of the ranged elements, so that the
+/// elements of a dialect are contiguous, and within a dialect the most
+/// referenced elements get the smallest numbers (and thus the most compact
+/// encoding).
+template <typename T>
+static void groupByDialect(std::vector<T *> &range) {
+  std::stable_sort(range.begin(), range.end(), [](const T *lhs, const T *rhs) {
+    if (lhs->dialect->number != rhs->dialect->number)
+      return lhs->dialect->number < rhs->dialect->number;
+    return lhs->refCount > rhs->refCount;
+  });
+  for (auto it : llvm::enumerate(range))
+    it.value()->number = it.index();
+}
+
+IRNumberingState::IRNumberingState(Operation *op) : context(op->getContext()) {
+  // Number the root operation, which defines the values of the top level
+  // scope.
+  unsigned nextValueID = 0;
+  number(*op, nextValueID);
+  numTopLevelValues = nextValueID;
+
+  // Group the attributes, types, and operation names by their dialect.
+  groupByDialect(orderedAttrs);
+  groupByDialect(orderedOpNames);
+  groupByDialect(orderedTypes);
+}
+
+void IRNumberingState::number(Attribute attr) {
+  auto it = attrs.insert({attr, nullptr});
+  if (!it.second) {
+    ++it.first->second->refCount;
+    return;
+  }
+  auto *numbering = new (attrAllocator.Allocate()) AttributeNumbering(attr);
+  it.first->second = numbering;
+  orderedAttrs.push_back(numbering);
+
+  // Otherwise, this is a new attribute. Number its dialect, and any nested
+  // components referenced by its custom encoding if it has one.
+  numbering->dialect = &numberDialect(attr.getDialect().getNamespace());
+  if (const BytecodeDialectInterface *interface =
+          numbering->dialect->interface) {
+    NumberingDialectWriter writer(*this);
+    (void)interface->writeAttribute(attr, writer);
+  }
+}
+
+void IRNumberingState::number(Block &block, unsigned &nextValueID) {
+  // Number the arguments of the block.
+  for (BlockArgument arg : block.getArguments()) {
+    valueIDs.try_emplace(arg, nextValueID++);
+    number(arg.getLoc());
+    number(arg.getType());
+  }
+
+  // Number the operations in this block.
+  for (Operation &op : block)
+    number(op, nextValueID);
+}
+
+DialectNumbering &IRNumberingState::numberDialect(StringRef dialect) {
+  DialectNumbering *&numbering = dialects[dialect];
+  if (!numbering) {
+    numbering = new (dialectAllocator.Allocate())
+        DialectNumbering(dialect, dialects.size() - 1);
+    if (Dialect *loadedDialect = context->getLoadedDialect(dialect))
+      numbering->interface =
+          loadedDialect->getRegisteredInterface<BytecodeDialectInterface>();
+  }
+  return *numbering;
+}
+
+void IRNumberingState::number(Operation &op, unsigned &nextValueID) {
+  number(op.getName());
+
+  // Number the results of the operation.
+  for (OpResult result : op.getResults()) {
+    valueIDs.try_emplace(result, nextValueID++);
+    number(result.getType());
+  }
+
+  // Only number the attribute dictionary if it isn't empty.
+  DictionaryAttr dictAttr = op.getAttrDictionary();
+  if (!dictAttr.empty())
+    number(dictAttr);
+
+  number(op.getLoc());
+
+  // Number the regions of the operation. Values defined in regions that are
+  // isolated from above get their own numbering scope, other regions continue
+  // the numbering of the enclosing scope.
+  bool isIsolatedFromAbove = op.hasTrait<OpTrait::IsIsolatedFromAbove>();
+  for (Region &region : op.getRegions()) {
+    unsigned isolatedValueID = 0;
+    number(region, isIsolatedFromAbove ? isolatedValueID : nextValueID);
+  }
+}
+
+void IRNumberingState::number(OperationName opName) {
+  OpNameNumbering *&numbering = opNames[opName];
+  if (numbering) {
+    ++numbering->refCount;
+    return;
+  }
+  DialectNumbering *dialectNumber =
+      &numberDialect(opName.getDialectNamespace());
+  numbering =
+      new (opNameAllocator.Allocate()) OpNameNumbering(dialectNumber, opName);
+  orderedOpNames.push_back(numbering);
+}
+
+void IRNumberingState::number(Region &region, unsigned &nextValueID) {
+  if (region.empty()) {
+    regionNumValues.try_emplace(&region, 0);
+    return;
+  }
+  unsigned startValueID = nextValueID;
+
+  // Number the blocks upfront, so that successors can refer to blocks that
+  // appear later in the region.
+  unsigned blockID = 0;
+  for (Block &block : region)
+    blockIDs.try_emplace(&block, blockID++);
+
+  // Number each of the blocks within the region.
+  for (Block &block : region)
+    number(block, nextValueID);
+
+  regionNumValues.try_emplace(&region, nextValueID - startValueID);
+}
+
+void IRNumberingState::number(Type type) {
+  auto it = types.insert({type, nullptr});
+  if (!it.second) {
+    ++it.first->second->refCount;
+    return;
+  }
+  auto *numbering = new (typeAllocator.Allocate()) TypeNumbering(type);
+  it.first->second = numbering;
+  orderedTypes.push_back(numbering);
+
+  // Otherwise, this is a new type. Number its dialect, and any nested
+  // components referenced by its custom encoding if it has one.
+  numbering->dialect = &numberDialect(type.getDialect().getNamespace());
+  if (const BytecodeDialectInterface *interface =
+          numbering->dialect->interface) {
+    NumberingDialectWriter writer(*this);
+    (void)interface->writeType(type, writer);
+  }
+}
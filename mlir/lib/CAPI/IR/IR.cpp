@@ -12,6 +12,8 @@
 #include "mlir/CAPI/IR.h"
 #include "mlir/CAPI/Support.h"
 #include "mlir/CAPI/Utils.h"
+#include "mlir/Bytecode/BytecodeReader.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Dialect.h"
@@ -23,6 +25,7 @@
 #include "mlir/Parser.h"
 
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MemoryBufferRef.h"
 #include <cstddef>
 
 using namespace mlir;
@@ -194,8 +197,20 @@ MlirModule mlirModuleCreateEmpty(MlirLocation location) {
 }
 
 MlirModule mlirModuleCreateParse(MlirContext context, MlirStringRef module) {
-  OwningOpRef<ModuleOp> owning =
-      parseSourceString(unwrap(module), unwrap(context));
+  MLIRContext *ctx = unwrap(context);
+  llvm::MemoryBufferRef buffer(unwrap(module), /*Identifier=*/"");
+  OwningOpRef<ModuleOp> owning;
+  if (isBytecode(buffer)) {
+    // The module is encoded as bytecode, read it into a module as the textual
+    // parser would.
+    Block block;
+    LocationAttr sourceFileLoc;
+    if (succeeded(readBytecodeFile(buffer, &block, ctx, &sourceFileLoc)))
+      owning = detail::constructContainerOpForParserIfNecessary<ModuleOp>(
+          &block, ctx, sourceFileLoc);
+  } else {
+    owning = parseSourceString(unwrap(module), ctx);
+  }
   if (!owning)
     return MlirModule{nullptr};
   return MlirModule{owning.release().getOperation()};
@@ -480,6 +495,12 @@ void mlirOperationPrintWithFlags(MlirOperation op, MlirOpPrintingFlags flags,
   unwrap(op)->print(stream, *unwrap(flags));
 }
 
+void mlirOperationWriteBytecode(MlirOperation op, MlirStringCallback callback,
+                                void *userData) {
+  detail::CallbackOstream stream(callback, userData);
+  writeBytecodeToFile(unwrap(op), stream);
+}
+
 void mlirOperationDump(MlirOperation op) { return unwrap(op)->dump(); }
 
 bool mlirOperationVerify(MlirOperation op) {
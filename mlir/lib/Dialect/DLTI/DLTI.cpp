@@ -312,6 +312,8 @@ constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutAttrName;
 constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutEndiannessKey;
 constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutEndiannessBig;
 constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutEndiannessLittle;
+constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutL1CacheSizeKey;
+constexpr const StringLiteral mlir::DLTIDialect::kDataLayoutVectorSizeKey;
 
 namespace {
 class TargetDataLayoutInterface : public DataLayoutDialectInterface {
@@ -332,6 +334,15 @@ public:
                             << DLTIDialect::kDataLayoutEndiannessBig << "' or '"
                             << DLTIDialect::kDataLayoutEndiannessLittle << "'";
     }
+    if (entryName == DLTIDialect::kDataLayoutL1CacheSizeKey ||
+        entryName == DLTIDialect::kDataLayoutVectorSizeKey) {
+      auto value = entry.getValue().dyn_cast<IntegerAttr>();
+      if (value && value.getValue().isStrictlyPositive())
+        return success();
+      return emitError(loc) << "'" << entryName
+                            << "' data layout entry is expected to be a "
+                               "positive integer";
+    }
     return emitError(loc) << "unknown data layout entry name: " << entryName;
   }
 };
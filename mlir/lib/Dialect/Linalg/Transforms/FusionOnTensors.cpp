@@ -322,8 +322,9 @@ LogicalResult TileLoopNest::tileRootOp(
   return success();
 }
 
-FailureOr<LinalgOp> TileLoopNest::fuseProducer(OpBuilder &b,
-                                               OpOperand *consumerOpOperand) {
+FailureOr<LinalgOp>
+TileLoopNest::fuseProducer(OpBuilder &b, OpOperand *consumerOpOperand,
+                           function_ref<bool(LinalgOp)> controlFn) {
   // Check if the consumer has been tiled before. For example, it may not have
   // been tiled if the outermost tile loop is a reduction loop.
   if (tiledRootAndFusedOpsLoops.count(consumerOpOperand->getOwner()) == 0)
@@ -360,6 +361,8 @@ FailureOr<LinalgOp> TileLoopNest::fuseProducer(OpBuilder &b,
   }
   if (!producerResult || !isa<LinalgOp>(producerResult.getOwner()))
     return failure();
+  if (controlFn && !controlFn(cast<LinalgOp>(producerResult.getOwner())))
+    return failure();
 
   // Compute the tiled producer slice dimensions given the tiled consumer loops.
   SmallVector<int64_t> tiledSliceDimIndices = getTiledSliceDims(
@@ -415,7 +418,8 @@ SmallVector<LinalgOp> TileLoopNest::getAllTiledAndFusedOps() {
 FailureOr<TileLoopNest> mlir::linalg::tileConsumerAndFuseProducers(
     OpBuilder &b, LinalgOp consumerOp, ArrayRef<int64_t> tileSizes,
     ArrayRef<int64_t> tileInterchange,
-    Optional<LinalgLoopDistributionOptions> tileDistribution) {
+    Optional<LinalgLoopDistributionOptions> tileDistribution,
+    function_ref<bool(LinalgOp)> controlFn) {
   assert(tileSizes.size() == tileInterchange.size() &&
          "expect the number of tile sizes and interchange dims to match");
   assert(isPermutation(tileInterchange) &&
@@ -439,7 +443,7 @@ FailureOr<TileLoopNest> mlir::linalg::tileConsumerAndFuseProducers(
     SmallVector<OpOperand *> candidates(operands.begin(), operands.end());
     while (!candidates.empty()) {
       FailureOr<LinalgOp> fusedProducer =
-          tileLoopNest.fuseProducer(b, candidates.pop_back_val());
+          tileLoopNest.fuseProducer(b, candidates.pop_back_val(), controlFn);
       if (failed(fusedProducer))
         continue;
       candidates.append(fusedProducer->getInputAndOutputOperands());
@@ -0,0 +1,249 @@
+//===- TileSizeSelection.cpp - Cost model driven tile sizes ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the selection of tile sizes for Linalg operations from
+// target properties, and the grouping of contractions and convolutions with
+// the producers to fuse into them.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Linalg/Transforms/TileSizeSelection.h"
+#include "mlir/Dialect/DLTI/DLTI.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
+#include "mlir/Interfaces/DataLayoutInterfaces.h"
+#include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+#include <limits>
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+//===----------------------------------------------------------------------===//
+// TileSizeSelectionTarget
+//===----------------------------------------------------------------------===//
+
+/// Returns the value of the integer entry `key` of the closest data layout
+/// specification enclosing `op`, if any.
+static Optional<int64_t> lookupTargetEntry(Operation *op, StringRef key) {
+  StringAttr keyAttr = StringAttr::get(op->getContext(), key);
+  for (Operation *parent = op; parent; parent = parent->getParentOp()) {
+    auto layoutOp = dyn_cast<DataLayoutOpInterface>(parent);
+    if (!layoutOp)
+      continue;
+    DataLayoutSpecInterface spec = layoutOp.getDataLayoutSpec();
+    if (!spec)
+      continue;
+    if (DataLayoutEntryInterface entry = spec.getSpecForIdentifier(keyAttr))
+      if (auto value = entry.getValue().dyn_cast<IntegerAttr>())
+        return value.getInt();
+  }
+  return llvm::None;
+}
+
+TileSizeSelectionTarget TileSizeSelectionTarget::get(Operation *op) {
+  TileSizeSelectionTarget target;
+  if (Optional<int64_t> size =
+          lookupTargetEntry(op, DLTIDialect::kDataLayoutL1CacheSizeKey))
+    target.l1CacheSizeInBytes = *size;
+  if (Optional<int64_t> size =
+          lookupTargetEntry(op, DLTIDialect::kDataLayoutVectorSizeKey))
+    target.vectorSizeInBits = *size;
+  return target;
+}
+
+//===----------------------------------------------------------------------===//
+// Tile size selection
+//===----------------------------------------------------------------------===//
+
+/// Returns the size in bits of the elements of `value`. Elements that are not
+/// integers or floats are assumed to be 64 bits wide.
+static int64_t getElementBitWidth(Value value) {
+  Type elementType = getElementTypeOrSelf(value.getType());
+  if (elementType.isIntOrFloat())
+    return std::max<int64_t>(elementType.getIntOrFloatBitWidth(), 8);
+  return 64;
+}
+
+/// Returns the number of distinct values `expr` takes when every loop `d`
+/// iterates over `tileSizes[d]` consecutive values.
+static int64_t getTileExtent(AffineExpr expr, ArrayRef<int64_t> tileSizes) {
+  if (auto dim = expr.dyn_cast<AffineDimExpr>())
+    return tileSizes[dim.getPosition()];
+  if (expr.isSymbolicOrConstant())
+    return 1;
+  if (auto binOp = expr.dyn_cast<AffineBinaryOpExpr>()) {
+    if (binOp.getKind() == AffineExprKind::Add)
+      return getTileExtent(binOp.getLHS(), tileSizes) +
+             getTileExtent(binOp.getRHS(), tileSizes) - 1;
+    // A strided access spans `(extent - 1) * stride + 1` values.
+    auto cst = binOp.getRHS().dyn_cast<AffineConstantExpr>();
+    if (binOp.getKind() == AffineExprKind::Mul && cst)
+      return (getTileExtent(binOp.getLHS(), tileSizes) - 1) *
+                 std::abs(cst.getValue()) +
+             1;
+  }
+
+  // Conservatively assume that other expressions span as many values as the
+  // largest tile of the loops they use.
+  int64_t extent = 1;
+  expr.walk([&](AffineExpr e) {
+    if (auto dim = e.dyn_cast<AffineDimExpr>())
+      extent = std::max(extent, tileSizes[dim.getPosition()]);
+  });
+  return extent;
+}
+
+/// Returns the number of bytes accessed by one tile of `op`.
+static int64_t getTileFootprint(LinalgOp op, ArrayRef<int64_t> tileSizes) {
+  int64_t footprint = 0;
+  for (OpOperand *opOperand : op.getInputAndOutputOperands()) {
+    int64_t numElements = 1;
+    for (AffineExpr expr : op.getTiedIndexingMap(opOperand).getResults())
+      numElements *= getTileExtent(expr, tileSizes);
+    footprint += numElements * getElementBitWidth(opOperand->get()) / 8;
+  }
+  return footprint;
+}
+
+/// Returns the innermost parallel loop that indexes the innermost dimension of
+/// the first output, which is the loop to vectorize.
+static Optional<unsigned> getVectorLoop(LinalgOp op) {
+  if (op.getNumOutputs() == 0)
+    return llvm::None;
+  AffineMap outputMap = op.getTiedIndexingMap(op.getOutputOperand(0));
+  if (outputMap.getNumResults() == 0)
+    return llvm::None;
+  auto dim = outputMap.getResults().back().dyn_cast<AffineDimExpr>();
+  if (!dim || !isParallelIterator(op.iterator_types()[dim.getPosition()]))
+    return llvm::None;
+  return dim.getPosition();
+}
+
+SmallVector<int64_t>
+mlir::linalg::selectTileSizes(LinalgOp op,
+                              const TileSizeSelectionTarget &target) {
+  unsigned numLoops = op.getNumLoops();
+  SmallVector<int64_t> ranges = op.getStaticLoopRanges();
+  if (ranges.size() != numLoops)
+    return SmallVector<int64_t>(numLoops, 0);
+
+  // Dynamic loop ranges are considered unbounded.
+  for (int64_t &range : ranges)
+    if (range <= 0)
+      range = std::numeric_limits<int64_t>::max();
+
+  // Start with tiles that fill one vector register along the vectorized loop.
+  SmallVector<int64_t> tileSizes(numLoops, 1);
+  if (Optional<unsigned> vectorLoop = getVectorLoop(op)) {
+    int64_t elementBitWidth =
+        getElementBitWidth(op.getOutputOperand(0)->get());
+    int64_t numLanes =
+        std::max<int64_t>(target.vectorSizeInBits / elementBitWidth, 1);
+    tileSizes[*vectorLoop] = std::min(numLanes, ranges[*vectorLoop]);
+  }
+
+  // Greedily double the tile size that maximizes the ratio of iterations to
+  // bytes accessed per tile, as long as the tile fits into the cache budget.
+  // Half of the cache is left for the data of the surrounding computation.
+  int64_t budget = target.l1CacheSizeInBytes / 2;
+  auto getNumIterations = [](ArrayRef<int64_t> sizes) {
+    double numIterations = 1;
+    for (int64_t size : sizes)
+      numIterations *= size;
+    return numIterations;
+  };
+  while (true) {
+    Optional<unsigned> bestLoop;
+    int64_t bestSize = 0;
+    double bestRatio = 0;
+    for (unsigned loop = 0; loop < numLoops; ++loop) {
+      if (tileSizes[loop] >= ranges[loop])
+        continue;
+      SmallVector<int64_t> candidate(tileSizes);
+      candidate[loop] = std::min(tileSizes[loop] * 2, ranges[loop]);
+      int64_t footprint = getTileFootprint(op, candidate);
+      if (footprint > budget || footprint <= 0)
+        continue;
+      double ratio = getNumIterations(candidate) / footprint;
+      if (!bestLoop || ratio > bestRatio) {
+        bestLoop = loop;
+        bestSize = candidate[loop];
+        bestRatio = ratio;
+      }
+    }
+    if (!bestLoop)
+      break;
+    tileSizes[*bestLoop] = bestSize;
+  }
+
+  // Loops that are covered by a single tile do not need to be tiled.
+  for (unsigned loop = 0; loop < numLoops; ++loop)
+    if (tileSizes[loop] >= ranges[loop])
+      tileSizes[loop] = 0;
+  return tileSizes;
+}
+
+//===----------------------------------------------------------------------===//
+// Tiling and fusion schedules
+//===----------------------------------------------------------------------===//
+
+/// Returns true if `op` is the root of a tiling and fusion schedule.
+static bool isScheduleRoot(LinalgOp op) {
+  return op.hasTensorSemantics() &&
+         (isaContractionOpInterface(op) ||
+          isa<ConvolutionOpInterface>(op.getOperation()));
+}
+
+SmallVector<TileAndFuseSchedule>
+mlir::linalg::computeTileAndFuseSchedules(Operation *op) {
+  SmallVector<TileAndFuseSchedule> schedules;
+  op->walk([&](LinalgOp rootOp) {
+    if (!isScheduleRoot(rootOp))
+      return;
+    TileAndFuseSchedule &schedule = schedules.emplace_back();
+    schedule.rootOp = rootOp;
+    schedule.tileSizes =
+        selectTileSizes(rootOp, TileSizeSelectionTarget::get(rootOp));
+
+    // Collect the producers to fuse, transitively through the operands of the
+    // fused producers. Contractions and convolutions are not fused, since they
+    // would be recomputed for every tile of the root.
+    llvm::SetVector<Operation *> producers;
+    SmallVector<OpOperand *> worklist = rootOp.getInputAndOutputOperands();
+    while (!worklist.empty()) {
+      auto producer = worklist.pop_back_val()->get().getDefiningOp<LinalgOp>();
+      if (!producer || producer->getBlock() != rootOp->getBlock() ||
+          !producer.hasTensorSemantics() || isScheduleRoot(producer) ||
+          !producers.insert(producer))
+        continue;
+      worklist.append(producer.getInputAndOutputOperands());
+    }
+    for (Operation *producer : producers)
+      schedule.fusedProducers.push_back(cast<LinalgOp>(producer));
+  });
+  return schedules;
+}
+
+FailureOr<TileLoopNest>
+mlir::linalg::applyTileAndFuseSchedule(OpBuilder &b,
+                                       const TileAndFuseSchedule &schedule) {
+  if (llvm::all_of(schedule.tileSizes, [](int64_t size) { return size == 0; }))
+    return failure();
+  llvm::SmallPtrSet<Operation *, 8> producers;
+  for (LinalgOp producer : schedule.fusedProducers)
+    producers.insert(producer);
+  SmallVector<int64_t> interchange =
+      llvm::to_vector<6>(llvm::seq<int64_t>(0, schedule.tileSizes.size()));
+  return tileConsumerAndFuseProducers(
+      b, schedule.rootOp, schedule.tileSizes, interchange,
+      /*tileDistribution=*/llvm::None, [&](LinalgOp producer) {
+        return producers.contains(producer);
+      });
+}
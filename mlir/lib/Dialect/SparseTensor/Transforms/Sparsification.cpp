@@ -430,6 +430,51 @@ static Value genVectorReducEnd(CodeGen &codegen, PatternRewriter &rewriter,
   return rewriter.create<vector::ReductionOp>(loc, kind, codegen.redVal);
 }
 
+/// Generates the identity value of a scalar reduction, which seeds the partial
+/// reduction computed by each iteration of a parallel loop.
+static Value genReducIdentity(CodeGen &codegen, PatternRewriter &rewriter,
+                              Location loc, Type tp) {
+  switch (codegen.redKind) {
+  case kNoReduc:
+    break;
+  case kSum:
+  case kOr:
+  case kXor:
+    return constantZero(rewriter, loc, tp);
+  case kProduct:
+    return constantOne(rewriter, loc, tp);
+  case kAnd:
+    return rewriter.create<arith::ConstantOp>(loc, tp,
+                                              rewriter.getIntegerAttr(tp, -1));
+  }
+  llvm_unreachable("unknown reduction kind");
+}
+
+/// Generates the combination of two partial scalar reductions.
+static Value genReducCombine(CodeGen &codegen, OpBuilder &builder,
+                             Location loc, Value lhs, Value rhs) {
+  bool isFloat = lhs.getType().isa<FloatType>();
+  switch (codegen.redKind) {
+  case kNoReduc:
+    break;
+  case kSum:
+    if (isFloat)
+      return builder.create<arith::AddFOp>(loc, lhs, rhs);
+    return builder.create<arith::AddIOp>(loc, lhs, rhs);
+  case kProduct:
+    if (isFloat)
+      return builder.create<arith::MulFOp>(loc, lhs, rhs);
+    return builder.create<arith::MulIOp>(loc, lhs, rhs);
+  case kAnd:
+    return builder.create<arith::AndIOp>(loc, lhs, rhs);
+  case kOr:
+    return builder.create<arith::OrIOp>(loc, lhs, rhs);
+  case kXor:
+    return builder.create<arith::XOrIOp>(loc, lhs, rhs);
+  }
+  llvm_unreachable("unknown reduction kind");
+}
+
 /// Updates scalarized reduction value.
 static void updateReduc(Merger &merger, CodeGen &codegen, Value reduc) {
   assert(codegen.redKind != kNoReduc);
@@ -1055,23 +1100,32 @@ static bool isVectorFor(CodeGen &codegen, bool isInner, bool isSparse) {
 /// Returns parallelization strategy. Any implicit loop in the Linalg operation
 /// that is marked "parallel" is a candidate. Whether it is actually converted
 /// to a parallel operation depends on the requested strategy.
-static bool isParallelFor(CodeGen &codegen, bool isOuter, bool isReduction,
-                          bool isSparse, bool isVector) {
+static bool isParallelFor(CodeGen &codegen, bool isOuter, bool isSparse,
+                          bool isVector) {
   switch (codegen.options.parallelizationStrategy) {
   case SparseParallelizationStrategy::kNone:
     return false;
   case SparseParallelizationStrategy::kDenseOuterLoop:
-    return isOuter && !isSparse && !isReduction && !isVector;
+    return isOuter && !isSparse && !isVector;
   case SparseParallelizationStrategy::kAnyStorageOuterLoop:
-    return isOuter && !isReduction && !isVector;
+    return isOuter && !isVector;
   case SparseParallelizationStrategy::kDenseAnyLoop:
-    return !isSparse && !isReduction && !isVector;
+    return !isSparse && !isVector;
   case SparseParallelizationStrategy::kAnyStorageAnyLoop:
-    return !isReduction && !isVector;
+    return !isVector;
   }
   llvm_unreachable("unexpected parallelization strategy");
 }
 
+/// Returns true if a loop that is marked "reduction" can be made parallel.
+/// This requires the reduction to be scalarized, so that every iteration
+/// computes a partial reduction that is combined with an `scf.reduce`. Note
+/// that, just like vectorization, this reassociates floating-point reductions.
+static bool isParallelReduc(CodeGen &codegen) {
+  return codegen.redVal && codegen.redKind != kNoReduc &&
+         !codegen.redVal.getType().isa<VectorType>();
+}
+
 /// Checks unit stride for dense tensors. The iteration graph may have ignored
 /// dense access patterns in order to avoid cycles (sparse access patterns are
 /// always placed innermost), but that means dense access has become strided.
@@ -1111,9 +1165,9 @@ static Operation *genFor(Merger &merger, CodeGen &codegen,
   bool isVector = !codegen.sparseOut &&
                   isVectorFor(codegen, isInner, isSparse) &&
                   denseUnitStrides(merger, op, idx);
-  bool isParallel =
-      !codegen.sparseOut &&
-      isParallelFor(codegen, isOuter, isReduction, isSparse, isVector);
+  bool isParallel = !codegen.sparseOut &&
+                    (!isReduction || isParallelReduc(codegen)) &&
+                    isParallelFor(codegen, isOuter, isSparse, isVector);
 
   // Prepare vector length.
   if (isVector)
@@ -1125,15 +1179,25 @@ static Operation *genFor(Merger &merger, CodeGen &codegen,
   Value hi = isSparse ? codegen.highs[tensor][idx] : codegen.sizes[idx];
   Value step = constantIndex(rewriter, loc, codegen.curVecLength);
 
-  // Emit a parallel loop.
+  // Emit a parallel loop. A pending scalar reduction becomes the initial
+  // value of the parallel loop, while the body starts its partial reduction
+  // from the identity.
   if (isParallel) {
     assert(!isVector);
-    scf::ParallelOp parOp = rewriter.create<scf::ParallelOp>(loc, lo, hi, step);
+    SmallVector<Value, 1> inits;
+    if (codegen.redVal)
+      inits.push_back(codegen.redVal);
+    scf::ParallelOp parOp =
+        rewriter.create<scf::ParallelOp>(loc, lo, hi, step, inits);
     if (isSparse)
       codegen.pidxs[tensor][idx] = parOp.getInductionVars()[0];
     else
       codegen.loops[idx] = parOp.getInductionVars()[0];
     rewriter.setInsertionPointToStart(parOp.getBody());
+    if (codegen.redVal)
+      updateReduc(merger, codegen,
+                  genReducIdentity(codegen, rewriter, loc,
+                                   codegen.redVal.getType()));
     return parOp;
   }
 
@@ -1390,15 +1454,25 @@ static void genForInduction(Merger &merger, CodeGen &codegen,
   unsigned o = 0;
   SmallVector<Value, 4> operands;
   if (codegen.redVal) {
-    operands.push_back(codegen.redVal);
+    if (isa<scf::ParallelOp>(loop)) {
+      // Combine the partial reduction of this iteration with the others.
+      rewriter.create<scf::ReduceOp>(
+          loc, codegen.redVal,
+          [&](OpBuilder &builder, Location loc, Value lhs, Value rhs) {
+            Value red = genReducCombine(codegen, builder, loc, lhs, rhs);
+            builder.create<scf::ReduceReturnOp>(loc, red);
+          });
+    } else {
+      operands.push_back(codegen.redVal);
+    }
     updateReduc(merger, codegen, loop->getResult(o++));
   }
   if (codegen.expValues) {
     operands.push_back(codegen.expCount);
     codegen.expCount = loop->getResult(o++);
   }
-  assert(o == operands.size());
-  if (o > 0)
+  assert(o == operands.size() || isa<scf::ParallelOp>(loop));
+  if (!operands.empty())
     rewriter.create<scf::YieldOp>(loc, operands);
   rewriter.setInsertionPointAfter(loop);
 }
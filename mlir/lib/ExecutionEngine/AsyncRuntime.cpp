@@ -18,14 +18,15 @@
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
-#include <functional>
+#include <deque>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
 
 #include "llvm/ADT/StringMap.h"
-#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace mlir::runtime;
 
@@ -40,6 +41,201 @@ namespace {
 // Forward declare class defined below.
 class RefCounted;
 
+// -------------------------------------------------------------------------- //
+// Work stealing scheduler for the coroutines launched by the async runtime.
+//
+// Every worker thread owns a queue of tasks. Tasks launched from a worker
+// thread are pushed to the back of its own queue and the worker pops tasks from
+// the back (LIFO), so that a continuation runs next on the thread that launched
+// it while its data is still in the cache. Tasks launched from other threads
+// are spread over the worker queues in a round robin fashion. Idle workers
+// steal tasks from the front of the queues of other workers (FIFO), and park
+// when no tasks are queued anywhere.
+// -------------------------------------------------------------------------- //
+
+class Scheduler {
+public:
+  // A task is a coroutine handle with the function that resumes it, which
+  // makes scheduling a task allocation free.
+  struct Task {
+    CoroResume resume;
+    CoroHandle handle;
+  };
+
+  explicit Scheduler(
+      llvm::ThreadPoolStrategy strategy = llvm::hardware_concurrency());
+  ~Scheduler();
+
+  // Schedules `task` for execution in one of the worker threads.
+  void schedule(Task task);
+
+  // Blocks the caller thread until all scheduled tasks are completed. Must not
+  // be called from a worker thread.
+  void wait();
+
+  unsigned getThreadCount() const { return workers.size(); }
+
+private:
+  struct Worker {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  // Pops the most recently scheduled task of the worker `index`.
+  bool popTask(unsigned index, Task &task);
+
+  // Steals the least recently scheduled task of any worker other than `index`.
+  bool stealTask(unsigned index, Task &task);
+
+  void runTask(Task task);
+  void workerLoop(unsigned index);
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+
+  // The worker queue for the next task scheduled from a non-worker thread.
+  std::atomic<unsigned> nextWorker;
+
+  // The number of tasks in the worker queues.
+  std::atomic<int64_t> numQueued;
+
+  // The number of tasks scheduled but not yet completed.
+  std::atomic<int64_t> numPending;
+
+  // Idle workers park on a condition variable until new tasks are queued.
+  std::mutex parkMu;
+  std::condition_variable parkCv;
+  std::atomic<int> numParked;
+  bool stopping;
+
+  // Signals the completion of all pending tasks to the `wait` callers.
+  std::mutex doneMu;
+  std::condition_variable doneCv;
+};
+
+// The scheduler and the index of the worker running on the current thread, or
+// null if the current thread is not a worker thread.
+static thread_local Scheduler *currentScheduler = nullptr;
+static thread_local unsigned currentWorker = 0;
+
+Scheduler::Scheduler(llvm::ThreadPoolStrategy strategy)
+    : nextWorker(0), numQueued(0), numPending(0), numParked(0),
+      stopping(false) {
+  unsigned numThreads = std::max(strategy.compute_thread_count(), 1u);
+  for (unsigned i = 0; i < numThreads; ++i)
+    workers.push_back(std::make_unique<Worker>());
+  for (unsigned i = 0; i < numThreads; ++i)
+    threads.emplace_back([this, strategy, i]() {
+      strategy.apply_thread_strategy(i);
+      workerLoop(i);
+    });
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard<std::mutex> lock(parkMu);
+    stopping = true;
+  }
+  parkCv.notify_all();
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
+void Scheduler::schedule(Task task) {
+  numPending.fetch_add(1, std::memory_order_relaxed);
+
+  unsigned index =
+      currentScheduler == this
+          ? currentWorker
+          : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+  {
+    Worker &worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mu);
+    worker.tasks.push_back(task);
+    numQueued.fetch_add(1);
+  }
+
+  // Wake up a parked worker to pick up the task. Workers increment `numParked`
+  // before checking `numQueued`, so either the worker sees the queued task or
+  // the task is queued before this check sees the parked worker.
+  if (numParked.load() > 0) {
+    std::lock_guard<std::mutex> lock(parkMu);
+    parkCv.notify_one();
+  }
+}
+
+void Scheduler::wait() {
+  assert(currentScheduler != this && "wait must not be called from a worker");
+  std::unique_lock<std::mutex> lock(doneMu);
+  doneCv.wait(lock, [this] { return numPending.load() == 0; });
+}
+
+bool Scheduler::popTask(unsigned index, Task &task) {
+  Worker &worker = *workers[index];
+  std::lock_guard<std::mutex> lock(worker.mu);
+  if (worker.tasks.empty())
+    return false;
+  task = worker.tasks.back();
+  worker.tasks.pop_back();
+  numQueued.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool Scheduler::stealTask(unsigned index, Task &task) {
+  for (unsigned i = 1, e = workers.size(); i < e; ++i) {
+    Worker &victim = *workers[(index + i) % e];
+    std::lock_guard<std::mutex> lock(victim.mu);
+    if (victim.tasks.empty())
+      continue;
+    task = victim.tasks.front();
+    victim.tasks.pop_front();
+    numQueued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void Scheduler::runTask(Task task) {
+  (*task.resume)(task.handle);
+
+  if (numPending.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> lock(doneMu);
+    doneCv.notify_all();
+  }
+}
+
+void Scheduler::workerLoop(unsigned index) {
+  currentScheduler = this;
+  currentWorker = index;
+
+  // The number of times an idle worker yields before it parks, to avoid the
+  // cost of parking and waking up between fine-grained tasks.
+  static constexpr int kNumSpins = 64;
+
+  Task task;
+  while (true) {
+    if (popTask(index, task) || stealTask(index, task)) {
+      runTask(task);
+      continue;
+    }
+
+    bool hasQueuedTasks = false;
+    for (int i = 0; i < kNumSpins && !hasQueuedTasks; ++i) {
+      std::this_thread::yield();
+      hasQueuedTasks = numQueued.load(std::memory_order_relaxed) > 0;
+    }
+    if (hasQueuedTasks)
+      continue;
+
+    std::unique_lock<std::mutex> lock(parkMu);
+    numParked.fetch_add(1);
+    parkCv.wait(lock, [this] { return stopping || numQueued.load() > 0; });
+    numParked.fetch_sub(1);
+    if (stopping && numQueued.load() == 0)
+      return;
+  }
+}
+
 // -------------------------------------------------------------------------- //
 // AsyncRuntime orchestrates all async operations and Async runtime API is built
 // on top of the default runtime instance.
@@ -50,7 +246,7 @@ public:
   AsyncRuntime() : numRefCountedObjects(0) {}
 
   ~AsyncRuntime() {
-    threadPool.wait(); // wait for the completion of all async tasks
+    scheduler.wait(); // wait for the completion of all async tasks
     assert(getNumRefCountedObjects() == 0 &&
            "all ref counted objects must be destroyed");
   }
@@ -59,7 +255,7 @@ public:
     return numRefCountedObjects.load(std::memory_order_relaxed);
   }
 
-  llvm::ThreadPool &getThreadPool() { return threadPool; }
+  Scheduler &getScheduler() { return scheduler; }
 
 private:
   friend class RefCounted;
@@ -74,7 +270,7 @@ private:
   }
 
   std::atomic<int64_t> numRefCountedObjects;
-  llvm::ThreadPool threadPool;
+  Scheduler scheduler;
 };
 
 // -------------------------------------------------------------------------- //
@@ -136,10 +332,16 @@ public:
   RefCounted(const RefCounted &) = delete;
   RefCounted &operator=(const RefCounted &) = delete;
 
-  void addRef(int64_t count = 1) { refCount.fetch_add(count); }
+  // Adding a reference requires an existing one, so it does not need to be
+  // ordered with other memory operations.
+  void addRef(int64_t count = 1) {
+    refCount.fetch_add(count, std::memory_order_relaxed);
+  }
 
+  // Dropping a reference releases the writes of this thread to the object, and
+  // the thread dropping the last reference acquires them before destroying it.
   void dropRef(int64_t count = 1) {
-    int64_t previous = refCount.fetch_sub(count);
+    int64_t previous = refCount.fetch_sub(count, std::memory_order_acq_rel);
     assert(previous >= count && "reference count should not go below zero");
     if (previous == count)
       destroy();
@@ -153,6 +355,146 @@ private:
   std::atomic<int64_t> refCount;
 };
 
+// -------------------------------------------------------------------------- //
+// Lock-free awaiters of the async runtime values.
+// -------------------------------------------------------------------------- //
+
+// An awaiter of an async runtime value, linked into the list of awaiters of the
+// value until the value becomes available and the awaiter callback runs.
+struct Awaiter {
+  using Callback = void (*)(Awaiter *awaiter);
+
+  explicit constexpr Awaiter(Callback callback)
+      : next(nullptr), callback(callback) {}
+
+  Awaiter *next;
+  Callback callback;
+};
+
+// A lock-free list of awaiters. Awaiters are pushed to the list until it gets
+// closed, which runs all the awaiters in the order they were added. Awaiters
+// added after the list is closed are rejected and must run inline.
+class AwaiterList {
+public:
+  AwaiterList() : head(nullptr) {}
+
+  ~AwaiterList() {
+    assert((isClosed() || head.load() == nullptr) &&
+           "awaiters must not be destroyed before they run");
+  }
+
+  bool isClosed() const {
+    return head.load(std::memory_order_acquire) == getClosedSentinel();
+  }
+
+  // Adds `awaiter` to the list and returns true, or returns false if the list
+  // is already closed.
+  bool add(Awaiter *awaiter) {
+    Awaiter *current = head.load(std::memory_order_acquire);
+    do {
+      if (current == getClosedSentinel())
+        return false;
+      awaiter->next = current;
+    } while (!head.compare_exchange_weak(current, awaiter,
+                                         std::memory_order_release,
+                                         std::memory_order_acquire));
+    return true;
+  }
+
+  // Closes the list and runs all awaiters added to it.
+  void close() {
+    Awaiter *current =
+        head.exchange(getClosedSentinel(), std::memory_order_acq_rel);
+    assert(current != getClosedSentinel() && "awaiters are already closed");
+
+    // Awaiters are pushed to the front of the list, reverse it to run them in
+    // the order they were added.
+    Awaiter *reversed = nullptr;
+    while (current) {
+      Awaiter *next = current->next;
+      current->next = reversed;
+      reversed = current;
+      current = next;
+    }
+
+    // The callback might destroy the awaiter, load the next one before.
+    while (reversed) {
+      Awaiter *next = reversed->next;
+      reversed->callback(reversed);
+      reversed = next;
+    }
+  }
+
+private:
+  static Awaiter *getClosedSentinel() {
+    static Awaiter sentinel(nullptr);
+    return &sentinel;
+  }
+
+  std::atomic<Awaiter *> head;
+};
+
+// Resumes a coroutine when the awaited value becomes available.
+struct CoroAwaiter : public Awaiter {
+  CoroAwaiter(CoroHandle handle, CoroResume resume)
+      : Awaiter(&run), handle(handle), resume(resume) {}
+
+  static void run(Awaiter *awaiter) {
+    auto *coroAwaiter = static_cast<CoroAwaiter *>(awaiter);
+    CoroHandle handle = coroAwaiter->handle;
+    CoroResume resume = coroAwaiter->resume;
+    delete coroAwaiter;
+    (*resume)(handle);
+  }
+
+  CoroHandle handle;
+  CoroResume resume;
+};
+
+// Unblocks a thread waiting for the awaited value to become available. Only the
+// threads that actually block pay for a mutex and a condition variable.
+struct BlockingAwaiter : public Awaiter {
+  BlockingAwaiter() : Awaiter(&run), ready(false) {}
+
+  static void run(Awaiter *awaiter) {
+    auto *blockingAwaiter = static_cast<BlockingAwaiter *>(awaiter);
+    // Notify with the lock held, so the waiter can not destroy the awaiter
+    // before the notification completes.
+    std::lock_guard<std::mutex> lock(blockingAwaiter->mu);
+    blockingAwaiter->ready = true;
+    blockingAwaiter->cv.notify_one();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, [this] { return ready; });
+  }
+
+  std::mutex mu;
+  std::condition_variable cv;
+  bool ready;
+};
+
+// Blocks the caller thread until `awaiters` are closed.
+static void awaitBlocking(AwaiterList &awaiters) {
+  if (awaiters.isClosed())
+    return;
+  BlockingAwaiter awaiter;
+  if (awaiters.add(&awaiter))
+    awaiter.wait();
+}
+
+// Resumes the coroutine once `awaiters` are closed. If they are already closed
+// the coroutine is resumed inline, without going through the scheduler.
+static void awaitAndExecute(AwaiterList &awaiters, CoroHandle handle,
+                            CoroResume resume) {
+  if (awaiters.isClosed())
+    return (*resume)(handle);
+  auto *awaiter = new CoroAwaiter(handle, resume);
+  if (!awaiters.add(awaiter))
+    CoroAwaiter::run(awaiter);
+}
+
 } // namespace
 
 // Returns the default per-process instance of an async runtime.
@@ -181,10 +523,8 @@ struct AsyncToken : public RefCounted {
 
   std::atomic<State::StateEnum> state;
 
-  // Pending awaiters are guarded by a mutex.
-  std::mutex mu;
-  std::condition_variable cv;
-  std::vector<std::function<void()>> awaiters;
+  // Pending awaiters, closed when the token becomes available.
+  AwaiterList awaiters;
 };
 
 // Async value provides a mechanism to access the result of asynchronous
@@ -201,10 +541,8 @@ struct AsyncValue : public RefCounted {
   // Use vector of bytes to store async value payload.
   std::vector<int8_t> storage;
 
-  // Pending awaiters are guarded by a mutex.
-  std::mutex mu;
-  std::condition_variable cv;
-  std::vector<std::function<void()>> awaiters;
+  // Pending awaiters, closed when the value becomes available.
+  AwaiterList awaiters;
 };
 
 // Async group provides a mechanism to group together multiple async tokens or
@@ -212,16 +550,53 @@ struct AsyncValue : public RefCounted {
 // tokens or values added to the group).
 struct AsyncGroup : public RefCounted {
   AsyncGroup(AsyncRuntime *runtime, int64_t size)
-      : RefCounted(runtime), pendingTokens(size), numErrors(0), rank(0) {}
+      : RefCounted(runtime), pendingTokens(size), numErrors(0), rank(0) {
+    // An empty group is immediately available.
+    if (size == 0)
+      awaiters.close();
+  }
 
   std::atomic<int> pendingTokens;
   std::atomic<int> numErrors;
   std::atomic<int> rank;
 
-  // Pending awaiters are guarded by a mutex.
-  std::mutex mu;
-  std::condition_variable cv;
-  std::vector<std::function<void()>> awaiters;
+  // Pending awaiters, closed when all the tokens in the group are available.
+  AwaiterList awaiters;
+};
+
+// Updates the group when a token added to it becomes available.
+static void onGroupTokenReady(AsyncGroup *group, AsyncToken *token) {
+  // Increment the number of errors in the group.
+  if (State(token->state).isError())
+    group->numErrors.fetch_add(1);
+
+  // If pending tokens go below zero it means that more tokens than the group
+  // size were added to this group.
+  assert(group->pendingTokens > 0 && "wrong group size");
+
+  // Run all group awaiters if it was the last token in the group.
+  if (group->pendingTokens.fetch_sub(1) == 1)
+    group->awaiters.close();
+}
+
+// Updates the group when the awaited token becomes available. Keeps a reference
+// to the group until then.
+struct GroupAwaiter : public Awaiter {
+  GroupAwaiter(AsyncGroup *group, AsyncToken *token)
+      : Awaiter(&run), group(group), token(token) {
+    group->addRef();
+  }
+
+  static void run(Awaiter *awaiter) {
+    auto *groupAwaiter = static_cast<GroupAwaiter *>(awaiter);
+    AsyncGroup *group = groupAwaiter->group;
+    onGroupTokenReady(group, groupAwaiter->token);
+    delete groupAwaiter;
+    group->dropRef();
+  }
+
+  AsyncGroup *group;
+  AsyncToken *token;
 };
 
 // Adds references to reference counted runtime object.
@@ -256,47 +631,17 @@ extern "C" AsyncGroup *mlirAsyncRuntimeCreateGroup(int64_t size) {
 
 extern "C" int64_t mlirAsyncRuntimeAddTokenToGroup(AsyncToken *token,
                                                    AsyncGroup *group) {
-  std::unique_lock<std::mutex> lockToken(token->mu);
-  std::unique_lock<std::mutex> lockGroup(group->mu);
-
   // Get the rank of the token inside the group before we drop the reference.
   int rank = group->rank.fetch_add(1);
 
-  auto onTokenReady = [group, token]() {
-    // Increment the number of errors in the group.
-    if (State(token->state).isError())
-      group->numErrors.fetch_add(1);
-
-    // If pending tokens go below zero it means that more tokens than the group
-    // size were added to this group.
-    assert(group->pendingTokens > 0 && "wrong group size");
-
-    // Run all group awaiters if it was the last token in the group.
-    if (group->pendingTokens.fetch_sub(1) == 1) {
-      group->cv.notify_all();
-      for (auto &awaiter : group->awaiters)
-        awaiter();
-    }
-  };
-
-  if (State(token->state).isAvailableOrError()) {
-    // Update group pending tokens immediately and maybe run awaiters.
-    onTokenReady();
-
+  // Update group pending tokens immediately if the token is already available,
+  // otherwise when the token will become available.
+  if (token->awaiters.isClosed()) {
+    onGroupTokenReady(group, token);
   } else {
-    // Update group pending tokens when token will become ready. Because this
-    // will happen asynchronously we must ensure that `group` is alive until
-    // then, and re-ackquire the lock.
-    group->addRef();
-
-    token->awaiters.emplace_back([group, onTokenReady]() {
-      // Make sure that `dropRef` does not destroy the mutex owned by the lock.
-      {
-        std::unique_lock<std::mutex> lockGroup(group->mu);
-        onTokenReady();
-      }
-      group->dropRef();
-    });
+    auto *awaiter = new GroupAwaiter(group, token);
+    if (!token->awaiters.add(awaiter))
+      GroupAwaiter::run(awaiter);
   }
 
   return rank;
@@ -308,14 +653,8 @@ static void setTokenState(AsyncToken *token, State state) {
   assert(state.isAvailableOrError() && "must be terminal state");
   assert(State(token->state).isUnavailable() && "token must be unavailable");
 
-  // Make sure that `dropRef` does not destroy the mutex owned by the lock.
-  {
-    std::unique_lock<std::mutex> lock(token->mu);
-    token->state = state;
-    token->cv.notify_all();
-    for (auto &awaiter : token->awaiters)
-      awaiter();
-  }
+  token->state.store(state, std::memory_order_release);
+  token->awaiters.close();
 
   // Async tokens created with a ref count `2` to keep token alive until the
   // async task completes. Drop this reference explicitly when token emplaced.
@@ -326,14 +665,8 @@ static void setValueState(AsyncValue *value, State state) {
   assert(state.isAvailableOrError() && "must be terminal state");
   assert(State(value->state).isUnavailable() && "value must be unavailable");
 
-  // Make sure that `dropRef` does not destroy the mutex owned by the lock.
-  {
-    std::unique_lock<std::mutex> lock(value->mu);
-    value->state = state;
-    value->cv.notify_all();
-    for (auto &awaiter : value->awaiters)
-      awaiter();
-  }
+  value->state.store(state, std::memory_order_release);
+  value->awaiters.close();
 
   // Async values created with a ref count `2` to keep value alive until the
   // async task completes. Drop this reference explicitly when value emplaced.
@@ -369,23 +702,15 @@ extern "C" bool mlirAsyncRuntimeIsGroupError(AsyncGroup *group) {
 }
 
 extern "C" void mlirAsyncRuntimeAwaitToken(AsyncToken *token) {
-  std::unique_lock<std::mutex> lock(token->mu);
-  if (!State(token->state).isAvailableOrError())
-    token->cv.wait(
-        lock, [token] { return State(token->state).isAvailableOrError(); });
+  awaitBlocking(token->awaiters);
 }
 
 extern "C" void mlirAsyncRuntimeAwaitValue(AsyncValue *value) {
-  std::unique_lock<std::mutex> lock(value->mu);
-  if (!State(value->state).isAvailableOrError())
-    value->cv.wait(
-        lock, [value] { return State(value->state).isAvailableOrError(); });
+  awaitBlocking(value->awaiters);
 }
 
 extern "C" void mlirAsyncRuntimeAwaitAllInGroup(AsyncGroup *group) {
-  std::unique_lock<std::mutex> lock(group->mu);
-  if (group->pendingTokens != 0)
-    group->cv.wait(lock, [group] { return group->pendingTokens == 0; });
+  awaitBlocking(group->awaiters);
 }
 
 // Returns a pointer to the storage owned by the async value.
@@ -396,50 +721,29 @@ extern "C" ValueStorage mlirAsyncRuntimeGetValueStorage(AsyncValue *value) {
 
 extern "C" void mlirAsyncRuntimeExecute(CoroHandle handle, CoroResume resume) {
   auto *runtime = getDefaultAsyncRuntime();
-  runtime->getThreadPool().async([handle, resume]() { (*resume)(handle); });
+  runtime->getScheduler().schedule({resume, handle});
 }
 
 extern "C" void mlirAsyncRuntimeAwaitTokenAndExecute(AsyncToken *token,
                                                      CoroHandle handle,
                                                      CoroResume resume) {
-  auto execute = [handle, resume]() { (*resume)(handle); };
-  std::unique_lock<std::mutex> lock(token->mu);
-  if (State(token->state).isAvailableOrError()) {
-    lock.unlock();
-    execute();
-  } else {
-    token->awaiters.emplace_back([execute]() { execute(); });
-  }
+  awaitAndExecute(token->awaiters, handle, resume);
 }
 
 extern "C" void mlirAsyncRuntimeAwaitValueAndExecute(AsyncValue *value,
                                                      CoroHandle handle,
                                                      CoroResume resume) {
-  auto execute = [handle, resume]() { (*resume)(handle); };
-  std::unique_lock<std::mutex> lock(value->mu);
-  if (State(value->state).isAvailableOrError()) {
-    lock.unlock();
-    execute();
-  } else {
-    value->awaiters.emplace_back([execute]() { execute(); });
-  }
+  awaitAndExecute(value->awaiters, handle, resume);
 }
 
 extern "C" void mlirAsyncRuntimeAwaitAllInGroupAndExecute(AsyncGroup *group,
                                                           CoroHandle handle,
                                                           CoroResume resume) {
-  auto execute = [handle, resume]() { (*resume)(handle); };
-  std::unique_lock<std::mutex> lock(group->mu);
-  if (group->pendingTokens == 0) {
-    lock.unlock();
-    execute();
-  } else {
-    group->awaiters.emplace_back([execute]() { execute(); });
-  }
+  awaitAndExecute(group->awaiters, handle, resume);
 }
 
 extern "C" int64_t mlirAsyncRuntimGetNumWorkerThreads() {
-  return getDefaultAsyncRuntime()->getThreadPool().getThreadCount();
+  return getDefaultAsyncRuntime()->getScheduler().getThreadCount();
 }
 
 //===----------------------------------------------------------------------===//
@@ -16,6 +16,8 @@
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Target/LLVMIR/Export.h"
 
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
@@ -29,8 +31,12 @@
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 
 #define DEBUG_TYPE "execution-engine"
 
@@ -53,6 +59,7 @@ using llvm::orc::JITTargetMachineBuilder;
 using llvm::orc::MangleAndInterner;
 using llvm::orc::RTDyldObjectLinkingLayer;
 using llvm::orc::SymbolMap;
+using llvm::orc::ThreadSafeContext;
 using llvm::orc::ThreadSafeModule;
 using llvm::orc::TMOwningSimpleCompiler;
 
@@ -62,14 +69,63 @@ static Error makeStringError(const Twine &message) {
                                        llvm::inconvertibleErrorCode());
 }
 
+std::string SimpleObjectCache::getObjectPath(const Module *m) const {
+  SmallString<128> path(cacheDir);
+  llvm::sys::path::append(path, m->getModuleIdentifier() + ".o");
+  return std::string(path.str());
+}
+
 void SimpleObjectCache::notifyObjectCompiled(const Module *m,
                                              MemoryBufferRef objBuffer) {
-  cachedObjects[m->getModuleIdentifier()] = MemoryBuffer::getMemBufferCopy(
-      objBuffer.getBuffer(), objBuffer.getBufferIdentifier());
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    cachedObjects[m->getModuleIdentifier()] = MemoryBuffer::getMemBufferCopy(
+        objBuffer.getBuffer(), objBuffer.getBufferIdentifier());
+  }
+  if (!isPersistent())
+    return;
+
+  // Write the object to a temporary file renamed into place once complete, so
+  // that concurrent readers never see a partially written object. Failing to
+  // persist the object is not an error, it will simply be compiled again.
+  std::string path = getObjectPath(m);
+  SmallString<128> tempPath;
+  int fd;
+  if (std::error_code ec =
+          llvm::sys::fs::createUniqueFile(path + ".tmp%%%%%%", fd, tempPath)) {
+    LLVM_DEBUG(dbgs() << "Could not persist object for "
+                      << m->getModuleIdentifier() << ": " << ec.message()
+                      << "\n");
+    return;
+  }
+  bool written;
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << objBuffer.getBuffer();
+    os.close();
+    written = !os.has_error();
+    os.clear_error();
+  }
+  if (!written || llvm::sys::fs::rename(tempPath, path)) {
+    LLVM_DEBUG(dbgs() << "Could not persist object for "
+                      << m->getModuleIdentifier() << " to " << path << "\n");
+    llvm::sys::fs::remove(tempPath);
+  }
 }
 
 std::unique_ptr<MemoryBuffer> SimpleObjectCache::getObject(const Module *m) {
+  std::lock_guard<std::mutex> lock(mutex);
   auto i = cachedObjects.find(m->getModuleIdentifier());
+  if (i == cachedObjects.end() && isPersistent()) {
+    auto file = MemoryBuffer::getFile(getObjectPath(m), /*IsText=*/false,
+                                      /*RequiresNullTerminator=*/false);
+    if (file) {
+      LLVM_DEBUG(dbgs() << "Object for " << m->getModuleIdentifier()
+                        << " loaded from " << cacheDir << ".\n");
+      i = cachedObjects.try_emplace(m->getModuleIdentifier(), std::move(*file))
+              .first;
+    }
+  }
   if (i == cachedObjects.end()) {
     LLVM_DEBUG(dbgs() << "No object for " << m->getModuleIdentifier()
                       << " in cache. Compiling.\n");
@@ -209,10 +265,46 @@ static void packFunctionArguments(Module *module) {
   }
 }
 
+/// Returns a key identifying the object code generated for `module` with the
+/// target machine described by `jtmb`, used to name the module in persistent
+/// object caches.
+static std::string getObjectCacheKey(Module &module,
+                                     const JITTargetMachineBuilder &jtmb) {
+  SmallString<0> bitcode;
+  llvm::raw_svector_ostream os(bitcode);
+  llvm::WriteBitcodeToFile(module, os);
+
+  llvm::SHA1 hasher;
+  hasher.update(bitcode.str());
+  hasher.update(jtmb.getTargetTriple().str());
+  hasher.update(jtmb.getCPU());
+  hasher.update(jtmb.getFeatures().getString());
+  hasher.update(std::to_string(static_cast<int>(jtmb.getCodeGenOptLevel())));
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+/// Splits `module` into at most `numPartitions` modules that can be compiled
+/// independently. Partitions without definitions are dropped.
+static SmallVector<std::unique_ptr<Module>>
+splitModule(Module &module, unsigned numPartitions) {
+  SmallVector<std::unique_ptr<Module>> partitions;
+  llvm::SplitModule(module, numPartitions,
+                    [&](std::unique_ptr<Module> partition) {
+                      if (llvm::any_of(partition->global_values(),
+                                       [](llvm::GlobalValue &value) {
+                                         return !value.isDeclaration();
+                                       }))
+                        partitions.push_back(std::move(partition));
+                    });
+  return partitions;
+}
+
 ExecutionEngine::ExecutionEngine(bool enableObjectCache,
                                  bool enableGDBNotificationListener,
-                                 bool enablePerfNotificationListener)
-    : cache(enableObjectCache ? new SimpleObjectCache() : nullptr),
+                                 bool enablePerfNotificationListener,
+                                 StringRef objectCacheDir)
+    : cache(enableObjectCache ? new SimpleObjectCache(objectCacheDir)
+                              : nullptr),
       gdbListener(enableGDBNotificationListener
                       ? llvm::JITEventListener::createGDBRegistrationListener()
                       : nullptr),
@@ -230,7 +322,7 @@ Expected<std::unique_ptr<ExecutionEngine>>
 ExecutionEngine::create(ModuleOp m, const ExecutionEngineOptions &options) {
   auto engine = std::make_unique<ExecutionEngine>(
       options.enableObjectCache, options.enableGDBNotificationListener,
-      options.enablePerfNotificationListener);
+      options.enablePerfNotificationListener, options.objectCacheDir);
 
   std::unique_ptr<llvm::LLVMContext> ctx(new llvm::LLVMContext);
   auto llvmModule = options.llvmModuleBuilder
@@ -295,10 +387,18 @@ ExecutionEngine::create(ModuleOp m, const ExecutionEngineOptions &options) {
 
   // Callback to inspect the cache and recompile on demand. This follows Lang's
   // LLJITWithObjectCache example.
+  // The target machine builder is kept to key the persistent object cache.
+  Optional<JITTargetMachineBuilder> targetMachineBuilder;
   auto compileFunctionCreator = [&](JITTargetMachineBuilder jtmb)
       -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
     if (options.jitCodeGenOptLevel)
       jtmb.setCodeGenOptLevel(options.jitCodeGenOptLevel.getValue());
+    targetMachineBuilder = jtmb;
+
+    // Compile threads each create their own target machine.
+    if (options.numCompileThreads > 0)
+      return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+          std::move(jtmb), engine->cache.get());
     auto tm = jtmb.createTargetMachine();
     if (!tm)
       return tm.takeError();
@@ -311,14 +411,48 @@ ExecutionEngine::create(ModuleOp m, const ExecutionEngineOptions &options) {
       cantFail(llvm::orc::LLJITBuilder()
                    .setCompileFunctionCreator(compileFunctionCreator)
                    .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
+                   .setNumCompileThreads(options.numCompileThreads)
                    .create());
 
-  // Add a ThreadSafemodule to the engine and return.
-  ThreadSafeModule tsm(std::move(llvmModule), std::move(ctx));
   if (options.transformer)
-    cantFail(tsm.withModuleDo(
-        [&](llvm::Module &module) { return options.transformer(&module); }));
-  cantFail(jit->addIRModule(std::move(tsm)));
+    cantFail(options.transformer(llvmModule.get()));
+
+  // Split the module into partitions compiled concurrently if requested. The
+  // names of the functions defined by the module are kept to compile all the
+  // partitions eagerly, as a single module would be.
+  SmallVector<std::unique_ptr<Module>> modules;
+  SmallVector<std::string> definedFunctions;
+  if (options.numCompileThreads > 0) {
+    for (llvm::Function &func : *llvmModule)
+      if (!func.isDeclaration() && !func.hasLocalLinkage())
+        definedFunctions.push_back(func.getName().str());
+    unsigned numPartitions = std::min<unsigned>(
+        definedFunctions.size(), 4 * options.numCompileThreads);
+    if (numPartitions > 1)
+      modules = splitModule(*llvmModule, numPartitions);
+  }
+  if (modules.empty())
+    modules.push_back(std::move(llvmModule));
+  llvmModule.reset();
+
+  // Name the modules after the code they produce when objects are persisted,
+  // otherwise make sure that the partitions have distinct names in the cache.
+  for (auto &indexedModule : llvm::enumerate(modules)) {
+    Module &module = *indexedModule.value();
+    if (engine->cache && engine->cache->isPersistent() && targetMachineBuilder)
+      module.setModuleIdentifier(
+          getObjectCacheKey(module, *targetMachineBuilder));
+    else if (modules.size() > 1)
+      module.setModuleIdentifier(module.getModuleIdentifier() + "." +
+                                 std::to_string(indexedModule.index()));
+  }
+  if (engine->cache && engine->cache->isPersistent())
+    (void)llvm::sys::fs::create_directories(options.objectCacheDir);
+
+  // Add the modules to the engine, sharing the context of the original module.
+  ThreadSafeContext tsCtx(std::move(ctx));
+  for (std::unique_ptr<Module> &module : modules)
+    cantFail(jit->addIRModule(ThreadSafeModule(std::move(module), tsCtx)));
   engine->jit = std::move(jit);
 
   // Resolve symbols that are statically linked in the current process.
@@ -327,6 +461,18 @@ ExecutionEngine::create(ModuleOp m, const ExecutionEngineOptions &options) {
       cantFail(DynamicLibrarySearchGenerator::GetForCurrentProcess(
           dataLayout.getGlobalPrefix())));
 
+  // Compile all the partitions at once, which dispatches them to the compile
+  // threads.
+  if (modules.size() > 1) {
+    llvm::orc::SymbolLookupSet symbols;
+    for (StringRef name : definedFunctions)
+      symbols.add(engine->jit->mangleAndIntern(name));
+    auto compiled = engine->jit->getExecutionSession().lookup(
+        llvm::orc::makeJITDylibSearchOrder(&mainJD), symbols);
+    if (!compiled)
+      return compiled.takeError();
+  }
+
   return std::move(engine);
 }
 
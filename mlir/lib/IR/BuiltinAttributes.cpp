@@ -1240,6 +1240,25 @@ bool DenseIntElementsAttr::classof(Attribute attr) {
          attr.getType().cast<ShapedType>().getElementType().isIntOrIndex();
 }
 
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr
+//===----------------------------------------------------------------------===//
+
+DenseResourceElementsAttr DenseResourceElementsAttr::get(ShapedType type,
+                                                         StringRef blobName,
+                                                         AsmResourceBlob blob) {
+  // Insert a new resource using the provided blob in the manager of the
+  // builtin dialect, and reference it with the attribute.
+  auto &manager = BuiltinBlobManagerInterface::get(type.getContext());
+  return get(type, manager.insert(blobName, std::move(blob)));
+}
+
+Optional<ArrayRef<char>> DenseResourceElementsAttr::tryGetRawData() const {
+  if (const AsmResourceBlob *blob = getRawHandle().getBlob())
+    return blob->getData();
+  return llvm::None;
+}
+
 //===----------------------------------------------------------------------===//
 // OpaqueElementsAttr
 //===----------------------------------------------------------------------===//
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/IR/BuiltinDialect.h"
+#include "BuiltinDialectBytecode.h"
 #include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
@@ -69,7 +70,8 @@ void BuiltinDialect::initialize() {
 #define GET_OP_LIST
 #include "mlir/IR/BuiltinOps.cpp.inc"
       >();
-  addInterfaces<BuiltinOpAsmDialectInterface>();
+  addInterfaces<BuiltinOpAsmDialectInterface, BuiltinBlobManagerInterface>();
+  addInterface(builtin_dialect_detail::createBytecodeInterface(this));
 }
 
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,122 @@
+//===- DialectResourceBlobManager.cpp - Dialect Blob Management -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/DialectResourceBlobManager.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemAlloc.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+using namespace mlir;
+
+//===----------------------------------------------------------------------===//
+// AsmResourceBlob
+//===----------------------------------------------------------------------===//
+
+AsmResourceBlob HeapAsmResourceBlob::allocate(size_t size, size_t align,
+                                              bool dataIsMutable) {
+  char *data =
+      static_cast<char *>(llvm::allocate_buffer(std::max<size_t>(size, 1),
+                                                std::max<size_t>(align, 1)));
+  auto deleter = [](void *data, size_t size, size_t align) {
+    return llvm::deallocate_buffer(data, std::max<size_t>(size, 1),
+                                   std::max<size_t>(align, 1));
+  };
+  return AsmResourceBlob(ArrayRef<char>(data, size), align, deleter,
+                         dataIsMutable);
+}
+
+AsmResourceBlob HeapAsmResourceBlob::allocateAndCopy(ArrayRef<char> data,
+                                                     size_t align,
+                                                     bool dataIsMutable) {
+  AsmResourceBlob blob = allocate(data.size(), align, dataIsMutable);
+  std::memcpy(const_cast<char *>(blob.getData().data()), data.data(),
+              data.size());
+  return blob;
+}
+
+FailureOr<AsmResourceBlob>
+mlir::loadAsmResourceBlobFromFile(StringRef path, size_t align,
+                                  std::string *errorMessage) {
+  assert(llvm::isPowerOf2_64(align) && "expected a power of two alignment");
+  auto fileOrErr =
+      llvm::MemoryBuffer::getFile(path, /*IsText=*/false,
+                                  /*RequiresNullTerminator=*/false);
+  if (std::error_code error = fileOrErr.getError()) {
+    if (errorMessage)
+      *errorMessage = "cannot open resource file '" + path.str() +
+                      "': " + error.message();
+    return failure();
+  }
+  std::unique_ptr<llvm::MemoryBuffer> file = std::move(*fileOrErr);
+  ArrayRef<char> data(file->getBufferStart(), file->getBufferSize());
+
+  // Memory mapped files are page aligned, but small files are read into a
+  // buffer that may not satisfy the requested alignment. Copy the data in that
+  // case.
+  if (reinterpret_cast<uintptr_t>(data.data()) & (align - 1))
+    return HeapAsmResourceBlob::allocateAndCopy(data, align,
+                                                /*dataIsMutable=*/false);
+
+  // Otherwise, keep the file alive for as long as the blob references it.
+  return UnmanagedAsmResourceBlob::allocate(
+      data, align, [file = std::move(file)](void *, size_t, size_t) {});
+}
+
+//===----------------------------------------------------------------------===//
+// DialectResourceBlobManager
+//===----------------------------------------------------------------------===//
+
+auto DialectResourceBlobManager::lookup(StringRef name) -> BlobEntry * {
+  llvm::sys::SmartScopedReader<true> reader(blobMapLock);
+
+  auto it = blobMap.find(name);
+  return it != blobMap.end() ? &it->second : nullptr;
+}
+
+void DialectResourceBlobManager::update(StringRef name,
+                                        AsmResourceBlob &&newBlob) {
+  BlobEntry *entry = lookup(name);
+  assert(entry && "`update` expects an existing entry for the provided name");
+  entry->setBlob(std::move(newBlob));
+}
+
+auto DialectResourceBlobManager::insert(StringRef name,
+                                        Optional<AsmResourceBlob> blob)
+    -> BlobEntry & {
+  llvm::sys::SmartScopedWriter<true> writer(blobMapLock);
+
+  // Functor used to attempt insertion with a given name.
+  auto tryInsertion = [&](StringRef name) -> BlobEntry * {
+    auto it = blobMap.try_emplace(name, BlobEntry());
+    if (it.second) {
+      it.first->second.initialize(it.first->getKey(), std::move(blob));
+      return &it.first->second;
+    }
+    return nullptr;
+  };
+
+  // Try inserting with the name provided by the user.
+  if (BlobEntry *entry = tryInsertion(name))
+    return *entry;
+
+  // If an entry already exists for the user provided name, tweak the name and
+  // re-attempt insertion until we find one that is unique.
+  llvm::SmallString<32> nameStorage(name);
+  nameStorage.push_back('_');
+  size_t nameCounter = 1;
+  do {
+    Twine(nameCounter++).toVector(nameStorage);
+
+    // Try inserting with the new name.
+    if (BlobEntry *entry = tryInsertion(nameStorage))
+      return *entry;
+    nameStorage.resize(name.size() + 1);
+  } while (true);
+}
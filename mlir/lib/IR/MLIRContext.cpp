@@ -32,6 +32,7 @@
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/RWMutex.h"
 #include "llvm/Support/ThreadPool.h"
@@ -67,6 +68,12 @@ struct MLIRContextOptions {
       "mlir-print-stacktrace-on-diagnostic",
       llvm::cl::desc("When a diagnostic is emitted, also print the stack trace "
                      "as an attached note")};
+
+  llvm::cl::opt<bool> printUniquerStatistics{
+      "mlir-print-uniquer-statistics",
+      llvm::cl::desc("Collect statistics about the uniquing of attributes, "
+                     "types, and affine structures, and print them when the "
+                     "context is destroyed")};
 };
 } // namespace
 
@@ -263,6 +270,7 @@ MLIRContext::MLIRContext(const DialectRegistry &registry, Threading setting)
   if (clOptions.isConstructed()) {
     printOpOnDiagnostic(clOptions->printOpOnDiagnostic);
     printStackTraceOnDiagnostic(clOptions->printStackTraceOnDiagnostic);
+    enableUniquerStatistics(clOptions->printUniquerStatistics);
   }
 
   // Pre-populate the registry.
@@ -323,7 +331,10 @@ MLIRContext::MLIRContext(const DialectRegistry &registry, Threading setting)
   impl->affineUniquer.registerParametricStorageType<IntegerSetStorage>();
 }
 
-MLIRContext::~MLIRContext() = default;
+MLIRContext::~MLIRContext() {
+  if (clOptions.isConstructed() && clOptions->printUniquerStatistics)
+    printUniquerStatistics(llvm::errs());
+}
 
 /// Copy the specified array of elements into memory managed by the provided
 /// bump pointer allocator.  This assumes the elements are all PODs.
@@ -479,6 +490,32 @@ bool MLIRContext::isMultithreadingEnabled() {
   return impl->threadingIsEnabled && llvm::llvm_is_multithreaded();
 }
 
+/// Enable or disable the collection of uniquing statistics.
+void MLIRContext::enableUniquerStatistics(bool enable) {
+  impl->affineUniquer.enableStatistics(enable);
+  impl->attributeUniquer.enableStatistics(enable);
+  impl->typeUniquer.enableStatistics(enable);
+}
+
+/// Print the uniquing statistics collected for this context.
+void MLIRContext::printUniquerStatistics(raw_ostream &os) {
+  auto printStatistics = [&](StringRef name, const StorageUniquer &uniquer) {
+    StorageUniquer::Statistics stats = uniquer.getStatistics();
+    os << llvm::formatv("  {0,-10} {1,12} {2,12} {3,12} {4,12}\n", name,
+                        stats.numLookups, stats.numHits, stats.numInstances,
+                        stats.numContendedInsertions);
+  };
+  os << "===" << std::string(73, '-') << "===\n"
+     << "                         ... Uniquer statistics ...\n"
+     << "===" << std::string(73, '-') << "===\n";
+  os << llvm::formatv("  {0,-10} {1,12} {2,12} {3,12} {4,12}\n", "uniquer",
+                      "lookups", "hits", "instances", "contended");
+  printStatistics("attribute", impl->attributeUniquer);
+  printStatistics("type", impl->typeUniquer);
+  printStatistics("affine", impl->affineUniquer);
+  os.flush();
+}
+
 /// Set the flag specifying if multi-threading is disabled by the context.
 void MLIRContext::disableMultithreading(bool disable) {
   // This API can be overridden by the global debugging flag
@@ -43,8 +43,10 @@ namespace {
 /// This class encapsulates all the state used to verify an operation region.
 class OperationVerifier {
 public:
-  /// Verify the given operation.
-  LogicalResult verifyOpAndDominance(Operation &op);
+  /// Verify the given operation. If `domInfo` is provided, it is used to check
+  /// the dominance of the regions of the operation.
+  LogicalResult verifyOpAndDominance(Operation &op,
+                                     DominanceInfo *domInfo = nullptr);
 
 private:
   LogicalResult
@@ -64,7 +66,8 @@ private:
 };
 } // namespace
 
-LogicalResult OperationVerifier::verifyOpAndDominance(Operation &op) {
+LogicalResult OperationVerifier::verifyOpAndDominance(Operation &op,
+                                                       DominanceInfo *domInfo) {
   SmallVector<Operation *> opsWithIsolatedRegions;
 
   // Verify the operation first, collecting any IsolatedFromAbove operations.
@@ -76,8 +79,9 @@ LogicalResult OperationVerifier::verifyOpAndDominance(Operation &op) {
   // CFG's can cause dominator analysis construction to crash and we want the
   // verifier to be resilient to malformed code.
   if (op.getNumRegions() != 0) {
-    DominanceInfo domInfo;
-    if (failed(verifyDominanceOfContainedRegions(op, domInfo)))
+    DominanceInfo localDomInfo;
+    if (failed(verifyDominanceOfContainedRegions(
+            op, domInfo ? *domInfo : localDomInfo)))
       return failure();
   }
 
@@ -358,3 +362,7 @@ OperationVerifier::verifyDominanceOfContainedRegions(Operation &op,
 LogicalResult mlir::verify(Operation *op) {
   return OperationVerifier().verifyOpAndDominance(*op);
 }
+
+LogicalResult mlir::verify(Operation *op, DominanceInfo &domInfo) {
+  return OperationVerifier().verifyOpAndDominance(*op, &domInfo);
+}
@@ -12,6 +12,7 @@
 
 #include "Parser.h"
 #include "mlir/IR/AffineMap.h"
+#include "mlir/IR/BuiltinDialect.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/IntegerSet.h"
@@ -90,6 +91,10 @@ Attribute Parser::parseAttribute(Type type) {
   case Token::kw_dense:
     return parseDenseElementsAttr(type);
 
+  // Parse a dense resource elements attribute.
+  case Token::kw_dense_resource:
+    return parseDenseResourceElementsAttr(type);
+
   // Parse a dictionary attribute.
   case Token::l_brace: {
     NamedAttrList elements;
@@ -222,6 +227,7 @@ OptionalParseResult Parser::parseOptionalAttribute(Attribute &attribute,
   case Token::kw_affine_map:
   case Token::kw_affine_set:
   case Token::kw_dense:
+  case Token::kw_dense_resource:
   case Token::kw_false:
   case Token::kw_loc:
   case Token::kw_opaque:
@@ -831,6 +837,39 @@ Attribute Parser::parseDenseElementsAttr(Type attrType) {
   return literalParser.getAttr(loc, type);
 }
 
+/// Parse a dense resource elements attribute.
+///
+///   dense-resource-elements-attribute ::=
+///     `dense_resource` `<` resource-key `>` `:` shaped-type
+///
+Attribute Parser::parseDenseResourceElementsAttr(Type attrType) {
+  consumeToken(Token::kw_dense_resource);
+  if (parseToken(Token::less, "expected '<' after 'dense_resource'"))
+    return nullptr;
+
+  // The key of the resource is either a bare identifier or a string.
+  std::string key;
+  if (getToken().is(Token::bare_identifier) || getToken().isKeyword()) {
+    key = getTokenSpelling().str();
+  } else if (getToken().is(Token::string)) {
+    key = getToken().getStringValue();
+  } else {
+    return (emitError("expected resource key"), nullptr);
+  }
+  consumeToken();
+
+  if (parseToken(Token::greater, "expected '>'"))
+    return nullptr;
+  auto type = parseElementsLiteralType(attrType);
+  if (!type)
+    return nullptr;
+
+  // Reference the blob registered for the key, or create an entry without a
+  // blob that can be provided later on.
+  auto &manager = BuiltinBlobManagerInterface::get(getContext());
+  return DenseResourceElementsAttr::get(type, manager.lookupOrInsert(key));
+}
+
 /// Parse an opaque elements attribute.
 Attribute Parser::parseOpaqueElementsAttr(Type attrType) {
   SMLoc loc = getToken().getLoc();
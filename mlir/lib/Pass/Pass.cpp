@@ -14,6 +14,7 @@
 #include "PassDetail.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Dialect.h"
+#include "mlir/IR/Dominance.h"
 #include "mlir/IR/Threading.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Support/FileUtilities.h"
@@ -343,6 +344,43 @@ LogicalResult OpPassManager::initialize(MLIRContext *context,
 // OpToOpPassAdaptor
 //===----------------------------------------------------------------------===//
 
+/// Verify `op` after a pass ran on it. If the pass reported the operations it
+/// changed in `changedOps`, only the regions holding them are verified. The
+/// dominance information cached in the analysis manager is reused if the pass
+/// preserved it.
+static LogicalResult verifyAfterPass(Operation *op, AnalysisManager am,
+                                     ArrayRef<Operation *> changedOps) {
+#ifdef EXPENSIVE_CHECKS
+  // Always verify everything from scratch in EXPENSIVE_CHECKS mode.
+  return verify(op);
+#else
+  DominanceInfo localDomInfo;
+  auto cachedDomInfo = am.getCachedAnalysis<DominanceInfo>();
+  DominanceInfo &domInfo = cachedDomInfo ? cachedDomInfo->get() : localDomInfo;
+  if (changedOps.empty())
+    return verify(op, domInfo);
+
+  // Verify the parents of the changed operations, which also checks that the
+  // operands of the changed operations dominate them. Parents nested under
+  // another parent are verified as part of it.
+  llvm::SetVector<Operation *> parents;
+  for (Operation *changedOp : changedOps)
+    parents.insert(changedOp == op ? op : changedOp->getParentOp());
+  auto isNestedUnderOtherParent = [&](Operation *parent) {
+    for (Operation *ancestor = parent; ancestor != op;) {
+      ancestor = ancestor->getParentOp();
+      if (parents.count(ancestor))
+        return true;
+    }
+    return false;
+  };
+  for (Operation *parent : parents)
+    if (!isNestedUnderOtherParent(parent) && failed(verify(parent, domInfo)))
+      return failure();
+  return success();
+#endif
+}
+
 LogicalResult OpToOpPassAdaptor::run(Pass *pass, Operation *op,
                                      AnalysisManager am, bool verifyPasses,
                                      unsigned parentInitGeneration) {
@@ -414,7 +452,8 @@ LogicalResult OpToOpPassAdaptor::run(Pass *pass, Operation *op,
                      !pass->passState->preservedAnalyses.isAll();
 #endif
     if (runVerifierNow)
-      passFailed = failed(verify(op));
+      passFailed =
+          failed(verifyAfterPass(op, am, pass->passState->changedOps));
   }
 
   // Instrument after the pass has run.
@@ -563,7 +602,9 @@ static bool hasSizeMismatch(ArrayRef<OpPassManager> lhs,
                       [&](size_t i) { return lhs[i].size() != rhs[i].size(); });
 }
 
-/// Run this pass adaptor synchronously.
+/// Run this pass adaptor asynchronously. This may be invoked from a thread that
+/// is itself running a nested pipeline of an enclosing adaptor, in which case
+/// the operations are distributed over the threads of the pool that are idle.
 void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
   AnalysisManager am = getAnalysisManager();
   MLIRContext *context = &getContext();
@@ -592,7 +633,9 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
                                                         this};
   auto *instrumentor = am.getPassInstrumentor();
 
-  // An atomic failure variable for the async executors.
+  // An atomic failure variable for the async executors. Each thread processes
+  // at most one operation of this adaptor at a time, so there is always an
+  // inactive executor available.
   std::vector<std::atomic<bool>> activePMs(asyncExecutors.size());
   std::fill(activePMs.begin(), activePMs.end(), false);
   auto processFn = [&](auto &opPMPair) {
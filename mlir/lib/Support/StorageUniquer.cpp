@@ -9,9 +9,12 @@
 #include "mlir/Support/StorageUniquer.h"
 
 #include "mlir/Support/LLVM.h"
-#include "mlir/Support/ThreadLocalCache.h"
 #include "mlir/Support/TypeID.h"
-#include "llvm/Support/RWMutex.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/Threading.h"
+#include <atomic>
+#include <mutex>
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -26,6 +29,7 @@ class ParametricStorageUniquer {
 public:
   using BaseStorage = StorageUniquer::BaseStorage;
   using StorageAllocator = StorageUniquer::StorageAllocator;
+  using Statistics = StorageUniquer::Statistics;
 
   /// A lookup key for derived instances of storage objects.
   struct LookupKey {
@@ -37,69 +41,127 @@ public:
   };
 
 private:
-  /// A utility wrapper object representing a hashed storage object. This class
-  /// contains a storage object and an existing computed hash value.
-  struct HashedStorage {
-    HashedStorage(unsigned hashValue = 0, BaseStorage *storage = nullptr)
-        : hashValue(hashValue), storage(storage) {}
-    unsigned hashValue;
-    BaseStorage *storage;
-  };
-
-  /// Storage info for derived TypeStorage objects.
-  struct StorageKeyInfo {
-    static inline HashedStorage getEmptyKey() {
-      return HashedStorage(0, DenseMapInfo<BaseStorage *>::getEmptyKey());
-    }
-    static inline HashedStorage getTombstoneKey() {
-      return HashedStorage(0, DenseMapInfo<BaseStorage *>::getTombstoneKey());
+  /// An open addressed hash table of storage instances, which supports lookups
+  /// that are concurrent with a single writer. Storage instances are never
+  /// erased, so a bucket only ever transitions from empty to filled: the
+  /// writer sets the hash value of the bucket and then publishes the storage
+  /// instance with release semantics, which readers load with acquire
+  /// semantics. Growing the table creates a new table that is published to
+  /// readers as a whole, the old table is kept alive as readers may still be
+  /// probing it.
+  struct InstanceTable {
+    struct Bucket {
+      unsigned hashValue = 0;
+      std::atomic<BaseStorage *> storage{nullptr};
+    };
+
+    InstanceTable(size_t capacity)
+        : buckets(new Bucket[capacity]), capacity(capacity) {
+      assert(llvm::isPowerOf2_64(capacity) &&
+             "the capacity is required to be a power of 2");
     }
 
-    static inline unsigned getHashValue(const HashedStorage &key) {
-      return key.hashValue;
-    }
-    static inline unsigned getHashValue(const LookupKey &key) {
-      return key.hashValue;
+    /// Return the storage instance matching the given key, or nullptr if
+    /// there isn't one. This may be called concurrently with `insert`.
+    BaseStorage *lookup(unsigned hashValue, const LookupKey &key) const {
+      for (size_t i = hashValue & (capacity - 1), probe = 1;;
+           i = (i + probe++) & (capacity - 1)) {
+        Bucket &bucket = buckets[i];
+        BaseStorage *storage = bucket.storage.load(std::memory_order_acquire);
+        if (!storage)
+          return nullptr;
+        if (bucket.hashValue == key.hashValue && key.isEqual(storage))
+          return storage;
+      }
     }
 
-    static inline bool isEqual(const HashedStorage &lhs,
-                               const HashedStorage &rhs) {
-      return lhs.storage == rhs.storage;
-    }
-    static inline bool isEqual(const LookupKey &lhs, const HashedStorage &rhs) {
-      if (isEqual(rhs, getEmptyKey()) || isEqual(rhs, getTombstoneKey()))
-        return false;
-      // Invoke the equality function on the lookup key.
-      return lhs.isEqual(rhs.storage);
+    /// Insert the given storage instance, which must not already be in the
+    /// table. This must only be called while holding the lock of the shard.
+    void insert(unsigned hashValue, unsigned fullHashValue,
+                BaseStorage *storage) {
+      for (size_t i = hashValue & (capacity - 1), probe = 1;;
+           i = (i + probe++) & (capacity - 1)) {
+        Bucket &bucket = buckets[i];
+        if (bucket.storage.load(std::memory_order_relaxed))
+          continue;
+        bucket.hashValue = fullHashValue;
+        bucket.storage.store(storage, std::memory_order_release);
+        return;
+      }
     }
+
+    /// The buckets of the table, the triangular probing sequence used above
+    /// visits all of them as the capacity is a power of 2.
+    std::unique_ptr<Bucket[]> buckets;
+    size_t capacity;
   };
-  using StorageTypeSet = DenseSet<HashedStorage, StorageKeyInfo>;
 
   /// This class represents a single shard of the uniquer. The uniquer uses a
   /// set of shards to allow for multiple threads to create instances with less
   /// lock contention.
   struct Shard {
-    /// The set containing the allocated storage instances.
-    StorageTypeSet instances;
+    Shard() : table(new InstanceTable(/*capacity=*/16)) {}
+    ~Shard() { delete table.load(std::memory_order_relaxed); }
+
+    /// The table containing the allocated storage instances.
+    std::atomic<InstanceTable *> table;
+
+    /// The number of storage instances within the table.
+    size_t numInstances = 0;
+
+    /// Tables that were replaced when growing `table`, which may still be in
+    /// use by concurrent readers.
+    std::vector<std::unique_ptr<InstanceTable>> retiredTables;
 
     /// Allocator to use when constructing derived instances.
     StorageAllocator allocator;
 
+    /// Uniquing statistics for this shard, only updated when statistics are
+    /// enabled.
+    std::atomic<uint64_t> numLookups{0}, numHits{0}, numContendedInsertions{0};
+
 #if LLVM_ENABLE_THREADS != 0
-    /// A mutex to keep uniquing thread-safe.
-    llvm::sys::SmartRWMutex<true> mutex;
+    /// A mutex to keep insertions and mutations thread-safe.
+    llvm::sys::SmartMutex<true> mutex;
 #endif
   };
 
+  /// Return the hash value used to index the instance table of a shard. The
+  /// low bits of the hash value select the shard, so they are dropped here to
+  /// avoid clustering the instances of the shard in the table.
+  unsigned getTableHash(unsigned hashValue) const {
+    return hashValue >> shardBits;
+  }
+
   /// Get or create an instance of a param derived type in an thread-unsafe
   /// fashion.
   BaseStorage *
   getOrCreateUnsafe(Shard &shard, LookupKey &key,
                     function_ref<BaseStorage *(StorageAllocator &)> ctorFn) {
-    auto existing = shard.instances.insert_as({key.hashValue}, key);
-    BaseStorage *&storage = existing.first->storage;
-    if (existing.second)
-      storage = ctorFn(shard.allocator);
+    unsigned tableHash = getTableHash(key.hashValue);
+    InstanceTable *table = shard.table.load(std::memory_order_relaxed);
+    if (BaseStorage *storage = table->lookup(tableHash, key))
+      return storage;
+
+    // Grow the table if it would become more than 3/4 full, which keeps the
+    // probe sequences short and guarantees that they terminate.
+    if ((shard.numInstances + 1) * 4 > table->capacity * 3) {
+      auto *newTable = new InstanceTable(table->capacity * 2);
+      for (size_t i = 0, e = table->capacity; i != e; ++i) {
+        InstanceTable::Bucket &bucket = table->buckets[i];
+        if (BaseStorage *storage =
+                bucket.storage.load(std::memory_order_relaxed))
+          newTable->insert(getTableHash(bucket.hashValue), bucket.hashValue,
+                           storage);
+      }
+      shard.retiredTables.emplace_back(table);
+      shard.table.store(newTable, std::memory_order_release);
+      table = newTable;
+    }
+
+    BaseStorage *storage = ctorFn(shard.allocator);
+    table->insert(tableHash, key.hashValue, storage);
+    ++shard.numInstances;
     return storage;
   }
 
@@ -107,8 +169,20 @@ private:
   void destroyShardInstances(Shard &shard) {
     if (!destructorFn)
       return;
-    for (HashedStorage &instance : shard.instances)
-      destructorFn(instance.storage);
+    InstanceTable *table = shard.table.load(std::memory_order_relaxed);
+    for (size_t i = 0, e = table->capacity; i != e; ++i)
+      if (BaseStorage *storage =
+              table->buckets[i].storage.load(std::memory_order_relaxed))
+        destructorFn(storage);
+  }
+
+  /// Add the statistics of the given shard to `stats`.
+  static void addShardStatistics(const Shard &shard, Statistics &stats) {
+    stats.numLookups += shard.numLookups.load(std::memory_order_relaxed);
+    stats.numHits += shard.numHits.load(std::memory_order_relaxed);
+    stats.numInstances += shard.numInstances;
+    stats.numContendedInsertions +=
+        shard.numContendedInsertions.load(std::memory_order_relaxed);
   }
 
 public:
@@ -117,9 +191,9 @@ public:
   /// use. The provided shard number is required to be a valid power of 2. The
   /// destructor function is used to destroy any allocated storage instances.
   ParametricStorageUniquer(function_ref<void(BaseStorage *)> destructorFn,
-                           size_t numShards = 8)
+                           size_t numShards = getDefaultNumShards())
       : shards(new std::atomic<Shard *>[numShards]), numShards(numShards),
-        destructorFn(destructorFn) {
+        shardBits(llvm::Log2_64(numShards)), destructorFn(destructorFn) {
     assert(llvm::isPowerOf2_64(numShards) &&
            "the number of shards is required to be a power of 2");
     for (size_t i = 0; i < numShards; i++)
@@ -136,32 +210,38 @@ public:
   }
   /// Get or create an instance of a parametric type.
   BaseStorage *
-  getOrCreate(bool threadingIsEnabled, unsigned hashValue,
+  getOrCreate(bool threadingIsEnabled, bool statisticsAreEnabled,
+              unsigned hashValue,
               function_ref<bool(const BaseStorage *)> isEqual,
               function_ref<BaseStorage *(StorageAllocator &)> ctorFn) {
     Shard &shard = getShard(hashValue);
     ParametricStorageUniquer::LookupKey lookupKey{hashValue, isEqual};
+    if (statisticsAreEnabled)
+      shard.numLookups.fetch_add(1, std::memory_order_relaxed);
     if (!threadingIsEnabled)
-      return getOrCreateUnsafe(shard, lookupKey, ctorFn);
-
-    // Check for a instance of this object in the local cache.
-    auto localIt = localCache->insert_as({hashValue}, lookupKey);
-    BaseStorage *&localInst = localIt.first->storage;
-    if (localInst)
-      return localInst;
-
-    // Check for an existing instance in read-only mode.
-    {
-      llvm::sys::SmartScopedReader<true> typeLock(shard.mutex);
-      auto it = shard.instances.find_as(lookupKey);
-      if (it != shard.instances.end())
-        return localInst = it->storage;
+      return getOrCreateUnsafe(shard, lookupKey, ctorFn, statisticsAreEnabled);
+
+    // Check for an existing instance without locking, this is the common case
+    // once the instances used by a program have been created.
+    InstanceTable *table = shard.table.load(std::memory_order_acquire);
+    if (BaseStorage *storage =
+            table->lookup(getTableHash(hashValue), lookupKey)) {
+      if (statisticsAreEnabled)
+        shard.numHits.fetch_add(1, std::memory_order_relaxed);
+      return storage;
     }
 
-    // Acquire a writer-lock so that we can safely create the new storage
-    // instance.
-    llvm::sys::SmartScopedWriter<true> typeLock(shard.mutex);
-    return localInst = getOrCreateUnsafe(shard, lookupKey, ctorFn);
+    // Acquire the lock so that we can safely create the new storage instance.
+    // Another thread may have created it in the meantime, which is checked
+    // when looking up the instance again under the lock.
+    if (!shard.mutex.try_lock()) {
+      if (statisticsAreEnabled)
+        shard.numContendedInsertions.fetch_add(1, std::memory_order_relaxed);
+      shard.mutex.lock();
+    }
+    std::lock_guard<llvm::sys::SmartMutex<true>> lock(shard.mutex,
+                                                      std::adopt_lock);
+    return getOrCreateUnsafe(shard, lookupKey, ctorFn, statisticsAreEnabled);
   }
   /// Run a mutation function on the provided storage object in a thread-safe
   /// way.
@@ -172,11 +252,46 @@ public:
     if (!threadingIsEnabled)
       return mutationFn(shard.allocator);
 
-    llvm::sys::SmartScopedWriter<true> lock(shard.mutex);
+    llvm::sys::SmartScopedLock<true> lock(shard.mutex);
     return mutationFn(shard.allocator);
   }
 
+  /// Add the uniquing statistics of this uniquer to `stats`.
+  void addStatistics(Statistics &stats) {
+    for (size_t i = 0; i != numShards; ++i) {
+      if (Shard *shard = shards[i].load(std::memory_order_acquire)) {
+        llvm::sys::SmartScopedLock<true> lock(shard->mutex);
+        addShardStatistics(*shard, stats);
+      }
+    }
+  }
+
 private:
+  /// Return the default number of shards to use, which scales with the number
+  /// of hardware threads so that highly parallel pass pipelines don't contend
+  /// on the same shards.
+  static size_t getDefaultNumShards() {
+    static const size_t numShards = llvm::PowerOf2Ceil(std::min<size_t>(
+        std::max<size_t>(llvm::hardware_concurrency().compute_thread_count(),
+                         8),
+        256));
+    return numShards;
+  }
+
+  /// Get or create an instance of a param derived type, updating the
+  /// statistics of the shard if necessary. This must only be called while
+  /// holding the lock of the shard, if threading is enabled.
+  BaseStorage *
+  getOrCreateUnsafe(Shard &shard, LookupKey &key,
+                    function_ref<BaseStorage *(StorageAllocator &)> ctorFn,
+                    bool statisticsAreEnabled) {
+    size_t numInstances = shard.numInstances;
+    BaseStorage *storage = getOrCreateUnsafe(shard, key, ctorFn);
+    if (statisticsAreEnabled && numInstances == shard.numInstances)
+      shard.numHits.fetch_add(1, std::memory_order_relaxed);
+    return storage;
+  }
+
   /// Return the shard used for the given hash value.
   Shard &getShard(unsigned hashValue) {
     // Get a shard number from the provided hashvalue.
@@ -201,7 +316,7 @@ private:
   Shard &getShardFor(BaseStorage *storage) {
     for (size_t i = 0; i != numShards; ++i) {
       if (Shard *shard = shards[i].load(std::memory_order_acquire)) {
-        llvm::sys::SmartScopedReader<true> lock(shard->mutex);
+        llvm::sys::SmartScopedLock<true> lock(shard->mutex);
         if (shard->allocator.allocated(storage))
           return *shard;
       }
@@ -209,17 +324,14 @@ private:
     llvm_unreachable("expected storage object to have a valid shard");
   }
 
-  /// A thread local cache for storage objects. This helps to reduce the lock
-  /// contention when an object already existing in the cache.
-  ThreadLocalCache<StorageTypeSet> localCache;
-
   /// A set of uniquer shards to allow for further bucketing accesses for
   /// instances of this storage type. Each shard is lazily initialized to reduce
   /// the overhead when only a small amount of shards are in use.
   std::unique_ptr<std::atomic<Shard *>[]> shards;
 
-  /// The number of available shards.
+  /// The number of available shards, and its log2.
   size_t numShards;
+  unsigned shardBits;
 
   /// Function to used to destruct any allocated storage instances.
   function_ref<void(BaseStorage *)> destructorFn;
@@ -235,11 +347,20 @@ private:
 
   /// Get or create an instance of a parametric type.
   BaseStorage *
-  getOrCreate(bool threadingIsEnabled, unsigned hashValue,
+  getOrCreate(bool threadingIsEnabled, bool statisticsAreEnabled,
+              unsigned hashValue,
               function_ref<bool(const BaseStorage *)> isEqual,
               function_ref<BaseStorage *(StorageAllocator &)> ctorFn) {
     ParametricStorageUniquer::LookupKey lookupKey{hashValue, isEqual};
-    return getOrCreateUnsafe(shard, lookupKey, ctorFn);
+    if (!statisticsAreEnabled)
+      return getOrCreateUnsafe(shard, lookupKey, ctorFn);
+
+    size_t numInstances = shard.numInstances;
+    BaseStorage *storage = getOrCreateUnsafe(shard, lookupKey, ctorFn);
+    ++shard.numLookups;
+    if (numInstances == shard.numInstances)
+      ++shard.numHits;
+    return storage;
   }
   /// Run a mutation function on the provided storage object in a thread-safe
   /// way.
@@ -249,10 +370,16 @@ private:
     return mutationFn(shard.allocator);
   }
 
+  /// Add the uniquing statistics of this uniquer to `stats`.
+  void addStatistics(Statistics &stats) { addShardStatistics(shard, stats); }
+
 private:
   /// The main uniquer shard that is used for allocating storage instances.
   Shard shard;
 
+  /// All of the hash value is used to index the instance table.
+  unsigned shardBits = 0;
+
   /// Function to used to destruct any allocated storage instances.
   function_ref<void(BaseStorage *)> destructorFn;
 #endif
@@ -281,8 +408,8 @@ struct StorageUniquerImpl {
     assert(parametricUniquers.count(id) &&
            "creating unregistered storage instance");
     ParametricStorageUniquer &storageUniquer = *parametricUniquers[id];
-    return storageUniquer.getOrCreate(threadingIsEnabled, hashValue, isEqual,
-                                      ctorFn);
+    return storageUniquer.getOrCreate(threadingIsEnabled, statisticsAreEnabled,
+                                      hashValue, isEqual, ctorFn);
   }
 
   /// Run a mutation function on the provided storage object in a thread-safe
@@ -296,6 +423,14 @@ struct StorageUniquerImpl {
     return storageUniquer.mutate(threadingIsEnabled, storage, mutationFn);
   }
 
+  /// Return the uniquing statistics of the parametric storage instances.
+  StorageUniquer::Statistics getStatistics() {
+    StorageUniquer::Statistics stats;
+    for (auto &it : parametricUniquers)
+      it.second->addStatistics(stats);
+    return stats;
+  }
+
   //===--------------------------------------------------------------------===//
   // Singleton Storage
   //===--------------------------------------------------------------------===//
@@ -327,6 +462,9 @@ struct StorageUniquerImpl {
 
   /// Flag specifying if multi-threading is enabled within the uniquer.
   bool threadingIsEnabled = true;
+
+  /// Flag specifying if uniquing statistics are collected.
+  bool statisticsAreEnabled = false;
 };
 } // namespace detail
 } // namespace mlir
@@ -339,6 +477,16 @@ void StorageUniquer::disableMultithreading(bool disable) {
   impl->threadingIsEnabled = !disable;
 }
 
+/// Set the flag specifying if uniquing statistics are collected.
+void StorageUniquer::enableStatistics(bool enable) {
+  impl->statisticsAreEnabled = enable;
+}
+
+/// Return the uniquing statistics collected for parametric storage instances.
+StorageUniquer::Statistics StorageUniquer::getStatistics() const {
+  return impl->getStatistics();
+}
+
 /// Implementation for getting/creating an instance of a derived type with
 /// parametric storage.
 auto StorageUniquer::getParametricStorageTypeImpl(
@@ -12,6 +12,7 @@
 
 #include "mlir/Support/Timing.h"
 #include "mlir/Support/ThreadLocalCache.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringMap.h"
@@ -175,7 +176,9 @@ public:
   using ChildrenMap = llvm::MapVector<const void *, std::unique_ptr<TimerImpl>>;
   using AsyncChildrenMap = llvm::DenseMap<uint64_t, ChildrenMap>;
 
-  TimerImpl(std::string &&name) : threadId(llvm::get_threadid()), name(name) {}
+  TimerImpl(std::string &&name) : threadId(llvm::get_threadid()), name(name) {
+    threads.insert(threadId);
+  }
 
   /// Start the timer.
   void start() { startTime = std::chrono::steady_clock::now(); }
@@ -227,12 +230,17 @@ public:
   /// but not the asynchronous ones (by the nesting nature of the timers).
   std::chrono::nanoseconds addAsyncUserTime() {
     auto added = std::chrono::nanoseconds(0);
-    for (auto &child : children)
+    for (auto &child : children) {
       added += child.second->addAsyncUserTime();
+      threads.insert(child.second->threads.begin(),
+                     child.second->threads.end());
+    }
     for (auto &thread : asyncChildren) {
       for (auto &child : thread.second) {
         child.second->addAsyncUserTime();
         added += child.second->userTime;
+        threads.insert(child.second->threads.begin(),
+                       child.second->threads.end());
       }
     }
     userTime += added;
@@ -286,6 +294,7 @@ public:
     } else {
       into->wallTime = std::max(into->wallTime, other->wallTime);
       into->userTime += other->userTime;
+      into->threads.insert(other->threads.begin(), other->threads.end());
       into->mergeChildren(std::move(other->children));
       into->mergeChildren(std::move(other->asyncChildren));
       other.reset();
@@ -345,20 +354,34 @@ public:
       printTimeEntry(os, 0, timeData.first, timeData.second, total);
   }
 
-  /// Print the timing result in tree mode.
-  void printAsTree(raw_ostream &os, TimeRecord total, unsigned indent = 0) {
+  /// Print the timing result in tree mode. If `showThreadUtilization` is set,
+  /// timers that ran on multiple threads are annotated with the number of
+  /// threads and the fraction of their combined wall time spent doing work.
+  void printAsTree(raw_ostream &os, TimeRecord total,
+                   bool showThreadUtilization, unsigned indent = 0) {
     unsigned childIndent = indent;
     if (!hidden) {
-      printTimeEntry(os, indent, name, getTimeRecord(), total);
+      auto time = getTimeRecord();
+      if (showThreadUtilization && threads.size() > 1 && time.wall > 0) {
+        double utilization = time.user / (time.wall * threads.size());
+        printTimeEntry(os, indent,
+                       llvm::formatv("{0} ({1} threads, {2:F1}% utilization)",
+                                     name, threads.size(), 100 * utilization)
+                           .str(),
+                       time, total);
+      } else {
+        printTimeEntry(os, indent, name, time, total);
+      }
       childIndent += 2;
     }
     for (auto &child : children) {
-      child.second->printAsTree(os, total, childIndent);
+      child.second->printAsTree(os, total, showThreadUtilization, childIndent);
     }
   }
 
   /// Print the current timing information.
-  void print(raw_ostream &os, DisplayMode displayMode) {
+  void print(raw_ostream &os, DisplayMode displayMode,
+             bool showThreadUtilization = false) {
     // Print the banner.
     auto total = getTimeRecord();
     printTimeHeader(os, total);
@@ -369,7 +392,7 @@ public:
       printAsList(os, total);
       break;
     case DisplayMode::Tree:
-      printAsTree(os, total);
+      printAsTree(os, total, showThreadUtilization);
       break;
     }
 
@@ -404,6 +427,10 @@ public:
   /// Whether to omit this timer from reports and directly show its children.
   bool hidden = false;
 
+  /// The threads on which this timer or any of its children ran. Async
+  /// children are only accounted for once the timer has been finalized.
+  llvm::SmallDenseSet<uint64_t, 4> threads;
+
   /// Child timers on the same thread the timer itself. We keep at most one
   /// timer per unique identifier.
   ChildrenMap children;
@@ -434,6 +461,9 @@ public:
   /// The configured display mode.
   DisplayMode displayMode = DisplayMode::Tree;
 
+  /// Whether to display the thread utilization of parallel timers.
+  bool showThreadUtilization = false;
+
   /// The stream where we should print our output. This will always be non-null.
   raw_ostream *output = &llvm::errs();
 
@@ -467,6 +497,16 @@ DefaultTimingManager::DisplayMode DefaultTimingManager::getDisplayMode() const {
   return impl->displayMode;
 }
 
+/// Enable or disable the display of the thread utilization of timers.
+void DefaultTimingManager::setShowThreadUtilization(bool show) {
+  impl->showThreadUtilization = show;
+}
+
+/// Return whether the thread utilization of timers is displayed.
+bool DefaultTimingManager::getShowThreadUtilization() const {
+  return impl->showThreadUtilization;
+}
+
 /// Change the stream where the output will be printed to.
 void DefaultTimingManager::setOutput(raw_ostream &os) { impl->output = &os; }
 
@@ -480,7 +520,8 @@ raw_ostream &DefaultTimingManager::getOutput() const {
 void DefaultTimingManager::print() {
   if (impl->enabled) {
     impl->rootTimer->finalize();
-    impl->rootTimer->print(*impl->output, impl->displayMode);
+    impl->rootTimer->print(*impl->output, impl->displayMode,
+                           impl->showThreadUtilization);
   }
   clear();
 }
@@ -505,7 +546,7 @@ void DefaultTimingManager::dumpAsList(raw_ostream &os) {
 /// Debug print the timers as a tree.
 void DefaultTimingManager::dumpAsTree(raw_ostream &os) {
   impl->rootTimer->finalize();
-  impl->rootTimer->print(os, DisplayMode::Tree);
+  impl->rootTimer->print(os, DisplayMode::Tree, impl->showThreadUtilization);
 }
 
 Optional<void *> DefaultTimingManager::rootTimer() {
@@ -548,6 +589,11 @@ struct DefaultTimingManagerOptions {
                      "display the results in a list sorted by total time"),
           clEnumValN(DisplayMode::Tree, "tree",
                      "display the results ina with a nested tree view"))};
+  llvm::cl::opt<bool> threadUtilization{
+      "mlir-timing-thread-utilization",
+      llvm::cl::desc("Display the number of threads and their utilization for "
+                     "timers that ran on multiple threads (tree display only)"),
+      llvm::cl::init(false)};
 };
 } // namespace
 
@@ -563,4 +609,5 @@ void mlir::applyDefaultTimingManagerCLOptions(DefaultTimingManager &tm) {
     return;
   tm.setEnabled(options->timing);
   tm.setDisplayMode(options->displayMode);
+  tm.setShowThreadUtilization(options->threadUtilization);
 }
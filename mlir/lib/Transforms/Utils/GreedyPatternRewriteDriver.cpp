@@ -74,6 +74,11 @@ protected:
   /// PatternRewriter hook for erasing a dead operation.
   void eraseOp(Operation *op) override;
 
+  // When an operation is updated in place, it may enable further
+  // simplifications of the operation itself. Revisit it if the driver doesn't
+  // rescan the regions on each iteration.
+  void finalizeRootUpdate(Operation *op) override;
+
   /// PatternRewriter hook for notifying match failure reasons.
   LogicalResult
   notifyMatchFailure(Operation *op,
@@ -151,8 +156,9 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
       // Reverse the list so our pop-back loop processes them in-order.
       std::reverse(worklist.begin(), worklist.end());
       // Remember the reverse index.
+      worklistMap.reserve(worklist.size());
       for (size_t i = 0, e = worklist.size(); i != e; ++i)
-        worklistMap[worklist[i]] = i;
+        worklistMap.try_emplace(worklist[i], i);
     }
 
     // These are scratch vectors used in the folding loop below.
@@ -221,6 +227,13 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
         changed = true;
         if (!inPlaceUpdate)
           continue;
+
+        // The operation was updated in place, make sure that it and the
+        // producers of its original operands get revisited.
+        if (config.enableChangeDrivenIteration) {
+          addToWorklist(originalOperands);
+          addToWorklist(op);
+        }
       }
 
       // Try to match one of the patterns. The rewriter is automatically
@@ -258,6 +271,12 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
       changed |= succeeded(matchResult);
     }
 
+    // In change-driven mode, all of the operations affected by the changes
+    // above have already been revisited through the worklist, there is no need
+    // to rescan the regions unless they get simplified below.
+    if (config.enableChangeDrivenIteration)
+      changed = false;
+
     // After applying patterns, make sure that the CFG of each of the regions
     // is kept up to date.
     if (config.enableRegionSimplification)
@@ -272,11 +291,8 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
 
 void GreedyPatternRewriteDriver::addToWorklist(Operation *op) {
   // Check to see if the worklist already contains this op.
-  if (worklistMap.count(op))
-    return;
-
-  worklistMap[op] = worklist.size();
-  worklist.push_back(op);
+  if (worklistMap.try_emplace(op, worklist.size()).second)
+    worklist.push_back(op);
 }
 
 Operation *GreedyPatternRewriteDriver::popFromWorklist() {
@@ -347,6 +363,15 @@ void GreedyPatternRewriteDriver::eraseOp(Operation *op) {
   PatternRewriter::eraseOp(op);
 }
 
+void GreedyPatternRewriteDriver::finalizeRootUpdate(Operation *op) {
+  LLVM_DEBUG({
+    logger.startLine() << "** Modified: '" << op->getName() << "'(" << op
+                       << ")\n";
+  });
+  if (config.enableChangeDrivenIteration)
+    addToWorklist(op);
+}
+
 LogicalResult GreedyPatternRewriteDriver::notifyMatchFailure(
     Operation *op, function_ref<void(Diagnostic &)> reasonCallback) {
   LLVM_DEBUG({
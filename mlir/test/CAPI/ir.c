@@ -1914,6 +1914,60 @@ int testSymbolTable(MlirContext ctx) {
   return 0;
 }
 
+/// A growable buffer used to accumulate the chunks of a string callback.
+typedef struct {
+  char *data;
+  intptr_t size;
+} CallbackBuffer;
+
+static void appendToCallbackBuffer(MlirStringRef str, void *userData) {
+  CallbackBuffer *buffer = (CallbackBuffer *)userData;
+  buffer->data = realloc(buffer->data, buffer->size + str.length);
+  memcpy(buffer->data + buffer->size, str.data, str.length);
+  buffer->size += str.length;
+}
+
+/// Tests writing an operation to bytecode and parsing it back.
+int testBytecodeRoundtrip(MlirContext ctx) {
+  fprintf(stderr, "@testBytecodeRoundtrip\n");
+  // CHECK-LABEL: @testBytecodeRoundtrip
+
+  const char *moduleString = "func @add(%arg0: i32, %arg1: i32) -> i32 {\n"
+                             "  %0 = arith.addi %arg0, %arg1 : i32\n"
+                             "  return %0 : i32\n"
+                             "}\n";
+  MlirModule module =
+      mlirModuleCreateParse(ctx, mlirStringRefCreateFromCString(moduleString));
+  if (mlirModuleIsNull(module))
+    return 1;
+
+  CallbackBuffer buffer = {NULL, 0};
+  mlirOperationWriteBytecode(mlirModuleGetOperation(module),
+                             appendToCallbackBuffer, &buffer);
+  mlirModuleDestroy(module);
+
+  // The bytecode starts with the magic number "ML\xefR".
+  if (buffer.size < 4 || memcmp(buffer.data, "ML\xefR", 4) != 0)
+    return 2;
+
+  MlirModule roundtripped =
+      mlirModuleCreateParse(ctx, mlirStringRefCreate(buffer.data, buffer.size));
+  free(buffer.data);
+  if (mlirModuleIsNull(roundtripped))
+    return 3;
+
+  mlirOperationDump(mlirModuleGetOperation(roundtripped));
+  // CHECK: module {
+  // CHECK:   func @add(%arg0: i32, %arg1: i32) -> i32 {
+  // CHECK:     %0 = arith.addi %arg0, %arg1 : i32
+  // CHECK:     return %0 : i32
+  // CHECK:   }
+  // CHECK: }
+
+  mlirModuleDestroy(roundtripped);
+  return 0;
+}
+
 int testDialectRegistry() {
   fprintf(stderr, "@testDialectRegistry\n");
 
@@ -2030,6 +2084,8 @@ int main() {
     return 14;
   if (testDialectRegistry())
     return 15;
+  if (testBytecodeRoundtrip(ctx))
+    return 16;
 
   mlirContextDestroy(ctx);
 
@@ -0,0 +1,88 @@
+//===- TestLinalgTileSizeSelection.cpp - Test Linalg tile size selection --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that reports the tiling and fusion schedules
+// selected by the Linalg tile size cost model, and optionally applies them.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Linalg/Transforms/TileSizeSelection.h"
+#include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Pass/Pass.h"
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+namespace {
+struct TestLinalgTileSizeSelection
+    : public PassWrapper<TestLinalgTileSizeSelection, OperationPass<FuncOp>> {
+  TestLinalgTileSizeSelection() = default;
+  TestLinalgTileSizeSelection(const TestLinalgTileSizeSelection &pass)
+      : PassWrapper(pass) {}
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<AffineDialect, LinalgDialect, scf::SCFDialect,
+                    tensor::TensorDialect>();
+  }
+  StringRef getArgument() const final {
+    return "test-linalg-tile-size-selection";
+  }
+  StringRef getDescription() const final {
+    return "Test the tile sizes and fusion groups selected for Linalg "
+           "contractions and convolutions";
+  }
+
+  Option<bool> apply{*this, "apply",
+                     llvm::cl::desc("Tile and fuse according to the schedule "
+                                    "instead of only reporting it"),
+                     llvm::cl::init(false)};
+
+  void runOnOperation() override {
+    FuncOp funcOp = getOperation();
+    SmallVector<TileAndFuseSchedule> schedules =
+        computeTileAndFuseSchedules(funcOp);
+
+    // Report the schedules as remarks on the root operations.
+    for (const TileAndFuseSchedule &schedule : schedules) {
+      InFlightDiagnostic diag = schedule.rootOp->emitRemark("tile sizes: [");
+      llvm::interleaveComma(schedule.tileSizes, diag);
+      diag << "], fused producers: [";
+      llvm::interleaveComma(schedule.fusedProducers, diag,
+                            [&](LinalgOp producer) {
+                              diag << producer->getName();
+                            });
+      diag << "]";
+    }
+    if (!apply)
+      return;
+
+    // Apply the schedules, consumers first, so that the producers of a
+    // schedule are still untiled when it is applied.
+    OpBuilder builder(funcOp.getContext());
+    for (const TileAndFuseSchedule &schedule : llvm::reverse(schedules)) {
+      builder.setInsertionPoint(schedule.rootOp);
+      FailureOr<TileLoopNest> tileLoopNest =
+          applyTileAndFuseSchedule(builder, schedule);
+      if (failed(tileLoopNest))
+        continue;
+      schedule.rootOp->replaceAllUsesWith(
+          tileLoopNest->getRootOpReplacementResults());
+      schedule.rootOp->erase();
+    }
+  }
+};
+} // namespace
+
+namespace mlir {
+namespace test {
+void registerTestLinalgTileSizeSelection() {
+  PassRegistration<TestLinalgTileSizeSelection>();
+}
+} // namespace test
+} // namespace mlir
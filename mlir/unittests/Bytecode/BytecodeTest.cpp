@@ -0,0 +1,134 @@
+//===- BytecodeTest.cpp - MLIR Bytecode unit tests ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Bytecode/BytecodeReader.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/OperationSupport.h"
+#include "mlir/Parser.h"
+#include "llvm/Support/MemoryBufferRef.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+static const char *const kIR = R"mlir(
+func @foo(%arg0: i32, %arg1: tensor<2x3xf32>) -> i32 {
+  %0 = "test.op"(%arg0) {
+    dense = dense<[1, -2]> : tensor<2xi64>,
+    splat = dense<1.5> : vector<4xf32>,
+    str = "hello",
+    arr = [1 : i8, 2.5 : f32, @sym, @sym::@nested, unit],
+    map = affine_map<(d0) -> (d0 + 1)>,
+    big = 123456789012345678901234567890 : i128
+  } : (i32) -> i32 loc("file.mlir":1:2)
+  "test.branch"(%1)[^bb1] : (i32) -> () loc(fused["a.mlir":1:1, "b"])
+^bb1:
+  %1 = "test.op"(%0) : (i32) -> i32 loc(callsite("foo" at "bar.mlir":3:4))
+  "test.region"() ({
+  ^bb0(%arg2: index, %arg3: complex<f64>):
+    "test.use"(%1, %arg1, %arg2) : (i32, tensor<2x3xf32>, index) -> ()
+  }) : () -> ()
+  "test.return"(%1) : (i32) -> ()
+}
+func private @bar(memref<4xf32, 1>, tuple<i32, f16>) -> (none, tensor<*xbf16>)
+)mlir";
+
+/// Print the given operation with its locations.
+static std::string print(Operation *op) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  op->print(os, OpPrintingFlags().enableDebugInfo());
+  return os.str();
+}
+
+/// Write the given operation to bytecode.
+static std::string writeBytecode(Operation *op) {
+  std::string bytecode;
+  llvm::raw_string_ostream os(bytecode);
+  writeBytecodeToFile(op, os);
+  return os.str();
+}
+
+TEST(Bytecode, Roundtrip) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString<ModuleOp>(kIR, &context);
+  ASSERT_TRUE(module);
+  std::string bytecode = writeBytecode(module->getOperation());
+
+  llvm::MemoryBufferRef buffer(bytecode, "roundtrip");
+  ASSERT_TRUE(isBytecode(buffer));
+  Block block;
+  ASSERT_TRUE(succeeded(readBytecodeFile(buffer, &block, &context)));
+  ASSERT_TRUE(llvm::hasSingleElement(block));
+  EXPECT_EQ(print(&block.front()), print(module->getOperation()));
+
+  // Writing the roundtripped IR should produce the same bytecode.
+  EXPECT_EQ(writeBytecode(&block.front()), bytecode);
+}
+
+TEST(Bytecode, LazyLoading) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString<ModuleOp>(kIR, &context);
+  ASSERT_TRUE(module);
+  std::string bytecode = writeBytecode(module->getOperation());
+
+  llvm::MemoryBufferRef buffer(bytecode, "lazy");
+  BytecodeReader reader(buffer, &context, /*lazyLoad=*/true);
+  Block block;
+  ASSERT_TRUE(succeeded(reader.readTopLevel(&block)));
+
+  // Only the top-level module has been read, its body is loaded on demand.
+  ASSERT_TRUE(llvm::hasSingleElement(block));
+  Operation *moduleOp = &block.front();
+  EXPECT_EQ(reader.getNumOpsToMaterialize(), 1);
+  EXPECT_TRUE(reader.isMaterializable(moduleOp));
+  EXPECT_TRUE(moduleOp->getRegion(0).empty());
+
+  // Materializing the module exposes the functions, whose bodies are in turn
+  // loaded on demand.
+  ASSERT_TRUE(succeeded(reader.materialize(moduleOp)));
+  EXPECT_FALSE(reader.isMaterializable(moduleOp));
+  EXPECT_EQ(reader.getNumOpsToMaterialize(), 2);
+  for (Operation &func : moduleOp->getRegion(0).front()) {
+    EXPECT_TRUE(reader.isMaterializable(&func));
+    EXPECT_TRUE(func.getRegion(0).empty());
+  }
+
+  ASSERT_TRUE(succeeded(reader.materializeAll()));
+  EXPECT_EQ(reader.getNumOpsToMaterialize(), 0);
+  EXPECT_EQ(print(moduleOp), print(module->getOperation()));
+}
+
+TEST(Bytecode, InvalidBytecode) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module = parseSourceString<ModuleOp>(kIR, &context);
+  ASSERT_TRUE(module);
+  std::string bytecode = writeBytecode(module->getOperation());
+
+  // Textual IR isn't detected as bytecode.
+  EXPECT_FALSE(isBytecode(llvm::MemoryBufferRef(kIR, "text")));
+
+  // Truncated bytecode is rejected with a diagnostic, instead of crashing.
+  unsigned numErrors = 0;
+  ScopedDiagnosticHandler handler(&context, [&](Diagnostic &diag) {
+    ++numErrors;
+    return success();
+  });
+  for (size_t size : {bytecode.size() / 2, bytecode.size() - 1}) {
+    llvm::MemoryBufferRef buffer(StringRef(bytecode).take_front(size),
+                                 "truncated");
+    Block block;
+    EXPECT_TRUE(failed(readBytecodeFile(buffer, &block, &context)));
+    EXPECT_TRUE(block.empty());
+  }
+  EXPECT_EQ(numErrors, 2u);
+}
@@ -0,0 +1,228 @@
+//===- AsyncRuntime.cpp - Async runtime unit tests ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/ExecutionEngine/AsyncRuntime.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "gmock/gmock.h"
+
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+using namespace mlir::runtime;
+
+// The async runtime only exports the runner integration entry point, the API
+// functions are looked up from the symbols it exports.
+extern "C" void __mlir_runner_init(llvm::StringMap<void *> &exportSymbols);
+
+namespace {
+struct AsyncRuntimeApi {
+  AsyncRuntimeApi() {
+    llvm::StringMap<void *> symbols;
+    __mlir_runner_init(symbols);
+    auto lookup = [&](auto &fn, llvm::StringRef name) {
+      fn = reinterpret_cast<std::remove_reference_t<decltype(fn)>>(
+          symbols.lookup(name));
+      ASSERT_NE(fn, nullptr) << name;
+    };
+    lookup(dropRef, "mlirAsyncRuntimeDropRef");
+    lookup(createToken, "mlirAsyncRuntimeCreateToken");
+    lookup(emplaceToken, "mlirAsyncRuntimeEmplaceToken");
+    lookup(setTokenError, "mlirAsyncRuntimeSetTokenError");
+    lookup(awaitToken, "mlirAsyncRuntimeAwaitToken");
+    lookup(createGroup, "mlirAsyncRuntimeCreateGroup");
+    lookup(addTokenToGroup, "mlirAsyncRuntimeAddTokenToGroup");
+    lookup(isGroupError, "mlirAsyncRuntimeIsGroupError");
+    lookup(awaitAllInGroup, "mlirAsyncRuntimeAwaitAllInGroup");
+    lookup(execute, "mlirAsyncRuntimeExecute");
+    lookup(awaitTokenAndExecute, "mlirAsyncRuntimeAwaitTokenAndExecute");
+    lookup(awaitAllInGroupAndExecute,
+           "mlirAsyncRuntimeAwaitAllInGroupAndExecute");
+  }
+
+  void (*dropRef)(RefCountedObjPtr, int64_t);
+  AsyncToken *(*createToken)();
+  void (*emplaceToken)(AsyncToken *);
+  void (*setTokenError)(AsyncToken *);
+  void (*awaitToken)(AsyncToken *);
+  AsyncGroup *(*createGroup)(int64_t);
+  int64_t (*addTokenToGroup)(AsyncToken *, AsyncGroup *);
+  bool (*isGroupError)(AsyncGroup *);
+  void (*awaitAllInGroup)(AsyncGroup *);
+  void (*execute)(CoroHandle, CoroResume);
+  void (*awaitTokenAndExecute)(AsyncToken *, CoroHandle, CoroResume);
+  void (*awaitAllInGroupAndExecute)(AsyncGroup *, CoroHandle, CoroResume);
+};
+
+const AsyncRuntimeApi &getApi() {
+  static AsyncRuntimeApi api;
+  return api;
+}
+
+/// A task that increments a counter, and emplaces a token when the counter
+/// reaches its expected value.
+struct CountingTask {
+  static void resume(void *handle) {
+    auto *task = static_cast<CountingTask *>(handle);
+    // The task may be destroyed as soon as the last increment is done, only the
+    // thread doing it may access the task afterwards.
+    int64_t expected = task->expected;
+    if (task->counter.fetch_add(1) + 1 == expected)
+      getApi().emplaceToken(task->done);
+  }
+
+  std::atomic<int64_t> counter{0};
+  int64_t expected;
+  AsyncToken *done;
+};
+} // namespace
+
+TEST(AsyncRuntime, ExecuteTasks) {
+  const AsyncRuntimeApi &api = getApi();
+  CountingTask task;
+  task.expected = 10000;
+  task.done = api.createToken();
+  for (int64_t i = 0; i < task.expected; ++i)
+    api.execute(&task, &CountingTask::resume);
+  api.awaitToken(task.done);
+  EXPECT_EQ(task.counter.load(), task.expected);
+  api.dropRef(task.done, 1);
+}
+
+TEST(AsyncRuntime, AwaitTokenAndExecute) {
+  const AsyncRuntimeApi &api = getApi();
+  CountingTask task;
+  task.expected = 3;
+  task.done = api.createToken();
+
+  // Continuations of an available token run inline.
+  AsyncToken *available = api.createToken();
+  api.emplaceToken(available);
+  api.awaitTokenAndExecute(available, &task, &CountingTask::resume);
+  EXPECT_EQ(task.counter.load(), 1);
+
+  // Continuations of an unavailable token run when it becomes available.
+  AsyncToken *pending = api.createToken();
+  api.awaitTokenAndExecute(pending, &task, &CountingTask::resume);
+  api.awaitTokenAndExecute(pending, &task, &CountingTask::resume);
+  EXPECT_EQ(task.counter.load(), 1);
+  api.emplaceToken(pending);
+  api.awaitToken(task.done);
+  EXPECT_EQ(task.counter.load(), 3);
+
+  api.dropRef(available, 1);
+  api.dropRef(pending, 1);
+  api.dropRef(task.done, 1);
+}
+
+namespace {
+/// A task that emplaces a token, or sets it to the error state.
+struct EmplaceTask {
+  static void resume(void *handle) {
+    auto *task = static_cast<EmplaceTask *>(handle);
+    if (task->error)
+      getApi().setTokenError(task->token);
+    else
+      getApi().emplaceToken(task->token);
+  }
+
+  AsyncToken *token;
+  bool error;
+};
+} // namespace
+
+TEST(AsyncRuntime, AwaitAllInGroup) {
+  const AsyncRuntimeApi &api = getApi();
+  constexpr int64_t kNumTokens = 1000;
+  AsyncGroup *group = api.createGroup(kNumTokens);
+
+  CountingTask continuation;
+  continuation.expected = 1;
+  continuation.done = api.createToken();
+  api.awaitAllInGroupAndExecute(group, &continuation, &CountingTask::resume);
+
+  std::vector<EmplaceTask> tasks(kNumTokens);
+  for (int64_t i = 0; i < kNumTokens; ++i) {
+    tasks[i].token = api.createToken();
+    tasks[i].error = i == kNumTokens / 2;
+    // Make half of the tokens available before adding them to the group.
+    if (i % 2 == 0)
+      EmplaceTask::resume(&tasks[i]);
+    EXPECT_EQ(api.addTokenToGroup(tasks[i].token, group), i);
+    if (i % 2 != 0)
+      api.execute(&tasks[i], &EmplaceTask::resume);
+  }
+
+  api.awaitAllInGroup(group);
+  api.awaitToken(continuation.done);
+  EXPECT_EQ(continuation.counter.load(), 1);
+  EXPECT_TRUE(api.isGroupError(group));
+
+  for (EmplaceTask &task : tasks)
+    api.dropRef(task.token, 1);
+  api.dropRef(continuation.done, 1);
+  api.dropRef(group, 1);
+}
+
+namespace {
+/// A task that spawns `numTasks` tasks by recursively splitting the range of
+/// tasks in halves, like the tasks created by `async-parallel-for`.
+struct SplittingTask {
+  static void resume(void *handle) {
+    auto *task = static_cast<SplittingTask *>(handle);
+    while (task->end - task->begin > 1) {
+      int64_t mid = task->begin + (task->end - task->begin) / 2;
+      auto *tail = new SplittingTask{mid, task->end, task->counter};
+      task->end = mid;
+      getApi().execute(tail, &SplittingTask::resume);
+    }
+    CountingTask::resume(task->counter);
+    delete task;
+  }
+
+  int64_t begin;
+  int64_t end;
+  CountingTask *counter;
+};
+} // namespace
+
+// Measures the throughput of the runtime for fine-grained tasks, spawned from
+// outside of the runtime and recursively from within worker threads.
+TEST(AsyncRuntime, SpawnThroughput) {
+  const AsyncRuntimeApi &api = getApi();
+  constexpr int64_t kNumTasks = 1000000;
+
+  auto measure = [&](llvm::StringRef name, auto spawn) {
+    CountingTask task;
+    task.expected = kNumTasks;
+    task.done = api.createToken();
+    auto start = std::chrono::steady_clock::now();
+    spawn(task);
+    api.awaitToken(task.done);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(task.counter.load(), kNumTasks);
+    api.dropRef(task.done, 1);
+    llvm::outs() << name << ": " << kNumTasks << " tasks in "
+                 << llvm::format("%.3f", elapsed.count()) << "s ("
+                 << llvm::format("%.2f", kNumTasks / elapsed.count() / 1e6)
+                 << "M tasks/s)\n";
+  };
+
+  measure("external spawn", [&](CountingTask &task) {
+    for (int64_t i = 0; i < kNumTasks; ++i)
+      api.execute(&task, &CountingTask::resume);
+  });
+  measure("recursive spawn", [&](CountingTask &task) {
+    api.execute(new SplittingTask{0, kNumTasks, &task},
+                &SplittingTask::resume);
+  });
+}
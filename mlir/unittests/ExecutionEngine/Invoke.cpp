@@ -24,6 +24,8 @@
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Export.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -102,6 +104,86 @@ TEST(MLIRExecutionEngine, SubtractFloat) {
   ASSERT_EQ(result, 42.f);
 }
 
+TEST(MLIRExecutionEngine, ParallelCompilation) {
+  std::string moduleStr = R"mlir(
+  func @double(%arg0 : i32) -> i32 {
+    %res = arith.addi %arg0, %arg0 : i32
+    return %res : i32
+  }
+  func @increment(%arg0 : i32) -> i32 {
+    %cst1 = arith.constant 1 : i32
+    %res = arith.addi %arg0, %cst1 : i32
+    return %res : i32
+  }
+  func @foo(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %0 = call @double(%arg0) : (i32) -> i32
+    %1 = call @increment(%0) : (i32) -> i32
+    return %1 : i32
+  }
+  )mlir";
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registerLLVMDialectTranslation(registry);
+  MLIRContext context(registry);
+  OwningOpRef<ModuleOp> module = parseSourceString(moduleStr, &context);
+  ASSERT_TRUE(!!module);
+  ASSERT_TRUE(succeeded(lowerToLLVMDialect(*module)));
+  ExecutionEngineOptions options;
+  options.numCompileThreads = 2;
+  auto jitOrError = ExecutionEngine::create(*module, options);
+  ASSERT_TRUE(!!jitOrError);
+  std::unique_ptr<ExecutionEngine> jit = std::move(jitOrError.get());
+  int result = 0;
+  llvm::Error error =
+      jit->invoke("foo", 20, ExecutionEngine::Result<int>(result));
+  ASSERT_TRUE(!error);
+  ASSERT_EQ(result, 41);
+}
+
+TEST(MLIRExecutionEngine, PersistentObjectCache) {
+  std::string moduleStr = R"mlir(
+  func @foo(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %res = arith.muli %arg0, %arg0 : i32
+    return %res : i32
+  }
+  )mlir";
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registerLLVMDialectTranslation(registry);
+  MLIRContext context(registry);
+  OwningOpRef<ModuleOp> module = parseSourceString(moduleStr, &context);
+  ASSERT_TRUE(!!module);
+  ASSERT_TRUE(succeeded(lowerToLLVMDialect(*module)));
+
+  SmallString<128> cacheDir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("mlir-object-cache",
+                                                    cacheDir));
+  ExecutionEngineOptions options;
+  options.objectCacheDir = cacheDir;
+
+  // The first engine persists the object, and the second one reuses it.
+  auto countCachedObjects = [&]() {
+    std::error_code ec;
+    unsigned numObjects = 0;
+    for (llvm::sys::fs::directory_iterator it(cacheDir, ec), end;
+         it != end && !ec; it.increment(ec))
+      numObjects += llvm::sys::path::extension(it->path()) == ".o";
+    return numObjects;
+  };
+  for (unsigned i = 0; i < 2; ++i) {
+    auto jitOrError = ExecutionEngine::create(*module, options);
+    ASSERT_TRUE(!!jitOrError);
+    std::unique_ptr<ExecutionEngine> jit = std::move(jitOrError.get());
+    int result = 0;
+    llvm::Error error =
+        jit->invoke("foo", 7, ExecutionEngine::Result<int>(result));
+    ASSERT_TRUE(!error);
+    ASSERT_EQ(result, 49);
+    EXPECT_EQ(countCachedObjects(), 1u);
+  }
+  llvm::sys::fs::remove_directories(cacheDir);
+}
+
 TEST(NativeMemRefJit, ZeroRankMemref) {
   OwningMemRef<float, 0> a({});
   a[{}] = 42.;
@@ -7,7 +7,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/BuiltinDialect.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace mlir;
@@ -250,4 +254,87 @@ TEST(SparseElementsAttrTest, GetZero) {
   EXPECT_TRUE(zeroStringValue.getType() == stringTy);
 }
 
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr
+//===----------------------------------------------------------------------===//
+
+TEST(DenseResourceElementsAttrTest, ReferencesBlobWithoutCopy) {
+  MLIRContext context;
+  static const int64_t data[] = {1, 2, 3, 4};
+  ArrayRef<char> rawData(reinterpret_cast<const char *>(data), sizeof(data));
+  auto type = RankedTensorType::get({4}, IntegerType::get(&context, 64));
+  auto attr = DenseResourceElementsAttr::get(
+      type, "weights",
+      UnmanagedAsmResourceBlob::allocate(rawData, alignof(int64_t)));
+
+  // The attribute references the data of the blob directly.
+  Optional<ArrayRef<char>> attrData = attr.tryGetRawData();
+  ASSERT_TRUE(attrData.hasValue());
+  EXPECT_EQ(attrData->data(), rawData.data());
+  EXPECT_EQ(attrData->size(), rawData.size());
+
+  // Attributes are uniqued by handle, and inserting another blob with the same
+  // name creates a new resource.
+  EXPECT_EQ(DenseResourceElementsAttr::get(type, attr.getRawHandle()), attr);
+  auto otherAttr = DenseResourceElementsAttr::get(
+      type, "weights",
+      UnmanagedAsmResourceBlob::allocate(rawData, alignof(int64_t)));
+  EXPECT_NE(otherAttr, attr);
+  EXPECT_EQ(otherAttr.getRawHandle().getKey(), "weights_1");
+
+  // Only the key of the resource is printed.
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  attr.print(os);
+  EXPECT_EQ(os.str(), "dense_resource<weights> : tensor<4xi64>");
+}
+
+TEST(DenseResourceElementsAttrTest, DeferredBlob) {
+  MLIRContext context;
+  auto &manager = BuiltinBlobManagerInterface::get(&context);
+  DenseResourceElementsHandle handle = manager.lookupOrInsert("deferred");
+  auto attr = DenseResourceElementsAttr::get(
+      RankedTensorType::get({2}, FloatType::getF32(&context)), handle);
+  EXPECT_FALSE(attr.tryGetRawData().hasValue());
+  EXPECT_EQ(manager.lookupOrInsert("deferred"), handle);
+
+  // Providing the blob later on makes it available through the attribute.
+  static const float data[] = {1.0f, 2.0f};
+  manager.update("deferred",
+                 HeapAsmResourceBlob::allocateAndCopy(
+                     ArrayRef<char>(reinterpret_cast<const char *>(data),
+                                    sizeof(data)),
+                     alignof(float)));
+  Optional<ArrayRef<char>> attrData = attr.tryGetRawData();
+  ASSERT_TRUE(attrData.hasValue());
+  EXPECT_EQ(attrData->size(), sizeof(data));
+  EXPECT_EQ(reinterpret_cast<const float *>(attrData->data())[1], 2.0f);
+}
+
+TEST(DenseResourceElementsAttrTest, LoadBlobFromFile) {
+  SmallString<128> path;
+  int fd;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("resource", "bin", fd, path));
+  llvm::FileRemover remover(path);
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    for (int32_t i = 0; i < 1024; ++i)
+      os.write(reinterpret_cast<const char *>(&i), sizeof(i));
+  }
+
+  std::string errorMessage;
+  FailureOr<AsmResourceBlob> blob =
+      loadAsmResourceBlobFromFile(path, alignof(int32_t), &errorMessage);
+  ASSERT_TRUE(succeeded(blob)) << errorMessage;
+  ASSERT_EQ(blob->getData().size(), 1024 * sizeof(int32_t));
+  EXPECT_EQ(reinterpret_cast<const int32_t *>(blob->getData().data())[1000],
+            1000);
+  EXPECT_FALSE(blob->isMutable());
+
+  std::string missingPath = (path + ".missing").str();
+  EXPECT_TRUE(failed(loadAsmResourceBlobFromFile(missingPath, alignof(int32_t),
+                                                 &errorMessage)));
+  EXPECT_FALSE(errorMessage.empty());
+}
+
 } // namespace
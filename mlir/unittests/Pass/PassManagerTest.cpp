@@ -10,9 +10,14 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Support/Timing.h"
+#include "llvm/Support/ThreadPool.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -128,4 +133,128 @@ TEST(PassManagerTest, InvalidPass) {
   ASSERT_DEATH(pm.addPass(std::make_unique<InvalidPass>()), "");
 }
 
+namespace {
+/// The number of instances of `ConcurrencyTrackingPass` currently running, and
+/// the maximum number that ran at the same time.
+static std::atomic<unsigned> numRunningPasses;
+static std::atomic<unsigned> maxRunningPasses;
+
+/// Pass that keeps a function busy for a while, tracking how many functions are
+/// processed concurrently.
+struct ConcurrencyTrackingPass
+    : public PassWrapper<ConcurrencyTrackingPass, OperationPass<FuncOp>> {
+  void runOnOperation() override {
+    unsigned numRunning = ++numRunningPasses;
+    unsigned maxRunning = maxRunningPasses;
+    while (numRunning > maxRunning &&
+           !maxRunningPasses.compare_exchange_weak(maxRunning, numRunning))
+      ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    --numRunningPasses;
+  }
+};
+} // namespace
+
+TEST(PassManagerTest, NestedParallelPipelines) {
+  // Use a fixed number of threads, independently of the host.
+  llvm::ThreadPool threadPool(llvm::hardware_concurrency(4));
+  MLIRContext context(MLIRContext::Threading::DISABLED);
+  context.setThreadPool(threadPool);
+  Builder builder(&context);
+
+  // Create a module with 2 nested modules of 4 functions each.
+  OwningOpRef<ModuleOp> module(ModuleOp::create(UnknownLoc::get(&context)));
+  for (unsigned i = 0; i < 2; ++i) {
+    ModuleOp nested = ModuleOp::create(builder.getUnknownLoc());
+    module->push_back(nested);
+    for (unsigned j = 0; j < 4; ++j) {
+      FuncOp func = FuncOp::create(
+          builder.getUnknownLoc(), ("func" + Twine(j)).str(),
+          builder.getFunctionType(llvm::None, llvm::None));
+      func.setPrivate();
+      nested.push_back(func);
+    }
+  }
+
+  DefaultTimingManager tm;
+  std::string timingReport;
+  llvm::raw_string_ostream timingOS(timingReport);
+  tm.setEnabled(true);
+  tm.setShowThreadUtilization(true);
+  tm.setOutput(timingOS);
+  {
+    TimingScope rootScope = tm.getRootScope();
+    PassManager pm(&context);
+    pm.enableTiming(rootScope);
+    pm.nest<ModuleOp>().addNestedPass<FuncOp>(
+        std::make_unique<ConcurrencyTrackingPass>());
+    numRunningPasses = maxRunningPasses = 0;
+    EXPECT_TRUE(succeeded(pm.run(module.get())));
+  }
+  tm.print();
+
+  // The function pipelines of a nested module are not confined to the thread
+  // running the module pipeline, so more functions than there are nested
+  // modules are processed at the same time.
+  EXPECT_EQ(numRunningPasses.load(), 0u);
+  EXPECT_GT(maxRunningPasses.load(), 2u);
+  EXPECT_NE(timingOS.str().find("% utilization)"), std::string::npos);
+}
+
+namespace {
+/// Module pass that breaks the functions named "broken", and reports the
+/// functions named "reported" as the only changed operations.
+struct BreakFunctionsPass
+    : public PassWrapper<BreakFunctionsPass, OperationPass<ModuleOp>> {
+  void runOnOperation() override {
+    getOperation().walk([&](FuncOp func) {
+      if (func.getName() == "broken")
+        func->removeAttr(FuncOp::getTypeAttrName());
+      if (func.getName() == "reported")
+        markOperationChanged(func);
+    });
+  }
+};
+} // namespace
+
+TEST(PassManagerTest, VerifyChangedOperations) {
+  MLIRContext context;
+  Builder builder(&context);
+  context.getDiagEngine().registerHandler([](Diagnostic &) {});
+
+  // Create a module with a nested module holding functions for each list of
+  // function names.
+  auto createModule = [&](ArrayRef<ArrayRef<StringRef>> nestedFuncNames) {
+    OwningOpRef<ModuleOp> module(ModuleOp::create(UnknownLoc::get(&context)));
+    for (ArrayRef<StringRef> funcNames : nestedFuncNames) {
+      ModuleOp nested = ModuleOp::create(builder.getUnknownLoc());
+      module->push_back(nested);
+      for (StringRef name : funcNames) {
+        FuncOp func =
+            FuncOp::create(builder.getUnknownLoc(), name,
+                           builder.getFunctionType(llvm::None, llvm::None));
+        func.setPrivate();
+        nested.push_back(func);
+      }
+    }
+    return module;
+  };
+  PassManager pm(&context);
+  pm.addPass(std::make_unique<BreakFunctionsPass>());
+
+  // Only the nested module holding the reported function is verified.
+#ifndef EXPENSIVE_CHECKS
+  OwningOpRef<ModuleOp> module = createModule({{"reported"}, {"broken"}});
+  EXPECT_TRUE(succeeded(pm.run(module.get())));
+#endif
+
+  // The regions holding the reported operations are verified.
+  module = createModule({{"reported", "broken"}});
+  EXPECT_TRUE(failed(pm.run(module.get())));
+
+  // Everything is verified if the pass does not report its changes.
+  module = createModule({{}, {"broken"}});
+  EXPECT_TRUE(failed(pm.run(module.get())));
+}
+
 } // namespace
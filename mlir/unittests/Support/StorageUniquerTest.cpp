@@ -8,6 +8,7 @@
 
 #include "mlir/Support/StorageUniquer.h"
 #include "gmock/gmock.h"
+#include <thread>
 
 using namespace mlir;
 
@@ -58,3 +59,41 @@ TEST(StorageUniquerTest, NonTrivialDestructor) {
 
   EXPECT_TRUE(wasDestructed);
 }
+
+TEST(StorageUniquerTest, ConcurrentUniquing) {
+  struct IntStorage : public SimpleStorage<IntStorage, int> {
+    using Base::Base;
+  };
+
+  StorageUniquer uniquer;
+  uniquer.registerParametricStorageType<IntStorage>();
+  uniquer.enableStatistics();
+
+  // Create the same instances from several threads, in different orders, and
+  // check that they all get the same instances.
+  constexpr int numKeys = 2000, numThreads = 4;
+  std::vector<std::vector<IntStorage *>> instances(
+      numThreads, std::vector<IntStorage *>(numKeys));
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < numThreads; ++thread) {
+    threads.emplace_back([&, thread] {
+      for (int i = 0; i < numKeys; ++i) {
+        int key = (i * 7919 + thread * 13) % numKeys;
+        instances[thread][key] = IntStorage::get(uniquer, key);
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  for (int key = 0; key < numKeys; ++key) {
+    EXPECT_EQ(std::get<0>(instances[0][key]->key), key);
+    for (int thread = 1; thread < numThreads; ++thread)
+      EXPECT_EQ(instances[thread][key], instances[0][key]);
+  }
+
+  StorageUniquer::Statistics stats = uniquer.getStatistics();
+  EXPECT_EQ(stats.numLookups, uint64_t(numKeys * numThreads));
+  EXPECT_EQ(stats.numInstances, uint64_t(numKeys));
+  EXPECT_EQ(stats.numHits, uint64_t(numKeys * (numThreads - 1)));
+}
@@ -49,6 +49,30 @@ struct EnabledPattern : public RewritePattern {
   }
 };
 
+/// Forward the operand of a "test.chain" operation defined by another
+/// "test.chain" operation, and count the number of times it gets matched.
+struct ForwardChainPattern : public RewritePattern {
+  ForwardChainPattern(MLIRContext *context, unsigned &numMatchAttempts)
+      : RewritePattern("test.chain", /*benefit=*/1, context,
+                       /*generatedNamed=*/{}),
+        numMatchAttempts(numMatchAttempts) {
+    setDebugName("ForwardChainPattern");
+  }
+
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    ++numMatchAttempts;
+    Operation *def = op->getOperand(0).getDefiningOp();
+    if (!def || def->getName() != op->getName())
+      return failure();
+    rewriter.updateRootInPlace(op,
+                               [&] { op->setOperand(0, def->getOperand(0)); });
+    return success();
+  }
+
+  unsigned &numMatchAttempts;
+};
+
 struct TestDialect : public Dialect {
   static StringRef getDialectNamespace() { return "test"; }
 
@@ -81,4 +105,52 @@ TEST(CanonicalizerTest, TestDisablePatterns) {
   EXPECT_FALSE(module->lookupSymbol("A"));
 }
 
+/// Canonicalize a module with many operations where only a few of them can be
+/// rewritten, and return the number of pattern match attempts.
+static unsigned canonicalizeChains(bool changeDriven, std::string &result) {
+  MLIRContext context;
+  context.getOrLoadDialect<TestDialect>();
+
+  std::string code = R"mlir(
+    %src = "test.source"() : () -> i32
+    %c0 = "test.chain"(%src) : (i32) -> i32
+    %c1 = "test.chain"(%c0) : (i32) -> i32
+    %c2 = "test.chain"(%c1) : (i32) -> i32
+  )mlir";
+  for (unsigned i = 0; i < 1000; ++i)
+    code += "\"test.chain\"(%src) : (i32) -> i32\n";
+
+  OwningOpRef<ModuleOp> module = mlir::parseSourceString(code, &context);
+  EXPECT_TRUE(module);
+
+  unsigned numMatchAttempts = 0;
+  RewritePatternSet patterns(&context);
+  patterns.add<ForwardChainPattern>(&context, numMatchAttempts);
+  FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+
+  GreedyRewriteConfig config;
+  config.useTopDownTraversal = true;
+  config.enableChangeDrivenIteration = changeDriven;
+  EXPECT_TRUE(succeeded(
+      applyPatternsAndFoldGreedily(*module, frozenPatterns, config)));
+
+  llvm::raw_string_ostream os(result);
+  module->print(os);
+  return numMatchAttempts;
+}
+
+TEST(CanonicalizerTest, TestChangeDrivenIteration) {
+  std::string rescanResult, changeDrivenResult;
+  unsigned rescanAttempts =
+      canonicalizeChains(/*changeDriven=*/false, rescanResult);
+  unsigned changeDrivenAttempts =
+      canonicalizeChains(/*changeDriven=*/true, changeDrivenResult);
+
+  // Both modes produce the same IR, but the change-driven mode doesn't rematch
+  // all of the operations on a second iteration.
+  EXPECT_EQ(rescanResult, changeDrivenResult);
+  EXPECT_GT(rescanAttempts, 2000u);
+  EXPECT_LT(changeDrivenAttempts, 1010u);
+}
+
 } // end anonymous namespace
@@ -13,6 +13,7 @@
 #ifndef LLVM_OPENMP_LIBOMPTARGET_PLUGINS_COMMON_MEMORYMANAGER_MEMORYMANAGER_H
 #define LLVM_OPENMP_LIBOMPTARGET_PLUGINS_COMMON_MEMORYMANAGER_MEMORYMANAGER_H
 
+#include <atomic>
 #include <cassert>
 #include <functional>
 #include <list>
@@ -40,13 +41,20 @@ public:
 /// Class of memory manager. The memory manager is per-device by using
 /// per-device allocator. Therefore, each plugin using memory manager should
 /// have an allocator for each device.
+///
+/// Freed memory is kept in size-class buckets, one per power of two, and
+/// handed out again to requests of the same size class. Only requests up to
+/// \p SizeThreshold are managed; the buckets go up to 1 << \p MaxBucketLog so
+/// that raising the threshold with \p LIBOMPTARGET_MEMORY_MANAGER_THRESHOLD
+/// also caches large buffers, e.g., the ones an iterative solver maps and
+/// unmaps at every iteration.
 class MemoryManagerTy {
-  static constexpr const size_t BucketSize[] = {
-      0,       1U << 2, 1U << 3,  1U << 4,  1U << 5,  1U << 6, 1U << 7,
-      1U << 8, 1U << 9, 1U << 10, 1U << 11, 1U << 12, 1U << 13};
+  /// The log2 of the size of the last bucket. Larger requests share it.
+  static constexpr const int MaxBucketLog = 40;
 
-  static constexpr const int NumBuckets =
-      sizeof(BucketSize) / sizeof(BucketSize[0]);
+  /// Bucket 0 holds requests smaller than 4 bytes, bucket \p B > 0 the ones in
+  /// [1 << (B + 1), 1 << (B + 2)).
+  static constexpr const int NumBuckets = MaxBucketLog;
 
   /// Find the previous number that is power of 2 given a number that is not
   /// power of 2.
@@ -73,16 +81,9 @@ class MemoryManagerTy {
 
     DP("findBucket: Size %zu is floored to %zu.\n", Size, F);
 
-    int L = 0, H = NumBuckets - 1;
-    while (H - L > 1) {
-      int M = (L + H) >> 1;
-      if (BucketSize[M] == F)
-        return M;
-      if (BucketSize[M] > F)
-        H = M - 1;
-      else
-        L = M;
-    }
+    int L = 0;
+    for (size_t S = F >> 2; S && L < NumBuckets - 1; S >>= 1)
+      ++L;
 
     assert(L >= 0 && L < NumBuckets && "L is out of range");
 
@@ -126,6 +127,20 @@ class MemoryManagerTy {
   /// The reference to a device allocator
   DeviceAllocatorTy &DeviceAllocator;
 
+  /// Statistics reported by \p printStatistics
+  struct StatisticsTy {
+    /// Requests served from the free lists
+    std::atomic<size_t> NumHits{0};
+    /// Managed requests that had to be allocated on the device
+    std::atomic<size_t> NumMisses{0};
+    /// Requests larger than the threshold, allocated on the device directly
+    std::atomic<size_t> NumUnmanaged{0};
+    /// Times the free lists were emptied because the device was out of memory
+    std::atomic<size_t> NumFlushes{0};
+    /// Bytes currently sitting in the free lists
+    std::atomic<size_t> CachedBytes{0};
+  } Stats;
+
   /// The threshold to manage memory using memory manager. If the request size
   /// is larger than \p SizeThreshold, the allocation will not be managed by the
   /// memory manager.
@@ -145,6 +160,8 @@ class MemoryManagerTy {
   void *freeAndAllocate(size_t Size, void *HstPtr) {
     std::vector<void *> RemoveList;
 
+    ++Stats.NumFlushes;
+
     // Deallocate all memory in FreeList
     for (int I = 0; I < NumBuckets; ++I) {
       FreeListTy &List = FreeLists[I];
@@ -154,6 +171,7 @@ class MemoryManagerTy {
       for (const NodeTy &N : List) {
         deleteOnDevice(N.Ptr);
         RemoveList.push_back(N.Ptr);
+        Stats.CachedBytes -= N.Size;
       }
       FreeLists[I].clear();
     }
@@ -227,6 +245,7 @@ public:
          "device\n",
          Size, SizeThreshold);
       void *TgtPtr = allocateOrFreeAndAllocateOnDevice(Size, HstPtr);
+      ++Stats.NumUnmanaged;
 
       DP("Got target pointer " DPxMOD ". Return directly.\n", DPxPTR(TgtPtr));
 
@@ -235,14 +254,16 @@ public:
 
     NodeTy *NodePtr = nullptr;
 
-    // Try to get a node from FreeList
+    // Try to get a node from FreeList. Except in the last bucket, all nodes
+    // are less than twice as large as the request, so take the smallest one
+    // that fits.
     {
       const int B = findBucket(Size);
       FreeListTy &List = FreeLists[B];
 
       NodeTy TempNode(Size, nullptr);
       std::lock_guard<std::mutex> LG(FreeListLocks[B]);
-      const auto Itr = List.find(TempNode);
+      const auto Itr = List.lower_bound(TempNode);
 
       if (Itr != List.end()) {
         NodePtr = &Itr->get();
@@ -250,8 +271,11 @@ public:
       }
     }
 
-    if (NodePtr != nullptr)
+    if (NodePtr != nullptr) {
       DP("Find one node " DPxMOD " in the bucket.\n", DPxPTR(NodePtr));
+      ++Stats.NumHits;
+      Stats.CachedBytes -= NodePtr->Size;
+    }
 
     // We cannot find a valid node in FreeLists. Let's allocate on device and
     // create a node for it.
@@ -262,6 +286,7 @@ public:
 
       if (TgtPtr == nullptr)
         return nullptr;
+      ++Stats.NumMisses;
 
       // Create a new node and add it into the map table
       {
@@ -311,10 +336,23 @@ public:
       std::lock_guard<std::mutex> G(FreeListLocks[B]);
       FreeLists[B].insert(*P);
     }
+    Stats.CachedBytes += P->Size;
 
     return OFFLOAD_SUCCESS;
   }
 
+  /// Print how well the memory manager of device \p DeviceId did, if
+  /// LIBOMPTARGET_INFO has \p OMP_INFOTYPE_MEMORY_MANAGER set.
+  void printStatistics(int DeviceId) const {
+    const size_t Managed = Stats.NumHits + Stats.NumMisses;
+    INFO(OMP_INFOTYPE_MEMORY_MANAGER, DeviceId,
+         "Memory manager: %zu of %zu managed allocations reused freed memory, "
+         "%zu allocations above the threshold of %zu bytes, %zu flushes, %zu "
+         "bytes cached\n",
+         Stats.NumHits.load(), Managed, Stats.NumUnmanaged.load(),
+         SizeThreshold, Stats.NumFlushes.load(), Stats.CachedBytes.load());
+  }
+
   /// Get the size threshold from the environment variable
   /// \p LIBOMPTARGET_MEMORY_MANAGER_THRESHOLD . Returns a <tt>
   /// std::pair<size_t, bool> </tt> where the first element represents the
@@ -340,7 +378,7 @@ public:
 
 // GCC still cannot handle the static data member like Clang so we still need
 // this part.
-constexpr const size_t MemoryManagerTy::BucketSize[];
+constexpr const int MemoryManagerTy::MaxBucketLog;
 constexpr const int MemoryManagerTy::NumBuckets;
 
 #endif // LLVM_OPENMP_LIBOMPTARGET_PLUGINS_COMMON_MEMORYMANAGER_MEMORYMANAGER_H
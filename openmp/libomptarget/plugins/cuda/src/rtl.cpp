@@ -560,8 +560,10 @@ public:
   ~DeviceRTLTy() {
     // We first destruct memory managers in case that its dependent data are
     // destroyed before it.
-    for (auto &M : MemoryManagers)
-      M.release();
+    for (size_t I = 0; I < MemoryManagers.size(); ++I) {
+      MemoryManagers[I]->printStatistics(I);
+      MemoryManagers[I].release();
+    }
 
     for (CUmodule &M : Modules)
       // Close module
@@ -613,6 +613,30 @@ struct DeallocTgtPtrInfo {
       : HstPtrBegin(HstPtr), DataSize(Size), HasHoldModifier(HasHoldModifier) {}
 };
 
+/// A host pointer whose original value has to be put back once the
+/// device-to-host copy of the object containing it has completed.
+struct ShadowPtrRestoreInfo {
+  /// Address of the host pointer
+  void **HstPtrAddr;
+  /// Original value of the host pointer
+  void *HstPtrVal;
+
+  ShadowPtrRestoreInfo(void **HstPtrAddr, void *HstPtrVal)
+      : HstPtrAddr(HstPtrAddr), HstPtrVal(HstPtrVal) {}
+};
+
+/// Restore the host pointers in \p ShadowPtrs. This must only be called after
+/// the copies overwriting them have been synchronized.
+static void restoreShadowPtrs(std::vector<ShadowPtrRestoreInfo> &ShadowPtrs) {
+  for (ShadowPtrRestoreInfo &Info : ShadowPtrs) {
+    *Info.HstPtrAddr = Info.HstPtrVal;
+    DP("Restoring original host pointer value " DPxMOD " for host "
+       "pointer " DPxMOD "\n",
+       DPxPTR(Info.HstPtrVal), DPxPTR(Info.HstPtrAddr));
+  }
+  ShadowPtrs.clear();
+}
+
 /// Apply \p CB to the shadow map pointer entries in the range \p Begin, to
 /// \p Begin + \p Size. \p CB is called with a locked shadow pointer map and the
 /// passed iterator can be updated. If the callback returns OFFLOAD_FAIL the
@@ -664,6 +688,7 @@ int targetDataEnd(ident_t *loc, DeviceTy &Device, int32_t ArgNum,
                   void **ArgMappers, AsyncInfoTy &AsyncInfo, bool FromMapper) {
   int Ret;
   std::vector<DeallocTgtPtrInfo> DeallocTgtPtrs;
+  std::vector<ShadowPtrRestoreInfo> ShadowPtrs;
   void *FromMapperBase = nullptr;
   // process each input.
   for (int32_t I = ArgNum - 1; I >= 0; --I) {
@@ -796,21 +821,16 @@ int targetDataEnd(ident_t *loc, DeviceTy &Device, int32_t ArgNum,
 
       // If we copied back to the host a struct/array containing pointers, we
       // need to restore the original host pointer values from their shadow
-      // copies. If the struct is going to be deallocated, remove any remaining
-      // shadow pointer entries for this struct.
+      // copies. This can only be done once the device-to-host copies have
+      // completed, so record them and restore them all after the
+      // synchronization below rather than waiting for each of them, with the
+      // shadow map locked, while later copies could already be in flight. If
+      // the struct is going to be deallocated, remove any remaining shadow
+      // pointer entries for this struct.
       auto CB = [&](ShadowPtrListTy::iterator &Itr) {
         // If we copied the struct to the host, we need to restore the pointer.
-        if (ArgTypes[I] & OMP_TGT_MAPTYPE_FROM) {
-          void **ShadowHstPtrAddr = (void **)Itr->first;
-          // Wait for device-to-host memcopies for whole struct to complete,
-          // before restoring the correct host pointer.
-          if (AsyncInfo.synchronize() != OFFLOAD_SUCCESS)
-            return OFFLOAD_FAIL;
-          *ShadowHstPtrAddr = Itr->second.HstPtrVal;
-          DP("Restoring original host pointer value " DPxMOD " for host "
-             "pointer " DPxMOD "\n",
-             DPxPTR(Itr->second.HstPtrVal), DPxPTR(ShadowHstPtrAddr));
-        }
+        if (ArgTypes[I] & OMP_TGT_MAPTYPE_FROM)
+          ShadowPtrs.emplace_back((void **)Itr->first, Itr->second.HstPtrVal);
         // If the struct is to be deallocated, remove the shadow entry.
         if (DelEntry) {
           DP("Removing shadow pointer " DPxMOD "\n",
@@ -837,6 +857,8 @@ int targetDataEnd(ident_t *loc, DeviceTy &Device, int32_t ArgNum,
   if (Ret != OFFLOAD_SUCCESS)
     return OFFLOAD_FAIL;
 
+  restoreShadowPtrs(ShadowPtrs);
+
   // Deallocate target pointer
   for (DeallocTgtPtrInfo &Info : DeallocTgtPtrs) {
     if (FromMapperBase && FromMapperBase == Info.HstPtrBegin)
@@ -887,20 +909,22 @@ static int targetDataContiguous(ident_t *loc, DeviceTy &Device, void *ArgsBase,
       return OFFLOAD_FAIL;
     }
 
+    std::vector<ShadowPtrRestoreInfo> ShadowPtrs;
     auto CB = [&](ShadowPtrListTy::iterator &Itr) {
-      void **ShadowHstPtrAddr = (void **)Itr->first;
-      // Wait for device-to-host memcopies for whole struct to complete,
-      // before restoring the correct host pointer.
-      if (AsyncInfo.synchronize() != OFFLOAD_SUCCESS)
-        return OFFLOAD_FAIL;
-      *ShadowHstPtrAddr = Itr->second.HstPtrVal;
-      DP("Restoring original host pointer value " DPxMOD
-         " for host pointer " DPxMOD "\n",
-         DPxPTR(Itr->second.HstPtrVal), DPxPTR(ShadowHstPtrAddr));
+      ShadowPtrs.emplace_back((void **)Itr->first, Itr->second.HstPtrVal);
       ++Itr;
       return OFFLOAD_SUCCESS;
     };
     applyToShadowMapEntries(Device, CB, HstPtrBegin, ArgSize, TPR);
+
+    // Wait for device-to-host memcopies for whole struct to complete, before
+    // restoring the correct host pointers. Only a single wait is needed for
+    // all of them, and none if the struct does not contain pointers.
+    if (!ShadowPtrs.empty()) {
+      if (AsyncInfo.synchronize() != OFFLOAD_SUCCESS)
+        return OFFLOAD_FAIL;
+      restoreShadowPtrs(ShadowPtrs);
+    }
   }
 
   if (ArgType & OMP_TGT_MAPTYPE_TO) {
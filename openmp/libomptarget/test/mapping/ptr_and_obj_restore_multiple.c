@@ -0,0 +1,42 @@
+// RUN: %libomptarget-compile-run-and-check-generic
+
+// Check that the host pointers of several structs copied back in the same
+// construct all get their original value back, both on a target exit data and
+// on a target update.
+
+#include <stdio.h>
+
+typedef struct {
+  int *ptr;
+  int val;
+} S;
+
+int main() {
+  int a[4] = {0, 0, 0, 0};
+  int b[4] = {0, 0, 0, 0};
+  S s1 = {a, 1};
+  S s2 = {b, 2};
+
+#pragma omp target enter data map(to : s1, s2) map(to : s1.ptr[0 : 4])        \
+    map(to : s2.ptr[0 : 4])
+
+#pragma omp target
+  {
+    s1.val += 10;
+    s2.val += 20;
+    s1.ptr[1] = 1;
+    s2.ptr[2] = 2;
+  }
+
+#pragma omp target update from(s1, s2)
+  // CHECK: update: 1 1 11 22
+  printf("update: %d %d %d %d\n", s1.ptr == a, s2.ptr == b, s1.val, s2.val);
+
+#pragma omp target exit data map(from : s1.ptr[0 : 4], s2.ptr[0 : 4])        \
+    map(from : s1, s2)
+
+  // CHECK: exit: 1 1 11 22 1 2
+  printf("exit: %d %d %d %d %d %d\n", s1.ptr == a, s2.ptr == b, s1.val, s2.val,
+         a[1], b[2]);
+  return 0;
+}
@@ -1,4 +1,7 @@
 // RUN: %libomptarget-compilexx-run-and-check-generic
+// RUN: %libomptarget-compilexx-generic && \
+// RUN:   env LIBOMPTARGET_MEMORY_MANAGER_THRESHOLD=1048576 \
+// RUN:   %libomptarget-run-generic | %fcheck-generic
 
 // UNSUPPORTED: x86_64-pc-linux-gnu
 // UNSUPPORTED: x86_64-pc-linux-gnu-newDriver
@@ -838,6 +838,9 @@ extern int __kmp_affinity_respect_mask; // Respect process' init affinity mask?
 extern char *__kmp_affinity_proclist; /* proc ID list */
 extern kmp_affin_mask_t *__kmp_affinity_masks;
 extern unsigned __kmp_affinity_num_masks;
+// Index of the __kmp_task_stealing_domain item each place belongs to, NULL
+// when task stealing is not topology aware
+extern int *__kmp_affinity_place_domains;
 extern void __kmp_affinity_bind_thread(int which);
 
 extern kmp_affin_mask_t *__kmp_affin_fullMask;
@@ -2255,6 +2258,8 @@ typedef enum kmp_tasking_mode {
 extern kmp_tasking_mode_t
     __kmp_tasking_mode; /* determines how/when to execute tasks */
 extern int __kmp_task_stealing_constraint;
+extern kmp_hw_t __kmp_task_stealing_domain; /* Topology layer to steal within */
+extern int __kmp_task_stealing_local_attempts;
 extern int __kmp_enable_task_throttling;
 extern kmp_int32 __kmp_default_device; // Set via OMP_DEFAULT_DEVICE if
 // specified, defaults to 0 otherwise
@@ -3066,6 +3071,8 @@ extern kmp_uint32 __kmp_barrier_gather_branch_bits[bs_last_barrier];
 extern kmp_uint32 __kmp_barrier_release_branch_bits[bs_last_barrier];
 extern kmp_bar_pat_e __kmp_barrier_gather_pattern[bs_last_barrier];
 extern kmp_bar_pat_e __kmp_barrier_release_pattern[bs_last_barrier];
+extern int __kmp_env_barrier_branch_bits[bs_last_barrier]; /* set by user? */
+extern int __kmp_barrier_auto_tune; /* tune branch bits to the machine? */
 extern char const *__kmp_barrier_branch_bit_env_name[bs_last_barrier];
 extern char const *__kmp_barrier_pattern_env_name[bs_last_barrier];
 extern char const *__kmp_barrier_type_name[bs_last_barrier];
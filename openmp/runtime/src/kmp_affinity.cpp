@@ -4475,6 +4475,68 @@ static void __kmp_aux_affinity_initialize(void) {
   KMP_CPU_FREE_ARRAY(osId2Mask, maxIndex + 1);
 }
 
+// Record which item of the __kmp_task_stealing_domain layer (e.g., which NUMA
+// domain or last level cache) each place belongs to, so that a thread looking
+// for tasks to steal can prefer victims that share it. A place spanning several
+// items is attributed to the one containing its first OS proc.
+static void __kmp_affinity_init_place_domains() {
+  KMP_DEBUG_ASSERT(__kmp_affinity_place_domains == NULL);
+  if (__kmp_task_stealing_domain == KMP_HW_UNKNOWN ||
+      __kmp_affinity_type == affinity_none || __kmp_affinity_num_masks < 2 ||
+      __kmp_topology == NULL)
+    return;
+  int level = __kmp_topology->get_level(__kmp_task_stealing_domain);
+  if (level < 0) {
+    if (__kmp_affinity_warnings)
+      KMP_WARNING(StgInvalidValue, "KMP_TASK_STEALING_DOMAIN",
+                  __kmp_hw_get_keyword(__kmp_task_stealing_domain));
+    return;
+  }
+  int num_hw_threads = __kmp_topology->get_num_hw_threads();
+  // Hardware thread representing each place, -1 if it could not be found
+  size_t size = sizeof(int) * __kmp_affinity_num_masks;
+  int *place_hwt = (int *)__kmp_allocate(size);
+  int *domains = (int *)__kmp_allocate(size);
+  int num_domains = 0;
+  for (unsigned p = 0; p < __kmp_affinity_num_masks; ++p) {
+    kmp_affin_mask_t *mask = KMP_CPU_INDEX(__kmp_affinity_masks, p);
+    int os_id = mask->begin();
+    place_hwt[p] = -1;
+    for (int i = 0; i < num_hw_threads; ++i) {
+      if (__kmp_topology->at(i).os_id == os_id) {
+        place_hwt[p] = i;
+        break;
+      }
+    }
+    domains[p] = -1;
+    if (place_hwt[p] < 0)
+      continue;
+    const kmp_hw_thread_t &hwt = __kmp_topology->at(place_hwt[p]);
+    for (unsigned q = 0; q < p && domains[p] < 0; ++q) {
+      if (place_hwt[q] < 0)
+        continue;
+      const kmp_hw_thread_t &other = __kmp_topology->at(place_hwt[q]);
+      bool same = true;
+      for (int l = 0; l <= level && same; ++l)
+        same = (hwt.ids[l] == other.ids[l]);
+      if (same)
+        domains[p] = domains[q];
+    }
+    if (domains[p] < 0)
+      domains[p] = num_domains++;
+  }
+  __kmp_free(place_hwt);
+  // A single domain means every victim is local, so don't bother
+  if (num_domains < 2) {
+    __kmp_free(domains);
+    return;
+  }
+  KA_TRACE(10, ("__kmp_affinity_init_place_domains: %u places in %d %s\n",
+                __kmp_affinity_num_masks, num_domains,
+                __kmp_hw_get_keyword(__kmp_task_stealing_domain, true)));
+  __kmp_affinity_place_domains = domains;
+}
+
 void __kmp_affinity_initialize(void) {
   // Much of the code above was written assuming that if a machine was not
   // affinity capable, then __kmp_affinity_type == affinity_none.  We now
@@ -4492,6 +4554,7 @@ void __kmp_affinity_initialize(void) {
     __kmp_affinity_type = affinity_none;
   }
   __kmp_aux_affinity_initialize();
+  __kmp_affinity_init_place_domains();
   if (disabled) {
     __kmp_affinity_type = affinity_disabled;
   }
@@ -4502,6 +4565,10 @@ void __kmp_affinity_uninitialize(void) {
     KMP_CPU_FREE_ARRAY(__kmp_affinity_masks, __kmp_affinity_num_masks);
     __kmp_affinity_masks = NULL;
   }
+  if (__kmp_affinity_place_domains != NULL) {
+    __kmp_free(__kmp_affinity_place_domains);
+    __kmp_affinity_place_domains = NULL;
+  }
   if (__kmp_affin_fullMask != NULL) {
     KMP_CPU_FREE(__kmp_affin_fullMask);
     __kmp_affin_fullMask = NULL;
@@ -90,6 +90,8 @@ kmp_uint32 __kmp_barrier_gather_branch_bits[bs_last_barrier] = {0};
 kmp_uint32 __kmp_barrier_release_branch_bits[bs_last_barrier] = {0};
 kmp_bar_pat_e __kmp_barrier_gather_pattern[bs_last_barrier] = {bp_linear_bar};
 kmp_bar_pat_e __kmp_barrier_release_pattern[bs_last_barrier] = {bp_linear_bar};
+int __kmp_env_barrier_branch_bits[bs_last_barrier] = {FALSE};
+int __kmp_barrier_auto_tune = TRUE;
 char const *__kmp_barrier_branch_bit_env_name[bs_last_barrier] = {
     "KMP_PLAIN_BARRIER", "KMP_FORKJOIN_BARRIER"
 #if KMP_FAST_REDUCTION_BARRIER
@@ -281,6 +283,7 @@ int __kmp_affinity_respect_mask = affinity_respect_mask_default;
 char *__kmp_affinity_proclist = NULL;
 kmp_affin_mask_t *__kmp_affinity_masks = NULL;
 unsigned __kmp_affinity_num_masks = 0;
+int *__kmp_affinity_place_domains = NULL;
 
 char *__kmp_cpuinfo_file = NULL;
 
@@ -353,6 +356,8 @@ omp_memspace_handle_t const llvm_omp_target_device_mem_space =
 KMP_BUILD_ASSERT(sizeof(kmp_tasking_flags_t) == 4);
 
 int __kmp_task_stealing_constraint = 1; /* Constrain task stealing by default */
+kmp_hw_t __kmp_task_stealing_domain = KMP_HW_UNKNOWN; /* Steal from anyone */
+int __kmp_task_stealing_local_attempts = 4;
 int __kmp_enable_task_throttling = 1;
 
 #ifdef DEBUG_SUSPEND
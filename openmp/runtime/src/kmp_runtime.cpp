@@ -7240,6 +7240,33 @@ void __kmp_serial_initialize(void) {
   __kmp_release_bootstrap_lock(&__kmp_initz_lock);
 }
 
+// Widen the plain and fork/join gather trees on large machines. A tree or
+// hypercube gather over n threads with b branch bits takes ceil(log2(n) / b)
+// rounds of cache line transfers, and the default of 2 bits, tuned for a few
+// dozen threads, makes a full team of a large machine go through 4 rounds or
+// more. Pick the branch bits so that a full team needs about 3 of them, which
+// keeps the number of children each parent polls at 16 or less. Barriers whose
+// branch bits were set through the environment are left alone, as is the
+// release side, where wider trees delay the wakeup of the last children.
+static void __kmp_tune_barrier_branch_bits() {
+  if (!__kmp_barrier_auto_tune || __kmp_avail_proc <= 0)
+    return;
+  kmp_uint32 log2_nproc = 0;
+  while ((1 << log2_nproc) < __kmp_avail_proc)
+    ++log2_nproc;
+  kmp_uint32 bits = KMP_MIN((log2_nproc + 2) / 3, 4);
+  for (int i = bs_plain_barrier; i <= bs_forkjoin_barrier; i++) {
+    if (__kmp_env_barrier_branch_bits[i] ||
+        bits <= __kmp_barrier_gather_branch_bits[i])
+      continue;
+    KA_TRACE(10, ("__kmp_tune_barrier_branch_bits: %s gather branch bits %u "
+                  "-> %u for %d procs\n",
+                  __kmp_barrier_type_name[i],
+                  __kmp_barrier_gather_branch_bits[i], bits, __kmp_avail_proc));
+    __kmp_barrier_gather_branch_bits[i] = bits;
+  }
+}
+
 static void __kmp_do_middle_initialize(void) {
   int i, j;
   int prev_dflt_team_nth;
@@ -7266,6 +7293,8 @@ static void __kmp_do_middle_initialize(void) {
     __kmp_avail_proc = __kmp_xproc;
   }
 
+  __kmp_tune_barrier_branch_bits();
+
   // If there were empty places in num_threads list (OMP_NUM_THREADS=,,2,3),
   // correct them now
   j = 0;
@@ -1654,6 +1654,7 @@ static void __kmp_stg_parse_barrier_branch_bit(char const *name,
     if ((strcmp(var, name) == 0) && (value != 0)) {
       char *comma;
 
+      __kmp_env_barrier_branch_bits[i] = TRUE;
       comma = CCAST(char *, strchr(value, ','));
       __kmp_barrier_gather_branch_bits[i] =
           (kmp_uint32)__kmp_str_to_int(value, ',');
@@ -1702,6 +1703,19 @@ static void __kmp_stg_print_barrier_branch_bit(kmp_str_buf_t *buffer,
   }
 } // __kmp_stg_print_barrier_branch_bit
 
+// -----------------------------------------------------------------------------
+// KMP_BARRIER_AUTO_TUNE
+
+static void __kmp_stg_parse_barrier_auto_tune(char const *name,
+                                              char const *value, void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_barrier_auto_tune);
+} // __kmp_stg_parse_barrier_auto_tune
+
+static void __kmp_stg_print_barrier_auto_tune(kmp_str_buf_t *buffer,
+                                              char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_barrier_auto_tune);
+} // __kmp_stg_print_barrier_auto_tune
+
 // ----------------------------------------------------------------------------
 // KMP_PLAIN_BARRIER_PATTERN, KMP_FORKJOIN_BARRIER_PATTERN,
 // KMP_REDUCTION_BARRIER_PATTERN
@@ -5112,6 +5126,50 @@ static void __kmp_stg_print_hw_subset(kmp_str_buf_t *buffer, char const *name,
   __kmp_str_buf_free(&buf);
 }
 
+// -----------------------------------------------------------------------------
+// KMP_TASK_STEALING_DOMAIN, KMP_TASK_STEALING_LOCAL_ATTEMPTS
+// KMP_TASK_STEALING_DOMAIN=numa makes threads prefer stealing tasks from
+// threads bound to the same NUMA domain, and likewise for any other topology
+// layer (e.g., ll_cache, socket). The default, none, steals from anyone.
+
+static void __kmp_stg_parse_task_stealing_domain(char const *name,
+                                                 char const *value,
+                                                 void *data) {
+  if (__kmp_str_match("none", 2, value)) {
+    __kmp_task_stealing_domain = KMP_HW_UNKNOWN;
+    return;
+  }
+  kmp_hw_t type = __kmp_stg_parse_hw_subset_name(value);
+  if (type == KMP_HW_UNKNOWN) {
+    KMP_WARNING(StgInvalidValue, name, value);
+    return;
+  }
+  __kmp_task_stealing_domain = type;
+} // __kmp_stg_parse_task_stealing_domain
+
+static void __kmp_stg_print_task_stealing_domain(kmp_str_buf_t *buffer,
+                                                 char const *name,
+                                                 void *data) {
+  if (__kmp_task_stealing_domain == KMP_HW_UNKNOWN)
+    __kmp_stg_print_str(buffer, name, "none");
+  else
+    __kmp_stg_print_str(buffer, name,
+                        __kmp_hw_get_keyword(__kmp_task_stealing_domain));
+} // __kmp_stg_print_task_stealing_domain
+
+static void __kmp_stg_parse_task_stealing_local_attempts(char const *name,
+                                                         char const *value,
+                                                         void *data) {
+  __kmp_stg_parse_int(name, value, 0, INT_MAX,
+                      &__kmp_task_stealing_local_attempts);
+} // __kmp_stg_parse_task_stealing_local_attempts
+
+static void __kmp_stg_print_task_stealing_local_attempts(kmp_str_buf_t *buffer,
+                                                         char const *name,
+                                                         void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_task_stealing_local_attempts);
+} // __kmp_stg_print_task_stealing_local_attempts
+
 #if USE_ITT_BUILD
 // -----------------------------------------------------------------------------
 // KMP_FORKJOIN_FRAMES
@@ -5347,6 +5405,11 @@ static kmp_setting_t __kmp_stg_table[] = {
      0},
     {"KMP_TASK_STEALING_CONSTRAINT", __kmp_stg_parse_task_stealing,
      __kmp_stg_print_task_stealing, NULL, 0, 0},
+    {"KMP_TASK_STEALING_DOMAIN", __kmp_stg_parse_task_stealing_domain,
+     __kmp_stg_print_task_stealing_domain, NULL, 0, 0},
+    {"KMP_TASK_STEALING_LOCAL_ATTEMPTS",
+     __kmp_stg_parse_task_stealing_local_attempts,
+     __kmp_stg_print_task_stealing_local_attempts, NULL, 0, 0},
     {"OMP_MAX_ACTIVE_LEVELS", __kmp_stg_parse_max_active_levels,
      __kmp_stg_print_max_active_levels, NULL, 0, 0},
     {"OMP_DEFAULT_DEVICE", __kmp_stg_parse_default_device,
@@ -5435,6 +5498,8 @@ static kmp_setting_t __kmp_stg_table[] = {
     {"KMP_REDUCTION_BARRIER_PATTERN", __kmp_stg_parse_barrier_pattern,
      __kmp_stg_print_barrier_pattern, NULL, 0, 0},
 #endif
+    {"KMP_BARRIER_AUTO_TUNE", __kmp_stg_parse_barrier_auto_tune,
+     __kmp_stg_print_barrier_auto_tune, NULL, 0, 0},
 
     {"KMP_ABORT_DELAY", __kmp_stg_parse_abort_delay,
      __kmp_stg_print_abort_delay, NULL, 0, 0},
@@ -113,7 +113,9 @@ enum stats_state_e {
   macro(OMP_TASKLOOP, 0, arg)                                                  \
   macro(TASK_executed, 0, arg)                                                 \
   macro(TASK_cancelled, 0, arg)                                                \
-  macro(TASK_stolen, 0, arg)
+  macro(TASK_stolen, 0, arg)                                                   \
+  macro(TASK_stolen_local, 0, arg)                                             \
+  macro(TASK_stolen_remote, 0, arg)
 // clang-format on
 
 /*!
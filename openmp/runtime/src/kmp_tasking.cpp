@@ -2877,6 +2877,20 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
 // spinner is the location on which to spin.
 // spinner == NULL means only execute a single task and return.
 // checker is the value to check to terminate the spin.
+// Return the topology domain (see KMP_TASK_STEALING_DOMAIN) of the place a
+// thread is bound to, or -1 if it is unknown or stealing is not topology aware.
+static inline int __kmp_task_stealing_domain_of(kmp_info_t *thread) {
+#if KMP_AFFINITY_SUPPORTED
+  int place = thread->th.th_current_place;
+  if (__kmp_affinity_place_domains == NULL || place < 0 ||
+      (unsigned)place >= __kmp_affinity_num_masks)
+    return -1;
+  return __kmp_affinity_place_domains[place];
+#else
+  return -1;
+#endif
+}
+
 template <class C>
 static inline int __kmp_execute_tasks_template(
     kmp_info_t *thread, kmp_int32 gtid, C *flag, int final_spin,
@@ -2890,6 +2904,7 @@ static inline int __kmp_execute_tasks_template(
   std::atomic<kmp_int32> *unfinished_threads;
   kmp_int32 nthreads, victim_tid = -2, use_own_tasks = 1, new_victim = 0,
                       tid = thread->th.th_info.ds.ds_tid;
+  int domain = __kmp_task_stealing_domain_of(thread);
 
   KMP_DEBUG_ASSERT(__kmp_tasking_mode != tskm_immediate_exec);
   KMP_DEBUG_ASSERT(thread == __kmp_threads[gtid]);
@@ -2933,6 +2948,7 @@ static inline int __kmp_execute_tasks_template(
           asleep = 0;
         } else if (!new_victim) { // no recent steals and we haven't already
           // used a new victim; select a random thread
+          int attempts = __kmp_task_stealing_local_attempts;
           do { // Find a different thread to steal work from.
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
@@ -2943,6 +2959,15 @@ static inline int __kmp_execute_tasks_template(
             }
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
+            // When stealing is topology aware, retry a few times to find a
+            // victim in our own domain before settling for a remote one. The
+            // bound keeps remote work reachable when our domain runs dry.
+            // asleep is still set here, so this picks another victim.
+            if (domain >= 0 && attempts > 0 &&
+                __kmp_task_stealing_domain_of(other_thread) != domain) {
+              --attempts;
+              continue;
+            }
             // There is a slight chance that __kmp_enable_tasking() did not wake
             // up all threads waiting at the barrier.  If victim is sleeping,
             // then wake it up. Since we were going to pay the cache miss
@@ -2975,6 +3000,15 @@ static inline int __kmp_execute_tasks_template(
                                   is_constrained);
         }
         if (task != NULL) { // set last stolen to victim
+#if KMP_STATS_ENABLED
+          if (domain >= 0) {
+            if (__kmp_task_stealing_domain_of(other_thread) == domain) {
+              KMP_COUNT_BLOCK(TASK_stolen_local);
+            } else {
+              KMP_COUNT_BLOCK(TASK_stolen_remote);
+            }
+          }
+#endif
           if (threads_data[tid].td.td_deque_last_stolen != victim_tid) {
             threads_data[tid].td.td_deque_last_stolen = victim_tid;
             // The pre-refactored code did not try more than 1 successful new
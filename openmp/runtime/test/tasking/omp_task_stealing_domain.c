@@ -0,0 +1,48 @@
+// RUN: %libomp-compile
+// RUN: env KMP_TASK_STEALING_DOMAIN=none %libomp-run
+// RUN: env KMP_AFFINITY=compact KMP_TASK_STEALING_DOMAIN=socket %libomp-run
+// RUN: env KMP_AFFINITY=compact KMP_TASK_STEALING_DOMAIN=ll_cache %libomp-run
+// RUN: env OMP_PLACES=cores OMP_PROC_BIND=spread KMP_TASK_STEALING_DOMAIN=numa \
+// RUN:     KMP_TASK_STEALING_LOCAL_ATTEMPTS=1 %libomp-run
+// RUN: env KMP_AFFINITY=compact KMP_TASK_STEALING_DOMAIN=core \
+// RUN:     KMP_TASK_STEALING_LOCAL_ATTEMPTS=0 %libomp-run
+// REQUIRES: affinity
+
+// Topology aware task stealing only changes which victims are tried first, so
+// every task must still get executed exactly once, whatever the domain.
+#include <omp.h>
+#include <stdio.h>
+
+#define NUM_TASKS 10000
+
+int main() {
+  int i, executed = 0;
+  int done[NUM_TASKS] = {0};
+
+  #pragma omp parallel
+  #pragma omp single
+  {
+    for (i = 0; i < NUM_TASKS; ++i) {
+      #pragma omp task firstprivate(i) shared(done, executed)
+      {
+        #pragma omp atomic
+        done[i]++;
+        #pragma omp atomic
+        executed++;
+      }
+    }
+  }
+
+  if (executed != NUM_TASKS) {
+    printf("failed: %d tasks executed out of %d\n", executed, NUM_TASKS);
+    return 1;
+  }
+  for (i = 0; i < NUM_TASKS; ++i) {
+    if (done[i] != 1) {
+      printf("failed: task %d executed %d times\n", i, done[i]);
+      return 1;
+    }
+  }
+  printf("passed\n");
+  return 0;
+}
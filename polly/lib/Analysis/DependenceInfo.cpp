@@ -22,10 +22,13 @@
 #include "polly/DependenceInfo.h"
 #include "polly/LinkAllPasses.h"
 #include "polly/Options.h"
+#include "polly/ScopDetectionDiagnostic.h"
 #include "polly/ScopInfo.h"
 #include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLTools.h"
 #include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/Support/Debug.h"
 #include "isl/aff.h"
 #include "isl/ctx.h"
@@ -41,6 +44,9 @@ using namespace llvm;
 
 #define DEBUG_TYPE "polly-dependence"
 
+STATISTIC(DependencesOutOfQuota,
+          "Number of dependence analyses that exceeded max_operations");
+
 static cl::opt<int> OptComputeOut(
     "polly-dependences-computeout",
     cl::desc("Bound the dependence analysis by a maximal amount of "
@@ -486,6 +492,15 @@ void Dependences::calculateDependences(Scop &S) {
     isl_union_map_free(StrictWAW);
     RAW = WAW = WAR = StrictWAW = nullptr;
     isl_ctx_reset_error(IslCtx.get());
+
+    DependencesOutOfQuota++;
+    LLVM_DEBUG(dbgs() << "Dependence analysis exceeded max_operations\n");
+    DebugLoc Begin, End;
+    getDebugLocations(getBBPairForRegion(&S.getRegion()), Begin, End);
+    OptimizationRemarkAnalysis R(DEBUG_TYPE, "OutOfQuota", Begin,
+                                 S.getEntry());
+    R << "maximal number of operations exceeded during dependence analysis";
+    S.getFunction().getContext().diagnose(R);
   }
 
   // Drop out early, as the remaining computations are only needed for
@@ -52,6 +52,8 @@
 #include "polly/MatmulOptimizer.h"
 #include "polly/Options.h"
 #include "polly/ScheduleTreeTransform.h"
+#include "polly/ScopDetectionDiagnostic.h"
+#include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLOStream.h"
 #include "polly/Support/ISLTools.h"
 #include "llvm/ADT/Sequence.h"
@@ -190,6 +192,12 @@ static cl::opt<bool>
                             "tiling (requires -polly-reschedule)"),
                    cl::init(true), cl::ZeroOrMore, cl::cat(PollyCategory));
 
+static cl::opt<int> ScheduleComputeOut(
+    "polly-schedule-computeout",
+    cl::desc("Bound the scheduler by a maximal amount of computational steps "
+             "(0 means no bound)"),
+    cl::Hidden, cl::init(300000), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 static cl::opt<bool> OptimizedScops(
     "polly-optimized-scops",
     cl::desc("Polly - Dump polyhedral description of Scops optimized with "
@@ -199,6 +207,8 @@ static cl::opt<bool> OptimizedScops(
 
 STATISTIC(ScopsProcessed, "Number of scops processed");
 STATISTIC(ScopsRescheduled, "Number of scops rescheduled");
+STATISTIC(ScopsScheduleComputeOut,
+          "Number of scops whose rescheduling exceeded max_operations");
 STATISTIC(ScopsOptimized, "Number of scops optimized");
 
 STATISTIC(NumAffineLoopsOptimized, "Number of affine loops optimized");
@@ -842,7 +852,26 @@ static bool runIslScheduleOptimizer(
     SC = SC.set_proximity(Proximity);
     SC = SC.set_validity(Validity);
     SC = SC.set_coincidence(Validity);
-    Schedule = SC.compute_schedule();
+
+    {
+      IslMaxOperationsGuard MaxOpGuard(Ctx, ScheduleComputeOut);
+      Schedule = SC.compute_schedule();
+
+      if (MaxOpGuard.hasQuotaExceeded()) {
+        ScopsScheduleComputeOut++;
+        LLVM_DEBUG(dbgs() << "Schedule optimizer calculation exceeds ISL "
+                             "quota\n");
+        if (ORE) {
+          DebugLoc Begin, End;
+          getDebugLocations(getBBPairForRegion(&S.getRegion()), Begin, End);
+          ORE->emit(OptimizationRemarkAnalysis(DEBUG_TYPE, "OutOfQuota", Begin,
+                                               S.getEntry())
+                    << "maximal number of operations exceeded during "
+                       "rescheduling; keeping the original schedule");
+        }
+        Schedule = {};
+      }
+    }
     isl_options_set_on_error(Ctx, OnErrorStatus);
 
     ScopsRescheduled++;
@@ -0,0 +1,676 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_STD_THREAD_H
+#define _PSTL_PARALLEL_BACKEND_STD_THREAD_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel_backend_utils.h"
+#include "pstl_config.h"
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __std_thread_backend
+{
+
+//------------------------------------------------------------------------
+// thread pool
+//------------------------------------------------------------------------
+
+// A unit of work forked by __parallel_invoke. The task lives on the stack of
+// the thread that forked it, which waits for it to be done before returning.
+struct __task
+{
+    void (*__execute_)(__task*);
+    std::atomic<bool> __done_{false};
+    std::exception_ptr __exception_;
+
+    void
+    __run()
+    {
+        try
+        {
+            __execute_(this);
+        }
+        catch (...)
+        {
+            __exception_ = std::current_exception();
+        }
+        __done_.store(true, std::memory_order_release);
+    }
+};
+
+template <typename _Fp>
+struct __task_impl : __task
+{
+    _Fp& __f_;
+
+    explicit __task_impl(_Fp& __f) : __f_(__f) { __execute_ = &__task_impl::__execute; }
+
+    static void
+    __execute(__task* __t)
+    {
+        static_cast<__task_impl*>(__t)->__f_();
+    }
+};
+
+// A process wide pool of hardware_concurrency() - 1 worker threads. The
+// thread waiting for a task runs the queued tasks in the meantime, so nested
+// parallelism does not deadlock, and the waiting thread contributes to the
+// work.
+class __thread_pool
+{
+    std::mutex __mutex_;
+    std::condition_variable __cv_;
+    std::deque<__task*> __queue_;
+    std::vector<std::thread> __workers_;
+    bool __stop_ = false;
+
+    __thread_pool()
+    {
+        unsigned __n = std::thread::hardware_concurrency();
+        for (unsigned __i = 1; __i < __n; ++__i)
+        {
+            try
+            {
+                __workers_.emplace_back([this] { __worker_loop(); });
+            }
+            catch (...)
+            {
+                // Run with the workers we could start, possibly none.
+                break;
+            }
+        }
+    }
+
+    ~__thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __stop_ = true;
+        }
+        __cv_.notify_all();
+        for (std::thread& __worker : __workers_)
+            __worker.join();
+    }
+
+    void
+    __worker_loop()
+    {
+        for (;;)
+        {
+            __task* __t;
+            {
+                std::unique_lock<std::mutex> __lock(__mutex_);
+                __cv_.wait(__lock, [this] { return __stop_ || !__queue_.empty(); });
+                if (__queue_.empty())
+                    return;
+                __t = __queue_.front();
+                __queue_.pop_front();
+            }
+            __t->__run();
+        }
+    }
+
+    __task*
+    __try_pop_any()
+    {
+        std::lock_guard<std::mutex> __lock(__mutex_);
+        if (__queue_.empty())
+            return nullptr;
+        __task* __t = __queue_.back();
+        __queue_.pop_back();
+        return __t;
+    }
+
+  public:
+    __thread_pool(const __thread_pool&) = delete;
+    __thread_pool&
+    operator=(const __thread_pool&) = delete;
+
+    static __thread_pool&
+    __get()
+    {
+        static __thread_pool __pool;
+        return __pool;
+    }
+
+    // The number of threads that run tasks, including the caller.
+    std::size_t
+    __concurrency() const
+    {
+        return __workers_.size() + 1;
+    }
+
+    void
+    __push(__task* __t)
+    {
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __queue_.push_back(__t);
+        }
+        __cv_.notify_one();
+    }
+
+    // Takes __t back out of the queue if no thread started running it yet.
+    bool
+    __try_pop(__task* __t)
+    {
+        std::lock_guard<std::mutex> __lock(__mutex_);
+        auto __it = std::find(__queue_.rbegin(), __queue_.rend(), __t);
+        if (__it == __queue_.rend())
+            return false;
+        __queue_.erase(std::next(__it).base());
+        return true;
+    }
+
+    void
+    __wait(__task* __t)
+    {
+        while (!__t->__done_.load(std::memory_order_acquire))
+        {
+            if (__task* __other = __try_pop_any())
+                __other->__run();
+            else
+                std::this_thread::yield();
+        }
+    }
+};
+
+inline std::size_t
+__concurrency()
+{
+    return __thread_pool::__get().__concurrency();
+}
+
+// The ranges are split in about four chunks per thread, to balance the load
+// while keeping the number of tasks low.
+template <typename _Size>
+_Size
+__chunk_size(_Size __n)
+{
+    const _Size __chunks = static_cast<_Size>(4 * __concurrency());
+    return std::max<_Size>((__n + __chunks - 1) / __chunks, 1);
+}
+
+// Ranges this small are sorted and merged serially.
+inline constexpr std::size_t __default_sort_chunk_size = 2048;
+
+//------------------------------------------------------------------------
+// use to cancel execution
+//------------------------------------------------------------------------
+inline void
+__cancel_execution()
+{
+}
+
+//------------------------------------------------------------------------
+// raw buffer
+//------------------------------------------------------------------------
+
+template <typename _Tp>
+class __buffer
+{
+    std::allocator<_Tp> __allocator_;
+    _Tp* __ptr_;
+    const std::size_t __buf_size_;
+    __buffer(const __buffer&) = delete;
+    void
+    operator=(const __buffer&) = delete;
+
+  public:
+    __buffer(std::size_t __n) : __allocator_(), __ptr_(__allocator_.allocate(__n)), __buf_size_(__n) {}
+
+    operator bool() const { return __ptr_ != nullptr; }
+    _Tp*
+    get() const
+    {
+        return __ptr_;
+    }
+    ~__buffer() { __allocator_.deallocate(__ptr_, __buf_size_); }
+};
+
+//------------------------------------------------------------------------
+// parallel_invoke
+//------------------------------------------------------------------------
+
+template <typename _F1, typename _F2>
+void
+__parallel_invoke_body(_F1&& __f1, _F2&& __f2)
+{
+    __thread_pool& __pool = __thread_pool::__get();
+    if (__pool.__concurrency() == 1)
+    {
+        std::forward<_F1>(__f1)();
+        std::forward<_F2>(__f2)();
+        return;
+    }
+
+    __task_impl<std::remove_reference_t<_F2>> __t(__f2);
+    __pool.__push(&__t);
+    std::exception_ptr __exception;
+    try
+    {
+        std::forward<_F1>(__f1)();
+    }
+    catch (...)
+    {
+        __exception = std::current_exception();
+    }
+    // Run the second function here unless another thread picked it up.
+    if (__pool.__try_pop(&__t))
+        __t.__run();
+    else
+        __pool.__wait(&__t);
+
+    if (__exception)
+        std::rethrow_exception(__exception);
+    if (__t.__exception_)
+        std::rethrow_exception(__t.__exception_);
+}
+
+template <class _ExecutionPolicy, typename _F1, typename _F2>
+void
+__parallel_invoke(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _F1&& __f1, _F2&& __f2)
+{
+    __std_thread_backend::__parallel_invoke_body(std::forward<_F1>(__f1), std::forward<_F2>(__f2));
+}
+
+//------------------------------------------------------------------------
+// parallel_for
+//------------------------------------------------------------------------
+
+template <class _Index, class _Fp>
+void
+__parallel_for_body(_Index __first, _Index __last, _Fp& __f, std::size_t __grain)
+{
+    if (static_cast<std::size_t>(__last - __first) <= __grain)
+    {
+        __f(__first, __last);
+        return;
+    }
+    _Index __middle = __first + ((__last - __first) / 2);
+    __std_thread_backend::__parallel_invoke_body(
+        [&]() { __std_thread_backend::__parallel_for_body(__first, __middle, __f, __grain); },
+        [&]() { __std_thread_backend::__parallel_for_body(__middle, __last, __f, __grain); });
+}
+
+//------------------------------------------------------------------------
+// Notation:
+// Evaluation of brick f[i,j) for each subrange [i,j) of [first, last)
+//------------------------------------------------------------------------
+
+template <class _ExecutionPolicy, class _Index, class _Fp>
+void
+__parallel_for(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _Index __first, _Index __last,
+               _Fp __f)
+{
+    if (__first == __last)
+        return;
+    std::size_t __n = __last - __first;
+    __std_thread_backend::__parallel_for_body(__first, __last, __f, __std_thread_backend::__chunk_size(__n));
+}
+
+//------------------------------------------------------------------------
+// parallel_reduce
+//------------------------------------------------------------------------
+
+template <class _Index, class _Value, typename _RealBody, typename _Reduction>
+_Value
+__parallel_reduce_body(_Index __first, _Index __last, const _Value& __identity, const _RealBody& __real_body,
+                       const _Reduction& __reduction, std::size_t __grain)
+{
+    if (static_cast<std::size_t>(__last - __first) <= __grain)
+        return __real_body(__first, __last, __identity);
+
+    _Index __middle = __first + ((__last - __first) / 2);
+    _Value __v1(__identity), __v2(__identity);
+    __std_thread_backend::__parallel_invoke_body(
+        [&]() {
+            __v1 = __std_thread_backend::__parallel_reduce_body(__first, __middle, __identity, __real_body,
+                                                                __reduction, __grain);
+        },
+        [&]() {
+            __v2 = __std_thread_backend::__parallel_reduce_body(__middle, __last, __identity, __real_body,
+                                                                __reduction, __grain);
+        });
+    return __reduction(__v1, __v2);
+}
+
+//------------------------------------------------------------------------
+// Notation:
+//      r(i,j,init) returns reduction of init with reduction over [i,j)
+//      c(x,y) combines values x and y that were the result of r
+//------------------------------------------------------------------------
+
+template <class _ExecutionPolicy, class _Value, class _Index, typename _RealBody, typename _Reduction>
+_Value
+__parallel_reduce(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _Index __first, _Index __last,
+                  const _Value& __identity, const _RealBody& __real_body, const _Reduction& __reduction)
+{
+    if (__first == __last)
+        return __identity;
+    std::size_t __n = __last - __first;
+    return __std_thread_backend::__parallel_reduce_body(__first, __last, __identity, __real_body, __reduction,
+                                                        __std_thread_backend::__chunk_size(__n));
+}
+
+//------------------------------------------------------------------------
+// parallel_transform_reduce
+//
+// Notation:
+//      u(i)             returns f(i,i+1)
+//      r(i,j,init)      returns reduction of init with reduction over [i,j)
+//      c(x,y)           combines values x and y that were the result of r
+//------------------------------------------------------------------------
+
+template <class _Index, class _Up, class _Tp, class _Cp, class _Rp>
+_Tp
+__parallel_transform_reduce_body(_Index __first, _Index __last, _Up& __u, _Tp __init, _Cp& __combine,
+                                 _Rp& __brick_reduce, std::size_t __grain)
+{
+    if (static_cast<std::size_t>(__last - __first) <= __grain)
+        return __brick_reduce(__first, __last, __init);
+
+    // There is no identity to start the second half from, so it starts from
+    // the transformed value of its first element instead.
+    _Index __middle = __first + ((__last - __first) / 2);
+    _Tp __v1(__init), __v2(__init);
+    __std_thread_backend::__parallel_invoke_body(
+        [&]() {
+            __v1 = __std_thread_backend::__parallel_transform_reduce_body(__first, __middle, __u, __init, __combine,
+                                                                          __brick_reduce, __grain);
+        },
+        [&]() {
+            __v2 = __std_thread_backend::__parallel_transform_reduce_body(__middle + 1, __last, __u, __u(__middle),
+                                                                          __combine, __brick_reduce, __grain);
+        });
+    return __combine(__v1, __v2);
+}
+
+template <class _ExecutionPolicy, class _Index, class _Up, class _Tp, class _Cp, class _Rp>
+_Tp
+__parallel_transform_reduce(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _Index __first,
+                            _Index __last, _Up __u, _Tp __init, _Cp __combine, _Rp __brick_reduce)
+{
+    if (__first == __last)
+        return __init;
+    std::size_t __n = __last - __first;
+    return __std_thread_backend::__parallel_transform_reduce_body(__first, __last, __u, __init, __combine,
+                                                                  __brick_reduce,
+                                                                  __std_thread_backend::__chunk_size(__n));
+}
+
+//------------------------------------------------------------------------
+// parallel_scan
+//
+// The range is split in chunks. The chunks are reduced in parallel, the
+// initial value of each chunk is computed serially from the reductions, and
+// the chunks are scanned in parallel.
+//------------------------------------------------------------------------
+
+template <class _ExecutionPolicy, typename _Index, typename _Tp, typename _Rp, typename _Cp, typename _Sp,
+          typename _Ap>
+void
+__parallel_strict_scan(__pstl::__internal::__std_thread_backend_tag __tag, _ExecutionPolicy&& __exec, _Index __n,
+                       _Tp __initial, _Rp __reduce, _Cp __combine, _Sp __scan, _Ap __apex)
+{
+    const _Index __chunk = __std_thread_backend::__chunk_size(__n);
+    if (__n <= __chunk)
+    {
+        _Tp __sum = __initial;
+        if (__n)
+            __sum = __combine(__sum, __reduce(_Index(0), __n));
+        __apex(__sum);
+        if (__n)
+            __scan(_Index(0), __n, __initial);
+        return;
+    }
+
+    const _Index __num_chunks = (__n + __chunk - 1) / __chunk;
+    std::vector<_Tp> __sums(__num_chunks, __initial);
+    __std_thread_backend::__parallel_for(__tag, __exec, _Index(0), __num_chunks,
+                                         [&](_Index __i, _Index __j) {
+                                             for (; __i != __j; ++__i)
+                                                 __sums[__i] = __reduce(__i * __chunk,
+                                                                        std::min(__chunk, __n - __i * __chunk));
+                                         });
+
+    // Turn the reductions into the initial value of each chunk.
+    _Tp __sum = __initial;
+    for (_Tp& __chunk_sum : __sums)
+    {
+        _Tp __next = __combine(__sum, __chunk_sum);
+        __chunk_sum = std::move(__sum);
+        __sum = std::move(__next);
+    }
+    __apex(__sum);
+
+    __std_thread_backend::__parallel_for(__tag, __exec, _Index(0), __num_chunks,
+                                         [&](_Index __i, _Index __j) {
+                                             for (; __i != __j; ++__i)
+                                                 __scan(__i * __chunk, std::min(__chunk, __n - __i * __chunk),
+                                                        __sums[__i]);
+                                         });
+}
+
+template <class _ExecutionPolicy, class _Index, class _Up, class _Tp, class _Cp, class _Rp, class _Sp>
+_Tp
+__parallel_transform_scan(__pstl::__internal::__std_thread_backend_tag __tag, _ExecutionPolicy&& __exec, _Index __n,
+                          _Up __u, _Tp __init, _Cp __combine, _Rp __brick_reduce, _Sp __scan)
+{
+    const _Index __chunk = __std_thread_backend::__chunk_size(__n);
+    if (__n <= __chunk)
+        return __scan(_Index(0), __n, __init);
+
+    // Each chunk is reduced starting from the transformed value of its first
+    // element, since there is no identity.
+    const _Index __num_chunks = (__n + __chunk - 1) / __chunk;
+    std::vector<_Tp> __sums(__num_chunks, __init);
+    __std_thread_backend::__parallel_for(__tag, __exec, _Index(0), __num_chunks,
+                                         [&](_Index __i, _Index __j) {
+                                             for (; __i != __j; ++__i)
+                                             {
+                                                 _Index __first = __i * __chunk;
+                                                 _Index __last = std::min(__first + __chunk, __n);
+                                                 __sums[__i] = __brick_reduce(__first + 1, __last, __u(__first));
+                                             }
+                                         });
+
+    _Tp __sum = __init;
+    for (_Tp& __chunk_sum : __sums)
+    {
+        _Tp __next = __combine(__sum, __chunk_sum);
+        __chunk_sum = std::move(__sum);
+        __sum = std::move(__next);
+    }
+
+    __std_thread_backend::__parallel_for(__tag, __exec, _Index(0), __num_chunks,
+                                         [&](_Index __i, _Index __j) {
+                                             for (; __i != __j; ++__i)
+                                             {
+                                                 _Index __first = __i * __chunk;
+                                                 __scan(__first, std::min(__first + __chunk, __n), __sums[__i]);
+                                             }
+                                         });
+    return __sum;
+}
+
+//------------------------------------------------------------------------
+// parallel_merge
+//------------------------------------------------------------------------
+
+template <typename _RandomAccessIterator1, typename _RandomAccessIterator2, typename _RandomAccessIterator3,
+          typename _Compare, typename _LeafMerge>
+void
+__parallel_merge_body(_RandomAccessIterator1 __xs, _RandomAccessIterator1 __xe, _RandomAccessIterator2 __ys,
+                      _RandomAccessIterator2 __ye, _RandomAccessIterator3 __zs, _Compare __comp,
+                      _LeafMerge& __leaf_merge, std::size_t __grain)
+{
+    const std::size_t __size_x = __xe - __xs;
+    const std::size_t __size_y = __ye - __ys;
+    if (__size_x + __size_y <= __grain || __size_x == 0 || __size_y == 0)
+    {
+        __leaf_merge(__xs, __xe, __ys, __ye, __zs, __comp);
+        return;
+    }
+
+    // Split the larger range in half, and the other one at the same value.
+    _RandomAccessIterator1 __xm;
+    _RandomAccessIterator2 __ym;
+    if (__size_x < __size_y)
+    {
+        __ym = __ys + (__size_y / 2);
+        __xm = std::upper_bound(__xs, __xe, *__ym, __comp);
+    }
+    else
+    {
+        __xm = __xs + (__size_x / 2);
+        __ym = std::lower_bound(__ys, __ye, *__xm, __comp);
+    }
+    _RandomAccessIterator3 __zm = __zs + (__xm - __xs) + (__ym - __ys);
+
+    __std_thread_backend::__parallel_invoke_body(
+        [&]() {
+            __std_thread_backend::__parallel_merge_body(__xs, __xm, __ys, __ym, __zs, __comp, __leaf_merge, __grain);
+        },
+        [&]() {
+            __std_thread_backend::__parallel_merge_body(__xm, __xe, __ym, __ye, __zm, __comp, __leaf_merge, __grain);
+        });
+}
+
+template <class _ExecutionPolicy, typename _RandomAccessIterator1, typename _RandomAccessIterator2,
+          typename _RandomAccessIterator3, typename _Compare, typename _LeafMerge>
+void
+__parallel_merge(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _RandomAccessIterator1 __xs,
+                 _RandomAccessIterator1 __xe, _RandomAccessIterator2 __ys, _RandomAccessIterator2 __ye,
+                 _RandomAccessIterator3 __zs, _Compare __comp, _LeafMerge __leaf_merge)
+{
+    std::size_t __n = (__xe - __xs) + (__ye - __ys);
+    std::size_t __grain = std::max(__std_thread_backend::__chunk_size(__n), __default_sort_chunk_size);
+    __std_thread_backend::__parallel_merge_body(__xs, __xe, __ys, __ye, __zs, __comp, __leaf_merge, __grain);
+}
+
+//------------------------------------------------------------------------
+// parallel_stable_sort
+//------------------------------------------------------------------------
+
+namespace __sort_details
+{
+struct __construct_value
+{
+    template <typename _Iterator, typename _OutputIterator>
+    void
+    operator()(_Iterator __x, _OutputIterator __z) const
+    {
+        using _ValueType = typename std::iterator_traits<_OutputIterator>::value_type;
+        ::new (std::addressof(*__z)) _ValueType(std::move(*__x));
+    }
+};
+
+struct __construct_range
+{
+    template <typename _Iterator, typename _OutputIterator>
+    _OutputIterator
+    operator()(_Iterator __first, _Iterator __last, _OutputIterator __d_first) const
+    {
+        for (; __first != __last; ++__first, ++__d_first)
+            __construct_value()(__first, __d_first);
+        return __d_first;
+    }
+};
+} // namespace __sort_details
+
+// Sorts [__xs, __xe) by sorting both halves in parallel, and merging them in
+// parallel into __buf, the uninitialized storage for __xe - __xs elements,
+// before moving them back.
+template <typename _RandomAccessIterator, typename _ValueType, typename _Compare, typename _LeafSort>
+void
+__parallel_stable_sort_body(_RandomAccessIterator __xs, _RandomAccessIterator __xe, _ValueType* __buf,
+                            _Compare __comp, _LeafSort& __leaf_sort, std::size_t __grain)
+{
+    const std::size_t __size = __xe - __xs;
+    if (__size <= __grain)
+    {
+        __leaf_sort(__xs, __xe, __comp);
+        return;
+    }
+
+    _RandomAccessIterator __mid = __xs + (__size / 2);
+    _ValueType* __buf_mid = __buf + (__size / 2);
+    __std_thread_backend::__parallel_invoke_body(
+        [&]() { __std_thread_backend::__parallel_stable_sort_body(__xs, __mid, __buf, __comp, __leaf_sort, __grain); },
+        [&]() {
+            __std_thread_backend::__parallel_stable_sort_body(__mid, __xe, __buf_mid, __comp, __leaf_sort, __grain);
+        });
+
+    __sort_details::__construct_value __construct_value;
+    __sort_details::__construct_range __construct_range;
+    __utils::__serial_move_merge __merge(__size);
+    auto __leaf_merge = [&](_RandomAccessIterator __as, _RandomAccessIterator __ae, _RandomAccessIterator __bs,
+                            _RandomAccessIterator __be, _ValueType* __cs, _Compare __comp) {
+        __merge(__as, __ae, __bs, __be, __cs, __comp, __construct_value, __construct_value, __construct_range,
+                __construct_range);
+    };
+    __std_thread_backend::__parallel_merge_body(__xs, __mid, __mid, __xe, __buf, __comp, __leaf_merge, __grain);
+
+    // Move the merged values back, destroying the ones in the buffer.
+    auto __move_back = [__xs, __buf](std::size_t __i, std::size_t __j) {
+        for (; __i != __j; ++__i)
+        {
+            __xs[__i] = std::move(__buf[__i]);
+            __buf[__i].~_ValueType();
+        }
+    };
+    __std_thread_backend::__parallel_for_body(std::size_t(0), __size, __move_back, __grain);
+}
+
+template <class _ExecutionPolicy, typename _RandomAccessIterator, typename _Compare, typename _LeafSort>
+void
+__parallel_stable_sort(__pstl::__internal::__std_thread_backend_tag, _ExecutionPolicy&&, _RandomAccessIterator __xs,
+                       _RandomAccessIterator __xe, _Compare __comp, _LeafSort __leaf_sort, std::size_t __nsort = 0)
+{
+    using _ValueType = typename std::iterator_traits<_RandomAccessIterator>::value_type;
+
+    // A partial sort of the first __nsort elements is done by the leaf sort
+    // as a whole: the halves can not be partially sorted independently.
+    const std::size_t __size = __xe - __xs;
+    const std::size_t __grain = std::max(__std_thread_backend::__chunk_size(__size), __default_sort_chunk_size);
+    if (__size <= __grain || (__nsort != 0 && __nsort < __size))
+    {
+        __leaf_sort(__xs, __xe, __comp);
+        return;
+    }
+
+    __buffer<_ValueType> __buf(__size);
+    __std_thread_backend::__parallel_stable_sort_body(__xs, __xe, __buf.get(), __comp, __leaf_sort, __grain);
+}
+
+} // namespace __std_thread_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_PARALLEL_BACKEND_STD_THREAD_H */